@@ -359,6 +359,12 @@ MIRACLE_PARAMETER_FOR_DOUBLE(GetThreadCacheMultiplierForAndroid,
                              "ThreadCacheMultiplierForAndroid",
                              1.)
 
+// Grows the thread cache limits of buckets which keep going to the central
+// allocator, and shrinks them back once they are idle.
+BASE_FEATURE(kPartitionAllocAdaptiveThreadCacheLimits,
+             "PartitionAllocAdaptiveThreadCacheLimits",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 constexpr partition_alloc::internal::base::TimeDelta ToPartitionAllocTimeDelta(
     base::TimeDelta time_delta) {
   return partition_alloc::internal::base::Microseconds(
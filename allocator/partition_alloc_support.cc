@@ -1383,6 +1383,12 @@ void PartitionAllocSupport::ReconfigureAfterTaskRunnerInit(
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_CHROMEOS)
   }
 
+  if (base::FeatureList::IsEnabled(
+          base::features::kPartitionAllocAdaptiveThreadCacheLimits)) {
+    ::partition_alloc::ThreadCacheRegistry::Instance().SetAdaptiveLimitsEnabled(
+        true);
+  }
+
   // Renderer processes are more performance-sensitive, increase thread cache
   // limits.
   if (process_type == switches::kRendererProcess &&
@@ -363,6 +363,12 @@ void DiscardSystemPages(void* address, size_t length) {
   DiscardSystemPages(reinterpret_cast<uintptr_t>(address), length);
 }
 
+void AdviseHugePages(uintptr_t address, size_t length, bool use_huge_pages) {
+  PA_DCHECK(!(address & internal::SystemPageOffsetMask()));
+  PA_DCHECK(!(length & internal::SystemPageOffsetMask()));
+  internal::AdviseHugePagesInternal(address, length, use_huge_pages);
+}
+
 bool ReserveAddressSpace(size_t size) {
   // To avoid deadlock, call only SystemAllocPages.
   internal::ScopedGuard guard(GetReserveLock());
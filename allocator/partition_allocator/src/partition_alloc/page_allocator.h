@@ -326,6 +326,25 @@ void DiscardSystemPages(uintptr_t address, size_t length);
 PA_COMPONENT_EXPORT(PARTITION_ALLOC)
 void DiscardSystemPages(void* address, size_t length);
 
+// Whether AdviseHugePages() has an effect on this platform.
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+inline constexpr bool kHugePagesAdviceSupported = true;
+#else
+inline constexpr bool kHugePagesAdviceSupported = false;
+#endif
+
+// Advises the system whether the pages within the region should be backed by
+// huge pages, i.e. transparent huge pages on Linux. The system is free to
+// ignore it, e.g. when huge pages are disabled, and it also ignores the parts
+// of the region which can't be backed by a whole huge page, so the region
+// should be aligned to kSuperPageSize, which is also the size of huge pages on
+// x86-64 and arm64 with 4kiB pages. Does nothing on other platforms.
+//
+// Huge pages cut the TLB misses of large heaps, but partially discarding or
+// decommitting a huge page splits it up again.
+PA_COMPONENT_EXPORT(PARTITION_ALLOC)
+void AdviseHugePages(uintptr_t address, size_t length, bool use_huge_pages);
+
 // Rounds up |address| to the next multiple of |SystemPageSize()|. Returns
 // 0 for an |address| of 0.
 PA_ALWAYS_INLINE PAGE_ALLOCATOR_CONSTANTS_DECLARE_CONSTEXPR uintptr_t
@@ -210,6 +210,10 @@ void DiscardSystemPagesInternal(uint64_t address, size_t length) {
   PA_ZX_CHECK(status == ZX_OK, status);
 }
 
+void AdviseHugePagesInternal(uint64_t address,
+                             size_t length,
+                             bool use_huge_pages) {}
+
 void DecommitSystemPagesInternal(
     uint64_t address,
     size_t length,
@@ -429,6 +429,17 @@ void DiscardSystemPagesInternal(uintptr_t address, size_t length) {
 #endif  // BUILDFLAG(IS_APPLE)
 }
 
+void AdviseHugePagesInternal(uintptr_t address,
+                             size_t length,
+                             bool use_huge_pages) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Fails with EINVAL when the kernel doesn't support transparent huge pages,
+  // which just means that there is nothing to advise.
+  madvise(reinterpret_cast<void*>(address), length,
+          use_huge_pages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+#endif
+}
+
 }  // namespace partition_alloc::internal
 
 #endif  // PARTITION_ALLOC_PAGE_ALLOCATOR_INTERNALS_POSIX_H_
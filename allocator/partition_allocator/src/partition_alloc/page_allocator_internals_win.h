@@ -238,6 +238,12 @@ void DiscardSystemPagesInternal(uintptr_t address, size_t length) {
   }
 }
 
+void AdviseHugePagesInternal(uintptr_t address,
+                             size_t length,
+                             bool use_huge_pages) {
+  // Large pages must be allocated as such on Windows, there is no advice.
+}
+
 }  // namespace partition_alloc::internal
 
 #endif  // PARTITION_ALLOC_PAGE_ALLOCATOR_INTERNALS_WIN_H_
@@ -518,6 +518,141 @@ TEST_P(PartitionAllocMemoryAllocationPerfTest,
 }
 #endif  // !defined(MEMORY_CONSTRAINED)
 
+// Hands the objects allocated by a producer thread to a consumer thread, which
+// frees them, through a single-producer single-consumer ring. Every free is
+// then a cross-thread one, and all the pairs contend for the lock of the root.
+class ProducerConsumerPair {
+ public:
+  static constexpr size_t kRingSize = 1024;
+
+  explicit ProducerConsumerPair(PartitionRoot* root)
+      : producer_(this, &ProducerConsumerPair::Produce),
+        consumer_(this, &ProducerConsumerPair::Consume),
+        root_(root) {}
+
+  void Start() {
+    PA_CHECK(base::PlatformThreadForTesting::Create(0, &producer_,
+                                                    &producer_handle_));
+    PA_CHECK(base::PlatformThreadForTesting::Create(0, &consumer_,
+                                                    &consumer_handle_));
+  }
+
+  // Returns the number of objects freed by the consumer per second.
+  float Join() {
+    base::PlatformThreadForTesting::Join(producer_handle_);
+    base::PlatformThreadForTesting::Join(consumer_handle_);
+    return laps_per_second_;
+  }
+
+ private:
+  class Delegate : public base::PlatformThreadForTesting::Delegate {
+   public:
+    Delegate(ProducerConsumerPair* pair, void (ProducerConsumerPair::*main)())
+        : pair_(pair), main_(main) {}
+    void ThreadMain() override { (pair_->*main_)(); }
+
+   private:
+    ProducerConsumerPair* pair_;
+    void (ProducerConsumerPair::*main_)();
+  };
+
+  void Produce() {
+    uint64_t position = 0;
+    while (!done_.load(std::memory_order_relaxed)) {
+      if (position - read_position_.load(std::memory_order_acquire) ==
+          kRingSize) {
+        base::PlatformThreadForTesting::YieldCurrentThread();
+        continue;
+      }
+      void* object = root_->Alloc<AllocFlags::kNoHooks>(kAllocSize);
+      PA_CHECK(object);
+      ring_[position % kRingSize] = object;
+      write_position_.store(++position, std::memory_order_release);
+    }
+    producer_done_.store(true, std::memory_order_release);
+  }
+
+  void Consume() {
+    uint64_t position = 0;
+    ::base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+    do {
+      if (write_position_.load(std::memory_order_acquire) == position) {
+        base::PlatformThreadForTesting::YieldCurrentThread();
+        continue;
+      }
+      PartitionRoot::FreeInlineInUnknownRoot<FreeFlags::kNoHooks>(
+          ring_[position % kRingSize]);
+      read_position_.store(++position, std::memory_order_release);
+      timer.NextLap();
+    } while (!timer.HasTimeLimitExpired());
+    laps_per_second_ = timer.LapsPerSecond();
+    done_.store(true, std::memory_order_relaxed);
+
+    // Free what the producer allocated before it stopped.
+    while (!producer_done_.load(std::memory_order_acquire)) {
+      base::PlatformThreadForTesting::YieldCurrentThread();
+    }
+    for (; position != write_position_.load(std::memory_order_acquire);
+         ++position) {
+      PartitionRoot::FreeInlineInUnknownRoot<FreeFlags::kNoHooks>(
+          ring_[position % kRingSize]);
+    }
+  }
+
+  Delegate producer_;
+  Delegate consumer_;
+  PartitionRoot* root_;
+  base::PlatformThreadHandle producer_handle_;
+  base::PlatformThreadHandle consumer_handle_;
+  void* ring_[kRingSize] = {};
+  alignas(kPartitionCachelineSize) std::atomic<uint64_t> write_position_{0};
+  alignas(kPartitionCachelineSize) std::atomic<uint64_t> read_position_{0};
+  std::atomic<bool> done_{false};
+  std::atomic<bool> producer_done_{false};
+  float laps_per_second_ = 0;
+};
+
+class PartitionAllocProducerConsumerPerfTest
+    : public testing::TestWithParam<std::tuple<int, bool>> {};
+
+INSTANTIATE_TEST_SUITE_P(,
+                         PartitionAllocProducerConsumerPerfTest,
+                         ::testing::Combine(::testing::Values(1, 2, 4),
+                                            ::testing::Bool()));
+
+// Compares the frees of objects allocated on other threads through the lock,
+// and through the delayed free list when the lock is contended.
+TEST_P(PartitionAllocProducerConsumerPerfTest, CrossThreadFree) {
+  const auto [pair_count, delayed_free_list] = GetParam();
+  PartitionOptions opts;
+  if (delayed_free_list) {
+    opts.delayed_free_list = PartitionOptions::kEnabled;
+  }
+  PartitionRoot root(opts);
+
+  std::vector<std::unique_ptr<ProducerConsumerPair>> pairs;
+  for (int i = 0; i < pair_count; ++i) {
+    pairs.push_back(std::make_unique<ProducerConsumerPair>(&root));
+  }
+  for (auto& pair : pairs) {
+    pair->Start();
+  }
+  uint64_t total_laps_per_second = 0;
+  uint64_t min_laps_per_second = std::numeric_limits<uint64_t>::max();
+  for (auto& pair : pairs) {
+    uint64_t laps_per_second = pair->Join();
+    min_laps_per_second = std::min(laps_per_second, min_laps_per_second);
+    total_laps_per_second += laps_per_second;
+  }
+
+  std::string name = base::TruncatingStringPrintf(
+      "%sCrossThreadFree_%s_%d", kMetricPrefixMemoryAllocation,
+      delayed_free_list ? "DelayedFreeList" : "Lock", pair_count);
+  DisplayResults(name + "_total", total_laps_per_second);
+  DisplayResults(name + "_worst", min_laps_per_second);
+  root.DestructForTesting();
+}
+
 }  // namespace
 
 }  // namespace partition_alloc::internal
@@ -760,6 +760,98 @@ TEST_P(PartitionAllocTest, MultiAlloc) {
   allocator.root()->Free(ptr3);
 }
 
+TEST_P(PartitionAllocTest, AllocWithSizeClass) {
+  PartitionRoot::SizeClass size_class =
+      allocator.root()->GetSizeClass(kTestAllocSize);
+  EXPECT_EQ(test_bucket_index_, size_class.bucket_index);
+
+  void* ptr1 = allocator.root()->AllocWithSizeClass(size_class, type_name);
+  void* ptr2 = allocator.root()->AllocWithSizeClass(size_class, type_name);
+  EXPECT_TRUE(ptr1);
+  EXPECT_TRUE(ptr2);
+  EXPECT_EQ(static_cast<ptrdiff_t>(ActualTestAllocSize()),
+            UntagPtr(ptr2) - UntagPtr(ptr1));
+  EXPECT_LE(kTestAllocSize, PartitionRoot::GetUsableSize(ptr1));
+  allocator.root()->Free(ptr1);
+  allocator.root()->Free(ptr2);
+
+  // A size class resolved with another bucket distribution still allocates
+  // from the right bucket.
+  size_class.bucket_distribution =
+      size_class.bucket_distribution == BucketDistribution::kNeutral
+          ? BucketDistribution::kDenser
+          : BucketDistribution::kNeutral;
+  size_class.bucket_index = 0;
+  void* ptr = allocator.root()->AllocWithSizeClass(size_class, type_name);
+  EXPECT_TRUE(ptr);
+  EXPECT_EQ(&allocator.root()->buckets[test_bucket_index_],
+            SlotSpanMetadata::FromObject(ptr)->bucket);
+  allocator.root()->Free(ptr);
+}
+
+TEST_P(PartitionAllocTest, AllocAndFreeBatch) {
+  constexpr size_t kCount = 100;
+  void* ptrs[kCount] = {};
+  ASSERT_EQ(kCount,
+            allocator.root()->AllocBatch(kTestAllocSize, kCount, ptrs,
+                                         type_name));
+  std::set<void*> distinct_ptrs;
+  for (void* ptr : ptrs) {
+    ASSERT_TRUE(ptr);
+    EXPECT_EQ(&allocator.root()->buckets[test_bucket_index_],
+              SlotSpanMetadata::FromObject(ptr)->bucket);
+    memset(ptr, 'A', kTestAllocSize);
+    distinct_ptrs.insert(ptr);
+  }
+  EXPECT_EQ(kCount, distinct_ptrs.size());
+  size_t allocated_bytes =
+      allocator.root()->get_total_size_of_allocated_bytes();
+
+  // Null pointers are skipped.
+  void* kept_ptr = ptrs[kCount / 2];
+  ptrs[kCount / 2] = nullptr;
+  allocator.root()->FreeBatch(ptrs, kCount);
+  EXPECT_EQ(allocated_bytes - (kCount - 1) * ActualTestAllocSize(),
+            allocator.root()->get_total_size_of_allocated_bytes());
+
+  // The slots are reused.
+  void* ptr = allocator.root()->Alloc(kTestAllocSize, type_name);
+  EXPECT_TRUE(distinct_ptrs.count(ptr));
+  EXPECT_NE(kept_ptr, ptr);
+  allocator.root()->Free(ptr);
+  allocator.root()->Free(kept_ptr);
+}
+
+TEST_P(PartitionAllocTest, AllocBatchZeroFill) {
+  constexpr size_t kCount = 10;
+  // Dirty some slots first.
+  void* ptrs[kCount] = {};
+  for (void*& ptr : ptrs) {
+    ptr = allocator.root()->Alloc(kTestAllocSize, type_name);
+    memset(ptr, 'A', kTestAllocSize);
+  }
+  allocator.root()->FreeBatch(ptrs, kCount);
+
+  ASSERT_EQ(kCount, allocator.root()->AllocBatch<AllocFlags::kZeroFill>(
+                        kTestAllocSize, kCount, ptrs, type_name));
+  for (void* ptr : ptrs) {
+    for (size_t i = 0; i < kTestAllocSize; ++i) {
+      EXPECT_EQ(0, static_cast<char*>(ptr)[i]);
+    }
+  }
+  allocator.root()->FreeBatch(ptrs, kCount);
+}
+
+TEST_P(PartitionAllocTest, AllocBatchDirectMapped) {
+  constexpr size_t kSize = kMaxBucketed + 1;
+  void* ptrs[2] = {};
+  ASSERT_EQ(2u, allocator.root()->AllocBatch(kSize, 2, ptrs, type_name));
+  EXPECT_TRUE(ptrs[0]);
+  EXPECT_TRUE(ptrs[1]);
+  EXPECT_NE(ptrs[0], ptrs[1]);
+  allocator.root()->FreeBatch(ptrs, 2);
+}
+
 // Test a bucket with multiple slot spans.
 TEST_P(PartitionAllocTest, MultiSlotSpans) {
   PartitionRoot::Bucket* bucket =
@@ -3645,6 +3737,133 @@ TEST_P(PartitionAllocTest, SchedulerLoopQuarantineDisabled) {
   root->Free(ptr_to_keep_slot_span);
 }
 
+namespace {
+
+class ThreadDelegateForDelayedFreeList
+    : public base::PlatformThreadForTesting::Delegate {
+ public:
+  explicit ThreadDelegateForDelayedFreeList(void* ptr) : ptr_(ptr) {}
+
+  void ThreadMain() override { PartitionRoot::FreeInUnknownRoot(ptr_); }
+
+ private:
+  void* ptr_;
+};
+
+}  // namespace
+
+TEST_P(PartitionAllocTest, DelayedFreeList) {
+  PartitionOptions opts = GetCommonPartitionOptions();
+  opts.thread_cache = PartitionOptions::kDisabled;
+  opts.star_scan_quarantine = PartitionOptions::kDisallowed;
+  opts.delayed_free_list = PartitionOptions::kEnabled;
+  std::unique_ptr<PartitionRoot> root = CreateCustomTestRoot(opts, {});
+
+  // This allocation is required to prevent slot span from being empty and
+  // decomitted.
+  void* ptr_to_keep_slot_span = root->Alloc(kTestAllocSize, type_name);
+  void* ptr = root->Alloc(kTestAllocSize, type_name);
+  void* other_ptr = root->Alloc(kTestAllocSize, type_name);
+  uintptr_t slot_start = root->ObjectToSlotStart(ptr);
+  auto* slot_span = SlotSpanMetadata::FromSlotStart(slot_start);
+  size_t num_allocated_slots = slot_span->num_allocated_slots;
+
+  // Another thread frees while the lock is held: the slot goes to the delayed
+  // free list.
+  {
+    ScopedGuard guard{PartitionRootLock(root.get())};
+    ThreadDelegateForDelayedFreeList delegate(ptr);
+    base::PlatformThreadHandle thread_handle;
+    ASSERT_TRUE(
+        base::PlatformThreadForTesting::Create(0, &delegate, &thread_handle));
+    base::PlatformThreadForTesting::Join(thread_handle);
+    EXPECT_EQ(num_allocated_slots, slot_span->num_allocated_slots);
+    EXPECT_EQ(slot_start, root->delayed_free_list_head.load());
+  }
+
+  // The next free with the lock frees it as well.
+  root->Free(other_ptr);
+  EXPECT_EQ(0u, root->delayed_free_list_head.load());
+  EXPECT_EQ(num_allocated_slots - 2, slot_span->num_allocated_slots);
+
+  // And so does the next allocation with the lock.
+  ptr = root->Alloc(kTestAllocSize, type_name);
+  {
+    ScopedGuard guard{PartitionRootLock(root.get())};
+    ThreadDelegateForDelayedFreeList delegate(ptr);
+    base::PlatformThreadHandle thread_handle;
+    ASSERT_TRUE(
+        base::PlatformThreadForTesting::Create(0, &delegate, &thread_handle));
+    base::PlatformThreadForTesting::Join(thread_handle);
+  }
+  EXPECT_NE(0u, root->delayed_free_list_head.load());
+  void* new_ptr = root->Alloc(kTestAllocSize, type_name);
+  EXPECT_EQ(0u, root->delayed_free_list_head.load());
+  // The slot was reclaimed before allocating, so it is the one reused.
+  EXPECT_EQ(ptr, new_ptr);
+  root->Free(new_ptr);
+
+  root->Free(ptr_to_keep_slot_span);
+}
+
+TEST_P(PartitionAllocTest, HugePages) {
+  PartitionOptions opts = GetCommonPartitionOptions();
+  opts.thread_cache = PartitionOptions::kDisabled;
+  opts.star_scan_quarantine = PartitionOptions::kDisallowed;
+  opts.memory_tagging = {.enabled = PartitionOptions::kDisabled};
+  opts.huge_pages = PartitionOptions::kEnabled;
+  std::unique_ptr<PartitionRoot> root = CreateCustomTestRoot(opts, {});
+  if (!root->settings.huge_pages) {
+    GTEST_SKIP() << "Huge pages are not supported.";
+  }
+
+  // Fill a super page, until a second one is needed.
+  constexpr size_t kSize = 1000;
+  std::vector<void*> ptrs;
+  ptrs.push_back(root->Alloc(kSize, type_name));
+  const uintptr_t super_page =
+      root->ObjectToSlotStart(ptrs[0]) & kSuperPageBaseMask;
+  void* ptr_in_next_super_page = nullptr;
+  while (!ptr_in_next_super_page) {
+    void* ptr = root->Alloc(kSize, type_name);
+    if ((root->ObjectToSlotStart(ptr) & kSuperPageBaseMask) == super_page) {
+      ptrs.push_back(ptr);
+    } else {
+      ptr_in_next_super_page = ptr;
+    }
+  }
+  auto* extent = PartitionSuperPageToExtent(super_page);
+  EXPECT_FALSE(extent->uses_huge_pages);
+
+  // Purging finds it dense.
+  root->PurgeMemory(PurgeFlags::kDecommitEmptySlotSpans |
+                    PurgeFlags::kDiscardUnusedSystemPages);
+  EXPECT_TRUE(extent->uses_huge_pages);
+
+  // An empty slot span stays committed.
+  auto* slot_span =
+      SlotSpanMetadata::FromSlotStart(root->ObjectToSlotStart(ptrs[0]));
+  size_t slots_per_span = slot_span->bucket->get_slots_per_span();
+  for (size_t i = 0; i < slots_per_span; ++i) {
+    root->Free(ptrs[i]);
+  }
+  EXPECT_TRUE(slot_span->is_empty());
+  root->PurgeMemory(PurgeFlags::kDecommitEmptySlotSpans);
+  EXPECT_TRUE(slot_span->is_empty());
+  EXPECT_EQ(0u, root->empty_slot_spans_dirty_bytes);
+
+  // Until the super page gets sparse.
+  for (size_t i = slots_per_span; i < ptrs.size() - 1; ++i) {
+    root->Free(ptrs[i]);
+  }
+  root->PurgeMemory(PurgeFlags::kDecommitEmptySlotSpans);
+  EXPECT_FALSE(extent->uses_huge_pages);
+  EXPECT_TRUE(slot_span->is_decommitted());
+
+  root->Free(ptrs.back());
+  root->Free(ptr_in_next_super_page);
+}
+
 TEST_P(PartitionAllocTest, ZapOnFree) {
   void* ptr = allocator.root()->Alloc(1, type_name);
   EXPECT_TRUE(ptr);
@@ -813,6 +813,20 @@ PartitionBucket::InitializeSuperPage(PartitionRoot* root,
   }
 #endif
 
+  if (root->settings.huge_pages) {
+    // A huge page can only back a range which is accessible in the same way,
+    // so the guard pages are given up, and the whole super page is committed
+    // at once. Slot spans are still accounted for as committed when they get
+    // provisioned. Until the super page gets dense, it shouldn't use a huge
+    // page, which would make the untouched parts of it resident.
+    ScopedSyscallTimer timer{root};
+    RecommitSystemPages(super_page, kSuperPageSize,
+                        PageAccessibilityConfiguration(
+                            PageAccessibilityConfiguration::kReadWrite),
+                        PageAccessibilityDisposition::kRequireUpdate);
+    AdviseHugePages(super_page, kSuperPageSize, /*use_huge_pages=*/false);
+  }
+
   // If we were after a specific address, but didn't get it, assume that
   // the system chose a lousy address. Here most OS'es have a default
   // algorithm that isn't randomized. For example, most Linux
@@ -835,6 +849,7 @@ PartitionBucket::InitializeSuperPage(PartitionRoot* root,
   latest_extent->number_of_consecutive_super_pages = 0;
   latest_extent->next = nullptr;
   latest_extent->number_of_nonempty_slot_spans = 0;
+  latest_extent->uses_huge_pages = false;
 
   PartitionSuperPageExtentEntry* current_extent = root->current_extent;
   const bool is_new_extent = super_page != requested_address;
@@ -64,6 +64,23 @@ class PA_LOCKABLE Lock {
 #endif
   }
 
+  // Acquires the lock if it is free, without waiting. Unlike Acquire(), this
+  // doesn't detect reentrancy, since a caller trying the lock must already
+  // handle failure.
+  bool Try() PA_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+    if (!lock_.Try()) {
+      return false;
+    }
+#if PA_BUILDFLAG(PA_DCHECK_IS_ON)
+#if PA_BUILDFLAG(ENABLE_THREAD_ISOLATION)
+    LiftThreadIsolationScope lift_thread_isolation_restrictions;
+#endif
+    owning_thread_ref_.store(base::PlatformThread::CurrentRef(),
+                             std::memory_order_release);
+#endif
+    return true;
+  }
+
   void Release() PA_UNLOCK_FUNCTION() {
 #if PA_BUILDFLAG(PA_DCHECK_IS_ON)
 #if PA_BUILDFLAG(ENABLE_THREAD_ISOLATION)
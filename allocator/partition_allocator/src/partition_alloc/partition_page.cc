@@ -220,13 +220,10 @@ void SlotSpanMetadata::Decommit(PartitionRoot* root) {
   PA_DCHECK(!bucket->is_direct_mapped());
   uintptr_t slot_span_start = SlotSpanMetadata::ToSlotSpanStart(this);
   // If lazy commit is enabled, only provisioned slots are committed.
-  size_t dirty_size =
-      base::bits::AlignUp(GetProvisionedSize(), SystemPageSize());
   size_t size_to_decommit =
-      kUseLazyCommit ? dirty_size : bucket->get_bytes_per_span();
-
-  PA_DCHECK(root->empty_slot_spans_dirty_bytes >= dirty_size);
-  root->empty_slot_spans_dirty_bytes -= dirty_size;
+      kUseLazyCommit
+          ? base::bits::AlignUp(GetProvisionedSize(), SystemPageSize())
+          : bucket->get_bytes_per_span();
 
   // Not decommitted slot span must've had at least 1 allocation.
   PA_DCHECK(size_to_decommit > 0);
@@ -257,7 +254,16 @@ void SlotSpanMetadata::DecommitIfPossible(PartitionRoot* root) {
   PA_DCHECK(this == root->global_empty_slot_span_ring[empty_cache_index_]);
   in_empty_cache_ = 0;
   if (is_empty()) {
-    Decommit(root);
+    size_t dirty_size =
+        base::bits::AlignUp(GetProvisionedSize(), SystemPageSize());
+    PA_DCHECK(root->empty_slot_spans_dirty_bytes >= dirty_size);
+    root->empty_slot_spans_dirty_bytes -= dirty_size;
+    // Decommitting part of a huge page would split it up, so the slot span
+    // stays committed until its super page gets sparse, see
+    // PartitionRoot::UpdateHugePagesAdvice().
+    if (!ToSuperPageExtent()->uses_huge_pages) {
+      Decommit(root);
+    }
   }
   root->global_empty_slot_span_ring[empty_cache_index_] = nullptr;
 }
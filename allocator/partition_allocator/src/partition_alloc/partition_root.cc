@@ -357,6 +357,10 @@ static size_t PartitionPurgeSlotSpan(PartitionRoot* root,
   if (slot_size < MinPurgeableSlotSize() || !slot_span->num_allocated_slots) {
     return 0;
   }
+  // Discarding part of a huge page would split it up.
+  if (slot_span->ToSuperPageExtent()->uses_huge_pages) {
+    return 0;
+  }
 
   size_t bucket_num_slots = bucket->get_slots_per_span();
   size_t discardable_bytes = 0;
@@ -848,6 +852,57 @@ void PartitionRoot::DecommitEmptySlotSpans() {
   PA_DCHECK(empty_slot_spans_dirty_bytes == 0);
 }
 
+void PartitionRoot::UpdateHugePagesAdvice() {
+  PA_DCHECK(settings.huge_pages);
+  // The super page slot spans are being carved out of is still growing.
+  const uintptr_t current_super_page =
+      next_partition_page & internal::kSuperPageBaseMask;
+  const bool with_quarantine = IsQuarantineAllowed();
+  for (auto* extent = first_extent; extent; extent = extent->next) {
+    for (uintptr_t super_page = internal::SuperPagesBeginFromExtent(extent);
+         super_page < internal::SuperPagesEndFromExtent(extent);
+         super_page += internal::kSuperPageSize) {
+      if (super_page == current_super_page) {
+        continue;
+      }
+      size_t used_bytes = 0;
+      internal::IterateSlotSpans(
+          super_page, with_quarantine, [&](SlotSpanMetadata* slot_span) {
+            if (!slot_span->is_empty() && !slot_span->is_decommitted()) {
+              used_bytes += slot_span->bucket->get_bytes_per_span();
+            }
+            return false;
+          });
+      const size_t payload_size =
+          internal::SuperPagePayloadSize(super_page, with_quarantine);
+      auto* entry = internal::PartitionSuperPageToExtent(super_page);
+      // Dense super pages are mostly resident anyway, so they would hardly
+      // grow by using a huge page. The gap between the thresholds keeps the
+      // super pages near one of them from flip-flopping.
+      if (!entry->uses_huge_pages && used_bytes >= payload_size / 2) {
+        internal::ScopedSyscallTimer timer{this};
+        AdviseHugePages(super_page, internal::kSuperPageSize,
+                        /*use_huge_pages=*/true);
+        entry->uses_huge_pages = true;
+      } else if (entry->uses_huge_pages && used_bytes < payload_size / 8) {
+        internal::ScopedSyscallTimer timer{this};
+        AdviseHugePages(super_page, internal::kSuperPageSize,
+                        /*use_huge_pages=*/false);
+        entry->uses_huge_pages = false;
+        // The slot spans in the empty cache are decommitted when they leave
+        // it, and the other empty ones were kept committed for the huge page.
+        internal::IterateSlotSpans(
+            super_page, with_quarantine, [this](SlotSpanMetadata* slot_span) {
+              if (slot_span->is_empty() && !slot_span->in_empty_cache()) {
+                slot_span->Decommit(this);
+              }
+              return false;
+            });
+      }
+    }
+  }
+}
+
 void PartitionRoot::DecommitEmptySlotSpansForTesting() {
   ::partition_alloc::internal::ScopedGuard guard{
       internal::PartitionRootLock(this)};
@@ -1033,6 +1088,16 @@ void PartitionRoot::Init(PartitionOptions opts) {
 
     settings.use_pool_offset_freelists =
         opts.use_pool_offset_freelists == PartitionOptions::kEnabled;
+    settings.delayed_free_list =
+        opts.delayed_free_list == PartitionOptions::kEnabled;
+    // A huge page needs the accessibility of its whole super page to be the
+    // same, which the read-only shadow metadata page breaks.
+    settings.huge_pages = kHugePagesAdviceSupported &&
+                          !PA_CONFIG(ENABLE_SHADOW_METADATA) &&
+                          opts.huge_pages == PartitionOptions::kEnabled;
+#if PA_BUILDFLAG(HAS_MEMORY_TAGGING)
+    PA_CHECK(!settings.huge_pages || !settings.memory_tagging_enabled_);
+#endif
 
     // brp_enabled() is not supported in the configurable pool because
     // BRP requires objects to be in a different Pool.
@@ -1046,6 +1111,7 @@ void PartitionRoot::Init(PartitionOptions opts) {
     PA_CHECK(!opts.thread_isolation.enabled ||
              opts.backup_ref_ptr == PartitionOptions::kDisabled);
     settings.thread_isolation = opts.thread_isolation;
+    PA_CHECK(!opts.thread_isolation.enabled || !settings.huge_pages);
 #endif  // PA_BUILDFLAG(ENABLE_THREAD_ISOLATION)
 
 #if PA_CONFIG(EXTRAS_REQUIRED)
@@ -1363,6 +1429,91 @@ bool PartitionRoot::TryReallocInPlaceForNormalBuckets(
   return object;
 }
 
+void PartitionRoot::DrainDelayedFreeList() {
+  uintptr_t slot_start =
+      delayed_free_list_head.exchange(0, std::memory_order_acquire);
+  while (slot_start) {
+    auto* entry = static_cast<DelayedFreeListEntry*>(
+        internal::SlotStartAddr2Ptr(slot_start));
+    const uintptr_t next = entry->next;
+    // The slot was freed, so the entry may have been overwritten by a
+    // use-after-free.
+    PA_CHECK(entry->inverted_next == ~next);
+    FreeInSlotSpan(slot_start, SlotSpanMetadata::FromSlotStart(slot_start));
+    slot_start = next;
+  }
+}
+
+void PartitionRoot::FreeBatch(void* const* objects, size_t count) {
+  // What FreeInline() does before releasing the extras isn't done here, so
+  // the setups which need it free the objects one by one.
+  bool free_one_by_one =
+      PartitionAllocHooks::AreHooksEnabled() || IsMemoryTaggingEnabled();
+#if defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+  free_one_by_one = true;
+#endif
+#if PA_BUILDFLAG(USE_STARSCAN)
+  free_one_by_one |= IsQuarantineEnabled();
+#endif
+  if (free_one_by_one) {
+    for (size_t i = 0; i < count; ++i) {
+      Free(objects[i]);
+    }
+    return;
+  }
+
+  // The slots which don't go to the thread cache are linked through their
+  // first word, which also faults them in before taking the lock, as in
+  // RawFree().
+  ThreadCache* thread_cache = GetThreadCache();
+  uintptr_t slots_to_free = 0;
+  for (size_t i = 0; i < count; ++i) {
+    void* object = objects[i];
+    if (!object) {
+      continue;
+    }
+    SlotSpanMetadata* slot_span = SlotSpanMetadata::FromObject(object);
+    PA_DCHECK(PartitionRoot::FromSlotSpanMetadata(slot_span) == this);
+    uintptr_t slot_start = ObjectToSlotStart(object);
+    if (!ReleaseSlotExtras(object, slot_span, slot_start)) {
+      continue;
+    }
+    // Direct-mapped frees release the lock.
+    if (IsDirectMappedBucket(slot_span->bucket)) {
+      RawFreeWithThreadCache(slot_start, slot_span);
+      continue;
+    }
+    if (PA_LIKELY(ThreadCache::IsValid(thread_cache))) {
+      size_t bucket_index =
+          static_cast<size_t>(slot_span->bucket - this->buckets);
+      size_t slot_size;
+      if (thread_cache->MaybePutInCache(slot_start, bucket_index,
+                                        &slot_size)) {
+        thread_cache->RecordDeallocation(
+            AdjustSizeForExtrasSubtract(slot_size));
+        continue;
+      }
+      thread_cache->RecordDeallocation(GetSlotUsableSize(slot_span));
+    }
+    *static_cast<uintptr_t*>(internal::SlotStartAddr2Ptr(slot_start)) =
+        slots_to_free;
+    slots_to_free = slot_start;
+  }
+  if (!slots_to_free) {
+    return;
+  }
+
+  ::partition_alloc::internal::ScopedGuard guard{
+      internal::PartitionRootLock(this)};
+  while (slots_to_free) {
+    const uintptr_t slot_start = slots_to_free;
+    slots_to_free =
+        *static_cast<uintptr_t*>(internal::SlotStartAddr2Ptr(slot_start));
+    FreeInSlotSpan(slot_start, SlotSpanMetadata::FromSlotStart(slot_start));
+  }
+  MaybeDrainDelayedFreeList();
+}
+
 void PartitionRoot::PurgeMemory(int flags) {
   {
     ::partition_alloc::internal::ScopedGuard guard{
@@ -1377,6 +1528,11 @@ void PartitionRoot::PurgeMemory(int flags) {
     }
 #endif  // PA_BUILDFLAG(USE_STARSCAN)
 
+    // First, so that the slot spans emptied by it can be decommitted.
+    MaybeDrainDelayedFreeList();
+    if (settings.huge_pages) {
+      UpdateHugePagesAdvice();
+    }
     if (flags & PurgeFlags::kDecommitEmptySlotSpans) {
       DecommitEmptySlotSpans();
     }
@@ -187,6 +187,22 @@ struct PartitionOptions {
 #endif
 
   EnableToggle use_pool_offset_freelists = kDisabled;
+
+  // When enabled, a free which finds the lock held by another thread doesn't
+  // wait for it, but pushes the slot to a lock-free list instead, which the
+  // next thread to take the lock frees as a batch. This helps when threads
+  // free what others allocated, as with producer/consumer queues, and the
+  // frees don't go to the thread cache. Direct-mapped frees always lock.
+  EnableToggle delayed_free_list = kDisabled;
+
+  // When enabled, on platforms supporting the advice, super pages are
+  // committed whole, giving up their guard pages, so that a huge page can back
+  // each of them. They are advised to use huge pages once they are dense, as
+  // seen by PurgeMemory(). Purging then leaves them alone, since decommitting
+  // or discarding any of it would split the huge page up, until they become
+  // sparse. This trades memory for fewer TLB misses, and suits large heaps.
+  // Not compatible with memory tagging and thread isolation.
+  EnableToggle huge_pages = kDisabled;
 };
 
 constexpr PartitionOptions::PartitionOptions() = default;
@@ -276,6 +292,8 @@ struct PA_ALIGNAS(64) PA_COMPONENT_EXPORT(PARTITION_ALLOC) PartitionRoot {
 #endif
 
     bool use_pool_offset_freelists = false;
+    bool delayed_free_list = false;
+    bool huge_pages = false;
 
 #if PA_CONFIG(EXTRAS_REQUIRED)
     uint32_t extras_size = 0;
@@ -291,6 +309,9 @@ struct PA_ALIGNAS(64) PA_COMPONENT_EXPORT(PARTITION_ALLOC) PartitionRoot {
   // Not used on the fastest path (thread cache allocations), but on the fast
   // path of the central allocator.
   alignas(internal::kPartitionCachelineSize) internal::Lock lock_;
+  // Slots freed while another thread held the lock, which are still allocated
+  // as far as their slot spans know. See PartitionOptions::delayed_free_list.
+  std::atomic<uintptr_t> delayed_free_list_head{0};
 
   Bucket buckets[internal::kNumBuckets] = {};
   Bucket sentinel_bucket{};
@@ -521,6 +542,35 @@ struct PA_ALIGNAS(64) PA_COMPONENT_EXPORT(PARTITION_ALLOC) PartitionRoot {
     return AllocInternal<flags>(requested_size, slot_span_alignment, type_name);
   }
 
+  // A requested size resolved to its bucket, for hot allocations of a fixed
+  // size: AllocWithSizeClass() skips the bucket lookup of Alloc(). The lookup
+  // is redone if the bucket distribution changed since GetSizeClass().
+  struct SizeClass {
+    size_t requested_size = 0;
+    size_t raw_size = 0;
+    uint16_t bucket_index = 0;
+    BucketDistribution bucket_distribution = BucketDistribution::kNeutral;
+  };
+  PA_ALWAYS_INLINE SizeClass GetSizeClass(size_t requested_size) const;
+  template <AllocFlags flags = AllocFlags::kNone>
+  PA_NOINLINE PA_MALLOC_FN void* AllocWithSizeClass(
+      const SizeClass& size_class,
+      const char* type_name = nullptr);
+
+  // Allocates |count| objects of |requested_size| to |out_ptrs|, bypassing the
+  // thread cache and taking the lock once for all of them, e.g. to refill an
+  // object pool. Returns the number of objects allocated, which is less than
+  // |count| only with AllocFlags::kReturnNull.
+  template <AllocFlags flags = AllocFlags::kNone>
+  PA_NOINLINE size_t AllocBatch(size_t requested_size,
+                                size_t count,
+                                void** out_ptrs,
+                                const char* type_name = nullptr);
+  // Frees |count| objects of this partition as Free() does, except that those
+  // which don't fit in the thread cache are freed taking the lock once for all
+  // of them. Null pointers are skipped.
+  PA_NOINLINE void FreeBatch(void* const* objects, size_t count);
+
   template <AllocFlags alloc_flags = AllocFlags::kNone,
             FreeFlags free_flags = FreeFlags::kNone>
   PA_NOINLINE void* Realloc(void* ptr, size_t new_size, const char* type_name) {
@@ -551,6 +601,12 @@ struct PA_ALIGNAS(64) PA_COMPONENT_EXPORT(PARTITION_ALLOC) PartitionRoot {
   PA_ALWAYS_INLINE void FreeNoHooksImmediate(void* object,
                                              SlotSpanMetadata* slot_span,
                                              uintptr_t slot_start);
+  // The part of FreeNoHooksImmediate() before the slot is handed to the thread
+  // cache or the central allocator, which checks and clears the extras.
+  // Returns false if the slot can't be reused yet, as it still has references.
+  PA_ALWAYS_INLINE bool ReleaseSlotExtras(void* object,
+                                          SlotSpanMetadata* slot_span,
+                                          uintptr_t slot_start);
 
   PA_ALWAYS_INLINE size_t GetSlotUsableSize(const SlotSpanMetadata* slot_span) {
     return AdjustSizeForExtrasSubtract(slot_span->GetUtilizedSlotSize());
@@ -913,6 +969,9 @@ struct PA_ALIGNAS(64) PA_COMPONENT_EXPORT(PARTITION_ALLOC) PartitionRoot {
   static inline bool sort_smaller_slot_span_free_lists_ = true;
   static inline bool sort_active_slot_spans_ = false;
 
+  // What a slot on the delayed free list holds.
+  struct DelayedFreeListEntry;
+
   // Common path of Free() and FreeInUnknownRoot(). Returns
   // true if the caller should return immediately.
   template <FreeFlags flags>
@@ -971,6 +1030,21 @@ struct PA_ALIGNAS(64) PA_COMPONENT_EXPORT(PARTITION_ALLOC) PartitionRoot {
   PA_ALWAYS_INLINE PA_MALLOC_FN void* AllocInternalNoHooks(
       size_t requested_size,
       size_t slot_span_alignment);
+  // Same as |AllocInternalNoHooks()|, with the bucket already looked up.
+  template <AllocFlags flags>
+  PA_ALWAYS_INLINE PA_MALLOC_FN void* AllocFromBucketIndexNoHooks(
+      size_t requested_size,
+      size_t raw_size,
+      uint16_t bucket_index,
+      size_t slot_span_alignment);
+  // Initializes the extras of a newly allocated slot, and returns the object
+  // in it.
+  template <AllocFlags flags>
+  PA_ALWAYS_INLINE void* InitializeAllocatedSlot(uintptr_t slot_start,
+                                                 size_t requested_size,
+                                                 size_t usable_size,
+                                                 size_t slot_size,
+                                                 bool is_already_zeroed);
   // Allocates a memory slot, without initializing extras.
   //
   // - |flags| are as in Alloc().
@@ -1017,8 +1091,20 @@ struct PA_ALIGNAS(64) PA_COMPONENT_EXPORT(PARTITION_ALLOC) PartitionRoot {
       PA_EXCLUSIVE_LOCKS_REQUIRED(internal::PartitionRootLock(this));
   void DecommitEmptySlotSpans()
       PA_EXCLUSIVE_LOCKS_REQUIRED(internal::PartitionRootLock(this));
+  // Advises the dense super pages to use huge pages, and the sparse ones not
+  // to, decommitting the empty slot spans kept committed in the latter. See
+  // PartitionOptions::huge_pages.
+  void UpdateHugePagesAdvice()
+      PA_EXCLUSIVE_LOCKS_REQUIRED(internal::PartitionRootLock(this));
   PA_ALWAYS_INLINE void RawFreeLocked(uintptr_t slot_start)
       PA_EXCLUSIVE_LOCKS_REQUIRED(internal::PartitionRootLock(this));
+  // Pushes a slot to the delayed free list, without taking the lock.
+  PA_ALWAYS_INLINE void PushToDelayedFreeList(uintptr_t slot_start);
+  // Frees the slots on the delayed free list, if any.
+  PA_ALWAYS_INLINE void MaybeDrainDelayedFreeList()
+      PA_EXCLUSIVE_LOCKS_REQUIRED(internal::PartitionRootLock(this));
+  void DrainDelayedFreeList()
+      PA_EXCLUSIVE_LOCKS_REQUIRED(internal::PartitionRootLock(this));
   ThreadCache* MaybeInitThreadCache();
 
   // May return an invalid thread cache.
@@ -1252,6 +1338,8 @@ PartitionRoot::AllocFromBucket(Bucket* bucket,
                                bool* is_already_zeroed) {
   PA_DCHECK((slot_span_alignment >= internal::PartitionPageSize()) &&
             std::has_single_bit(slot_span_alignment));
+  // Before looking at the slot spans, since this may free slots in them.
+  MaybeDrainDelayedFreeList();
   SlotSpanMetadata* slot_span = bucket->active_slot_spans_head;
   // There always must be a slot span on the active list (could be a sentinel).
   PA_DCHECK(slot_span);
@@ -1559,6 +1647,15 @@ PA_ALWAYS_INLINE void PartitionRoot::FreeNoHooksImmediate(
   // 2. Deallocation
   //   a. Return to the thread cache if possible. If it succeeds, return.
   //   b. Otherwise, call the "raw" allocator <-- Locking
+  if (PA_LIKELY(ReleaseSlotExtras(object, slot_span, slot_start))) {
+    RawFreeWithThreadCache(slot_start, slot_span);
+  }
+}
+
+PA_ALWAYS_INLINE bool PartitionRoot::ReleaseSlotExtras(
+    void* object,
+    SlotSpanMetadata* slot_span,
+    uintptr_t slot_start) {
   PA_DCHECK(object);
   PA_DCHECK(slot_span);
   DCheckIsValidSlotSpan(slot_span);
@@ -1616,7 +1713,7 @@ PA_ALWAYS_INLINE void PartitionRoot::FreeNoHooksImmediate(
           slot_span->GetSlotSizeForBookkeeping(), std::memory_order_relaxed);
       cumulative_count_of_brp_quarantined_slots.fetch_add(
           1, std::memory_order_relaxed);
-      return;
+      return false;
     }
   }
 #endif  // PA_BUILDFLAG(ENABLE_BACKUP_REF_PTR_SUPPORT)
@@ -1635,7 +1732,7 @@ PA_ALWAYS_INLINE void PartitionRoot::FreeNoHooksImmediate(
   }
 #endif  // PA_CONFIG(ZERO_RANDOMLY_ON_FREE)
 
-  RawFreeWithThreadCache(slot_start, slot_span);
+  return true;
 }
 
 PA_ALWAYS_INLINE void PartitionRoot::FreeInSlotSpan(
@@ -1703,6 +1800,18 @@ PA_ALWAYS_INLINE void PartitionRoot::RawFree(uintptr_t slot_start,
   __asm__ __volatile__("" : : "r"(slot_start) : "memory");
 #endif
 
+  if (PA_UNLIKELY(settings.delayed_free_list) &&
+      !IsDirectMappedBucket(slot_span->bucket)) {
+    if (!internal::PartitionRootLock(this).Try()) {
+      PushToDelayedFreeList(slot_start);
+      return;
+    }
+    FreeInSlotSpan(slot_start, slot_span);
+    MaybeDrainDelayedFreeList();
+    internal::PartitionRootLock(this).Release();
+    return;
+  }
+
   ::partition_alloc::internal::ScopedGuard guard{
       internal::PartitionRootLock(this)};
   FreeInSlotSpan(slot_start, slot_span);
@@ -1770,6 +1879,35 @@ PA_ALWAYS_INLINE void PartitionRoot::RawFreeWithThreadCache(
   RawFree(slot_start, slot_span);
 }
 
+// The delayed free list is a stack, which is only ever pushed to, or emptied
+// all at once. There is no ABA problem, as no thread pops a single entry.
+// Each slot holds the next one, and its complement to detect a write after
+// free before the slots are reused.
+struct PartitionRoot::DelayedFreeListEntry {
+  uintptr_t next;
+  uintptr_t inverted_next;
+};
+
+PA_ALWAYS_INLINE void PartitionRoot::PushToDelayedFreeList(
+    uintptr_t slot_start) {
+  auto* entry = static_cast<DelayedFreeListEntry*>(
+      internal::SlotStartAddr2Ptr(slot_start));
+  uintptr_t head = delayed_free_list_head.load(std::memory_order_relaxed);
+  do {
+    entry->next = head;
+    entry->inverted_next = ~head;
+  } while (!delayed_free_list_head.compare_exchange_weak(
+      head, slot_start, std::memory_order_release,
+      std::memory_order_relaxed));
+}
+
+PA_ALWAYS_INLINE void PartitionRoot::MaybeDrainDelayedFreeList() {
+  if (PA_UNLIKELY(settings.delayed_free_list) &&
+      delayed_free_list_head.load(std::memory_order_relaxed)) {
+    DrainDelayedFreeList();
+  }
+}
+
 PA_ALWAYS_INLINE void PartitionRoot::RawFreeLocked(uintptr_t slot_start) {
   SlotSpanMetadata* slot_span = SlotSpanMetadata::FromSlotStart(slot_start);
   // Direct-mapped deallocation releases then re-acquires the lock. The caller
@@ -2139,17 +2277,26 @@ PA_ALWAYS_INLINE void* PartitionRoot::AllocInternalNoHooks(
   // which would result in an inconsistent state.
   uint16_t bucket_index =
       SizeToBucketIndex(raw_size, this->GetBucketDistribution());
+  return AllocFromBucketIndexNoHooks<flags>(requested_size, raw_size,
+                                            bucket_index, slot_span_alignment);
+}
+
+template <AllocFlags flags>
+PA_ALWAYS_INLINE void* PartitionRoot::AllocFromBucketIndexNoHooks(
+    size_t requested_size,
+    size_t raw_size,
+    uint16_t bucket_index,
+    size_t slot_span_alignment) {
   size_t usable_size;
   bool is_already_zeroed = false;
   uintptr_t slot_start = 0;
   size_t slot_size = 0;
 
 #if PA_BUILDFLAG(USE_STARSCAN)
-  const bool is_quarantine_enabled = IsQuarantineEnabled();
   // PCScan safepoint. Call before trying to allocate from cache.
   // TODO(bikineev): Change the condition to PA_LIKELY once PCScan is enabled by
   // default.
-  if (PA_UNLIKELY(is_quarantine_enabled)) {
+  if (PA_UNLIKELY(IsQuarantineEnabled())) {
     PCScan::JoinScanIfNeeded();
   }
 #endif  // PA_BUILDFLAG(USE_STARSCAN)
@@ -2206,6 +2353,18 @@ PA_ALWAYS_INLINE void* PartitionRoot::AllocInternalNoHooks(
     thread_cache->RecordAllocation(usable_size);
   }
 
+  return InitializeAllocatedSlot<flags>(slot_start, requested_size,
+                                        usable_size, slot_size,
+                                        is_already_zeroed);
+}
+
+template <AllocFlags flags>
+PA_ALWAYS_INLINE void* PartitionRoot::InitializeAllocatedSlot(
+    uintptr_t slot_start,
+    size_t requested_size,
+    size_t usable_size,
+    size_t slot_size,
+    bool is_already_zeroed) {
   // Layout inside the slot:
   //   |...object...|[empty]|[cookie]|[unused]|[metadata]|
   //   <----(a)----->
@@ -2292,7 +2451,7 @@ PA_ALWAYS_INLINE void* PartitionRoot::AllocInternalNoHooks(
 #if PA_BUILDFLAG(USE_STARSCAN)
   // TODO(bikineev): Change the condition to PA_LIKELY once PCScan is enabled by
   // default.
-  if (PA_UNLIKELY(is_quarantine_enabled)) {
+  if (PA_UNLIKELY(IsQuarantineEnabled())) {
     if (PA_LIKELY(internal::IsManagedByNormalBuckets(slot_start))) {
       // Mark the corresponding bits in the state bitmap as allocated.
       internal::StateBitmapFromAddr(slot_start)->Allocate(slot_start);
@@ -2316,6 +2475,110 @@ PA_ALWAYS_INLINE uintptr_t PartitionRoot::RawAlloc(Bucket* bucket,
                                 usable_size, slot_size, is_already_zeroed);
 }
 
+PA_ALWAYS_INLINE PartitionRoot::SizeClass PartitionRoot::GetSizeClass(
+    size_t requested_size) const {
+  SizeClass size_class;
+  size_class.requested_size = requested_size;
+  size_class.raw_size = AdjustSizeForExtrasAdd(requested_size);
+  PA_CHECK(size_class.raw_size >= requested_size);  // check for overflows
+  size_class.bucket_distribution = GetBucketDistribution();
+  size_class.bucket_index =
+      SizeToBucketIndex(size_class.raw_size, size_class.bucket_distribution);
+  return size_class;
+}
+
+template <AllocFlags flags>
+void* PartitionRoot::AllocWithSizeClass(const SizeClass& size_class,
+                                        const char* type_name) {
+  // The hooks and memory tools are given the requested size, as for Alloc().
+#if defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+  return AllocInline<flags>(size_class.requested_size, type_name);
+#else
+  if constexpr (!ContainsFlags(flags, AllocFlags::kNoHooks)) {
+    if (PA_UNLIKELY(PartitionAllocHooks::AreHooksEnabled())) {
+      return AllocInline<flags>(size_class.requested_size, type_name);
+    }
+  }
+  PA_DCHECK(initialized);
+  if (PA_UNLIKELY(size_class.bucket_distribution !=
+                  GetBucketDistribution())) {
+    return AllocInternalNoHooks<flags>(size_class.requested_size,
+                                       internal::PartitionPageSize());
+  }
+  return AllocFromBucketIndexNoHooks<flags>(
+      size_class.requested_size, size_class.raw_size, size_class.bucket_index,
+      internal::PartitionPageSize());
+#endif  // defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+}
+
+template <AllocFlags flags>
+size_t PartitionRoot::AllocBatch(size_t requested_size,
+                                 size_t count,
+                                 void** out_ptrs,
+                                 const char* type_name) {
+  const SizeClass size_class = GetSizeClass(requested_size);
+  bool allocate_one_by_one = size_class.raw_size > internal::kMaxBucketed;
+#if defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+  allocate_one_by_one = true;
+#endif
+  if constexpr (!ContainsFlags(flags, AllocFlags::kNoHooks)) {
+    allocate_one_by_one |= PartitionAllocHooks::AreHooksEnabled();
+  }
+  // The hooks are notified of each allocation separately, and direct-mapped
+  // allocations release the lock anyway.
+  if (allocate_one_by_one) {
+    for (size_t i = 0; i < count; ++i) {
+      out_ptrs[i] = AllocInline<flags>(requested_size, type_name);
+      if (!out_ptrs[i]) {
+        return i;
+      }
+    }
+    return count;
+  }
+
+#if PA_BUILDFLAG(USE_STARSCAN)
+  if (PA_UNLIKELY(IsQuarantineEnabled())) {
+    PCScan::JoinScanIfNeeded();
+  }
+#endif  // PA_BUILDFLAG(USE_STARSCAN)
+
+  // Only the slots are taken with the lock held. Their usable size is the same
+  // for all of them, as is their slot size.
+  size_t allocated = 0;
+  size_t usable_size = 0;
+  size_t slot_size = 0;
+  bool all_already_zeroed = true;
+  {
+    ::partition_alloc::internal::ScopedGuard guard{
+        internal::PartitionRootLock(this)};
+    for (; allocated < count; ++allocated) {
+      bool is_already_zeroed = false;
+      uintptr_t slot_start = AllocFromBucket<flags>(
+          buckets + size_class.bucket_index, size_class.raw_size,
+          internal::PartitionPageSize(), &usable_size, &slot_size,
+          &is_already_zeroed);
+      if (PA_UNLIKELY(!slot_start)) {
+        break;
+      }
+      all_already_zeroed &= is_already_zeroed;
+      out_ptrs[allocated] = reinterpret_cast<void*>(slot_start);
+    }
+  }
+
+  ThreadCache* thread_cache = GetThreadCache();
+  for (size_t i = 0; i < allocated; ++i) {
+    if (PA_LIKELY(ThreadCache::IsValid(thread_cache))) {
+      thread_cache->RecordAllocation(usable_size);
+    }
+    // Whether each slot was zeroed already is not kept, so zero-filled
+    // batches are only spared the memset() when all of them were.
+    out_ptrs[i] = InitializeAllocatedSlot<flags>(
+        reinterpret_cast<uintptr_t>(out_ptrs[i]), requested_size, usable_size,
+        slot_size, all_already_zeroed);
+  }
+  return allocated;
+}
+
 template <AllocFlags flags>
 PA_ALWAYS_INLINE void* PartitionRoot::AlignedAllocInline(
     size_t alignment,
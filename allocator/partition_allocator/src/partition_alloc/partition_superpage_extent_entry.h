@@ -27,6 +27,9 @@ struct PartitionSuperPageExtentEntry {
   PartitionSuperPageExtentEntry* next;
   uint16_t number_of_consecutive_super_pages;
   uint16_t number_of_nonempty_slot_spans;
+  // Whether this super page was advised to use a huge page, in which case its
+  // slot spans stay committed. See PartitionOptions::huge_pages.
+  bool uses_huge_pages;
 
   PA_ALWAYS_INLINE void IncrementNumberOfNonemptySlotSpans() {
     DCheckNumberOfPartitionPagesInSuperPagePayload(
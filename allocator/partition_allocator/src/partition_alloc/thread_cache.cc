@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <limits>
 
 #include "partition_alloc/build_config.h"
 #include "partition_alloc/internal_allocator.h"
@@ -78,6 +79,8 @@ uint8_t ThreadCache::global_limits_[ThreadCache::kBucketCount];
 uint16_t ThreadCache::largest_active_bucket_index_ =
     internal::BucketIndexLookup::GetIndex(ThreadCache::kDefaultSizeThreshold);
 
+std::atomic<bool> ThreadCache::adaptive_limits_enabled_{false};
+
 // static
 ThreadCacheRegistry& ThreadCacheRegistry::Instance() {
   return g_instance;
@@ -233,18 +236,31 @@ void ThreadCacheRegistry::SetThreadCacheMultiplier(float multiplier) {
 
     // Setting the global limit while locked, because we need |tcache->root_|.
     ThreadCache::SetGlobalLimits(tcache->root_, multiplier);
+    ResetLimitsLocked();
+  }
+}
 
-    while (tcache) {
-      PA_DCHECK(ThreadCache::IsValid(tcache));
-      for (int index = 0; index < ThreadCache::kBucketCount; index++) {
-        // This is racy, but we don't care if the limit is enforced later, and
-        // we really want to avoid atomic instructions on the fast path.
-        tcache->buckets_[index].limit.store(ThreadCache::global_limits_[index],
-                                            std::memory_order_relaxed);
-      }
+void ThreadCacheRegistry::SetAdaptiveLimitsEnabled(bool enabled) {
+  internal::ScopedGuard scoped_locker(GetLock());
+  ThreadCache::adaptive_limits_enabled_.store(enabled,
+                                              std::memory_order_relaxed);
+  if (!enabled) {
+    ResetLimitsLocked();
+  }
+}
 
-      tcache = tcache->next_;
+void ThreadCacheRegistry::ResetLimitsLocked() {
+  ThreadCache* tcache = list_head_;
+  while (tcache) {
+    PA_DCHECK(ThreadCache::IsValid(tcache));
+    for (int index = 0; index < ThreadCache::kBucketCount; index++) {
+      // This is racy, but we don't care if the limit is enforced later, and
+      // we really want to avoid atomic instructions on the fast path.
+      tcache->buckets_[index].limit.store(ThreadCache::global_limits_[index],
+                                          std::memory_order_relaxed);
     }
+
+    tcache = tcache->next_;
   }
 }
 
@@ -461,6 +477,22 @@ void ThreadCache::SetLargestCachedSize(size_t size) {
       largest_active_bucket_index_);
 }
 
+// static
+void ThreadCache::SetLargestCachedSizeForCurrentThread(size_t size) {
+  auto* tcache = Get();
+  if (!IsValid(tcache)) {
+    return;
+  }
+  if (size > ThreadCache::kLargeSizeThreshold) {
+    size = ThreadCache::kLargeSizeThreshold;
+  }
+  tcache->thread_largest_active_bucket_index_ =
+      size ? PartitionRoot::SizeToBucketIndex(
+                 size, PartitionRoot::BucketDistribution::kNeutral)
+           : 0;
+  PA_CHECK(tcache->thread_largest_active_bucket_index_ < kBucketCount);
+}
+
 // static
 ThreadCache* ThreadCache::Create(PartitionRoot* root) {
   PA_CHECK(root);
@@ -610,6 +642,7 @@ void ThreadCache::FillBucket(size_t bucket_index) {
   // tries to keep memory usage low. So clearing half of the bucket, and filling
   // a quarter of it are sensible defaults.
   PA_INCREMENT_COUNTER(stats_.batch_fill_count);
+  RecordBucketRefill(bucket_index);
 
   Bucket& bucket = buckets_[bucket_index];
   // Some buckets may have a limit lower than |kBatchFillRatio|, but we still
@@ -669,6 +702,47 @@ void ThreadCache::ClearBucket(Bucket& bucket, size_t limit) {
   ClearBucketHelper<true>(bucket, limit);
 }
 
+void ThreadCache::RecordBucketRefill(size_t bucket_index) {
+  Bucket& bucket = buckets_[bucket_index];
+  // Wraps around to 1 rather than 0, which means that the bucket was idle.
+  bucket.refill_count =
+      bucket.refill_count == std::numeric_limits<uint8_t>::max()
+          ? 1
+          : bucket.refill_count + 1;
+  if (!adaptive_limits_enabled_.load(std::memory_order_relaxed) ||
+      bucket.refill_count % kRefillsToGrowLimit) {
+    return;
+  }
+
+  // This bucket keeps going to the central allocator, cache more of it. The
+  // limit must stay below the maximum count, see |SetGlobalLimits()|.
+  constexpr size_t kMaxLimit = std::numeric_limits<uint8_t>::max() - 1;
+  const size_t max_limit = std::min(
+      kMaxLimit, global_limits_[bucket_index] * kMaxAdaptiveLimitFactor);
+  const size_t limit = bucket.limit.load(std::memory_order_relaxed);
+  if (limit < max_limit) {
+    bucket.limit.store(static_cast<uint8_t>(std::min(2 * limit, max_limit)),
+                       std::memory_order_relaxed);
+  }
+}
+
+void ThreadCache::LowerIdleBucketLimits() {
+  const bool adaptive_limits_enabled =
+      adaptive_limits_enabled_.load(std::memory_order_relaxed);
+  for (int index = 0; index < kBucketCount; index++) {
+    Bucket& bucket = buckets_[index];
+    if (adaptive_limits_enabled && !bucket.refill_count) {
+      const uint8_t limit = bucket.limit.load(std::memory_order_relaxed);
+      const uint8_t global_limit = global_limits_[index];
+      if (limit > global_limit) {
+        bucket.limit.store(std::max<uint8_t>(limit / 2, global_limit),
+                           std::memory_order_relaxed);
+      }
+    }
+    bucket.refill_count = 0;
+  }
+}
+
 template <bool crash_on_corruption>
 void ThreadCache::ClearBucketHelper(Bucket& bucket, size_t limit) {
   // Avoids acquiring the lock needlessly.
@@ -778,6 +852,11 @@ void ThreadCache::ResetForTesting() {
   Purge();
   PA_CHECK(cached_memory_ == 0u);
   should_purge_.store(false, std::memory_order_relaxed);
+
+  thread_largest_active_bucket_index_ = 0;
+  for (int index = 0; index < kBucketCount; index++) {
+    buckets_[index].refill_count = 0;
+  }
 }
 
 size_t ThreadCache::CachedMemory() const {
@@ -860,6 +939,7 @@ void ThreadCache::PurgeInternalHelper() {
   for (auto& bucket : buckets_) {
     ClearBucketHelper<crash_on_corruption>(bucket, 0);
   }
+  LowerIdleBucketLimits();
 }
 
 }  // namespace partition_alloc
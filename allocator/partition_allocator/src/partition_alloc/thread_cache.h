@@ -143,6 +143,13 @@ class PA_COMPONENT_EXPORT(PARTITION_ALLOC) ThreadCacheRegistry {
   // or below |ThreadCache::kDefaultMultiplier|.
   void SetThreadCacheMultiplier(float multiplier);
   void SetLargestActiveBucketIndex(uint16_t largest_active_bucket_index);
+  // Controls adaptive limits. When enabled, each thread cache raises the limit
+  // of the buckets it keeps refilling from (or clearing to) the central
+  // allocator, up to |ThreadCache::kMaxAdaptiveLimitFactor| times the global
+  // limit, and lowers the limit of buckets which were idle between two purges
+  // back towards the global one. Disabling resets all limits to the global
+  // ones.
+  void SetAdaptiveLimitsEnabled(bool enabled);
 
   // Controls the thread cache purging configuration.
   void SetPurgingConfiguration(
@@ -175,6 +182,9 @@ class PA_COMPONENT_EXPORT(PARTITION_ALLOC) ThreadCacheRegistry {
   friend class tools::ThreadCacheInspector;
   friend class tools::HeapDumper;
 
+  // Sets the limits of all thread caches to the global ones.
+  void ResetLimitsLocked() PA_EXCLUSIVE_LOCKS_REQUIRED(GetLock());
+
   // Not using base::Lock as the object's constructor must be constexpr.
   internal::Lock lock_;
   ThreadCache* list_head_ PA_GUARDED_BY(GetLock()) = nullptr;
@@ -247,6 +257,9 @@ class PA_COMPONENT_EXPORT(PARTITION_ALLOC) ThreadCache {
     uint8_t count = 0;
     std::atomic<uint8_t> limit{};  // Can be changed from another thread.
     uint16_t slot_size = 0;
+    // Round trips to the central allocator since the last purge, that is
+    // batched fills and batched deallocations. Non-zero on overflow.
+    uint8_t refill_count = 0;
 
     Bucket();
   };
@@ -355,6 +368,14 @@ class PA_COMPONENT_EXPORT(PARTITION_ALLOC) ThreadCache {
   // |kLargeSizeThreshold|.
   static void SetLargestCachedSize(size_t size);
 
+  // Sets the maximum size of allocations that may be cached by the thread
+  // cache of the current thread only, e.g. for a thread which allocates mostly
+  // mid-size objects. The larger of this and the size set by
+  // |SetLargestCachedSize()| applies. Also bounded by |kLargeSizeThreshold|,
+  // and 0 only applies the global size. Does nothing if the current thread has
+  // no thread cache.
+  static void SetLargestCachedSizeForCurrentThread(size_t size);
+
   // Cumulative stats about *all* allocations made on the `root_` partition on
   // this thread, that is not only the allocations serviced by the thread cache,
   // but all allocations, including large and direct-mapped ones. This should in
@@ -374,6 +395,12 @@ class PA_COMPONENT_EXPORT(PARTITION_ALLOC) ThreadCache {
   static constexpr float kDefaultMultiplier = 2.;
   static constexpr uint8_t kSmallBucketBaseCount = 64;
 
+  // With adaptive limits, a bucket's limit doubles every |kRefillsToGrowLimit|
+  // round trips to the central allocator, up to |kMaxAdaptiveLimitFactor|
+  // times its global limit.
+  static constexpr uint8_t kRefillsToGrowLimit = 4;
+  static constexpr size_t kMaxAdaptiveLimitFactor = 8;
+
   static constexpr size_t kDefaultSizeThreshold =
       ThreadCacheLimits::kDefaultSizeThreshold;
   static constexpr size_t kLargeSizeThreshold =
@@ -428,6 +455,13 @@ class PA_COMPONENT_EXPORT(PARTITION_ALLOC) ThreadCache {
   template <bool crash_on_corruption>
   void ClearBucketHelper(Bucket& bucket, size_t limit);
   void ClearBucket(Bucket& bucket, size_t limit);
+  // Records a round trip to the central allocator for the bucket at
+  // |bucket_index|, and raises its limit if adaptive limits are enabled and
+  // it is refilled often.
+  void RecordBucketRefill(size_t bucket_index);
+  // With adaptive limits, lowers the limits of the buckets which were not
+  // refilled since the last purge.
+  void LowerIdleBucketLimits();
   PA_ALWAYS_INLINE void PutInBucket(Bucket& bucket, uintptr_t slot_start);
   void ResetForTesting();
   // Releases the entire freelist starting at |head| to the root.
@@ -455,10 +489,14 @@ class PA_COMPONENT_EXPORT(PARTITION_ALLOC) ThreadCache {
   // TODO(lizeb): Investigate making this per-thread rather than static, to
   // improve locality, and open the door to per-thread settings.
   static uint16_t largest_active_bucket_index_;
+  static std::atomic<bool> adaptive_limits_enabled_;
 
   // These are at the beginning as they're accessed for each allocation.
   uint32_t cached_memory_ = 0;
   std::atomic<bool> should_purge_;
+  // Per-thread override of |largest_active_bucket_index_|, only checked when
+  // an allocation is too large for the global one.
+  uint16_t thread_largest_active_bucket_index_ = 0;
   ThreadCacheStats stats_;
   ThreadAllocStats thread_alloc_stats_;
 
@@ -492,7 +530,8 @@ PA_ALWAYS_INLINE bool ThreadCache::MaybePutInCache(uintptr_t slot_start,
   PA_REENTRANCY_GUARD(is_in_thread_cache_);
   PA_INCREMENT_COUNTER(stats_.cache_fill_count);
 
-  if (PA_UNLIKELY(bucket_index > largest_active_bucket_index_)) {
+  if (PA_UNLIKELY(bucket_index > largest_active_bucket_index_ &&
+                  bucket_index > thread_largest_active_bucket_index_)) {
     PA_INCREMENT_COUNTER(stats_.cache_fill_misses);
     return false;
   }
@@ -513,6 +552,7 @@ PA_ALWAYS_INLINE bool ThreadCache::MaybePutInCache(uintptr_t slot_start,
   // Batched deallocation, amortizing lock acquisitions.
   if (PA_UNLIKELY(bucket.count > limit)) {
     ClearBucket(bucket, limit / 2);
+    RecordBucketRefill(bucket_index);
   }
 
   if (PA_UNLIKELY(should_purge_.load(std::memory_order_relaxed))) {
@@ -532,7 +572,8 @@ PA_ALWAYS_INLINE uintptr_t ThreadCache::GetFromCache(size_t bucket_index,
   PA_REENTRANCY_GUARD(is_in_thread_cache_);
   PA_INCREMENT_COUNTER(stats_.alloc_count);
   // Only handle "small" allocations.
-  if (PA_UNLIKELY(bucket_index > largest_active_bucket_index_)) {
+  if (PA_UNLIKELY(bucket_index > largest_active_bucket_index_ &&
+                  bucket_index > thread_largest_active_bucket_index_)) {
     PA_INCREMENT_COUNTER(stats_.alloc_miss_too_large);
     PA_INCREMENT_COUNTER(stats_.alloc_misses);
     return 0;
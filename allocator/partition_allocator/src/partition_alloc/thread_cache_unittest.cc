@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <limits>
 #include <vector>
 
 #include "partition_alloc/build_config.h"
@@ -111,6 +112,7 @@ class PartitionAllocThreadCacheTest
 
   ~PartitionAllocThreadCacheTest() override {
     ThreadCache::SetLargestCachedSize(ThreadCache::kDefaultSizeThreshold);
+    ThreadCacheRegistry::Instance().SetAdaptiveLimitsEnabled(false);
 
     // Cleanup the global state so next test can recreate ThreadCache.
     if (ThreadCache::IsTombstone(ThreadCache::Get())) {
@@ -1166,6 +1168,88 @@ TEST_P(PartitionAllocThreadCacheTest, DynamicSizeThreshold) {
   EXPECT_EQ(3u, alloc_miss_too_large_counter.Delta());
 }
 
+TEST_P(PartitionAllocThreadCacheTest, PerThreadSizeThreshold) {
+  auto* tcache = root()->thread_cache_for_testing();
+  DeltaCounter alloc_miss_too_large_counter{
+      tcache->stats_for_testing().alloc_miss_too_large};
+  constexpr size_t kMidSize = 4 * ThreadCache::kDefaultSizeThreshold;
+
+  ThreadCache::SetLargestCachedSize(ThreadCache::kDefaultSizeThreshold);
+  FillThreadCacheAndReturnIndex(kMidSize);
+  EXPECT_EQ(1u, alloc_miss_too_large_counter.Delta());
+
+  // Raised for this thread only.
+  ThreadCache::SetLargestCachedSizeForCurrentThread(kMidSize);
+  size_t index = FillThreadCacheAndReturnIndex(kMidSize);
+  EXPECT_EQ(1u, alloc_miss_too_large_counter.Delta());
+  EXPECT_GT(tcache->bucket_count_for_testing(index), 0u);
+  // Still bounded.
+  FillThreadCacheAndReturnIndex(2 * kMidSize);
+  EXPECT_EQ(2u, alloc_miss_too_large_counter.Delta());
+
+  // The global threshold still applies when it is larger.
+  ThreadCache::SetLargestCachedSize(ThreadCache::kLargeSizeThreshold);
+  FillThreadCacheAndReturnIndex(2 * kMidSize);
+  EXPECT_EQ(2u, alloc_miss_too_large_counter.Delta());
+
+  // Reset.
+  ThreadCache::SetLargestCachedSize(ThreadCache::kDefaultSizeThreshold);
+  ThreadCache::SetLargestCachedSizeForCurrentThread(0);
+  FillThreadCacheAndReturnIndex(kMidSize);
+  EXPECT_EQ(3u, alloc_miss_too_large_counter.Delta());
+}
+
+TEST_P(PartitionAllocThreadCacheTest, AdaptiveLimits) {
+  auto* tcache = root()->thread_cache_for_testing();
+  size_t index = SizeToIndex(kMediumSize);
+  // Enough objects to go to the central allocator several times.
+  constexpr size_t kChurnCount = 4 * kDefaultCountForMediumBucket;
+  auto limit = [&]() -> size_t {
+    return tcache->bucket_for_testing(index).limit.load(
+        std::memory_order_relaxed);
+  };
+  EXPECT_EQ(kDefaultCountForMediumBucket, limit());
+
+  // Without adaptive limits, churn doesn't change the limit.
+  for (int i = 0; i < 10; i++) {
+    FillThreadCacheAndReturnIndex(kMediumSize, kChurnCount);
+  }
+  EXPECT_EQ(kDefaultCountForMediumBucket, limit());
+
+  // With them, the limit grows, within bounds.
+  ThreadCacheRegistry::Instance().SetAdaptiveLimitsEnabled(true);
+  for (int i = 0; i < 10; i++) {
+    FillThreadCacheAndReturnIndex(kMediumSize, kChurnCount);
+  }
+  EXPECT_GT(limit(), kDefaultCountForMediumBucket);
+  EXPECT_LE(limit(), std::min<size_t>(
+                         ThreadCache::kMaxAdaptiveLimitFactor *
+                             kDefaultCountForMediumBucket,
+                         std::numeric_limits<uint8_t>::max() - 1));
+  // And more objects are cached.
+  EXPECT_GT(tcache->bucket_count_for_testing(index),
+            kDefaultCountForMediumBucket);
+
+  // The first purge only resets the activity, the next ones lower the limit
+  // of the now idle bucket back to the global one.
+  tcache->Purge();
+  const size_t grown_limit = limit();
+  tcache->Purge();
+  EXPECT_LT(limit(), grown_limit);
+  for (int i = 0; i < 10; i++) {
+    tcache->Purge();
+  }
+  EXPECT_EQ(kDefaultCountForMediumBucket, limit());
+
+  // Disabling resets the limits.
+  for (int i = 0; i < 10; i++) {
+    FillThreadCacheAndReturnIndex(kMediumSize, kChurnCount);
+  }
+  EXPECT_GT(limit(), kDefaultCountForMediumBucket);
+  ThreadCacheRegistry::Instance().SetAdaptiveLimitsEnabled(false);
+  EXPECT_EQ(kDefaultCountForMediumBucket, limit());
+}
+
 // Disabled due to flakiness: crbug.com/1287811
 TEST_P(PartitionAllocThreadCacheTest, DISABLED_DynamicSizeThresholdPurge) {
   auto* tcache = root()->thread_cache_for_testing();
@@ -36,7 +36,8 @@ std::string HistogramConstructionParamsToString(HistogramBase* histogram) {
     case HISTOGRAM:
     case LINEAR_HISTOGRAM:
     case BOOLEAN_HISTOGRAM:
-    case CUSTOM_HISTOGRAM: {
+    case CUSTOM_HISTOGRAM:
+    case QUANTILE_SKETCH_HISTOGRAM: {
       Histogram* hist = static_cast<Histogram*>(histogram);
       params_str += StringPrintf("/%d/%d/%" PRIuS, hist->declared_min(),
                                  hist->declared_max(), hist->bucket_count());
@@ -5,8 +5,10 @@
 #ifndef BASE_BARRIER_CALLBACK_H_
 #define BASE_BARRIER_CALLBACK_H_
 
+#include <atomic>
 #include <concepts>
 #include <memory>
+#include <optional>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -53,6 +55,42 @@ class BarrierCallbackInfo {
   OnceCallback<void(DoneArg)> done_callback_;
 };
 
+template <typename T, typename DoneArg>
+class LockFreeBarrierCallbackInfo {
+ public:
+  LockFreeBarrierCallbackInfo(size_t num_callbacks,
+                              OnceCallback<void(DoneArg)> done_callback)
+      : num_callbacks_left_(num_callbacks),
+        results_(num_callbacks),
+        done_callback_(std::move(done_callback)) {}
+
+  void Run(T t) {
+    // Each call owns a distinct slot, so the result is stored without
+    // synchronizing with the other calls.
+    const size_t slot = next_slot_.fetch_add(1, std::memory_order_relaxed);
+    CHECK_LT(slot, results_.size());
+    results_[slot].emplace(std::move(t));
+
+    // Makes the result visible to the last call, which runs `done_callback_`.
+    if (num_callbacks_left_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    std::vector<std::remove_cvref_t<T>> results;
+    results.reserve(results_.size());
+    for (auto& result : results_) {
+      results.push_back(std::move(*result));
+    }
+    results_.clear();
+    std::move(done_callback_).Run(std::move(results));
+  }
+
+ private:
+  std::atomic<size_t> next_slot_{0};
+  std::atomic<size_t> num_callbacks_left_;
+  std::vector<std::optional<std::remove_cvref_t<T>>> results_;
+  OnceCallback<void(DoneArg)> done_callback_;
+};
+
 template <typename T>
 void ShouldNeverRun(T t) {
   CHECK(false);
@@ -113,6 +151,37 @@ RepeatingCallback<void(T)> BarrierCallback(
           num_callbacks, std::move(done_callback)));
 }
 
+// LockFreeBarrierCallback<T> is a BarrierCallback<T> for fan-in from many
+// threads at once. Instead of appending the `T`s to a vector under a lock,
+// each `Run()` reserves a slot of an array allocated up front with an atomic
+// increment, and the final `Run()` moves the `T`s into the vector passed to
+// `done_callback`. The `T`s are ordered by the order in which the calls
+// reserved their slot.
+//
+// This costs an allocation of `num_callbacks` optional `T`s and a move of
+// each `T`, so prefer BarrierCallback when the callbacks aren't run
+// concurrently.
+template <typename T,
+          typename RawArg = std::remove_cvref_t<T>,
+          typename DoneArg = std::vector<RawArg>,
+          template <typename>
+          class CallbackType>
+  requires(std::same_as<std::vector<RawArg>, std::remove_cvref_t<DoneArg>> &&
+           IsBaseCallback<CallbackType<void()>>)
+RepeatingCallback<void(T)> LockFreeBarrierCallback(
+    size_t num_callbacks,
+    CallbackType<void(DoneArg)> done_callback) {
+  if (num_callbacks == 0) {
+    std::move(done_callback).Run({});
+    return BindRepeating(&internal::ShouldNeverRun<T>);
+  }
+
+  return BindRepeating(
+      &internal::LockFreeBarrierCallbackInfo<T, DoneArg>::Run,
+      std::make_unique<internal::LockFreeBarrierCallbackInfo<T, DoneArg>>(
+          num_callbacks, std::move(done_callback)));
+}
+
 }  // namespace base
 
 #endif  // BASE_BARRIER_CALLBACK_H_
@@ -4,11 +4,17 @@
 
 #include "base/barrier_callback.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/raw_ref.h"
 #include "base/test/bind.h"
 #include "base/test/gtest_util.h"
+#include "base/threading/simple_thread.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -164,4 +170,95 @@ TEST(BarrierCallbackTest, SupportsReferenceTypes) {
   barrier_callback2.Run(ref);
 }
 
+TEST(LockFreeBarrierCallbackTest, RunsImmediatelyForZeroCallbacks) {
+  bool done = false;
+  auto barrier_callback = base::LockFreeBarrierCallback<int>(
+      0, base::BindLambdaForTesting([&done](std::vector<int> results) {
+        EXPECT_THAT(results, testing::IsEmpty());
+        done = true;
+      }));
+  EXPECT_TRUE(done);
+  EXPECT_CHECK_DEATH(barrier_callback.Run(3));
+}
+
+TEST(LockFreeBarrierCallbackTest, RunAfterNumCallbacks) {
+  bool done = false;
+  auto barrier_callback = base::LockFreeBarrierCallback<int>(
+      3, base::BindLambdaForTesting([&done](std::vector<int> results) {
+        EXPECT_THAT(results, testing::ElementsAre(1, 3, 2));
+        done = true;
+      }));
+  barrier_callback.Run(1);
+  barrier_callback.Run(3);
+  EXPECT_FALSE(done);
+  barrier_callback.Run(2);
+  EXPECT_TRUE(done);
+}
+
+TEST(LockFreeBarrierCallbackTest, SupportsMoveonlyAndReferenceTypes) {
+  auto move_only_callback =
+      base::LockFreeBarrierCallback<std::unique_ptr<int>>(
+          1, base::BindOnce([](std::vector<std::unique_ptr<int>> results) {
+            EXPECT_EQ(*results[0], 42);
+          }));
+  move_only_callback.Run(std::make_unique<int>(42));
+
+  const int value = 7;
+  auto reference_callback = base::LockFreeBarrierCallback<const int&>(
+      1, base::BindOnce([](const std::vector<int>& results) {
+        EXPECT_THAT(results, testing::ElementsAre(7));
+      }));
+  reference_callback.Run(value);
+}
+
+// Runs a barrier callback from several threads at once.
+TEST(LockFreeBarrierCallbackTest, ConcurrentRuns) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumCallbacksPerThread = 1000;
+
+  class RunBarrierDelegate : public base::DelegateSimpleThread::Delegate {
+   public:
+    RunBarrierDelegate(const base::RepeatingCallback<void(int)>& callback,
+                       int first_value)
+        : callback_(callback), first_value_(first_value) {}
+
+    void Run() override {
+      for (int i = 0; i < kNumCallbacksPerThread; ++i) {
+        callback_->Run(first_value_ + i);
+      }
+    }
+
+   private:
+    const raw_ref<const base::RepeatingCallback<void(int)>> callback_;
+    const int first_value_;
+  };
+
+  std::vector<int> results;
+  const auto barrier_callback = base::LockFreeBarrierCallback<int>(
+      kNumThreads * kNumCallbacksPerThread,
+      base::BindLambdaForTesting([&results](std::vector<int> values) {
+        results = std::move(values);
+      }));
+
+  std::vector<std::unique_ptr<RunBarrierDelegate>> delegates;
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    delegates.push_back(std::make_unique<RunBarrierDelegate>(
+        barrier_callback, i * kNumCallbacksPerThread));
+    threads.push_back(std::make_unique<base::DelegateSimpleThread>(
+        delegates.back().get(), "BarrierThread"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  ASSERT_EQ(results.size(),
+            static_cast<size_t>(kNumThreads * kNumCallbacksPerThread));
+  std::sort(results.begin(), results.end());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i], static_cast<int>(i));
+  }
+}
+
 }  // namespace
@@ -11,8 +11,10 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <string_view>
 
+#include "base/base64_internal.h"
 #include "base/check.h"
 #include "base/numerics/checked_math.h"
 #include "base/strings/string_util.h"
@@ -22,6 +24,8 @@ namespace base {
 
 namespace {
 
+constexpr char kPaddingChar = '=';
+
 ModpDecodePolicy GetModpPolicy(Base64DecodePolicy policy) {
   switch (policy) {
     case Base64DecodePolicy::kStrict:
@@ -31,6 +35,25 @@ ModpDecodePolicy GetModpPolicy(Base64DecodePolicy policy) {
   }
 }
 
+// Decodes `input` into `output`, which has room for modp_b64_decode_len()
+// bytes, and returns the size of the decoding or MODP_B64_ERROR. The vector
+// code decodes the bulk of the input, and modp_b64 the rest, with the padding.
+size_t DecodeToBuffer(std::string_view input,
+                      span<uint8_t> output,
+                      ModpDecodePolicy policy) {
+  const size_t prefix_size = internal::Base64DecodePrefix(
+      input, output, internal::Base64Alphabet::kStandard);
+  const size_t prefix_output_size = prefix_size / 4 * 3;
+  const std::string_view rest = input.substr(prefix_size);
+  const size_t rest_output_size = modp_b64_decode(
+      reinterpret_cast<char*>(output.data() + prefix_output_size), rest.data(),
+      rest.size(), policy);
+  if (rest_output_size == MODP_B64_ERROR) {
+    return MODP_B64_ERROR;
+  }
+  return prefix_output_size + rest_output_size;
+}
+
 }  // namespace
 
 std::string Base64Encode(span<const uint8_t> input) {
@@ -47,10 +70,17 @@ void Base64EncodeAppend(span<const uint8_t> input, std::string* output) {
   size_t prefix_len = output->size();
   output->resize(base::CheckAdd(encode_data_len, prefix_len).ValueOrDie());
 
+  // The vector code encodes the bulk of the input, and modp_b64 the rest, with
+  // the padding.
+  const span<char> encoded = span(*output).subspan(prefix_len);
+  const size_t vector_input_size = internal::Base64EncodePrefix(
+      input, encoded, internal::Base64Alphabet::kStandard);
+  const size_t vector_output_size = vector_input_size / 3 * 4;
   const size_t output_size = modp_b64_encode_data(
-      output->data() + prefix_len, reinterpret_cast<const char*>(input.data()),
-      input.size());
-  CHECK_EQ(output->size(), prefix_len + output_size);
+      encoded.data() + vector_output_size,
+      reinterpret_cast<const char*>(input.data() + vector_input_size),
+      input.size() - vector_input_size);
+  CHECK_EQ(output->size(), prefix_len + vector_output_size + output_size);
 }
 
 std::string Base64Encode(std::string_view input) {
@@ -64,9 +94,8 @@ bool Base64Decode(std::string_view input,
   temp.resize(modp_b64_decode_len(input.size()));
 
   // does not null terminate result since result is binary data!
-  size_t input_size = input.size();
-  size_t output_size = modp_b64_decode(&(temp[0]), input.data(), input_size,
-                                       GetModpPolicy(policy));
+  size_t output_size =
+      DecodeToBuffer(input, as_writable_byte_span(temp), GetModpPolicy(policy));
 
   // Forgiving mode requires whitespace to be stripped prior to decoding.
   // We don't do that in the above code to ensure that the "happy path" of
@@ -81,9 +110,9 @@ bool Base64Decode(std::string_view input,
     // on success.
     std::string input_without_whitespace;
     RemoveChars(input, kInfraAsciiWhitespace, &input_without_whitespace);
-    output_size =
-        modp_b64_decode(&(temp[0]), input_without_whitespace.data(),
-                        input_without_whitespace.size(), GetModpPolicy(policy));
+    output_size = DecodeToBuffer(input_without_whitespace,
+                                 as_writable_byte_span(temp),
+                                 GetModpPolicy(policy));
   }
 
   if (output_size == MODP_B64_ERROR)
@@ -97,9 +126,7 @@ bool Base64Decode(std::string_view input,
 std::optional<std::vector<uint8_t>> Base64Decode(std::string_view input) {
   std::vector<uint8_t> ret(modp_b64_decode_len(input.size()));
 
-  size_t input_size = input.size();
-  size_t output_size = modp_b64_decode(reinterpret_cast<char*>(ret.data()),
-                                       input.data(), input_size);
+  size_t output_size = DecodeToBuffer(input, ret, ModpDecodePolicy::kStrict);
   if (output_size == MODP_B64_ERROR)
     return std::nullopt;
 
@@ -107,4 +134,112 @@ std::optional<std::vector<uint8_t>> Base64Decode(std::string_view input) {
   return ret;
 }
 
+Base64Encoder::Base64Encoder() = default;
+
+Base64Encoder::~Base64Encoder() = default;
+
+void Base64Encoder::Append(span<const uint8_t> chunk, std::string* output) {
+  if (pending_size_) {
+    // Complete the group of three bytes of the previous chunks.
+    std::array<uint8_t, 3> group;
+    span(group).first(pending_size_).copy_from(
+        span(pending_).first(pending_size_));
+    const size_t taken = std::min(group.size() - pending_size_, chunk.size());
+    span(group).subspan(pending_size_, taken).copy_from(chunk.first(taken));
+    chunk = chunk.subspan(taken);
+    pending_size_ += taken;
+    if (pending_size_ < group.size()) {
+      span(pending_).first(pending_size_).copy_from(
+          span(group).first(pending_size_));
+      return;
+    }
+    Base64EncodeAppend(group, output);
+    pending_size_ = 0;
+  }
+
+  const size_t encodable_size = chunk.size() - chunk.size() % 3;
+  Base64EncodeAppend(chunk.first(encodable_size), output);
+  pending_size_ = chunk.size() - encodable_size;
+  span(pending_).first(pending_size_).copy_from(
+      chunk.subspan(encodable_size));
+}
+
+void Base64Encoder::Finish(std::string* output) {
+  Base64EncodeAppend(span(pending_).first(pending_size_), output);
+  pending_size_ = 0;
+}
+
+Base64Decoder::Base64Decoder() = default;
+
+Base64Decoder::~Base64Decoder() = default;
+
+bool Base64Decoder::Append(std::string_view chunk, std::string* output) {
+  if (failed_ || chunk.empty()) {
+    return !failed_;
+  }
+
+  if (pending_size_) {
+    // Complete the group of four characters of the previous chunks.
+    std::array<char, 4> group;
+    span(group).first(pending_size_).copy_from(
+        span(pending_).first(pending_size_));
+    const size_t taken = std::min(group.size() - pending_size_, chunk.size());
+    span(group).subspan(pending_size_, taken).copy_from(
+        span(chunk).first(taken));
+    chunk.remove_prefix(taken);
+    pending_size_ += taken;
+    if (pending_size_ < group.size()) {
+      span(pending_).first(pending_size_).copy_from(
+          span(group).first(pending_size_));
+      return true;
+    }
+    pending_size_ = 0;
+    if (!DecodeAppend(std::string_view(group.data(), group.size()), output)) {
+      return false;
+    }
+  }
+
+  const size_t decodable_size = chunk.size() - chunk.size() % 4;
+  if (!DecodeAppend(chunk.substr(0, decodable_size), output)) {
+    return false;
+  }
+  chunk.remove_prefix(decodable_size);
+  pending_size_ = chunk.size();
+  span(pending_).first(pending_size_).copy_from(span(chunk));
+  // Nothing may follow the padding.
+  failed_ = saw_padding_ && pending_size_;
+  return !failed_;
+}
+
+bool Base64Decoder::DecodeAppend(std::string_view input, std::string* output) {
+  if (input.empty()) {
+    return true;
+  }
+  if (saw_padding_) {
+    failed_ = true;
+    return false;
+  }
+  const size_t prefix_size = output->size();
+  output->resize(prefix_size + modp_b64_decode_len(input.size()));
+  const size_t output_size =
+      DecodeToBuffer(input, as_writable_byte_span(*output).subspan(prefix_size),
+                     ModpDecodePolicy::kStrict);
+  if (output_size == MODP_B64_ERROR) {
+    output->resize(prefix_size);
+    failed_ = true;
+    return false;
+  }
+  output->resize(prefix_size + output_size);
+  saw_padding_ = input.back() == kPaddingChar;
+  return true;
+}
+
+bool Base64Decoder::Finish() {
+  const bool success = !failed_ && !pending_size_;
+  pending_size_ = 0;
+  saw_padding_ = false;
+  failed_ = false;
+  return success;
+}
+
 }  // namespace base
@@ -5,8 +5,10 @@
 #ifndef BASE_BASE64_H_
 #define BASE_BASE64_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <array>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -52,6 +54,58 @@ BASE_EXPORT bool Base64Decode(
 BASE_EXPORT std::optional<std::vector<uint8_t>> Base64Decode(
     std::string_view input);
 
+// Encodes binary data in base64 as it arrives in chunks: the concatenation of
+// what Append() and Finish() append to their outputs is the Base64Encode() of
+// the concatenation of the chunks. Only up to two bytes are kept between
+// calls, so large inputs needn't be held in memory at once.
+class BASE_EXPORT Base64Encoder {
+ public:
+  Base64Encoder();
+  Base64Encoder(const Base64Encoder&) = delete;
+  Base64Encoder& operator=(const Base64Encoder&) = delete;
+  ~Base64Encoder();
+
+  // Appends the encoding of as much of `chunk` as can be encoded to `output`.
+  void Append(span<const uint8_t> chunk, std::string* output);
+
+  // Appends the encoding of the last bytes, with the padding, to `output`.
+  // The encoder can then be reused for another input.
+  void Finish(std::string* output);
+
+ private:
+  std::array<uint8_t, 2> pending_;
+  size_t pending_size_ = 0;
+};
+
+// Decodes base64 as it arrives in chunks, with the rules of
+// Base64DecodePolicy::kStrict applied to the concatenation of the chunks.
+class BASE_EXPORT Base64Decoder {
+ public:
+  Base64Decoder();
+  Base64Decoder(const Base64Decoder&) = delete;
+  Base64Decoder& operator=(const Base64Decoder&) = delete;
+  ~Base64Decoder();
+
+  // Appends the decoding of as much of `chunk` as can be decoded to `output`.
+  // Returns false if the input is invalid, after which the decoder keeps
+  // returning false.
+  bool Append(std::string_view chunk, std::string* output);
+
+  // Returns whether the input was valid and complete. The decoder can then be
+  // reused for another input.
+  bool Finish();
+
+ private:
+  // Decodes whole groups of four characters.
+  bool DecodeAppend(std::string_view input, std::string* output);
+
+  std::array<char, 3> pending_;
+  size_t pending_size_ = 0;
+  // Whether the input had padding, which must be the end.
+  bool saw_padding_ = false;
+  bool failed_ = false;
+};
+
 }  // namespace base
 
 #endif  // BASE_BASE64_H_
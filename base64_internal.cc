@@ -0,0 +1,222 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifdef UNSAFE_BUFFERS_BUILD
+// TODO(crbug.com/40284755): Remove this and spanify to fix the errors.
+#pragma allow_unsafe_buffers
+#endif
+
+#include "base/base64_internal.h"
+
+#include <array>
+
+#include "base/check_op.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include <immintrin.h>
+
+#include "base/cpu.h"
+#endif
+
+namespace base::internal {
+
+namespace {
+
+#if defined(ARCH_CPU_X86_64)
+
+// The AVX2 codecs follow Muła and Lemire, "Faster Base64 Encoding and
+// Decoding Using AVX2 Instructions" (2018): 24 bytes are spread over the 32
+// 6-bit fields of a vector, which are translated to characters with a lookup
+// on a small index, and the decoder does the converse, classifying the
+// characters from lookups on their nibbles.
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+bool HasAvx2() {
+  static const bool has_avx2 = CPU::GetInstanceNoAllocation().has_avx2();
+  return has_avx2;
+}
+
+AVX2_TARGET __m256i BroadcastTable(const std::array<int8_t, 16>& table) {
+  return _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data())));
+}
+
+// What to add to the 6-bit values to get their characters, indexed as
+// computed in EncodeAvx2(): 0 for A-Z, 1 for a-z, 2 to 11 for 0-9, and 12 and
+// 13 for the last two characters.
+constexpr std::array<int8_t, 16> kStandardEncodeOffsets = {
+    'A', 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 0, 0};
+constexpr std::array<int8_t, 16> kUrlSafeEncodeOffsets = {
+    'A', 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 0, 0};
+
+AVX2_TARGET size_t EncodeAvx2(span<const uint8_t> input,
+                              span<char> output,
+                              Base64Alphabet alphabet) {
+  const __m256i offsets = BroadcastTable(alphabet == Base64Alphabet::kStandard
+                                             ? kStandardEncodeOffsets
+                                             : kUrlSafeEncodeOffsets);
+  // Spreads the bytes abc of each group of three to the 32-bit lanes as bcab,
+  // so that each of the four 6-bit fields can be moved to its own byte with a
+  // multiplication.
+  const __m256i spread = _mm256_setr_epi8(
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,  //
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+  const uint8_t* src = input.data();
+  char* dest = output.data();
+  size_t i = 0;
+  // Each iteration reads 28 bytes, and encodes 24 of them to 32 characters.
+  for (; i + 28 <= input.size(); i += 24, dest += 32) {
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+    src += 24;
+    const __m256i bytes = _mm256_shuffle_epi8(
+        _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), spread);
+
+    // The fields 1 and 3 of each lane are shifted right with a high
+    // multiplication, and the fields 0 and 2 left with a low one.
+    const __m256i odd_fields = _mm256_mulhi_epu16(
+        _mm256_and_si256(bytes, _mm256_set1_epi32(0x0fc0fc00)),
+        _mm256_set1_epi32(0x04000040));
+    const __m256i even_fields = _mm256_mullo_epi16(
+        _mm256_and_si256(bytes, _mm256_set1_epi32(0x003f03f0)),
+        _mm256_set1_epi32(0x01000010));
+    const __m256i values = _mm256_or_si256(odd_fields, even_fields);
+
+    // 51 and below saturate to 0, which is then made 1 for 26 to 51.
+    __m256i index = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+    index = _mm256_sub_epi8(
+        index, _mm256_cmpgt_epi8(values, _mm256_set1_epi8(25)));
+    const __m256i chars =
+        _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, index));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), chars);
+  }
+  return i;
+}
+
+// A character is invalid if the entries of its low and high nibbles in these
+// tables share a bit. Each bit stands for a set of low nibbles which are
+// invalid after the high nibbles which have it; bit 0 is all of them.
+constexpr std::array<int8_t, 16> kStandardLowNibbleClasses = {
+    0x0b, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+    0x03, 0x03, 0x07, 0x15, 0x17, 0x17, 0x17, 0x15};
+constexpr std::array<int8_t, 16> kStandardHighNibbleClasses = {
+    0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x08, 0x10,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01};
+constexpr std::array<int8_t, 16> kUrlSafeLowNibbleClasses = {
+    0x0b, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+    0x03, 0x03, 0x07, 0x37, 0x37, 0x35, 0x37, 0x27};
+constexpr std::array<int8_t, 16> kUrlSafeHighNibbleClasses = {
+    0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x08, 0x20,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01};
+
+// What to add to the valid characters to get their values, by high nibble;
+// index 1 is for '/', and the URL-safe '_' is handled separately.
+constexpr std::array<int8_t, 16> kStandardDecodeOffsets = {
+    0, 63 - '/', 62 - '+', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a',
+    0, 0,        0,        0,        0,    0,    0,        0};
+constexpr std::array<int8_t, 16> kUrlSafeDecodeOffsets = {
+    0, 0, 62 - '-', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a',
+    0, 0, 0,        0,        0,    0,    0,        0};
+
+template <Base64Alphabet alphabet>
+AVX2_TARGET size_t DecodeAvx2(std::string_view input, span<uint8_t> output) {
+  constexpr bool kStandard = alphabet == Base64Alphabet::kStandard;
+  const __m256i low_classes = BroadcastTable(
+      kStandard ? kStandardLowNibbleClasses : kUrlSafeLowNibbleClasses);
+  const __m256i high_classes = BroadcastTable(
+      kStandard ? kStandardHighNibbleClasses : kUrlSafeHighNibbleClasses);
+  const __m256i offsets = BroadcastTable(kStandard ? kStandardDecodeOffsets
+                                                   : kUrlSafeDecodeOffsets);
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+  // Gathers the three bytes of each 32-bit lane, most significant first.
+  const __m256i gather = _mm256_setr_epi8(
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,  //
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+  const char* src = input.data();
+  uint8_t* dest = output.data();
+  size_t i = 0;
+  for (; i + 32 <= input.size(); i += 32, src += 32, dest += 24) {
+    const __m256i chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const __m256i high_nibbles =
+        _mm256_and_si256(_mm256_srli_epi32(chars, 4), nibble_mask);
+    const __m256i low_nibbles = _mm256_and_si256(chars, nibble_mask);
+    if (!_mm256_testz_si256(_mm256_shuffle_epi8(low_classes, low_nibbles),
+                            _mm256_shuffle_epi8(high_classes, high_nibbles))) {
+      break;
+    }
+
+    __m256i values;
+    if constexpr (kStandard) {
+      const __m256i is_slash =
+          _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/'));
+      values = _mm256_add_epi8(
+          chars, _mm256_shuffle_epi8(offsets,
+                                     _mm256_add_epi8(high_nibbles, is_slash)));
+    } else {
+      const __m256i is_underscore =
+          _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_'));
+      const __m256i offset = _mm256_blendv_epi8(
+          _mm256_shuffle_epi8(offsets, high_nibbles),
+          _mm256_set1_epi8(63 - '_'), is_underscore);
+      values = _mm256_add_epi8(chars, offset);
+    }
+
+    // Merges the pairs of 6-bit values to 12 bits, then the pairs of those to
+    // the 24 bits of each lane.
+    const __m256i pairs =
+        _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    const __m256i lanes =
+        _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    const __m256i bytes = _mm256_permutevar8x32_epi32(
+        _mm256_shuffle_epi8(lanes, gather),
+        _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm256_castsi256_si128(bytes));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + 16),
+                     _mm256_extracti128_si256(bytes, 1));
+  }
+  return i;
+}
+
+#undef AVX2_TARGET
+
+#endif  // defined(ARCH_CPU_X86_64)
+
+}  // namespace
+
+size_t Base64EncodePrefix(span<const uint8_t> input,
+                          span<char> output,
+                          Base64Alphabet alphabet) {
+  DCHECK_GE(output.size() / 4, (input.size() + 2) / 3);
+#if defined(ARCH_CPU_X86_64)
+  if (HasAvx2()) {
+    return EncodeAvx2(input, output, alphabet);
+  }
+#endif
+  return 0;
+}
+
+size_t Base64DecodePrefix(std::string_view input,
+                          span<uint8_t> output,
+                          Base64Alphabet alphabet) {
+  DCHECK_GE(output.size(), input.size() / 4 * 3);
+#if defined(ARCH_CPU_X86_64)
+  if (HasAvx2()) {
+    return alphabet == Base64Alphabet::kStandard
+               ? DecodeAvx2<Base64Alphabet::kStandard>(input, output)
+               : DecodeAvx2<Base64Alphabet::kUrlSafe>(input, output);
+  }
+#endif
+  return 0;
+}
+
+}  // namespace base::internal
@@ -0,0 +1,47 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_BASE64_INTERNAL_H_
+#define BASE_BASE64_INTERNAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string_view>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+
+// Vector kernels for base64.cc and base64url.cc. They only handle the bulk of
+// the data, in whole blocks without padding, and leave the rest to the scalar
+// codec, so that the error handling and the padding rules stay in one place.
+// They use AVX2 on x86-64 CPUs which have it; elsewhere they handle nothing.
+
+namespace base::internal {
+
+enum class Base64Alphabet {
+  // RFC 4648 section 4: A-Z, a-z, 0-9, '+' and '/'.
+  kStandard,
+  // RFC 4648 section 5: A-Z, a-z, 0-9, '-' and '_'.
+  kUrlSafe,
+};
+
+// Encodes a prefix of `input` whose size is a multiple of 3 into `output`,
+// which must have room for the encoding of all of `input`. Returns the size of
+// the prefix; its encoding is the first 4/3 as many characters of `output`.
+BASE_EXPORT size_t Base64EncodePrefix(span<const uint8_t> input,
+                                      span<char> output,
+                                      Base64Alphabet alphabet);
+
+// Decodes the longest prefix of `input` which the vector code handles: whole
+// blocks of characters of `alphabet`, so neither padding nor whitespace. Its
+// decoding is written to `output`, which must have room for 3/4 as many bytes
+// as `input` has characters. Returns the size of the prefix, a multiple of 4.
+BASE_EXPORT size_t Base64DecodePrefix(std::string_view input,
+                                      span<uint8_t> output,
+                                      Base64Alphabet alphabet);
+
+}  // namespace base::internal
+
+#endif  // BASE_BASE64_INTERNAL_H_
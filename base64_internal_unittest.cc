@@ -0,0 +1,113 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/base64_internal.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base::internal {
+
+namespace {
+
+constexpr std::string_view kStandardChars =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr std::string_view kUrlSafeChars =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+std::string_view CharsOf(Base64Alphabet alphabet) {
+  return alphabet == Base64Alphabet::kStandard ? kStandardChars
+                                               : kUrlSafeChars;
+}
+
+// Encodes whole groups of three bytes one character at a time.
+std::string EncodeGroups(span<const uint8_t> input, Base64Alphabet alphabet) {
+  const std::string_view chars = CharsOf(alphabet);
+  std::string output;
+  for (size_t i = 0; i + 3 <= input.size(); i += 3) {
+    const uint32_t group = input[i] << 16 | input[i + 1] << 8 | input[i + 2];
+    for (int shift = 18; shift >= 0; shift -= 6) {
+      output.push_back(chars[(group >> shift) & 0x3f]);
+    }
+  }
+  return output;
+}
+
+class Base64InternalTest : public testing::TestWithParam<Base64Alphabet> {};
+
+}  // namespace
+
+TEST_P(Base64InternalTest, EncodePrefix) {
+  std::vector<uint8_t> data(300);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 37 + (i >> 3));
+  }
+  for (size_t size = 0; size <= data.size(); ++size) {
+    const span<const uint8_t> input = span(data).first(size);
+    std::string output((size + 2) / 3 * 4, '\0');
+    const size_t prefix_size = Base64EncodePrefix(input, output, GetParam());
+    ASSERT_EQ(0u, prefix_size % 3);
+    ASSERT_LE(prefix_size, size);
+    EXPECT_EQ(EncodeGroups(input.first(prefix_size), GetParam()),
+              output.substr(0, prefix_size / 3 * 4));
+
+    // The whole input decodes back.
+    const std::string encoded = EncodeGroups(input, GetParam());
+    std::vector<uint8_t> decoded(encoded.size() / 4 * 3);
+    const size_t decoded_size =
+        Base64DecodePrefix(encoded, decoded, GetParam());
+    ASSERT_EQ(0u, decoded_size % 4);
+    ASSERT_LE(decoded_size, encoded.size());
+    decoded.resize(decoded_size / 4 * 3);
+    EXPECT_EQ(std::vector<uint8_t>(input.begin(),
+                                   input.begin() + decoded.size()),
+              decoded);
+  }
+}
+
+// Checks that every byte is classified right at every position of a block.
+TEST_P(Base64InternalTest, DecodePrefixCharacters) {
+  const std::string_view chars = CharsOf(GetParam());
+  const std::string valid(128, 'A');
+
+  std::vector<uint8_t> decoded(valid.size() / 4 * 3);
+  const size_t valid_size = Base64DecodePrefix(valid, decoded, GetParam());
+  for (int c = 0; c < 256; ++c) {
+    const bool is_valid = chars.find(static_cast<char>(c)) != chars.npos;
+    for (size_t position = 0; position < 64; ++position) {
+      std::string input = valid;
+      input[position] = static_cast<char>(c);
+      const size_t prefix_size =
+          Base64DecodePrefix(input, decoded, GetParam());
+      if (is_valid) {
+        ASSERT_EQ(valid_size, prefix_size);
+        if (!prefix_size) {
+          continue;
+        }
+        // The value of the character is in its 6 bits of the output.
+        uint32_t value = 0;
+        for (size_t bit = position * 6; bit < position * 6 + 6; ++bit) {
+          value = value << 1 | ((decoded[bit / 8] >> (7 - bit % 8)) & 1);
+        }
+        EXPECT_EQ(chars.find(static_cast<char>(c)), value) << c;
+      } else {
+        // The vector code stops before the block with the character.
+        ASSERT_LE(prefix_size, position / 4 * 4) << c << " " << position;
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         Base64InternalTest,
+                         testing::Values(Base64Alphabet::kStandard,
+                                         Base64Alphabet::kUrlSafe));
+
+}  // namespace base::internal
@@ -0,0 +1,123 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/base64.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/base64url.h"
+#include "base/check.h"
+#include "base/debug/alias.h"
+#include "base/functional/function_ref.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricThroughput[] = "throughput";
+
+constexpr size_t kSizes[] = {64, 4096, 1 << 20, 16 << 20};
+
+// Runs `codec`, which processes `len` bytes of binary data, on at least 256 MB
+// in total, and reports its throughput in MB of binary data per second.
+void RunBase64PerfTest(const char* codec_name,
+                       size_t len,
+                       FunctionRef<void()> codec) {
+  perf_test::PerfResultReporter reporter(codec_name,
+                                         NumberToString(len) + "_bytes");
+  reporter.RegisterImportantMetric(kMetricThroughput, "MB/s");
+
+  const size_t num_runs = std::max<size_t>(1, (256u << 20) / len);
+  const TimeTicks start_time = TimeTicks::Now();
+  for (size_t i = 0; i < num_runs; ++i) {
+    codec();
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - start_time;
+
+  // Bytes per microsecond are MB/s.
+  reporter.AddResult(kMetricThroughput,
+                     len * num_runs / elapsed.InMicrosecondsF());
+}
+
+}  // namespace
+
+TEST(Base64PerfTest, Encode) {
+  for (size_t len : kSizes) {
+    const std::vector<uint8_t> data = RandBytesAsVector(len);
+    std::string encoded;
+    RunBase64PerfTest("Base64Encode", len, [&] {
+      encoded.clear();
+      Base64EncodeAppend(data, &encoded);
+    });
+    debug::Alias(&encoded);
+  }
+}
+
+TEST(Base64PerfTest, Decode) {
+  for (size_t len : kSizes) {
+    const std::string encoded = Base64Encode(RandBytesAsVector(len));
+    std::string decoded;
+    RunBase64PerfTest("Base64Decode", len, [&] {
+      CHECK(Base64Decode(encoded, &decoded));
+    });
+    debug::Alias(&decoded);
+  }
+}
+
+TEST(Base64PerfTest, StreamingDecode) {
+  // As the data would arrive from the network.
+  constexpr size_t kChunkSize = 16 * 1024 + 1;
+  for (size_t len : kSizes) {
+    const std::string encoded = Base64Encode(RandBytesAsVector(len));
+    std::string decoded;
+    RunBase64PerfTest("Base64Decoder", len, [&] {
+      decoded.clear();
+      Base64Decoder decoder;
+      for (size_t i = 0; i < encoded.size(); i += kChunkSize) {
+        CHECK(decoder.Append(std::string_view(encoded).substr(i, kChunkSize),
+                             &decoded));
+      }
+      CHECK(decoder.Finish());
+    });
+    debug::Alias(&decoded);
+  }
+}
+
+TEST(Base64PerfTest, UrlEncode) {
+  for (size_t len : kSizes) {
+    const std::vector<uint8_t> data = RandBytesAsVector(len);
+    std::string encoded;
+    RunBase64PerfTest("Base64UrlEncode", len, [&] {
+      Base64UrlEncode(data, Base64UrlEncodePolicy::OMIT_PADDING, &encoded);
+    });
+    debug::Alias(&encoded);
+  }
+}
+
+TEST(Base64PerfTest, UrlDecode) {
+  for (size_t len : kSizes) {
+    std::string encoded;
+    Base64UrlEncode(RandBytesAsVector(len), Base64UrlEncodePolicy::OMIT_PADDING,
+                    &encoded);
+    std::string decoded;
+    RunBase64PerfTest("Base64UrlDecode", len, [&] {
+      CHECK(Base64UrlDecode(encoded, Base64UrlDecodePolicy::IGNORE_PADDING,
+                            &decoded));
+    });
+    debug::Alias(&decoded);
+  }
+}
+
+}  // namespace base
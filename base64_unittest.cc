@@ -9,7 +9,11 @@
 
 #include "base/base64.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string_view>
+#include <vector>
 
 #include "base/numerics/checked_math.h"
 #include "base/strings/escape.h"
@@ -156,4 +160,139 @@ TEST(Base64Test, Overflow) {
   EXPECT_TRUE(modp_b64_encode_data_len(max_len).IsValid());
 }
 
+namespace {
+
+// Bytes which aren't just a repeated block, so that misplaced blocks show.
+std::vector<uint8_t> MakeData(size_t size) {
+  std::vector<uint8_t> data(size);
+  uint32_t state = 1;
+  for (uint8_t& byte : data) {
+    state = state * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(state >> 16);
+  }
+  return data;
+}
+
+}  // namespace
+
+// Large inputs go through the vector code, if the CPU has it.
+TEST(Base64Test, LargeInputs) {
+  for (size_t size : {0u, 1u, 27u, 28u, 29u, 47u, 48u, 49u, 100u, 1000u,
+                      65537u}) {
+    const std::vector<uint8_t> data = MakeData(size);
+    const std::string encoded = Base64Encode(data);
+
+    // Small inputs are encoded by the scalar code, so encoding groups of three
+    // bytes one at a time gives the expected encoding.
+    std::string expected;
+    for (size_t i = 0; i < size; i += 3) {
+      Base64EncodeAppend(span(data).subspan(i, std::min<size_t>(3, size - i)),
+                         &expected);
+    }
+    EXPECT_EQ(expected, encoded) << size;
+
+    EXPECT_THAT(Base64Decode(encoded),
+                testing::Optional(testing::ElementsAreArray(data)));
+    std::string decoded;
+    EXPECT_TRUE(Base64Decode(encoded, &decoded));
+    EXPECT_EQ(std::string(data.begin(), data.end()), decoded);
+  }
+}
+
+TEST(Base64Test, LargeInvalidInputs) {
+  const std::string encoded = Base64Encode(MakeData(300));
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    for (char c : {'*', '-', '\0', '\x80', '='}) {
+      std::string invalid = encoded;
+      invalid[i] = c;
+      if (c == '=' && i == encoded.size() - 1) {
+        continue;  // This is valid padding.
+      }
+      EXPECT_FALSE(Base64Decode(invalid)) << i << " " << c;
+    }
+  }
+
+  // Whitespace is only skipped in forgiving mode.
+  std::string with_whitespace = encoded;
+  with_whitespace.insert(100, " \n");
+  std::string decoded;
+  EXPECT_FALSE(Base64Decode(with_whitespace, &decoded));
+  EXPECT_TRUE(
+      Base64Decode(with_whitespace, &decoded, Base64DecodePolicy::kForgiving));
+  EXPECT_EQ(Base64Decode(encoded), std::vector<uint8_t>(decoded.begin(),
+                                                        decoded.end()));
+}
+
+TEST(Base64Test, Encoder) {
+  const std::vector<uint8_t> data = MakeData(1000);
+  const std::string expected = Base64Encode(data);
+  for (size_t chunk_size : {1u, 2u, 3u, 4u, 5u, 64u, 999u}) {
+    Base64Encoder encoder;
+    std::string encoded = "PREFIX";
+    for (size_t i = 0; i < data.size(); i += chunk_size) {
+      encoder.Append(
+          span(data).subspan(i, std::min(chunk_size, data.size() - i)),
+          &encoded);
+    }
+    encoder.Append({}, &encoded);
+    encoder.Finish(&encoded);
+    EXPECT_EQ("PREFIX" + expected, encoded) << chunk_size;
+
+    // The encoder can be reused.
+    encoded.clear();
+    encoder.Append(span(data).first(4u), &encoded);
+    encoder.Finish(&encoded);
+    EXPECT_EQ(Base64Encode(span(data).first(4u)), encoded);
+  }
+}
+
+TEST(Base64Test, Decoder) {
+  const std::vector<uint8_t> data = MakeData(1000);
+  const std::string encoded = Base64Encode(data);
+  for (size_t chunk_size : {1u, 2u, 3u, 4u, 5u, 64u, 999u}) {
+    Base64Decoder decoder;
+    std::string decoded;
+    for (size_t i = 0; i < encoded.size(); i += chunk_size) {
+      const std::string_view chunk =
+          std::string_view(encoded).substr(i, chunk_size);
+      EXPECT_TRUE(decoder.Append(chunk, &decoded));
+    }
+    EXPECT_TRUE(decoder.Finish());
+    EXPECT_EQ(std::string(data.begin(), data.end()), decoded) << chunk_size;
+  }
+}
+
+TEST(Base64Test, DecoderErrors) {
+  std::string decoded;
+  Base64Decoder decoder;
+
+  // Incomplete input.
+  EXPECT_TRUE(decoder.Append("aGVsbG8", &decoded));
+  EXPECT_FALSE(decoder.Finish());
+
+  // Data after the padding, in the same chunk or not.
+  decoded.clear();
+  EXPECT_FALSE(decoder.Append("aGk=aGk=", &decoded));
+  EXPECT_FALSE(decoder.Finish());
+  EXPECT_TRUE(decoder.Append("aG", &decoded));
+  EXPECT_TRUE(decoder.Append("k=", &decoded));
+  EXPECT_FALSE(decoder.Append("a", &decoded));
+  EXPECT_FALSE(decoder.Finish());
+
+  // Invalid characters, after which the decoder stays failed.
+  decoded.clear();
+  EXPECT_TRUE(decoder.Append("aGVs", &decoded));
+  EXPECT_FALSE(decoder.Append("b*8g", &decoded));
+  EXPECT_FALSE(decoder.Append("d29y", &decoded));
+  EXPECT_FALSE(decoder.Finish());
+  EXPECT_EQ("hel", decoded);
+
+  // Valid input after a reset.
+  decoded.clear();
+  EXPECT_TRUE(decoder.Append("aGk", &decoded));
+  EXPECT_TRUE(decoder.Append("=", &decoded));
+  EXPECT_TRUE(decoder.Finish());
+  EXPECT_EQ("hi", decoded);
+}
+
 }  // namespace base
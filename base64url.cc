@@ -6,9 +6,12 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <string_view>
 
 #include "base/base64.h"
+#include "base/base64_internal.h"
+#include "base/check_op.h"
 #include "base/numerics/safe_math.h"
 #include "base/strings/string_util.h"
 #include "third_party/modp_b64/modp_b64.h"
@@ -101,10 +104,19 @@ std::optional<StringViewOrString> Base64ToBase64URL(
 void Base64UrlEncode(span<const uint8_t> input,
                      Base64UrlEncodePolicy policy,
                      std::string* output) {
-  *output = Base64Encode(input);
-
-  ReplaceChars(*output, "+", "-", output);
-  ReplaceChars(*output, "/", "_", output);
+  // The vector code encodes the bulk of the input in the base64url alphabet
+  // directly; the rest is encoded in base64, then translated.
+  CHECK_LE(input.size(), MODP_B64_MAX_INPUT_LEN);
+  std::string encoded(modp_b64_encode_data_len(input.size()), '\0');
+  const size_t vector_input_size = internal::Base64EncodePrefix(
+      input, encoded, internal::Base64Alphabet::kUrlSafe);
+  const size_t vector_output_size = vector_input_size / 3 * 4;
+  encoded.resize(vector_output_size);
+  Base64EncodeAppend(input.subspan(vector_input_size), &encoded);
+  std::replace(encoded.begin() + vector_output_size, encoded.end(), '+', '-');
+  std::replace(encoded.begin() + vector_output_size, encoded.end(), '/', '_');
+  // `input` may reference `*output`, which is only written now.
+  output->swap(encoded);
 
   switch (policy) {
     case Base64UrlEncodePolicy::INCLUDE_PADDING:
@@ -131,23 +143,53 @@ void Base64UrlEncode(std::string_view input,
 bool Base64UrlDecode(std::string_view input,
                      Base64UrlDecodePolicy policy,
                      std::string* output) {
+  // The vector code decodes the bulk of the input directly, then the rest is
+  // converted to base64 and decoded. The policy only concerns the end of the
+  // input, and the characters outside of the alphabet stop the vector code.
+  std::string decoded(input.size() / 4 * 3, '\0');
+  const size_t prefix_size = internal::Base64DecodePrefix(
+      input, as_writable_byte_span(decoded),
+      internal::Base64Alphabet::kUrlSafe);
+  decoded.resize(prefix_size / 4 * 3);
+
   std::optional<StringViewOrString> base64_input =
-      Base64ToBase64URL(input, policy);
+      Base64ToBase64URL(input.substr(prefix_size), policy);
   if (!base64_input) {
     return false;
   }
-  return Base64Decode(base64_input->get(), output);
+  if (!prefix_size) {
+    return Base64Decode(base64_input->get(), output);
+  }
+  std::string rest;
+  if (!Base64Decode(base64_input->get(), &rest)) {
+    return false;
+  }
+  decoded.append(rest);
+  output->swap(decoded);
+  return true;
 }
 
 std::optional<std::vector<uint8_t>> Base64UrlDecode(
     std::string_view input,
     Base64UrlDecodePolicy policy) {
+  // As above.
+  std::vector<uint8_t> decoded(input.size() / 4 * 3);
+  const size_t prefix_size = internal::Base64DecodePrefix(
+      input, decoded, internal::Base64Alphabet::kUrlSafe);
+  decoded.resize(prefix_size / 4 * 3);
+
   std::optional<StringViewOrString> base64_input =
-      Base64ToBase64URL(input, policy);
+      Base64ToBase64URL(input.substr(prefix_size), policy);
   if (!base64_input) {
     return std::nullopt;
   }
-  return Base64Decode(base64_input->get());
+  std::optional<std::vector<uint8_t>> rest =
+      Base64Decode(base64_input->get());
+  if (!rest || !prefix_size) {
+    return rest;
+  }
+  decoded.insert(decoded.end(), rest->begin(), rest->end());
+  return decoded;
 }
 
 }  // namespace base
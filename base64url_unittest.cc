@@ -5,7 +5,9 @@
 #include "base/base64url.h"
 
 #include <string_view>
+#include <vector>
 
+#include "base/base64.h"
 #include "base/ranges/algorithm.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -184,6 +186,51 @@ TEST(Base64UrlTest, DecodeDisallowsPaddingOnly) {
       "====", Base64UrlDecodePolicy::IGNORE_PADDING, &output));
 }
 
+// Large inputs go through the vector code, if the CPU has it.
+TEST(Base64UrlTest, LargeInputs) {
+  for (size_t size : {29u, 48u, 100u, 1000u, 1001u}) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+      // Every 6-bit value occurs, so that '-' and '_' do.
+      data[i] = static_cast<uint8_t>(i * 251 + (i >> 2));
+    }
+
+    std::string expected = Base64Encode(data);
+    ranges::replace(expected, '+', '-');
+    ranges::replace(expected, '/', '_');
+    std::string encoded;
+    Base64UrlEncode(data, Base64UrlEncodePolicy::INCLUDE_PADDING, &encoded);
+    EXPECT_EQ(expected, encoded);
+
+    EXPECT_THAT(
+        Base64UrlDecode(encoded, Base64UrlDecodePolicy::REQUIRE_PADDING),
+        Optional(ElementsAreArray(data)));
+    std::string decoded;
+    EXPECT_TRUE(Base64UrlDecode(encoded, Base64UrlDecodePolicy::REQUIRE_PADDING,
+                                &decoded));
+    EXPECT_EQ(std::string(data.begin(), data.end()), decoded);
+
+    // The policies apply to the end of the input.
+    Base64UrlEncode(data, Base64UrlEncodePolicy::OMIT_PADDING, &encoded);
+    const bool has_padding = size % 3 != 0;
+    EXPECT_NE(has_padding, Base64UrlDecode(
+                               encoded, Base64UrlDecodePolicy::REQUIRE_PADDING)
+                               .has_value());
+    EXPECT_THAT(
+        Base64UrlDecode(encoded, Base64UrlDecodePolicy::DISALLOW_PADDING),
+        Optional(ElementsAreArray(data)));
+
+    // The base64 alphabet is rejected anywhere.
+    std::string invalid = encoded;
+    invalid[size / 2] = '+';
+    EXPECT_FALSE(
+        Base64UrlDecode(invalid, Base64UrlDecodePolicy::IGNORE_PADDING));
+    EXPECT_FALSE(Base64UrlDecode(invalid,
+                                 Base64UrlDecodePolicy::IGNORE_PADDING,
+                                 &decoded));
+  }
+}
+
 }  // namespace
 
 }  // namespace base
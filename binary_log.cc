@@ -0,0 +1,240 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/binary_log.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include "base/no_destructor.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+
+namespace logging {
+
+namespace {
+
+using internal::BinaryLogArgType;
+
+// Decodes the argument at the start of `args` and advances it. Returns nullopt
+// if the encoding is invalid, which can only happen if a record was
+// overwritten by two writers at once.
+std::optional<std::string> ReadArg(base::span<const uint8_t>& args) {
+  if (args.empty()) {
+    return std::nullopt;
+  }
+  const auto tag = static_cast<BinaryLogArgType>(args[0]);
+  args = args.subspan(1u);
+
+  auto read_word = [&args]() -> std::optional<uint64_t> {
+    if (args.size() < sizeof(uint64_t)) {
+      return std::nullopt;
+    }
+    uint64_t word;
+    memcpy(&word, args.data(), sizeof(word));
+    args = args.subspan(sizeof(word));
+    return word;
+  };
+
+  switch (tag) {
+    case BinaryLogArgType::kInt: {
+      const std::optional<uint64_t> word = read_word();
+      if (!word) {
+        return std::nullopt;
+      }
+      return base::NumberToString(static_cast<int64_t>(*word));
+    }
+    case BinaryLogArgType::kUint: {
+      const std::optional<uint64_t> word = read_word();
+      if (!word) {
+        return std::nullopt;
+      }
+      return base::NumberToString(*word);
+    }
+    case BinaryLogArgType::kDouble: {
+      const std::optional<uint64_t> word = read_word();
+      if (!word) {
+        return std::nullopt;
+      }
+      double value;
+      memcpy(&value, &*word, sizeof(value));
+      return base::NumberToString(value);
+    }
+    case BinaryLogArgType::kPointer: {
+      const std::optional<uint64_t> word = read_word();
+      if (!word) {
+        return std::nullopt;
+      }
+      return base::StringPrintf("0x%" PRIx64, *word);
+    }
+    case BinaryLogArgType::kBool: {
+      if (args.empty()) {
+        return std::nullopt;
+      }
+      const bool value = args[0] != 0;
+      args = args.subspan(1u);
+      return value ? "true" : "false";
+    }
+    case BinaryLogArgType::kString: {
+      if (args.empty() || args.size() - 1 < args[0]) {
+        return std::nullopt;
+      }
+      const size_t length = args[0];
+      std::string value(args.begin() + 1, args.begin() + 1 + length);
+      args = args.subspan(1 + length);
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+BinaryLogRecord::BinaryLogRecord() = default;
+BinaryLogRecord::BinaryLogRecord(BinaryLogRecord&&) = default;
+BinaryLogRecord& BinaryLogRecord::operator=(BinaryLogRecord&&) = default;
+BinaryLogRecord::~BinaryLogRecord() = default;
+
+std::string BinaryLogRecord::FormatMessage() const {
+  std::vector<std::string> substitutions;
+  base::span<const uint8_t> remaining_args(args);
+  while (substitutions.size() < 9) {
+    std::optional<std::string> arg = ReadArg(remaining_args);
+    if (!arg) {
+      break;
+    }
+    substitutions.push_back(std::move(*arg));
+  }
+  // The placeholders of the arguments which didn't fit in the record are
+  // replaced with nothing.
+  return base::ReplaceStringPlaceholders(site->format, substitutions,
+                                         /*offsets=*/nullptr);
+}
+
+namespace internal {
+
+void BinaryLogArgWriter::Append(std::string_view value) {
+  if (full_ || size_ + 2 > kCapacity) {
+    full_ = true;
+    return;
+  }
+  // Truncate the strings which don't fit, rather than dropping them.
+  const size_t length = std::min({value.size(), kCapacity - size_ - 2,
+                                  size_t{std::numeric_limits<uint8_t>::max()}});
+  buffer_[size_++] = static_cast<uint8_t>(BinaryLogArgType::kString);
+  buffer_[size_++] = static_cast<uint8_t>(length);
+  memcpy(&buffer_[size_], value.data(), length);
+  size_ += length;
+}
+
+void BinaryLogArgWriter::AppendTagged(BinaryLogArgType tag,
+                                      const void* payload,
+                                      size_t size) {
+  if (full_ || size_ + 1 + size > kCapacity) {
+    full_ = true;
+    return;
+  }
+  buffer_[size_++] = static_cast<uint8_t>(tag);
+  memcpy(&buffer_[size_], payload, size);
+  size_ += size;
+}
+
+}  // namespace internal
+
+BinaryLog::BinaryLog(size_t capacity)
+    : capacity_(std::bit_ceil(std::max(capacity, size_t{1}))),
+      slots_(new Slot[capacity_]) {}
+
+BinaryLog::~BinaryLog() = default;
+
+// static
+BinaryLog& BinaryLog::Get() {
+  // Leaked, so that BINARY_LOG() can be called during shutdown.
+  static base::NoDestructor<BinaryLog> binary_log;
+  return *binary_log;
+}
+
+void BinaryLog::WriteRecord(const BinaryLogSite& site,
+                            base::span<const uint8_t> args) {
+  const uint64_t sequence =
+      next_sequence_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[sequence & (capacity_ - 1)];
+
+  // An odd stamp tells readers the record is being written. The fence orders
+  // it before the stores of the record.
+  slot.stamp.store(sequence * 2 + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.site.store(reinterpret_cast<uintptr_t>(&site),
+                  std::memory_order_relaxed);
+  slot.timestamp.store(base::TimeTicks::Now().ToInternalValue(),
+                       std::memory_order_relaxed);
+  slot.thread_id_and_size.store(
+      (uint64_t{static_cast<uint32_t>(base::PlatformThread::CurrentId())}
+       << 32) |
+          args.size(),
+      std::memory_order_relaxed);
+  // The unused bytes of the last word are zero.
+  for (size_t i = 0; i * sizeof(uint64_t) < args.size(); ++i) {
+    uint64_t word = 0;
+    const base::span<const uint8_t> bytes = args.subspan(
+        i * sizeof(uint64_t),
+        std::min(sizeof(uint64_t), args.size() - i * sizeof(uint64_t)));
+    memcpy(&word, bytes.data(), bytes.size());
+    slot.args[i].store(word, std::memory_order_relaxed);
+  }
+
+  slot.stamp.store(sequence * 2 + 2, std::memory_order_release);
+}
+
+std::vector<BinaryLogRecord> BinaryLog::Snapshot() const {
+  const uint64_t end = next_sequence_.load(std::memory_order_acquire);
+  const uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+
+  std::vector<BinaryLogRecord> records;
+  records.reserve(end - begin);
+  for (uint64_t sequence = begin; sequence < end; ++sequence) {
+    const Slot& slot = slots_[sequence & (capacity_ - 1)];
+    const uint64_t stamp = slot.stamp.load(std::memory_order_acquire);
+    if (stamp != sequence * 2 + 2) {
+      // Still being written, or already overwritten.
+      continue;
+    }
+
+    BinaryLogRecord record;
+    record.site = reinterpret_cast<const BinaryLogSite*>(
+        static_cast<uintptr_t>(slot.site.load(std::memory_order_relaxed)));
+    record.timestamp = base::TimeTicks::FromInternalValue(
+        slot.timestamp.load(std::memory_order_relaxed));
+    const uint64_t thread_id_and_size =
+        slot.thread_id_and_size.load(std::memory_order_relaxed);
+    record.thread_id =
+        static_cast<base::PlatformThreadId>(thread_id_and_size >> 32);
+    const size_t size = std::min<size_t>(thread_id_and_size & 0xffffffff,
+                                         kArgWords * sizeof(uint64_t));
+    record.args.resize(kArgWords * sizeof(uint64_t));
+    for (size_t i = 0; i < kArgWords; ++i) {
+      const uint64_t word = slot.args[i].load(std::memory_order_relaxed);
+      memcpy(&record.args[i * sizeof(uint64_t)], &word, sizeof(word));
+    }
+    record.args.resize(size);
+
+    // The record is valid if it wasn't overwritten while it was read.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.stamp.load(std::memory_order_relaxed) != stamp) {
+      continue;
+    }
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+}  // namespace logging
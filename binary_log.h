@@ -0,0 +1,245 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_BINARY_LOG_H_
+#define BASE_BINARY_LOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/logging.h"
+#include "base/memory/raw_ptr.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+
+// A structured logging API for hot paths, where even an asynchronous LOG()
+// costs too much because the message is formatted by an ostream on the
+// calling thread. BINARY_LOG() instead records a pointer to its call site,
+// which holds the format string, and the raw values of its arguments in a
+// fixed-size ring buffer. Formatting is deferred to whoever reads the ring,
+// e.g. to dump the recent events into a crash report or a test failure:
+//
+//   BINARY_LOG(INFO, "Scheduled task $1 on worker $2", task_id, worker_name);
+//   BINARY_VLOG(2, "Queue $1 depth is $2", queue_name, depth);
+//
+//   for (const logging::BinaryLogRecord& record :
+//        logging::BinaryLog::Get().Snapshot()) {
+//     LOG(INFO) << record.site->file << ":" << record.site->line << " "
+//               << record.FormatMessage();
+//   }
+//
+// The format string uses the $1 to $9 placeholders of
+// base::ReplaceStringPlaceholders(). Arguments can be integers, enums, bools,
+// floating point numbers, pointers and strings. A record has room for about
+// 96 bytes of arguments: the arguments which don't fit, and the end of long
+// strings, are dropped.
+//
+// BINARY_LOG() is filtered like LOG(), by the minimum log level, and
+// BINARY_VLOG() like VLOG(), by --v and --vmodule. The records are not
+// written to the LOG() destinations, and BINARY_LOG(FATAL) doesn't crash. The
+// ring keeps the most recent records only.
+//
+// Writing a record takes an atomic increment and a few relaxed stores, with
+// no lock and no allocation, so BINARY_LOG() can be called from any thread.
+
+#define BINARY_LOG(severity, format, ...)                          \
+  BINARY_LOG_INTERNAL(::logging::LOGGING_##severity,               \
+                      ::logging::LOGGING_##severity >=             \
+                          ::logging::GetMinLogLevel(),             \
+                      format __VA_OPT__(, ) __VA_ARGS__)
+
+#define BINARY_VLOG(verbose_level, format, ...)                         \
+  BINARY_LOG_INTERNAL(-(verbose_level), VLOG_IS_ON(verbose_level), format \
+                      __VA_OPT__(, ) __VA_ARGS__)
+
+#define BINARY_LOG_INTERNAL(severity, condition, format, ...)             \
+  do {                                                                    \
+    static constexpr ::logging::BinaryLogSite kBinaryLogSite = {          \
+        __FILE__, __LINE__, severity, format};                            \
+    if (condition) {                                                      \
+      ::logging::BinaryLog::Get().Write(kBinaryLogSite __VA_OPT__(, )     \
+                                            __VA_ARGS__);                 \
+    }                                                                     \
+  } while (false)
+
+namespace logging {
+
+// The static description of a BINARY_LOG() call site.
+struct BinaryLogSite {
+  const char* file;
+  int line;
+  // A LogSeverity, or minus the verbose level for BINARY_VLOG().
+  int severity;
+  const char* format;
+};
+
+// A record read from a BinaryLog.
+struct BASE_EXPORT BinaryLogRecord {
+  BinaryLogRecord();
+  BinaryLogRecord(BinaryLogRecord&&);
+  BinaryLogRecord& operator=(BinaryLogRecord&&);
+  ~BinaryLogRecord();
+
+  // Replaces the placeholders of the format string of `site` with the
+  // arguments. The arguments which were dropped are replaced with nothing.
+  std::string FormatMessage() const;
+
+  raw_ptr<const BinaryLogSite> site = nullptr;
+  base::TimeTicks timestamp;
+  base::PlatformThreadId thread_id = base::kInvalidThreadId;
+  // The encoded arguments, see internal::BinaryLogArgWriter.
+  std::vector<uint8_t> args;
+};
+
+namespace internal {
+
+// The type tags of the encoded arguments. Each argument is a tag followed by
+// its payload: 8 bytes for numbers and pointers, 1 byte for bools, and a
+// 1-byte length followed by the bytes for strings.
+enum class BinaryLogArgType : uint8_t {
+  kInt = 1,
+  kUint,
+  kDouble,
+  kBool,
+  kPointer,
+  kString,
+};
+
+// Encodes the arguments of a record into a buffer on the stack.
+class BASE_EXPORT BinaryLogArgWriter {
+ public:
+  static constexpr size_t kCapacity = 96;
+
+  BinaryLogArgWriter() = default;
+  BinaryLogArgWriter(const BinaryLogArgWriter&) = delete;
+  BinaryLogArgWriter& operator=(const BinaryLogArgWriter&) = delete;
+
+  void Append(bool value) {
+    const uint8_t byte = value;
+    AppendTagged(BinaryLogArgType::kBool, &byte, sizeof(byte));
+  }
+  void Append(const char* value) { Append(std::string_view(value)); }
+  void Append(const void* value) {
+    const uint64_t address = reinterpret_cast<uintptr_t>(value);
+    AppendTagged(BinaryLogArgType::kPointer, &address, sizeof(address));
+  }
+  void Append(double value) {
+    AppendTagged(BinaryLogArgType::kDouble, &value, sizeof(value));
+  }
+  void Append(std::string_view value);
+  template <typename T>
+    requires(std::integral<T> && !std::same_as<T, bool>)
+  void Append(T value) {
+    if constexpr (std::is_signed_v<T>) {
+      const int64_t signed_value = value;
+      AppendTagged(BinaryLogArgType::kInt, &signed_value,
+                   sizeof(signed_value));
+    } else {
+      const uint64_t unsigned_value = value;
+      AppendTagged(BinaryLogArgType::kUint, &unsigned_value,
+                   sizeof(unsigned_value));
+    }
+  }
+  template <typename T>
+    requires(std::is_enum_v<T>)
+  void Append(T value) {
+    Append(static_cast<std::underlying_type_t<T>>(value));
+  }
+  template <typename T>
+    requires(std::floating_point<T> && !std::same_as<T, double>)
+  void Append(T value) {
+    Append(static_cast<double>(value));
+  }
+
+  base::span<const uint8_t> data() const {
+    return base::span(buffer_).first(size_);
+  }
+
+ private:
+  // Appends `tag` and `size` bytes of `payload`, or nothing if they don't fit.
+  void AppendTagged(BinaryLogArgType tag, const void* payload, size_t size);
+
+  alignas(uint64_t) std::array<uint8_t, kCapacity> buffer_;
+  size_t size_ = 0;
+  // Set when an argument didn't fit. The following ones are dropped too, so
+  // that they don't shift into the placeholder of the dropped one.
+  bool full_ = false;
+};
+
+}  // namespace internal
+
+// A ring buffer of BINARY_LOG() records. The process-wide instance, used by
+// the macros, is returned by Get(); tests can create their own.
+class BASE_EXPORT BinaryLog {
+ public:
+  // The number of records kept by the process-wide instance.
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  // `capacity` is rounded up to a power of 2.
+  explicit BinaryLog(size_t capacity = kDefaultCapacity);
+  BinaryLog(const BinaryLog&) = delete;
+  BinaryLog& operator=(const BinaryLog&) = delete;
+  ~BinaryLog();
+
+  static BinaryLog& Get();
+
+  template <typename... Args>
+  void Write(const BinaryLogSite& site, const Args&... args) {
+    static_assert(sizeof...(Args) <= 9,
+                  "The format string can refer to 9 arguments only");
+    internal::BinaryLogArgWriter writer;
+    (writer.Append(args), ...);
+    WriteRecord(site, writer.data());
+  }
+
+  // Returns the records in the ring, oldest first. The records which are
+  // overwritten or still being written while they are read are skipped. Can
+  // be called from any thread, concurrently with Write().
+  std::vector<BinaryLogRecord> Snapshot() const;
+
+  // Returns the number of records written since the creation of the ring,
+  // including the ones which were overwritten.
+  uint64_t num_records_written() const {
+    return next_sequence_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // A record is 16 words: the sequence stamp, the site, the timestamp, the
+  // thread id and arguments size, then the arguments.
+  static constexpr size_t kHeaderWords = 4;
+  static constexpr size_t kArgWords =
+      internal::BinaryLogArgWriter::kCapacity / sizeof(uint64_t);
+
+  // The words are atomics so that Snapshot() can read them while they are
+  // overwritten, like a seqlock: `stamp` is odd while the record is written.
+  struct Slot {
+    std::atomic<uint64_t> stamp{0};
+    std::atomic<uint64_t> site{0};
+    std::atomic<int64_t> timestamp{0};
+    std::atomic<uint64_t> thread_id_and_size{0};
+    std::array<std::atomic<uint64_t>, kArgWords> args = {};
+  };
+  static_assert(sizeof(Slot) == (kHeaderWords + kArgWords) * sizeof(uint64_t));
+
+  void WriteRecord(const BinaryLogSite& site, base::span<const uint8_t> args);
+
+  const size_t capacity_;
+  const std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> next_sequence_{0};
+};
+
+}  // namespace logging
+
+#endif  // BASE_BINARY_LOG_H_
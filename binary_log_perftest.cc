@@ -0,0 +1,58 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/binary_log.h"
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/logging.h"
+#include "base/test/scoped_logging_settings.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace logging {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "BinaryLog.";
+constexpr char kMetricTimePerRecord[] = "time_per_record";
+
+constexpr size_t kNumRecords = 100000;
+
+void ReportTimePerRecord(const std::string& story, base::TimeDelta elapsed) {
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricTimePerRecord, "ns");
+  reporter.AddResult(kMetricTimePerRecord,
+                     elapsed.InMicrosecondsF() * 1000 / kNumRecords);
+}
+
+}  // namespace
+
+// Compares the cost of recording a message with BINARY_LOG() and of
+// formatting the same message with LOG(), which is not written anywhere.
+TEST(BinaryLogPerfTest, WriteRecord) {
+  ScopedLoggingSettings scoped_logging_settings;
+  SetLogMessageHandler([](int severity, const char* file, int line,
+                          size_t message_start, const std::string& str) {
+    return true;
+  });
+  const std::string name = "worker";
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t i = 0; i < kNumRecords; ++i) {
+    BINARY_LOG(INFO, "Scheduled task $1 on $2", i, name);
+  }
+  ReportTimePerRecord("binary_log", base::TimeTicks::Now() - start);
+
+  start = base::TimeTicks::Now();
+  for (size_t i = 0; i < kNumRecords; ++i) {
+    LOG(INFO) << "Scheduled task " << i << " on " << name;
+  }
+  ReportTimePerRecord("log", base::TimeTicks::Now() - start);
+}
+
+}  // namespace logging
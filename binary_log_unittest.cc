@@ -0,0 +1,99 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/binary_log.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/test/scoped_logging_settings.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace logging {
+
+namespace {
+
+enum class TestEnum { kFirst, kSecond };
+
+constexpr BinaryLogSite kTestSite = {__FILE__, __LINE__, LOGGING_INFO,
+                                     "$1 $2 $3 $4 $5 $6"};
+
+// The format string of a BINARY_LOG() must be a constant expression.
+constexpr char kFormat[] = "BinaryLogTest.Macros $1";
+
+// Returns the formatted messages of the records of `binary_log` whose format
+// string is `format`.
+std::vector<std::string> FormatMessages(const BinaryLog& binary_log,
+                                        std::string_view format) {
+  std::vector<std::string> messages;
+  for (const BinaryLogRecord& record : binary_log.Snapshot()) {
+    if (record.site->format == format) {
+      messages.push_back(record.FormatMessage());
+    }
+  }
+  return messages;
+}
+
+}  // namespace
+
+TEST(BinaryLogTest, FormatArguments) {
+  BinaryLog binary_log(16);
+  const std::string string_arg = "string";
+  binary_log.Write(kTestSite, -42, uint64_t{42}, true, 0.5, string_arg,
+                   TestEnum::kSecond);
+
+  const std::vector<BinaryLogRecord> records = binary_log.Snapshot();
+  ASSERT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0].site, &kTestSite);
+  EXPECT_EQ(records[0].thread_id, base::PlatformThread::CurrentId());
+  EXPECT_FALSE(records[0].timestamp.is_null());
+  EXPECT_EQ(records[0].FormatMessage(), "-42 42 true 0.5 string 1");
+}
+
+TEST(BinaryLogTest, ArgumentsWhichDontFitAreDropped) {
+  BinaryLog binary_log(16);
+  const std::string long_string(200, 'a');
+  binary_log.Write(kTestSite, 1, long_string, 2);
+
+  const std::vector<BinaryLogRecord> records = binary_log.Snapshot();
+  ASSERT_EQ(records.size(), 1u);
+  // The string is truncated to fill the record, and the last argument is
+  // dropped.
+  const std::string message = records[0].FormatMessage();
+  EXPECT_EQ(message.substr(0, 2), "1 ");
+  EXPECT_LT(message.size(), long_string.size());
+  EXPECT_EQ(message.find('2'), std::string::npos);
+}
+
+TEST(BinaryLogTest, KeepsMostRecentRecords) {
+  BinaryLog binary_log(4);
+  for (int i = 0; i < 10; ++i) {
+    binary_log.Write(kTestSite, i);
+  }
+
+  EXPECT_EQ(binary_log.num_records_written(), 10u);
+  EXPECT_EQ(FormatMessages(binary_log, kTestSite.format),
+            std::vector<std::string>({"6     ", "7     ", "8     ", "9     "}));
+}
+
+TEST(BinaryLogTest, Macros) {
+  ScopedLoggingSettings scoped_logging_settings;
+  SetMinLogLevel(LOGGING_WARNING);
+
+  BINARY_LOG(INFO, kFormat, 1);
+  BINARY_LOG(WARNING, kFormat, 2);
+  BINARY_VLOG(1, kFormat, 3);
+  SetMinLogLevel(-1);
+  BINARY_VLOG(1, kFormat, 4);
+
+  EXPECT_EQ(FormatMessages(BinaryLog::Get(), kFormat),
+            std::vector<std::string>(
+                {"BinaryLogTest.Macros 2", "BinaryLogTest.Macros 4"}));
+}
+
+}  // namespace logging
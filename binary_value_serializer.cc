@@ -0,0 +1,719 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/binary_value_serializer.h"
+
+#include <utility>
+
+#include "base/bit_cast.h"
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/containers/span_reader.h"
+#include "base/json/json_common.h"
+#include "base/notreached.h"
+#include "base/numerics/byte_conversions.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/pickle.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+
+namespace base {
+
+namespace {
+
+// Bump this, and keep reading older versions, when changing the format.
+constexpr uint8_t kFormatVersion = 1;
+
+// Nesting is limited like in JSONReader and JSONWriter, so that anything
+// that can be serialized can also be deserialized.
+constexpr size_t kMaxDepth = internal::kAbsoluteMaxDepth;
+
+// These values are persisted. Do not renumber or reuse them.
+enum class Tag : uint8_t {
+  kNone = 0,
+  kFalse = 1,
+  kTrue = 2,
+  kInt = 3,
+  kDouble = 4,
+  kString = 5,
+  kBinary = 6,
+  kDict = 7,
+  kList = 8,
+  kMaxValue = kList,
+};
+
+// Encoder /////////////////////////////////////////////////////////////////////
+
+class Encoder {
+ public:
+  explicit Encoder(std::vector<uint8_t>* output) : output_(*output) {}
+
+  bool Encode(absl::monostate node, size_t depth) {
+    WriteTag(Tag::kNone);
+    return true;
+  }
+
+  bool Encode(bool node, size_t depth) {
+    WriteTag(node ? Tag::kTrue : Tag::kFalse);
+    return true;
+  }
+
+  bool Encode(int node, size_t depth) {
+    WriteTag(Tag::kInt);
+    // Zigzag encoding keeps small negative numbers small.
+    const uint32_t bits = static_cast<uint32_t>(node);
+    WriteVarint((bits << 1) ^ (node < 0 ? 0xFFFFFFFFu : 0u));
+    return true;
+  }
+
+  bool Encode(double node, size_t depth) {
+    WriteTag(Tag::kDouble);
+    WriteBytes(DoubleToLittleEndian(node));
+    return true;
+  }
+
+  bool Encode(std::string_view node, size_t depth) {
+    WriteTag(Tag::kString);
+    WriteString(node);
+    return true;
+  }
+
+  bool Encode(const Value::BlobStorage& node, size_t depth) {
+    WriteTag(Tag::kBinary);
+    WriteVarint(node.size());
+    WriteBytes(node);
+    return true;
+  }
+
+  bool Encode(const Value::Dict& node, size_t depth) {
+    if (depth >= kMaxDepth) {
+      return false;
+    }
+    WriteTag(Tag::kDict);
+    const size_t size_offset = BeginContainer(node.size());
+    for (const auto [key, value] : node) {
+      WriteString(key);
+      if (!EncodeChild(value, depth)) {
+        return false;
+      }
+    }
+    return EndContainer(size_offset);
+  }
+
+  bool Encode(const Value::List& node, size_t depth) {
+    if (depth >= kMaxDepth) {
+      return false;
+    }
+    WriteTag(Tag::kList);
+    const size_t size_offset = BeginContainer(node.size());
+    for (const Value& value : node) {
+      if (!EncodeChild(value, depth)) {
+        return false;
+      }
+    }
+    return EndContainer(size_offset);
+  }
+
+ private:
+  bool EncodeChild(const Value& value, size_t depth) {
+    return value.Visit([this, depth = depth + 1](const auto& member) {
+      return Encode(member, depth);
+    });
+  }
+
+  void WriteTag(Tag tag) { output_.push_back(static_cast<uint8_t>(tag)); }
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      output_.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    output_.push_back(static_cast<uint8_t>(value));
+  }
+
+  void WriteBytes(span<const uint8_t> bytes) {
+    output_.insert(output_.end(), bytes.begin(), bytes.end());
+  }
+
+  void WriteString(std::string_view string) {
+    WriteVarint(string.size());
+    WriteBytes(as_byte_span(string));
+  }
+
+  // Reserves space for the size of the container's encoding, which is only
+  // known once its contents have been written, and writes the element count.
+  // Returns the offset of the reserved space.
+  size_t BeginContainer(size_t count) {
+    const size_t size_offset = output_.size();
+    output_.resize(size_offset + sizeof(uint32_t));
+    WriteVarint(count);
+    return size_offset;
+  }
+
+  bool EndContainer(size_t size_offset) {
+    const size_t size = output_.size() - size_offset - sizeof(uint32_t);
+    if (!IsValueInRangeForNumericType<uint32_t>(size)) {
+      return false;
+    }
+    span(output_)
+        .subspan(size_offset)
+        .first<sizeof(uint32_t)>()
+        .copy_from(U32ToLittleEndian(static_cast<uint32_t>(size)));
+    return true;
+  }
+
+  std::vector<uint8_t>& output_;
+};
+
+// Decoder /////////////////////////////////////////////////////////////////////
+
+// Reads values from untrusted data. Every method returns false, or
+// std::nullopt, if the data is malformed.
+class Decoder {
+ public:
+  explicit Decoder(span<const uint8_t> data) : data_(data), reader_(data) {}
+
+  size_t offset() const { return reader_.num_read(); }
+  size_t remaining() const { return reader_.remaining(); }
+
+  bool ReadVersion() {
+    uint8_t version;
+    return reader_.ReadU8LittleEndian(version) && version == kFormatVersion;
+  }
+
+  // Checks the value at the current position, advancing past it.
+  bool Validate(size_t depth) {
+    Tag tag;
+    if (!ReadTag(&tag)) {
+      return false;
+    }
+    switch (tag) {
+      case Tag::kNone:
+      case Tag::kFalse:
+      case Tag::kTrue:
+        return true;
+      case Tag::kInt: {
+        int value;
+        return ReadInt(&value);
+      }
+      case Tag::kDouble:
+        return reader_.Skip(sizeof(double)).has_value();
+      case Tag::kString: {
+        std::string_view value;
+        return ReadString(&value);
+      }
+      case Tag::kBinary: {
+        span<const uint8_t> value;
+        return ReadBlob(&value);
+      }
+      case Tag::kDict: {
+        size_t count;
+        size_t end;
+        if (!ReadContainerHeader(depth, &count, &end)) {
+          return false;
+        }
+        std::optional<std::string_view> previous_key;
+        for (size_t i = 0; i < count; ++i) {
+          std::string_view key;
+          if (!ReadKey(previous_key, &key) || !Validate(depth + 1)) {
+            return false;
+          }
+          previous_key = key;
+        }
+        return offset() == end;
+      }
+      case Tag::kList: {
+        size_t count;
+        size_t end;
+        if (!ReadContainerHeader(depth, &count, &end)) {
+          return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+          if (!Validate(depth + 1)) {
+            return false;
+          }
+        }
+        return offset() == end;
+      }
+    }
+    NOTREACHED_NORETURN();
+  }
+
+  // Decodes the value at the current position, advancing past it.
+  std::optional<Value> Decode(size_t depth) {
+    Tag tag;
+    if (!ReadTag(&tag)) {
+      return std::nullopt;
+    }
+    switch (tag) {
+      case Tag::kNone:
+        return Value();
+      case Tag::kFalse:
+        return Value(false);
+      case Tag::kTrue:
+        return Value(true);
+      case Tag::kInt: {
+        int value;
+        if (!ReadInt(&value)) {
+          return std::nullopt;
+        }
+        return Value(value);
+      }
+      case Tag::kDouble: {
+        double value;
+        if (!ReadDouble(&value)) {
+          return std::nullopt;
+        }
+        return Value(value);
+      }
+      case Tag::kString: {
+        std::string_view value;
+        if (!ReadString(&value)) {
+          return std::nullopt;
+        }
+        return Value(value);
+      }
+      case Tag::kBinary: {
+        span<const uint8_t> value;
+        if (!ReadBlob(&value)) {
+          return std::nullopt;
+        }
+        return Value(value);
+      }
+      case Tag::kDict: {
+        size_t count;
+        size_t end;
+        if (!ReadContainerHeader(depth, &count, &end)) {
+          return std::nullopt;
+        }
+        std::vector<std::pair<std::string, Value>> entries;
+        entries.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+          std::string_view key;
+          if (!ReadKey(entries.empty() ? std::nullopt
+                                       : std::make_optional<std::string_view>(
+                                             entries.back().first),
+                       &key)) {
+            return std::nullopt;
+          }
+          std::optional<Value> value = Decode(depth + 1);
+          if (!value) {
+            return std::nullopt;
+          }
+          entries.emplace_back(key, std::move(*value));
+        }
+        if (offset() != end) {
+          return std::nullopt;
+        }
+        // The keys are already in order, so this does not sort them again.
+        return Value(Value::Dict(std::move(entries)));
+      }
+      case Tag::kList: {
+        size_t count;
+        size_t end;
+        if (!ReadContainerHeader(depth, &count, &end)) {
+          return std::nullopt;
+        }
+        Value::List list;
+        list.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+          std::optional<Value> value = Decode(depth + 1);
+          if (!value) {
+            return std::nullopt;
+          }
+          list.Append(std::move(*value));
+        }
+        if (offset() != end) {
+          return std::nullopt;
+        }
+        return Value(std::move(list));
+      }
+    }
+    NOTREACHED_NORETURN();
+  }
+
+  // Advances past the value at the current position, which must have been
+  // validated, and returns its encoding. Does not look inside containers.
+  span<const uint8_t> SkipValidated() {
+    const size_t start = offset();
+    Tag tag;
+    CHECK(ReadTag(&tag));
+    switch (tag) {
+      case Tag::kNone:
+      case Tag::kFalse:
+      case Tag::kTrue:
+        break;
+      case Tag::kInt: {
+        uint64_t value;
+        CHECK(ReadVarint(&value));
+        break;
+      }
+      case Tag::kDouble:
+        CHECK(reader_.Skip(sizeof(double)));
+        break;
+      case Tag::kString:
+      case Tag::kBinary: {
+        span<const uint8_t> value;
+        CHECK(ReadBlob(&value));
+        break;
+      }
+      case Tag::kDict:
+      case Tag::kList: {
+        uint32_t size;
+        CHECK(reader_.ReadU32LittleEndian(size));
+        CHECK(reader_.Skip(size));
+        break;
+      }
+    }
+    return data_.subspan(start, offset() - start);
+  }
+
+  bool ReadTag(Tag* tag) {
+    uint8_t byte;
+    if (!reader_.ReadU8LittleEndian(byte) ||
+        byte > static_cast<uint8_t>(Tag::kMaxValue)) {
+      return false;
+    }
+    *tag = static_cast<Tag>(byte);
+    return true;
+  }
+
+  bool ReadVarint(uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!reader_.ReadU8LittleEndian(byte)) {
+        return false;
+      }
+      // The tenth byte may only hold the top bit of a 64-bit value.
+      if (shift == 63 && byte > 1) {
+        return false;
+      }
+      *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadInt(int* value) {
+    uint64_t zigzag;
+    if (!ReadVarint(&zigzag) ||
+        !IsValueInRangeForNumericType<uint32_t>(zigzag)) {
+      return false;
+    }
+    const uint32_t bits = static_cast<uint32_t>(zigzag);
+    *value = static_cast<int>((bits >> 1) ^ (0u - (bits & 1)));
+    return true;
+  }
+
+  bool ReadDouble(double* value) {
+    uint64_t bits;
+    if (!reader_.ReadU64LittleEndian(bits)) {
+      return false;
+    }
+    *value = bit_cast<double>(bits);
+    return true;
+  }
+
+  bool ReadBlob(span<const uint8_t>* value) {
+    uint64_t size;
+    if (!ReadVarint(&size) || size > remaining()) {
+      return false;
+    }
+    *value = *reader_.Read(static_cast<size_t>(size));
+    return true;
+  }
+
+  bool ReadString(std::string_view* value) {
+    span<const uint8_t> bytes;
+    if (!ReadBlob(&bytes)) {
+      return false;
+    }
+    *value = as_string_view(bytes);
+    return IsStringUTF8AllowingNoncharacters(*value);
+  }
+
+  // Reads a dict key, which must sort after |previous_key| if there is one,
+  // so that keys are unique and in the same order as in a Value::Dict.
+  bool ReadKey(std::optional<std::string_view> previous_key,
+               std::string_view* key) {
+    return ReadString(key) && (!previous_key || *previous_key < *key);
+  }
+
+  // Reads the size and element count of a dict or list at |depth|, and sets
+  // |end| to the offset just past the container.
+  bool ReadContainerHeader(size_t depth, size_t* count, size_t* end) {
+    uint32_t size;
+    if (depth >= kMaxDepth || !reader_.ReadU32LittleEndian(size) ||
+        size > remaining()) {
+      return false;
+    }
+    *end = offset() + size;
+    uint64_t count64;
+    if (!ReadVarint(&count64) || count64 > *end - offset()) {
+      // Every element takes at least one byte.
+      return false;
+    }
+    *count = static_cast<size_t>(count64);
+    return true;
+  }
+
+ private:
+  const span<const uint8_t> data_;
+  SpanReader<const uint8_t> reader_;
+};
+
+}  // namespace
+
+// BinaryValueSerializer ///////////////////////////////////////////////////////
+
+BinaryValueSerializer::BinaryValueSerializer(std::vector<uint8_t>* output)
+    : output_(output) {
+  CHECK(output_);
+}
+
+BinaryValueSerializer::~BinaryValueSerializer() = default;
+
+bool BinaryValueSerializer::Serialize(ValueView root) {
+  output_->clear();
+  output_->push_back(kFormatVersion);
+  Encoder encoder(output_);
+  const bool result = root.Visit(
+      [&encoder](const auto& member) { return encoder.Encode(member, 0); });
+  if (!result) {
+    output_->clear();
+  }
+  return result;
+}
+
+// BinaryValueDeserializer /////////////////////////////////////////////////////
+
+BinaryValueDeserializer::BinaryValueDeserializer(span<const uint8_t> data)
+    : data_(data) {}
+
+BinaryValueDeserializer::~BinaryValueDeserializer() = default;
+
+std::unique_ptr<Value> BinaryValueDeserializer::Deserialize(
+    int* error_code,
+    std::string* error_message) {
+  Decoder decoder(data_);
+  std::optional<Value> value;
+  if (decoder.ReadVersion()) {
+    value = decoder.Decode(0);
+  }
+  if (!value || decoder.remaining() != 0) {
+    if (error_code) {
+      *error_code = kErrorCodeInvalidFormat;
+    }
+    if (error_message) {
+      *error_message =
+          StringPrintf("Invalid binary value at offset %zu.", decoder.offset());
+    }
+    return nullptr;
+  }
+  if (error_code) {
+    *error_code = kErrorCodeNoError;
+  }
+  return std::make_unique<Value>(std::move(*value));
+}
+
+// BinaryValueView /////////////////////////////////////////////////////////////
+
+// static
+std::optional<BinaryValueView> BinaryValueView::Create(
+    span<const uint8_t> data) {
+  Decoder decoder(data);
+  if (!decoder.ReadVersion() || !decoder.Validate(0) ||
+      decoder.remaining() != 0) {
+    return std::nullopt;
+  }
+  return BinaryValueView(data.subspan(1u));
+}
+
+BinaryValueView::BinaryValueView(span<const uint8_t> encoded)
+    : encoded_(encoded) {
+  DCHECK(!encoded_.empty());
+}
+
+BinaryValueView::BinaryValueView(const BinaryValueView&) = default;
+
+BinaryValueView& BinaryValueView::operator=(const BinaryValueView&) = default;
+
+BinaryValueView::~BinaryValueView() = default;
+
+Value::Type BinaryValueView::type() const {
+  switch (static_cast<Tag>(encoded_[0])) {
+    case Tag::kNone:
+      return Value::Type::NONE;
+    case Tag::kFalse:
+    case Tag::kTrue:
+      return Value::Type::BOOLEAN;
+    case Tag::kInt:
+      return Value::Type::INTEGER;
+    case Tag::kDouble:
+      return Value::Type::DOUBLE;
+    case Tag::kString:
+      return Value::Type::STRING;
+    case Tag::kBinary:
+      return Value::Type::BINARY;
+    case Tag::kDict:
+      return Value::Type::DICT;
+    case Tag::kList:
+      return Value::Type::LIST;
+  }
+  NOTREACHED_NORETURN();
+}
+
+std::optional<bool> BinaryValueView::GetIfBool() const {
+  switch (static_cast<Tag>(encoded_[0])) {
+    case Tag::kFalse:
+      return false;
+    case Tag::kTrue:
+      return true;
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<int> BinaryValueView::GetIfInt() const {
+  if (!is_int()) {
+    return std::nullopt;
+  }
+  Decoder decoder(encoded_.subspan(1u));
+  int value;
+  CHECK(decoder.ReadInt(&value));
+  return value;
+}
+
+std::optional<double> BinaryValueView::GetIfDouble() const {
+  if (std::optional<int> int_value = GetIfInt()) {
+    return *int_value;
+  }
+  if (!is_double()) {
+    return std::nullopt;
+  }
+  Decoder decoder(encoded_.subspan(1u));
+  double value;
+  CHECK(decoder.ReadDouble(&value));
+  return value;
+}
+
+std::optional<std::string_view> BinaryValueView::GetIfString() const {
+  if (!is_string()) {
+    return std::nullopt;
+  }
+  Decoder decoder(encoded_.subspan(1u));
+  span<const uint8_t> bytes;
+  CHECK(decoder.ReadBlob(&bytes));
+  return as_string_view(bytes);
+}
+
+std::optional<span<const uint8_t>> BinaryValueView::GetIfBlob() const {
+  if (!is_blob()) {
+    return std::nullopt;
+  }
+  Decoder decoder(encoded_.subspan(1u));
+  span<const uint8_t> bytes;
+  CHECK(decoder.ReadBlob(&bytes));
+  return bytes;
+}
+
+size_t BinaryValueView::size() const {
+  CHECK(is_dict() || is_list());
+  Decoder decoder(encoded_.subspan(1u));
+  size_t count;
+  size_t end;
+  CHECK(decoder.ReadContainerHeader(0, &count, &end));
+  return count;
+}
+
+std::optional<BinaryValueView> BinaryValueView::FindKey(
+    std::string_view key) const {
+  CHECK(is_dict());
+  Decoder decoder(encoded_.subspan(1u));
+  size_t count;
+  size_t end;
+  CHECK(decoder.ReadContainerHeader(0, &count, &end));
+  for (size_t i = 0; i < count; ++i) {
+    span<const uint8_t> entry_key;
+    CHECK(decoder.ReadBlob(&entry_key));
+    const std::string_view entry_key_string = as_string_view(entry_key);
+    if (entry_key_string == key) {
+      return BinaryValueView(decoder.SkipValidated());
+    }
+    if (entry_key_string > key) {
+      // Keys are sorted, so |key| is not present.
+      break;
+    }
+    decoder.SkipValidated();
+  }
+  return std::nullopt;
+}
+
+std::optional<BinaryValueView> BinaryValueView::GetListItem(
+    size_t index) const {
+  CHECK(is_list());
+  Decoder decoder(encoded_.subspan(1u));
+  size_t count;
+  size_t end;
+  CHECK(decoder.ReadContainerHeader(0, &count, &end));
+  if (index >= count) {
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < index; ++i) {
+    decoder.SkipValidated();
+  }
+  return BinaryValueView(decoder.SkipValidated());
+}
+
+void BinaryValueView::ForEach(
+    FunctionRef<void(std::string_view, const BinaryValueView&)> callback)
+    const {
+  CHECK(is_dict() || is_list());
+  Decoder decoder(encoded_.subspan(1u));
+  size_t count;
+  size_t end;
+  CHECK(decoder.ReadContainerHeader(0, &count, &end));
+  for (size_t i = 0; i < count; ++i) {
+    std::string_view key;
+    if (is_dict()) {
+      span<const uint8_t> key_bytes;
+      CHECK(decoder.ReadBlob(&key_bytes));
+      key = as_string_view(key_bytes);
+    }
+    callback(key, BinaryValueView(decoder.SkipValidated()));
+  }
+}
+
+Value BinaryValueView::ToValue() const {
+  Decoder decoder(encoded_);
+  std::optional<Value> value = decoder.Decode(0);
+  CHECK(value);
+  return std::move(*value);
+}
+
+// Pickle support //////////////////////////////////////////////////////////////
+
+void WriteValueToPickle(Pickle* pickle, ValueView value) {
+  std::vector<uint8_t> data;
+  CHECK(BinaryValueSerializer(&data).Serialize(value));
+  pickle->WriteData(data);
+}
+
+std::optional<Value> ReadValueFromPickle(PickleIterator* iter) {
+  std::optional<span<const uint8_t>> data = iter->ReadData();
+  if (!data) {
+    return std::nullopt;
+  }
+  std::unique_ptr<Value> value =
+      BinaryValueDeserializer(*data).Deserialize(nullptr, nullptr);
+  if (!value) {
+    return std::nullopt;
+  }
+  return std::move(*value);
+}
+
+}  // namespace base
@@ -0,0 +1,170 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_BINARY_VALUE_SERIALIZER_H_
+#define BASE_BINARY_VALUE_SERIALIZER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/functional/function_ref.h"
+#include "base/memory/raw_ptr.h"
+#include "base/values.h"
+
+namespace base {
+
+class Pickle;
+class PickleIterator;
+
+// A compact binary encoding for base::Value, for persisting Values or sending
+// them to another process without the cost of formatting and parsing JSON.
+// Unlike JSON, every Value type (including binary blobs) round-trips exactly.
+//
+// The encoding is a version byte followed by the root value. Each value is a
+// one-byte type tag followed by its payload:
+//   - none, false and true: no payload.
+//   - int: zigzag-encoded LEB128 varint.
+//   - double: 8 bytes, little-endian IEEE 754.
+//   - string and binary: varint byte length, then the bytes.
+//   - dict: 4-byte little-endian size of the rest of the dict's encoding,
+//     varint entry count, then for each entry the key (as a string payload)
+//     followed by the value.
+//   - list: like dict, with items instead of entries.
+// Because containers are length-prefixed, a reader can skip over any value
+// without decoding it; BinaryValueView uses this to look up keys in place.
+//
+// The format is versioned, so that data persisted by one version of Chrome
+// can be read by later ones.
+
+// Serializes a Value into the binary format, replacing the contents of the
+// vector passed to the constructor.
+class BASE_EXPORT BinaryValueSerializer : public ValueSerializer {
+ public:
+  // |output| must not be null and must outlive this object.
+  explicit BinaryValueSerializer(std::vector<uint8_t>* output);
+
+  BinaryValueSerializer(const BinaryValueSerializer&) = delete;
+  BinaryValueSerializer& operator=(const BinaryValueSerializer&) = delete;
+
+  ~BinaryValueSerializer() override;
+
+  // Returns false, leaving the output empty, if |root| is nested more deeply
+  // than JSONWriter allows.
+  bool Serialize(ValueView root) override;
+
+ private:
+  raw_ptr<std::vector<uint8_t>> output_;
+};
+
+// Decodes the binary format into a Value. The input is untrusted: malformed
+// data results in an error rather than a crash.
+class BASE_EXPORT BinaryValueDeserializer : public ValueDeserializer {
+ public:
+  // |data| must outlive this object.
+  explicit BinaryValueDeserializer(span<const uint8_t> data);
+
+  BinaryValueDeserializer(const BinaryValueDeserializer&) = delete;
+  BinaryValueDeserializer& operator=(const BinaryValueDeserializer&) = delete;
+
+  ~BinaryValueDeserializer() override;
+
+  // Returns null on failure, setting |error_code| to kErrorCodeInvalidFormat
+  // and |error_message| to a description including the offset of the error,
+  // if they are non-null.
+  std::unique_ptr<Value> Deserialize(int* error_code,
+                                     std::string* error_message) override;
+
+ private:
+  span<const uint8_t> data_;
+};
+
+// Read-only access to binary-encoded data without decoding it into a Value.
+// Looking up a key or list item only walks the bytes of the enclosing
+// container, skipping nested containers by their length prefix, and strings
+// are returned as views into the encoded data.
+//
+// Example:
+//   std::optional<BinaryValueView> root = BinaryValueView::Create(data);
+//   if (root && root->is_dict()) {
+//     std::optional<BinaryValueView> name = root->FindKey("name");
+//     if (name && name->is_string())
+//       UseName(*name->GetIfString());
+//   }
+class BASE_EXPORT BinaryValueView {
+ public:
+  // Validates the whole encoding, without allocating, and returns a view of
+  // its root value, or std::nullopt if |data| is malformed. |data| must
+  // outlive the returned view and any view or string obtained from it.
+  static std::optional<BinaryValueView> Create(span<const uint8_t> data);
+
+  BinaryValueView(const BinaryValueView&);
+  BinaryValueView& operator=(const BinaryValueView&);
+  ~BinaryValueView();
+
+  Value::Type type() const;
+
+  bool is_none() const { return type() == Value::Type::NONE; }
+  bool is_bool() const { return type() == Value::Type::BOOLEAN; }
+  bool is_int() const { return type() == Value::Type::INTEGER; }
+  bool is_double() const { return type() == Value::Type::DOUBLE; }
+  bool is_string() const { return type() == Value::Type::STRING; }
+  bool is_blob() const { return type() == Value::Type::BINARY; }
+  bool is_dict() const { return type() == Value::Type::DICT; }
+  bool is_list() const { return type() == Value::Type::LIST; }
+
+  // These have the same semantics as their base::Value equivalents; in
+  // particular GetIfDouble() accepts integers.
+  std::optional<bool> GetIfBool() const;
+  std::optional<int> GetIfInt() const;
+  std::optional<double> GetIfDouble() const;
+  std::optional<std::string_view> GetIfString() const;
+  std::optional<span<const uint8_t>> GetIfBlob() const;
+
+  // Returns the number of entries in a dict or items in a list. CHECKs that
+  // this is a dict or a list.
+  size_t size() const;
+
+  // Returns the value for |key|, or std::nullopt if there is none. CHECKs that
+  // this is a dict. Linear in the size of the dict's encoding, excluding
+  // nested containers.
+  std::optional<BinaryValueView> FindKey(std::string_view key) const;
+
+  // Returns the list item at |index|, or std::nullopt if it is out of range.
+  // CHECKs that this is a list. Linear in |index|.
+  std::optional<BinaryValueView> GetListItem(size_t index) const;
+
+  // Calls |callback| with each key and value of a dict, in key order, or with
+  // an empty key and each item of a list.
+  void ForEach(FunctionRef<void(std::string_view, const BinaryValueView&)>
+                   callback) const;
+
+  // Decodes this value into a base::Value.
+  Value ToValue() const;
+
+ private:
+  explicit BinaryValueView(span<const uint8_t> encoded);
+
+  // The encoding of this value, starting with its type tag.
+  span<const uint8_t> encoded_;
+};
+
+// Writes |value| to |pickle| in the binary format, as a single data field.
+// CHECKs that |value| is not nested too deeply to be serialized.
+BASE_EXPORT void WriteValueToPickle(Pickle* pickle, ValueView value);
+
+// Reads a value written by WriteValueToPickle(). Returns std::nullopt if the
+// data is missing or malformed.
+BASE_EXPORT std::optional<Value> ReadValueFromPickle(PickleIterator* iter);
+
+}  // namespace base
+
+#endif  // BASE_BINARY_VALUE_SERIALIZER_H_
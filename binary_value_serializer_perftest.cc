@@ -0,0 +1,126 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/binary_value_serializer.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixBinaryValue[] = "BinaryValue.";
+constexpr char kMetricJSONWriteTime[] = "json_write_time";
+constexpr char kMetricJSONReadTime[] = "json_read_time";
+constexpr char kMetricJSONSize[] = "json_size";
+constexpr char kMetricBinaryWriteTime[] = "binary_write_time";
+constexpr char kMetricBinaryReadTime[] = "binary_read_time";
+constexpr char kMetricBinarySize[] = "binary_size";
+constexpr char kMetricBinaryLookupTime[] = "binary_lookup_time";
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixBinaryValue, story_name);
+  reporter.RegisterImportantMetric(kMetricJSONWriteTime, "ms");
+  reporter.RegisterImportantMetric(kMetricJSONReadTime, "ms");
+  reporter.RegisterImportantMetric(kMetricJSONSize, "bytes");
+  reporter.RegisterImportantMetric(kMetricBinaryWriteTime, "ms");
+  reporter.RegisterImportantMetric(kMetricBinaryReadTime, "ms");
+  reporter.RegisterImportantMetric(kMetricBinarySize, "bytes");
+  reporter.RegisterImportantMetric(kMetricBinaryLookupTime, "ms");
+  return reporter;
+}
+
+// Generates the same data as json_perftest.cc, so that the results can be
+// compared: a tree-like dictionary with a size of O(breadth ** depth).
+Value::Dict GenerateLayeredDict(int breadth, int depth) {
+  Value::Dict root;
+  root.Set("Double", 3.141);
+  root.Set("Bool", true);
+  root.Set("Int", 42);
+  root.Set("String", "Foo");
+
+  Value::List list;
+  list.Append(2.718);
+  list.Append(false);
+  list.Append(123);
+  list.Append("Bar");
+  root.Set("List", std::move(list));
+  if (depth == 1) {
+    return root;
+  }
+
+  Value::Dict next = GenerateLayeredDict(breadth, depth - 1);
+  for (int i = 0; i < breadth; ++i) {
+    root.Set("Dict" + NumberToString(i), next.Clone());
+  }
+  return root;
+}
+
+}  // namespace
+
+class BinaryValueSerializerPerfTest : public testing::Test {
+ public:
+  void TestWriteAndRead(int breadth, int depth) {
+    const Value::Dict dict = GenerateLayeredDict(breadth, depth);
+    auto reporter = SetUpReporter("breadth_" + NumberToString(breadth) +
+                                  "_depth_" + NumberToString(depth));
+
+    std::string json;
+    TimeTicks start = TimeTicks::Now();
+    JSONWriter::Write(dict, &json);
+    reporter.AddResult(kMetricJSONWriteTime, TimeTicks::Now() - start);
+    reporter.AddResult(kMetricJSONSize, json.size());
+
+    start = TimeTicks::Now();
+    std::optional<Value> from_json = JSONReader::Read(json);
+    reporter.AddResult(kMetricJSONReadTime, TimeTicks::Now() - start);
+    EXPECT_TRUE(from_json);
+
+    std::vector<uint8_t> binary;
+    start = TimeTicks::Now();
+    EXPECT_TRUE(BinaryValueSerializer(&binary).Serialize(dict));
+    reporter.AddResult(kMetricBinaryWriteTime, TimeTicks::Now() - start);
+    reporter.AddResult(kMetricBinarySize, binary.size());
+
+    start = TimeTicks::Now();
+    std::unique_ptr<Value> from_binary =
+        BinaryValueDeserializer(binary).Deserialize(nullptr, nullptr);
+    reporter.AddResult(kMetricBinaryReadTime, TimeTicks::Now() - start);
+    EXPECT_TRUE(from_binary);
+
+    // Create() validates the whole buffer without allocating; the lookups
+    // then only walk the dicts along the path to the leaf.
+    start = TimeTicks::Now();
+    std::optional<BinaryValueView> view = BinaryValueView::Create(binary);
+    ASSERT_TRUE(view);
+    for (int i = 1; i < depth; ++i) {
+      view = view->FindKey("Dict0");
+      ASSERT_TRUE(view);
+    }
+    EXPECT_EQ(42, view->FindKey("Int")->GetIfInt());
+    reporter.AddResult(kMetricBinaryLookupTime, TimeTicks::Now() - start);
+  }
+};
+
+TEST_F(BinaryValueSerializerPerfTest, StressTest) {
+  // Same ranges as JSONPerfTest.StressTest.
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      TestWriteAndRead(i + 1, j + 1);
+    }
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,202 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/binary_value_serializer.h"
+
+#include <stdint.h>
+
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/pickle.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+std::vector<uint8_t> Serialize(ValueView value) {
+  std::vector<uint8_t> data;
+  EXPECT_TRUE(BinaryValueSerializer(&data).Serialize(value));
+  return data;
+}
+
+std::unique_ptr<Value> Deserialize(const std::vector<uint8_t>& data,
+                                   int* error_code = nullptr,
+                                   std::string* error_message = nullptr) {
+  return BinaryValueDeserializer(data).Deserialize(error_code, error_message);
+}
+
+Value MakeTestValue() {
+  return Value(
+      Value::Dict()
+          .Set("none", Value())
+          .Set("true", true)
+          .Set("false", false)
+          .Set("zero", 0)
+          .Set("negative", -12345)
+          .Set("min", std::numeric_limits<int>::min())
+          .Set("max", std::numeric_limits<int>::max())
+          .Set("double", 3.25)
+          .Set("string", "h\xC3\xA9llo")
+          .Set("empty", "")
+          .Set("blob", Value(Value::BlobStorage({0, 1, 2, 255})))
+          .Set("list", Value::List().Append(1).Append("two").Append(
+                           Value::List().Append(Value::Dict())))
+          .Set("dict", Value::Dict().Set("a", Value::Dict().Set("b", 2.5))));
+}
+
+}  // namespace
+
+TEST(BinaryValueSerializerTest, RoundTrip) {
+  const Value value = MakeTestValue();
+  std::vector<uint8_t> data = Serialize(value);
+  int error_code = -1;
+  std::unique_ptr<Value> result = Deserialize(data, &error_code);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(value, *result);
+  EXPECT_EQ(ValueDeserializer::kErrorCodeNoError, error_code);
+
+  // Non-container roots work too.
+  for (const Value& root : {Value(), Value(7), Value("s"), Value(-0.5)}) {
+    result = Deserialize(Serialize(root));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(root, *result);
+  }
+}
+
+TEST(BinaryValueSerializerTest, Compact) {
+  // Version, list tag, 4-byte size and count, then a tag and a single byte
+  // for each small int.
+  Value::List list;
+  list.Append(1);
+  list.Append(-1);
+  list.Append(63);
+  list.Append(-64);
+  EXPECT_EQ(15u, Serialize(list).size());
+}
+
+TEST(BinaryValueSerializerTest, TooDeep) {
+  Value::List list;
+  for (int i = 0; i < 250; ++i) {
+    list = Value::List().Append(std::move(list));
+  }
+  std::vector<uint8_t> data = {1, 2, 3};
+  EXPECT_FALSE(BinaryValueSerializer(&data).Serialize(list));
+  EXPECT_TRUE(data.empty());
+}
+
+TEST(BinaryValueSerializerTest, MalformedInput) {
+  const std::vector<uint8_t> valid = Serialize(MakeTestValue());
+
+  // Every truncation is rejected.
+  for (size_t size = 0; size < valid.size(); ++size) {
+    const std::vector<uint8_t> truncated(valid.begin(), valid.begin() + size);
+    EXPECT_FALSE(Deserialize(truncated)) << size;
+    EXPECT_FALSE(BinaryValueView::Create(truncated)) << size;
+  }
+
+  std::vector<uint8_t> trailing = valid;
+  trailing.push_back(0);
+  EXPECT_FALSE(Deserialize(trailing));
+
+  int error_code = 0;
+  std::string error_message;
+  EXPECT_FALSE(Deserialize({2, 0}, &error_code, &error_message));
+  EXPECT_EQ(ValueDeserializer::kErrorCodeInvalidFormat, error_code);
+  EXPECT_EQ("Invalid binary value at offset 1.", error_message);
+
+  // Unknown tag.
+  EXPECT_FALSE(Deserialize({1, 9}));
+  // Invalid UTF-8.
+  EXPECT_FALSE(Deserialize({1, 5, 1, 0xFF}));
+  // An int that does not fit in 32 bits.
+  EXPECT_FALSE(Deserialize({1, 3, 0x80, 0x80, 0x80, 0x80, 0x10}));
+  // A dict whose size does not match its contents.
+  EXPECT_FALSE(Deserialize({1, 7, 3, 0, 0, 0, 1, 1, 'a', 0}));
+  // Keys must be sorted and unique.
+  EXPECT_TRUE(Deserialize({1, 7, 7, 0, 0, 0, 2, 1, 'a', 0, 1, 'b', 0}));
+  EXPECT_FALSE(Deserialize({1, 7, 7, 0, 0, 0, 2, 1, 'b', 0, 1, 'a', 0}));
+  EXPECT_FALSE(Deserialize({1, 7, 7, 0, 0, 0, 2, 1, 'a', 0, 1, 'a', 0}));
+}
+
+TEST(BinaryValueViewTest, LazyAccess) {
+  const Value value = MakeTestValue();
+  const std::vector<uint8_t> data = Serialize(value);
+  std::optional<BinaryValueView> root = BinaryValueView::Create(data);
+  ASSERT_TRUE(root);
+  ASSERT_TRUE(root->is_dict());
+  EXPECT_EQ(value.GetDict().size(), root->size());
+
+  EXPECT_TRUE(root->FindKey("none")->is_none());
+  EXPECT_EQ(true, root->FindKey("true")->GetIfBool());
+  EXPECT_EQ(false, root->FindKey("false")->GetIfBool());
+  EXPECT_EQ(-12345, root->FindKey("negative")->GetIfInt());
+  EXPECT_EQ(std::numeric_limits<int>::min(), root->FindKey("min")->GetIfInt());
+  EXPECT_EQ(3.25, root->FindKey("double")->GetIfDouble());
+  EXPECT_EQ(42.0, BinaryValueView::Create(Serialize(Value(42)))->GetIfDouble());
+  EXPECT_FALSE(root->FindKey("double")->GetIfInt());
+  EXPECT_FALSE(root->FindKey("aaa"));
+  EXPECT_FALSE(root->FindKey("zzz"));
+
+  // Strings and blobs point into the encoded data.
+  std::optional<std::string_view> string =
+      root->FindKey("string")->GetIfString();
+  ASSERT_TRUE(string);
+  EXPECT_EQ("h\xC3\xA9llo", *string);
+  EXPECT_GE(reinterpret_cast<const uint8_t*>(string->data()), data.data());
+  EXPECT_LE(reinterpret_cast<const uint8_t*>(string->data() + string->size()),
+            data.data() + data.size());
+  std::optional<span<const uint8_t>> blob = root->FindKey("blob")->GetIfBlob();
+  ASSERT_TRUE(blob);
+  EXPECT_EQ(4u, blob->size());
+  EXPECT_EQ(255, (*blob)[3]);
+
+  std::optional<BinaryValueView> list = root->FindKey("list");
+  ASSERT_TRUE(list);
+  ASSERT_EQ(3u, list->size());
+  EXPECT_EQ(1, list->GetListItem(0)->GetIfInt());
+  EXPECT_EQ("two", list->GetListItem(1)->GetIfString());
+  EXPECT_TRUE(list->GetListItem(2)->GetListItem(0)->is_dict());
+  EXPECT_FALSE(list->GetListItem(3));
+
+  EXPECT_EQ(2.5,
+            root->FindKey("dict")->FindKey("a")->FindKey("b")->GetIfDouble());
+
+  std::vector<std::string> keys;
+  root->ForEach([&keys](std::string_view key, const BinaryValueView& value) {
+    keys.emplace_back(key);
+  });
+  ASSERT_EQ(value.GetDict().size(), keys.size());
+  EXPECT_EQ("blob", keys.front());
+  EXPECT_EQ("zero", keys.back());
+
+  EXPECT_EQ(value, root->ToValue());
+  EXPECT_EQ(*value.GetDict().Find("list"), list->ToValue());
+}
+
+TEST(BinaryValueSerializerTest, Pickle) {
+  const Value value = MakeTestValue();
+  Pickle pickle;
+  pickle.WriteInt(1);
+  WriteValueToPickle(&pickle, value);
+  pickle.WriteInt(2);
+
+  PickleIterator iter(pickle);
+  int before;
+  int after;
+  ASSERT_TRUE(iter.ReadInt(&before));
+  EXPECT_EQ(value, ReadValueFromPickle(&iter));
+  ASSERT_TRUE(iter.ReadInt(&after));
+  EXPECT_EQ(1, before);
+  EXPECT_EQ(2, after);
+  EXPECT_FALSE(ReadValueFromPickle(&iter));
+}
+
+}  // namespace base
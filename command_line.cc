@@ -83,18 +83,19 @@ size_t GetSwitchPrefixLength(CommandLine::StringPieceType string) {
 
 // Fills in |switch_string| and |switch_value| if |string| is a switch.
 // This will preserve the input switch prefix in the output |switch_string|.
-bool IsSwitch(const CommandLine::StringType& string,
-              CommandLine::StringType* switch_string,
-              CommandLine::StringType* switch_value) {
-  switch_string->clear();
-  switch_value->clear();
+// The outputs are views into |string|, so that parsing doesn't copy them.
+bool IsSwitch(CommandLine::StringPieceType string,
+              CommandLine::StringPieceType* switch_string,
+              CommandLine::StringPieceType* switch_value) {
+  *switch_string = CommandLine::StringPieceType();
+  *switch_value = CommandLine::StringPieceType();
   size_t prefix_length = GetSwitchPrefixLength(string);
   if (prefix_length == 0 || prefix_length == string.length())
     return false;
 
   const size_t equals_position = string.find(kSwitchValueSeparator);
   *switch_string = string.substr(0, equals_position);
-  if (equals_position != CommandLine::StringType::npos)
+  if (equals_position != CommandLine::StringPieceType::npos)
     *switch_value = string.substr(equals_position + 1);
   return true;
 }
@@ -312,6 +313,7 @@ void CommandLine::InitFromArgv(int argc,
 
 void CommandLine::InitFromArgv(const StringVector& argv) {
   argv_ = StringVector(1);
+  argv_.reserve(argv.size() + 1);
   switches_.clear();
   begin_args_ = 1;
   SetProgram(argv.empty() ? FilePath() : FilePath(argv[0]));
@@ -375,6 +377,10 @@ CommandLine::StringType CommandLine::GetSwitchValueNative(
   return result == switches_.end() ? StringType() : result->second;
 }
 
+CommandLine::SwitchMap CommandLine::GetSwitches() const {
+  return SwitchMap(switches_.begin(), switches_.end());
+}
+
 void CommandLine::AppendSwitch(std::string_view switch_string) {
   AppendSwitchNative(switch_string, StringType());
 }
@@ -398,11 +404,12 @@ void CommandLine::AppendSwitchNative(std::string_view switch_string,
 #endif
   size_t prefix_length = GetSwitchPrefixLength(combined_switch_string);
   auto key = switch_key.substr(prefix_length);
+  // Only allocates the key if the switch wasn't already present.
+  StringType& stored_value = switches_.try_emplace(key).first->second;
   if (g_duplicate_switch_handler) {
-    g_duplicate_switch_handler->ResolveDuplicate(key, value,
-                                                 switches_[std::string(key)]);
+    g_duplicate_switch_handler->ResolveDuplicate(key, value, stored_value);
   } else {
-    switches_[std::string(key)] = StringType(value);
+    stored_value.assign(value);
   }
 
   // Preserve existing switch prefixes in |argv_|; only append one if necessary.
@@ -579,21 +586,23 @@ void CommandLine::AppendSwitchesAndArguments(span<const StringType> argv) {
 #if BUILDFLAG(IS_WIN)
   const bool is_parsed_from_string = !raw_command_line_string_.empty();
 #endif
-  for (StringType arg : argv) {
+  // Each switch inserts into |switches_|, whose storage is contiguous.
+  switches_.reserve(switches_.size() + argv.size());
+  for (const StringType& untrimmed_arg : argv) {
 #if BUILDFLAG(IS_WIN)
-    arg = CommandLine::StringType(TrimWhitespace(arg, TRIM_ALL));
+    const StringPieceType arg = TrimWhitespace(untrimmed_arg, TRIM_ALL);
 #elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
-    TrimWhitespaceASCII(arg, TRIM_ALL, &arg);
+    const StringPieceType arg = TrimWhitespaceASCII(untrimmed_arg, TRIM_ALL);
 #endif
 
-    CommandLine::StringType switch_string;
-    CommandLine::StringType switch_value;
+    CommandLine::StringPieceType switch_string;
+    CommandLine::StringPieceType switch_value;
     parse_switches &= (arg != kSwitchTerminator);
     if (parse_switches && IsSwitch(arg, &switch_string, &switch_value)) {
 #if BUILDFLAG(IS_WIN)
       if (is_parsed_from_string &&
           IsSwitchWithKey(switch_string, kSingleArgument)) {
-        ParseAsSingleArgument(switch_string);
+        ParseAsSingleArgument(StringType(switch_string));
         return;
       }
       AppendSwitchNative(WideToUTF8(switch_string), switch_value);
@@ -619,19 +628,21 @@ CommandLine::StringType CommandLine::GetArgumentsStringInternal(
 
   for (size_t i = 1; i < argv_.size(); ++i) {
     StringType arg = argv_[i];
-    StringType switch_string;
-    StringType switch_value;
+    StringPieceType switch_string;
+    StringPieceType switch_value;
     parse_switches &= arg != kSwitchTerminator;
     if (i > 1)
       params.append(FILE_PATH_LITERAL(" "));
     if (parse_switches && IsSwitch(arg, &switch_string, &switch_value)) {
       params.append(switch_string);
       if (!switch_value.empty()) {
+        params.append(kSwitchValueSeparator);
 #if BUILDFLAG(IS_WIN)
-        switch_value = QuoteForCommandLineToArgvWInternal(
-            switch_value, allow_unsafe_insert_sequences);
+        params.append(QuoteForCommandLineToArgvWInternal(
+            StringType(switch_value), allow_unsafe_insert_sequences));
+#else
+        params.append(switch_value);
 #endif
-        params.append(kSwitchValueSeparator + switch_value);
       }
     } else {
 #if BUILDFLAG(IS_WIN)
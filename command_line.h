@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "base/base_export.h"
+#include "base/containers/flat_map.h"
 #include "base/containers/span.h"
 #include "base/debug/debugging_buildflags.h"
 #include "build/build_config.h"
@@ -200,7 +201,7 @@ class BASE_EXPORT CommandLine {
   StringType GetSwitchValueNative(std::string_view switch_string) const;
 
   // Get a copy of all switches, along with their values.
-  const SwitchMap& GetSwitches() const { return switches_; }
+  SwitchMap GetSwitches() const;
 
   // Append a switch [with optional value] to the command line.
   // Note: Switches will precede arguments regardless of appending order.
@@ -329,8 +330,9 @@ class BASE_EXPORT CommandLine {
   // The argv array: { program, [(--|-|/)switch[=value]]*, [--], [argument]* }
   StringVector argv_;
 
-  // Parsed-out switch keys and values.
-  SwitchMap switches_;
+  // Parsed-out switch keys and values. Sorted, contiguous storage, so that
+  // lookups by std::string_view allocate nothing and touch few cache lines.
+  base::flat_map<std::string, StringType, std::less<>> switches_;
 
   // The index after the program and switches, any arguments start here.
   ptrdiff_t begin_args_;
@@ -0,0 +1,213 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONCURRENT_MOVING_WINDOW_H_
+#define BASE_CONCURRENT_MOVING_WINDOW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/containers/span.h"
+#include "base/moving_window.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/platform_thread.h"
+
+namespace base {
+
+// A moving window which can be fed from multiple threads without contending on
+// a single lock. Samples are added to one of `num_shards` MovingWindows,
+// chosen by the id of the calling thread, each with its own lock and its own
+// window of `window_size` samples. Statistics are aggregated over the shards
+// when read: Min()/Max() are the extremum of all the shards' windows, and
+// Mean() is the mean of all the samples in them. They are therefore computed
+// over up to `num_shards * window_size` of the most recent samples, rather
+// than exactly the last `window_size` samples added to the whole window.
+//
+// Reads lock each shard in turn, so they are O(num_shards) and should be less
+// frequent than AddSample(). Threads which add many samples at once should use
+// AddSamples(), which takes the lock of their shard only once.
+//
+// Only the Min, Max and Mean features are supported, since the other
+// statistics can't be aggregated from the shards.
+//
+// Usage:
+// base::ConcurrentMovingAverage<int, int64_t> request_sizes(window_size);
+// request_sizes.AddSample(request_size);  // On any thread.
+// int mean = request_sizes.Mean();  // On any thread.
+template <typename T, typename... Features>
+class ConcurrentMovingWindow {
+ public:
+  using Window = MovingWindow<T, Features...>;
+  using EnabledFeatures = typename Window::EnabledFeatures;
+
+  static_assert(!internal::has_member_deviation<EnabledFeatures>,
+                "Deviation can't be aggregated over the shards");
+  static_assert(!internal::has_member_iteration<EnabledFeatures>,
+                "Iteration isn't supported over the shards");
+
+  static constexpr size_t kDefaultNumShards = 8;
+
+  explicit ConcurrentMovingWindow(size_t window_size,
+                                  size_t num_shards = kDefaultNumShards)
+      : window_size_(window_size),
+        num_shards_(num_shards),
+        shards_(std::make_unique<Shard[]>(num_shards)) {
+    CHECK_GT(window_size, 0u);
+    CHECK_GT(num_shards, 0u);
+    for (size_t i = 0; i < num_shards_; ++i) {
+      AutoLock lock(shards_[i].lock);
+      shards_[i].window.emplace(window_size);
+    }
+  }
+  ConcurrentMovingWindow(const ConcurrentMovingWindow&) = delete;
+  ConcurrentMovingWindow& operator=(const ConcurrentMovingWindow&) = delete;
+  ~ConcurrentMovingWindow() = default;
+
+  // Adds `sample` to the window of the current thread's shard.
+  void AddSample(const T& sample) {
+    Shard& shard = GetShardForCurrentThread();
+    AutoLock lock(shard.lock);
+    shard.window->AddSample(sample);
+  }
+
+  // Adds `samples` to the window of the current thread's shard, in order. See
+  // MovingWindow::AddSamples().
+  void AddSamples(span<const T> samples) {
+    if (samples.empty()) {
+      return;
+    }
+    Shard& shard = GetShardForCurrentThread();
+    AutoLock lock(shard.lock);
+    shard.window->AddSamples(samples);
+  }
+
+  // Returns the number of samples added so far to all the shards (might be
+  // bigger than the window size).
+  size_t Count() const {
+    size_t count = 0;
+    for (size_t i = 0; i < num_shards_; ++i) {
+      AutoLock lock(shards_[i].lock);
+      count += shards_[i].window->Count();
+    }
+    return count;
+  }
+
+  // Calculates the min in the windows of all the shards. At least one sample
+  // must have been added.
+  T Min() const
+    requires internal::has_member_min<EnabledFeatures>
+  {
+    return Extremum([](const Window& window) { return window.Min(); },
+                    std::less<>());
+  }
+
+  // Calculates the max in the windows of all the shards. At least one sample
+  // must have been added.
+  T Max() const
+    requires internal::has_member_max<EnabledFeatures>
+  {
+    return Extremum([](const Window& window) { return window.Max(); },
+                    std::greater<>());
+  }
+
+  // Calculates the mean of the samples in the windows of all the shards.
+  // `ReturnType` can be used to adjust the type of the calculated mean value;
+  // if not specified, uses `T` by default.
+  template <typename ReturnType = T>
+    requires internal::has_member_mean<EnabledFeatures>
+  ReturnType Mean() const {
+    using SumType = decltype(std::declval<const Window&>().Sum());
+    SumType sum = SumType();
+    size_t count = 0;
+    for (size_t i = 0; i < num_shards_; ++i) {
+      AutoLock lock(shards_[i].lock);
+      sum += shards_[i].window->Sum();
+      count += std::min(shards_[i].window->Count(), window_size_);
+    }
+    if (count == 0) {
+      return ReturnType();
+    }
+    return internal::DivideInternal<SumType, ReturnType>::Compute(sum, count);
+  }
+
+  // Resets the state of all the shards to an empty window.
+  void Reset() {
+    for (size_t i = 0; i < num_shards_; ++i) {
+      AutoLock lock(shards_[i].lock);
+      shards_[i].window->Reset();
+    }
+  }
+
+ private:
+  // Each shard is on its own cache line.
+  struct alignas(64) Shard {
+    mutable Lock lock;
+    // Emplaced by the constructor, since MovingWindow has no default
+    // constructor.
+    std::optional<Window> window GUARDED_BY(lock);
+  };
+
+  Shard& GetShardForCurrentThread() {
+    // Mixes the thread id, which is often a multiple of a page size or of a
+    // small power of 2.
+    const uint64_t hash =
+        static_cast<uint64_t>(PlatformThread::CurrentId()) *
+        0x9E3779B97F4A7C15ull;
+    return shards_[(hash >> 32) % num_shards_];
+  }
+
+  // Returns the value of `get_value` for the shard whose value compares first
+  // with `compare`, among the shards which have samples.
+  template <typename GetValue, typename Compare>
+  T Extremum(GetValue get_value, Compare compare) const {
+    std::optional<T> extremum;
+    for (size_t i = 0; i < num_shards_; ++i) {
+      AutoLock lock(shards_[i].lock);
+      if (shards_[i].window->Count() == 0) {
+        continue;
+      }
+      const T value = get_value(*shards_[i].window);
+      if (!extremum || compare(value, *extremum)) {
+        extremum = value;
+      }
+    }
+    CHECK(extremum.has_value());
+    return *extremum;
+  }
+
+  const size_t window_size_;
+  const size_t num_shards_;
+  const std::unique_ptr<Shard[]> shards_;
+};
+
+// Convenience shortcuts.
+template <typename T>
+using ConcurrentMovingMax =
+    ConcurrentMovingWindow<T, MovingWindowFeatures::Max>;
+
+template <typename T>
+using ConcurrentMovingMin =
+    ConcurrentMovingWindow<T, MovingWindowFeatures::Min>;
+
+template <typename T>
+using ConcurrentMovingMinMax =
+    ConcurrentMovingWindow<T,
+                           MovingWindowFeatures::Min,
+                           MovingWindowFeatures::Max>;
+
+template <typename T, typename SumType>
+using ConcurrentMovingAverage =
+    ConcurrentMovingWindow<T, MovingWindowFeatures::Mean<SumType>>;
+
+}  // namespace base
+
+#endif  // BASE_CONCURRENT_MOVING_WINDOW_H_
@@ -0,0 +1,121 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/concurrent_moving_window.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/memory/raw_ref.h"
+#include "base/moving_window.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+using TestWindow = ConcurrentMovingWindow<int,
+                                          MovingWindowFeatures::Min,
+                                          MovingWindowFeatures::Max,
+                                          MovingWindowFeatures::Mean<int64_t>>;
+
+constexpr int kNumSamplesPerWorker = 1000;
+
+class Worker : public SimpleThread {
+ public:
+  Worker(TestWindow& window, int value, bool add_in_bulk)
+      : SimpleThread("ConcurrentMovingWindowTest"),
+        window_(window),
+        value_(value),
+        add_in_bulk_(add_in_bulk) {}
+
+  void Run() override {
+    if (add_in_bulk_) {
+      const std::vector<int> samples(kNumSamplesPerWorker, value_);
+      window_->AddSamples(samples);
+      return;
+    }
+    for (int i = 0; i < kNumSamplesPerWorker; ++i) {
+      window_->AddSample(value_);
+    }
+  }
+
+ private:
+  raw_ref<TestWindow> window_;
+  const int value_;
+  const bool add_in_bulk_;
+};
+
+}  // namespace
+
+TEST(ConcurrentMovingWindowTest, Empty) {
+  ConcurrentMovingAverage<int, int64_t> window(10);
+  EXPECT_EQ(window.Count(), 0u);
+  EXPECT_EQ(window.Mean(), 0);
+}
+
+TEST(ConcurrentMovingWindowTest, SingleThread) {
+  // Samples of a single thread go to a single shard, so the window behaves
+  // like a MovingWindow.
+  constexpr size_t kWindowSize = 5;
+  TestWindow window(kWindowSize);
+  MovingWindow<int,
+               MovingWindowFeatures::Min,
+               MovingWindowFeatures::Max,
+               MovingWindowFeatures::Mean<int64_t>>
+      expected(kWindowSize);
+  for (int value : {33, 1, 2, 7, 5, 2, 4, 45, 1000, 1, 100, 2, 200, 2}) {
+    window.AddSample(value);
+    expected.AddSample(value);
+    EXPECT_EQ(window.Count(), expected.Count());
+    EXPECT_EQ(window.Min(), expected.Min());
+    EXPECT_EQ(window.Max(), expected.Max());
+    EXPECT_EQ(window.Mean(), expected.Mean());
+  }
+
+  const int kSamples[] = {8, 9, 10, 11, 12, 13, 14};
+  window.AddSamples(kSamples);
+  EXPECT_EQ(window.Min(), 10);
+  EXPECT_EQ(window.Max(), 14);
+  EXPECT_EQ(window.Mean(), 12);
+
+  window.Reset();
+  EXPECT_EQ(window.Count(), 0u);
+  EXPECT_EQ(window.Mean(), 0);
+}
+
+TEST(ConcurrentMovingWindowTest, MultipleThreads) {
+  for (bool add_in_bulk : {false, true}) {
+    constexpr int kNumWorkers = 4;
+    // Large enough that no shard evicts samples, even if all the workers
+    // share one.
+    TestWindow window(kNumWorkers * kNumSamplesPerWorker, 4);
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < kNumWorkers; ++i) {
+      workers.push_back(std::make_unique<Worker>(window, i, add_in_bulk));
+      workers.back()->Start();
+    }
+    for (auto& worker : workers) {
+      worker->Join();
+    }
+    EXPECT_EQ(window.Count(),
+              static_cast<size_t>(kNumWorkers * kNumSamplesPerWorker));
+    EXPECT_EQ(window.Min(), 0);
+    EXPECT_EQ(window.Max(), kNumWorkers - 1);
+    EXPECT_EQ(window.Mean<double>(), 1.5);
+  }
+}
+
+TEST(ConcurrentMovingWindowTest, WorksWithTimeDelta) {
+  ConcurrentMovingAverage<TimeDelta, TimeDelta> window(2);
+  window.AddSample(Milliseconds(400));
+  window.AddSample(Milliseconds(200));
+  EXPECT_EQ(window.Mean(), Milliseconds(300));
+}
+
+}  // namespace base
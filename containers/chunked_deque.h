@@ -0,0 +1,384 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_CHUNKED_DEQUE_H_
+#define BASE_CONTAINERS_CHUNKED_DEQUE_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/compiler_specific.h"
+#include "base/containers/circular_deque.h"
+#include "base/memory/raw_ptr_exclusion.h"
+
+namespace base {
+
+// The default number of elements per chunk of a chunked_deque: about 4 KiB of
+// elements, and at least 16.
+template <typename T>
+inline constexpr size_t kDefaultChunkedDequeChunkSize =
+    std::max<size_t>(4096 / sizeof(T), 16);
+
+// chunked_deque is a double-ended queue which stores its elements in
+// fixed-size chunks, like std::deque, rather than in one contiguous buffer
+// like base::circular_deque.
+//
+// Growing a circular_deque moves every element into a new buffer, which makes
+// a push O(size) once in a while: a latency spike for large queues, e.g. of
+// tasks or messages. A chunked_deque instead allocates one more chunk, and
+// only the array of chunk pointers is ever reallocated. As a consequence:
+//  - push and pop are O(1) without amortization, except for the rare
+//    reallocation of the chunk pointers,
+//  - pushing and popping never moves the other elements, so references and
+//    pointers to them stay valid (iterators don't, as with std::deque),
+//  - chunks emptied by pops are kept, up to `kMaxSpareChunks`, and reused by
+//    the following pushes, so a queue whose size oscillates doesn't allocate.
+//    shrink_to_fit() frees them.
+//
+// Unlike std::deque, the chunk size is a template parameter, and indexing and
+// iterators are bounds-checked.
+//
+// Prefer circular_deque for small queues: it has no per-chunk overhead and
+// its elements are contiguous, at least when it doesn't wrap around.
+template <typename T, size_t kChunkSize = kDefaultChunkedDequeChunkSize<T>>
+class chunked_deque {
+ private:
+  template <bool kIsConst>
+  class IteratorImpl;
+
+ public:
+  static_assert(kChunkSize > 0);
+
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = IteratorImpl<false>;
+  using const_iterator = IteratorImpl<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  // The number of emptied chunks kept for reuse.
+  static constexpr size_t kMaxSpareChunks = 2;
+
+  chunked_deque() = default;
+  chunked_deque(std::initializer_list<T> values) {
+    for (const T& value : values) {
+      push_back(value);
+    }
+  }
+  chunked_deque(const chunked_deque& other) {
+    for (const T& value : other) {
+      push_back(value);
+    }
+  }
+  chunked_deque(chunked_deque&& other) noexcept
+      : chunks_(std::move(other.chunks_)),
+        spare_chunks_(std::move(other.spare_chunks_)),
+        begin_(std::exchange(other.begin_, 0)),
+        size_(std::exchange(other.size_, 0)) {
+    other.chunks_.clear();
+    other.spare_chunks_.clear();
+  }
+  chunked_deque& operator=(const chunked_deque& other) {
+    if (this != &other) {
+      chunked_deque copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+  chunked_deque& operator=(chunked_deque&& other) noexcept {
+    if (this != &other) {
+      chunked_deque moved(std::move(other));
+      swap(moved);
+    }
+    return *this;
+  }
+  ~chunked_deque() { clear(); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // The number of chunks which are allocated, including spare ones.
+  size_t num_allocated_chunks() const {
+    return chunks_.size() + spare_chunks_.size();
+  }
+
+  T& operator[](size_t index) {
+    CHECK_LT(index, size_);
+    return GetSlot(index);
+  }
+  const T& operator[](size_t index) const {
+    CHECK_LT(index, size_);
+    return GetSlot(index);
+  }
+  T& front() {
+    CHECK(!empty());
+    return GetSlot(0);
+  }
+  const T& front() const {
+    CHECK(!empty());
+    return GetSlot(0);
+  }
+  T& back() {
+    CHECK(!empty());
+    return GetSlot(size_ - 1);
+  }
+  const T& back() const {
+    CHECK(!empty());
+    return GetSlot(size_ - 1);
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator cbegin() const { return begin(); }
+  iterator end() { return iterator(this, size_); }
+  const_iterator end() const { return const_iterator(this, size_); }
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    const size_t position = begin_ + size_;
+    if (position == chunks_.size() * kChunkSize) {
+      chunks_.push_back(TakeChunk());
+    }
+    T* slot = chunks_[position / kChunkSize]->slot(position % kChunkSize);
+    std::construct_at(slot, std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+
+  void push_front(const T& value) { emplace_front(value); }
+  void push_front(T&& value) { emplace_front(std::move(value)); }
+  template <typename... Args>
+  T& emplace_front(Args&&... args) {
+    if (begin_ == 0) {
+      chunks_.push_front(TakeChunk());
+      begin_ = kChunkSize;
+    }
+    T* slot = chunks_.front()->slot(begin_ - 1);
+    std::construct_at(slot, std::forward<Args>(args)...);
+    --begin_;
+    ++size_;
+    return *slot;
+  }
+
+  void pop_front() {
+    CHECK(!empty());
+    std::destroy_at(chunks_.front()->slot(begin_));
+    ++begin_;
+    --size_;
+    if (size_ == 0 || begin_ == kChunkSize) {
+      ReleaseChunk(std::move(chunks_.front()));
+      chunks_.pop_front();
+      begin_ = 0;
+    }
+  }
+
+  void pop_back() {
+    CHECK(!empty());
+    const size_t position = begin_ + size_ - 1;
+    std::destroy_at(
+        chunks_[position / kChunkSize]->slot(position % kChunkSize));
+    --size_;
+    if (size_ == 0) {
+      ReleaseChunk(std::move(chunks_.back()));
+      chunks_.pop_back();
+      begin_ = 0;
+    } else if (position % kChunkSize == 0) {
+      ReleaseChunk(std::move(chunks_.back()));
+      chunks_.pop_back();
+    }
+  }
+
+  // Destroys all the elements. Up to `kMaxSpareChunks` chunks are kept.
+  void clear() {
+    while (!empty()) {
+      pop_back();
+    }
+  }
+
+  // Frees the spare chunks.
+  void shrink_to_fit() {
+    spare_chunks_.clear();
+    chunks_.shrink_to_fit();
+  }
+
+  void swap(chunked_deque& other) noexcept {
+    chunks_.swap(other.chunks_);
+    spare_chunks_.swap(other.spare_chunks_);
+    std::swap(begin_, other.begin_);
+    std::swap(size_, other.size_);
+  }
+  friend void swap(chunked_deque& lhs, chunked_deque& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  friend bool operator==(const chunked_deque& lhs, const chunked_deque& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+ private:
+  // Uninitialized storage for `kChunkSize` elements.
+  class Chunk {
+   public:
+    T* slot(size_t index) {
+      DCHECK_LT(index, kChunkSize);
+      // SAFETY: `index` is less than `kChunkSize`, the number of elements
+      // `storage_` can hold.
+      return UNSAFE_BUFFERS(
+          reinterpret_cast<T*>(storage_.data() + index * sizeof(T)));
+    }
+
+   private:
+    alignas(T) std::array<unsigned char, sizeof(T) * kChunkSize> storage_;
+  };
+
+  T& GetSlot(size_t index) const {
+    const size_t position = begin_ + index;
+    return *chunks_[position / kChunkSize]->slot(position % kChunkSize);
+  }
+
+  std::unique_ptr<Chunk> TakeChunk() {
+    if (spare_chunks_.empty()) {
+      return std::make_unique<Chunk>();
+    }
+    std::unique_ptr<Chunk> chunk = std::move(spare_chunks_.back());
+    spare_chunks_.pop_back();
+    return chunk;
+  }
+
+  void ReleaseChunk(std::unique_ptr<Chunk> chunk) {
+    if (spare_chunks_.size() < kMaxSpareChunks) {
+      spare_chunks_.push_back(std::move(chunk));
+    }
+  }
+
+  template <bool kIsConst>
+  class IteratorImpl {
+   public:
+    using Deque =
+        std::conditional_t<kIsConst, const chunked_deque, chunked_deque>;
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using pointer = std::conditional_t<kIsConst, const T*, T*>;
+    using reference = std::conditional_t<kIsConst, const T&, T&>;
+
+    IteratorImpl() = default;
+    IteratorImpl(const IteratorImpl&) = default;
+    IteratorImpl& operator=(const IteratorImpl&) = default;
+    // Allows conversion from iterator to const_iterator.
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    IteratorImpl(const IteratorImpl<false>& other)
+      requires(kIsConst)
+        : deque_(other.deque_), index_(other.index_) {}
+
+    reference operator*() const { return (*deque_)[index_]; }
+    pointer operator->() const { return &(*deque_)[index_]; }
+    reference operator[](difference_type offset) const {
+      return *(*this + offset);
+    }
+
+    IteratorImpl& operator++() {
+      ++index_;
+      return *this;
+    }
+    IteratorImpl operator++(int) {
+      IteratorImpl result = *this;
+      ++index_;
+      return result;
+    }
+    IteratorImpl& operator--() {
+      --index_;
+      return *this;
+    }
+    IteratorImpl operator--(int) {
+      IteratorImpl result = *this;
+      --index_;
+      return result;
+    }
+    IteratorImpl& operator+=(difference_type offset) {
+      index_ = static_cast<size_t>(static_cast<difference_type>(index_) +
+                                   offset);
+      return *this;
+    }
+    IteratorImpl& operator-=(difference_type offset) {
+      return *this += -offset;
+    }
+    friend IteratorImpl operator+(IteratorImpl it, difference_type offset) {
+      return it += offset;
+    }
+    friend IteratorImpl operator+(difference_type offset, IteratorImpl it) {
+      return it += offset;
+    }
+    friend IteratorImpl operator-(IteratorImpl it, difference_type offset) {
+      return it -= offset;
+    }
+    friend difference_type operator-(const IteratorImpl& lhs,
+                                     const IteratorImpl& rhs) {
+      DCHECK_EQ(lhs.deque_, rhs.deque_);
+      return static_cast<difference_type>(lhs.index_) -
+             static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const IteratorImpl& lhs, const IteratorImpl& rhs) {
+      DCHECK_EQ(lhs.deque_, rhs.deque_);
+      return lhs.index_ == rhs.index_;
+    }
+    friend auto operator<=>(const IteratorImpl& lhs, const IteratorImpl& rhs) {
+      DCHECK_EQ(lhs.deque_, rhs.deque_);
+      return lhs.index_ <=> rhs.index_;
+    }
+
+   private:
+    friend class chunked_deque;
+    friend class IteratorImpl<true>;
+
+    IteratorImpl(Deque* deque, size_t index) : deque_(deque), index_(index) {}
+
+    // Not a raw_ptr<...> for performance reasons, like the iterators of
+    // circular_deque: it usually lives on the stack, pointing back to the
+    // container being iterated.
+    RAW_PTR_EXCLUSION Deque* deque_ = nullptr;
+    size_t index_ = 0;
+  };
+
+  // The chunks holding the elements, in order.
+  circular_deque<std::unique_ptr<Chunk>> chunks_;
+  // Emptied chunks, kept for reuse.
+  std::vector<std::unique_ptr<Chunk>> spare_chunks_;
+  // The position of the first element in the first chunk.
+  size_t begin_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_CHUNKED_DEQUE_H_
@@ -0,0 +1,65 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/chunked_deque.h"
+
+#include <stdint.h>
+
+#include <array>
+#include <string>
+
+#include "base/containers/circular_deque.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+namespace {
+
+constexpr char kMetricPrefixCircularDeque[] = "CircularDeque.";
+constexpr char kMetricPrefixChunkedDeque[] = "ChunkedDeque.";
+constexpr char kMetricTotalTime[] = "total_time";
+constexpr char kMetricMaxPushTime[] = "max_push_time";
+
+constexpr int kNumElements = 1000000;
+
+// About the size of a task.
+struct Element {
+  std::array<uint64_t, 8> data;
+};
+
+// Grows a queue from empty to `kNumElements` elements, and reports the total
+// time and the time of the slowest push, which includes the growth of the
+// container.
+template <typename Deque>
+void RunTest(const std::string& metric_prefix) {
+  Deque deque;
+  TimeDelta max_push_time;
+  ElapsedTimer total_timer;
+  for (int i = 0; i < kNumElements; ++i) {
+    ElapsedTimer push_timer;
+    deque.push_back(Element{{static_cast<uint64_t>(i)}});
+    max_push_time = std::max(max_push_time, push_timer.Elapsed());
+  }
+  const TimeDelta total_time = total_timer.Elapsed();
+  EXPECT_EQ(static_cast<size_t>(kNumElements), deque.size());
+
+  perf_test::PerfResultReporter reporter(metric_prefix, "push_back");
+  reporter.RegisterImportantMetric(kMetricTotalTime, "ms");
+  reporter.RegisterImportantMetric(kMetricMaxPushTime, "us");
+  reporter.AddResult(kMetricTotalTime, total_time);
+  reporter.AddResult(kMetricMaxPushTime, max_push_time);
+}
+
+TEST(ChunkedDequePerfTest, CircularDeque) {
+  RunTest<circular_deque<Element>>(kMetricPrefixCircularDeque);
+}
+
+TEST(ChunkedDequePerfTest, ChunkedDeque) {
+  RunTest<chunked_deque<Element>>(kMetricPrefixChunkedDeque);
+}
+
+}  // namespace
+}  // namespace base
@@ -0,0 +1,156 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/chunked_deque.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/test/gtest_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Small chunks, to exercise the transitions between them.
+using IntDeque = chunked_deque<int, 4>;
+
+std::vector<int> ToVector(const IntDeque& deque) {
+  return std::vector<int>(deque.begin(), deque.end());
+}
+
+}  // namespace
+
+TEST(ChunkedDequeTest, PushAndPop) {
+  IntDeque deque;
+  EXPECT_TRUE(deque.empty());
+  for (int i = 0; i < 10; ++i) {
+    deque.push_back(i);
+  }
+  for (int i = 1; i <= 5; ++i) {
+    deque.push_front(-i);
+  }
+  EXPECT_EQ(15u, deque.size());
+  EXPECT_EQ(-5, deque.front());
+  EXPECT_EQ(9, deque.back());
+  for (size_t i = 0; i < deque.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(i) - 5, deque[i]);
+  }
+
+  deque.pop_front();
+  deque.pop_back();
+  EXPECT_EQ((std::vector<int>{-4, -3, -2, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8}),
+            ToVector(deque));
+
+  while (!deque.empty()) {
+    deque.pop_front();
+  }
+  deque.push_front(1);
+  deque.push_back(2);
+  EXPECT_EQ((std::vector<int>{1, 2}), ToVector(deque));
+}
+
+TEST(ChunkedDequeTest, StableReferences) {
+  IntDeque deque;
+  deque.push_back(0);
+  int* first = &deque.front();
+  for (int i = 1; i < 100; ++i) {
+    deque.push_back(i);
+    deque.push_front(-i);
+  }
+  EXPECT_EQ(first, &deque[99]);
+  for (int i = 0; i < 99; ++i) {
+    deque.pop_front();
+  }
+  EXPECT_EQ(first, &deque.front());
+  EXPECT_EQ(0, *first);
+}
+
+TEST(ChunkedDequeTest, ReusesChunks) {
+  IntDeque deque;
+  for (int i = 0; i < 8; ++i) {
+    deque.push_back(i);
+  }
+  EXPECT_EQ(2u, deque.num_allocated_chunks());
+
+  // A queue moving through the chunks doesn't allocate more of them.
+  for (int i = 0; i < 100; ++i) {
+    deque.pop_front();
+    deque.push_back(i);
+  }
+  EXPECT_EQ(8u, deque.size());
+  EXPECT_LE(deque.num_allocated_chunks(), 2u + IntDeque::kMaxSpareChunks);
+
+  deque.clear();
+  EXPECT_EQ(IntDeque::kMaxSpareChunks, deque.num_allocated_chunks());
+  deque.shrink_to_fit();
+  EXPECT_EQ(0u, deque.num_allocated_chunks());
+}
+
+TEST(ChunkedDequeTest, Iterators) {
+  IntDeque deque = {1, 2, 3, 4, 5, 6};
+  deque.push_front(0);
+  EXPECT_EQ(7, deque.end() - deque.begin());
+  EXPECT_EQ(3, deque.begin()[3]);
+  EXPECT_TRUE(std::is_sorted(deque.begin(), deque.end()));
+  EXPECT_EQ(deque.begin() + 4, std::find(deque.begin(), deque.end(), 4));
+
+  std::reverse(deque.begin(), deque.end());
+  EXPECT_EQ((std::vector<int>{6, 5, 4, 3, 2, 1, 0}), ToVector(deque));
+  EXPECT_EQ(0, *deque.rbegin());
+
+  IntDeque::const_iterator it = deque.begin();
+  EXPECT_EQ(6, *it);
+  EXPECT_TRUE(it < deque.cend());
+}
+
+TEST(ChunkedDequeTest, CopyAndMove) {
+  chunked_deque<std::string, 2> deque = {"a", "b", "c"};
+  chunked_deque<std::string, 2> copy = deque;
+  EXPECT_EQ(deque, copy);
+
+  chunked_deque<std::string, 2> moved = std::move(deque);
+  EXPECT_EQ(copy, moved);
+  EXPECT_TRUE(deque.empty());
+
+  copy.pop_back();
+  EXPECT_NE(copy, moved);
+  copy = moved;
+  EXPECT_EQ(copy, moved);
+}
+
+TEST(ChunkedDequeTest, MoveOnly) {
+  chunked_deque<std::unique_ptr<int>> deque;
+  deque.push_back(std::make_unique<int>(1));
+  deque.emplace_front(std::make_unique<int>(0));
+  EXPECT_EQ(0, *deque.front());
+  EXPECT_EQ(1, *deque.back());
+}
+
+TEST(ChunkedDequeTest, DestroysElements) {
+  auto counter = std::make_shared<int>(0);
+  {
+    chunked_deque<std::shared_ptr<int>, 4> deque;
+    for (int i = 0; i < 10; ++i) {
+      deque.push_back(counter);
+    }
+    deque.pop_front();
+    EXPECT_EQ(10, counter.use_count());
+  }
+  EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(ChunkedDequeDeathTest, OutOfBounds) {
+  IntDeque deque = {1, 2};
+  EXPECT_CHECK_DEATH(deque[2]);
+  deque.clear();
+  EXPECT_CHECK_DEATH(deque.front());
+  EXPECT_CHECK_DEATH(deque.pop_back());
+}
+
+}  // namespace base
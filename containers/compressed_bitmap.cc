@@ -0,0 +1,568 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/compressed_bitmap.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/containers/span.h"
+#include "base/pickle.h"
+
+namespace base {
+
+namespace {
+
+bool TestBit(const std::vector<uint64_t>& words, uint32_t bit) {
+  return (words[bit / 64] >> (bit % 64)) & 1;
+}
+
+void SetBit(std::vector<uint64_t>& words, uint32_t bit) {
+  words[bit / 64] |= uint64_t{1} << (bit % 64);
+}
+
+// Sets the bits from `first` to `last`, included.
+void SetBits(std::vector<uint64_t>& words, uint32_t first, uint32_t last) {
+  for (uint32_t bit = first; bit <= last;) {
+    const uint32_t end = std::min(last + 1, (bit / 64 + 1) * 64);
+    const uint32_t count = end - bit;
+    const uint64_t mask =
+        count == 64 ? ~uint64_t{0} : ((uint64_t{1} << count) - 1);
+    words[bit / 64] |= mask << (bit % 64);
+    bit = end;
+  }
+}
+
+// Returns whether runs, as [first, last] pairs, are sorted with gaps between
+// them.
+bool AreValidRuns(const std::vector<uint16_t>& runs) {
+  if (runs.empty() || runs.size() % 2 != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < runs.size(); i += 2) {
+    if (runs[i] > runs[i + 1] || (i > 0 && runs[i] <= runs[i - 1] + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// CompressedBitmap::Chunk
+
+CompressedBitmap::Chunk::Chunk() = default;
+CompressedBitmap::Chunk::Chunk(const Chunk&) = default;
+CompressedBitmap::Chunk::Chunk(Chunk&&) noexcept = default;
+CompressedBitmap::Chunk& CompressedBitmap::Chunk::operator=(const Chunk&) =
+    default;
+CompressedBitmap::Chunk& CompressedBitmap::Chunk::operator=(Chunk&&) noexcept =
+    default;
+CompressedBitmap::Chunk::~Chunk() = default;
+
+// static
+CompressedBitmap::Chunk CompressedBitmap::Chunk::Union(const Chunk& lhs,
+                                                       const Chunk& rhs) {
+  if (lhs.type_ == Type::kArray && rhs.type_ == Type::kArray &&
+      lhs.size_ + rhs.size_ <= kMaxArraySize) {
+    Chunk result;
+    result.values_.reserve(lhs.size_ + rhs.size_);
+    std::set_union(lhs.values_.begin(), lhs.values_.end(), rhs.values_.begin(),
+                   rhs.values_.end(), std::back_inserter(result.values_));
+    result.size_ = static_cast<uint32_t>(result.values_.size());
+    return result;
+  }
+  std::vector<uint64_t> words = lhs.ToBitmap();
+  rhs.OrInto(words);
+  return FromBitmap(std::move(words));
+}
+
+// static
+CompressedBitmap::Chunk CompressedBitmap::Chunk::Intersection(
+    const Chunk& lhs,
+    const Chunk& rhs) {
+  if (lhs.type_ == Type::kArray || rhs.type_ == Type::kArray) {
+    const Chunk& array = lhs.type_ == Type::kArray ? lhs : rhs;
+    const Chunk& other = lhs.type_ == Type::kArray ? rhs : lhs;
+    Chunk result;
+    if (other.type_ == Type::kArray && array.size_ * 32 > other.size_ &&
+        other.size_ * 32 > array.size_) {
+      // Merges arrays of similar sizes.
+      std::set_intersection(array.values_.begin(), array.values_.end(),
+                            other.values_.begin(), other.values_.end(),
+                            std::back_inserter(result.values_));
+    } else {
+      // Otherwise, looks up each value of the smaller array in the other
+      // chunk.
+      const Chunk& smaller =
+          other.type_ == Type::kArray && other.size_ < array.size_ ? other
+                                                                   : array;
+      const Chunk& larger = &smaller == &array ? other : array;
+      for (uint16_t value : smaller.values_) {
+        if (larger.Contains(value)) {
+          result.values_.push_back(value);
+        }
+      }
+    }
+    result.size_ = static_cast<uint32_t>(result.values_.size());
+    return result;
+  }
+
+  std::vector<uint64_t> words = lhs.ToBitmap();
+  if (rhs.type_ == Type::kBitmap) {
+    for (size_t i = 0; i < kBitmapWords; ++i) {
+      words[i] &= rhs.words_[i];
+    }
+  } else {
+    const std::vector<uint64_t> rhs_words = rhs.ToBitmap();
+    for (size_t i = 0; i < kBitmapWords; ++i) {
+      words[i] &= rhs_words[i];
+    }
+  }
+  return FromBitmap(std::move(words));
+}
+
+bool CompressedBitmap::Chunk::Add(uint16_t value) {
+  if (type_ == Type::kRun) {
+    if (Contains(value)) {
+      return false;
+    }
+    Decompress();
+  }
+
+  if (type_ == Type::kBitmap) {
+    if (TestBit(words_, value)) {
+      return false;
+    }
+    SetBit(words_, value);
+    ++size_;
+    return true;
+  }
+
+  auto it = std::lower_bound(values_.begin(), values_.end(), value);
+  if (it != values_.end() && *it == value) {
+    return false;
+  }
+  values_.insert(it, value);
+  ++size_;
+  if (size_ > kMaxArraySize) {
+    words_ = ToBitmap();
+    type_ = Type::kBitmap;
+    values_.clear();
+    values_.shrink_to_fit();
+  }
+  return true;
+}
+
+bool CompressedBitmap::Chunk::Remove(uint16_t value) {
+  if (type_ == Type::kRun) {
+    if (!Contains(value)) {
+      return false;
+    }
+    Decompress();
+  }
+
+  if (type_ == Type::kBitmap) {
+    if (!TestBit(words_, value)) {
+      return false;
+    }
+    words_[value / 64] &= ~(uint64_t{1} << (value % 64));
+    --size_;
+    if (size_ <= kMaxArraySize) {
+      *this = FromBitmap(std::move(words_));
+    }
+    return true;
+  }
+
+  auto it = std::lower_bound(values_.begin(), values_.end(), value);
+  if (it == values_.end() || *it != value) {
+    return false;
+  }
+  values_.erase(it);
+  --size_;
+  return true;
+}
+
+bool CompressedBitmap::Chunk::Contains(uint16_t value) const {
+  switch (type_) {
+    case Type::kArray:
+      return std::binary_search(values_.begin(), values_.end(), value);
+    case Type::kBitmap:
+      return TestBit(words_, value);
+    case Type::kRun: {
+      // Finds the last run which starts at or before `value`.
+      size_t begin = 0;
+      size_t end = values_.size() / 2;
+      while (begin < end) {
+        const size_t mid = begin + (end - begin) / 2;
+        if (values_[2 * mid] <= value) {
+          begin = mid + 1;
+        } else {
+          end = mid;
+        }
+      }
+      return begin > 0 && value <= values_[2 * begin - 1];
+    }
+  }
+}
+
+void CompressedBitmap::Chunk::ForEach(
+    uint32_t high,
+    FunctionRef<void(uint32_t)> callback) const {
+  switch (type_) {
+    case Type::kArray:
+      for (uint16_t value : values_) {
+        callback(high | value);
+      }
+      return;
+    case Type::kBitmap:
+      for (size_t i = 0; i < kBitmapWords; ++i) {
+        for (uint64_t word = words_[i]; word; word &= word - 1) {
+          callback(high |
+                   static_cast<uint32_t>(i * 64 + std::countr_zero(word)));
+        }
+      }
+      return;
+    case Type::kRun:
+      for (size_t i = 0; i < values_.size(); i += 2) {
+        for (uint32_t value = values_[i]; value <= values_[i + 1]; ++value) {
+          callback(high | value);
+        }
+      }
+      return;
+  }
+}
+
+void CompressedBitmap::Chunk::Optimize() {
+  std::vector<uint16_t> runs;
+  ForEach(0, [&runs](uint32_t value) {
+    if (!runs.empty() && runs.back() + 1u == value) {
+      runs.back() = static_cast<uint16_t>(value);
+    } else {
+      runs.push_back(static_cast<uint16_t>(value));
+      runs.push_back(static_cast<uint16_t>(value));
+    }
+  });
+
+  const size_t run_bytes = runs.size() * sizeof(uint16_t);
+  const size_t other_bytes = size_ <= kMaxArraySize
+                                 ? size_ * sizeof(uint16_t)
+                                 : kBitmapWords * sizeof(uint64_t);
+  if (run_bytes < other_bytes) {
+    type_ = Type::kRun;
+    values_ = std::move(runs);
+    values_.shrink_to_fit();
+    words_.clear();
+    words_.shrink_to_fit();
+    return;
+  }
+  if (type_ == Type::kRun) {
+    Decompress();
+  }
+  values_.shrink_to_fit();
+}
+
+bool CompressedBitmap::Chunk::Equals(const Chunk& other) const {
+  if (size_ != other.size_) {
+    return false;
+  }
+  if (type_ == other.type_) {
+    return values_ == other.values_ && words_ == other.words_;
+  }
+  return ToBitmap() == other.ToBitmap();
+}
+
+size_t CompressedBitmap::Chunk::EstimateMemoryUsage() const {
+  return values_.capacity() * sizeof(uint16_t) +
+         words_.capacity() * sizeof(uint64_t);
+}
+
+void CompressedBitmap::Chunk::WriteToPickle(Pickle* pickle) const {
+  pickle->WriteInt(static_cast<int>(type_));
+  if (type_ == Type::kBitmap) {
+    pickle->WriteData(as_byte_span(words_));
+  } else {
+    pickle->WriteData(as_byte_span(values_));
+  }
+}
+
+bool CompressedBitmap::Chunk::ReadFromPickle(PickleIterator* iter) {
+  int type;
+  if (!iter->ReadInt(&type)) {
+    return false;
+  }
+  std::optional<span<const uint8_t>> data = iter->ReadData();
+  if (!data) {
+    return false;
+  }
+
+  *this = Chunk();
+  switch (static_cast<Type>(type)) {
+    case Type::kArray:
+      if (data->empty() || data->size() % sizeof(uint16_t) != 0 ||
+          data->size() / sizeof(uint16_t) > kMaxArraySize) {
+        return false;
+      }
+      values_.resize(data->size() / sizeof(uint16_t));
+      as_writable_byte_span(values_).copy_from(*data);
+      if (!std::is_sorted(values_.begin(), values_.end(),
+                          std::less_equal<>())) {
+        return false;
+      }
+      size_ = static_cast<uint32_t>(values_.size());
+      return true;
+    case Type::kBitmap:
+      if (data->size() != kBitmapWords * sizeof(uint64_t)) {
+        return false;
+      }
+      words_.resize(kBitmapWords);
+      as_writable_byte_span(words_).copy_from(*data);
+      type_ = Type::kBitmap;
+      for (uint64_t word : words_) {
+        size_ += static_cast<uint32_t>(std::popcount(word));
+      }
+      return size_ > kMaxArraySize;
+    case Type::kRun:
+      if (data->size() % (2 * sizeof(uint16_t)) != 0) {
+        return false;
+      }
+      values_.resize(data->size() / sizeof(uint16_t));
+      as_writable_byte_span(values_).copy_from(*data);
+      if (!AreValidRuns(values_)) {
+        return false;
+      }
+      type_ = Type::kRun;
+      for (size_t i = 0; i < values_.size(); i += 2) {
+        size_ += values_[i + 1] - values_[i] + 1u;
+      }
+      return true;
+  }
+  return false;
+}
+
+// static
+CompressedBitmap::Chunk CompressedBitmap::Chunk::FromBitmap(
+    std::vector<uint64_t> words) {
+  DCHECK_EQ(words.size(), kBitmapWords);
+  Chunk chunk;
+  for (uint64_t word : words) {
+    chunk.size_ += static_cast<uint32_t>(std::popcount(word));
+  }
+  if (chunk.size_ > kMaxArraySize) {
+    chunk.type_ = Type::kBitmap;
+    chunk.words_ = std::move(words);
+    return chunk;
+  }
+  chunk.values_.reserve(chunk.size_);
+  for (size_t i = 0; i < kBitmapWords; ++i) {
+    for (uint64_t word = words[i]; word; word &= word - 1) {
+      chunk.values_.push_back(
+          static_cast<uint16_t>(i * 64 + std::countr_zero(word)));
+    }
+  }
+  return chunk;
+}
+
+std::vector<uint64_t> CompressedBitmap::Chunk::ToBitmap() const {
+  if (type_ == Type::kBitmap) {
+    return words_;
+  }
+  std::vector<uint64_t> words(kBitmapWords);
+  OrInto(words);
+  return words;
+}
+
+void CompressedBitmap::Chunk::OrInto(std::vector<uint64_t>& words) const {
+  switch (type_) {
+    case Type::kArray:
+      for (uint16_t value : values_) {
+        SetBit(words, value);
+      }
+      return;
+    case Type::kBitmap:
+      // Written so that the compiler vectorizes it.
+      for (size_t i = 0; i < kBitmapWords; ++i) {
+        words[i] |= words_[i];
+      }
+      return;
+    case Type::kRun:
+      for (size_t i = 0; i < values_.size(); i += 2) {
+        SetBits(words, values_[i], values_[i + 1]);
+      }
+      return;
+  }
+}
+
+void CompressedBitmap::Chunk::Decompress() {
+  DCHECK_EQ(type_, Type::kRun);
+  std::vector<uint64_t> words(kBitmapWords);
+  OrInto(words);
+  *this = FromBitmap(std::move(words));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// CompressedBitmap
+
+CompressedBitmap::CompressedBitmap() = default;
+CompressedBitmap::CompressedBitmap(const CompressedBitmap&) = default;
+CompressedBitmap::CompressedBitmap(CompressedBitmap&&) noexcept = default;
+CompressedBitmap& CompressedBitmap::operator=(const CompressedBitmap&) =
+    default;
+CompressedBitmap& CompressedBitmap::operator=(CompressedBitmap&&) noexcept =
+    default;
+CompressedBitmap::~CompressedBitmap() = default;
+
+bool CompressedBitmap::Add(uint32_t value) {
+  if (!chunks_[static_cast<uint16_t>(value >> 16)].Add(
+          static_cast<uint16_t>(value))) {
+    return false;
+  }
+  ++size_;
+  return true;
+}
+
+bool CompressedBitmap::Remove(uint32_t value) {
+  auto it = chunks_.find(static_cast<uint16_t>(value >> 16));
+  if (it == chunks_.end() || !it->second.Remove(static_cast<uint16_t>(value))) {
+    return false;
+  }
+  if (it->second.size() == 0) {
+    chunks_.erase(it);
+  }
+  --size_;
+  return true;
+}
+
+bool CompressedBitmap::Contains(uint32_t value) const {
+  auto it = chunks_.find(static_cast<uint16_t>(value >> 16));
+  return it != chunks_.end() &&
+         it->second.Contains(static_cast<uint16_t>(value));
+}
+
+void CompressedBitmap::clear() {
+  chunks_.clear();
+  size_ = 0;
+}
+
+void CompressedBitmap::ForEach(FunctionRef<void(uint32_t)> callback) const {
+  for (const auto& [high, chunk] : chunks_) {
+    chunk.ForEach(uint32_t{high} << 16, callback);
+  }
+}
+
+void CompressedBitmap::Optimize() {
+  for (auto& [high, chunk] : chunks_) {
+    chunk.Optimize();
+  }
+}
+
+CompressedBitmap& CompressedBitmap::operator|=(const CompressedBitmap& other) {
+  // Merges the sorted chunks of both sets.
+  std::vector<std::pair<uint16_t, Chunk>> chunks;
+  chunks.reserve(chunks_.size() + other.chunks_.size());
+  auto it = chunks_.begin();
+  auto other_it = other.chunks_.begin();
+  while (it != chunks_.end() || other_it != other.chunks_.end()) {
+    if (other_it == other.chunks_.end() ||
+        (it != chunks_.end() && it->first < other_it->first)) {
+      chunks.emplace_back(it->first, std::move(it->second));
+      ++it;
+    } else if (it == chunks_.end() || other_it->first < it->first) {
+      chunks.emplace_back(*other_it);
+      ++other_it;
+    } else {
+      chunks.emplace_back(it->first,
+                          Chunk::Union(it->second, other_it->second));
+      ++it;
+      ++other_it;
+    }
+  }
+
+  size_ = 0;
+  for (const auto& [high, chunk] : chunks) {
+    size_ += chunk.size();
+  }
+  chunks_ = flat_map<uint16_t, Chunk>(sorted_unique, std::move(chunks));
+  return *this;
+}
+
+CompressedBitmap& CompressedBitmap::operator&=(const CompressedBitmap& other) {
+  std::vector<std::pair<uint16_t, Chunk>> chunks;
+  size_ = 0;
+  auto other_it = other.chunks_.begin();
+  for (const auto& [high, chunk] : chunks_) {
+    while (other_it != other.chunks_.end() && other_it->first < high) {
+      ++other_it;
+    }
+    if (other_it == other.chunks_.end()) {
+      break;
+    }
+    if (other_it->first != high) {
+      continue;
+    }
+    Chunk result = Chunk::Intersection(chunk, other_it->second);
+    if (result.size() != 0) {
+      size_ += result.size();
+      chunks.emplace_back(high, std::move(result));
+    }
+  }
+  chunks_ = flat_map<uint16_t, Chunk>(sorted_unique, std::move(chunks));
+  return *this;
+}
+
+bool operator==(const CompressedBitmap& lhs, const CompressedBitmap& rhs) {
+  return lhs.size_ == rhs.size_ &&
+         std::equal(lhs.chunks_.begin(), lhs.chunks_.end(),
+                    rhs.chunks_.begin(), rhs.chunks_.end(),
+                    [](const auto& a, const auto& b) {
+                      return a.first == b.first && a.second.Equals(b.second);
+                    });
+}
+
+size_t CompressedBitmap::EstimateMemoryUsage() const {
+  size_t usage = chunks_.capacity() * sizeof(std::pair<uint16_t, Chunk>);
+  for (const auto& [high, chunk] : chunks_) {
+    usage += chunk.EstimateMemoryUsage();
+  }
+  return usage;
+}
+
+void CompressedBitmap::WriteToPickle(Pickle* pickle) const {
+  pickle->WriteUInt32(static_cast<uint32_t>(chunks_.size()));
+  for (const auto& [high, chunk] : chunks_) {
+    pickle->WriteUInt16(high);
+    chunk.WriteToPickle(pickle);
+  }
+}
+
+bool CompressedBitmap::ReadFromPickle(PickleIterator* iter) {
+  clear();
+  uint32_t count;
+  if (!iter->ReadUInt32(&count) || count > 65536) {
+    return false;
+  }
+
+  std::vector<std::pair<uint16_t, Chunk>> chunks;
+  size_t size = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint16_t high;
+    Chunk chunk;
+    if (!iter->ReadUInt16(&high) || (i > 0 && high <= chunks.back().first) ||
+        !chunk.ReadFromPickle(iter)) {
+      return false;
+    }
+    size += chunk.size();
+    chunks.emplace_back(high, std::move(chunk));
+  }
+  chunks_ = flat_map<uint16_t, Chunk>(sorted_unique, std::move(chunks));
+  size_ = size;
+  return true;
+}
+
+}  // namespace base
@@ -0,0 +1,159 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_COMPRESSED_BITMAP_H_
+#define BASE_CONTAINERS_COMPRESSED_BITMAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/flat_map.h"
+#include "base/functional/function_ref.h"
+
+namespace base {
+
+class Pickle;
+class PickleIterator;
+
+// CompressedBitmap is a set of uint32_t values, for large sets such as sets of
+// IDs, hashes or offsets. It takes much less memory than a flat_set<uint32_t>,
+// and its unions and intersections work on whole words instead of one value
+// at a time. Use EnumSet or std::bitset for small domains, and flat_set for
+// small sets, or for sets so sparse that most chunks (see below) would hold a
+// handful of values, since each chunk has a fixed overhead of about 64 bytes.
+//
+// Like a roaring bitmap, the values are split by their high 16 bits into
+// chunks, and each chunk stores the low 16 bits of its values in the smallest
+// of:
+//  - an array: the sorted values, 2 bytes each, for up to 4096 values;
+//  - a bitmap: 2^16 bits (8 kB), for chunks with more values;
+//  - runs: the sorted [first, last] ranges of consecutive values, 4 bytes
+//    each. Runs are only made by Optimize(), and are converted back to an
+//    array or a bitmap when the chunk is modified.
+//
+// Example usage:
+//   base::CompressedBitmap seen;
+//   seen.Add(hash);
+//   if (seen.Contains(other_hash)) { ... }
+//
+//   base::CompressedBitmap common = seen & other_seen;
+//   common.ForEach([](uint32_t value) { ... });
+class BASE_EXPORT CompressedBitmap {
+ public:
+  CompressedBitmap();
+  CompressedBitmap(const CompressedBitmap&);
+  CompressedBitmap(CompressedBitmap&&) noexcept;
+  CompressedBitmap& operator=(const CompressedBitmap&);
+  CompressedBitmap& operator=(CompressedBitmap&&) noexcept;
+  ~CompressedBitmap();
+
+  // Returns whether `value` was added, i.e. was not already in the set.
+  bool Add(uint32_t value);
+
+  // Returns whether `value` was removed, i.e. was in the set.
+  bool Remove(uint32_t value);
+
+  bool Contains(uint32_t value) const;
+
+  // The number of values in the set, which is O(1).
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  void clear();
+
+  // Calls `callback` with each value of the set, in increasing order.
+  void ForEach(FunctionRef<void(uint32_t)> callback) const;
+
+  // Converts the chunks made of few runs of consecutive values to runs. Call
+  // this once a set is built, before keeping it around or serializing it.
+  void Optimize();
+
+  CompressedBitmap& operator|=(const CompressedBitmap& other);
+  CompressedBitmap& operator&=(const CompressedBitmap& other);
+  friend CompressedBitmap operator|(const CompressedBitmap& lhs,
+                                    const CompressedBitmap& rhs) {
+    CompressedBitmap result = lhs;
+    result |= rhs;
+    return result;
+  }
+  friend CompressedBitmap operator&(const CompressedBitmap& lhs,
+                                    const CompressedBitmap& rhs) {
+    CompressedBitmap result = lhs;
+    result &= rhs;
+    return result;
+  }
+
+  // Sets are equal if they have the same values, whatever their layout.
+  BASE_EXPORT friend bool operator==(const CompressedBitmap& lhs,
+                                     const CompressedBitmap& rhs);
+
+  size_t EstimateMemoryUsage() const;
+
+  // ReadFromPickle() returns false, and leaves the set empty, if the data
+  // isn't a valid set written by WriteToPickle().
+  void WriteToPickle(Pickle* pickle) const;
+  bool ReadFromPickle(PickleIterator* iter);
+
+ private:
+  // The values of the set which share the same high 16 bits.
+  class Chunk {
+   public:
+    enum class Type : int { kArray, kBitmap, kRun };
+
+    // Chunks with more values than this use a bitmap rather than an array.
+    static constexpr size_t kMaxArraySize = 4096;
+    static constexpr size_t kBitmapWords = 65536 / 64;
+
+    Chunk();
+    Chunk(const Chunk&);
+    Chunk(Chunk&&) noexcept;
+    Chunk& operator=(const Chunk&);
+    Chunk& operator=(Chunk&&) noexcept;
+    ~Chunk();
+
+    static Chunk Union(const Chunk& lhs, const Chunk& rhs);
+    static Chunk Intersection(const Chunk& lhs, const Chunk& rhs);
+
+    Type type() const { return type_; }
+    size_t size() const { return size_; }
+
+    bool Add(uint16_t value);
+    bool Remove(uint16_t value);
+    bool Contains(uint16_t value) const;
+    void ForEach(uint32_t high, FunctionRef<void(uint32_t)> callback) const;
+    void Optimize();
+
+    bool Equals(const Chunk& other) const;
+    size_t EstimateMemoryUsage() const;
+
+    void WriteToPickle(Pickle* pickle) const;
+    bool ReadFromPickle(PickleIterator* iter);
+
+   private:
+    // Returns the chunk with the values of the bitmap `words`.
+    static Chunk FromBitmap(std::vector<uint64_t> words);
+
+    std::vector<uint64_t> ToBitmap() const;
+    void OrInto(std::vector<uint64_t>& words) const;
+
+    // Converts runs to an array or a bitmap.
+    void Decompress();
+
+    Type type_ = Type::kArray;
+    uint32_t size_ = 0;
+    // The sorted values of an array, or the [first, last] pairs of runs.
+    std::vector<uint16_t> values_;
+    // The kBitmapWords words of a bitmap.
+    std::vector<uint64_t> words_;
+  };
+
+  flat_map<uint16_t, Chunk> chunks_;
+  size_t size_ = 0;
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_COMPRESSED_BITMAP_H_
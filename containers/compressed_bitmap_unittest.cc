@@ -0,0 +1,293 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/compressed_bitmap.h"
+
+#include <stdint.h>
+
+#include <set>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/pickle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+std::vector<uint32_t> ToVector(const CompressedBitmap& bitmap) {
+  std::vector<uint32_t> values;
+  bitmap.ForEach([&values](uint32_t value) { values.push_back(value); });
+  return values;
+}
+
+// Checks that `bitmap` holds exactly `expected`.
+void ExpectEqual(const std::set<uint32_t>& expected,
+                 const CompressedBitmap& bitmap) {
+  EXPECT_EQ(expected.size(), bitmap.size());
+  EXPECT_EQ(std::vector<uint32_t>(expected.begin(), expected.end()),
+            ToVector(bitmap));
+}
+
+// Adds the same values to `bitmap` and `expected`: a sparse chunk, a dense
+// chunk, and a chunk of runs.
+void AddMixedValues(uint32_t seed,
+                    CompressedBitmap& bitmap,
+                    std::set<uint32_t>& expected) {
+  for (uint32_t i = 0; i < 100; ++i) {
+    const uint32_t value = (i * 7919 + seed) % 50000;
+    bitmap.Add(value);
+    expected.insert(value);
+  }
+  for (uint32_t i = 0; i < 10000; ++i) {
+    const uint32_t value = (1 << 16) + (i * 37 + seed) % 30000;
+    bitmap.Add(value);
+    expected.insert(value);
+  }
+  for (uint32_t i = 0; i < 5000; ++i) {
+    const uint32_t value = (7 << 16) + seed + (i / 100) * 300 + i % 100;
+    bitmap.Add(value);
+    expected.insert(value);
+  }
+}
+
+}  // namespace
+
+TEST(CompressedBitmapTest, Empty) {
+  CompressedBitmap bitmap;
+  EXPECT_TRUE(bitmap.empty());
+  EXPECT_EQ(0u, bitmap.size());
+  EXPECT_FALSE(bitmap.Contains(0));
+  EXPECT_FALSE(bitmap.Remove(0));
+  EXPECT_TRUE(ToVector(bitmap).empty());
+}
+
+TEST(CompressedBitmapTest, AddRemoveContains) {
+  CompressedBitmap bitmap;
+  EXPECT_TRUE(bitmap.Add(5));
+  EXPECT_TRUE(bitmap.Add(0xFFFFFFFF));
+  EXPECT_TRUE(bitmap.Add(1 << 16));
+  EXPECT_FALSE(bitmap.Add(5));
+  EXPECT_EQ(3u, bitmap.size());
+
+  EXPECT_TRUE(bitmap.Contains(5));
+  EXPECT_TRUE(bitmap.Contains(0xFFFFFFFF));
+  EXPECT_TRUE(bitmap.Contains(1 << 16));
+  EXPECT_FALSE(bitmap.Contains(6));
+  EXPECT_FALSE(bitmap.Contains((1 << 16) + 5));
+  EXPECT_EQ((std::vector<uint32_t>{5, 1 << 16, 0xFFFFFFFF}), ToVector(bitmap));
+
+  EXPECT_TRUE(bitmap.Remove(5));
+  EXPECT_FALSE(bitmap.Remove(5));
+  EXPECT_FALSE(bitmap.Contains(5));
+  EXPECT_EQ(2u, bitmap.size());
+
+  bitmap.clear();
+  EXPECT_TRUE(bitmap.empty());
+  EXPECT_FALSE(bitmap.Contains(1 << 16));
+}
+
+TEST(CompressedBitmapTest, DenseChunk) {
+  CompressedBitmap bitmap;
+  std::set<uint32_t> expected;
+  // More values than fit in an array.
+  for (uint32_t i = 0; i < 20000; i += 3) {
+    EXPECT_TRUE(bitmap.Add(i));
+    expected.insert(i);
+  }
+  ExpectEqual(expected, bitmap);
+  EXPECT_TRUE(bitmap.Contains(19998));
+  EXPECT_FALSE(bitmap.Contains(19999));
+
+  // Back below the size of an array.
+  for (uint32_t i = 0; i < 20000; i += 6) {
+    EXPECT_TRUE(bitmap.Remove(i));
+    expected.erase(i);
+  }
+  ExpectEqual(expected, bitmap);
+  EXPECT_TRUE(bitmap.Contains(3));
+  EXPECT_FALSE(bitmap.Contains(6));
+}
+
+TEST(CompressedBitmapTest, Optimize) {
+  CompressedBitmap bitmap;
+  std::set<uint32_t> expected;
+  for (uint32_t i = 0; i < 65536; ++i) {
+    bitmap.Add(i);
+    expected.insert(i);
+  }
+  for (uint32_t i = 100000; i < 101000; ++i) {
+    bitmap.Add(i);
+    expected.insert(i);
+  }
+  const size_t usage = bitmap.EstimateMemoryUsage();
+  bitmap.Optimize();
+  EXPECT_LT(bitmap.EstimateMemoryUsage(), usage / 50);
+  ExpectEqual(expected, bitmap);
+  EXPECT_TRUE(bitmap.Contains(65535));
+  EXPECT_TRUE(bitmap.Contains(100999));
+  EXPECT_FALSE(bitmap.Contains(101000));
+  EXPECT_FALSE(bitmap.Contains(99999));
+
+  // Modifying the runs still works.
+  EXPECT_FALSE(bitmap.Add(100500));
+  EXPECT_TRUE(bitmap.Remove(100500));
+  EXPECT_TRUE(bitmap.Add(101000));
+  EXPECT_TRUE(bitmap.Remove(0));
+  expected.erase(100500);
+  expected.insert(101000);
+  expected.erase(0);
+  ExpectEqual(expected, bitmap);
+}
+
+TEST(CompressedBitmapTest, UnionAndIntersection) {
+  CompressedBitmap a;
+  CompressedBitmap b;
+  std::set<uint32_t> expected_a;
+  std::set<uint32_t> expected_b;
+  AddMixedValues(0, a, expected_a);
+  AddMixedValues(50, b, expected_b);
+  b.Add(200 << 16);
+  expected_b.insert(200 << 16);
+
+  std::set<uint32_t> expected_union = expected_a;
+  expected_union.insert(expected_b.begin(), expected_b.end());
+  std::set<uint32_t> expected_intersection;
+  for (uint32_t value : expected_a) {
+    if (expected_b.count(value)) {
+      expected_intersection.insert(value);
+    }
+  }
+
+  ExpectEqual(expected_union, a | b);
+  ExpectEqual(expected_intersection, a & b);
+
+  // The same with some chunks as runs.
+  a.Optimize();
+  ExpectEqual(expected_union, a | b);
+  ExpectEqual(expected_intersection, a & b);
+  b.Optimize();
+  ExpectEqual(expected_union, b | a);
+  ExpectEqual(expected_intersection, b & a);
+
+  ExpectEqual(expected_a, a | a);
+  ExpectEqual(expected_a, a & a);
+  ExpectEqual(expected_a, a | CompressedBitmap());
+  ExpectEqual({}, a & CompressedBitmap());
+}
+
+TEST(CompressedBitmapTest, Equality) {
+  CompressedBitmap a;
+  CompressedBitmap b;
+  std::set<uint32_t> expected;
+  AddMixedValues(0, a, expected);
+  AddMixedValues(0, b, expected);
+  EXPECT_EQ(a, b);
+
+  // Equal whatever the layout.
+  b.Optimize();
+  EXPECT_EQ(a, b);
+
+  b.Add(0xFFFFFFFF);
+  EXPECT_NE(a, b);
+  b.Remove(0xFFFFFFFF);
+  b.Remove(*expected.begin());
+  EXPECT_NE(a, b);
+}
+
+TEST(CompressedBitmapTest, Pickle) {
+  CompressedBitmap bitmap;
+  std::set<uint32_t> expected;
+  AddMixedValues(0, bitmap, expected);
+  bitmap.Optimize();
+
+  Pickle pickle;
+  bitmap.WriteToPickle(&pickle);
+  CompressedBitmap().WriteToPickle(&pickle);
+
+  PickleIterator iter(pickle);
+  CompressedBitmap read;
+  ASSERT_TRUE(read.ReadFromPickle(&iter));
+  ExpectEqual(expected, read);
+  EXPECT_EQ(bitmap, read);
+  ASSERT_TRUE(read.ReadFromPickle(&iter));
+  EXPECT_TRUE(read.empty());
+}
+
+TEST(CompressedBitmapTest, PickleInvalid) {
+  {
+    // Truncated.
+    Pickle pickle;
+    pickle.WriteUInt32(1);
+    pickle.WriteUInt16(0);
+    PickleIterator iter(pickle);
+    CompressedBitmap read;
+    EXPECT_FALSE(read.ReadFromPickle(&iter));
+    EXPECT_TRUE(read.empty());
+  }
+  {
+    // An unsorted array.
+    Pickle pickle;
+    pickle.WriteUInt32(1);
+    pickle.WriteUInt16(0);
+    pickle.WriteInt(0);
+    const uint16_t values[] = {2, 1};
+    pickle.WriteData(as_byte_span(values));
+    PickleIterator iter(pickle);
+    CompressedBitmap read;
+    EXPECT_FALSE(read.ReadFromPickle(&iter));
+  }
+  {
+    // Chunks out of order.
+    Pickle pickle;
+    pickle.WriteUInt32(2);
+    pickle.WriteUInt16(1);
+    pickle.WriteInt(0);
+    const uint16_t values[] = {1};
+    pickle.WriteData(as_byte_span(values));
+    pickle.WriteUInt16(0);
+    pickle.WriteInt(0);
+    pickle.WriteData(as_byte_span(values));
+    PickleIterator iter(pickle);
+    CompressedBitmap read;
+    EXPECT_FALSE(read.ReadFromPickle(&iter));
+  }
+  {
+    // Overlapping runs.
+    Pickle pickle;
+    pickle.WriteUInt32(1);
+    pickle.WriteUInt16(0);
+    pickle.WriteInt(2);
+    const uint16_t runs[] = {1, 5, 5, 8};
+    pickle.WriteData(as_byte_span(runs));
+    PickleIterator iter(pickle);
+    CompressedBitmap read;
+    EXPECT_FALSE(read.ReadFromPickle(&iter));
+  }
+}
+
+TEST(CompressedBitmapTest, SmallerThanFlatSet) {
+  // 100000 24-bit hashes.
+  CompressedBitmap bitmap;
+  std::vector<uint32_t> values;
+  for (uint32_t i = 0; i < 100000; ++i) {
+    values.push_back((i * 2654435761u) >> 8);
+  }
+  for (uint32_t value : values) {
+    bitmap.Add(value);
+  }
+  const flat_set<uint32_t> set(values);
+  EXPECT_EQ(set.size(), bitmap.size());
+  EXPECT_LT(bitmap.EstimateMemoryUsage(), set.size() * sizeof(uint32_t));
+
+  // Dense IDs take 8 kB per 65536 values.
+  CompressedBitmap ids;
+  for (uint32_t i = 0; i < 1000000; ++i) {
+    ids.Add(i);
+  }
+  EXPECT_LT(ids.EstimateMemoryUsage() * 10, ids.size() * sizeof(uint32_t));
+}
+
+}  // namespace base
@@ -0,0 +1,196 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_CONCURRENT_LRU_CACHE_H_
+#define BASE_CONTAINERS_CONCURRENT_LRU_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/containers/lru_cache.h"
+#include "base/synchronization/rw_lock.h"
+#include "base/thread_annotations.h"
+
+namespace base {
+
+enum class ConcurrentLRUCacheRecency {
+  // Get() moves the item to the front of the recency list of its shard, which
+  // requires exclusive access to the shard.
+  kExact,
+  // Get() only sets a "referenced" bit on the item, under a read lock, so that
+  // concurrent hits on a shard don't serialize. Referenced items get a second
+  // chance when they reach the back of the list (CLOCK), so eviction
+  // approximates LRU.
+  kApproximate,
+};
+
+// A hashing LRU cache which can be used from multiple threads. Items are
+// distributed between `num_shards` shards by the hash of their key, each with
+// its own lock and its own LRU list which holds up to `max_size / num_shards`
+// items, rounded up. Eviction is therefore LRU per shard, and only
+// approximately LRU for the cache as a whole.
+//
+// Values are returned by copy, since references into the cache would be
+// invalidated by concurrent eviction, so `ValueType` should be cheap to copy,
+// e.g. a scoped_refptr.
+template <class KeyType,
+          class ValueType,
+          class KeyHash = std::hash<KeyType>,
+          class KeyEqual = std::equal_to<KeyType>>
+class ConcurrentLRUCache {
+ public:
+  static constexpr size_t kDefaultNumShards = 16;
+
+  explicit ConcurrentLRUCache(
+      size_t max_size,
+      size_t num_shards = kDefaultNumShards,
+      ConcurrentLRUCacheRecency recency = ConcurrentLRUCacheRecency::kExact)
+      : num_shards_(num_shards),
+        recency_(recency),
+        shards_(std::make_unique<Shard[]>(num_shards)) {
+    CHECK_GT(num_shards, 0u);
+    CHECK_GT(max_size, 0u);
+    const size_t max_size_per_shard = (max_size + num_shards - 1) / num_shards;
+    for (size_t i = 0; i < num_shards_; ++i) {
+      AutoWriteLock lock(shards_[i].lock);
+      shards_[i].cache = ShardCache(max_size_per_shard);
+    }
+  }
+
+  ConcurrentLRUCache(const ConcurrentLRUCache&) = delete;
+  ConcurrentLRUCache& operator=(const ConcurrentLRUCache&) = delete;
+  ~ConcurrentLRUCache() = default;
+
+  // Returns a copy of the value of `key`, or nullopt if not found, and marks
+  // it as recently used.
+  std::optional<ValueType> Get(const KeyType& key) {
+    Shard& shard = GetShard(key);
+    if (recency_ == ConcurrentLRUCacheRecency::kApproximate) {
+      AutoReadLock lock(shard.lock);
+      const ShardCache& cache = shard.cache;
+      auto it = cache.Peek(key);
+      if (it == cache.end()) {
+        return std::nullopt;
+      }
+      // Avoids writing to the cache line of hot items on each hit.
+      if (!it->second.referenced.load(std::memory_order_relaxed)) {
+        it->second.referenced.store(true, std::memory_order_relaxed);
+      }
+      return it->second.value;
+    }
+    AutoWriteLock lock(shard.lock);
+    auto it = shard.cache.Get(key);
+    if (it == shard.cache.end()) {
+      return std::nullopt;
+    }
+    return it->second.value;
+  }
+
+  // Inserts or replaces the value of `key`, possibly evicting the least
+  // recently used item of its shard.
+  void Put(KeyType key, ValueType value) {
+    Shard& shard = GetShard(key);
+    AutoWriteLock lock(shard.lock);
+    if (recency_ == ConcurrentLRUCacheRecency::kApproximate &&
+        shard.cache.size() >= shard.cache.max_size()) {
+      GiveSecondChances(shard);
+    }
+    shard.cache.Put(std::move(key), Entry(std::move(value)));
+  }
+
+  // Removes `key`. Returns whether it was found.
+  bool Erase(const KeyType& key) {
+    Shard& shard = GetShard(key);
+    AutoWriteLock lock(shard.lock);
+    auto it = shard.cache.Peek(key);
+    if (it == shard.cache.end()) {
+      return false;
+    }
+    shard.cache.Erase(it);
+    return true;
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < num_shards_; ++i) {
+      AutoWriteLock lock(shards_[i].lock);
+      shards_[i].cache.Clear();
+    }
+  }
+
+  // Returns the number of items. Only a snapshot if other threads modify the
+  // cache concurrently.
+  size_t size() const {
+    size_t size = 0;
+    for (size_t i = 0; i < num_shards_; ++i) {
+      AutoReadLock lock(shards_[i].lock);
+      size += shards_[i].cache.size();
+    }
+    return size;
+  }
+
+  size_t num_shards() const { return num_shards_; }
+
+ private:
+  struct Entry {
+    explicit Entry(ValueType value) : value(std::move(value)) {}
+    Entry(Entry&& other)
+        : value(std::move(other.value)),
+          referenced(other.referenced.load(std::memory_order_relaxed)) {}
+    Entry& operator=(Entry&& other) {
+      value = std::move(other.value);
+      referenced.store(other.referenced.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+      return *this;
+    }
+
+    ValueType value;
+    // Set by Get() with kApproximate, under the read lock.
+    mutable std::atomic<bool> referenced{false};
+  };
+
+  using ShardCache = HashingLRUCache<KeyType, Entry, KeyHash, KeyEqual>;
+
+  // Each shard is on its own cache line.
+  struct alignas(64) Shard {
+    mutable RWLock lock;
+    ShardCache cache GUARDED_BY(lock){ShardCache::NO_AUTO_EVICT};
+  };
+
+  Shard& GetShard(const KeyType& key) {
+    // Uses the high bits of the mixed hash, so that the shard is independent
+    // of the bucket of the key in the shard's index.
+    const uint64_t hash = static_cast<uint64_t>(KeyHash()(key));
+    return shards_[((hash * 0x9E3779B97F4A7C15ull) >> 32) % num_shards_];
+  }
+
+  // Moves referenced items from the back of the list of `shard` to its front,
+  // clearing their bit, so that the next item evicted is unreferenced.
+  static void GiveSecondChances(Shard& shard)
+      EXCLUSIVE_LOCKS_REQUIRED(shard.lock) {
+    // Terminates since each iteration clears a bit.
+    while (!shard.cache.empty()) {
+      auto it = shard.cache.rbegin();
+      if (!it->second.referenced.load(std::memory_order_relaxed)) {
+        return;
+      }
+      it->second.referenced.store(false, std::memory_order_relaxed);
+      shard.cache.Get(it->first);
+    }
+  }
+
+  const size_t num_shards_;
+  const ConcurrentLRUCacheRecency recency_;
+  const std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_CONCURRENT_LRU_CACHE_H_
@@ -0,0 +1,152 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/concurrent_lru_cache.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/containers/lru_cache.h"
+#include "base/memory/raw_ref.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+namespace {
+
+constexpr char kMetricPrefixLockedLRUCache[] = "LockedLRUCache.";
+constexpr char kMetricPrefixConcurrentLRUCache[] = "ConcurrentLRUCache.";
+constexpr char kMetricPrefixApproximateConcurrentLRUCache[] =
+    "ConcurrentLRUCacheApproximate.";
+constexpr char kMetricThroughput[] = "throughput";
+
+constexpr size_t kMaxSize = 4096;
+// Twice as many keys as the cache can hold, so that some lookups miss.
+constexpr uint32_t kNumKeys = 2 * kMaxSize;
+constexpr int kNumOperationsPerThread = 1000000;
+// One operation out of `kPutRatio` is a Put().
+constexpr int kPutRatio = 10;
+
+// The cache most clients use today: a HashingLRUCache behind a Lock.
+class LockedLRUCache {
+ public:
+  LockedLRUCache() : cache_(kMaxSize) {}
+
+  std::optional<uint64_t> Get(uint32_t key) {
+    AutoLock lock(lock_);
+    auto it = cache_.Get(key);
+    if (it == cache_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void Put(uint32_t key, uint64_t value) {
+    AutoLock lock(lock_);
+    cache_.Put(key, value);
+  }
+
+ private:
+  Lock lock_;
+  HashingLRUCache<uint32_t, uint64_t> cache_ GUARDED_BY(lock_);
+};
+
+template <typename CacheType>
+class Worker : public SimpleThread {
+ public:
+  Worker(CacheType& cache, uint32_t seed)
+      : SimpleThread("ConcurrentLRUCachePerfTest"),
+        cache_(cache),
+        state_(seed | 1) {}
+
+  void Run() override {
+    for (int i = 0; i < kNumOperationsPerThread; ++i) {
+      const uint32_t key = NextRandom() % kNumKeys;
+      if (i % kPutRatio == 0) {
+        cache_->Put(key, key);
+      } else if (cache_->Get(key)) {
+        ++hits_;
+      }
+    }
+  }
+
+  int hits() const { return hits_; }
+
+ private:
+  // xorshift32, which is cheap enough not to dominate the measurement.
+  uint32_t NextRandom() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  raw_ref<CacheType> cache_;
+  uint32_t state_;
+  int hits_ = 0;
+};
+
+template <typename CacheType>
+void RunTest(CacheType& cache,
+             const std::string& metric_prefix,
+             int num_threads) {
+  std::vector<std::unique_ptr<Worker<CacheType>>> workers;
+  for (int i = 0; i < num_threads; ++i) {
+    workers.push_back(std::make_unique<Worker<CacheType>>(
+        cache, static_cast<uint32_t>(i + 1) * 0x9E3779B9u));
+  }
+
+  ElapsedTimer timer;
+  for (auto& worker : workers) {
+    worker->Start();
+  }
+  int hits = 0;
+  for (auto& worker : workers) {
+    worker->Join();
+    hits += worker->hits();
+  }
+  const TimeDelta elapsed = timer.Elapsed();
+  EXPECT_GT(hits, 0);
+
+  perf_test::PerfResultReporter reporter(
+      metric_prefix, std::to_string(num_threads) + "_threads");
+  reporter.RegisterImportantMetric(kMetricThroughput, "ops/s");
+  reporter.AddResult(kMetricThroughput, num_threads * kNumOperationsPerThread /
+                                            elapsed.InSecondsF());
+}
+
+class ConcurrentLRUCachePerfTest : public testing::TestWithParam<int> {};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         ConcurrentLRUCachePerfTest,
+                         testing::Values(1, 4, 8));
+
+TEST_P(ConcurrentLRUCachePerfTest, LockedLRUCache) {
+  LockedLRUCache cache;
+  RunTest(cache, kMetricPrefixLockedLRUCache, GetParam());
+}
+
+TEST_P(ConcurrentLRUCachePerfTest, ConcurrentLRUCache) {
+  ConcurrentLRUCache<uint32_t, uint64_t> cache(kMaxSize);
+  RunTest(cache, kMetricPrefixConcurrentLRUCache, GetParam());
+}
+
+TEST_P(ConcurrentLRUCachePerfTest, ApproximateConcurrentLRUCache) {
+  ConcurrentLRUCache<uint32_t, uint64_t> cache(
+      kMaxSize, ConcurrentLRUCache<uint32_t, uint64_t>::kDefaultNumShards,
+      ConcurrentLRUCacheRecency::kApproximate);
+  RunTest(cache, kMetricPrefixApproximateConcurrentLRUCache, GetParam());
+}
+
+}  // namespace
+}  // namespace base
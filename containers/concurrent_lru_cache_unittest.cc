@@ -0,0 +1,127 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/concurrent_lru_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/memory/raw_ref.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class Worker : public SimpleThread {
+ public:
+  Worker(ConcurrentLRUCache<int, int>& cache, int first_key)
+      : SimpleThread("ConcurrentLRUCacheTest"),
+        cache_(cache),
+        first_key_(first_key) {}
+
+  void Run() override {
+    for (int i = first_key_; i < first_key_ + 1000; ++i) {
+      cache_->Put(i, i);
+      std::optional<int> value = cache_->Get(i);
+      // The item may have been evicted by another thread.
+      if (value) {
+        EXPECT_EQ(i, *value);
+      }
+    }
+  }
+
+ private:
+  raw_ref<ConcurrentLRUCache<int, int>> cache_;
+  const int first_key_;
+};
+
+}  // namespace
+
+TEST(ConcurrentLRUCacheTest, Basic) {
+  ConcurrentLRUCache<std::string, int> cache(100, 4);
+  EXPECT_EQ(4u, cache.num_shards());
+  EXPECT_EQ(std::nullopt, cache.Get("a"));
+
+  cache.Put("a", 1);
+  cache.Put("b", 2);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(1, cache.Get("a"));
+  cache.Put("a", 3);
+  EXPECT_EQ(3, cache.Get("a"));
+  EXPECT_EQ(2u, cache.size());
+
+  EXPECT_TRUE(cache.Erase("a"));
+  EXPECT_FALSE(cache.Erase("a"));
+  EXPECT_EQ(std::nullopt, cache.Get("a"));
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(ConcurrentLRUCacheTest, EvictsLeastRecentlyUsed) {
+  ConcurrentLRUCache<int, int> cache(3, 1);
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Put(3, 3);
+  cache.Get(1);
+  cache.Put(4, 4);
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_EQ(std::nullopt, cache.Get(2));
+  EXPECT_EQ(1, cache.Get(1));
+}
+
+TEST(ConcurrentLRUCacheTest, ApproximateRecency) {
+  ConcurrentLRUCache<int, int> cache(3, 1,
+                                     ConcurrentLRUCacheRecency::kApproximate);
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Put(3, 3);
+  // 1 is the oldest item, but it gets a second chance since it was used.
+  cache.Get(1);
+  cache.Put(4, 4);
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_EQ(std::nullopt, cache.Get(2));
+  EXPECT_EQ(1, cache.Get(1));
+
+  // All the items were used: the oldest one is evicted once their bits are
+  // cleared.
+  cache.Get(3);
+  cache.Get(4);
+  cache.Put(5, 5);
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_EQ(std::nullopt, cache.Get(3));
+}
+
+TEST(ConcurrentLRUCacheTest, ShardCapacity) {
+  ConcurrentLRUCache<int, int> cache(64, 8);
+  for (int i = 0; i < 1000; ++i) {
+    cache.Put(i, i);
+  }
+  // Each shard holds up to 8 items.
+  EXPECT_LE(cache.size(), 64u);
+  EXPECT_GT(cache.size(), 0u);
+}
+
+TEST(ConcurrentLRUCacheTest, MultipleThreads) {
+  for (ConcurrentLRUCacheRecency recency :
+       {ConcurrentLRUCacheRecency::kExact,
+        ConcurrentLRUCacheRecency::kApproximate}) {
+    ConcurrentLRUCache<int, int> cache(256, 4, recency);
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < 4; ++i) {
+      workers.push_back(std::make_unique<Worker>(cache, i * 1000));
+      workers.back()->Start();
+    }
+    for (auto& worker : workers) {
+      worker->Join();
+    }
+    EXPECT_LE(cache.size(), 256u);
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,355 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// This is a benchmark of the throughput and allocation counts of the base
+// containers, compared with their std counterparts. It is the companion of
+// containers_memory_benchmark, which measures the memory footprint of maps.
+//
+// For each container and each size, the benchmark fills containers of that
+// size, looks up each element, iterates over the containers, then erases each
+// element. Each of these phases is timed, and the allocations made during the
+// phase are counted with an allocator hook. Small sizes are repeated over
+// many containers so that each phase runs about kTargetOperations times.
+//
+// Usage:
+// $ out/release/containers_benchmark --output=results.json
+//
+// The results are written as JSON to the --output file, or to stdout:
+//
+// {
+//   "results": [ {
+//     "allocated_bytes_per_op": 48.0,
+//     "allocations_per_op": 1.0,
+//     "container": "std::map",
+//     "family": "map",
+//     "ns_per_op": 35.2,
+//     "operation": "insert",
+//     "size": 64
+//   }, ... ]
+// }
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "base/allocator/dispatcher/dispatcher.h"
+#include "base/allocator/dispatcher/notification_data.h"
+#include "base/check.h"
+#include "base/command_line.h"
+#include "base/containers/circular_deque.h"
+#include "base/containers/dense_id_map.h"
+#include "base/containers/flat_map.h"
+#include "base/containers/id_map.h"
+#include "base/containers/lru_cache.h"
+#include "base/containers/small_map.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/functional/function_ref.h"
+#include "base/json/json_writer.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+
+namespace {
+
+constexpr size_t kSizes[] = {4, 16, 64, 256, 1024, 4096};
+constexpr size_t kTargetOperations = 1 << 18;
+
+std::atomic<bool> count_allocations;
+std::atomic<uint64_t> allocation_count;
+std::atomic<uint64_t> allocated_bytes;
+
+// Keeps the results of the measured operations alive.
+volatile uint64_t sink;
+
+struct AllocationCounter {
+ public:
+  void OnAllocation(
+      const base::allocator::dispatcher::AllocationNotificationData&
+          allocation_data) {
+    if (count_allocations.load(std::memory_order_relaxed)) {
+      allocation_count.fetch_add(1, std::memory_order_relaxed);
+      allocated_bytes.fetch_add(allocation_data.size(),
+                                std::memory_order_relaxed);
+    }
+  }
+
+  void OnFree(const base::allocator::dispatcher::FreeNotificationData&) {}
+
+  static void Install() {
+    static AllocationCounter counter;
+    base::allocator::dispatcher::Dispatcher::GetInstance().InitializeForTesting(
+        &counter);
+  }
+};
+
+struct Measurement {
+  base::TimeDelta elapsed;
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+};
+
+// Runs `phase`, timing it and counting the allocations it makes.
+Measurement Measure(base::FunctionRef<void()> phase) {
+  const uint64_t allocations_before = allocation_count.load();
+  const uint64_t bytes_before = allocated_bytes.load();
+  count_allocations.store(true);
+  base::ElapsedTimer timer;
+  phase();
+  Measurement measurement;
+  measurement.elapsed = timer.Elapsed();
+  count_allocations.store(false);
+  measurement.allocations = allocation_count.load() - allocations_before;
+  measurement.bytes = allocated_bytes.load() - bytes_before;
+  return measurement;
+}
+
+// The keys inserted in the containers. Their order is pseudo-random, so that
+// sorted containers don't always insert at the end.
+uint64_t GetValue(size_t i) {
+  return (i + 1) * 0x9E3779B97F4A7C15ull;
+}
+
+// The following structs adapt each kind of container to the operations of the
+// benchmark: Insert() returns the key to pass to Lookup() and Erase().
+
+template <typename Map>
+struct MapOps {
+  using Container = Map;
+  using Key = uint64_t;
+
+  static std::unique_ptr<Map> Create(size_t) { return std::make_unique<Map>(); }
+  static Key Insert(Map& map, uint64_t value) {
+    map.insert({value, value});
+    return value;
+  }
+  static uint64_t Lookup(Map& map, Key key) { return map.find(key)->second; }
+  static void Erase(Map& map, Key key) { map.erase(key); }
+  static uint64_t Iterate(Map& map) {
+    uint64_t sum = 0;
+    for (const auto& [key, value] : map) {
+      sum += value;
+    }
+    return sum;
+  }
+};
+
+// Elements are erased from the front, in insertion order.
+template <typename Deque>
+struct DequeOps {
+  using Container = Deque;
+  using Key = size_t;
+
+  static std::unique_ptr<Deque> Create(size_t) {
+    return std::make_unique<Deque>();
+  }
+  static Key Insert(Deque& deque, uint64_t value) {
+    deque.push_back(value);
+    return deque.size() - 1;
+  }
+  static uint64_t Lookup(Deque& deque, Key key) { return deque[key]; }
+  static void Erase(Deque& deque, Key) { deque.pop_front(); }
+  static uint64_t Iterate(Deque& deque) {
+    uint64_t sum = 0;
+    for (uint64_t value : deque) {
+      sum += value;
+    }
+    return sum;
+  }
+};
+
+// Lookups use Get(), which also moves the element to the front. The caches are
+// large enough that nothing is evicted.
+template <typename Cache>
+struct LRUCacheOps {
+  using Container = Cache;
+  using Key = uint64_t;
+
+  static std::unique_ptr<Cache> Create(size_t size) {
+    return std::make_unique<Cache>(size);
+  }
+  static Key Insert(Cache& cache, uint64_t value) {
+    cache.Put(value, value);
+    return value;
+  }
+  static uint64_t Lookup(Cache& cache, Key key) {
+    return cache.Get(key)->second;
+  }
+  static void Erase(Cache& cache, Key key) { cache.Erase(cache.Peek(key)); }
+  static uint64_t Iterate(Cache& cache) {
+    uint64_t sum = 0;
+    for (const auto& [key, value] : cache) {
+      sum += value;
+    }
+    return sum;
+  }
+};
+
+// The maps own the values, so that they hold different data as they would in
+// practice.
+template <typename Map>
+struct IDMapOps {
+  using Container = Map;
+  using Key = typename Map::KeyType;
+
+  static std::unique_ptr<Map> Create(size_t) { return std::make_unique<Map>(); }
+  static Key Insert(Map& map, uint64_t value) {
+    return map.Add(std::make_unique<uint64_t>(value));
+  }
+  static uint64_t Lookup(Map& map, Key key) { return *map.Lookup(key); }
+  static void Erase(Map& map, Key key) { map.Remove(key); }
+  static uint64_t Iterate(Map& map) {
+    uint64_t sum = 0;
+    for (typename Map::iterator it(&map); !it.IsAtEnd(); it.Advance()) {
+      sum += *it.GetCurrentValue();
+    }
+    return sum;
+  }
+};
+
+void AddResult(std::string_view family,
+               std::string_view container,
+               std::string_view operation,
+               size_t size,
+               size_t operations,
+               const Measurement& measurement,
+               base::Value::List& results) {
+  const double ops = static_cast<double>(operations);
+  results.Append(
+      base::Value::Dict()
+          .Set("family", family)
+          .Set("container", container)
+          .Set("operation", operation)
+          .Set("size", static_cast<int>(size))
+          .Set("ns_per_op",
+               static_cast<double>(measurement.elapsed.InNanoseconds()) / ops)
+          .Set("allocations_per_op",
+               static_cast<double>(measurement.allocations) / ops)
+          .Set("allocated_bytes_per_op",
+               static_cast<double>(measurement.bytes) / ops));
+}
+
+template <typename Ops>
+void Benchmark(std::string_view family,
+               std::string_view container,
+               base::Value::List& results) {
+  using Container = typename Ops::Container;
+  using Key = typename Ops::Key;
+
+  for (size_t size : kSizes) {
+    const size_t repetitions = std::max<size_t>(1, kTargetOperations / size);
+    const size_t operations = repetitions * size;
+
+    // Everything but the containers is allocated before the measurements.
+    std::vector<std::unique_ptr<Container>> containers;
+    containers.reserve(repetitions);
+    for (size_t r = 0; r < repetitions; ++r) {
+      containers.push_back(Ops::Create(size));
+    }
+    std::vector<std::vector<Key>> keys(repetitions, std::vector<Key>(size));
+
+    Measurement measurement = Measure([&] {
+      for (size_t r = 0; r < repetitions; ++r) {
+        for (size_t i = 0; i < size; ++i) {
+          keys[r][i] = Ops::Insert(*containers[r], GetValue(i));
+        }
+      }
+    });
+    AddResult(family, container, "insert", size, operations, measurement,
+              results);
+
+    measurement = Measure([&] {
+      uint64_t sum = 0;
+      for (size_t r = 0; r < repetitions; ++r) {
+        for (Key key : keys[r]) {
+          sum += Ops::Lookup(*containers[r], key);
+        }
+      }
+      sink = sum;
+    });
+    AddResult(family, container, "lookup", size, operations, measurement,
+              results);
+
+    measurement = Measure([&] {
+      uint64_t sum = 0;
+      for (size_t r = 0; r < repetitions; ++r) {
+        sum += Ops::Iterate(*containers[r]);
+      }
+      sink = sum;
+    });
+    AddResult(family, container, "iterate", size, operations, measurement,
+              results);
+
+    measurement = Measure([&] {
+      for (size_t r = 0; r < repetitions; ++r) {
+        for (Key key : keys[r]) {
+          Ops::Erase(*containers[r], key);
+        }
+      }
+    });
+    AddResult(family, container, "erase", size, operations, measurement,
+              results);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  base::CommandLine::Init(argc, argv);
+  AllocationCounter::Install();
+
+  using Map = std::map<uint64_t, uint64_t>;
+  using UnorderedMap = std::unordered_map<uint64_t, uint64_t>;
+
+  base::Value::List results;
+  Benchmark<MapOps<base::flat_map<uint64_t, uint64_t>>>("map", "base::flat_map",
+                                                        results);
+  Benchmark<MapOps<base::small_map<UnorderedMap>>>("map", "base::small_map",
+                                                    results);
+  Benchmark<MapOps<Map>>("map", "std::map", results);
+  Benchmark<MapOps<UnorderedMap>>("map", "std::unordered_map", results);
+  Benchmark<MapOps<absl::flat_hash_map<uint64_t, uint64_t>>>(
+      "map", "absl::flat_hash_map", results);
+
+  Benchmark<DequeOps<base::circular_deque<uint64_t>>>(
+      "deque", "base::circular_deque", results);
+  Benchmark<DequeOps<std::deque<uint64_t>>>("deque", "std::deque", results);
+
+  // There is no std LRU cache; the usual alternative to base::LRUCache is its
+  // hashing variant.
+  Benchmark<LRUCacheOps<base::LRUCache<uint64_t, uint64_t>>>(
+      "lru_cache", "base::LRUCache", results);
+  Benchmark<LRUCacheOps<base::HashingLRUCache<uint64_t, uint64_t>>>(
+      "lru_cache", "base::HashingLRUCache", results);
+
+  // IDMap is itself built on std::unordered_map.
+  Benchmark<IDMapOps<base::IDMap<std::unique_ptr<uint64_t>>>>(
+      "id_map", "base::IDMap", results);
+  Benchmark<IDMapOps<base::DenseIDMap<std::unique_ptr<uint64_t>>>>(
+      "id_map", "base::DenseIDMap", results);
+
+  std::string json;
+  CHECK(base::JSONWriter::WriteWithOptions(
+      base::Value::Dict().Set("results", std::move(results)),
+      base::JSONWriter::OPTIONS_PRETTY_PRINT, &json));
+
+  const base::FilePath output =
+      base::CommandLine::ForCurrentProcess()->GetSwitchValuePath("output");
+  if (output.empty()) {
+    fputs(json.c_str(), stdout);
+  } else {
+    CHECK(base::WriteFile(output, json));
+  }
+  return 0;
+}
@@ -11,6 +11,9 @@
 // and logs out the raw data, relying on analyze_containers_memory_usage.py to
 // turn the raw output into useful numbers.
 //
+// See containers_benchmark.cc for the throughput and allocation counts of the
+// operations of more containers.
+//
 // The output of consists of m (number of different key/value combinations being
 // tested) x n (number of different map types being tested) sections:
 //
@@ -60,6 +63,7 @@
 
 #include "base/allocator/dispatcher/dispatcher.h"
 #include "base/allocator/dispatcher/notification_data.h"
+#include "base/containers/flat_hash_map.h"
 #include "base/containers/flat_map.h"
 #include "base/logging.h"
 #include "base/strings/safe_sprintf.h"
@@ -168,6 +172,8 @@ void Measure(const Inserter& inserter) {
   MeasureOneContainer<absl::btree_map<K, V>>(inserter);
   RAW_LOG(INFO, "===== absl::flat_hash_map =====");
   MeasureOneContainer<absl::flat_hash_map<K, V, Hasher>>(inserter);
+  RAW_LOG(INFO, "===== base::flat_hash_map =====");
+  MeasureOneContainer<base::flat_hash_map<K, V, Hasher>>(inserter);
   RAW_LOG(INFO, "===== absl::node_hash_map =====");
   MeasureOneContainer<absl::node_hash_map<K, V, Hasher>>(inserter);
 }
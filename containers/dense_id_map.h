@@ -0,0 +1,321 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_DENSE_ID_MAP_H_
+#define BASE_CONTAINERS_DENSE_ID_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/memory/raw_ptr.h"
+#include "base/sequence_checker.h"
+
+namespace base {
+
+// DenseIDMap is a variant of base::IDMap (id_map.h) for maps which are large
+// or looked up often, and whose IDs are all generated by the map.
+//
+// The values are stored in a vector of slots, and the ID of a value encodes
+// the index of its slot, so that looking up an ID is an index operation
+// instead of hashing it, and iteration goes linearly through memory. The slots
+// of removed values are put on a free list and reused by Add(). Each slot also
+// has a generation counter, incremented when its value is removed, which is
+// part of the ID: IDs of removed values are never confused with the IDs of
+// the values which reuse their slot, and Lookup() returns null for them.
+//
+// Unlike IDMap, IDs can't be chosen by the caller (there is no AddWithID()),
+// IDs are 64-bit and aren't increasing, and memory is proportional to the
+// largest number of values the map held at once.
+//
+// It is safe to remove values during iteration. Slots freed during iteration
+// are only reused once the outermost iterator is destroyed.
+//
+// The map's value type (the V param) can be any dereferenceable type, such as a
+// raw pointer or smart pointer, and must be comparable with nullptr.
+template <typename V>
+class DenseIDMap final {
+ public:
+  // The low 32 bits are the index of the slot plus one, so that 0 is never a
+  // valid ID, and the high 32 bits are the generation of the slot.
+  using KeyType = uint64_t;
+
+ private:
+  // The value type `V` must be pointer-like and support operator*.
+  using T = typename std::remove_reference<decltype(*V())>::type;
+
+ public:
+  DenseIDMap() {
+    // As with IDMap, the map may be created on a different sequence than the
+    // one it is used on.
+    DETACH_FROM_SEQUENCE(sequence_checker_);
+  }
+
+  DenseIDMap(const DenseIDMap&) = delete;
+  DenseIDMap& operator=(const DenseIDMap&) = delete;
+
+  ~DenseIDMap() { DETACH_FROM_SEQUENCE(sequence_checker_); }
+
+  // Sets whether Add and Replace should DCHECK if passed in NULL data.
+  // Default is false.
+  void set_check_on_null_data(bool value) { check_on_null_data_ = value; }
+
+  // Adds `data` and returns its ID.
+  KeyType Add(V data) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    DCHECK(!check_on_null_data_ || data);
+    uint32_t index;
+    if (free_indices_.empty()) {
+      CHECK_LT(slots_.size(), std::numeric_limits<uint32_t>::max() - 1);
+      index = static_cast<uint32_t>(slots_.size());
+      slots_.emplace_back();
+    } else {
+      index = free_indices_.back();
+      free_indices_.pop_back();
+    }
+    Slot& slot = slots_[index];
+    slot.value = std::move(data);
+    slot.occupied = true;
+    ++size_;
+    return MakeKey(index, slot.generation);
+  }
+
+  // Removes the `id` from the map.
+  //
+  // Does nothing if the `id` is not in the map.
+  void Remove(KeyType id) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    Slot* slot = FindSlot(id);
+    if (slot) {
+      RemoveSlot(*slot, GetIndex(id));
+    }
+  }
+
+  // Replaces the value for `id` with `new_data` and returns the existing value.
+  //
+  // May only be called with an id that is in the map, and will CHECK()
+  // otherwise.
+  V Replace(KeyType id, V new_data) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    DCHECK(!check_on_null_data_ || new_data);
+    Slot* slot = FindSlot(id);
+    CHECK(slot);
+
+    using std::swap;
+    swap(slot->value, new_data);
+    return new_data;
+  }
+
+  void Clear() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      if (slots_[i].occupied) {
+        RemoveSlot(slots_[i], static_cast<uint32_t>(i));
+      }
+    }
+  }
+
+  bool IsEmpty() const {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    return size() == 0u;
+  }
+
+  // Returns whether `id` is in the map, even if its value is null. Returns
+  // false for the ID of a removed value, even if its slot was reused.
+  bool Contains(KeyType id) const {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    return FindSlot(id) != nullptr;
+  }
+
+  // Returns a pointer to raw value associated with `id` if the `id` is in the
+  // map and is not empty.
+  //
+  // The raw value is obtained by dereferencing the stored value type `V`.
+  //
+  // If the `id` is not in the map, or the value type compares as equal to
+  // nullptr, this function will return null.
+  T* Lookup(KeyType id) const {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    const Slot* slot = FindSlot(id);
+    if (!slot || slot->value == nullptr) {
+      return nullptr;
+    }
+    return std::addressof(*slot->value);
+  }
+
+  size_t size() const {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    return size_;
+  }
+
+#if defined(UNIT_TEST)
+  int iteration_depth() const { return iteration_depth_; }
+#endif  // defined(UNIT_TEST)
+
+  // It is safe to remove elements from the map during iteration. All iterators
+  // will remain valid. Values added during iteration may or may not be
+  // visited.
+  template <class ReturnType>
+  class Iterator {
+   public:
+    explicit Iterator(DenseIDMap<V>* map) : map_(map) { Init(); }
+
+    Iterator(const Iterator& iter) : map_(iter.map_), index_(iter.index_) {
+      Init();
+    }
+
+    const Iterator& operator=(const Iterator& iter) {
+      map_ = iter.map_;
+      index_ = iter.index_;
+      Init();
+      return *this;
+    }
+
+    ~Iterator() {
+      DCHECK_CALLED_ON_VALID_SEQUENCE(map_->sequence_checker_);
+
+      if (--map_->iteration_depth_ == 0) {
+        map_->ReleasePendingIndices();
+      } else {
+        // The iteration depth should not become negative, it would mean there
+        // was an untracked iterator which is now being destroyed.
+        CHECK_GT(map_->iteration_depth_, 0);
+      }
+    }
+
+    bool IsAtEnd() const {
+      DCHECK_CALLED_ON_VALID_SEQUENCE(map_->sequence_checker_);
+      return index_ >= map_->slots_.size();
+    }
+
+    KeyType GetCurrentKey() const {
+      DCHECK_CALLED_ON_VALID_SEQUENCE(map_->sequence_checker_);
+      CHECK(!IsAtEnd());
+      return MakeKey(static_cast<uint32_t>(index_),
+                     map_->slots_[index_].generation);
+    }
+
+    ReturnType* GetCurrentValue() const {
+      DCHECK_CALLED_ON_VALID_SEQUENCE(map_->sequence_checker_);
+      CHECK(!IsAtEnd());
+      const Slot& slot = map_->slots_[index_];
+      if (!slot.occupied || !slot.value) {
+        return nullptr;
+      }
+      return &*slot.value;
+    }
+
+    void Advance() {
+      DCHECK_CALLED_ON_VALID_SEQUENCE(map_->sequence_checker_);
+      ++index_;
+      SkipRemovedEntries();
+    }
+
+   private:
+    void Init() {
+      DCHECK_CALLED_ON_VALID_SEQUENCE(map_->sequence_checker_);
+      // Guard signed integer overflow.
+      CHECK(map_->iteration_depth_ < std::numeric_limits<int>::max());
+      ++map_->iteration_depth_;
+      SkipRemovedEntries();
+    }
+
+    void SkipRemovedEntries() {
+      while (index_ < map_->slots_.size() && !map_->slots_[index_].occupied) {
+        ++index_;
+      }
+    }
+
+    raw_ptr<DenseIDMap<V>> map_;
+    size_t index_ = 0;
+  };
+
+  typedef Iterator<T> iterator;
+  typedef Iterator<const T> const_iterator;
+
+ private:
+  struct Slot {
+    V value{};
+    uint32_t generation = 0;
+    bool occupied = false;
+  };
+
+  static KeyType MakeKey(uint32_t index, uint32_t generation) {
+    return (static_cast<KeyType>(generation) << 32) | (index + 1u);
+  }
+
+  // Returns UINT32_MAX for the invalid ID 0.
+  static uint32_t GetIndex(KeyType id) {
+    return static_cast<uint32_t>(id) - 1u;
+  }
+
+  Slot* FindSlot(KeyType id) {
+    return const_cast<Slot*>(std::as_const(*this).FindSlot(id));
+  }
+
+  const Slot* FindSlot(KeyType id) const {
+    const uint32_t index = GetIndex(id);
+    if (index >= slots_.size()) {
+      return nullptr;
+    }
+    const Slot& slot = slots_[index];
+    if (!slot.occupied || slot.generation != static_cast<uint32_t>(id >> 32)) {
+      return nullptr;
+    }
+    return &slot;
+  }
+
+  void RemoveSlot(Slot& slot, uint32_t index) {
+    slot.value = V();
+    slot.occupied = false;
+    // Invalidates the IDs of the slot.
+    ++slot.generation;
+    --size_;
+    if (slot.generation == 0) {
+      // Retires the slot rather than reusing old IDs once the generation
+      // wraps around.
+      return;
+    }
+    if (iteration_depth_ == 0) {
+      free_indices_.push_back(index);
+    } else {
+      pending_free_indices_.push_back(index);
+    }
+  }
+
+  void ReleasePendingIndices() {
+    DCHECK_EQ(0, iteration_depth_);
+    free_indices_.insert(free_indices_.end(), pending_free_indices_.begin(),
+                         pending_free_indices_.end());
+    pending_free_indices_.clear();
+  }
+
+  std::vector<Slot> slots_;
+  // Indices of the unoccupied slots, reused last in, first out.
+  std::vector<uint32_t> free_indices_;
+  // Indices of the slots freed during iteration, which are only reused once
+  // the iteration is over, so that the iterators don't see new values in the
+  // slots of old ones.
+  std::vector<uint32_t> pending_free_indices_;
+  size_t size_ = 0;
+
+  // Keep track of how many iterators are currently iterating on us.
+  int iteration_depth_ = 0;
+
+  // See description above setter.
+  bool check_on_null_data_ = false;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_DENSE_ID_MAP_H_
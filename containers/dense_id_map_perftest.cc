@@ -0,0 +1,70 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/dense_id_map.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/id_map.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+namespace {
+
+constexpr char kMetricPrefixIDMap[] = "IDMap.";
+constexpr char kMetricPrefixDenseIDMap[] = "DenseIDMap.";
+constexpr char kMetricLookupTime[] = "lookup_time";
+
+constexpr int kNumEntries = 100000;
+constexpr int kNumLookups = 10000000;
+
+// Looks up random IDs of a map of `kNumEntries` entries, e.g. a table of
+// connections.
+template <typename MapType>
+void RunTest(const std::string& metric_prefix) {
+  MapType map;
+  int value = 0;
+  std::vector<typename MapType::KeyType> ids;
+  for (int i = 0; i < kNumEntries; ++i) {
+    ids.push_back(map.Add(&value));
+  }
+
+  uint32_t state = 0x9E3779B9u;
+  int hits = 0;
+  ElapsedTimer timer;
+  for (int i = 0; i < kNumLookups; ++i) {
+    // xorshift32, which is cheap enough not to dominate the measurement.
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    if (map.Lookup(ids[state % kNumEntries])) {
+      ++hits;
+    }
+  }
+  const TimeDelta elapsed = timer.Elapsed();
+  EXPECT_EQ(kNumLookups, hits);
+
+  perf_test::PerfResultReporter reporter(metric_prefix, "Lookup");
+  reporter.RegisterImportantMetric(kMetricLookupTime, "ns");
+  reporter.AddResult(
+      kMetricLookupTime,
+      static_cast<double>(elapsed.InNanoseconds()) / kNumLookups);
+}
+
+TEST(DenseIDMapPerfTest, IDMap) {
+  RunTest<IDMap<int*>>(kMetricPrefixIDMap);
+}
+
+TEST(DenseIDMapPerfTest, DenseIDMap) {
+  RunTest<DenseIDMap<int*>>(kMetricPrefixDenseIDMap);
+}
+
+}  // namespace
+}  // namespace base
@@ -0,0 +1,150 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/dense_id_map.h"
+
+#include <memory>
+#include <set>
+
+#include "base/test/gtest_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class TestObject {};
+
+class DestructorCounter {
+ public:
+  explicit DestructorCounter(int* counter) : counter_(counter) {}
+  ~DestructorCounter() { ++(*counter_); }
+
+ private:
+  raw_ptr<int> counter_;
+};
+
+}  // namespace
+
+TEST(DenseIDMapTest, Basic) {
+  DenseIDMap<TestObject*> map;
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_EQ(0u, map.size());
+  EXPECT_EQ(nullptr, map.Lookup(0));
+
+  TestObject obj1;
+  TestObject obj2;
+  const auto id1 = map.Add(&obj1);
+  EXPECT_NE(0u, id1);
+  EXPECT_FALSE(map.IsEmpty());
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(&obj1, map.Lookup(id1));
+
+  const auto id2 = map.Add(&obj2);
+  EXPECT_NE(id1, id2);
+  EXPECT_EQ(2u, map.size());
+  EXPECT_EQ(&obj2, map.Lookup(id2));
+
+  map.Remove(id1);
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(nullptr, map.Lookup(id1));
+  EXPECT_FALSE(map.Contains(id1));
+  // Removing again does nothing.
+  map.Remove(id1);
+  EXPECT_EQ(1u, map.size());
+
+  EXPECT_EQ(&obj2, map.Replace(id2, &obj1));
+  EXPECT_EQ(&obj1, map.Lookup(id2));
+
+  map.Clear();
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_EQ(nullptr, map.Lookup(id2));
+}
+
+TEST(DenseIDMapTest, StaleIDs) {
+  DenseIDMap<TestObject*> map;
+  TestObject obj1;
+  TestObject obj2;
+  const auto id1 = map.Add(&obj1);
+  map.Remove(id1);
+
+  // The slot is reused, with a new ID.
+  const auto id2 = map.Add(&obj2);
+  EXPECT_NE(id1, id2);
+  EXPECT_EQ(nullptr, map.Lookup(id1));
+  EXPECT_EQ(&obj2, map.Lookup(id2));
+
+  // Stale IDs can't remove or replace the new value.
+  map.Remove(id1);
+  EXPECT_EQ(&obj2, map.Lookup(id2));
+  EXPECT_CHECK_DEATH(map.Replace(id1, &obj1));
+}
+
+TEST(DenseIDMapTest, NullValues) {
+  DenseIDMap<TestObject*> map;
+  const auto id = map.Add(nullptr);
+  EXPECT_TRUE(map.Contains(id));
+  EXPECT_EQ(nullptr, map.Lookup(id));
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(DenseIDMapTest, IteratorRemovesDuringIteration) {
+  DenseIDMap<TestObject*> map;
+  TestObject objs[5];
+  DenseIDMap<TestObject*>::KeyType ids[5];
+  for (int i = 0; i < 5; ++i) {
+    ids[i] = map.Add(&objs[i]);
+  }
+
+  std::set<TestObject*> visited;
+  {
+    DenseIDMap<TestObject*>::const_iterator iter(&map);
+    EXPECT_EQ(1, map.iteration_depth());
+    // Removes an element ahead of the iterator and one behind it.
+    map.Remove(ids[3]);
+    for (; !iter.IsAtEnd(); iter.Advance()) {
+      visited.insert(const_cast<TestObject*>(iter.GetCurrentValue()));
+      if (iter.GetCurrentKey() == ids[1]) {
+        map.Remove(ids[0]);
+        map.Remove(ids[1]);
+        // The freed slots are not reused during iteration.
+        map.Add(&objs[0]);
+      }
+    }
+  }
+  EXPECT_EQ(0, map.iteration_depth());
+  EXPECT_EQ(0u, visited.count(&objs[3]));
+  EXPECT_TRUE(visited.count(&objs[2]));
+  EXPECT_TRUE(visited.count(&objs[4]));
+  EXPECT_EQ(3u, map.size());
+
+  // Now they are.
+  const auto id = map.Add(&objs[1]);
+  EXPECT_EQ(&objs[1], map.Lookup(id));
+}
+
+TEST(DenseIDMapTest, OwningPointersDeletesThemOnRemove) {
+  int destructor_count = 0;
+  DenseIDMap<std::unique_ptr<DestructorCounter>> map;
+  const auto id1 =
+      map.Add(std::make_unique<DestructorCounter>(&destructor_count));
+  map.Add(std::make_unique<DestructorCounter>(&destructor_count));
+
+  map.Remove(id1);
+  EXPECT_EQ(1, destructor_count);
+  map.Clear();
+  EXPECT_EQ(2, destructor_count);
+}
+
+TEST(DenseIDMapTest, OwningPointersDeletesThemOnDestruct) {
+  int destructor_count = 0;
+  {
+    DenseIDMap<std::unique_ptr<DestructorCounter>> map;
+    map.Add(std::make_unique<DestructorCounter>(&destructor_count));
+    map.Add(std::make_unique<DestructorCounter>(&destructor_count));
+  }
+  EXPECT_EQ(2, destructor_count);
+}
+
+}  // namespace base
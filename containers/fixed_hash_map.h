@@ -0,0 +1,296 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FIXED_HASH_MAP_H_
+#define BASE_CONTAINERS_FIXED_HASH_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "base/check.h"
+
+namespace base {
+
+namespace internal {
+
+// The finalizer of SplitMix64.
+constexpr uint64_t FixedHashMix(uint64_t value) {
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+// The hashes of fixed_hash_map, which must be constexpr and stable between
+// compile time and run time.
+constexpr uint64_t FixedHash(std::string_view str) {
+  // FNV-1a.
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (char c : str) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+  }
+  return FixedHashMix(hash);
+}
+
+template <typename T>
+  requires(std::is_integral_v<T> || std::is_enum_v<T>)
+constexpr uint64_t FixedHash(T value) {
+  return FixedHashMix(static_cast<uint64_t>(value));
+}
+
+}  // namespace internal
+
+// fixed_hash_map is an immutable map, built at compile time by
+// MakeFixedHashMap(), which finds keys with a minimal perfect hash: a lookup
+// hashes the key once, reads one displacement, and compares the key with a
+// single entry. This beats the binary search of base::fixed_flat_map for
+// string keys, where each step of the search is a string comparison, e.g.
+// for tables of header names or command line switches.
+//
+// The perfect hash is found with "hash, displace and compress" (CHD): keys
+// are first distributed in N buckets, then, from the largest bucket to the
+// smallest, a seed is searched for each bucket which sends its keys to free
+// slots. Buckets of one key get their slot directly. If no seed is found for
+// a bucket, which is very unlikely, the entries are sorted instead, and
+// lookups fall back to a binary search.
+//
+// Keys must be integers, enums, or types convertible to std::string_view.
+// Iteration is in slot order, which is neither sorted nor insertion order.
+//
+// Please see //base/containers/README.md for an overview of which container
+// to select.
+//
+// Example usage:
+//   constexpr auto kMap = base::MakeFixedHashMap<std::string_view, int>(
+//       {{"foo", 1}, {"bar", 2}, {"baz", 3}});
+//   auto it = kMap.find(name);
+//   if (it != kMap.end()) {
+//     return it->second;
+//   }
+template <class Key, class Mapped, size_t N>
+class fixed_hash_map {
+ public:
+  static_assert(N > 0, "Use an empty std::array instead");
+  static_assert(N < (size_t{1} << 31), "Too many entries");
+
+  using key_type = Key;
+  using mapped_type = Mapped;
+  using value_type = std::pair<const Key, Mapped>;
+  using size_type = size_t;
+  using const_iterator = typename std::array<value_type, N>::const_iterator;
+
+  // Prefer MakeFixedHashMap(). Requires that the keys of `data` be unique.
+  consteval explicit fixed_hash_map(std::pair<Key, Mapped> (&&data)[N])
+      : fixed_hash_map(data,
+                       ComputeLayout(data),
+                       std::make_index_sequence<N>()) {}
+
+  constexpr size_t size() const { return N; }
+  constexpr bool empty() const { return false; }
+
+  constexpr const_iterator begin() const { return entries_.begin(); }
+  constexpr const_iterator end() const { return entries_.end(); }
+
+  // Whether lookups use the perfect hash rather than a binary search.
+  constexpr bool is_perfect() const { return perfect_; }
+
+  template <typename K>
+  constexpr const_iterator find(const K& key) const {
+    size_t index;
+    if (perfect_) [[likely]] {
+      index = GetSlot(internal::FixedHash(key));
+    } else {
+      auto it = std::lower_bound(
+          entries_.begin(), entries_.end(), key,
+          [](const value_type& entry, const K& k) { return entry.first < k; });
+      index = static_cast<size_t>(it - entries_.begin());
+      if (index == N) {
+        return end();
+      }
+    }
+    return entries_[index].first == key
+               ? entries_.begin() + static_cast<ptrdiff_t>(index)
+               : end();
+  }
+
+  template <typename K>
+  constexpr bool contains(const K& key) const {
+    return find(key) != end();
+  }
+
+  template <typename K>
+  constexpr size_t count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  // CHECKs that `key` is present.
+  template <typename K>
+  constexpr const Mapped& at(const K& key) const {
+    const_iterator it = find(key);
+    CHECK(it != end());
+    return it->second;
+  }
+
+ private:
+  // A seed with this bit is the slot of the bucket's only key.
+  static constexpr uint32_t kDirectSlot = uint32_t{1} << 31;
+  // Gives up on the perfect hash if a bucket needs more seeds than this.
+  static constexpr uint32_t kMaxSeed = uint32_t{1} << 16;
+
+  struct Layout {
+    std::array<uint32_t, N> seeds{};
+    // The index in the input of the entry of each slot.
+    std::array<size_t, N> order{};
+    bool perfect = false;
+  };
+
+  template <size_t... I>
+  consteval fixed_hash_map(const std::pair<Key, Mapped> (&data)[N],
+                           const Layout& layout,
+                           std::index_sequence<I...>)
+      : seeds_(layout.seeds),
+        perfect_(layout.perfect),
+        entries_{{value_type(data[layout.order[I]])...}} {}
+
+  static constexpr size_t GetBucket(uint64_t hash) { return (hash >> 32) % N; }
+
+  static constexpr size_t GetSlotForSeed(uint64_t hash, uint32_t seed) {
+    return internal::FixedHashMix(hash ^ (seed * 0x9E3779B97F4A7C15ull)) % N;
+  }
+
+  constexpr size_t GetSlot(uint64_t hash) const {
+    const uint32_t seed = seeds_[GetBucket(hash)];
+    return seed & kDirectSlot ? seed & ~kDirectSlot
+                              : GetSlotForSeed(hash, seed);
+  }
+
+  static consteval Layout ComputeLayout(
+      const std::pair<Key, Mapped> (&data)[N]) {
+    Layout layout;
+    std::array<uint64_t, N> hashes{};
+    std::array<size_t, N> bucket_sizes{};
+    for (size_t i = 0; i < N; ++i) {
+      hashes[i] = internal::FixedHash(data[i].first);
+      ++bucket_sizes[GetBucket(hashes[i])];
+    }
+
+    // Groups the keys by bucket, largest buckets first.
+    std::array<size_t, N> keys{};
+    for (size_t i = 0; i < N; ++i) {
+      keys[i] = i;
+    }
+    std::sort(keys.begin(), keys.end(), [&](size_t a, size_t b) {
+      const size_t bucket_a = GetBucket(hashes[a]);
+      const size_t bucket_b = GetBucket(hashes[b]);
+      if (bucket_sizes[bucket_a] != bucket_sizes[bucket_b]) {
+        return bucket_sizes[bucket_a] > bucket_sizes[bucket_b];
+      }
+      if (bucket_a != bucket_b) {
+        return bucket_a < bucket_b;
+      }
+      // So that equal hashes are adjacent.
+      return hashes[a] < hashes[b];
+    });
+
+    std::array<bool, N> used{};
+    size_t next_free = 0;
+    for (size_t begin = 0; begin < N;) {
+      const size_t bucket = GetBucket(hashes[keys[begin]]);
+      const size_t end = begin + bucket_sizes[bucket];
+      if (end - begin == 1) {
+        while (used[next_free]) {
+          ++next_free;
+        }
+        used[next_free] = true;
+        layout.seeds[bucket] = kDirectSlot | static_cast<uint32_t>(next_free);
+        layout.order[next_free] = keys[begin];
+        begin = end;
+        continue;
+      }
+
+      for (size_t i = begin + 1; i < end; ++i) {
+        if (hashes[keys[i]] == hashes[keys[i - 1]]) {
+          // No seed can separate equal hashes. The keys are probably not
+          // unique, which ComputeSortedLayout() CHECKs.
+          return ComputeSortedLayout(data);
+        }
+      }
+
+      bool placed = false;
+      for (uint32_t seed = 0; seed < kMaxSeed && !placed; ++seed) {
+        placed = true;
+        for (size_t i = begin; i < end && placed; ++i) {
+          const size_t slot = GetSlotForSeed(hashes[keys[i]], seed);
+          placed = !used[slot];
+          used[slot] = true;
+          if (!placed) {
+            // Frees the slots of the previous keys of the bucket.
+            for (size_t j = begin; j < i; ++j) {
+              used[GetSlotForSeed(hashes[keys[j]], seed)] = false;
+            }
+          }
+        }
+        if (placed) {
+          layout.seeds[bucket] = seed;
+          for (size_t i = begin; i < end; ++i) {
+            layout.order[GetSlotForSeed(hashes[keys[i]], seed)] = keys[i];
+          }
+        }
+      }
+      if (!placed) {
+        return ComputeSortedLayout(data);
+      }
+      begin = end;
+    }
+    layout.perfect = true;
+    return layout;
+  }
+
+  static consteval Layout ComputeSortedLayout(
+      const std::pair<Key, Mapped> (&data)[N]) {
+    Layout layout;
+    for (size_t i = 0; i < N; ++i) {
+      layout.order[i] = i;
+    }
+    std::sort(
+        layout.order.begin(), layout.order.end(),
+        [&](size_t a, size_t b) { return data[a].first < data[b].first; });
+    for (size_t i = 1; i < N; ++i) {
+      // If this CHECK fails, a compiler error will occur because CHECK
+      // failure is not consteval: the keys of the provided data weren't
+      // unique.
+      CHECK(data[layout.order[i - 1]].first < data[layout.order[i]].first);
+    }
+    return layout;
+  }
+
+  std::array<uint32_t, N> seeds_;
+  bool perfect_;
+  std::array<value_type, N> entries_;
+};
+
+// Utility function to construct a fixed_hash_map from a fixed list of keys
+// and values. Requires that the passed in `data` contains unique keys.
+//
+// Large inputs will run into compiler limits, e.g. "constexpr evaluation hit
+// maximum step limit". Use base::MakeFixedFlatMap() with sorted input then.
+//
+// Example usage:
+//   constexpr auto kMap = base::MakeFixedHashMap<std::string_view, int>(
+//       {{"foo", 1}, {"bar", 2}, {"baz", 3}});
+template <class Key, class Mapped, size_t N>
+consteval fixed_hash_map<Key, Mapped, N> MakeFixedHashMap(
+    std::pair<Key, Mapped> (&&data)[N]) {
+  return fixed_hash_map<Key, Mapped, N>(std::move(data));
+}
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FIXED_HASH_MAP_H_
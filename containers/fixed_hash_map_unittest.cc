@@ -0,0 +1,87 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/fixed_hash_map.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "base/test/gtest_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+enum class Color { kRed, kGreen, kBlue };
+
+}  // namespace
+
+TEST(FixedHashMapTest, StringKeys) {
+  static constexpr auto kMap = MakeFixedHashMap<std::string_view, int>({
+      {"accept", 1},
+      {"accept-encoding", 2},
+      {"accept-language", 3},
+      {"cache-control", 4},
+      {"content-length", 5},
+      {"content-type", 6},
+      {"cookie", 7},
+      {"host", 8},
+      {"referer", 9},
+      {"user-agent", 10},
+  });
+  static_assert(kMap.size() == 10);
+  static_assert(kMap.is_perfect());
+  static_assert(kMap.at("host") == 8);
+  static_assert(!kMap.contains("hostname"));
+
+  EXPECT_EQ(5, kMap.at(std::string("content-length")));
+  EXPECT_EQ(1u, kMap.count("cookie"));
+  EXPECT_EQ(kMap.end(), kMap.find(""));
+  EXPECT_EQ(kMap.end(), kMap.find("Host"));
+
+  int sum = 0;
+  for (const auto& [key, value] : kMap) {
+    EXPECT_EQ(value, kMap.at(key));
+    sum += value;
+  }
+  EXPECT_EQ(55, sum);
+}
+
+TEST(FixedHashMapTest, IntegerKeys) {
+  static constexpr auto kMap = MakeFixedHashMap<uint32_t, char>(
+      {{1, 'a'}, {10, 'b'}, {100, 'c'}, {1000, 'd'}, {10000, 'e'}});
+  static_assert(kMap.is_perfect());
+  EXPECT_EQ('c', kMap.at(100u));
+  EXPECT_FALSE(kMap.contains(0u));
+  EXPECT_FALSE(kMap.contains(11u));
+}
+
+TEST(FixedHashMapTest, EnumKeys) {
+  static constexpr auto kMap = MakeFixedHashMap<Color, std::string_view>(
+      {{Color::kRed, "red"}, {Color::kBlue, "blue"}});
+  EXPECT_EQ("red", kMap.at(Color::kRed));
+  EXPECT_EQ("blue", kMap.at(Color::kBlue));
+  EXPECT_FALSE(kMap.contains(Color::kGreen));
+}
+
+TEST(FixedHashMapTest, SingleEntry) {
+  static constexpr auto kMap = MakeFixedHashMap<std::string_view, int>({
+      {"only", 1},
+  });
+  EXPECT_TRUE(kMap.contains("only"));
+  EXPECT_FALSE(kMap.contains("other"));
+}
+
+TEST(FixedHashMapDeathTest, AtMissingKey) {
+  static constexpr auto kMap = MakeFixedHashMap<std::string_view, int>({
+      {"foo", 1},
+      {"bar", 2},
+  });
+  EXPECT_CHECK_DEATH(kMap.at("baz"));
+}
+
+}  // namespace base
@@ -0,0 +1,37 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_HASH_MAP_H_
+#define BASE_CONTAINERS_FLAT_HASH_MAP_H_
+
+#include "third_party/abseil-cpp/absl/container/flat_hash_map.h"
+
+namespace base {
+
+// An open-addressing hash map which stores its elements inline, in a single
+// array, next to an array of one-byte control values which are probed a group
+// at a time with SIMD instructions where available (a "SwissTable"). Prefer
+// it to std::unordered_map for large sets of keys which are frequently
+// mutated or looked up: lookups touch one or two cache lines instead of
+// chasing a pointer per node.
+//
+// Unlike base::flat_map, insertion and erasure are O(1) on average, but
+// iteration order is unspecified and, like for std::vector, insertion
+// invalidates pointers and iterators to the elements. Use std::unique_ptr<V>
+// values, or absl::node_hash_map, if pointer stability is needed.
+//
+// The default hasher is transparent for string-like keys, so that e.g.
+// base::flat_hash_map<std::string, int> can be looked up by std::string_view.
+// Custom key types can hash themselves with base::FastHash(), see
+// base::FastStringHash in base/hash/hash.h.
+template <typename Key,
+          typename Value,
+          typename Hash = typename absl::flat_hash_map<Key, Value>::hasher,
+          typename KeyEqual =
+              typename absl::flat_hash_map<Key, Value, Hash>::key_equal>
+using flat_hash_map = absl::flat_hash_map<Key, Value, Hash, KeyEqual>;
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_HASH_MAP_H_
@@ -0,0 +1,58 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_hash_map.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "base/hash/hash.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(FlatHashMapTest, InsertFindErase) {
+  flat_hash_map<int, std::string> map;
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(map.emplace(i, std::to_string(i)).second);
+  }
+  EXPECT_FALSE(map.emplace(1, "one").second);
+  EXPECT_EQ(1000u, map.size());
+  EXPECT_EQ("1", map.at(1));
+
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_EQ(1u, map.erase(i));
+  }
+  EXPECT_EQ(500u, map.size());
+  EXPECT_FALSE(map.contains(0));
+  ASSERT_TRUE(map.contains(999));
+  EXPECT_EQ("999", map.find(999)->second);
+}
+
+TEST(FlatHashMapTest, HeterogeneousLookup) {
+  flat_hash_map<std::string, int> map = {{"a", 1}, {"b", 2}};
+  EXPECT_EQ(1, map.find(std::string_view("a"))->second);
+  EXPECT_TRUE(map.contains("b"));
+  EXPECT_FALSE(map.contains(std::string_view("c")));
+}
+
+TEST(FlatHashMapTest, FastStringHash) {
+  flat_hash_map<std::string, int, FastStringHash> map;
+  map["key"] = 1;
+  EXPECT_EQ(1, map.find(std::string_view("key"))->second);
+  EXPECT_EQ(0u, map.count(std::string_view("other")));
+  EXPECT_EQ(FastHash("key"), map.hash_function()(std::string_view("key")));
+}
+
+TEST(FlatHashMapTest, MoveOnlyValues) {
+  flat_hash_map<int, std::unique_ptr<int>> map;
+  map.emplace(1, std::make_unique<int>(10));
+  std::unique_ptr<int> value = std::move(map[1]);
+  EXPECT_EQ(10, *value);
+  EXPECT_EQ(1u, map.size());
+  EXPECT_FALSE(map[1]);
+}
+
+}  // namespace base
@@ -0,0 +1,22 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_HASH_SET_H_
+#define BASE_CONTAINERS_FLAT_HASH_SET_H_
+
+#include "third_party/abseil-cpp/absl/container/flat_hash_set.h"
+
+namespace base {
+
+// An open-addressing hash set which stores its elements inline. See
+// base::flat_hash_map in base/containers/flat_hash_map.h for the trade-offs.
+template <typename Key,
+          typename Hash = typename absl::flat_hash_set<Key>::hasher,
+          typename KeyEqual =
+              typename absl::flat_hash_set<Key, Hash>::key_equal>
+using flat_hash_set = absl::flat_hash_set<Key, Hash, KeyEqual>;
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_HASH_SET_H_
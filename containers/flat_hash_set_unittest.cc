@@ -0,0 +1,38 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_hash_set.h"
+
+#include <string>
+#include <string_view>
+
+#include "base/hash/hash.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(FlatHashSetTest, InsertFindErase) {
+  flat_hash_set<int> set;
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(set.insert(i).second);
+  }
+  EXPECT_FALSE(set.insert(1).second);
+  EXPECT_EQ(1000u, set.size());
+
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_EQ(1u, set.erase(i));
+  }
+  EXPECT_EQ(500u, set.size());
+  EXPECT_FALSE(set.contains(0));
+  EXPECT_TRUE(set.contains(999));
+}
+
+TEST(FlatHashSetTest, HeterogeneousLookup) {
+  flat_hash_set<std::string, FastStringHash> set = {"a", "b"};
+  EXPECT_TRUE(set.contains(std::string_view("a")));
+  EXPECT_NE(set.end(), set.find("b"));
+  EXPECT_FALSE(set.contains(std::string_view("c")));
+}
+
+}  // namespace base
@@ -0,0 +1,461 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This file contains `base::FlatLRUCache`, a hashing cache with the interface
+// of `base::HashingLRUCache` (see lru_cache.h) which is optimized for memory
+// usage and locality when holding many entries.
+//
+// `HashingLRUCache` is a `std::list` plus a `std::unordered_map` of list
+// iterators: each entry costs two node allocations and the key is stored
+// twice. `FlatLRUCache` instead stores the entries in one contiguous slab,
+// linked into the recency list by 32-bit indices, and indexes them with an
+// open-addressed (linear probing) table of 32-bit slab indices. The key is
+// stored once, and looking up an entry touches the index and the entry only.
+//
+// Unlike `HashingLRUCache`, pointers and references to entries are invalidated
+// when the slab grows, i.e. by `Put()` of a new key. Iterators stay valid
+// until the entry they point to is erased.
+//
+// Two eviction policies are supported:
+// - `kLRU` evicts the least recently used entry, and moves entries to the
+//   front of the recency list on each `Get()`.
+// - `kSieve` implements SIEVE (Zhang et al., NSDI '24): `Get()` only marks the
+//   entry as visited, without relinking it, and eviction scans from the oldest
+//   entry towards the newest, sparing (and unmarking) visited entries. Hits are
+//   cheaper, and the hit ratio is usually on par or better than LRU. The list
+//   is then in insertion order instead of recency order.
+
+#ifndef BASE_CONTAINERS_FLAT_LRU_CACHE_H_
+#define BASE_CONTAINERS_FLAT_LRU_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/check_op.h"
+
+namespace base {
+
+enum class FlatLRUCacheEvictionPolicy {
+  kLRU,
+  kSieve,
+};
+
+template <class KeyType,
+          class ValueType,
+          class KeyHash = std::hash<KeyType>,
+          class KeyEqual = std::equal_to<KeyType>>
+class FlatLRUCache {
+ private:
+  template <bool kIsConst>
+  class IteratorImpl;
+
+ public:
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  using value_type = std::pair<KeyType, ValueType>;
+  using size_type = size_t;
+
+  using iterator = IteratorImpl<false>;
+  using const_iterator = IteratorImpl<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  enum { NO_AUTO_EVICT = 0 };
+
+  // See `LRUCacheBase` for the meaning of `max_size`. With a `max_size`, the
+  // slab is allocated upfront.
+  explicit FlatLRUCache(
+      size_type max_size,
+      FlatLRUCacheEvictionPolicy policy = FlatLRUCacheEvictionPolicy::kLRU)
+      : max_size_(max_size), policy_(policy) {
+    CHECK_LT(max_size, size_t{kInvalidIndex});
+    if (max_size_ != NO_AUTO_EVICT) {
+      nodes_.reserve(max_size_);
+      ReserveIndex(max_size_);
+    }
+  }
+
+  // Move-only, like `LRUCacheBase`.
+  FlatLRUCache(FlatLRUCache&&) noexcept = default;
+  FlatLRUCache& operator=(FlatLRUCache&&) noexcept = default;
+
+  ~FlatLRUCache() = default;
+
+  size_type max_size() const { return max_size_; }
+  FlatLRUCacheEvictionPolicy policy() const { return policy_; }
+
+  // Inserts an item into the cache, or replaces the value of the existing item
+  // with the same key. With `kLRU`, the item is moved to the front of the list.
+  // An iterator to the item is returned.
+  template <class K, class V>
+  iterator Put(K&& key, V&& value) {
+    const uint32_t hash = HashKey(key);
+    const uint32_t existing = FindIndex(key, hash);
+    if (existing != kInvalidIndex) {
+      nodes_[existing].value->second = std::forward<V>(value);
+      Touch(existing);
+      return iterator(this, existing);
+    }
+    if (max_size_ != NO_AUTO_EVICT) {
+      ShrinkToSize(max_size_ - 1);
+    }
+
+    uint32_t index;
+    if (free_list_ != kInvalidIndex) {
+      index = free_list_;
+      free_list_ = nodes_[index].next;
+    } else {
+      CHECK_LT(nodes_.size(), size_t{kInvalidIndex});
+      index = static_cast<uint32_t>(nodes_.size());
+      nodes_.emplace_back();
+    }
+    Node& node = nodes_[index];
+    node.value.emplace(std::forward<K>(key), std::forward<V>(value));
+    node.hash = hash;
+    node.visited = false;
+    LinkFront(index);
+    ++size_;
+    InsertIntoIndex(index);
+    return iterator(this, index);
+  }
+
+  // Retrieves the item of the given key, or end() if not found. With `kLRU`,
+  // this moves the item to the front of the list. With `kSieve`, this marks
+  // it as visited.
+  iterator Get(const key_type& key) {
+    const uint32_t index = FindIndex(key, HashKey(key));
+    if (index == kInvalidIndex) {
+      return end();
+    }
+    Touch(index);
+    return iterator(this, index);
+  }
+
+  // Retrieves the item of the given key, or end() if not found, without
+  // affecting eviction.
+  iterator Peek(const key_type& key) {
+    return iterator(this, FindIndex(key, HashKey(key)));
+  }
+
+  const_iterator Peek(const key_type& key) const {
+    return const_iterator(this, FindIndex(key, HashKey(key)));
+  }
+
+  // Exchanges the contents of |this| by the contents of the |other|.
+  void Swap(FlatLRUCache& other) { std::swap(*this, other); }
+
+  // Erases the item referenced by the given iterator. An iterator to the item
+  // following it will be returned. The iterator must be valid.
+  iterator Erase(iterator pos) {
+    DCHECK_EQ(pos.cache_, this);
+    const uint32_t index = pos.index_;
+    DCHECK(nodes_[index].value);
+    const uint32_t next = nodes_[index].next;
+    RemoveFromIndex(index);
+    Unlink(index);
+    --size_;
+    Node& node = nodes_[index];
+    node.value.reset();
+    node.next = free_list_;
+    free_list_ = index;
+    return iterator(this, next);
+  }
+
+  reverse_iterator Erase(reverse_iterator pos) {
+    return reverse_iterator(Erase((++pos).base()));
+  }
+
+  // Shrinks the cache so it only holds |new_size| items, evicting items
+  // according to the eviction policy. If |new_size| is bigger or equal to the
+  // current number of items, this will do nothing.
+  void ShrinkToSize(size_type new_size) {
+    while (size_ > new_size) {
+      Erase(iterator(this, GetEvictionCandidate()));
+    }
+  }
+
+  // Deletes everything from the cache. Keeps the memory of the slab and of the
+  // index.
+  void Clear() {
+    nodes_.clear();
+    std::fill(buckets_.begin(), buckets_.end(), kInvalidIndex);
+    head_ = tail_ = hand_ = free_list_ = kInvalidIndex;
+    size_ = 0;
+  }
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Iterates from the front of the list: the most recently used item with
+  // `kLRU`, the most recently inserted one with `kSieve`.
+  iterator begin() { return iterator(this, head_); }
+  const_iterator begin() const { return const_iterator(this, head_); }
+  iterator end() { return iterator(this, kInvalidIndex); }
+  const_iterator end() const { return const_iterator(this, kInvalidIndex); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  // Returns the number of bytes allocated by the cache, excluding memory
+  // owned by the keys and values.
+  size_t EstimateMemoryUsage() const {
+    return nodes_.capacity() * sizeof(Node) +
+           buckets_.capacity() * sizeof(uint32_t);
+  }
+
+ private:
+  static constexpr uint32_t kInvalidIndex =
+      std::numeric_limits<uint32_t>::max();
+
+  struct Node {
+    // Empty if the node is in the free list.
+    std::optional<value_type> value;
+    // Towards the back of the list, or the next free node.
+    uint32_t next = kInvalidIndex;
+    // Towards the front of the list.
+    uint32_t prev = kInvalidIndex;
+    // The hash of the key, which avoids rehashing keys when the index grows
+    // and most key comparisons of colliding keys.
+    uint32_t hash = 0;
+    // Whether the item was used since the SIEVE hand last passed it.
+    bool visited = false;
+  };
+
+  template <bool kIsConst>
+  class IteratorImpl {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = FlatLRUCache::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer =
+        std::conditional_t<kIsConst, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<kIsConst, const value_type&, value_type&>;
+    using CachePointer =
+        std::conditional_t<kIsConst, const FlatLRUCache*, FlatLRUCache*>;
+
+    IteratorImpl() = default;
+    IteratorImpl(CachePointer cache, uint32_t index)
+        : cache_(cache), index_(index) {}
+    // Allows conversion from iterator to const_iterator.
+    template <bool kOtherIsConst,
+              class = std::enable_if_t<kIsConst && !kOtherIsConst>>
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    IteratorImpl(const IteratorImpl<kOtherIsConst>& other)
+        : cache_(other.cache_), index_(other.index_) {}
+
+    reference operator*() const {
+      DCHECK_NE(index_, kInvalidIndex);
+      return *cache_->nodes_[index_].value;
+    }
+    pointer operator->() const { return &**this; }
+
+    IteratorImpl& operator++() {
+      DCHECK_NE(index_, kInvalidIndex);
+      index_ = cache_->nodes_[index_].next;
+      return *this;
+    }
+    IteratorImpl operator++(int) {
+      IteratorImpl result = *this;
+      ++*this;
+      return result;
+    }
+    IteratorImpl& operator--() {
+      index_ = index_ == kInvalidIndex ? cache_->tail_
+                                       : cache_->nodes_[index_].prev;
+      DCHECK_NE(index_, kInvalidIndex);
+      return *this;
+    }
+    IteratorImpl operator--(int) {
+      IteratorImpl result = *this;
+      --*this;
+      return result;
+    }
+
+    friend bool operator==(const IteratorImpl& lhs, const IteratorImpl& rhs) {
+      return lhs.index_ == rhs.index_;
+    }
+
+   private:
+    friend class FlatLRUCache;
+    template <bool>
+    friend class IteratorImpl;
+
+    CachePointer cache_ = nullptr;
+    uint32_t index_ = kInvalidIndex;
+  };
+
+  static uint32_t HashKey(const key_type& key) {
+    // Mixes the bits of the hash, since std::hash is the identity for
+    // integers on some platforms and the index only uses the low bits.
+    const uint64_t hash = static_cast<uint64_t>(KeyHash()(key));
+    return static_cast<uint32_t>((hash * 0x9E3779B97F4A7C15ull) >> 32);
+  }
+
+  size_t BucketMask() const { return buckets_.size() - 1; }
+
+  // Returns the slab index of the item of `key`, or kInvalidIndex.
+  uint32_t FindIndex(const key_type& key, uint32_t hash) const {
+    if (buckets_.empty()) {
+      return kInvalidIndex;
+    }
+    const size_t mask = BucketMask();
+    for (size_t bucket = hash & mask;; bucket = (bucket + 1) & mask) {
+      const uint32_t index = buckets_[bucket];
+      if (index == kInvalidIndex) {
+        return kInvalidIndex;
+      }
+      const Node& node = nodes_[index];
+      if (node.hash == hash && KeyEqual()(node.value->first, key)) {
+        return index;
+      }
+    }
+  }
+
+  // Grows the index so that it can hold `size` items with a load factor of 3/4
+  // at most. The number of buckets is a power of two.
+  void ReserveIndex(size_t size) {
+    size_t num_buckets = buckets_.empty() ? 8 : buckets_.size();
+    while (size * 4 > num_buckets * 3) {
+      num_buckets *= 2;
+    }
+    if (num_buckets == buckets_.size()) {
+      return;
+    }
+    buckets_.assign(num_buckets, kInvalidIndex);
+    for (uint32_t index = head_; index != kInvalidIndex;
+         index = nodes_[index].next) {
+      InsertIntoIndex(index);
+    }
+  }
+
+  // Inserts the item at `index`, which is already counted in `size_`.
+  void InsertIntoIndex(uint32_t index) {
+    if (size_ * 4 > buckets_.size() * 3) {
+      // Reinserts all the items of the list, including this one.
+      ReserveIndex(size_);
+      return;
+    }
+    const size_t mask = BucketMask();
+    size_t bucket = nodes_[index].hash & mask;
+    while (buckets_[bucket] != kInvalidIndex) {
+      bucket = (bucket + 1) & mask;
+    }
+    buckets_[bucket] = index;
+  }
+
+  // Removes the item at `index` from the index with backward shift deletion,
+  // which keeps lookups fast without tombstones.
+  void RemoveFromIndex(uint32_t index) {
+    const size_t mask = BucketMask();
+    size_t hole = nodes_[index].hash & mask;
+    while (buckets_[hole] != index) {
+      hole = (hole + 1) & mask;
+    }
+    for (size_t bucket = (hole + 1) & mask; buckets_[bucket] != kInvalidIndex;
+         bucket = (bucket + 1) & mask) {
+      const size_t ideal_bucket = nodes_[buckets_[bucket]].hash & mask;
+      // Moves the item into the hole if the hole is between its ideal bucket
+      // and its current bucket.
+      if (((bucket - ideal_bucket) & mask) >= ((bucket - hole) & mask)) {
+        buckets_[hole] = buckets_[bucket];
+        hole = bucket;
+      }
+    }
+    buckets_[hole] = kInvalidIndex;
+  }
+
+  void LinkFront(uint32_t index) {
+    Node& node = nodes_[index];
+    node.prev = kInvalidIndex;
+    node.next = head_;
+    if (head_ != kInvalidIndex) {
+      nodes_[head_].prev = index;
+    } else {
+      tail_ = index;
+    }
+    head_ = index;
+  }
+
+  void Unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (hand_ == index) {
+      hand_ = node.prev;
+    }
+    if (node.prev != kInvalidIndex) {
+      nodes_[node.prev].next = node.next;
+    } else {
+      head_ = node.next;
+    }
+    if (node.next != kInvalidIndex) {
+      nodes_[node.next].prev = node.prev;
+    } else {
+      tail_ = node.prev;
+    }
+  }
+
+  void Touch(uint32_t index) {
+    switch (policy_) {
+      case FlatLRUCacheEvictionPolicy::kLRU:
+        if (index != head_) {
+          Unlink(index);
+          LinkFront(index);
+        }
+        break;
+      case FlatLRUCacheEvictionPolicy::kSieve:
+        nodes_[index].visited = true;
+        break;
+    }
+  }
+
+  // Returns the index of the next item to evict. The cache must not be empty.
+  uint32_t GetEvictionCandidate() {
+    DCHECK_NE(tail_, kInvalidIndex);
+    if (policy_ == FlatLRUCacheEvictionPolicy::kLRU) {
+      return tail_;
+    }
+    uint32_t index = hand_ != kInvalidIndex ? hand_ : tail_;
+    while (nodes_[index].visited) {
+      nodes_[index].visited = false;
+      index = nodes_[index].prev != kInvalidIndex ? nodes_[index].prev : tail_;
+    }
+    // Erase() moves the hand to the previous item.
+    hand_ = index;
+    return index;
+  }
+
+  std::vector<Node> nodes_;
+  // The open-addressed index: slab indices of the items, or kInvalidIndex.
+  std::vector<uint32_t> buckets_;
+
+  uint32_t head_ = kInvalidIndex;
+  uint32_t tail_ = kInvalidIndex;
+  // The SIEVE hand, which moves from the back towards the front of the list.
+  uint32_t hand_ = kInvalidIndex;
+  uint32_t free_list_ = kInvalidIndex;
+  size_type size_ = 0;
+
+  size_type max_size_;
+  FlatLRUCacheEvictionPolicy policy_;
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_LRU_CACHE_H_
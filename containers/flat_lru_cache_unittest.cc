@@ -0,0 +1,159 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_lru_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+template <class Cache>
+std::vector<int> GetKeys(const Cache& cache) {
+  std::vector<int> keys;
+  for (const auto& [key, value] : cache) {
+    keys.push_back(key);
+  }
+  return keys;
+}
+
+}  // namespace
+
+TEST(FlatLRUCacheTest, Basic) {
+  FlatLRUCache<int, std::string> cache(
+      FlatLRUCache<int, std::string>::NO_AUTO_EVICT);
+  EXPECT_TRUE(cache.empty());
+  EXPECT_EQ(cache.end(), cache.Get(1));
+
+  cache.Put(1, "one");
+  cache.Put(2, "two");
+  EXPECT_EQ(2u, cache.size());
+  ASSERT_NE(cache.end(), cache.Get(1));
+  EXPECT_EQ("one", cache.Get(1)->second);
+  EXPECT_EQ((std::vector<int>{1, 2}), GetKeys(cache));
+
+  // Replacing a value moves the item to the front.
+  cache.Put(2, "deux");
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ("deux", cache.Peek(2)->second);
+  EXPECT_EQ((std::vector<int>{2, 1}), GetKeys(cache));
+
+  // Peek() doesn't move the item.
+  EXPECT_EQ("one", cache.Peek(1)->second);
+  EXPECT_EQ((std::vector<int>{2, 1}), GetKeys(cache));
+
+  EXPECT_EQ(cache.end(), cache.Erase(cache.Peek(1)));
+  EXPECT_EQ(cache.end(), cache.Peek(1));
+  EXPECT_EQ(1u, cache.size());
+
+  cache.Clear();
+  EXPECT_TRUE(cache.empty());
+  EXPECT_EQ(cache.end(), cache.Peek(2));
+  EXPECT_EQ(cache.end(), cache.begin());
+}
+
+TEST(FlatLRUCacheTest, EvictsLeastRecentlyUsed) {
+  FlatLRUCache<int, int> cache(3);
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Put(3, 3);
+  cache.Get(1);
+  cache.Put(4, 4);
+  EXPECT_EQ((std::vector<int>{4, 1, 3}), GetKeys(cache));
+
+  // Reverse iteration starts with the least recently used item.
+  EXPECT_EQ(3, cache.rbegin()->first);
+  cache.Erase(cache.rbegin());
+  EXPECT_EQ((std::vector<int>{4, 1}), GetKeys(cache));
+
+  cache.ShrinkToSize(1);
+  EXPECT_EQ((std::vector<int>{4}), GetKeys(cache));
+}
+
+TEST(FlatLRUCacheTest, Sieve) {
+  FlatLRUCache<int, int> cache(3, FlatLRUCacheEvictionPolicy::kSieve);
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Put(3, 3);
+
+  // Hits don't reorder the list.
+  cache.Get(1);
+  EXPECT_EQ((std::vector<int>{3, 2, 1}), GetKeys(cache));
+
+  // 1 was visited, so the oldest unvisited item is evicted.
+  cache.Put(4, 4);
+  EXPECT_EQ((std::vector<int>{4, 3, 1}), GetKeys(cache));
+
+  // The hand resumes from where it stopped instead of from the oldest item.
+  cache.Put(5, 5);
+  EXPECT_EQ((std::vector<int>{5, 4, 1}), GetKeys(cache));
+
+  // When all the items were visited, the hand wraps around and evicts the
+  // first item it passed.
+  cache.Get(1);
+  cache.Get(4);
+  cache.Get(5);
+  cache.Put(6, 6);
+  EXPECT_EQ((std::vector<int>{6, 5, 1}), GetKeys(cache));
+}
+
+TEST(FlatLRUCacheTest, ManyItems) {
+  constexpr int kNumItems = 10000;
+  FlatLRUCache<int, int> cache(kNumItems / 2);
+  for (int i = 0; i < kNumItems; ++i) {
+    cache.Put(i, i * 2);
+  }
+  EXPECT_EQ(static_cast<size_t>(kNumItems / 2), cache.size());
+  for (int i = 0; i < kNumItems / 2; ++i) {
+    EXPECT_EQ(cache.end(), cache.Peek(i));
+  }
+  for (int i = kNumItems / 2; i < kNumItems; ++i) {
+    ASSERT_NE(cache.end(), cache.Peek(i));
+    EXPECT_EQ(i * 2, cache.Peek(i)->second);
+  }
+
+  // Erasing every other item exercises the backward shift deletion.
+  for (int i = kNumItems / 2; i < kNumItems; i += 2) {
+    cache.Erase(cache.Peek(i));
+  }
+  for (int i = kNumItems / 2; i < kNumItems; ++i) {
+    EXPECT_EQ(i % 2 == 1, cache.Peek(i) != cache.end());
+  }
+}
+
+TEST(FlatLRUCacheTest, GrowsWithoutMaxSize) {
+  FlatLRUCache<std::string, int> cache(
+      FlatLRUCache<std::string, int>::NO_AUTO_EVICT);
+  for (int i = 0; i < 1000; ++i) {
+    cache.Put(std::to_string(i), i);
+  }
+  EXPECT_EQ(1000u, cache.size());
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_NE(cache.end(), cache.Peek(std::to_string(i)));
+    EXPECT_EQ(i, cache.Peek(std::to_string(i))->second);
+  }
+  EXPECT_GT(cache.EstimateMemoryUsage(), 0u);
+}
+
+TEST(FlatLRUCacheTest, MoveOnlyValuesAndSwap) {
+  FlatLRUCache<int, std::unique_ptr<int>> cache1(2);
+  FlatLRUCache<int, std::unique_ptr<int>> cache2(3);
+  cache1.Put(1, std::make_unique<int>(10));
+  cache2.Put(2, std::make_unique<int>(20));
+  cache2.Put(3, std::make_unique<int>(30));
+
+  cache1.Swap(cache2);
+  EXPECT_EQ(3u, cache1.max_size());
+  EXPECT_EQ(2u, cache1.size());
+  EXPECT_EQ(20, *cache1.Peek(2)->second);
+  EXPECT_EQ(1u, cache2.size());
+  EXPECT_EQ(10, *cache2.Peek(1)->second);
+}
+
+}  // namespace base
@@ -946,6 +946,68 @@ TYPED_TEST_P(FlatTreeTest, Replace) {
   EXPECT_THAT(cont, ElementsAre(1, 2, 3, 4));
 }
 
+// ----------------------------------------------------------------------------
+// Bulk insertion.
+
+TEST(FlatTree, BulkInsert) {
+  IntTree cont({2, 4, 6});
+  {
+    auto inserter = cont.bulk_insert();
+    for (int i : {9, 1, 4, 8, 1, 3, 9, 5}) {
+      inserter.insert(i);
+    }
+  }
+  EXPECT_THAT(cont, ElementsAre(1, 2, 3, 4, 5, 6, 8, 9));
+
+  {
+    auto inserter = cont.bulk_insert();
+    inserter.insert(0);
+    inserter.commit();
+    EXPECT_THAT(cont, ElementsAre(0, 1, 2, 3, 4, 5, 6, 8, 9));
+    inserter.insert(7);
+    inserter.insert(2);
+  }
+  EXPECT_THAT(cont, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+
+  // Nothing to merge.
+  { auto inserter = cont.bulk_insert(); }
+  EXPECT_EQ(10u, cont.size());
+}
+
+TEST(FlatTree, BulkInsertKeepsFirst) {
+  struct GetKeyFromIntIntPair {
+    const int& operator()(const std::pair<int, int>& p) const {
+      return p.first;
+    }
+  };
+
+  using IntIntMap = flat_tree<int, GetKeyFromIntIntPair, std::less<int>,
+                              std::vector<IntPair>>;
+
+  IntIntMap cont({{1, 1}, {3, 1}});
+  {
+    auto inserter = cont.bulk_insert();
+    inserter.insert({3, 2});
+    inserter.emplace(2, 2);
+    inserter.insert({1, 2});
+    inserter.emplace(2, 3);
+  }
+  EXPECT_THAT(cont, ElementsAre(IntPair(1, 1), IntPair(2, 2), IntPair(3, 1)));
+}
+
+TEST(FlatTree, BulkInsertMoveOnly) {
+  MoveOnlyTree cont;
+  {
+    auto inserter = cont.bulk_insert();
+    inserter.insert(MoveOnlyInt(3));
+    inserter.emplace(1);
+    inserter.insert(MoveOnlyInt(3));
+  }
+  ASSERT_EQ(2u, cont.size());
+  EXPECT_EQ(1, cont.begin()->data());
+  EXPECT_EQ(3, std::next(cont.begin())->data());
+}
+
 // ----------------------------------------------------------------------------
 // Erase operations.
 
@@ -24,6 +24,15 @@
 
 namespace base {
 
+namespace trace_event::internal {
+
+template <class IDMapType>
+size_t DoEstimateMemoryUsageForIDMap(const IDMapType&);
+template <class IDMapType>
+size_t DoEstimateShallowMemoryUsageForIDMap(const IDMapType&);
+
+}  // namespace trace_event::internal
+
 // This object maintains a list of IDs that can be quickly converted to
 // pointers to objects. It is implemented as a hash table, optimized for
 // relatively small data sets (in the common case, there will be exactly one
@@ -35,6 +44,9 @@ namespace base {
 //
 // The map's value type (the V param) can be any dereferenceable type, such as a
 // raw pointer or smart pointer, and must be comparable with nullptr.
+//
+// For large maps whose IDs are all generated by Add(), see base::DenseIDMap
+// (dense_id_map.h), which looks up IDs by index rather than by hashing them.
 template <typename V, typename K = int32_t>
 class IDMap final {
  public:
@@ -244,6 +256,13 @@ class IDMap final {
   typedef Iterator<const T> const_iterator;
 
  private:
+  template <class IDMapType>
+  friend size_t trace_event::internal::DoEstimateMemoryUsageForIDMap(
+      const IDMapType&);
+  template <class IDMapType>
+  friend size_t trace_event::internal::DoEstimateShallowMemoryUsageForIDMap(
+      const IDMapType&);
+
   // Transforms a map iterator to an iterator on the keys of the map.
   // Used by Clear() to populate |removed_ids_| in bulk.
   struct KeyIterator {
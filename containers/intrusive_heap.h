@@ -25,6 +25,13 @@
 // are storing is able to have its sort key be changed externally you can
 // repair the heap by resorting the modified element via a call to "Update".
 //
+// By default the heap is binary. A heap with a larger |kArity| is shallower,
+// and the children of a node, which are compared together on the way down, are
+// adjacent in memory: a 4-ary heap takes about half the cache misses of a
+// binary heap to pop an element, at the cost of a few more comparisons. This
+// pays off for large heaps that are mostly popped, such as delayed task
+// queues.
+//
 // Example usage:
 //
 //   // Create a heap, wrapping integer elements with WithHeapHandle in order to
@@ -147,7 +154,6 @@
 #include "base/check.h"
 #include "base/check_op.h"
 #include "base/memory/ptr_util.h"
-#include "base/ranges/algorithm.h"
 #include "third_party/abseil-cpp/absl/container/inlined_vector.h"
 
 namespace base {
@@ -189,7 +195,10 @@ class BASE_EXPORT HeapHandle {
                                           const HeapHandle& rhs) = default;
 
  private:
-  template <typename T, typename Compare, typename HeapHandleAccessor>
+  template <typename T,
+            typename Compare,
+            typename HeapHandleAccessor,
+            size_t kArity>
   friend class IntrusiveHeap;
 
   // Only IntrusiveHeaps can create valid HeapHandles.
@@ -219,8 +228,11 @@ struct DefaultHeapHandleAccessor {
 // container).
 template <typename T,
           typename Compare = std::less<T>,
-          typename HeapHandleAccessor = DefaultHeapHandleAccessor<T>>
+          typename HeapHandleAccessor = DefaultHeapHandleAccessor<T>,
+          size_t kArity = 2>
 class IntrusiveHeap {
+  static_assert(kArity >= 2, "A heap node needs at least two children");
+
  private:
   using UnderlyingType = std::vector<T>;
 
@@ -349,6 +361,8 @@ class IntrusiveHeap {
   // All insertion operations invalidate iterators, pointers and references.
   // Handles remain valid. Insertion of one element is amortized O(lg size)
   // (occasional O(size) cost if a new vector allocation is required).
+  // Inserting a range of k elements is O(k lg size), or O(size) if the heap is
+  // rebuilt because k is larger than the current size.
 
   const_iterator insert(const value_type& value) { return InsertImpl(value); }
   const_iterator insert(value_type&& value) {
@@ -435,9 +449,9 @@ class IntrusiveHeap {
     }
 
     // Repair the heap and ensure handles are pointing to the right index.
-    ranges::make_heap(impl_.heap_, value_comp());
     for (size_t i = 0; i < size(); ++i)
       SetHeapHandle(i);
+    Heapify();
 
     // Explicitly delete elements last.
     elements_to_delete.clear();
@@ -588,6 +602,11 @@ class IntrusiveHeap {
   template <typename U>
   const_iterator ReplaceTopImpl(U element);
 
+  // Restores the heap property over the whole heap in O(size), by moving the
+  // elements down from the last parent up to the root (Floyd's algorithm). The
+  // elements must have valid handles.
+  void Heapify();
+
   // To support comparators that may not be possible to default-construct, we
   // have to store an instance of value_compare. Using this to store all
   // internal state of IntrusiveHeap and using private inheritance to store
@@ -710,13 +729,17 @@ class WithHeapHandle : public InternalHeapHandleStorage {
 
 namespace intrusive_heap {
 
-BASE_EXPORT inline size_t ParentIndex(size_t i) {
+// Index helpers for a heap whose nodes have |kArity| children, the first of
+// which is at LeftIndex().
+template <size_t kArity = 2>
+inline size_t ParentIndex(size_t i) {
   DCHECK_NE(0u, i);
-  return (i - 1) / 2;
+  return (i - 1) / kArity;
 }
 
-BASE_EXPORT inline size_t LeftIndex(size_t i) {
-  return 2 * i + 1;
+template <size_t kArity = 2>
+inline size_t LeftIndex(size_t i) {
+  return kArity * i + 1;
 }
 
 template <typename HandleType>
@@ -734,8 +757,11 @@ BASE_EXPORT inline void CheckInvalidOrEqualTo(HeapHandle handle, size_t index) {
 ////////////////////////////////////////////////////////////////////////////////
 // IntrusiveHeap
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::IntrusiveHeap(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::IntrusiveHeap(
     const IntrusiveHeap& other)
     : impl_(other.impl_) {
   for (size_t i = 0; i < size(); ++i) {
@@ -743,23 +769,32 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::IntrusiveHeap(
   }
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::~IntrusiveHeap() {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::~IntrusiveHeap() {
   clear();
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-IntrusiveHeap<T, Compare, HeapHandleAccessor>&
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::operator=(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>&
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::operator=(
     IntrusiveHeap&& other) noexcept {
   clear();
   impl_ = std::move(other.impl_);
   return *this;
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-IntrusiveHeap<T, Compare, HeapHandleAccessor>&
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::operator=(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>&
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::operator=(
     const IntrusiveHeap& other) {
   clear();
   impl_ = other.impl_;
@@ -769,16 +804,22 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::operator=(
   return *this;
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-IntrusiveHeap<T, Compare, HeapHandleAccessor>&
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::operator=(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>&
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::operator=(
     std::initializer_list<value_type> ilist) {
   clear();
   insert(std::begin(ilist), std::end(ilist));
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::clear() {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::clear() {
   // Make all of the handles invalid before cleaning up the heap.
   for (size_type i = 0; i < size(); ++i) {
     ClearHeapHandle(i);
@@ -788,26 +829,50 @@ void IntrusiveHeap<T, Compare, HeapHandleAccessor>::clear() {
   impl_.heap_.clear();
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
 template <class InputIterator>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::insert(InputIterator first,
-                                                           InputIterator last) {
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::insert(
+    InputIterator first,
+    InputIterator last) {
+  const size_type old_size = size();
   for (auto it = first; it != last; ++it) {
-    insert(value_type(*it));
+    impl_.heap_.push_back(value_type(*it));
+    SetHeapHandle(size() - 1);
+  }
+
+  // Moving each new element up costs O(lg size) each, which is more than
+  // rebuilding the heap once there are more new elements than old ones.
+  if (size() - old_size > old_size) {
+    Heapify();
+    return;
+  }
+  for (size_type i = old_size; i < size(); ++i) {
+    MakeHole(i);
+    MoveHoleUpAndFill(i, std::move_if_noexcept(impl_.heap_[i]));
   }
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
 template <typename... Args>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::const_iterator
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::emplace(Args&&... args) {
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::const_iterator
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::emplace(
+    Args&&... args) {
   value_type value(std::forward<Args>(args)...);
   return InsertImpl(std::move_if_noexcept(value));
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::value_type
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::take(size_type pos) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::value_type
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::take(size_type pos) {
   // Make a hole by taking the element out of the heap.
   MakeHole(pos);
   value_type val = std::move(impl_.heap_[pos]);
@@ -829,8 +894,12 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::take(size_type pos) {
 }
 
 // This is effectively identical to "take", but it avoids an unnecessary move.
-template <typename T, typename Compare, typename HeapHandleAccessor>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::erase(size_type pos) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::erase(
+    size_type pos) {
   DCHECK_LT(pos, size());
   // Make a hole by taking the element out of the heap.
   MakeHole(pos);
@@ -849,9 +918,12 @@ void IntrusiveHeap<T, Compare, HeapHandleAccessor>::erase(size_type pos) {
   impl_.heap_.pop_back();
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::const_iterator
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::Update(size_type pos) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::const_iterator
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::Update(size_type pos) {
   DCHECK_LT(pos, size());
   MakeHole(pos);
 
@@ -859,7 +931,7 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::Update(size_type pos) {
   bool child_greater_eq_parent = false;
   size_type i = 0;
   if (pos > 0) {
-    i = intrusive_heap::ParentIndex(pos);
+    i = intrusive_heap::ParentIndex<kArity>(pos);
     child_greater_eq_parent = !Less(pos, i);
   }
 
@@ -873,8 +945,11 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::Update(size_type pos) {
   return cbegin() + i;
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::swap(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::swap(
     IntrusiveHeap& other) noexcept {
   std::swap(impl_.get_value_compare(), other.impl_.get_value_compare());
   std::swap(impl_.get_heap_handle_access(),
@@ -882,9 +957,13 @@ void IntrusiveHeap<T, Compare, HeapHandleAccessor>::swap(
   std::swap(impl_.heap_, other.impl_.heap_);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::size_type
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::ToIndex(const_iterator pos) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::size_type
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::ToIndex(
+    const_iterator pos) {
   DCHECK(cbegin() <= pos);
   DCHECK(pos <= cend());
   if (pos == cend())
@@ -892,9 +971,12 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::ToIndex(const_iterator pos) {
   return pos - cbegin();
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::size_type
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::ToIndex(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::size_type
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::ToIndex(
     const_reverse_iterator pos) {
   DCHECK(crbegin() <= pos);
   DCHECK(pos <= crend());
@@ -903,57 +985,86 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::ToIndex(
   return (pos.base() - cbegin()) - 1;
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::SetHeapHandle(size_type i) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::SetHeapHandle(
+    size_type i) {
   impl_.get_heap_handle_access().SetHeapHandle(&impl_.heap_[i], HeapHandle(i));
   intrusive_heap::CheckInvalidOrEqualTo(GetHeapHandle(i), i);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::ClearHeapHandle(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::ClearHeapHandle(
     size_type i) {
   impl_.get_heap_handle_access().ClearHeapHandle(&impl_.heap_[i]);
   DCHECK(!GetHeapHandle(i).IsValid());
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-HeapHandle IntrusiveHeap<T, Compare, HeapHandleAccessor>::GetHeapHandle(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+HeapHandle IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::GetHeapHandle(
     size_type i) {
   return impl_.get_heap_handle_access().GetHeapHandle(&impl_.heap_[i]);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-bool IntrusiveHeap<T, Compare, HeapHandleAccessor>::Less(size_type i,
-                                                         size_type j) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+bool IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::Less(size_type i,
+                                                                 size_type j) {
   DCHECK_LT(i, size());
   DCHECK_LT(j, size());
   return impl_.get_value_compare()(impl_.heap_[i], impl_.heap_[j]);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-bool IntrusiveHeap<T, Compare, HeapHandleAccessor>::Less(const T& element,
-                                                         size_type i) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+bool IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::Less(
+    const T& element,
+    size_type i) {
   DCHECK_LT(i, size());
   return impl_.get_value_compare()(element, impl_.heap_[i]);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-bool IntrusiveHeap<T, Compare, HeapHandleAccessor>::Less(size_type i,
-                                                         const T& element) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+bool IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::Less(
+    size_type i,
+    const T& element) {
   DCHECK_LT(i, size());
   return impl_.get_value_compare()(impl_.heap_[i], element);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::MakeHole(size_type pos) {
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::MakeHole(
+    size_type pos) {
   DCHECK_LT(pos, size());
   ClearHeapHandle(pos);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
 template <typename U>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::FillHole(size_type hole_pos,
-                                                             U element) {
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::FillHole(
+    size_type hole_pos,
+    U element) {
   // The hole that we're filling may not yet exist. This can occur when
   // inserting a new element into the heap.
   DCHECK_LE(hole_pos, size());
@@ -965,8 +1076,11 @@ void IntrusiveHeap<T, Compare, HeapHandleAccessor>::FillHole(size_type hole_pos,
   SetHeapHandle(hole_pos);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
-void IntrusiveHeap<T, Compare, HeapHandleAccessor>::MoveHole(
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::MoveHole(
     size_type new_hole_pos,
     size_type old_hole_pos) {
   // The old hole position may be one past the end. This occurs when a new
@@ -984,10 +1098,13 @@ void IntrusiveHeap<T, Compare, HeapHandleAccessor>::MoveHole(
   SetHeapHandle(old_hole_pos);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
 template <typename U>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::size_type
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::MoveHoleUpAndFill(
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::size_type
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::MoveHoleUpAndFill(
     size_type hole_pos,
     U element) {
   // Moving 1 spot beyond the end is fine. This happens when we insert a new
@@ -997,7 +1114,7 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::MoveHoleUpAndFill(
   // Stop when the element is as far up as it can go.
   while (hole_pos != 0) {
     // If our parent is >= to us, we can stop.
-    size_type parent = intrusive_heap::ParentIndex(hole_pos);
+    size_type parent = intrusive_heap::ParentIndex<kArity>(hole_pos);
     if (!Less(parent, element))
       break;
 
@@ -1009,10 +1126,13 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::MoveHoleUpAndFill(
   return hole_pos;
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
 template <typename FillElementType, typename U>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::size_type
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::MoveHoleDownAndFill(
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::size_type
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::MoveHoleDownAndFill(
     size_type hole_pos,
     U element) {
   DCHECK_LT(hole_pos, size());
@@ -1026,15 +1146,17 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::MoveHoleDownAndFill(
 
   while (true) {
     // If this spot has no children, then we've gone down as far as we can go.
-    size_type left = intrusive_heap::LeftIndex(hole_pos);
+    size_type left = intrusive_heap::LeftIndex<kArity>(hole_pos);
     if (left >= n)
       break;
-    size_type right = left + 1;
 
-    // Get the larger of the potentially two child nodes.
+    // Get the largest of the up to |kArity| child nodes.
     size_type largest = left;
-    if (right < n && Less(left, right))
-      largest = right;
+    const size_type end = std::min(left + kArity, n);
+    for (size_type child = left + 1; child < end; ++child) {
+      if (Less(largest, child))
+        largest = child;
+    }
 
     // If we're not deterministically moving the element all the way down to
     // become a leaf, then stop when it is >= the largest of the children.
@@ -1055,10 +1177,14 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::MoveHoleDownAndFill(
   return hole_pos;
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
 template <typename U>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::const_iterator
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::InsertImpl(U element) {
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::const_iterator
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::InsertImpl(
+    U element) {
   // MoveHoleUpAndFill can tolerate the initial hole being in a slot that
   // doesn't yet exist. It will be created by MoveHole by copy/move, thus
   // removing the need for a default constructor.
@@ -1066,11 +1192,15 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::InsertImpl(U element) {
   return cbegin() + static_cast<difference_type>(i);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
 template <typename U>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::const_iterator
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::ReplaceImpl(size_type pos,
-                                                           U element) {
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::const_iterator
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::ReplaceImpl(
+    size_type pos,
+    U element) {
   // If we're greater than our parent we need to go up, otherwise we may need
   // to go down.
   MakeHole(pos);
@@ -1083,16 +1213,34 @@ IntrusiveHeap<T, Compare, HeapHandleAccessor>::ReplaceImpl(size_type pos,
   return cbegin() + static_cast<difference_type>(i);
 }
 
-template <typename T, typename Compare, typename HeapHandleAccessor>
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
 template <typename U>
-typename IntrusiveHeap<T, Compare, HeapHandleAccessor>::const_iterator
-IntrusiveHeap<T, Compare, HeapHandleAccessor>::ReplaceTopImpl(U element) {
+typename IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::const_iterator
+IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::ReplaceTopImpl(
+    U element) {
   MakeHole(0u);
   size_type i =
       MoveHoleDownAndFill<WithElement>(0u, std::move_if_noexcept(element));
   return cbegin() + static_cast<difference_type>(i);
 }
 
+template <typename T,
+          typename Compare,
+          typename HeapHandleAccessor,
+          size_t kArity>
+void IntrusiveHeap<T, Compare, HeapHandleAccessor, kArity>::Heapify() {
+  if (size() < 2)
+    return;
+  for (size_type i = intrusive_heap::ParentIndex<kArity>(GetLastIndex()) + 1;
+       i-- > 0;) {
+    MakeHole(i);
+    MoveHoleDownAndFill<WithElement>(i, std::move_if_noexcept(impl_.heap_[i]));
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // WithHeapHandle
 
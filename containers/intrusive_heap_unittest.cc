@@ -15,6 +15,7 @@
 #include "base/memory/raw_ptr.h"
 #include "base/notreached.h"
 #include "base/rand_util.h"
+#include "base/ranges/algorithm.h"
 #include "base/test/bind.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -25,20 +26,19 @@ namespace {
 
 using IntrusiveHeapInt = IntrusiveHeap<WithHeapHandle<int>>;
 
-// Validates whether or not the given heap satisfies the heap invariant.
-template <class H>
+// Validates whether or not the given heap, whose nodes have |kArity| children,
+// satisfies the heap invariant.
+template <size_t kArity = 2, class H>
 void ExpectHeap(const H& heap) {
   const auto& less = heap.value_comp();
   const auto& handle_access = heap.heap_handle_access();
 
   for (size_t i = 0; i < heap.size(); ++i) {
-    size_t left = intrusive_heap::LeftIndex(i);
-    size_t right = left + 1;
-
-    if (left < heap.size())
-      EXPECT_FALSE(less(heap[i], heap[left]));
-    if (right < heap.size())
-      EXPECT_FALSE(less(heap[i], heap[right]));
+    size_t left = intrusive_heap::LeftIndex<kArity>(i);
+    for (size_t child = left; child < left + kArity && child < heap.size();
+         ++child) {
+      EXPECT_FALSE(less(heap[i], heap[child]));
+    }
 
     intrusive_heap::CheckInvalidOrEqualTo(handle_access.GetHeapHandle(&heap[i]),
                                           i);
@@ -52,17 +52,14 @@ void ExpectHeap(const H& heap) {
 void ExpectCanonical(const IntrusiveHeapInt& heap) {
   ExpectHeap(heap);
 
-  // Manual implementation of a max-heap inserting the elements defined by
-  // CANONICAL_ELEMENTS:
-  // 3
-  // 3 1
-  // 3 1 2
-  // 3 1 2 4 -> 3 4 2 1 -> 4 3 2 1
-  // 4 3 2 1 5 -> 4 5 2 1 3 -> 5 4 2 1 3
-  // 5 4 2 1 3 6 -> 5 4 6 1 3 2 -> 6 4 5 1 3 2
-  // 6 4 5 1 3 2 7 -> 6 4 7 1 3 2 5 -> 7 4 6 1 3 2 5
-  // 7 4 6 1 3 2 5 0
-  std::vector<int> expected{7, 4, 6, 1, 3, 2, 5, 0};
+  // Manual implementation of a max-heap built from the elements defined by
+  // CANONICAL_ELEMENTS, by moving down the parents from the last one:
+  // 3 1 2 4 5 6 7 0
+  // 3 1 2 4 5 6 7 0 (4 stays above 0)
+  // 3 1 7 4 5 6 2 0
+  // 3 5 7 4 1 6 2 0
+  // 7 5 3 4 1 6 2 0 -> 7 5 6 4 1 3 2 0
+  std::vector<int> expected{7, 5, 6, 4, 1, 3, 2, 0};
   std::vector<int> actual;
   for (const auto& element : heap)
     actual.push_back(element.value());
@@ -1113,6 +1110,102 @@ TEST(IntrusiveHeapTest, EraseIf) {
   EXPECT_THAT(results, testing::ElementsAre(1, 3, 5, 7, 9));
 }
 
+TEST(IntrusiveHeapTest, InsertRange) {
+  HeapHandle index[40];
+  std::vector<TestElement> elements;
+  for (int i = 0; i < 40; i++)
+    elements.push_back({(i * 17) % 40, &index[(i * 17) % 40]});
+
+  // Inserting into an empty heap rebuilds it.
+  IntrusiveHeap<TestElement> heap(elements.begin(), elements.begin() + 30);
+  ExpectHeap(heap);
+  EXPECT_EQ(30u, heap.size());
+
+  // Inserting fewer elements than the heap holds moves each of them up.
+  heap.insert(elements.begin() + 30, elements.end());
+  ExpectHeap(heap);
+  EXPECT_EQ(40u, heap.size());
+
+  for (int i = 0; i < 40; i++) {
+    ASSERT_TRUE(index[i].IsValid());
+    EXPECT_EQ(i, heap[index[i]].key);
+  }
+  for (int i = 0; i < 40; i++) {
+    EXPECT_EQ(i, heap.top().key);
+    heap.pop();
+  }
+}
+
+TEST(IntrusiveHeapTest, FourAry) {
+  using FourAryHeap = IntrusiveHeap<TestElement, std::less<TestElement>,
+                                    DefaultHeapHandleAccessor<TestElement>, 4>;
+  HeapHandle index[100];
+  std::vector<int> keys(100);
+  FourAryHeap heap;
+
+  for (int i = 0; i < 100; i++) {
+    keys[i] = (i * 7919) % 1000;
+    heap.insert({keys[i], &index[i]});
+  }
+  ExpectHeap<4>(heap);
+
+  // Erase every third element and change the key of every other one.
+  for (int i = 0; i < 100; i += 3) {
+    heap.erase(index[i]);
+    EXPECT_FALSE(index[i].IsValid());
+    ExpectHeap<4>(heap);
+  }
+  for (int i = 1; i < 100; i += 6) {
+    keys[i] = (i * 31 + 500) % 1000;
+    heap.Replace(index[i], {keys[i], &index[i]});
+    ExpectHeap<4>(heap);
+  }
+  for (int i = 0; i < 100; i++) {
+    if (index[i].IsValid())
+      EXPECT_EQ(keys[i], heap[index[i]].key);
+  }
+
+  // Popping returns the remaining keys in order.
+  std::vector<int> expected;
+  for (int i = 0; i < 100; i++) {
+    if (i % 3 != 0)
+      expected.push_back(keys[i]);
+  }
+  ranges::sort(expected);
+  std::vector<int> results;
+  while (!heap.empty()) {
+    results.push_back(heap.top().key);
+    heap.pop();
+    ExpectHeap<4>(heap);
+  }
+  EXPECT_EQ(expected, results);
+}
+
+TEST(IntrusiveHeapTest, FourAryInsertRangeAndEraseIf) {
+  using FourAryHeap = IntrusiveHeap<TestElement, std::less<TestElement>,
+                                    DefaultHeapHandleAccessor<TestElement>, 4>;
+  HeapHandle index[50];
+  std::vector<TestElement> elements;
+  for (int i = 0; i < 50; i++)
+    elements.push_back({49 - i, &index[49 - i]});
+
+  FourAryHeap heap(elements.begin(), elements.end());
+  ExpectHeap<4>(heap);
+  EXPECT_EQ(0, heap.top().key);
+
+  heap.EraseIf([](const TestElement& element) { return IsEven(element.key); });
+  ExpectHeap<4>(heap);
+  for (int i = 0; i < 50; i++) {
+    EXPECT_EQ(!IsEven(i), index[i].IsValid());
+    if (index[i].IsValid())
+      EXPECT_EQ(i, heap[index[i]].key);
+  }
+
+  heap.ReplaceTop({100, &index[1]});
+  ExpectHeap<4>(heap);
+  EXPECT_EQ(3, heap.top().key);
+}
+
 // A comparator class whose sole purpose is to allow the insertion of a
 // ScopedClosureRunner inside the heap. The ordering does not matter.
 class Comparator {
@@ -33,6 +33,8 @@ namespace trace_event::internal {
 
 template <class LruCacheType>
 size_t DoEstimateMemoryUsageForLruCache(const LruCacheType&);
+template <class LruCacheType>
+size_t DoEstimateShallowMemoryUsageForLruCache(const LruCacheType&);
 
 }  // namespace trace_event::internal
 
@@ -219,6 +221,9 @@ class LRUCacheBase {
   template <class LruCacheType>
   friend size_t trace_event::internal::DoEstimateMemoryUsageForLruCache(
       const LruCacheType&);
+  template <class LruCacheType>
+  friend size_t trace_event::internal::DoEstimateShallowMemoryUsageForLruCache(
+      const LruCacheType&);
 
   ValueList ordering_;
   // TODO(crbug.com/40069408): Remove annotation once crbug.com/1472363 is
@@ -0,0 +1,229 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_MPMC_QUEUE_H_
+#define BASE_CONTAINERS_MPMC_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <optional>
+#include <utility>
+
+#include "base/check.h"
+#include "base/containers/span.h"
+#include "base/synchronization/atomic_waiter.h"
+
+namespace base {
+
+// A bounded, lock-free, multi-producer multi-consumer FIFO queue of up to
+// `kCapacity` elements, which must be a power of two. This is Dmitry Vyukov's
+// bounded MPMC queue: each cell has a sequence number which tells producers
+// and consumers whether it is free or full for their position, so that a push
+// or a pop is one compare-and-swap on the shared index plus one store on the
+// cell. The producer and consumer indices are on separate cache lines.
+//
+// Prefer base::SPSCQueue (spsc_queue.h) when there is a single producer and a
+// single consumer: it needs no compare-and-swap and can publish batches with
+// one store, whereas TryPushBatch() and TryPopBatch() here are loops.
+//
+// With Mode::kBlocking, Push() and Pop() block the thread with AtomicWaiter
+// while the queue is full or empty. That mode costs a memory fence per
+// operation, so use kNonBlocking if the threads only poll.
+template <typename T, size_t kCapacity>
+class MPMCQueue {
+ public:
+  static_assert(kCapacity > 1 && (kCapacity & (kCapacity - 1)) == 0,
+                "kCapacity must be a power of two, other than 1");
+  static_assert(kCapacity <= (size_t{1} << 30), "kCapacity is too large");
+
+  enum class Mode {
+    kNonBlocking,
+    kBlocking,
+  };
+
+  explicit MPMCQueue(Mode mode = Mode::kNonBlocking) : mode_(mode) {
+    for (uint32_t i = 0; i < kCapacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  MPMCQueue(const MPMCQueue&) = delete;
+  MPMCQueue& operator=(const MPMCQueue&) = delete;
+  ~MPMCQueue() = default;
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+  // Pushes `value` if the queue isn't full. Returns false, without moving
+  // from `value`, if it is.
+  bool TryPush(const T& value) { return TryPushImpl(value); }
+  bool TryPush(T&& value) { return TryPushImpl(std::move(value)); }
+
+  // Moves as many of the first elements of `values` as fit into the queue.
+  // Returns how many were moved. Elements of other producers may be
+  // interleaved with them.
+  size_t TryPushBatch(span<T> values) {
+    size_t count = 0;
+    while (count < values.size() && TryPush(std::move(values[count]))) {
+      ++count;
+    }
+    return count;
+  }
+
+  // Pushes `value`, waiting for space if the queue is full. Requires
+  // Mode::kBlocking.
+  void Push(T value) {
+    DCHECK(mode_ == Mode::kBlocking);
+    while (!TryPush(std::move(value))) {
+      // Waits for the consumer of the previous round to free the cell.
+      const uint32_t position =
+          enqueue_position_.load(std::memory_order_relaxed);
+      Cell& cell = cells_[position & kMask];
+      const uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+      if (static_cast<int32_t>(sequence - position) < 0) {
+        Wait(cell, sequence);
+      }
+    }
+  }
+
+  // Pops the oldest element, or returns nullopt if the queue is empty.
+  std::optional<T> TryPop() {
+    uint32_t position = dequeue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[position & kMask];
+      const uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const int32_t diff = static_cast<int32_t>(sequence - (position + 1));
+      if (diff == 0) {
+        if (dequeue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          std::optional<T> value = std::move(cell.value);
+          cell.value.reset();
+          // Frees the cell for the producer of the next round.
+          cell.sequence.store(position + kCapacity, std::memory_order_release);
+          Notify(cell);
+          return value;
+        }
+      } else if (diff < 0) {
+        return std::nullopt;
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Moves up to `values.size()` of the oldest elements into `values`. Returns
+  // how many were moved.
+  size_t TryPopBatch(span<T> values) {
+    size_t count = 0;
+    while (count < values.size()) {
+      std::optional<T> value = TryPop();
+      if (!value) {
+        break;
+      }
+      values[count++] = std::move(*value);
+    }
+    return count;
+  }
+
+  // Pops the oldest element, waiting for one if the queue is empty. Requires
+  // Mode::kBlocking.
+  T Pop() {
+    DCHECK(mode_ == Mode::kBlocking);
+    while (true) {
+      std::optional<T> value = TryPop();
+      if (value) {
+        return std::move(*value);
+      }
+      // Waits for the producer of this round to fill the cell.
+      const uint32_t position =
+          dequeue_position_.load(std::memory_order_relaxed);
+      Cell& cell = cells_[position & kMask];
+      const uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+      if (static_cast<int32_t>(sequence - (position + 1)) < 0) {
+        Wait(cell, sequence);
+      }
+    }
+  }
+
+  // Returns the approximate number of elements.
+  size_t size() const {
+    const uint32_t size = enqueue_position_.load(std::memory_order_relaxed) -
+                          dequeue_position_.load(std::memory_order_relaxed);
+    // The positions are read at different times.
+    return static_cast<int32_t>(size) < 0 ? 0
+                                          : std::min<size_t>(size, kCapacity);
+  }
+
+  bool empty() const { return size() == 0; }
+
+ private:
+  static constexpr uint32_t kMask = kCapacity - 1;
+
+  struct Cell {
+    // `position` if the cell is free for the producer of `position`,
+    // `position + 1` once it is filled for the consumer of `position`.
+    std::atomic<uint32_t> sequence;
+    std::optional<T> value;
+  };
+
+  template <typename U>
+  bool TryPushImpl(U&& value) {
+    uint32_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[position & kMask];
+      const uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const int32_t diff = static_cast<int32_t>(sequence - position);
+      if (diff == 0) {
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          cell.value.emplace(std::forward<U>(value));
+          cell.sequence.store(position + 1, std::memory_order_release);
+          Notify(cell);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Waits for the sequence of `cell` to change from `sequence`. The fences of
+  // Wait() and Notify() ensure that either the waiter sees the new sequence,
+  // or the notifier sees the waiter.
+  void Wait(Cell& cell, uint32_t sequence) {
+    num_waiters_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (cell.sequence.load(std::memory_order_relaxed) == sequence) {
+      AtomicWaiter::Wait(cell.sequence, sequence);
+    }
+    num_waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void Notify(Cell& cell) {
+    if (mode_ != Mode::kBlocking) {
+      return;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_waiters_.load(std::memory_order_relaxed) > 0) {
+      // Producers and consumers of different rounds may wait on the cell.
+      AtomicWaiter::NotifyAll(cell.sequence);
+    }
+  }
+
+  const Mode mode_;
+
+  alignas(64) std::atomic<uint32_t> enqueue_position_{0};
+  alignas(64) std::atomic<uint32_t> dequeue_position_{0};
+  alignas(64) std::atomic<uint32_t> num_waiters_{0};
+
+  alignas(64) std::array<Cell, kCapacity> cells_;
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_MPMC_QUEUE_H_
@@ -0,0 +1,146 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/mpmc_queue.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/circular_deque.h"
+#include "base/memory/raw_ref.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixMPMCQueue[] = "MPMCQueue.";
+constexpr char kMetricThroughput[] = "throughput";
+constexpr char kStoryMPMCQueue[] = "4_producers_4_consumers";
+constexpr char kStoryLockedDeque[] =
+    "4_producers_4_consumers_locked_circular_deque_baseline";
+
+constexpr size_t kCapacity = 1024;
+constexpr int kNumThreadsPerSide = 4;
+constexpr uint64_t kNumElementsPerThread = 250000;
+
+// What cross-thread handoffs use today: a bounded circular_deque behind a
+// Lock, with a ConditionVariable per direction.
+class LockedQueue {
+ public:
+  void Push(uint64_t value) {
+    AutoLock lock(lock_);
+    while (deque_.size() == kCapacity) {
+      not_full_.Wait();
+    }
+    deque_.push_back(value);
+    not_empty_.Signal();
+  }
+
+  uint64_t Pop() {
+    AutoLock lock(lock_);
+    while (deque_.empty()) {
+      not_empty_.Wait();
+    }
+    const uint64_t value = deque_.front();
+    deque_.pop_front();
+    not_full_.Signal();
+    return value;
+  }
+
+ private:
+  Lock lock_;
+  ConditionVariable not_empty_{&lock_};
+  ConditionVariable not_full_{&lock_};
+  circular_deque<uint64_t> deque_ GUARDED_BY(lock_);
+};
+
+template <typename QueueType>
+class Producer : public SimpleThread {
+ public:
+  explicit Producer(QueueType& queue)
+      : SimpleThread("MPMCQueuePerfTest.Producer"), queue_(queue) {}
+
+  void Run() override {
+    for (uint64_t i = 0; i < kNumElementsPerThread; ++i) {
+      queue_->Push(i);
+    }
+  }
+
+ private:
+  const raw_ref<QueueType> queue_;
+};
+
+template <typename QueueType>
+class Consumer : public SimpleThread {
+ public:
+  Consumer(QueueType& queue, std::atomic<uint64_t>& sum)
+      : SimpleThread("MPMCQueuePerfTest.Consumer"), queue_(queue), sum_(sum) {}
+
+  void Run() override {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < kNumElementsPerThread; ++i) {
+      sum += queue_->Pop();
+    }
+    sum_->fetch_add(sum, std::memory_order_relaxed);
+  }
+
+ private:
+  const raw_ref<QueueType> queue_;
+  const raw_ref<std::atomic<uint64_t>> sum_;
+};
+
+template <typename QueueType>
+void RunTest(QueueType& queue, const std::string& story) {
+  std::atomic<uint64_t> sum{0};
+  std::vector<std::unique_ptr<SimpleThread>> threads;
+  for (int i = 0; i < kNumThreadsPerSide; ++i) {
+    threads.push_back(std::make_unique<Producer<QueueType>>(queue));
+    threads.push_back(std::make_unique<Consumer<QueueType>>(queue, sum));
+  }
+
+  ElapsedTimer timer;
+  for (auto& thread : threads) {
+    thread->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+  const TimeDelta elapsed = timer.Elapsed();
+  EXPECT_EQ(kNumThreadsPerSide * kNumElementsPerThread *
+                (kNumElementsPerThread - 1) / 2,
+            sum.load());
+
+  perf_test::PerfResultReporter reporter(kMetricPrefixMPMCQueue, story);
+  reporter.RegisterImportantMetric(kMetricThroughput, "elements/s");
+  reporter.AddResult(kMetricThroughput,
+                     kNumThreadsPerSide * kNumElementsPerThread /
+                         elapsed.InSecondsF());
+}
+
+}  // namespace
+
+TEST(MPMCQueuePerfTest, Blocking) {
+  using Queue = MPMCQueue<uint64_t, kCapacity>;
+  Queue queue(Queue::Mode::kBlocking);
+  RunTest(queue, kStoryMPMCQueue);
+}
+
+TEST(MPMCQueuePerfTest, LockedDequeBaseline) {
+  LockedQueue queue;
+  RunTest(queue, kStoryLockedDeque);
+}
+
+}  // namespace base
@@ -0,0 +1,134 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/mpmc_queue.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "base/memory/raw_ref.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+constexpr int kNumThreads = 4;
+constexpr int kNumElementsPerProducer = 20000;
+
+using TestQueue = MPMCQueue<int, 64>;
+
+class Producer : public SimpleThread {
+ public:
+  Producer(TestQueue& queue, int first_value)
+      : SimpleThread("MPMCQueueTest.Producer"),
+        queue_(queue),
+        first_value_(first_value) {}
+
+  void Run() override {
+    for (int i = first_value_; i < first_value_ + kNumElementsPerProducer;
+         ++i) {
+      queue_->Push(i);
+    }
+  }
+
+ private:
+  const raw_ref<TestQueue> queue_;
+  const int first_value_;
+};
+
+// Pops `kNumElementsPerProducer` values and adds them to `sum`.
+class Consumer : public SimpleThread {
+ public:
+  Consumer(TestQueue& queue, std::atomic<int64_t>& sum)
+      : SimpleThread("MPMCQueueTest.Consumer"), queue_(queue), sum_(sum) {}
+
+  void Run() override {
+    int64_t sum = 0;
+    for (int i = 0; i < kNumElementsPerProducer; ++i) {
+      sum += queue_->Pop();
+    }
+    sum_->fetch_add(sum, std::memory_order_relaxed);
+  }
+
+ private:
+  const raw_ref<TestQueue> queue_;
+  const raw_ref<std::atomic<int64_t>> sum_;
+};
+
+}  // namespace
+
+TEST(MPMCQueueTest, PushPop) {
+  MPMCQueue<std::unique_ptr<int>, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(std::nullopt, queue.TryPop());
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.TryPush(std::make_unique<int>(i)));
+  }
+  EXPECT_EQ(4u, queue.size());
+  // A failed push doesn't consume the value.
+  auto value = std::make_unique<int>(4);
+  EXPECT_FALSE(queue.TryPush(std::move(value)));
+  ASSERT_TRUE(value);
+
+  for (int i = 0; i < 4; ++i) {
+    std::optional<std::unique_ptr<int>> popped = queue.TryPop();
+    ASSERT_TRUE(popped);
+    EXPECT_EQ(i, **popped);
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MPMCQueueTest, Batches) {
+  MPMCQueue<int, 8> queue;
+  std::array<int, 6> input = {0, 1, 2, 3, 4, 5};
+  EXPECT_EQ(6u, queue.TryPushBatch(input));
+  EXPECT_EQ(2u, queue.TryPushBatch(input));
+
+  std::array<int, 5> output = {};
+  EXPECT_EQ(5u, queue.TryPopBatch(output));
+  EXPECT_EQ((std::array<int, 5>{0, 1, 2, 3, 4}), output);
+  EXPECT_EQ(3u, queue.TryPopBatch(output));
+  EXPECT_EQ(0u, queue.TryPopBatch(output));
+}
+
+TEST(MPMCQueueTest, WrapsAround) {
+  MPMCQueue<int, 2> queue;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(queue.TryPush(i));
+    EXPECT_TRUE(queue.TryPush(i + 1000));
+    EXPECT_FALSE(queue.TryPush(0));
+    EXPECT_EQ(i, queue.TryPop());
+    EXPECT_EQ(i + 1000, queue.TryPop());
+  }
+}
+
+TEST(MPMCQueueTest, MultipleProducersAndConsumers) {
+  TestQueue queue(TestQueue::Mode::kBlocking);
+  std::atomic<int64_t> sum{0};
+  std::vector<std::unique_ptr<SimpleThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(
+        std::make_unique<Producer>(queue, i * kNumElementsPerProducer));
+    threads.push_back(std::make_unique<Consumer>(queue, sum));
+  }
+  for (auto& thread : threads) {
+    thread->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  // Each value was popped exactly once.
+  constexpr int64_t kNumValues = kNumThreads * kNumElementsPerProducer;
+  EXPECT_EQ(kNumValues * (kNumValues - 1) / 2, sum.load());
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace base
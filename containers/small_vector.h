@@ -0,0 +1,202 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_SMALL_VECTOR_H_
+#define BASE_CONTAINERS_SMALL_VECTOR_H_
+
+#include <stddef.h>
+
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/compiler_specific.h"
+#include "base/containers/span.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
+#include "third_party/abseil-cpp/absl/container/inlined_vector.h"
+
+namespace base {
+
+// small_vector<T, N> is a std::vector-like container which stores up to `N`
+// elements inline, in the object itself, and only allocates on the heap when
+// it grows beyond that. Use it for short sequences which are created and
+// destroyed frequently, e.g. in a local variable or a member of a short-lived
+// object, where the typical size is known and small: it saves the allocation,
+// and the pointer chase to the elements.
+//
+// Unlike std::vector, iterators and operator[] are bounds-checked, like those
+// of base::span, and the container converts implicitly to base::span.
+//
+// Moving a small_vector moves its inline elements one by one, and swapping
+// can't be done in constant time, so prefer std::vector when the container is
+// moved around a lot or when `N` elements would make the object too large
+// (e.g. on the stack).
+template <typename T, size_t N>
+class GSL_OWNER small_vector {
+ public:
+  static_assert(N > 0, "Use std::vector without inline storage");
+  static_assert(!std::is_const_v<T>, "small_vector cannot hold const types");
+  static_assert(!std::is_reference_v<T>,
+                "small_vector cannot hold reference types");
+
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = typename span<T>::iterator;
+  using const_iterator = typename span<const T>::iterator;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static constexpr size_t inline_capacity() { return N; }
+
+  small_vector() = default;
+  explicit small_vector(size_t count) : impl_(count) {}
+  small_vector(size_t count, const T& value) : impl_(count, value) {}
+  small_vector(std::initializer_list<T> values) : impl_(values) {}
+  template <std::input_iterator InputIterator>
+  small_vector(InputIterator first, InputIterator last) : impl_(first, last) {}
+
+  small_vector(const small_vector&) = default;
+  small_vector& operator=(const small_vector&) = default;
+  small_vector(small_vector&&) noexcept = default;
+  small_vector& operator=(small_vector&&) noexcept = default;
+  ~small_vector() = default;
+
+  size_t size() const { return impl_.size(); }
+  bool empty() const { return impl_.empty(); }
+  // At least inline_capacity().
+  size_t capacity() const { return impl_.capacity(); }
+
+  // Prefer span-based methods over data() where possible. The data() method
+  // exists primarily to allow implicit constructions of spans.
+  T* data() ABSL_ATTRIBUTE_LIFETIME_BOUND { return impl_.data(); }
+  const T* data() const ABSL_ATTRIBUTE_LIFETIME_BOUND { return impl_.data(); }
+
+  span<T> as_span() ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return span<T>(impl_.data(), impl_.size());
+  }
+  span<const T> as_span() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return span<const T>(impl_.data(), impl_.size());
+  }
+
+  iterator begin() ABSL_ATTRIBUTE_LIFETIME_BOUND { return as_span().begin(); }
+  const_iterator begin() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return as_span().begin();
+  }
+  const_iterator cbegin() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return begin();
+  }
+  iterator end() ABSL_ATTRIBUTE_LIFETIME_BOUND { return as_span().end(); }
+  const_iterator end() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return as_span().end();
+  }
+  const_iterator cend() const ABSL_ATTRIBUTE_LIFETIME_BOUND { return end(); }
+
+  reverse_iterator rbegin() ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return reverse_iterator(end());
+  }
+  const_reverse_iterator rbegin() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return reverse_iterator(begin());
+  }
+  const_reverse_iterator rend() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return const_reverse_iterator(begin());
+  }
+
+  // These CHECK that the index is in bounds, or that the container isn't
+  // empty.
+  T& operator[](size_t index) ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return as_span()[index];
+  }
+  const T& operator[](size_t index) const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return as_span()[index];
+  }
+  T& front() ABSL_ATTRIBUTE_LIFETIME_BOUND { return as_span().front(); }
+  const T& front() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return as_span().front();
+  }
+  T& back() ABSL_ATTRIBUTE_LIFETIME_BOUND { return as_span().back(); }
+  const T& back() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return as_span().back();
+  }
+
+  void reserve(size_t capacity) { impl_.reserve(capacity); }
+  // Moves the elements back inline if they fit.
+  void shrink_to_fit() { impl_.shrink_to_fit(); }
+  // Keeps the heap allocation, if any.
+  void clear() { impl_.clear(); }
+  void resize(size_t size) { impl_.resize(size); }
+  void resize(size_t size, const T& value) { impl_.resize(size, value); }
+
+  void push_back(const T& value) { impl_.push_back(value); }
+  void push_back(T&& value) { impl_.push_back(std::move(value)); }
+  template <typename... Args>
+  T& emplace_back(Args&&... args) ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return impl_.emplace_back(std::forward<Args>(args)...);
+  }
+  void pop_back() {
+    CHECK(!empty());
+    impl_.pop_back();
+  }
+
+  // Inserts before `position`, and returns an iterator to the inserted
+  // element.
+  iterator insert(const_iterator position, const T& value)
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return emplace(position, value);
+  }
+  iterator insert(const_iterator position, T&& value)
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return emplace(position, std::move(value));
+  }
+  template <typename... Args>
+  iterator emplace(const_iterator position, Args&&... args)
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    const size_t index = GetIndex(position);
+    impl_.emplace(impl_.begin() + index, std::forward<Args>(args)...);
+    return begin() + index;
+  }
+
+  // Erases the elements of [first, last), and returns an iterator to the
+  // element which followed them.
+  iterator erase(const_iterator position) ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    CHECK(position != end());
+    return erase(position, position + 1);
+  }
+  iterator erase(const_iterator first, const_iterator last)
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    const size_t first_index = GetIndex(first);
+    const size_t last_index = GetIndex(last);
+    CHECK_LE(first_index, last_index);
+    impl_.erase(impl_.begin() + first_index, impl_.begin() + last_index);
+    return begin() + first_index;
+  }
+
+  void swap(small_vector& other) { impl_.swap(other.impl_); }
+
+  friend bool operator==(const small_vector& lhs,
+                         const small_vector& rhs) = default;
+
+ private:
+  // Returns the index of `position`, which CHECKs that it belongs to this
+  // container.
+  size_t GetIndex(const_iterator position) const {
+    return static_cast<size_t>(position - cbegin());
+  }
+
+  absl::InlinedVector<T, N> impl_;
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_SMALL_VECTOR_H_
@@ -0,0 +1,119 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/small_vector.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "base/containers/span.h"
+#include "base/test/gtest_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Whether the elements of `vector` are stored in the object itself.
+template <typename T, size_t N>
+bool IsInline(const small_vector<T, N>& vector) {
+  const uintptr_t object = reinterpret_cast<uintptr_t>(&vector);
+  const uintptr_t data = reinterpret_cast<uintptr_t>(vector.data());
+  return data >= object && data < object + sizeof(vector);
+}
+
+int Sum(span<const int> values) {
+  int sum = 0;
+  for (int value : values) {
+    sum += value;
+  }
+  return sum;
+}
+
+}  // namespace
+
+TEST(SmallVectorTest, InlineUntilFull) {
+  small_vector<int, 4> vector;
+  EXPECT_TRUE(vector.empty());
+  EXPECT_EQ(4u, vector.capacity());
+  for (int i = 0; i < 4; ++i) {
+    vector.push_back(i);
+  }
+  EXPECT_TRUE(IsInline(vector));
+
+  vector.push_back(4);
+  EXPECT_EQ(5u, vector.size());
+  EXPECT_FALSE(IsInline(vector));
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(i, vector[static_cast<size_t>(i)]);
+  }
+
+  vector.resize(2);
+  vector.shrink_to_fit();
+  EXPECT_TRUE(IsInline(vector));
+  EXPECT_EQ((small_vector<int, 4>{0, 1}), vector);
+}
+
+TEST(SmallVectorTest, ConvertsToSpan) {
+  small_vector<int, 4> vector = {1, 2, 3};
+  EXPECT_EQ(6, Sum(vector));
+  span<int> mutable_span = vector;
+  mutable_span[0] = 10;
+  EXPECT_EQ(10, vector.front());
+  EXPECT_EQ(3u, vector.as_span().size());
+}
+
+TEST(SmallVectorTest, InsertAndErase) {
+  small_vector<std::string, 2> vector = {"a", "c"};
+  auto it = vector.insert(vector.begin() + 1, "b");
+  EXPECT_EQ("b", *it);
+  vector.emplace(vector.end(), "d");
+  EXPECT_TRUE(std::ranges::equal(
+      vector, std::initializer_list<std::string>{"a", "b", "c", "d"}));
+
+  it = vector.erase(vector.begin());
+  EXPECT_EQ("b", *it);
+  it = vector.erase(vector.begin() + 1, vector.end());
+  EXPECT_EQ(vector.end(), it);
+  EXPECT_EQ((small_vector<std::string, 2>{"b"}), vector);
+
+  vector.pop_back();
+  EXPECT_TRUE(vector.empty());
+}
+
+TEST(SmallVectorTest, MoveOnly) {
+  small_vector<std::unique_ptr<int>, 2> vector;
+  vector.push_back(std::make_unique<int>(1));
+  vector.emplace_back(std::make_unique<int>(2));
+  vector.push_back(std::make_unique<int>(3));
+
+  small_vector<std::unique_ptr<int>, 2> moved = std::move(vector);
+  ASSERT_EQ(3u, moved.size());
+  EXPECT_EQ(3, *moved.back());
+}
+
+TEST(SmallVectorTest, ReverseIteration) {
+  small_vector<int, 4> vector = {1, 2, 3};
+  EXPECT_TRUE(std::ranges::equal(
+      std::ranges::subrange(vector.rbegin(), vector.rend()),
+      std::initializer_list<int>{3, 2, 1}));
+}
+
+TEST(SmallVectorDeathTest, OutOfBounds) {
+  small_vector<int, 4> vector = {1, 2};
+  EXPECT_CHECK_DEATH(vector[2]);
+  EXPECT_CHECK_DEATH(*vector.end());
+
+  small_vector<int, 4> other = {1, 2};
+  EXPECT_CHECK_DEATH(vector.erase(other.begin()));
+
+  vector.clear();
+  EXPECT_CHECK_DEATH(vector.front());
+  EXPECT_CHECK_DEATH(vector.pop_back());
+}
+
+}  // namespace base
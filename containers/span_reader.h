@@ -5,7 +5,12 @@
 #ifndef BASE_CONTAINERS_SPAN_READER_H_
 #define BASE_CONTAINERS_SPAN_READER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
 #include <concepts>
+#include <limits>
 #include <optional>
 
 #include "base/containers/span.h"
@@ -246,6 +251,93 @@ class SpanReader {
     return ReadAnd<8>([&](auto buf) { value = I64FromNativeEndian(buf); });
   }
 
+  // For a SpanReader over bytes, reads `values.size()` integers at once into
+  // `values`. Returns true if there was room remaining and the bytes were read.
+  // Otherwise, it returns false and does nothing.
+  //
+  // These treat the bytes from the buffer as being in big endian order. The
+  // bytes are swapped in a plain loop over `values`, which compilers vectorize,
+  // so this is much faster than reading the integers one at a time.
+  template <class Int, size_t N>
+    requires(std::integral<Int> &&
+             std::same_as<std::remove_const_t<T>, uint8_t>)
+  bool ReadBigEndian(span<Int, N> values) {
+    if (!ReadLittleEndian(values)) {
+      return false;
+    }
+    if constexpr (sizeof(Int) > 1) {
+      for (Int& value : values) {
+        value = ByteSwap(value);
+      }
+    }
+    return true;
+  }
+
+  // As above, but treats the bytes from the buffer as being in little endian
+  // order.
+  template <class Int, size_t N>
+    requires(std::integral<Int> &&
+             std::same_as<std::remove_const_t<T>, uint8_t>)
+  bool ReadLittleEndian(span<Int, N> values) {
+    // Chromium only runs on little endian machines, see byte_conversions.h.
+    return ReadCopy(as_writable_bytes(values));
+  }
+
+  // For a SpanReader over bytes, reads an unsigned integer encoded as a
+  // LEB128 varint: 7 bits per byte, least significant first, with the high bit
+  // of each byte set if more bytes follow. Returns true if a complete varint
+  // was read and its value fits in `value`. Otherwise, it returns false and
+  // does nothing.
+  template <class UInt>
+    requires(std::unsigned_integral<UInt> &&
+             std::same_as<std::remove_const_t<T>, uint8_t>)
+  bool ReadVarint(UInt& value) {
+    constexpr size_t kBits = std::numeric_limits<UInt>::digits;
+    constexpr size_t kMaxSize = (kBits + 6) / 7;
+
+    // Small values, which are the most common, take a single byte.
+    if (!buf_.empty() && buf_[0u] < 0x80) {
+      value = buf_[0u];
+      buf_ = buf_.subspan(1u);
+      return true;
+    }
+
+    const size_t size = std::min(kMaxSize, remaining());
+    UInt result = 0;
+    for (size_t i = 0; i < size; ++i) {
+      const uint8_t byte = buf_[i];
+      // The last byte can only hold the high bits of `value`, and can't be
+      // followed by more bytes.
+      if (i == kMaxSize - 1 && (byte >> (kBits - 7 * i)) != 0) {
+        return false;
+      }
+      result |= static_cast<UInt>(static_cast<UInt>(byte & 0x7f) << (7 * i));
+      if (byte < 0x80) {
+        value = result;
+        buf_ = buf_.subspan(i + 1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // For a SpanReader over bytes, reads a signed integer encoded as the varint
+  // of its ZigZagEncode() (see byte_conversions.h), as written by
+  // SpanWriter::WriteZigZagVarint(). Returns true if a complete varint was read
+  // and its value fits in `value`. Otherwise, it returns false and does
+  // nothing.
+  template <class Int>
+    requires(std::signed_integral<Int> &&
+             std::same_as<std::remove_const_t<T>, uint8_t>)
+  bool ReadZigZagVarint(Int& value) {
+    std::make_unsigned_t<Int> encoded;
+    if (!ReadVarint(encoded)) {
+      return false;
+    }
+    value = ZigZagDecode(encoded);
+    return true;
+  }
+
   // For a SpanReader over bytes, reads one byte and returns it as a `char`,
   // which may be signed or unsigned depending on the platform. Returns true if
   // there was room remaining and the byte was read.
@@ -428,5 +428,123 @@ TEST(SpanReaderTest, ReadChar) {
   EXPECT_EQ(c, char{5});
 }
 
+TEST(SpanReaderTest, ReadIntegerSpans) {
+  std::array<const uint8_t, 9u> kArray = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+  {
+    auto r = SpanReader(base::span(kArray));
+    std::array<uint16_t, 4u> values;
+    EXPECT_TRUE(r.ReadBigEndian(base::span(values)));
+    EXPECT_EQ(values, (std::array<uint16_t, 4u>{0x0102, 0x0304, 0x0506,
+                                                0x0708}));
+    EXPECT_EQ(r.remaining(), 1u);
+    // Nothing is read if there isn't enough room.
+    EXPECT_FALSE(r.ReadBigEndian(base::span(values)));
+    EXPECT_EQ(r.remaining(), 1u);
+  }
+  {
+    auto r = SpanReader(base::span(kArray));
+    EXPECT_TRUE(r.Skip(1u));
+    std::array<uint32_t, 2u> values;
+    EXPECT_TRUE(r.ReadLittleEndian(base::span(values)));
+    EXPECT_EQ(values, (std::array<uint32_t, 2u>{0x05040302, 0x09080706}));
+    EXPECT_EQ(r.remaining(), 0u);
+  }
+  {
+    auto r = SpanReader(base::span(kArray));
+    std::array<int64_t, 1u> values;
+    EXPECT_TRUE(r.ReadBigEndian(base::span(values)));
+    EXPECT_EQ(values[0u], 0x0102030405060708);
+  }
+}
+
+TEST(SpanReaderTest, ReadVarint) {
+  {
+    std::array<const uint8_t, 6u> kArray = {0x00, 0x7f, 0x80, 0x01,
+                                            0xac, 0x02};
+    auto r = SpanReader(base::span(kArray));
+    uint32_t value;
+    EXPECT_TRUE(r.ReadVarint(value));
+    EXPECT_EQ(value, 0u);
+    EXPECT_TRUE(r.ReadVarint(value));
+    EXPECT_EQ(value, 127u);
+    EXPECT_TRUE(r.ReadVarint(value));
+    EXPECT_EQ(value, 128u);
+    EXPECT_TRUE(r.ReadVarint(value));
+    EXPECT_EQ(value, 300u);
+    EXPECT_EQ(r.remaining(), 0u);
+    EXPECT_FALSE(r.ReadVarint(value));
+    EXPECT_EQ(value, 300u);
+  }
+  {
+    // The largest uint64_t takes 10 bytes.
+    std::array<const uint8_t, 10u> kArray = {0xff, 0xff, 0xff, 0xff, 0xff,
+                                             0xff, 0xff, 0xff, 0xff, 0x01};
+    auto r = SpanReader(base::span(kArray));
+    uint64_t value;
+    EXPECT_TRUE(r.ReadVarint(value));
+    EXPECT_EQ(value, std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(r.remaining(), 0u);
+  }
+  {
+    // Too large for a uint64_t.
+    std::array<const uint8_t, 10u> kArray = {0xff, 0xff, 0xff, 0xff, 0xff,
+                                             0xff, 0xff, 0xff, 0xff, 0x02};
+    auto r = SpanReader(base::span(kArray));
+    uint64_t value = 1u;
+    EXPECT_FALSE(r.ReadVarint(value));
+    EXPECT_EQ(value, 1u);
+    EXPECT_EQ(r.remaining(), 10u);
+  }
+  {
+    // Too large for a uint32_t, but not for a uint64_t.
+    std::array<const uint8_t, 5u> kArray = {0xff, 0xff, 0xff, 0xff, 0x1f};
+    auto r = SpanReader(base::span(kArray));
+    uint32_t value32;
+    EXPECT_FALSE(r.ReadVarint(value32));
+    EXPECT_EQ(r.remaining(), 5u);
+    uint64_t value64;
+    EXPECT_TRUE(r.ReadVarint(value64));
+    EXPECT_EQ(value64, 0x1ffffffffu);
+  }
+  {
+    // More bytes than a uint8_t can take.
+    std::array<const uint8_t, 3u> kArray = {0xff, 0x01, 0x80};
+    auto r = SpanReader(base::span(kArray));
+    uint8_t value;
+    EXPECT_TRUE(r.ReadVarint(value));
+    EXPECT_EQ(value, 255u);
+    // Truncated.
+    EXPECT_FALSE(r.ReadVarint(value));
+    EXPECT_EQ(r.remaining(), 1u);
+  }
+}
+
+TEST(SpanReaderTest, ReadZigZagVarint) {
+  std::array<const uint8_t, 13u> kArray = {0x00, 0x01, 0x02, 0x7f,
+                                           0x80, 0x01, 0xff, 0xff,
+                                           0xff, 0xff, 0x0f, 0x03,
+                                           0x80};
+  auto r = SpanReader(base::span(kArray));
+  int32_t value;
+  EXPECT_TRUE(r.ReadZigZagVarint(value));
+  EXPECT_EQ(value, 0);
+  EXPECT_TRUE(r.ReadZigZagVarint(value));
+  EXPECT_EQ(value, -1);
+  EXPECT_TRUE(r.ReadZigZagVarint(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(r.ReadZigZagVarint(value));
+  EXPECT_EQ(value, -64);
+  EXPECT_TRUE(r.ReadZigZagVarint(value));
+  EXPECT_EQ(value, 64);
+  EXPECT_TRUE(r.ReadZigZagVarint(value));
+  EXPECT_EQ(value, std::numeric_limits<int32_t>::min());
+  int8_t value8;
+  EXPECT_TRUE(r.ReadZigZagVarint(value8));
+  EXPECT_EQ(value8, -2);
+  EXPECT_FALSE(r.ReadZigZagVarint(value8));
+  EXPECT_EQ(value8, -2);
+}
+
 }  // namespace
 }  // namespace base
@@ -5,6 +5,13 @@
 #ifndef BASE_CONTAINERS_SPAN_WRITER_H_
 #define BASE_CONTAINERS_SPAN_WRITER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <limits>
 #include <optional>
 
 #include "base/containers/span.h"
@@ -227,6 +234,81 @@ class SpanWriter {
     return Write(I64ToNativeEndian(value));
   }
 
+  // For a SpanWriter over bytes, writes all of `values` at once. Returns true
+  // if there was room remaining and the bytes were written. Otherwise, it
+  // returns false and does nothing.
+  //
+  // These write the integers in big endian order. The bytes are swapped in
+  // blocks on the stack in a plain loop, which compilers vectorize, so this is
+  // much faster than writing the integers one at a time.
+  template <class Int, size_t N>
+    requires(std::integral<Int> && std::same_as<T, uint8_t>)
+  bool WriteBigEndian(span<Int, N> values) {
+    if constexpr (sizeof(Int) == 1) {
+      return WriteLittleEndian(values);
+    } else {
+      std::optional<span<uint8_t>> out = Skip(values.size_bytes());
+      if (!out.has_value()) {
+        return false;
+      }
+      constexpr size_t kBlockSize = 64;
+      std::array<std::remove_const_t<Int>, kBlockSize> block;
+      span<Int> rest = values;
+      while (!rest.empty()) {
+        const size_t n = std::min(rest.size(), kBlockSize);
+        auto [head, tail] = rest.split_at(n);
+        for (size_t i = 0; i < n; ++i) {
+          block[i] = ByteSwap(head[i]);
+        }
+        auto [out_head, out_tail] = out->split_at(n * sizeof(Int));
+        out_head.copy_from(as_bytes(span(block).first(n)));
+        rest = tail;
+        out = out_tail;
+      }
+      return true;
+    }
+  }
+
+  // As above, but writes the integers in little endian order.
+  template <class Int, size_t N>
+    requires(std::integral<Int> && std::same_as<T, uint8_t>)
+  bool WriteLittleEndian(span<Int, N> values) {
+    // Chromium only runs on little endian machines, see byte_conversions.h.
+    return Write(as_bytes(values));
+  }
+
+  // For a SpanWriter over bytes, writes `value` as a LEB128 varint: 7 bits per
+  // byte, least significant first, with the high bit of each byte set if more
+  // bytes follow. Values below 128 take one byte, and a uint64_t takes at most
+  // 10 bytes. Returns true if there was room remaining and the bytes were
+  // written. Otherwise, it returns false and does nothing.
+  template <class UInt>
+    requires(std::unsigned_integral<UInt> && std::same_as<T, uint8_t>)
+  bool WriteVarint(UInt value) {
+    // Small values, which are the most common, take a single byte.
+    if (value < 0x80) {
+      return WriteU8LittleEndian(static_cast<uint8_t>(value));
+    }
+    std::array<uint8_t, (std::numeric_limits<UInt>::digits + 6) / 7> bytes;
+    size_t size = 0;
+    while (value >= 0x80) {
+      bytes[size++] = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    bytes[size++] = static_cast<uint8_t>(value);
+    return Write(span(bytes).first(size));
+  }
+
+  // For a SpanWriter over bytes, writes `value` as the varint of its
+  // ZigZagEncode() (see byte_conversions.h), so that negative values of small
+  // magnitude take few bytes. Returns true if there was room remaining and the
+  // bytes were written. Otherwise, it returns false and does nothing.
+  template <class Int>
+    requires(std::signed_integral<Int> && std::same_as<T, uint8_t>)
+  bool WriteZigZagVarint(Int value) {
+    return WriteVarint(ZigZagEncode(value));
+  }
+
   // Returns the number of objects remaining to be written to the original span.
   size_t remaining() const { return buf_.size(); }
   // Returns the objects that have not yet been written to, as a span.
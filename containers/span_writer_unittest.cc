@@ -4,6 +4,10 @@
 
 #include "base/containers/span_writer.h"
 
+#include <limits>
+
+#include "base/containers/span_reader.h"
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -377,5 +381,120 @@ TEST(SpanWriterTest, Chars) {
   EXPECT_EQ(kArray, base::span({'a', 'f', 'g', 'd', 'e'}));
 }
 
+TEST(SpanWriterTest, WriteIntegerSpans) {
+  {
+    std::array<uint8_t, 9u> kArray = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+    auto r = SpanWriter(base::span(kArray));
+    const std::array<uint16_t, 4u> kValues = {0x0102, 0x0304, 0x0506, 0x0708};
+    EXPECT_TRUE(r.WriteBigEndian(base::span(kValues)));
+    EXPECT_EQ(r.remaining(), 1u);
+    EXPECT_EQ(kArray, base::span({uint8_t{1}, uint8_t{2}, uint8_t{3},
+                                  uint8_t{4}, uint8_t{5}, uint8_t{6},
+                                  uint8_t{7}, uint8_t{8}, uint8_t{1}}));
+    // Nothing is written if there isn't enough room.
+    EXPECT_FALSE(r.WriteBigEndian(base::span(kValues)));
+    EXPECT_EQ(r.remaining(), 1u);
+  }
+  {
+    std::array<uint8_t, 9u> kArray = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+    auto r = SpanWriter(base::span(kArray));
+    EXPECT_TRUE(r.Skip(1u));
+    std::array<uint32_t, 2u> values = {0x05040302, 0x09080706};
+    EXPECT_TRUE(r.WriteLittleEndian(base::span(values)));
+    EXPECT_EQ(r.remaining(), 0u);
+    EXPECT_EQ(kArray, base::span({uint8_t{1}, uint8_t{2}, uint8_t{3},
+                                  uint8_t{4}, uint8_t{5}, uint8_t{6},
+                                  uint8_t{7}, uint8_t{8}, uint8_t{9}}));
+  }
+  {
+    // More values than are swapped at once.
+    std::array<uint32_t, 150u> values;
+    for (size_t i = 0u; i < values.size(); ++i) {
+      values[i] = static_cast<uint32_t>(i * 0x01020304u);
+    }
+    std::array<uint8_t, 600u> bytes;
+    auto w = SpanWriter(base::span(bytes));
+    EXPECT_TRUE(w.WriteBigEndian(base::span(values)));
+    EXPECT_EQ(w.remaining(), 0u);
+
+    auto r = SpanReader(base::span<const uint8_t>(bytes));
+    for (uint32_t value : values) {
+      uint32_t read;
+      EXPECT_TRUE(r.ReadU32BigEndian(read));
+      EXPECT_EQ(read, value);
+    }
+  }
+}
+
+TEST(SpanWriterTest, WriteVarint) {
+  std::array<uint8_t, 16u> kArray = {};
+  {
+    auto r = SpanWriter(base::span(kArray));
+    EXPECT_TRUE(r.WriteVarint(uint32_t{0}));
+    EXPECT_TRUE(r.WriteVarint(uint32_t{127}));
+    EXPECT_TRUE(r.WriteVarint(uint32_t{128}));
+    EXPECT_TRUE(r.WriteVarint(uint16_t{300}));
+    EXPECT_EQ(r.num_written(), 6u);
+    EXPECT_EQ(base::span(kArray).first(6u),
+              base::span({uint8_t{0x00}, uint8_t{0x7f}, uint8_t{0x80},
+                          uint8_t{0x01}, uint8_t{0xac}, uint8_t{0x02}}));
+  }
+  {
+    auto r = SpanWriter(base::span(kArray));
+    EXPECT_TRUE(r.WriteVarint(std::numeric_limits<uint64_t>::max()));
+    EXPECT_EQ(r.num_written(), 10u);
+    EXPECT_EQ(base::span(kArray).first(10u),
+              base::span({uint8_t{0xff}, uint8_t{0xff}, uint8_t{0xff},
+                          uint8_t{0xff}, uint8_t{0xff}, uint8_t{0xff},
+                          uint8_t{0xff}, uint8_t{0xff}, uint8_t{0xff},
+                          uint8_t{0x01}}));
+    // Nothing is written if there isn't enough room.
+    EXPECT_FALSE(r.WriteVarint(std::numeric_limits<uint64_t>::max()));
+    EXPECT_EQ(r.num_written(), 10u);
+  }
+  {
+    auto r = SpanWriter(base::span(kArray));
+    EXPECT_TRUE(r.WriteZigZagVarint(int32_t{-1}));
+    EXPECT_TRUE(r.WriteZigZagVarint(int32_t{1}));
+    EXPECT_TRUE(r.WriteZigZagVarint(int32_t{-64}));
+    EXPECT_TRUE(r.WriteZigZagVarint(int8_t{64}));
+    EXPECT_EQ(r.num_written(), 5u);
+    EXPECT_EQ(base::span(kArray).first(5u),
+              base::span({uint8_t{0x01}, uint8_t{0x02}, uint8_t{0x7f},
+                          uint8_t{0x80}, uint8_t{0x01}}));
+  }
+}
+
+TEST(SpanWriterTest, VarintRoundTrip) {
+  const uint64_t kValues[] = {0u,
+                              1u,
+                              0x7fu,
+                              0x80u,
+                              0x3fffu,
+                              0x4000u,
+                              0xffffffffu,
+                              0x100000000u,
+                              std::numeric_limits<uint64_t>::max() - 1u,
+                              std::numeric_limits<uint64_t>::max()};
+  std::array<uint8_t, 200u> bytes;
+  auto w = SpanWriter(base::span(bytes));
+  for (uint64_t value : kValues) {
+    EXPECT_TRUE(w.WriteVarint(value));
+    EXPECT_TRUE(w.WriteZigZagVarint(static_cast<int64_t>(value)));
+  }
+
+  auto r = SpanReader(
+      base::span<const uint8_t>(bytes).first(w.num_written()));
+  for (uint64_t value : kValues) {
+    uint64_t read;
+    EXPECT_TRUE(r.ReadVarint(read));
+    EXPECT_EQ(read, value);
+    int64_t signed_read;
+    EXPECT_TRUE(r.ReadZigZagVarint(signed_read));
+    EXPECT_EQ(signed_read, static_cast<int64_t>(value));
+  }
+  EXPECT_EQ(r.remaining(), 0u);
+}
+
 }  // namespace
 }  // namespace base
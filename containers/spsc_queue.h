@@ -0,0 +1,224 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_SPSC_QUEUE_H_
+#define BASE_CONTAINERS_SPSC_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <optional>
+#include <utility>
+
+#include "base/check.h"
+#include "base/containers/span.h"
+#include "base/synchronization/atomic_waiter.h"
+
+namespace base {
+
+// A bounded, lock-free, single-producer single-consumer FIFO queue of up to
+// `kCapacity` elements, which must be a power of two. Exactly one thread may
+// push at a time and exactly one thread may pop at a time; for more, see
+// base::MPMCQueue in mpmc_queue.h.
+//
+// Unlike base::RingBuffer, the queue never overwrites elements: pushing to a
+// full queue fails (TryPush()) or waits (Push()). The producer and consumer
+// indices are on separate cache lines, and each side caches the other side's
+// index, so that a push or a pop usually touches no cache line written by the
+// other thread except the element's. TryPushBatch() and TryPopBatch() publish
+// a whole batch with a single atomic store.
+//
+// With Mode::kBlocking, Push() and Pop() block the thread with AtomicWaiter
+// while the queue is full or empty. That mode costs a memory fence per
+// operation, so use kNonBlocking if the threads only poll.
+template <typename T, size_t kCapacity>
+class SPSCQueue {
+ public:
+  static_assert(kCapacity > 0 && (kCapacity & (kCapacity - 1)) == 0,
+                "kCapacity must be a power of two");
+  static_assert(kCapacity <= (size_t{1} << 31), "kCapacity is too large");
+
+  enum class Mode {
+    kNonBlocking,
+    kBlocking,
+  };
+
+  explicit SPSCQueue(Mode mode = Mode::kNonBlocking) : mode_(mode) {}
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+  ~SPSCQueue() = default;
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+  // Producer methods.
+
+  // Pushes `value` if the queue isn't full. Returns false, without moving
+  // from `value`, if it is.
+  bool TryPush(const T& value) { return TryPushImpl(value); }
+  bool TryPush(T&& value) { return TryPushImpl(std::move(value)); }
+
+  // Moves as many of the first elements of `values` as fit into the queue.
+  // Returns how many were moved.
+  size_t TryPushBatch(span<T> values) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (kCapacity - (tail - cached_head_) < values.size()) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    const size_t count =
+        std::min(values.size(), kCapacity - (tail - cached_head_));
+    for (size_t i = 0; i < count; ++i) {
+      slots_[(tail + i) & kMask].emplace(std::move(values[i]));
+    }
+    if (count > 0) {
+      tail_.store(tail + static_cast<uint32_t>(count),
+                  std::memory_order_release);
+      NotifyWaiter(consumer_waiting_, tail_);
+    }
+    return count;
+  }
+
+  // Pushes `value`, waiting for space if the queue is full. Requires
+  // Mode::kBlocking.
+  void Push(T value) {
+    DCHECK(mode_ == Mode::kBlocking);
+    while (!TryPush(std::move(value))) {
+      const uint32_t head = head_.load(std::memory_order_acquire);
+      if (tail_.load(std::memory_order_relaxed) - head == kCapacity) {
+        Wait(producer_waiting_, head_, head);
+      }
+    }
+  }
+
+  // Consumer methods.
+
+  // Pops the oldest element, or returns nullopt if the queue is empty.
+  std::optional<T> TryPop() {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) {
+        return std::nullopt;
+      }
+    }
+    std::optional<T>& slot = slots_[head & kMask];
+    std::optional<T> value = std::move(slot);
+    slot.reset();
+    head_.store(head + 1, std::memory_order_release);
+    NotifyWaiter(producer_waiting_, head_);
+    return value;
+  }
+
+  // Moves up to `values.size()` of the oldest elements into `values`. Returns
+  // how many were moved.
+  size_t TryPopBatch(span<T> values) {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    if (cached_tail_ - head < values.size()) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    const size_t count = std::min<size_t>(values.size(), cached_tail_ - head);
+    for (size_t i = 0; i < count; ++i) {
+      std::optional<T>& slot = slots_[(head + i) & kMask];
+      values[i] = std::move(*slot);
+      slot.reset();
+    }
+    if (count > 0) {
+      head_.store(head + static_cast<uint32_t>(count),
+                  std::memory_order_release);
+      NotifyWaiter(producer_waiting_, head_);
+    }
+    return count;
+  }
+
+  // Pops the oldest element, waiting for one if the queue is empty. Requires
+  // Mode::kBlocking.
+  T Pop() {
+    DCHECK(mode_ == Mode::kBlocking);
+    while (true) {
+      std::optional<T> value = TryPop();
+      if (value) {
+        return std::move(*value);
+      }
+      const uint32_t tail = tail_.load(std::memory_order_acquire);
+      if (tail == head_.load(std::memory_order_relaxed)) {
+        Wait(consumer_waiting_, tail_, tail);
+      }
+    }
+  }
+
+  // Returns the number of elements. Only exact when called from the producer
+  // or the consumer while the other side is idle.
+  size_t size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+
+ private:
+  static constexpr uint32_t kMask = kCapacity - 1;
+
+  template <typename U>
+  bool TryPushImpl(U&& value) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == kCapacity) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ == kCapacity) {
+        return false;
+      }
+    }
+    slots_[tail & kMask].emplace(std::forward<U>(value));
+    tail_.store(tail + 1, std::memory_order_release);
+    NotifyWaiter(consumer_waiting_, tail_);
+    return true;
+  }
+
+  // Waits for `index` to change from `value`. The fences of Wait() and
+  // NotifyWaiter() ensure that either the waiter sees the new index, or the
+  // notifier sees `waiting`.
+  static void Wait(std::atomic<bool>& waiting,
+                   const std::atomic<uint32_t>& index,
+                   uint32_t value) {
+    waiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (index.load(std::memory_order_relaxed) == value) {
+      AtomicWaiter::Wait(index, value);
+    }
+    waiting.store(false, std::memory_order_relaxed);
+  }
+
+  // Wakes up the other side if it waits for `index` to change.
+  void NotifyWaiter(const std::atomic<bool>& waiting,
+                    std::atomic<uint32_t>& index) {
+    if (mode_ != Mode::kBlocking) {
+      return;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed)) {
+      AtomicWaiter::NotifyOne(index);
+    }
+  }
+
+  const Mode mode_;
+
+  // Written by the consumer.
+  alignas(64) std::atomic<uint32_t> head_{0};
+  std::atomic<bool> consumer_waiting_{false};
+  // The consumer's copy of `tail_`, to avoid reading it on each pop.
+  uint32_t cached_tail_ = 0;
+
+  // Written by the producer.
+  alignas(64) std::atomic<uint32_t> tail_{0};
+  std::atomic<bool> producer_waiting_{false};
+  // The producer's copy of `head_`, to avoid reading it on each push.
+  uint32_t cached_head_ = 0;
+
+  alignas(64) std::array<std::optional<T>, kCapacity> slots_;
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_SPSC_QUEUE_H_
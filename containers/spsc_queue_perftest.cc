@@ -0,0 +1,175 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/spsc_queue.h"
+
+#include <stdint.h>
+
+#include <array>
+#include <string>
+#include <utility>
+
+#include "base/containers/circular_deque.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixSPSCQueue[] = "SPSCQueue.";
+constexpr char kMetricThroughput[] = "throughput";
+constexpr char kStoryBlocking[] = "blocking";
+constexpr char kStoryBatch[] = "batch_of_16";
+constexpr char kStoryLockedDeque[] = "locked_circular_deque_baseline";
+
+constexpr size_t kCapacity = 1024;
+constexpr uint64_t kNumElements = 1000000;
+
+using Queue = SPSCQueue<uint64_t, kCapacity>;
+
+// What cross-thread handoffs use today: a bounded circular_deque behind a
+// Lock, with a ConditionVariable per direction.
+class LockedQueue {
+ public:
+  void Push(uint64_t value) {
+    AutoLock lock(lock_);
+    while (deque_.size() == kCapacity) {
+      not_full_.Wait();
+    }
+    deque_.push_back(value);
+    not_empty_.Signal();
+  }
+
+  uint64_t Pop() {
+    AutoLock lock(lock_);
+    while (deque_.empty()) {
+      not_empty_.Wait();
+    }
+    const uint64_t value = deque_.front();
+    deque_.pop_front();
+    not_full_.Signal();
+    return value;
+  }
+
+ private:
+  Lock lock_;
+  ConditionVariable not_empty_{&lock_};
+  ConditionVariable not_full_{&lock_};
+  circular_deque<uint64_t> deque_ GUARDED_BY(lock_);
+};
+
+template <typename PushFunction>
+class Producer : public SimpleThread {
+ public:
+  explicit Producer(PushFunction push)
+      : SimpleThread("SPSCQueuePerfTest"), push_(std::move(push)) {}
+
+  void Run() override { push_(); }
+
+ private:
+  PushFunction push_;
+};
+
+// Runs `push` on another thread and `pop` on this one, and reports the
+// throughput of the whole transfer.
+template <typename PushFunction, typename PopFunction>
+void RunTest(const std::string& story,
+             PushFunction push,
+             PopFunction pop) {
+  Producer<PushFunction> producer(std::move(push));
+  ElapsedTimer timer;
+  producer.Start();
+  EXPECT_EQ(kNumElements * (kNumElements - 1) / 2, pop());
+  producer.Join();
+  const TimeDelta elapsed = timer.Elapsed();
+
+  perf_test::PerfResultReporter reporter(kMetricPrefixSPSCQueue, story);
+  reporter.RegisterImportantMetric(kMetricThroughput, "elements/s");
+  reporter.AddResult(kMetricThroughput, kNumElements / elapsed.InSecondsF());
+}
+
+}  // namespace
+
+TEST(SPSCQueuePerfTest, Blocking) {
+  Queue queue(Queue::Mode::kBlocking);
+  RunTest(
+      kStoryBlocking,
+      [&] {
+        for (uint64_t i = 0; i < kNumElements; ++i) {
+          queue.Push(i);
+        }
+      },
+      [&] {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < kNumElements; ++i) {
+          sum += queue.Pop();
+        }
+        return sum;
+      });
+}
+
+TEST(SPSCQueuePerfTest, Batch) {
+  constexpr size_t kBatchSize = 16;
+  Queue queue;
+  RunTest(
+      kStoryBatch,
+      [&] {
+        std::array<uint64_t, kBatchSize> batch;
+        for (uint64_t i = 0; i < kNumElements; i += kBatchSize) {
+          for (size_t j = 0; j < kBatchSize; ++j) {
+            batch[j] = i + j;
+          }
+          span<uint64_t> remaining(batch);
+          while (!remaining.empty()) {
+            remaining = remaining.subspan(queue.TryPushBatch(remaining));
+            if (!remaining.empty()) {
+              PlatformThread::YieldCurrentThread();
+            }
+          }
+        }
+      },
+      [&] {
+        std::array<uint64_t, kBatchSize> batch;
+        uint64_t sum = 0;
+        for (uint64_t popped = 0; popped < kNumElements;) {
+          const size_t count = queue.TryPopBatch(batch);
+          if (count == 0) {
+            PlatformThread::YieldCurrentThread();
+          }
+          for (size_t j = 0; j < count; ++j) {
+            sum += batch[j];
+          }
+          popped += count;
+        }
+        return sum;
+      });
+}
+
+TEST(SPSCQueuePerfTest, LockedDequeBaseline) {
+  LockedQueue queue;
+  RunTest(
+      kStoryLockedDeque,
+      [&] {
+        for (uint64_t i = 0; i < kNumElements; ++i) {
+          queue.Push(i);
+        }
+      },
+      [&] {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < kNumElements; ++i) {
+          sum += queue.Pop();
+        }
+        return sum;
+      });
+}
+
+}  // namespace base
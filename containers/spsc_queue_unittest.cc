@@ -0,0 +1,126 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/spsc_queue.h"
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "base/memory/raw_ref.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+constexpr int kNumElements = 100000;
+
+// Pushes `kNumElements` increasing integers.
+template <typename QueueType>
+class Producer : public SimpleThread {
+ public:
+  Producer(QueueType& queue, bool blocking)
+      : SimpleThread("SPSCQueueTest"), queue_(queue), blocking_(blocking) {}
+
+  void Run() override {
+    for (int i = 0; i < kNumElements; ++i) {
+      if (blocking_) {
+        queue_->Push(i);
+      } else {
+        while (!queue_->TryPush(i)) {
+          PlatformThread::YieldCurrentThread();
+        }
+      }
+    }
+  }
+
+ private:
+  const raw_ref<QueueType> queue_;
+  const bool blocking_;
+};
+
+}  // namespace
+
+TEST(SPSCQueueTest, PushPop) {
+  SPSCQueue<std::unique_ptr<int>, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(std::nullopt, queue.TryPop());
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.TryPush(std::make_unique<int>(i)));
+  }
+  EXPECT_EQ(4u, queue.size());
+  // A failed push doesn't consume the value.
+  auto value = std::make_unique<int>(4);
+  EXPECT_FALSE(queue.TryPush(std::move(value)));
+  ASSERT_TRUE(value);
+
+  for (int i = 0; i < 4; ++i) {
+    std::optional<std::unique_ptr<int>> popped = queue.TryPop();
+    ASSERT_TRUE(popped);
+    EXPECT_EQ(i, **popped);
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQueueTest, Batches) {
+  SPSCQueue<int, 8> queue;
+  std::array<int, 6> input = {0, 1, 2, 3, 4, 5};
+  EXPECT_EQ(6u, queue.TryPushBatch(input));
+  // Only 2 more fit.
+  EXPECT_EQ(2u, queue.TryPushBatch(input));
+
+  std::array<int, 5> output = {};
+  EXPECT_EQ(5u, queue.TryPopBatch(output));
+  EXPECT_EQ((std::array<int, 5>{0, 1, 2, 3, 4}), output);
+  EXPECT_EQ(3u, queue.TryPopBatch(output));
+  EXPECT_EQ(5, output[0]);
+  EXPECT_EQ(0, output[1]);
+  EXPECT_EQ(1, output[2]);
+  EXPECT_EQ(0u, queue.TryPopBatch(output));
+}
+
+TEST(SPSCQueueTest, WrapsAround) {
+  SPSCQueue<int, 4> queue;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(queue.TryPush(i));
+    EXPECT_TRUE(queue.TryPush(i + 1000));
+    EXPECT_EQ(i, queue.TryPop());
+    EXPECT_EQ(i + 1000, queue.TryPop());
+  }
+}
+
+TEST(SPSCQueueTest, TwoThreads) {
+  using QueueType = SPSCQueue<int, 64>;
+  QueueType queue;
+  Producer<QueueType> producer(queue, /*blocking=*/false);
+  producer.Start();
+  for (int i = 0; i < kNumElements; ++i) {
+    std::optional<int> value;
+    while (!(value = queue.TryPop())) {
+      PlatformThread::YieldCurrentThread();
+    }
+    ASSERT_EQ(i, *value);
+  }
+  producer.Join();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQueueTest, Blocking) {
+  using QueueType = SPSCQueue<int, 16>;
+  QueueType queue(QueueType::Mode::kBlocking);
+  Producer<QueueType> producer(queue, /*blocking=*/true);
+  producer.Start();
+  for (int i = 0; i < kNumElements; ++i) {
+    ASSERT_EQ(i, queue.Pop());
+  }
+  producer.Join();
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace base
@@ -0,0 +1,188 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_STATIC_SEARCH_SET_H_
+#define BASE_CONTAINERS_STATIC_SEARCH_SET_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/compiler_specific.h"
+#include "base/containers/fixed_flat_set.h"
+#include "base/containers/flat_set.h"
+#include "base/containers/flat_tree.h"
+#include "base/containers/span.h"
+
+namespace base {
+
+// static_search_set is an immutable set, built once from sorted keys, which
+// is faster to search than a flat_set once it no longer fits in the CPU
+// caches, i.e. from tens of thousands of keys.
+//
+// A binary search over a sorted array touches a different cache line at
+// almost every step, and the lines of the next steps can't be fetched before
+// the comparison is done. static_search_set instead stores the keys in
+// Eytzinger order, i.e. in breadth-first order of the implicit binary search
+// tree: the children of the key at (1-based) position k are at 2k and 2k + 1.
+// The first levels of the tree are then packed at the start of the array and
+// stay in the cache, the search is branchless, and since the descendants of a
+// key several levels down are contiguous, they are prefetched while the
+// comparisons of the levels in between are done.
+//
+// Iteration is in layout order, NOT in sorted order. Use flat_set when the
+// set is small, or when sorted iteration or range queries are needed.
+//
+// Keys must be default-constructible and copy-assignable.
+//
+// Example usage:
+//   base::flat_set<uint64_t> ids = ...;
+//   const base::static_search_set<uint64_t> kIds(ids);
+//   if (kIds.contains(id)) { ... }
+//
+//   // Built at compile time from a fixed_flat_set.
+//   constexpr auto kNames = base::MakeStaticSearchSet(
+//       base::MakeFixedFlatSet<std::string_view>({"foo", "bar", "baz"}));
+template <class Key,
+          class Compare = std::less<>,
+          class Container = std::vector<Key>>
+class static_search_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using key_compare = Compare;
+  using size_type = size_t;
+  using const_iterator = typename Container::const_iterator;
+  using container_type = Container;
+
+  // Builds the set from `sorted`, which must be sorted and unique with
+  // regard to `comp`.
+  constexpr static_search_set(sorted_unique_t,
+                              span<const Key> sorted,
+                              const Compare& comp = Compare())
+      : comp_(comp) {
+    DCHECK(internal::is_sorted_and_unique(sorted, comp_));
+    if constexpr (requires { body_.resize(sorted.size()); }) {
+      body_.resize(sorted.size());
+    } else {
+      CHECK_EQ(body_.size(), sorted.size());
+    }
+    const size_t filled = Fill(sorted, 0, 1);
+    DCHECK_EQ(filled, sorted.size());
+  }
+
+  template <class SetContainer>
+  explicit constexpr static_search_set(
+      const flat_set<Key, Compare, SetContainer>& set)
+      : static_search_set(sorted_unique, set, set.key_comp()) {}
+
+  static_search_set(const static_search_set&) = default;
+  static_search_set(static_search_set&&) = default;
+  static_search_set& operator=(const static_search_set&) = default;
+  static_search_set& operator=(static_search_set&&) = default;
+
+  constexpr size_t size() const { return body_.size(); }
+  constexpr bool empty() const { return body_.empty(); }
+
+  // Iterates in layout order, which is not the sorted order.
+  constexpr const_iterator begin() const { return body_.begin(); }
+  constexpr const_iterator end() const { return body_.end(); }
+
+  // Returns the first key, in sorted order, which is not less than `key`, or
+  // end() if there is none.
+  template <typename K>
+  constexpr const_iterator lower_bound(const K& key) const {
+    size_t k = LowerBoundPosition(key);
+    return k == 0 ? end() : begin() + static_cast<ptrdiff_t>(k - 1);
+  }
+
+  // Returns the key equivalent to `key`, or end() if there is none.
+  template <typename K>
+  constexpr const_iterator find(const K& key) const {
+    const_iterator it = lower_bound(key);
+    return it == end() || comp_(key, *it) ? end() : it;
+  }
+
+  template <typename K>
+  constexpr bool contains(const K& key) const {
+    return find(key) != end();
+  }
+
+  template <typename K>
+  constexpr size_t count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  constexpr key_compare key_comp() const { return comp_; }
+
+  // The keys in layout order.
+  constexpr const container_type& layout() const { return body_; }
+
+ private:
+  // Prefetches the descendants of the current key this many levels down,
+  // which fill one cache line when keys are small.
+  static constexpr size_t kPrefetchLevels =
+      std::bit_width(64 / std::clamp<size_t>(sizeof(Key), 1, 64)) - 1;
+
+  // Fills the subtree at 1-based position `k` in order with the keys of
+  // `sorted` starting at `next`, and returns the index of the first key not
+  // consumed. The recursion depth is the height of the tree.
+  constexpr size_t Fill(span<const Key> sorted, size_t next, size_t k) {
+    if (k > sorted.size()) {
+      return next;
+    }
+    next = Fill(sorted, next, 2 * k);
+    body_[k - 1] = sorted[next++];
+    return Fill(sorted, next, 2 * k + 1);
+  }
+
+  // Returns the 1-based position of the lower bound of `key`, or 0 if there
+  // is none.
+  template <typename K>
+  constexpr size_t LowerBoundPosition(const K& key) const {
+    const size_t n = body_.size();
+    size_t k = 1;
+    while (k <= n) {
+      if (!std::is_constant_evaluated()) {
+        const size_t ahead = k << kPrefetchLevels;
+#if HAS_BUILTIN(__builtin_prefetch)
+        if (ahead <= n) {
+          __builtin_prefetch(&body_[ahead - 1]);
+        }
+#endif
+      }
+      // Goes right if the key at `k` is less than `key`, without branching.
+      k = 2 * k + static_cast<size_t>(comp_(body_[k - 1], key));
+    }
+    // The last left turn was at the lower bound: the turns are the bits of `k`
+    // after the leading one, and right turns (ones) follow it.
+    return k >> (std::countr_one(k) + 1);
+  }
+
+  NO_UNIQUE_ADDRESS key_compare comp_;
+  container_type body_{};
+};
+
+// Builds a static_search_set at compile time from a fixed_flat_set.
+//
+// Example usage:
+//   constexpr auto kSet =
+//       base::MakeStaticSearchSet(base::MakeFixedFlatSet<int>({3, 1, 2}));
+template <class Key, size_t N, class Compare>
+constexpr static_search_set<Key, Compare, std::array<Key, N>>
+MakeStaticSearchSet(const fixed_flat_set<Key, N, Compare>& set) {
+  return static_search_set<Key, Compare, std::array<Key, N>>(
+      sorted_unique, set, set.key_comp());
+}
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_STATIC_SEARCH_SET_H_
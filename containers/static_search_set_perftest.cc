@@ -0,0 +1,84 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/static_search_set.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+namespace {
+
+constexpr char kMetricPrefixFlatSet[] = "FlatSet.";
+constexpr char kMetricPrefixStaticSearchSet[] = "StaticSearchSet.";
+constexpr char kMetricLookupTime[] = "lookup_time";
+
+constexpr int kNumLookups = 10000000;
+
+// xorshift32, which is cheap enough not to dominate the measurement.
+uint32_t NextRandom(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+template <typename SetType>
+void RunTest(const SetType& set,
+             uint32_t num_keys,
+             const std::string& metric_prefix) {
+  uint32_t state = 0x9E3779B9u;
+  int hits = 0;
+  ElapsedTimer timer;
+  for (int i = 0; i < kNumLookups; ++i) {
+    // Half of the lookups miss, since the keys are even.
+    if (set.contains(NextRandom(state) % (2 * num_keys))) {
+      ++hits;
+    }
+  }
+  const TimeDelta elapsed = timer.Elapsed();
+  EXPECT_GT(hits, 0);
+
+  perf_test::PerfResultReporter reporter(metric_prefix,
+                                         std::to_string(num_keys) + "_keys");
+  reporter.RegisterImportantMetric(kMetricLookupTime, "ns");
+  reporter.AddResult(
+      kMetricLookupTime,
+      static_cast<double>(elapsed.InNanoseconds()) / kNumLookups);
+}
+
+class StaticSearchSetPerfTest : public testing::TestWithParam<uint32_t> {
+ protected:
+  flat_set<uint32_t> MakeKeys() const {
+    std::vector<uint32_t> keys;
+    for (uint32_t i = 0; i < GetParam(); ++i) {
+      keys.push_back(2 * i);
+    }
+    return flat_set<uint32_t>(sorted_unique, std::move(keys));
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         StaticSearchSetPerfTest,
+                         testing::Values(1000, 100000, 10000000));
+
+TEST_P(StaticSearchSetPerfTest, FlatSet) {
+  RunTest(MakeKeys(), GetParam(), kMetricPrefixFlatSet);
+}
+
+TEST_P(StaticSearchSetPerfTest, StaticSearchSet) {
+  RunTest(static_search_set<uint32_t>(MakeKeys()), GetParam(),
+          kMetricPrefixStaticSearchSet);
+}
+
+}  // namespace
+}  // namespace base
@@ -0,0 +1,81 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/static_search_set.h"
+
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "base/containers/fixed_flat_set.h"
+#include "base/containers/flat_set.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+using ::testing::ElementsAre;
+
+TEST(StaticSearchSetTest, Layout) {
+  const static_search_set<int> set(flat_set<int>({1, 2, 3, 4, 5, 6}));
+  // The tree is 4 2 6 1 3 5, breadth-first.
+  EXPECT_THAT(set.layout(), ElementsAre(4, 2, 6, 1, 3, 5));
+  EXPECT_EQ(6u, set.size());
+}
+
+TEST(StaticSearchSetTest, Empty) {
+  const static_search_set<int> set(flat_set<int>{});
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.end(), set.find(1));
+  EXPECT_EQ(set.end(), set.lower_bound(1));
+  EXPECT_FALSE(set.contains(1));
+}
+
+TEST(StaticSearchSetTest, MatchesFlatSet) {
+  // Every size up to a few full levels, with the keys at even values so that
+  // lookups of odd values miss.
+  for (int size = 0; size < 70; ++size) {
+    std::vector<int> keys;
+    for (int i = 0; i < size; ++i) {
+      keys.push_back(2 * i);
+    }
+    const flat_set<int> sorted(sorted_unique, keys);
+    const static_search_set<int> set(sorted);
+    for (int key = -1; key <= 2 * size; ++key) {
+      SCOPED_TRACE(testing::Message() << "size " << size << ", key " << key);
+      EXPECT_EQ(sorted.contains(key), set.contains(key));
+      EXPECT_EQ(sorted.count(key), set.count(key));
+      auto expected = sorted.lower_bound(key);
+      auto actual = set.lower_bound(key);
+      if (expected == sorted.end()) {
+        EXPECT_EQ(set.end(), actual);
+      } else {
+        ASSERT_NE(set.end(), actual);
+        EXPECT_EQ(*expected, *actual);
+      }
+    }
+  }
+}
+
+TEST(StaticSearchSetTest, CustomCompare) {
+  const static_search_set<int, std::greater<>> set(
+      flat_set<int, std::greater<>>({1, 2, 3}));
+  EXPECT_THAT(set.layout(), ElementsAre(2, 3, 1));
+  EXPECT_TRUE(set.contains(3));
+  EXPECT_EQ(1, *set.lower_bound(1));
+  EXPECT_EQ(set.end(), set.lower_bound(0));
+}
+
+TEST(StaticSearchSetTest, Constexpr) {
+  static constexpr auto kSet = MakeStaticSearchSet(
+      MakeFixedFlatSet<std::string_view>({"foo", "bar", "baz", "qux"}));
+  static_assert(kSet.size() == 4);
+  static_assert(kSet.contains("baz"));
+  static_assert(!kSet.contains("quux"));
+  static_assert(*kSet.lower_bound("c") == "foo");
+  EXPECT_TRUE(kSet.contains("qux"));
+  EXPECT_FALSE(kSet.contains("a"));
+}
+
+}  // namespace base
@@ -6,8 +6,13 @@
 
 #include <array>
 #include <atomic>
+#include <bit>
+#include <utility>
 
 #include "base/check_op.h"
+#include "base/containers/span.h"
+#include "base/hash/hash.h"
+#include "base/trace_event/trace_event.h"
 
 namespace base::debug::tracer {
 
@@ -105,4 +110,88 @@ AllocationTraceRecorder::GetRecorderStatistics() const {
 #endif
 }
 
+
+void AllocationCallSiteRecorder::RecordSample(size_t allocated_size) {
+  static_assert(std::has_single_bit(kMaximumNumberOfCallSites),
+                "kMaximumNumberOfCallSites should be a power of 2 to allow for "
+                "fast modulo operation.");
+  // Bound the probing, so that a full table doesn't make every sample scan all
+  // the entries.
+  constexpr size_t kMaximumNumberOfProbes = 16;
+
+  StackTraceContainer stack_trace = {};
+#if BUILDFLAG(CAN_UNWIND_WITH_FRAME_POINTERS)
+  base::debug::TraceStackFramePointers(&stack_trace[0], stack_trace.size(), 0);
+#elif BUILDFLAG(IS_LINUX)
+  base::debug::CollectStackTrace(&stack_trace[0], stack_trace.size());
+#else
+#error "No supported stack tracer found."
+#endif
+
+  size_t stack_hash = FastHash(as_byte_span(stack_trace));
+  if (stack_hash == 0) {
+    stack_hash = 1;
+  }
+
+  size_t index = stack_hash % kMaximumNumberOfCallSites;
+  for (size_t probe = 0; probe < kMaximumNumberOfProbes;
+       ++probe, index = (index + 1) % kMaximumNumberOfCallSites) {
+    CallSiteEntry& entry = call_sites_[index];
+    size_t entry_hash = entry.stack_hash.load(std::memory_order_acquire);
+    if (entry_hash == 0 &&
+        entry.stack_hash.compare_exchange_strong(entry_hash, stack_hash,
+                                                 std::memory_order_acq_rel)) {
+      entry.stack_trace = stack_trace;
+      entry.is_initialized.store(true, std::memory_order_release);
+      entry_hash = stack_hash;
+    }
+    if (entry_hash == stack_hash) {
+      entry.count.fetch_add(1, std::memory_order_relaxed);
+      entry.bytes.fetch_add(allocated_size, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  dropped_samples_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<CallSiteStatistics> AllocationCallSiteRecorder::GetSnapshot()
+    const {
+  std::vector<CallSiteStatistics> snapshot;
+  for (const CallSiteEntry& entry : call_sites_) {
+    if (!entry.is_initialized.load(std::memory_order_acquire)) {
+      continue;
+    }
+    CallSiteStatistics& statistics = snapshot.emplace_back();
+    statistics.stack_hash = entry.stack_hash.load(std::memory_order_relaxed);
+    statistics.stack_trace = entry.stack_trace;
+    statistics.sampled_count = entry.count.load(std::memory_order_relaxed);
+    statistics.sampled_bytes = entry.bytes.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void AllocationCallSiteRecorder::EmitSnapshotAsTraceEvent() const {
+  const std::vector<CallSiteStatistics> snapshot = GetSnapshot();
+  TRACE_EVENT_INSTANT(
+      "memory", "AllocationCallSites", "sampling_interval", sampling_interval_,
+      "dropped_samples", GetNumberOfDroppedSamples(), "call_sites",
+      [&snapshot](perfetto::TracedValue context) {
+        perfetto::TracedArray call_sites = std::move(context).WriteArray();
+        for (const CallSiteStatistics& statistics : snapshot) {
+          perfetto::TracedDictionary call_site =
+              call_sites.AppendDictionary();
+          call_site.Add("stack_hash", statistics.stack_hash);
+          call_site.Add("sampled_count", statistics.sampled_count);
+          call_site.Add("sampled_bytes", statistics.sampled_bytes);
+          perfetto::TracedArray frames = call_site.AddArray("frames");
+          for (const void* frame : statistics.stack_trace) {
+            if (frame) {
+              frames.Append(reinterpret_cast<uintptr_t>(frame));
+            }
+          }
+        }
+      });
+}
+
 }  // namespace base::debug::tracer
\ No newline at end of file
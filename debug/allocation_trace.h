@@ -10,6 +10,7 @@
 #include <atomic>
 #include <bit>
 #include <cstdint>
+#include <vector>
 
 #include "base/allocator/dispatcher/notification_data.h"
 #include "base/base_export.h"
@@ -301,6 +302,101 @@ ALWAYS_INLINE size_t AllocationTraceRecorder::GetNextIndex() {
   return WrapIdxIfNeeded(raw_idx);
 }
 
+
+// Statistics of the sampled allocations made from a single call site, as
+// reported by AllocationCallSiteRecorder::GetSnapshot().
+struct BASE_EXPORT CallSiteStatistics {
+  // The hash of |stack_trace|, which identifies the call site.
+  size_t stack_hash = 0;
+  StackTraceContainer stack_trace = {};
+  // The number of sampled allocations and their total size. Multiply by the
+  // sampling interval to estimate the actual values.
+  size_t sampled_count = 0;
+  size_t sampled_bytes = 0;
+};
+
+// A sampling recorder which aggregates allocations by call site, rather than
+// keeping a ring of the most recent operations like AllocationTraceRecorder.
+// It is an allocation event observer for the dispatcher, like the latter.
+//
+// One allocation in |sampling_interval|, which must be positive, is sampled.
+// For sampled allocations, the stack trace is taken and hashed, and the count
+// and size of the allocation are added to the counters of the call site in a
+// preallocated open addressing table. Like AllocationTraceRecorder, the
+// recorder doesn't allocate and works without locking: the slot of a new call
+// site is claimed by a compare-and-swap of its hash, and counters are updated
+// with relaxed atomic increments. Samples of new call sites are dropped once
+// the table is full.
+//
+// Non-sampled allocations only pay for an atomic increment, which is the same
+// cost as the bookkeeping of AllocationTraceRecorder.
+class BASE_EXPORT AllocationCallSiteRecorder {
+ public:
+  static constexpr size_t kDefaultSamplingInterval = 1000;
+  // Number of call sites that can be tracked. Must be a power of two.
+  static constexpr size_t kMaximumNumberOfCallSites = 1024;
+
+  explicit constexpr AllocationCallSiteRecorder(
+      size_t sampling_interval = kDefaultSamplingInterval)
+      : sampling_interval_(sampling_interval) {}
+
+  AllocationCallSiteRecorder(const AllocationCallSiteRecorder&) = delete;
+  AllocationCallSiteRecorder& operator=(const AllocationCallSiteRecorder&) =
+      delete;
+
+  // The allocation event observer interface. See the dispatcher for further
+  // details.
+  ALWAYS_INLINE void OnAllocation(
+      const base::allocator::dispatcher::AllocationNotificationData&
+          allocation_data) {
+    if (allocation_counter_.fetch_add(1, std::memory_order_relaxed) %
+            sampling_interval_ ==
+        0) {
+      RecordSample(allocation_data.size());
+    }
+  }
+
+  // Frees are not attributed to call sites.
+  void OnFree(const base::allocator::dispatcher::FreeNotificationData&) {}
+
+  size_t GetSamplingInterval() const { return sampling_interval_; }
+
+  // Returns the statistics of all call sites recorded so far. Counters are
+  // read without synchronization with concurrent allocations, so each of them
+  // is only individually consistent.
+  std::vector<CallSiteStatistics> GetSnapshot() const;
+
+  // Emits the snapshot as an instant trace event in the "memory" category.
+  void EmitSnapshotAsTraceEvent() const;
+
+  // Returns the number of samples dropped because the table of call sites was
+  // full.
+  size_t GetNumberOfDroppedSamples() const {
+    return dropped_samples_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct CallSiteEntry {
+    // Zero for unused entries.
+    std::atomic<size_t> stack_hash = 0;
+    // Set once |stack_trace| has been written by the thread which claimed the
+    // entry.
+    std::atomic<bool> is_initialized = false;
+    StackTraceContainer stack_trace = {};
+    std::atomic<size_t> count = 0;
+    std::atomic<size_t> bytes = 0;
+  };
+
+  // Takes the stack trace and updates the counters of its call site. It is
+  // NOINLINE so that the number of frames taken by the recorder is fixed.
+  NOINLINE void RecordSample(size_t allocated_size);
+
+  const size_t sampling_interval_;
+  std::array<CallSiteEntry, kMaximumNumberOfCallSites> call_sites_ = {};
+  std::atomic<size_t> allocation_counter_ = 0;
+  std::atomic<size_t> dropped_samples_ = 0;
+};
+
 }  // namespace base::debug::tracer
 
 #endif  // BASE_DEBUG_ALLOCATION_TRACE_H_
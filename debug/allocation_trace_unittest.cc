@@ -15,6 +15,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "base/allocator/dispatcher/dispatcher.h"
 #include "base/allocator/dispatcher/testing/tools.h"
@@ -449,4 +450,67 @@ TEST_F(OperationRecordTest, VerifyRecordFree) {
   VerifyStackTrace(reference_trace, subject_under_test.GetStackTrace());
 }
 
+class AllocationCallSiteRecorderTest : public Test {
+ protected:
+  AllocationNotificationData CreateAllocationData(void* address, size_t size) {
+    return AllocationNotificationData(address, size, nullptr,
+                                      AllocationSubsystem::kPartitionAllocator);
+  }
+
+  NOINLINE void AllocateFromCallSiteA(AllocationCallSiteRecorder& recorder,
+                                      size_t size) {
+    recorder.OnAllocation(CreateAllocationData(this, size));
+  }
+
+  // Allocates twice |size|, so that the linker doesn't fold the call sites.
+  NOINLINE void AllocateFromCallSiteB(AllocationCallSiteRecorder& recorder,
+                                      size_t size) {
+    recorder.OnAllocation(CreateAllocationData(this, 2 * size));
+  }
+};
+
+TEST_F(AllocationCallSiteRecorderTest, AggregatesByCallSite) {
+  auto recorder = std::make_unique<AllocationCallSiteRecorder>(1);
+
+  for (size_t i = 0; i < 3; ++i) {
+    AllocateFromCallSiteA(*recorder, 16);
+  }
+  AllocateFromCallSiteB(*recorder, 50);
+
+  std::vector<CallSiteStatistics> snapshot = recorder->GetSnapshot();
+  ASSERT_EQ(snapshot.size(), 2u);
+  std::sort(snapshot.begin(), snapshot.end(),
+            [](const CallSiteStatistics& a, const CallSiteStatistics& b) {
+              return a.sampled_count < b.sampled_count;
+            });
+  EXPECT_EQ(snapshot[0].sampled_count, 1u);
+  EXPECT_EQ(snapshot[0].sampled_bytes, 100u);
+  EXPECT_EQ(snapshot[1].sampled_count, 3u);
+  EXPECT_EQ(snapshot[1].sampled_bytes, 48u);
+  EXPECT_NE(snapshot[0].stack_hash, snapshot[1].stack_hash);
+  EXPECT_NE(snapshot[0].stack_trace[0], nullptr);
+  EXPECT_EQ(recorder->GetNumberOfDroppedSamples(), 0u);
+}
+
+TEST_F(AllocationCallSiteRecorderTest, SamplesOneInInterval) {
+  auto recorder = std::make_unique<AllocationCallSiteRecorder>(10);
+  EXPECT_EQ(recorder->GetSamplingInterval(), 10u);
+
+  for (size_t i = 0; i < 100; ++i) {
+    AllocateFromCallSiteA(*recorder, 8);
+  }
+
+  std::vector<CallSiteStatistics> snapshot = recorder->GetSnapshot();
+  ASSERT_EQ(snapshot.size(), 1u);
+  EXPECT_EQ(snapshot[0].sampled_count, 10u);
+  EXPECT_EQ(snapshot[0].sampled_bytes, 80u);
+}
+
+TEST_F(AllocationCallSiteRecorderTest, IgnoresFrees) {
+  auto recorder = std::make_unique<AllocationCallSiteRecorder>(1);
+  recorder->OnFree(
+      FreeNotificationData(this, AllocationSubsystem::kPartitionAllocator));
+  EXPECT_TRUE(recorder->GetSnapshot().empty());
+}
+
 }  // namespace base::debug::tracer
@@ -1281,6 +1281,40 @@ void PopulateCompileUnitOffsets(int fd,
   }
 }
 
+// Returns the end of the address range covered by the PT_LOAD segments of the
+// ELF object in `fd`, relative to the base address of the object. Returns 0 if
+// the program headers can't be read.
+uint64_t GetObjectAddressRangeEnd(int fd) {
+  ElfW(Ehdr) elf_header;
+  if (google::ReadFromOffset(fd, &elf_header, sizeof(elf_header), 0) !=
+      static_cast<ssize_t>(sizeof(elf_header))) {
+    return 0;
+  }
+
+  // Read the program headers in batches, rather than one read per header.
+  constexpr size_t kMaxProgramHeadersPerRead = 16;
+  ElfW(Phdr) program_headers[kMaxProgramHeadersPerRead];
+  uint64_t end = 0;
+  for (size_t i = 0; i < elf_header.e_phnum; i += kMaxProgramHeadersPerRead) {
+    const size_t num_headers =
+        std::min<size_t>(kMaxProgramHeadersPerRead, elf_header.e_phnum - i);
+    const size_t size = num_headers * sizeof(program_headers[0]);
+    if (google::ReadFromOffset(
+            fd, program_headers, size,
+            elf_header.e_phoff + i * sizeof(program_headers[0])) !=
+        static_cast<ssize_t>(size)) {
+      return 0;
+    }
+    for (size_t j = 0; j < num_headers; ++j) {
+      if (program_headers[j].p_type == PT_LOAD) {
+        end = std::max<uint64_t>(
+            end, program_headers[j].p_vaddr + program_headers[j].p_memsz);
+      }
+    }
+  }
+  return end;
+}
+
 }  // namespace
 
 bool GetDwarfSourceLineNumber(const void* pc,
@@ -1310,6 +1344,10 @@ bool GetDwarfSourceLineNumber(const void* pc,
 void GetDwarfCompileUnitOffsets(const void* const* trace,
                                 uint64_t* cu_offsets,
                                 size_t num_frames) {
+  if (num_frames == 0) {
+    return;
+  }
+
   // LINT.IfChange(max_stack_frames)
   FrameInfo frame_info[250] = {};
   // LINT.ThenChange(stack_trace.h:max_stack_frames)
@@ -1323,11 +1361,12 @@ void GetDwarfCompileUnitOffsets(const void* const* trace,
   };
 
   // Use heapsort to avoid recursion in a signal handler.
-  std::make_heap(&frame_info[0], &frame_info[num_frames - 1], pc_comparator);
-  std::sort_heap(&frame_info[0], &frame_info[num_frames - 1], pc_comparator);
+  std::make_heap(&frame_info[0], &frame_info[num_frames], pc_comparator);
+  std::sort_heap(&frame_info[0], &frame_info[num_frames], pc_comparator);
 
-  // Walk the frame_info one compilation unit at a time.
-  for (size_t cur_frame = 0; cur_frame < num_frames; ++cur_frame) {
+  // Walk the frame_info one object file at a time. Since the frames are sorted
+  // by pc, the frames of an object are contiguous.
+  for (size_t cur_frame = 0; cur_frame < num_frames;) {
     uint64_t object_start_address = 0;
     uint64_t object_base_address = 0;
     google::FileDescriptor object_fd(google::FileDescriptor(
@@ -1339,18 +1378,25 @@ void GetDwarfCompileUnitOffsets(const void* const* trace,
     // frame inside the Linux kernel's vdso. Just skip over these stack frames,
     // as this is done on a best-effort basis.
     if (object_fd.get() < 0) {
+      ++cur_frame;
       continue;
     }
 
-    // TODO(crbug.com/40228616): Consider exposing the end address so a
-    // range of frames can be bulk-populated. This was originally implemented,
-    // but line number symbolization is currently broken by default (and also
-    // broken in sandboxed processes). The various issues will be addressed
-    // incrementally in follow-up patches, and the optimization here restored if
-    // needed.
+    // Populate all the frames of the object in a single pass over its
+    // .debug_aranges, instead of reopening the object and rescanning the table
+    // for each frame. If the end of the object can't be determined, only the
+    // current frame is populated.
+    const uint64_t object_end_address =
+        object_base_address + GetObjectAddressRangeEnd(object_fd.get());
+    size_t end_frame = cur_frame + 1;
+    while (end_frame < num_frames &&
+           frame_info[end_frame].pc < object_end_address) {
+      ++end_frame;
+    }
 
-    PopulateCompileUnitOffsets(object_fd.get(), &frame_info[cur_frame], 1,
-                               object_base_address);
+    PopulateCompileUnitOffsets(object_fd.get(), &frame_info[cur_frame],
+                               end_frame - cur_frame, object_base_address);
+    cur_frame = end_frame;
   }
 }
 
@@ -12,19 +12,101 @@
 #include <fcntl.h>
 #include <stddef.h>
 
+#include <algorithm>
+#include <limits>
+#include <string_view>
+
 #include "base/files/file_util.h"
 #include "base/files/scoped_file.h"
 #include "base/logging.h"
-#include "base/strings/string_split.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
 #include "build/build_config.h"
 
-#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
-#include <inttypes.h>
-#endif
-
 namespace base {
 namespace debug {
 
+namespace {
+
+// The Consume*() functions parse a field at the start of |input| and remove
+// it. They return false if the field is missing or invalid, in which case
+// |input| and the output are unspecified.
+
+bool ConsumeChar(std::string_view& input, char c) {
+  if (input.empty() || input.front() != c) {
+    return false;
+  }
+  input.remove_prefix(1);
+  return true;
+}
+
+// Consumes one or more spaces or tabs.
+bool ConsumeSpaces(std::string_view& input) {
+  const size_t end = std::min(input.find_first_not_of(" \t"), input.size());
+  input.remove_prefix(end);
+  return end != 0;
+}
+
+template <typename T>
+bool ConsumeHex(std::string_view& input, T& value) {
+  value = 0;
+  size_t length = 0;
+  for (; length < input.size() && IsHexDigit(input[length]); ++length) {
+    if (value > std::numeric_limits<T>::max() >> 4) {
+      return false;
+    }
+    value = static_cast<T>((value << 4) |
+                           static_cast<T>(HexDigitToInt(input[length])));
+  }
+  input.remove_prefix(length);
+  return length != 0;
+}
+
+bool ConsumeDecimal(std::string_view& input, uint64_t& value) {
+  size_t length = 0;
+  while (length < input.size() && IsAsciiDigit(input[length])) {
+    ++length;
+  }
+  if (!StringToUint64(input.substr(0, length), &value)) {
+    return false;
+  }
+  input.remove_prefix(length);
+  return true;
+}
+
+// Consumes the 4 characters of the permissions, e.g. "r-xp".
+bool ConsumePermissions(std::string_view& input, uint8_t& permissions) {
+  if (input.size() < 4) {
+    return false;
+  }
+  permissions = 0;
+
+  if (input[0] == 'r')
+    permissions |= MappedMemoryRegion::READ;
+  else if (input[0] != '-')
+    return false;
+
+  if (input[1] == 'w')
+    permissions |= MappedMemoryRegion::WRITE;
+  else if (input[1] != '-')
+    return false;
+
+  if (input[2] == 'x')
+    permissions |= MappedMemoryRegion::EXECUTE;
+  else if (input[2] != '-')
+    return false;
+
+  if (input[3] == 'p')
+    permissions |= MappedMemoryRegion::PRIVATE;
+  else if (input[3] != 's' && input[3] != 'S')  // Shared memory.
+    return false;
+
+  input.remove_prefix(4);
+  return true;
+}
+
+}  // namespace
+
 // Scans |proc_maps| starting from |pos| returning true if the gate VMA was
 // found, otherwise returns false.
 static bool ContainsGateVMA(std::string* proc_maps, size_t pos) {
@@ -92,70 +174,52 @@ bool ParseProcMaps(const std::string& input,
                    std::vector<MappedMemoryRegion>* regions_out) {
   CHECK(regions_out);
   std::vector<MappedMemoryRegion> regions;
+  regions.reserve(
+      static_cast<size_t>(std::count(input.begin(), input.end(), '\n')));
 
-  // This isn't async safe nor terribly efficient, but it doesn't need to be at
-  // this point in time.
-  std::vector<std::string> lines = SplitString(
-      input, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
-
-  for (size_t i = 0; i < lines.size(); ++i) {
-    // Due to splitting on '\n' the last line should be empty.
-    if (i == lines.size() - 1) {
-      if (!lines[i].empty()) {
+  // Parsed by hand rather than with sscanf(), and without splitting |input|
+  // into strings first, since this is called on every symbolization and the
+  // maps of a large process have thousands of lines.
+  std::string_view remaining(input);
+  while (true) {
+    const size_t line_end = remaining.find('\n');
+    const std::string_view full_line =
+        TrimWhitespaceASCII(remaining.substr(0, line_end), TRIM_ALL);
+    std::string_view line = full_line;
+    if (line_end == std::string_view::npos) {
+      // The last line should be empty since each line ends with '\n'.
+      if (!line.empty()) {
         DLOG(WARNING) << "Last line not empty";
         return false;
       }
       break;
     }
-
-    MappedMemoryRegion region;
-    const char* line = lines[i].c_str();
-    char permissions[5] = {'\0'};  // Ensure NUL-terminated string.
-    uint8_t dev_major = 0;
-    uint8_t dev_minor = 0;
-    long inode = 0;
-    int path_index = 0;
+    remaining.remove_prefix(line_end + 1);
 
     // Sample format from man 5 proc:
     //
     // address           perms offset  dev   inode   pathname
     // 08048000-08056000 r-xp 00000000 03:0c 64593   /usr/sbin/gpm
-    //
-    // The final %n term captures the offset in the input string, which is used
-    // to determine the path name. It *does not* increment the return value.
-    // Refer to man 3 sscanf for details.
-    if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR " %4c %llx %hhx:%hhx %ld %n",
-               &region.start, &region.end, permissions, &region.offset,
-               &dev_major, &dev_minor, &inode, &path_index) < 7) {
-      DPLOG(WARNING) << "sscanf failed for line: " << line;
+    MappedMemoryRegion region;
+    bool parsed = ConsumeHex(line, region.start) && ConsumeChar(line, '-') &&
+                  ConsumeHex(line, region.end) && ConsumeSpaces(line) &&
+                  ConsumePermissions(line, region.permissions) &&
+                  ConsumeSpaces(line) && ConsumeHex(line, region.offset) &&
+                  ConsumeSpaces(line);
+    // The device and inode are not stored.
+    uint32_t dev_major = 0;
+    uint32_t dev_minor = 0;
+    uint64_t inode = 0;
+    parsed = parsed && ConsumeHex(line, dev_major) && ConsumeChar(line, ':') &&
+             ConsumeHex(line, dev_minor) && ConsumeSpaces(line) &&
+             ConsumeDecimal(line, inode);
+    if (!parsed || (!line.empty() && !ConsumeSpaces(line))) {
+      DLOG(WARNING) << "Failed to parse line: " << full_line;
       return false;
     }
 
-    region.permissions = 0;
-
-    if (permissions[0] == 'r')
-      region.permissions |= MappedMemoryRegion::READ;
-    else if (permissions[0] != '-')
-      return false;
-
-    if (permissions[1] == 'w')
-      region.permissions |= MappedMemoryRegion::WRITE;
-    else if (permissions[1] != '-')
-      return false;
-
-    if (permissions[2] == 'x')
-      region.permissions |= MappedMemoryRegion::EXECUTE;
-    else if (permissions[2] != '-')
-      return false;
-
-    if (permissions[3] == 'p')
-      region.permissions |= MappedMemoryRegion::PRIVATE;
-    else if (permissions[3] != 's' && permissions[3] != 'S')  // Shared memory.
-      return false;
-
-    // Pushing then assigning saves us a string copy.
     regions.push_back(region);
-    regions.back().path.assign(line + path_index);
+    regions.back().path.assign(line);
   }
 
   regions_out->swap(regions);
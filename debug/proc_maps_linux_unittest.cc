@@ -330,5 +330,47 @@ TEST(ProcMapsTest, ParseProcMapsWeirdCorrectInput) {
   EXPECT_EQ("[vsys call]", regions[4].path);
 }
 
+TEST(ProcMapsTest, ParseProcMapsLargeFields) {
+  // Device numbers wider than a byte, the largest 32-bit addresses, the
+  // largest offset, and tabs between the fields.
+  const std::string kContents =
+      "ffff0000-ffffffff r-xp ffffffffffffffff 103:05 "
+      "18446744073709551615\t/bin/cat\n";
+  std::vector<MappedMemoryRegion> regions;
+  ASSERT_TRUE(ParseProcMaps(kContents, &regions));
+  ASSERT_EQ(1u, regions.size());
+  EXPECT_EQ(0xffff0000u, regions[0].start);
+  EXPECT_EQ(0xffffffffu, regions[0].end);
+  EXPECT_EQ(0xffffffffffffffffULL, regions[0].offset);
+  EXPECT_EQ("/bin/cat", regions[0].path);
+
+#if defined(ARCH_CPU_64_BITS)
+  // The largest 64-bit addresses.
+  ASSERT_TRUE(ParseProcMaps(
+      "ffffffffff600000-ffffffffffffffff r-xp 00000000 00:00 0 [vsyscall]\n",
+      &regions));
+  ASSERT_EQ(1u, regions.size());
+  EXPECT_EQ(0xffffffffff600000u, regions[0].start);
+  EXPECT_EQ(0xffffffffffffffffu, regions[0].end);
+
+  // Addresses which overflow uintptr_t.
+  EXPECT_FALSE(ParseProcMaps(
+      "1ffffffffffffffff-ffffffffffffffff r-xp 00000000 fc:00 0 /bin/cat\n",
+      &regions));
+#else
+  // Addresses which overflow uintptr_t.
+  EXPECT_FALSE(ParseProcMaps(
+      "1ffffffff-ffffffff r-xp 00000000 fc:00 0 /bin/cat\n", &regions));
+  EXPECT_FALSE(ParseProcMaps(
+      "ffffffffff600000-ffffffffffffffff r-xp 00000000 00:00 0 [vsyscall]\n",
+      &regions));
+#endif
+
+  // Offsets which overflow.
+  EXPECT_FALSE(ParseProcMaps(
+      "ffff0000-ffffffff r-xp 1ffffffffffffffff fc:00 0 /bin/cat\n",
+      &regions));
+}
+
 }  // namespace debug
 }  // namespace base
@@ -0,0 +1,194 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/symbolizer.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+
+#include "base/containers/span.h"
+#include "base/debug/debugging_buildflags.h"
+#include "base/debug/stack_trace.h"
+#include "base/profiler/module_cache.h"
+#include "base/sequence_checker.h"
+#include "base/task/thread_pool.h"
+#include "build/build_config.h"
+
+#if defined(USE_SYMBOLIZE)
+#include "base/third_party/symbolize/symbolize.h"  // nogncheck
+
+#if BUILDFLAG(ENABLE_STACK_TRACE_LINE_NUMBERS)
+#include "base/debug/dwarf_line_no.h"  // nogncheck
+#endif
+#else
+#include "base/strings/string_split.h"
+#endif
+
+namespace base {
+namespace debug {
+
+namespace {
+
+// The maximum number of cached symbols, beyond which the cache is cleared.
+constexpr size_t kMaxCachedSymbols = 64 * 1024;
+
+// Symbolizes `addresses` into `symbols`, which have the same size. Sorted
+// addresses are symbolized faster.
+void SymbolizeAddresses(span<const uintptr_t> addresses,
+                        span<Symbolizer::Symbol> symbols) {
+  // Batches of at most kMaxTraces, which is what StackTrace and the DWARF
+  // helpers support.
+  for (size_t start = 0; start < addresses.size();
+       start += StackTrace::kMaxTraces) {
+    const size_t size =
+        std::min(addresses.size() - start, StackTrace::kMaxTraces);
+    span<const uintptr_t> batch = addresses.subspan(start, size);
+    span<Symbolizer::Symbol> batch_symbols = symbols.subspan(start, size);
+
+#if defined(USE_SYMBOLIZE)
+#if BUILDFLAG(ENABLE_STACK_TRACE_LINE_NUMBERS)
+    const void* pcs[StackTrace::kMaxTraces];
+    for (size_t i = 0; i < size; ++i) {
+      pcs[i] = reinterpret_cast<const void*>(batch[i]);
+    }
+    uint64_t cu_offsets[StackTrace::kMaxTraces] = {};
+    GetDwarfCompileUnitOffsets(pcs, cu_offsets, size);
+#endif
+    for (size_t i = 0; i < size; ++i) {
+      char buf[1024] = {'\0'};
+      if (!google::Symbolize(reinterpret_cast<void*>(batch[i]), buf,
+                             sizeof(buf))) {
+        continue;
+      }
+      batch_symbols[i].function_name = buf;
+#if BUILDFLAG(ENABLE_STACK_TRACE_LINE_NUMBERS)
+      // As for StackTrace, only look up line numbers if the compile unit was
+      // found, since it is very slow otherwise.
+      if (cu_offsets[i] != 0 &&
+          GetDwarfSourceLineNumber(pcs[i], cu_offsets[i], buf, sizeof(buf))) {
+        batch_symbols[i].source_location = buf;
+      }
+#endif
+    }
+#else
+    // Use the platform's symbolization of StackTrace, which outputs a line
+    // per address.
+    const void* pcs[StackTrace::kMaxTraces];
+    for (size_t i = 0; i < size; ++i) {
+      pcs[i] = reinterpret_cast<const void*>(batch[i]);
+    }
+    std::vector<std::string> lines =
+        SplitString(StackTrace(pcs, size).ToString(), "\n",
+                    TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY);
+    if (lines.size() == size) {
+      for (size_t i = 0; i < size; ++i) {
+        batch_symbols[i].function_name = std::move(lines[i]);
+      }
+    }
+#endif
+  }
+}
+
+}  // namespace
+
+// Symbolizes addresses and caches the results, on a thread pool sequence.
+class Symbolizer::Core {
+ public:
+  Core() = default;
+  Core(const Core&) = delete;
+  Core& operator=(const Core&) = delete;
+  ~Core() = default;
+
+  std::vector<Symbol> Symbolize(std::vector<uintptr_t> addresses) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    if (num_cached_symbols_ > kMaxCachedSymbols) {
+      cache_.clear();
+      num_cached_symbols_ = 0;
+    }
+
+    // Visit the addresses in increasing order, so that each module is looked
+    // up once, and duplicate addresses are adjacent.
+    std::vector<size_t> order(addresses.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return addresses[a] < addresses[b];
+    });
+
+    std::vector<Symbol> symbols(addresses.size());
+    // The indices in `order` of the first occurrence of the addresses which
+    // aren't cached, with their modules.
+    std::vector<std::pair<size_t, const ModuleCache::Module*>> misses;
+    const ModuleCache::Module* module = nullptr;
+    for (size_t i = 0; i < order.size(); ++i) {
+      const uintptr_t address = addresses[order[i]];
+      if (i > 0 && address == addresses[order[i - 1]]) {
+        continue;
+      }
+      if (!module || address < module->GetBaseAddress() ||
+          address - module->GetBaseAddress() >= module->GetSize()) {
+        module = module_cache_.GetModuleForAddress(address);
+      }
+      auto& module_symbols = cache_[module];
+      auto it = module_symbols.find(address);
+      if (it != module_symbols.end()) {
+        symbols[order[i]] = it->second;
+      } else {
+        misses.emplace_back(i, module);
+      }
+    }
+
+    std::vector<uintptr_t> missed_addresses;
+    missed_addresses.reserve(misses.size());
+    for (const auto& [index, missed_module] : misses) {
+      missed_addresses.push_back(addresses[order[index]]);
+    }
+    std::vector<Symbol> missed_symbols(misses.size());
+    SymbolizeAddresses(missed_addresses, missed_symbols);
+    for (size_t i = 0; i < misses.size(); ++i) {
+      symbols[order[misses[i].first]] = missed_symbols[i];
+      cache_[misses[i].second].emplace(missed_addresses[i],
+                                       std::move(missed_symbols[i]));
+    }
+    num_cached_symbols_ += misses.size();
+
+    // Copy the symbols of the duplicate addresses.
+    for (size_t i = 1; i < order.size(); ++i) {
+      if (addresses[order[i]] == addresses[order[i - 1]]) {
+        symbols[order[i]] = symbols[order[i - 1]];
+      }
+    }
+    return symbols;
+  }
+
+ private:
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  ModuleCache module_cache_ GUARDED_BY_CONTEXT(sequence_checker_);
+  // The symbols of the addresses of each module, or of addresses outside of
+  // known modules for null.
+  std::map<const ModuleCache::Module*,
+           std::unordered_map<uintptr_t, Symbol>>
+      cache_ GUARDED_BY_CONTEXT(sequence_checker_);
+  size_t num_cached_symbols_ GUARDED_BY_CONTEXT(sequence_checker_) = 0;
+};
+
+Symbolizer::Symbolizer()
+    : core_(ThreadPool::CreateSequencedTaskRunner(
+          {MayBlock(), TaskPriority::BEST_EFFORT,
+           TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {}
+
+Symbolizer::~Symbolizer() = default;
+
+void Symbolizer::Symbolize(std::vector<uintptr_t> addresses,
+                           SymbolizeCallback callback) {
+  core_.AsyncCall(&Core::Symbolize)
+      .WithArgs(std::move(addresses))
+      .Then(std::move(callback));
+}
+
+}  // namespace debug
+}  // namespace base
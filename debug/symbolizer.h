@@ -0,0 +1,67 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_DEBUG_SYMBOLIZER_H_
+#define BASE_DEBUG_SYMBOLIZER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/functional/callback.h"
+#include "base/threading/sequence_bound.h"
+
+namespace base {
+namespace debug {
+
+// Symbolizes batches of addresses of the current process on the thread pool,
+// instead of on the calling thread as StackTrace::OutputToStream() does. This
+// is meant for symbolizing many addresses at once, e.g. the frames of the
+// samples of profiles or the stacks of hang reports:
+//
+//   Symbolizer symbolizer;
+//   symbolizer.Symbolize(addresses, BindOnce(&OnSymbolized));
+//
+// Addresses are sorted so that each module is looked up once per batch, and
+// the symbols are cached per module of a ModuleCache, so that symbolizing the
+// same address again is cheap.
+//
+// Addresses are symbolized as given: to symbolize return addresses as the
+// call instruction, as StackTrace does, subtract 1 from them.
+class BASE_EXPORT Symbolizer {
+ public:
+  struct BASE_EXPORT Symbol {
+    friend bool operator==(const Symbol&, const Symbol&) = default;
+
+    // The demangled name of the function, or empty if unknown.
+    std::string function_name;
+    // The source file, line number and column, e.g. "../../base/foo.cc:12,3",
+    // or empty if unknown.
+    std::string source_location;
+  };
+
+  // Receives a Symbol per address, in the order of the addresses.
+  using SymbolizeCallback = OnceCallback<void(std::vector<Symbol>)>;
+
+  Symbolizer();
+  Symbolizer(const Symbolizer&) = delete;
+  Symbolizer& operator=(const Symbolizer&) = delete;
+  ~Symbolizer();
+
+  // Symbolizes `addresses` on the thread pool and runs `callback` on the
+  // current sequence with the results. Batches are symbolized in order.
+  void Symbolize(std::vector<uintptr_t> addresses, SymbolizeCallback callback);
+
+ private:
+  class Core;
+
+  SequenceBound<Core> core_;
+};
+
+}  // namespace debug
+}  // namespace base
+
+#endif  // BASE_DEBUG_SYMBOLIZER_H_
@@ -0,0 +1,71 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/symbolizer.h"
+
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/debug/stack_trace.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_future.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+NOINLINE void SymbolizerTestFunction() {
+  // Prevent the function from being folded with others.
+  static volatile int counter = 0;
+  counter = counter + 1;
+}
+
+uintptr_t GetTestFunctionAddress() {
+  return reinterpret_cast<uintptr_t>(&SymbolizerTestFunction);
+}
+
+}  // namespace
+
+class SymbolizerTest : public testing::Test {
+ protected:
+  std::vector<Symbolizer::Symbol> Symbolize(
+      std::vector<uintptr_t> addresses) {
+    test::TestFuture<std::vector<Symbolizer::Symbol>> future;
+    symbolizer_.Symbolize(std::move(addresses), future.GetCallback());
+    return future.Take();
+  }
+
+  test::TaskEnvironment task_environment_;
+  Symbolizer symbolizer_;
+};
+
+TEST_F(SymbolizerTest, ReturnsSymbolPerAddress) {
+  const uintptr_t address = GetTestFunctionAddress();
+  const std::vector<Symbolizer::Symbol> symbols =
+      Symbolize({address, 0x1, address});
+  ASSERT_EQ(3u, symbols.size());
+  EXPECT_EQ(symbols[0], symbols[2]);
+
+  if (!StackTrace::WillSymbolizeToStreamForTesting()) {
+    return;
+  }
+  EXPECT_THAT(symbols[0].function_name,
+              testing::HasSubstr("SymbolizerTestFunction"));
+}
+
+TEST_F(SymbolizerTest, CachesSymbols) {
+  const uintptr_t address = GetTestFunctionAddress();
+  const std::vector<Symbolizer::Symbol> symbols = Symbolize({address});
+  EXPECT_EQ(symbols, Symbolize({address}));
+  EXPECT_TRUE(Symbolize({}).empty());
+}
+
+}  // namespace debug
+}  // namespace base
@@ -4,10 +4,15 @@
 
 #include "base/environment.h"
 
+#include <algorithm>
 #include <array>
 #include <string_view>
 
+#include "base/compiler_specific.h"
+#include "base/containers/span.h"
 #include "base/memory/ptr_util.h"
+#include "base/no_destructor.h"
+#include "base/ranges/algorithm.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
@@ -18,6 +23,12 @@
 #include <stdlib.h>
 #endif
 
+#if BUILDFLAG(IS_APPLE)
+#include <crt_externs.h>
+#elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+extern char** environ;
+#endif
+
 namespace base {
 
 namespace {
@@ -104,6 +115,62 @@ class EnvironmentImpl : public Environment {
   }
 };
 
+using Var = std::pair<std::string, std::string>;
+
+// How the name being looked up is converted before comparing it with the names
+// of an EnvironmentSnapshot.
+enum class NameCase {
+  kAsIs,
+  kUpper,
+  kLower,
+};
+
+char ConvertCase(char c, NameCase name_case) {
+  switch (name_case) {
+    case NameCase::kAsIs:
+      return c;
+    case NameCase::kUpper:
+      return ToUpperASCII(c);
+    case NameCase::kLower:
+      return ToLowerASCII(c);
+  }
+}
+
+// Compares |name| with |query| converted to |query_case|, in the same order as
+// std::string, without allocating the converted query.
+int CompareName(std::string_view name,
+                std::string_view query,
+                NameCase query_case) {
+  const size_t length = std::min(name.size(), query.size());
+  for (size_t i = 0; i < length; ++i) {
+    const unsigned char name_char = static_cast<unsigned char>(name[i]);
+    const unsigned char query_char =
+        static_cast<unsigned char>(ConvertCase(query[i], query_case));
+    if (name_char != query_char) {
+      return name_char < query_char ? -1 : 1;
+    }
+  }
+  if (name.size() == query.size()) {
+    return 0;
+  }
+  return name.size() < query.size() ? -1 : 1;
+}
+
+// Returns the value of the variable of |vars|, which are sorted by name, whose
+// name is |query| converted to |query_case|.
+std::optional<std::string_view> FindVar(span<const Var> vars,
+                                        std::string_view query,
+                                        NameCase query_case) {
+  const auto it = std::partition_point(
+      vars.begin(), vars.end(), [&](const Var& var) {
+        return CompareName(var.first, query, query_case) < 0;
+      });
+  if (it == vars.end() || CompareName(it->first, query, query_case) != 0) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
 }  // namespace
 
 namespace env_vars {
@@ -127,4 +194,85 @@ bool Environment::HasVar(std::string_view variable_name) {
   return GetVar(variable_name, nullptr);
 }
 
+EnvironmentSnapshot::EnvironmentSnapshot() {
+#if BUILDFLAG(IS_WIN)
+  wchar_t* strings = ::GetEnvironmentStrings();
+  if (strings) {
+    // The block is a sequence of null-terminated "name=value" strings, ended
+    // by an empty string.
+    for (const wchar_t* entry = strings; *entry;
+         UNSAFE_BUFFERS(entry += wcslen(entry) + 1)) {
+      const std::wstring_view entry_view(entry);
+      // Names of variables private to the command shell start with '=', e.g.
+      // "=C:=C:\foo". Like GetEnvironmentVariable(), don't list them.
+      const size_t separator = entry_view.find(L'=', 1);
+      if (separator == std::wstring_view::npos) {
+        continue;
+      }
+      vars_.emplace_back(
+          ToUpperASCII(WideToUTF8(entry_view.substr(0, separator))),
+          WideToUTF8(entry_view.substr(separator + 1)));
+    }
+    ::FreeEnvironmentStrings(strings);
+  }
+#elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+#if BUILDFLAG(IS_APPLE)
+  char** env = *_NSGetEnviron();
+#else
+  char** env = environ;
+#endif
+  for (char** entry = env; entry && *entry; UNSAFE_BUFFERS(++entry)) {
+    const std::string_view entry_view(*entry);
+    const size_t separator = entry_view.find('=');
+    if (separator == std::string_view::npos) {
+      continue;
+    }
+    vars_.emplace_back(entry_view.substr(0, separator),
+                       entry_view.substr(separator + 1));
+  }
+#endif
+
+  // Keep the first of variables with the same name, which is the one that
+  // getenv() returns.
+  ranges::stable_sort(vars_, {}, &Var::first);
+  vars_.erase(ranges::unique(vars_, {}, &Var::first), vars_.end());
+}
+
+EnvironmentSnapshot::~EnvironmentSnapshot() = default;
+
+// static
+const EnvironmentSnapshot& EnvironmentSnapshot::GetInstance() {
+  static NoDestructor<EnvironmentSnapshot> snapshot;
+  return *snapshot;
+}
+
+std::optional<std::string_view> EnvironmentSnapshot::GetVar(
+    std::string_view variable_name) const {
+#if BUILDFLAG(IS_WIN)
+  // Names were converted to upper case when the snapshot was taken.
+  return FindVar(vars_, variable_name, NameCase::kUpper);
+#else
+  if (std::optional<std::string_view> value =
+          FindVar(vars_, variable_name, NameCase::kAsIs)) {
+    return value;
+  }
+  // Look for the name in the reverse case, like EnvironmentImpl::GetVar().
+  if (variable_name.empty()) {
+    return std::nullopt;
+  }
+  const char first_char = variable_name[0];
+  if (IsAsciiLower(first_char)) {
+    return FindVar(vars_, variable_name, NameCase::kUpper);
+  }
+  if (IsAsciiUpper(first_char)) {
+    return FindVar(vars_, variable_name, NameCase::kLower);
+  }
+  return std::nullopt;
+#endif
+}
+
+bool EnvironmentSnapshot::HasVar(std::string_view variable_name) const {
+  return GetVar(variable_name).has_value();
+}
+
 }  // namespace base
@@ -7,8 +7,11 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "base/base_export.h"
 #include "build/build_config.h"
@@ -47,6 +50,41 @@ class BASE_EXPORT Environment {
   virtual bool UnSetVar(std::string_view variable_name) = 0;
 };
 
+// An immutable copy of the environment variables of the process. Unlike
+// Environment::GetVar(), lookups don't call getenv(), so they are safe while
+// another thread calls Environment::SetVar(), and they don't allocate. They
+// don't see the variables which are set or unset after the snapshot is taken
+// though, so this is meant for variables which are fixed once the process has
+// started.
+//
+// Like Environment::GetVar(), lookups fall back to the name in the reverse
+// case, e.g. HTTP_PROXY for http_proxy. On Windows, names are case
+// insensitive.
+class BASE_EXPORT EnvironmentSnapshot {
+ public:
+  // Takes a snapshot of the current environment. Like Environment::SetVar(),
+  // this must not be called while other threads modify the environment.
+  EnvironmentSnapshot();
+  EnvironmentSnapshot(const EnvironmentSnapshot&) = delete;
+  EnvironmentSnapshot& operator=(const EnvironmentSnapshot&) = delete;
+  ~EnvironmentSnapshot();
+
+  // Returns a snapshot of the environment taken by the first call, which
+  // should happen early during startup. It's never destroyed.
+  static const EnvironmentSnapshot& GetInstance();
+
+  // Returns the value of |variable_name|, or nullopt if it was unset. The
+  // value lives as long as the snapshot.
+  std::optional<std::string_view> GetVar(std::string_view variable_name) const;
+
+  bool HasVar(std::string_view variable_name) const;
+
+ private:
+  // Names and values, in UTF-8, sorted by name. On Windows, names are
+  // converted to upper case. Names are unique.
+  std::vector<std::pair<std::string, std::string>> vars_;
+};
+
 #if BUILDFLAG(IS_WIN)
 using NativeEnvironmentString = std::wstring;
 #elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
@@ -5,6 +5,7 @@
 #include "base/environment.h"
 
 #include <memory>
+#include <string>
 
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -99,4 +100,46 @@ TEST_F(EnvironmentTest, UnSetVar) {
   EXPECT_FALSE(env->HasVar(kFooUpper));
 }
 
+TEST_F(EnvironmentTest, Snapshot) {
+  std::unique_ptr<Environment> env(Environment::Create());
+  const char kFooUpper[] = "FOO";
+  const char kFooLower[] = "foo";
+  ASSERT_TRUE(env->SetVar(kFooUpper, "bar"));
+
+  EnvironmentSnapshot snapshot;
+  EXPECT_TRUE(snapshot.HasVar(kValidEnvironmentVariable));
+  std::string env_value;
+  ASSERT_TRUE(env->GetVar(kValidEnvironmentVariable, &env_value));
+  EXPECT_EQ(snapshot.GetVar(kValidEnvironmentVariable), env_value);
+  EXPECT_EQ(snapshot.GetVar(kFooUpper), "bar");
+  // Like Environment::GetVar(), falls back to the reverse case.
+  EXPECT_EQ(snapshot.GetVar(kFooLower), "bar");
+  EXPECT_FALSE(snapshot.GetVar("FOO_NOT_SET"));
+  EXPECT_FALSE(snapshot.GetVar(""));
+
+  // The snapshot doesn't change with the environment.
+  ASSERT_TRUE(env->UnSetVar(kFooUpper));
+  EXPECT_EQ(snapshot.GetVar(kFooUpper), "bar");
+  ASSERT_TRUE(env->SetVar("FOO_SET_LATER", "baz"));
+  EXPECT_FALSE(snapshot.HasVar("FOO_SET_LATER"));
+  EXPECT_TRUE(env->UnSetVar("FOO_SET_LATER"));
+}
+
+#if BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+TEST_F(EnvironmentTest, SnapshotEmptyValue) {
+  std::unique_ptr<Environment> env(Environment::Create());
+  ASSERT_TRUE(env->SetVar("FOO_EMPTY", ""));
+  EnvironmentSnapshot snapshot;
+  EXPECT_EQ(snapshot.GetVar("FOO_EMPTY"), "");
+  EXPECT_TRUE(env->UnSetVar("FOO_EMPTY"));
+}
+#endif
+
+TEST_F(EnvironmentTest, SnapshotGetInstance) {
+  EXPECT_EQ(&EnvironmentSnapshot::GetInstance(),
+            &EnvironmentSnapshot::GetInstance());
+  EXPECT_TRUE(
+      EnvironmentSnapshot::GetInstance().HasVar(kValidEnvironmentVariable));
+}
+
 }  // namespace base
@@ -11,9 +11,12 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "base/base_switches.h"
 #include "base/containers/contains.h"
@@ -31,6 +34,7 @@
 #include "base/notreached.h"
 #include "base/pickle.h"
 #include "base/rand_util.h"
+#include "base/ranges/algorithm.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -389,6 +393,7 @@ void FeatureList::AssociateReportingFieldTrial(
 
   // Only one associated field trial is supported per feature. This is generally
   // enforced server-side.
+  MergePendingOverrides();
   OverrideEntry* entry = &overrides_.find(feature_name)->second;
   if (entry->field_trial) {
     NOTREACHED_IN_MIGRATION()
@@ -408,7 +413,7 @@ void FeatureList::RegisterFieldTrialOverride(const std::string& feature_name,
   DCHECK(!HasAssociatedFieldTrialByFeatureName(feature_name))
       << "Feature " << feature_name << " is overriden multiple times in these "
       << "trials: "
-      << overrides_.find(feature_name)->second.field_trial->trial_name()
+      << GetOverrideEntryByFeatureName(feature_name)->field_trial->trial_name()
       << " and " << field_trial->trial_name() << ". "
       << "Check the trial (study) in (1) the server config, "
       << "(2) fieldtrial_testing_config.json, (3) about_flags.cc, and "
@@ -607,6 +612,8 @@ void FeatureList::SetInstance(std::unique_ptr<FeatureList> instance) {
 
   // Note: Intentional leak of global singleton.
   g_feature_list_instance = instance.release();
+  // The field trials associated with features may have changed.
+  internal::FeatureParamCache::InvalidateAll();
 
   EarlyFeatureAccessTracker::GetInstance()->AssertNoAccess();
 
@@ -656,6 +663,7 @@ void FeatureList::SetEarlyAccessInstance(
 std::unique_ptr<FeatureList> FeatureList::ClearInstanceForTesting() {
   FeatureList* old_instance = g_feature_list_instance;
   g_feature_list_instance = nullptr;
+  internal::FeatureParamCache::InvalidateAll();
   EarlyFeatureAccessTracker::GetInstance()->Reset();
   return WrapUnique(old_instance);
 }
@@ -666,6 +674,7 @@ void FeatureList::RestoreInstanceForTesting(
   DCHECK(!g_feature_list_instance);
   // Note: Intentional leak of global singleton.
   g_feature_list_instance = instance.release();
+  internal::FeatureParamCache::InvalidateAll();
 }
 
 // static
@@ -718,6 +727,7 @@ void FeatureList::VisitFeaturesAndParams(FeatureVisitor& visitor) {
 
 void FeatureList::FinalizeInitialization() {
   DCHECK(!initialized_);
+  MergePendingOverrides();
   // Store the field trial list pointer for DCHECKing.
   field_trial_list_ = FieldTrialList::GetInstance();
   initialized_ = true;
@@ -815,6 +825,14 @@ FeatureList::GetOverrideEntryByFeatureName(std::string_view name) const {
     const OverrideEntry& entry = it->second;
     return &entry;
   }
+  // The pending overrides were registered after the merged ones, so they only
+  // apply to the features without a merged override. Only their first override
+  // takes effect, as in MergePendingOverrides().
+  for (const auto& [feature_name, entry] : pending_overrides_) {
+    if (feature_name == name) {
+      return &entry;
+    }
+  }
   return nullptr;
 }
 
@@ -898,11 +916,48 @@ void FeatureList::RegisterOverride(std::string_view feature_name,
     overridden_state = OVERRIDE_USE_DEFAULT;
   }
 
-  // Note: The semantics of emplace() is that it does not overwrite the entry if
-  // one already exists for the key. Thus, only the first override for a given
-  // feature name takes effect.
-  overrides_.emplace(std::string(feature_name),
-                     OverrideEntry(overridden_state, field_trial));
+  // Only the first override for a given feature name takes effect, which
+  // MergePendingOverrides() preserves. Inserting into `overrides_` here instead
+  // would cost a linear move of the map per override.
+  pending_overrides_.emplace_back(std::string(feature_name),
+                                  OverrideEntry(overridden_state, field_trial));
+}
+
+void FeatureList::MergePendingOverrides() {
+  if (pending_overrides_.empty()) {
+    return;
+  }
+
+  auto by_name = [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  };
+  auto same_name = [](const auto& lhs, const auto& rhs) {
+    return lhs.first == rhs.first;
+  };
+
+  // Keep the first pending override of each feature: the sort is stable, and
+  // std::unique() keeps the first element of each run.
+  ranges::stable_sort(pending_overrides_, by_name);
+  pending_overrides_.erase(std::unique(pending_overrides_.begin(),
+                                       pending_overrides_.end(), same_name),
+                           pending_overrides_.end());
+
+  // Merge the two sorted ranges. The merged overrides are older, so they win
+  // over the pending ones for the same feature.
+  std::vector<std::pair<std::string, OverrideEntry>> merged =
+      std::move(overrides_).extract();
+  const size_t num_merged = merged.size();
+  merged.reserve(num_merged + pending_overrides_.size());
+  for (auto& pending : pending_overrides_) {
+    if (!std::binary_search(merged.begin(), merged.begin() + num_merged,
+                            pending, by_name)) {
+      merged.push_back(std::move(pending));
+    }
+  }
+  std::inplace_merge(merged.begin(), merged.begin() + num_merged, merged.end(),
+                     by_name);
+  overrides_.replace(std::move(merged));
+  pending_overrides_.clear();
 }
 
 void FeatureList::GetFeatureOverridesImpl(std::string* enable_overrides,
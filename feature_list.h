@@ -338,9 +338,8 @@ class BASE_EXPORT FeatureList {
   // Adds extra overrides (not associated with a field trial). Should be called
   // before SetInstance().
   // The ordering of calls with respect to InitFromCommandLine(),
-  // RegisterFieldTrialOverride(), etc. matters. The first call wins out,
-  // because the |overrides_| map uses insert(), which retains the first
-  // inserted entry and does not overwrite it on subsequent calls to insert().
+  // RegisterFieldTrialOverride(), etc. matters. The first call wins out, and
+  // subsequent overrides of the same feature are ignored.
   void RegisterExtraFeatureOverrides(
       const std::vector<FeatureOverrideInfo>& extra_overrides);
 
@@ -613,6 +612,11 @@ class BASE_EXPORT FeatureList {
                         OverrideState overridden_state,
                         FieldTrial* field_trial);
 
+  // Moves |pending_overrides_| into |overrides_| with a single sort and merge,
+  // keeping the first override registered for each feature. Called before
+  // |overrides_| is modified or iterated, and by FinalizeInitialization().
+  void MergePendingOverrides();
+
   // Implementation of GetFeatureOverrides() with a parameter that specifies
   // whether only command-line enabled overrides should be emitted. See that
   // function's comments for more details.
@@ -641,6 +645,13 @@ class BASE_EXPORT FeatureList {
   // exists.
   base::flat_map<std::string, OverrideEntry> overrides_;
 
+  // Overrides registered since the last MergePendingOverrides(), in
+  // registration order. Startup can register thousands of overrides, which
+  // would cost a linear move of |overrides_| each if inserted one at a time.
+  // Lookups fall back to a linear scan of these, which only happens before
+  // initialization is finalized.
+  std::vector<std::pair<std::string, OverrideEntry>> pending_overrides_;
+
   // Locked map that keeps track of seen features, to ensure a single feature is
   // only defined once. This verification is only done in builds with DCHECKs
   // enabled. This is mutable as it's not externally visible and needs to be
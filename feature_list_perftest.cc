@@ -0,0 +1,87 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/feature_list.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "FeatureList.";
+constexpr char kMetricInitTime[] = "init_time";
+constexpr char kMetricLookupTime[] = "time_per_lookup";
+
+constexpr size_t kNumOverrides[] = {100, 1000, 5000};
+constexpr size_t kNumRuns = 20;
+
+// Returns `num_features` feature names, in the shuffled order in which a
+// --enable-features switch lists them.
+std::vector<std::string> MakeFeatureNames(size_t num_features) {
+  std::vector<std::string> names;
+  for (size_t i = 0; i < num_features; ++i) {
+    // A multiplier coprime with `num_features` shuffles the names.
+    names.push_back(StrCat(
+        {"PerfTestFeature", NumberToString((i * 7919) % num_features)}));
+  }
+  return names;
+}
+
+}  // namespace
+
+// Measures the startup cost of a FeatureList with `num_overrides` overrides
+// from the command line, from parsing the switches until it is installed.
+TEST(FeatureListPerfTest, InitFromCommandLine) {
+  for (size_t num_overrides : kNumOverrides) {
+    const std::vector<std::string> names = MakeFeatureNames(num_overrides);
+    const std::vector<std::string> enabled(names.begin(),
+                                           names.begin() + names.size() / 2);
+    const std::vector<std::string> disabled(names.begin() + names.size() / 2,
+                                            names.end());
+    const std::string enable_features = JoinString(enabled, ",");
+    const std::string disable_features = JoinString(disabled, ",");
+
+    TimeDelta init_time;
+    TimeDelta lookup_time;
+    for (size_t run = 0; run < kNumRuns; ++run) {
+      const TimeTicks start = TimeTicks::Now();
+      auto feature_list = std::make_unique<FeatureList>();
+      feature_list->InitFromCommandLine(enable_features, disable_features);
+      test::ScopedFeatureList scoped_feature_list;
+      scoped_feature_list.InitWithFeatureList(std::move(feature_list));
+      const TimeTicks initialized = TimeTicks::Now();
+      init_time += initialized - start;
+
+      for (const std::string& name : names) {
+        CHECK(FeatureList::GetInstance()->IsFeatureOverridden(name));
+      }
+      lookup_time += TimeTicks::Now() - initialized;
+    }
+
+    perf_test::PerfResultReporter reporter(
+        kMetricPrefix, NumberToString(num_overrides) + "_overrides");
+    reporter.RegisterImportantMetric(kMetricInitTime, "us");
+    reporter.RegisterImportantMetric(kMetricLookupTime, "ns");
+    reporter.AddResult(kMetricInitTime, init_time.InMicrosecondsF() / kNumRuns);
+    reporter.AddResult(kMetricLookupTime, lookup_time.InMicrosecondsF() * 1000 /
+                                              (kNumRuns * num_overrides));
+  }
+}
+
+}  // namespace base
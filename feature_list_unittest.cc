@@ -509,6 +509,42 @@ TEST_F(FeatureListTest, InitFromCommandLineThenRegisterExtraOverrides) {
   EXPECT_EQ(kFeatureOffByDefaultName, SortFeatureListString(disable_features));
 }
 
+// Overrides are merged into the map of the FeatureList in batches. The first
+// override of a feature wins whether or not it was merged already.
+TEST_F(FeatureListTest, FirstOverrideWinsAcrossMerges) {
+  test::ScopedFeatureList outer_scope;
+  outer_scope.InitWithEmptyFeatureAndFieldTrialLists();
+
+  auto feature_list = std::make_unique<FeatureList>();
+  feature_list->InitFromCommandLine("", kFeatureOnByDefaultName);
+  // Merges the overrides of the command line.
+  FieldTrial* trial =
+      FieldTrialList::CreateFieldTrial("ReportingTrial", "Group");
+  feature_list->AssociateReportingFieldTrial(
+      kFeatureOnByDefaultName, FeatureList::OVERRIDE_DISABLE_FEATURE, trial);
+
+  std::vector<FeatureList::FeatureOverrideInfo> overrides;
+  overrides.push_back({std::cref(kFeatureOffByDefault),
+                       FeatureList::OverrideState::OVERRIDE_ENABLE_FEATURE});
+  overrides.push_back({std::cref(kFeatureOnByDefault),
+                       FeatureList::OverrideState::OVERRIDE_ENABLE_FEATURE});
+  overrides.push_back({std::cref(kFeatureOffByDefault),
+                       FeatureList::OverrideState::OVERRIDE_DISABLE_FEATURE});
+  feature_list->RegisterExtraFeatureOverrides(std::move(overrides));
+
+  // Lookups see the pending overrides too.
+  EXPECT_TRUE(feature_list->IsFeatureOverriddenFromCommandLine(
+      kFeatureOnByDefaultName, FeatureList::OVERRIDE_DISABLE_FEATURE));
+  EXPECT_TRUE(feature_list->IsFeatureOverridden(kFeatureOffByDefaultName));
+
+  test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitWithFeatureList(std::move(feature_list));
+
+  EXPECT_FALSE(FeatureList::IsEnabled(kFeatureOnByDefault));
+  EXPECT_TRUE(FeatureList::IsEnabled(kFeatureOffByDefault));
+  EXPECT_EQ(trial, FeatureList::GetFieldTrial(kFeatureOnByDefault));
+}
+
 TEST_F(FeatureListTest, GetFeatureOverrides) {
   auto feature_list = std::make_unique<FeatureList>();
   feature_list->InitFromCommandLine("A,X", "D");
@@ -5,6 +5,7 @@
 #include "base/features.h"
 
 #include "base/cpu_reduction_experiment.h"
+#include "base/functional/callback_internal.h"
 #include "base/task/sequence_manager/sequence_manager_impl.h"
 #include "base/threading/platform_thread.h"
 #include "build/buildflag.h"
@@ -52,6 +53,12 @@ BASE_FEATURE(kNotReachedIsFatal,
 // Optimizes parsing and loading of data: URLs.
 BASE_FEATURE(kOptimizeDataUrls, "OptimizeDataUrls", FEATURE_ENABLED_BY_DEFAULT);
 
+// Recycles the memory of small bind states with per-thread caches, instead of
+// allocating it for each callback.
+BASE_FEATURE(kRecycleBindStateMemory,
+             "RecycleBindStateMemory",
+             FEATURE_DISABLED_BY_DEFAULT);
+
 BASE_FEATURE(kUseRustJsonParser,
              "UseRustJsonParser",
              FEATURE_DISABLED_BY_DEFAULT);
@@ -94,6 +101,7 @@ BASE_FEATURE(kCollectAndroidFrameTimelineMetrics,
 void Init(EmitThreadControllerProfilerMetadata
               emit_thread_controller_profiler_metadata) {
   InitializeCpuReductionExperiment();
+  internal::BindStateBase::InitializeFeatures();
   sequence_manager::internal::SequenceManagerImpl::InitializeFeatures();
   sequence_manager::internal::ThreadController::InitializeFeatures(
       emit_thread_controller_profiler_metadata);
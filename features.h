@@ -21,6 +21,8 @@ BASE_EXPORT BASE_DECLARE_FEATURE(kNotReachedIsFatal);
 
 BASE_EXPORT BASE_DECLARE_FEATURE(kOptimizeDataUrls);
 
+BASE_EXPORT BASE_DECLARE_FEATURE(kRecycleBindStateMemory);
+
 BASE_EXPORT BASE_DECLARE_FEATURE(kUseRustJsonParser);
 
 BASE_EXPORT BASE_DECLARE_FEATURE(kJsonNegativeZero);
@@ -4,13 +4,16 @@
 
 #include "base/files/file.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/files/file_path.h"
 #include "base/files/file_tracing.h"
 #include "base/metrics/histogram.h"
 #include "base/notreached.h"
+#include "base/numerics/clamped_math.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/timer/elapsed_timer.h"
 #include "base/trace_event/base_tracing.h"
@@ -159,6 +162,35 @@ bool File::WriteAtCurrentPosAndCheck(span<const uint8_t> data) {
   return WriteAtCurrentPos(data) == static_cast<int>(data.size());
 }
 
+bool File::ReadMany(span<const ReadRequest> requests, span<size_t> bytes_read) {
+  CHECK_EQ(requests.size(), bytes_read.size());
+  std::vector<span<uint8_t>> buffers;
+  size_t begin = 0;
+  while (begin < requests.size()) {
+    // Finds the run of requests which continue each other in the file.
+    size_t end = begin;
+    int64_t next_offset = requests[begin].offset;
+    buffers.clear();
+    while (end < requests.size() && requests[end].offset == next_offset) {
+      buffers.push_back(requests[end].data);
+      next_offset = ClampAdd(next_offset, requests[end].data.size());
+      ++end;
+    }
+
+    std::optional<size_t> result = ReadV(requests[begin].offset, buffers);
+    if (!result) {
+      return false;
+    }
+    size_t remaining = *result;
+    for (size_t i = begin; i < end; ++i) {
+      bytes_read[i] = std::min(remaining, requests[i].data.size());
+      remaining -= bytes_read[i];
+    }
+    begin = end;
+  }
+  return true;
+}
+
 // static
 std::string File::ErrorToString(Error error) {
   switch (error) {
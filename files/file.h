@@ -5,6 +5,7 @@
 #ifndef BASE_FILES_FILE_H_
 #define BASE_FILES_FILE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <optional>
@@ -15,6 +16,7 @@
 #include "base/files/file_path.h"
 #include "base/files/file_tracing.h"
 #include "base/files/platform_file.h"
+#include "base/memory/raw_span.h"
 #include "base/time/time.h"
 #include "base/trace_event/base_tracing_forward.h"
 #include "build/build_config.h"
@@ -76,8 +78,16 @@ class BASE_EXPORT File {
         1 << 21,  // Windows only. Marks the file with a deny ACE that prevents
                   // opening the file with EXECUTE access. Cannot be used with
                   // FILE_WIN_EXECUTE flag. See also PreventExecuteMapping.
+    FLAG_DIRECT = 1 << 22,  // Bypasses the page cache, where supported. The
+                            // offsets, sizes and buffers of reads and writes
+                            // must then be aligned, see kDirectIOAlignment.
   };
 
+  // The alignment of the offsets, sizes and buffers of reads and writes of
+  // files opened with FLAG_DIRECT. This is the largest logical block size of
+  // common storage devices: smaller ones divide it.
+  static constexpr size_t kDirectIOAlignment = 4096;
+
   // This enum has been recorded in multiple histograms using PlatformFileError
   // enum. If the order of the fields needs to change, please ensure that those
   // histograms are obsolete or have been moved to a different enum.
@@ -252,6 +262,35 @@ class BASE_EXPORT File {
   // platforms. Returns the number of bytes written, or -1 on error.
   int WriteAtCurrentPosNoBestEffort(const char* data, int size);
 
+  // Reads into `buffers` in order, as if they were one buffer, starting at
+  // `offset`, until they are all full or EOF is reached. Returns the number of
+  // bytes read, or std::nullopt on error. Like Read(), this makes a best effort
+  // to read all data. On Linux, ChromeOS and Android this takes one preadv()
+  // for up to IOV_MAX buffers; elsewhere it reads each buffer in turn.
+  std::optional<size_t> ReadV(int64_t offset,
+                              span<const span<uint8_t>> buffers);
+
+  // Writes `buffers` in order, as if they were one buffer, at `offset`.
+  // Returns the number of bytes written, or std::nullopt on error. Like
+  // Write(), this makes a best effort to write all data, and ignores the
+  // offset if the file was opened with FLAG_APPEND.
+  std::optional<size_t> WriteV(int64_t offset,
+                               span<const span<const uint8_t>> buffers);
+
+  // A read of `data.size()` bytes at `offset`, for ReadMany().
+  struct ReadRequest {
+    int64_t offset;
+    raw_span<uint8_t> data;
+  };
+
+  // Performs `requests`, setting each element of `bytes_read`, which must be
+  // the same size, to how many bytes its request read. That is less than
+  // requested only at EOF. Consecutive requests whose ranges are adjacent in
+  // the file take a single ReadV(), so sorting the requests by offset saves
+  // calls when their ranges touch. Returns false if a read failed; the
+  // requests after it are not performed.
+  bool ReadMany(span<const ReadRequest> requests, span<size_t> bytes_read);
+
   // Returns the current size of this file, or a negative number on failure.
   int64_t GetLength() const;
 
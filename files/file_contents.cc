@@ -0,0 +1,62 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/file_contents.h"
+
+#include <limits>
+#include <utility>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/threading/scoped_blocking_call.h"
+
+namespace base {
+
+FileContents::FileContents(std::string data) : data_(std::move(data)) {}
+
+FileContents::FileContents(std::unique_ptr<MemoryMappedFile> mapped_file)
+    : mapped_file_(std::move(mapped_file)) {}
+
+FileContents::FileContents(FileContents&&) = default;
+FileContents& FileContents::operator=(FileContents&&) = default;
+FileContents::~FileContents() = default;
+
+// static
+std::optional<FileContents> FileContents::Read(const FilePath& path,
+                                               size_t map_threshold) {
+  if (path.ReferencesParent()) {
+    return std::nullopt;
+  }
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  File file(path, File::FLAG_OPEN | File::FLAG_READ);
+  if (!file.IsValid()) {
+    return std::nullopt;
+  }
+
+  // Files of unknown size, such as proc files, report a size of 0, and are
+  // read.
+  const int64_t length = file.GetLength();
+  if (length > 0 && static_cast<uint64_t>(length) >= map_threshold) {
+    auto mapped_file = std::make_unique<MemoryMappedFile>();
+    if (!mapped_file->Initialize(std::move(file))) {
+      return std::nullopt;
+    }
+    return FileContents(std::move(mapped_file));
+  }
+
+  std::string data;
+  if (!ReadFileToStringWithMaxSize(file, &data,
+                                   std::numeric_limits<size_t>::max())) {
+    return std::nullopt;
+  }
+  return FileContents(std::move(data));
+}
+
+span<const uint8_t> FileContents::bytes() const {
+  return mapped_file_ ? mapped_file_->bytes() : as_byte_span(data_);
+}
+
+}  // namespace base
@@ -0,0 +1,67 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_FILE_CONTENTS_H_
+#define BASE_FILES_FILE_CONTENTS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+
+namespace base {
+
+class FilePath;
+class MemoryMappedFile;
+
+// The read-only contents of a file, read into memory or, for a large file,
+// mapped, so that reading it costs neither a copy nor its size in private
+// memory. Prefer this over ReadFileToString() to read a file which may be
+// large, and which is only looked at.
+//
+// A mapped file must not be truncated while it is mapped: accessing the pages
+// past its new end crashes. Only read files this way, such as resources,
+// which the program doesn't modify in place.
+class BASE_EXPORT FileContents {
+ public:
+  // The size from which Read() maps files by default. Below this size, the
+  // cost of mapping and faulting in the pages outweighs that of the copy.
+  static constexpr size_t kDefaultMapThreshold = 1024 * 1024;
+
+  FileContents(FileContents&&);
+  FileContents& operator=(FileContents&&);
+  ~FileContents();
+
+  // Reads the file at `path`, or maps it if its size is at least
+  // `map_threshold`, and returns its contents, or nullopt if it can't be
+  // read. As with ReadFileToString(), a `path` containing path traversal
+  // components ('..') is treated as a read error. Blocks.
+  static std::optional<FileContents> Read(
+      const FilePath& path,
+      size_t map_threshold = kDefaultMapThreshold);
+
+  span<const uint8_t> bytes() const;
+  std::string_view AsStringView() const { return as_string_view(bytes()); }
+
+  // Whether the contents are mapped rather than read.
+  bool is_mapped() const { return !!mapped_file_; }
+
+ private:
+  explicit FileContents(std::string data);
+  explicit FileContents(std::unique_ptr<MemoryMappedFile> mapped_file);
+
+  // The contents, unless they are mapped.
+  std::string data_;
+  std::unique_ptr<MemoryMappedFile> mapped_file_;
+};
+
+}  // namespace base
+
+#endif  // BASE_FILES_FILE_CONTENTS_H_
@@ -0,0 +1,69 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/file_contents.h"
+
+#include <optional>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class FileContentsTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("file");
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+};
+
+TEST_F(FileContentsTest, SmallFileIsRead) {
+  ASSERT_TRUE(WriteFile(path_, "contents"));
+  std::optional<FileContents> contents = FileContents::Read(path_);
+  ASSERT_TRUE(contents);
+  EXPECT_FALSE(contents->is_mapped());
+  EXPECT_EQ("contents", contents->AsStringView());
+}
+
+TEST_F(FileContentsTest, LargeFileIsMapped) {
+  const std::string data(4096, 'x');
+  ASSERT_TRUE(WriteFile(path_, data));
+  std::optional<FileContents> contents =
+      FileContents::Read(path_, /*map_threshold=*/data.size());
+  ASSERT_TRUE(contents);
+  EXPECT_TRUE(contents->is_mapped());
+  EXPECT_EQ(data, contents->AsStringView());
+
+  // The mapping outlives moves.
+  FileContents moved = std::move(*contents);
+  EXPECT_EQ(data, moved.AsStringView());
+}
+
+TEST_F(FileContentsTest, EmptyFile) {
+  ASSERT_TRUE(WriteFile(path_, ""));
+  std::optional<FileContents> contents =
+      FileContents::Read(path_, /*map_threshold=*/0);
+  ASSERT_TRUE(contents);
+  EXPECT_FALSE(contents->is_mapped());
+  EXPECT_TRUE(contents->bytes().empty());
+}
+
+TEST_F(FileContentsTest, Failures) {
+  EXPECT_FALSE(FileContents::Read(path_));
+  ASSERT_TRUE(WriteFile(path_, "contents"));
+  const FilePath dangerous_path = temp_dir_.GetPath()
+                                     .AppendASCII("..")
+                                     .Append(temp_dir_.GetPath().BaseName())
+                                     .AppendASCII("file");
+  EXPECT_FALSE(FileContents::Read(dangerous_path));
+}
+
+}  // namespace base
@@ -180,6 +180,8 @@ FilePath FileEnumerator::Next() {
 #endif  // BUILDFLAG(IS_FUCHSIA)
 
     current_directory_entry_ = 0;
+    // Reused across the entries, so that its buffer is only allocated once.
+    FilePath full_path;
     struct dirent* dent;
     // NOTE: Per the readdir() documentation, when the end of the directory is
     // reached with no errors, null is returned and errno is not changed.
@@ -214,7 +216,8 @@ FilePath FileEnumerator::Next() {
         continue;
       }
 
-      const FilePath full_path = root_path_.Append(info.filename_);
+      full_path = root_path_;
+      full_path.AppendInPlace(info.filename_);
       GetStat(full_path, ShouldShowSymLinks(file_type_), &info.stat_);
 
       const bool is_dir = info.IsDirectory();
@@ -0,0 +1,183 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/file_operation_batch.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/containers/heap_array.h"
+#include "base/containers/span.h"
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/memory/raw_ptr.h"
+#include "base/numerics/checked_math.h"
+#include "base/task/task_runner.h"
+
+namespace base {
+
+struct FileOperationBatch::Operation {
+  enum class Type { kRead, kWrite, kFlush };
+
+  Type type;
+  raw_ptr<File> file;
+  int64_t offset = 0;
+  // The size requested or to write.
+  size_t size = 0;
+  // Where the data is in `Batch::read_data` or `Batch::write_data`.
+  size_t data_offset = 0;
+
+  ReadCallback read_callback;
+  WriteCallback write_callback;
+  StatusCallback status_callback;
+
+  // The results, set on the TaskRunner.
+  File::Error error = File::FILE_ERROR_FAILED;
+  size_t bytes_done = 0;
+};
+
+struct FileOperationBatch::Batch {
+  std::vector<Operation> operations;
+  // The data of all writes, and the total size of all reads.
+  std::vector<uint8_t> write_data;
+  size_t read_size = 0;
+  // Allocated on the TaskRunner, to hold the data of all reads.
+  HeapArray<uint8_t> read_data;
+};
+
+FileOperationBatch::FileOperationBatch(scoped_refptr<TaskRunner> task_runner)
+    : task_runner_(std::move(task_runner)) {
+  DCHECK(task_runner_);
+}
+
+FileOperationBatch::~FileOperationBatch() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void FileOperationBatch::Read(File& file,
+                              int64_t offset,
+                              size_t size,
+                              ReadCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(callback);
+  if (!batch_) {
+    batch_ = std::make_unique<Batch>();
+  }
+  Operation& op = batch_->operations.emplace_back();
+  op.type = Operation::Type::kRead;
+  op.file = &file;
+  op.offset = offset;
+  op.size = size;
+  op.data_offset = batch_->read_size;
+  op.read_callback = std::move(callback);
+  batch_->read_size = CheckAdd(batch_->read_size, size).ValueOrDie();
+}
+
+void FileOperationBatch::Write(File& file,
+                               int64_t offset,
+                               span<const uint8_t> data,
+                               WriteCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!batch_) {
+    batch_ = std::make_unique<Batch>();
+  }
+  Operation& op = batch_->operations.emplace_back();
+  op.type = Operation::Type::kWrite;
+  op.file = &file;
+  op.offset = offset;
+  op.size = data.size();
+  op.data_offset = batch_->write_data.size();
+  op.write_callback = std::move(callback);
+  batch_->write_data.insert(batch_->write_data.end(), data.begin(),
+                            data.end());
+}
+
+void FileOperationBatch::Flush(File& file, StatusCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!batch_) {
+    batch_ = std::make_unique<Batch>();
+  }
+  Operation& op = batch_->operations.emplace_back();
+  op.type = Operation::Type::kFlush;
+  op.file = &file;
+  op.status_callback = std::move(callback);
+}
+
+size_t FileOperationBatch::pending_operations() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return batch_ ? batch_->operations.size() : 0;
+}
+
+bool FileOperationBatch::Submit() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!batch_) {
+    return true;
+  }
+  return task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE, BindOnce(&RunBatch, std::move(batch_)),
+      BindOnce(&CompleteBatch));
+}
+
+// static
+std::unique_ptr<FileOperationBatch::Batch> FileOperationBatch::RunBatch(
+    std::unique_ptr<Batch> batch) {
+  batch->read_data = HeapArray<uint8_t>::Uninit(batch->read_size);
+  for (Operation& op : batch->operations) {
+    if (!op.file->IsValid()) {
+      op.error = File::FILE_ERROR_INVALID_OPERATION;
+      continue;
+    }
+    std::optional<size_t> result;
+    switch (op.type) {
+      case Operation::Type::kRead:
+        result = op.file->Read(
+            op.offset, batch->read_data.subspan(op.data_offset, op.size));
+        break;
+      case Operation::Type::kWrite:
+        result = op.file->Write(op.offset, span(batch->write_data)
+                                               .subspan(op.data_offset,
+                                                        op.size));
+        break;
+      case Operation::Type::kFlush:
+        if (op.file->Flush()) {
+          result = 0;
+        }
+        break;
+    }
+    if (result) {
+      op.error = File::FILE_OK;
+      op.bytes_done = *result;
+    } else {
+      op.error = File::GetLastFileError();
+    }
+  }
+  return batch;
+}
+
+// static
+void FileOperationBatch::CompleteBatch(std::unique_ptr<Batch> batch) {
+  for (Operation& op : batch->operations) {
+    switch (op.type) {
+      case Operation::Type::kRead:
+        std::move(op.read_callback)
+            .Run(op.error,
+                 batch->read_data.subspan(op.data_offset, op.bytes_done));
+        break;
+      case Operation::Type::kWrite:
+        if (op.write_callback) {
+          std::move(op.write_callback).Run(op.error, op.bytes_done);
+        }
+        break;
+      case Operation::Type::kFlush:
+        if (op.status_callback) {
+          std::move(op.status_callback).Run(op.error);
+        }
+        break;
+    }
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,95 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_FILE_OPERATION_BATCH_H_
+#define BASE_FILES_FILE_OPERATION_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/functional/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequence_checker.h"
+
+namespace base {
+
+class TaskRunner;
+
+// Runs reads, writes and flushes of open Files in batches. The operations
+// queued between two calls to Submit() run in order in a single task on a
+// TaskRunner, and their callbacks then run in order in a single reply on the
+// sequence which submitted them. For many small operations, this replaces the
+// two task hops per operation of FileProxy with two per batch.
+//
+//   base::FileOperationBatch batch(base::ThreadPool::CreateSequencedTaskRunner(
+//       {base::MayBlock(), base::TaskPriority::USER_VISIBLE}));
+//   for (const Record& record : records) {
+//     batch.Read(file, record.offset, record.size,
+//                base::BindOnce(&Store::OnRead, weak_factory_.GetWeakPtr()));
+//   }
+//   batch.Submit();
+//
+// The Files must stay open, and must not be used otherwise, until the
+// callbacks of all their submitted operations have run. Flush() applies to the
+// writes before it in its batch. Callbacks run even if the FileOperationBatch
+// has been destroyed by then.
+class BASE_EXPORT FileOperationBatch {
+ public:
+  // `data` is only valid during the call. It is shorter than requested at the
+  // end of the file.
+  using ReadCallback =
+      OnceCallback<void(File::Error error, span<const uint8_t> data)>;
+  using WriteCallback =
+      OnceCallback<void(File::Error error, size_t bytes_written)>;
+  using StatusCallback = OnceCallback<void(File::Error error)>;
+
+  // `task_runner` must allow blocking.
+  explicit FileOperationBatch(scoped_refptr<TaskRunner> task_runner);
+  FileOperationBatch(const FileOperationBatch&) = delete;
+  FileOperationBatch& operator=(const FileOperationBatch&) = delete;
+  ~FileOperationBatch();
+
+  // Queues a read of up to `size` bytes at `offset` in `file`.
+  void Read(File& file, int64_t offset, size_t size, ReadCallback callback);
+
+  // Queues a write of `data`, which is copied, at `offset` in `file`. The
+  // callback can be null.
+  void Write(File& file,
+             int64_t offset,
+             span<const uint8_t> data,
+             WriteCallback callback);
+
+  // Queues a File::Flush() of `file`. The callback can be null.
+  void Flush(File& file, StatusCallback callback);
+
+  // Returns how many operations are queued for the next Submit().
+  size_t pending_operations() const;
+
+  // Posts the queued operations as one task. Returns false, dropping them and
+  // their callbacks, if posting to the TaskRunner failed.
+  bool Submit();
+
+ private:
+  struct Operation;
+  struct Batch;
+
+  // Runs the operations of `batch` on the TaskRunner.
+  static std::unique_ptr<Batch> RunBatch(std::unique_ptr<Batch> batch);
+  // Runs the callbacks of `batch` on the sequence which submitted it.
+  static void CompleteBatch(std::unique_ptr<Batch> batch);
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  const scoped_refptr<TaskRunner> task_runner_;
+  std::unique_ptr<Batch> batch_ GUARDED_BY_CONTEXT(sequence_checker_);
+};
+
+}  // namespace base
+
+#endif  // BASE_FILES_FILE_OPERATION_BATCH_H_
@@ -0,0 +1,155 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/file_operation_batch.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/functional/bind.h"
+#include "base/run_loop.h"
+#include "base/task/thread_pool.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class FileOperationBatchTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(dir_.CreateUniqueTempDir());
+    path_ = dir_.GetPath().AppendASCII("test");
+    file_ = File(path_, File::FLAG_CREATE_ALWAYS | File::FLAG_READ |
+                            File::FLAG_WRITE);
+    ASSERT_TRUE(file_.IsValid());
+  }
+
+  void TearDown() override { file_.Close(); }
+
+ protected:
+  // Submits the queued operations of `batch`, and waits for their callbacks.
+  void SubmitAndWait(FileOperationBatch& batch) {
+    ASSERT_TRUE(batch.Submit());
+    task_environment_.RunUntilIdle();
+  }
+
+  test::TaskEnvironment task_environment_;
+  ScopedTempDir dir_;
+  FilePath path_;
+  File file_;
+  FileOperationBatch batch_{ThreadPool::CreateSequencedTaskRunner(
+      {MayBlock()})};
+};
+
+TEST_F(FileOperationBatchTest, WriteThenRead) {
+  std::vector<std::string> events;
+  batch_.Write(file_, 0, as_byte_span(std::string_view("0123456789")),
+               BindOnce(
+                   [](std::vector<std::string>* events, File::Error error,
+                      size_t bytes_written) {
+                     EXPECT_EQ(File::FILE_OK, error);
+                     EXPECT_EQ(10u, bytes_written);
+                     events->push_back("write");
+                   },
+                   &events));
+  batch_.Flush(file_, BindOnce(
+                          [](std::vector<std::string>* events,
+                             File::Error error) {
+                            EXPECT_EQ(File::FILE_OK, error);
+                            events->push_back("flush");
+                          },
+                          &events));
+  // The reads see the write before them in the same batch.
+  for (int64_t offset : {6, 2, 8}) {
+    batch_.Read(file_, offset, 4,
+                BindOnce(
+                    [](std::vector<std::string>* events, File::Error error,
+                       span<const uint8_t> data) {
+                      EXPECT_EQ(File::FILE_OK, error);
+                      events->emplace_back(data.begin(), data.end());
+                    },
+                    &events));
+  }
+  EXPECT_EQ(5u, batch_.pending_operations());
+
+  SubmitAndWait(batch_);
+  EXPECT_EQ(0u, batch_.pending_operations());
+  // The read at 8 stops at the end of the file.
+  EXPECT_EQ((std::vector<std::string>{"write", "flush", "6789", "2345", "89"}),
+            events);
+}
+
+TEST_F(FileOperationBatchTest, SeveralBatches) {
+  std::string contents;
+  for (int i = 0; i < 4; ++i) {
+    const std::string chunk(100, static_cast<char>('a' + i));
+    batch_.Write(file_, i * 100, as_byte_span(chunk), {});
+    contents += chunk;
+    // Submitting the next batch before the previous one's callbacks have run
+    // keeps them in order, as the TaskRunner is sequenced.
+    ASSERT_TRUE(batch_.Submit());
+  }
+
+  std::string read;
+  batch_.Read(file_, 0, 1000,
+              BindOnce(
+                  [](std::string* read, File::Error error,
+                     span<const uint8_t> data) {
+                    EXPECT_EQ(File::FILE_OK, error);
+                    read->assign(data.begin(), data.end());
+                  },
+                  &read));
+  SubmitAndWait(batch_);
+  EXPECT_EQ(contents, read);
+
+  std::string on_disk;
+  ASSERT_TRUE(ReadFileToString(path_, &on_disk));
+  EXPECT_EQ(contents, on_disk);
+}
+
+TEST_F(FileOperationBatchTest, Errors) {
+  File read_only(path_, File::FLAG_OPEN | File::FLAG_READ);
+  ASSERT_TRUE(read_only.IsValid());
+  File invalid;
+
+  File::Error write_error = File::FILE_OK;
+  File::Error read_error = File::FILE_OK;
+  bool read_ok = false;
+  batch_.Write(read_only, 0, as_byte_span(std::string_view("x")),
+               BindOnce([](File::Error* out, File::Error error,
+                           size_t) { *out = error; },
+                        &write_error));
+  batch_.Read(invalid, 0, 1,
+              BindOnce([](File::Error* out, File::Error error,
+                          span<const uint8_t>) { *out = error; },
+                       &read_error));
+  // A failed operation does not affect the others.
+  batch_.Read(file_, 0, 1,
+              BindOnce(
+                  [](bool* out, File::Error error, span<const uint8_t> data) {
+                    *out = error == File::FILE_OK && data.empty();
+                  },
+                  &read_ok));
+  SubmitAndWait(batch_);
+
+  EXPECT_NE(File::FILE_OK, write_error);
+  EXPECT_EQ(File::FILE_ERROR_INVALID_OPERATION, read_error);
+  EXPECT_TRUE(read_ok);
+  read_only.Close();
+}
+
+TEST_F(FileOperationBatchTest, SubmitEmpty) {
+  EXPECT_EQ(0u, batch_.pending_operations());
+  EXPECT_TRUE(batch_.Submit());
+}
+
+}  // namespace base
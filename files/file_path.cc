@@ -106,7 +106,7 @@ bool IsPathAbsolute(StringPieceType path) {
 #endif  // FILE_PATH_USES_DRIVE_LETTERS
 }
 
-bool AreAllSeparators(const StringType& input) {
+bool AreAllSeparators(StringPieceType input) {
   for (auto it : input) {
     if (!FilePath::IsSeparator(it))
       return false;
@@ -118,7 +118,7 @@ bool AreAllSeparators(const StringType& input) {
 // Find the position of the '.' that separates the extension from the rest
 // of the file name. The position is relative to BaseName(), not value().
 // Returns npos if it can't find an extension.
-StringType::size_type FinalExtensionSeparatorPosition(const StringType& path) {
+StringType::size_type FinalExtensionSeparatorPosition(StringPieceType path) {
   // Special case "." and ".."
   if (path == FilePath::kCurrentDirectory || path == FilePath::kParentDirectory)
     return StringType::npos;
@@ -130,7 +130,7 @@ StringType::size_type FinalExtensionSeparatorPosition(const StringType& path) {
 // characters when the rightmost extension component is a common double
 // extension (gz, bz2, Z).  For example, foo.tar.gz or foo.tar.Z would have
 // extension components of '.tar.gz' and '.tar.Z' respectively.
-StringType::size_type ExtensionSeparatorPosition(const StringType& path) {
+StringType::size_type ExtensionSeparatorPosition(StringPieceType path) {
   const StringType::size_type last_dot = FinalExtensionSeparatorPosition(path);
 
   // No extension, or the extension is the whole filename.
@@ -150,12 +150,11 @@ StringType::size_type ExtensionSeparatorPosition(const StringType& path) {
   }
 
   for (auto* i : kCommonDoubleExtensions) {
-    StringType extension(path, penultimate_dot + 1);
-    if (EqualsCaseInsensitiveASCII(extension, i))
+    if (EqualsCaseInsensitiveASCII(path.substr(penultimate_dot + 1), i))
       return penultimate_dot;
   }
 
-  StringType extension(path, last_dot + 1);
+  const StringPieceType extension = path.substr(last_dot + 1);
   for (auto* i : kCommonDoubleExtensionSuffixes) {
     if (EqualsCaseInsensitiveASCII(extension, i)) {
       if ((last_dot - penultimate_dot) <= 5U &&
@@ -168,6 +167,31 @@ StringType::size_type ExtensionSeparatorPosition(const StringType& path) {
   return last_dot;
 }
 
+// Returns the length of |path| without its trailing separators, as stripped by
+// FilePath::StripTrailingSeparatorsInternal().
+StringPieceType::size_type StripTrailingSeparatorsLength(StringPieceType path) {
+  // If there is no drive letter, start will be 1, which will prevent stripping
+  // the leading separator if there is only one separator.  If there is a drive
+  // letter, start will be set appropriately to prevent stripping the first
+  // separator following the drive letter, if a separator immediately follows
+  // the drive letter.
+  StringPieceType::size_type start = FindDriveLetter(path) + 2;
+
+  StringPieceType::size_type length = path.length();
+  StringPieceType::size_type last_stripped = StringPieceType::npos;
+  for (StringPieceType::size_type pos = path.length();
+       pos > start && FilePath::IsSeparator(path[pos - 1]); --pos) {
+    // If the string only has two separators and they're at the beginning,
+    // don't strip them, unless the string began with more than two separators.
+    if (pos != start + 1 || last_stripped == start + 2 ||
+        !FilePath::IsSeparator(path[start - 1])) {
+      length = pos - 1;
+      last_stripped = pos;
+    }
+  }
+  return length;
+}
+
 // Returns true if path is "", ".", or "..".
 bool IsEmptyOrSpecialCase(const StringType& path) {
   // Special cases "", ".", and ".."
@@ -230,34 +254,9 @@ bool FilePath::IsSeparator(CharType character) {
 }
 
 std::vector<FilePath::StringType> FilePath::GetComponents() const {
-  std::vector<StringType> ret_val;
-  if (value().empty())
-    return ret_val;
-
-  FilePath current = *this;
-  FilePath base;
-
-  // Capture path components.
-  while (current != current.DirName()) {
-    base = current.BaseName();
-    if (!AreAllSeparators(base.value()))
-      ret_val.push_back(base.value());
-    current = current.DirName();
-  }
-
-  // Capture root, if any.
-  base = current.BaseName();
-  if (!base.value().empty() && base.value() != kCurrentDirectory)
-    ret_val.push_back(current.BaseName().value());
-
-  // Capture drive letter, if any.
-  FilePath dir = current.DirName();
-  StringType::size_type letter = FindDriveLetter(dir.value());
-  if (letter != StringType::npos)
-    ret_val.emplace_back(dir.value(), 0, letter + 1);
-
-  ranges::reverse(ret_val);
-  return ret_val;
+  std::vector<StringPieceType> components;
+  FilePathView(*this).GetComponents(&components);
+  return std::vector<StringType>(components.begin(), components.end());
 }
 
 bool FilePath::IsParent(const FilePath& child) const {
@@ -321,94 +320,19 @@ bool FilePath::AppendRelativePath(const FilePath& child,
 // differently in this regard on different platforms.  Don't use them, but
 // adhere to their behavior.
 FilePath FilePath::DirName() const {
-  FilePath new_path(path_);
-  new_path.StripTrailingSeparatorsInternal();
-
-  // The drive letter, if any, always needs to remain in the output.  If there
-  // is no drive letter, as will always be the case on platforms which do not
-  // support drive letters, letter will be npos, or -1, so the comparisons and
-  // resizes below using letter will still be valid.
-  StringType::size_type letter = FindDriveLetter(new_path.path_);
-
-  StringType::size_type last_separator =
-      new_path.path_.find_last_of(kSeparators, StringType::npos,
-                                  kSeparatorsLength - 1);
-  if (last_separator == StringType::npos) {
-    // path_ is in the current directory.
-    new_path.path_.resize(letter + 1);
-  } else if (last_separator == letter + 1) {
-    // path_ is in the root directory.
-    new_path.path_.resize(letter + 2);
-  } else if (last_separator == letter + 2 &&
-             IsSeparator(new_path.path_[letter + 1])) {
-    // path_ is in "//" (possibly with a drive letter); leave the double
-    // separator intact indicating alternate root.
-    new_path.path_.resize(letter + 3);
-  } else if (last_separator != 0) {
-    bool trim_to_basename = true;
-#if BUILDFLAG(IS_POSIX)
-    // On Posix, more than two leading separators are always collapsed to one.
-    // See
-    // https://pubs.opengroup.org/onlinepubs/9699919799/basedefs/V1_chap04.html#tag_04_13
-    // So, do not strip any of the separators, let
-    // StripTrailingSeparatorsInternal() take care of the extra.
-    if (AreAllSeparators(new_path.path_.substr(0, last_separator + 1))) {
-      new_path.path_.resize(last_separator + 1);
-      trim_to_basename = false;
-    }
-#endif  // BUILDFLAG(IS_POSIX)
-    if (trim_to_basename) {
-      // path_ is somewhere else, trim the basename.
-      new_path.path_.resize(last_separator);
-    }
-  }
-
-  new_path.StripTrailingSeparatorsInternal();
-  if (!new_path.path_.length())
-    new_path.path_ = kCurrentDirectory;
-
-  return new_path;
+  return FilePathView(*this).DirName().ToFilePath();
 }
 
 FilePath FilePath::BaseName() const {
-  FilePath new_path(path_);
-  new_path.StripTrailingSeparatorsInternal();
-
-  // The drive letter, if any, is always stripped.
-  StringType::size_type letter = FindDriveLetter(new_path.path_);
-  if (letter != StringType::npos) {
-    new_path.path_.erase(0, letter + 1);
-  }
-
-  // Keep everything after the final separator, but if the pathname is only
-  // one character and it's a separator, leave it alone.
-  StringType::size_type last_separator =
-      new_path.path_.find_last_of(kSeparators, StringType::npos,
-                                  kSeparatorsLength - 1);
-  if (last_separator != StringType::npos &&
-      last_separator < new_path.path_.length() - 1) {
-    new_path.path_.erase(0, last_separator + 1);
-  }
-
-  return new_path;
+  return FilePathView(*this).BaseName().ToFilePath();
 }
 
 StringType FilePath::Extension() const {
-  FilePath base(BaseName());
-  const StringType::size_type dot = ExtensionSeparatorPosition(base.path_);
-  if (dot == StringType::npos)
-    return StringType();
-
-  return base.path_.substr(dot, StringType::npos);
+  return StringType(FilePathView(*this).Extension());
 }
 
 StringType FilePath::FinalExtension() const {
-  FilePath base(BaseName());
-  const StringType::size_type dot = FinalExtensionSeparatorPosition(base.path_);
-  if (dot == StringType::npos)
-    return StringType();
-
-  return base.path_.substr(dot, StringType::npos);
+  return StringType(FilePathView(*this).FinalExtension());
 }
 
 FilePath FilePath::RemoveExtension() const {
@@ -521,18 +445,27 @@ bool FilePath::MatchesFinalExtension(StringPieceType extension) const {
 }
 
 FilePath FilePath::Append(StringPieceType component) const {
-  StringPieceType appended = component;
-  StringType without_nuls;
+  FilePath new_path(*this);
+  new_path.AppendInPlace(component);
+  return new_path;
+}
 
+FilePath FilePath::Append(const FilePath& component) const {
+  return Append(component.value());
+}
+
+FilePath FilePath::Append(const SafeBaseName& component) const {
+  return Append(component.path().value());
+}
+
+FilePath& FilePath::AppendInPlace(StringPieceType component) {
   StringType::size_type nul_pos = component.find(kStringTerminator);
-  if (nul_pos != StringPieceType::npos) {
-    without_nuls = StringType(component.substr(0, nul_pos));
-    appended = StringPieceType(without_nuls);
-  }
+  if (nul_pos != StringPieceType::npos)
+    component = component.substr(0, nul_pos);
 
-  DCHECK(!IsPathAbsolute(appended));
+  DCHECK(!IsPathAbsolute(component));
 
-  if (path_.compare(kCurrentDirectory) == 0 && !appended.empty()) {
+  if (path_.compare(kCurrentDirectory) == 0 && !component.empty()) {
     // Append normally doesn't do any normalization, but as a special case,
     // when appending to kCurrentDirectory, just return a new path for the
     // component argument.  Appending component to kCurrentDirectory would
@@ -540,36 +473,32 @@ FilePath FilePath::Append(StringPieceType component) const {
     // it's likely in practice to wind up with FilePath objects containing
     // only kCurrentDirectory when calling DirName on a single relative path
     // component.
-    return FilePath(appended);
+    path_.assign(component);
+    return *this;
   }
 
-  FilePath new_path(path_);
-  new_path.StripTrailingSeparatorsInternal();
+  StripTrailingSeparatorsInternal();
 
   // Don't append a separator if the path is empty (indicating the current
   // directory) or if the path component is empty (indicating nothing to
   // append).
-  if (!appended.empty() && !new_path.path_.empty()) {
+  if (!component.empty() && !path_.empty()) {
     // Don't append a separator if the path still ends with a trailing
     // separator after stripping (indicating the root directory).
-    if (!IsSeparator(new_path.path_.back())) {
+    if (!IsSeparator(path_.back())) {
       // Don't append a separator if the path is just a drive letter.
-      if (FindDriveLetter(new_path.path_) + 1 != new_path.path_.length()) {
-        new_path.path_.append(1, kSeparators[0]);
+      if (FindDriveLetter(path_) + 1 != path_.length()) {
+        path_.append(1, kSeparators[0]);
       }
     }
   }
 
-  new_path.path_.append(appended);
-  return new_path;
+  path_.append(component);
+  return *this;
 }
 
-FilePath FilePath::Append(const FilePath& component) const {
-  return Append(component.value());
-}
-
-FilePath FilePath::Append(const SafeBaseName& component) const {
-  return Append(component.path().value());
+FilePath& FilePath::AppendInPlace(const FilePath& component) {
+  return AppendInPlace(component.value());
 }
 
 FilePath FilePath::AppendASCII(StringPiece component) const {
@@ -1363,25 +1292,7 @@ int FilePath::CompareIgnoreCase(StringPieceType string1,
 
 
 void FilePath::StripTrailingSeparatorsInternal() {
-  // If there is no drive letter, start will be 1, which will prevent stripping
-  // the leading separator if there is only one separator.  If there is a drive
-  // letter, start will be set appropriately to prevent stripping the first
-  // separator following the drive letter, if a separator immediately follows
-  // the drive letter.
-  StringType::size_type start = FindDriveLetter(path_) + 2;
-
-  StringType::size_type last_stripped = StringType::npos;
-  for (StringType::size_type pos = path_.length();
-       pos > start && IsSeparator(path_[pos - 1]);
-       --pos) {
-    // If the string only has two separators and they're at the beginning,
-    // don't strip them, unless the string began with more than two separators.
-    if (pos != start + 1 || last_stripped == start + 2 ||
-        !IsSeparator(path_[start - 1])) {
-      path_.resize(pos - 1);
-      last_stripped = pos;
-    }
-  }
+  path_.resize(StripTrailingSeparatorsLength(path_));
 }
 
 FilePath FilePath::NormalizePathSeparators() const {
@@ -1412,4 +1323,128 @@ bool FilePath::IsContentUri() const {
 }
 #endif
 
+// libgen's dirname and basename aren't guaranteed to be thread-safe and aren't
+// guaranteed to not modify their input strings, and in fact are implemented
+// differently in this regard on different platforms.  Don't use them, but
+// adhere to their behavior.
+FilePathView FilePathView::DirName() const {
+  StringPieceType path = path_.substr(0, StripTrailingSeparatorsLength(path_));
+
+  // The drive letter, if any, always needs to remain in the output.  If there
+  // is no drive letter, as will always be the case on platforms which do not
+  // support drive letters, letter will be npos, or -1, so the comparisons and
+  // substrings below using letter will still be valid.
+  StringPieceType::size_type letter = FindDriveLetter(path);
+
+  StringPieceType::size_type last_separator =
+      path.find_last_of(FilePath::kSeparators, StringPieceType::npos,
+                        FilePath::kSeparatorsLength - 1);
+  if (last_separator == StringPieceType::npos) {
+    // path_ is in the current directory.
+    path = path.substr(0, letter + 1);
+  } else if (last_separator == letter + 1) {
+    // path_ is in the root directory.
+    path = path.substr(0, letter + 2);
+  } else if (last_separator == letter + 2 &&
+             FilePath::IsSeparator(path[letter + 1])) {
+    // path_ is in "//" (possibly with a drive letter); leave the double
+    // separator intact indicating alternate root.
+    path = path.substr(0, letter + 3);
+  } else if (last_separator != 0) {
+    bool trim_to_basename = true;
+#if BUILDFLAG(IS_POSIX)
+    // On Posix, more than two leading separators are always collapsed to one.
+    // See
+    // https://pubs.opengroup.org/onlinepubs/9699919799/basedefs/V1_chap04.html#tag_04_13
+    // So, do not strip any of the separators, let
+    // StripTrailingSeparatorsLength() take care of the extra.
+    if (AreAllSeparators(path.substr(0, last_separator + 1))) {
+      path = path.substr(0, last_separator + 1);
+      trim_to_basename = false;
+    }
+#endif  // BUILDFLAG(IS_POSIX)
+    if (trim_to_basename) {
+      // path_ is somewhere else, trim the basename.
+      path = path.substr(0, last_separator);
+    }
+  }
+
+  path = path.substr(0, StripTrailingSeparatorsLength(path));
+  if (path.empty())
+    path = FilePath::kCurrentDirectory;
+
+  return FilePathView(path);
+}
+
+FilePathView FilePathView::BaseName() const {
+  StringPieceType path = path_.substr(0, StripTrailingSeparatorsLength(path_));
+
+  // The drive letter, if any, is always stripped.
+  StringPieceType::size_type letter = FindDriveLetter(path);
+  if (letter != StringPieceType::npos) {
+    path.remove_prefix(letter + 1);
+  }
+
+  // Keep everything after the final separator, but if the pathname is only
+  // one character and it's a separator, leave it alone.
+  StringPieceType::size_type last_separator =
+      path.find_last_of(FilePath::kSeparators, StringPieceType::npos,
+                        FilePath::kSeparatorsLength - 1);
+  if (last_separator != StringPieceType::npos &&
+      last_separator < path.length() - 1) {
+    path.remove_prefix(last_separator + 1);
+  }
+
+  return FilePathView(path);
+}
+
+StringPieceType FilePathView::Extension() const {
+  const StringPieceType base = BaseName().value();
+  const StringPieceType::size_type dot = ExtensionSeparatorPosition(base);
+  if (dot == StringPieceType::npos)
+    return StringPieceType();
+
+  return base.substr(dot);
+}
+
+StringPieceType FilePathView::FinalExtension() const {
+  const StringPieceType base = BaseName().value();
+  const StringPieceType::size_type dot = FinalExtensionSeparatorPosition(base);
+  if (dot == StringPieceType::npos)
+    return StringPieceType();
+
+  return base.substr(dot);
+}
+
+void FilePathView::GetComponents(
+    std::vector<StringPieceType>* components) const {
+  components->clear();
+  if (empty())
+    return;
+
+  FilePathView current = *this;
+  FilePathView dir = current.DirName();
+
+  // Capture path components.
+  while (current.value() != dir.value()) {
+    const StringPieceType base = current.BaseName().value();
+    if (!AreAllSeparators(base))
+      components->push_back(base);
+    current = dir;
+    dir = current.DirName();
+  }
+
+  // Capture root, if any.
+  const StringPieceType base = current.BaseName().value();
+  if (!base.empty() && base != FilePath::kCurrentDirectory)
+    components->push_back(base);
+
+  // Capture drive letter, if any.
+  StringPieceType::size_type letter = FindDriveLetter(dir.value());
+  if (letter != StringPieceType::npos)
+    components->push_back(dir.value().substr(0, letter + 1));
+
+  ranges::reverse(*components);
+}
+
 }  // namespace base
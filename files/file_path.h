@@ -358,6 +358,19 @@ class BASE_EXPORT FilePath {
   [[nodiscard]] FilePath Append(const FilePath& component) const;
   [[nodiscard]] FilePath Append(const SafeBaseName& component) const;
 
+  // Like Append(), but modifies this path instead of returning a new one, so
+  // that building many paths into the same FilePath reuses its buffer:
+  //
+  //   FilePath path;
+  //   for (const FilePath::StringType& name : names) {
+  //     path = dir;
+  //     path.AppendInPlace(name);
+  //   }
+  //
+  // |component| must not point into this path.
+  FilePath& AppendInPlace(StringPieceType component);
+  FilePath& AppendInPlace(const FilePath& component);
+
   // Although Windows StringType is std::wstring, since the encoding it uses for
   // paths is well defined, it can handle ASCII path components as well.
   // Mac uses UTF8, and since ASCII is a subset of that, it works there as well.
@@ -511,6 +524,40 @@ class BASE_EXPORT FilePath {
 BASE_EXPORT std::ostream& operator<<(std::ostream& out,
                                      const FilePath& file_path);
 
+// A non-owning view of a native pathname which, like a std::string_view, must
+// not outlive the string it refers to. Its methods behave like the FilePath
+// methods of the same name, but return views into that string instead of new
+// strings, so that code inspecting many paths doesn't allocate:
+//
+//   if (FilePathView(path).BaseName().value() == FILE_PATH_LITERAL(".git"))
+//     ...
+class BASE_EXPORT FilePathView {
+ public:
+  constexpr FilePathView() = default;
+  constexpr explicit FilePathView(FilePath::StringPieceType path)
+      : path_(path) {}
+  explicit FilePathView(const FilePath& path) : path_(path.value()) {}
+
+  constexpr FilePath::StringPieceType value() const { return path_; }
+
+  [[nodiscard]] constexpr bool empty() const { return path_.empty(); }
+
+  [[nodiscard]] FilePathView DirName() const;
+  [[nodiscard]] FilePathView BaseName() const;
+  [[nodiscard]] FilePath::StringPieceType Extension() const;
+  [[nodiscard]] FilePath::StringPieceType FinalExtension() const;
+
+  // Replaces the contents of |components| with the components of the path, as
+  // returned by FilePath::GetComponents(). Reusing |components| across calls
+  // avoids allocating.
+  void GetComponents(std::vector<FilePath::StringPieceType>* components) const;
+
+  [[nodiscard]] FilePath ToFilePath() const { return FilePath(path_); }
+
+ private:
+  FilePath::StringPieceType path_;
+};
+
 }  // namespace base
 
 namespace std {
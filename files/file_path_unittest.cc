@@ -14,6 +14,7 @@
 #include <sstream>
 
 #include "base/files/safe_base_name.h"
+#include "base/ranges/algorithm.h"
 #include "base/strings/utf_ostream_operators.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
@@ -167,6 +168,8 @@ TEST_F(FilePathTest, DirName) {
     FilePath observed = input.DirName();
     EXPECT_EQ(FilePath::StringType(cases[i].expected), observed.value()) <<
               "i: " << i << ", input: " << input.value();
+    EXPECT_EQ(cases[i].expected, FilePathView(input).DirName().value())
+        << "i: " << i << ", input: " << input.value();
   }
 }
 
@@ -254,6 +257,8 @@ TEST_F(FilePathTest, BaseName) {
     FilePath observed = input.BaseName();
     EXPECT_EQ(FilePath::StringType(cases[i].expected), observed.value()) <<
               "i: " << i << ", input: " << input.value();
+    EXPECT_EQ(cases[i].expected, FilePathView(input).BaseName().value())
+        << "i: " << i << ", input: " << input.value();
   }
 }
 
@@ -336,6 +341,11 @@ TEST_F(FilePathTest, Append) {
     FilePath observed_path = root.Append(FilePath(leaf));
     EXPECT_EQ(FilePath::StringType(cases[i].expected), observed_path.value()) <<
               "i: " << i << ", root: " << root.value() << ", leaf: " << leaf;
+    FilePath observed_in_place = root;
+    observed_in_place.AppendInPlace(leaf);
+    EXPECT_EQ(FilePath::StringType(cases[i].expected),
+              observed_in_place.value())
+        << "i: " << i << ", root: " << root.value() << ", leaf: " << leaf;
 
     // TODO(erikkay): It would be nice to have a unicode test append value to
     // handle the case when AppendASCII is passed UTF8
@@ -530,6 +540,7 @@ TEST_F(FilePathTest, PathComponentsTest) {
 #endif  // FILE_PATH_USES_WIN_SEPARATORS
   };
 
+  std::vector<FilePath::StringPieceType> view_comps;
   for (size_t i = 0; i < std::size(cases); ++i) {
     FilePath input(cases[i].input);
     std::vector<FilePath::StringType> comps = input.GetComponents();
@@ -541,6 +552,12 @@ TEST_F(FilePathTest, PathComponentsTest) {
     }
     EXPECT_EQ(FilePath::StringType(cases[i].expected), observed) <<
               "i: " << i << ", input: " << input.value();
+
+    // The view returns the same components, into a vector reused across the
+    // cases.
+    FilePathView(input).GetComponents(&view_comps);
+    EXPECT_TRUE(ranges::equal(comps, view_comps))
+        << "i: " << i << ", input: " << input.value();
   }
 }
 
@@ -850,6 +867,10 @@ TEST_F(FilePathTest, Extension2) {
         << "i: " << i << ", path: " << path.value();
     EXPECT_EQ(cases[i].expected, final_extension)
         << "i: " << i << ", path: " << path.value();
+    EXPECT_EQ(cases[i].expected, FilePathView(path).Extension())
+        << "i: " << i << ", path: " << path.value();
+    EXPECT_EQ(cases[i].expected, FilePathView(path).FinalExtension())
+        << "i: " << i << ", path: " << path.value();
   }
 
   for (size_t i = 0; i < std::size(double_extension_cases); ++i) {
@@ -857,6 +878,9 @@ TEST_F(FilePathTest, Extension2) {
     FilePath::StringType extension = path.Extension();
     EXPECT_EQ(double_extension_cases[i].expected, extension)
         << "i: " << i << ", path: " << path.value();
+    EXPECT_EQ(double_extension_cases[i].expected,
+              FilePathView(path).Extension())
+        << "i: " << i << ", path: " << path.value();
   }
 }
 
@@ -1327,6 +1351,15 @@ TEST_F(FilePathTest, AppendWithNUL) {
 #else
   EXPECT_EQ(FPL("a/b"), path.value());
 #endif
+
+  // Test AppendInPlace() strips '\0'
+  path = FilePath(FPL("a"));
+  path.AppendInPlace(FPS("b\0b"));
+#if defined(FILE_PATH_USES_WIN_SEPARATORS)
+  EXPECT_EQ(FPL("a\\b"), path.value());
+#else
+  EXPECT_EQ(FPL("a/b"), path.value());
+#endif
 }
 
 TEST_F(FilePathTest, AppendBaseName) {
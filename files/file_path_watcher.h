@@ -19,6 +19,7 @@
 #include "base/memory/scoped_refptr.h"
 #include "base/sequence_checker.h"
 #include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 
 namespace base {
@@ -113,6 +114,19 @@ class BASE_EXPORT FilePathWatcher {
     bool report_modified_path = false;
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_FUCHSIA)
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    // If not zero, changes are collected from the first one for this long,
+    // and then reported once per path, in the order in which the paths first
+    // changed, with the ChangeInfo of the latest change (a file created and
+    // then modified is reported as created). This keeps a storm of events,
+    // such as a build rewriting a watched tree, from running the callback for
+    // each of them. Combine with |report_modified_path| to report each
+    // changed file once, rather than the watched path once per window.
+    // Changes collected when an error is reported are dropped.
+    TimeDelta coalescing_window;
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
   };
 
   // Callback type for Watch(). |path| points to the file that was updated,
@@ -0,0 +1,388 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/file_path_watcher_fanotify.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/fanotify.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+
+#include <array>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_file.h"
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/no_destructor.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/scoped_blocking_call.h"
+
+namespace base::internal {
+
+namespace {
+
+// The same changes as inotify watches for, see InotifyReader::AddWatch().
+constexpr uint64_t kEventMask = FAN_ATTRIB | FAN_CREATE | FAN_DELETE |
+                                FAN_CLOSE_WRITE | FAN_MOVED_FROM |
+                                FAN_MOVED_TO | FAN_ONDIR;
+
+// The changes to a directory which may make the watched tree under it
+// (dis)appear.
+constexpr uint64_t kEntryEventMask =
+    FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO;
+
+// The largest file handle that name_to_handle_at() returns.
+constexpr size_t kMaxHandleSize = 128;
+
+bool g_fanotify_disabled_for_testing = false;
+
+// Identifies a file system, as in statfs() and fanotify events.
+using FileSystemId = std::pair<int, int>;
+
+struct Change {
+  FilePathWatcher::ChangeInfo change_info;
+  FilePath path;
+};
+
+FilePathWatcher::ChangeType ToChangeType(uint64_t mask) {
+  // Ordered by specificity, as for inotify.
+  if (mask & (FAN_MOVED_FROM | FAN_MOVED_TO)) {
+    return FilePathWatcher::ChangeType::kMoved;
+  } else if (mask & FAN_CREATE) {
+    return FilePathWatcher::ChangeType::kCreated;
+  } else if (mask & FAN_DELETE) {
+    return FilePathWatcher::ChangeType::kDeleted;
+  } else {
+    return FilePathWatcher::ChangeType::kModified;
+  }
+}
+
+void RunChangeCallback(const FanotifyWatch::ChangeCallback& callback,
+                       std::vector<Change> changes) {
+  for (const Change& change : changes) {
+    callback.Run(change.change_info, change.path);
+  }
+}
+
+// Whether the directory at `dir_fd` can be reopened from its file handle,
+// which needs CAP_DAC_READ_SEARCH, as reading the events does.
+bool CanOpenByHandle(int dir_fd) {
+  alignas(file_handle) std::array<uint8_t, sizeof(file_handle) +
+                                               kMaxHandleSize> buffer;
+  file_handle* handle = reinterpret_cast<file_handle*>(buffer.data());
+  handle->handle_bytes = kMaxHandleSize;
+  int mount_id;
+  if (name_to_handle_at(dir_fd, "", handle, &mount_id, AT_EMPTY_PATH) != 0) {
+    return false;
+  }
+  ScopedFD fd(open_by_handle_at(dir_fd, handle, O_PATH | O_CLOEXEC));
+  return fd.is_valid();
+}
+
+// Singleton which owns the fanotify group of the process, marks the file
+// systems of the watched trees, and reads their events on a thread of its
+// own, as InotifyReader does for inotify.
+class FanotifyReader final : public PlatformThread::Delegate {
+ public:
+  static FanotifyReader& Get() {
+    static NoDestructor<FanotifyReader> reader;
+    return *reader;
+  }
+
+  FanotifyReader(const FanotifyReader&) = delete;
+  FanotifyReader& operator=(const FanotifyReader&) = delete;
+
+  // Watches the tree at `path`, and posts its changes to `callback` on
+  // `task_runner`. Returns the id of the watch, or nullopt if fanotify can't
+  // be used for `path`.
+  std::optional<uint64_t> AddWatch(
+      const FilePath& path,
+      scoped_refptr<SequencedTaskRunner> task_runner,
+      FanotifyWatch::ChangeCallback callback);
+
+  void RemoveWatch(uint64_t id);
+
+ private:
+  friend class NoDestructor<FanotifyReader>;
+
+  struct FileSystem {
+    // A directory of the file system, to reopen the directories of its events
+    // from their file handles.
+    ScopedFD fd;
+    size_t watch_count = 0;
+  };
+
+  struct Watch {
+    // The path of the tree, as given and as resolved by the kernel. The events
+    // carry the latter.
+    FilePath path;
+    FilePath real_path;
+    FileSystemId file_system_id;
+    scoped_refptr<SequencedTaskRunner> task_runner;
+    FanotifyWatch::ChangeCallback callback;
+  };
+
+  FanotifyReader();
+  // There is no destructor, since this is a NoDestructor.
+
+  // PlatformThread::Delegate:
+  void ThreadMain() override;
+
+  void OnEvents(span<const uint8_t> events);
+
+  // Returns the path of the file or directory of the event, or nullopt if it
+  // can't be known, e.g. because its directory was deleted since.
+  std::optional<FilePath> GetEventPath(const fanotify_event_metadata* metadata)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // The fanotify group, invalid if fanotify can't be used.
+  const ScopedFD fanotify_fd_;
+
+  Lock lock_;
+  std::map<FileSystemId, FileSystem> file_systems_ GUARDED_BY(lock_);
+  std::map<uint64_t, Watch> watches_ GUARDED_BY(lock_);
+  uint64_t next_watch_id_ GUARDED_BY(lock_) = 0;
+  bool thread_started_ GUARDED_BY(lock_) = false;
+};
+
+FanotifyReader::FanotifyReader()
+    : fanotify_fd_(fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC |
+                                     FAN_REPORT_DFID_NAME,
+                                 O_RDONLY | O_CLOEXEC | O_LARGEFILE)) {
+  // This fails without CAP_SYS_ADMIN before Linux 5.13, and with EINVAL
+  // before Linux 5.9.
+  DPLOG_IF(WARNING, !fanotify_fd_.is_valid()) << "fanotify_init() failed";
+}
+
+std::optional<uint64_t> FanotifyReader::AddWatch(
+    const FilePath& path,
+    scoped_refptr<SequencedTaskRunner> task_runner,
+    FanotifyWatch::ChangeCallback callback) {
+  if (!fanotify_fd_.is_valid()) {
+    return std::nullopt;
+  }
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+
+  ScopedFD dir_fd(HANDLE_EINTR(
+      open(path.value().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)));
+  struct statfs file_system_info;
+  if (!dir_fd.is_valid() || fstatfs(dir_fd.get(), &file_system_info) != 0) {
+    return std::nullopt;
+  }
+  const FileSystemId file_system_id(file_system_info.f_fsid.__val[0],
+                                    file_system_info.f_fsid.__val[1]);
+  FilePath real_path;
+  if (!ReadSymbolicLink(
+          FilePath("/proc/self/fd").Append(NumberToString(dir_fd.get())),
+          &real_path)) {
+    return std::nullopt;
+  }
+
+  AutoLock auto_lock(lock_);
+  if (!thread_started_) {
+    // This object is a NoDestructor, so it outlives the thread.
+    if (!PlatformThread::CreateNonJoinable(0, this)) {
+      return std::nullopt;
+    }
+    thread_started_ = true;
+  }
+
+  auto file_system_it = file_systems_.find(file_system_id);
+  if (file_system_it == file_systems_.end()) {
+    // Marking a file system needs CAP_SYS_ADMIN, and fails for file systems
+    // which can't identify their files by handles.
+    if (!CanOpenByHandle(dir_fd.get()) ||
+        fanotify_mark(fanotify_fd_.get(), FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                      kEventMask, dir_fd.get(), nullptr) != 0) {
+      DPLOG(WARNING) << "Can't watch " << path << " with fanotify";
+      return std::nullopt;
+    }
+    file_system_it =
+        file_systems_.emplace(file_system_id, FileSystem{std::move(dir_fd)})
+            .first;
+  }
+  ++file_system_it->second.watch_count;
+
+  const uint64_t id = next_watch_id_++;
+  watches_.emplace(id, Watch{path, real_path, file_system_id,
+                             std::move(task_runner), std::move(callback)});
+  return id;
+}
+
+void FanotifyReader::RemoveWatch(uint64_t id) {
+  AutoLock auto_lock(lock_);
+  auto watch_it = watches_.find(id);
+  CHECK(watch_it != watches_.end());
+  auto file_system_it = file_systems_.find(watch_it->second.file_system_id);
+  watches_.erase(watch_it);
+
+  if (--file_system_it->second.watch_count == 0) {
+    ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                            BlockingType::WILL_BLOCK);
+    fanotify_mark(fanotify_fd_.get(), FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM,
+                  kEventMask, file_system_it->second.fd.get(), nullptr);
+    file_systems_.erase(file_system_it);
+  }
+}
+
+void FanotifyReader::ThreadMain() {
+  PlatformThread::SetName("fanotify_reader");
+
+  // Large enough for the events of a storm to be read at once. The events
+  // are aligned as their metadata.
+  std::vector<fanotify_event_metadata> buffer(
+      64 * 1024 / sizeof(fanotify_event_metadata));
+  while (true) {
+    const ssize_t bytes_read =
+        HANDLE_EINTR(read(fanotify_fd_.get(), buffer.data(),
+                          buffer.size() * sizeof(fanotify_event_metadata)));
+    if (bytes_read <= 0) {
+      DPLOG(WARNING) << "read from fanotify fd failed";
+      return;
+    }
+    OnEvents(as_bytes(span(buffer)).first(static_cast<size_t>(bytes_read)));
+  }
+}
+
+void FanotifyReader::OnEvents(span<const uint8_t> events) {
+  std::map<uint64_t, std::vector<Change>> changes_by_watch;
+
+  AutoLock auto_lock(lock_);
+  const fanotify_event_metadata* metadata =
+      reinterpret_cast<const fanotify_event_metadata*>(events.data());
+  for (ssize_t length = static_cast<ssize_t>(events.size());
+       FAN_EVENT_OK(metadata, length);
+       metadata = FAN_EVENT_NEXT(metadata, length)) {
+    if (metadata->vers != FANOTIFY_METADATA_VERSION) {
+      DLOG(ERROR) << "Unexpected fanotify metadata version "
+                  << metadata->vers;
+      return;
+    }
+
+    if (metadata->mask & FAN_Q_OVERFLOW) {
+      // Changes were lost: report a change of each tree, for its watchers to
+      // look at it again.
+      for (const auto& [id, watch] : watches_) {
+        changes_by_watch[id].push_back({{}, watch.path});
+      }
+      continue;
+    }
+
+    std::optional<FilePath> path = GetEventPath(metadata);
+    if (!path) {
+      continue;
+    }
+    const FilePathWatcher::ChangeInfo change_info{
+        .file_path_type = metadata->mask & FAN_ONDIR
+                              ? FilePathWatcher::FilePathType::kDirectory
+                              : FilePathWatcher::FilePathType::kFile,
+        .change_type = ToChangeType(metadata->mask),
+    };
+    for (const auto& [id, watch] : watches_) {
+      FilePath changed_path = watch.path;
+      if (watch.real_path != *path &&
+          !watch.real_path.AppendRelativePath(*path, &changed_path)) {
+        // A directory above the tree may have (dis)appeared with it.
+        if (!(metadata->mask & kEntryEventMask) ||
+            !path->IsParent(watch.real_path)) {
+          continue;
+        }
+      }
+      changes_by_watch[id].push_back({change_info, std::move(changed_path)});
+    }
+  }
+
+  for (auto& [id, changes] : changes_by_watch) {
+    const Watch& watch = watches_.at(id);
+    watch.task_runner->PostTask(
+        FROM_HERE,
+        BindOnce(&RunChangeCallback, watch.callback, std::move(changes)));
+  }
+}
+
+std::optional<FilePath> FanotifyReader::GetEventPath(
+    const fanotify_event_metadata* metadata) {
+  // With FAN_REPORT_DFID_NAME, the metadata is followed by the file handle of
+  // the directory of the event, and the name of its entry.
+  const auto* info =
+      reinterpret_cast<const fanotify_event_info_fid*>(metadata + 1);
+  if (metadata->event_len < sizeof(*metadata) + sizeof(*info) ||
+      (info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME &&
+       info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID)) {
+    return std::nullopt;
+  }
+  auto file_system_it =
+      file_systems_.find({info->fsid.val[0], info->fsid.val[1]});
+  if (file_system_it == file_systems_.end()) {
+    return std::nullopt;
+  }
+
+  file_handle* handle = reinterpret_cast<file_handle*>(
+      const_cast<unsigned char*>(info->handle));
+  ScopedFD dir_fd(open_by_handle_at(file_system_it->second.fd.get(), handle,
+                                    O_PATH | O_CLOEXEC));
+  FilePath dir;
+  if (!dir_fd.is_valid() ||
+      !ReadSymbolicLink(
+          FilePath("/proc/self/fd").Append(NumberToString(dir_fd.get())),
+          &dir)) {
+    return std::nullopt;
+  }
+  if (info->hdr.info_type == FAN_EVENT_INFO_TYPE_DFID_NAME) {
+    const char* name =
+        reinterpret_cast<const char*>(handle->f_handle + handle->handle_bytes);
+    // "." names the directory itself.
+    if (strcmp(name, ".") != 0) {
+      return dir.Append(name);
+    }
+  }
+  return dir;
+}
+
+}  // namespace
+
+FanotifyWatch::FanotifyWatch(uint64_t id) : id_(id) {}
+
+FanotifyWatch::~FanotifyWatch() {
+  FanotifyReader::Get().RemoveWatch(id_);
+}
+
+// static
+std::unique_ptr<FanotifyWatch> FanotifyWatch::Create(const FilePath& path,
+                                                     ChangeCallback callback) {
+  DCHECK(path.IsAbsolute());
+  if (g_fanotify_disabled_for_testing) {
+    return nullptr;
+  }
+  std::optional<uint64_t> id = FanotifyReader::Get().AddWatch(
+      path, SequencedTaskRunner::GetCurrentDefault(), std::move(callback));
+  if (!id) {
+    return nullptr;
+  }
+  return WrapUnique(new FanotifyWatch(*id));
+}
+
+ScopedFanotifyDisabledForTesting::ScopedFanotifyDisabledForTesting() {
+  CHECK(!g_fanotify_disabled_for_testing);
+  g_fanotify_disabled_for_testing = true;
+}
+
+ScopedFanotifyDisabledForTesting::~ScopedFanotifyDisabledForTesting() {
+  g_fanotify_disabled_for_testing = false;
+}
+
+}  // namespace base::internal
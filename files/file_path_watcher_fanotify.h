@@ -0,0 +1,73 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_FILE_PATH_WATCHER_FANOTIFY_H_
+#define BASE_FILES_FILE_PATH_WATCHER_FANOTIFY_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/base_export.h"
+#include "base/files/file_path.h"
+#include "base/files/file_path_watcher.h"
+#include "base/functional/callback.h"
+
+namespace base::internal {
+
+// Watches a directory tree with fanotify, for recursive FilePathWatchers.
+// inotify needs a watch per directory, which runs into the limit on the
+// number of watches for large trees, and has to walk the tree to set them up.
+// Instead, this marks the whole file system of the tree once, and filters the
+// events by path, so that watching a tree costs the same whatever its size.
+//
+// This needs Linux 5.9 or later for FAN_REPORT_DFID_NAME, CAP_SYS_ADMIN to
+// mark a file system, and CAP_DAC_READ_SEARCH to resolve the directories of
+// the events to paths. Changes in other file systems mounted within the tree
+// are not reported.
+class BASE_EXPORT FanotifyWatch {
+ public:
+  // Run for each change in the tree, with the path of the changed file or
+  // directory.
+  using ChangeCallback =
+      RepeatingCallback<void(const FilePathWatcher::ChangeInfo& change_info,
+                             const FilePath& path)>;
+
+  FanotifyWatch(const FanotifyWatch&) = delete;
+  FanotifyWatch& operator=(const FanotifyWatch&) = delete;
+  // Stops watching. `callback` may still run for changes which were already
+  // read, so it should be bound to a WeakPtr.
+  ~FanotifyWatch();
+
+  // Starts watching the tree at `path`, which must be an existing directory
+  // given as an absolute path, and runs `callback` on the current sequence
+  // for each change in it, including changes to `path` itself. Returns null
+  // if fanotify can't be used, in which case the caller should fall back to
+  // inotify.
+  static std::unique_ptr<FanotifyWatch> Create(const FilePath& path,
+                                               ChangeCallback callback);
+
+ private:
+  explicit FanotifyWatch(uint64_t id);
+
+  // Identifies the watch to the reader of the events.
+  const uint64_t id_;
+};
+
+// Makes FanotifyWatch::Create() fail while it is alive, so that recursive
+// FilePathWatchers use inotify, e.g. to test it in a process which has the
+// capabilities for fanotify.
+class BASE_EXPORT ScopedFanotifyDisabledForTesting {
+ public:
+  ScopedFanotifyDisabledForTesting();
+  ScopedFanotifyDisabledForTesting(const ScopedFanotifyDisabledForTesting&) =
+      delete;
+  ScopedFanotifyDisabledForTesting& operator=(
+      const ScopedFanotifyDisabledForTesting&) = delete;
+  ~ScopedFanotifyDisabledForTesting();
+};
+
+}  // namespace base::internal
+
+#endif  // BASE_FILES_FILE_PATH_WATCHER_FANOTIFY_H_
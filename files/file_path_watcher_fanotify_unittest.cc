@@ -0,0 +1,102 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/file_path_watcher_fanotify.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/containers/contains.h"
+#include "base/files/file_path.h"
+#include "base/files/file_path_watcher.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/bind.h"
+#include "base/test/run_until.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base::internal {
+
+class FanotifyWatchTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    tree_ = temp_dir_.GetPath().AppendASCII("tree");
+    ASSERT_TRUE(CreateDirectory(tree_.AppendASCII("a").AppendASCII("b")));
+  }
+
+  // Returns a watch of `tree_` which records the changed paths in `paths_`,
+  // or null if the process can't use fanotify.
+  std::unique_ptr<FanotifyWatch> Watch() {
+    return FanotifyWatch::Create(
+        tree_, BindLambdaForTesting(
+                   [this](const FilePathWatcher::ChangeInfo& change_info,
+                          const FilePath& path) { paths_.push_back(path); }));
+  }
+
+  test::TaskEnvironment task_environment_{
+      test::TaskEnvironment::MainThreadType::IO};
+  ScopedTempDir temp_dir_;
+  FilePath tree_;
+  std::vector<FilePath> paths_;
+};
+
+TEST_F(FanotifyWatchTest, ReportsChangesInTree) {
+  std::unique_ptr<FanotifyWatch> watch = Watch();
+  if (!watch) {
+    GTEST_SKIP() << "fanotify needs CAP_SYS_ADMIN and CAP_DAC_READ_SEARCH";
+  }
+
+  // Not in the tree.
+  ASSERT_TRUE(WriteFile(temp_dir_.GetPath().AppendASCII("outside"), "data"));
+  // Deep in the tree, without a watch for its directory.
+  const FilePath file = tree_.AppendASCII("a").AppendASCII("b").AppendASCII(
+      "file");
+  ASSERT_TRUE(WriteFile(file, "data"));
+  EXPECT_TRUE(test::RunUntil([&] { return Contains(paths_, file); }));
+  for (const FilePath& path : paths_) {
+    EXPECT_TRUE(tree_.IsParent(path)) << path;
+  }
+}
+
+TEST_F(FanotifyWatchTest, ReportsTreeReappearing) {
+  std::unique_ptr<FanotifyWatch> watch = Watch();
+  if (!watch) {
+    GTEST_SKIP() << "fanotify needs CAP_SYS_ADMIN and CAP_DAC_READ_SEARCH";
+  }
+
+  ASSERT_TRUE(DeletePathRecursively(tree_));
+  EXPECT_TRUE(test::RunUntil([&] { return Contains(paths_, tree_); }));
+
+  ASSERT_TRUE(CreateDirectory(tree_));
+  const FilePath file = tree_.AppendASCII("file");
+  ASSERT_TRUE(WriteFile(file, "data"));
+  EXPECT_TRUE(test::RunUntil([&] { return Contains(paths_, file); }));
+}
+
+TEST_F(FanotifyWatchTest, UsedByRecursiveFilePathWatcher) {
+  if (!Watch()) {
+    GTEST_SKIP() << "fanotify needs CAP_SYS_ADMIN and CAP_DAC_READ_SEARCH";
+  }
+
+  FilePathWatcher watcher;
+  std::vector<FilePath> paths;
+  ASSERT_TRUE(watcher.WatchWithOptions(
+      tree_,
+      {.type = FilePathWatcher::Type::kRecursive,
+       .report_modified_path = true},
+      BindLambdaForTesting([&](const FilePath& path, bool error) {
+        EXPECT_FALSE(error);
+        paths.push_back(path);
+      })));
+  // No inotify watch is needed.
+  EXPECT_FALSE(FilePathWatcher::HasWatchesForTest());
+
+  const FilePath file = tree_.AppendASCII("a").AppendASCII("file");
+  ASSERT_TRUE(WriteFile(file, "data"));
+  EXPECT_TRUE(test::RunUntil([&] { return Contains(paths, file); }));
+}
+
+}  // namespace base::internal
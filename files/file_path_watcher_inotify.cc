@@ -43,9 +43,15 @@
 #include "base/task/single_thread_task_runner.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/scoped_blocking_call.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "base/trace_event/base_tracing.h"
 #include "build/build_config.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+#include "base/files/file_path_watcher_fanotify.h"
+#endif
+
 namespace base {
 
 namespace {
@@ -134,8 +140,9 @@ class InotifyReader {
   // Remove |watch| if it's valid.
   void RemoveWatch(Watch watch, FilePathWatcherImpl* watcher);
 
-  // Invoked on "inotify_reader" thread to notify relevant watchers.
-  void OnInotifyEvent(const inotify_event* event);
+  // Invoked on "inotify_reader" thread to notify relevant watchers of the
+  // events read at once, with one task per watcher.
+  void OnInotifyEvents(const std::vector<const inotify_event*>& events);
 
   // Returns true if any paths are actively being watched.
   bool HasWatches();
@@ -169,6 +176,16 @@ class InotifyReader {
   bool valid_ = false;
 };
 
+// An inotify event, as delivered to one of the FilePathWatcherImpls which
+// watch its watch descriptor.
+struct InotifyEvent {
+  InotifyReader::Watch watch;
+  FilePath::StringType child;
+  FilePathWatcher::ChangeInfo change_info;
+  bool created;
+  bool deleted;
+};
+
 class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate {
  public:
   FilePathWatcherImpl();
@@ -176,6 +193,11 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate {
   FilePathWatcherImpl& operator=(const FilePathWatcherImpl&) = delete;
   ~FilePathWatcherImpl() override;
 
+  // Called for the events read at once from inotify which concern this
+  // watcher, on the original sequence. Calls OnFilePathChanged() for each, in
+  // order.
+  void OnFilePathsChanged(std::vector<InotifyEvent> events);
+
   // Called for each event coming from the watch on the original thread.
   // |fired_watch| identifies the watch that fired, |child| indicates what has
   // changed, and is relative to the currently watched path for |fired_watch|.
@@ -267,6 +289,22 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate {
 
   bool HasValidWatchVector() const;
 
+  // Reports a change of |path| to |callback_|, or collects it until the end
+  // of the coalescing window. `this` may be deleted.
+  void ReportChange(FilePathWatcher::ChangeInfo change_info,
+                    const FilePath& path);
+
+  // Reports the changes collected during the coalescing window, once per
+  // path. `this` may be deleted.
+  void ReportPendingChanges();
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  // Called for each change of |target_| or within it, for a recursive watch
+  // through fanotify.
+  void OnFanotifyChange(const FilePathWatcher::ChangeInfo& change_info,
+                        const FilePath& path);
+#endif
+
   // Callback to notify upon changes.
   FilePathWatcher::CallbackWithChangeInfo callback_;
 
@@ -284,6 +322,21 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate {
   std::unordered_map<InotifyReader::Watch, FilePath> recursive_paths_by_watch_;
   std::map<FilePath, InotifyReader::Watch> recursive_watches_by_path_;
 
+  // See WatchOptions::coalescing_window. The changes collected during the
+  // current window are in |pending_changes_|, in the order in which their
+  // paths first changed, and indexed by path in |pending_change_indices_|.
+  TimeDelta coalescing_window_;
+  OneShotTimer coalescing_timer_;
+  std::vector<std::pair<FilePath, FilePathWatcher::ChangeInfo>>
+      pending_changes_;
+  std::unordered_map<FilePath, size_t> pending_change_indices_;
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  // The watch of a recursive watcher which uses fanotify instead of inotify,
+  // in which case there are no inotify watches.
+  std::unique_ptr<internal::FanotifyWatch> fanotify_watch_;
+#endif
+
   WeakPtrFactory<FilePathWatcherImpl> weak_factory_{this};
 };
 
@@ -321,13 +374,17 @@ void InotifyReaderThreadDelegate::ThreadMain() {
       return;
     }
 
+    // Under load, a read returns many events, which are delivered together
+    // to cut the number of tasks and of acquisitions of the lock.
+    std::vector<const inotify_event*> events;
     for (size_t i = 0; i < static_cast<size_t>(bytes_read);) {
       inotify_event* event = reinterpret_cast<inotify_event*>(&buffer[i]);
       size_t event_size = sizeof(inotify_event) + event->len;
       DUMP_WILL_BE_CHECK_LE(i + event_size, static_cast<size_t>(bytes_read));
-      g_inotify_reader.Get().OnInotifyEvent(event);
+      events.push_back(event);
       i += event_size;
     }
+    g_inotify_reader.Get().OnInotifyEvents(events);
   }
 }
 
@@ -396,38 +453,59 @@ void InotifyReader::RemoveWatch(Watch watch, FilePathWatcherImpl* watcher) {
   }
 }
 
-void InotifyReader::OnInotifyEvent(const inotify_event* event) {
-  if (event->mask & IN_IGNORED)
-    return;
+void InotifyReader::OnInotifyEvents(
+    const std::vector<const inotify_event*>& events) {
+  struct WatcherEvents {
+    WatcherEntry watcher_entry;
+    std::vector<InotifyEvent> events;
+  };
+  std::map<FilePathWatcherImpl*, WatcherEvents> events_by_watcher;
 
-  FilePath::StringType child(event->len ? event->name : FILE_PATH_LITERAL(""));
   AutoLock auto_lock(lock_);
+  for (const inotify_event* event : events) {
+    if (event->mask & IN_IGNORED) {
+      continue;
+    }
 
-  // In racing conditions, RemoveWatch() could grab `lock_` first and remove
-  // the entry for `event->wd`.
-  auto watchers_it = watchers_.find(static_cast<Watch>(event->wd));
-  if (watchers_it == watchers_.end())
-    return;
+    // In racing conditions, RemoveWatch() could grab `lock_` first and remove
+    // the entry for `event->wd`.
+    auto watchers_it = watchers_.find(static_cast<Watch>(event->wd));
+    if (watchers_it == watchers_.end()) {
+      continue;
+    }
 
-  auto& watcher_map = watchers_it->second;
-  for (const auto& entry : watcher_map) {
-    auto& watcher_entry = entry.second;
-
-    FilePathWatcher::ChangeInfo change_info{
-        .file_path_type = event->mask & IN_ISDIR
-                              ? FilePathWatcher::FilePathType::kDirectory
-                              : FilePathWatcher::FilePathType::kFile,
-        .change_type = ToChangeType(event),
-        .cookie =
-            event->cookie ? std::make_optional(event->cookie) : std::nullopt,
-    };
-    bool created = event->mask & (IN_CREATE | IN_MOVED_TO);
-    bool deleted = event->mask & (IN_DELETE | IN_MOVED_FROM);
-    watcher_entry.task_runner->PostTask(
-        FROM_HERE,
-        BindOnce(&FilePathWatcherImpl::OnFilePathChanged, watcher_entry.watcher,
-                 static_cast<Watch>(event->wd), child, std::move(change_info),
-                 created, deleted));
+    FilePath::StringType child(event->len ? event->name
+                                          : FILE_PATH_LITERAL(""));
+    for (const auto& [watcher, watcher_entry] : watchers_it->second) {
+      WatcherEvents& watcher_events = events_by_watcher[watcher];
+      if (watcher_events.events.empty()) {
+        watcher_events.watcher_entry = watcher_entry;
+      }
+      watcher_events.events.push_back({
+          .watch = static_cast<Watch>(event->wd),
+          .child = child,
+          .change_info =
+              {
+                  .file_path_type =
+                      event->mask & IN_ISDIR
+                          ? FilePathWatcher::FilePathType::kDirectory
+                          : FilePathWatcher::FilePathType::kFile,
+                  .change_type = ToChangeType(event),
+                  .cookie = event->cookie ? std::make_optional(event->cookie)
+                                          : std::nullopt,
+              },
+          .created = static_cast<bool>(event->mask & (IN_CREATE | IN_MOVED_TO)),
+          .deleted =
+              static_cast<bool>(event->mask & (IN_DELETE | IN_MOVED_FROM)),
+      });
+    }
+  }
+
+  for (auto& [watcher, watcher_events] : events_by_watcher) {
+    watcher_events.watcher_entry.task_runner->PostTask(
+        FROM_HERE, BindOnce(&FilePathWatcherImpl::OnFilePathsChanged,
+                            watcher_events.watcher_entry.watcher,
+                            std::move(watcher_events.events)));
   }
 }
 
@@ -444,6 +522,19 @@ FilePathWatcherImpl::~FilePathWatcherImpl() {
                      task_runner()->RunsTasksInCurrentSequence());
 }
 
+void FilePathWatcherImpl::OnFilePathsChanged(
+    std::vector<InotifyEvent> events) {
+  WeakPtr<FilePathWatcherImpl> weak_this = weak_factory_.GetWeakPtr();
+  for (InotifyEvent& event : events) {
+    OnFilePathChanged(event.watch, event.child, std::move(event.change_info),
+                      event.created, event.deleted);
+    // The callback may have deleted `this`, and an error cancels the watch.
+    if (!weak_this || is_cancelled()) {
+      return;
+    }
+  }
+}
+
 void FilePathWatcherImpl::OnFilePathChanged(
     InotifyReader::Watch fired_watch,
     const FilePath::StringType& child,
@@ -532,8 +623,8 @@ void FilePathWatcherImpl::OnFilePathChanged(
       FilePath modified_path = report_modified_path_ && !change_on_target_path
                                    ? target_.Append(child)
                                    : target_;
-      callback_.Run(std::move(change_info), modified_path,
-                    /*error=*/false);  // `this` may be deleted.
+      ReportChange(std::move(change_info),
+                   modified_path);  // `this` may be deleted.
       return;
     }
   }
@@ -551,8 +642,8 @@ void FilePathWatcherImpl::OnFilePathChanged(
           report_modified_path_
               ? recursive_paths_by_watch_[fired_watch].Append(child)
               : target_;
-      callback_.Run(std::move(change_info), modified_path,
-                    /*error=*/false);  // `this` may be deleted.
+      ReportChange(std::move(change_info),
+                   modified_path);  // `this` may be deleted.
       return;
     }
   }
@@ -620,6 +711,22 @@ bool FilePathWatcherImpl::WatchWithChangeInfo(
   target_ = path;
   type_ = options.type;
   report_modified_path_ = options.report_modified_path;
+  coalescing_window_ = options.coalescing_window;
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  // Where the process may use fanotify, a recursive watch takes a single mark
+  // instead of an inotify watch per directory. fanotify needs the tree to
+  // exist, but then also sees it reappear.
+  if (type_ == Type::kRecursive && target_.IsAbsolute() &&
+      DirectoryExists(target_)) {
+    fanotify_watch_ = internal::FanotifyWatch::Create(
+        target_, BindRepeating(&FilePathWatcherImpl::OnFanotifyChange,
+                               weak_factory_.GetWeakPtr()));
+    if (fanotify_watch_) {
+      return true;
+    }
+  }
+#endif
 
   std::vector<FilePath::StringType> comps = target_.GetComponents();
   DUMP_WILL_BE_CHECK(!comps.empty());
@@ -649,6 +756,12 @@ void FilePathWatcherImpl::Cancel() {
 
   set_cancelled();
   callback_.Reset();
+  coalescing_timer_.Stop();
+  pending_changes_.clear();
+  pending_change_indices_.clear();
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  fanotify_watch_.reset();
+#endif
 
   for (const auto& watch : watches_)
     g_inotify_reader.Get().RemoveWatch(watch.watch, this);
@@ -684,7 +797,7 @@ bool FilePathWatcherImpl::UpdateWatches() {
     }
     if (old_watch != watch_entry.watch)
       g_inotify_reader.Get().RemoveWatch(old_watch, this);
-    path = path.Append(watch_entry.subdir);
+    path.AppendInPlace(watch_entry.subdir);
   }
 
   return UpdateRecursiveWatches(InotifyReader::kInvalidWatch, /*is_dir=*/false);
@@ -875,6 +988,59 @@ bool FilePathWatcherImpl::HasValidWatchVector() const {
   return watches_.back().subdir.empty();
 }
 
+void FilePathWatcherImpl::ReportChange(FilePathWatcher::ChangeInfo change_info,
+                                       const FilePath& path) {
+  if (coalescing_window_.is_zero()) {
+    callback_.Run(std::move(change_info), path,
+                  /*error=*/false);  // `this` may be deleted.
+    return;
+  }
+
+  auto [it, inserted] =
+      pending_change_indices_.try_emplace(path, pending_changes_.size());
+  if (inserted) {
+    pending_changes_.emplace_back(path, std::move(change_info));
+  } else {
+    // The latest change wins, except that a file which was created and then
+    // modified is reported as created.
+    FilePathWatcher::ChangeInfo& pending_change_info =
+        pending_changes_[it->second].second;
+    if (pending_change_info.change_type !=
+            FilePathWatcher::ChangeType::kCreated ||
+        change_info.change_type != FilePathWatcher::ChangeType::kModified) {
+      pending_change_info = std::move(change_info);
+    }
+  }
+  if (!coalescing_timer_.IsRunning()) {
+    coalescing_timer_.Start(FROM_HERE, coalescing_window_, this,
+                            &FilePathWatcherImpl::ReportPendingChanges);
+  }
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+void FilePathWatcherImpl::OnFanotifyChange(
+    const FilePathWatcher::ChangeInfo& change_info,
+    const FilePath& path) {
+  DUMP_WILL_BE_CHECK(task_runner()->RunsTasksInCurrentSequence());
+  ReportChange(change_info, report_modified_path_ ? path : target_);
+}
+#endif
+
+void FilePathWatcherImpl::ReportPendingChanges() {
+  DUMP_WILL_BE_CHECK(task_runner()->RunsTasksInCurrentSequence());
+  std::vector<std::pair<FilePath, FilePathWatcher::ChangeInfo>> changes;
+  changes.swap(pending_changes_);
+  pending_change_indices_.clear();
+
+  WeakPtr<FilePathWatcherImpl> weak_this = weak_factory_.GetWeakPtr();
+  for (auto& [path, change_info] : changes) {
+    callback_.Run(std::move(change_info), path, /*error=*/false);
+    if (!weak_this || is_cancelled()) {
+      return;
+    }
+  }
+}
+
 }  // namespace
 
 size_t GetMaxNumberOfInotifyWatches() {
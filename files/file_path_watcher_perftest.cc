@@ -0,0 +1,125 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/file_path_watcher.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/functional/bind.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "FilePathWatcher.";
+constexpr char kMetricWatchTime[] = "watch_time";
+constexpr char kMetricDeliveryTime[] = "delivery_time";
+constexpr char kMetricCallbacks[] = "callbacks";
+
+// 100k files, in few enough directories to stay well within the inotify
+// watch limit.
+constexpr size_t kDirectoryCount = 100;
+constexpr size_t kFilesPerDirectory = 1000;
+
+// Each file is rewritten this many times, as by a build. The files are
+// rewritten a round of directories at a time, so that inotify's queue of
+// events doesn't overflow.
+constexpr size_t kWritesPerFile = 3;
+constexpr size_t kDirectoriesPerRound = 2;
+
+class FilePathWatcherPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    for (size_t i = 0; i < kDirectoryCount; ++i) {
+      const FilePath dir =
+          temp_dir_.GetPath().AppendASCII("dir" + NumberToString(i));
+      ASSERT_TRUE(CreateDirectory(dir));
+      std::vector<FilePath>& files = files_.emplace_back();
+      for (size_t j = 0; j < kFilesPerDirectory; ++j) {
+        files.push_back(dir.AppendASCII("file" + NumberToString(j)));
+        ASSERT_TRUE(WriteFile(files.back(), ""));
+      }
+    }
+    sentinel_ = temp_dir_.GetPath().AppendASCII("sentinel");
+    ASSERT_TRUE(WriteFile(sentinel_, ""));
+  }
+
+  // Watches the tree recursively with `coalescing_window`, rewrites every
+  // file, and reports the time to set up the watch, the time until the last
+  // change is delivered, and the number of callbacks.
+  void RunTest(const std::string& story, TimeDelta coalescing_window) {
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+    reporter.RegisterImportantMetric(kMetricWatchTime, "ms");
+    reporter.RegisterImportantMetric(kMetricDeliveryTime, "ms");
+    reporter.RegisterImportantMetric(kMetricCallbacks, "count");
+
+    size_t callbacks = 0;
+    OnceClosure on_sentinel;
+    FilePathWatcher watcher;
+    TimeTicks start = TimeTicks::Now();
+    ASSERT_TRUE(watcher.WatchWithOptions(
+        temp_dir_.GetPath(),
+        {.type = FilePathWatcher::Type::kRecursive,
+         .report_modified_path = true,
+         .coalescing_window = coalescing_window},
+        BindLambdaForTesting([&](const FilePath& path, bool error) {
+          ASSERT_FALSE(error);
+          ++callbacks;
+          if (path == sentinel_ && on_sentinel) {
+            std::move(on_sentinel).Run();
+          }
+        })));
+    reporter.AddResult(kMetricWatchTime,
+                       (TimeTicks::Now() - start).InMillisecondsF());
+
+    start = TimeTicks::Now();
+    for (size_t round = 0; round < kDirectoryCount;
+         round += kDirectoriesPerRound) {
+      for (size_t i = 0; i < kWritesPerFile; ++i) {
+        for (size_t dir = round; dir < round + kDirectoriesPerRound; ++dir) {
+          for (const FilePath& file : files_[dir]) {
+            ASSERT_TRUE(WriteFile(file, "x"));
+          }
+        }
+      }
+      // The changes are delivered in order, so the sentinel's is the last.
+      RunLoop run_loop;
+      on_sentinel = run_loop.QuitClosure();
+      ASSERT_TRUE(WriteFile(sentinel_, "x"));
+      run_loop.Run();
+    }
+    reporter.AddResult(kMetricDeliveryTime,
+                       (TimeTicks::Now() - start).InMillisecondsF());
+    reporter.AddResult(kMetricCallbacks, static_cast<double>(callbacks));
+  }
+
+  test::TaskEnvironment task_environment_{
+      test::TaskEnvironment::MainThreadType::IO};
+  ScopedTempDir temp_dir_;
+  std::vector<std::vector<FilePath>> files_;
+  FilePath sentinel_;
+};
+
+}  // namespace
+
+TEST_F(FilePathWatcherPerfTest, RewriteTree) {
+  RunTest("Immediate", TimeDelta());
+  RunTest("Coalesced", Milliseconds(10));
+}
+
+}  // namespace base
@@ -50,6 +50,7 @@
 #endif  // BUILDFLAG(IS_POSIX)
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+#include "base/files/file_path_watcher_fanotify.h"
 #include "base/files/file_path_watcher_inotify.h"
 #include "base/format_macros.h"
 #endif
@@ -414,6 +415,13 @@ class FilePathWatcherTest : public testing::Test {
   test::TaskEnvironment task_environment_;
 
   ScopedTempDir temp_dir_;
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  // These tests are for inotify, which recursive watches would otherwise not
+  // use where the tests run with the capabilities for fanotify. See
+  // file_path_watcher_fanotify_unittest.cc for fanotify.
+  internal::ScopedFanotifyDisabledForTesting fanotify_disabled_;
+#endif
 };
 
 bool FilePathWatcherTest::SetupWatch(const FilePath& target,
@@ -1776,6 +1784,45 @@ TEST_F(FilePathWatcherTest, ReturnWatchedPath_NonRecursiveInRootFolder) {
   delegate.RunUntilEventsMatch(event_expecter);
 }
 
+TEST_F(FilePathWatcherTest, CoalescedChanges) {
+  FilePathWatcher directory_watcher;
+  FilePath watched_folder(temp_dir_.GetPath().AppendASCII("watched_folder"));
+  FilePath file1(watched_folder.AppendASCII("file1"));
+  FilePath file2(watched_folder.AppendASCII("file2"));
+
+  ASSERT_TRUE(CreateDirectory(watched_folder));
+
+  TestDelegate delegate;
+  ASSERT_TRUE(SetupWatchWithChangeInfo(
+      watched_folder, &directory_watcher, &delegate,
+      {.type = FilePathWatcher::Type::kRecursive,
+       .report_modified_path = true,
+       .coalescing_window = TestTimeouts::tiny_timeout()}));
+
+  // Each file is reported once, as created, although it is also modified.
+  const auto created_file1 =
+      testing::AllOf(HasPath(file1), IsFile(),
+                     IsType(FilePathWatcher::ChangeType::kCreated));
+  const auto created_file2 =
+      testing::AllOf(HasPath(file2), IsFile(),
+                     IsType(FilePathWatcher::ChangeType::kCreated));
+  ASSERT_TRUE(WriteFile(file1, "test"));
+  ASSERT_TRUE(WriteFile(file2, "test"));
+  ASSERT_TRUE(WriteFile(file1, "test123"));
+  delegate.RunUntilEventsMatch(
+      testing::ElementsAre(created_file1, created_file2));
+  delegate.RunUntilEventsMatch(
+      testing::ElementsAre(created_file1, created_file2),
+      ExpectedEventsSinceLastWait::kNone);
+
+  // The next change starts a new window.
+  ASSERT_TRUE(DeleteFile(file1));
+  delegate.RunUntilEventsMatch(testing::ElementsAre(
+      created_file1, created_file2,
+      testing::AllOf(HasPath(file1), IsFile(),
+                     IsType(FilePathWatcher::ChangeType::kDeleted))));
+}
+
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
 
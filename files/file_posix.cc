@@ -17,20 +17,25 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdint.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 static_assert(sizeof(base::stat_wrapper_t::st_size) >= 8);
 
+#include <algorithm>
 #include <atomic>
 #include <optional>
+#include <type_traits>
 
 #include "base/check_op.h"
 #include "base/feature_list.h"
 #include "base/metrics/field_trial_params.h"
 #include "base/notimplemented.h"
 #include "base/notreached.h"
+#include "base/numerics/clamped_math.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/strings/utf_string_conversions.h"
@@ -74,6 +79,72 @@ std::atomic<MacFileFlushMechanism> g_mac_file_flush_mechanism{
     MacFileFlushMechanism::kFullFsync};
 #endif  // BUILDFLAG(IS_APPLE)
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#define HAS_PREADV_PWRITEV 1
+#else
+#define HAS_PREADV_PWRITEV 0
+#endif
+
+#if HAS_PREADV_PWRITEV
+// Transfers `buffers` as if they were one buffer starting at `offset`, through
+// `io`, which is called with up to IOV_MAX iovecs and the file offset to
+// transfer them at, and returns the result of the preadv()-like call it makes.
+// Calls it again after short transfers, as Read() and Write() do.
+template <typename T, typename IoFunction>
+std::optional<size_t> TransferVectored(int64_t offset,
+                                       span<const span<T>> buffers,
+                                       IoFunction io) {
+  size_t size = 0;
+  for (span<T> buffer : buffers) {
+    size += buffer.size();
+  }
+  if (!IsValueInRangeForNumericType<off_t>(offset) ||
+      !IsValueInRangeForNumericType<off_t>(ClampAdd(offset, size))) {
+    return std::nullopt;
+  }
+
+  iovec iov[IOV_MAX];
+  size_t transferred = 0;
+  // The first buffer not fully transferred, and how much of it was.
+  size_t index = 0;
+  size_t index_done = 0;
+  while (transferred < size) {
+    int count = 0;
+    for (size_t i = index; i < buffers.size() && count < IOV_MAX; ++i) {
+      span<T> buffer = buffers[i];
+      if (i == index) {
+        buffer = buffer.subspan(index_done);
+      }
+      iov[count].iov_base = const_cast<std::remove_const_t<T>*>(buffer.data());
+      iov[count].iov_len = buffer.size();
+      ++count;
+    }
+    const ssize_t rv =
+        io(iov, count, static_cast<off_t>(offset) +
+                           static_cast<off_t>(transferred));
+    if (rv <= 0) {
+      if (rv < 0 && transferred == 0) {
+        return std::nullopt;
+      }
+      break;
+    }
+    transferred += static_cast<size_t>(rv);
+    size_t advance = static_cast<size_t>(rv);
+    while (advance > 0) {
+      const size_t left = buffers[index].size() - index_done;
+      if (advance < left) {
+        index_done += advance;
+        break;
+      }
+      advance -= left;
+      ++index;
+      index_done = 0;
+    }
+  }
+  return transferred;
+}
+#endif  // HAS_PREADV_PWRITEV
+
 // NaCl doesn't provide the following system calls, so either simulate them or
 // wrap them in order to minimize the number of #ifdef's in this file.
 #if !BUILDFLAG(IS_NACL) && !BUILDFLAG(IS_AIX)
@@ -400,6 +471,70 @@ int File::WriteAtCurrentPosNoBestEffort(const char* data, int size) {
       HANDLE_EINTR(write(file_.get(), data, static_cast<size_t>(size))));
 }
 
+std::optional<size_t> File::ReadV(int64_t offset,
+                                  span<const span<uint8_t>> buffers) {
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  DCHECK(IsValid());
+  SCOPED_FILE_TRACE("ReadV");
+
+#if HAS_PREADV_PWRITEV
+  return TransferVectored(
+      offset, buffers, [this](const iovec* iov, int count, off_t position) {
+        return HANDLE_EINTR(preadv(file_.get(), iov, count, position));
+      });
+#else
+  size_t bytes_read = 0;
+  for (span<uint8_t> buffer : buffers) {
+    std::optional<size_t> result =
+        Read(ClampAdd(offset, bytes_read), buffer);
+    if (!result) {
+      return bytes_read ? std::optional<size_t>(bytes_read) : std::nullopt;
+    }
+    bytes_read += *result;
+    if (*result < buffer.size()) {
+      break;
+    }
+  }
+  return bytes_read;
+#endif
+}
+
+std::optional<size_t> File::WriteV(int64_t offset,
+                                   span<const span<const uint8_t>> buffers) {
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  DCHECK(IsValid());
+  SCOPED_FILE_TRACE("WriteV");
+
+#if HAS_PREADV_PWRITEV
+  // pwritev() appends on Linux when the file was opened with O_APPEND, but
+  // writev() makes that explicit, as in Write().
+  const bool append = IsOpenAppend(file_.get());
+  return TransferVectored(
+      offset, buffers,
+      [this, append](const iovec* iov, int count, off_t position) {
+        if (append) {
+          return HANDLE_EINTR(writev(file_.get(), iov, count));
+        }
+        return HANDLE_EINTR(pwritev(file_.get(), iov, count, position));
+      });
+#else
+  size_t bytes_written = 0;
+  for (span<const uint8_t> buffer : buffers) {
+    std::optional<size_t> result =
+        Write(ClampAdd(offset, bytes_written), buffer);
+    if (!result) {
+      return bytes_written ? std::optional<size_t>(bytes_written)
+                           : std::nullopt;
+    }
+    bytes_written += *result;
+    if (*result < buffer.size()) {
+      break;
+    }
+  }
+  return bytes_written;
+#endif
+}
+
 int64_t File::GetLength() const {
   DCHECK(IsValid());
 
@@ -569,6 +704,11 @@ void File::DoInitialize(const FilePath& path, uint32_t flags) {
   if (flags & FLAG_TERMINAL_DEVICE)
     open_flags |= O_NOCTTY | O_NDELAY;
 
+#if defined(O_DIRECT)
+  if (flags & FLAG_DIRECT)
+    open_flags |= O_DIRECT;
+#endif
+
   if (flags & FLAG_APPEND && flags & FLAG_READ)
     open_flags |= O_APPEND | O_RDWR;
   else if (flags & FLAG_APPEND)
@@ -600,6 +740,13 @@ void File::DoInitialize(const FilePath& path, uint32_t flags) {
   if (flags & (FLAG_CREATE_ALWAYS | FLAG_CREATE))
     created_ = true;
 
+#if BUILDFLAG(IS_APPLE)
+  // There is no O_DIRECT on Apple platforms, but F_NOCACHE has the same
+  // effect.
+  if (flags & FLAG_DIRECT)
+    fcntl(descriptor, F_NOCACHE, 1);
+#endif
+
   if (flags & FLAG_DELETE_ON_CLOSE)
     unlink(path.value().c_str());
 
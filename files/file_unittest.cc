@@ -11,11 +11,16 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <string_view>
 #include <utility>
+#include <vector>
 
+#include "base/containers/span.h"
 #include "base/files/file_util.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/memory/aligned_memory.h"
 #include "base/strings/string_util.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
@@ -335,6 +340,95 @@ TEST(FileTest, ReadWriteSpans) {
   }
 }
 
+TEST(FileTest, ReadWriteVectored) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath file_path = temp_dir.GetPath().AppendASCII("read_write_file");
+  File file(file_path, base::File::FLAG_CREATE | base::File::FLAG_READ |
+                           base::File::FLAG_WRITE);
+  ASSERT_TRUE(file.IsValid());
+
+  // No buffers, and empty ones, are fine.
+  EXPECT_EQ(0u, file.WriteV(0, {}));
+  const std::string_view kHeader = "head";
+  const std::string_view kPayload = "payload";
+  const base::span<const uint8_t> to_write[] = {
+      base::as_byte_span(kHeader), base::span<const uint8_t>(),
+      base::as_byte_span(kPayload)};
+  EXPECT_EQ(11u, file.WriteV(2, to_write));
+
+  uint8_t a[3];
+  uint8_t b[5];
+  uint8_t c[16];
+  const base::span<uint8_t> to_read[] = {a, base::span<uint8_t>(), b, c};
+  // The file starts with a hole of two bytes, and the last buffer is only
+  // partly filled at EOF.
+  EXPECT_EQ(13u, file.ReadV(0, to_read));
+  EXPECT_EQ(std::string_view("\0\0h", 3), base::as_string_view(a));
+  EXPECT_EQ("eadpa", base::as_string_view(b));
+  EXPECT_EQ("yload", base::as_string_view(base::span(c).first(5u)));
+  EXPECT_EQ(0u, file.ReadV(13, to_read));
+
+  // Many more buffers than one call can take.
+  std::vector<uint8_t> bytes(3000);
+  std::vector<base::span<uint8_t>> singles;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<uint8_t>(i);
+    singles.emplace_back(&bytes[i], 1u);
+  }
+  EXPECT_EQ(bytes.size(), file.WriteV(0, std::vector<base::span<const uint8_t>>(
+                                             singles.begin(), singles.end())));
+  std::vector<uint8_t> read_back(bytes.size());
+  EXPECT_EQ(bytes.size(), file.Read(0, read_back));
+  EXPECT_EQ(bytes, read_back);
+  std::ranges::fill(bytes, 0);
+  EXPECT_EQ(bytes.size(), file.ReadV(0, singles));
+  EXPECT_EQ(read_back, bytes);
+}
+
+TEST(FileTest, ReadMany) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath file_path = temp_dir.GetPath().AppendASCII("read_many_file");
+  File file(file_path, base::File::FLAG_CREATE | base::File::FLAG_READ |
+                           base::File::FLAG_WRITE);
+  ASSERT_TRUE(file.IsValid());
+  ASSERT_TRUE(file.WriteAndCheck(0, base::as_byte_span(std::string_view(
+                                        "0123456789abcdefghij"))));
+
+  uint8_t a[4];
+  uint8_t b[4];
+  uint8_t c[2];
+  uint8_t d[8];
+  // `a` and `b` are adjacent, `c` is before them, and `d` runs past EOF.
+  const File::ReadRequest requests[] = {
+      {.offset = 4, .data = a},
+      {.offset = 8, .data = b},
+      {.offset = 0, .data = c},
+      {.offset = 16, .data = d},
+  };
+  size_t bytes_read[4];
+  ASSERT_TRUE(file.ReadMany(requests, bytes_read));
+  EXPECT_EQ(4u, bytes_read[0]);
+  EXPECT_EQ(4u, bytes_read[1]);
+  EXPECT_EQ(2u, bytes_read[2]);
+  EXPECT_EQ(4u, bytes_read[3]);
+  EXPECT_EQ("4567", base::as_string_view(a));
+  EXPECT_EQ("89ab", base::as_string_view(b));
+  EXPECT_EQ("01", base::as_string_view(c));
+  EXPECT_EQ("ghij", base::as_string_view(base::span(d).first(4u)));
+
+  // Adjacent requests past EOF.
+  const File::ReadRequest past_end[] = {
+      {.offset = 18, .data = c},
+      {.offset = 20, .data = a},
+  };
+  ASSERT_TRUE(file.ReadMany(past_end, base::span(bytes_read).first(2u)));
+  EXPECT_EQ(2u, bytes_read[0]);
+  EXPECT_EQ(0u, bytes_read[1]);
+  EXPECT_EQ("ij", base::as_string_view(c));
+}
+
 TEST(FileTest, GetLastFileError) {
 #if BUILDFLAG(IS_WIN)
   ::SetLastError(ERROR_ACCESS_DENIED);
@@ -769,6 +863,33 @@ TEST(FileTest, MAYBE_WriteDataToLargeOffset) {
   ASSERT_EQ(kDataLen, file.Write(kLargeFileOffset + 1, kData, kDataLen));
 }
 
+TEST(FileTest, Direct) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath file_path = temp_dir.GetPath().AppendASCII("file");
+  std::vector<uint8_t> data(3 * File::kDirectIOAlignment + 100);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  ASSERT_TRUE(base::WriteFile(file_path, data));
+
+  File file(file_path, File::FLAG_OPEN | File::FLAG_READ | File::FLAG_DIRECT);
+  if (!file.IsValid()) {
+    // The temporary directory may be on a file system without direct I/O.
+    GTEST_SKIP() << File::ErrorToString(file.error_details());
+  }
+  base::AlignedHeapArray<uint8_t> buffer =
+      base::AlignedUninit<uint8_t>(2 * File::kDirectIOAlignment,
+                                   File::kDirectIOAlignment);
+  EXPECT_EQ(buffer.size(),
+            file.Read(File::kDirectIOAlignment, buffer.as_span()));
+  EXPECT_EQ(base::span(data).subspan(File::kDirectIOAlignment, buffer.size()),
+            buffer.as_span());
+  // The read at the end of the file is short.
+  EXPECT_EQ(File::kDirectIOAlignment + 100,
+            file.Read(2 * File::kDirectIOAlignment, buffer.as_span()));
+}
+
 TEST(FileTest, AddFlagsForPassingToUntrustedProcess) {
   {
     uint32_t flags = base::File::FLAG_OPEN | base::File::FLAG_READ;
@@ -26,11 +26,13 @@
 #include "base/bit_cast.h"
 #include "base/check_op.h"
 #include "base/containers/contains.h"
+#include "base/containers/heap_array.h"
 #include "base/containers/span.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/functional/function_ref.h"
 #include "base/notreached.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/ranges/algorithm.h"
 #include "base/strings/string_piece.h"
@@ -44,6 +46,10 @@
 #include <windows.h>
 #endif
 
+#if BUILDFLAG(IS_POSIX)
+#include <fcntl.h>
+#endif
+
 namespace base {
 
 namespace {
@@ -139,6 +145,80 @@ bool ReadStreamToSpanWithMaxSize(
   return read_status;
 }
 
+// As ReadStreamToSpanWithMaxSize(), but reading from |file|'s current position
+// without the copies through a stream's buffer. The size of the file is only
+// a hint, as for a stream: when the file is as large as it claims, which is
+// the common case, reading takes one fstat() and one read() into a buffer of
+// exactly its size, and otherwise reads on until the end.
+bool ReadFileToSpanWithMaxSize(File& file,
+                               size_t max_size,
+                               FunctionRef<span<uint8_t>(size_t)> resize_span) {
+  if (!file.IsValid()) {
+    return false;
+  }
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+
+  constexpr size_t kSmallChunkSize = 4096;
+  constexpr size_t kDefaultChunkSize = 1 << 16;
+  // Never reads more than one byte past |max_size|, which is enough to tell
+  // that the file is too large.
+  const size_t limit = max_size == std::numeric_limits<size_t>::max()
+                           ? max_size
+                           : max_size + 1;
+  // 0 for files of unknown size, such as pipes and most proc files.
+  const int64_t length = file.GetLength();
+  const size_t size_hint = length > 0 ? saturated_cast<size_t>(length) : 0;
+
+  // One more byte than the hint, to see the end of the file in the first
+  // read.
+  size_t capacity = std::min(kSmallChunkSize, limit);
+  if (size_hint > 0) {
+    capacity = size_hint < limit ? size_hint + 1 : limit;
+  }
+  span<uint8_t> buffer = resize_span(capacity);
+  DCHECK_EQ(buffer.size(), capacity);
+  size_t bytes_read = 0;
+  bool read_status = true;
+  for (;;) {
+    const size_t chunk_size = std::min(
+        buffer.size() - bytes_read,
+        static_cast<size_t>(std::numeric_limits<int>::max()));
+    const int bytes_read_this_pass = file.ReadAtCurrentPosNoBestEffort(
+        reinterpret_cast<char*>(buffer.data() + bytes_read),
+        static_cast<int>(chunk_size));
+    if (bytes_read_this_pass < 0) {
+      read_status = false;
+      break;
+    }
+    bytes_read += static_cast<size_t>(bytes_read_this_pass);
+    if (bytes_read > max_size) {
+      // Read more than max_size bytes, bail out.
+      bytes_read = max_size;
+      read_status = false;
+      break;
+    }
+    // A short read up to the size of the file is at its end, which saves the
+    // read() that would return 0.
+    if (bytes_read_this_pass == 0 ||
+        (bytes_read == size_hint && bytes_read < buffer.size())) {
+      break;
+    }
+    if (bytes_read == buffer.size()) {
+      capacity = limit - bytes_read > kDefaultChunkSize
+                     ? bytes_read + kDefaultChunkSize
+                     : limit;
+      buffer = resize_span(capacity);
+      DCHECK_EQ(buffer.size(), capacity);
+    }
+  }
+
+  // Trim the container down to the number of bytes that were actually read.
+  buffer = resize_span(bytes_read);
+  DCHECK_EQ(buffer.size(), bytes_read);
+
+  return read_status;
+}
+
 }  // namespace
 
 #if !BUILDFLAG(IS_WIN)
@@ -180,9 +260,18 @@ bool Move(const FilePath& from_path, const FilePath& to_path) {
 
 bool CopyFileContents(File& infile, File& outfile) {
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // From the fastest to the most widely supported: sharing the data, letting
+  // the file system copy it, and copying it in the kernel.
+  if (internal::CloneFileContents(infile, outfile)) {
+    return true;
+  }
   bool retry_slow = false;
   bool res =
-      internal::CopyFileContentsWithSendfile(infile, outfile, retry_slow);
+      internal::CopyFileContentsWithCopyFileRange(infile, outfile, retry_slow);
+  if (res || !retry_slow) {
+    return res;
+  }
+  res = internal::CopyFileContentsWithSendfile(infile, outfile, retry_slow);
   if (res || !retry_slow) {
     return res;
   }
@@ -329,23 +418,56 @@ bool ReadStreamToStringWithMaxSize(FILE* stream,
   return read_successs;
 }
 
-std::optional<std::vector<uint8_t>> ReadFileToBytes(const FilePath& path) {
-  if (path.ReferencesParent()) {
-    return std::nullopt;
+bool ReadFileInChunks(File& file,
+                      FunctionRef<void(span<const uint8_t>)> on_chunk) {
+  // posix_fadvise() is only available in the Android NDK in API 21+, see
+  // PreReadFile(). Failing to give the hint only makes reading slower.
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    (BUILDFLAG(IS_ANDROID) && __ANDROID_API__ >= 21)
+  posix_fadvise(file.GetPlatformFile(), /*offset=*/0, /*len=*/0,
+                POSIX_FADV_SEQUENTIAL);
+#endif
+
+  // Large enough that the system calls don't matter, small enough that each
+  // chunk is still in the cache when |on_chunk| processes it.
+  static constexpr size_t kChunkSize = 256 * 1024;
+  auto buffer = HeapArray<uint8_t>::Uninit(kChunkSize);
+  for (;;) {
+    const std::optional<size_t> bytes_read = file.ReadAtCurrentPos(buffer);
+    if (!bytes_read) {
+      return false;
+    }
+    if (*bytes_read == 0) {
+      return true;
+    }
+    on_chunk(buffer.first(*bytes_read));
   }
+}
 
-  ScopedFILE file_stream(OpenFile(path, "rb"));
-  if (!file_stream) {
+std::optional<std::vector<uint8_t>> ReadFileToBytes(const FilePath& path) {
+  if (path.ReferencesParent()) {
     return std::nullopt;
   }
 
   std::vector<uint8_t> bytes;
-  if (!ReadStreamToSpanWithMaxSize(file_stream.get(),
-                                   std::numeric_limits<size_t>::max(),
-                                   [&bytes](size_t size) {
-                                     bytes.resize(size);
-                                     return make_span(bytes);
-                                   })) {
+  auto resize_span = [&bytes](size_t size) {
+    bytes.resize(size);
+    return make_span(bytes);
+  };
+#if BUILDFLAG(IS_WIN)
+  // Unlike File, the C runtime reads a named pipe up to the end of what its
+  // writer wrote.
+  ScopedFILE file_stream(OpenFile(path, "rb"));
+  const bool read_success =
+      file_stream && ReadStreamToSpanWithMaxSize(
+                         file_stream.get(), std::numeric_limits<size_t>::max(),
+                         resize_span);
+#else
+  File file(path, File::FLAG_OPEN | File::FLAG_READ);
+  const bool read_success = ReadFileToSpanWithMaxSize(
+      file, std::numeric_limits<size_t>::max(), resize_span);
+#endif  // BUILDFLAG(IS_WIN)
+  if (!read_success) {
     return std::nullopt;
   }
   return bytes;
@@ -363,10 +485,37 @@ bool ReadFileToStringWithMaxSize(const FilePath& path,
     contents->clear();
   if (path.ReferencesParent())
     return false;
+#if BUILDFLAG(IS_WIN)
+  // Unlike File, the C runtime reads a named pipe up to the end of what its
+  // writer wrote.
   ScopedFILE file_stream(OpenFile(path, "rb"));
   if (!file_stream)
     return false;
   return ReadStreamToStringWithMaxSize(file_stream.get(), max_size, contents);
+#else
+  File file(path, File::FLAG_OPEN | File::FLAG_READ);
+  return ReadFileToStringWithMaxSize(file, contents, max_size);
+#endif  // BUILDFLAG(IS_WIN)
+}
+
+bool ReadFileToStringWithMaxSize(File& file,
+                                 std::string* contents,
+                                 size_t max_size) {
+  if (contents) {
+    contents->clear();
+  }
+
+  std::string content_string;
+  bool read_success = ReadFileToSpanWithMaxSize(
+      file, max_size, [&content_string](size_t size) {
+        content_string.resize(size);
+        return as_writable_bytes(make_span(content_string));
+      });
+
+  if (contents) {
+    contents->swap(content_string);
+  }
+  return read_success;
 }
 
 bool IsDirectoryEmpty(const FilePath& dir_path) {
@@ -23,6 +23,7 @@
 #include "base/files/file_path.h"
 #include "base/files/scoped_file.h"
 #include "base/functional/callback.h"
+#include "base/functional/function_ref.h"
 #include "base/strings/cstring_view.h"
 #include "base/types/pass_key.h"
 #include "build/build_config.h"
@@ -276,6 +277,14 @@ BASE_EXPORT bool ReadFileToStringWithMaxSize(const FilePath& path,
                                              std::string* contents,
                                              size_t max_size);
 
+// As ReadFileToStringWithMaxSize, but reading from the current position of
+// |file| to its end. The size of |file| is taken as a hint, so that a file as
+// large as it claims is read into a buffer of exactly its size with a single
+// read.
+BASE_EXPORT bool ReadFileToStringWithMaxSize(File& file,
+                                             std::string* contents,
+                                             size_t max_size);
+
 // As ReadFileToString, but reading from an open stream after seeking to its
 // start (if supported by the stream). This can also be used to read the whole
 // file from a file descriptor by converting the file descriptor into a stream
@@ -288,6 +297,15 @@ BASE_EXPORT bool ReadStreamToStringWithMaxSize(FILE* stream,
                                                size_t max_size,
                                                std::string* contents);
 
+// Reads |file| from its current position to its end and passes the data to
+// |on_chunk| a chunk at a time, so that e.g. hashing a large file doesn't need
+// all of it in memory. Hints the OS to read ahead where supported; on Windows,
+// open |file| with File::FLAG_WIN_SEQUENTIAL_SCAN for the same effect. Returns
+// false if reading fails, after passing what could be read.
+BASE_EXPORT bool ReadFileInChunks(
+    File& file,
+    FunctionRef<void(span<const uint8_t>)> on_chunk);
+
 #if BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
 
 // Reads exactly as many bytes as `buffer` can hold from file descriptor `fd`
@@ -769,6 +787,21 @@ BASE_EXPORT bool CopyAndDeleteDirectory(const FilePath& from_path,
 BASE_EXPORT bool CopyFileContentsWithSendfile(File& infile,
                                               File& outfile,
                                               bool& retry_slow);
+
+// CopyFileContentsWithCopyFileRange is like CopyFileContentsWithSendfile, but
+// uses the copy_file_range(2) syscall, which lets the file system copy the
+// data itself, e.g. by sharing extents or with a server-side copy, and works
+// only between regular files.
+BASE_EXPORT bool CopyFileContentsWithCopyFileRange(File& infile,
+                                                   File& outfile,
+                                                   bool& retry_slow);
+
+// CloneFileContents makes |outfile| share the data of |infile| with the
+// FICLONE ioctl on file systems which support it (btrfs, XFS, ...), which
+// takes constant time. Returns false, without having changed either file, if
+// this is not possible, which includes unless both file positions are at the
+// start and |outfile| is empty.
+BASE_EXPORT bool CloneFileContents(File& infile, File& outfile);
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
 
@@ -25,8 +25,11 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <bit>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/base_switches.h"
@@ -54,6 +57,9 @@
 #include "base/strings/sys_string_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/system/sys_info.h"
+#include "base/task/parallel_algorithms.h"
+#include "base/task/scoped_set_task_priority_for_current_thread.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "base/time/time.h"
 #include "build/branding_buildflags.h"
@@ -65,7 +71,14 @@
 #endif
 
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
 #include <sys/sendfile.h>
+#include <sys/syscall.h>
+
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
 #endif
 
 #if BUILDFLAG(IS_ANDROID)
@@ -142,6 +155,65 @@ bool AdvanceEnumeratorWithStat(FileEnumerator* traversal,
   return true;
 }
 
+// Copies the regular file |from_path| for DoCopyDirectory(). Returns true if
+// it was copied or skipped, as it is not a regular file.
+bool CopyDirectoryFile(const FilePath& from_path,
+                       const FilePath& to_path,
+                       bool open_exclusive) {
+  // Add O_NONBLOCK so we can't block opening a pipe.
+  File infile(open(from_path.value().c_str(), O_RDONLY | O_NONBLOCK));
+  if (!infile.IsValid()) {
+    DPLOG(ERROR) << "CopyDirectory() couldn't open file: " << from_path.value();
+    return false;
+  }
+
+  stat_wrapper_t stat_at_use;
+  if (File::Fstat(infile.GetPlatformFile(), &stat_at_use) < 0) {
+    DPLOG(ERROR) << "CopyDirectory() couldn't stat file: " << from_path.value();
+    return false;
+  }
+
+  if (!S_ISREG(stat_at_use.st_mode)) {
+    DLOG(WARNING) << "CopyDirectory() skipping non-regular file: "
+                  << from_path.value();
+    return true;
+  }
+
+  int open_flags = O_WRONLY | O_CREAT;
+  // If |open_exclusive| is set then we should always create the destination
+  // file, so O_NONBLOCK is not necessary to ensure we don't block on the
+  // open call for the target file below, and since the destination will
+  // always be a regular file it wouldn't affect the behavior of the
+  // subsequent write calls anyway.
+  if (open_exclusive)
+    open_flags |= O_EXCL;
+  else
+    open_flags |= O_TRUNC | O_NONBLOCK;
+  // Each platform has different default file opening modes for CopyFile which
+  // we want to replicate here. On OS X, we use copyfile(3) which takes the
+  // source file's permissions into account. On the other platforms, we just
+  // use the base::File constructor. On Chrome OS, base::File uses a different
+  // set of permissions than it does on other POSIX platforms.
+#if BUILDFLAG(IS_APPLE)
+  mode_t mode = 0600 | (stat_at_use.st_mode & 0177);
+#elif BUILDFLAG(IS_CHROMEOS)
+  mode_t mode = 0644;
+#else
+  mode_t mode = 0600;
+#endif
+  File outfile(open(to_path.value().c_str(), open_flags, mode));
+  if (!outfile.IsValid()) {
+    DPLOG(ERROR) << "CopyDirectory() couldn't create file: " << to_path.value();
+    return false;
+  }
+
+  if (!CopyFileContents(infile, outfile)) {
+    DLOG(ERROR) << "CopyDirectory() couldn't copy file: " << from_path.value();
+    return false;
+  }
+  return true;
+}
+
 bool DoCopyDirectory(const FilePath& from_path,
                      const FilePath& to_path,
                      bool recursive,
@@ -198,6 +270,8 @@ bool DoCopyDirectory(const FilePath& from_path,
   // TODO(maruel): This is not necessary anymore.
   DCHECK(recursive || S_ISDIR(from_stat.st_mode));
 
+  // Directories are created as they are found, then the files are copied.
+  std::vector<std::pair<FilePath, FilePath>> files;
   do {
     // current is the source path, including from_path, so append
     // the suffix after from_path to to_path to create the target_path.
@@ -225,60 +299,30 @@ bool DoCopyDirectory(const FilePath& from_path,
       continue;
     }
 
-    // Add O_NONBLOCK so we can't block opening a pipe.
-    File infile(open(current.value().c_str(), O_RDONLY | O_NONBLOCK));
-    if (!infile.IsValid()) {
-      DPLOG(ERROR) << "CopyDirectory() couldn't open file: " << current.value();
-      return false;
-    }
-
-    stat_wrapper_t stat_at_use;
-    if (File::Fstat(infile.GetPlatformFile(), &stat_at_use) < 0) {
-      DPLOG(ERROR) << "CopyDirectory() couldn't stat file: " << current.value();
-      return false;
-    }
-
-    if (!S_ISREG(stat_at_use.st_mode)) {
-      DLOG(WARNING) << "CopyDirectory() skipping non-regular file: "
-                    << current.value();
-      continue;
-    }
-
-    int open_flags = O_WRONLY | O_CREAT;
-    // If |open_exclusive| is set then we should always create the destination
-    // file, so O_NONBLOCK is not necessary to ensure we don't block on the
-    // open call for the target file below, and since the destination will
-    // always be a regular file it wouldn't affect the behavior of the
-    // subsequent write calls anyway.
-    if (open_exclusive)
-      open_flags |= O_EXCL;
-    else
-      open_flags |= O_TRUNC | O_NONBLOCK;
-    // Each platform has different default file opening modes for CopyFile which
-    // we want to replicate here. On OS X, we use copyfile(3) which takes the
-    // source file's permissions into account. On the other platforms, we just
-    // use the base::File constructor. On Chrome OS, base::File uses a different
-    // set of permissions than it does on other POSIX platforms.
-#if BUILDFLAG(IS_APPLE)
-    mode_t mode = 0600 | (stat_at_use.st_mode & 0177);
-#elif BUILDFLAG(IS_CHROMEOS)
-    mode_t mode = 0644;
-#else
-    mode_t mode = 0600;
-#endif
-    File outfile(open(target_path.value().c_str(), open_flags, mode));
-    if (!outfile.IsValid()) {
-      DPLOG(ERROR) << "CopyDirectory() couldn't create file: "
-                   << target_path.value();
-      return false;
-    }
+    files.emplace_back(current, std::move(target_path));
+  } while (AdvanceEnumeratorWithStat(&traversal, &current, &from_stat));
 
-    if (!CopyFileContents(infile, outfile)) {
-      DLOG(ERROR) << "CopyDirectory() couldn't copy file: " << current.value();
+  // Copying many files is bound by the latency of each, so overlap them on
+  // the thread pool if there is one.
+  if (files.size() > 1 && ThreadPoolInstance::Get()) {
+    std::atomic<bool> success{true};
+    ParallelFor(
+        FROM_HERE,
+        {MayBlock(), internal::GetTaskPriorityForCurrentThread()},
+        span(files),
+        [&](const std::pair<FilePath, FilePath>& file) {
+          if (!CopyDirectoryFile(file.first, file.second, open_exclusive)) {
+            success.store(false, std::memory_order_relaxed);
+          }
+        },
+        {.grain_size = 1});
+    return success.load(std::memory_order_relaxed);
+  }
+  for (const auto& [from_file, to_file] : files) {
+    if (!CopyDirectoryFile(from_file, to_file, open_exclusive)) {
       return false;
     }
-  } while (AdvanceEnumeratorWithStat(&traversal, &current, &from_stat));
-
+  }
   return true;
 }
 
@@ -1414,6 +1458,90 @@ bool CopyFileContentsWithSendfile(File& infile,
 
   return res >= 0;
 }
+
+bool CopyFileContentsWithCopyFileRange(File& infile,
+                                       File& outfile,
+                                       bool& retry_slow) {
+  DCHECK(infile.IsValid());
+  stat_wrapper_t in_file_info;
+  retry_slow = false;
+
+  if (base::File::Fstat(infile.GetPlatformFile(), &in_file_info)) {
+    return false;
+  }
+
+  int64_t file_size = in_file_info.st_size;
+  if (file_size < 0)
+    return false;
+  if (file_size == 0) {
+    // As for sendfile(2), this may be a file whose size isn't known.
+    retry_slow = true;
+    return false;
+  }
+
+#if defined(__NR_copy_file_range)
+  size_t copied = 0;
+  long res = 0;
+  do {
+    // Called directly, as not all C libraries have a wrapper. Without offsets
+    // the kernel reads and writes at the current file offsets.
+    res = HANDLE_EINTR(syscall(
+        __NR_copy_file_range, infile.GetPlatformFile(), /*off_in=*/nullptr,
+        outfile.GetPlatformFile(), /*off_out=*/nullptr,
+        /*len=*/static_cast<size_t>(file_size) - copied, /*flags=*/0u));
+    if (res <= 0) {
+      break;
+    }
+
+    copied += static_cast<size_t>(res);
+  } while (copied < static_cast<size_t>(file_size));
+
+  // copy_file_range(2) fails before copying anything for unsupported files:
+  // EXDEV across file systems on kernels before 5.3, EINVAL for non-regular
+  // files, EBADF if |outfile| is in append mode, and ENOSYS, EOPNOTSUPP or
+  // EPERM where it is not available. Some kernels also copy nothing from
+  // files like those of procfs. The file offsets are then unchanged.
+  retry_slow = copied == 0 &&
+               (res == 0 || (res < 0 && (errno == EXDEV || errno == EINVAL ||
+                                         errno == EBADF || errno == ENOSYS ||
+                                         errno == EOPNOTSUPP ||
+                                         errno == EPERM)));
+  return !retry_slow && res >= 0;
+#else
+  retry_slow = true;
+  return false;
+#endif  // defined(__NR_copy_file_range)
+}
+
+bool CloneFileContents(File& infile, File& outfile) {
+  DCHECK(infile.IsValid());
+  DCHECK(outfile.IsValid());
+  stat_wrapper_t in_file_info;
+  stat_wrapper_t out_file_info;
+  if (File::Fstat(infile.GetPlatformFile(), &in_file_info) ||
+      File::Fstat(outfile.GetPlatformFile(), &out_file_info)) {
+    return false;
+  }
+
+  // A clone replaces all of |outfile| with all of |infile|, which is what
+  // copying from the current positions does only in this case.
+  if (!S_ISREG(in_file_info.st_mode) || !S_ISREG(out_file_info.st_mode) ||
+      in_file_info.st_size == 0 || out_file_info.st_size != 0 ||
+      infile.Seek(File::FROM_CURRENT, 0) != 0 ||
+      outfile.Seek(File::FROM_CURRENT, 0) != 0) {
+    return false;
+  }
+
+  if (HANDLE_EINTR(ioctl(outfile.GetPlatformFile(), FICLONE,
+                         infile.GetPlatformFile())) != 0) {
+    return false;
+  }
+
+  // Leave the file positions where a copy would have.
+  const int64_t size = in_file_info.st_size;
+  return infile.Seek(File::FROM_BEGIN, size) == size &&
+         outfile.Seek(File::FROM_BEGIN, size) == size;
+}
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
 
@@ -37,6 +37,7 @@
 #include "base/path_service.h"
 #include "base/rand_util.h"
 #include "base/scoped_environment_variable_override.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
@@ -64,7 +65,6 @@
 #include <shlobj.h>
 
 #include "base/scoped_native_library.h"
-#include "base/strings/string_number_conversions.h"
 #include "base/test/file_path_reparse_point_win.h"
 #include "base/test/gtest_util.h"
 #include "base/win/scoped_handle.h"
@@ -2169,6 +2169,35 @@ TEST_F(FileUtilTest, CopyDirectoryNew) {
   EXPECT_FALSE(PathExists(subdir_name_to));
 }
 
+TEST_F(FileUtilTest, CopyDirectoryManyFiles) {
+  // With a thread pool, the files are copied in parallel.
+  test::TaskEnvironment task_environment;
+  FilePath dir_name_from =
+      temp_dir_.GetPath().Append(FILE_PATH_LITERAL("Copy_From_Subdir"));
+  FilePath subdir_name_from = dir_name_from.Append(FILE_PATH_LITERAL("Subdir"));
+  ASSERT_TRUE(CreateDirectory(subdir_name_from));
+  for (int i = 0; i < 20; ++i) {
+    const std::string name = "file" + NumberToString(i);
+    ASSERT_TRUE(WriteFile(dir_name_from.AppendASCII(name), name));
+    ASSERT_TRUE(WriteFile(subdir_name_from.AppendASCII(name), name + "sub"));
+  }
+
+  FilePath dir_name_to =
+      temp_dir_.GetPath().Append(FILE_PATH_LITERAL("Copy_To_Subdir"));
+  EXPECT_TRUE(CopyDirectory(dir_name_from, dir_name_to, true));
+
+  for (int i = 0; i < 20; ++i) {
+    const std::string name = "file" + NumberToString(i);
+    std::string contents;
+    EXPECT_TRUE(ReadFileToString(dir_name_to.AppendASCII(name), &contents));
+    EXPECT_EQ(name, contents);
+    EXPECT_TRUE(ReadFileToString(
+        dir_name_to.Append(FILE_PATH_LITERAL("Subdir")).AppendASCII(name),
+        &contents));
+    EXPECT_EQ(name + "sub", contents);
+  }
+}
+
 TEST_F(FileUtilTest, CopyDirectoryExists) {
   // Create a directory.
   FilePath dir_name_from =
@@ -3481,6 +3510,34 @@ TEST_F(FileUtilTest, ReadFileToString) {
   EXPECT_EQ(0u, data.length());
 }
 
+TEST_F(FileUtilTest, ReadFileToStringFromFile) {
+  FilePath file_path =
+      temp_dir_.GetPath().Append(FILE_PATH_LITERAL("ReadFileToStringTest"));
+  // Larger than the chunks in which files of unknown size are read.
+  std::string test_data(kLargeFileSize, 'x');
+  test_data.replace(0, 4, "0123");
+  ASSERT_TRUE(WriteFile(file_path, test_data));
+
+  File file(file_path, File::FLAG_OPEN | File::FLAG_READ);
+  ASSERT_TRUE(file.IsValid());
+  std::string data = "temp";
+  EXPECT_TRUE(ReadFileToStringWithMaxSize(file, &data, kLargeFileSize));
+  EXPECT_EQ(test_data, data);
+
+  // Reads from the current position.
+  ASSERT_EQ(2, file.Seek(File::FROM_BEGIN, 2));
+  EXPECT_FALSE(ReadFileToStringWithMaxSize(file, &data, 2));
+  EXPECT_EQ("23", data);
+  ASSERT_EQ(2, file.Seek(File::FROM_BEGIN, 2));
+  EXPECT_TRUE(ReadFileToStringWithMaxSize(file, &data, kLargeFileSize));
+  EXPECT_EQ(test_data.substr(2), data);
+
+  file.Close();
+  data = "temp";
+  EXPECT_FALSE(ReadFileToStringWithMaxSize(file, &data, kLargeFileSize));
+  EXPECT_EQ(0u, data.length());
+}
+
 #if !BUILDFLAG(IS_WIN)
 TEST_F(FileUtilTest, ReadFileToStringWithUnknownFileSize) {
 #if BUILDFLAG(IS_FUCHSIA)
@@ -4769,6 +4826,98 @@ TEST_F(FileUtilTest, CopyFileContentsWithSendfileSocket) {
   ASSERT_TRUE(retry_slow);
 }
 
+TEST_F(FileUtilTest, CopyFileContentsWithCopyFileRange) {
+  // As CopyFileContentsWithSendfile, this honors the file offsets.
+  FilePath file_name_from = temp_dir_.GetPath().Append(
+      FILE_PATH_LITERAL("copy_contents_file_in.txt"));
+  FilePath file_name_to = temp_dir_.GetPath().Append(
+      FILE_PATH_LITERAL("copy_contents_file_out.txt"));
+  CreateTextFile(file_name_from, L"0123456789ABCDEF");
+  CreateTextFile(file_name_to, L"GHIJKL");
+
+  File from(file_name_from, File::FLAG_OPEN | File::FLAG_READ);
+  ASSERT_TRUE(from.IsValid());
+  File to(file_name_to, File::FLAG_OPEN | File::FLAG_WRITE);
+  ASSERT_TRUE(to.IsValid());
+  ASSERT_EQ(from.Seek(File::Whence::FROM_BEGIN, 1), 1);
+  ASSERT_EQ(to.Seek(File::Whence::FROM_BEGIN, 1), 1);
+
+  bool retry_slow = false;
+  if (!internal::CopyFileContentsWithCopyFileRange(from, to, retry_slow)) {
+    // Not supported between these files; nothing was copied.
+    ASSERT_TRUE(retry_slow);
+    GTEST_SKIP();
+  }
+  EXPECT_EQ(to.Seek(File::Whence::FROM_CURRENT, 0), 16);
+  from.Close();
+  to.Close();
+  EXPECT_EQ(L"G123456789ABCDEF", ReadTextFile(file_name_to));
+}
+
+TEST_F(FileUtilTest, CopyFileContentsWithCopyFileRangeUnsupported) {
+  FilePath file_name_to = temp_dir_.GetPath().Append(
+      FILE_PATH_LITERAL("copy_contents_file_out.txt"));
+  File to(file_name_to,
+          File::FLAG_OPEN | File::FLAG_WRITE | File::FLAG_CREATE_ALWAYS);
+  ASSERT_TRUE(to.IsValid());
+
+  // Only regular files are supported.
+  int fd[2];
+  ASSERT_EQ(pipe2(fd, O_CLOEXEC), 0);
+  ScopedFD write_end(fd[1]);
+  ASSERT_TRUE(WriteFileDescriptor(fd[1], "hello world"));
+  File pipe_read(fd[0]);
+  bool retry_slow = false;
+  EXPECT_FALSE(
+      internal::CopyFileContentsWithCopyFileRange(pipe_read, to, retry_slow));
+  EXPECT_TRUE(retry_slow);
+
+  // Neither are files whose size isn't known.
+  File proc_file(FilePath("/proc/self/status"),
+                 File::FLAG_OPEN | File::FLAG_READ);
+  ASSERT_TRUE(proc_file.IsValid());
+  EXPECT_FALSE(
+      internal::CopyFileContentsWithCopyFileRange(proc_file, to, retry_slow));
+  EXPECT_TRUE(retry_slow);
+
+  // Which CopyFileContents() still copies.
+  EXPECT_TRUE(CopyFileContents(proc_file, to));
+  to.Close();
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(file_name_to, &contents));
+  EXPECT_FALSE(contents.empty());
+}
+
+TEST_F(FileUtilTest, CloneFileContents) {
+  FilePath file_name_from = temp_dir_.GetPath().Append(
+      FILE_PATH_LITERAL("copy_contents_file_in.txt"));
+  FilePath file_name_to = temp_dir_.GetPath().Append(
+      FILE_PATH_LITERAL("copy_contents_file_out.txt"));
+  CreateTextFile(file_name_from, L"0123456789ABCDEF");
+
+  File from(file_name_from, File::FLAG_OPEN | File::FLAG_READ);
+  ASSERT_TRUE(from.IsValid());
+  File to(file_name_to,
+          File::FLAG_OPEN | File::FLAG_WRITE | File::FLAG_CREATE_ALWAYS);
+  ASSERT_TRUE(to.IsValid());
+
+  // A clone isn't a copy from the current positions unless both are 0.
+  ASSERT_EQ(from.Seek(File::Whence::FROM_BEGIN, 1), 1);
+  EXPECT_FALSE(internal::CloneFileContents(from, to));
+  EXPECT_EQ(from.Seek(File::Whence::FROM_CURRENT, 0), 1);
+  ASSERT_EQ(from.Seek(File::Whence::FROM_BEGIN, 0), 0);
+
+  // Whether it is supported depends on the file system.
+  if (!internal::CloneFileContents(from, to)) {
+    EXPECT_EQ(to.GetLength(), 0);
+    GTEST_SKIP() << "The temporary directory doesn't support reflinks";
+  }
+  EXPECT_EQ(from.Seek(File::Whence::FROM_CURRENT, 0), 16);
+  EXPECT_EQ(to.Seek(File::Whence::FROM_CURRENT, 0), 16);
+  to.Close();
+  EXPECT_EQ(L"0123456789ABCDEF", ReadTextFile(file_name_to));
+}
+
 TEST_F(FileUtilTest, CopyFileContentsWithSendfileSeqFile) {
   // This test verifies the special case where we have a regular file with zero
   // length that might actually have contents (such as a seq_file).
@@ -9,6 +9,7 @@
 #include <io.h>
 #include <stdint.h>
 
+#include <optional>
 #include <tuple>
 
 #include "base/check_op.h"
@@ -16,6 +17,7 @@
 #include "base/immediate_crash.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/notreached.h"
+#include "base/numerics/clamped_math.h"
 #include "base/strings/string_util.h"
 #include "base/threading/scoped_blocking_call.h"
 
@@ -168,6 +170,44 @@ int File::WriteAtCurrentPosNoBestEffort(const char* data, int size) {
   return WriteAtCurrentPos(data, size);
 }
 
+// ReadFileScatter() and WriteFileGather() need unbuffered files and page-sized
+// buffers, so these transfer the buffers one at a time.
+std::optional<size_t> File::ReadV(int64_t offset,
+                                  span<const span<uint8_t>> buffers) {
+  SCOPED_FILE_TRACE("ReadV");
+  size_t bytes_read = 0;
+  for (span<uint8_t> buffer : buffers) {
+    std::optional<size_t> result = Read(ClampAdd(offset, bytes_read), buffer);
+    if (!result) {
+      return bytes_read ? std::optional<size_t>(bytes_read) : std::nullopt;
+    }
+    bytes_read += *result;
+    if (*result < buffer.size()) {
+      break;
+    }
+  }
+  return bytes_read;
+}
+
+std::optional<size_t> File::WriteV(int64_t offset,
+                                   span<const span<const uint8_t>> buffers) {
+  SCOPED_FILE_TRACE("WriteV");
+  size_t bytes_written = 0;
+  for (span<const uint8_t> buffer : buffers) {
+    std::optional<size_t> result =
+        Write(ClampAdd(offset, bytes_written), buffer);
+    if (!result) {
+      return bytes_written ? std::optional<size_t>(bytes_written)
+                           : std::nullopt;
+    }
+    bytes_written += *result;
+    if (*result < buffer.size()) {
+      break;
+    }
+  }
+  return bytes_written;
+}
+
 int64_t File::GetLength() const {
   ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
   DCHECK(IsValid());
@@ -442,6 +482,8 @@ void File::DoInitialize(const FilePath& path, uint32_t flags) {
     create_flags |= FILE_FLAG_BACKUP_SEMANTICS;
   if (flags & FLAG_WIN_SEQUENTIAL_SCAN)
     create_flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+  if (flags & FLAG_DIRECT)
+    create_flags |= FILE_FLAG_NO_BUFFERING;
 
   file_.Set(CreateFile(path.value().c_str(), access, sharing, NULL, disposition,
                        create_flags, NULL));
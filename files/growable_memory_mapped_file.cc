@@ -0,0 +1,302 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/growable_memory_mapped_file.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bits.h"
+#include "base/check_op.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/location.h"
+#include "base/memory/page_size.h"
+#include "base/memory/ref_counted.h"
+#include "base/numerics/checked_math.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/thread_annotations.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_WIN)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace base {
+
+namespace {
+
+// Maps the first `size` bytes of `file`, which must not be 0, for reading and
+// writing. Returns an empty span on failure.
+span<uint8_t> MapFile(File& file, size_t size) {
+#if BUILDFLAG(IS_WIN)
+  ULARGE_INTEGER map_size;
+  map_size.QuadPart = size;
+  HANDLE mapping =
+      ::CreateFileMapping(file.GetPlatformFile(), nullptr, PAGE_READWRITE,
+                          map_size.HighPart, map_size.LowPart, nullptr);
+  if (!mapping) {
+    DPLOG(ERROR) << "CreateFileMapping";
+    return span<uint8_t>();
+  }
+  // The view keeps the file mapping object alive.
+  void* ptr = ::MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+  ::CloseHandle(mapping);
+  if (!ptr) {
+    DPLOG(ERROR) << "MapViewOfFile";
+    return span<uint8_t>();
+  }
+#else
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   file.GetPlatformFile(), 0);
+  if (ptr == MAP_FAILED) {
+    DPLOG(ERROR) << "mmap";
+    return span<uint8_t>();
+  }
+#endif
+  // SAFETY: The OS mapped `size` bytes at `ptr`.
+  return UNSAFE_BUFFERS(span(static_cast<uint8_t*>(ptr), size));
+}
+
+void Unmap(span<uint8_t> bytes) {
+#if BUILDFLAG(IS_WIN)
+  ::UnmapViewOfFile(bytes.data());
+#else
+  munmap(bytes.data(), bytes.size());
+#endif
+}
+
+// Maps the first `size` bytes of `file` in place of `old_bytes`, which may be
+// empty, and returns them, or an empty span leaving `old_bytes` mapped on
+// failure.
+span<uint8_t> Remap(File& file, span<uint8_t> old_bytes, size_t size) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (!old_bytes.empty()) {
+    // This moves the page tables instead of faulting the pages in again, and
+    // can often extend the mapping in place.
+    void* ptr =
+        mremap(old_bytes.data(), old_bytes.size(), size, MREMAP_MAYMOVE);
+    if (ptr == MAP_FAILED) {
+      DPLOG(ERROR) << "mremap";
+      return span<uint8_t>();
+    }
+    // SAFETY: mremap() mapped `size` bytes at `ptr`.
+    return UNSAFE_BUFFERS(span(static_cast<uint8_t*>(ptr), size));
+  }
+#endif
+  // Two shared mappings of a file are coherent, so the old one can go once
+  // the new one is made.
+  span<uint8_t> bytes = MapFile(file, size);
+  if (!bytes.empty() && !old_bytes.empty()) {
+    Unmap(old_bytes);
+  }
+  return bytes;
+}
+
+// Writes back the pages of `bytes`, whose start must be page-aligned, and if
+// `wait` waits until they are on disk.
+bool SyncPages(File& file, span<uint8_t> bytes, bool wait) {
+#if BUILDFLAG(IS_WIN)
+  if (!::FlushViewOfFile(bytes.data(), bytes.size())) {
+    DPLOG(ERROR) << "FlushViewOfFile";
+    return false;
+  }
+  // FlushViewOfFile() only starts writing back.
+  return !wait || file.Flush();
+#else
+  if (msync(bytes.data(), bytes.size(), wait ? MS_SYNC : MS_ASYNC) != 0) {
+    DPLOG(ERROR) << "msync";
+    return false;
+  }
+  return true;
+#endif
+}
+
+}  // namespace
+
+// The mapping, shared with the flushes on the background sequence. The lock
+// keeps them from writing back pages while Grow() moves them.
+class GrowableMemoryMappedFile::Mapping
+    : public RefCountedThreadSafe<Mapping> {
+ public:
+  explicit Mapping(File file) : file_(std::move(file)) {}
+  Mapping(const Mapping&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+
+  int64_t GetFileLength() {
+    AutoLock lock(lock_);
+    return file_.GetLength();
+  }
+
+  // Extends the file to `size` bytes if it is shorter, and maps all of it.
+  // Returns the mapping, or an empty span, leaving the mapping as it was, on
+  // failure.
+  span<uint8_t> Resize(size_t size) {
+    AutoLock lock(lock_);
+    DCHECK_GE(size, bytes_.size());
+    if (!IsValueInRangeForNumericType<int64_t>(size)) {
+      return span<uint8_t>();
+    }
+    if (file_.GetLength() < static_cast<int64_t>(size) &&
+        !file_.SetLength(static_cast<int64_t>(size))) {
+      DPLOG(ERROR) << "SetLength";
+      return span<uint8_t>();
+    }
+    span<uint8_t> bytes = Remap(file_, bytes_, size);
+    if (!bytes.empty()) {
+      bytes_ = bytes;
+    }
+    return bytes;
+  }
+
+  // Writes back `ranges` of the mapping. Returns false if any failed.
+  bool Sync(const Ranges& ranges, bool wait) {
+    ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                            BlockingType::MAY_BLOCK);
+    AutoLock lock(lock_);
+    bool success = true;
+    for (const auto& [begin, end] : ranges) {
+      success &= SyncPages(file_, bytes_.subspan(begin, end - begin), wait);
+    }
+    return success;
+  }
+
+ private:
+  friend class RefCountedThreadSafe<Mapping>;
+
+  ~Mapping() {
+    if (!bytes_.empty()) {
+      Unmap(bytes_);
+    }
+  }
+
+  Lock lock_;
+  File file_ GUARDED_BY(lock_);
+  // RAW_PTR_EXCLUSION: Never allocated by PartitionAlloc (always mapped), so
+  // there is no benefit to using a raw_span, only cost.
+  RAW_PTR_EXCLUSION span<uint8_t> bytes_ GUARDED_BY(lock_);
+};
+
+GrowableMemoryMappedFile::GrowableMemoryMappedFile(
+    scoped_refptr<SequencedTaskRunner> flush_task_runner)
+    : flush_task_runner_(std::move(flush_task_runner)) {
+  DCHECK(flush_task_runner_);
+}
+
+GrowableMemoryMappedFile::~GrowableMemoryMappedFile() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+bool GrowableMemoryMappedFile::Initialize(File file, size_t min_size) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  if (IsValid() || !file.IsValid()) {
+    return false;
+  }
+
+  auto mapping = MakeRefCounted<Mapping>(std::move(file));
+  const int64_t file_length = mapping->GetFileLength();
+  if (file_length < 0 || !IsValueInRangeForNumericType<size_t>(file_length)) {
+    return false;
+  }
+  const size_t size = std::max(static_cast<size_t>(file_length), min_size);
+  if (size > 0) {
+    span<uint8_t> bytes = mapping->Resize(size);
+    if (bytes.empty()) {
+      return false;
+    }
+    bytes_ = bytes;
+  }
+  mapping_ = std::move(mapping);
+  return true;
+}
+
+bool GrowableMemoryMappedFile::IsValid() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return !!mapping_;
+}
+
+bool GrowableMemoryMappedFile::Grow(size_t min_size) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(IsValid());
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  if (min_size <= bytes_.size()) {
+    return true;
+  }
+
+  // Growing geometrically keeps the cost of remapping linear in the size.
+  const size_t page_size = GetPageSize();
+  size_t new_size;
+  if (!(CheckMax(CheckAdd(bytes_.size(),
+                          std::max(bytes_.size() / 2, kMinGrowth)),
+                 min_size) +
+        (page_size - 1))
+           .AssignIfValid(&new_size)) {
+    return false;
+  }
+  new_size = bits::AlignDown(new_size, page_size);
+
+  span<uint8_t> bytes = mapping_->Resize(new_size);
+  if (bytes.empty()) {
+    return false;
+  }
+  bytes_ = bytes;
+  return true;
+}
+
+void GrowableMemoryMappedFile::MarkDirty(size_t offset, size_t length) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  CHECK_LE(offset, bytes_.size());
+  CHECK_LE(length, bytes_.size() - offset);
+  if (length == 0) {
+    return;
+  }
+  const size_t page_size = GetPageSize();
+  dirty_ranges_.emplace_back(
+      bits::AlignDown(offset, page_size),
+      std::min(bits::AlignUp(offset + length, page_size), bytes_.size()));
+}
+
+void GrowableMemoryMappedFile::FlushDirtyRanges() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (dirty_ranges_.empty()) {
+    return;
+  }
+
+  // Merges the ranges which overlap or touch, so that each is written back
+  // with a single call.
+  std::sort(dirty_ranges_.begin(), dirty_ranges_.end());
+  Ranges ranges;
+  for (const auto& range : dirty_ranges_) {
+    if (!ranges.empty() && range.first <= ranges.back().second) {
+      ranges.back().second = std::max(ranges.back().second, range.second);
+    } else {
+      ranges.push_back(range);
+    }
+  }
+  dirty_ranges_.clear();
+
+  flush_task_runner_->PostTask(
+      FROM_HERE, BindOnce(IgnoreResult(&Mapping::Sync), mapping_,
+                          std::move(ranges), /*wait=*/false));
+}
+
+bool GrowableMemoryMappedFile::Flush() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(IsValid());
+  dirty_ranges_.clear();
+  if (bytes_.empty()) {
+    return true;
+  }
+  return mapping_->Sync({{0, bytes_.size()}}, /*wait=*/true);
+}
+
+}  // namespace base
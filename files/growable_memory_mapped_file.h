@@ -0,0 +1,102 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_GROWABLE_MEMORY_MAPPED_FILE_H_
+#define BASE_FILES_GROWABLE_MEMORY_MAPPED_FILE_H_
+
+#include <stddef.h>
+
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/memory/raw_ptr_exclusion.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequence_checker.h"
+
+namespace base {
+
+class SequencedTaskRunner;
+
+// A read-write mapping of a whole file which can grow after it was made, for
+// append-mostly stores such as logs. Unlike MemoryMappedFile's
+// READ_WRITE_EXTEND, which fixes the maximum size at map time, Grow() extends
+// the file and the mapping in large increments, so that appending remaps
+// rarely.
+//
+// Writes to bytes() reach the file whenever the OS writes dirty pages back.
+// To have them written back sooner, report them with MarkDirty() and call
+// FlushDirtyRanges(), which starts writing back on a background sequence
+// without blocking; or call Flush(), which blocks until everything is on disk.
+//
+// Except for the flushes posted by FlushDirtyRanges(), this must be used on a
+// single sequence.
+class BASE_EXPORT GrowableMemoryMappedFile {
+ public:
+  // The minimum by which Grow() extends the mapping.
+  static constexpr size_t kMinGrowth = 1024 * 1024;
+
+  // FlushDirtyRanges() posts to `flush_task_runner`, which must allow
+  // blocking.
+  explicit GrowableMemoryMappedFile(
+      scoped_refptr<SequencedTaskRunner> flush_task_runner);
+  GrowableMemoryMappedFile(const GrowableMemoryMappedFile&) = delete;
+  GrowableMemoryMappedFile& operator=(const GrowableMemoryMappedFile&) =
+      delete;
+  ~GrowableMemoryMappedFile();
+
+  // Maps `file`, which must be open for reading and writing, after extending
+  // it with zeros to `min_size` bytes if it is shorter. Returns false if this
+  // is already initialized or if that fails. An empty file is mapped once it
+  // grows.
+  [[nodiscard]] bool Initialize(File file, size_t min_size);
+
+  bool IsValid() const;
+
+  // The mapping, which covers the whole file. Grow() invalidates it.
+  span<uint8_t> bytes() { return bytes_; }
+  span<const uint8_t> bytes() const { return bytes_; }
+  size_t size() const { return bytes_.size(); }
+
+  // Extends the file and the mapping with zeros to at least `min_size` bytes:
+  // by at least half of the current size and at least kMinGrowth. The mapping
+  // may move. Returns false, leaving the mapping as it was, on failure.
+  [[nodiscard]] bool Grow(size_t min_size);
+
+  // Records that [offset, offset + length) of bytes() was written, for
+  // FlushDirtyRanges().
+  void MarkDirty(size_t offset, size_t length);
+
+  // Posts a task which starts writing back the pages of the ranges reported
+  // to MarkDirty() since the last flush (msync(MS_ASYNC) on POSIX,
+  // FlushViewOfFile() on Windows).
+  void FlushDirtyRanges();
+
+  // Writes back all of the mapping and waits until it is on disk. Returns
+  // false on failure.
+  bool Flush();
+
+ private:
+  class Mapping;
+
+  // Page-aligned [begin, end) ranges of the mapping.
+  using Ranges = std::vector<std::pair<size_t, size_t>>;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  const scoped_refptr<SequencedTaskRunner> flush_task_runner_;
+  // Shared with the tasks posted by FlushDirtyRanges().
+  scoped_refptr<Mapping> mapping_ GUARDED_BY_CONTEXT(sequence_checker_);
+  Ranges dirty_ranges_ GUARDED_BY_CONTEXT(sequence_checker_);
+  // The bytes of `mapping_`, which only this sequence changes.
+  // RAW_PTR_EXCLUSION: Never allocated by PartitionAlloc (always mapped), so
+  // there is no benefit to using a raw_span, only cost.
+  RAW_PTR_EXCLUSION span<uint8_t> bytes_;
+};
+
+}  // namespace base
+
+#endif  // BASE_FILES_GROWABLE_MEMORY_MAPPED_FILE_H_
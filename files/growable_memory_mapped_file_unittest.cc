@@ -0,0 +1,147 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/growable_memory_mapped_file.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/page_size.h"
+#include "base/task/thread_pool.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class GrowableMemoryMappedFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("mapped");
+  }
+
+  File OpenFile() {
+    return File(path_, File::FLAG_OPEN_ALWAYS | File::FLAG_READ |
+                           File::FLAG_WRITE);
+  }
+
+  int64_t GetFileLength() {
+    int64_t length = -1;
+    EXPECT_TRUE(GetFileSize(path_, &length));
+    return length;
+  }
+
+  std::string ReadFile() {
+    std::string contents;
+    EXPECT_TRUE(ReadFileToString(path_, &contents));
+    return contents;
+  }
+
+  test::TaskEnvironment task_environment_;
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+  GrowableMemoryMappedFile mapped_{
+      ThreadPool::CreateSequencedTaskRunner({MayBlock()})};
+};
+
+TEST_F(GrowableMemoryMappedFileTest, InitializeExtends) {
+  ASSERT_TRUE(mapped_.Initialize(OpenFile(), 100));
+  EXPECT_TRUE(mapped_.IsValid());
+  EXPECT_EQ(100u, mapped_.size());
+  EXPECT_EQ(100, GetFileLength());
+  EXPECT_EQ(std::string(100, '\0'), as_string_view(mapped_.bytes()));
+
+  EXPECT_FALSE(mapped_.Initialize(OpenFile(), 100));
+}
+
+TEST_F(GrowableMemoryMappedFileTest, InitializeKeepsContents) {
+  ASSERT_TRUE(WriteFile(path_, "contents"));
+  ASSERT_TRUE(mapped_.Initialize(OpenFile(), 0));
+  EXPECT_EQ("contents", as_string_view(mapped_.bytes()));
+}
+
+TEST_F(GrowableMemoryMappedFileTest, InitializeEmpty) {
+  ASSERT_TRUE(mapped_.Initialize(OpenFile(), 0));
+  EXPECT_TRUE(mapped_.IsValid());
+  EXPECT_TRUE(mapped_.bytes().empty());
+  EXPECT_TRUE(mapped_.Flush());
+
+  ASSERT_TRUE(mapped_.Grow(1));
+  EXPECT_EQ(GrowableMemoryMappedFile::kMinGrowth, mapped_.size());
+}
+
+TEST_F(GrowableMemoryMappedFileTest, Grow) {
+  ASSERT_TRUE(mapped_.Initialize(OpenFile(), 10));
+  mapped_.bytes().first(4u).copy_from(as_byte_span(std::string_view("head")));
+
+  // Growing by a little grows by at least kMinGrowth, to whole pages.
+  ASSERT_TRUE(mapped_.Grow(11));
+  EXPECT_GE(mapped_.size(), 10 + GrowableMemoryMappedFile::kMinGrowth);
+  EXPECT_EQ(0u, mapped_.size() % GetPageSize());
+  EXPECT_EQ(static_cast<int64_t>(mapped_.size()), GetFileLength());
+
+  // Large mappings grow by half, or to the size asked for.
+  const size_t size = mapped_.size();
+  ASSERT_TRUE(mapped_.Grow(size + 1));
+  EXPECT_GE(mapped_.size(), size + size / 2);
+  ASSERT_TRUE(mapped_.Grow(size * 10));
+  EXPECT_EQ(size * 10, mapped_.size());
+  // Growing to a smaller size does nothing.
+  ASSERT_TRUE(mapped_.Grow(1));
+  EXPECT_EQ(size * 10, mapped_.size());
+
+  // The contents survive remapping, and the new bytes are zero.
+  EXPECT_EQ("head", as_string_view(mapped_.bytes().first(4u)));
+  EXPECT_EQ(0u, mapped_.bytes()[10]);
+  EXPECT_EQ(0u, mapped_.bytes().back());
+}
+
+TEST_F(GrowableMemoryMappedFileTest, FlushDirtyRanges) {
+  ASSERT_TRUE(mapped_.Initialize(OpenFile(), 0));
+  ASSERT_TRUE(mapped_.Grow(3 * GetPageSize()));
+  const std::string_view kRecord = "record";
+  const size_t offsets[] = {0, 2 * GetPageSize() - 2, 10};
+  for (size_t offset : offsets) {
+    mapped_.bytes()
+        .subspan(offset, kRecord.size())
+        .copy_from(as_byte_span(kRecord));
+    mapped_.MarkDirty(offset, kRecord.size());
+  }
+  mapped_.MarkDirty(mapped_.size(), 0);
+  mapped_.FlushDirtyRanges();
+  // Growing while the flush may be running.
+  ASSERT_TRUE(mapped_.Grow(mapped_.size() + 1));
+  task_environment_.RunUntilIdle();
+
+  const std::string contents = ReadFile();
+  ASSERT_EQ(mapped_.size(), contents.size());
+  for (size_t offset : offsets) {
+    EXPECT_EQ(kRecord, std::string_view(contents).substr(offset,
+                                                          kRecord.size()));
+  }
+  EXPECT_TRUE(mapped_.Flush());
+}
+
+TEST_F(GrowableMemoryMappedFileTest, FlushAfterDestruction) {
+  auto mapped = std::make_unique<GrowableMemoryMappedFile>(
+      ThreadPool::CreateSequencedTaskRunner({MayBlock()}));
+  ASSERT_TRUE(mapped->Initialize(OpenFile(), 10));
+  mapped->bytes().first(4u).copy_from(as_byte_span(std::string_view("data")));
+  mapped->MarkDirty(0, 4);
+  mapped->FlushDirtyRanges();
+  // The pending flush keeps the mapping alive.
+  mapped.reset();
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ("data", ReadFile().substr(0, 4));
+}
+
+}  // namespace base
@@ -0,0 +1,230 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/important_file_committer.h"
+
+#include <set>
+#include <utility>
+
+#include "base/check.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "base/files/scoped_file.h"
+#include "base/posix/eintr_wrapper.h"
+#endif
+
+namespace base {
+
+namespace {
+
+#if !BUILDFLAG(IS_WIN)
+// A write of a batch, once its data is in its temporary file.
+struct StagedWrite {
+  FilePath path;
+  FilePath tmp_path;
+  File tmp_file;
+  OnceCallback<void(bool success)> after_write_callback;
+  bool success = false;
+};
+
+// Starts writing back `file` without waiting, so that the writeback of all of
+// the files of a batch overlaps.
+void StartWriteback(File& file) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // This is only a hint; File::Flush() still waits for the data.
+  sync_file_range(file.GetPlatformFile(), 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+}
+
+// Makes the renames in `directory` durable.
+bool FlushDirectory(const FilePath& directory) {
+  ScopedFD fd(HANDLE_EINTR(
+      open(directory.value().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)));
+  if (!fd.is_valid() || HANDLE_EINTR(fsync(fd.get())) != 0) {
+    DPLOG(WARNING) << "Failed to flush " << directory;
+    return false;
+  }
+  return true;
+}
+#endif  // !BUILDFLAG(IS_WIN)
+
+}  // namespace
+
+ImportantFileCommitter::PendingWrite::PendingWrite() = default;
+ImportantFileCommitter::PendingWrite::PendingWrite(PendingWrite&&) = default;
+ImportantFileCommitter::PendingWrite&
+ImportantFileCommitter::PendingWrite::operator=(PendingWrite&&) = default;
+ImportantFileCommitter::PendingWrite::~PendingWrite() = default;
+
+ImportantFileCommitter::ImportantFileCommitter(
+    scoped_refptr<SequencedTaskRunner> task_runner,
+    TimeDelta window)
+    : task_runner_(std::move(task_runner)), window_(window) {
+  DCHECK(task_runner_);
+}
+
+ImportantFileCommitter::~ImportantFileCommitter() = default;
+
+void ImportantFileCommitter::AddWrite(
+    const FilePath& path,
+    DataProducerCallback data_producer,
+    OnceClosure before_write_callback,
+    OnceCallback<void(bool success)> after_write_callback) {
+  DCHECK(data_producer);
+  PendingWrite write;
+  write.path = path;
+  write.data_producer = std::move(data_producer);
+  write.before_write_callback = std::move(before_write_callback);
+  write.after_write_callback = std::move(after_write_callback);
+
+  bool post_commit;
+  {
+    AutoLock lock(lock_);
+    pending_writes_.push_back(std::move(write));
+    post_commit = !std::exchange(commit_posted_, true);
+  }
+  if (post_commit) {
+    task_runner_->PostDelayedTask(
+        FROM_HERE, BindOnce(&ImportantFileCommitter::CommitBatch, this),
+        window_);
+  }
+}
+
+void ImportantFileCommitter::CommitNow() {
+  task_runner_->PostTask(FROM_HERE,
+                         BindOnce(&ImportantFileCommitter::CommitBatch, this));
+}
+
+void ImportantFileCommitter::CommitBatch() {
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  std::vector<PendingWrite> writes;
+  {
+    AutoLock lock(lock_);
+    writes.swap(pending_writes_);
+    commit_posted_ = false;
+  }
+  if (!writes.empty()) {
+    WriteBatch(std::move(writes));
+  }
+}
+
+// static
+void ImportantFileCommitter::WriteBatch(std::vector<PendingWrite> writes) {
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+
+#if BUILDFLAG(IS_WIN)
+  // ReplaceFile() needs the temporary file closed, and is retried while other
+  // software has it open, which is best left to WriteFileAtomically().
+  for (PendingWrite& write : writes) {
+    std::optional<std::string> data = std::move(write.data_producer).Run();
+    if (!data) {
+      DLOG(WARNING) << "Failed to serialize data to be saved in "
+                    << write.path.value();
+      continue;
+    }
+    if (write.before_write_callback) {
+      std::move(write.before_write_callback).Run();
+    }
+    const bool success =
+        ImportantFileWriter::WriteFileAtomically(write.path, *data);
+    if (write.after_write_callback) {
+      std::move(write.after_write_callback).Run(success);
+    }
+  }
+#else
+  // Writes the data of each write to a temporary file in the directory of its
+  // file, without flushing.
+  std::vector<StagedWrite> staged;
+  staged.reserve(writes.size());
+  for (PendingWrite& write : writes) {
+    std::optional<std::string> data = std::move(write.data_producer).Run();
+    if (!data) {
+      DLOG(WARNING) << "Failed to serialize data to be saved in "
+                    << write.path.value();
+      continue;
+    }
+    if (write.before_write_callback) {
+      std::move(write.before_write_callback).Run();
+    }
+
+    StagedWrite& staged_write = staged.emplace_back();
+    staged_write.path = write.path;
+    staged_write.after_write_callback = std::move(write.after_write_callback);
+    staged_write.tmp_file = CreateAndOpenTemporaryFileInDir(
+        write.path.DirName(), &staged_write.tmp_path);
+    if (!staged_write.tmp_file.IsValid()) {
+      DPLOG(WARNING) << "Failed to create temporary file to update "
+                     << write.path;
+      continue;
+    }
+    if (!staged_write.tmp_file.WriteAtCurrentPosAndCheck(
+            as_byte_span(*data))) {
+      DPLOG(WARNING) << "Failed to write temp file to update " << write.path;
+      continue;
+    }
+    StartWriteback(staged_write.tmp_file);
+    staged_write.success = true;
+  }
+
+  // Waits for all of the data to be on disk before any file is replaced, so
+  // that a crash leaves each file either as it was or with its new contents.
+  for (StagedWrite& staged_write : staged) {
+    if (staged_write.success && !staged_write.tmp_file.Flush()) {
+      DPLOG(WARNING) << "Failed to flush temp file to update "
+                     << staged_write.path;
+      staged_write.success = false;
+    }
+  }
+
+  std::set<FilePath> directories;
+  for (StagedWrite& staged_write : staged) {
+    staged_write.tmp_file.Close();
+    if (staged_write.success) {
+      staged_write.success =
+          ReplaceFile(staged_write.tmp_path, staged_write.path, nullptr);
+      if (staged_write.success) {
+        directories.insert(staged_write.path.DirName());
+        continue;
+      }
+      DPLOG(WARNING) << "Failed to replace " << staged_write.path << " with "
+                     << staged_write.tmp_path;
+    }
+    if (!staged_write.tmp_path.empty()) {
+      DeleteFile(staged_write.tmp_path);
+    }
+  }
+
+  // The renames may still be lost in a crash until their directories are
+  // flushed, once per directory for the whole batch.
+  std::set<FilePath> failed_directories;
+  for (const FilePath& directory : directories) {
+    if (!FlushDirectory(directory)) {
+      failed_directories.insert(directory);
+    }
+  }
+
+  for (StagedWrite& staged_write : staged) {
+    if (staged_write.after_write_callback) {
+      std::move(staged_write.after_write_callback)
+          .Run(staged_write.success &&
+               !failed_directories.contains(staged_write.path.DirName()));
+    }
+  }
+#endif  // BUILDFLAG(IS_WIN)
+}
+
+}  // namespace base
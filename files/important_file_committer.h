@@ -0,0 +1,103 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_IMPORTANT_FILE_COMMITTER_H_
+#define BASE_FILES_IMPORTANT_FILE_COMMITTER_H_
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/files/file_path.h"
+#include "base/functional/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+
+namespace base {
+
+class SequencedTaskRunner;
+
+// Commits the writes of many ImportantFileWriters in batches, so that they
+// share the cost of making them durable. Each write is still atomic: the new
+// contents go to a temporary file which replaces the file once it is on disk.
+// But rather than writing, flushing and renaming each file in turn, a batch
+// writes all of its temporary files, flushes them together, renames them, and
+// then flushes each directory once so that the renames are durable too.
+//
+// On Linux, ChromeOS and Android, the writeback of all of the temporary files
+// is started before waiting for any of them, so that the flushes overlap, and
+// file systems with a journal can commit them in a single transaction. On
+// Windows, each write of a batch is committed as by
+// ImportantFileWriter::WriteFileAtomically().
+//
+// This is thread-safe, and can be shared by writers on different sequences.
+class BASE_EXPORT ImportantFileCommitter
+    : public RefCountedThreadSafe<ImportantFileCommitter> {
+ public:
+  using DataProducerCallback = OnceCallback<std::optional<std::string>()>;
+
+  // How long a batch waits for more writes by default.
+  static constexpr TimeDelta kDefaultWindow = Milliseconds(500);
+
+  // Commits each batch on `task_runner`, which must allow blocking, `window`
+  // after its first write was added.
+  explicit ImportantFileCommitter(
+      scoped_refptr<SequencedTaskRunner> task_runner,
+      TimeDelta window = kDefaultWindow);
+  ImportantFileCommitter(const ImportantFileCommitter&) = delete;
+  ImportantFileCommitter& operator=(const ImportantFileCommitter&) = delete;
+
+  // Adds a write to `path` of the data returned by `data_producer` to the
+  // next batch. Nothing is written if it returns nullopt. Otherwise
+  // `before_write_callback` and `after_write_callback`, which may be null, are
+  // run before the write and with its result. All three are run on the
+  // committer's task runner. Writes to the same path are made in the order in
+  // which they were added.
+  void AddWrite(const FilePath& path,
+                DataProducerCallback data_producer,
+                OnceClosure before_write_callback,
+                OnceCallback<void(bool success)> after_write_callback);
+
+  // Commits the writes added so far without waiting for the end of the
+  // window, e.g. at shutdown, as delayed tasks may not run then.
+  void CommitNow();
+
+ private:
+  friend class RefCountedThreadSafe<ImportantFileCommitter>;
+
+  struct PendingWrite {
+    PendingWrite();
+    PendingWrite(PendingWrite&&);
+    PendingWrite& operator=(PendingWrite&&);
+    ~PendingWrite();
+
+    FilePath path;
+    DataProducerCallback data_producer;
+    OnceClosure before_write_callback;
+    OnceCallback<void(bool success)> after_write_callback;
+  };
+
+  ~ImportantFileCommitter();
+
+  // Commits the writes added so far, on `task_runner_`.
+  void CommitBatch();
+
+  static void WriteBatch(std::vector<PendingWrite> writes);
+
+  const scoped_refptr<SequencedTaskRunner> task_runner_;
+  const TimeDelta window_;
+
+  Lock lock_;
+  std::vector<PendingWrite> pending_writes_ GUARDED_BY(lock_);
+  // Whether the commit of `pending_writes_` was posted.
+  bool commit_posted_ GUARDED_BY(lock_) = false;
+};
+
+}  // namespace base
+
+#endif  // BASE_FILES_IMPORTANT_FILE_COMMITTER_H_
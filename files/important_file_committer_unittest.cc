@@ -0,0 +1,152 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/important_file_committer.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/functional/bind.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class ImportantFileCommitterTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  FilePath GetPath(const char* name) {
+    return temp_dir_.GetPath().AppendASCII(name);
+  }
+
+  std::string GetFileContent(const FilePath& path) {
+    std::string content;
+    EXPECT_TRUE(ReadFileToString(path, &content));
+    return content;
+  }
+
+  // Adds a write of `data` to `path`, whose result is appended to `results_`.
+  void AddWrite(const FilePath& path, std::optional<std::string> data) {
+    committer_->AddWrite(
+        path, BindOnce([](std::optional<std::string> data) { return data; },
+                       std::move(data)),
+        BindOnce([](int* before_writes) { ++*before_writes; },
+                 &before_writes_),
+        BindOnce([](std::vector<bool>* results,
+                    bool success) { results->push_back(success); },
+                 &results_));
+  }
+
+  test::TaskEnvironment task_environment_{
+      test::TaskEnvironment::TimeSource::MOCK_TIME};
+  ScopedTempDir temp_dir_;
+  scoped_refptr<ImportantFileCommitter> committer_ =
+      MakeRefCounted<ImportantFileCommitter>(
+          SequencedTaskRunner::GetCurrentDefault());
+  int before_writes_ = 0;
+  std::vector<bool> results_;
+};
+
+TEST_F(ImportantFileCommitterTest, BatchesWrites) {
+  const FilePath path1 = GetPath("file1");
+  const FilePath path2 = GetPath("file2");
+  ASSERT_TRUE(WriteFile(path1, "old"));
+  AddWrite(path1, "first");
+  AddWrite(path2, "second");
+  task_environment_.FastForwardBy(ImportantFileCommitter::kDefaultWindow / 2);
+  // Writes to the same file are made in order.
+  AddWrite(path1, "third");
+
+  // Nothing is written until the end of the window of the first write.
+  task_environment_.FastForwardBy(ImportantFileCommitter::kDefaultWindow / 4);
+  EXPECT_EQ("old", GetFileContent(path1));
+  EXPECT_FALSE(PathExists(path2));
+  EXPECT_TRUE(results_.empty());
+
+  task_environment_.FastForwardBy(ImportantFileCommitter::kDefaultWindow / 4);
+  EXPECT_EQ("third", GetFileContent(path1));
+  EXPECT_EQ("second", GetFileContent(path2));
+  EXPECT_EQ(3, before_writes_);
+  EXPECT_EQ((std::vector<bool>{true, true, true}), results_);
+  // No temporary file is left.
+  FileEnumerator files(temp_dir_.GetPath(), false, FileEnumerator::FILES);
+  int file_count = 0;
+  while (!files.Next().empty()) {
+    ++file_count;
+  }
+  EXPECT_EQ(2, file_count);
+
+  // The next write starts a new batch.
+  AddWrite(path2, "fourth");
+  task_environment_.FastForwardBy(ImportantFileCommitter::kDefaultWindow);
+  EXPECT_EQ("fourth", GetFileContent(path2));
+  EXPECT_EQ(4u, results_.size());
+}
+
+TEST_F(ImportantFileCommitterTest, Failures) {
+  const FilePath path = GetPath("file");
+  const FilePath missing_dir_path =
+      temp_dir_.GetPath().AppendASCII("missing").AppendASCII("file");
+  AddWrite(path, "data");
+  // Not written, and the callbacks don't run.
+  AddWrite(GetPath("unserialized"), std::nullopt);
+  AddWrite(missing_dir_path, "data");
+  task_environment_.FastForwardBy(ImportantFileCommitter::kDefaultWindow);
+
+  EXPECT_EQ("data", GetFileContent(path));
+  EXPECT_FALSE(PathExists(GetPath("unserialized")));
+  EXPECT_EQ(2, before_writes_);
+  EXPECT_EQ((std::vector<bool>{true, false}), results_);
+}
+
+TEST_F(ImportantFileCommitterTest, CommitNow) {
+  const FilePath path = GetPath("file");
+  AddWrite(path, "data");
+  committer_->CommitNow();
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ("data", GetFileContent(path));
+  EXPECT_EQ((std::vector<bool>{true}), results_);
+
+  // The end of the window finds nothing left to commit.
+  task_environment_.FastForwardBy(ImportantFileCommitter::kDefaultWindow);
+  EXPECT_EQ(1u, results_.size());
+}
+
+TEST_F(ImportantFileCommitterTest, ImportantFileWriter) {
+  ImportantFileWriter writer1(GetPath("file1"),
+                              SequencedTaskRunner::GetCurrentDefault());
+  ImportantFileWriter writer2(GetPath("file2"),
+                              SequencedTaskRunner::GetCurrentDefault());
+  writer1.SetCommitter(committer_);
+  writer2.SetCommitter(committer_);
+
+  bool written = false;
+  writer1.RegisterOnNextWriteCallbacks(
+      {}, BindOnce(
+              [](bool* written, bool success) {
+                EXPECT_TRUE(success);
+                *written = true;
+              },
+              &written));
+  writer1.WriteNow("data1");
+  writer2.WriteNow("data2");
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(written);
+  EXPECT_FALSE(PathExists(writer1.path()));
+
+  task_environment_.FastForwardBy(ImportantFileCommitter::kDefaultWindow);
+  EXPECT_TRUE(written);
+  EXPECT_EQ("data1", GetFileContent(writer1.path()));
+  EXPECT_EQ("data2", GetFileContent(writer2.path()));
+}
+
+}  // namespace base
@@ -23,6 +23,7 @@
 #include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/important_file_committer.h"
 #include "base/files/important_file_writer_cleaner.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
@@ -323,6 +324,14 @@ void ImportantFileWriter::WriteNowWithBackgroundDataProducer(
     BackgroundDataProducerCallback background_data_producer) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+  if (committer_) {
+    committer_->AddWrite(path_, std::move(background_data_producer),
+                         std::move(before_next_write_callback_),
+                         std::move(after_next_write_callback_));
+    ClearPendingWrite();
+    return;
+  }
+
   auto split_task = SplitOnceCallback(
       BindOnce(&ProduceAndWriteStringToFileAtomically, path_,
                std::move(background_data_producer),
@@ -422,6 +431,12 @@ void ImportantFileWriter::ClearPendingWrite() {
   serializer_.emplace<absl::monostate>();
 }
 
+void ImportantFileWriter::SetCommitter(
+    scoped_refptr<ImportantFileCommitter> committer) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  committer_ = std::move(committer);
+}
+
 void ImportantFileWriter::SetTimerForTesting(OneShotTimer* timer_override) {
   timer_override_ = timer_override;
 }
@@ -21,6 +21,7 @@
 
 namespace base {
 
+class ImportantFileCommitter;
 class SequencedTaskRunner;
 
 // Helper for atomically writing a file to ensure that it won't be corrupted by
@@ -139,6 +140,12 @@ class BASE_EXPORT ImportantFileWriter {
       OnceClosure before_next_write_callback,
       OnceCallback<void(bool success)> after_next_write_callback);
 
+  // Has the writes from now on committed in batches with those of other
+  // writers by |committer|, instead of on |task_runner|. The data producers
+  // and the callbacks registered with RegisterOnNextWriteCallbacks() then run
+  // on the committer's task runner.
+  void SetCommitter(scoped_refptr<ImportantFileCommitter> committer);
+
   TimeDelta commit_interval() const {
     return commit_interval_;
   }
@@ -195,6 +202,9 @@ class BASE_EXPORT ImportantFileWriter {
   // TaskRunner for the thread on which file I/O can be done.
   const scoped_refptr<SequencedTaskRunner> task_runner_;
 
+  // If set, commits the writes instead of |task_runner_|.
+  scoped_refptr<ImportantFileCommitter> committer_;
+
   // Timer used to schedule commit after ScheduleWrite.
   OneShotTimer timer_;
 
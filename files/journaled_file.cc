@@ -0,0 +1,206 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/journaled_file.h"
+
+#include <array>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/containers/span.h"
+#include "base/containers/span_reader.h"
+#include "base/containers/span_writer.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/hash/hash.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/threading/scoped_blocking_call.h"
+
+namespace base {
+
+namespace {
+
+// Both files start with a magic number and the number of the snapshot.
+constexpr uint32_t kSnapshotMagic = 0x50534e4a;  // "JNSP"
+constexpr uint32_t kJournalMagic = 0x4c4e524a;   // "JRNL"
+constexpr size_t kHeaderSize = sizeof(uint32_t) + sizeof(uint64_t);
+
+// Each record is preceded by its size and its hash.
+constexpr size_t kRecordHeaderSize = 2 * sizeof(uint32_t);
+
+std::array<uint8_t, kHeaderSize> MakeHeader(uint32_t magic,
+                                            uint64_t generation) {
+  std::array<uint8_t, kHeaderSize> header;
+  SpanWriter writer{span(header)};
+  writer.WriteU32LittleEndian(magic);
+  writer.WriteU64LittleEndian(generation);
+  return header;
+}
+
+// Reads the header of `reader`'s file, and returns the generation in it, or
+// nullopt if the header isn't a valid one for `magic`.
+std::optional<uint64_t> ReadHeader(SpanReader<const uint8_t>& reader,
+                                   uint32_t magic) {
+  uint32_t file_magic;
+  uint64_t generation;
+  if (!reader.ReadU32LittleEndian(file_magic) || file_magic != magic ||
+      !reader.ReadU64LittleEndian(generation)) {
+    return std::nullopt;
+  }
+  return generation;
+}
+
+}  // namespace
+
+JournaledFile::JournaledFile(const FilePath& path)
+    : JournaledFile(path, Options()) {}
+
+JournaledFile::JournaledFile(const FilePath& path, const Options& options)
+    : path_(path),
+      journal_path_(path.AddExtensionASCII("journal")),
+      options_(options) {}
+
+JournaledFile::~JournaledFile() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+bool JournaledFile::Load(std::string& snapshot,
+                         std::vector<std::string>& records) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(!loaded_);
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  snapshot.clear();
+  records.clear();
+
+  std::string contents;
+  if (ReadFileToString(path_, &contents)) {
+    SpanReader reader(as_byte_span(contents));
+    std::optional<uint64_t> generation = ReadHeader(reader, kSnapshotMagic);
+    if (!generation) {
+      DLOG(ERROR) << "Corrupt snapshot " << path_;
+      return false;
+    }
+    generation_ = *generation;
+    snapshot = contents.substr(kHeaderSize);
+  } else if (PathExists(path_)) {
+    DPLOG(ERROR) << "Failed to read " << path_;
+    return false;
+  }
+
+  // The records of an older snapshot are already in this one.
+  journal_size_ = 0;
+  if (ReadFileToString(journal_path_, &contents)) {
+    SpanReader reader(as_byte_span(contents));
+    if (ReadHeader(reader, kJournalMagic) == generation_) {
+      journal_size_ = kHeaderSize;
+      uint32_t size;
+      uint32_t hash;
+      span<const uint8_t> record;
+      while (reader.ReadU32LittleEndian(size) &&
+             reader.ReadU32LittleEndian(hash) &&
+             reader.ReadInto(size, record) && PersistentHash(record) == hash) {
+        records.emplace_back(as_string_view(record));
+        journal_size_ += kRecordHeaderSize + size;
+      }
+    }
+  }
+
+  journal_ = File(journal_path_, File::FLAG_OPEN_ALWAYS | File::FLAG_READ |
+                                     File::FLAG_WRITE);
+  if (!journal_.IsValid()) {
+    DLOG(ERROR) << "Failed to open " << journal_path_ << ": "
+                << File::ErrorToString(journal_.error_details());
+    return false;
+  }
+  if (journal_size_ == 0) {
+    if (!ResetJournal(generation_)) {
+      return false;
+    }
+  } else if (!journal_.SetLength(static_cast<int64_t>(journal_size_))) {
+    // Drops the torn record, if any, so that the next one doesn't follow it.
+    DPLOG(ERROR) << "Failed to truncate " << journal_path_;
+    return false;
+  }
+  loaded_ = true;
+  return true;
+}
+
+bool JournaledFile::Append(std::string_view record) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(loaded_);
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  if (!journal_.IsValid() || !IsValueInRangeForNumericType<uint32_t>(
+                                 record.size())) {
+    return false;
+  }
+
+  // One write per record, so that a crash tears at most the last one.
+  std::vector<uint8_t> buffer(kRecordHeaderSize + record.size());
+  SpanWriter writer{span(buffer)};
+  writer.WriteU32LittleEndian(static_cast<uint32_t>(record.size()));
+  writer.WriteU32LittleEndian(PersistentHash(record));
+  writer.Write(as_byte_span(record));
+  if (!journal_.WriteAndCheck(static_cast<int64_t>(journal_size_), buffer) ||
+      !journal_.Flush()) {
+    DPLOG(ERROR) << "Failed to append to " << journal_path_;
+    // Anything written is after `journal_size_`, and overwritten by the next
+    // record.
+    return false;
+  }
+  journal_size_ += buffer.size();
+  return true;
+}
+
+bool JournaledFile::Compact(std::string_view snapshot) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(loaded_);
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+
+  const uint64_t generation = generation_ + 1;
+  std::string contents;
+  contents.reserve(kHeaderSize + snapshot.size());
+  contents.append(as_string_view(MakeHeader(kSnapshotMagic, generation)));
+  contents.append(snapshot);
+  if (!ImportantFileWriter::WriteFileAtomically(path_, contents)) {
+    return false;
+  }
+  generation_ = generation;
+
+  // From now on, the records in the journal are ignored by Load().
+  if (!journal_.IsValid()) {
+    journal_ = File(journal_path_, File::FLAG_OPEN_ALWAYS | File::FLAG_READ |
+                                       File::FLAG_WRITE);
+  }
+  if (!journal_.IsValid() || !ResetJournal(generation)) {
+    journal_.Close();
+    return false;
+  }
+  return true;
+}
+
+bool JournaledFile::ShouldCompact() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return journal_size_ > options_.max_journal_size;
+}
+
+size_t JournaledFile::journal_size() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return journal_size_;
+}
+
+bool JournaledFile::ResetJournal(uint64_t generation) {
+  if (!journal_.SetLength(0) ||
+      !journal_.WriteAndCheck(0, MakeHeader(kJournalMagic, generation)) ||
+      !journal_.Flush()) {
+    DPLOG(ERROR) << "Failed to reset " << journal_path_;
+    return false;
+  }
+  journal_size_ = kHeaderSize;
+  return true;
+}
+
+}  // namespace base
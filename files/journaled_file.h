@@ -0,0 +1,107 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_JOURNALED_FILE_H_
+#define BASE_FILES_JOURNALED_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/sequence_checker.h"
+
+namespace base {
+
+// Persists state which changes a little at a time, such as a large
+// dictionary of preferences, as a snapshot plus a journal of changes since
+// the snapshot, instead of rewriting all of it on each change as
+// ImportantFileWriter does. Each change is appended to the journal as a
+// record, and the journal is periodically compacted into a new snapshot.
+//
+// The snapshot is in the file at `path`, which is replaced atomically by
+// ImportantFileWriter::WriteFileAtomically(), and the journal in the file
+// at `path` plus ".journal". The records are checksummed, so that a record
+// torn by a crash while appending is dropped along with anything after it.
+// Both files carry the number of the snapshot, so that a crash between
+// writing a snapshot and emptying the journal doesn't replay the old records
+// on top of the new snapshot.
+//
+// What the snapshot and the records contain, and how the records apply to
+// the snapshot, is up to the caller.
+//
+// All methods block, and must be called on the same sequence, which must
+// allow blocking. To use this from a sequence which doesn't, wrap it in a
+// SequenceBound.
+class BASE_EXPORT JournaledFile {
+ public:
+  struct Options {
+    // The size of the journal past which ShouldCompact() returns true.
+    size_t max_journal_size = 1024 * 1024;
+  };
+
+  explicit JournaledFile(const FilePath& path);
+  JournaledFile(const FilePath& path, const Options& options);
+  JournaledFile(const JournaledFile&) = delete;
+  JournaledFile& operator=(const JournaledFile&) = delete;
+  ~JournaledFile();
+
+  // Reads the snapshot into `snapshot` and the records appended since it
+  // into `records`, in order, and prepares to append more. A missing file is
+  // read as an empty snapshot. Returns false if the snapshot is corrupt or
+  // can't be read, or if the journal can't be opened for writing. Must be
+  // called once, before the other methods.
+  [[nodiscard]] bool Load(std::string& snapshot,
+                          std::vector<std::string>& records);
+
+  // Appends `record` to the journal, and returns once it is on disk. Returns
+  // false if that fails, in which case the journal holds the records appended
+  // before, and the caller should Compact() to persist `record`.
+  [[nodiscard]] bool Append(std::string_view record);
+
+  // Replaces the snapshot with `snapshot`, which should include the changes
+  // of all of the records, and empties the journal. Returns false if that
+  // fails. If the new snapshot was written but the journal couldn't be
+  // emptied, appending fails until the next successful Compact().
+  [[nodiscard]] bool Compact(std::string_view snapshot);
+
+  // Whether the journal is large enough that it should be compacted, both to
+  // reclaim its space and to keep Load() fast.
+  bool ShouldCompact() const;
+
+  // The size of the journal in bytes, for callers which also compact on
+  // other criteria.
+  size_t journal_size() const;
+
+  const FilePath& path() const { return path_; }
+  const FilePath& journal_path() const { return journal_path_; }
+
+ private:
+  // Empties the journal and marks it as following snapshot `generation`.
+  bool ResetJournal(uint64_t generation);
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  const FilePath path_;
+  const FilePath journal_path_;
+  const Options options_;
+
+  // The journal, open for writing once loaded, unless it couldn't be reset
+  // after a Compact().
+  File journal_ GUARDED_BY_CONTEXT(sequence_checker_);
+  // The number of the current snapshot, incremented by Compact().
+  uint64_t generation_ GUARDED_BY_CONTEXT(sequence_checker_) = 0;
+  // The size of the valid part of the journal, where the next record goes.
+  size_t journal_size_ GUARDED_BY_CONTEXT(sequence_checker_) = 0;
+  bool loaded_ GUARDED_BY_CONTEXT(sequence_checker_) = false;
+};
+
+}  // namespace base
+
+#endif  // BASE_FILES_JOURNALED_FILE_H_
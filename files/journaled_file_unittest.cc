@@ -0,0 +1,173 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/journaled_file.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class JournaledFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("state");
+  }
+
+  // Loads the file at `path_` with a new JournaledFile, and returns the
+  // snapshot followed by the records.
+  std::vector<std::string> Load() {
+    JournaledFile file(path_);
+    std::string snapshot;
+    std::vector<std::string> records;
+    EXPECT_TRUE(file.Load(snapshot, records));
+    records.insert(records.begin(), snapshot);
+    return records;
+  }
+
+  int64_t GetJournalLength() {
+    int64_t length = -1;
+    EXPECT_TRUE(GetFileSize(path_.AddExtensionASCII("journal"), &length));
+    return length;
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+};
+
+TEST_F(JournaledFileTest, AppendAndCompact) {
+  {
+    JournaledFile file(path_);
+    std::string snapshot = "unchanged";
+    std::vector<std::string> records = {"unchanged"};
+    ASSERT_TRUE(file.Load(snapshot, records));
+    // A missing file is empty.
+    EXPECT_EQ("", snapshot);
+    EXPECT_TRUE(records.empty());
+
+    ASSERT_TRUE(file.Append("a"));
+    ASSERT_TRUE(file.Append(""));
+    ASSERT_TRUE(file.Append("b"));
+  }
+  EXPECT_EQ((std::vector<std::string>{"", "a", "", "b"}), Load());
+
+  {
+    JournaledFile file(path_);
+    std::string snapshot;
+    std::vector<std::string> records;
+    ASSERT_TRUE(file.Load(snapshot, records));
+    const size_t journal_size = file.journal_size();
+    ASSERT_TRUE(file.Compact("ab"));
+    EXPECT_LT(file.journal_size(), journal_size);
+    ASSERT_TRUE(file.Append("c"));
+  }
+  EXPECT_EQ((std::vector<std::string>{"ab", "c"}), Load());
+}
+
+TEST_F(JournaledFileTest, ShouldCompact) {
+  JournaledFile file(path_, {.max_journal_size = 100});
+  std::string snapshot;
+  std::vector<std::string> records;
+  ASSERT_TRUE(file.Load(snapshot, records));
+  EXPECT_FALSE(file.ShouldCompact());
+  ASSERT_TRUE(file.Append(std::string(50, 'x')));
+  EXPECT_FALSE(file.ShouldCompact());
+  ASSERT_TRUE(file.Append(std::string(50, 'x')));
+  EXPECT_TRUE(file.ShouldCompact());
+  ASSERT_TRUE(file.Compact(std::string(100, 'x')));
+  EXPECT_FALSE(file.ShouldCompact());
+}
+
+TEST_F(JournaledFileTest, TornRecord) {
+  {
+    JournaledFile file(path_);
+    std::string snapshot;
+    std::vector<std::string> records;
+    ASSERT_TRUE(file.Load(snapshot, records));
+    ASSERT_TRUE(file.Append("complete"));
+    ASSERT_TRUE(file.Append("torn"));
+  }
+  // As if the process crashed while appending the last record.
+  {
+    File journal(path_.AddExtensionASCII("journal"),
+                 File::FLAG_OPEN | File::FLAG_WRITE);
+    ASSERT_TRUE(journal.SetLength(journal.GetLength() - 1));
+  }
+  const int64_t torn_length = GetJournalLength();
+
+  {
+    JournaledFile file(path_);
+    std::string snapshot;
+    std::vector<std::string> records;
+    ASSERT_TRUE(file.Load(snapshot, records));
+    EXPECT_EQ((std::vector<std::string>{"complete"}), records);
+    // The torn record is dropped, and the next one replaces it.
+    EXPECT_LT(GetJournalLength(), torn_length);
+    ASSERT_TRUE(file.Append("next"));
+  }
+  EXPECT_EQ((std::vector<std::string>{"", "complete", "next"}), Load());
+}
+
+TEST_F(JournaledFileTest, CorruptRecord) {
+  {
+    JournaledFile file(path_);
+    std::string snapshot;
+    std::vector<std::string> records;
+    ASSERT_TRUE(file.Load(snapshot, records));
+    ASSERT_TRUE(file.Append("first"));
+    ASSERT_TRUE(file.Append("second"));
+    ASSERT_TRUE(file.Append("third"));
+  }
+  std::string journal;
+  ASSERT_TRUE(ReadFileToString(path_.AddExtensionASCII("journal"), &journal));
+  const size_t offset = journal.find("second");
+  ASSERT_NE(std::string::npos, offset);
+  journal[offset] = 'S';
+  ASSERT_TRUE(WriteFile(path_.AddExtensionASCII("journal"), journal));
+
+  // The records after a corrupt one are dropped too.
+  EXPECT_EQ((std::vector<std::string>{"", "first"}), Load());
+}
+
+TEST_F(JournaledFileTest, StaleJournal) {
+  {
+    JournaledFile file(path_);
+    std::string snapshot;
+    std::vector<std::string> records;
+    ASSERT_TRUE(file.Load(snapshot, records));
+    ASSERT_TRUE(file.Append("old"));
+  }
+  std::string old_journal;
+  ASSERT_TRUE(
+      ReadFileToString(path_.AddExtensionASCII("journal"), &old_journal));
+  {
+    JournaledFile file(path_);
+    std::string snapshot;
+    std::vector<std::string> records;
+    ASSERT_TRUE(file.Load(snapshot, records));
+    ASSERT_TRUE(file.Compact("new"));
+  }
+  // As if the process crashed after writing the snapshot, but before emptying
+  // the journal: the old records are already in the snapshot.
+  ASSERT_TRUE(WriteFile(path_.AddExtensionASCII("journal"), old_journal));
+  EXPECT_EQ((std::vector<std::string>{"new"}), Load());
+}
+
+TEST_F(JournaledFileTest, CorruptSnapshot) {
+  ASSERT_TRUE(WriteFile(path_, "not a snapshot"));
+  JournaledFile file(path_);
+  std::string snapshot;
+  std::vector<std::string> records;
+  EXPECT_FALSE(file.Load(snapshot, records));
+}
+
+}  // namespace base
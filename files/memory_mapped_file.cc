@@ -60,10 +60,11 @@ bool MemoryMappedFile::Initialize(const FilePath& file_name, Access access) {
     return false;
   }
 
-  if (!MapFileRegionToMemory(Region::kWholeFile, access)) {
+  if (!MapFileRegionToMemory(Region::kWholeFile, access, MapOptions())) {
     CloseHandles();
     return false;
   }
+  copy_on_write_ = access == READ_WRITE_COPY;
 
   return true;
 }
@@ -76,6 +77,13 @@ bool MemoryMappedFile::Initialize(File file, Access access) {
 bool MemoryMappedFile::Initialize(File file,
                                   const Region& region,
                                   Access access) {
+  return Initialize(std::move(file), region, access, MapOptions());
+}
+
+bool MemoryMappedFile::Initialize(File file,
+                                  const Region& region,
+                                  Access access,
+                                  const MapOptions& options) {
   switch (access) {
     case READ_WRITE_EXTEND:
       DCHECK(Region::kWholeFile != region);
@@ -114,10 +122,11 @@ bool MemoryMappedFile::Initialize(File file,
 
   file_ = std::move(file);
 
-  if (!MapFileRegionToMemory(region, access)) {
+  if (!MapFileRegionToMemory(region, access, options)) {
     CloseHandles();
     return false;
   }
+  copy_on_write_ = access == READ_WRITE_COPY;
 
   return true;
 }
@@ -126,6 +135,18 @@ bool MemoryMappedFile::IsValid() const {
   return !bytes_.empty();
 }
 
+span<uint8_t> MemoryMappedFile::BytesInRegion(const Region& region) {
+  if (region == Region::kWholeFile) {
+    return bytes_;
+  }
+  if (region.offset < 0 ||
+      static_cast<uint64_t>(region.offset) > bytes_.size() ||
+      region.size > bytes_.size() - static_cast<size_t>(region.offset)) {
+    return span<uint8_t>();
+  }
+  return bytes_.subspan(static_cast<size_t>(region.offset), region.size);
+}
+
 // static
 void MemoryMappedFile::CalculateVMAlignedBoundaries(int64_t start,
                                                     size_t size,
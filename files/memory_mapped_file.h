@@ -62,6 +62,33 @@ class BASE_EXPORT MemoryMappedFile {
 #endif
   };
 
+  // How a mapping is going to be accessed, so that the OS can tune read-ahead.
+  enum class AccessPattern {
+    kNormal,
+    // Reads ahead aggressively, and may drop pages soon after they are used.
+    kSequential,
+    // Reads only the pages which are accessed.
+    kRandom,
+  };
+
+  // Options for the mapping made by Initialize().
+  struct MapOptions {
+    // Reads the whole mapping in from the file while mapping it, so that later
+    // accesses don't fault. This is MAP_POPULATE on Linux, ChromeOS and
+    // Android, and Prefetch() of the whole mapping elsewhere.
+    bool populate = false;
+
+    // Asks for the mapping to be backed by transparent huge pages, which cuts
+    // TLB misses for large mappings accessed at random. This only takes effect
+    // on Linux, ChromeOS and Android, when the kernel supports huge pages in
+    // the page cache of the file system (MADV_HUGEPAGE). Windows only
+    // supports large pages for memory which is not backed by a file.
+    bool huge_pages = false;
+
+    // See Advise().
+    AccessPattern access_pattern = AccessPattern::kNormal;
+  };
+
   // The default constructor sets all members to invalid/null values.
   MemoryMappedFile();
   MemoryMappedFile(const MemoryMappedFile&) = delete;
@@ -110,6 +137,12 @@ class BASE_EXPORT MemoryMappedFile {
     return Initialize(std::move(file), region, READ_ONLY);
   }
 
+  // As above, with `options` for the mapping.
+  [[nodiscard]] bool Initialize(File file,
+                                const Region& region,
+                                Access access,
+                                const MapOptions& options);
+
   const uint8_t* data() const { return bytes_.data(); }
   uint8_t* data() { return bytes_.data(); }
   size_t length() const { return bytes_.size(); }
@@ -120,6 +153,24 @@ class BASE_EXPORT MemoryMappedFile {
   // Is file_ a valid file handle that points to an open, memory mapped file?
   bool IsValid() const;
 
+  // Starts reading `region`, whose offset is relative to the start of
+  // bytes(), in from the file without blocking, so that accessing it later
+  // doesn't fault. Region::kWholeFile prefetches all of bytes(). This is
+  // madvise(MADV_WILLNEED) on POSIX and PrefetchVirtualMemory() on Windows.
+  // Returns false if `region` is out of bounds or the OS rejected the hint.
+  bool Prefetch(const Region& region);
+
+  // Tells the OS how the mapping is going to be accessed. This is madvise() on
+  // POSIX. Windows has no equivalent, so it returns false there.
+  bool Advise(AccessPattern pattern);
+
+  // Drops the pages of `region`, relative to bytes() like for Prefetch(), from
+  // the resident memory of the process, e.g. when it goes idle. They are read
+  // in again from the file when accessed. This is madvise(MADV_DONTNEED) on
+  // POSIX and VirtualUnlock() on Windows. Returns false if `region` is out of
+  // bounds, and for READ_WRITE_COPY mappings, whose changes would be lost.
+  bool Evict(const Region& region);
+
  private:
   // Given the arbitrarily aligned memory region [start, size], returns the
   // boundaries of the region aligned to the granularity specified by the OS,
@@ -142,7 +193,13 @@ class BASE_EXPORT MemoryMappedFile {
   // Map the file to memory, point `bytes_` to that memory address. Return true
   // on success, false on any kind of failure. This is a helper for
   // Initialize().
-  bool MapFileRegionToMemory(const Region& region, Access access);
+  bool MapFileRegionToMemory(const Region& region,
+                             Access access,
+                             const MapOptions& options);
+
+  // Returns the part of `bytes_` which `region` refers to, for Prefetch() and
+  // Evict(), or an empty span if it is out of bounds.
+  span<uint8_t> BytesInRegion(const Region& region);
 
   // Closes all open handles.
   void CloseHandles();
@@ -153,6 +210,9 @@ class BASE_EXPORT MemoryMappedFile {
   // there is no benefit to using a raw_span, only cost.
   RAW_PTR_EXCLUSION span<uint8_t> bytes_;
 
+  // True for READ_WRITE_COPY mappings, which Evict() would revert.
+  bool copy_on_write_ = false;
+
 #if BUILDFLAG(IS_WIN)
   win::ScopedHandle file_mapping_;
 #endif
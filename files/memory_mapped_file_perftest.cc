@@ -0,0 +1,133 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/memory_mapped_file.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/check.h"
+#include "base/containers/heap_array.h"
+#include "base/debug/alias.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/functional/function_ref.h"
+#include "base/memory/page_size.h"
+#include "base/rand_util.h"
+#include "base/test/test_file_util.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "MemoryMappedFile.";
+constexpr char kMetricSequential[] = "sequential_access_time";
+constexpr char kMetricRandom[] = "random_access_time";
+
+constexpr size_t kFileSize = 128 * 1024 * 1024;
+
+class MemoryMappedFilePerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("mapped");
+    File file(path_, File::FLAG_CREATE_ALWAYS | File::FLAG_WRITE);
+    ASSERT_TRUE(file.IsValid());
+    auto chunk = HeapArray<uint8_t>::Uninit(1024 * 1024);
+    RandBytes(chunk);
+    for (size_t offset = 0; offset < kFileSize; offset += chunk.size()) {
+      ASSERT_TRUE(file.WriteAndCheck(static_cast<int64_t>(offset), chunk));
+    }
+    ASSERT_TRUE(file.Flush());
+
+    // A page from each 64 KB, in random order, as in lookups in an index.
+    for (size_t offset = 0; offset < kFileSize; offset += 64 * 1024) {
+      random_pages_.push_back(offset);
+    }
+    RandomShuffle(random_pages_.begin(), random_pages_.end());
+  }
+
+  // Maps the file with `options` after dropping it from the page cache, calls
+  // `prepare`, and then reports the time to read a byte from every page in
+  // order and, on a fresh mapping, from the random pages. The time includes
+  // Initialize() and `prepare`.
+  void RunTest(const std::string& story,
+               const MemoryMappedFile::MapOptions& options,
+               FunctionRef<void(MemoryMappedFile&)> prepare) {
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+    reporter.RegisterImportantMetric(kMetricSequential, "ms");
+    reporter.RegisterImportantMetric(kMetricRandom, "ms");
+
+    const size_t page_size = GetPageSize();
+    reporter.AddResult(
+        kMetricSequential,
+        TimeAccesses(options, prepare, [&](span<const uint8_t> bytes) {
+          uint8_t sum = 0;
+          for (size_t i = 0; i < bytes.size(); i += page_size) {
+            sum += bytes[i];
+          }
+          return sum;
+        }));
+
+    reporter.AddResult(
+        kMetricRandom,
+        TimeAccesses(options, prepare, [&](span<const uint8_t> bytes) {
+          uint8_t sum = 0;
+          for (size_t offset : random_pages_) {
+            sum += bytes[offset];
+          }
+          return sum;
+        }));
+  }
+
+ private:
+  double TimeAccesses(const MemoryMappedFile::MapOptions& options,
+                      FunctionRef<void(MemoryMappedFile&)> prepare,
+                      FunctionRef<uint8_t(span<const uint8_t>)> access) {
+    // Without this the file is warm, and only minor faults are measured.
+    EvictFileFromSystemCache(path_);
+
+    const TimeTicks start = TimeTicks::Now();
+    MemoryMappedFile map;
+    CHECK(map.Initialize(File(path_, File::FLAG_OPEN | File::FLAG_READ),
+                         MemoryMappedFile::Region::kWholeFile,
+                         MemoryMappedFile::READ_ONLY, options));
+    prepare(map);
+    uint8_t sum = access(map.bytes());
+    debug::Alias(&sum);
+    return (TimeTicks::Now() - start).InMillisecondsF();
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+  std::vector<size_t> random_pages_;
+};
+
+}  // namespace
+
+TEST_F(MemoryMappedFilePerfTest, ColdAccess) {
+  const auto no_prepare = [](MemoryMappedFile&) {};
+
+  RunTest("Default", {}, no_prepare);
+  RunTest("Populate", {.populate = true}, no_prepare);
+  RunTest("Sequential",
+          {.access_pattern = MemoryMappedFile::AccessPattern::kSequential},
+          no_prepare);
+  RunTest("Random",
+          {.access_pattern = MemoryMappedFile::AccessPattern::kRandom},
+          no_prepare);
+  RunTest("HugePages", {.huge_pages = true}, no_prepare);
+  RunTest("Prefetch", {}, [](MemoryMappedFile& map) {
+    map.Prefetch(MemoryMappedFile::Region::kWholeFile);
+  });
+}
+
+}  // namespace base
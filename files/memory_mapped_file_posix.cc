@@ -13,6 +13,8 @@
 
 #include "base/files/file_util.h"
 #include "base/logging.h"
+#include "base/memory/page_size.h"
+#include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "build/build_config.h"
@@ -22,9 +24,32 @@ namespace base {
 MemoryMappedFile::MemoryMappedFile() = default;
 
 #if !BUILDFLAG(IS_NACL)
+namespace {
+
+// Applies `advice` to the pages which hold `bytes`.
+bool AdvisePages(span<uint8_t> bytes, int advice) {
+  if (bytes.empty()) {
+    return false;
+  }
+  // madvise() needs a page-aligned start. The mapping covers whole pages, so
+  // the page which holds the first byte is within it.
+  const uintptr_t page_mask = static_cast<uintptr_t>(GetPageSize()) - 1;
+  const uintptr_t start = reinterpret_cast<uintptr_t>(bytes.data());
+  const uintptr_t aligned_start = start & ~page_mask;
+  const size_t length = bytes.size() + (start - aligned_start);
+  if (madvise(reinterpret_cast<void*>(aligned_start), length, advice) != 0) {
+    DPLOG(ERROR) << "madvise";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 bool MemoryMappedFile::MapFileRegionToMemory(
     const MemoryMappedFile::Region& region,
-    Access access) {
+    Access access,
+    const MapOptions& options) {
   ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
 
   off_t map_start = 0;
@@ -98,6 +123,12 @@ bool MemoryMappedFile::MapFileRegionToMemory(
       break;
   }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (options.populate) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+
   auto* ptr = static_cast<uint8_t*>(
       mmap(nullptr, map_size, prot, flags, file_.GetPlatformFile(), map_start));
   if (ptr == MAP_FAILED) {
@@ -128,8 +159,47 @@ bool MemoryMappedFile::MapFileRegionToMemory(
   // the padding before and after the mapped region to satisfy alignment. So
   // the `data_offset + byte_size <= map_size`.
   bytes_ = UNSAFE_BUFFERS(base::span(ptr + data_offset, byte_size));
+
+  // The options are hints, so failing to apply them doesn't fail the mapping.
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (options.huge_pages) {
+    AdvisePages(bytes_, MADV_HUGEPAGE);
+  }
+#else
+  if (options.populate) {
+    Prefetch(Region::kWholeFile);
+  }
+#endif
+  if (options.access_pattern != AccessPattern::kNormal) {
+    Advise(options.access_pattern);
+  }
   return true;
 }
+
+bool MemoryMappedFile::Prefetch(const Region& region) {
+  return AdvisePages(BytesInRegion(region), MADV_WILLNEED);
+}
+
+bool MemoryMappedFile::Advise(AccessPattern pattern) {
+  switch (pattern) {
+    case AccessPattern::kNormal:
+      return AdvisePages(bytes_, MADV_NORMAL);
+    case AccessPattern::kSequential:
+      return AdvisePages(bytes_, MADV_SEQUENTIAL);
+    case AccessPattern::kRandom:
+      return AdvisePages(bytes_, MADV_RANDOM);
+  }
+  NOTREACHED_NORETURN();
+}
+
+bool MemoryMappedFile::Evict(const Region& region) {
+  if (copy_on_write_) {
+    return false;
+  }
+  // The pages of read-only and shared mappings are backed by the file, so
+  // discarding them only costs reading them again.
+  return AdvisePages(BytesInRegion(region), MADV_DONTNEED);
+}
 #endif
 
 void MemoryMappedFile::CloseHandles() {
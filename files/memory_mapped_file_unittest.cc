@@ -18,6 +18,7 @@
 #include "base/containers/span.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
@@ -178,6 +179,78 @@ TEST_F(MemoryMappedFileTest, MapLargePartialRegionInTheMiddle) {
   ASSERT_TRUE(CheckBufferContents(map.bytes().first(kPartialSize), kOffset));
 }
 
+TEST_F(MemoryMappedFileTest, MapWithOptions) {
+  const size_t kFileSize = 157 * 1024;
+  const size_t kOffset = 1024 * 5 + 32;
+  const size_t kPartialSize = 64 * 1024;
+  CreateTemporaryTestFile(kFileSize);
+
+  for (MemoryMappedFile::AccessPattern pattern :
+       {MemoryMappedFile::AccessPattern::kNormal,
+        MemoryMappedFile::AccessPattern::kSequential,
+        MemoryMappedFile::AccessPattern::kRandom}) {
+    MemoryMappedFile map;
+    File file(temp_file_path(), File::FLAG_OPEN | File::FLAG_READ);
+    MemoryMappedFile::MapOptions options;
+    options.populate = true;
+    options.huge_pages = true;
+    options.access_pattern = pattern;
+    ASSERT_TRUE(map.Initialize(std::move(file), {kOffset, kPartialSize},
+                               MemoryMappedFile::READ_ONLY, options));
+    ASSERT_EQ(kPartialSize, map.length());
+    EXPECT_TRUE(CheckBufferContents(map.bytes(), kOffset));
+  }
+}
+
+TEST_F(MemoryMappedFileTest, PrefetchAndAdvise) {
+  const size_t kFileSize = 157 * 1024;
+  const size_t kOffset = 1024 * 5 + 32;
+  const size_t kPartialSize = 64 * 1024;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  File file(temp_file_path(), File::FLAG_OPEN | File::FLAG_READ);
+  ASSERT_TRUE(map.Initialize(std::move(file), {kOffset, kPartialSize}));
+
+  // The region is relative to the mapped bytes, which don't start on a page.
+  EXPECT_TRUE(map.Prefetch(MemoryMappedFile::Region::kWholeFile));
+  EXPECT_TRUE(map.Prefetch({100, 1000}));
+  EXPECT_TRUE(map.Prefetch({0, kPartialSize}));
+  EXPECT_FALSE(map.Prefetch({1, kPartialSize}));
+  EXPECT_FALSE(map.Prefetch({-1, 10}));
+  EXPECT_FALSE(map.Prefetch({kPartialSize, 0}));
+  EXPECT_TRUE(CheckBufferContents(map.bytes(), kOffset));
+
+#if BUILDFLAG(IS_WIN)
+  EXPECT_FALSE(map.Advise(MemoryMappedFile::AccessPattern::kRandom));
+#else
+  EXPECT_TRUE(map.Advise(MemoryMappedFile::AccessPattern::kRandom));
+  EXPECT_TRUE(map.Advise(MemoryMappedFile::AccessPattern::kSequential));
+  EXPECT_TRUE(map.Advise(MemoryMappedFile::AccessPattern::kNormal));
+#endif
+  EXPECT_TRUE(CheckBufferContents(map.bytes(), kOffset));
+}
+
+TEST_F(MemoryMappedFileTest, Evict) {
+  const size_t kFileSize = 157 * 1024;
+  CreateTemporaryTestFile(kFileSize);
+  MemoryMappedFile map;
+  ASSERT_TRUE(map.Initialize(temp_file_path()));
+  ASSERT_TRUE(CheckBufferContents(map.bytes(), 0));
+
+  // The pages are read in again when accessed.
+  EXPECT_TRUE(map.Evict({4096, 8192}));
+  EXPECT_TRUE(CheckBufferContents(map.bytes(), 0));
+  EXPECT_TRUE(map.Evict(MemoryMappedFile::Region::kWholeFile));
+  EXPECT_TRUE(CheckBufferContents(map.bytes(), 0));
+  EXPECT_FALSE(map.Evict({0, kFileSize + 1}));
+
+  // The changes of a copy-on-write mapping would be lost.
+  MemoryMappedFile copy_on_write_map;
+  ASSERT_TRUE(copy_on_write_map.Initialize(temp_file_path(),
+                                           MemoryMappedFile::READ_WRITE_COPY));
+  EXPECT_FALSE(copy_on_write_map.Evict(MemoryMappedFile::Region::kWholeFile));
+}
+
 TEST_F(MemoryMappedFileTest, WriteableFile) {
   const size_t kFileSize = 127;
   CreateTemporaryTestFile(kFileSize);
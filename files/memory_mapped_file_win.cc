@@ -62,7 +62,8 @@ bool MemoryMappedFile::MapImageToMemory(Access access) {
 
 bool MemoryMappedFile::MapFileRegionToMemory(
     const MemoryMappedFile::Region& region,
-    Access access) {
+    Access access,
+    const MapOptions& options) {
   ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
 
   DCHECK(access != READ_CODE_IMAGE || region == Region::kWholeFile);
@@ -175,6 +176,42 @@ bool MemoryMappedFile::MapFileRegionToMemory(
   // the padding before and after the mapped region to satisfy alignment. So
   // the `data_offset + byte_size <= map_size`.
   bytes_ = UNSAFE_BUFFERS(base::span(ptr + data_offset, byte_size));
+
+  // The options are hints, so failing to apply them doesn't fail the mapping.
+  // There are no huge pages or access patterns for views of files.
+  if (options.populate) {
+    Prefetch(Region::kWholeFile);
+  }
+  return true;
+}
+
+bool MemoryMappedFile::Prefetch(const Region& region) {
+  span<uint8_t> bytes = BytesInRegion(region);
+  // ::PrefetchVirtualMemory() fails when asked to read zero bytes.
+  if (bytes.empty()) {
+    return false;
+  }
+  ::_WIN32_MEMORY_RANGE_ENTRY address_range = {bytes.data(), bytes.size()};
+  return ::PrefetchVirtualMemory(::GetCurrentProcess(),
+                                 /*NumberOfEntries=*/1, &address_range,
+                                 /*Flags=*/0);
+}
+
+bool MemoryMappedFile::Advise(AccessPattern pattern) {
+  return false;
+}
+
+bool MemoryMappedFile::Evict(const Region& region) {
+  span<uint8_t> bytes = BytesInRegion(region);
+  if (bytes.empty() || copy_on_write_) {
+    return false;
+  }
+  // Unlocking pages which aren't locked removes them from the working set,
+  // and fails with ERROR_NOT_LOCKED.
+  if (!::VirtualUnlock(bytes.data(), bytes.size()) &&
+      ::GetLastError() != ERROR_NOT_LOCKED) {
+    return false;
+  }
   return true;
 }
 
@@ -0,0 +1,329 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/parallel_file_enumerator.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "base/files/scoped_file.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/ranges/algorithm.h"
+#include "base/synchronization/lock.h"
+#include "base/task/post_job.h"
+#include "base/thread_annotations.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sys/syscall.h>
+
+#include "base/files/dir_reader_linux.h"
+#define HAS_GETDENTS64 1
+#endif
+
+namespace base {
+
+namespace {
+
+// Large enough for a few hundred entries per getdents64() call, instead of
+// DirReaderLinux's handful.
+constexpr size_t kDirentBufferSize = 32 * 1024;
+
+bool IsDotOrDotDot(const char* name) {
+  return name[0] == '.' &&
+         (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+// The directories left of an Enumerate() call. Each worker reads directories
+// from the queue until it is empty, and queues the subdirectories it finds.
+class DirectoryQueue {
+ public:
+  DirectoryQueue(const ParallelFileEnumerator::Options& options,
+                 FunctionRef<void(const ParallelFileEnumerator::Entry&)>
+                     callback)
+      : options_(options), callback_(callback) {}
+
+  DirectoryQueue(const DirectoryQueue&) = delete;
+  DirectoryQueue& operator=(const DirectoryQueue&) = delete;
+
+  bool succeeded() const { return !failed_.load(std::memory_order_relaxed); }
+
+  // Queues the first directory, before the job starts.
+  void Start(FilePath root) {
+    if (options_.follow_symlinks) {
+      stat_wrapper_t st;
+      if (File::Stat(root, &st) == 0) {
+        MarkVisited(st);
+      }
+    }
+    Push({std::move(root)}, nullptr);
+  }
+
+  // Worker task: reads directories until none is queued or `delegate` asks to
+  // yield.
+  void Run(JobDelegate* delegate) {
+    ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                            BlockingType::MAY_BLOCK);
+    while (std::optional<FilePath> directory = Pop()) {
+      ReadDirectory(*directory, delegate);
+      // This directory is done, after its subdirectories were counted.
+      remaining_.fetch_sub(1, std::memory_order_relaxed);
+      if (delegate->ShouldYield()) {
+        return;
+      }
+    }
+  }
+
+  // Max concurrency callback: the directories queued or being read. Those
+  // being read may find more.
+  size_t GetMaxConcurrency(size_t /*worker_count*/) const {
+    return remaining_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void Push(std::vector<FilePath> directories, JobDelegate* delegate) {
+    if (directories.empty()) {
+      return;
+    }
+    remaining_.fetch_add(directories.size(), std::memory_order_relaxed);
+    {
+      AutoLock lock(lock_);
+      for (FilePath& directory : directories) {
+        directories_.push_back(std::move(directory));
+      }
+    }
+    // Not under `lock_`, as this may call GetMaxConcurrency().
+    if (delegate) {
+      delegate->NotifyConcurrencyIncrease();
+    }
+  }
+
+  std::optional<FilePath> Pop() {
+    AutoLock lock(lock_);
+    if (directories_.empty()) {
+      return std::nullopt;
+    }
+    // Depth-first, which keeps the queue short.
+    FilePath directory = std::move(directories_.back());
+    directories_.pop_back();
+    return directory;
+  }
+
+  // Returns true if the directory of `st` wasn't visited yet.
+  bool MarkVisited(const stat_wrapper_t& st) {
+    AutoLock lock(lock_);
+    return visited_.emplace(st.st_dev, st.st_ino).second;
+  }
+
+  void ReadDirectory(const FilePath& directory, JobDelegate* delegate) {
+    ScopedFD fd(HANDLE_EINTR(open(directory.value().c_str(),
+                                  O_RDONLY | O_DIRECTORY | O_CLOEXEC)));
+    if (!fd.is_valid()) {
+      // The directory may have been removed since it was found.
+      if (errno != ENOENT) {
+        DPLOG(ERROR) << "Cannot open '" << directory << "'";
+        failed_.store(true, std::memory_order_relaxed);
+      }
+      return;
+    }
+
+    std::vector<FilePath> subdirectories;
+    const auto on_entry = [&](const char* name, unsigned char type) {
+      if (!IsDotOrDotDot(name)) {
+        ReportEntry(directory, fd.get(), name, type, subdirectories);
+      }
+    };
+#if defined(HAS_GETDENTS64)
+    alignas(linux_dirent) unsigned char buffer[kDirentBufferSize];
+    for (;;) {
+      const long size =
+          HANDLE_EINTR(syscall(__NR_getdents64, fd.get(), buffer,
+                               sizeof(buffer)));
+      if (size <= 0) {
+        if (size < 0 && errno != ENOENT) {
+          DPLOG(ERROR) << "getdents64 failed on '" << directory << "'";
+          failed_.store(true, std::memory_order_relaxed);
+        }
+        break;
+      }
+      for (long offset = 0; offset < size;) {
+        const auto* dirent =
+            reinterpret_cast<const linux_dirent*>(&buffer[offset]);
+        on_entry(dirent->d_name, dirent->d_type);
+        offset += dirent->d_reclen;
+      }
+    }
+#else
+    // fdopendir() takes ownership of the descriptor on success, so read
+    // through a copy and keep `fd` for fstatat().
+    ScopedFD dir_fd(HANDLE_EINTR(dup(fd.get())));
+    DIR* dir = dir_fd.is_valid() ? fdopendir(dir_fd.get()) : nullptr;
+    if (!dir) {
+      DPLOG(ERROR) << "Cannot read '" << directory << "'";
+      failed_.store(true, std::memory_order_relaxed);
+      return;
+    }
+    std::ignore = dir_fd.release();
+    errno = 0;
+    while (const dirent* entry = readdir(dir)) {
+      on_entry(entry->d_name, entry->d_type);
+      errno = 0;
+    }
+    if (errno != 0) {
+      DPLOG(ERROR) << "readdir failed on '" << directory << "'";
+      failed_.store(true, std::memory_order_relaxed);
+    }
+    closedir(dir);
+#endif
+
+    Push(std::move(subdirectories), delegate);
+  }
+
+  // Reports the entry `name` of `directory`, whose descriptor is `fd`, and
+  // adds it to `subdirectories` if it should be enumerated.
+  void ReportEntry(const FilePath& directory,
+                   int fd,
+                   const char* name,
+                   unsigned char type,
+                   std::vector<FilePath>& subdirectories) {
+    ParallelFileEnumerator::Entry entry;
+    entry.path = directory.Append(name);
+    // Following symlinks needs the (device, inode) of the directories.
+    const bool needs_stat =
+        options_.stat_entries || type == DT_UNKNOWN ||
+        (options_.follow_symlinks && (type == DT_LNK || type == DT_DIR));
+    bool has_stat = false;
+    if (needs_stat) {
+      // Relative to `fd`, which saves resolving the whole path again.
+      int result = fstatat(fd, name, &entry.stat,
+                           options_.follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW);
+      if (result != 0 && errno == ENOENT && options_.follow_symlinks) {
+        // A dangling symlink is reported as itself.
+        result = fstatat(fd, name, &entry.stat, AT_SYMLINK_NOFOLLOW);
+      }
+      if (result != 0) {
+        // The entry may have been removed since it was read.
+        if (errno != ENOENT) {
+          DPLOG(ERROR) << "Cannot stat '" << entry.path << "'";
+          failed_.store(true, std::memory_order_relaxed);
+        }
+        return;
+      }
+      has_stat = true;
+    }
+    entry.is_directory =
+        has_stat ? S_ISDIR(entry.stat.st_mode) : type == DT_DIR;
+    const bool enumerate =
+        entry.is_directory && options_.recursive &&
+        (!options_.follow_symlinks || MarkVisited(entry.stat));
+    if (!options_.stat_entries) {
+      entry.stat = {};
+    }
+    callback_(entry);
+    if (enumerate) {
+      subdirectories.push_back(std::move(entry.path));
+    }
+  }
+
+  const ParallelFileEnumerator::Options options_;
+  const FunctionRef<void(const ParallelFileEnumerator::Entry&)> callback_;
+
+  // The directories queued or being read.
+  std::atomic<size_t> remaining_{0};
+  std::atomic<bool> failed_{false};
+
+  Lock lock_;
+  std::vector<FilePath> directories_ GUARDED_BY(lock_);
+  // The (device, inode) of the directories enumerated, if following
+  // symlinks.
+  std::set<std::pair<dev_t, ino_t>> visited_ GUARDED_BY(lock_);
+};
+
+}  // namespace
+
+// static
+bool ParallelFileEnumerator::Enumerate(
+    const FilePath& root,
+    const Options& options,
+    FunctionRef<void(const Entry&)> callback) {
+  DirectoryQueue queue(options, callback);
+  queue.Start(root);
+  // `queue` outlives the job, since Join() returns once all workers returned
+  // and no directory is left.
+  CreateJob(FROM_HERE, {MayBlock(), options.priority},
+            BindRepeating(&DirectoryQueue::Run, Unretained(&queue)),
+            BindRepeating(&DirectoryQueue::GetMaxConcurrency,
+                          Unretained(&queue)))
+      .Join();
+  return queue.succeeded();
+}
+
+int64_t ComputeDirectorySizeInParallel(const FilePath& root_path) {
+  std::atomic<int64_t> size{0};
+  ParallelFileEnumerator::Enumerate(
+      root_path, {}, [&](const ParallelFileEnumerator::Entry& entry) {
+        if (S_ISREG(entry.stat.st_mode)) {
+          size.fetch_add(entry.stat.st_size, std::memory_order_relaxed);
+        }
+      });
+  return size.load(std::memory_order_relaxed);
+}
+
+bool DeletePathRecursivelyInParallel(const FilePath& path) {
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, BlockingType::MAY_BLOCK);
+  stat_wrapper_t file_info;
+  if (File::Lstat(path, &file_info) != 0) {
+    // As DeletePathRecursively().
+    return errno == ENOENT;
+  }
+  if (!S_ISDIR(file_info.st_mode)) {
+    return unlink(path.value().c_str()) == 0 || errno == ENOENT;
+  }
+
+  // Files are removed as they are found, in parallel. Directories are removed
+  // once empty, deepest first.
+  std::atomic<bool> success{true};
+  Lock lock;
+  std::vector<FilePath> directories;
+  const bool enumerated = ParallelFileEnumerator::Enumerate(
+      path, {.stat_entries = false},
+      [&](const ParallelFileEnumerator::Entry& entry) {
+        if (entry.is_directory) {
+          AutoLock auto_lock(lock);
+          directories.push_back(entry.path);
+        } else if (unlink(entry.path.value().c_str()) != 0 &&
+                   errno != ENOENT) {
+          success.store(false, std::memory_order_relaxed);
+        }
+      });
+
+  const auto depth = [](const FilePath& directory) {
+    return ranges::count(directory.value(), FilePath::kSeparators[0]);
+  };
+  ranges::stable_sort(directories, ranges::greater(), depth);
+  directories.push_back(path);
+  for (const FilePath& directory : directories) {
+    if (rmdir(directory.value().c_str()) != 0 && errno != ENOENT) {
+      success.store(false, std::memory_order_relaxed);
+    }
+  }
+  return enumerated && success.load(std::memory_order_relaxed);
+}
+
+}  // namespace base
@@ -0,0 +1,68 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_PARALLEL_FILE_ENUMERATOR_H_
+#define BASE_FILES_PARALLEL_FILE_ENUMERATOR_H_
+
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include "base/base_export.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/functional/function_ref.h"
+#include "base/task/task_traits.h"
+
+namespace base {
+
+// Enumerates a directory tree on several threads: each directory found is
+// read by a PostJob() worker, and the entries are reported to a callback as
+// they are read. Unlike FileEnumerator, which reads one directory at a time
+// and stats every entry by path, this reads directories with getdents64()
+// where available and stats entries relative to the directory's descriptor,
+// which is much faster on large trees.
+//
+// The order of the entries is unspecified, except that a directory is
+// reported before its contents.
+class BASE_EXPORT ParallelFileEnumerator {
+ public:
+  struct Entry {
+    FilePath path;
+    bool is_directory = false;
+    // The lstat() of the entry, or its stat() if following symlinks. Only set
+    // if Options::stat_entries.
+    stat_wrapper_t stat = {};
+  };
+
+  struct Options {
+    // Whether to enumerate subdirectories.
+    bool recursive = true;
+    // Whether to enumerate the directories that symlinks point to. Each
+    // directory is enumerated once, so that cycles terminate.
+    bool follow_symlinks = false;
+    // Whether to set Entry::stat. If not, entries are stat()ed only if the
+    // file system doesn't report their types.
+    bool stat_entries = true;
+    TaskPriority priority = TaskPriority::USER_VISIBLE;
+  };
+
+  ParallelFileEnumerator() = delete;
+
+  // Calls `callback` for each entry under `root`, excluding `root` itself,
+  // and returns once all were reported. `callback` may be called on several
+  // threads at once, including this one. Returns false if a directory could
+  // not be read; the entries of the others are still reported. This blocks.
+  static bool Enumerate(const FilePath& root,
+                        const Options& options,
+                        FunctionRef<void(const Entry&)> callback);
+};
+
+// Like ComputeDirectorySize() and DeletePathRecursively() from file_util.h,
+// on a ParallelFileEnumerator.
+BASE_EXPORT int64_t ComputeDirectorySizeInParallel(const FilePath& root_path);
+BASE_EXPORT bool DeletePathRecursivelyInParallel(const FilePath& path);
+
+}  // namespace base
+
+#endif  // BASE_FILES_PARALLEL_FILE_ENUMERATOR_H_
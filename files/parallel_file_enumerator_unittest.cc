@@ -0,0 +1,146 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/parallel_file_enumerator.h"
+
+#include <stdint.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/lock.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class ParallelFileEnumeratorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    root_ = temp_dir_.GetPath().AppendASCII("root");
+    ASSERT_TRUE(CreateDirectory(root_));
+  }
+
+  // Creates a tree of `depth` levels of `fanout` directories, each with a
+  // file of 10 bytes, and returns the number of files.
+  int CreateTree(const FilePath& dir, int depth, int fanout) {
+    EXPECT_TRUE(WriteFile(dir.AppendASCII("file"), "0123456789"));
+    int files = 1;
+    if (depth == 0) {
+      return files;
+    }
+    for (int i = 0; i < fanout; ++i) {
+      const FilePath subdir = dir.AppendASCII("dir" + NumberToString(i));
+      EXPECT_TRUE(CreateDirectory(subdir));
+      files += CreateTree(subdir, depth - 1, fanout);
+    }
+    return files;
+  }
+
+  // Returns the entries under `root_`, relative to it, with whether they are
+  // directories.
+  std::map<std::string, bool> Enumerate(
+      const ParallelFileEnumerator::Options& options) {
+    Lock lock;
+    std::map<std::string, bool> entries;
+    EXPECT_TRUE(ParallelFileEnumerator::Enumerate(
+        root_, options, [&](const ParallelFileEnumerator::Entry& entry) {
+          FilePath relative;
+          EXPECT_TRUE(root_.AppendRelativePath(entry.path, &relative));
+          AutoLock auto_lock(lock);
+          EXPECT_TRUE(
+              entries.emplace(relative.value(), entry.is_directory).second);
+        }));
+    return entries;
+  }
+
+  test::TaskEnvironment task_environment_;
+  ScopedTempDir temp_dir_;
+  FilePath root_;
+};
+
+TEST_F(ParallelFileEnumeratorTest, Empty) {
+  EXPECT_TRUE(Enumerate({}).empty());
+}
+
+TEST_F(ParallelFileEnumeratorTest, Recursive) {
+  ASSERT_TRUE(CreateDirectory(root_.AppendASCII("a/b")));
+  ASSERT_TRUE(WriteFile(root_.AppendASCII("a/b/c"), "c"));
+  ASSERT_TRUE(WriteFile(root_.AppendASCII("d"), "d"));
+
+  const std::map<std::string, bool> expected = {
+      {"a", true}, {"a/b", true}, {"a/b/c", false}, {"d", false}};
+  EXPECT_EQ(expected, Enumerate({}));
+  EXPECT_EQ(expected, Enumerate({.stat_entries = false}));
+  EXPECT_EQ((std::map<std::string, bool>{{"a", true}, {"d", false}}),
+            Enumerate({.recursive = false}));
+}
+
+TEST_F(ParallelFileEnumeratorTest, Stat) {
+  ASSERT_TRUE(WriteFile(root_.AppendASCII("file"), "12345"));
+  int64_t size = -1;
+  ASSERT_TRUE(ParallelFileEnumerator::Enumerate(
+      root_, {}, [&](const ParallelFileEnumerator::Entry& entry) {
+        size = entry.stat.st_size;
+      }));
+  EXPECT_EQ(5, size);
+}
+
+TEST_F(ParallelFileEnumeratorTest, Symlinks) {
+  const FilePath target = temp_dir_.GetPath().AppendASCII("target");
+  ASSERT_TRUE(CreateDirectory(target));
+  ASSERT_TRUE(WriteFile(target.AppendASCII("file"), "file"));
+  ASSERT_TRUE(CreateSymbolicLink(target, root_.AppendASCII("link")));
+  // A cycle, which is enumerated once.
+  ASSERT_TRUE(CreateSymbolicLink(root_, target.AppendASCII("cycle")));
+  ASSERT_TRUE(CreateSymbolicLink(root_.AppendASCII("missing"),
+                                 root_.AppendASCII("dangling")));
+
+  EXPECT_EQ((std::map<std::string, bool>{{"dangling", false},
+                                         {"link", false}}),
+            Enumerate({}));
+  EXPECT_EQ((std::map<std::string, bool>{{"dangling", false},
+                                         {"link", true},
+                                         {"link/cycle", true},
+                                         {"link/file", false}}),
+            Enumerate({.follow_symlinks = true}));
+}
+
+TEST_F(ParallelFileEnumeratorTest, MissingRoot) {
+  EXPECT_TRUE(ParallelFileEnumerator::Enumerate(
+      root_.AppendASCII("missing"), {},
+      [](const ParallelFileEnumerator::Entry&) { ADD_FAILURE(); }));
+}
+
+TEST_F(ParallelFileEnumeratorTest, ComputeDirectorySize) {
+  const int files = CreateTree(root_, 3, 4);
+  EXPECT_EQ(10 * files, ComputeDirectorySizeInParallel(root_));
+  EXPECT_EQ(ComputeDirectorySize(root_), ComputeDirectorySizeInParallel(root_));
+}
+
+TEST_F(ParallelFileEnumeratorTest, DeletePathRecursively) {
+  CreateTree(root_, 3, 4);
+  // Symlinks are removed, not followed.
+  const FilePath outside = temp_dir_.GetPath().AppendASCII("outside");
+  ASSERT_TRUE(CreateDirectory(outside));
+  ASSERT_TRUE(WriteFile(outside.AppendASCII("file"), "file"));
+  ASSERT_TRUE(CreateSymbolicLink(outside, root_.AppendASCII("dir0/link")));
+
+  EXPECT_TRUE(DeletePathRecursivelyInParallel(root_));
+  EXPECT_FALSE(PathExists(root_));
+  EXPECT_TRUE(PathExists(outside.AppendASCII("file")));
+
+  // A missing path is already deleted, and a file is deleted on its own.
+  EXPECT_TRUE(DeletePathRecursivelyInParallel(root_));
+  EXPECT_TRUE(DeletePathRecursivelyInParallel(outside.AppendASCII("file")));
+  EXPECT_FALSE(PathExists(outside.AppendASCII("file")));
+}
+
+}  // namespace base
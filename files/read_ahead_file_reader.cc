@@ -0,0 +1,147 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/read_ahead_file_reader.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+
+namespace base {
+
+ReadAheadFileReader::Chunk::Chunk() = default;
+ReadAheadFileReader::Chunk::Chunk(Chunk&&) = default;
+ReadAheadFileReader::Chunk& ReadAheadFileReader::Chunk::operator=(Chunk&&) =
+    default;
+ReadAheadFileReader::Chunk::~Chunk() = default;
+
+ReadAheadFileReader::ReadAheadFileReader(File file)
+    : ReadAheadFileReader(std::move(file), Options()) {}
+
+ReadAheadFileReader::ReadAheadFileReader(File file, const Options& options)
+    : file_(MakeRefCounted<RefCountedData<File>>(std::move(file))),
+      options_(options) {
+  DCHECK(file_->data.IsValid());
+  CHECK_GT(options_.chunk_size, 0u);
+  CHECK_EQ(options_.chunk_size % File::kDirectIOAlignment, 0u);
+  CHECK(IsValueInRangeForNumericType<int>(options_.chunk_size));
+  CHECK_GT(options_.chunks_ahead, 0u);
+}
+
+ReadAheadFileReader::~ReadAheadFileReader() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void ReadAheadFileReader::ReadNext(ReadCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(!callback_);
+  callback_ = std::move(callback);
+  if (!current_buffer_.empty()) {
+    free_buffers_.push_back(std::move(current_buffer_));
+  }
+  StartReads();
+  // The next chunk may already have been read, but the callback must not run
+  // synchronously.
+  SequencedTaskRunner::GetCurrentDefault()->PostTask(
+      FROM_HERE, BindOnce(&ReadAheadFileReader::MaybeRunCallback,
+                          weak_factory_.GetWeakPtr()));
+}
+
+void ReadAheadFileReader::StartReads() {
+  while (!done_reading_ && chunks_.size() < options_.chunks_ahead) {
+    AlignedHeapArray<uint8_t> buffer;
+    if (free_buffers_.empty()) {
+      buffer = AlignedUninit<uint8_t>(options_.chunk_size,
+                                      File::kDirectIOAlignment);
+    } else {
+      buffer = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+    }
+    const uint64_t index = first_chunk_index_ + chunks_.size();
+    chunks_.emplace_back();
+    ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE,
+        {MayBlock(), options_.priority,
+         TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        BindOnce(&ReadAheadFileReader::ReadChunk, file_, next_offset_,
+                 std::move(buffer)),
+        BindOnce(&ReadAheadFileReader::OnChunkRead,
+                 weak_factory_.GetWeakPtr(), index));
+    next_offset_ += checked_cast<int64_t>(options_.chunk_size);
+  }
+}
+
+// static
+ReadAheadFileReader::Chunk ReadAheadFileReader::ReadChunk(
+    scoped_refptr<RefCountedData<File>> file,
+    int64_t offset,
+    AlignedHeapArray<uint8_t> buffer) {
+  Chunk chunk;
+  // File is safe to read at an offset from several threads at once.
+  std::optional<size_t> bytes_read =
+      file->data.Read(offset, buffer.as_span());
+  chunk.bytes_read = bytes_read ? checked_cast<int>(*bytes_read) : -1;
+  chunk.buffer = std::move(buffer);
+  return chunk;
+}
+
+void ReadAheadFileReader::OnChunkRead(uint64_t index, Chunk chunk) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (done_) {
+    // A read past the end of the file, or after a failure.
+    return;
+  }
+  DCHECK_GE(index, first_chunk_index_);
+  DCHECK_LT(index - first_chunk_index_, chunks_.size());
+  // A short read is at the end of the file.
+  if (*chunk.bytes_read < checked_cast<int>(options_.chunk_size)) {
+    done_reading_ = true;
+  }
+  chunks_[index - first_chunk_index_] = std::move(chunk);
+  MaybeRunCallback();
+}
+
+void ReadAheadFileReader::MaybeRunCallback() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!callback_) {
+    return;
+  }
+  if (done_) {
+    if (failed_) {
+      std::move(callback_).Run(std::nullopt);
+    } else {
+      std::move(callback_).Run(span<const uint8_t>());
+    }
+    return;
+  }
+  if (chunks_.empty() || !chunks_.front().bytes_read) {
+    return;
+  }
+
+  Chunk chunk = std::move(chunks_.front());
+  chunks_.pop_front();
+  ++first_chunk_index_;
+  const int bytes_read = *chunk.bytes_read;
+  if (bytes_read < checked_cast<int>(options_.chunk_size)) {
+    // Any chunks after this one are past the end of the file.
+    done_ = true;
+    failed_ = bytes_read < 0;
+    chunks_.clear();
+    free_buffers_.clear();
+  }
+  if (failed_) {
+    std::move(callback_).Run(std::nullopt);
+    return;
+  }
+  current_buffer_ = std::move(chunk.buffer);
+  std::move(callback_).Run(
+      current_buffer_.first(static_cast<size_t>(bytes_read)));
+}
+
+}  // namespace base
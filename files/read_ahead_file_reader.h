@@ -0,0 +1,116 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_FILES_READ_AHEAD_FILE_READER_H_
+#define BASE_FILES_READ_AHEAD_FILE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/circular_deque.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/functional/callback.h"
+#include "base/memory/aligned_memory.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/task/task_traits.h"
+
+namespace base {
+
+// Reads a file sequentially, in chunks read ahead on the thread pool, so that
+// the reads of the next chunks overlap with the processing of the current
+// one. The chunks are aligned buffers read at aligned offsets, so the file
+// may be opened with File::FLAG_DIRECT, e.g. so that a bulk scan doesn't
+// evict the data of other readers from the page cache.
+//
+// This must be used and destroyed on a single sequence.
+class BASE_EXPORT ReadAheadFileReader {
+ public:
+  struct Options {
+    // The size of each read. Must be a multiple of
+    // File::kDirectIOAlignment.
+    size_t chunk_size = 1024 * 1024;
+    // How many chunks are read ahead of the one being processed.
+    size_t chunks_ahead = 4;
+    TaskPriority priority = TaskPriority::USER_VISIBLE;
+  };
+
+  // Run with the next chunk of the file, which is empty at the end of the
+  // file, or with nullopt if a read failed.
+  using ReadCallback =
+      OnceCallback<void(std::optional<span<const uint8_t>> chunk)>;
+
+  // Reads `file` from its start; it must have been opened with
+  // File::FLAG_READ.
+  explicit ReadAheadFileReader(File file);
+  ReadAheadFileReader(File file, const Options& options);
+  ReadAheadFileReader(const ReadAheadFileReader&) = delete;
+  ReadAheadFileReader& operator=(const ReadAheadFileReader&) = delete;
+  // Reads still in flight complete on the thread pool, and are discarded.
+  ~ReadAheadFileReader();
+
+  // Runs `callback` asynchronously with the next chunk of the file. The chunk
+  // remains valid until the next call to ReadNext() or the destruction of
+  // this reader. Must not be called again before `callback` has run.
+  void ReadNext(ReadCallback callback);
+
+ private:
+  struct Chunk {
+    Chunk();
+    Chunk(Chunk&&);
+    Chunk& operator=(Chunk&&);
+    ~Chunk();
+
+    AlignedHeapArray<uint8_t> buffer;
+    // The result of the read into `buffer`, negative if it failed, or nullopt
+    // while it is in flight.
+    std::optional<int> bytes_read;
+  };
+
+  // Starts reads until `options_.chunks_ahead` chunks are read ahead, or the
+  // end of the file was reached.
+  void StartReads();
+
+  static Chunk ReadChunk(scoped_refptr<RefCountedData<File>> file,
+                         int64_t offset,
+                         AlignedHeapArray<uint8_t> buffer);
+  void OnChunkRead(uint64_t index, Chunk chunk);
+
+  // Runs `callback_` if the next chunk was read.
+  void MaybeRunCallback();
+
+  const scoped_refptr<RefCountedData<File>> file_;
+  const Options options_;
+
+  // The chunks being read or read ahead, in order, then the chunk given to
+  // the last callback, and the buffers which can be reused.
+  circular_deque<Chunk> chunks_;
+  uint64_t first_chunk_index_ = 0;
+  AlignedHeapArray<uint8_t> current_buffer_;
+  std::vector<AlignedHeapArray<uint8_t>> free_buffers_;
+
+  // The offset of the next read to start.
+  int64_t next_offset_ = 0;
+  // Whether a read reached the end of the file, or failed, so that no more
+  // reads are needed.
+  bool done_reading_ = false;
+  // Whether the last chunk, or an error, was given to a callback.
+  bool done_ = false;
+  bool failed_ = false;
+
+  ReadCallback callback_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  WeakPtrFactory<ReadAheadFileReader> weak_factory_{this};
+};
+
+}  // namespace base
+
+#endif  // BASE_FILES_READ_AHEAD_FILE_READER_H_
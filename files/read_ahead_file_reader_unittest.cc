@@ -0,0 +1,111 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/read_ahead_file_reader.h"
+
+#include <stdint.h>
+
+#include <optional>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_future.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class ReadAheadFileReaderTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("file");
+  }
+
+  // Writes a file of `size` bytes, and returns its contents.
+  std::vector<uint8_t> WriteTestFile(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i) {
+      data[i] = static_cast<uint8_t>(i * 7);
+    }
+    EXPECT_TRUE(WriteFile(path_, data));
+    return data;
+  }
+
+  // Reads the whole file with `reader`, and returns its contents, or nullopt
+  // if a read failed.
+  std::optional<std::vector<uint8_t>> ReadAll(ReadAheadFileReader& reader) {
+    std::vector<uint8_t> contents;
+    while (true) {
+      test::TestFuture<std::optional<span<const uint8_t>>> future;
+      reader.ReadNext(future.GetCallback());
+      std::optional<span<const uint8_t>> chunk = future.Get();
+      if (!chunk) {
+        return std::nullopt;
+      }
+      if (chunk->empty()) {
+        return contents;
+      }
+      contents.insert(contents.end(), chunk->begin(), chunk->end());
+    }
+  }
+
+  test::TaskEnvironment task_environment_;
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+};
+
+TEST_F(ReadAheadFileReaderTest, ReadsFile) {
+  const ReadAheadFileReader::Options options = {
+      .chunk_size = File::kDirectIOAlignment, .chunks_ahead = 3};
+  // Empty, a chunk, and an uneven number of chunks.
+  for (size_t size : {size_t{0}, File::kDirectIOAlignment,
+                      10 * File::kDirectIOAlignment + 123}) {
+    const std::vector<uint8_t> data = WriteTestFile(size);
+    ReadAheadFileReader reader(File(path_, File::FLAG_OPEN | File::FLAG_READ),
+                               options);
+    EXPECT_EQ(data, ReadAll(reader)) << size;
+    // The end of the file is sticky.
+    EXPECT_EQ(std::vector<uint8_t>(), ReadAll(reader));
+  }
+}
+
+TEST_F(ReadAheadFileReaderTest, ReadsFileDirectly) {
+  const std::vector<uint8_t> data =
+      WriteTestFile(5 * File::kDirectIOAlignment + 1);
+  File file(path_, File::FLAG_OPEN | File::FLAG_READ | File::FLAG_DIRECT);
+  if (!file.IsValid()) {
+    // The temporary directory may be on a file system without direct I/O.
+    GTEST_SKIP() << File::ErrorToString(file.error_details());
+  }
+  ReadAheadFileReader reader(std::move(file),
+                             {.chunk_size = 2 * File::kDirectIOAlignment});
+  EXPECT_EQ(data, ReadAll(reader));
+}
+
+TEST_F(ReadAheadFileReaderTest, ReadFails) {
+  WriteTestFile(File::kDirectIOAlignment);
+  // Reading a file opened only for writing fails.
+  ReadAheadFileReader reader(File(path_, File::FLAG_OPEN | File::FLAG_WRITE));
+  EXPECT_EQ(std::nullopt, ReadAll(reader));
+  EXPECT_EQ(std::nullopt, ReadAll(reader));
+}
+
+TEST_F(ReadAheadFileReaderTest, DestroyWithReadsInFlight) {
+  WriteTestFile(10 * File::kDirectIOAlignment);
+  std::optional<ReadAheadFileReader> reader;
+  reader.emplace(File(path_, File::FLAG_OPEN | File::FLAG_READ),
+                 ReadAheadFileReader::Options{
+                     .chunk_size = File::kDirectIOAlignment});
+  reader->ReadNext(BindOnce([](std::optional<span<const uint8_t>> chunk) {
+    ADD_FAILURE() << "Unexpected callback";
+  }));
+  reader.reset();
+  task_environment_.RunUntilIdle();
+}
+
+}  // namespace base
@@ -10,6 +10,7 @@
 #include <concepts>
 #include <functional>
 #include <memory>
+#include <new>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -1137,8 +1138,17 @@ struct BindState final : BindStateBase {
     if constexpr (is_method) {
       VerifyMethodReceiver(bound_args...);
     }
-    return new BindState(invoke_func, std::forward<ForwardFunctor>(functor),
-                         std::forward<ForwardBoundArgs>(bound_args)...);
+    bool recycled;
+    BindState* bind_state = new (
+        AllocateStorage(sizeof(BindState), alignof(BindState), &recycled))
+        BindState(invoke_func, std::forward<ForwardFunctor>(functor),
+                  std::forward<ForwardBoundArgs>(bound_args)...);
+    // Recycled memory goes back to its pool, even if recycling is disabled
+    // before the bind state is destroyed.
+    if (recycled) {
+      bind_state->destructor_ = &DestroyRecycled;
+    }
+    return bind_state;
   }
 
   Functor functor_;
@@ -1186,6 +1196,13 @@ struct BindState final : BindStateBase {
     delete static_cast<const BindState*>(self);
   }
 
+  static void DestroyRecycled(const BindStateBase* self) {
+    auto* const bind_state =
+        const_cast<BindState*>(static_cast<const BindState*>(self));
+    bind_state->~BindState();
+    FreeRecycledStorage(bind_state, sizeof(BindState), alignof(BindState));
+  }
+
   // Helpers to do arg tuple expansion.
   template <size_t... indices>
   bool IsCancelled(std::index_sequence<indices...>) const {
@@ -4,7 +4,16 @@
 
 #include "base/functional/callback_internal.h"
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <new>
+
 #include "base/check.h"
+#include "base/feature_list.h"
+#include "base/features.h"
+#include "base/memory/object_pool.h"
+#include "base/no_destructor.h"
 #include "base/notreached.h"
 #include "base/types/cxx23_to_underlying.h"
 
@@ -13,6 +22,43 @@ namespace internal {
 
 namespace {
 
+// The size classes of the recycled bind states. The smallest holds a function
+// pointer and an int, the next one a method pointer and its receiver.
+constexpr size_t kBindStateSizeClasses[] = {48, 64, 96, 128};
+
+// Sanitizers need to see each allocation to detect use-after-frees.
+#if defined(ADDRESS_SANITIZER) || defined(MEMORY_SANITIZER)
+constexpr bool kRecycleBindStates = false;
+#else
+constexpr bool kRecycleBindStates = true;
+#endif
+
+// Whether the bind states created from now on are recycled, as of the
+// kRecycleBindStateMemory feature.
+std::atomic_bool g_recycle_bind_states{false};
+
+// Returns the pool recycling the bind states of `size` and `alignment`, or
+// null if they're too large or over-aligned.
+ObjectPoolBase* GetBindStatePool(size_t size, size_t alignment) {
+  if (!kRecycleBindStates || size > std::end(kBindStateSizeClasses)[-1] ||
+      alignment > alignof(std::max_align_t)) {
+    return nullptr;
+  }
+  struct BindStatePools {
+    ObjectPoolBase pools[std::size(kBindStateSizeClasses)] = {
+        {"bind_state_48", 48, alignof(std::max_align_t)},
+        {"bind_state_64", 64, alignof(std::max_align_t)},
+        {"bind_state_96", 96, alignof(std::max_align_t)},
+        {"bind_state_128", 128, alignof(std::max_align_t)},
+    };
+  };
+  static NoDestructor<BindStatePools> bind_state_pools;
+  const size_t size_class = static_cast<size_t>(
+      std::ranges::lower_bound(kBindStateSizeClasses, size) -
+      std::begin(kBindStateSizeClasses));
+  return &bind_state_pools->pools[size_class];
+}
+
 bool QueryCancellationTraitsForNonCancellables(
     const BindStateBase*,
     BindStateBase::CancellationQueryMode mode) {
@@ -41,6 +87,39 @@ BindStateBase::BindStateBase(
       destructor_(destructor),
       query_cancellation_traits_(query_cancellation_traits) {}
 
+// static
+void BindStateBase::InitializeFeatures() {
+  g_recycle_bind_states.store(
+      FeatureList::IsEnabled(features::kRecycleBindStateMemory),
+      std::memory_order_relaxed);
+}
+
+// static
+void* BindStateBase::AllocateStorage(size_t size,
+                                     size_t alignment,
+                                     bool* recycled) {
+  if (g_recycle_bind_states.load(std::memory_order_relaxed)) {
+    if (ObjectPoolBase* pool = GetBindStatePool(size, alignment)) {
+      *recycled = true;
+      return pool->Allocate();
+    }
+  }
+  *recycled = false;
+  if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    return ::operator new(size, std::align_val_t(alignment));
+  }
+  return ::operator new(size);
+}
+
+// static
+void BindStateBase::FreeRecycledStorage(void* storage,
+                                        size_t size,
+                                        size_t alignment) {
+  ObjectPoolBase* pool = GetBindStatePool(size, alignment);
+  CHECK(pool);
+  pool->Free(storage);
+}
+
 BindStateHolder& BindStateHolder::operator=(BindStateHolder&&) noexcept =
     default;
 
@@ -8,6 +8,8 @@
 #ifndef BASE_FUNCTIONAL_CALLBACK_INTERNAL_H_
 #define BASE_FUNCTIONAL_CALLBACK_INTERNAL_H_
 
+#include <stddef.h>
+
 #include <type_traits>
 #include <utility>
 
@@ -66,6 +68,10 @@ class BASE_EXPORT BindStateBase
   BindStateBase(const BindStateBase&) = delete;
   BindStateBase& operator=(const BindStateBase&) = delete;
 
+  // Initializes the state of the kRecycleBindStateMemory feature. Only the bind
+  // states created afterwards are affected.
+  static void InitializeFeatures();
+
  private:
   using DestructorPtr = void (*)(const BindStateBase*);
   using QueryCancellationTraitsPtr = bool (*)(const BindStateBase*,
@@ -100,6 +106,16 @@ class BASE_EXPORT BindStateBase
     return query_cancellation_traits_(this, CancellationQueryMode::kMaybeValid);
   }
 
+  // Allocates the memory of a `BindState<>`. Most bind states are small, and
+  // are created and destroyed around every posted task, often on different
+  // threads, so with the kRecycleBindStateMemory feature, their memory is
+  // recycled by size class with `ObjectPool`-style per-thread caches. Sets
+  // `recycled` to whether it is, in which case it must be given back with
+  // FreeRecycledStorage(). Otherwise, it comes from the global operator new,
+  // and is freed by the delete expression of the bind state.
+  static void* AllocateStorage(size_t size, size_t alignment, bool* recycled);
+  static void FreeRecycledStorage(void* storage, size_t size, size_t alignment);
+
   // In C++, it is safe to cast function pointers to function pointers of
   // another type. It is not okay to use void*. We create a InvokeFuncStorage
   // that that can store our function pointer, and then cast it back to
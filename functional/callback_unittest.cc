@@ -6,15 +6,20 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/functional/bind.h"
 #include "base/functional/callback_internal.h"
+#include "base/features.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/object_pool.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/notreached.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/test/bind.h"
 #include "base/test/gtest_util.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/test_timeouts.h"
 #include "base/threading/thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -764,6 +769,81 @@ TEST_F(CallbackTest, CallbackHasLastRefOnContainingObject) {
   ASSERT_TRUE(deleted);
 }
 
+#if !defined(ADDRESS_SANITIZER) && !defined(MEMORY_SANITIZER)
+size_t GetRecycledBindStateSlots() {
+  size_t slots = 0;
+  for (const auto& stats : internal::ObjectPoolBase::GetStatsForAllPools()) {
+    if (stats.name.starts_with("bind_state_")) {
+      slots += stats.allocated_slots;
+    }
+  }
+  return slots;
+}
+
+// Enables kRecycleBindStateMemory for the bind states created during its
+// lifetime.
+class ScopedRecycleBindStateMemory {
+ public:
+  ScopedRecycleBindStateMemory() {
+    internal::BindStateBase::InitializeFeatures();
+  }
+  ~ScopedRecycleBindStateMemory() {
+    feature_list_.Reset();
+    internal::BindStateBase::InitializeFeatures();
+  }
+
+ private:
+  test::ScopedFeatureList feature_list_{features::kRecycleBindStateMemory};
+};
+
+TEST_F(CallbackTest, SmallBindStatesAreNotRecycledByDefault) {
+  const size_t slots = GetRecycledBindStateSlots();
+  OnceCallback<int()> callback = BindOnce([](int i) { return i; }, 0);
+  EXPECT_EQ(0, std::move(callback).Run());
+  EXPECT_EQ(slots, GetRecycledBindStateSlots());
+}
+
+TEST_F(CallbackTest, SmallBindStatesAreRecycled) {
+  ScopedRecycleBindStateMemory recycle_bind_state_memory;
+  OnceCallback<int()> callback = BindOnce([](int i) { return i; }, 0);
+  callback.Reset();
+  const size_t slots = GetRecycledBindStateSlots();
+  EXPECT_GT(slots, 0u);
+
+  // The memory of the first bind state is reused by all the others.
+  for (int i = 0; i < 100; ++i) {
+    callback = BindOnce([](int i) { return i; }, i);
+    EXPECT_EQ(i, std::move(callback).Run());
+  }
+  EXPECT_EQ(slots, GetRecycledBindStateSlots());
+
+  // Large bind states aren't recycled, but work the same.
+  struct alignas(64) OverAligned {
+    char data[256];
+  };
+  callback = BindOnce([](const OverAligned& value) { return 1; },
+                      OverAligned());
+  EXPECT_EQ(1, std::move(callback).Run());
+  EXPECT_EQ(slots, GetRecycledBindStateSlots());
+}
+
+TEST_F(CallbackTest, RecycledBindStatesAreTrimmedOnMemoryPressure) {
+  ScopedRecycleBindStateMemory recycle_bind_state_memory;
+  std::vector<OnceClosure> callbacks;
+  for (int i = 0; i < 100; ++i) {
+    callbacks.push_back(BindOnce([](int i) {}, i));
+  }
+  callbacks.clear();
+  const size_t slots = GetRecycledBindStateSlots();
+  EXPECT_GE(slots, 100u);
+
+  // Frees the slots cached by this thread.
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  EXPECT_LE(GetRecycledBindStateSlots(), slots - 100);
+}
+#endif  // !defined(ADDRESS_SANITIZER) && !defined(MEMORY_SANITIZER)
+
 // According to legends, it is good practice to put death tests into their own
 // test suite, so they are grouped separately from regular tests, since death
 // tests are somewhat slow and have quirks that can slow down test running if
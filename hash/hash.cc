@@ -129,6 +129,30 @@ size_t FastHash(base::span<const uint8_t> data) {
   return Scramble(FastHashImpl(data));
 }
 
+FastHasher::FastHasher() = default;
+FastHasher::~FastHasher() = default;
+
+void FastHasher::Update(span<const uint8_t> data) {
+  if (heap_buffer_.empty()) {
+    if (data.size() <= kInlineCapacity - inline_size_) {
+      span(inline_buffer_).subspan(inline_size_, data.size()).copy_from(data);
+      inline_size_ += data.size();
+      return;
+    }
+    heap_buffer_.reserve(inline_size_ + data.size());
+    heap_buffer_.assign(inline_buffer_.begin(),
+                        inline_buffer_.begin() + inline_size_);
+  }
+  heap_buffer_.insert(heap_buffer_.end(), data.begin(), data.end());
+}
+
+size_t FastHasher::Finish() const {
+  if (heap_buffer_.empty()) {
+    return FastHash(span(inline_buffer_).first(inline_size_));
+  }
+  return FastHash(heap_buffer_);
+}
+
 uint32_t Hash(base::span<const uint8_t> data) {
   // Currently our in-memory hash is the same as the persistent hash. The
   // split between in-memory and persistent hash functions is maintained to
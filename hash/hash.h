@@ -8,10 +8,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <array>
 #include <limits>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/containers/span.h"
@@ -38,6 +40,41 @@ inline size_t FastHash(std::string_view str) {
   return FastHash(as_bytes(make_span(str)));
 }
 
+// Computes FastHash() of the concatenation of everything passed to Update(),
+// for keys made of several parts, without building the concatenation first.
+// Example:
+//
+//   base::FastHasher hasher;
+//   hasher.Update(scheme);
+//   hasher.Update(host);
+//   size_t hash = hasher.Finish();
+//
+// FastHash() reads the end of its input first, so the parts are gathered in a
+// buffer; it is inline up to kInlineCapacity bytes, so that typical keys are
+// hashed without allocating.
+class BASE_EXPORT FastHasher {
+ public:
+  static constexpr size_t kInlineCapacity = 64;
+
+  FastHasher();
+  FastHasher(const FastHasher&) = delete;
+  FastHasher& operator=(const FastHasher&) = delete;
+  ~FastHasher();
+
+  void Update(span<const uint8_t> data);
+  void Update(std::string_view str) { Update(as_byte_span(str)); }
+
+  // Returns FastHash() of the data passed to Update() so far. More data can
+  // still be added afterwards.
+  size_t Finish() const;
+
+ private:
+  // The data, in `inline_buffer_` while it fits, else in `heap_buffer_`.
+  std::array<uint8_t, kInlineCapacity> inline_buffer_;
+  size_t inline_size_ = 0;
+  std::vector<uint8_t> heap_buffer_;
+};
+
 // Computes a hash of a memory buffer. This hash function must not change so
 // that code can use the hashed values for persistent storage purposes or
 // sending across the network. If a new persistent hash function is desired, a
@@ -76,6 +113,17 @@ struct IntPairHash<std::pair<Type1, Type2>> {
   }
 };
 
+// A transparent hasher for string keys, which allows looking up e.g.
+// std::string keys by std::string_view without a copy. Example:
+//
+//   base::flat_hash_set<std::string, base::FastStringHash> set;
+//   set.contains(std::string_view("key"));
+struct FastStringHash {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view str) const { return FastHash(str); }
+};
+
 }  // namespace base
 
 #endif  // BASE_HASH_HASH_H_
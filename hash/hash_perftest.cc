@@ -8,12 +8,15 @@
 #include <stdint.h>
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/containers/span.h"
+#include "base/debug/alias.h"
 #include "base/hash/sha1.h"
 #include "base/rand_util.h"
 #include "base/ranges/algorithm.h"
+#include "base/strings/strcat.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/time/time.h"
@@ -83,6 +86,36 @@ void RunTest(const char* hash_name,
   reporter.AddResultList(kMetricThroughput, JoinString(rate_strings, ","));
 }
 
+// Reports the time `hash` takes per key for keys of three parts, as the parts
+// of URLs.
+void RunCompositeKeyTest(
+    const char* story,
+    size_t (*hash)(std::string_view, std::string_view, std::string_view)) {
+  constexpr char kMetricTimePerKey[] = "time_per_key";
+  perf_test::PerfResultReporter reporter("FastHash.", story);
+  reporter.RegisterImportantMetric(kMetricTimePerKey, "ns");
+
+  constexpr size_t kNumKeys = 1000;
+  std::vector<std::string> parts;
+  for (size_t i = 0; i < 3 * kNumKeys; ++i) {
+    parts.push_back(RandBytesAsString(RandInt(4, 24)));
+  }
+
+  constexpr int kNumRuns = 1000;
+  size_t result = 0;
+  const auto start = TimeTicks::Now();
+  for (int run = 0; run < kNumRuns; ++run) {
+    for (size_t i = 0; i < parts.size(); i += 3) {
+      result += hash(parts[i], parts[i + 1], parts[i + 2]);
+    }
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+  debug::Alias(&result);
+
+  reporter.AddResult(kMetricTimePerKey, elapsed.InMicrosecondsF() * 1000 /
+                                            (kNumRuns * kNumKeys));
+}
+
 }  // namespace
 
 TEST(SHA1PerfTest, Speed) {
@@ -97,4 +130,21 @@ TEST(HashPerfTest, Speed) {
   }
 }
 
+TEST(HashPerfTest, CompositeKeys) {
+  RunCompositeKeyTest(
+      "concatenated",
+      [](std::string_view a, std::string_view b, std::string_view c) {
+        return base::FastHash(StrCat({a, b, c}));
+      });
+  RunCompositeKeyTest(
+      "FastHasher",
+      [](std::string_view a, std::string_view b, std::string_view c) {
+        FastHasher hasher;
+        hasher.Update(a);
+        hasher.Update(b);
+        hasher.Update(c);
+        return hasher.Finish();
+      });
+}
+
 }  // namespace base
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/containers/span.h"
@@ -91,4 +92,23 @@ TEST(HashTest, FastHash) {
   EXPECT_EQ(FastHash(s), FastHash(kEmptyString));
 }
 
+TEST(HashTest, FastHasher) {
+  // Lengths around the inline capacity and the size classes of FastHash().
+  std::string data;
+  for (int i = 0; i < 300; ++i) {
+    data.push_back(static_cast<char>(i * 7));
+  }
+  for (size_t len : {0, 1, 7, 16, 17, 33, 63, 64, 65, 100, 129, 300}) {
+    const std::string_view str = std::string_view(data).substr(0, len);
+    for (size_t part_size : {1, 3, 64, 300}) {
+      FastHasher hasher;
+      for (size_t i = 0; i < len; i += part_size) {
+        EXPECT_EQ(FastHash(str.substr(0, i)), hasher.Finish());
+        hasher.Update(str.substr(i, part_size));
+      }
+      EXPECT_EQ(FastHash(str), hasher.Finish()) << len << " " << part_size;
+    }
+  }
+}
+
 }  // namespace base
@@ -0,0 +1,28 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/hash/md5.h"
+
+#include <optional>
+
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+
+namespace base {
+
+std::optional<MD5Digest> MD5HashFile(File& file) {
+  MD5Context context;
+  MD5Init(&context);
+  if (!ReadFileInChunks(file, [&context](span<const uint8_t> chunk) {
+        MD5Update(&context, chunk);
+      })) {
+    return std::nullopt;
+  }
+  MD5Digest digest;
+  MD5Final(&digest, &context);
+  return digest;
+}
+
+}  // namespace base
@@ -5,6 +5,7 @@
 #ifndef BASE_HASH_MD5_H_
 #define BASE_HASH_MD5_H_
 
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -43,6 +44,8 @@
 
 namespace base {
 
+class File;
+
 // Initializes the given MD5 context structure for subsequent calls to
 // MD5Update().
 BASE_EXPORT void MD5Init(MD5Context* context);
@@ -67,6 +70,11 @@ BASE_EXPORT void MD5Sum(base::span<const uint8_t> data, MD5Digest* digest);
 // Returns the MD5 (in hexadecimal) of a string.
 BASE_EXPORT std::string MD5String(std::string_view str);
 
+// Computes the MD5 sum of `file` from its current position to its end, reading
+// it in chunks rather than into memory all at once. Returns std::nullopt if
+// reading fails.
+BASE_EXPORT std::optional<MD5Digest> MD5HashFile(File& file);
+
 }  // namespace base
 
 #endif  // BASE_HASH_MD5_H_
@@ -12,11 +12,15 @@
 #include <string.h>
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 
 #include "base/containers/heap_array.h"
 #include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/hash/md5_boringssl.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -201,4 +205,24 @@ TEST(MD5, ContextWithStringData) {
   EXPECT_EQ(expected, actual);
 }
 
+TEST(MD5, MD5HashFile) {
+  // Larger than the chunks the file is read in.
+  std::string data(1'000'000, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i * 31);
+  }
+  MD5Digest expected;
+  MD5Sum(as_byte_span(data), &expected);
+
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath path = temp_dir.GetPath().AppendASCII("file");
+  ASSERT_TRUE(WriteFile(path, data));
+
+  File file(path, File::FLAG_OPEN | File::FLAG_READ);
+  std::optional<MD5Digest> digest = MD5HashFile(file);
+  ASSERT_TRUE(digest);
+  EXPECT_EQ(MD5DigestToBase16(expected), MD5DigestToBase16(*digest));
+}
+
 }  // namespace base
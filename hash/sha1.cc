@@ -0,0 +1,28 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/hash/sha1.h"
+
+#include <optional>
+
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+
+namespace base {
+
+std::optional<SHA1Digest> SHA1HashFile(File& file) {
+  SHA1Context context;
+  SHA1Init(context);
+  if (!ReadFileInChunks(file, [&context](span<const uint8_t> chunk) {
+        SHA1Update(as_string_view(chunk), context);
+      })) {
+    return std::nullopt;
+  }
+  SHA1Digest digest;
+  SHA1Final(context, digest);
+  return digest;
+}
+
+}  // namespace base
@@ -8,6 +8,7 @@
 #include <stddef.h>
 
 #include <array>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -22,6 +23,8 @@
 
 namespace base {
 
+class File;
+
 enum { kSHA1Length = 20 };  // Length in bytes of a SHA-1 hash.
 
 // The output of an SHA-1 operation.
@@ -43,6 +46,12 @@ BASE_EXPORT void SHA1HashBytes(const unsigned char* data,
 BASE_EXPORT void SHA1Init(SHA1Context& context);
 BASE_EXPORT void SHA1Update(const std::string_view data, SHA1Context& context);
 BASE_EXPORT void SHA1Final(SHA1Context& context, SHA1Digest& digest);
+
+// Computes the SHA-1 hash of |file| from its current position to its end,
+// reading it in chunks rather than into memory all at once. Returns
+// std::nullopt if reading fails. A MemoryMappedFile can be hashed in place with
+// SHA1HashSpan() instead.
+BASE_EXPORT std::optional<SHA1Digest> SHA1HashFile(File& file);
 }  // namespace base
 
 #endif  // BASE_HASH_SHA1_H_
@@ -11,10 +11,15 @@
 
 #include <stddef.h>
 
+#include <optional>
 #include <string>
 
 #include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/hash/sha1_boringssl.h"
+#include "base/ranges/algorithm.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 TEST(SHA1Test, Test1) {
@@ -159,3 +164,27 @@ TEST(SHA1Test, StreamingSHA1WithChunkedInput) {
     EXPECT_EQ(kExpected[i], digest_array[i]);
   }
 }
+
+TEST(SHA1Test, SHA1HashFile) {
+  // Example A.3 from FIPS 180-2, read in several chunks.
+  const std::string input(1000000, 'a');
+  static constexpr unsigned char kExpected[] = {
+      0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e,
+      0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f};
+
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().AppendASCII("file");
+  ASSERT_TRUE(base::WriteFile(path, "xyz" + input));
+
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  ASSERT_TRUE(file.IsValid());
+  // Only the data after the current position is hashed.
+  ASSERT_EQ(3, file.Seek(base::File::FROM_BEGIN, 3));
+  std::optional<base::SHA1Digest> digest = base::SHA1HashFile(file);
+  ASSERT_TRUE(digest);
+  EXPECT_TRUE(base::ranges::equal(kExpected, *digest));
+
+  // Nothing is left to read.
+  EXPECT_EQ(base::SHA1HashSpan({}), base::SHA1HashFile(file));
+}
@@ -5,16 +5,24 @@
 #include "base/i18n/break_iterator.h"
 
 #include <stdint.h>
+
+#include <array>
+#include <memory>
 #include <ostream>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "base/check.h"
-#include "base/lazy_instance.h"
 #include "base/memory/raw_ptr.h"
+#include "base/no_destructor.h"
 #include "base/notreached.h"
-#include "base/synchronization/lock.h"
+#include "base/ranges/algorithm.h"
+#include "base/threading/thread_local.h"
 #include "third_party/icu/source/common/unicode/ubrk.h"
 #include "third_party/icu/source/common/unicode/uchar.h"
+#include "third_party/icu/source/common/unicode/uloc.h"
 #include "third_party/icu/source/common/unicode/ustring.h"
 
 namespace base {
@@ -22,42 +30,43 @@ namespace i18n {
 
 namespace {
 
-// We found the usage pattern of break iterator is to create, use and destroy.
-// The following cache support multiple break iterator in the same thread and
-// also optimize to not create break iterator many time. For each kind of break
-// iterator (character, word, line and sentence, but NOT rule), we keep one of
-// them in the main_ and lease it out. If some other code request a lease
-// before |main_| is returned, we create a new instance of the iterator.
-// This will keep at most 4 break iterators (one for each kind) unreleased until
-// the program destruction time.
-template <UBreakIteratorType break_type>
-class DefaultLocaleBreakIteratorCache {
+// Break iterators are typically created, used on a short string and
+// destroyed, while opening an ICU break iterator loads and compiles its rules.
+// So each thread keeps the ICU iterators which aren't in use: one of each kind
+// for the default locale (character, word, line and sentence) and the most
+// recently used rule-based ones. A BreakIterator leases one in Init(), and
+// ubrk_setText() resets it for the new string. If the kind is already leased
+// out, e.g. by a nested BreakIterator, a new one is opened. Being per thread,
+// the cache needs no lock.
+class ThreadBreakIteratorCache {
  public:
-  DefaultLocaleBreakIteratorCache() {
-    main_ = UBreakIteratorPtr(
-        ubrk_open(break_type, nullptr, nullptr, 0, &main_status_));
-    if (U_FAILURE(main_status_)) {
-      NOTREACHED_IN_MIGRATION() << "ubrk_open failed for type " << break_type
-                                << " with error " << main_status_;
+  ThreadBreakIteratorCache() = default;
+  ThreadBreakIteratorCache(const ThreadBreakIteratorCache&) = delete;
+  ThreadBreakIteratorCache& operator=(const ThreadBreakIteratorCache&) = delete;
+  ~ThreadBreakIteratorCache() = default;
+
+  static ThreadBreakIteratorCache& Get() {
+    static NoDestructor<ThreadLocalOwnedPointer<ThreadBreakIteratorCache>>
+        caches;
+    if (!caches->Get()) {
+      caches->Set(std::make_unique<ThreadBreakIteratorCache>());
     }
+    return *caches->Get();
   }
-  UBreakIteratorPtr Lease(UErrorCode& status) {
-    if (U_FAILURE(status)) {
-      return nullptr;
-    }
-    if (U_FAILURE(main_status_)) {
-      status = main_status_;
-      return nullptr;
-    }
-    {
-      AutoLock scoped_lock(lock_);
-      if (main_) {
-        return std::move(main_);
+
+  UBreakIteratorPtr Lease(UBreakIteratorType break_type, UErrorCode& status) {
+    // The iterators were opened for the default locale, which may have
+    // changed since.
+    const char* locale = uloc_getDefault();
+    if (locale_ != locale) {
+      locale_ = locale;
+      for (UBreakIteratorPtr& iter : iterators_) {
+        iter.reset();
       }
     }
-
-    // The main_ is already leased out to some other places, return a new
-    // object instead.
+    if (UBreakIteratorPtr& iter = iterators_[break_type]) {
+      return std::move(iter);
+    }
     UBreakIteratorPtr result(
         ubrk_open(break_type, nullptr, nullptr, 0, &status));
     if (U_FAILURE(status)) {
@@ -67,27 +76,72 @@ class DefaultLocaleBreakIteratorCache {
     return result;
   }
 
-  void Return(UBreakIteratorPtr item) {
-    AutoLock scoped_lock(lock_);
-    if (!main_) {
-      main_ = std::move(item);
+  void Return(UBreakIteratorType break_type, UBreakIteratorPtr iter) {
+    if (!iter || iterators_[break_type]) {
+      return;
+    }
+    ResetText(iter.get());
+    iterators_[break_type] = std::move(iter);
+  }
+
+  UBreakIteratorPtr LeaseRuleBased(const std::u16string& rules,
+                                   UErrorCode& status) {
+    auto it = ranges::find(rule_based_iterators_, rules,
+                           &RuleBasedIterator::first);
+    if (it != rule_based_iterators_.end()) {
+      UBreakIteratorPtr result = std::move(it->second);
+      rule_based_iterators_.erase(it);
+      return result;
     }
+    UParseError parse_error;
+    UBreakIteratorPtr result(
+        ubrk_openRules(rules.c_str(), static_cast<int32_t>(rules.length()),
+                       nullptr, 0, &parse_error, &status));
+    if (U_FAILURE(status)) {
+      NOTREACHED_IN_MIGRATION()
+          << "ubrk_openRules failed to parse rule string at line "
+          << parse_error.line << ", offset " << parse_error.offset;
+    }
+    return result;
+  }
+
+  void ReturnRuleBased(const std::u16string& rules, UBreakIteratorPtr iter) {
+    if (!iter) {
+      return;
+    }
+    if (ranges::find(rule_based_iterators_, rules, &RuleBasedIterator::first) !=
+        rule_based_iterators_.end()) {
+      return;
+    }
+    if (rule_based_iterators_.size() == kMaxRuleBasedIterators) {
+      // Evict the least recently returned iterator.
+      rule_based_iterators_.erase(rule_based_iterators_.begin());
+    }
+    ResetText(iter.get());
+    rule_based_iterators_.emplace_back(rules, std::move(iter));
   }
 
  private:
-  UErrorCode main_status_ = U_ZERO_ERROR;
-  UBreakIteratorPtr main_ GUARDED_BY(lock_);
-  Lock lock_;
-};
+  using RuleBasedIterator = std::pair<std::u16string, UBreakIteratorPtr>;
 
-static LazyInstance<DefaultLocaleBreakIteratorCache<UBRK_CHARACTER>>::Leaky
-    char_break_cache = LAZY_INSTANCE_INITIALIZER;
-static LazyInstance<DefaultLocaleBreakIteratorCache<UBRK_WORD>>::Leaky
-    word_break_cache = LAZY_INSTANCE_INITIALIZER;
-static LazyInstance<DefaultLocaleBreakIteratorCache<UBRK_SENTENCE>>::Leaky
-    sentence_break_cache = LAZY_INSTANCE_INITIALIZER;
-static LazyInstance<DefaultLocaleBreakIteratorCache<UBRK_LINE>>::Leaky
-    line_break_cache = LAZY_INSTANCE_INITIALIZER;
+  static constexpr size_t kMaxRuleBasedIterators = 4;
+
+  // Detaches `iter` from the text of the BreakIterator which returns it, which
+  // may be freed before the iterator is leased again.
+  static void ResetText(UBreakIterator* iter) {
+    UErrorCode status = U_ZERO_ERROR;
+    ubrk_setText(iter, u"", 0, &status);
+  }
+
+  // The default locale when `iterators_` were opened.
+  std::string locale_;
+
+  // Indexed by UBreakIteratorType.
+  std::array<UBreakIteratorPtr, UBRK_SENTENCE + 1> iterators_;
+
+  // Ordered from the least to the most recently returned.
+  std::vector<RuleBasedIterator> rule_based_iterators_;
+};
 
 }  // namespace
 
@@ -105,51 +159,46 @@ BreakIterator::BreakIterator(std::u16string_view str,
     : string_(str), rules_(rules), break_type_(RULE_BASED) {}
 
 BreakIterator::~BreakIterator() {
+  ThreadBreakIteratorCache& cache = ThreadBreakIteratorCache::Get();
   switch (break_type_) {
     case RULE_BASED:
+      cache.ReturnRuleBased(rules_, std::move(iter_));
       return;
     case BREAK_CHARACTER:
-      char_break_cache.Pointer()->Return(std::move(iter_));
+      cache.Return(UBRK_CHARACTER, std::move(iter_));
       return;
     case BREAK_WORD:
-      word_break_cache.Pointer()->Return(std::move(iter_));
+      cache.Return(UBRK_WORD, std::move(iter_));
       return;
     case BREAK_SENTENCE:
-      sentence_break_cache.Pointer()->Return(std::move(iter_));
+      cache.Return(UBRK_SENTENCE, std::move(iter_));
       return;
     case BREAK_LINE:
     case BREAK_NEWLINE:
-      line_break_cache.Pointer()->Return(std::move(iter_));
+      cache.Return(UBRK_LINE, std::move(iter_));
       return;
   }
 }
 
 bool BreakIterator::Init() {
   UErrorCode status = U_ZERO_ERROR;
-  UParseError parse_error;
+  ThreadBreakIteratorCache& cache = ThreadBreakIteratorCache::Get();
   switch (break_type_) {
     case BREAK_CHARACTER:
-      iter_ = char_break_cache.Pointer()->Lease(status);
+      iter_ = cache.Lease(UBRK_CHARACTER, status);
       break;
     case BREAK_WORD:
-      iter_ = word_break_cache.Pointer()->Lease(status);
+      iter_ = cache.Lease(UBRK_WORD, status);
       break;
     case BREAK_SENTENCE:
-      iter_ = sentence_break_cache.Pointer()->Lease(status);
+      iter_ = cache.Lease(UBRK_SENTENCE, status);
       break;
     case BREAK_LINE:
     case BREAK_NEWLINE:
-      iter_ = line_break_cache.Pointer()->Lease(status);
+      iter_ = cache.Lease(UBRK_LINE, status);
       break;
     case RULE_BASED:
-      iter_ = UBreakIteratorPtr(
-          ubrk_openRules(rules_.c_str(), static_cast<int32_t>(rules_.length()),
-                         nullptr, 0, &parse_error, &status));
-      if (U_FAILURE(status)) {
-        NOTREACHED_IN_MIGRATION()
-            << "ubrk_openRules failed to parse rule string at line "
-            << parse_error.line << ", offset " << parse_error.offset;
-      }
+      iter_ = cache.LeaseRuleBased(rules_, status);
       break;
   }
 
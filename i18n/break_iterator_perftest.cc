@@ -0,0 +1,117 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/i18n/break_iterator.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "base/check.h"
+#include "base/i18n/string_compare.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base::i18n {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "BreakIterator.";
+constexpr char kMetricTimePerString[] = "time_per_string";
+
+constexpr size_t kNumStrings = 10000;
+
+// Returns short strings like the titles and names which are segmented one at
+// a time, when the cost of setting up an iterator dominates.
+std::vector<std::u16string> MakeShortStrings() {
+  std::vector<std::u16string> strings;
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    strings.push_back(u"Document " + NumberToString16(i) + u", final draft");
+  }
+  return strings;
+}
+
+void ReportTimePerString(const std::string& prefix,
+                         const std::string& story,
+                         TimeDelta elapsed) {
+  perf_test::PerfResultReporter reporter(prefix, story);
+  reporter.RegisterImportantMetric(kMetricTimePerString, "ns");
+  reporter.AddResult(kMetricTimePerString,
+                     elapsed.InMicrosecondsF() * 1000 / kNumStrings);
+}
+
+size_t CountWords(const std::u16string& str, BreakIterator::BreakType type) {
+  BreakIterator iter(str, type);
+  CHECK(iter.Init());
+  size_t num_words = 0;
+  while (iter.Advance()) {
+    if (iter.IsWord()) {
+      ++num_words;
+    }
+  }
+  return num_words;
+}
+
+}  // namespace
+
+// Measures segmenting short strings with a new BreakIterator each, which
+// leases a cached ICU iterator.
+TEST(BreakIteratorPerfTest, NewIteratorPerString) {
+  const std::vector<std::u16string> strings = MakeShortStrings();
+  const std::u16string rules(u"$Letters = [a-zA-Z];\n$Letters+ {200};\n");
+  struct {
+    const char* story;
+    BreakIterator::BreakType type;
+  } const kCases[] = {
+      {"word", BreakIterator::BREAK_WORD},
+      {"line", BreakIterator::BREAK_LINE},
+      {"character", BreakIterator::BREAK_CHARACTER},
+  };
+
+  for (const auto& test_case : kCases) {
+    size_t num_words = 0;
+    const TimeTicks start = TimeTicks::Now();
+    for (const std::u16string& str : strings) {
+      num_words += CountWords(str, test_case.type);
+    }
+    ReportTimePerString(kMetricPrefix, test_case.story,
+                        TimeTicks::Now() - start);
+    CHECK_GT(num_words, 0u);
+  }
+
+  size_t num_words = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (const std::u16string& str : strings) {
+    BreakIterator iter(str, rules);
+    CHECK(iter.Init());
+    while (iter.Advance()) {
+      num_words += iter.IsWord();
+    }
+  }
+  ReportTimePerString(kMetricPrefix, "rule_based", TimeTicks::Now() - start);
+  CHECK_GT(num_words, 0u);
+}
+
+// Measures comparing short strings with the collator of the thread, looked up
+// for each comparison.
+TEST(BreakIteratorPerfTest, CompareWithThreadCollator) {
+  const std::vector<std::u16string> strings = MakeShortStrings();
+  size_t num_less = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (size_t i = 1; i < strings.size(); ++i) {
+    const icu::Collator* collator =
+        GetCollatorForCurrentThread(icu::Collator::TERTIARY);
+    CHECK(collator);
+    num_less += CompareString16WithCollator(*collator, strings[i - 1],
+                                            strings[i]) == UCOL_LESS;
+  }
+  ReportTimePerString("Collator.", "thread_collator", TimeTicks::Now() - start);
+  CHECK_GT(num_less, 0u);
+}
+
+}  // namespace base::i18n
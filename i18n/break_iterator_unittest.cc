@@ -546,6 +546,44 @@ TEST(BreakIteratorTest, GetStringView) {
   EXPECT_EQ(std::u16string_view(u"string"), iter.GetStringView());
 }
 
+// The ICU iterators are reused after their BreakIterator is destroyed, and a
+// new one is opened while they are in use.
+TEST(BreakIteratorTest, ReuseIterators) {
+  for (int i = 0; i < 3; ++i) {
+    const std::u16string outer_string(u"outer text");
+    BreakIterator outer(outer_string, BreakIterator::BREAK_WORD);
+    ASSERT_TRUE(outer.Init());
+    ASSERT_TRUE(outer.Advance());
+    EXPECT_EQ(u"outer", outer.GetString());
+    {
+      const std::u16string inner_string(u"inner");
+      BreakIterator inner(inner_string, BreakIterator::BREAK_WORD);
+      ASSERT_TRUE(inner.Init());
+      ASSERT_TRUE(inner.Advance());
+      EXPECT_EQ(u"inner", inner.GetString());
+    }
+    ASSERT_TRUE(outer.Advance());
+    ASSERT_TRUE(outer.Advance());
+    EXPECT_EQ(u"text", outer.GetString());
+  }
+}
+
+TEST(BreakIteratorTest, ReuseRuleBasedIterators) {
+  const std::u16string rules(u"$Letters = [a-z];\n$Letters+ {200};\n");
+  for (int i = 0; i < 3; ++i) {
+    const std::u16string str(u"ab1cd");
+    BreakIterator iter(str, rules);
+    ASSERT_TRUE(iter.Init());
+    std::vector<std::u16string> words;
+    while (iter.Advance()) {
+      if (iter.IsWord()) {
+        words.push_back(iter.GetString());
+      }
+    }
+    EXPECT_EQ(std::vector<std::u16string>({u"ab", u"cd"}), words);
+  }
+}
+
 // Make sure that when not in RULE_BASED or BREAK_WORD mode we're getting
 // IS_LINE_OR_CHAR_BREAK.
 TEST(BreakIteratorTest, GetWordBreakStatusBreakLine) {
@@ -5,12 +5,14 @@
 #include "base/i18n/case_conversion.h"
 
 #include <stdint.h>
+#include <string.h>
 
 #include <string>
 #include <string_view>
 
 #include "base/numerics/safe_conversions.h"
 #include "base/strings/string_util.h"
+#include "third_party/icu/source/common/unicode/locid.h"
 #include "third_party/icu/source/common/unicode/uchar.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/icu/source/common/unicode/ustring.h"
@@ -49,16 +51,17 @@ int32_t FoldCaseMapper(UChar* dest, int32_t dest_capacity,
 
 // Provides similar functionality as UnicodeString::caseMap but on
 // std::u16string.
-std::u16string CaseMap(std::u16string_view string,
-                       CaseMapperFunction case_mapper) {
-  std::u16string dest;
+void CaseMap(std::u16string_view string,
+             CaseMapperFunction case_mapper,
+             std::u16string* dest) {
+  dest->clear();
   if (string.empty())
-    return dest;
+    return;
 
   // Provide an initial guess that the string length won't change. The typical
   // strings we use will very rarely change length in this process, so don't
   // optimize for that case.
-  dest.resize(string.size());
+  dest->resize(string.size());
 
   UErrorCode error;
   do {
@@ -68,25 +71,73 @@ std::u16string CaseMap(std::u16string_view string,
     // terminator, but will otherwise. So we don't need to save room for that.
     // Don't use WriteInto, which assumes null terminators.
     int32_t new_length = case_mapper(
-        &dest[0], saturated_cast<int32_t>(dest.size()), string.data(),
+        &(*dest)[0], saturated_cast<int32_t>(dest->size()), string.data(),
         saturated_cast<int32_t>(string.size()), &error);
-    dest.resize(new_length);
+    dest->resize(new_length);
   } while (error == U_BUFFER_OVERFLOW_ERROR);
-  return dest;
+}
+
+// Returns true if the case mapping of ASCII characters in the default locale
+// is the ASCII one. Turkish and Azeri map I to dotless i, and i to dotted I.
+bool HasASCIICaseMapping() {
+  const char* language = icu::Locale::getDefault().getLanguage();
+  return strcmp(language, "tr") != 0 && strcmp(language, "az") != 0;
+}
+
+// Maps ASCII |string| with |mapper|, which maps a character, without going
+// through ICU. Most of the strings we convert are ASCII, and ICU's case
+// mapping is much slower than a table-free branch per character.
+template <char16_t (*mapper)(char16_t)>
+void ASCIICaseMap(std::u16string_view string, std::u16string* dest) {
+  dest->resize(string.size());
+  for (size_t i = 0; i < string.size(); ++i) {
+    (*dest)[i] = mapper(string[i]);
+  }
 }
 
 }  // namespace
 
 std::u16string ToLower(std::u16string_view string) {
-  return CaseMap(string, &ToLowerMapper);
+  std::u16string dest;
+  ToLower(string, &dest);
+  return dest;
 }
 
 std::u16string ToUpper(std::u16string_view string) {
-  return CaseMap(string, &ToUpperMapper);
+  std::u16string dest;
+  ToUpper(string, &dest);
+  return dest;
 }
 
 std::u16string FoldCase(std::u16string_view string) {
-  return CaseMap(string, &FoldCaseMapper);
+  std::u16string dest;
+  FoldCase(string, &dest);
+  return dest;
+}
+
+void ToLower(std::u16string_view string, std::u16string* output) {
+  if (IsStringASCII(string) && HasASCIICaseMapping()) {
+    ASCIICaseMap<&ToLowerASCII<char16_t>>(string, output);
+    return;
+  }
+  CaseMap(string, &ToLowerMapper, output);
+}
+
+void ToUpper(std::u16string_view string, std::u16string* output) {
+  if (IsStringASCII(string) && HasASCIICaseMapping()) {
+    ASCIICaseMap<&ToUpperASCII<char16_t>>(string, output);
+    return;
+  }
+  CaseMap(string, &ToUpperMapper, output);
+}
+
+void FoldCase(std::u16string_view string, std::u16string* output) {
+  // Case folding doesn't depend on the locale, and folds ASCII to lower case.
+  if (IsStringASCII(string)) {
+    ASCIICaseMap<&ToLowerASCII<char16_t>>(string, output);
+    return;
+  }
+  CaseMap(string, &FoldCaseMapper, output);
 }
 
 }  // namespace i18n
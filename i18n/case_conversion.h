@@ -43,6 +43,23 @@ BASE_I18N_EXPORT std::u16string ToUpper(std::u16string_view string);
 // See http://unicode.org/faq/casemap_charprop.html#2
 BASE_I18N_EXPORT std::u16string FoldCase(std::u16string_view string);
 
+// Same as the above, but replace the contents of |output| with the result, so
+// that converting many strings in a row reuses one buffer:
+//
+//   std::u16string folded;
+//   for (const std::u16string& token : tokens) {
+//     FoldCase(token, &folded);
+//     ...
+//   }
+//
+// |string| must not point into |output|.
+BASE_I18N_EXPORT void ToLower(std::u16string_view string,
+                              std::u16string* output);
+BASE_I18N_EXPORT void ToUpper(std::u16string_view string,
+                              std::u16string* output);
+BASE_I18N_EXPORT void FoldCase(std::u16string_view string,
+                               std::u16string* output);
+
 }  // namespace i18n
 }  // namespace base
 
@@ -0,0 +1,61 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/i18n/case_conversion.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "base/check.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base::i18n {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "CaseConversion.";
+constexpr char kMetricTimePerString[] = "time_per_string";
+
+constexpr size_t kNumStrings = 10000;
+
+void ReportTimePerString(const std::string& story, TimeDelta elapsed) {
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricTimePerString, "ns");
+  reporter.AddResult(kMetricTimePerString,
+                     elapsed.InMicrosecondsF() * 1000 / kNumStrings);
+}
+
+// Folds the case of `strings` like a search index does, reusing one buffer.
+void FoldStrings(const char* story,
+                 const std::vector<std::u16string>& strings) {
+  std::u16string folded;
+  size_t total_length = 0;
+  const TimeTicks start = TimeTicks::Now();
+  for (const std::u16string& str : strings) {
+    FoldCase(str, &folded);
+    total_length += folded.size();
+  }
+  ReportTimePerString(story, TimeTicks::Now() - start);
+  CHECK_GT(total_length, 0u);
+}
+
+}  // namespace
+
+TEST(CaseConversionPerfTest, FoldCase) {
+  std::vector<std::u16string> ascii_strings;
+  std::vector<std::u16string> non_ascii_strings;
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    ascii_strings.push_back(u"Quarterly Report " + NumberToString16(i));
+    non_ascii_strings.push_back(u"RÉSUMÉ " + NumberToString16(i));
+  }
+  FoldStrings("ascii", ascii_strings);
+  FoldStrings("non_ascii", non_ascii_strings);
+}
+
+}  // namespace base::i18n
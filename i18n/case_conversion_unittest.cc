@@ -80,6 +80,48 @@ TEST(CaseConversionTest, TurkishLocaleConversion) {
   EXPECT_EQ(expected_upper_turkish, result);
 }
 
+// The ASCII strings are converted without ICU, except in the locales where
+// ASCII letters don't map to ASCII letters.
+TEST(CaseConversionTest, TurkishLocaleASCIIConversion) {
+  test::ScopedRestoreICUDefaultLocale restore_locale;
+  i18n::SetICUDefaultLocale("en_US");
+  EXPECT_EQ(u"title", ToLower(u"TITLE"));
+  EXPECT_EQ(u"TITLE", ToUpper(u"title"));
+
+  i18n::SetICUDefaultLocale("tr");
+  EXPECT_EQ(u"t1tle", ToLower(u"TITLE"));
+  EXPECT_EQ(u"T0TLE", ToUpper(u"title"));
+
+  i18n::SetICUDefaultLocale("az");
+  EXPECT_EQ(u"t1tle", ToLower(u"TITLE"));
+  EXPECT_EQ(u"T0TLE", ToUpper(u"title"));
+
+  // Case folding doesn't depend on the locale.
+  EXPECT_EQ(u"title", FoldCase(u"TITLE"));
+}
+
+TEST(CaseConversionTest, ConvertIntoOutput) {
+  std::u16string output;
+  ToLower(u"Hello, World", &output);
+  EXPECT_EQ(u"hello, world", output);
+
+  // The previous contents of the output are replaced.
+  ToUpper(u"abc", &output);
+  EXPECT_EQ(u"ABC", output);
+
+  FoldCase(kNonASCIIMixed, &output);
+  EXPECT_EQ(FoldCase(kNonASCIILower), output);
+
+  ToUpper(kNonASCIIMixed, &output);
+  EXPECT_EQ(kNonASCIIUpper, output);
+
+  FoldCase(u"\u00DF", &output);
+  EXPECT_EQ(u"ss", output);
+
+  ToLower(u"", &output);
+  EXPECT_TRUE(output.empty());
+}
+
 TEST(CaseConversionTest, FoldCase) {
   // Simple ASCII, should lower-case.
   EXPECT_EQ(u"hello, world", FoldCase(u"Hello, World"));
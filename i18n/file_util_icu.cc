@@ -288,14 +288,11 @@ void ReplaceIllegalCharactersInPath(FilePath::StringType* file_name,
 }
 
 bool LocaleAwareCompareFilenames(const FilePath& a, const FilePath& b) {
-  UErrorCode error_code = U_ZERO_ERROR;
   // Use the default collator. The default locale should have been properly
-  // set by the time this constructor is called.
-  std::unique_ptr<icu::Collator> collator(
-      icu::Collator::createInstance(error_code));
-  DCHECK(U_SUCCESS(error_code));
-  // Make it case-sensitive.
-  collator->setStrength(icu::Collator::TERTIARY);
+  // set by the time this constructor is called. Make it case-sensitive.
+  const icu::Collator* collator =
+      GetCollatorForCurrentThread(icu::Collator::TERTIARY);
+  DCHECK(collator);
 
 #if BUILDFLAG(IS_WIN)
   return CompareString16WithCollator(*collator, AsStringPiece16(a.value()),
@@ -156,6 +156,48 @@ const uint8_t* IcuMergeableDataFile::data() const {
   return static_cast<const uint8_t*>(lacros_data_);
 }
 
+bool IcuMergeableDataFile::Advise(MemoryMappedFile::AccessPattern pattern) {
+  if (!lacros_data_) {
+    return false;
+  }
+  int advice = MADV_NORMAL;
+  switch (pattern) {
+    case MemoryMappedFile::AccessPattern::kNormal:
+      break;
+    case MemoryMappedFile::AccessPattern::kSequential:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case MemoryMappedFile::AccessPattern::kRandom:
+      advice = MADV_RANDOM;
+      break;
+  }
+  // The advice applies to the merged pages too, since madvise() can span
+  // several mappings.
+  return madvise(lacros_data_, lacros_length_, advice) == 0;
+}
+
+bool IcuMergeableDataFile::Evict(const MemoryMappedFile::Region& region) {
+  if (!lacros_data_) {
+    return false;
+  }
+  size_t offset = 0;
+  size_t length = lacros_length_;
+  if (region != MemoryMappedFile::Region::kWholeFile) {
+    if (region.offset < 0 ||
+        static_cast<uint64_t>(region.offset) > lacros_length_ ||
+        region.size > lacros_length_ - static_cast<size_t>(region.offset)) {
+      return false;
+    }
+    // madvise() needs a page-aligned start.
+    offset = static_cast<size_t>(region.offset) &
+             ~static_cast<size_t>(kPageSize - 1);
+    length = region.size + (static_cast<size_t>(region.offset) - offset);
+  }
+  // All the pages are private, read-only mappings of either ICU data file,
+  // so discarding them only costs reading them again.
+  return madvise(lacros_data_ + offset, length, MADV_DONTNEED) == 0;
+}
+
 bool IcuMergeableDataFile::MergeWithAshVersion(const FilePath& ash_file_path) {
   // Verify the assumption that page size is 4K.
   CHECK_EQ(sysconf(_SC_PAGESIZE), kPageSize);
@@ -40,6 +40,8 @@ class BASE_I18N_EXPORT IcuMergeableDataFile {
   // The following APIs are designed to be consistent with MemoryMappedFile.
   bool Initialize(File lacros_file, MemoryMappedFile::Region region);
   const uint8_t* data() const;
+  bool Advise(MemoryMappedFile::AccessPattern pattern);
+  bool Evict(const MemoryMappedFile::Region& region);
 
   // Attempt merging with Ash's icudtl.dat.
   // Return `true` if successful or in case of non-critical failure.
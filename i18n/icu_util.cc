@@ -229,6 +229,10 @@ int LoadIcuData(PlatformFile data_fd,
     LOG(ERROR) << "Couldn't mmap icu data file";
     return 2;  // To debug http://crbug.com/445616.
   }
+  // ICU looks up its tables through the table of contents of the data file,
+  // and a process typically uses a few of them. Without read-ahead, only the
+  // pages of these tables become resident.
+  (*out_mapped_data_file)->Advise(MemoryMappedFile::AccessPattern::kRandom);
 
   (*out_error_code) = U_ZERO_ERROR;
   udata_setCommonData(const_cast<uint8_t*>((*out_mapped_data_file)->data()),
@@ -389,6 +393,12 @@ PlatformFile GetIcuDataFileHandle(MemoryMappedFile::Region* out_region) {
   return g_icudtl_pf;
 }
 
+void EvictIcuData() {
+  if (g_icudtl_mapped_file) {
+    g_icudtl_mapped_file->Evict(MemoryMappedFile::Region::kWholeFile);
+  }
+}
+
 void ResetGlobalsForTesting() {
   // Reset ICU library internal state before tearing-down the mapped data
   // file, or handle.
@@ -49,6 +49,11 @@ BASE_I18N_EXPORT bool InitializeICUWithFileDescriptor(
     PlatformFile data_fd,
     const MemoryMappedFile::Region& data_region);
 
+// Drops the pages of the ICU data file from the resident memory of the
+// process, e.g. when it goes idle. ICU keeps pointers into the mapping, and
+// the pages it accesses later are read in again from the file.
+BASE_I18N_EXPORT void EvictIcuData();
+
 // Calls `u_cleanup()` to reset the ICU library, and clears global state,
 // notably releasing the mapped ICU data file, and handle.
 BASE_I18N_EXPORT void ResetGlobalsForTesting();
@@ -7,6 +7,7 @@
 #include "base/test/icu_test_util.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/icu/source/i18n/unicode/ucol.h"
 
 #if !BUILDFLAG(IS_NACL) && (ICU_UTIL_DATA_IMPL == ICU_UTIL_DATA_FILE) && \
     (BUILDFLAG(IS_CHROMEOS_LACROS) || BUILDFLAG(IS_ANDROID))
@@ -31,6 +32,17 @@ TEST_F(IcuUtilTest, InitializeIcuSucceeds) {
   ASSERT_TRUE(success);
 }
 
+TEST_F(IcuUtilTest, EvictIcuData) {
+  ASSERT_TRUE(InitializeICU());
+  EvictIcuData();
+
+  // The evicted pages are read in again.
+  UErrorCode status = U_ZERO_ERROR;
+  UCollator* collator = ucol_open("en", &status);
+  EXPECT_TRUE(U_SUCCESS(status));
+  ucol_close(collator);
+}
+
 }  // namespace base::i18n
 
 #endif
@@ -13,8 +13,11 @@
 
 #include "base/i18n/streaming_utf8_validator.h"
 
+#include <algorithm>
+
 #include "base/check_op.h"
 #include "base/i18n/utf8_validator_tables.h"
+#include "base/strings/utf8_validation_internal.h"
 
 namespace base {
 namespace {
@@ -24,6 +27,27 @@ uint8_t StateTableLookup(uint8_t offset) {
   return internal::kUtf8ValidatorTables[offset];
 }
 
+// Chunks at least this large are validated in bulk.
+constexpr size_t kMinBulkSize = 64;
+
+// Returns the size of the prefix of `data` which ends at a character boundary,
+// assuming `data` is valid UTF-8.
+size_t CompleteCharactersSize(base::span<const uint8_t> data) {
+  const size_t size = data.size();
+  for (size_t i = 1; i <= std::min<size_t>(3u, size); ++i) {
+    const uint8_t ch = data[size - i];
+    if ((ch & 0xC0) == 0x80) {
+      continue;
+    }
+    if (ch < 0x80) {
+      return size;
+    }
+    const size_t length = ch >= 0xF0 ? 4u : ch >= 0xE0 ? 3u : 2u;
+    return length > i ? size - i : size;
+  }
+  return size;
+}
+
 }  // namespace
 
 StreamingUtf8Validator::State StreamingUtf8Validator::AddBytes(
@@ -31,6 +55,17 @@ StreamingUtf8Validator::State StreamingUtf8Validator::AddBytes(
   // Copy |state_| into a local variable so that the compiler doesn't have to be
   // careful of aliasing.
   uint8_t state = state_;
+  // Large chunks which start at a character boundary are validated with the
+  // vector kernel of IsStringUTF8(), which accepts the same strings as the
+  // state machine, leaving it only the incomplete last character, if any.
+  if (state == 0 && data.size() >= kMinBulkSize) {
+    const auto [complete, rest] = data.split_at(CompleteCharactersSize(data));
+    if (internal::ValidateUtf8(complete) == internal::Utf8Validity::kInvalid) {
+      state_ = internal::I18N_UTF8_VALIDATOR_INVALID_INDEX;
+      return INVALID;
+    }
+    data = rest;
+  }
   for (const uint8_t ch : data) {
     if ((ch & 0x80) == 0) {
       if (state == 0)
@@ -303,6 +303,37 @@ TEST(StreamingUtf8ValidatorTest, ResetWorks) {
             validator.AddBytes(base::as_bytes(base::make_span("a", 1u))));
 }
 
+// Chunks large enough to be validated in bulk give the same results when split
+// anywhere, including in the middle of a character.
+TEST(StreamingUtf8ValidatorTest, LargeChunks) {
+  std::string valid;
+  while (valid.size() < 200) {
+    valid += "abc\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+  }
+  std::string invalid = valid;
+  invalid[150] = '\xFF';
+
+  for (size_t split = 0; split <= valid.size(); ++split) {
+    const auto [head, tail] = base::as_byte_span(valid).split_at(split);
+    StreamingUtf8Validator validator;
+    EXPECT_NE(INVALID, validator.AddBytes(head)) << split;
+    EXPECT_EQ(VALID_ENDPOINT, validator.AddBytes(tail)) << split;
+
+    const auto [invalid_head, invalid_tail] =
+        base::as_byte_span(invalid).split_at(split);
+    StreamingUtf8Validator invalid_validator;
+    invalid_validator.AddBytes(invalid_head);
+    EXPECT_EQ(INVALID, invalid_validator.AddBytes(invalid_tail)) << split;
+  }
+
+  // A chunk which starts in the middle of a character: "\xE2\x82\xAC".
+  StreamingUtf8Validator validator;
+  EXPECT_EQ(VALID_MIDPOINT,
+            validator.AddBytes(base::as_bytes(base::make_span("\xE2", 1u))));
+  EXPECT_EQ(VALID_ENDPOINT,
+            validator.AddBytes(base::as_byte_span(valid).subspan(6u)));
+}
+
 TEST_F(StreamingUtf8ValidatorSingleSequenceTest, Valid) {
   CheckRange(valid, valid_end, VALID_ENDPOINT);
 }
@@ -4,15 +4,37 @@
 
 #include "base/i18n/string_compare.h"
 
+#include <memory>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include "base/check.h"
+#include "base/no_destructor.h"
+#include "base/ranges/algorithm.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/thread_local.h"
+#include "third_party/icu/source/common/unicode/uloc.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 
 namespace base {
 namespace i18n {
 
+namespace {
+
+struct CachedCollator {
+  std::string locale;
+  icu::Collator::ECollationStrength strength;
+  std::unique_ptr<icu::Collator> collator;
+};
+
+// The collators created on a thread. There are typically one or two of them,
+// and they are never deleted before the thread exits, since callers may hold
+// on to them after the default locale changes.
+using ThreadCollatorCache = std::vector<CachedCollator>;
+
+}  // namespace
+
 // Compares the character data stored in two different std::u16string strings by
 // specified Collator instance.
 UCollationResult CompareString16WithCollator(const icu::Collator& collator,
@@ -27,5 +49,33 @@ UCollationResult CompareString16WithCollator(const icu::Collator& collator,
   return result;
 }
 
+const icu::Collator* GetCollatorForCurrentThread(
+    icu::Collator::ECollationStrength strength) {
+  static NoDestructor<ThreadLocalOwnedPointer<ThreadCollatorCache>> caches;
+  ThreadCollatorCache* cache = caches->Get();
+  if (!cache) {
+    caches->Set(std::make_unique<ThreadCollatorCache>());
+    cache = caches->Get();
+  }
+
+  const char* locale = uloc_getDefault();
+  auto it = ranges::find_if(*cache, [&](const CachedCollator& cached) {
+    return cached.strength == strength && cached.locale == locale;
+  });
+  if (it != cache->end()) {
+    return it->collator.get();
+  }
+
+  UErrorCode error = U_ZERO_ERROR;
+  std::unique_ptr<icu::Collator> collator(
+      icu::Collator::createInstance(error));
+  if (U_FAILURE(error) || !collator) {
+    return nullptr;
+  }
+  collator->setStrength(strength);
+  cache->push_back({locale, strength, std::move(collator)});
+  return cache->back().collator.get();
+}
+
 }  // namespace i18n
 }  // namespace base
@@ -19,6 +19,14 @@ CompareString16WithCollator(const icu::Collator& collator,
                             const std::u16string_view lhs,
                             const std::u16string_view rhs);
 
+// Returns a collator for the default locale with `strength`, or null if ICU
+// failed to create it. Creating a collator loads and builds the collation
+// rules of the locale, so the collators are cached for each thread, default
+// locale and strength, until the thread exits. The collator must only be used
+// on the calling thread.
+BASE_I18N_EXPORT const icu::Collator* GetCollatorForCurrentThread(
+    icu::Collator::ECollationStrength strength);
+
 }  // namespace i18n
 }  // namespace base
 
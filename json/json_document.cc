@@ -0,0 +1,279 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_document.h"
+
+#include <string.h>
+
+#include <iterator>
+#include <memory>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/notreached.h"
+#include "base/numerics/safe_conversions.h"
+
+namespace base {
+
+namespace {
+
+// Size of the blocks that decoded strings are packed into. Strings longer than
+// a quarter of this get a block of their own, so at most a quarter of each
+// block is wasted.
+constexpr size_t kStringBlockSize = 4096;
+
+}  // namespace
+
+// Node ////////////////////////////////////////////////////////////////////////
+
+JSONDocument::Node::Node(const Storage* storage, uint32_t index)
+    : storage_(storage), index_(index) {}
+
+JSONDocument::Node::Node(const Node&) = default;
+
+JSONDocument::Node& JSONDocument::Node::operator=(const Node&) = default;
+
+JSONDocument::Node::~Node() = default;
+
+Value::Type JSONDocument::Node::type() const {
+  const NodeData& data = storage_->data(index_);
+  if (absl::holds_alternative<absl::monostate>(data)) {
+    return Value::Type::NONE;
+  }
+  if (absl::holds_alternative<bool>(data)) {
+    return Value::Type::BOOLEAN;
+  }
+  if (absl::holds_alternative<int>(data)) {
+    return Value::Type::INTEGER;
+  }
+  if (absl::holds_alternative<double>(data)) {
+    return Value::Type::DOUBLE;
+  }
+  if (absl::holds_alternative<std::string_view>(data)) {
+    return Value::Type::STRING;
+  }
+  if (absl::holds_alternative<DictRange>(data)) {
+    return Value::Type::DICT;
+  }
+  CHECK(absl::holds_alternative<ListRange>(data));
+  return Value::Type::LIST;
+}
+
+std::optional<bool> JSONDocument::Node::GetIfBool() const {
+  const bool* result = absl::get_if<bool>(&storage_->data(index_));
+  return result ? std::optional<bool>(*result) : std::nullopt;
+}
+
+std::optional<int> JSONDocument::Node::GetIfInt() const {
+  const int* result = absl::get_if<int>(&storage_->data(index_));
+  return result ? std::optional<int>(*result) : std::nullopt;
+}
+
+std::optional<double> JSONDocument::Node::GetIfDouble() const {
+  const NodeData& data = storage_->data(index_);
+  if (const int* int_value = absl::get_if<int>(&data)) {
+    return static_cast<double>(*int_value);
+  }
+  const double* result = absl::get_if<double>(&data);
+  return result ? std::optional<double>(*result) : std::nullopt;
+}
+
+std::optional<std::string_view> JSONDocument::Node::GetIfString() const {
+  const std::string_view* result =
+      absl::get_if<std::string_view>(&storage_->data(index_));
+  return result ? std::optional<std::string_view>(*result) : std::nullopt;
+}
+
+bool JSONDocument::Node::GetBool() const {
+  return absl::get<bool>(storage_->data(index_));
+}
+
+int JSONDocument::Node::GetInt() const {
+  return absl::get<int>(storage_->data(index_));
+}
+
+double JSONDocument::Node::GetDouble() const {
+  std::optional<double> result = GetIfDouble();
+  CHECK(result);
+  return *result;
+}
+
+std::string_view JSONDocument::Node::GetString() const {
+  return absl::get<std::string_view>(storage_->data(index_));
+}
+
+size_t JSONDocument::Node::size() const {
+  const NodeData& data = storage_->data(index_);
+  if (const DictRange* dict = absl::get_if<DictRange>(&data)) {
+    return dict->size;
+  }
+  return absl::get<ListRange>(data).size;
+}
+
+JSONDocument::Node JSONDocument::Node::GetListItem(size_t index) const {
+  const ListRange& list = absl::get<ListRange>(storage_->data(index_));
+  CHECK_LT(index, list.size);
+  return Node(storage_, storage_->list_items[list.begin + index]);
+}
+
+std::string_view JSONDocument::Node::GetDictKey(size_t index) const {
+  const DictRange& dict = absl::get<DictRange>(storage_->data(index_));
+  CHECK_LT(index, dict.size);
+  return storage_->dict_members[dict.begin + index].first;
+}
+
+JSONDocument::Node JSONDocument::Node::GetDictValue(size_t index) const {
+  const DictRange& dict = absl::get<DictRange>(storage_->data(index_));
+  CHECK_LT(index, dict.size);
+  return Node(storage_, storage_->dict_members[dict.begin + index].second);
+}
+
+std::optional<JSONDocument::Node> JSONDocument::Node::FindKey(
+    std::string_view key) const {
+  const DictRange& dict = absl::get<DictRange>(storage_->data(index_));
+  // Search backwards so that the last of any duplicate keys wins.
+  for (size_t i = dict.size; i > 0; --i) {
+    const DictMember& member = storage_->dict_members[dict.begin + i - 1];
+    if (member.first == key) {
+      return Node(storage_, member.second);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<JSONDocument::Node> JSONDocument::Node::FindByDottedPath(
+    std::string_view path) const {
+  DCHECK(!path.empty());
+  std::optional<Node> current = *this;
+  while (true) {
+    const size_t dot = path.find('.');
+    current = current->FindKey(path.substr(0, dot));
+    if (dot == std::string_view::npos || !current) {
+      return current;
+    }
+    if (!current->is_dict()) {
+      return std::nullopt;
+    }
+    path.remove_prefix(dot + 1);
+  }
+}
+
+Value JSONDocument::Node::ToValue() const {
+  switch (type()) {
+    case Value::Type::NONE:
+      return Value();
+    case Value::Type::BOOLEAN:
+      return Value(GetBool());
+    case Value::Type::INTEGER:
+      return Value(GetInt());
+    case Value::Type::DOUBLE:
+      return Value(GetDouble());
+    case Value::Type::STRING:
+      return Value(GetString());
+    case Value::Type::DICT: {
+      Value::Dict dict;
+      for (size_t i = 0; i < size(); ++i) {
+        dict.Set(GetDictKey(i), GetDictValue(i).ToValue());
+      }
+      return Value(std::move(dict));
+    }
+    case Value::Type::LIST: {
+      Value::List list;
+      list.reserve(size());
+      for (size_t i = 0; i < size(); ++i) {
+        list.Append(GetListItem(i).ToValue());
+      }
+      return Value(std::move(list));
+    }
+    case Value::Type::BINARY:
+      break;
+  }
+  NOTREACHED_NORETURN();
+}
+
+// JSONDocument ////////////////////////////////////////////////////////////////
+
+JSONDocument::Storage::Storage() = default;
+
+JSONDocument::Storage::~Storage() = default;
+
+JSONDocument::JSONDocument() : storage_(std::make_unique<Storage>()) {}
+
+JSONDocument::JSONDocument(JSONDocument&& other) = default;
+
+JSONDocument& JSONDocument::operator=(JSONDocument&& other) = default;
+
+JSONDocument::~JSONDocument() = default;
+
+JSONDocument::Node JSONDocument::root() const {
+  CHECK(storage_);
+  CHECK(!storage_->nodes.empty());
+  return Node(storage_.get(),
+              checked_cast<uint32_t>(storage_->nodes.size() - 1));
+}
+
+uint32_t JSONDocument::AddNode(NodeData data) {
+  storage_->nodes.push_back(std::move(data));
+  return checked_cast<uint32_t>(storage_->nodes.size() - 1);
+}
+
+std::string_view JSONDocument::AddOwnedString(std::string_view string) {
+  owned_string_bytes_ += string.size();
+  char* dest;
+  if (string.size() > kStringBlockSize / 4) {
+    large_strings_.push_back(
+        std::make_unique_for_overwrite<char[]>(string.size()));
+    dest = large_strings_.back().get();
+  } else {
+    if (string.size() > string_block_remaining_) {
+      string_blocks_.push_back(
+          std::make_unique_for_overwrite<char[]>(kStringBlockSize));
+      string_block_remaining_ = kStringBlockSize;
+    }
+    dest = string_blocks_.back().get() + kStringBlockSize -
+           string_block_remaining_;
+    string_block_remaining_ -= string.size();
+  }
+  memcpy(dest, string.data(), string.size());
+  return std::string_view(dest, string.size());
+}
+
+uint32_t JSONDocument::FinishList(size_t mark) {
+  DCHECK_LE(mark, pending_list_items_.size());
+  std::vector<uint32_t>& list_items = storage_->list_items;
+  const ListRange range = {
+      .begin = checked_cast<uint32_t>(list_items.size()),
+      .size = checked_cast<uint32_t>(pending_list_items_.size() - mark),
+  };
+  list_items.insert(list_items.end(),
+                    std::next(pending_list_items_.begin(),
+                              static_cast<ptrdiff_t>(mark)),
+                    pending_list_items_.end());
+  pending_list_items_.resize(mark);
+  return AddNode(range);
+}
+
+uint32_t JSONDocument::FinishDict(size_t mark) {
+  DCHECK_LE(mark, pending_dict_members_.size());
+  std::vector<DictMember>& dict_members = storage_->dict_members;
+  const DictRange range = {
+      .begin = checked_cast<uint32_t>(dict_members.size()),
+      .size = checked_cast<uint32_t>(pending_dict_members_.size() - mark),
+  };
+  dict_members.insert(dict_members.end(),
+                      std::next(pending_dict_members_.begin(),
+                                static_cast<ptrdiff_t>(mark)),
+                      pending_dict_members_.end());
+  pending_dict_members_.resize(mark);
+  return AddNode(range);
+}
+
+void JSONDocument::FinishBuilding() {
+  DCHECK(pending_list_items_.empty());
+  DCHECK(pending_dict_members_.empty());
+  pending_list_items_.shrink_to_fit();
+  pending_dict_members_.shrink_to_fit();
+}
+
+}  // namespace base
@@ -0,0 +1,223 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_JSON_JSON_DOCUMENT_H_
+#define BASE_JSON_JSON_DOCUMENT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/memory/raw_ptr.h"
+#include "base/values.h"
+#include "third_party/abseil-cpp/absl/types/variant.h"
+
+namespace base {
+
+namespace internal {
+class JSONParser;
+}  // namespace internal
+
+// A read-only JSON DOM produced by JSONReader::ReadDocument().
+//
+// Unlike base::Value, a JSONDocument does not copy string contents that can be
+// used as-is: strings (including dictionary keys) that contain no escape
+// sequences are std::string_views into the original input, and only strings
+// that had to be decoded are stored in the document itself. All nodes live in
+// a few flat arrays and decoded strings are packed into large blocks, so
+// building and destroying a document costs a handful of allocations regardless
+// of its size. This makes it a good fit for large, short-lived documents that
+// are only read, e.g. with JSONValueConverter.
+//
+// The input passed to JSONReader::ReadDocument() must outlive the document and
+// any std::string_view obtained from it. Moving a document keeps its nodes and
+// strings valid.
+//
+// Dictionaries preserve their members in input order, including duplicate
+// keys. FindKey() returns the last member with a given key, matching the
+// behavior of JSONReader::Read().
+//
+// Example:
+//
+//   std::optional<JSONDocument> doc = JSONReader::ReadDocument(json);
+//   if (doc && doc->root().is_dict()) {
+//     if (std::optional<JSONDocument::Node> name = doc->root().FindKey("name");
+//         name && name->is_string()) {
+//       std::string_view value = name->GetString();
+//     }
+//   }
+class BASE_EXPORT JSONDocument {
+ private:
+  struct Storage;
+
+ public:
+  // A lightweight handle to a value in a JSONDocument. Nodes are cheap to copy
+  // and are valid for as long as the document they came from, or the document
+  // it was moved to.
+  class BASE_EXPORT Node {
+   public:
+    Node(const Node&);
+    Node& operator=(const Node&);
+    ~Node();
+
+    Value::Type type() const;
+
+    bool is_none() const { return type() == Value::Type::NONE; }
+    bool is_bool() const { return type() == Value::Type::BOOLEAN; }
+    bool is_int() const { return type() == Value::Type::INTEGER; }
+    bool is_double() const { return type() == Value::Type::DOUBLE; }
+    bool is_string() const { return type() == Value::Type::STRING; }
+    bool is_list() const { return type() == Value::Type::LIST; }
+    bool is_dict() const { return type() == Value::Type::DICT; }
+
+    // These have the same semantics as their base::Value equivalents; in
+    // particular GetIfDouble() and GetDouble() accept integers.
+    std::optional<bool> GetIfBool() const;
+    std::optional<int> GetIfInt() const;
+    std::optional<double> GetIfDouble() const;
+    std::optional<std::string_view> GetIfString() const;
+
+    // These CHECK that the node has the matching type.
+    bool GetBool() const;
+    int GetInt() const;
+    double GetDouble() const;
+    std::string_view GetString() const;
+
+    // Returns the number of items in a list or members in a dictionary. CHECKs
+    // that the node is a list or a dictionary.
+    size_t size() const;
+
+    // Returns the list item at |index|. CHECKs that the node is a list and that
+    // |index| is in range.
+    Node GetListItem(size_t index) const;
+
+    // Return the key and value of the dictionary member at |index|, in input
+    // order. CHECK that the node is a dictionary and that |index| is in range.
+    std::string_view GetDictKey(size_t index) const;
+    Node GetDictValue(size_t index) const;
+
+    // Returns the value of the last member with |key|, or std::nullopt if there
+    // is none. CHECKs that the node is a dictionary.
+    std::optional<Node> FindKey(std::string_view key) const;
+
+    // Like Value::Dict::FindByDottedPath(): looks up a '.'-separated |path| of
+    // keys through nested dictionaries. Returns std::nullopt if a component is
+    // missing or an intermediate value is not a dictionary. CHECKs that the
+    // node is a dictionary.
+    std::optional<Node> FindByDottedPath(std::string_view path) const;
+
+    // Deep-copies this node into a base::Value. Duplicate dictionary keys
+    // collapse to the last value.
+    Value ToValue() const;
+
+   private:
+    friend class JSONDocument;
+
+    Node(const Storage* storage, uint32_t index);
+
+    raw_ptr<const Storage> storage_;
+    uint32_t index_;
+  };
+
+  JSONDocument(JSONDocument&& other);
+  JSONDocument& operator=(JSONDocument&& other);
+
+  JSONDocument(const JSONDocument&) = delete;
+  JSONDocument& operator=(const JSONDocument&) = delete;
+
+  ~JSONDocument();
+
+  // Returns the top-level value of the document.
+  Node root() const;
+
+  // Returns the number of bytes of decoded string data owned by the document,
+  // i.e. the strings that could not be borrowed from the input.
+  size_t owned_string_bytes() const { return owned_string_bytes_; }
+
+ private:
+  friend class internal::JSONParser;
+
+  // Ranges into |list_items_| and |dict_members_|.
+  struct ListRange {
+    uint32_t begin;
+    uint32_t size;
+  };
+  struct DictRange {
+    uint32_t begin;
+    uint32_t size;
+  };
+
+  using NodeData = absl::variant<absl::monostate,
+                                 bool,
+                                 int,
+                                 double,
+                                 std::string_view,
+                                 DictRange,
+                                 ListRange>;
+
+  using DictMember = std::pair<std::string_view, uint32_t>;
+
+  // The nodes, which are allocated separately so that they don't move with the
+  // document.
+  struct Storage {
+    Storage();
+    ~Storage();
+
+    const NodeData& data(uint32_t index) const { return nodes[index]; }
+
+    std::vector<NodeData> nodes;
+    std::vector<uint32_t> list_items;
+    std::vector<DictMember> dict_members;
+  };
+
+  JSONDocument();
+
+  // Builder interface for internal::JSONParser. Containers are built bottom-up:
+  // the parser adds each child node, records it with AddPendingListItem() or
+  // AddPendingDictMember(), and once the container is closed, FinishList() or
+  // FinishDict() moves the pending children recorded since |mark| into place
+  // and adds the container node itself. The last node added is the root.
+  uint32_t AddNode(NodeData data);
+  std::string_view AddOwnedString(std::string_view string);
+  size_t pending_list_items_mark() const { return pending_list_items_.size(); }
+  size_t pending_dict_members_mark() const {
+    return pending_dict_members_.size();
+  }
+  void AddPendingListItem(uint32_t node) {
+    pending_list_items_.push_back(node);
+  }
+  void AddPendingDictMember(std::string_view key, uint32_t node) {
+    pending_dict_members_.emplace_back(key, node);
+  }
+  uint32_t FinishList(size_t mark);
+  uint32_t FinishDict(size_t mark);
+  // Releases scratch space once parsing is complete.
+  void FinishBuilding();
+
+  std::unique_ptr<Storage> storage_;
+
+  // Strings that needed decoding. Short strings are packed back to back into
+  // fixed-size blocks, the last of which has |string_block_remaining_| bytes
+  // left; long strings get an allocation of their own. Neither is ever
+  // reallocated, so std::string_views into them remain valid as more strings
+  // are added and when the document is moved.
+  std::vector<std::unique_ptr<char[]>> string_blocks_;
+  size_t string_block_remaining_ = 0;
+  std::vector<std::unique_ptr<char[]>> large_strings_;
+  size_t owned_string_bytes_ = 0;
+
+  std::vector<uint32_t> pending_list_items_;
+  std::vector<DictMember> pending_dict_members_;
+};
+
+}  // namespace base
+
+#endif  // BASE_JSON_JSON_DOCUMENT_H_
@@ -0,0 +1,203 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_document.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Returns true if |view| points into |input|.
+bool IsBorrowedFrom(std::string_view view, std::string_view input) {
+  return view.data() >= input.data() &&
+         view.data() + view.size() <= input.data() + input.size();
+}
+
+}  // namespace
+
+TEST(JSONDocumentTest, Scalars) {
+  std::optional<JSONDocument> doc = JSONReader::ReadDocument("true");
+  ASSERT_TRUE(doc);
+  EXPECT_TRUE(doc->root().is_bool());
+  EXPECT_TRUE(doc->root().GetBool());
+
+  doc = JSONReader::ReadDocument("null");
+  ASSERT_TRUE(doc);
+  EXPECT_TRUE(doc->root().is_none());
+  EXPECT_FALSE(doc->root().GetIfBool());
+
+  doc = JSONReader::ReadDocument("42");
+  ASSERT_TRUE(doc);
+  EXPECT_TRUE(doc->root().is_int());
+  EXPECT_EQ(42, doc->root().GetInt());
+  EXPECT_EQ(42.0, doc->root().GetDouble());
+
+  doc = JSONReader::ReadDocument("4.5");
+  ASSERT_TRUE(doc);
+  EXPECT_TRUE(doc->root().is_double());
+  EXPECT_EQ(4.5, doc->root().GetDouble());
+  EXPECT_FALSE(doc->root().GetIfInt());
+}
+
+TEST(JSONDocumentTest, BorrowsUnescapedStrings) {
+  const std::string json = R"({"plain": "value", "escaped": "a\nb"})";
+  std::optional<JSONDocument> doc = JSONReader::ReadDocument(json);
+  ASSERT_TRUE(doc);
+  JSONDocument::Node root = doc->root();
+  ASSERT_TRUE(root.is_dict());
+  ASSERT_EQ(2u, root.size());
+
+  EXPECT_EQ("plain", root.GetDictKey(0));
+  EXPECT_TRUE(IsBorrowedFrom(root.GetDictKey(0), json));
+  EXPECT_EQ("value", root.GetDictValue(0).GetString());
+  EXPECT_TRUE(IsBorrowedFrom(root.GetDictValue(0).GetString(), json));
+
+  EXPECT_EQ("escaped", root.GetDictKey(1));
+  EXPECT_TRUE(IsBorrowedFrom(root.GetDictKey(1), json));
+  EXPECT_EQ("a\nb", root.GetDictValue(1).GetString());
+  EXPECT_FALSE(IsBorrowedFrom(root.GetDictValue(1).GetString(), json));
+
+  EXPECT_EQ(3u, doc->owned_string_bytes());
+}
+
+TEST(JSONDocumentTest, NestedContainers) {
+  const std::string json =
+      R"([1, [2, 3], {"a": [4, {"b": 5}], "c": []}, "x", {}])";
+  std::optional<JSONDocument> doc = JSONReader::ReadDocument(json);
+  ASSERT_TRUE(doc);
+  JSONDocument::Node root = doc->root();
+  ASSERT_TRUE(root.is_list());
+  ASSERT_EQ(5u, root.size());
+  EXPECT_EQ(1, root.GetListItem(0).GetInt());
+
+  JSONDocument::Node inner = root.GetListItem(1);
+  ASSERT_TRUE(inner.is_list());
+  ASSERT_EQ(2u, inner.size());
+  EXPECT_EQ(2, inner.GetListItem(0).GetInt());
+  EXPECT_EQ(3, inner.GetListItem(1).GetInt());
+
+  JSONDocument::Node dict = root.GetListItem(2);
+  ASSERT_TRUE(dict.is_dict());
+  std::optional<JSONDocument::Node> a = dict.FindKey("a");
+  ASSERT_TRUE(a);
+  ASSERT_EQ(2u, a->size());
+  EXPECT_EQ(4, a->GetListItem(0).GetInt());
+  std::optional<JSONDocument::Node> b = a->GetListItem(1).FindKey("b");
+  ASSERT_TRUE(b);
+  EXPECT_EQ(5, b->GetInt());
+  std::optional<JSONDocument::Node> c = dict.FindKey("c");
+  ASSERT_TRUE(c);
+  EXPECT_TRUE(c->is_list());
+  EXPECT_EQ(0u, c->size());
+  EXPECT_FALSE(dict.FindKey("d"));
+
+  EXPECT_EQ("x", root.GetListItem(3).GetIfString());
+  EXPECT_TRUE(root.GetListItem(4).is_dict());
+  EXPECT_EQ(0u, root.GetListItem(4).size());
+
+  EXPECT_EQ(JSONReader::Read(json), root.ToValue());
+}
+
+TEST(JSONDocumentTest, DuplicateKeys) {
+  std::optional<JSONDocument> doc =
+      JSONReader::ReadDocument(R"({"k": 1, "j": 2, "k": 3})");
+  ASSERT_TRUE(doc);
+  JSONDocument::Node root = doc->root();
+  // Members are preserved in input order...
+  ASSERT_EQ(3u, root.size());
+  EXPECT_EQ("k", root.GetDictKey(0));
+  EXPECT_EQ("k", root.GetDictKey(2));
+  // ...but lookups, like base::Value, see the last one.
+  EXPECT_EQ(3, root.FindKey("k")->GetInt());
+  Value value = root.ToValue();
+  EXPECT_EQ(2u, value.GetDict().size());
+  EXPECT_EQ(3, value.GetDict().FindInt("k"));
+}
+
+TEST(JSONDocumentTest, FindByDottedPath) {
+  std::optional<JSONDocument> doc = JSONReader::ReadDocument(
+      R"({"a": {"b": {"c": 1}, "list": [2]}, "a.b": 3})");
+  ASSERT_TRUE(doc);
+  JSONDocument::Node root = doc->root();
+  std::optional<JSONDocument::Node> c = root.FindByDottedPath("a.b.c");
+  ASSERT_TRUE(c);
+  EXPECT_EQ(1, c->GetInt());
+  EXPECT_TRUE(root.FindByDottedPath("a.b")->is_dict());
+  EXPECT_TRUE(root.FindByDottedPath("a")->is_dict());
+  EXPECT_FALSE(root.FindByDottedPath("a.list.0"));
+  EXPECT_FALSE(root.FindByDottedPath("a.b.d"));
+  EXPECT_FALSE(root.FindByDottedPath("x.b"));
+}
+
+TEST(JSONDocumentTest, ManyDecodedStrings) {
+  // Mix short strings, which share storage blocks, with long ones, which are
+  // stored separately, and check that none of them is overwritten.
+  Value::List expected;
+  for (int i = 0; i < 2000; ++i) {
+    const size_t length = (i % 100 == 0) ? 5000 : static_cast<size_t>(i % 37);
+    expected.Append(std::string(length, static_cast<char>('a' + i % 26)) +
+                    "\n");
+  }
+  std::string json;
+  ASSERT_TRUE(JSONWriter::Write(expected, &json));
+  std::optional<JSONDocument> doc = JSONReader::ReadDocument(json);
+  ASSERT_TRUE(doc);
+  EXPECT_EQ(Value(std::move(expected)), doc->root().ToValue());
+}
+
+TEST(JSONDocumentTest, SurvivesMove) {
+  const std::string json = "[\"borrowed\", \"\xC3\xA9\", \"s\\tso\"]";
+  std::optional<JSONDocument> doc = JSONReader::ReadDocument(json);
+  ASSERT_TRUE(doc);
+  JSONDocument moved = std::move(*doc);
+  JSONDocument::Node root = moved.root();
+  ASSERT_EQ(3u, root.size());
+  EXPECT_EQ("borrowed", root.GetListItem(0).GetString());
+  EXPECT_EQ("\xC3\xA9", root.GetListItem(1).GetString());
+  EXPECT_EQ("s\tso", root.GetListItem(2).GetString());
+}
+
+TEST(JSONDocumentTest, NodesSurviveMove) {
+  const std::string json = R"({"list": [1, "s\tso"], "b": true})";
+  std::optional<JSONDocument> doc = JSONReader::ReadDocument(json);
+  ASSERT_TRUE(doc);
+  JSONDocument::Node root = doc->root();
+  std::optional<JSONDocument::Node> list = root.FindKey("list");
+  ASSERT_TRUE(list);
+
+  JSONDocument moved = std::move(*doc);
+  doc.reset();
+  EXPECT_TRUE(root.is_dict());
+  EXPECT_EQ(2u, list->size());
+  EXPECT_EQ(1, list->GetListItem(0).GetInt());
+  EXPECT_EQ("s\tso", list->GetListItem(1).GetString());
+
+  std::optional<JSONDocument> assigned = JSONReader::ReadDocument("null");
+  ASSERT_TRUE(assigned);
+  *assigned = std::move(moved);
+  EXPECT_TRUE(root.FindKey("b")->GetBool());
+  EXPECT_EQ(1, list->GetListItem(0).GetInt());
+}
+
+TEST(JSONDocumentTest, Errors) {
+  EXPECT_FALSE(JSONReader::ReadDocument("[1, 2"));
+  EXPECT_FALSE(JSONReader::ReadDocument("{\"a\": }"));
+  EXPECT_FALSE(JSONReader::ReadDocument("[1] 2"));
+  EXPECT_FALSE(JSONReader::ReadDocument("[1,]", JSON_PARSE_RFC));
+  EXPECT_TRUE(JSONReader::ReadDocument("[1,]", JSON_ALLOW_TRAILING_COMMAS));
+  EXPECT_FALSE(JSONReader::ReadDocument("[[[1]]]", JSON_PARSE_RFC, 3));
+  EXPECT_TRUE(JSONReader::ReadDocument("[[[1]]]", JSON_PARSE_RFC, 4));
+}
+
+}  // namespace base
@@ -0,0 +1,190 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_lines.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check.h"
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+#include "base/json/json_parser.h"
+#include "base/json/json_writer.h"
+#include "base/strings/stringprintf.h"
+
+namespace base {
+
+namespace {
+
+// Buffered records are written once they reach this size.
+constexpr size_t kWriteBufferSize = 64 * 1024;
+
+}  // namespace
+
+JSONLinesReader::JSONLinesReader(int options, size_t max_depth)
+    : options_(options), max_depth_(max_depth) {}
+
+JSONLinesReader::~JSONLinesReader() = default;
+
+bool JSONLinesReader::Initialize(const FilePath& path) {
+  return Initialize(File(path, File::FLAG_OPEN | File::FLAG_READ));
+}
+
+bool JSONLinesReader::Initialize(File file) {
+  DCHECK(!file_.IsValid());
+  if (!file.IsValid()) {
+    return false;
+  }
+  // An empty file cannot be mapped, but is a valid file with no records.
+  if (file.GetLength() == 0) {
+    return true;
+  }
+  if (!file_.Initialize(std::move(file))) {
+    return false;
+  }
+  data_ = as_string_view(file_.bytes());
+  return true;
+}
+
+std::optional<JSONReader::Result> JSONLinesReader::ReadNext() {
+  while (offset_ < data_.size()) {
+    const size_t line_end = std::min(data_.find('\n', offset_), data_.size());
+    const std::string_view line = data_.substr(offset_, line_end - offset_);
+    const int line_number = line_number_;
+
+    offset_ = std::min(line_end + 1, data_.size());
+    if (line_number_ != 0) {
+      ++line_number_;
+    }
+
+    // JSONParser treats a '\r' before the '\n' as whitespace.
+    if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+      continue;
+    }
+
+    internal::JSONParser parser(options_, max_depth_);
+    std::optional<Value> value = parser.Parse(line);
+    if (value) {
+      return JSONReader::Result(std::move(*value));
+    }
+    JSONReader::Error error;
+    error.line = line_number;
+    error.column = parser.error_column();
+    error.message =
+        StringPrintf("Line: %i, column: %i, %s", error.line, error.column,
+                     parser.GetErrorDescription().c_str());
+    return JSONReader::Result(unexpected(std::move(error)));
+  }
+  return std::nullopt;
+}
+
+bool JSONLinesReader::SeekToOffset(size_t offset) {
+  if (offset > data_.size() || (offset > 0 && data_[offset - 1] != '\n')) {
+    return false;
+  }
+  offset_ = offset;
+  if (line_offsets_) {
+    line_number_ = static_cast<int>(
+        std::upper_bound(line_offsets_->begin(), line_offsets_->end(), offset) -
+        line_offsets_->begin());
+    // |offset| may be the end of a file that ends with a line break, which
+    // is not the start of a line in the index.
+    if (offset == data_.size()) {
+      ++line_number_;
+    }
+  } else {
+    line_number_ = offset == 0 ? 1 : 0;
+  }
+  return true;
+}
+
+void JSONLinesReader::BuildIndex() {
+  if (line_offsets_) {
+    return;
+  }
+  line_offsets_.emplace();
+  for (size_t offset = 0; offset < data_.size();) {
+    line_offsets_->push_back(offset);
+    const size_t line_end = data_.find('\n', offset);
+    if (line_end == std::string_view::npos) {
+      break;
+    }
+    offset = line_end + 1;
+  }
+  if (line_number_ == 0) {
+    CHECK(SeekToOffset(offset_));
+  }
+}
+
+size_t JSONLinesReader::GetLineCount() const {
+  CHECK(line_offsets_);
+  return line_offsets_->size();
+}
+
+bool JSONLinesReader::SeekToLine(size_t line) {
+  CHECK(line_offsets_);
+  if (line >= line_offsets_->size()) {
+    return false;
+  }
+  offset_ = (*line_offsets_)[line];
+  line_number_ = static_cast<int>(line) + 1;
+  return true;
+}
+
+JSONLinesWriter::JSONLinesWriter() = default;
+
+JSONLinesWriter::~JSONLinesWriter() {
+  if (file_.IsValid()) {
+    Flush();
+  }
+}
+
+bool JSONLinesWriter::Initialize(const FilePath& path) {
+  DCHECK(!file_.IsValid());
+  file_ = File(path, File::FLAG_OPEN_ALWAYS | File::FLAG_READ |
+                         File::FLAG_APPEND);
+  if (!file_.IsValid()) {
+    return false;
+  }
+  const int64_t length = file_.GetLength();
+  if (length < 0) {
+    return false;
+  }
+  if (length > 0) {
+    uint8_t last_char;
+    if (!file_.ReadAndCheck(length - 1, span_from_ref(last_char))) {
+      return false;
+    }
+    if (last_char != '\n') {
+      buffer_.push_back('\n');
+    }
+  }
+  return true;
+}
+
+bool JSONLinesWriter::Append(ValueView value) {
+  DCHECK(file_.IsValid());
+  std::string record;
+  if (!JSONWriter::Write(value, &record)) {
+    return false;
+  }
+  buffer_.append(record);
+  buffer_.push_back('\n');
+  if (buffer_.size() >= kWriteBufferSize) {
+    return Flush();
+  }
+  return !write_failed_;
+}
+
+bool JSONLinesWriter::Flush() {
+  DCHECK(file_.IsValid());
+  if (!buffer_.empty()) {
+    write_failed_ |= !file_.WriteAtCurrentPosAndCheck(as_byte_span(buffer_));
+    buffer_.clear();
+  }
+  return !write_failed_;
+}
+
+}  // namespace base
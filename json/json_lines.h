@@ -0,0 +1,143 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_JSON_JSON_LINES_H_
+#define BASE_JSON_JSON_LINES_H_
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/files/file.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/json/json_common.h"
+#include "base/json/json_reader.h"
+#include "base/values.h"
+
+namespace base {
+
+class FilePath;
+
+// Support for JSON Lines (also known as NDJSON, https://jsonlines.org/) files,
+// which hold one JSON value per line. Such files are typically logs that are
+// too large to read into a string.
+//
+// Like the other file serializers, these do blocking I/O and must only be
+// used where that is allowed.
+
+// Reads the records of a JSON Lines file one at a time. The file is memory
+// mapped rather than read, so only the pages holding the records being parsed
+// need to be in memory, and each record is parsed straight out of the
+// mapping. Lines that hold only whitespace are skipped.
+//
+// Example:
+//   JSONLinesReader reader;
+//   if (!reader.Initialize(path))
+//     return;
+//   while (std::optional<JSONReader::Result> record = reader.ReadNext()) {
+//     if (!record->has_value()) {
+//       LOG(ERROR) << record->error().ToString();
+//       continue;
+//     }
+//     Process(**record);
+//   }
+class BASE_EXPORT JSONLinesReader {
+ public:
+  // |options| is a bitmask of JSONParserOptions.
+  explicit JSONLinesReader(int options = JSON_PARSE_RFC,
+                           size_t max_depth = internal::kAbsoluteMaxDepth);
+
+  JSONLinesReader(const JSONLinesReader&) = delete;
+  JSONLinesReader& operator=(const JSONLinesReader&) = delete;
+
+  ~JSONLinesReader();
+
+  // Maps the file at |path|, or |file|, for reading. Returns false if the file
+  // cannot be opened or mapped. An empty file is valid and has no records.
+  [[nodiscard]] bool Initialize(const FilePath& path);
+  [[nodiscard]] bool Initialize(File file);
+
+  // Parses the next record. Returns std::nullopt once there are no more
+  // records. A record that is not valid JSON results in an error, after which
+  // reading can continue with the next line. The error's line is the 1-based
+  // line number of the record in the file, or 0 if that is unknown because
+  // of a call to SeekToOffset() before BuildIndex().
+  std::optional<JSONReader::Result> ReadNext();
+
+  // Returns the byte offset in the file of the next line to be read, which can
+  // be saved and later passed to SeekToOffset().
+  size_t offset() const { return offset_; }
+
+  // Continues reading from |offset|, which must be the start of a line.
+  // Returns false, leaving the position unchanged, if it is not.
+  bool SeekToOffset(size_t offset);
+
+  // Scans the whole file for line breaks, so that lines can be accessed by
+  // number. This takes time linear in the size of the file, and memory linear
+  // in the number of lines.
+  void BuildIndex();
+
+  // Returns the number of lines in the file, including blank ones. Requires
+  // BuildIndex().
+  size_t GetLineCount() const;
+
+  // Continues reading from the start of the 0-based line |line|. Returns false
+  // if there is no such line. Requires BuildIndex().
+  bool SeekToLine(size_t line);
+
+ private:
+  const int options_;
+  const size_t max_depth_;
+
+  MemoryMappedFile file_;
+  std::string_view data_;
+
+  // The offset of the next line to read, and its 1-based line number, or 0 if
+  // that is unknown.
+  size_t offset_ = 0;
+  int line_number_ = 1;
+
+  // The offsets of the start of each line, once BuildIndex() is called.
+  std::optional<std::vector<size_t>> line_offsets_;
+};
+
+// Appends records to a JSON Lines file, creating it if it does not exist.
+// Records are buffered, and written once enough have accumulated, by Flush()
+// or on destruction.
+class BASE_EXPORT JSONLinesWriter {
+ public:
+  JSONLinesWriter();
+
+  JSONLinesWriter(const JSONLinesWriter&) = delete;
+  JSONLinesWriter& operator=(const JSONLinesWriter&) = delete;
+
+  ~JSONLinesWriter();
+
+  // Opens the file at |path| for appending. If the file does not end with a
+  // line break, for example because a previous writer was interrupted, one
+  // is added so that new records start on their own line. Returns false if
+  // the file cannot be opened.
+  [[nodiscard]] bool Initialize(const FilePath& path);
+
+  // Serializes |value| as one line. Returns false if |value| cannot be
+  // serialized (see JSONWriter::Write()), in which case nothing is appended,
+  // or if writing to the file has failed.
+  bool Append(ValueView value);
+
+  // Writes all buffered records to the file. Returns false if writing failed.
+  bool Flush();
+
+ private:
+  File file_;
+  std::string buffer_;
+  bool write_failed_ = false;
+};
+
+}  // namespace base
+
+#endif  // BASE_JSON_JSON_LINES_H_
@@ -0,0 +1,166 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_lines.h"
+
+#include <optional>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class JSONLinesTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("test.jsonl");
+  }
+
+ protected:
+  // Reads the value of the next record, which must be valid.
+  static Value ReadValue(JSONLinesReader& reader) {
+    std::optional<JSONReader::Result> record = reader.ReadNext();
+    if (!record || !record->has_value()) {
+      ADD_FAILURE() << "Expected a valid record";
+      return Value();
+    }
+    return std::move(**record);
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+};
+
+}  // namespace
+
+TEST_F(JSONLinesTest, ReadRecords) {
+  ASSERT_TRUE(WriteFile(path_, "{\"a\": 1}\n\n  \r\n[1, 2]\r\n\"last\""));
+  JSONLinesReader reader;
+  ASSERT_TRUE(reader.Initialize(path_));
+  EXPECT_EQ(Value(Value::Dict().Set("a", 1)), ReadValue(reader));
+  EXPECT_EQ(Value(Value::List().Append(1).Append(2)), ReadValue(reader));
+  EXPECT_EQ(Value("last"), ReadValue(reader));
+  EXPECT_FALSE(reader.ReadNext());
+}
+
+TEST_F(JSONLinesTest, EmptyFile) {
+  ASSERT_TRUE(WriteFile(path_, ""));
+  JSONLinesReader reader;
+  ASSERT_TRUE(reader.Initialize(path_));
+  EXPECT_FALSE(reader.ReadNext());
+  reader.BuildIndex();
+  EXPECT_EQ(0u, reader.GetLineCount());
+}
+
+TEST_F(JSONLinesTest, MissingFile) {
+  JSONLinesReader reader;
+  EXPECT_FALSE(reader.Initialize(path_));
+}
+
+TEST_F(JSONLinesTest, InvalidRecord) {
+  ASSERT_TRUE(WriteFile(path_, "1\n\n[1,\n2\n"));
+  JSONLinesReader reader;
+  ASSERT_TRUE(reader.Initialize(path_));
+  EXPECT_EQ(Value(1), ReadValue(reader));
+
+  std::optional<JSONReader::Result> record = reader.ReadNext();
+  ASSERT_TRUE(record);
+  ASSERT_FALSE(record->has_value());
+  EXPECT_EQ(3, record->error().line);
+  EXPECT_EQ(4, record->error().column);
+
+  // Reading continues after the invalid line.
+  EXPECT_EQ(Value(2), ReadValue(reader));
+  EXPECT_FALSE(reader.ReadNext());
+}
+
+TEST_F(JSONLinesTest, SeekToOffset) {
+  ASSERT_TRUE(WriteFile(path_, "1\n22\n333\n"));
+  JSONLinesReader reader;
+  ASSERT_TRUE(reader.Initialize(path_));
+  EXPECT_EQ(Value(1), ReadValue(reader));
+  const size_t offset = reader.offset();
+  EXPECT_EQ(2u, offset);
+  EXPECT_EQ(Value(22), ReadValue(reader));
+  EXPECT_EQ(Value(333), ReadValue(reader));
+
+  ASSERT_TRUE(reader.SeekToOffset(offset));
+  EXPECT_EQ(Value(22), ReadValue(reader));
+
+  // Offsets must be the start of a line.
+  EXPECT_FALSE(reader.SeekToOffset(3));
+  EXPECT_FALSE(reader.SeekToOffset(100));
+  EXPECT_EQ(Value(333), ReadValue(reader));
+}
+
+TEST_F(JSONLinesTest, Index) {
+  ASSERT_TRUE(WriteFile(path_, "0\n1\n\n3\n[4,\n5"));
+  JSONLinesReader reader;
+  ASSERT_TRUE(reader.Initialize(path_));
+  reader.BuildIndex();
+  EXPECT_EQ(6u, reader.GetLineCount());
+
+  ASSERT_TRUE(reader.SeekToLine(3));
+  EXPECT_EQ(Value(3), ReadValue(reader));
+  std::optional<JSONReader::Result> record = reader.ReadNext();
+  ASSERT_TRUE(record);
+  ASSERT_FALSE(record->has_value());
+  EXPECT_EQ(5, record->error().line);
+
+  // Blank lines are skipped.
+  ASSERT_TRUE(reader.SeekToLine(2));
+  EXPECT_EQ(Value(3), ReadValue(reader));
+
+  ASSERT_TRUE(reader.SeekToLine(0));
+  EXPECT_EQ(Value(0), ReadValue(reader));
+  EXPECT_FALSE(reader.SeekToLine(6));
+}
+
+TEST_F(JSONLinesTest, WriteAndReadBack) {
+  {
+    JSONLinesWriter writer;
+    ASSERT_TRUE(writer.Initialize(path_));
+    EXPECT_TRUE(writer.Append(Value(Value::Dict().Set("text", "a\nb"))));
+    EXPECT_TRUE(writer.Append(Value(1.5)));
+    // Binary values cannot be written, and leave no trace.
+    EXPECT_FALSE(writer.Append(Value(Value::BlobStorage({1, 2}))));
+  }
+  {
+    JSONLinesWriter writer;
+    ASSERT_TRUE(writer.Initialize(path_));
+    EXPECT_TRUE(writer.Append(Value(true)));
+    EXPECT_TRUE(writer.Flush());
+  }
+
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(path_, &contents));
+  EXPECT_EQ("{\"text\":\"a\\nb\"}\n1.5\ntrue\n", contents);
+}
+
+TEST_F(JSONLinesTest, AppendAfterTruncatedRecord) {
+  ASSERT_TRUE(WriteFile(path_, "1\n[2"));
+  {
+    JSONLinesWriter writer;
+    ASSERT_TRUE(writer.Initialize(path_));
+    EXPECT_TRUE(writer.Append(Value(3)));
+  }
+
+  JSONLinesReader reader;
+  ASSERT_TRUE(reader.Initialize(path_));
+  EXPECT_EQ(Value(1), ReadValue(reader));
+  std::optional<JSONReader::Result> record = reader.ReadNext();
+  ASSERT_TRUE(record);
+  EXPECT_FALSE(record->has_value());
+  EXPECT_EQ(Value(3), ReadValue(reader));
+}
+
+}  // namespace base
@@ -9,12 +9,18 @@
 
 #include "base/json/json_parser.h"
 
-#include <cmath>
+#include <bit>
 #include <iterator>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "base/check_op.h"
 #include "base/feature_list.h"
 #include "base/features.h"
@@ -22,7 +28,6 @@
 #include "base/metrics/histogram_functions.h"
 #include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
-#include "base/ranges/algorithm.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -83,6 +88,33 @@ bool UnprefixedHexStringToInt(std::string_view input, int* output) {
   return HexStringToInt(input, output);
 }
 
+// Converts the integer part of a JSON number, which JSONParser::ReadInt() has
+// already validated as an optional '-' followed by digits, to an int. Returns
+// false if it is out of range.
+bool JSONIntegerToInt(std::string_view input, int* output) {
+  const bool negative = input.starts_with('-');
+  if (negative) {
+    input.remove_prefix(1);
+  }
+  // Anything longer than INT_MIN's digits is out of range. ReadInt() rejects
+  // leading zeros, so this does not reject valid numbers.
+  if (input.size() > 10) {
+    return false;
+  }
+  int64_t value = 0;
+  for (char c : input) {
+    value = value * 10 + (c - '0');
+  }
+  if (negative) {
+    value = -value;
+  }
+  if (!IsValueInRangeForNumericType<int>(value)) {
+    return false;
+  }
+  *output = static_cast<int>(value);
+  return true;
+}
+
 // These values are persisted to logs. Entries should not be renumbered and
 // numeric values should never be reused.
 enum class ChromiumJsonExtension {
@@ -98,6 +130,109 @@ enum class ChromiumJsonExtension {
 const char kExtensionHistogramName[] =
     "Security.JSONParser.ChromiumExtensionUsage";
 
+// Returns true if |c| terminates a run of string bytes that can be copied
+// verbatim: a quotation mark, a reverse solidus, an ASCII control character or
+// the lead byte of a multi-byte UTF-8 sequence.
+constexpr bool IsStringSpecialChar(char c) {
+  const unsigned char uc = static_cast<unsigned char>(c);
+  return uc == '"' || uc == '\\' || uc < 0x20 || uc >= kExtendedASCIIStart;
+}
+
+// Returns the number of leading bytes of |input| for which
+// IsStringSpecialChar() is false. Scans 16 bytes at a time where SIMD is
+// available, since string contents dominate the size of most JSON documents.
+size_t CountPlainStringChars(std::string_view input) {
+  const char* const begin = input.data();
+  const char* const end = begin + input.size();
+  const char* p = begin;
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  // A signed comparison against 0x20 catches both the control characters and,
+  // as negative values, all bytes >= 0x80.
+  const __m128i space = _mm_set1_epi8(0x20);
+  for (; end - p >= 16; p += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i special =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                  _mm_cmpeq_epi8(chunk, backslash)),
+                     _mm_cmplt_epi8(chunk, space));
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+    if (mask) {
+      return static_cast<size_t>(p - begin) +
+             static_cast<size_t>(std::countr_zero(mask));
+    }
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t space = vdupq_n_u8(0x20);
+  const uint8x16_t non_ascii = vdupq_n_u8(kExtendedASCIIStart);
+  for (; end - p >= 16; p += 16) {
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    const uint8x16_t special =
+        vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+                 vorrq_u8(vcltq_u8(chunk, space), vcgeq_u8(chunk, non_ascii)));
+    // Narrow each 0x00/0xFF lane to a nibble so that the position of the first
+    // special byte can be recovered from a single 64-bit word.
+    const uint64_t mask = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+    if (mask) {
+      return static_cast<size_t>(p - begin) +
+             static_cast<size_t>(std::countr_zero(mask) / 4);
+    }
+  }
+#endif
+  while (p != end && !IsStringSpecialChar(*p)) {
+    ++p;
+  }
+  return static_cast<size_t>(p - begin);
+}
+
+// Returns the number of leading spaces and tabs in |input|. Pretty-printed
+// documents are mostly indentation, so these runs are skipped in bulk.
+size_t CountLeadingBlanks(std::string_view input) {
+  const char* const begin = input.data();
+  const char* const end = begin + input.size();
+  const char* p = begin;
+#if defined(__SSE2__)
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  for (; end - p >= 16; p += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                       _mm_cmpeq_epi8(chunk, tab));
+    const uint32_t mask =
+        ~static_cast<uint32_t>(_mm_movemask_epi8(blank)) & 0xFFFFu;
+    if (mask) {
+      return static_cast<size_t>(p - begin) +
+             static_cast<size_t>(std::countr_zero(mask));
+    }
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t space = vdupq_n_u8(' ');
+  const uint8x16_t tab = vdupq_n_u8('\t');
+  for (; end - p >= 16; p += 16) {
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    const uint8x16_t non_blank =
+        vmvnq_u8(vorrq_u8(vceqq_u8(chunk, space), vceqq_u8(chunk, tab)));
+    const uint64_t mask = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(non_blank), 4)),
+        0);
+    if (mask) {
+      return static_cast<size_t>(p - begin) +
+             static_cast<size_t>(std::countr_zero(mask) / 4);
+    }
+  }
+#endif
+  while (p != end && (*p == ' ' || *p == '\t')) {
+    ++p;
+  }
+  return static_cast<size_t>(p - begin);
+}
+
 }  // namespace
 
 // This is U+FFFD.
@@ -133,30 +268,7 @@ JSONParser::JSONParser(int options, size_t max_depth)
 JSONParser::~JSONParser() = default;
 
 std::optional<Value> JSONParser::Parse(std::string_view input) {
-  input_ = input;
-  index_ = 0;
-  // Line and column counting is 1-based, but |index_| is 0-based. For example,
-  // if input is "Aaa\nB" then 'A' and 'B' are both in column 1 (at lines 1 and
-  // 2) and have indexes of 0 and 4. We track the line number explicitly (the
-  // |line_number_| field) and the column number implicitly (the difference
-  // between |index_| and |index_last_line_|). In calculating that difference,
-  // |index_last_line_| is the index of the '\r' or '\n', not the index of the
-  // first byte after the '\n'. For the 'B' in "Aaa\nB", its |index_| and
-  // |index_last_line_| would be 4 and 3: 'B' is in column (4 - 3) = 1. We
-  // initialize |index_last_line_| to -1, not 0, since -1 is the (out of range)
-  // index of the imaginary '\n' immediately before the start of the string:
-  // 'A' is in column (0 - -1) = 1.
-  line_number_ = 1;
-  index_last_line_ = static_cast<size_t>(-1);
-
-  error_code_ = JSON_NO_ERROR;
-  error_line_ = 0;
-  error_column_ = 0;
-
-  // When the input JSON string starts with a UTF-8 Byte-Order-Mark,
-  // advance the start position to avoid the ParseNextToken function mis-
-  // treating a Unicode BOM as an invalid character and returning NULL.
-  ConsumeIfMatch("\xEF\xBB\xBF");
+  StartParsing(input);
 
   // Parse the first and any nested tokens.
   std::optional<Value> root(ParseNextToken());
@@ -172,6 +284,23 @@ std::optional<Value> JSONParser::Parse(std::string_view input) {
   return root;
 }
 
+std::optional<JSONDocument> JSONParser::ParseDocument(std::string_view input) {
+  StartParsing(input);
+
+  JSONDocument document;
+  if (!ParseDocumentToken(GetNextToken(), &document)) {
+    return std::nullopt;
+  }
+
+  if (GetNextToken() != T_END_OF_INPUT) {
+    ReportError(JSON_UNEXPECTED_DATA_AFTER_ROOT, 0);
+    return std::nullopt;
+  }
+
+  document.FinishBuilding();
+  return document;
+}
+
 JSONParser::JsonParseError JSONParser::error_code() const {
   return error_code_;
 }
@@ -181,6 +310,10 @@ std::string JSONParser::GetErrorMessage() const {
                             ErrorCodeToString(error_code_));
 }
 
+std::string JSONParser::GetErrorDescription() const {
+  return ErrorCodeToString(error_code_);
+}
+
 int JSONParser::error_line() const {
   return error_line_;
 }
@@ -221,6 +354,15 @@ void JSONParser::StringBuilder::Append(base_icu::UChar32 point) {
   }
 }
 
+void JSONParser::StringBuilder::AppendRun(std::string_view run) {
+  if (!string_) {
+    DCHECK_EQ(run.data(), pos_ + length_);
+    length_ += run.size();
+  } else {
+    string_->append(run);
+  }
+}
+
 void JSONParser::StringBuilder::Convert() {
   if (string_)
     return;
@@ -233,8 +375,43 @@ std::string JSONParser::StringBuilder::DestructiveAsString() {
   return std::string(pos_, length_);
 }
 
+std::optional<std::string_view> JSONParser::StringBuilder::AsBorrowedString()
+    const {
+  if (string_) {
+    return std::nullopt;
+  }
+  return std::string_view(pos_, length_);
+}
+
 // JSONParser private //////////////////////////////////////////////////////////
 
+void JSONParser::StartParsing(std::string_view input) {
+  input_ = input;
+  index_ = 0;
+  // Line and column counting is 1-based, but |index_| is 0-based. For example,
+  // if input is "Aaa\nB" then 'A' and 'B' are both in column 1 (at lines 1 and
+  // 2) and have indexes of 0 and 4. We track the line number explicitly (the
+  // |line_number_| field) and the column number implicitly (the difference
+  // between |index_| and |index_last_line_|). In calculating that difference,
+  // |index_last_line_| is the index of the '\r' or '\n', not the index of the
+  // first byte after the '\n'. For the 'B' in "Aaa\nB", its |index_| and
+  // |index_last_line_| would be 4 and 3: 'B' is in column (4 - 3) = 1. We
+  // initialize |index_last_line_| to -1, not 0, since -1 is the (out of range)
+  // index of the imaginary '\n' immediately before the start of the string:
+  // 'A' is in column (0 - -1) = 1.
+  line_number_ = 1;
+  index_last_line_ = static_cast<size_t>(-1);
+
+  error_code_ = JSON_NO_ERROR;
+  error_line_ = 0;
+  error_column_ = 0;
+
+  // When the input JSON string starts with a UTF-8 Byte-Order-Mark,
+  // advance the start position to avoid the ParseNextToken function mis-
+  // treating a Unicode BOM as an invalid character and returning NULL.
+  ConsumeIfMatch("\xEF\xBB\xBF");
+}
+
 std::optional<std::string_view> JSONParser::PeekChars(size_t count) {
   if (index_ + count > input_.length())
     return std::nullopt;
@@ -269,6 +446,11 @@ const char* JSONParser::pos() {
   return input_.data() + index_;
 }
 
+std::string_view JSONParser::RemainingInput() {
+  CHECK_LE(index_, input_.length());
+  return std::string_view(input_.data() + index_, input_.length() - index_);
+}
+
 JSONParser::Token JSONParser::GetNextToken() {
   EatWhitespaceAndComments();
 
@@ -324,10 +506,11 @@ void JSONParser::EatWhitespaceAndComments() {
         if (!(c == '\n' && index_ > 0 && input_[index_ - 1] == '\r')) {
           ++line_number_;
         }
-        [[fallthrough]];
+        ConsumeChar();
+        break;
       case ' ':
       case '\t':
-        ConsumeChar();
+        index_ += CountLeadingBlanks(RemainingInput());
         break;
       case '/':
         if (!EatComment())
@@ -472,11 +655,9 @@ std::optional<Value> JSONParser::ConsumeDictionary() {
   }
 
   ConsumeChar();  // Closing '}'.
-  // Reverse |dict_storage| to keep the last of elements with the same key in
-  // the input.
-  ranges::reverse(values);
-  return Value(Value::Dict(std::make_move_iterator(values.begin()),
-                           std::make_move_iterator(values.end())));
+  // The Dict constructor keeps the last of elements with the same key in the
+  // input.
+  return Value(Value::Dict(std::move(values)));
 }
 
 std::optional<Value> JSONParser::ConsumeList() {
@@ -529,6 +710,165 @@ std::optional<Value> JSONParser::ConsumeString() {
   return Value(string.DestructiveAsString());
 }
 
+std::optional<uint32_t> JSONParser::ParseDocumentToken(
+    Token token,
+    JSONDocument* document) {
+  switch (token) {
+    case T_OBJECT_BEGIN:
+      return ConsumeDocumentDictionary(document);
+    case T_ARRAY_BEGIN:
+      return ConsumeDocumentList(document);
+    case T_STRING: {
+      std::optional<std::string_view> string = ConsumeDocumentString(document);
+      if (!string) {
+        return std::nullopt;
+      }
+      return document->AddNode(*string);
+    }
+    case T_NUMBER: {
+      std::optional<Value> number = ConsumeNumber();
+      if (!number) {
+        return std::nullopt;
+      }
+      if (number->is_int()) {
+        return document->AddNode(number->GetInt());
+      }
+      return document->AddNode(number->GetDouble());
+    }
+    case T_BOOL_TRUE:
+    case T_BOOL_FALSE:
+    case T_NULL: {
+      std::optional<Value> literal = ConsumeLiteral();
+      if (!literal) {
+        return std::nullopt;
+      }
+      if (literal->is_bool()) {
+        return document->AddNode(literal->GetBool());
+      }
+      return document->AddNode(absl::monostate());
+    }
+    default:
+      ReportError(JSON_UNEXPECTED_TOKEN, 0);
+      return std::nullopt;
+  }
+}
+
+std::optional<uint32_t> JSONParser::ConsumeDocumentDictionary(
+    JSONDocument* document) {
+  if (ConsumeChar() != '{') {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return std::nullopt;
+  }
+
+  StackMarker depth_check(max_depth_, &stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSON_TOO_MUCH_NESTING, -1);
+    return std::nullopt;
+  }
+
+  const size_t mark = document->pending_dict_members_mark();
+
+  Token token = GetNextToken();
+  while (token != T_OBJECT_END) {
+    if (token != T_STRING) {
+      ReportError(JSON_UNQUOTED_DICTIONARY_KEY, 0);
+      return std::nullopt;
+    }
+
+    std::optional<std::string_view> key = ConsumeDocumentString(document);
+    if (!key) {
+      return std::nullopt;
+    }
+
+    token = GetNextToken();
+    if (token != T_OBJECT_PAIR_SEPARATOR) {
+      ReportError(JSON_SYNTAX_ERROR, 0);
+      return std::nullopt;
+    }
+
+    ConsumeChar();
+    std::optional<uint32_t> value =
+        ParseDocumentToken(GetNextToken(), document);
+    if (!value) {
+      // ReportError from deeper level.
+      return std::nullopt;
+    }
+
+    document->AddPendingDictMember(*key, *value);
+
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      ConsumeChar();
+      token = GetNextToken();
+      if (token == T_OBJECT_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSON_TRAILING_COMMA, 0);
+        return std::nullopt;
+      }
+    } else if (token != T_OBJECT_END) {
+      ReportError(JSON_SYNTAX_ERROR, 0);
+      return std::nullopt;
+    }
+  }
+
+  ConsumeChar();  // Closing '}'.
+  return document->FinishDict(mark);
+}
+
+std::optional<uint32_t> JSONParser::ConsumeDocumentList(
+    JSONDocument* document) {
+  if (ConsumeChar() != '[') {
+    ReportError(JSON_UNEXPECTED_TOKEN, 0);
+    return std::nullopt;
+  }
+
+  StackMarker depth_check(max_depth_, &stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSON_TOO_MUCH_NESTING, -1);
+    return std::nullopt;
+  }
+
+  const size_t mark = document->pending_list_items_mark();
+
+  Token token = GetNextToken();
+  while (token != T_ARRAY_END) {
+    std::optional<uint32_t> item = ParseDocumentToken(token, document);
+    if (!item) {
+      // ReportError from deeper level.
+      return std::nullopt;
+    }
+
+    document->AddPendingListItem(*item);
+
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      ConsumeChar();
+      token = GetNextToken();
+      if (token == T_ARRAY_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSON_TRAILING_COMMA, 0);
+        return std::nullopt;
+      }
+    } else if (token != T_ARRAY_END) {
+      ReportError(JSON_SYNTAX_ERROR, 0);
+      return std::nullopt;
+    }
+  }
+
+  ConsumeChar();  // Closing ']'.
+  return document->FinishList(mark);
+}
+
+std::optional<std::string_view> JSONParser::ConsumeDocumentString(
+    JSONDocument* document) {
+  StringBuilder string;
+  if (!ConsumeStringRaw(&string)) {
+    return std::nullopt;
+  }
+  if (std::optional<std::string_view> borrowed = string.AsBorrowedString()) {
+    return borrowed;
+  }
+  return document->AddOwnedString(string.DestructiveAsString());
+}
+
 bool JSONParser::ConsumeStringRaw(StringBuilder* out) {
   if (ConsumeChar() != '"') {
     ReportError(JSON_UNEXPECTED_TOKEN, 0);
@@ -541,6 +881,17 @@ bool JSONParser::ConsumeStringRaw(StringBuilder* out) {
   StringBuilder string(pos());
 
   while (std::optional<char> c = PeekChar()) {
+    // Fast path for runs of characters that need no decoding or validation.
+    // These never include line breaks, so the line tracking below is
+    // unaffected.
+    if (!IsStringSpecialChar(*c)) {
+      std::string_view run = RemainingInput();
+      run = run.substr(0, CountPlainStringChars(run));
+      string.AppendRun(run);
+      index_ += run.size();
+      continue;
+    }
+
     base_icu::UChar32 next_char = 0;
     if (static_cast<unsigned char>(*c) < kExtendedASCIIStart) {
       // Fast path for ASCII.
@@ -769,9 +1120,11 @@ std::optional<Value> JSONParser::ConsumeNumber() {
     return std::nullopt;
   }
   end_index = index_;
+  bool is_integer = true;
 
   // The optional fraction part.
   if (PeekChar() == '.') {
+    is_integer = false;
     ConsumeChar();
     if (!ReadInt(true)) {
       ReportError(JSON_SYNTAX_ERROR, 0);
@@ -783,6 +1136,7 @@ std::optional<Value> JSONParser::ConsumeNumber() {
   // Optional exponent part.
   std::optional<char> c = PeekChar();
   if (c == 'e' || c == 'E') {
+    is_integer = false;
     ConsumeChar();
     if (PeekChar() == '-' || PeekChar() == '+') {
       ConsumeChar();
@@ -816,8 +1170,8 @@ std::optional<Value> JSONParser::ConsumeNumber() {
   std::string_view num_string(num_start, end_index - start_index);
 
   int num_int;
-  if (StringToInt(num_string, &num_int)) {
-    // StringToInt will treat `-0` as zero, losing the significance of the
+  if (is_integer && JSONIntegerToInt(num_string, &num_int)) {
+    // Integer conversion treats `-0` as zero, losing the significance of the
     // negation.
     if (num_int == 0 && num_string.starts_with('-')) {
       if (base::FeatureList::IsEnabled(features::kJsonNegativeZero)) {
@@ -828,7 +1182,7 @@ std::optional<Value> JSONParser::ConsumeNumber() {
   }
 
   double num_double;
-  if (StringToDouble(num_string, &num_double) && std::isfinite(num_double)) {
+  if (DecimalStringToDouble(num_string, &num_double)) {
     return Value(num_double);
   }
 
@@ -17,6 +17,7 @@
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
 #include "base/json/json_common.h"
+#include "base/json/json_document.h"
 #include "base/third_party/icu/icu_utf.h"
 #include "base/values.h"
 
@@ -83,12 +84,21 @@ class BASE_EXPORT JSONParser {
   // convert to a FooValue at the same time.
   std::optional<Value> Parse(std::string_view input);
 
+  // Parses the input string like Parse(), but returns the result as a
+  // read-only JSONDocument. Strings without escape sequences in the result
+  // refer directly to |input|, which must outlive the document.
+  std::optional<JSONDocument> ParseDocument(std::string_view input);
+
   // Returns the error code.
   JsonParseError error_code() const;
 
   // Returns the human-friendly error message.
   std::string GetErrorMessage() const;
 
+  // Returns the human-friendly description of the error, without the location
+  // that GetErrorMessage() includes.
+  std::string GetErrorDescription() const;
+
   // Returns the error line number if parse error happened. Otherwise always
   // returns 0.
   int error_line() const;
@@ -136,6 +146,11 @@ class BASE_EXPORT JSONParser {
     // converted, or by appending the UTF8 bytes for the code point.
     void Append(base_icu::UChar32 point);
 
+    // Appends |run|, a sequence of ASCII characters that need no decoding. If
+    // the string has not been converted, |run| must immediately follow the
+    // bytes already in the builder.
+    void AppendRun(std::string_view run);
+
     // Converts the builder from its default std::string_view to a full
     // std::string, performing a copy. Once a builder is converted, it cannot be
     // made a std::string_view again.
@@ -146,6 +161,10 @@ class BASE_EXPORT JSONParser {
     // in cases where the builder will not be needed any more.
     std::string DestructiveAsString();
 
+    // Returns the string as a view of the input if it has not been converted,
+    // and std::nullopt otherwise.
+    std::optional<std::string_view> AsBorrowedString() const;
+
    private:
     // The beginning of the input string.
     const char* pos_;
@@ -158,6 +177,9 @@ class BASE_EXPORT JSONParser {
     std::optional<std::string> string_;
   };
 
+  // Resets the parser state to the beginning of |input|.
+  void StartParsing(std::string_view input);
+
   // Returns the next |count| bytes of the input stream, or nullopt if fewer
   // than |count| bytes remain.
   std::optional<std::string_view> PeekChars(size_t count);
@@ -175,6 +197,9 @@ class BASE_EXPORT JSONParser {
   // Returns a pointer to the current character position.
   const char* pos();
 
+  // Returns the input from the current character position to the end.
+  std::string_view RemainingInput();
+
   // Skips over whitespace and comments to find the next token in the stream.
   // This does not advance the parser for non-whitespace or comment chars.
   Token GetNextToken();
@@ -204,6 +229,19 @@ class BASE_EXPORT JSONParser {
   // Calls through ConsumeStringRaw and wraps it in a value.
   std::optional<Value> ConsumeString();
 
+  // The equivalents of ParseToken(), ConsumeDictionary() and ConsumeList()
+  // for ParseDocument(). On success, these add the parsed value to |document|
+  // and return the index of its node.
+  std::optional<uint32_t> ParseDocumentToken(Token token,
+                                             JSONDocument* document);
+  std::optional<uint32_t> ConsumeDocumentDictionary(JSONDocument* document);
+  std::optional<uint32_t> ConsumeDocumentList(JSONDocument* document);
+
+  // Calls through ConsumeStringRaw and returns the result as a view of the
+  // input if possible, or else of a string owned by |document|.
+  std::optional<std::string_view> ConsumeDocumentString(
+      JSONDocument* document);
+
   // Assuming that the parser is wound to a double quote, this parses a string,
   // decoding any escape sequences and converts UTF-16 to UTF-8. Returns true on
   // success and places result into |out|. Returns false on failure with
@@ -273,6 +311,7 @@ class BASE_EXPORT JSONParser {
   FRIEND_TEST_ALL_PREFIXES(JSONParserTest, ConsumeDictionary);
   FRIEND_TEST_ALL_PREFIXES(JSONParserTest, ConsumeList);
   FRIEND_TEST_ALL_PREFIXES(JSONParserTest, ConsumeString);
+  FRIEND_TEST_ALL_PREFIXES(JSONParserTest, ConsumeLongString);
   FRIEND_TEST_ALL_PREFIXES(JSONParserTest, ConsumeLiterals);
   FRIEND_TEST_ALL_PREFIXES(JSONParserTest, ConsumeNumbers);
   FRIEND_TEST_ALL_PREFIXES(JSONParserTest, ErrorMessages);
@@ -64,6 +64,59 @@ TEST_F(JSONParserTest, ConsumeString) {
   EXPECT_EQ("test", value->GetString());
 }
 
+TEST_F(JSONParserTest, ConsumeLongString) {
+  // Place characters that need special handling at every offset around the
+  // 16-byte blocks that the string scanner works on.
+  for (size_t offset = 0; offset < 40; ++offset) {
+    const std::string prefix(offset, 'a');
+    const std::string suffix(offset % 7 + 20, 'b');
+
+    std::string input = "\"" + prefix + "\\n" + suffix + "\",|";
+    std::unique_ptr<JSONParser> parser(NewTestParser(input));
+    std::optional<Value> value(parser->ConsumeString());
+    EXPECT_EQ(',', *parser->pos());
+    TestLastThree(parser.get());
+    ASSERT_TRUE(value);
+    EXPECT_EQ(prefix + "\n" + suffix, value->GetString());
+
+    input = "\"" + prefix + "\xC3\xA9" + suffix + "\",|";
+    parser.reset(NewTestParser(input));
+    value = parser->ConsumeString();
+    TestLastThree(parser.get());
+    ASSERT_TRUE(value);
+    EXPECT_EQ(prefix + "\xC3\xA9" + suffix, value->GetString());
+
+    input = "\"" + prefix + "\",|";
+    parser.reset(NewTestParser(input));
+    value = parser->ConsumeString();
+    TestLastThree(parser.get());
+    ASSERT_TRUE(value);
+    EXPECT_EQ(prefix, value->GetString());
+
+    input = "\"" + prefix + '\x01' + suffix + "\"";
+    parser.reset(NewTestParser(input));
+    EXPECT_FALSE(parser->ConsumeString());
+    EXPECT_EQ(JSONParser::JSON_UNSUPPORTED_ENCODING, parser->error_code());
+  }
+}
+
+TEST_F(JSONParserTest, LongWhitespaceRuns) {
+  const std::string indent(37, ' ');
+  const std::string tabs(19, '\t');
+  std::string input = "[\n" + indent + "1,\n" + tabs + indent + "2" + tabs +
+                      ",\r\n" + indent + "  x]";
+  JSONParser parser(JSON_PARSE_RFC);
+  EXPECT_FALSE(parser.Parse(input));
+  EXPECT_EQ(4, parser.error_line());
+  EXPECT_EQ(static_cast<int>(indent.size()) + 3, parser.error_column());
+
+  input = "[\n" + indent + "1,\n" + tabs + indent + "2" + tabs + "\r\n]";
+  std::optional<Value> value = parser.Parse(input);
+  ASSERT_TRUE(value);
+  ASSERT_TRUE(value->is_list());
+  EXPECT_EQ(2u, value->GetList().size());
+}
+
 TEST_F(JSONParserTest, ConsumeList) {
   std::string input("[true, false],|");
   std::unique_ptr<JSONParser> parser(NewTestParser(input));
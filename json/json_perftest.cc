@@ -2,15 +2,16 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/json/json_parser.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/string_number_conversions.h"
-#include "base/time/time.h"
+#include "base/test/perf_benchmark.h"
+#include "base/test/task_environment.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
-#include "testing/perf/perf_result_reporter.h"
 
 namespace base {
 
@@ -19,13 +20,14 @@ namespace {
 constexpr char kMetricPrefixJSON[] = "JSON.";
 constexpr char kMetricReadTime[] = "read_time";
 constexpr char kMetricWriteTime[] = "write_time";
+constexpr char kMetricParseTime[] = "parse_time";
 
-perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
-  perf_test::PerfResultReporter reporter(kMetricPrefixJSON, story_name);
-  reporter.RegisterImportantMetric(kMetricReadTime, "ms");
-  reporter.RegisterImportantMetric(kMetricWriteTime, "ms");
-  return reporter;
-}
+// The largest trees of the stress test take seconds to write and read, so it
+// takes fewer samples.
+constexpr PerfBenchmark::Options kStressTestOptions = {
+    .warmup_repetitions = 1,
+    .repetitions = 5,
+};
 
 // Generates a simple dictionary value with simple data types, a string and a
 // list.
@@ -61,27 +63,55 @@ Value::Dict GenerateLayeredDict(int breadth, int depth) {
   return root;
 }
 
+// Generates a list of |count| dictionaries whose values are mostly long,
+// unescaped strings, which is typical of configuration and manifest files.
+Value::List GenerateStringHeavyList(int count) {
+  Value::List list;
+  for (int i = 0; i < count; ++i) {
+    Value::Dict dict;
+    dict.Set("name", "item_" + base::NumberToString(i));
+    dict.Set("description", std::string(200, 'd'));
+    dict.Set("url", "https://www.example.com/some/fairly/long/path/" +
+                        base::NumberToString(i) + "/index.html");
+    dict.Set("escaped", "line one\nline two\t\"quoted\"");
+    list.Append(std::move(dict));
+  }
+  return list;
+}
+
+// Generates a list of |count| numbers, alternating between integers and
+// doubles of the sort found in telemetry samples.
+Value::List GenerateNumberHeavyList(int count) {
+  Value::List list;
+  for (int i = 0; i < count; ++i) {
+    list.Append(i * 7919 % 100000);
+    list.Append(i * 0.001 + 0.5);
+  }
+  return list;
+}
+
+// Times the C++ JSONParser directly, bypassing JSONReader's choice of parser.
+void TestParse(const std::string& story_name, std::string_view json) {
+  internal::JSONParser parser(JSON_PARSE_RFC);
+  PerfBenchmark benchmark(kMetricPrefixJSON, story_name);
+  benchmark.Run(kMetricParseTime, [&] { EXPECT_TRUE(parser.Parse(json)); });
+}
+
 }  // namespace
 
 class JSONPerfTest : public testing::Test {
  public:
   void TestWriteAndRead(int breadth, int depth) {
-    std::string description = "Breadth: " + base::NumberToString(breadth) +
-                              ", Depth: " + base::NumberToString(depth);
     Value::Dict dict = GenerateLayeredDict(breadth, depth);
     std::string json;
-
-    TimeTicks start_write = TimeTicks::Now();
-    JSONWriter::Write(dict, &json);
-    TimeTicks end_write = TimeTicks::Now();
-    auto reporter = SetUpReporter("breadth_" + base::NumberToString(breadth) +
-                                  "_depth_" + base::NumberToString(depth));
-    reporter.AddResult(kMetricWriteTime, end_write - start_write);
-
-    TimeTicks start_read = TimeTicks::Now();
-    JSONReader::Read(json);
-    TimeTicks end_read = TimeTicks::Now();
-    reporter.AddResult(kMetricReadTime, end_read - start_read);
+    PerfBenchmark benchmark(kMetricPrefixJSON,
+                            "breadth_" + base::NumberToString(breadth) +
+                                "_depth_" + base::NumberToString(depth),
+                            kStressTestOptions);
+    benchmark.RunWithSetup(
+        kMetricWriteTime, [&] { json.clear(); },
+        [&] { JSONWriter::Write(dict, &json); });
+    benchmark.Run(kMetricReadTime, [&] { JSONReader::Read(json); });
   }
 };
 
@@ -97,4 +127,58 @@ TEST_F(JSONPerfTest, StressTest) {
   }
 }
 
+TEST_F(JSONPerfTest, ParseStringHeavy) {
+  std::string json;
+  JSONWriter::Write(GenerateStringHeavyList(50000), &json);
+  TestParse("string_heavy", json);
+}
+
+TEST_F(JSONPerfTest, ParseNumberHeavy) {
+  std::string json;
+  JSONWriter::Write(GenerateNumberHeavyList(500000), &json);
+  TestParse("number_heavy", json);
+}
+
+TEST_F(JSONPerfTest, WriteNumberHeavy) {
+  Value list(GenerateNumberHeavyList(500000));
+  std::string json;
+  PerfBenchmark benchmark(kMetricPrefixJSON, "number_heavy");
+  benchmark.RunWithSetup(
+      kMetricWriteTime, [&] { json.clear(); },
+      [&] { JSONWriter::Write(list, &json); });
+}
+
+TEST_F(JSONPerfTest, ReadListInParallel) {
+  test::TaskEnvironment task_environment;
+  std::string json;
+  JSONWriter::Write(GenerateStringHeavyList(200000), &json);
+
+  PerfBenchmark sequential_benchmark(kMetricPrefixJSON, "list_sequential");
+  sequential_benchmark.Run(kMetricParseTime,
+                           [&] { EXPECT_TRUE(JSONReader::Read(json)); });
+
+  PerfBenchmark parallel_benchmark(kMetricPrefixJSON, "list_parallel");
+  parallel_benchmark.Run(kMetricParseTime, [&] {
+    EXPECT_TRUE(JSONReader::ReadListInParallel(json));
+  });
+}
+
+TEST_F(JSONPerfTest, ParseWideDict) {
+  // Keys in reverse order are the worst case for inserting one at a time.
+  std::string json = "{";
+  for (int i = 200000; i > 0; --i) {
+    json += "\"key" + NumberToString(i) + "\": " + NumberToString(i) + ",";
+  }
+  json.back() = '}';
+  TestParse("wide_dict", json);
+}
+
+TEST_F(JSONPerfTest, ParsePrettyPrinted) {
+  // Pretty-printing a deep tree makes most of the document indentation.
+  std::string json;
+  JSONWriter::WriteWithOptions(GenerateLayeredDict(3, 10),
+                               JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+  TestParse("pretty_printed", json);
+}
+
 }  // namespace base
@@ -16,6 +16,10 @@
 // lines per input file (individual iteration times). For a single input file,
 // building and running this program before and after a particular commit can
 // work well with the 'ministat' tool: https://github.com/thorduri/ministat
+//
+// The -cpp switch times the C++ JSONParser directly, even when JSONReader
+// would otherwise pick the Rust implementation. This is useful for measuring
+// changes to json_parser.cc.
 
 #include <inttypes.h>
 #include <iomanip>
@@ -23,6 +27,7 @@
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
+#include "base/json/json_parser.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/time/time.h"
@@ -37,6 +42,7 @@ int main(int argc, char* argv[]) {
   base::CommandLine::Init(argc, argv);
   base::CommandLine* command_line = base::CommandLine::ForCurrentProcess();
   bool average = command_line->HasSwitch("a");
+  bool use_cpp_parser = command_line->HasSwitch("cpp");
   int iterations = 1;
   std::string iterations_str = command_line->GetSwitchValueASCII("n");
   if (!iterations_str.empty()) {
@@ -64,7 +70,22 @@ int main(int argc, char* argv[]) {
     std::string error_message;
     for (int i = 0; i < iterations; ++i) {
       auto start = base::ThreadTicks::Now();
-      auto v = base::JSONReader::ReadAndReturnValueWithError(src);
+      base::JSONReader::Result v;
+      if (use_cpp_parser) {
+        base::internal::JSONParser parser(base::JSON_PARSE_CHROMIUM_EXTENSIONS);
+        std::optional<base::Value> value = parser.Parse(src);
+        if (value) {
+          v = std::move(*value);
+        } else {
+          v = base::unexpected(base::JSONReader::Error{
+              .message = parser.GetErrorMessage(),
+              .line = parser.error_line(),
+              .column = parser.error_column(),
+          });
+        }
+      } else {
+        v = base::JSONReader::ReadAndReturnValueWithError(src);
+      }
       auto end = base::ThreadTicks::Now();
       int64_t iteration_time = (end - start).InMicroseconds();
       total_time += iteration_time;
@@ -4,13 +4,19 @@
 
 #include "base/json/json_reader.h"
 
+#include <atomic>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "base/features.h"
+#include "base/functional/bind.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/ranges/algorithm.h"
 #include "base/rust_buildflags.h"
+#include "base/task/post_job.h"
+#include "base/task/task_traits.h"
 
 #if BUILDFLAG(BUILD_RUST_JSON_READER)
 #include "base/strings/string_piece_rust.h"
@@ -134,6 +140,248 @@ JSONReader::Result DecodeJSONInRust(std::string_view json,
 
 #endif  // BUILDFLAG(BUILD_RUST_JSON_READER)
 
+namespace {
+
+// Items are grouped into chunks of about this many bytes of input, which are
+// the unit of work for ReadListInParallel().
+constexpr size_t kParallelChunkSize = 64 * 1024;
+
+// Advances |*pos| past any whitespace and, if |allow_comments|, comments.
+// Returns false if |json| has an unterminated comment or a '/' that does not
+// start a comment.
+bool SkipWhitespaceAndComments(std::string_view json,
+                               bool allow_comments,
+                               size_t* pos) {
+  while (*pos < json.size()) {
+    switch (json[*pos]) {
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+        ++*pos;
+        break;
+      case '/': {
+        if (!allow_comments || *pos + 1 == json.size()) {
+          return false;
+        }
+        size_t end;
+        if (json[*pos + 1] == '/') {
+          end = json.find_first_of("\r\n", *pos + 2);
+          *pos = end == std::string_view::npos ? json.size() : end;
+        } else if (json[*pos + 1] == '*') {
+          end = json.find("*/", *pos + 2);
+          if (end == std::string_view::npos) {
+            return false;
+          }
+          *pos = end + 2;
+        } else {
+          return false;
+        }
+        break;
+      }
+      default:
+        return true;
+    }
+  }
+  return true;
+}
+
+// Splits |json|, which must be a list, into the source text of its items by
+// tracking string, comment and nesting boundaries, without validating the
+// items themselves. Returns false if |json| is not a list, or is one that
+// this quick scan cannot split, such as one with a trailing comma or a
+// syntax error at the top level.
+bool SplitListItems(std::string_view json,
+                    int options,
+                    std::vector<std::string_view>* items) {
+  const bool allow_comments = options & JSON_ALLOW_COMMENTS;
+  size_t pos = 0;
+  if (json.starts_with("\xEF\xBB\xBF")) {
+    pos = 3;
+  }
+  if (!SkipWhitespaceAndComments(json, allow_comments, &pos) ||
+      pos == json.size() || json[pos] != '[') {
+    return false;
+  }
+
+  size_t item_start = ++pos;
+  size_t depth = 0;
+  while (true) {
+    pos = json.find_first_of("\"/[]{},", pos);
+    if (pos == std::string_view::npos) {
+      return false;
+    }
+    const char c = json[pos];
+    if (c == '"') {
+      // Find the closing quote, skipping escaped characters.
+      for (++pos; pos < json.size() && json[pos] != '"'; ++pos) {
+        if (json[pos] == '\\') {
+          ++pos;
+        }
+      }
+      if (pos >= json.size()) {
+        return false;
+      }
+      ++pos;
+    } else if (c == '/') {
+      if (!SkipWhitespaceAndComments(json, allow_comments, &pos)) {
+        return false;
+      }
+    } else if (c == '[' || c == '{') {
+      ++depth;
+      ++pos;
+    } else if (c == ']' || c == '}') {
+      if (depth == 0) {
+        break;
+      }
+      --depth;
+      ++pos;
+    } else {
+      if (depth == 0) {
+        items->push_back(json.substr(item_start, pos - item_start));
+        item_start = pos + 1;
+      }
+      ++pos;
+    }
+  }
+
+  if (json[pos] != ']') {
+    return false;
+  }
+  std::string_view last_item = json.substr(item_start, pos - item_start);
+  ++pos;
+  if (!SkipWhitespaceAndComments(json, allow_comments, &pos) ||
+      pos != json.size()) {
+    return false;
+  }
+
+  // Empty items, as in "[1,,2]" or with a trailing comma, are left to
+  // JSONParser to accept or report. The exception is an empty list.
+  size_t blank_pos = 0;
+  const bool last_item_is_blank =
+      SkipWhitespaceAndComments(last_item, allow_comments, &blank_pos) &&
+      blank_pos == last_item.size();
+  if (last_item_is_blank && items->empty()) {
+    return true;
+  }
+  items->push_back(last_item);
+  return ranges::none_of(*items, [&](std::string_view item) {
+    size_t item_pos = 0;
+    // A BOM is only allowed at the start of the whole input.
+    return !SkipWhitespaceAndComments(item, allow_comments, &item_pos) ||
+           item_pos == item.size() || item.substr(item_pos).starts_with("\xEF");
+  });
+}
+
+// Parses the items of a list in chunks, on as many threads as the Job
+// system provides.
+class ParallelListParser {
+ public:
+  ParallelListParser(std::vector<std::string_view> items,
+                     int options,
+                     size_t max_depth)
+      : items_(std::move(items)), options_(options), max_depth_(max_depth) {
+    size_t chunk_bytes = 0;
+    chunk_starts_.push_back(0);
+    for (size_t i = 0; i < items_.size(); ++i) {
+      chunk_bytes += items_[i].size();
+      if (chunk_bytes >= kParallelChunkSize && i + 1 < items_.size()) {
+        chunk_starts_.push_back(i + 1);
+        chunk_bytes = 0;
+      }
+    }
+    chunk_starts_.push_back(items_.size());
+    results_.resize(items_.size());
+    remaining_chunks_ = num_chunks();
+  }
+
+  ParallelListParser(const ParallelListParser&) = delete;
+  ParallelListParser& operator=(const ParallelListParser&) = delete;
+
+  ~ParallelListParser() = default;
+
+  // Returns the parsed list, or std::nullopt if any item failed to parse.
+  std::optional<Value::List> Parse() {
+    if (num_chunks() == 1) {
+      ParseChunk(0);
+    } else {
+      // BEST_EFFORT is the lowest priority; Join() raises it to that of the
+      // current thread.
+      CreateJob(FROM_HERE, {TaskPriority::BEST_EFFORT},
+                BindRepeating(&ParallelListParser::Run, Unretained(this)),
+                BindRepeating(&ParallelListParser::GetMaxConcurrency,
+                              Unretained(this)))
+          .Join();
+    }
+    if (failed_.load(std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+
+    Value::List list;
+    list.reserve(results_.size());
+    for (Value& value : results_) {
+      list.Append(std::move(value));
+    }
+    return list;
+  }
+
+ private:
+  size_t num_chunks() const { return chunk_starts_.size() - 1; }
+
+  void Run(JobDelegate* delegate) {
+    while (!delegate->ShouldYield()) {
+      const size_t chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= num_chunks()) {
+        return;
+      }
+      ParseChunk(chunk);
+      remaining_chunks_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  size_t GetMaxConcurrency(size_t worker_count) const {
+    if (failed_.load(std::memory_order_relaxed)) {
+      return 0;
+    }
+    return remaining_chunks_.load(std::memory_order_relaxed);
+  }
+
+  void ParseChunk(size_t chunk) {
+    // The items are nested inside the list, so each has one less level of
+    // depth available.
+    internal::JSONParser parser(options_, max_depth_ - 1);
+    for (size_t i = chunk_starts_[chunk]; i < chunk_starts_[chunk + 1]; ++i) {
+      if (failed_.load(std::memory_order_relaxed)) {
+        return;
+      }
+      std::optional<Value> value = parser.Parse(items_[i]);
+      if (!value) {
+        failed_.store(true, std::memory_order_relaxed);
+        return;
+      }
+      results_[i] = std::move(*value);
+    }
+  }
+
+  const std::vector<std::string_view> items_;
+  const int options_;
+  const size_t max_depth_;
+
+  // Index into |items_| of the first item of each chunk, followed by
+  // items_.size().
+  std::vector<size_t> chunk_starts_;
+
+  // The parsed items. Each element is written by exactly one worker, and
+  // read once the Job has been joined.
+  std::vector<Value> results_;
+
+  std::atomic<size_t> next_chunk_ = 0;
+  std::atomic<size_t> remaining_chunks_ = 0;
+  std::atomic<bool> failed_ = false;
+};
+
+}  // namespace
+
 // static
 std::optional<Value> JSONReader::Read(std::string_view json,
                                       int options,
@@ -167,6 +415,30 @@ std::optional<Value::Dict> JSONReader::ReadDict(std::string_view json,
   return std::move(*value).TakeDict();
 }
 
+// static
+std::optional<Value::List> JSONReader::ReadListInParallel(
+    std::string_view json,
+    int options,
+    size_t max_depth) {
+  std::vector<std::string_view> items;
+  if (max_depth > 1 && SplitListItems(json, options, &items)) {
+    std::optional<Value::List> list =
+        ParallelListParser(std::move(items), options, max_depth).Parse();
+    if (list) {
+      return list;
+    }
+  }
+
+  // Let the sequential parser accept or reject anything the quick scan could
+  // not split, or in which an item failed to parse, so that the result is
+  // always the same as Read()'s.
+  std::optional<Value> value = Read(json, options, max_depth);
+  if (!value || !value->is_list()) {
+    return std::nullopt;
+  }
+  return std::move(*value).TakeList();
+}
+
 // static
 JSONReader::Result JSONReader::ReadAndReturnValueWithError(
     std::string_view json,
@@ -203,6 +475,14 @@ JSONReader::Result JSONReader::ReadAndReturnValueWithError(
 #endif  // BUILDFLAG(BUILD_RUST_JSON_READER)
 }
 
+// static
+std::optional<JSONDocument> JSONReader::ReadDocument(std::string_view json,
+                                                     int options,
+                                                     size_t max_depth) {
+  internal::JSONParser parser(options, max_depth);
+  return parser.ParseDocument(json);
+}
+
 // static
 bool JSONReader::UsingRust() {
   // If features have not yet been enabled, we cannot check the feature, so fall
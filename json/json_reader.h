@@ -41,7 +41,9 @@
 #include <string_view>
 
 #include "base/base_export.h"
+#include "base/compiler_specific.h"
 #include "base/json/json_common.h"
+#include "base/json/json_document.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/types/expected.h"
 #include "base/values.h"
@@ -123,6 +125,23 @@ class BASE_EXPORT JSONReader {
       int options = JSON_PARSE_CHROMIUM_EXTENSIONS,
       size_t max_depth = internal::kAbsoluteMaxDepth);
 
+  // Reads and parses |json|, which must be a list, like ReadDict() does for
+  // dicts, but parses the list's items concurrently on the ThreadPool. This is
+  // much faster for large lists of independent items, such as a list of
+  // records.
+  //
+  // The items are first found with a quick scan of the top level of the list,
+  // then the C++ parser parses them in chunks of roughly equal size in a Job
+  // (see base/task/post_job.h), and finally the results are moved into a
+  // single list. If the scan cannot split |json|, or any item is invalid,
+  // |json| is parsed again by Read(), so the result is always the same as
+  // Read()'s. This blocks until parsing is complete, contributing to the Job
+  // on the calling thread, and requires a ThreadPoolInstance.
+  static std::optional<Value::List> ReadListInParallel(
+      std::string_view json,
+      int options = JSON_PARSE_CHROMIUM_EXTENSIONS,
+      size_t max_depth = internal::kAbsoluteMaxDepth);
+
   // Reads and parses |json| like Read(). On success returns a Value as the
   // expected value. Otherwise, it returns an Error instance, populated with a
   // formatted error message, an error code, and the error location if
@@ -131,6 +150,16 @@ class BASE_EXPORT JSONReader {
       std::string_view json,
       int options = JSON_PARSE_CHROMIUM_EXTENSIONS);
 
+  // Reads and parses |json| into a read-only JSONDocument, which avoids
+  // copying strings that contain no escape sequences. |json| must outlive the
+  // returned document. Returns std::nullopt if |json| is not a properly formed
+  // JSON string. This always uses the C++ parser, since borrowing strings from
+  // the input is not possible across the Rust boundary.
+  static std::optional<JSONDocument> ReadDocument(
+      std::string_view json LIFETIME_BOUND,
+      int options = JSON_PARSE_CHROMIUM_EXTENSIONS,
+      size_t max_depth = internal::kAbsoluteMaxDepth);
+
   // Determine whether the Rust parser is in use.
   static bool UsingRust();
 };
@@ -18,6 +18,7 @@
 #include "base/base_paths.h"
 #include "base/features.h"
 #include "base/files/file_util.h"
+#include "base/json/json_writer.h"
 #include "base/logging.h"
 #include "base/path_service.h"
 #include "base/rust_buildflags.h"
@@ -26,6 +27,7 @@
 #include "base/test/gmock_expected_support.h"
 #include "base/test/metrics/histogram_tester.h"
 #include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -1193,6 +1195,66 @@ TEST_P(JSONReaderTest, UsingRust) {
   ASSERT_EQ(JSONReader::UsingRust(), using_rust_);
 }
 
+TEST(JSONReaderParallelTest, MatchesRead) {
+  const char* const kInputs[] = {
+      "[]",
+      " [ ] ",
+      "[1]",
+      "\xEF\xBB\xBF[1, 2.5, true, null, \"x\"]",
+      "[\"a,]\\\"}\", [2, [3]], {\"b\": \"}\", \"c\": [{}]}]",
+      "[1, // comment, ]\n 2 /* , ] */, 3] // trailing",
+  };
+  for (const char* input : kInputs) {
+    SCOPED_TRACE(input);
+    std::optional<Value> expected = JSONReader::Read(input);
+    ASSERT_TRUE(expected);
+    EXPECT_EQ(expected->GetList(), JSONReader::ReadListInParallel(input));
+  }
+}
+
+TEST(JSONReaderParallelTest, FallsBackToRead) {
+  // These cannot be split, or have an item that fails to parse on its own,
+  // so they are handed to Read().
+  EXPECT_EQ(
+      Value::List().Append(1).Append(2),
+      JSONReader::ReadListInParallel("[1, 2,]", JSON_ALLOW_TRAILING_COMMAS));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("[1, 2,]", JSON_PARSE_RFC));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("[1,,2]"));
+  EXPECT_FALSE(
+      JSONReader::ReadListInParallel("[1, /* c */ 2]", JSON_PARSE_RFC));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("[1, \xEF\xBB\xBF2]"));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("[{]}"));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("[1] 2"));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("[\"unterminated]"));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("{\"not\": \"a list\"}"));
+  EXPECT_FALSE(JSONReader::ReadListInParallel(""));
+}
+
+TEST(JSONReaderParallelTest, MaxDepth) {
+  EXPECT_TRUE(JSONReader::ReadListInParallel("[[1]]", JSON_PARSE_RFC, 3));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("[[[1]]]", JSON_PARSE_RFC, 3));
+  EXPECT_FALSE(JSONReader::ReadListInParallel("[1]", JSON_PARSE_RFC, 1));
+}
+
+TEST(JSONReaderParallelTest, LargeList) {
+  test::TaskEnvironment task_environment;
+  Value::List expected;
+  for (int i = 0; i < 50000; ++i) {
+    expected.Append(Value::Dict()
+                        .Set("id", i)
+                        .Set("name", "item " + NumberToString(i))
+                        .Set("tags", Value::List().Append("a,b").Append("]")));
+  }
+  std::string json;
+  ASSERT_TRUE(JSONWriter::Write(expected, &json));
+
+  EXPECT_EQ(expected, JSONReader::ReadListInParallel(json));
+
+  // An error in any chunk fails the whole list.
+  json.insert(json.size() - 1, ", [1 2]");
+  EXPECT_FALSE(JSONReader::ReadListInParallel(json));
+}
+
 INSTANTIATE_TEST_SUITE_P(All,
                          JSONReaderTest,
 #if BUILDFLAG(BUILD_RUST_JSON_READER)
@@ -0,0 +1,399 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_stream_parser.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/json/json_parser.h"
+#include "base/notreached.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+
+namespace base {
+
+namespace {
+
+constexpr std::string_view kByteOrderMark = "\xEF\xBB\xBF";
+
+bool IsNumberChar(char c) {
+  return IsAsciiDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' ||
+         c == 'E';
+}
+
+}  // namespace
+
+JSONStreamParser::JSONStreamParser(Delegate* delegate,
+                                   int options,
+                                   size_t max_depth)
+    : delegate_(delegate), options_(options), max_depth_(max_depth) {
+  CHECK(delegate_);
+  CHECK_LE(max_depth, internal::kAbsoluteMaxDepth);
+}
+
+JSONStreamParser::~JSONStreamParser() = default;
+
+bool JSONStreamParser::Write(std::string_view chunk) {
+  CHECK(!finished_);
+  if (state_ == State::kStopped) {
+    return false;
+  }
+
+  if (buffer_.empty()) {
+    // Common case: parse straight out of |chunk| and only keep the tail.
+    const size_t consumed = Process(chunk);
+    input_offset_ += consumed;
+    buffer_.assign(chunk.substr(consumed));
+  } else {
+    buffer_.append(chunk);
+    const size_t consumed = Process(buffer_);
+    input_offset_ += consumed;
+    buffer_.erase(0, consumed);
+  }
+  return state_ != State::kStopped;
+}
+
+bool JSONStreamParser::Finish() {
+  CHECK(!finished_);
+  finished_ = true;
+  if (state_ == State::kStopped) {
+    return false;
+  }
+
+  const size_t consumed = Process(buffer_);
+  if (state_ == State::kStopped) {
+    return false;
+  }
+  DCHECK_EQ(consumed, buffer_.size());
+
+  if (state_ != State::kDone) {
+    // Mirror the errors JSONParser reports on a premature end of input.
+    const bool expecting_value = state_ == State::kValue ||
+                                 state_ == State::kListFirstValueOrEnd ||
+                                 state_ == State::kListValueAfterComma;
+    ReportError(expecting_value ? internal::JSONParser::kUnexpectedToken
+                                : internal::JSONParser::kSyntaxError,
+                consumed);
+    return false;
+  }
+  return true;
+}
+
+size_t JSONStreamParser::Process(std::string_view input) {
+  size_t pos = 0;
+
+  if (!checked_bom_) {
+    if (input.size() < kByteOrderMark.size() &&
+        kByteOrderMark.starts_with(input) && !finished_) {
+      return 0;
+    }
+    checked_bom_ = true;
+    if (input.starts_with(kByteOrderMark)) {
+      Advance(input, &pos, kByteOrderMark.size());
+    }
+  }
+
+  while (state_ != State::kStopped) {
+    if (SkipWhitespaceAndComments(input, &pos) != Step::kContinue ||
+        pos == input.size()) {
+      break;
+    }
+    if (ProcessToken(input, &pos) != Step::kContinue) {
+      break;
+    }
+  }
+  return pos;
+}
+
+JSONStreamParser::Step JSONStreamParser::ProcessToken(std::string_view input,
+                                                      size_t* pos) {
+  const char c = input[*pos];
+  switch (state_) {
+    case State::kValue:
+      return ConsumeValue(input, pos);
+
+    case State::kListValueAfterComma:
+      if (c == ']' && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        return ReportError(internal::JSONParser::kTrailingComma, *pos);
+      }
+      [[fallthrough]];
+    case State::kListFirstValueOrEnd:
+      if (c == ']') {
+        Advance(input, pos, 1);
+        containers_.pop_back();
+        OnValueComplete();
+        return HandleDelegateResult(delegate_->OnListEnd());
+      }
+      return ConsumeValue(input, pos);
+
+    case State::kListSeparatorOrEnd:
+      if (c == ',') {
+        Advance(input, pos, 1);
+        state_ = State::kListValueAfterComma;
+        return Step::kContinue;
+      }
+      if (c == ']') {
+        Advance(input, pos, 1);
+        containers_.pop_back();
+        OnValueComplete();
+        return HandleDelegateResult(delegate_->OnListEnd());
+      }
+      return ReportError(internal::JSONParser::kSyntaxError, *pos);
+
+    case State::kDictKeyAfterComma:
+      if (c == '}' && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        return ReportError(internal::JSONParser::kTrailingComma, *pos);
+      }
+      [[fallthrough]];
+    case State::kDictFirstKeyOrEnd: {
+      if (c == '}') {
+        Advance(input, pos, 1);
+        containers_.pop_back();
+        OnValueComplete();
+        return HandleDelegateResult(delegate_->OnDictEnd());
+      }
+      if (c != '"') {
+        return ReportError(internal::JSONParser::kUnquotedDictionaryKey, *pos);
+      }
+      std::optional<Value> key;
+      Step step = ConsumeScalar(input, pos, &key);
+      if (step != Step::kContinue) {
+        return step;
+      }
+      state_ = State::kDictPairSeparator;
+      return HandleDelegateResult(delegate_->OnDictKey(key->GetString()));
+    }
+
+    case State::kDictPairSeparator:
+      if (c != ':') {
+        return ReportError(internal::JSONParser::kSyntaxError, *pos);
+      }
+      Advance(input, pos, 1);
+      state_ = State::kValue;
+      return Step::kContinue;
+
+    case State::kDictSeparatorOrEnd:
+      if (c == ',') {
+        Advance(input, pos, 1);
+        state_ = State::kDictKeyAfterComma;
+        return Step::kContinue;
+      }
+      if (c == '}') {
+        Advance(input, pos, 1);
+        containers_.pop_back();
+        OnValueComplete();
+        return HandleDelegateResult(delegate_->OnDictEnd());
+      }
+      return ReportError(internal::JSONParser::kSyntaxError, *pos);
+
+    case State::kDone:
+      return ReportError(internal::JSONParser::kUnexpectedDataAfterRoot, *pos);
+
+    case State::kStopped:
+      break;
+  }
+  NOTREACHED_NORETURN();
+}
+
+JSONStreamParser::Step JSONStreamParser::SkipWhitespaceAndComments(
+    std::string_view input,
+    size_t* pos) {
+  while (*pos < input.size()) {
+    const char c = input[*pos];
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      Advance(input, pos, 1);
+      continue;
+    }
+    if (c != '/') {
+      return Step::kContinue;
+    }
+
+    if (*pos + 1 == input.size()) {
+      // Can't tell whether this is a comment yet.
+      return finished_
+                 ? ReportError(internal::JSONParser::kUnexpectedToken, *pos)
+                 : Step::kNeedMoreInput;
+    }
+    const char next = input[*pos + 1];
+    if ((next != '/' && next != '*') || !(options_ & JSON_ALLOW_COMMENTS)) {
+      return ReportError(internal::JSONParser::kUnexpectedToken, *pos);
+    }
+
+    // Comments are only consumed once they are complete, so that an
+    // unterminated one is retried when more input arrives.
+    size_t end;
+    if (next == '/') {
+      end = input.find_first_of("\r\n", *pos + 2);
+      if (end == std::string_view::npos) {
+        if (!finished_) {
+          return Step::kNeedMoreInput;
+        }
+        end = input.size();
+      }
+    } else {
+      end = input.find("*/", *pos + 2);
+      if (end == std::string_view::npos) {
+        if (!finished_) {
+          return Step::kNeedMoreInput;
+        }
+        // Match JSONParser, which treats an unterminated block comment as the
+        // end of input.
+        end = input.size();
+      } else {
+        end += 2;
+      }
+    }
+    Advance(input, pos, end - *pos);
+  }
+  return Step::kContinue;
+}
+
+JSONStreamParser::Step JSONStreamParser::ConsumeValue(std::string_view input,
+                                                      size_t* pos) {
+  const char c = input[*pos];
+  if (c == '{' || c == '[') {
+    // JSONParser counts the container being opened towards the depth.
+    if (containers_.size() + 1 >= max_depth_) {
+      return ReportError(internal::JSONParser::kTooMuchNesting, *pos);
+    }
+    Advance(input, pos, 1);
+    const bool is_dict = c == '{';
+    containers_.push_back(is_dict);
+    state_ = is_dict ? State::kDictFirstKeyOrEnd : State::kListFirstValueOrEnd;
+    return HandleDelegateResult(is_dict ? delegate_->OnDictStart()
+                                        : delegate_->OnListStart());
+  }
+
+  if (c != '"' && c != '-' && !IsAsciiDigit(c) && c != 't' && c != 'f' &&
+      c != 'n') {
+    return ReportError(internal::JSONParser::kUnexpectedToken, *pos);
+  }
+
+  std::optional<Value> value;
+  Step step = ConsumeScalar(input, pos, &value);
+  if (step != Step::kContinue) {
+    return step;
+  }
+  OnValueComplete();
+  return HandleDelegateResult(delegate_->OnValue(std::move(*value)));
+}
+
+JSONStreamParser::Step JSONStreamParser::ConsumeScalar(
+    std::string_view input,
+    size_t* pos,
+    std::optional<Value>* out) {
+  const size_t start = *pos;
+  size_t end = start + 1;
+  if (input[start] == '"') {
+    // Find the closing quote, skipping over escaped characters. Resume where
+    // the previous attempt stopped so that long strings split across many
+    // chunks are scanned only once.
+    end = start + std::max<size_t>(1, string_scan_offset_);
+    while (end < input.size() && input[end] != '"') {
+      end += input[end] == '\\' ? 2 : 1;
+    }
+    if (end >= input.size()) {
+      if (!finished_) {
+        string_scan_offset_ = end - start;
+        return Step::kNeedMoreInput;
+      }
+      // Let JSONParser report the unterminated string.
+      end = input.size();
+    } else {
+      ++end;  // Include the closing quote.
+    }
+  } else {
+    // Numbers and literals have no terminator, so they are only complete once
+    // a following character (or the end of input) is seen.
+    const bool is_number = input[start] == '-' || IsAsciiDigit(input[start]);
+    while (end < input.size() &&
+           (is_number ? IsNumberChar(input[end]) : IsAsciiAlpha(input[end]))) {
+      ++end;
+    }
+    if (end == input.size() && !finished_) {
+      return Step::kNeedMoreInput;
+    }
+  }
+
+  string_scan_offset_ = 0;
+  const std::string_view token = input.substr(start, end - start);
+  internal::JSONParser parser(options_);
+  *out = parser.Parse(token);
+  if (!*out) {
+    // Translate the error location within |token| to the whole input. Columns
+    // on the first line of the token are relative to its first byte.
+    int line = line_number_ + parser.error_line() - 1;
+    int column = parser.error_column();
+    if (parser.error_line() <= 1) {
+      column += static_cast<int>(input_offset_ + start - index_last_line_) - 1;
+    }
+    return SetError(parser.GetErrorDescription(), line, column);
+  }
+  Advance(input, pos, token.size());
+  return Step::kContinue;
+}
+
+void JSONStreamParser::OnValueComplete() {
+  if (containers_.empty()) {
+    state_ = State::kDone;
+  } else if (containers_.back()) {
+    state_ = State::kDictSeparatorOrEnd;
+  } else {
+    state_ = State::kListSeparatorOrEnd;
+  }
+}
+
+void JSONStreamParser::Advance(std::string_view input,
+                               size_t* pos,
+                               size_t count) {
+  DCHECK_LE(*pos + count, input.size());
+  for (size_t i = *pos; i < *pos + count; ++i) {
+    const char c = input[i];
+    if (c == '\r' || c == '\n') {
+      index_last_line_ = input_offset_ + i;
+      // Don't increment the line number twice for "\r\n".
+      if (!(c == '\n' && last_char_ == '\r')) {
+        ++line_number_;
+      }
+    }
+    last_char_ = c;
+  }
+  *pos += count;
+}
+
+JSONStreamParser::Step JSONStreamParser::ReportError(
+    std::string_view description,
+    size_t pos) {
+  return SetError(description, line_number_,
+                  static_cast<int>(input_offset_ + pos - index_last_line_));
+}
+
+JSONStreamParser::Step JSONStreamParser::SetError(std::string_view description,
+                                                  int line,
+                                                  int column) {
+  JSONReader::Error error;
+  error.line = line;
+  error.column = std::max(column, 1);
+  error.message = StringPrintf("Line: %i, column: %i, %.*s", error.line,
+                               error.column,
+                               static_cast<int>(description.size()),
+                               description.data());
+  error_ = std::move(error);
+  state_ = State::kStopped;
+  return Step::kStop;
+}
+
+JSONStreamParser::Step JSONStreamParser::HandleDelegateResult(
+    bool keep_going) {
+  if (!keep_going) {
+    state_ = State::kStopped;
+    return Step::kStop;
+  }
+  return Step::kContinue;
+}
+
+}  // namespace base
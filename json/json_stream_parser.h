@@ -0,0 +1,205 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_JSON_JSON_STREAM_PARSER_H_
+#define BASE_JSON_JSON_STREAM_PARSER_H_
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/json/json_common.h"
+#include "base/json/json_reader.h"
+#include "base/memory/raw_ptr.h"
+#include "base/values.h"
+
+namespace base {
+
+// An event-based (SAX-style) JSON parser that reports the structure of a
+// document to a Delegate without building a base::Value tree. Input can be
+// supplied in arbitrarily split chunks, e.g. straight from a socket or a File
+// read loop; only the bytes of a token that straddles two chunks are buffered.
+//
+// The accepted syntax, the JSONParserOptions and |max_depth| behave as for
+// JSONReader::Read(). Scalar tokens are decoded by the same JSONParser code as
+// JSONReader, so escapes, invalid characters and numbers are handled
+// identically.
+//
+// Example, summing the "size" of every top-level object in a huge array:
+//
+//   class SizeSummer : public JSONStreamParser::Delegate {
+//    public:
+//     bool OnDictStart() override { ++depth_; return true; }
+//     bool OnDictEnd() override { --depth_; return true; }
+//     bool OnDictKey(std::string_view key) override {
+//       is_size_ = depth_ == 1 && key == "size";
+//       return true;
+//     }
+//     bool OnValue(Value value) override {
+//       if (is_size_ && value.is_int()) total_ += value.GetInt();
+//       return true;
+//     }
+//     ...
+//   };
+//
+//   SizeSummer summer;
+//   JSONStreamParser parser(&summer);
+//   while (ReadNextChunk(&chunk)) {
+//     if (!parser.Write(chunk)) break;
+//   }
+//   if (!parser.Finish()) LOG(ERROR) << parser.error()->message;
+class BASE_EXPORT JSONStreamParser {
+ public:
+  // Receives parse events in document order. Each method returns whether
+  // parsing should continue; returning false stops the parser, e.g. once the
+  // values of interest have been seen. The delegate must not call back into
+  // the JSONStreamParser.
+  class BASE_EXPORT Delegate {
+   public:
+    virtual ~Delegate() = default;
+
+    virtual bool OnDictStart() = 0;
+    // Called for each key of the current dictionary, before its value.
+    virtual bool OnDictKey(std::string_view key) = 0;
+    virtual bool OnDictEnd() = 0;
+    virtual bool OnListStart() = 0;
+    virtual bool OnListEnd() = 0;
+    // Called for every scalar: none, bool, int, double and string values.
+    virtual bool OnValue(Value value) = 0;
+  };
+
+  // |delegate| must outlive this object.
+  explicit JSONStreamParser(Delegate* delegate,
+                            int options = JSON_PARSE_CHROMIUM_EXTENSIONS,
+                            size_t max_depth = internal::kAbsoluteMaxDepth);
+
+  JSONStreamParser(const JSONStreamParser&) = delete;
+  JSONStreamParser& operator=(const JSONStreamParser&) = delete;
+
+  ~JSONStreamParser();
+
+  // Parses the next chunk of input, reporting every complete token to the
+  // delegate. Returns false if the input is malformed, in which case error()
+  // is set, or if the delegate stopped parsing. Must not be called after
+  // Finish().
+  bool Write(std::string_view chunk);
+
+  // Signals the end of input and reports any final token. Returns true if the
+  // input was a single complete JSON value, and false otherwise (see Write()).
+  bool Finish();
+
+  // Returns the parse error, if any. Line and column numbers refer to the
+  // concatenation of all chunks.
+  const std::optional<JSONReader::Error>& error() const { return error_; }
+
+ private:
+  enum class State {
+    // Expecting a value: at the root, after ':' or after ',' in a list.
+    kValue,
+    // After '[': expecting a value or ']'.
+    kListFirstValueOrEnd,
+    // After a list item: expecting ',' or ']'.
+    kListSeparatorOrEnd,
+    // After ',' in a list: expecting a value, or ']' if trailing commas are
+    // allowed.
+    kListValueAfterComma,
+    // After '{': expecting a key or '}'.
+    kDictFirstKeyOrEnd,
+    // After ',' in a dictionary: expecting a key, or '}' if trailing commas
+    // are allowed.
+    kDictKeyAfterComma,
+    // After a key: expecting ':'.
+    kDictPairSeparator,
+    // After a dictionary value: expecting ',' or '}'.
+    kDictSeparatorOrEnd,
+    // The root value is complete; only whitespace and comments may follow.
+    kDone,
+    // Parsing failed or was stopped by the delegate.
+    kStopped,
+  };
+
+  enum class Step {
+    // A token was consumed; keep going.
+    kContinue,
+    // The rest of the input is an incomplete token.
+    kNeedMoreInput,
+    // State is now kStopped.
+    kStop,
+  };
+
+  // Consumes as much of |input| as possible and returns the number of bytes
+  // consumed. Any remainder is the beginning of an incomplete token.
+  size_t Process(std::string_view input);
+
+  // Handles the token that starts at |*pos|, advancing past it.
+  Step ProcessToken(std::string_view input, size_t* pos);
+
+  // Skips whitespace and, if allowed, comments.
+  Step SkipWhitespaceAndComments(std::string_view input, size_t* pos);
+
+  // Handles the start of a value at |*pos|.
+  Step ConsumeValue(std::string_view input, size_t* pos);
+
+  // Finds the end of the scalar token starting at |pos|, decodes it with
+  // JSONParser and advances past it.
+  Step ConsumeScalar(std::string_view input,
+                     size_t* pos,
+                     std::optional<Value>* out);
+
+  // Updates the state once a value has been completed.
+  void OnValueComplete();
+
+  // Moves |*pos| forward by |count| bytes, keeping track of line breaks.
+  void Advance(std::string_view input, size_t* pos, size_t count);
+
+  // Records an error at |pos|, which is an offset in the current input.
+  Step ReportError(std::string_view description, size_t pos);
+
+  // Records an error at the given location and stops parsing.
+  Step SetError(std::string_view description, int line, int column);
+
+  // Stops parsing if |keep_going| is false.
+  Step HandleDelegateResult(bool keep_going);
+
+  const raw_ptr<Delegate> delegate_;
+  const int options_;
+  const size_t max_depth_;
+
+  State state_ = State::kValue;
+
+  // Whether each open container is a dictionary (true) or a list (false).
+  std::vector<bool> containers_;
+
+  // The unconsumed tail of previous chunks.
+  std::string buffer_;
+
+  // How far the scan for the end of an incomplete string token at the start
+  // of |buffer_| has progressed.
+  size_t string_scan_offset_ = 0;
+
+  // Whether Finish() has been called.
+  bool finished_ = false;
+
+  // Whether a potential byte-order mark at the start of input was handled.
+  bool checked_bom_ = false;
+
+  // Absolute offset of the first byte of the input being processed.
+  size_t input_offset_ = 0;
+
+  // Line tracking, in the same terms as JSONParser: |index_last_line_| is the
+  // absolute offset of the last '\r' or '\n', or -1 before the first one.
+  int line_number_ = 1;
+  size_t index_last_line_ = static_cast<size_t>(-1);
+  char last_char_ = '\0';
+
+  std::optional<JSONReader::Error> error_;
+};
+
+}  // namespace base
+
+#endif  // BASE_JSON_JSON_STREAM_PARSER_H_
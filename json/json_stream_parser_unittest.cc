@@ -0,0 +1,215 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_stream_parser.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "base/json/json_parser.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Rebuilds a Value from the parse events, and counts them.
+class ValueBuildingDelegate : public JSONStreamParser::Delegate {
+ public:
+  ValueBuildingDelegate() = default;
+  ~ValueBuildingDelegate() override = default;
+
+  bool OnDictStart() override {
+    stack_.emplace_back(Value::Dict());
+    return Count();
+  }
+  bool OnDictKey(std::string_view key) override {
+    keys_.emplace_back(key);
+    return Count();
+  }
+  bool OnDictEnd() override { return Pop(); }
+  bool OnListStart() override {
+    stack_.emplace_back(Value::List());
+    return Count();
+  }
+  bool OnListEnd() override { return Pop(); }
+  bool OnValue(Value value) override {
+    Add(std::move(value));
+    return Count();
+  }
+
+  std::optional<Value>& result() { return result_; }
+  int events() const { return events_; }
+  void set_stop_after(int events) { stop_after_ = events; }
+
+ private:
+  bool Count() { return ++events_ != stop_after_; }
+
+  bool Pop() {
+    Value value = std::move(stack_.back());
+    stack_.pop_back();
+    Add(std::move(value));
+    return Count();
+  }
+
+  void Add(Value value) {
+    if (stack_.empty()) {
+      result_ = std::move(value);
+    } else if (stack_.back().is_list()) {
+      stack_.back().GetList().Append(std::move(value));
+    } else {
+      stack_.back().GetDict().Set(keys_.back(), std::move(value));
+      keys_.pop_back();
+    }
+  }
+
+  std::vector<Value> stack_;
+  std::vector<std::string> keys_;
+  std::optional<Value> result_;
+  int events_ = 0;
+  int stop_after_ = -1;
+};
+
+// Parses |json| delivered in chunks of |chunk_size| bytes.
+bool ParseInChunks(std::string_view json,
+                   size_t chunk_size,
+                   int options,
+                   ValueBuildingDelegate* delegate,
+                   std::optional<JSONReader::Error>* error = nullptr) {
+  JSONStreamParser parser(delegate, options);
+  bool ok = true;
+  for (size_t i = 0; ok && i < json.size(); i += chunk_size) {
+    ok = parser.Write(json.substr(i, chunk_size));
+  }
+  if (ok) {
+    ok = parser.Finish();
+  }
+  if (error) {
+    *error = parser.error();
+  }
+  return ok;
+}
+
+}  // namespace
+
+TEST(JSONStreamParserTest, MatchesJSONParserForAnyChunking) {
+  const char* const kInputs[] = {
+      "null",
+      "  42  ",
+      "-1.5e3",
+      "\"string\"",
+      "[]",
+      "{}",
+      "[1, 2.5, true, false, null, \"x\", [], {}]",
+      "{\"a\": {\"b\": [1, {\"c\": \"d\"}]}, \"e\": -0.25}",
+      "\xEF\xBB\xBF{\"bom\": true}",
+      "{\"esc\\u00e9\": \"line\\nbreak \\\"quoted\\\" \\\\ end\"}",
+      "[1, // comment\n 2 /* block\n comment */, 3]",
+      "{\"dup\": 1, \"dup\": 2}",
+      "[\"\xC3\xA9\xE2\x82\xAC\", 12345678901234]",
+  };
+  for (const char* input : kInputs) {
+    SCOPED_TRACE(input);
+    internal::JSONParser reference(JSON_PARSE_CHROMIUM_EXTENSIONS);
+    std::optional<Value> expected = reference.Parse(input);
+    ASSERT_TRUE(expected);
+
+    for (size_t chunk_size : {1u, 2u, 3u, 7u, 1024u}) {
+      SCOPED_TRACE(chunk_size);
+      ValueBuildingDelegate delegate;
+      EXPECT_TRUE(ParseInChunks(input, chunk_size,
+                                JSON_PARSE_CHROMIUM_EXTENSIONS, &delegate));
+      EXPECT_EQ(expected, delegate.result());
+    }
+  }
+}
+
+TEST(JSONStreamParserTest, LongStringAcrossChunks) {
+  const std::string long_string(100000, 'z');
+  std::string json;
+  JSONWriter::Write(Value(Value::List().Append(long_string)), &json);
+  ValueBuildingDelegate delegate;
+  ASSERT_TRUE(ParseInChunks(json, 13, JSON_PARSE_RFC, &delegate));
+  ASSERT_TRUE(delegate.result());
+  EXPECT_EQ(long_string, delegate.result()->GetList()[0].GetString());
+}
+
+TEST(JSONStreamParserTest, ErrorsMatchJSONParser) {
+  const char* const kInputs[] = {
+      "",
+      "[1,]",
+      "{\"a\": 1,}",
+      "{a: 1}",
+      "[1 2]",
+      "{\"a\" 1}",
+      "[1] [2]",
+      "[\n  \"abc\",\n  \"x\\qy\"\n]",
+      "[\"unterminated",
+      "[1, 2",
+      "[nul]",
+      "[/ 1]",
+      "[-]",
+      "{\"a\":\n\n   @}",
+  };
+  for (const char* input : kInputs) {
+    SCOPED_TRACE(input);
+    internal::JSONParser reference(JSON_PARSE_RFC);
+    ASSERT_FALSE(reference.Parse(input));
+
+    for (size_t chunk_size : {1u, 4u, 1024u}) {
+      SCOPED_TRACE(chunk_size);
+      ValueBuildingDelegate delegate;
+      std::optional<JSONReader::Error> error;
+      EXPECT_FALSE(
+          ParseInChunks(input, chunk_size, JSON_PARSE_RFC, &delegate, &error));
+      ASSERT_TRUE(error);
+      EXPECT_EQ(reference.GetErrorMessage(), error->message);
+      EXPECT_EQ(reference.error_line(), error->line);
+      EXPECT_EQ(reference.error_column(), error->column);
+    }
+  }
+}
+
+TEST(JSONStreamParserTest, Options) {
+  ValueBuildingDelegate delegate;
+  EXPECT_TRUE(
+      ParseInChunks("[1,]", 1, JSON_ALLOW_TRAILING_COMMAS, &delegate));
+  EXPECT_EQ(Value(Value::List().Append(1)), delegate.result());
+
+  ValueBuildingDelegate comments;
+  EXPECT_FALSE(ParseInChunks("[1 /* c */]", 1, JSON_PARSE_RFC, &comments));
+  EXPECT_TRUE(ParseInChunks("[1 /* c */]", 1, JSON_ALLOW_COMMENTS, &comments));
+}
+
+TEST(JSONStreamParserTest, MaxDepth) {
+  ValueBuildingDelegate delegate;
+  JSONStreamParser parser(&delegate, JSON_PARSE_RFC, 3);
+  EXPECT_TRUE(parser.Write("[[1]]"));
+  EXPECT_TRUE(parser.Finish());
+
+  ValueBuildingDelegate too_deep_delegate;
+  JSONStreamParser too_deep(&too_deep_delegate, JSON_PARSE_RFC, 3);
+  EXPECT_FALSE(too_deep.Write("[[[1]]]"));
+  ASSERT_TRUE(too_deep.error());
+  EXPECT_EQ(3, too_deep.error()->column);
+}
+
+TEST(JSONStreamParserTest, DelegateCanStop) {
+  ValueBuildingDelegate delegate;
+  delegate.set_stop_after(3);
+  JSONStreamParser parser(&delegate);
+  // Stops after "[", "1" and "2"; the syntax error later on is never seen.
+  EXPECT_FALSE(parser.Write("[1, 2, 3, oops"));
+  EXPECT_EQ(3, delegate.events());
+  EXPECT_FALSE(parser.error());
+  EXPECT_FALSE(parser.Finish());
+}
+
+}  // namespace base
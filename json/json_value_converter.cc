@@ -18,6 +18,15 @@ bool BasicValueConverter<int>::Convert(
   return true;
 }
 
+bool BasicValueConverter<int>::Convert(const JSONDocument::Node& node,
+                                       int* field) const {
+  if (!node.is_int())
+    return false;
+  if (field)
+    *field = node.GetInt();
+  return true;
+}
+
 bool BasicValueConverter<std::string>::Convert(
     const base::Value& value, std::string* field) const {
   if (!value.is_string())
@@ -27,6 +36,15 @@ bool BasicValueConverter<std::string>::Convert(
   return true;
 }
 
+bool BasicValueConverter<std::string>::Convert(const JSONDocument::Node& node,
+                                               std::string* field) const {
+  if (!node.is_string())
+    return false;
+  if (field)
+    *field = node.GetString();
+  return true;
+}
+
 bool BasicValueConverter<std::u16string>::Convert(const base::Value& value,
                                                   std::u16string* field) const {
   if (!value.is_string())
@@ -36,6 +54,16 @@ bool BasicValueConverter<std::u16string>::Convert(const base::Value& value,
   return true;
 }
 
+bool BasicValueConverter<std::u16string>::Convert(
+    const JSONDocument::Node& node,
+    std::u16string* field) const {
+  if (!node.is_string())
+    return false;
+  if (field)
+    *field = base::UTF8ToUTF16(node.GetString());
+  return true;
+}
+
 bool BasicValueConverter<double>::Convert(
     const base::Value& value, double* field) const {
   if (!value.is_double() && !value.is_int())
@@ -45,6 +73,15 @@ bool BasicValueConverter<double>::Convert(
   return true;
 }
 
+bool BasicValueConverter<double>::Convert(const JSONDocument::Node& node,
+                                          double* field) const {
+  if (!node.is_double() && !node.is_int())
+    return false;
+  if (field)
+    *field = node.GetDouble();
+  return true;
+}
+
 bool BasicValueConverter<bool>::Convert(
     const base::Value& value, bool* field) const {
   if (!value.is_bool())
@@ -54,6 +91,15 @@ bool BasicValueConverter<bool>::Convert(
   return true;
 }
 
+bool BasicValueConverter<bool>::Convert(const JSONDocument::Node& node,
+                                        bool* field) const {
+  if (!node.is_bool())
+    return false;
+  if (field)
+    *field = node.GetBool();
+  return true;
+}
+
 }  // namespace internal
 }  // namespace base
 
@@ -7,13 +7,19 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "base/base_export.h"
+#include "base/containers/small_vector.h"
+#include "base/json/json_document.h"
+#include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/values.h"
@@ -47,6 +53,16 @@
 //   JSONValueConverter<Message> converter;
 //   converter.Convert(json, &message);
 //
+// Convert() also accepts a JSONDocument::Node, which avoids building a
+// base::Value tree for the whole input:
+//   std::optional<JSONDocument> doc = JSONReader::ReadDocument(json_string);
+//   if (doc)
+//     converter.Convert(doc->root(), &message);
+// ConvertJSON() does both steps:
+//   converter.ConvertJSON(json_string, &message);
+// A JSONDocument is converted in a single pass over the members of each
+// dictionary, which are dispatched to the fields registered for their key.
+//
 // Convert() returns false when it fails.  Here "fail" means that the value is
 // structurally different from expected, such like a string value appears
 // for an int field.  Do not report failures for missing fields.
@@ -102,6 +118,8 @@ class FieldConverterBase {
   virtual ~FieldConverterBase() = default;
   virtual bool ConvertField(const base::Value& value,
                             StructType* obj) const = 0;
+  virtual bool ConvertField(const JSONDocument::Node& node,
+                            StructType* obj) const = 0;
   const std::string& field_path() const { return field_path_; }
 
  private:
@@ -113,6 +131,13 @@ class ValueConverter {
  public:
   virtual ~ValueConverter() = default;
   virtual bool Convert(const base::Value& value, FieldType* field) const = 0;
+
+  // By default, |node| is copied into a base::Value and converted as such.
+  // Converters that can read a JSONDocument directly override this.
+  virtual bool Convert(const JSONDocument::Node& node,
+                       FieldType* field) const {
+    return Convert(node.ToValue(), field);
+  }
 };
 
 template <typename StructType, typename FieldType>
@@ -132,6 +157,11 @@ class FieldConverter : public FieldConverterBase<StructType> {
     return value_converter_->Convert(value, &(dst->*field_pointer_));
   }
 
+  bool ConvertField(const JSONDocument::Node& node,
+                    StructType* dst) const override {
+    return value_converter_->Convert(node, &(dst->*field_pointer_));
+  }
+
  private:
   FieldType StructType::*field_pointer_;
   std::unique_ptr<ValueConverter<FieldType>> value_converter_;
@@ -149,6 +179,7 @@ class BASE_EXPORT BasicValueConverter<int> : public ValueConverter<int> {
   BasicValueConverter& operator=(const BasicValueConverter&) = delete;
 
   bool Convert(const base::Value& value, int* field) const override;
+  bool Convert(const JSONDocument::Node& node, int* field) const override;
 };
 
 template <>
@@ -161,6 +192,8 @@ class BASE_EXPORT BasicValueConverter<std::string>
   BasicValueConverter& operator=(const BasicValueConverter&) = delete;
 
   bool Convert(const base::Value& value, std::string* field) const override;
+  bool Convert(const JSONDocument::Node& node,
+               std::string* field) const override;
 };
 
 template <>
@@ -173,6 +206,8 @@ class BASE_EXPORT BasicValueConverter<std::u16string>
   BasicValueConverter& operator=(const BasicValueConverter&) = delete;
 
   bool Convert(const base::Value& value, std::u16string* field) const override;
+  bool Convert(const JSONDocument::Node& node,
+               std::u16string* field) const override;
 };
 
 template <>
@@ -184,6 +219,7 @@ class BASE_EXPORT BasicValueConverter<double> : public ValueConverter<double> {
   BasicValueConverter& operator=(const BasicValueConverter&) = delete;
 
   bool Convert(const base::Value& value, double* field) const override;
+  bool Convert(const JSONDocument::Node& node, double* field) const override;
 };
 
 template <>
@@ -195,6 +231,7 @@ class BASE_EXPORT BasicValueConverter<bool> : public ValueConverter<bool> {
   BasicValueConverter& operator=(const BasicValueConverter&) = delete;
 
   bool Convert(const base::Value& value, bool* field) const override;
+  bool Convert(const JSONDocument::Node& node, bool* field) const override;
 };
 
 template <typename FieldType>
@@ -208,6 +245,8 @@ class ValueFieldConverter : public ValueConverter<FieldType> {
   ValueFieldConverter(const ValueFieldConverter&) = delete;
   ValueFieldConverter& operator=(const ValueFieldConverter&) = delete;
 
+  using ValueConverter<FieldType>::Convert;
+
   bool Convert(const base::Value& value, FieldType* field) const override {
     return convert_func_(&value, field);
   }
@@ -231,6 +270,11 @@ class CustomFieldConverter : public ValueConverter<FieldType> {
     return value.is_string() && convert_func_(value.GetString(), field);
   }
 
+  bool Convert(const JSONDocument::Node& node,
+               FieldType* field) const override {
+    return node.is_string() && convert_func_(node.GetString(), field);
+  }
+
  private:
   ConvertFunc convert_func_;
 };
@@ -247,6 +291,11 @@ class NestedValueConverter : public ValueConverter<NestedType> {
     return converter_.Convert(value, field);
   }
 
+  bool Convert(const JSONDocument::Node& node,
+               NestedType* field) const override {
+    return converter_.Convert(node, field);
+  }
+
  private:
   JSONValueConverter<NestedType> converter_;
 };
@@ -283,6 +332,26 @@ class RepeatedValueConverter
     return true;
   }
 
+  bool Convert(const JSONDocument::Node& node,
+               std::vector<std::unique_ptr<Element>>* field) const override {
+    if (!node.is_list()) {
+      // The field is not a list.
+      return false;
+    }
+
+    field->reserve(node.size());
+    for (size_t i = 0; i < node.size(); ++i) {
+      auto e = std::make_unique<Element>();
+      if (basic_converter_.Convert(node.GetListItem(i), e.get())) {
+        field->push_back(std::move(e));
+      } else {
+        DVLOG(1) << "failure at " << i << "-th element";
+        return false;
+      }
+    }
+    return true;
+  }
+
  private:
   BasicValueConverter<Element> basic_converter_;
 };
@@ -317,6 +386,24 @@ class RepeatedMessageConverter
     return true;
   }
 
+  bool Convert(const JSONDocument::Node& node,
+               std::vector<std::unique_ptr<NestedType>>* field) const override {
+    if (!node.is_list())
+      return false;
+
+    field->reserve(node.size());
+    for (size_t i = 0; i < node.size(); ++i) {
+      auto nested = std::make_unique<NestedType>();
+      if (converter_.Convert(node.GetListItem(i), nested.get())) {
+        field->push_back(std::move(nested));
+      } else {
+        DVLOG(1) << "failure at " << i << "-th element";
+        return false;
+      }
+    }
+    return true;
+  }
+
  private:
   JSONValueConverter<NestedType> converter_;
 };
@@ -334,6 +421,8 @@ class RepeatedCustomValueConverter
   RepeatedCustomValueConverter& operator=(const RepeatedCustomValueConverter&) =
       delete;
 
+  using ValueConverter<std::vector<std::unique_ptr<NestedType>>>::Convert;
+
   bool Convert(const base::Value& value,
                std::vector<std::unique_ptr<NestedType>>* field) const override {
     const Value::List* list = value.GetIfList();
@@ -370,21 +459,20 @@ class JSONValueConverter {
   JSONValueConverter& operator=(const JSONValueConverter&) = delete;
 
   void RegisterIntField(const std::string& field_name, int StructType::*field) {
-    fields_.push_back(
-        std::make_unique<internal::FieldConverter<StructType, int>>(
-            field_name, field, new internal::BasicValueConverter<int>));
+    AddField(std::make_unique<internal::FieldConverter<StructType, int>>(
+        field_name, field, new internal::BasicValueConverter<int>));
   }
 
   void RegisterStringField(const std::string& field_name,
                            std::string StructType::*field) {
-    fields_.push_back(
+    AddField(
         std::make_unique<internal::FieldConverter<StructType, std::string>>(
             field_name, field, new internal::BasicValueConverter<std::string>));
   }
 
   void RegisterStringField(const std::string& field_name,
                            std::u16string StructType::*field) {
-    fields_.push_back(
+    AddField(
         std::make_unique<internal::FieldConverter<StructType, std::u16string>>(
             field_name, field,
             new internal::BasicValueConverter<std::u16string>));
@@ -392,34 +480,30 @@ class JSONValueConverter {
 
   void RegisterBoolField(const std::string& field_name,
                          bool StructType::*field) {
-    fields_.push_back(
-        std::make_unique<internal::FieldConverter<StructType, bool>>(
-            field_name, field, new internal::BasicValueConverter<bool>));
+    AddField(std::make_unique<internal::FieldConverter<StructType, bool>>(
+        field_name, field, new internal::BasicValueConverter<bool>));
   }
 
   void RegisterDoubleField(const std::string& field_name,
                            double StructType::*field) {
-    fields_.push_back(
-        std::make_unique<internal::FieldConverter<StructType, double>>(
-            field_name, field, new internal::BasicValueConverter<double>));
+    AddField(std::make_unique<internal::FieldConverter<StructType, double>>(
+        field_name, field, new internal::BasicValueConverter<double>));
   }
 
   template <class NestedType>
   void RegisterNestedField(const std::string& field_name,
                            NestedType StructType::*field) {
-    fields_.push_back(
-        std::make_unique<internal::FieldConverter<StructType, NestedType>>(
-            field_name, field, new internal::NestedValueConverter<NestedType>));
+    AddField(std::make_unique<internal::FieldConverter<StructType, NestedType>>(
+        field_name, field, new internal::NestedValueConverter<NestedType>));
   }
 
   template <typename FieldType>
   void RegisterCustomField(const std::string& field_name,
                            FieldType StructType::*field,
                            bool (*convert_func)(std::string_view, FieldType*)) {
-    fields_.push_back(
-        std::make_unique<internal::FieldConverter<StructType, FieldType>>(
-            field_name, field,
-            new internal::CustomFieldConverter<FieldType>(convert_func)));
+    AddField(std::make_unique<internal::FieldConverter<StructType, FieldType>>(
+        field_name, field,
+        new internal::CustomFieldConverter<FieldType>(convert_func)));
   }
 
   template <typename FieldType>
@@ -427,24 +511,23 @@ class JSONValueConverter {
                                 FieldType StructType::*field,
                                 bool (*convert_func)(const base::Value*,
                                                      FieldType*)) {
-    fields_.push_back(
-        std::make_unique<internal::FieldConverter<StructType, FieldType>>(
-            field_name, field,
-            new internal::ValueFieldConverter<FieldType>(convert_func)));
+    AddField(std::make_unique<internal::FieldConverter<StructType, FieldType>>(
+        field_name, field,
+        new internal::ValueFieldConverter<FieldType>(convert_func)));
   }
 
   void RegisterRepeatedInt(
       const std::string& field_name,
       std::vector<std::unique_ptr<int>> StructType::*field) {
-    fields_.push_back(std::make_unique<internal::FieldConverter<
-                          StructType, std::vector<std::unique_ptr<int>>>>(
+    AddField(std::make_unique<internal::FieldConverter<
+                 StructType, std::vector<std::unique_ptr<int>>>>(
         field_name, field, new internal::RepeatedValueConverter<int>));
   }
 
   void RegisterRepeatedString(
       const std::string& field_name,
       std::vector<std::unique_ptr<std::string>> StructType::*field) {
-    fields_.push_back(
+    AddField(
         std::make_unique<internal::FieldConverter<
             StructType, std::vector<std::unique_ptr<std::string>>>>(
             field_name, field,
@@ -454,7 +537,7 @@ class JSONValueConverter {
   void RegisterRepeatedString(
       const std::string& field_name,
       std::vector<std::unique_ptr<std::u16string>> StructType::*field) {
-    fields_.push_back(
+    AddField(
         std::make_unique<internal::FieldConverter<
             StructType, std::vector<std::unique_ptr<std::u16string>>>>(
             field_name, field,
@@ -464,16 +547,16 @@ class JSONValueConverter {
   void RegisterRepeatedDouble(
       const std::string& field_name,
       std::vector<std::unique_ptr<double>> StructType::*field) {
-    fields_.push_back(std::make_unique<internal::FieldConverter<
-                          StructType, std::vector<std::unique_ptr<double>>>>(
+    AddField(std::make_unique<internal::FieldConverter<
+                 StructType, std::vector<std::unique_ptr<double>>>>(
         field_name, field, new internal::RepeatedValueConverter<double>));
   }
 
   void RegisterRepeatedBool(
       const std::string& field_name,
       std::vector<std::unique_ptr<bool>> StructType::*field) {
-    fields_.push_back(std::make_unique<internal::FieldConverter<
-                          StructType, std::vector<std::unique_ptr<bool>>>>(
+    AddField(std::make_unique<internal::FieldConverter<
+                 StructType, std::vector<std::unique_ptr<bool>>>>(
         field_name, field, new internal::RepeatedValueConverter<bool>));
   }
 
@@ -482,7 +565,7 @@ class JSONValueConverter {
       const std::string& field_name,
       std::vector<std::unique_ptr<NestedType>> StructType::*field,
       bool (*convert_func)(const base::Value*, NestedType*)) {
-    fields_.push_back(
+    AddField(
         std::make_unique<internal::FieldConverter<
             StructType, std::vector<std::unique_ptr<NestedType>>>>(
             field_name, field,
@@ -494,7 +577,7 @@ class JSONValueConverter {
   void RegisterRepeatedMessage(
       const std::string& field_name,
       std::vector<std::unique_ptr<NestedType>> StructType::*field) {
-    fields_.push_back(
+    AddField(
         std::make_unique<internal::FieldConverter<
             StructType, std::vector<std::unique_ptr<NestedType>>>>(
             field_name, field,
@@ -509,6 +592,60 @@ class JSONValueConverter {
     return Convert(*dict, output);
   }
 
+  bool Convert(const JSONDocument::Node& node, StructType* output) const {
+    if (!node.is_dict())
+      return false;
+
+    // Finds the member for the first key of the path of each field, in one
+    // pass over the members. Like FindByDottedPath(), the last member with a
+    // key wins.
+    constexpr size_t kNoMember = std::numeric_limits<size_t>::max();
+    small_vector<size_t, 16> members(fields_.size(), kNoMember);
+    for (size_t i = 0; i < node.size(); ++i) {
+      const auto [begin, end] = std::equal_range(
+          field_index_.begin(), field_index_.end(),
+          FieldIndexEntry{node.GetDictKey(i), 0}, &CompareFieldIndexEntries);
+      for (auto it = begin; it != end; ++it) {
+        members[it->field] = i;
+      }
+    }
+
+    // The fields are converted in registration order, so that the same
+    // failure is reported as when converting a base::Value.
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      if (members[i] == kNoMember) {
+        continue;
+      }
+      const internal::FieldConverterBase<StructType>* field_converter =
+          fields_[i].get();
+      std::optional<JSONDocument::Node> field = node.GetDictValue(members[i]);
+      const std::string_view path = field_converter->field_path();
+      if (const size_t dot = path.find('.'); dot != std::string_view::npos) {
+        if (!field->is_dict()) {
+          continue;
+        }
+        const std::string_view rest = path.substr(dot + 1);
+        field = rest.empty() ? field->FindKey(rest)
+                             : field->FindByDottedPath(rest);
+        if (!field) {
+          continue;
+        }
+      }
+      if (!field_converter->ConvertField(*field, output)) {
+        DVLOG(1) << "failure at field " << field_converter->field_path();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Parses |json| with JSONReader::ReadDocument() and converts it. Returns
+  // false if |json| is not valid JSON, or if the conversion fails.
+  bool ConvertJSON(std::string_view json, StructType* output) const {
+    std::optional<JSONDocument> document = JSONReader::ReadDocument(json);
+    return document && Convert(document->root(), output);
+  }
+
   bool Convert(const base::Value::Dict& dict, StructType* output) const {
     for (size_t i = 0; i < fields_.size(); ++i) {
       const internal::FieldConverterBase<StructType>* field_converter =
@@ -526,8 +663,34 @@ class JSONValueConverter {
   }
 
  private:
+  // An entry of |field_index_|: a field and the first key of its path.
+  struct FieldIndexEntry {
+    std::string_view key;
+    size_t field;
+  };
+
+  static bool CompareFieldIndexEntries(const FieldIndexEntry& a,
+                                       const FieldIndexEntry& b) {
+    return a.key < b.key;
+  }
+
+  void AddField(
+      std::unique_ptr<internal::FieldConverterBase<StructType>> field) {
+    const std::string_view path = field->field_path();
+    const FieldIndexEntry entry = {path.substr(0, path.find('.')),
+                                   fields_.size()};
+    field_index_.insert(std::upper_bound(field_index_.begin(),
+                                         field_index_.end(), entry,
+                                         &CompareFieldIndexEntries),
+                        entry);
+    fields_.push_back(std::move(field));
+  }
+
   std::vector<std::unique_ptr<internal::FieldConverterBase<StructType>>>
       fields_;
+  // The fields sorted by the first key of their path, which points into the
+  // path owned by the field converter.
+  std::vector<FieldIndexEntry> field_index_;
 };
 
 }  // namespace base
@@ -10,6 +10,7 @@
 #include <string_view>
 #include <vector>
 
+#include "base/json/json_document.h"
 #include "base/json/json_reader.h"
 #include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -92,6 +93,20 @@ struct NestedMessage {
   }
 };
 
+// For fields registered with dotted paths.
+struct DottedPathMessage {
+  int inner_foo = 0;
+  int inner_bar = 0;
+  int foo = 0;
+
+  static void RegisterJSONConverter(
+      base::JSONValueConverter<DottedPathMessage>* converter) {
+    converter->RegisterIntField("inner.foo", &DottedPathMessage::inner_foo);
+    converter->RegisterIntField("inner.bar", &DottedPathMessage::inner_bar);
+    converter->RegisterIntField("foo", &DottedPathMessage::foo);
+  }
+};
+
 }  // namespace
 
 TEST(JSONValueConverterTest, ParseSimpleMessage) {
@@ -183,6 +198,86 @@ TEST(JSONValueConverterTest, ParseNestedMessage) {
   EXPECT_EQ(0U, second_child->string_values.size());
 }
 
+TEST(JSONValueConverterTest, ParseNestedMessageFromDocument) {
+  const char normal_data[] =
+      "{\n"
+      "  \"foo\": 1,\n"
+      "  \"child\": {\n"
+      "    \"foo\": 1,\n"
+      "    \"bar\": \"b\\u0061r\",\n"
+      "    \"bstruct\": {},\n"
+      "    \"string_values\": [{\"val\": \"value_1\"}, {\"val\": \"value_2\"}],"
+      "    \"simple_enum\": \"bar\","
+      "    \"ints\": [1, 2]"
+      "  },\n"
+      "  \"children\": [{\n"
+      "    \"foo\": 2,\n"
+      "    \"bar\": \"foobar\",\n"
+      "    \"baz\": true\n"
+      "  }]\n"
+      "}\n";
+
+  std::optional<JSONDocument> doc = base::JSONReader::ReadDocument(normal_data);
+  ASSERT_TRUE(doc);
+  NestedMessage message;
+  base::JSONValueConverter<NestedMessage> converter;
+  EXPECT_TRUE(converter.Convert(doc->root(), &message));
+
+  EXPECT_EQ(1.0, message.foo);
+  EXPECT_EQ(1, message.child.foo);
+  EXPECT_EQ("bar", message.child.bar);
+  EXPECT_FALSE(message.child.baz);
+  EXPECT_TRUE(message.child.bstruct);
+  EXPECT_EQ(SimpleMessage::BAR, message.child.simple_enum);
+  ASSERT_EQ(2U, message.child.ints.size());
+  EXPECT_EQ(2, *message.child.ints[1]);
+  ASSERT_EQ(2U, message.child.string_values.size());
+  EXPECT_EQ("value_1", *message.child.string_values[0]);
+  EXPECT_EQ("value_2", *message.child.string_values[1]);
+
+  ASSERT_EQ(1U, message.children.size());
+  EXPECT_EQ(2, message.children[0]->foo);
+  EXPECT_EQ("foobar", message.children[0]->bar);
+  EXPECT_TRUE(message.children[0]->baz);
+
+  // The same failures are detected as when converting a base::Value.
+  doc = base::JSONReader::ReadDocument("{\"child\": {\"ints\": [1, false]}}");
+  ASSERT_TRUE(doc);
+  EXPECT_FALSE(converter.Convert(doc->root(), &message));
+  doc = base::JSONReader::ReadDocument("[]");
+  ASSERT_TRUE(doc);
+  EXPECT_FALSE(converter.Convert(doc->root(), &message));
+}
+
+TEST(JSONValueConverterTest, ParseDottedPathsFromDocument) {
+  base::JSONValueConverter<DottedPathMessage> converter;
+  DottedPathMessage message;
+  EXPECT_TRUE(converter.ConvertJSON(
+      R"({"foo": 1, "inner": {"bar": 2, "foo": 3}, "other": 4})", &message));
+  EXPECT_EQ(1, message.foo);
+  EXPECT_EQ(3, message.inner_foo);
+  EXPECT_EQ(2, message.inner_bar);
+
+  // Like JSONReader::Read(), the last of the duplicate keys wins.
+  message = DottedPathMessage();
+  EXPECT_TRUE(converter.ConvertJSON(
+      R"({"foo": "x", "inner": {"foo": 5}, "foo": 6, "inner": {"bar": 7}})",
+      &message));
+  EXPECT_EQ(6, message.foo);
+  EXPECT_EQ(0, message.inner_foo);
+  EXPECT_EQ(7, message.inner_bar);
+
+  // A path through a value which isn't a dictionary is a missing field.
+  message = DottedPathMessage();
+  EXPECT_TRUE(converter.ConvertJSON(R"({"inner": 1, "foo": 2})", &message));
+  EXPECT_EQ(2, message.foo);
+  EXPECT_EQ(0, message.inner_foo);
+
+  EXPECT_FALSE(converter.ConvertJSON(R"({"inner": {"foo": true}})", &message));
+  EXPECT_FALSE(converter.ConvertJSON("{\"foo\": 1", &message));
+  EXPECT_FALSE(converter.ConvertJSON("[]", &message));
+}
+
 TEST(JSONValueConverterTest, ParseFailures) {
   const char normal_data[] =
       "{\n"
@@ -6,10 +6,12 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <string_view>
 
+#include "base/check_op.h"
 #include "base/json/string_escape.h"
 #include "base/logging.h"
 #include "base/numerics/safe_conversions.h"
@@ -25,6 +27,75 @@ const char kPrettyPrintLineEnding[] = "\r\n";
 const char kPrettyPrintLineEnding[] = "\n";
 #endif
 
+namespace {
+
+// Estimates the size of the JSON generated for a value, so that the output
+// string can be allocated once up front. Errs on the low side for strings that
+// need escaping and for doubles with many digits.
+class SizeEstimator {
+ public:
+  SizeEstimator(bool pretty_print, size_t max_depth)
+      : pretty_print_(pretty_print), max_depth_(max_depth) {}
+
+  size_t Estimate(ValueView node) const {
+    return node.Visit(
+        [this](const auto& member) { return Estimate(member, 0); });
+  }
+
+ private:
+  size_t Estimate(const Value& node, size_t depth) const {
+    return node.Visit(
+        [this, depth](const auto& member) { return Estimate(member, depth); });
+  }
+
+  size_t Estimate(absl::monostate node, size_t depth) const { return 4; }
+  size_t Estimate(bool node, size_t depth) const { return 5; }
+  size_t Estimate(int node, size_t depth) const {
+    size_t size = node < 0 ? 2 : 1;
+    for (int rest = node / 10; rest != 0; rest /= 10) {
+      ++size;
+    }
+    return size;
+  }
+  size_t Estimate(double node, size_t depth) const { return 17; }
+  size_t Estimate(std::string_view node, size_t depth) const {
+    return node.size() + 2;
+  }
+  size_t Estimate(const Value::BlobStorage& node, size_t depth) const {
+    return 0;
+  }
+
+  size_t Estimate(const Value::Dict& node, size_t depth) const {
+    size_t size = 2;
+    if (depth + 1 >= max_depth_) {
+      return size;
+    }
+    // Quotes, colon and comma, plus a space, indentation and line break.
+    const size_t per_entry = pretty_print_ ? 4 + 3 * (depth + 1) + 2 : 4;
+    for (const auto [key, value] : node) {
+      size += key.size() + per_entry + Estimate(value, depth + 1);
+    }
+    return size;
+  }
+
+  size_t Estimate(const Value::List& node, size_t depth) const {
+    size_t size = 2;
+    if (depth + 1 >= max_depth_) {
+      return size;
+    }
+    const size_t per_item = pretty_print_ ? 2 : 1;
+    for (const Value& value : node) {
+      size += per_item + Estimate(value, depth + 1);
+    }
+    return size;
+  }
+
+  const bool pretty_print_;
+  const size_t max_depth_;
+};
+
+}  // namespace
+
 // static
 bool JSONWriter::Write(ValueView node, std::string* json, size_t max_depth) {
   return WriteWithOptions(node, 0, json, max_depth);
@@ -36,35 +107,57 @@ bool JSONWriter::WriteWithOptions(ValueView node,
                                   std::string* json,
                                   size_t max_depth) {
   json->clear();
-  // Is there a better way to estimate the size of the output?
-  if (json->capacity() < 1024) {
-    json->reserve(1024);
-  }
+  json->reserve(
+      SizeEstimator((options & OPTIONS_PRETTY_PRINT) != 0, max_depth)
+          .Estimate(node));
 
   JSONWriter writer(options, json, max_depth);
-  bool result = node.Visit([&writer](const auto& member) {
-    return writer.BuildJSONString(member, 0);
-  });
-
-  if (options & OPTIONS_PRETTY_PRINT) {
-    json->append(kPrettyPrintLineEnding);
-  }
+  return writer.Build(node);
+}
 
-  return result;
+// static
+bool JSONWriter::WriteToSink(ValueView node,
+                             int options,
+                             Sink sink,
+                             size_t buffer_size,
+                             size_t max_depth) {
+  CHECK_GT(buffer_size, 0u);
+  std::string buffer;
+  buffer.reserve(buffer_size);
+
+  JSONWriter writer(options, &buffer, max_depth, sink, buffer_size);
+  return writer.Build(node) && writer.MaybeFlush(/*force=*/true);
 }
 
-JSONWriter::JSONWriter(int options, std::string* json, size_t max_depth)
+JSONWriter::JSONWriter(int options,
+                       std::string* json,
+                       size_t max_depth,
+                       std::optional<Sink> sink,
+                       size_t buffer_size)
     : omit_binary_values_((options & OPTIONS_OMIT_BINARY_VALUES) != 0),
       omit_double_type_preservation_(
           (options & OPTIONS_OMIT_DOUBLE_TYPE_PRESERVATION) != 0),
       pretty_print_((options & OPTIONS_PRETTY_PRINT) != 0),
       json_string_(json),
+      sink_(sink),
+      buffer_size_(buffer_size),
       max_depth_(max_depth),
       stack_depth_(0) {
   DCHECK(json);
   CHECK_LE(max_depth, internal::kAbsoluteMaxDepth);
 }
 
+bool JSONWriter::Build(ValueView node) {
+  bool result = node.Visit(
+      [this](const auto& member) { return BuildJSONString(member, 0); });
+
+  if (pretty_print_) {
+    json_string_->append(kPrettyPrintLineEnding);
+  }
+
+  return result;
+}
+
 bool JSONWriter::BuildJSONString(absl::monostate node, size_t depth) {
   json_string_->append("null");
   return true;
@@ -76,40 +169,42 @@ bool JSONWriter::BuildJSONString(bool node, size_t depth) {
 }
 
 bool JSONWriter::BuildJSONString(int node, size_t depth) {
-  json_string_->append(NumberToString(node));
+  AppendNumberToString(node, *json_string_);
   return true;
 }
 
 bool JSONWriter::BuildJSONString(double node, size_t depth) {
   if (omit_double_type_preservation_ &&
       IsValueInRangeForNumericType<int64_t>(node) && std::floor(node) == node) {
-    json_string_->append(NumberToString(static_cast<int64_t>(node)));
+    AppendNumberToString(static_cast<int64_t>(node), *json_string_);
     return true;
   }
 
-  std::string real = NumberToString(node);
+  const size_t start = json_string_->size();
+  AppendNumberToString(node, *json_string_);
+  std::string_view real = std::string_view(*json_string_).substr(start);
+
+  // The JSON spec requires that non-integer values in the range (-1,1)
+  // have a zero before the decimal point - ".52" is not valid, "0.52" is.
+  // Likewise "-.1" is bad and "-0.1" is good.
+  const size_t sign_length = real.starts_with('-') ? 1 : 0;
+  const bool needs_leading_zero =
+      real.length() > sign_length && real[sign_length] == '.';
+
   // Ensure that the number has a .0 if there's no decimal or 'e'.  This
   // makes sure that when we read the JSON back, it's interpreted as a
   // real rather than an int.
-  if (real.find_first_of(".eE") == std::string::npos) {
-    real.append(".0");
+  if (real.find_first_of(".eE") == std::string_view::npos) {
+    json_string_->append(".0");
   }
-
-  // The JSON spec requires that non-integer values in the range (-1,1)
-  // have a zero before the decimal point - ".52" is not valid, "0.52" is.
-  if (real[0] == '.') {
-    real.insert(0, 1, '0');
-  } else if (real.length() > 1 && real[0] == '-' && real[1] == '.') {
-    // "-.1" bad "-0.1" good
-    real.insert(1, 1, '0');
+  if (needs_leading_zero) {
+    json_string_->insert(start + sign_length, 1, '0');
   }
-  json_string_->append(real);
   return true;
 }
 
 bool JSONWriter::BuildJSONString(std::string_view node, size_t depth) {
-  EscapeJSONString(node, true, json_string_);
-  return true;
+  return WriteString(node);
 }
 
 bool JSONWriter::BuildJSONString(const Value::BlobStorage& node, size_t depth) {
@@ -148,7 +243,9 @@ bool JSONWriter::BuildJSONString(const Value::Dict& node, size_t depth) {
       IndentLine(depth + 1U);
     }
 
-    EscapeJSONString(key, true, json_string_);
+    if (!WriteString(key)) {
+      return false;
+    }
     json_string_->push_back(':');
     if (pretty_print_) {
       json_string_->push_back(' ');
@@ -157,6 +254,9 @@ bool JSONWriter::BuildJSONString(const Value::Dict& node, size_t depth) {
     result &= value.Visit([this, depth = depth + 1](const auto& member) {
       return BuildJSONString(member, depth);
     });
+    if (!MaybeFlush()) {
+      return false;
+    }
 
     first_value_has_been_output = true;
   }
@@ -201,6 +301,9 @@ bool JSONWriter::BuildJSONString(const Value::List& node, size_t depth) {
     result &= value.Visit([this, depth](const auto& member) {
       return BuildJSONString(member, depth);
     });
+    if (!MaybeFlush()) {
+      return false;
+    }
 
     first_value_has_been_output = true;
   }
@@ -216,6 +319,43 @@ void JSONWriter::IndentLine(size_t depth) {
   json_string_->append(depth * 3U, ' ');
 }
 
+bool JSONWriter::WriteString(std::string_view node) {
+  if (!sink_ || node.size() <= buffer_size_) {
+    EscapeJSONString(node, true, json_string_);
+    return true;
+  }
+
+  json_string_->push_back('"');
+  while (!node.empty()) {
+    size_t piece_size = std::min(node.size(), buffer_size_);
+    // Split between code points, since EscapeJSONString() replaces partial
+    // UTF-8 sequences.
+    while (piece_size < node.size() && (node[piece_size] & 0xC0) == 0x80) {
+      ++piece_size;
+    }
+    EscapeJSONString(node.substr(0, piece_size), false, json_string_);
+    node.remove_prefix(piece_size);
+    if (!MaybeFlush()) {
+      return false;
+    }
+  }
+  json_string_->push_back('"');
+  return true;
+}
+
+bool JSONWriter::MaybeFlush(bool force) {
+  if (!sink_ || sink_failed_) {
+    return !sink_failed_;
+  }
+  if (json_string_->empty() ||
+      (!force && json_string_->size() < buffer_size_)) {
+    return true;
+  }
+  sink_failed_ = !(*sink_)(*json_string_);
+  json_string_->clear();
+  return !sink_failed_;
+}
+
 std::optional<std::string> WriteJson(ValueView node, size_t max_depth) {
   std::string result;
   if (!JSONWriter::Write(node, &result, max_depth)) {
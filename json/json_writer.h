@@ -13,6 +13,8 @@
 #include <string_view>
 
 #include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/functional/function_ref.h"
 #include "base/json/json_common.h"
 #include "base/memory/raw_ptr.h"
 #include "base/values.h"
@@ -95,10 +97,39 @@ class BASE_EXPORT JSONWriter {
                                std::string* json,
                                size_t max_depth = internal::kAbsoluteMaxDepth);
 
+  // Receives consecutive chunks of JSON output. Returns false to abort
+  // writing, e.g. on an I/O error.
+  using Sink = FunctionRef<bool(span<const char>)>;
+
+  static constexpr size_t kDefaultSinkBufferSize = 64 * 1024;
+
+  // Like WriteWithOptions(), but passes the output to |sink| in chunks of
+  // roughly |buffer_size| bytes instead of building a single string, so that
+  // memory use does not grow with the size of the output. Returns false if
+  // the JSON could not be generated (see WriteWithOptions()) or if |sink|
+  // returned false; |sink| is not called again after returning false, but
+  // may already have received part of the output. For example:
+  //
+  //   JSONWriter::WriteToSink(state, JSONWriter::OPTIONS_PRETTY_PRINT,
+  //                           [&file](span<const char> chunk) {
+  //                             return file.WriteAtCurrentPosAndCheck(
+  //                                 as_bytes(chunk));
+  //                           });
+  static bool WriteToSink(ValueView node,
+                          int options,
+                          Sink sink,
+                          size_t buffer_size = kDefaultSinkBufferSize,
+                          size_t max_depth = internal::kAbsoluteMaxDepth);
+
  private:
   JSONWriter(int options,
              std::string* json,
-             size_t max_depth = internal::kAbsoluteMaxDepth);
+             size_t max_depth = internal::kAbsoluteMaxDepth,
+             std::optional<Sink> sink = std::nullopt,
+             size_t buffer_size = 0);
+
+  // Writes |node| and, with OPTIONS_PRETTY_PRINT, a final line break.
+  bool Build(ValueView node);
 
   // Called recursively to build the JSON string. When completed,
   // |json_string_| will contain the JSON.
@@ -114,13 +145,28 @@ class BASE_EXPORT JSONWriter {
   // Adds space to json_string_ for the indent level.
   void IndentLine(size_t depth);
 
+  // Appends |node| to |json_string_| as a quoted JSON string. When writing to a
+  // sink, long strings are escaped piecewise so that they never have to be
+  // buffered whole.
+  bool WriteString(std::string_view node);
+
+  // When writing to a sink, passes the buffered output to it once there is at
+  // least |buffer_size_| of it, or unconditionally if |force| is true. Returns
+  // false if the sink failed, now or earlier.
+  bool MaybeFlush(bool force = false);
+
   bool omit_binary_values_;
   bool omit_double_type_preservation_;
   bool pretty_print_;
 
-  // Where we write JSON data as we generate it.
+  // Where we write JSON data as we generate it. When writing to a sink, this
+  // only holds the output that has not been passed to |sink_| yet.
   raw_ptr<std::string> json_string_;
 
+  const std::optional<Sink> sink_;
+  const size_t buffer_size_;
+  bool sink_failed_ = false;
+
   // Maximum depth to write.
   const size_t max_depth_;
 
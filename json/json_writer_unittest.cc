@@ -9,10 +9,14 @@
 
 #include "base/json/json_writer.h"
 
+#include <algorithm>
 #include <optional>
+#include <string>
+#include <utility>
 
 #include "base/containers/span.h"
 #include "base/json/json_reader.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/test/gmock_expected_support.h"
 #include "base/values.h"
@@ -237,4 +241,89 @@ TEST(JsonWriterTest, JSONWriterWriteWithOptionsFailure) {
       JSONWriter::OPTIONS_PRETTY_PRINT, &output_js, /*max_depth=*/1));
 }
 
+TEST(JsonWriterTest, WriteToSinkMatchesWriteWithOptions) {
+  Value::List list;
+  for (int i = 0; i < 200; ++i) {
+    list.Append(Value::Dict()
+                    .Set("int", i)
+                    .Set("double", i + 0.5)
+                    .Set("string", "caf\xC3\xA9 \"" + NumberToString(i) + "\"")
+                    .Set("list", Value::List().Append(true).Append(Value())));
+  }
+  const Value value(std::move(list));
+
+  for (int options : {0, static_cast<int>(JSONWriter::OPTIONS_PRETTY_PRINT)}) {
+    std::string expected;
+    ASSERT_TRUE(JSONWriter::WriteWithOptions(value, options, &expected));
+
+    for (size_t buffer_size : {1u, 7u, 100u, 1000000u}) {
+      SCOPED_TRACE(buffer_size);
+      std::string output;
+      size_t max_chunk_size = 0;
+      EXPECT_TRUE(JSONWriter::WriteToSink(
+          value, options,
+          [&](span<const char> chunk) {
+            output.append(chunk.begin(), chunk.end());
+            max_chunk_size = std::max(max_chunk_size, chunk.size());
+            return true;
+          },
+          buffer_size));
+      EXPECT_EQ(expected, output);
+      // A chunk is flushed as soon as it reaches |buffer_size|, so it can only
+      // exceed it by the last value written.
+      EXPECT_LT(max_chunk_size, buffer_size + 100);
+    }
+  }
+}
+
+TEST(JsonWriterTest, WriteToSinkSplitsLongStrings) {
+  // 3-byte characters, so that pieces are not aligned with code points.
+  std::string long_string;
+  for (int i = 0; i < 10000; ++i) {
+    long_string += "\xE2\x82\xAC";
+  }
+  std::string expected;
+  ASSERT_TRUE(JSONWriter::Write(Value(long_string), &expected));
+
+  std::string output;
+  size_t max_chunk_size = 0;
+  EXPECT_TRUE(JSONWriter::WriteToSink(
+      Value(long_string), 0,
+      [&](span<const char> chunk) {
+        output.append(chunk.begin(), chunk.end());
+        max_chunk_size = std::max(max_chunk_size, chunk.size());
+        return true;
+      },
+      /*buffer_size=*/1000));
+  EXPECT_EQ(expected, output);
+  EXPECT_LE(max_chunk_size, 2000u);
+}
+
+TEST(JsonWriterTest, WriteToSinkStopsOnSinkFailure) {
+  Value::List list;
+  for (int i = 0; i < 1000; ++i) {
+    list.Append(i);
+  }
+  int calls = 0;
+  EXPECT_FALSE(JSONWriter::WriteToSink(
+      list, 0,
+      [&calls](span<const char> chunk) {
+        ++calls;
+        return false;
+      },
+      /*buffer_size=*/16));
+  EXPECT_EQ(1, calls);
+}
+
+TEST(JsonWriterTest, WriteToSinkFailures) {
+  auto sink = [](span<const char> chunk) { return true; };
+  const Value blob(Value::BlobStorage({1}));
+  EXPECT_FALSE(JSONWriter::WriteToSink(blob, 0, sink));
+  EXPECT_TRUE(JSONWriter::WriteToSink(
+      blob, JSONWriter::OPTIONS_OMIT_BINARY_VALUES, sink));
+  EXPECT_FALSE(JSONWriter::WriteToSink(
+      Value::List().Append(Value::List()), 0, sink,
+      JSONWriter::kDefaultSinkBufferSize, /*max_depth=*/1));
+}
+
 }  // namespace base
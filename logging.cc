@@ -21,7 +21,9 @@
 #include <cstring>
 #include <ctime>
 #include <iomanip>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <string_view>
@@ -32,6 +34,7 @@
 #include "base/base_export.h"
 #include "base/base_switches.h"
 #include "base/command_line.h"
+#include "base/containers/mpmc_queue.h"
 #include "base/containers/stack.h"
 #include "base/debug/alias.h"
 #include "base/debug/crash_logging.h"
@@ -53,13 +56,17 @@
 #include "base/strings/sys_string_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/thread_annotations.h"
 #include "base/task/common/task_annotator.h"
 #include "base/test/scoped_logging_settings.h"
 #include "base/threading/platform_thread.h"
+#include "base/time/time.h"
 #include "base/trace_event/base_tracing.h"
 #include "base/vlog.h"
 #include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
 #include "third_party/abseil-cpp/absl/cleanup/cleanup.h"
 
 #if !BUILDFLAG(IS_NACL)
@@ -127,6 +134,8 @@ typedef FILE* FileHandle;
 
 namespace logging {
 
+std::atomic<uint32_t> g_vlog_levels_generation{1};
+
 namespace {
 
 int g_min_log_level = 0;
@@ -157,11 +166,17 @@ VlogInfo* GetVlogInfo() {
 // overwriting values set via ScopedVmoduleSwitches.
 bool InitializeVlogInfo(VlogInfo* vlog_info) {
   VlogInfo* previous_vlog_info = nullptr;
-  return g_vlog_info.compare_exchange_strong(previous_vlog_info, vlog_info);
+  if (!g_vlog_info.compare_exchange_strong(previous_vlog_info, vlog_info)) {
+    return false;
+  }
+  InvalidateVlogLevelCaches();
+  return true;
 }
 
 VlogInfo* ExchangeVlogInfo(VlogInfo* vlog_info) {
-  return g_vlog_info.exchange(vlog_info);
+  VlogInfo* previous_vlog_info = g_vlog_info.exchange(vlog_info);
+  InvalidateVlogLevelCaches();
+  return previous_vlog_info;
 }
 
 // Creates a VlogInfo from the commandline if it has been initialized and if it
@@ -509,6 +524,222 @@ void TraceLogMessage(const char* file, int line, const std::string& message) {
   });
 }
 
+// Appends `data` to the log file, opening it if needed.
+void WriteToLogFile(std::string_view data) {
+#if BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+  // If the client app did not call InitLogging() and the lock has not
+  // been created it will be done now on calling GetLoggingLock(). We do this
+  // on demand, but if two threads try to do this at the same time, there will
+  // be a race condition to create the lock. This is why InitLogging should be
+  // called from the main thread at the beginning of execution.
+  base::AutoLock guard(GetLoggingLock());
+#endif
+  if (!InitializeLogFileHandle()) {
+    return;
+  }
+#if BUILDFLAG(IS_WIN)
+  DWORD num_written;
+  WriteFile(g_log_file, static_cast<const void*>(data.data()),
+            static_cast<DWORD>(data.length()), &num_written, nullptr);
+#elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+  std::ignore = fwrite(data.data(), data.size(), 1, g_log_file);
+  fflush(g_log_file);
+#else
+#error Unsupported platform
+#endif
+}
+
+// A formatted message of the asynchronous logging mode, waiting to be written.
+struct AsyncLogMessage {
+  std::string text;
+  bool to_stderr = false;
+  bool to_file = false;
+};
+
+// Whether LogMessage queues its messages in AsyncLogWriter rather than writing
+// them.
+std::atomic<bool> g_async_logging_enabled{false};
+
+// Whether the current thread holds the lock of AsyncLogWriter to write the
+// queued messages, e.g. the writer thread. The messages it logs meanwhile, for
+// instance from a failed CHECK in the writing code, must be written right away
+// rather than queued, since writing the queue again would deadlock.
+ABSL_CONST_INIT thread_local bool g_is_writing_async_logs = false;
+
+// Queues the messages of the asynchronous logging mode and writes them in
+// batches on a dedicated thread. The queue is bounded: when it is full, the
+// drop policy decides whether the logging thread writes the backlog itself or
+// drops its message.
+class AsyncLogWriter : public base::PlatformThread::Delegate {
+ public:
+  AsyncLogWriter() = default;
+  AsyncLogWriter(const AsyncLogWriter&) = delete;
+  AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+  ~AsyncLogWriter() override = default;
+
+  static AsyncLogWriter& Get() {
+    // Leaked, since messages can be logged during process exit.
+    static base::NoDestructor<AsyncLogWriter> writer;
+    return *writer;
+  }
+
+  static bool IsEnabled() {
+    return g_async_logging_enabled.load(std::memory_order_relaxed);
+  }
+
+  // Starts the writer thread. Returns false if it couldn't be created, in
+  // which case logging stays synchronous.
+  bool Start(AsyncLogDropPolicy drop_policy) {
+    DCHECK(!IsEnabled());
+    drop_policy_.store(drop_policy, std::memory_order_relaxed);
+    stopping_.store(false, std::memory_order_relaxed);
+    if (!base::PlatformThread::Create(0, this, &thread_)) {
+      return false;
+    }
+    g_async_logging_enabled.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Writes the queued messages and joins the writer thread. Messages queued
+  // afterwards by threads which saw the mode enabled are written by them.
+  void Stop() {
+    if (!IsEnabled()) {
+      return;
+    }
+    g_async_logging_enabled.store(false, std::memory_order_relaxed);
+    stopping_.store(true, std::memory_order_release);
+    wake_up_.Signal();
+    base::PlatformThread::Join(thread_);
+    thread_ = base::PlatformThreadHandle();
+    Drain();
+  }
+
+  void Enqueue(AsyncLogMessage message) {
+    if (g_is_writing_async_logs) {
+      WriteMessage(message);
+      return;
+    }
+    if (queue_.TryPush(std::move(message))) {
+      // The writer wakes up periodically anyway, so it only needs to be woken
+      // up at the start of a burst.
+      if (queue_.size() == 1) {
+        wake_up_.Signal();
+      }
+      if (stopping_.load(std::memory_order_acquire)) {
+        // The writer may have exited before the push.
+        Drain();
+      }
+      return;
+    }
+
+    switch (drop_policy_.load(std::memory_order_relaxed)) {
+      case AsyncLogDropPolicy::kWriteInline: {
+        // Write the backlog and the message on this thread, in order.
+        base::AutoLock lock(drain_lock_);
+        g_is_writing_async_logs = true;
+        DrainLocked();
+        WriteMessage(message);
+        g_is_writing_async_logs = false;
+        break;
+      }
+      case AsyncLogDropPolicy::kDropNewest:
+        num_dropped_.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+  }
+
+  // Writes the queued messages on the calling thread. Does nothing if the
+  // calling thread is already writing them, in which case they are written
+  // once it returns to the outer Drain().
+  void Drain() {
+    if (g_is_writing_async_logs) {
+      return;
+    }
+    base::AutoLock lock(drain_lock_);
+    g_is_writing_async_logs = true;
+    DrainLocked();
+    g_is_writing_async_logs = false;
+  }
+
+  // base::PlatformThread::Delegate:
+  void ThreadMain() override {
+    base::PlatformThread::SetName("LogWriter");
+    while (!stopping_.load(std::memory_order_acquire)) {
+      // Bounds the latency of the messages queued while their size() was
+      // observed above 1 by a racing pop.
+      wake_up_.TimedWait(kMaxLatency);
+      Drain();
+    }
+  }
+
+ private:
+  static constexpr size_t kQueueCapacity = 1024;
+  // Above this size, a batch is written before more messages are popped.
+  static constexpr size_t kMaxBatchSize = 64 * 1024;
+  static constexpr base::TimeDelta kMaxLatency = base::Milliseconds(100);
+
+  static void WriteMessage(const AsyncLogMessage& message) {
+    if (message.to_stderr) {
+      WriteToFd(STDERR_FILENO, message.text.data(), message.text.size());
+    }
+    if (message.to_file) {
+      WriteToLogFile(message.text);
+    }
+  }
+
+  // Pops the queued messages and writes them with one write per destination
+  // and batch. Holding `drain_lock_` while popping and writing keeps the
+  // messages in order when several threads drain.
+  void DrainLocked() EXCLUSIVE_LOCKS_REQUIRED(drain_lock_) {
+    std::string stderr_batch;
+    std::string file_batch;
+    auto write_batches = [&] {
+      if (!stderr_batch.empty()) {
+        WriteToFd(STDERR_FILENO, stderr_batch.data(), stderr_batch.size());
+        stderr_batch.clear();
+      }
+      if (!file_batch.empty()) {
+        WriteToLogFile(file_batch);
+        file_batch.clear();
+      }
+    };
+
+    while (std::optional<AsyncLogMessage> message = queue_.TryPop()) {
+      if (message->to_stderr) {
+        stderr_batch.append(message->text);
+      }
+      if (message->to_file) {
+        file_batch.append(message->text);
+      }
+      if (stderr_batch.size() + file_batch.size() >= kMaxBatchSize) {
+        write_batches();
+      }
+    }
+
+    const uint32_t num_dropped =
+        num_dropped_.exchange(0, std::memory_order_relaxed);
+    if (num_dropped) {
+      const std::string dropped_message = base::StringPrintf(
+          "[%u log messages dropped: the log queue was full]\n", num_dropped);
+      if ((g_logging_destination & LOG_TO_FILE) != 0) {
+        file_batch.append(dropped_message);
+      } else {
+        stderr_batch.append(dropped_message);
+      }
+    }
+    write_batches();
+  }
+
+  base::MPMCQueue<AsyncLogMessage, kQueueCapacity> queue_;
+  base::Lock drain_lock_;
+  base::WaitableEvent wake_up_{base::WaitableEvent::ResetPolicy::AUTOMATIC};
+  std::atomic<bool> stopping_{false};
+  std::atomic<AsyncLogDropPolicy> drop_policy_{
+      AsyncLogDropPolicy::kWriteInline};
+  std::atomic<uint32_t> num_dropped_{0};
+  base::PlatformThreadHandle thread_;
+};
+
 }  // namespace
 
 #if BUILDFLAG(DCHECK_IS_CONFIGURABLE)
@@ -536,6 +767,16 @@ bool BaseInitLoggingImpl(const LoggingSettings& settings) {
 
   MaybeInitializeVlogInfo();
 
+  // The queued messages go to the previous destinations.
+  if (AsyncLogWriter::IsEnabled()) {
+    AsyncLogWriter::Get().Stop();
+  }
+  absl::Cleanup start_async_log_writer = [&settings] {
+    if (settings.async) {
+      AsyncLogWriter::Get().Start(settings.async_drop_policy);
+    }
+  };
+
   g_logging_destination = settings.logging_dest;
 
 #if BUILDFLAG(IS_FUCHSIA)
@@ -578,6 +819,7 @@ bool BaseInitLoggingImpl(const LoggingSettings& settings) {
 
 void SetMinLogLevel(int level) {
   g_min_log_level = std::min(LOGGING_FATAL, level);
+  InvalidateVlogLevelCaches();
 }
 
 int GetMinLogLevel() {
@@ -626,6 +868,27 @@ int GetVlogLevelHelper(const char* file, size_t N) {
                    : GetVlogVerbosity();
 }
 
+void InvalidateVlogLevelCaches() {
+  // Skip 0, which would match the caches which were never filled.
+  if (g_vlog_levels_generation.fetch_add(1, std::memory_order_release) ==
+      std::numeric_limits<uint32_t>::max()) {
+    g_vlog_levels_generation.fetch_add(1, std::memory_order_release);
+  }
+}
+
+int UpdateVlogLevelCache(VlogLevelCache& cache,
+                         const char* file_start,
+                         size_t N) {
+  // Read the generation first, so that a change of the levels during the
+  // lookup invalidates the result.
+  const uint32_t generation =
+      g_vlog_levels_generation.load(std::memory_order_acquire);
+  const int level = GetVlogLevelHelper(file_start, N);
+  cache.value.store((uint64_t{generation} << 32) | static_cast<uint32_t>(level),
+                    std::memory_order_relaxed);
+  return level;
+}
+
 void SetLogItems(bool enable_process_id, bool enable_thread_id,
                  bool enable_timestamp, bool enable_tickcount) {
   g_log_process_id = enable_process_id;
@@ -887,6 +1150,19 @@ void LogMessage::Flush() {
 #endif  // BUILDFLAG(IS_FUCHSIA)
   }
 
+  if (AsyncLogWriter::IsEnabled()) {
+    if (severity_ != LOGGING_FATAL) {
+      AsyncLogWriter::Get().Enqueue(
+          {.text = std::move(str_newline),
+           .to_stderr = ShouldLogToStderr(severity_),
+           .to_file = (g_logging_destination & LOG_TO_FILE) != 0});
+      return;
+    }
+    // The process is about to crash: write the queued messages first, and the
+    // FATAL message synchronously.
+    AsyncLogWriter::Get().Drain();
+  }
+
   if (ShouldLogToStderr(severity_)) {
     // Not using fwrite() here, as there are crashes on Windows when CRT calls
     // malloc() internally, triggering an OOM crash. This likely means that the
@@ -903,30 +1179,7 @@ void LogMessage::Flush() {
   }
 
   if ((g_logging_destination & LOG_TO_FILE) != 0) {
-#if BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
-    // If the client app did not call InitLogging() and the lock has not
-    // been created it will be done now on calling GetLoggingLock(). We do this
-    // on demand, but if two threads try to do this at the same time, there will
-    // be a race condition to create the lock. This is why InitLogging should be
-    // called from the main thread at the beginning of execution.
-    base::AutoLock guard(GetLoggingLock());
-#endif
-    if (InitializeLogFileHandle()) {
-#if BUILDFLAG(IS_WIN)
-      DWORD num_written;
-      WriteFile(g_log_file,
-                static_cast<const void*>(str_newline.c_str()),
-                static_cast<DWORD>(str_newline.length()),
-                &num_written,
-                nullptr);
-#elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
-      std::ignore =
-          fwrite(str_newline.data(), str_newline.size(), 1, g_log_file);
-      fflush(g_log_file);
-#else
-#error Unsupported platform
-#endif
-    }
+    WriteToLogFile(str_newline);
   }
 }
 
@@ -1150,7 +1403,14 @@ ErrnoLogMessageFatal::~ErrnoLogMessageFatal() {
 
 #endif  // BUILDFLAG(IS_WIN)
 
+void FlushAsyncLogs() {
+  if (AsyncLogWriter::IsEnabled()) {
+    AsyncLogWriter::Get().Drain();
+  }
+}
+
 void CloseLogFile() {
+  FlushAsyncLogs();
 #if BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
   base::AutoLock guard(GetLoggingLock());
 #endif
@@ -1216,6 +1476,7 @@ ScopedLoggingSettings::ScopedLoggingSettings()
   // automatically anyway, when required, so just close the existing one.
   if (g_log_file) {
     CHECK(g_log_file_name) << "Un-named |log_file| is not supported.";
+    FlushAsyncLogs();
     CloseLogFileUnlocked();
   }
 }
@@ -7,6 +7,7 @@
 
 #include <stddef.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <sstream>
@@ -219,6 +220,17 @@ enum LogLockingState { LOCK_LOG_FILE, DONT_LOCK_LOG_FILE };
 // Defaults to APPEND_TO_OLD_LOG_FILE.
 enum OldFileDeletionState { DELETE_OLD_LOG_FILE, APPEND_TO_OLD_LOG_FILE };
 
+// What a logging thread does in the asynchronous logging mode when the queue
+// of messages is full.
+enum class AsyncLogDropPolicy {
+  // Write the queued messages and its own message, like in the synchronous
+  // mode. No message is lost, and the messages stay in order.
+  kWriteInline,
+  // Drop the message. The number of dropped messages is logged with the next
+  // batch of messages.
+  kDropNewest,
+};
+
 #if BUILDFLAG(IS_CHROMEOS)
 // Defines the log message prefix format to use.
 // LOG_FORMAT_SYSLOG indicates syslog-like message prefixes.
@@ -252,6 +264,12 @@ struct BASE_EXPORT LoggingSettings {
   // will be opened.
   HANDLE log_file = nullptr;
 #endif
+  // If true, the messages to stderr and to the log file are queued and written
+  // in batches by a dedicated thread, so that logging threads don't block on
+  // the writes. FATAL messages are still written synchronously, after the
+  // queued messages. Use FlushAsyncLogs() to write the queued messages.
+  bool async = false;
+  AsyncLogDropPolicy async_drop_policy = AsyncLogDropPolicy::kWriteInline;
 };
 
 // Define different names for the BaseInitLoggingImpl() function depending on
@@ -315,6 +333,38 @@ int GetVlogLevel(const char (&file)[N]) {
   return GetVlogLevelHelper(file, N);
 }
 
+// Incremented whenever the vlog levels may change, i.e. when the min log level
+// or the --vmodule patterns change, to invalidate the VlogLevelCaches.
+BASE_EXPORT extern std::atomic<uint32_t> g_vlog_levels_generation;
+
+// Must be called after changing the vlog levels.
+BASE_EXPORT void InvalidateVlogLevelCaches();
+
+// The vlog level of a VLOG_IS_ON_CACHED() call site, resolved against the
+// --vmodule patterns once per generation of the vlog levels.
+struct VlogLevelCache {
+  // `g_vlog_levels_generation` in the high 32 bits and the level in the low 32
+  // bits. 0 until the first lookup, since the generations start at 1.
+  std::atomic<uint64_t> value{0};
+};
+
+// Looks up the vlog level of `file` and stores it in `cache`.
+BASE_EXPORT int UpdateVlogLevelCache(VlogLevelCache& cache,
+                                     const char* file_start,
+                                     size_t N);
+
+// Same as GetVlogLevel(file), but costs a relaxed load and a comparison when
+// `cache` is up to date.
+template <size_t N>
+int GetVlogLevel(VlogLevelCache& cache, const char (&file)[N]) {
+  const uint64_t value = cache.value.load(std::memory_order_relaxed);
+  if (static_cast<uint32_t>(value >> 32) ==
+      g_vlog_levels_generation.load(std::memory_order_relaxed)) {
+    return static_cast<int32_t>(static_cast<uint32_t>(value));
+  }
+  return UpdateVlogLevelCache(cache, file, N);
+}
+
 // Sets the common items you want to be prepended to each log message.
 // process and thread IDs default to off, the timestamp defaults to on.
 // If this function is not called, logging defaults to writing the timestamp
@@ -444,6 +494,21 @@ constexpr LogSeverity LOGGING_0 = LOGGING_ERROR;
   ((verboselevel) <= (ENABLED_VLOG_LEVEL) || \
    (verboselevel) <= ::logging::GetVlogLevel(__FILE__))
 
+// Same as VLOG_IS_ON(), but caches the vlog level of the file in a static
+// VlogLevelCache, so that the --vmodule patterns are only matched again after
+// the vlog levels change. This costs a static and an out-of-line lookup per
+// call site, so only use it on hot paths where profiles show the --vmodule
+// matching.
+#define VLOG_IS_ON_CACHED(verboselevel)                                  \
+  ((verboselevel) <= (ENABLED_VLOG_LEVEL) ||                             \
+   (verboselevel) <= ::logging::GetVlogLevel(                            \
+                         []() -> ::logging::VlogLevelCache& {            \
+                           static constinit ::logging::VlogLevelCache    \
+                               vlog_level_cache;                         \
+                           return vlog_level_cache;                      \
+                         }(),                                            \
+                         __FILE__))
+
 // Helper macro which avoids evaluating the arguments to a stream if
 // the condition doesn't hold. Condition is evaluated once and only once.
 #define LAZY_STREAM(stream, condition)                                  \
@@ -728,6 +793,10 @@ class BASE_EXPORT ErrnoLogMessageFatal final : public ErrnoLogMessage {
 
 #endif  // BUILDFLAG(IS_WIN)
 
+// Writes the messages queued in the asynchronous logging mode on the calling
+// thread. Does nothing if the mode isn't enabled.
+BASE_EXPORT void FlushAsyncLogs();
+
 // Closes the log file explicitly if open.
 // NOTE: Since the log file is opened as necessary by the action of logging
 //       statements, there's no guarantee that it will stay closed
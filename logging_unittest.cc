@@ -315,6 +315,85 @@ TEST_F(LoggingTest, AlwaysLogErrorsToStderr) {
 }
 #endif  // BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
 
+TEST_F(LoggingTest, AsyncLoggingKeepsOrder) {
+  constexpr int kNumMessages = 100;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath file_log_path =
+      temp_dir.GetPath().Append(FILE_PATH_LITERAL("file.log"));
+
+  LoggingSettings settings;
+  settings.logging_dest = LOG_TO_FILE;
+  settings.log_file_path = file_log_path.value();
+  settings.async = true;
+  ASSERT_TRUE(InitLogging(settings));
+
+  for (int i = 0; i < kNumMessages; ++i) {
+    LOG(WARNING) << "async message " << i << ".";
+  }
+  FlushAsyncLogs();
+
+  std::string written_logs;
+  ASSERT_TRUE(base::ReadFileToString(file_log_path, &written_logs));
+  size_t previous_pos = 0;
+  for (int i = 0; i < kNumMessages; ++i) {
+    const size_t pos = written_logs.find(
+        base::StrCat({"async message ", base::NumberToString(i), "."}));
+    ASSERT_NE(pos, std::string::npos) << i;
+    EXPECT_GE(pos, previous_pos) << i;
+    previous_pos = pos;
+  }
+}
+
+TEST_F(LoggingTest, AsyncLoggingFromLogMessageHandler) {
+  // More messages than the queue holds, so that the queue fills up and the
+  // messages are written inline, from a thread which is logging.
+  constexpr int kNumMessages = 4096;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath file_log_path =
+      temp_dir.GetPath().Append(FILE_PATH_LITERAL("file.log"));
+
+  LoggingSettings settings;
+  settings.logging_dest = LOG_TO_FILE;
+  settings.log_file_path = file_log_path.value();
+  settings.async = true;
+  settings.async_drop_policy = AsyncLogDropPolicy::kWriteInline;
+  ASSERT_TRUE(InitLogging(settings));
+
+  // Logs a nested message for each message. Use a captureless lambda, which
+  // can be converted to a function pointer for SetLogMessageHandler().
+  SetLogMessageHandler([](int severity, const char* file, int line,
+                          size_t start, const std::string& str) -> bool {
+    static bool is_logging_nested_message = false;
+    if (!is_logging_nested_message) {
+      is_logging_nested_message = true;
+      LOG(WARNING) << "nested message.";
+      is_logging_nested_message = false;
+    }
+    return false;
+  });
+  for (int i = 0; i < kNumMessages; ++i) {
+    LOG(WARNING) << "async message " << i << ".";
+  }
+  SetLogMessageHandler(nullptr);
+  FlushAsyncLogs();
+
+  std::string written_logs;
+  ASSERT_TRUE(base::ReadFileToString(file_log_path, &written_logs));
+  int num_nested_messages = 0;
+  for (size_t pos = written_logs.find("nested message.");
+       pos != std::string::npos;
+       pos = written_logs.find("nested message.", pos + 1)) {
+    ++num_nested_messages;
+  }
+  EXPECT_EQ(kNumMessages, num_nested_messages);
+  EXPECT_NE(written_logs.find(base::StrCat(
+                {"async message ", base::NumberToString(kNumMessages - 1),
+                 "."})),
+            std::string::npos);
+}
+
 #if BUILDFLAG(IS_CHROMEOS_ASH)
 TEST_F(LoggingTest, InitWithFileDescriptor) {
   const char kErrorLogMessage[] = "something bad happened";
@@ -910,6 +989,32 @@ TEST_F(LoggingTest, ScopedVmoduleSwitches) {
   }
 }
 
+namespace {
+// A single VLOG_IS_ON_CACHED() call site, whose cached level must follow the
+// changes of the vlog levels.
+bool IsVlogOneOn() {
+  return VLOG_IS_ON_CACHED(1);
+}
+}  // namespace
+
+TEST_F(LoggingTest, VlogLevelCacheIsInvalidated) {
+  SetMinLogLevel(LOGGING_INFO);
+  EXPECT_FALSE(IsVlogOneOn());
+  EXPECT_FALSE(IsVlogOneOn());
+
+  SetMinLogLevel(-1);
+  EXPECT_TRUE(IsVlogOneOn());
+
+  SetMinLogLevel(LOGGING_INFO);
+  EXPECT_FALSE(IsVlogOneOn());
+  {
+    ScopedVmoduleSwitches scoped_vmodule_switches;
+    scoped_vmodule_switches.InitWithSwitches(__FILE__ "=1");
+    EXPECT_TRUE(IsVlogOneOn());
+  }
+  EXPECT_FALSE(IsVlogOneOn());
+}
+
 TEST_F(LoggingTest, BuildCrashString) {
   EXPECT_EQ("file.cc:42: ",
             LogMessage("file.cc", 42, LOGGING_ERROR).BuildCrashString());
@@ -8,11 +8,16 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <bit>
 #include <ostream>
+#include <type_traits>
 
 #include "base/base_export.h"
 #include "base/check.h"
+#include "base/compiler_specific.h"
+#include "base/containers/heap_array.h"
+#include "base/numerics/checked_math.h"
 #include "build/build_config.h"
 
 #if defined(COMPILER_MSVC)
@@ -63,6 +68,30 @@ struct AlignedFreeDeleter {
   }
 };
 
+// A HeapArray of memory allocated by `AlignedAlloc`, e.g. for the buffers of
+// files opened with File::FLAG_DIRECT.
+template <typename T>
+using AlignedHeapArray = HeapArray<T, AlignedFreeDeleter>;
+
+// Allocates uninitialized memory for `size` elements of `T`, aligned to
+// `alignment`, which must be a power of 2 and a multiple of sizeof(void*).
+// No memory is allocated when `size` is 0.
+template <typename T>
+  requires(std::is_trivially_constructible_v<T> &&
+           std::is_trivially_destructible_v<T>)
+AlignedHeapArray<T> AlignedUninit(size_t size, size_t alignment) {
+  alignment = std::max(alignment, alignof(T));
+  if (!size) {
+    return AlignedHeapArray<T>();
+  }
+  // SAFETY: AlignedAlloc() returns memory of `size` elements of `T`, aligned
+  // for `T`, which AlignedFreeDeleter frees.
+  return UNSAFE_BUFFERS(AlignedHeapArray<T>::FromOwningPointer(
+      static_cast<T*>(AlignedAlloc(CheckMul(size, sizeof(T)).ValueOrDie(),
+                                   alignment)),
+      size));
+}
+
 #ifdef __has_builtin
 #define SUPPORTS_BUILTIN_IS_ALIGNED (__has_builtin(__builtin_is_aligned))
 #else
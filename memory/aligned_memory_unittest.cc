@@ -50,6 +50,20 @@ TEST(AlignedMemoryTest, ScopedDynamicAllocation) {
   EXPECT_TRUE(IsAligned(const_p, 8));
 }
 
+TEST(AlignedMemoryTest, AlignedUninit) {
+  AlignedHeapArray<uint8_t> bytes = AlignedUninit<uint8_t>(100, 4096);
+  EXPECT_EQ(100u, bytes.size());
+  EXPECT_TRUE(IsAligned(bytes.data(), 4096));
+  memset(bytes.data(), 0, bytes.size());  // Fill to check the size under ASAN.
+
+  // The alignment is at least that of the type.
+  AlignedHeapArray<double> doubles = AlignedUninit<double>(3, sizeof(void*));
+  EXPECT_EQ(3u, doubles.size());
+  EXPECT_TRUE(IsAligned(doubles.data(), alignof(double)));
+
+  EXPECT_TRUE(AlignedUninit<uint8_t>(0, 4096).empty());
+}
+
 TEST(AlignedMemoryTest, IsAligned) {
   // Check alignment around powers of two.
   for (int i = 0; i < 64; ++i) {
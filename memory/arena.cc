@@ -0,0 +1,175 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/arena.h"
+
+#include <array>
+#include <memory>
+
+#include "base/no_destructor.h"
+#include "base/threading/thread_local.h"
+
+namespace base {
+
+struct alignas(std::max_align_t) Arena::Chunk {
+  uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+  uint8_t* end() { return reinterpret_cast<uint8_t*>(this) + size; }
+
+  RAW_PTR_EXCLUSION Chunk* next;
+  size_t size;
+};
+
+namespace {
+
+// The number of chunks of kDefaultChunkSize which each thread keeps around for
+// the next arenas.
+constexpr size_t kMaxCachedChunks = 4;
+
+// The memory of the chunks comes from operator new, which is PartitionAlloc
+// where it is the default allocator.
+class ChunkCache {
+ public:
+  ChunkCache() = default;
+  ChunkCache(const ChunkCache&) = delete;
+  ChunkCache& operator=(const ChunkCache&) = delete;
+  ~ChunkCache() {
+    for (size_t i = 0; i < size_; ++i) {
+      ::operator delete(chunks_[i]);
+    }
+  }
+
+  // Returns a chunk of kDefaultChunkSize bytes, or null if there is none.
+  void* Take() { return size_ ? chunks_[--size_] : nullptr; }
+
+  // Returns whether `chunk` was kept.
+  bool Put(void* chunk) {
+    if (size_ == kMaxCachedChunks) {
+      return false;
+    }
+    chunks_[size_++] = chunk;
+    return true;
+  }
+
+ private:
+  RAW_PTR_EXCLUSION std::array<void*, kMaxCachedChunks> chunks_;
+  size_t size_ = 0;
+};
+
+ChunkCache& GetChunkCache() {
+  static NoDestructor<ThreadLocalOwnedPointer<ChunkCache>> cache;
+  if (!cache->Get()) {
+    cache->Set(std::make_unique<ChunkCache>());
+  }
+  return *cache->Get();
+}
+
+}  // namespace
+
+Arena::Arena() : Arena(kDefaultChunkSize) {}
+
+Arena::Arena(size_t chunk_size) : chunk_size_(chunk_size) {
+  // Room for the bookkeeping and a few allocations.
+  CHECK_GE(chunk_size_, 4 * sizeof(Chunk));
+}
+
+Arena::~Arena() {
+  RunDestructors();
+  while (chunks_) {
+    FreeChunk(std::exchange(chunks_, chunks_->next));
+  }
+}
+
+void Arena::Reset() {
+  RunDestructors();
+
+  // Keep the most recent chunk of the regular size.
+  Chunk* kept = nullptr;
+  while (chunks_) {
+    Chunk* chunk = std::exchange(chunks_, chunks_->next);
+    if (!kept && chunk->size == chunk_size_) {
+      kept = chunk;
+    } else {
+      FreeChunk(chunk);
+    }
+  }
+  chunks_ = kept;
+  if (kept) {
+    kept->next = nullptr;
+    current_ = kept->data();
+    end_ = kept->end();
+  } else {
+    current_ = end_ = nullptr;
+  }
+  bytes_allocated_ = 0;
+}
+
+void* Arena::AllocateSlow(size_t size, size_t alignment) {
+  const size_t max_size = (chunk_size_ - sizeof(Chunk)) / 4;
+  if (size > max_size || alignment > max_size) {
+    // Allocated in a chunk of its own, so that the current chunk can still be
+    // used.
+    CHECK_LE(size, SIZE_MAX - sizeof(Chunk) - alignment);
+    Chunk* chunk = AddChunk(sizeof(Chunk) + size + alignment - 1);
+    bytes_allocated_ += size;
+    return reinterpret_cast<void*>(
+        (reinterpret_cast<uintptr_t>(chunk->data()) + alignment - 1) &
+        ~(alignment - 1));
+  }
+
+  // The rest of the current chunk is wasted, which is at most a quarter of it
+  // since the allocation didn't fit.
+  Chunk* chunk = AddChunk(chunk_size_);
+  current_ = chunk->data();
+  end_ = chunk->end();
+  return Allocate(size, alignment);
+}
+
+void Arena::RunDestructors() {
+  // Destructors may create more objects, which are then destroyed first.
+  while (destructors_) {
+    Destructor* destructor = std::exchange(destructors_, destructors_->next);
+    destructor->destroy(destructor->object);
+  }
+}
+
+Arena::Chunk* Arena::AddChunk(size_t size) {
+  void* memory = nullptr;
+  if (size == kDefaultChunkSize) {
+    memory = GetChunkCache().Take();
+  }
+  if (!memory) {
+    memory = ::operator new(size);
+  }
+  chunks_ = new (memory) Chunk{chunks_, size};
+  bytes_reserved_ += size;
+  return chunks_;
+}
+
+void Arena::FreeChunk(Chunk* chunk) {
+  const size_t size = chunk->size;
+  bytes_reserved_ -= size;
+  if (size == kDefaultChunkSize && GetChunkCache().Put(chunk)) {
+    return;
+  }
+  ::operator delete(chunk);
+}
+
+ArenaMemoryResource::ArenaMemoryResource(Arena& arena) : arena_(arena) {}
+
+ArenaMemoryResource::~ArenaMemoryResource() = default;
+
+void* ArenaMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+  return arena_->Allocate(bytes, alignment);
+}
+
+void ArenaMemoryResource::do_deallocate(void* p,
+                                        size_t bytes,
+                                        size_t alignment) {}
+
+bool ArenaMemoryResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+}  // namespace base
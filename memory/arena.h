@@ -0,0 +1,181 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_ARENA_H_
+#define BASE_MEMORY_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <bit>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "base/base_export.h"
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/memory/raw_ptr_exclusion.h"
+#include "base/memory/raw_ref.h"
+
+namespace base {
+
+// Arena is a bump allocator: it hands out memory from large chunks, and frees
+// all of it at once when it is reset or destroyed. Allocating is a pointer
+// increment, and freeing everything is O(1) in the number of allocations, plus
+// the destructors of the objects which have one. This suits request-scoped
+// work which builds many small objects that all die together, such as the
+// nodes of a parse tree.
+//
+// Arena is not thread-safe, but it takes no lock: like a container, each arena
+// should be used from one sequence at a time. The chunks of the default size
+// are recycled through a small per-thread cache, so that arenas which are
+// created and destroyed repeatedly on a thread rarely reach the allocator.
+//
+// Example usage:
+//   base::Arena arena;
+//   Node* root = arena.New<Node>(...);
+//   root->children = arena.New<std::vector<Node*>>();
+//   ...
+//   arena.Reset();  // Destroys the vector and frees everything.
+//
+// To use an arena with std::pmr containers, or with base containers that are
+// backed by one (e.g. base::flat_map<K, V, std::less<>,
+// std::pmr::vector<std::pair<K, V>>>), see ArenaMemoryResource below.
+class BASE_EXPORT Arena {
+ public:
+  // The size of the chunks, including the bookkeeping at their start.
+  static constexpr size_t kDefaultChunkSize = 16 * 1024;
+
+  Arena();
+  // Chunks of sizes other than kDefaultChunkSize aren't recycled.
+  explicit Arena(size_t chunk_size);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Destroys the objects made with New(), in the reverse order of their
+  // creation, then frees the memory.
+  ~Arena();
+
+  // Returns `size` uninitialized bytes aligned to `alignment`, which must be a
+  // power of two. The memory is valid until Reset() or the destruction of the
+  // arena. Allocations larger than a quarter of a chunk get a chunk of their
+  // own.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    DCHECK(std::has_single_bit(alignment));
+    const uintptr_t aligned =
+        (reinterpret_cast<uintptr_t>(current_) + alignment - 1) &
+        ~(alignment - 1);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(end_);
+    if (aligned < end && size <= end - aligned) [[likely]] {
+      current_ = reinterpret_cast<uint8_t*>(aligned + size);
+      bytes_allocated_ += size;
+      return reinterpret_cast<void*>(aligned);
+    }
+    return AllocateSlow(size, alignment);
+  }
+
+  // Constructs a T from `args` in the arena. If T isn't trivially
+  // destructible, its destructor is run by Reset() or ~Arena().
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    if constexpr (std::is_trivially_destructible_v<T>) {
+      return new (Allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+    } else {
+      void* node = Allocate(sizeof(Destructor), alignof(Destructor));
+      T* object = new (Allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+      // Registered once the object is built, so that the objects created by
+      // its constructor, if any, are destroyed after it.
+      destructors_ = new (node) Destructor{
+          [](void* object) { static_cast<T*>(object)->~T(); }, object,
+          destructors_};
+      return object;
+    }
+  }
+
+  // Returns an array of `count` value-initialized Ts in the arena.
+  template <typename T>
+    requires(std::is_trivially_destructible_v<T>)
+  T* NewArray(size_t count) {
+    CHECK_LE(count, SIZE_MAX / sizeof(T));
+    return new (Allocate(count * sizeof(T), alignof(T))) T[count]();
+  }
+
+  // Destroys the objects made with New(), frees all the allocations, and
+  // keeps one chunk to allocate from.
+  void Reset();
+
+  // The number of bytes returned by Allocate() since the last Reset().
+  size_t bytes_allocated() const { return bytes_allocated_; }
+
+  // The size of the chunks held by the arena.
+  size_t bytes_reserved() const { return bytes_reserved_; }
+
+ private:
+  struct Chunk;
+
+  struct Destructor {
+    void (*destroy)(void*);
+    RAW_PTR_EXCLUSION void* object;
+    RAW_PTR_EXCLUSION Destructor* next;
+  };
+
+  void* AllocateSlow(size_t size, size_t alignment);
+  void RunDestructors();
+
+  // Returns a new chunk of `size` bytes, at the head of `chunks_`.
+  Chunk* AddChunk(size_t size);
+  void FreeChunk(Chunk* chunk);
+
+  const size_t chunk_size_;
+
+  // The free bytes of the current chunk. Not raw_ptr<> for performance:
+  // Allocate() is the hot path, and these point into chunks owned by the
+  // arena.
+  RAW_PTR_EXCLUSION uint8_t* current_ = nullptr;
+  RAW_PTR_EXCLUSION uint8_t* end_ = nullptr;
+
+  // The chunks, most recent first, and the objects to destroy, most recent
+  // first. Both live in the chunks.
+  RAW_PTR_EXCLUSION Chunk* chunks_ = nullptr;
+  RAW_PTR_EXCLUSION Destructor* destructors_ = nullptr;
+
+  size_t bytes_allocated_ = 0;
+  size_t bytes_reserved_ = 0;
+};
+
+// A std::pmr::memory_resource which allocates from an Arena, so that std::pmr
+// containers can use it:
+//   base::Arena arena;
+//   base::ArenaMemoryResource resource(arena);
+//   std::pmr::vector<int> values(&resource);
+//
+// Deallocating is a no-op: the memory is freed with the arena. Containers
+// which grow by reallocating, like vectors, leave their old buffers in the
+// arena, so reserve() them when their size is known. The resource must
+// outlive the containers, and the arena must outlive the resource.
+class BASE_EXPORT ArenaMemoryResource : public std::pmr::memory_resource {
+ public:
+  explicit ArenaMemoryResource(Arena& arena);
+  ~ArenaMemoryResource() override;
+
+  Arena& arena() { return *arena_; }
+
+ private:
+  // std::pmr::memory_resource:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+  const raw_ref<Arena> arena_;
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_ARENA_H_
@@ -0,0 +1,187 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/arena.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/raw_ref.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+bool IsAligned(const void* p, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+// Appends its id to `destroyed` when destroyed.
+class Tracked {
+ public:
+  Tracked(int id, std::vector<int>& destroyed)
+      : id_(id), destroyed_(destroyed) {}
+  ~Tracked() { destroyed_->push_back(id_); }
+
+  int id() const { return id_; }
+
+ private:
+  int id_;
+  raw_ref<std::vector<int>> destroyed_;
+};
+
+}  // namespace
+
+TEST(ArenaTest, Allocate) {
+  Arena arena;
+  EXPECT_EQ(0u, arena.bytes_reserved());
+
+  std::vector<uint8_t*> allocations;
+  for (size_t i = 1; i < 100; ++i) {
+    uint8_t* p = static_cast<uint8_t*>(arena.Allocate(i, 1));
+    memset(p, static_cast<int>(i), i);
+    allocations.push_back(p);
+  }
+  // Each allocation kept its content.
+  for (size_t i = 1; i < 100; ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      EXPECT_EQ(i, allocations[i - 1][j]);
+    }
+  }
+  EXPECT_EQ(99u * 100u / 2u, arena.bytes_allocated());
+  EXPECT_EQ(Arena::kDefaultChunkSize, arena.bytes_reserved());
+}
+
+TEST(ArenaTest, Alignment) {
+  Arena arena;
+  for (size_t alignment = 1; alignment <= 4096; alignment *= 2) {
+    arena.Allocate(1, 1);
+    void* p = arena.Allocate(8, alignment);
+    EXPECT_TRUE(IsAligned(p, alignment)) << alignment;
+  }
+  EXPECT_TRUE(IsAligned(arena.Allocate(3), alignof(std::max_align_t)));
+  EXPECT_TRUE(IsAligned(arena.Allocate(3), alignof(std::max_align_t)));
+  EXPECT_TRUE(IsAligned(arena.Allocate(8, 65536), 65536));
+}
+
+TEST(ArenaTest, LargeAllocations) {
+  Arena arena;
+  arena.Allocate(16);
+  const size_t reserved = arena.bytes_reserved();
+
+  // Large allocations get their own chunk, and the current chunk is kept.
+  uint8_t* large = static_cast<uint8_t*>(arena.Allocate(100000));
+  memset(large, 1, 100000);
+  EXPECT_GE(arena.bytes_reserved(), reserved + 100000);
+  uint8_t* small = static_cast<uint8_t*>(arena.Allocate(16));
+  EXPECT_FALSE(small >= large && small < large + 100000);
+
+  arena.Reset();
+  EXPECT_EQ(0u, arena.bytes_allocated());
+  EXPECT_EQ(Arena::kDefaultChunkSize, arena.bytes_reserved());
+}
+
+TEST(ArenaTest, ChunkSize) {
+  Arena arena(1024);
+  for (int i = 0; i < 100; ++i) {
+    arena.Allocate(100, 4);
+  }
+  EXPECT_EQ(10u * 1024u, arena.bytes_reserved());
+  EXPECT_EQ(10000u, arena.bytes_allocated());
+
+  arena.Reset();
+  EXPECT_EQ(1024u, arena.bytes_reserved());
+}
+
+TEST(ArenaTest, New) {
+  Arena arena;
+  int* value = arena.New<int>(42);
+  EXPECT_EQ(42, *value);
+  int* array = arena.NewArray<int>(10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(0, array[i]);
+  }
+
+  auto* strings = arena.New<std::vector<std::string>>(3, "abc");
+  strings->push_back(std::string(100, 'x'));
+  EXPECT_EQ(4u, strings->size());
+  EXPECT_EQ("abc", (*strings)[0]);
+}
+
+TEST(ArenaTest, Destructors) {
+  std::vector<int> destroyed;
+  {
+    Arena arena;
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(i, arena.New<Tracked>(i, destroyed)->id());
+    }
+    arena.Reset();
+    EXPECT_EQ((std::vector<int>{2, 1, 0}), destroyed);
+
+    arena.New<Tracked>(3, destroyed);
+    arena.New<Tracked>(4, destroyed);
+  }
+  EXPECT_EQ((std::vector<int>{2, 1, 0, 4, 3}), destroyed);
+}
+
+TEST(ArenaTest, DestructorsOfNestedObjects) {
+  // An object which creates another one in the arena is destroyed first.
+  struct Outer {
+    Outer(Arena& arena, std::vector<int>& destroyed)
+        : inner(arena.New<Tracked>(1, destroyed)), tracked(0, destroyed) {}
+    raw_ptr<Tracked> inner;
+    Tracked tracked;
+  };
+
+  std::vector<int> destroyed;
+  {
+    Arena arena;
+    arena.New<Outer>(arena, destroyed);
+  }
+  EXPECT_EQ((std::vector<int>{0, 1}), destroyed);
+}
+
+TEST(ArenaTest, RecyclesChunks) {
+  void* first = nullptr;
+  {
+    Arena arena;
+    first = arena.Allocate(16);
+  }
+  // The chunk went back to the thread's cache.
+  Arena arena;
+  EXPECT_EQ(first, arena.Allocate(16));
+}
+
+TEST(ArenaTest, MemoryResource) {
+  Arena arena;
+  ArenaMemoryResource resource(arena);
+  EXPECT_TRUE(resource.is_equal(resource));
+  EXPECT_FALSE(resource.is_equal(*std::pmr::new_delete_resource()));
+
+  std::pmr::vector<int> values(&resource);
+  values.reserve(100);
+  for (int i = 0; i < 100; ++i) {
+    values.push_back(i);
+  }
+  EXPECT_EQ(100 * sizeof(int), arena.bytes_allocated());
+  EXPECT_EQ(99, values.back());
+
+  // base containers backed by a std::pmr container work too.
+  using PmrVector = std::pmr::vector<std::pair<int, int>>;
+  flat_map<int, int, std::less<>, PmrVector> map(PmrVector{&resource});
+  map[2] = 3;
+  map[1] = 2;
+  EXPECT_EQ(2u, map.size());
+  EXPECT_EQ(1, map.begin()->first);
+  EXPECT_GT(arena.bytes_allocated(), 100 * sizeof(int));
+}
+
+}  // namespace base
@@ -0,0 +1,308 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/biased_ref_counted.h"
+
+#include <limits>
+#include <vector>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/compiler_specific.h"
+#include "base/memory/raw_ptr.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/thread_local_storage.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
+
+namespace base::subtle {
+
+// The objects created by a thread, whose counts it has yet to merge.
+//
+// Objects may point to it after the thread exited, so it's deleted once the
+// thread exited and none of its objects points to it anymore.
+class BiasedRefCountedBase::Owner {
+ public:
+  Owner() = default;
+  Owner(const Owner&) = delete;
+  Owner& operator=(const Owner&) = delete;
+
+  // Returns null if the current thread is exiting.
+  static Owner* GetOrCreateForCurrentThread();
+  static Owner* GetForCurrentThread();
+
+  // Called on the owner thread when an object starts or stops pointing to
+  // this.
+  void AddObject() { ++num_objects_; }
+  void RemoveObject() {
+    DCHECK_GT(num_objects_, 0u);
+    --num_objects_;
+  }
+
+  bool HasPendingMerges() const {
+    return has_pending_merges_.load(std::memory_order_relaxed);
+  }
+
+  // Queues the counts of `object` to be merged on the owner thread. Merges
+  // them right away if it exited, and returns true if `object` should then
+  // self-delete.
+  bool QueueMerge(const BiasedRefCountedBase* object,
+                  DestructFunction destruct);
+
+  // Merges the queued counts, and deletes the objects which have no reference
+  // left. Called on the owner thread.
+  void MergePending();
+
+ private:
+  struct PendingMerge {
+    raw_ptr<const BiasedRefCountedBase> object;
+    DestructFunction destruct;
+  };
+
+  static void OnThreadExit(void* owner);
+  static ThreadLocalStorage::Slot& GetExitSlot();
+
+  static thread_local Owner* current_;
+  static thread_local bool current_exited_;
+
+  Lock lock_;
+  bool exited_ GUARDED_BY(lock_) = false;
+  std::vector<PendingMerge> pending_merges_ GUARDED_BY(lock_);
+  std::atomic<bool> has_pending_merges_{false};
+  // The objects which point to this, including the queued ones. Only accessed
+  // on the owner thread until `exited_` is set, and under `lock_` afterwards.
+  size_t num_objects_ = 0;
+};
+
+ABSL_CONST_INIT thread_local BiasedRefCountedBase::Owner*
+    BiasedRefCountedBase::Owner::current_ = nullptr;
+ABSL_CONST_INIT thread_local bool
+    BiasedRefCountedBase::Owner::current_exited_ = false;
+
+// static
+BiasedRefCountedBase::Owner*
+BiasedRefCountedBase::Owner::GetOrCreateForCurrentThread() {
+  if (current_) [[likely]] {
+    return current_;
+  }
+  if (current_exited_) {
+    return nullptr;
+  }
+  current_ = new Owner();
+  // The slot is only used to be notified of the thread exit.
+  GetExitSlot().Set(current_);
+  return current_;
+}
+
+// static
+BiasedRefCountedBase::Owner*
+BiasedRefCountedBase::Owner::GetForCurrentThread() {
+  return current_;
+}
+
+bool BiasedRefCountedBase::Owner::QueueMerge(
+    const BiasedRefCountedBase* object,
+    DestructFunction destruct) {
+  bool delete_self;
+  {
+    AutoLock lock(lock_);
+    if (!exited_) {
+      pending_merges_.push_back({object, destruct});
+      has_pending_merges_.store(true, std::memory_order_relaxed);
+      return false;
+    }
+    // `object` stops pointing to this when merged below.
+    DCHECK_GT(num_objects_, 0u);
+    delete_self = --num_objects_ == 0;
+  }
+  if (delete_self) {
+    delete this;
+  }
+  // The owner won't touch `biased_count_` anymore, and `lock_` orders its last
+  // accesses before this.
+  return object->Merge();
+}
+
+void BiasedRefCountedBase::Owner::MergePending() {
+  std::vector<PendingMerge> pending_merges;
+  {
+    AutoLock lock(lock_);
+    pending_merges.swap(pending_merges_);
+    has_pending_merges_.store(false, std::memory_order_relaxed);
+  }
+  for (PendingMerge& pending_merge : pending_merges) {
+    const BiasedRefCountedBase* object = pending_merge.object;
+    pending_merge.object = nullptr;
+    RemoveObject();
+    if (object->Merge()) {
+      pending_merge.destruct(object);
+    }
+  }
+}
+
+// static
+void BiasedRefCountedBase::Owner::OnThreadExit(void* owner) {
+  DCHECK_EQ(owner, current_);
+  // The objects released from now on, e.g. in other thread-local storage
+  // destructors, use atomic operations.
+  current_ = nullptr;
+  current_exited_ = true;
+
+  // From now on, the threads which queue objects merge them right away. Merge
+  // the ones which were queued before.
+  auto* self = static_cast<Owner*>(owner);
+  std::vector<PendingMerge> pending_merges;
+  bool delete_self;
+  {
+    AutoLock lock(self->lock_);
+    self->exited_ = true;
+    pending_merges.swap(self->pending_merges_);
+    self->has_pending_merges_.store(false, std::memory_order_relaxed);
+    DCHECK_GE(self->num_objects_, pending_merges.size());
+    self->num_objects_ -= pending_merges.size();
+    delete_self = self->num_objects_ == 0;
+  }
+  // `self` may be deleted by another thread from here on, unless this deletes
+  // it.
+  if (delete_self) {
+    delete self;
+  }
+  for (PendingMerge& pending_merge : pending_merges) {
+    const BiasedRefCountedBase* object = pending_merge.object;
+    pending_merge.object = nullptr;
+    if (object->Merge()) {
+      pending_merge.destruct(object);
+    }
+  }
+}
+
+// static
+ThreadLocalStorage::Slot& BiasedRefCountedBase::Owner::GetExitSlot() {
+  static NoDestructor<ThreadLocalStorage::Slot> slot(&OnThreadExit);
+  return *slot;
+}
+
+BiasedRefCountedBase::BiasedRefCountedBase()
+    : owner_(Owner::GetOrCreateForCurrentThread()) {
+  Owner* owner = owner_.load(std::memory_order_relaxed);
+  if (!owner) {
+    shared_count_.store(kMerged, std::memory_order_relaxed);
+    return;
+  }
+  owner->AddObject();
+}
+
+bool BiasedRefCountedBase::HasOneRef() const {
+  return biased_count_.load(std::memory_order_relaxed) +
+             GetCount(shared_count_.load(std::memory_order_acquire)) ==
+         1;
+}
+
+bool BiasedRefCountedBase::HasAtLeastOneRef() const {
+  return biased_count_.load(std::memory_order_relaxed) +
+             GetCount(shared_count_.load(std::memory_order_acquire)) >
+         0;
+}
+
+void BiasedRefCountedBase::AddRef() const {
+  Owner* current = Owner::GetForCurrentThread();
+  if (current && owner_.load(std::memory_order_relaxed) == current) {
+    const int32_t biased_count = biased_count_.load(std::memory_order_relaxed);
+    CHECK_NE(biased_count, std::numeric_limits<int32_t>::max());
+    biased_count_.store(biased_count + 1, std::memory_order_relaxed);
+    return;
+  }
+  constexpr int32_t kMaxCount = GetCount(std::numeric_limits<int32_t>::max());
+  const int32_t shared_count =
+      shared_count_.fetch_add(kCountIncrement, std::memory_order_relaxed);
+  CHECK_NE(GetCount(shared_count), kMaxCount);
+}
+
+bool BiasedRefCountedBase::Release(DestructFunction destruct) const {
+  Owner* current = Owner::GetForCurrentThread();
+  if (current && owner_.load(std::memory_order_relaxed) == current) {
+    const int32_t biased_count =
+        biased_count_.load(std::memory_order_relaxed) - 1;
+    DCHECK_GE(biased_count, 0);
+    biased_count_.store(biased_count, std::memory_order_relaxed);
+    const bool should_delete =
+        biased_count == 0 && ReleaseBiasedLast(current);
+    // `this` may be deleted from here on, if it was queued.
+    if (current->HasPendingMerges()) [[unlikely]] {
+      current->MergePending();
+    }
+    return should_delete;
+  }
+  return ReleaseShared(destruct);
+}
+
+bool BiasedRefCountedBase::Merge() const {
+  const int32_t biased_count =
+      biased_count_.exchange(0, std::memory_order_relaxed);
+  owner_.store(nullptr, std::memory_order_relaxed);
+  int32_t shared_count = shared_count_.load(std::memory_order_relaxed);
+  int32_t merged_count;
+  do {
+    DCHECK(shared_count & kQueued);
+    merged_count =
+        ((shared_count + biased_count * kCountIncrement) & ~kQueued) | kMerged;
+  } while (!shared_count_.compare_exchange_weak(shared_count, merged_count,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
+  DCHECK_GE(GetCount(merged_count), 0);
+  return GetCount(merged_count) == 0;
+}
+
+bool BiasedRefCountedBase::ReleaseBiasedLast(Owner* owner) const {
+  // Cleared first, as the object may be deleted by another thread as soon as
+  // `kMerged` is set.
+  owner_.store(nullptr, std::memory_order_relaxed);
+  const int32_t shared_count =
+      shared_count_.fetch_or(kMerged, std::memory_order_acq_rel);
+  // A queued object is deleted once the queue is processed, not to leave a
+  // dangling pointer in it.
+  if (shared_count & kQueued) {
+    return false;
+  }
+  owner->RemoveObject();
+  DCHECK_GE(GetCount(shared_count), 0);
+  return GetCount(shared_count) == 0;
+}
+
+bool BiasedRefCountedBase::ReleaseShared(DestructFunction destruct) const {
+  // Read before releasing, as the owner clears it before setting `kMerged` in
+  // ReleaseBiasedLast(). If it's already cleared, the owner is about to merge
+  // the counts, and the object doesn't need to be queued.
+  Owner* const owner = owner_.load(std::memory_order_relaxed);
+  int32_t shared_count = shared_count_.load(std::memory_order_relaxed);
+  int32_t released_count;
+  bool needs_merge;
+  do {
+    released_count = shared_count - kCountIncrement;
+    // Only the first release to go below zero queues the object. So does the
+    // release of the last shared reference, if the owner holds none: it may
+    // never take one, e.g. if it only created the object for other threads.
+    // If it does concurrently, the merge below finds its references.
+    needs_merge = owner && !(released_count & (kMerged | kQueued)) &&
+                  (GetCount(released_count) < 0 ||
+                   (GetCount(released_count) == 0 &&
+                    biased_count_.load(std::memory_order_relaxed) == 0));
+    if (needs_merge) {
+      released_count |= kQueued;
+    }
+  } while (!shared_count_.compare_exchange_weak(shared_count, released_count,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
+  if (released_count & kMerged) {
+    return GetCount(released_count) == 0 && !(released_count & kQueued);
+  }
+  if (!needs_merge) {
+    return false;
+  }
+  // `owner` can't be deleted before it merges the object.
+  return owner->QueueMerge(this, destruct);
+}
+
+}  // namespace base::subtle
@@ -0,0 +1,158 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_BIASED_REF_COUNTED_H_
+#define BASE_MEMORY_BIASED_REF_COUNTED_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_refptr.h"
+
+namespace base {
+
+namespace subtle {
+
+// Biased reference counting, after "Biased Reference Counting: Minimizing
+// Atomic Operations in Garbage Collection" (Choi et al., PACT 2018).
+//
+// The thread which creates the object owns it: its references are counted
+// with relaxed loads and stores in `biased_count_`, which compile to plain
+// moves. The references of other threads are counted with atomic
+// read-modify-write operations in `shared_count_`, which can go negative when
+// they release references taken by the owner. Once the owner releases all of
+// the references it counted, the two counts are merged and the object is an
+// ordinary thread-safe ref counted object.
+//
+// When another thread takes the shared count below zero, the owner may have
+// handed it its last references (e.g. in a bound task argument), and may
+// never release the object again. The same goes when another thread releases
+// the last shared reference while the owner holds none, e.g. because it never
+// took one. The object is then queued for the owner to merge the counts, the
+// next time it releases any biased object, or when it exits.
+//
+// AddRef() and Release() aren't inline, as they look up the current thread in
+// a thread_local, which can't be exported from base.
+class BASE_EXPORT BiasedRefCountedBase {
+ public:
+  BiasedRefCountedBase(const BiasedRefCountedBase&) = delete;
+  BiasedRefCountedBase& operator=(const BiasedRefCountedBase&) = delete;
+
+  // Exact on the owner thread, or once the counts are merged. Otherwise, may
+  // miss the references being taken or released concurrently on the owner
+  // thread.
+  bool HasOneRef() const;
+  bool HasAtLeastOneRef() const;
+
+ protected:
+  // Deletes an object, whose count was merged on its owner thread.
+  using DestructFunction = void (*)(const BiasedRefCountedBase*);
+
+  BiasedRefCountedBase();
+  ~BiasedRefCountedBase() = default;
+
+  void AddRef() const;
+  // Returns true if the object should self-delete.
+  bool Release(DestructFunction destruct) const;
+
+ private:
+  class Owner;
+
+  // `shared_count_` holds the count in its high bits, and these flags.
+  static constexpr int32_t kMerged = 1;
+  static constexpr int32_t kQueued = 2;
+  static constexpr int32_t kCountIncrement = 4;
+
+  static constexpr int32_t GetCount(int32_t shared_count) {
+    return shared_count >> 2;
+  }
+
+  // Merges `biased_count_` into `shared_count_`, on the owner thread or after
+  // it exited. Returns true if the object should self-delete.
+  bool Merge() const;
+  // Called on the owner thread when `biased_count_` drops to 0.
+  bool ReleaseBiasedLast(Owner* owner) const;
+  bool ReleaseShared(DestructFunction destruct) const;
+
+  // The thread whose references are counted in `biased_count_`, or null once
+  // all of the references are counted in `shared_count_`.
+  mutable std::atomic<Owner*> owner_;
+  mutable std::atomic<int32_t> biased_count_{0};
+  mutable std::atomic<int32_t> shared_count_{0};
+};
+
+}  // namespace subtle
+
+template <class T, typename Traits>
+class BiasedRefCounted;
+
+// Default traits for BiasedRefCounted<T>. Deletes the object when its ref
+// count reaches 0. Overload to delete it on a different thread etc.
+template <typename T>
+struct DefaultBiasedRefCountedTraits {
+  static void Destruct(const T* x) {
+    BiasedRefCounted<T, DefaultBiasedRefCountedTraits>::DeleteInternal(x);
+  }
+};
+
+// A variant of RefCountedThreadSafe<T> for objects which are mostly used on
+// the thread which creates them, but may be shared with others. AddRef() and
+// Release() on the creating thread don't take atomic operations, which avoids
+// their cost on hot paths where many references are taken and released.
+// References can be taken, released and passed across threads as with
+// RefCountedThreadSafe<T>, at the cost of an atomic operation each.
+//
+//   class MyFoo : public base::BiasedRefCounted<MyFoo> {
+//    ...
+//    private:
+//     friend class base::BiasedRefCounted<MyFoo>;
+//     ~MyFoo();
+//   };
+//
+// If the last reference is released on another thread than the creating one,
+// the object may be deleted on the creating thread, some time later. Prefer
+// RefCountedThreadSafe<T> for objects which are mostly used on other threads
+// than the creating one, or which must be deleted as soon as their last
+// reference is released.
+template <class T, typename Traits = DefaultBiasedRefCountedTraits<T>>
+class BiasedRefCounted : public subtle::BiasedRefCountedBase {
+ public:
+  using RefCountPreferenceTag = subtle::StartRefCountFromZeroTag;
+
+  BiasedRefCounted() = default;
+
+  BiasedRefCounted(const BiasedRefCounted&) = delete;
+  BiasedRefCounted& operator=(const BiasedRefCounted&) = delete;
+
+  void AddRef() const { subtle::BiasedRefCountedBase::AddRef(); }
+
+  void Release() const {
+    if (subtle::BiasedRefCountedBase::Release(&Destruct)) {
+      ANALYZER_SKIP_THIS_PATH();
+      Traits::Destruct(static_cast<const T*>(this));
+    }
+  }
+
+ protected:
+  ~BiasedRefCounted() = default;
+
+ private:
+  friend struct DefaultBiasedRefCountedTraits<T>;
+  template <typename U>
+  static void DeleteInternal(const U* x) {
+    delete x;
+  }
+
+  static void Destruct(const subtle::BiasedRefCountedBase* x) {
+    Traits::Destruct(
+        static_cast<const T*>(static_cast<const BiasedRefCounted*>(x)));
+  }
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_BIASED_REF_COUNTED_H_
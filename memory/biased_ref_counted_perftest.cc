@@ -0,0 +1,87 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/compiler_specific.h"
+#include "base/memory/biased_ref_counted.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file contains tests to measure the cost of taking and releasing a
+// reference on the thread which created the object, for:
+// - RefCounted, which uses no atomic operation.
+// - RefCountedThreadSafe, which uses atomic operations.
+// - BiasedRefCounted, which uses no atomic operation on the creating thread.
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixRefCounted[] = "RefCounted.";
+constexpr char kMetricOperationThroughput[] = "operation_throughput";
+constexpr int kNumIterations = 10000000;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixRefCounted, story_name);
+  reporter.RegisterImportantMetric(kMetricOperationThroughput, "operations/ms");
+  return reporter;
+}
+
+class NotThreadSafe : public RefCounted<NotThreadSafe> {
+ private:
+  friend class RefCounted<NotThreadSafe>;
+  ~NotThreadSafe() = default;
+};
+
+class ThreadSafe : public RefCountedThreadSafe<ThreadSafe> {
+ private:
+  friend class RefCountedThreadSafe<ThreadSafe>;
+  ~ThreadSafe() = default;
+};
+
+class Biased : public BiasedRefCounted<Biased> {
+ private:
+  friend class BiasedRefCounted<Biased>;
+  ~Biased() = default;
+};
+
+// Not inlined, so that the compiler can't elide the reference.
+template <typename T>
+NOINLINE void TakeReference(scoped_refptr<T> reference) {}
+
+template <typename T>
+void RunAddRefReleasePerfTest(const std::string& story_name) {
+  auto object = MakeRefCounted<T>();
+
+  TimeTicks start_time = TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    TakeReference(object);
+  }
+  TimeTicks end_time = TimeTicks::Now();
+
+  auto reporter = SetUpReporter(story_name);
+  reporter.AddResult(
+      kMetricOperationThroughput,
+      kNumIterations / (end_time - start_time).InMillisecondsF());
+}
+
+}  // namespace
+
+TEST(RefCountedPerfTest, NotThreadSafe) {
+  RunAddRefReleasePerfTest<NotThreadSafe>("NotThreadSafe");
+}
+
+TEST(RefCountedPerfTest, ThreadSafe) {
+  RunAddRefReleasePerfTest<ThreadSafe>("ThreadSafe");
+}
+
+TEST(RefCountedPerfTest, Biased) {
+  RunAddRefReleasePerfTest<Biased>("Biased");
+}
+
+}  // namespace base
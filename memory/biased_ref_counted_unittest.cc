@@ -0,0 +1,272 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/biased_ref_counted.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
+#include "base/memory/raw_ptr.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class BiasedObject : public BiasedRefCounted<BiasedObject> {
+ public:
+  // `destructor_thread` is set to the thread which deletes the object.
+  explicit BiasedObject(PlatformThreadRef* destructor_thread)
+      : destructor_thread_(destructor_thread) {}
+
+ private:
+  friend class BiasedRefCounted<BiasedObject>;
+  ~BiasedObject() { *destructor_thread_ = PlatformThread::CurrentRef(); }
+
+  const raw_ptr<PlatformThreadRef> destructor_thread_;
+};
+
+class ClosureThread : public SimpleThread {
+ public:
+  explicit ClosureThread(OnceClosure closure)
+      : SimpleThread("ClosureThread"), closure_(std::move(closure)) {}
+
+  // SimpleThread:
+  void Run() override { std::move(closure_).Run(); }
+
+ private:
+  OnceClosure closure_;
+};
+
+// Runs `closure` on another thread, which exits before this returns.
+void RunOnOtherThread(OnceClosure closure) {
+  ClosureThread thread(std::move(closure));
+  thread.Start();
+  thread.Join();
+}
+
+}  // namespace
+
+TEST(BiasedRefCountedTest, OwnerThread) {
+  PlatformThreadRef destructor_thread;
+  auto object = MakeRefCounted<BiasedObject>(&destructor_thread);
+  scoped_refptr<BiasedObject> copy = object;
+  object.reset();
+  EXPECT_TRUE(destructor_thread.is_null());
+  copy.reset();
+  EXPECT_EQ(destructor_thread, PlatformThread::CurrentRef());
+}
+
+TEST(BiasedRefCountedTest, HasOneRef) {
+  PlatformThreadRef destructor_thread;
+  auto object = MakeRefCounted<BiasedObject>(&destructor_thread);
+  EXPECT_TRUE(object->HasOneRef());
+  scoped_refptr<BiasedObject> copy = object;
+  EXPECT_FALSE(object->HasOneRef());
+
+  // The counts of the other thread are added.
+  RunOnOtherThread(BindOnce([](scoped_refptr<BiasedObject> copy) {},
+                            std::move(copy)));
+  EXPECT_TRUE(object->HasOneRef());
+  EXPECT_TRUE(object->HasAtLeastOneRef());
+}
+
+TEST(BiasedRefCountedTest, OtherThreadReleasesCopy) {
+  PlatformThreadRef destructor_thread;
+  auto object = MakeRefCounted<BiasedObject>(&destructor_thread);
+  scoped_refptr<BiasedObject> copy = object;
+  RunOnOtherThread(BindOnce([](scoped_refptr<BiasedObject> copy) {},
+                            std::move(copy)));
+  EXPECT_TRUE(destructor_thread.is_null());
+  object.reset();
+  EXPECT_EQ(destructor_thread, PlatformThread::CurrentRef());
+}
+
+TEST(BiasedRefCountedTest, OtherThreadReleasesLast) {
+  PlatformThreadRef destructor_thread;
+  PlatformThreadRef other_thread;
+  auto object = MakeRefCounted<BiasedObject>(&destructor_thread);
+  scoped_refptr<BiasedObject> copy;
+
+  // The owner releases all of its references, after another thread took one.
+  RunOnOtherThread(BindOnce(
+      [](scoped_refptr<BiasedObject>* copy,
+         const scoped_refptr<BiasedObject>* object) { *copy = *object; },
+      &copy, &object));
+  object.reset();
+  EXPECT_TRUE(destructor_thread.is_null());
+
+  RunOnOtherThread(BindOnce(
+      [](scoped_refptr<BiasedObject> copy, PlatformThreadRef* other_thread) {
+        *other_thread = PlatformThread::CurrentRef();
+      },
+      std::move(copy), &other_thread));
+  EXPECT_EQ(destructor_thread, other_thread);
+}
+
+TEST(BiasedRefCountedTest, LastReferenceMovedToOtherThread) {
+  PlatformThreadRef destructor_thread;
+  auto object = MakeRefCounted<BiasedObject>(&destructor_thread);
+  RunOnOtherThread(BindOnce([](scoped_refptr<BiasedObject> object) {},
+                            std::move(object)));
+  // The owner merges the counts the next time it releases a biased object.
+  EXPECT_TRUE(destructor_thread.is_null());
+
+  PlatformThreadRef unused;
+  MakeRefCounted<BiasedObject>(&unused).reset();
+  EXPECT_EQ(destructor_thread, PlatformThread::CurrentRef());
+}
+
+TEST(BiasedRefCountedTest, OnlyReferencedOnOtherThread) {
+  PlatformThreadRef destructor_thread;
+  BiasedObject* object = new BiasedObject(&destructor_thread);
+  RunOnOtherThread(BindOnce(
+      [](BiasedObject* object) { scoped_refptr<BiasedObject> ref(object); },
+      Unretained(object)));
+  // The owner merges the counts the next time it releases a biased object.
+  EXPECT_TRUE(destructor_thread.is_null());
+
+  PlatformThreadRef unused;
+  MakeRefCounted<BiasedObject>(&unused).reset();
+  EXPECT_EQ(destructor_thread, PlatformThread::CurrentRef());
+}
+
+TEST(BiasedRefCountedTest, OnlyReferencedAfterOwnerThreadExits) {
+  PlatformThreadRef destructor_thread;
+  BiasedObject* object = nullptr;
+  RunOnOtherThread(BindOnce(
+      [](BiasedObject** object, PlatformThreadRef* destructor_thread) {
+        *object = new BiasedObject(destructor_thread);
+      },
+      &object, &destructor_thread));
+  scoped_refptr<BiasedObject>(object).reset();
+  EXPECT_EQ(destructor_thread, PlatformThread::CurrentRef());
+}
+
+TEST(BiasedRefCountedTest, OwnerThreadExits) {
+  PlatformThreadRef destructor_thread;
+  scoped_refptr<BiasedObject> object;
+  RunOnOtherThread(BindOnce(
+      [](scoped_refptr<BiasedObject>* object,
+         PlatformThreadRef* destructor_thread) {
+        *object = MakeRefCounted<BiasedObject>(destructor_thread);
+      },
+      &object, &destructor_thread));
+  object.reset();
+  EXPECT_EQ(destructor_thread, PlatformThread::CurrentRef());
+}
+
+TEST(BiasedRefCountedTest, OwnerThreadExitsWithQueuedObject) {
+  PlatformThreadRef destructor_thread;
+  PlatformThreadRef owner_thread;
+  RunOnOtherThread(BindOnce(
+      [](PlatformThreadRef* destructor_thread,
+         PlatformThreadRef* owner_thread) {
+        *owner_thread = PlatformThread::CurrentRef();
+        auto object = MakeRefCounted<BiasedObject>(destructor_thread);
+        RunOnOtherThread(BindOnce([](scoped_refptr<BiasedObject> object) {},
+                                  std::move(object)));
+        EXPECT_TRUE(destructor_thread->is_null());
+      },
+      &destructor_thread, &owner_thread));
+  // The owner merged the counts when it exited.
+  EXPECT_EQ(destructor_thread, owner_thread);
+}
+
+TEST(BiasedRefCountedTest, ConcurrentReferences) {
+  constexpr int kIterations = 10000;
+  PlatformThreadRef destructor_thread;
+  auto object = MakeRefCounted<BiasedObject>(&destructor_thread);
+
+  ClosureThread thread(BindOnce(
+      [](scoped_refptr<BiasedObject> object) {
+        for (int i = 0; i < kIterations; ++i) {
+          scoped_refptr<BiasedObject> copy = object;
+        }
+      },
+      object));
+  thread.Start();
+  for (int i = 0; i < kIterations; ++i) {
+    scoped_refptr<BiasedObject> copy = object;
+  }
+  thread.Join();
+
+  EXPECT_TRUE(destructor_thread.is_null());
+  object.reset();
+  EXPECT_EQ(destructor_thread, PlatformThread::CurrentRef());
+}
+
+TEST(BiasedRefCountedTest, ConcurrentReleaseOfLastReferences) {
+  // Each iteration races the release of the last references of the owner
+  // with the release of another thread which queues the object, which reads
+  // the owner:
+  // - The owner gives a copy to the releasing thread.
+  // - The taking thread takes a reference, which it gives to the owner.
+  // - The owner releases its references, which drops `biased_count_` to 0.
+  // The copy takes the shared count below 0 when it's released before the
+  // taking thread takes its reference.
+  constexpr int kIterations = 1000;
+  std::vector<PlatformThreadRef> destructor_threads(kIterations);
+
+  struct Iteration {
+    raw_ptr<BiasedObject> object;
+    scoped_refptr<BiasedObject> released_copy;
+    scoped_refptr<BiasedObject> taken_copy;
+    WaitableEvent release{WaitableEvent::ResetPolicy::AUTOMATIC};
+    WaitableEvent take{WaitableEvent::ResetPolicy::AUTOMATIC};
+    WaitableEvent released{WaitableEvent::ResetPolicy::AUTOMATIC};
+    WaitableEvent taken{WaitableEvent::ResetPolicy::AUTOMATIC};
+  } iteration;
+
+  ClosureThread releasing_thread(BindOnce(
+      [](Iteration* iteration) {
+        for (int i = 0; i < kIterations; ++i) {
+          iteration->release.Wait();
+          iteration->released_copy.reset();
+          iteration->released.Signal();
+        }
+      },
+      &iteration));
+  ClosureThread taking_thread(BindOnce(
+      [](Iteration* iteration) {
+        for (int i = 0; i < kIterations; ++i) {
+          iteration->take.Wait();
+          iteration->taken_copy = iteration->object.get();
+          iteration->taken.Signal();
+        }
+      },
+      &iteration));
+  releasing_thread.Start();
+  taking_thread.Start();
+
+  for (int i = 0; i < kIterations; ++i) {
+    auto object = MakeRefCounted<BiasedObject>(&destructor_threads[i]);
+    iteration.object = object.get();
+    iteration.released_copy = object;
+    iteration.release.Signal();
+    iteration.take.Signal();
+    iteration.taken.Wait();
+    iteration.object = nullptr;
+    scoped_refptr<BiasedObject> taken_copy = std::move(iteration.taken_copy);
+    taken_copy.reset();
+    object.reset();
+    iteration.released.Wait();
+  }
+  releasing_thread.Join();
+  taking_thread.Join();
+
+  // Merges the objects which were queued.
+  PlatformThreadRef unused;
+  MakeRefCounted<BiasedObject>(&unused).reset();
+  for (int i = 0; i < kIterations; ++i) {
+    EXPECT_FALSE(destructor_threads[i].is_null()) << i;
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,189 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/evictable_cache_registry.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/memory/ptr_util.h"
+#include "base/no_destructor.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/trace_event/base_tracing.h"
+
+namespace base {
+
+EvictableCacheRegistry::Registration::Registration(
+    EvictableCacheRegistry* registry,
+    const char* name,
+    Client* client)
+    : registry_(registry), name_(name), client_(client) {}
+
+EvictableCacheRegistry::Registration::~Registration() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  registry_->Unregister(this);
+}
+
+void EvictableCacheRegistry::Registration::UpdateUsage(
+    size_t size_bytes,
+    double recompute_cost_us) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_GE(recompute_cost_us, 0);
+  registry_->UpdateUsage(this, size_bytes, recompute_cost_us);
+}
+
+void EvictableCacheRegistry::Registration::Evict(size_t bytes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  TRACE_EVENT("base", "EvictableCacheRegistry::Evict", "cache", name_, "bytes",
+              bytes);
+  client_->EvictBytes(bytes);
+}
+
+EvictableCacheRegistry::Entry::Entry(
+    Registration* registration,
+    scoped_refptr<SequencedTaskRunner> task_runner)
+    : registration(registration),
+      task_runner(std::move(task_runner)),
+      weak_registration(registration->weak_factory_.GetWeakPtr()) {}
+
+EvictableCacheRegistry::Entry::Entry(Entry&&) = default;
+EvictableCacheRegistry::Entry& EvictableCacheRegistry::Entry::operator=(
+    Entry&&) = default;
+EvictableCacheRegistry::Entry::~Entry() = default;
+
+double EvictableCacheRegistry::Entry::GetValuePerByte() const {
+  return size_bytes ? recompute_cost_us / size_bytes : 0;
+}
+
+// static
+EvictableCacheRegistry& EvictableCacheRegistry::GetInstance() {
+  static NoDestructor<EvictableCacheRegistry> registry;
+  return *registry;
+}
+
+EvictableCacheRegistry::EvictableCacheRegistry()
+    : memory_pressure_listener_(
+          FROM_HERE,
+          DoNothing(),
+          BindRepeating(&EvictableCacheRegistry::OnMemoryPressure,
+                        Unretained(this))) {}
+
+EvictableCacheRegistry::~EvictableCacheRegistry() {
+  AutoLock lock(lock_);
+  DCHECK(entries_.empty());
+}
+
+std::unique_ptr<EvictableCacheRegistry::Registration>
+EvictableCacheRegistry::Register(const char* name, Client* client) {
+  DCHECK(client);
+  // WrapUnique() as the constructor is private.
+  auto registration = WrapUnique(new Registration(this, name, client));
+  AutoLock lock(lock_);
+  entries_.emplace_back(registration.get(),
+                        SequencedTaskRunner::GetCurrentDefault());
+  return registration;
+}
+
+void EvictableCacheRegistry::SetSoftBudget(size_t budget_bytes) {
+  AutoLock lock(lock_);
+  soft_budget_bytes_ = budget_bytes;
+  EnforceBudgetLocked();
+}
+
+size_t EvictableCacheRegistry::GetTotalSize() const {
+  AutoLock lock(lock_);
+  return GetTotalSizeLocked();
+}
+
+void EvictableCacheRegistry::Evict(size_t bytes) {
+  AutoLock lock(lock_);
+  EvictLocked(bytes);
+}
+
+void EvictableCacheRegistry::UpdateUsage(Registration* registration,
+                                         size_t size_bytes,
+                                         double recompute_cost_us) {
+  AutoLock lock(lock_);
+  auto it = std::ranges::find_if(entries_, [registration](const Entry& entry) {
+    return entry.registration == registration;
+  });
+  CHECK(it != entries_.end());
+  it->size_bytes = size_bytes;
+  it->recompute_cost_us = recompute_cost_us;
+  // The cache reports what is left after an eviction it was asked for.
+  it->pending_eviction_bytes = 0;
+  EnforceBudgetLocked();
+}
+
+void EvictableCacheRegistry::Unregister(Registration* registration) {
+  AutoLock lock(lock_);
+  size_t num_erased =
+      std::erase_if(entries_, [registration](const Entry& entry) {
+        return entry.registration == registration;
+      });
+  DCHECK_EQ(num_erased, 1u);
+}
+
+size_t EvictableCacheRegistry::GetTotalSizeLocked() const {
+  size_t total = 0;
+  for (const Entry& entry : entries_) {
+    total += entry.size_bytes - entry.pending_eviction_bytes;
+  }
+  return total;
+}
+
+void EvictableCacheRegistry::EnforceBudgetLocked() {
+  if (!soft_budget_bytes_) {
+    return;
+  }
+  const size_t total = GetTotalSizeLocked();
+  if (total > soft_budget_bytes_) {
+    EvictLocked(total - soft_budget_bytes_);
+  }
+}
+
+void EvictableCacheRegistry::EvictLocked(size_t bytes) {
+  std::vector<Entry*> candidates;
+  for (Entry& entry : entries_) {
+    if (entry.size_bytes > entry.pending_eviction_bytes) {
+      candidates.push_back(&entry);
+    }
+  }
+  std::ranges::stable_sort(candidates, {}, &Entry::GetValuePerByte);
+
+  for (Entry* entry : candidates) {
+    if (!bytes) {
+      break;
+    }
+    const size_t to_evict =
+        std::min(bytes, entry->size_bytes - entry->pending_eviction_bytes);
+    entry->pending_eviction_bytes += to_evict;
+    bytes -= to_evict;
+    entry->task_runner->PostTask(
+        FROM_HERE,
+        BindOnce(&Registration::Evict, entry->weak_registration, to_evict));
+  }
+}
+
+void EvictableCacheRegistry::OnMemoryPressure(
+    MemoryPressureListener::MemoryPressureLevel level) {
+  AutoLock lock(lock_);
+  const size_t total = GetTotalSizeLocked();
+  switch (level) {
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      EvictLocked(total / 2);
+      break;
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      EvictLocked(total);
+      break;
+  }
+}
+
+}  // namespace base
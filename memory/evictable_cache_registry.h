@@ -0,0 +1,173 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_EVICTABLE_CACHE_REGISTRY_H_
+#define BASE_MEMORY_EVICTABLE_CACHE_REGISTRY_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace base {
+
+class SequencedTaskRunner;
+
+// EvictableCacheRegistry decides which caches of the process give back memory,
+// instead of each cache reacting to memory pressure on its own. Caches report
+// how much memory they hold and an estimate of the cost of recomputing it, and
+// the registry asks the ones holding the least valuable memory per byte to
+// evict first:
+//   - On moderate memory pressure, half of the registered memory is evicted,
+//     and on critical memory pressure, all of it.
+//   - When a soft budget is set, memory beyond it is evicted as soon as the
+//     caches report it, before the OS signals memory pressure.
+//
+// Example:
+//   class MyCache : public EvictableCacheRegistry::Client {
+//    public:
+//     MyCache()
+//         : registration_(EvictableCacheRegistry::GetInstance().Register(
+//               "MyCache", this)) {}
+//
+//     void Add(Key key, Value value) {
+//       ...
+//       registration_->UpdateUsage(size_bytes_, recompute_cost_);
+//     }
+//
+//     // EvictableCacheRegistry::Client:
+//     void EvictBytes(size_t bytes) override {
+//       // Evict the least recently used entries.
+//       ...
+//       registration_->UpdateUsage(size_bytes_, recompute_cost_);
+//     }
+//
+//    private:
+//     std::unique_ptr<EvictableCacheRegistry::Registration> registration_;
+//   };
+//
+// This class is thread-safe.
+class BASE_EXPORT EvictableCacheRegistry {
+ public:
+  // Implemented by the caches.
+  class Client {
+   public:
+    // Asks the cache to free about `bytes` of its memory, and to report its
+    // new usage. Called on the sequence the cache registered on.
+    virtual void EvictBytes(size_t bytes) = 0;
+
+   protected:
+    virtual ~Client() = default;
+  };
+
+  // Keeps a cache registered until destroyed. Must be used and destroyed on
+  // the sequence it was created on.
+  class BASE_EXPORT Registration {
+   public:
+    Registration(const Registration&) = delete;
+    Registration& operator=(const Registration&) = delete;
+    ~Registration();
+
+    // Reports the memory held by the cache, and an estimate of the cost of
+    // recomputing all of it, in a unit shared by all the caches: the
+    // microseconds of CPU time it would take. Should be called after the
+    // cache grows or evicts.
+    void UpdateUsage(size_t size_bytes, double recompute_cost_us);
+
+   private:
+    friend class EvictableCacheRegistry;
+
+    Registration(EvictableCacheRegistry* registry,
+                 const char* name,
+                 Client* client);
+
+    void Evict(size_t bytes);
+
+    const raw_ptr<EvictableCacheRegistry> registry_;
+    const char* const name_;
+    const raw_ptr<Client> client_;
+    SEQUENCE_CHECKER(sequence_checker_);
+    WeakPtrFactory<Registration> weak_factory_{this};
+  };
+
+  // Returns the registry of the process.
+  static EvictableCacheRegistry& GetInstance();
+
+  // Only tests should create their own registry. All of its registrations
+  // must be destroyed before it.
+  EvictableCacheRegistry();
+  EvictableCacheRegistry(const EvictableCacheRegistry&) = delete;
+  EvictableCacheRegistry& operator=(const EvictableCacheRegistry&) = delete;
+  ~EvictableCacheRegistry();
+
+  // Registers `client`, which must outlive the returned registration. `name`
+  // must be a string literal. Must be called on a sequence.
+  [[nodiscard]] std::unique_ptr<Registration> Register(const char* name,
+                                                       Client* client);
+
+  // Caches are asked to evict whenever they hold more than `budget_bytes` in
+  // total. 0, the default, means no budget.
+  void SetSoftBudget(size_t budget_bytes);
+
+  // Returns the memory the caches reported, minus the evictions they were
+  // asked for and didn't report yet.
+  size_t GetTotalSize() const;
+
+  // Asks the caches to evict `bytes`, the least valuable memory first.
+  void Evict(size_t bytes);
+
+ private:
+  struct Entry {
+    Entry(Registration* registration,
+          scoped_refptr<SequencedTaskRunner> task_runner);
+    Entry(Entry&&);
+    Entry& operator=(Entry&&);
+    ~Entry();
+
+    // The recompute cost of one byte.
+    double GetValuePerByte() const;
+
+    raw_ptr<Registration> registration;
+    scoped_refptr<SequencedTaskRunner> task_runner;
+    // Bound to the sequence of `registration`, to cancel its evictions.
+    WeakPtr<Registration> weak_registration;
+    size_t size_bytes = 0;
+    double recompute_cost_us = 0;
+    // The part of `size_bytes` the cache was asked to evict, until it reports
+    // its usage again.
+    size_t pending_eviction_bytes = 0;
+  };
+
+  void UpdateUsage(Registration* registration,
+                   size_t size_bytes,
+                   double recompute_cost_us);
+  void Unregister(Registration* registration);
+
+  size_t GetTotalSizeLocked() const EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void EnforceBudgetLocked() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void EvictLocked(size_t bytes) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level);
+
+  mutable Lock lock_;
+  std::vector<Entry> entries_ GUARDED_BY(lock_);
+  size_t soft_budget_bytes_ GUARDED_BY(lock_) = 0;
+
+  // Evicts synchronously with the notification, as the registered caches may
+  // live on any sequence.
+  MemoryPressureListener memory_pressure_listener_;
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_EVICTABLE_CACHE_REGISTRY_H_
@@ -0,0 +1,127 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/evictable_cache_registry.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// A cache whose entries all have the same recompute cost per byte.
+class FakeCache : public EvictableCacheRegistry::Client {
+ public:
+  FakeCache(EvictableCacheRegistry& registry, double cost_per_byte)
+      : registration_(registry.Register("FakeCache", this)),
+        cost_per_byte_(cost_per_byte) {}
+
+  void SetSize(size_t size_bytes) {
+    size_bytes_ = size_bytes;
+    registration_->UpdateUsage(size_bytes_, size_bytes_ * cost_per_byte_);
+  }
+
+  void Unregister() { registration_.reset(); }
+
+  size_t size_bytes() const { return size_bytes_; }
+  size_t evicted_bytes() const { return evicted_bytes_; }
+
+  // EvictableCacheRegistry::Client:
+  void EvictBytes(size_t bytes) override {
+    bytes = std::min(bytes, size_bytes_);
+    evicted_bytes_ += bytes;
+    SetSize(size_bytes_ - bytes);
+  }
+
+ private:
+  std::unique_ptr<EvictableCacheRegistry::Registration> registration_;
+  const double cost_per_byte_;
+  size_t size_bytes_ = 0;
+  size_t evicted_bytes_ = 0;
+};
+
+class EvictableCacheRegistryTest : public testing::Test {
+ protected:
+  test::TaskEnvironment task_environment_;
+  EvictableCacheRegistry registry_;
+};
+
+}  // namespace
+
+TEST_F(EvictableCacheRegistryTest, EvictsLeastValuableFirst) {
+  FakeCache cheap(registry_, 1);
+  FakeCache expensive(registry_, 10);
+  cheap.SetSize(1000);
+  expensive.SetSize(1000);
+  EXPECT_EQ(registry_.GetTotalSize(), 2000u);
+
+  registry_.Evict(1500);
+  // The evictions are pending until the caches run them.
+  EXPECT_EQ(registry_.GetTotalSize(), 500u);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(cheap.evicted_bytes(), 1000u);
+  EXPECT_EQ(expensive.evicted_bytes(), 500u);
+  EXPECT_EQ(registry_.GetTotalSize(), 500u);
+}
+
+TEST_F(EvictableCacheRegistryTest, SoftBudget) {
+  FakeCache cheap(registry_, 1);
+  FakeCache expensive(registry_, 10);
+  registry_.SetSoftBudget(1500);
+  cheap.SetSize(1000);
+  expensive.SetSize(400);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(cheap.evicted_bytes(), 0u);
+
+  // Growing beyond the budget evicts the least valuable memory, even if it
+  // isn't the memory which grew.
+  expensive.SetSize(1000);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(cheap.evicted_bytes(), 500u);
+  EXPECT_EQ(expensive.evicted_bytes(), 0u);
+  EXPECT_EQ(registry_.GetTotalSize(), 1500u);
+
+  // Lowering the budget evicts right away.
+  registry_.SetSoftBudget(1000);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(cheap.size_bytes(), 0u);
+  EXPECT_EQ(registry_.GetTotalSize(), 1000u);
+}
+
+TEST_F(EvictableCacheRegistryTest, MemoryPressure) {
+  FakeCache cheap(registry_, 1);
+  FakeCache expensive(registry_, 10);
+  cheap.SetSize(1000);
+  expensive.SetSize(1000);
+
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(cheap.size_bytes(), 0u);
+  EXPECT_EQ(expensive.size_bytes(), 1000u);
+
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(expensive.size_bytes(), 0u);
+  EXPECT_EQ(registry_.GetTotalSize(), 0u);
+}
+
+TEST_F(EvictableCacheRegistryTest, UnregisterCancelsEviction) {
+  FakeCache cache(registry_, 1);
+  cache.SetSize(1000);
+  registry_.Evict(1000);
+  cache.Unregister();
+  EXPECT_EQ(registry_.GetTotalSize(), 0u);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(cache.evicted_bytes(), 0u);
+}
+
+}  // namespace base
@@ -17,8 +17,19 @@
 
 namespace base {
 
+namespace features {
+BASE_FEATURE(kPackedMadvFreeDiscardableMemory,
+             "PackedMadvFreeDiscardableMemory",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+}  // namespace features
+
 MadvFreeDiscardableMemoryAllocatorPosix::
     MadvFreeDiscardableMemoryAllocatorPosix() {
+  if (FeatureList::IsEnabled(features::kPackedMadvFreeDiscardableMemory)) {
+    span_allocator_ =
+        std::make_unique<MadvFreeDiscardableSpanAllocatorPosix>(
+            &bytes_allocated_);
+  }
 #if BUILDFLAG(ENABLE_BASE_TRACING)
   // Don't register dump provider if
   // SingleThreadTaskRunner::CurrentDefaultHAndle is not set, such as in tests
@@ -41,10 +52,22 @@ MadvFreeDiscardableMemoryAllocatorPosix::
 std::unique_ptr<DiscardableMemory>
 MadvFreeDiscardableMemoryAllocatorPosix::AllocateLockedDiscardableMemory(
     size_t size) {
+  if (span_allocator_ &&
+      size <= MadvFreeDiscardableSpanAllocatorPosix::kMaxAllocationSize) {
+    return span_allocator_->AllocateLockedDiscardableMemory(size);
+  }
   return std::make_unique<MadvFreeDiscardableMemoryPosix>(size,
                                                           &bytes_allocated_);
 }
 
+void MadvFreeDiscardableMemoryAllocatorPosix::ReleaseFreeMemory() {
+  // MADV_FREE discardable memory doesn't keep any memory overhead, but the
+  // packed allocations may wait to be released to the kernel.
+  if (span_allocator_) {
+    span_allocator_->FlushPendingUnlocks();
+  }
+}
+
 size_t MadvFreeDiscardableMemoryAllocatorPosix::GetBytesAllocated() const {
   return bytes_allocated_;
 }
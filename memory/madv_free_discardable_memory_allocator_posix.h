@@ -11,15 +11,24 @@
 #include <memory>
 
 #include "base/base_export.h"
+#include "base/feature_list.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/memory/discardable_memory.h"
 #include "base/memory/discardable_memory_allocator.h"
 #include "base/memory/madv_free_discardable_memory_posix.h"
+#include "base/memory/madv_free_discardable_span_allocator_posix.h"
 #include "base/trace_event/base_tracing.h"
 #include "build/build_config.h"
 
 namespace base {
+
+namespace features {
+// Packs the small allocations of MadvFreeDiscardableMemoryAllocatorPosix into
+// spans, see MadvFreeDiscardableSpanAllocatorPosix.
+BASE_EXPORT BASE_DECLARE_FEATURE(kPackedMadvFreeDiscardableMemory);
+}  // namespace features
+
 class BASE_EXPORT MadvFreeDiscardableMemoryAllocatorPosix
     : public DiscardableMemoryAllocator,
       public base::trace_event::MemoryDumpProvider {
@@ -38,16 +47,15 @@ class BASE_EXPORT MadvFreeDiscardableMemoryAllocatorPosix
 
   size_t GetBytesAllocated() const override;
 
-  void ReleaseFreeMemory() override {
-    // Do nothing, since MADV_FREE discardable memory does not keep any memory
-    // overhead that can be released.
-  }
+  void ReleaseFreeMemory() override;
 
   bool OnMemoryDump(const trace_event::MemoryDumpArgs& args,
                     trace_event::ProcessMemoryDump* pmd) override;
 
  private:
   std::atomic<size_t> bytes_allocated_{0};
+  // Null unless kPackedMadvFreeDiscardableMemory is enabled.
+  std::unique_ptr<MadvFreeDiscardableSpanAllocatorPosix> span_allocator_;
 };
 }  // namespace base
 
@@ -11,6 +11,7 @@
 #include "base/memory/madv_free_discardable_memory_allocator_posix.h"
 #include "base/memory/madv_free_discardable_memory_posix.h"
 #include "base/memory/page_size.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/tracing_buildflags.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -104,4 +105,25 @@ TEST_F(MadvFreeDiscardableMemoryAllocatorPosixTest, AllocateAndUseMemory) {
 
   EXPECT_EQ(memcmp(test_pattern, buffer, sizeof(test_pattern)), 0);
 }
+
+TEST(MadvFreeDiscardableMemoryAllocatorPosixPackedTest, PacksSmallAllocations) {
+  SUCCEED_IF_MADV_FREE_UNSUPPORTED();
+
+  test::ScopedFeatureList feature_list(
+      features::kPackedMadvFreeDiscardableMemory);
+  MadvFreeDiscardableMemoryAllocatorPosix allocator;
+  auto small = allocator.AllocateLockedDiscardableMemory(
+      MadvFreeDiscardableSpanAllocatorPosix::kMaxAllocationSize);
+  auto large = allocator.AllocateLockedDiscardableMemory(GetPageSize() * 2);
+  EXPECT_EQ(allocator.GetBytesAllocated(),
+            MadvFreeDiscardableSpanAllocatorPosix::kMaxAllocationSize +
+                GetPageSize() * 2);
+
+  small->Unlock();
+  allocator.ReleaseFreeMemory();
+  EXPECT_TRUE(small->Lock());
+  small.reset();
+  large.reset();
+  EXPECT_EQ(allocator.GetBytesAllocated(), 0u);
+}
 }  // namespace base
@@ -0,0 +1,443 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifdef UNSAFE_BUFFERS_BUILD
+// TODO(crbug.com/40284755): Remove this and spanify to fix the errors.
+#pragma allow_unsafe_buffers
+#endif
+
+#include "base/memory/madv_free_discardable_span_allocator_posix.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/logging.h"
+#include "base/memory/page_size.h"
+#include "base/notreached.h"
+#include "base/tracing_buildflags.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_ANDROID)
+#include <sys/prctl.h>
+#endif
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+#include "base/trace_event/memory_allocator_dump.h"  // no-presubmit-check
+#include "base/trace_event/process_memory_dump.h"    // no-presubmit-check
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+
+#if defined(ADDRESS_SANITIZER)
+#include <sanitizer/asan_interface.h>
+#endif  // defined(ADDRESS_SANITIZER)
+
+namespace base {
+
+namespace {
+
+constexpr intptr_t kPageMagicCookie = 1;
+
+// The first word of a page, which is poisoned while the slot holding it is
+// unlocked or free.
+class ScopedPageFirstWord {
+ public:
+  explicit ScopedPageFirstWord(uint8_t* page)
+      : word_(reinterpret_cast<std::atomic<intptr_t>*>(page)) {
+#if defined(ADDRESS_SANITIZER)
+    ASAN_UNPOISON_MEMORY_REGION(word_, sizeof(*word_));
+#endif  // defined(ADDRESS_SANITIZER)
+  }
+  ScopedPageFirstWord(const ScopedPageFirstWord&) = delete;
+  ScopedPageFirstWord& operator=(const ScopedPageFirstWord&) = delete;
+  ~ScopedPageFirstWord() {
+#if defined(ADDRESS_SANITIZER)
+    ASAN_POISON_MEMORY_REGION(word_, sizeof(*word_));
+#endif  // defined(ADDRESS_SANITIZER)
+  }
+
+  std::atomic<intptr_t>& operator*() { return *word_; }
+
+ private:
+  // RAW_PTR_EXCLUSION: Points to mmap'ed memory.
+  RAW_PTR_EXCLUSION std::atomic<intptr_t>* const word_;
+};
+
+void PoisonSlot(void* slot, size_t size) {
+#if defined(ADDRESS_SANITIZER)
+  ASAN_POISON_MEMORY_REGION(slot, size);
+#endif  // defined(ADDRESS_SANITIZER)
+}
+
+void UnpoisonSlot(void* slot, size_t size) {
+#if defined(ADDRESS_SANITIZER)
+  ASAN_UNPOISON_MEMORY_REGION(slot, size);
+#endif  // defined(ADDRESS_SANITIZER)
+}
+
+}  // namespace
+
+class MadvFreeDiscardableSpanAllocatorPosix::Memory : public DiscardableMemory {
+ public:
+  Memory(MadvFreeDiscardableSpanAllocatorPosix* allocator,
+         Span* span,
+         size_t slot,
+         size_t size)
+      : allocator_(allocator), span_(span), slot_(slot), size_(size) {}
+  Memory(const Memory&) = delete;
+  Memory& operator=(const Memory&) = delete;
+
+  ~Memory() override {
+    AutoLock lock(allocator_->lock_);
+    *allocator_->bytes_allocated_ -= size_;
+    // The span may be gone after this.
+    allocator_->FreeSlot(span_.ExtractAsDangling(), slot_, is_locked_);
+  }
+
+  // DiscardableMemory:
+  bool Lock() override {
+    DCHECK(!is_locked_);
+    {
+      AutoLock lock(allocator_->lock_);
+      if (!allocator_->LockSlot(span_)) {
+        return false;
+      }
+    }
+    UnpoisonSlot(GetSlot(), span_->slot_size);
+    is_locked_ = true;
+    return true;
+  }
+
+  void Unlock() override {
+    DCHECK(is_locked_);
+    PoisonSlot(GetSlot(), span_->slot_size);
+    is_locked_ = false;
+    AutoLock lock(allocator_->lock_);
+    allocator_->UnlockSlot(span_);
+  }
+
+  void* data() const override {
+    DCHECK(is_locked_);
+    return GetSlot();
+  }
+
+  void DiscardForTesting() override {
+    DCHECK(!is_locked_);
+    AutoLock lock(allocator_->lock_);
+    if (span_->state == SpanState::kUnlockedPending ||
+        span_->state == SpanState::kUnlocked) {
+      allocator_->DiscardSpan(span_);
+    }
+  }
+
+  trace_event::MemoryAllocatorDump* CreateMemoryAllocatorDump(
+      const char* name,
+      trace_event::ProcessMemoryDump* pmd) const override {
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+    bool is_discarded;
+    {
+      AutoLock lock(allocator_->lock_);
+      is_discarded = span_->state == SpanState::kDiscarded;
+    }
+    trace_event::MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(name);
+    dump->AddScalar(trace_event::MemoryAllocatorDump::kNameSize,
+                    trace_event::MemoryAllocatorDump::kUnitsBytes,
+                    is_discarded ? 0U : static_cast<uint64_t>(size_));
+    return dump;
+#else   // BUILDFLAG(ENABLE_BASE_TRACING)
+    NOTREACHED_IN_MIGRATION();
+    return nullptr;
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+  }
+
+ private:
+  uint8_t* GetSlot() const { return span_->data + slot_ * span_->slot_size; }
+
+  const raw_ptr<MadvFreeDiscardableSpanAllocatorPosix> allocator_;
+  raw_ptr<Span> span_;
+  const size_t slot_;
+  const size_t size_;
+  bool is_locked_ = true;
+};
+
+MadvFreeDiscardableSpanAllocatorPosix::Span::Span(void* data,
+                                                  size_t slot_size,
+                                                  size_t num_pages)
+    : data(static_cast<uint8_t*>(data)),
+      slot_size(slot_size),
+      size_class(GetSizeClass(slot_size)),
+      page_allocated_slots(num_pages),
+      page_first_words(num_pages) {
+  const size_t num_slots = kSpanSize / slot_size;
+  free_slots.reserve(num_slots);
+  // The lowest slots are used first.
+  for (size_t slot = num_slots; slot > 0; --slot) {
+    free_slots.push_back(static_cast<uint16_t>(slot - 1));
+  }
+}
+
+MadvFreeDiscardableSpanAllocatorPosix::Span::~Span() = default;
+
+MadvFreeDiscardableSpanAllocatorPosix::MadvFreeDiscardableSpanAllocatorPosix(
+    std::atomic<size_t>* bytes_allocated)
+    : bytes_allocated_(bytes_allocated),
+      memory_pressure_listener_(
+          FROM_HERE,
+          DoNothing(),
+          BindRepeating(
+              &MadvFreeDiscardableSpanAllocatorPosix::OnMemoryPressure,
+              Unretained(this))) {
+  CHECK_EQ(kSpanSize % GetPageSize(), 0u);
+  CHECK_LE(kMaxAllocationSize, GetPageSize());
+}
+
+MadvFreeDiscardableSpanAllocatorPosix::
+    ~MadvFreeDiscardableSpanAllocatorPosix() {
+  AutoLock lock(lock_);
+  DCHECK(spans_.empty());
+}
+
+std::unique_ptr<DiscardableMemory>
+MadvFreeDiscardableSpanAllocatorPosix::AllocateLockedDiscardableMemory(
+    size_t size) {
+  DCHECK_GT(size, 0u);
+  DCHECK_LE(size, kMaxAllocationSize);
+  const size_t size_class = GetSizeClass(size);
+
+  AutoLock lock(lock_);
+  auto& spans_with_free_slots = spans_with_free_slots_[size_class];
+  Span* span = nullptr;
+  while (!spans_with_free_slots.empty()) {
+    // Locking a discarded span removes it from `spans_with_free_slots`.
+    if (LockSlot(spans_with_free_slots.back())) {
+      span = spans_with_free_slots.back();
+      break;
+    }
+  }
+  if (!span) {
+    void* data = mmap(nullptr, kSpanSize, PROT_READ | PROT_WRITE,
+                      MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    PCHECK(data != MAP_FAILED);
+#if BUILDFLAG(IS_ANDROID)
+    prctl(PR_SET_VMA, PR_SET_VMA_ANON_NAME, data, kSpanSize,
+          "madv-free-discardable");
+#endif
+    PoisonSlot(data, kSpanSize);
+    spans_.push_back(std::make_unique<Span>(
+        data, kMinSlotSize << size_class, kSpanSize / GetPageSize()));
+    span = spans_.back().get();
+    spans_with_free_slots.push_back(span);
+    CHECK(LockSlot(span));
+  }
+
+  const size_t slot = span->free_slots.back();
+  span->free_slots.pop_back();
+  if (span->free_slots.empty()) {
+    DCHECK(spans_with_free_slots.back() == span);
+    spans_with_free_slots.pop_back();
+  }
+  ++span->num_allocated_slots;
+  ++span->page_allocated_slots[slot * span->slot_size / GetPageSize()];
+  *bytes_allocated_ += size;
+
+  void* data = span->data + slot * span->slot_size;
+  UnpoisonSlot(data, span->slot_size);
+  return std::make_unique<Memory>(this, span, slot, size);
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::FlushPendingUnlocks() {
+  AutoLock lock(lock_);
+  FlushPendingUnlocksLocked();
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::PurgeUnlockedSpans(size_t bytes) {
+  AutoLock lock(lock_);
+  PurgeUnlockedSpansLocked(bytes);
+}
+
+size_t MadvFreeDiscardableSpanAllocatorPosix::GetSpanCountForTesting() const {
+  AutoLock lock(lock_);
+  return spans_.size();
+}
+
+size_t MadvFreeDiscardableSpanAllocatorPosix::GetMadviseCountForTesting()
+    const {
+  AutoLock lock(lock_);
+  return madvise_count_;
+}
+
+// static
+size_t MadvFreeDiscardableSpanAllocatorPosix::GetSizeClass(size_t size) {
+  const size_t slot_size = std::max(std::bit_ceil(size), kMinSlotSize);
+  return static_cast<size_t>(std::countr_zero(slot_size) -
+                             std::countr_zero(kMinSlotSize));
+}
+
+bool MadvFreeDiscardableSpanAllocatorPosix::LockSlot(Span* span) {
+  if (span->state == SpanState::kDiscarded) {
+    return false;
+  }
+  if (span->state != SpanState::kLocked && !RelockSpan(span)) {
+    return false;
+  }
+  ++span->num_locked_slots;
+  return true;
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::UnlockSlot(Span* span) {
+  DCHECK_EQ(span->state, SpanState::kLocked);
+  DCHECK_GT(span->num_locked_slots, 0u);
+  if (--span->num_locked_slots) {
+    return;
+  }
+  span->state = SpanState::kUnlockedPending;
+  unlocked_spans_.Append(span);
+  ++num_unlocked_spans_;
+  if (++num_pending_spans_ > kMaxPendingSpans) {
+    FlushPendingUnlocksLocked();
+  }
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::FreeSlot(Span* span,
+                                                     size_t slot,
+                                                     bool is_locked) {
+  PoisonSlot(span->data + slot * span->slot_size, span->slot_size);
+  span->free_slots.push_back(static_cast<uint16_t>(slot));
+  --span->page_allocated_slots[slot * span->slot_size / GetPageSize()];
+  if (!--span->num_allocated_slots) {
+    DestroySpan(span);
+    return;
+  }
+  if (is_locked) {
+    UnlockSlot(span);
+  }
+  if (span->state != SpanState::kDiscarded && span->free_slots.size() == 1) {
+    spans_with_free_slots_[span->size_class].push_back(span);
+  }
+}
+
+bool MadvFreeDiscardableSpanAllocatorPosix::RelockSpan(Span* span) {
+  DCHECK(span->state == SpanState::kUnlockedPending ||
+         span->state == SpanState::kUnlocked);
+  if (span->state == SpanState::kUnlocked) {
+    const size_t page_size = GetPageSize();
+    for (size_t page = 0; page < span->page_allocated_slots.size(); ++page) {
+      if (!span->page_allocated_slots[page]) {
+        continue;
+      }
+      // The cookie is gone if the page was discarded, and replaced by zeroes.
+      ScopedPageFirstWord first_word(span->data + page * page_size);
+      intptr_t expected = kPageMagicCookie;
+      if (!(*first_word)
+               .compare_exchange_strong(expected,
+                                        span->page_first_words[page],
+                                        std::memory_order_relaxed)) {
+        DVLOG(1) << "Span eviction discovered during lock";
+        DiscardSpan(span);
+        return false;
+      }
+    }
+  }
+  RemoveFromUnlockedSpans(span);
+  span->state = SpanState::kLocked;
+  return true;
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::ApplyMadvFree(Span* span) {
+  DCHECK_EQ(span->state, SpanState::kUnlockedPending);
+  const size_t page_size = GetPageSize();
+  for (size_t page = 0; page < span->page_allocated_slots.size(); ++page) {
+    if (!span->page_allocated_slots[page]) {
+      continue;
+    }
+    ScopedPageFirstWord first_word(span->data + page * page_size);
+    span->page_first_words[page] =
+        (*first_word).load(std::memory_order_relaxed);
+    (*first_word).store(kPageMagicCookie, std::memory_order_relaxed);
+  }
+#ifdef MADV_FREE
+  int retval = madvise(span->data, kSpanSize, MADV_FREE);
+  DPCHECK(!retval);
+  ++madvise_count_;
+#endif
+  span->state = SpanState::kUnlocked;
+  --num_pending_spans_;
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::DiscardSpan(Span* span) {
+  RemoveFromUnlockedSpans(span);
+  span->state = SpanState::kDiscarded;
+  std::erase(spans_with_free_slots_[span->size_class], span);
+  int retval = madvise(span->data, kSpanSize, MADV_DONTNEED);
+  DPCHECK(!retval);
+  ++madvise_count_;
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::DestroySpan(Span* span) {
+  DCHECK_EQ(span->num_allocated_slots, 0u);
+  if (span->state == SpanState::kUnlockedPending ||
+      span->state == SpanState::kUnlocked) {
+    RemoveFromUnlockedSpans(span);
+  }
+  std::erase(spans_with_free_slots_[span->size_class], span);
+  UnpoisonSlot(span->data, kSpanSize);
+  int retval = munmap(span->data, kSpanSize);
+  PCHECK(!retval);
+  std::erase_if(spans_, [span](const std::unique_ptr<Span>& other) {
+    return other.get() == span;
+  });
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::RemoveFromUnlockedSpans(
+    Span* span) {
+  DCHECK(span->state == SpanState::kUnlockedPending ||
+         span->state == SpanState::kUnlocked);
+  span->RemoveFromList();
+  --num_unlocked_spans_;
+  if (span->state == SpanState::kUnlockedPending) {
+    --num_pending_spans_;
+  }
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::FlushPendingUnlocksLocked() {
+  for (LinkNode<Span>* node = unlocked_spans_.head();
+       node != unlocked_spans_.end() && num_pending_spans_;
+       node = node->next()) {
+    if (node->value()->state == SpanState::kUnlockedPending) {
+      ApplyMadvFree(node->value());
+    }
+  }
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::PurgeUnlockedSpansLocked(
+    size_t bytes) {
+  while (bytes && !unlocked_spans_.empty()) {
+    DiscardSpan(unlocked_spans_.head()->value());
+    bytes -= std::min(bytes, kSpanSize);
+  }
+}
+
+void MadvFreeDiscardableSpanAllocatorPosix::OnMemoryPressure(
+    MemoryPressureListener::MemoryPressureLevel level) {
+  AutoLock lock(lock_);
+  switch (level) {
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      PurgeUnlockedSpansLocked(num_unlocked_spans_ / 2 * kSpanSize);
+      // Let the kernel reclaim the rest.
+      FlushPendingUnlocksLocked();
+      break;
+    case MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      PurgeUnlockedSpansLocked(num_unlocked_spans_ * kSpanSize);
+      break;
+  }
+}
+
+}  // namespace base
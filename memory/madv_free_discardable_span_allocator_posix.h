@@ -0,0 +1,155 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_MADV_FREE_DISCARDABLE_SPAN_ALLOCATOR_POSIX_H_
+#define BASE_MEMORY_MADV_FREE_DISCARDABLE_SPAN_ALLOCATOR_POSIX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/linked_list.h"
+#include "base/memory/discardable_memory.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/raw_ptr_exclusion.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace base {
+
+// Packs small discardable allocations into spans of pages backed by the
+// MADV_FREE advice value, for MadvFreeDiscardableMemoryAllocatorPosix.
+//
+// MadvFreeDiscardableMemoryPosix maps at least a page per allocation, and
+// calls madvise() on every unlock. With many small discardable objects, the
+// syscalls dominate. Here, a span is the unit of discarding instead:
+//   - The allocations of a span only lose their memory once they are all
+//     unlocked, so most unlocks only update counters.
+//   - The MADV_FREE of the spans which became unlocked is deferred, and
+//     applied in a batch once kMaxPendingSpans of them are waiting. A span
+//     which is locked again before that costs no syscall at all.
+//   - The unlocked spans are kept in least recently unlocked order, and purged
+//     in that order on memory pressure, half of them on moderate pressure and
+//     all of them on critical pressure.
+// If any page of a span was discarded, all of the allocations of the span fail
+// to lock, the way all the pages of a MadvFreeDiscardableMemoryPosix do.
+//
+// This class is thread-safe. The allocations must be destroyed before it.
+class BASE_EXPORT MadvFreeDiscardableSpanAllocatorPosix {
+ public:
+  // The largest allocation packed into spans. Each allocation takes the
+  // smallest power of two at least kMinSlotSize which fits it.
+  static constexpr size_t kMaxAllocationSize = 2048;
+  static constexpr size_t kMinSlotSize = 64;
+  static constexpr size_t kSpanSize = 64 * 1024;
+  // The spans whose MADV_FREE is deferred. Bounds the memory which can't be
+  // reclaimed by the kernel although it is unlocked.
+  static constexpr size_t kMaxPendingSpans = 16;
+
+  // The bytes of the allocations are added to `bytes_allocated`, which must
+  // outlive this.
+  explicit MadvFreeDiscardableSpanAllocatorPosix(
+      std::atomic<size_t>* bytes_allocated);
+  MadvFreeDiscardableSpanAllocatorPosix(
+      const MadvFreeDiscardableSpanAllocatorPosix&) = delete;
+  MadvFreeDiscardableSpanAllocatorPosix& operator=(
+      const MadvFreeDiscardableSpanAllocatorPosix&) = delete;
+  ~MadvFreeDiscardableSpanAllocatorPosix();
+
+  // `size` must be in (0, kMaxAllocationSize].
+  std::unique_ptr<DiscardableMemory> AllocateLockedDiscardableMemory(
+      size_t size);
+
+  // Applies the deferred MADV_FREE to the unlocked spans.
+  void FlushPendingUnlocks();
+
+  // Discards the least recently unlocked spans, until at least `bytes` were
+  // discarded or none is left.
+  void PurgeUnlockedSpans(size_t bytes);
+
+  size_t GetSpanCountForTesting() const;
+  size_t GetMadviseCountForTesting() const;
+
+ private:
+  class Memory;
+
+  // 64, 128, 256, 512, 1024 and 2048 bytes.
+  static constexpr size_t kNumSizeClasses = 6;
+
+  enum class SpanState {
+    // Some allocation of the span is locked, or it has none.
+    kLocked,
+    // All of the allocations are unlocked, and the MADV_FREE is deferred.
+    kUnlockedPending,
+    // All of the allocations are unlocked, and the kernel may discard pages.
+    kUnlocked,
+    // Pages were discarded. The allocations left can't lock anymore.
+    kDiscarded,
+  };
+
+  struct Span : public LinkNode<Span> {
+    Span(void* data, size_t slot_size, size_t num_pages);
+    ~Span();
+
+    // RAW_PTR_EXCLUSION: Never allocated by PartitionAlloc (always mmap'ed),
+    // so there is no benefit to using a raw_ptr, only cost.
+    RAW_PTR_EXCLUSION uint8_t* const data;
+    const size_t slot_size;
+    const size_t size_class;
+    SpanState state = SpanState::kLocked;
+    size_t num_allocated_slots = 0;
+    size_t num_locked_slots = 0;
+    std::vector<uint16_t> free_slots;
+    // The allocated slots in each page. A slot never straddles two pages.
+    std::vector<uint16_t> page_allocated_slots;
+    // The first word of each page with allocated slots, replaced by a cookie
+    // while the span is unlocked, to tell whether the page was discarded.
+    // Pages without allocated slots aren't touched, not to commit them.
+    std::vector<intptr_t> page_first_words;
+  };
+
+  static size_t GetSizeClass(size_t size);
+
+  // Returns false if the span was discarded.
+  bool LockSlot(Span* span) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void UnlockSlot(Span* span) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void FreeSlot(Span* span, size_t slot, bool is_locked)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns false, and discards the span, if any page was discarded.
+  bool RelockSpan(Span* span) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void ApplyMadvFree(Span* span) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void DiscardSpan(Span* span) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void DestroySpan(Span* span) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void RemoveFromUnlockedSpans(Span* span) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void FlushPendingUnlocksLocked() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void PurgeUnlockedSpansLocked(size_t bytes) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level);
+
+  const raw_ptr<std::atomic<size_t>> bytes_allocated_;
+
+  mutable Lock lock_;
+  std::vector<std::unique_ptr<Span>> spans_ GUARDED_BY(lock_);
+  // The spans which can take an allocation, for each size class.
+  std::array<std::vector<raw_ptr<Span, VectorExperimental>>, kNumSizeClasses>
+      spans_with_free_slots_ GUARDED_BY(lock_);
+  // The unlocked spans, least recently unlocked first.
+  LinkedList<Span> unlocked_spans_ GUARDED_BY(lock_);
+  size_t num_unlocked_spans_ GUARDED_BY(lock_) = 0;
+  size_t num_pending_spans_ GUARDED_BY(lock_) = 0;
+  size_t madvise_count_ GUARDED_BY(lock_) = 0;
+
+  MemoryPressureListener memory_pressure_listener_;
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_MADV_FREE_DISCARDABLE_SPAN_ALLOCATOR_POSIX_H_
@@ -0,0 +1,169 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/madv_free_discardable_span_allocator_posix.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/bits.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/page_size.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class MadvFreeDiscardableSpanAllocatorPosixTest : public ::testing::Test {
+ protected:
+  using Allocator = MadvFreeDiscardableSpanAllocatorPosix;
+
+  std::unique_ptr<DiscardableMemory> Allocate(size_t size) {
+    return allocator_.AllocateLockedDiscardableMemory(size);
+  }
+
+  std::atomic<size_t> bytes_allocated_{0};
+  Allocator allocator_{&bytes_allocated_};
+};
+
+TEST_F(MadvFreeDiscardableSpanAllocatorPosixTest, PacksSmallAllocations) {
+  std::vector<std::unique_ptr<DiscardableMemory>> memories;
+  for (int i = 0; i < 10; ++i) {
+    memories.push_back(Allocate(100));
+    memset(memories.back()->data(), i, 100);
+  }
+  EXPECT_EQ(allocator_.GetSpanCountForTesting(), 1u);
+  EXPECT_EQ(bytes_allocated_, 1000u);
+
+  // Another size class goes to another span.
+  memories.push_back(Allocate(Allocator::kMaxAllocationSize));
+  EXPECT_EQ(allocator_.GetSpanCountForTesting(), 2u);
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(memories[i]->data_as<uint8_t>()[99], i);
+  }
+  memories.clear();
+  EXPECT_EQ(allocator_.GetSpanCountForTesting(), 0u);
+  EXPECT_EQ(bytes_allocated_, 0u);
+}
+
+TEST_F(MadvFreeDiscardableSpanAllocatorPosixTest, UnlocksAreDeferred) {
+  std::vector<std::unique_ptr<DiscardableMemory>> memories;
+  for (int i = 0; i < 100; ++i) {
+    memories.push_back(Allocate(128));
+    memories.back()->data_as<uint8_t>()[0] = static_cast<uint8_t>(i);
+  }
+
+  // Locking the memory again before the MADV_FREE is applied doesn't take a
+  // syscall.
+  for (auto& memory : memories) {
+    memory->Unlock();
+  }
+  for (auto& memory : memories) {
+    ASSERT_TRUE(memory->Lock());
+  }
+  EXPECT_EQ(allocator_.GetMadviseCountForTesting(), 0u);
+
+  // Applying it takes one for all the memory of the span.
+  for (auto& memory : memories) {
+    memory->Unlock();
+  }
+  allocator_.FlushPendingUnlocks();
+#ifdef MADV_FREE
+  EXPECT_EQ(allocator_.GetMadviseCountForTesting(), 1u);
+#endif
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(memories[i]->Lock());
+    EXPECT_EQ(memories[i]->data_as<uint8_t>()[0], i);
+  }
+}
+
+TEST_F(MadvFreeDiscardableSpanAllocatorPosixTest, PendingUnlocksAreBounded) {
+  const size_t slots_per_span =
+      Allocator::kSpanSize / Allocator::kMaxAllocationSize;
+  std::vector<std::unique_ptr<DiscardableMemory>> memories;
+  for (size_t i = 0; i < (Allocator::kMaxPendingSpans + 1) * slots_per_span;
+       ++i) {
+    memories.push_back(Allocate(Allocator::kMaxAllocationSize));
+  }
+  EXPECT_EQ(allocator_.GetSpanCountForTesting(),
+            Allocator::kMaxPendingSpans + 1);
+  for (auto& memory : memories) {
+    memory->Unlock();
+  }
+#ifdef MADV_FREE
+  EXPECT_EQ(allocator_.GetMadviseCountForTesting(),
+            Allocator::kMaxPendingSpans + 1);
+#endif
+}
+
+TEST_F(MadvFreeDiscardableSpanAllocatorPosixTest, DiscardFailsAllLocks) {
+  auto memory1 = Allocate(100);
+  auto memory2 = Allocate(100);
+  memory1->Unlock();
+  memory2->Unlock();
+  memory1->DiscardForTesting();
+  EXPECT_FALSE(memory1->Lock());
+  EXPECT_FALSE(memory2->Lock());
+
+  // The discarded span doesn't take new allocations.
+  auto memory3 = Allocate(100);
+  EXPECT_EQ(allocator_.GetSpanCountForTesting(), 2u);
+  memory1.reset();
+  memory2.reset();
+  EXPECT_EQ(allocator_.GetSpanCountForTesting(), 1u);
+}
+
+TEST_F(MadvFreeDiscardableSpanAllocatorPosixTest, DetectsDiscardedPages) {
+  auto memory1 = Allocate(100);
+  auto memory2 = Allocate(100);
+  uint8_t* page = reinterpret_cast<uint8_t*>(bits::AlignDown(
+      reinterpret_cast<uintptr_t>(memory1->data()), GetPageSize()));
+  memory1->Unlock();
+  memory2->Unlock();
+  allocator_.FlushPendingUnlocks();
+
+  // Has the effect of the kernel discarding the page under memory pressure.
+  ASSERT_EQ(madvise(page, GetPageSize(), MADV_DONTNEED), 0);
+  EXPECT_FALSE(memory2->Lock());
+  EXPECT_FALSE(memory1->Lock());
+}
+
+TEST_F(MadvFreeDiscardableSpanAllocatorPosixTest, PurgeInUnlockOrder) {
+  // Each size class has its own span.
+  auto memory1 = Allocate(64);
+  auto memory2 = Allocate(128);
+  auto memory3 = Allocate(256);
+  EXPECT_EQ(allocator_.GetSpanCountForTesting(), 3u);
+  memory2->Unlock();
+  memory1->Unlock();
+  memory3->Unlock();
+
+  allocator_.PurgeUnlockedSpans(Allocator::kSpanSize);
+  EXPECT_FALSE(memory2->Lock());
+  EXPECT_TRUE(memory1->Lock());
+  EXPECT_TRUE(memory3->Lock());
+}
+
+TEST_F(MadvFreeDiscardableSpanAllocatorPosixTest, MemoryPressure) {
+  auto memory1 = Allocate(64);
+  auto memory2 = Allocate(128);
+  auto memory3 = Allocate(256);
+  memory1->Unlock();
+  memory2->Unlock();
+
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  EXPECT_FALSE(memory1->Lock());
+  EXPECT_FALSE(memory2->Lock());
+  // Locked memory stays.
+  memory3->Unlock();
+  EXPECT_TRUE(memory3->Lock());
+}
+
+}  // namespace base
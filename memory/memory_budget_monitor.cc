@@ -0,0 +1,276 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/memory_budget_monitor.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/memory/raw_ptr.h"
+#include "base/no_destructor.h"
+#include "base/process/process_metrics.h"
+#include "base/synchronization/lock.h"
+#include "base/task/task_runner.h"
+#include "build/build_config.h"
+#include "partition_alloc/partition_alloc_buildflags.h"
+
+#if PA_BUILDFLAG(USE_PARTITION_ALLOC_AS_MALLOC)
+#include "partition_alloc/partition_root.h"
+#include "partition_alloc/shim/allocator_shim_default_dispatch_to_partition_alloc.h"
+#endif
+
+namespace base {
+
+namespace {
+
+using MemoryPressureLevel = MemoryPressureListener::MemoryPressureLevel;
+
+MemoryBudgetMonitor* g_budget_monitor = nullptr;
+
+// Whether the tasks posted to backpressured task runners are held. Set while
+// the usage is above the soft limit.
+std::atomic<bool> g_holds_tasks{false};
+
+class BackpressuredTaskRunner;
+
+// The backpressured task runners which are alive, to post their held tasks.
+struct BackpressuredTaskRunners {
+  Lock lock;
+  std::vector<raw_ptr<BackpressuredTaskRunner>> runners GUARDED_BY(lock);
+};
+
+BackpressuredTaskRunners& GetBackpressuredTaskRunners() {
+  static NoDestructor<BackpressuredTaskRunners> runners;
+  return *runners;
+}
+
+class BackpressuredTaskRunner : public TaskRunner {
+ public:
+  struct HeldTask {
+    Location from_here;
+    OnceClosure task;
+    TimeDelta delay;
+  };
+
+  explicit BackpressuredTaskRunner(scoped_refptr<TaskRunner> task_runner)
+      : task_runner_(std::move(task_runner)) {
+    BackpressuredTaskRunners& runners = GetBackpressuredTaskRunners();
+    AutoLock lock(runners.lock);
+    runners.runners.push_back(this);
+  }
+
+  // TaskRunner:
+  bool PostDelayedTask(const Location& from_here,
+                       OnceClosure task,
+                       TimeDelta delay) override {
+    {
+      AutoLock lock(lock_);
+      if (g_holds_tasks.load(std::memory_order_relaxed)) {
+        held_tasks_.push_back({from_here, std::move(task), delay});
+        return true;
+      }
+    }
+    return task_runner_->PostDelayedTask(from_here, std::move(task), delay);
+  }
+
+  // Moves the held tasks to `tasks`, and returns the runner to post them to.
+  scoped_refptr<TaskRunner> TakeHeldTasks(std::vector<HeldTask>& tasks) {
+    AutoLock lock(lock_);
+    std::move(held_tasks_.begin(), held_tasks_.end(),
+              std::back_inserter(tasks));
+    held_tasks_.clear();
+    return task_runner_;
+  }
+
+ private:
+  ~BackpressuredTaskRunner() override {
+    BackpressuredTaskRunners& runners = GetBackpressuredTaskRunners();
+    AutoLock lock(runners.lock);
+    std::erase(runners.runners, this);
+  }
+
+  const scoped_refptr<TaskRunner> task_runner_;
+  Lock lock_;
+  std::vector<HeldTask> held_tasks_ GUARDED_BY(lock_);
+};
+
+void PostHeldTasks() {
+  std::vector<std::pair<scoped_refptr<TaskRunner>,
+                        std::vector<BackpressuredTaskRunner::HeldTask>>>
+      held_tasks;
+  {
+    BackpressuredTaskRunners& runners = GetBackpressuredTaskRunners();
+    AutoLock lock(runners.lock);
+    for (BackpressuredTaskRunner* runner : runners.runners) {
+      std::vector<BackpressuredTaskRunner::HeldTask> tasks;
+      scoped_refptr<TaskRunner> task_runner = runner->TakeHeldTasks(tasks);
+      if (!tasks.empty()) {
+        held_tasks.emplace_back(std::move(task_runner), std::move(tasks));
+      }
+    }
+  }
+  // Posted without holding the lock, as the tasks which are dropped by their
+  // runner may release the last reference to a backpressured runner.
+  for (auto& [task_runner, tasks] : held_tasks) {
+    for (BackpressuredTaskRunner::HeldTask& task : tasks) {
+      task_runner->PostDelayedTask(task.from_here, std::move(task.task),
+                                   task.delay);
+    }
+  }
+}
+
+void SetHoldsTasks(bool holds_tasks) {
+  if (g_holds_tasks.exchange(holds_tasks, std::memory_order_relaxed) &&
+      !holds_tasks) {
+    PostHeldTasks();
+  }
+}
+
+size_t GetPartitionAllocCommittedBytes() {
+#if PA_BUILDFLAG(USE_PARTITION_ALLOC_AS_MALLOC)
+  // The committed size of the roots is a counter, unlike their DumpStats(),
+  // which walks all of their buckets.
+  size_t committed_bytes = allocator_shim::internal::PartitionAllocMalloc::
+                               Allocator()
+                                   ->get_total_size_of_committed_pages();
+  if (auto* original_allocator = allocator_shim::internal::
+          PartitionAllocMalloc::OriginalAllocator()) {
+    committed_bytes += original_allocator->get_total_size_of_committed_pages();
+  }
+  return committed_bytes;
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
+MemoryBudgetMonitor::MemoryBudgetMonitor(size_t soft_limit_bytes,
+                                         size_t hard_limit_bytes,
+                                         TimeDelta sampling_interval)
+    : MemoryBudgetMonitor(
+          soft_limit_bytes,
+          hard_limit_bytes,
+          sampling_interval,
+          BindRepeating(&MemoryBudgetMonitor::GetProcessUsage,
+                        Owned(ProcessMetrics::CreateCurrentProcessMetrics()
+                                  .release()))) {}
+
+MemoryBudgetMonitor::MemoryBudgetMonitor(size_t soft_limit_bytes,
+                                         size_t hard_limit_bytes,
+                                         TimeDelta sampling_interval,
+                                         UsageCallback usage_callback)
+    : soft_limit_bytes_(soft_limit_bytes),
+      hard_limit_bytes_(hard_limit_bytes),
+      usage_callback_(std::move(usage_callback)) {
+  DCHECK_LE(soft_limit_bytes_, hard_limit_bytes_);
+  DCHECK(!g_budget_monitor);
+  g_budget_monitor = this;
+  timer_.Start(FROM_HERE, sampling_interval,
+               BindRepeating(&MemoryBudgetMonitor::Sample, Unretained(this)));
+}
+
+MemoryBudgetMonitor::~MemoryBudgetMonitor() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_EQ(g_budget_monitor, this);
+  g_budget_monitor = nullptr;
+  // The tasks mustn't be held forever.
+  SetHoldsTasks(false);
+}
+
+// static
+MemoryBudgetMonitor* MemoryBudgetMonitor::Get() {
+  return g_budget_monitor;
+}
+
+// static
+scoped_refptr<TaskRunner> MemoryBudgetMonitor::CreateBackpressuredTaskRunner(
+    scoped_refptr<TaskRunner> task_runner) {
+  return MakeRefCounted<BackpressuredTaskRunner>(std::move(task_runner));
+}
+
+// static
+size_t MemoryBudgetMonitor::GetProcessUsage(ProcessMetrics* process_metrics) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  const size_t process_bytes = process_metrics->GetResidentSetSize();
+#else
+  const size_t process_bytes = process_metrics->GetMallocUsage();
+#endif
+  // Pages committed by PartitionAlloc which were never touched, or were
+  // swapped out, aren't resident, but may become so at any time.
+  return std::max(process_bytes, GetPartitionAllocCommittedBytes());
+}
+
+MemoryPressureLevel MemoryBudgetMonitor::GetCurrentPressureLevel() const {
+  return level_.load(std::memory_order_relaxed);
+}
+
+void MemoryBudgetMonitor::SetLimits(size_t soft_limit_bytes,
+                                    size_t hard_limit_bytes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_LE(soft_limit_bytes, hard_limit_bytes);
+  soft_limit_bytes_ = soft_limit_bytes;
+  hard_limit_bytes_ = hard_limit_bytes;
+}
+
+size_t MemoryBudgetMonitor::soft_limit_bytes() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return soft_limit_bytes_;
+}
+
+size_t MemoryBudgetMonitor::hard_limit_bytes() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return hard_limit_bytes_;
+}
+
+size_t MemoryBudgetMonitor::last_usage_bytes() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return last_usage_bytes_;
+}
+
+void MemoryBudgetMonitor::SampleNow() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  Sample();
+  timer_.Reset();
+}
+
+void MemoryBudgetMonitor::Sample() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  last_usage_bytes_ = usage_callback_.Run();
+  const MemoryPressureLevel level = GetLevelForUsage(last_usage_bytes_);
+  const MemoryPressureLevel previous_level =
+      level_.exchange(level, std::memory_order_relaxed);
+
+  // Tasks are released before the notification, which may take a while.
+  SetHoldsTasks(level != MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_NONE);
+  if (level == MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_NONE) {
+    return;
+  }
+  const TimeTicks now = TimeTicks::Now();
+  if (level <= previous_level &&
+      now - last_notification_time_ < kRenotifyInterval) {
+    return;
+  }
+  last_notification_time_ = now;
+  MemoryPressureListener::NotifyMemoryPressure(level);
+}
+
+MemoryPressureLevel MemoryBudgetMonitor::GetLevelForUsage(
+    size_t usage_bytes) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (usage_bytes >= hard_limit_bytes_) {
+    return MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_CRITICAL;
+  }
+  if (usage_bytes >= soft_limit_bytes_) {
+    return MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_MODERATE;
+  }
+  return MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_NONE;
+}
+
+}  // namespace base
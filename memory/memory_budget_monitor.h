@@ -0,0 +1,119 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_MEMORY_BUDGET_MONITOR_H_
+#define BASE_MEMORY_MEMORY_BUDGET_MONITOR_H_
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/functional/callback.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/memory_pressure_monitor.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/sequence_checker.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace base {
+
+class ProcessMetrics;
+class TaskRunner;
+
+// A MemoryPressureMonitor which derives the memory pressure from a budget for
+// the memory of the process, rather than from signals of the OS. This suits
+// processes which run with a fixed amount of memory, e.g. in a container, and
+// are killed once they exceed it without the OS ever reporting pressure.
+//
+// The usage of the process is sampled periodically, as the larger of its
+// resident set size and of the pages committed by the malloc partitions of
+// PartitionAlloc, when it is the malloc implementation. The pressure level is:
+//   - MEMORY_PRESSURE_LEVEL_NONE below the soft limit.
+//   - MEMORY_PRESSURE_LEVEL_MODERATE from the soft limit.
+//   - MEMORY_PRESSURE_LEVEL_CRITICAL from the hard limit.
+// MemoryPressureListeners are notified when the level rises, and again every
+// kRenotifyInterval while it stays above NONE, for them to keep freeing memory.
+//
+// Must be created, used and destroyed on a sequence with a task runner, which
+// runs the sampling. As all MemoryPressureMonitors, there can only be one at a
+// time, and the OS specific monitors must not be created with it.
+class BASE_EXPORT MemoryBudgetMonitor : public MemoryPressureMonitor {
+ public:
+  // Returns the usage of the process, in bytes.
+  using UsageCallback = RepeatingCallback<size_t()>;
+
+  static constexpr TimeDelta kDefaultSamplingInterval = Seconds(1);
+  static constexpr TimeDelta kRenotifyInterval = Seconds(10);
+
+  // `soft_limit_bytes` must not be greater than `hard_limit_bytes`.
+  MemoryBudgetMonitor(size_t soft_limit_bytes,
+                      size_t hard_limit_bytes,
+                      TimeDelta sampling_interval = kDefaultSamplingInterval);
+  // Uses `usage_callback` to sample the usage of the process.
+  MemoryBudgetMonitor(size_t soft_limit_bytes,
+                      size_t hard_limit_bytes,
+                      TimeDelta sampling_interval,
+                      UsageCallback usage_callback);
+
+  MemoryBudgetMonitor(const MemoryBudgetMonitor&) = delete;
+  MemoryBudgetMonitor& operator=(const MemoryBudgetMonitor&) = delete;
+
+  ~MemoryBudgetMonitor() override;
+
+  // Returns the current monitor, if it is a MemoryBudgetMonitor.
+  static MemoryBudgetMonitor* Get();
+
+  // Returns a TaskRunner which posts to `task_runner`, but holds the tasks
+  // posted while the usage is above the soft limit of the current monitor,
+  // and posts them once it falls back below. This lets task sources which
+  // only allocate to get ahead, e.g. by prefetching or precomputing, stop
+  // when the process runs out of budget. The held tasks may run after tasks
+  // posted once they are released, so the runner isn't sequenced even if
+  // `task_runner` is.
+  static scoped_refptr<TaskRunner> CreateBackpressuredTaskRunner(
+      scoped_refptr<TaskRunner> task_runner);
+
+  // The default UsageCallback.
+  static size_t GetProcessUsage(ProcessMetrics* process_metrics);
+
+  // MemoryPressureMonitor:
+  MemoryPressureLevel GetCurrentPressureLevel() const override;
+
+  // Changes the limits, which are applied from the next sample.
+  void SetLimits(size_t soft_limit_bytes, size_t hard_limit_bytes);
+
+  size_t soft_limit_bytes() const;
+  size_t hard_limit_bytes() const;
+
+  // Returns the usage of the last sample, in bytes.
+  size_t last_usage_bytes() const;
+
+  // Samples the usage right away, e.g. after a large allocation.
+  void SampleNow();
+
+ private:
+  void Sample();
+  MemoryPressureLevel GetLevelForUsage(size_t usage_bytes) const;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  size_t soft_limit_bytes_ GUARDED_BY_CONTEXT(sequence_checker_);
+  size_t hard_limit_bytes_ GUARDED_BY_CONTEXT(sequence_checker_);
+  const UsageCallback usage_callback_;
+
+  // Read by GetCurrentPressureLevel() on any thread.
+  std::atomic<MemoryPressureLevel> level_{
+      MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_NONE};
+  size_t last_usage_bytes_ GUARDED_BY_CONTEXT(sequence_checker_) = 0;
+  TimeTicks last_notification_time_ GUARDED_BY_CONTEXT(sequence_checker_);
+
+  RepeatingTimer timer_ GUARDED_BY_CONTEXT(sequence_checker_);
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_MEMORY_BUDGET_MONITOR_H_
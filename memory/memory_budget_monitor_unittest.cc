@@ -0,0 +1,174 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/memory_budget_monitor.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/process/process_metrics.h"
+#include "base/run_loop.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/task_runner.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+using MemoryPressureLevel = MemoryPressureListener::MemoryPressureLevel;
+
+namespace {
+
+constexpr size_t kSoftLimit = 100;
+constexpr size_t kHardLimit = 200;
+constexpr TimeDelta kSamplingInterval = Seconds(1);
+
+}  // namespace
+
+class MemoryBudgetMonitorTest : public testing::Test {
+ protected:
+  MemoryBudgetMonitorTest()
+      : monitor_(std::make_unique<MemoryBudgetMonitor>(
+            kSoftLimit,
+            kHardLimit,
+            kSamplingInterval,
+            BindLambdaForTesting([this] { return usage_; }))),
+        listener_(FROM_HERE,
+                  BindRepeating(&MemoryBudgetMonitorTest::OnMemoryPressure,
+                                Unretained(this))) {}
+
+  void OnMemoryPressure(MemoryPressureLevel level) {
+    levels_.push_back(level);
+  }
+
+  // Sets the usage, and waits for it to be sampled.
+  void SetUsage(size_t usage) {
+    usage_ = usage;
+    task_environment_.FastForwardBy(kSamplingInterval);
+  }
+
+  test::TaskEnvironment task_environment_{
+      test::TaskEnvironment::TimeSource::MOCK_TIME};
+  size_t usage_ = 0;
+  std::unique_ptr<MemoryBudgetMonitor> monitor_;
+  MemoryPressureListener listener_;
+  std::vector<MemoryPressureLevel> levels_;
+};
+
+TEST_F(MemoryBudgetMonitorTest, Get) {
+  EXPECT_EQ(MemoryBudgetMonitor::Get(), monitor_.get());
+  EXPECT_EQ(MemoryPressureMonitor::Get(), monitor_.get());
+}
+
+TEST_F(MemoryBudgetMonitorTest, Levels) {
+  SetUsage(kSoftLimit - 1);
+  EXPECT_EQ(monitor_->GetCurrentPressureLevel(),
+            MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_NONE);
+  EXPECT_EQ(monitor_->last_usage_bytes(), kSoftLimit - 1);
+
+  SetUsage(kSoftLimit);
+  EXPECT_EQ(monitor_->GetCurrentPressureLevel(),
+            MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_MODERATE);
+
+  SetUsage(kHardLimit);
+  EXPECT_EQ(monitor_->GetCurrentPressureLevel(),
+            MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_CRITICAL);
+
+  SetUsage(0);
+  EXPECT_EQ(monitor_->GetCurrentPressureLevel(),
+            MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_NONE);
+
+  EXPECT_EQ(levels_, (std::vector<MemoryPressureLevel>{
+                         MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_MODERATE,
+                         MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_CRITICAL}));
+}
+
+TEST_F(MemoryBudgetMonitorTest, Renotifies) {
+  SetUsage(kSoftLimit);
+  EXPECT_EQ(levels_.size(), 1u);
+
+  // Staying at the same level doesn't notify again until the interval passed.
+  task_environment_.FastForwardBy(MemoryBudgetMonitor::kRenotifyInterval -
+                                  kSamplingInterval);
+  EXPECT_EQ(levels_.size(), 1u);
+  task_environment_.FastForwardBy(kSamplingInterval);
+  EXPECT_EQ(levels_.size(), 2u);
+
+  // Nor does falling from critical to moderate.
+  SetUsage(kHardLimit);
+  SetUsage(kSoftLimit);
+  EXPECT_EQ(levels_, (std::vector<MemoryPressureLevel>{
+                         MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_MODERATE,
+                         MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_MODERATE,
+                         MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_CRITICAL}));
+}
+
+TEST_F(MemoryBudgetMonitorTest, SetLimits) {
+  SetUsage(kSoftLimit);
+  monitor_->SetLimits(kSoftLimit * 2, kHardLimit * 2);
+  EXPECT_EQ(monitor_->soft_limit_bytes(), kSoftLimit * 2);
+  EXPECT_EQ(monitor_->hard_limit_bytes(), kHardLimit * 2);
+  task_environment_.FastForwardBy(kSamplingInterval);
+  EXPECT_EQ(monitor_->GetCurrentPressureLevel(),
+            MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_NONE);
+}
+
+TEST_F(MemoryBudgetMonitorTest, SampleNow) {
+  usage_ = kHardLimit;
+  monitor_->SampleNow();
+  EXPECT_EQ(monitor_->GetCurrentPressureLevel(),
+            MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(levels_, (std::vector<MemoryPressureLevel>{
+                         MemoryPressureLevel::MEMORY_PRESSURE_LEVEL_CRITICAL}));
+}
+
+TEST_F(MemoryBudgetMonitorTest, BackpressuredTaskRunner) {
+  scoped_refptr<TaskRunner> task_runner =
+      MemoryBudgetMonitor::CreateBackpressuredTaskRunner(
+          SequencedTaskRunner::GetCurrentDefault());
+  int runs = 0;
+  auto increment = BindLambdaForTesting([&] { ++runs; });
+
+  task_runner->PostTask(FROM_HERE, increment);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(runs, 1);
+
+  // Tasks are held while over the soft limit.
+  SetUsage(kSoftLimit);
+  task_runner->PostTask(FROM_HERE, increment);
+  task_runner->PostTask(FROM_HERE, increment);
+  SetUsage(kHardLimit);
+  EXPECT_EQ(runs, 1);
+
+  SetUsage(kSoftLimit - 1);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(runs, 3);
+}
+
+TEST_F(MemoryBudgetMonitorTest, ReleasesTasksOnDestruction) {
+  scoped_refptr<TaskRunner> task_runner =
+      MemoryBudgetMonitor::CreateBackpressuredTaskRunner(
+          SequencedTaskRunner::GetCurrentDefault());
+  bool ran = false;
+  SetUsage(kHardLimit);
+  task_runner->PostTask(FROM_HERE, BindLambdaForTesting([&] { ran = true; }));
+  task_environment_.FastForwardBy(kSamplingInterval);
+  EXPECT_FALSE(ran);
+
+  monitor_.reset();
+  RunLoop().RunUntilIdle();
+  EXPECT_TRUE(ran);
+}
+
+TEST(MemoryBudgetMonitorProcessUsageTest, GetProcessUsage) {
+  std::unique_ptr<ProcessMetrics> process_metrics =
+      ProcessMetrics::CreateCurrentProcessMetrics();
+  EXPECT_GT(MemoryBudgetMonitor::GetProcessUsage(process_metrics.get()), 0u);
+}
+
+}  // namespace base
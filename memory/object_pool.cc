@@ -0,0 +1,249 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/object_pool.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/memory/aligned_memory.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace base::internal {
+
+namespace {
+
+struct PoolRegistry {
+  Lock lock;
+  std::vector<ObjectPoolBase*> pools GUARDED_BY(lock);
+};
+
+PoolRegistry& GetPoolRegistry() {
+  static NoDestructor<PoolRegistry> registry;
+  return *registry;
+}
+
+// Set once the memory pressure listener of the pools is created, or being
+// created.
+std::atomic_bool g_listening_to_memory_pressure{false};
+
+}  // namespace
+
+ObjectPoolBase::Stats::Stats() = default;
+ObjectPoolBase::Stats::Stats(const Stats&) = default;
+ObjectPoolBase::Stats& ObjectPoolBase::Stats::operator=(const Stats&) =
+    default;
+ObjectPoolBase::Stats::~Stats() = default;
+
+ObjectPoolBase::ThreadCache::ThreadCache(ObjectPoolBase* pool) : pool(pool) {}
+
+ObjectPoolBase::ThreadCache::~ThreadCache() {
+  if (free_slots) {
+    pool->PushToSharedCache(free_slots, num_free_slots);
+  }
+}
+
+ObjectPoolBase::ObjectPoolBase(const char* name,
+                               size_t object_size,
+                               size_t object_alignment)
+    : name_(name),
+      slot_size_(std::max(object_size, sizeof(FreeSlot))),
+      slot_alignment_(std::max(object_alignment, alignof(FreeSlot))) {
+  PoolRegistry& registry = GetPoolRegistry();
+  AutoLock lock(registry.lock);
+  registry.pools.push_back(this);
+}
+
+ObjectPoolBase::~ObjectPoolBase() {
+  {
+    PoolRegistry& registry = GetPoolRegistry();
+    AutoLock lock(registry.lock);
+    std::erase(registry.pools, this);
+  }
+  // The cache of this thread goes to the shared cache, and the caches of the
+  // other threads must be gone already.
+  thread_caches_.Set(nullptr);
+  FreeSlots(TakeSharedCache());
+  DCHECK_EQ(num_allocated_slots_.load(), 0u)
+      << "All the objects of a pool must be deleted before it.";
+}
+
+void ObjectPoolBase::Trim() {
+  if (ThreadCache* cache = thread_caches_.Get()) {
+    FreeSlots(std::exchange(cache->free_slots, nullptr));
+    cache->num_free_slots = 0;
+  }
+  FreeSlots(TakeSharedCache());
+}
+
+ObjectPoolBase::Stats ObjectPoolBase::GetStats() const {
+  Stats stats;
+  stats.name = name_;
+  stats.allocated_slots = num_allocated_slots_.load(std::memory_order_relaxed);
+  stats.allocated_size = stats.allocated_slots * slot_size_;
+  stats.shared_cached_size =
+      num_shared_cached_slots_.load(std::memory_order_relaxed) * slot_size_;
+  return stats;
+}
+
+// static
+std::vector<ObjectPoolBase::Stats> ObjectPoolBase::GetStatsForAllPools() {
+  std::map<std::string, Stats> stats_by_name;
+  {
+    PoolRegistry& registry = GetPoolRegistry();
+    AutoLock lock(registry.lock);
+    for (const ObjectPoolBase* pool : registry.pools) {
+      const Stats pool_stats = pool->GetStats();
+      Stats& stats = stats_by_name[pool_stats.name];
+      stats.name = pool_stats.name;
+      stats.allocated_slots += pool_stats.allocated_slots;
+      stats.allocated_size += pool_stats.allocated_size;
+      stats.shared_cached_size += pool_stats.shared_cached_size;
+    }
+  }
+  std::vector<Stats> all_stats;
+  all_stats.reserve(stats_by_name.size());
+  for (auto& [name, stats] : stats_by_name) {
+    all_stats.push_back(std::move(stats));
+  }
+  return all_stats;
+}
+
+ObjectPoolBase::ThreadCache& ObjectPoolBase::CreateThreadCache() {
+  auto cache = std::make_unique<ThreadCache>(this);
+  ThreadCache* raw_cache = cache.get();
+  thread_caches_.Set(std::move(cache));
+  return *raw_cache;
+}
+
+void* ObjectPoolBase::AllocateSlow(ThreadCache& cache) {
+  DCHECK(!cache.free_slots);
+  // Refill the cache of this thread from the shared cache, up to its limit.
+  FreeSlot* slots = TakeSharedCache();
+  if (slots) {
+    FreeSlot* last = slots;
+    size_t count = 1;
+    while (last->next && count < kMaxThreadCachedSlots) {
+      last = last->next;
+      ++count;
+    }
+    if (FreeSlot* rest = std::exchange(last->next, nullptr)) {
+      size_t rest_count = 1;
+      for (FreeSlot* slot = rest; slot->next; slot = slot->next) {
+        ++rest_count;
+      }
+      PushToSharedCache(rest, rest_count);
+    }
+    cache.free_slots = slots->next;
+    cache.num_free_slots = count - 1;
+    return slots;
+  }
+  return AllocateNewSlot();
+}
+
+// static
+void ObjectPoolBase::ListenToMemoryPressure() {
+  // Creating the listener binds callbacks, whose memory may come from a pool
+  // which then gets here again.
+  if (g_listening_to_memory_pressure.exchange(true,
+                                              std::memory_order_relaxed)) {
+    return;
+  }
+  static NoDestructor<MemoryPressureListener> listener(
+      FROM_HERE, DoNothing(), BindRepeating(&ObjectPoolBase::OnMemoryPressure));
+}
+
+void* ObjectPoolBase::AllocateNewSlot() {
+  if (!g_listening_to_memory_pressure.load(std::memory_order_relaxed))
+      [[unlikely]] {
+    ListenToMemoryPressure();
+  }
+  num_allocated_slots_.fetch_add(1, std::memory_order_relaxed);
+  void* slot = slot_alignment_ <= alignof(std::max_align_t)
+                   ? malloc(slot_size_)
+                   : AlignedAlloc(slot_size_, slot_alignment_);
+  CHECK(slot);
+  return slot;
+}
+
+void ObjectPoolBase::MoveToSharedCache(ThreadCache& cache, size_t count) {
+  DCHECK_LE(count, cache.num_free_slots);
+  FreeSlot* first = cache.free_slots;
+  FreeSlot* last = first;
+  for (size_t i = 1; i < count; ++i) {
+    last = last->next;
+  }
+  cache.free_slots = std::exchange(last->next, nullptr);
+  cache.num_free_slots -= count;
+  PushToSharedCache(first, count);
+}
+
+void ObjectPoolBase::PushToSharedCache(FreeSlot* first, size_t count) {
+  // Count the slots before they can be taken, so that the counter doesn't go
+  // below zero.
+  if (num_shared_cached_slots_.fetch_add(count, std::memory_order_relaxed) +
+          count >
+      kMaxSharedCachedSlots) {
+    num_shared_cached_slots_.fetch_sub(count, std::memory_order_relaxed);
+    FreeSlots(first);
+    return;
+  }
+  FreeSlot* last = first;
+  while (last->next) {
+    last = last->next;
+  }
+  FreeSlot* head = shared_cache_.load(std::memory_order_relaxed);
+  do {
+    last->next = head;
+  } while (!shared_cache_.compare_exchange_weak(head, first,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
+}
+
+ObjectPoolBase::FreeSlot* ObjectPoolBase::TakeSharedCache() {
+  if (!shared_cache_.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  FreeSlot* slots = shared_cache_.exchange(nullptr, std::memory_order_acquire);
+  size_t count = 0;
+  for (FreeSlot* slot = slots; slot; slot = slot->next) {
+    ++count;
+  }
+  num_shared_cached_slots_.fetch_sub(count, std::memory_order_relaxed);
+  return slots;
+}
+
+void ObjectPoolBase::FreeSlots(FreeSlot* first) {
+  size_t count = 0;
+  while (first) {
+    FreeSlot* slot = std::exchange(first, first->next);
+    if (slot_alignment_ <= alignof(std::max_align_t)) {
+      free(slot);
+    } else {
+      AlignedFree(slot);
+    }
+    ++count;
+  }
+  num_allocated_slots_.fetch_sub(count, std::memory_order_relaxed);
+}
+
+// static
+void ObjectPoolBase::OnMemoryPressure(
+    MemoryPressureListener::MemoryPressureLevel level) {
+  PoolRegistry& registry = GetPoolRegistry();
+  AutoLock lock(registry.lock);
+  for (ObjectPoolBase* pool : registry.pools) {
+    pool->Trim();
+  }
+}
+
+}  // namespace base::internal
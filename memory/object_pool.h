@@ -0,0 +1,286 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_OBJECT_POOL_H_
+#define BASE_MEMORY_OBJECT_POOL_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/raw_ptr_exclusion.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/threading/thread_local.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace internal {
+
+// The part of ObjectPool which doesn't depend on the type of the objects: a
+// pool of uninitialized slots of a fixed size.
+class BASE_EXPORT ObjectPoolBase {
+ public:
+  struct BASE_EXPORT Stats {
+    Stats();
+    Stats(const Stats&);
+    Stats& operator=(const Stats&);
+    ~Stats();
+
+    std::string name;
+    // The slots allocated from malloc() and not freed yet, whether they hold
+    // an object or are cached by the pool.
+    size_t allocated_slots = 0;
+    size_t allocated_size = 0;
+    // The part of `allocated_size` cached for any thread to reuse. The caches
+    // of the threads aren't included.
+    size_t shared_cached_size = 0;
+  };
+
+  // Each thread caches up to this many free slots. The slots freed beyond
+  // that go to the cache shared by all threads, which holds up to
+  // kMaxSharedCachedSlots.
+  static constexpr size_t kMaxThreadCachedSlots = 64;
+  static constexpr size_t kMaxSharedCachedSlots = 1024;
+
+  ObjectPoolBase(const char* name, size_t object_size, size_t object_alignment);
+  ObjectPoolBase(const ObjectPoolBase&) = delete;
+  ObjectPoolBase& operator=(const ObjectPoolBase&) = delete;
+  ~ObjectPoolBase();
+
+  // Returns an uninitialized slot.
+  void* Allocate() {
+    ThreadCache* cache = GetThreadCache();
+    if (!cache) [[unlikely]] {
+      return AllocateNewSlot();
+    }
+    if (cache->free_slots) [[likely]] {
+      FreeSlot* slot =
+          std::exchange(cache->free_slots, cache->free_slots->next);
+      --cache->num_free_slots;
+      return slot;
+    }
+    return AllocateSlow(*cache);
+  }
+
+  // Gives back a slot returned by Allocate(), on any thread.
+  void Free(void* slot) {
+    ThreadCache* cache = GetThreadCache();
+    if (!cache) [[unlikely]] {
+      PushToSharedCache(new (slot) FreeSlot{nullptr}, 1);
+      return;
+    }
+    if (cache->num_free_slots == kMaxThreadCachedSlots) [[unlikely]] {
+      MoveToSharedCache(*cache, kMaxThreadCachedSlots / 2);
+    }
+    cache->free_slots = new (slot) FreeSlot{cache->free_slots};
+    ++cache->num_free_slots;
+  }
+
+  // Same as Allocate() and Free(), but without caching the slot, e.g. for
+  // users which recycle their objects only under a feature. The slots of
+  // either can be given back by either.
+  void* AllocateUncached() { return AllocateNewSlot(); }
+  void FreeUncached(void* slot) { FreeSlots(new (slot) FreeSlot{nullptr}); }
+
+  // Frees the shared cache and the cache of the calling thread.
+  void Trim();
+
+  Stats GetStats() const;
+
+  // Returns the stats of all the pools alive in the process, added up for the
+  // pools of the same name.
+  static std::vector<Stats> GetStatsForAllPools();
+
+ private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  // The free slots of a thread. Given to the shared cache when the thread
+  // exits.
+  struct ThreadCache {
+    explicit ThreadCache(ObjectPoolBase* pool);
+    ThreadCache(const ThreadCache&) = delete;
+    ThreadCache& operator=(const ThreadCache&) = delete;
+    ~ThreadCache();
+
+    const raw_ptr<ObjectPoolBase> pool;
+    // Not raw_ptr<>, as this is the fast path, and these are free slots.
+    RAW_PTR_EXCLUSION FreeSlot* free_slots = nullptr;
+    size_t num_free_slots = 0;
+  };
+
+  // Returns null once the thread-local storage of the thread is being
+  // destroyed, e.g. when the destructor of a thread-local object deletes a
+  // pooled object. The slots then bypass the cache of the thread.
+  ThreadCache* GetThreadCache() {
+    if (ThreadLocalStorage::HasBeenDestroyed()) [[unlikely]] {
+      return nullptr;
+    }
+    ThreadCache* cache = thread_caches_.Get();
+    if (!cache) [[unlikely]] {
+      return &CreateThreadCache();
+    }
+    return cache;
+  }
+  ThreadCache& CreateThreadCache();
+
+  void* AllocateSlow(ThreadCache& cache);
+  // Creates the memory pressure listener of all the pools, unless it exists.
+  // It's created the first time a pool allocates a slot, rather than with the
+  // first pool, since the pools recycling the memory of callbacks are created
+  // when binding the callback of the listener.
+  static void ListenToMemoryPressure();
+  // Allocates a slot from malloc().
+  void* AllocateNewSlot();
+  // Moves the `count` most recently freed slots of `cache` to the shared
+  // cache, or frees them if it is full.
+  void MoveToSharedCache(ThreadCache& cache, size_t count);
+  // Pushes the list of `count` slots starting at `first` to the shared cache,
+  // or frees them if it is full.
+  void PushToSharedCache(FreeSlot* first, size_t count);
+  // Takes all the slots in the shared cache. The counters may lag behind the
+  // slots pushed concurrently, so only a list is returned.
+  FreeSlot* TakeSharedCache();
+  void FreeSlots(FreeSlot* first);
+
+  // Trims all of the pools.
+  static void OnMemoryPressure(
+      MemoryPressureListener::MemoryPressureLevel level);
+
+  const std::string name_;
+  const size_t slot_size_;
+  const size_t slot_alignment_;
+
+  // A stack which is only ever pushed to, or emptied at once, so there is no
+  // ABA problem.
+  std::atomic<FreeSlot*> shared_cache_{nullptr};
+  std::atomic<size_t> num_shared_cached_slots_{0};
+  std::atomic<size_t> num_allocated_slots_{0};
+
+  ThreadLocalOwnedPointer<ThreadCache> thread_caches_;
+};
+
+}  // namespace internal
+
+// ObjectPool<T> recycles the memory of objects of type T, which are created
+// and destroyed at high rates, such as tasks and callbacks. Objects are
+// constructed and destroyed as usual, but their memory goes to a cache of the
+// thread deleting them, where the next New() on that thread finds it without a
+// lock or an atomic operation. A thread which frees more objects than it
+// creates, as a consumer does, hands them over in batches to a lock-free cache
+// shared by all threads, where others, such as the producer, take them from.
+//
+// The shared cache and the cache of the thread receiving the notification are
+// freed on memory pressure, and the memory of every pool is reported by
+// MallocDumpProvider under "malloc/object_pools/<name>", as part of malloc's
+// allocated objects.
+//
+// A pool is meant to be static and alive until the process exits, e.g. in a
+// NoDestructor, since destroying it requires that no other thread used it,
+// and that all of its objects were deleted.
+//
+// Example usage:
+//   ObjectPool<Request>& RequestPool() {
+//     static NoDestructor<ObjectPool<Request>> pool("Request");
+//     return *pool;
+//   }
+//   ObjectPool<Request>::UniquePtr request = RequestPool().MakeUnique(url);
+//
+// For ref-counted types, see ObjectPoolRefCountedTraits below.
+template <typename T>
+class ObjectPool {
+ public:
+  // Deletes objects through their pool, e.g. for std::unique_ptr.
+  class Deleter {
+   public:
+    Deleter() = default;
+    explicit Deleter(ObjectPool* pool) : pool_(pool) {}
+
+    void operator()(T* object) const { pool_->Delete(object); }
+
+   private:
+    raw_ptr<ObjectPool> pool_ = nullptr;
+  };
+  using UniquePtr = std::unique_ptr<T, Deleter>;
+
+  // `name` is used for memory dumps, and must be made of alphanumeric
+  // characters and underscores.
+  explicit ObjectPool(const char* name) : base_(name, sizeof(T), alignof(T)) {}
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+  ~ObjectPool() = default;
+
+  // Creates an object, which must be deleted with Delete(). T must have a
+  // public constructor, or befriend ObjectPool<T>.
+  template <typename... Args>
+  T* New(Args&&... args) {
+    return new (base_.Allocate()) T(std::forward<Args>(args)...);
+  }
+
+  // Deletes an object created by New(), on any thread.
+  void Delete(T* object) {
+    if (!object) {
+      return;
+    }
+    object->~T();
+    base_.Free(object);
+  }
+
+  template <typename... Args>
+  UniquePtr MakeUnique(Args&&... args) {
+    return UniquePtr(New(std::forward<Args>(args)...), Deleter(this));
+  }
+
+  // Creates a ref-counted object the way MakeRefCounted() does. T must use
+  // ObjectPoolRefCountedTraits<T>, for its last reference to delete it through
+  // this pool.
+  template <typename... Args>
+  scoped_refptr<T> MakeRefCounted(Args&&... args) {
+    return subtle::AdoptRefIfNeeded(New(std::forward<Args>(args)...),
+                                    subtle::GetRefCountPreference<T>());
+  }
+
+  // Frees the memory cached by the pool, for all threads but the caches of
+  // the other threads.
+  void Trim() { base_.Trim(); }
+
+  internal::ObjectPoolBase::Stats GetStats() const { return base_.GetStats(); }
+
+ private:
+  internal::ObjectPoolBase base_;
+};
+
+// The traits of RefCounted<T> or RefCountedThreadSafe<T> for types created by
+// ObjectPool<T>::MakeRefCounted(), which their last reference deletes through
+// the pool returned by `T::GetObjectPool()`:
+//
+//   class Foo
+//       : public RefCountedThreadSafe<Foo, ObjectPoolRefCountedTraits<Foo>> {
+//    public:
+//     static ObjectPool<Foo>& GetObjectPool();
+//    private:
+//     friend class ObjectPool<Foo>;
+//     ~Foo();
+//   };
+//   scoped_refptr<Foo> foo = Foo::GetObjectPool().MakeRefCounted();
+template <typename T>
+struct ObjectPoolRefCountedTraits {
+  static void Destruct(const T* object) {
+    T::GetObjectPool().Delete(const_cast<T*>(object));
+  }
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_OBJECT_POOL_H_
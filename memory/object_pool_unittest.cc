@@ -0,0 +1,274 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/object_pool.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted.h"
+#include "base/no_destructor.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread.h"
+#include "base/threading/thread_local.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+struct Point {
+  Point(int x, int y) : x(x), y(y) {}
+
+  int x;
+  int y;
+};
+
+struct alignas(64) OverAligned {
+  char data[3];
+};
+
+class RefCountedObject
+    : public RefCountedThreadSafe<
+          RefCountedObject,
+          ObjectPoolRefCountedTraits<RefCountedObject>> {
+ public:
+  explicit RefCountedObject(int* destroyed) : destroyed_(destroyed) {}
+
+  static ObjectPool<RefCountedObject>& GetObjectPool() {
+    static NoDestructor<ObjectPool<RefCountedObject>> pool(
+        "RefCountedObject");
+    return *pool;
+  }
+
+ private:
+  friend class ObjectPool<RefCountedObject>;
+
+  ~RefCountedObject() { ++*destroyed_; }
+
+  raw_ptr<int> destroyed_;
+};
+
+// Deletes a pooled object when the thread-local storage of its thread is
+// destroyed.
+class ThreadLocalPoint {
+ public:
+  ThreadLocalPoint(ObjectPool<Point>* pool, Point* point)
+      : pool_(pool), point_(point) {}
+  ThreadLocalPoint(const ThreadLocalPoint&) = delete;
+  ThreadLocalPoint& operator=(const ThreadLocalPoint&) = delete;
+  ~ThreadLocalPoint() {
+    pool_->Delete(point_.ExtractAsDangling());
+    // Objects can also be created and deleted at this point.
+    pool_->Delete(pool_->New(3, 4));
+  }
+
+ private:
+  const raw_ptr<ObjectPool<Point>> pool_;
+  raw_ptr<Point> point_;
+};
+
+}  // namespace
+
+TEST(ObjectPoolTest, NewAndDelete) {
+  ObjectPool<Point> pool("Point");
+  Point* point = pool.New(1, 2);
+  EXPECT_EQ(point->x, 1);
+  EXPECT_EQ(point->y, 2);
+  EXPECT_EQ(pool.GetStats().allocated_slots, 1u);
+  EXPECT_EQ(pool.GetStats().allocated_size, sizeof(Point));
+
+  // The slot is cached by this thread, and reused by the next object.
+  void* address = point;
+  pool.Delete(point);
+  EXPECT_EQ(pool.GetStats().allocated_slots, 1u);
+  point = pool.New(3, 4);
+  EXPECT_EQ(address, point);
+  EXPECT_EQ(point->x, 3);
+  pool.Delete(point);
+
+  pool.Delete(nullptr);
+  pool.Trim();
+  EXPECT_EQ(pool.GetStats().allocated_slots, 0u);
+}
+
+TEST(ObjectPoolTest, Alignment) {
+  ObjectPool<OverAligned> pool("OverAligned");
+  std::vector<OverAligned*> objects;
+  for (int i = 0; i < 10; ++i) {
+    objects.push_back(pool.New());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(objects.back()) % 64, 0u);
+  }
+  for (OverAligned* object : objects) {
+    pool.Delete(object);
+  }
+  pool.Trim();
+}
+
+TEST(ObjectPoolTest, UniquePtr) {
+  ObjectPool<Point> pool("Point");
+  {
+    ObjectPool<Point>::UniquePtr point = pool.MakeUnique(5, 6);
+    EXPECT_EQ(point->x, 5);
+    EXPECT_EQ(pool.GetStats().allocated_slots, 1u);
+  }
+  ObjectPool<Point>::UniquePtr point = pool.MakeUnique(7, 8);
+  EXPECT_EQ(pool.GetStats().allocated_slots, 1u);
+  point.reset();
+  pool.Trim();
+  EXPECT_EQ(pool.GetStats().allocated_slots, 0u);
+}
+
+TEST(ObjectPoolTest, RefCounted) {
+  ObjectPool<RefCountedObject>& pool = RefCountedObject::GetObjectPool();
+  pool.Trim();
+  int destroyed = 0;
+  scoped_refptr<RefCountedObject> object = pool.MakeRefCounted(&destroyed);
+  scoped_refptr<RefCountedObject> other_ref = object;
+  EXPECT_EQ(pool.GetStats().allocated_slots, 1u);
+
+  object.reset();
+  EXPECT_EQ(destroyed, 0);
+  other_ref.reset();
+  EXPECT_EQ(destroyed, 1);
+
+  // The slot went back to the pool.
+  EXPECT_EQ(pool.GetStats().allocated_slots, 1u);
+  pool.Trim();
+  EXPECT_EQ(pool.GetStats().allocated_slots, 0u);
+}
+
+TEST(ObjectPoolTest, CrossThreadFree) {
+  ObjectPool<Point> pool("Point");
+  constexpr size_t kNumObjects =
+      internal::ObjectPoolBase::kMaxThreadCachedSlots * 4;
+  std::vector<Point*> points;
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    points.push_back(pool.New(0, 0));
+  }
+
+  // The consumer frees more than it can cache, and its cache is handed over
+  // when it exits, so all of the slots end up in the shared cache.
+  Thread consumer("Consumer");
+  ASSERT_TRUE(consumer.Start());
+  consumer.task_runner()->PostTask(
+      FROM_HERE, BindOnce(
+                     [](ObjectPool<Point>* pool, std::vector<Point*> points) {
+                       for (Point* point : points) {
+                         pool->Delete(point);
+                       }
+                     },
+                     Unretained(&pool), std::move(points)));
+  consumer.Stop();
+  EXPECT_EQ(pool.GetStats().allocated_slots, kNumObjects);
+  EXPECT_EQ(pool.GetStats().shared_cached_size, kNumObjects * sizeof(Point));
+
+  // The producer reuses them.
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    points.push_back(pool.New(0, 0));
+  }
+  EXPECT_EQ(pool.GetStats().allocated_slots, kNumObjects);
+  EXPECT_EQ(pool.GetStats().shared_cached_size, 0u);
+
+  for (Point* point : points) {
+    pool.Delete(point);
+  }
+  pool.Trim();
+  EXPECT_EQ(pool.GetStats().allocated_slots, 0u);
+}
+
+TEST(ObjectPoolTest, DeleteDuringThreadLocalStorageDestruction) {
+  ObjectPool<Point> pool("Point");
+  ThreadLocalOwnedPointer<ThreadLocalPoint> thread_local_point;
+
+  Thread thread("Thread");
+  ASSERT_TRUE(thread.Start());
+  thread.task_runner()->PostTask(
+      FROM_HERE,
+      BindOnce(
+          [](ObjectPool<Point>* pool,
+             ThreadLocalOwnedPointer<ThreadLocalPoint>* thread_local_point) {
+            // Also creates the cache of the thread.
+            pool->Delete(pool->New(1, 2));
+            thread_local_point->Set(
+                std::make_unique<ThreadLocalPoint>(pool, pool->New(1, 2)));
+          },
+          Unretained(&pool), Unretained(&thread_local_point)));
+  thread.Stop();
+
+  // The cache of the thread went to the shared cache when it exited, and so
+  // did the slots freed without it.
+  EXPECT_GE(pool.GetStats().allocated_slots, 1u);
+  EXPECT_EQ(pool.GetStats().shared_cached_size,
+            pool.GetStats().allocated_slots * sizeof(Point));
+  pool.Trim();
+  EXPECT_EQ(pool.GetStats().allocated_slots, 0u);
+}
+
+TEST(ObjectPoolTest, SharedCacheLimit) {
+  ObjectPool<Point> pool("Point");
+  constexpr size_t kNumObjects =
+      internal::ObjectPoolBase::kMaxSharedCachedSlots * 2;
+  std::vector<Point*> points;
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    points.push_back(pool.New(0, 0));
+  }
+  for (Point* point : points) {
+    pool.Delete(point);
+  }
+  // The slots beyond the caches are freed.
+  EXPECT_LE(pool.GetStats().allocated_slots,
+            internal::ObjectPoolBase::kMaxThreadCachedSlots +
+                internal::ObjectPoolBase::kMaxSharedCachedSlots);
+  EXPECT_LE(pool.GetStats().shared_cached_size,
+            internal::ObjectPoolBase::kMaxSharedCachedSlots * sizeof(Point));
+  pool.Trim();
+  EXPECT_EQ(pool.GetStats().allocated_slots, 0u);
+}
+
+TEST(ObjectPoolTest, MemoryPressure) {
+  test::TaskEnvironment task_environment;
+  ObjectPool<Point> pool("Point");
+  std::vector<Point*> points;
+  for (size_t i = 0; i < 100; ++i) {
+    points.push_back(pool.New(0, 0));
+  }
+  for (Point* point : points) {
+    pool.Delete(point);
+  }
+  EXPECT_EQ(pool.GetStats().allocated_slots, 100u);
+
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(pool.GetStats().allocated_slots, 0u);
+}
+
+TEST(ObjectPoolTest, GetStatsForAllPools) {
+  ObjectPool<Point> pool1("ObjectPoolTestPool");
+  ObjectPool<Point> pool2("ObjectPoolTestPool");
+  Point* point1 = pool1.New(0, 0);
+  Point* point2 = pool2.New(0, 0);
+
+  std::vector<internal::ObjectPoolBase::Stats> all_stats =
+      internal::ObjectPoolBase::GetStatsForAllPools();
+  auto it = std::ranges::find(all_stats, "ObjectPoolTestPool",
+                              &internal::ObjectPoolBase::Stats::name);
+  ASSERT_NE(it, all_stats.end());
+  EXPECT_EQ(it->allocated_slots, 2u);
+  EXPECT_EQ(it->allocated_size, 2 * sizeof(Point));
+
+  pool1.Delete(point1);
+  pool2.Delete(point2);
+  pool1.Trim();
+  pool2.Trim();
+}
+
+}  // namespace base
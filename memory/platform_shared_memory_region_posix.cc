@@ -7,10 +7,13 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+#include <string>
+
 #include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/threading/thread_restrictions.h"
 #include "build/build_config.h"
 
@@ -268,6 +271,76 @@ PlatformSharedMemoryRegion PlatformSharedMemoryRegion::Create(Mode mode,
 #endif  // !BUILDFLAG(IS_NACL)
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+// static
+PlatformSharedMemoryRegion
+PlatformSharedMemoryRegion::CreateWritableWithHugePages(size_t size) {
+  return CreateWithHugePages(Mode::kWritable, size);
+}
+
+// static
+PlatformSharedMemoryRegion
+PlatformSharedMemoryRegion::CreateUnsafeWithHugePages(size_t size) {
+  return CreateWithHugePages(Mode::kUnsafe, size);
+}
+
+// static
+PlatformSharedMemoryRegion PlatformSharedMemoryRegion::CreateWithHugePages(
+    Mode mode,
+    size_t size) {
+  if (size == 0) {
+    return {};
+  }
+
+  if (size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return {};
+  }
+
+  CHECK_NE(mode, Mode::kReadOnly) << "Creating a region in read-only mode will "
+                                     "lead to this region being non-modifiable";
+
+  ScopedFD fd(memfd_create("base_shared_memory", MFD_CLOEXEC | MFD_HUGETLB));
+  if (!fd.is_valid()) {
+    DPLOG(ERROR) << "memfd_create(MFD_HUGETLB) failed";
+    return {};
+  }
+
+  // hugetlbfs reports the huge page size as the block size.
+  stat_wrapper_t fd_stat;
+  if (File::Fstat(fd.get(), &fd_stat) != 0) {
+    DPLOG(ERROR) << "fstat(fd) failed";
+    return {};
+  }
+  if (fd_stat.st_blksize <= 0 ||
+      size % static_cast<size_t>(fd_stat.st_blksize) != 0) {
+    DLOG(ERROR) << "Size " << size << " isn't a multiple of the huge page size "
+                << fd_stat.st_blksize;
+    return {};
+  }
+
+  // Allocates the huge pages, and sets the size of the file.
+  if (HANDLE_EINTR(fallocate(fd.get(), 0, 0, static_cast<off_t>(size))) != 0) {
+    DPLOG(ERROR) << "fallocate(" << size << ") of huge pages failed";
+    return {};
+  }
+
+  ScopedFD readonly_fd;
+  if (mode == Mode::kWritable) {
+    // memfds have no path; reopen through procfs to get a read-only descriptor
+    // of the same inode, so that we can ConvertToReadOnly().
+    std::string fd_path = "/proc/self/fd/" + NumberToString(fd.get());
+    readonly_fd.reset(HANDLE_EINTR(open(fd_path.c_str(), O_RDONLY)));
+    if (!readonly_fd.is_valid()) {
+      DPLOG(ERROR) << "open(\"" << fd_path << "\", O_RDONLY) failed";
+      return {};
+    }
+  }
+
+  return PlatformSharedMemoryRegion({std::move(fd), std::move(readonly_fd)},
+                                    mode, size, UnguessableToken::Create());
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+
 bool PlatformSharedMemoryRegion::CheckPlatformHandlePermissionsCorrespondToMode(
     PlatformSharedMemoryHandle handle,
     Mode mode,
@@ -238,6 +238,7 @@ TEST_F(PlatformSharedMemoryRegionTest, ConvertToUnsafeInvalidatesSecondHandle) {
 }
 #endif
 
+
 void CheckReadOnlyMapProtection(void* addr) {
 #if BUILDFLAG(IS_APPLE)
   vm_region_basic_info_64 basic_info;
@@ -300,6 +301,41 @@ bool TryToRestoreWritablePermissions(void* addr, size_t len) {
 #endif
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+// Tests that a huge page backed region can be mapped and converted to
+// read-only. Huge pages are frequently not configured, in which case creation
+// must fail cleanly.
+TEST_F(PlatformSharedMemoryRegionTest, CreateWithHugePages) {
+  constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+  PlatformSharedMemoryRegion region =
+      PlatformSharedMemoryRegion::CreateWritableWithHugePages(kHugePageSize);
+  if (!region.IsValid()) {
+    GTEST_SKIP() << "Huge pages aren't available";
+  }
+  EXPECT_EQ(region.GetSize(), kHugePageSize);
+  EXPECT_EQ(region.GetMode(), PlatformSharedMemoryRegion::Mode::kWritable);
+
+  WritableSharedMemoryMapping mapping = MapForTesting(&region);
+  ASSERT_TRUE(mapping.IsValid());
+  mapping.GetMemoryAsSpan<uint8_t>()[0] = 42;
+
+  ASSERT_TRUE(region.ConvertToReadOnly());
+  EXPECT_EQ(region.GetMode(), PlatformSharedMemoryRegion::Mode::kReadOnly);
+  WritableSharedMemoryMapping ro_mapping = MapForTesting(&region);
+  ASSERT_TRUE(ro_mapping.IsValid());
+  CheckReadOnlyMapProtection(ro_mapping.memory());
+  EXPECT_EQ(ro_mapping.GetMemoryAsSpan<uint8_t>()[0], 42);
+}
+
+// Tests that huge page backed regions must be a multiple of the huge page
+// size.
+TEST_F(PlatformSharedMemoryRegionTest, CreateWithHugePagesUnalignedIsInvalid) {
+  PlatformSharedMemoryRegion region =
+      PlatformSharedMemoryRegion::CreateUnsafeWithHugePages(kRegionSize);
+  EXPECT_FALSE(region.IsValid());
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+
 // Tests that protection bits are set correctly for read-only region.
 TEST_F(PlatformSharedMemoryRegionTest, MappingProtectionSetCorrectly) {
   PlatformSharedMemoryRegion region =
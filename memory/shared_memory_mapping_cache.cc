@@ -0,0 +1,117 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/shared_memory_mapping_cache.h"
+
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/unsafe_shared_memory_region.h"
+#include "base/memory/writable_shared_memory_region.h"
+
+namespace base {
+
+SharedMemoryMappingCache::SharedMemoryMappingCache(size_t max_cached_mappings)
+    : max_cached_mappings_(max_cached_mappings),
+      read_only_mappings_(max_cached_mappings),
+      writable_mappings_(max_cached_mappings),
+      memory_pressure_listener_(
+          FROM_HERE,
+          DoNothing(),
+          BindRepeating(&SharedMemoryMappingCache::OnMemoryPressure,
+                        Unretained(this))) {
+  DCHECK_GT(max_cached_mappings, 0u);
+}
+
+SharedMemoryMappingCache::~SharedMemoryMappingCache() = default;
+
+scoped_refptr<RefCountedReadOnlySharedMemoryMapping>
+SharedMemoryMappingCache::Map(const ReadOnlySharedMemoryRegion& region) {
+  return MapImpl(region, read_only_mappings_);
+}
+
+scoped_refptr<RefCountedWritableSharedMemoryMapping>
+SharedMemoryMappingCache::Map(const WritableSharedMemoryRegion& region) {
+  return MapImpl(region, writable_mappings_);
+}
+
+scoped_refptr<RefCountedWritableSharedMemoryMapping>
+SharedMemoryMappingCache::Map(const UnsafeSharedMemoryRegion& region) {
+  return MapImpl(region, writable_mappings_);
+}
+
+void SharedMemoryMappingCache::Clear() {
+  // Unmap outside of the lock.
+  MappingLRUCache<ReadOnlySharedMemoryMapping> read_only_mappings(
+      max_cached_mappings_);
+  MappingLRUCache<WritableSharedMemoryMapping> writable_mappings(
+      max_cached_mappings_);
+  AutoLock lock(lock_);
+  read_only_mappings_.Swap(read_only_mappings);
+  writable_mappings_.Swap(writable_mappings);
+}
+
+size_t SharedMemoryMappingCache::size() const {
+  AutoLock lock(lock_);
+  return read_only_mappings_.size() + writable_mappings_.size();
+}
+
+template <typename RegionType>
+scoped_refptr<RefCountedSharedMemoryMapping<typename RegionType::MappingType>>
+SharedMemoryMappingCache::MapImpl(
+    const RegionType& region,
+    MappingLRUCache<typename RegionType::MappingType>& cache) {
+  using RefCountedMapping =
+      RefCountedSharedMemoryMapping<typename RegionType::MappingType>;
+
+  if (!region.IsValid()) {
+    return nullptr;
+  }
+
+  const UnguessableToken& guid = region.GetGUID();
+  {
+    AutoLock lock(lock_);
+    auto it = cache.Get(guid);
+    if (it != cache.end() &&
+        it->second->mapping().size() == region.GetSize()) {
+      return it->second;
+    }
+  }
+
+  // Map outside of the lock; if another thread raced to map the same region,
+  // the later mapping replaces the earlier one in the cache, which stays valid
+  // for its users.
+  typename RegionType::MappingType mapping = region.Map();
+  if (!mapping.IsValid()) {
+    return nullptr;
+  }
+  auto result = MakeRefCounted<RefCountedMapping>(std::move(mapping));
+
+  scoped_refptr<RefCountedMapping> evicted;
+  {
+    AutoLock lock(lock_);
+    auto it = cache.Peek(guid);
+    if (it != cache.end()) {
+      evicted = std::move(it->second);
+      cache.Erase(it);
+    }
+    if (cache.size() == max_cached_mappings_) {
+      // Unmap the least recently used mapping outside of the lock.
+      auto oldest = cache.rbegin();
+      evicted = std::move(oldest->second);
+      cache.Erase(oldest);
+    }
+    cache.Put(guid, result);
+  }
+  return result;
+}
+
+void SharedMemoryMappingCache::OnMemoryPressure(
+    MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL) {
+    Clear();
+  }
+}
+
+}  // namespace base
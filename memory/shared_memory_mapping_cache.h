@@ -0,0 +1,124 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MEMORY_SHARED_MEMORY_MAPPING_CACHE_H_
+#define BASE_MEMORY_SHARED_MEMORY_MAPPING_CACHE_H_
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "base/base_export.h"
+#include "base/containers/lru_cache.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/shared_memory_mapping.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/unguessable_token.h"
+
+namespace base {
+
+class ReadOnlySharedMemoryRegion;
+class UnsafeSharedMemoryRegion;
+class WritableSharedMemoryRegion;
+
+// A ref-counted, immutable holder of a whole-region shared memory mapping. The
+// mapping is unmapped when the last reference goes away.
+template <typename MappingType>
+class RefCountedSharedMemoryMapping
+    : public RefCountedThreadSafe<RefCountedSharedMemoryMapping<MappingType>> {
+ public:
+  explicit RefCountedSharedMemoryMapping(MappingType mapping)
+      : mapping_(std::move(mapping)) {}
+
+  RefCountedSharedMemoryMapping(const RefCountedSharedMemoryMapping&) = delete;
+  RefCountedSharedMemoryMapping& operator=(
+      const RefCountedSharedMemoryMapping&) = delete;
+
+  const MappingType& mapping() const { return mapping_; }
+
+ private:
+  friend class RefCountedThreadSafe<RefCountedSharedMemoryMapping>;
+  ~RefCountedSharedMemoryMapping() = default;
+
+  const MappingType mapping_;
+};
+
+using RefCountedReadOnlySharedMemoryMapping =
+    RefCountedSharedMemoryMapping<ReadOnlySharedMemoryMapping>;
+using RefCountedWritableSharedMemoryMapping =
+    RefCountedSharedMemoryMapping<WritableSharedMemoryMapping>;
+
+// SharedMemoryMappingCache keeps the mappings of recently mapped shared memory
+// regions alive, keyed by the region GUID, so that mapping the same region over
+// and over (e.g. per-frame buffers) doesn't create and destroy a VMA each time.
+// Mappings are handed out as ref-counted handles, so that the same mapping is
+// shared by all its users. It is thread-safe.
+//
+// Up to |max_cached_mappings| mappings of each access kind are kept alive by
+// the cache itself, in LRU order; an evicted mapping stays valid for as long
+// as handles to it exist. Only whole-region mappings made with the default
+// SharedMemoryMapper are cached. The cache is cleared on critical memory
+// pressure.
+//
+// The cache relies on the GUID uniquely identifying the kernel region, which
+// holds for regions created through base. Since a WritableSharedMemoryRegion
+// keeps its GUID when converted to a ReadOnlySharedMemoryRegion, read-only and
+// writable mappings are cached separately.
+class BASE_EXPORT SharedMemoryMappingCache {
+ public:
+  static constexpr size_t kDefaultMaxCachedMappings = 16;
+
+  explicit SharedMemoryMappingCache(
+      size_t max_cached_mappings = kDefaultMaxCachedMappings);
+  SharedMemoryMappingCache(const SharedMemoryMappingCache&) = delete;
+  SharedMemoryMappingCache& operator=(const SharedMemoryMappingCache&) = delete;
+  ~SharedMemoryMappingCache();
+
+  // Returns a handle to a mapping of the whole |region|, reusing a cached
+  // mapping of the region if there is one. Returns null if |region| is invalid
+  // or can't be mapped.
+  scoped_refptr<RefCountedReadOnlySharedMemoryMapping> Map(
+      const ReadOnlySharedMemoryRegion& region);
+  scoped_refptr<RefCountedWritableSharedMemoryMapping> Map(
+      const WritableSharedMemoryRegion& region);
+  scoped_refptr<RefCountedWritableSharedMemoryMapping> Map(
+      const UnsafeSharedMemoryRegion& region);
+
+  // Drops the cache's own references to all mappings.
+  void Clear();
+
+  // Returns the number of mappings kept alive by the cache.
+  size_t size() const;
+
+ private:
+  template <typename MappingType>
+  using MappingLRUCache =
+      LRUCache<UnguessableToken,
+               scoped_refptr<RefCountedSharedMemoryMapping<MappingType>>>;
+
+  template <typename RegionType>
+  scoped_refptr<RefCountedSharedMemoryMapping<typename RegionType::MappingType>>
+  MapImpl(const RegionType& region,
+          MappingLRUCache<typename RegionType::MappingType>& cache);
+
+  void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level);
+
+  const size_t max_cached_mappings_;
+
+  mutable Lock lock_;
+  MappingLRUCache<ReadOnlySharedMemoryMapping> read_only_mappings_
+      GUARDED_BY(lock_);
+  MappingLRUCache<WritableSharedMemoryMapping> writable_mappings_
+      GUARDED_BY(lock_);
+
+  // Notified synchronously, so that the cache can be used on any thread. It is
+  // the last member, so that it stops before the rest is destroyed.
+  MemoryPressureListener memory_pressure_listener_;
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_SHARED_MEMORY_MAPPING_CACHE_H_
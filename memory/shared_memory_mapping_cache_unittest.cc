@@ -0,0 +1,117 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/shared_memory_mapping_cache.h"
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/unsafe_shared_memory_region.h"
+#include "base/memory/writable_shared_memory_region.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+constexpr size_t kRegionSize = 4096;
+}  // namespace
+
+TEST(SharedMemoryMappingCacheTest, InvalidRegion) {
+  SharedMemoryMappingCache cache;
+  EXPECT_FALSE(cache.Map(ReadOnlySharedMemoryRegion()));
+  EXPECT_FALSE(cache.Map(UnsafeSharedMemoryRegion()));
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(SharedMemoryMappingCacheTest, ReusesMapping) {
+  SharedMemoryMappingCache cache;
+  UnsafeSharedMemoryRegion region =
+      UnsafeSharedMemoryRegion::Create(kRegionSize);
+  ASSERT_TRUE(region.IsValid());
+
+  scoped_refptr<RefCountedWritableSharedMemoryMapping> mapping =
+      cache.Map(region);
+  ASSERT_TRUE(mapping);
+  ASSERT_TRUE(mapping->mapping().IsValid());
+  EXPECT_EQ(mapping->mapping().size(), kRegionSize);
+  const void* memory = mapping->mapping().memory();
+
+  // The cache keeps the mapping alive once the handle is released.
+  mapping.reset();
+  mapping = cache.Map(region);
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(mapping->mapping().memory(), memory);
+  EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(SharedMemoryMappingCacheTest, ReusesMappingOfDuplicatedRegion) {
+  SharedMemoryMappingCache cache;
+  UnsafeSharedMemoryRegion region =
+      UnsafeSharedMemoryRegion::Create(kRegionSize);
+  UnsafeSharedMemoryRegion duplicate = region.Duplicate();
+  ASSERT_TRUE(duplicate.IsValid());
+
+  auto mapping = cache.Map(region);
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(cache.Map(duplicate), mapping);
+}
+
+TEST(SharedMemoryMappingCacheTest, SeparatesReadOnlyAndWritableMappings) {
+  SharedMemoryMappingCache cache;
+  WritableSharedMemoryRegion region =
+      WritableSharedMemoryRegion::Create(kRegionSize);
+  auto writable_mapping = cache.Map(region);
+  ASSERT_TRUE(writable_mapping);
+  writable_mapping->mapping().GetMemoryAsSpan<uint8_t>()[0] = 42;
+
+  ReadOnlySharedMemoryRegion read_only_region =
+      WritableSharedMemoryRegion::ConvertToReadOnly(std::move(region));
+  auto read_only_mapping = cache.Map(read_only_region);
+  ASSERT_TRUE(read_only_mapping);
+  EXPECT_NE(read_only_mapping->mapping().memory(),
+            writable_mapping->mapping().memory());
+  EXPECT_EQ(read_only_mapping->mapping().GetMemoryAsSpan<uint8_t>()[0], 42);
+  EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST(SharedMemoryMappingCacheTest, EvictsLeastRecentlyUsed) {
+  SharedMemoryMappingCache cache(2);
+  UnsafeSharedMemoryRegion region1 =
+      UnsafeSharedMemoryRegion::Create(kRegionSize);
+  UnsafeSharedMemoryRegion region2 =
+      UnsafeSharedMemoryRegion::Create(kRegionSize);
+  UnsafeSharedMemoryRegion region3 =
+      UnsafeSharedMemoryRegion::Create(kRegionSize);
+
+  auto mapping1 = cache.Map(region1);
+  auto mapping2 = cache.Map(region2);
+  // Makes region2 the least recently used.
+  EXPECT_EQ(cache.Map(region1), mapping1);
+  auto mapping3 = cache.Map(region3);
+  EXPECT_EQ(cache.size(), 2u);
+
+  // The evicted mapping stays valid for its users, but is no longer shared.
+  ASSERT_TRUE(mapping2->mapping().IsValid());
+  mapping2->mapping().GetMemoryAsSpan<uint8_t>()[0] = 1;
+  EXPECT_NE(cache.Map(region2), mapping2);
+  EXPECT_EQ(cache.Map(region3), mapping3);
+}
+
+TEST(SharedMemoryMappingCacheTest, ClearsOnCriticalMemoryPressure) {
+  SharedMemoryMappingCache cache;
+  UnsafeSharedMemoryRegion region =
+      UnsafeSharedMemoryRegion::Create(kRegionSize);
+  auto mapping = cache.Map(region);
+  ASSERT_TRUE(mapping);
+
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_EQ(cache.size(), 1u);
+
+  MemoryPressureListener::SimulatePressureNotification(
+      MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_TRUE(mapping->mapping().IsValid());
+}
+
+}  // namespace base
@@ -4,6 +4,13 @@
 
 #include "base/memory/unsafe_shared_memory_pool.h"
 
+#include <bit>
+#include <iterator>
+
+#include "base/bits.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/location.h"
 #include "base/logging.h"
 
 namespace {
@@ -12,7 +19,12 @@ constexpr size_t kMaxStoredBuffers = 32;
 
 namespace base {
 
-UnsafeSharedMemoryPool::UnsafeSharedMemoryPool() = default;
+UnsafeSharedMemoryPool::UnsafeSharedMemoryPool()
+    : memory_pressure_listener_(
+          FROM_HERE,
+          DoNothing(),
+          BindRepeating(&UnsafeSharedMemoryPool::OnMemoryPressure,
+                        Unretained(this))) {}
 
 UnsafeSharedMemoryPool::~UnsafeSharedMemoryPool() = default;
 
@@ -45,29 +57,26 @@ const WritableSharedMemoryMapping& UnsafeSharedMemoryPool::Handle::GetMapping()
 
 std::unique_ptr<UnsafeSharedMemoryPool::Handle>
 UnsafeSharedMemoryPool::MaybeAllocateBuffer(size_t region_size) {
-  AutoLock lock(lock_);
-
-  DCHECK_GE(region_size, 0u);
-  if (is_shutdown_)
-    return nullptr;
-
-  // Only change the configured size if bigger region is requested to avoid
-  // unncecessary reallocations.
-  if (region_size > region_size_) {
-    regions_.clear();
-    region_size_ = region_size;
-  }
-  if (!regions_.empty()) {
-    auto region = std::move(regions_.back());
-    regions_.pop_back();
-    DCHECK_GE(region.first.GetSize(), region_size_);
-    auto handle = std::make_unique<Handle>(PassKey<UnsafeSharedMemoryPool>(),
-                                           std::move(region.first),
-                                           std::move(region.second), this);
-    return handle;
+  const std::optional<size_t> size_class = GetSizeClass(region_size);
+  {
+    AutoLock lock(lock_);
+    if (is_shutdown_)
+      return nullptr;
+
+    if (size_class && !regions_[*size_class].empty()) {
+      CachedRegion region = std::move(regions_[*size_class].back());
+      regions_[*size_class].pop_back();
+      DCHECK_GE(region.first.GetSize(), region_size);
+      return std::make_unique<Handle>(PassKey<UnsafeSharedMemoryPool>(),
+                                      std::move(region.first),
+                                      std::move(region.second), this);
+    }
   }
 
-  auto region = UnsafeSharedMemoryRegion::Create(region_size_);
+  // Creating and mapping a region are system calls, so they are done without
+  // holding the lock.
+  auto region = UnsafeSharedMemoryRegion::Create(
+      size_class ? kMinRegionSize << *size_class : region_size);
   if (!region.IsValid())
     return nullptr;
 
@@ -80,28 +89,74 @@ UnsafeSharedMemoryPool::MaybeAllocateBuffer(size_t region_size) {
 }
 
 void UnsafeSharedMemoryPool::Shutdown() {
-  AutoLock lock(lock_);
-  DCHECK(!is_shutdown_);
-  is_shutdown_ = true;
-  regions_.clear();
+  std::array<std::vector<CachedRegion>, kNumSizeClasses> regions;
+  {
+    AutoLock lock(lock_);
+    DCHECK(!is_shutdown_);
+    is_shutdown_ = true;
+    std::swap(regions, regions_);
+  }
+  // `regions` are unmapped and closed without holding the lock.
+}
+
+// static
+std::optional<size_t> UnsafeSharedMemoryPool::GetSizeClass(size_t size) {
+  static_assert(std::has_single_bit(kMinRegionSize) &&
+                kMinRegionSize << (kNumSizeClasses - 1) ==
+                    kMaxPooledRegionSize);
+  if (size > kMaxPooledRegionSize)
+    return std::nullopt;
+  if (size <= kMinRegionSize)
+    return 0u;
+  return static_cast<size_t>(
+      bits::Log2Ceiling(static_cast<uint32_t>(size)) -
+      bits::Log2Floor(static_cast<uint32_t>(kMinRegionSize)));
 }
 
 void UnsafeSharedMemoryPool::ReleaseBuffer(
     UnsafeSharedMemoryRegion region,
     WritableSharedMemoryMapping mapping) {
-  AutoLock lock(lock_);
-  // Only return regions which are at least as big as the current configuration.
-  if (is_shutdown_ || regions_.size() >= kMaxStoredBuffers ||
-      !region.IsValid() || region.GetSize() < region_size_) {
+  // Only pool regions of exactly the size of their class.
+  const size_t region_size = region.IsValid() ? region.GetSize() : 0u;
+  const std::optional<size_t> size_class = GetSizeClass(region_size);
+  const bool is_class_size =
+      size_class && region_size == kMinRegionSize << *size_class;
+  {
+    AutoLock lock(lock_);
+    if (!is_shutdown_ && is_class_size &&
+        regions_[*size_class].size() < kMaxStoredBuffers) {
+      regions_[*size_class].emplace_back(std::move(region),
+                                         std::move(mapping));
+      return;
+    }
     DLOG(WARNING) << "Not returning SharedMemoryRegion to the pool:"
                   << " is_shutdown: " << (is_shutdown_ ? "true" : "false")
-                  << " stored regions: " << regions_.size()
-                  << " configured size: " << region_size_
-                  << " this region size: " << region.GetSize()
+                  << " stored regions: "
+                  << (is_class_size ? regions_[*size_class].size() : 0u)
+                  << " this region size: " << region_size
                   << " valid: " << (region.IsValid() ? "true" : "false");
-    return;
   }
-  regions_.emplace_back(std::move(region), std::move(mapping));
+  // `region` and `mapping` are freed without holding the lock.
+}
+
+void UnsafeSharedMemoryPool::OnMemoryPressure(
+    MemoryPressureListener::MemoryPressureLevel level) {
+  std::vector<CachedRegion> freed_regions;
+  {
+    AutoLock lock(lock_);
+    for (std::vector<CachedRegion>& regions : regions_) {
+      // Keep half of the regions on moderate pressure, rounding down.
+      const size_t kept =
+          level == MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL
+              ? 0u
+              : regions.size() / 2;
+      freed_regions.insert(freed_regions.end(),
+                           std::make_move_iterator(regions.begin() + kept),
+                           std::make_move_iterator(regions.end()));
+      regions.erase(regions.begin() + kept, regions.end());
+    }
+  }
+  // `freed_regions` are unmapped and closed without holding the lock.
 }
 
 }  // namespace base
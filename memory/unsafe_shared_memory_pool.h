@@ -5,11 +5,16 @@
 #ifndef BASE_MEMORY_UNSAFE_SHARED_MEMORY_POOL_H_
 #define BASE_MEMORY_UNSAFE_SHARED_MEMORY_POOL_H_
 
+#include <stddef.h>
+
+#include <array>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "base/base_export.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/unsafe_shared_memory_region.h"
 #include "base/synchronization/lock.h"
@@ -19,10 +24,13 @@ namespace base {
 
 // UnsafeSharedMemoryPool manages allocation and pooling of
 // UnsafeSharedMemoryRegions. Using pool saves cost of repeated shared memory
-// allocations. Up-to 32 regions would be pooled. It is thread-safe. May return
-// bigger regions than requested. If a requested size is increased, all stored
-// regions are purged. Regions are returned to the buffer on destruction of
-// |SharedMemoryHandle| if they are of a correct size.
+// allocations. It is thread-safe. Sizes are rounded up to a power of two of at
+// least kMinRegionSize, and regions of each such size class are pooled
+// separately, up-to 32 per class, so that varying sizes reuse regions too.
+// Regions are returned to the pool on destruction of |Handle|. Sizes above
+// kMaxPooledRegionSize are allocated exactly and never pooled. Pooled regions
+// are freed on memory pressure: half of them on moderate pressure, and all of
+// them on critical pressure.
 class BASE_EXPORT UnsafeSharedMemoryPool
     : public RefCountedThreadSafe<UnsafeSharedMemoryPool> {
  public:
@@ -50,6 +58,10 @@ class BASE_EXPORT UnsafeSharedMemoryPool
     scoped_refptr<UnsafeSharedMemoryPool> pool_;
   };
 
+  // The smallest and the largest size class.
+  static constexpr size_t kMinRegionSize = 4096;
+  static constexpr size_t kMaxPooledRegionSize = 1024 * 1024 * 1024;
+
   UnsafeSharedMemoryPool();
   // Disallow copy and assign.
   UnsafeSharedMemoryPool(const UnsafeSharedMemoryPool&) = delete;
@@ -67,17 +79,31 @@ class BASE_EXPORT UnsafeSharedMemoryPool
   friend class RefCountedThreadSafe<UnsafeSharedMemoryPool>;
   ~UnsafeSharedMemoryPool();
 
+  using CachedRegion =
+      std::pair<UnsafeSharedMemoryRegion, WritableSharedMemoryMapping>;
+
+  static constexpr size_t kNumSizeClasses = 19;
+
+  // Returns the size class of regions of `size` bytes, or nullopt if they are
+  // too big to be pooled.
+  static std::optional<size_t> GetSizeClass(size_t size);
+
   void ReleaseBuffer(UnsafeSharedMemoryRegion region,
                      WritableSharedMemoryMapping mapping);
 
+  // Frees pooled regions, as appropriate for `level`.
+  void OnMemoryPressure(MemoryPressureListener::MemoryPressureLevel level);
+
   Lock lock_;
-  // All shared memory regions cached internally are guaranteed to be
-  // at least `region_size_` bytes in size.
-  size_t region_size_ GUARDED_BY(lock_) = 0u;
-  // Cached unused regions and their mappings.
-  std::vector<std::pair<UnsafeSharedMemoryRegion, WritableSharedMemoryMapping>>
-      regions_ GUARDED_BY(lock_);
+  // Cached unused regions and their mappings, by size class. The regions of
+  // class `i` are `kMinRegionSize << i` bytes in size.
+  std::array<std::vector<CachedRegion>, kNumSizeClasses> regions_
+      GUARDED_BY(lock_);
   bool is_shutdown_ GUARDED_BY(lock_) = false;
+
+  // Notified synchronously, so that the pool can be used on any thread. It is
+  // the last member, so that it stops before the rest is destroyed.
+  MemoryPressureListener memory_pressure_listener_;
 };
 
 }  // namespace base
@@ -4,6 +4,12 @@
 
 #include "base/memory/unsafe_shared_memory_pool.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/unguessable_token.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
@@ -47,4 +53,71 @@ TEST(UnsafeSharedMemoryPoolTest, RespectsSize) {
   ASSERT_TRUE(handle);
   EXPECT_GE(handle->GetRegion().GetSize(), 1100u);
 }
+
+TEST(UnsafeSharedMemoryPoolTest, ReusesRegionsOfSizeClass) {
+  scoped_refptr<UnsafeSharedMemoryPool> pool(
+      base::MakeRefCounted<UnsafeSharedMemoryPool>());
+  auto handle = pool->MaybeAllocateBuffer(5000u);
+  ASSERT_TRUE(handle);
+  EXPECT_EQ(8192u, handle->GetRegion().GetSize());
+  auto id1 = handle->GetRegion().GetGUID();
+  handle.reset();
+
+  // A different size of the same class reuses the region.
+  handle = pool->MaybeAllocateBuffer(8000u);
+  ASSERT_TRUE(handle);
+  EXPECT_EQ(id1, handle->GetRegion().GetGUID());
+}
+
+TEST(UnsafeSharedMemoryPoolTest, KeepsSizeClassesApart) {
+  scoped_refptr<UnsafeSharedMemoryPool> pool(
+      base::MakeRefCounted<UnsafeSharedMemoryPool>());
+  auto small_handle = pool->MaybeAllocateBuffer(1000u);
+  auto large_handle = pool->MaybeAllocateBuffer(100000u);
+  ASSERT_TRUE(small_handle);
+  ASSERT_TRUE(large_handle);
+  auto small_id = small_handle->GetRegion().GetGUID();
+  auto large_id = large_handle->GetRegion().GetGUID();
+  small_handle.reset();
+  large_handle.reset();
+
+  // Allocating a size doesn't discard the regions of other sizes.
+  large_handle = pool->MaybeAllocateBuffer(100000u);
+  small_handle = pool->MaybeAllocateBuffer(1000u);
+  ASSERT_TRUE(small_handle);
+  ASSERT_TRUE(large_handle);
+  EXPECT_EQ(small_id, small_handle->GetRegion().GetGUID());
+  EXPECT_EQ(large_id, large_handle->GetRegion().GetGUID());
+}
+
+TEST(UnsafeSharedMemoryPoolTest, FreesRegionsOnMemoryPressure) {
+  scoped_refptr<UnsafeSharedMemoryPool> pool(
+      base::MakeRefCounted<UnsafeSharedMemoryPool>());
+  // Pools 4 regions, and returns how many of them the next 4 allocations
+  // reuse, after `level` of memory pressure.
+  auto count_reused_after =
+      [&](MemoryPressureListener::MemoryPressureLevel level) {
+        std::vector<std::unique_ptr<UnsafeSharedMemoryPool::Handle>> handles;
+        std::vector<UnguessableToken> ids;
+        for (int i = 0; i < 4; ++i) {
+          handles.push_back(pool->MaybeAllocateBuffer(1000u));
+          ids.push_back(handles.back()->GetRegion().GetGUID());
+        }
+        handles.clear();
+        MemoryPressureListener::SimulatePressureNotification(level);
+        size_t reused = 0;
+        for (int i = 0; i < 4; ++i) {
+          handles.push_back(pool->MaybeAllocateBuffer(1000u));
+          reused += std::count(ids.begin(), ids.end(),
+                               handles.back()->GetRegion().GetGUID());
+        }
+        return reused;
+      };
+
+  EXPECT_EQ(2u, count_reused_after(
+                    MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE));
+  EXPECT_EQ(0u, count_reused_after(
+                    MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL));
+}
+
 }  // namespace base
@@ -4,6 +4,12 @@
 
 #include "base/memory/weak_ptr.h"
 
+#if BUILDFLAG(USE_BIASED_WEAK_PTR_FLAGS)
+#include "base/check_op.h"
+#include "base/memory/object_pool.h"
+#include "base/no_destructor.h"
+#endif
+
 #if DCHECK_IS_ON()
 #include <ostream>
 
@@ -12,6 +18,19 @@
 
 namespace base::internal {
 
+#if BUILDFLAG(USE_BIASED_WEAK_PTR_FLAGS)
+namespace {
+
+ObjectPoolBase& GetFlagPool() {
+  static NoDestructor<ObjectPoolBase> pool("weak_reference_flags",
+                                           sizeof(WeakReference::Flag),
+                                           alignof(WeakReference::Flag));
+  return *pool;
+}
+
+}  // namespace
+#endif
+
 WeakReference::Flag::Flag() {
   // Flags only become bound when checked for validity, or invalidated,
   // so that we can check that later validity/invalidation operations on
@@ -56,6 +75,19 @@ void WeakReference::Flag::BindToCurrentSequence() {
 
 WeakReference::Flag::~Flag() = default;
 
+#if BUILDFLAG(USE_BIASED_WEAK_PTR_FLAGS)
+// static
+void* WeakReference::Flag::operator new(size_t size) {
+  DCHECK_EQ(size, sizeof(Flag));
+  return GetFlagPool().Allocate();
+}
+
+// static
+void WeakReference::Flag::operator delete(void* flag) {
+  GetFlagPool().Free(flag);
+}
+#endif
+
 WeakReference::WeakReference() = default;
 WeakReference::WeakReference(const scoped_refptr<Flag>& flag) : flag_(flag) {}
 WeakReference::~WeakReference() = default;
@@ -79,6 +79,8 @@
 #include "base/check.h"
 #include "base/compiler_specific.h"
 #include "base/dcheck_is_on.h"
+#include "base/memory/biased_ref_counted.h"
+#include "base/memory/memory_buildflags.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/safe_ref_traits.h"
@@ -109,10 +111,24 @@ class BASE_EXPORT TRIVIAL_ABI WeakReference {
  public:
   // Although Flag is bound to a specific SequencedTaskRunner, it may be
   // deleted from another via base::WeakPtr::~WeakPtr().
+  //
+  // WeakPtrs are mostly copied and destroyed on the thread which created their
+  // factory, e.g. when binding weak receivers to tasks. With
+  // use_biased_weak_ptr_flags, Flag's ref count is biased towards that thread,
+  // to avoid the atomic operations there, and the memory of Flags is recycled.
+#if BUILDFLAG(USE_BIASED_WEAK_PTR_FLAGS)
+  class BASE_EXPORT Flag : public BiasedRefCounted<Flag> {
+#else
   class BASE_EXPORT Flag : public RefCountedThreadSafe<Flag> {
+#endif
    public:
     Flag();
 
+#if BUILDFLAG(USE_BIASED_WEAK_PTR_FLAGS)
+    static void* operator new(size_t size);
+    static void operator delete(void* flag);
+#endif
+
     void Invalidate();
     bool IsValid() const;
 
@@ -124,7 +140,11 @@ class BASE_EXPORT TRIVIAL_ABI WeakReference {
 #endif
 
    private:
+#if BUILDFLAG(USE_BIASED_WEAK_PTR_FLAGS)
+    friend class base::BiasedRefCounted<Flag>;
+#else
     friend class base::RefCountedThreadSafe<Flag>;
+#endif
 
     ~Flag();
 
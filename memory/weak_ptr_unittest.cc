@@ -544,6 +544,30 @@ TEST(WeakPtrTest, MaybeValidOnOtherSequence) {
   // run.
 }
 
+TEST(WeakPtrTest, LastReferenceReleasedAfterCreatingThreadExited) {
+  // The flag is created on another thread, which exits before this thread
+  // releases the last references. With use_biased_weak_ptr_flags, the creating
+  // thread counts its references to the flag without atomic operations.
+  WeakPtr<int> ptr;
+  {
+    Thread creator_thread("creator_thread");
+    ASSERT_TRUE(creator_thread.Start());
+    creator_thread.task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(
+                       [](WeakPtr<int>* ptr) {
+                         int data;
+                         WeakPtrFactory<int> factory(&data);
+                         *ptr = factory.GetWeakPtr();
+                       },
+                       &ptr));
+  }
+  EXPECT_FALSE(ptr.MaybeValid());
+  WeakPtr<int> copy = ptr;
+  ptr.reset();
+  EXPECT_FALSE(copy.MaybeValid());
+  copy.reset();
+}
+
 TEST(WeakPtrTest, HasWeakPtrs) {
   int data;
   WeakPtrFactory<int> factory(&data);
@@ -0,0 +1,203 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/io_uring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/posix/eintr_wrapper.h"
+
+// Older system headers don't define these. The numbers are the same on all
+// architectures.
+#if !defined(__NR_io_uring_setup)
+#define __NR_io_uring_setup 425
+#endif
+#if !defined(__NR_io_uring_enter)
+#define __NR_io_uring_enter 426
+#endif
+#if !defined(__NR_io_uring_register)
+#define __NR_io_uring_register 427
+#endif
+
+namespace base {
+
+namespace {
+
+uint32_t LoadAcquire(uint32_t* p) {
+  return std::atomic_ref<uint32_t>(*p).load(std::memory_order_acquire);
+}
+
+void StoreRelease(uint32_t* p, uint32_t value) {
+  std::atomic_ref<uint32_t>(*p).store(value, std::memory_order_release);
+}
+
+template <typename T>
+T* RingPointer(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<IOUring> IOUring::Create(uint32_t num_entries) {
+  io_uring_params params = {};
+  ScopedFD ring_fd(static_cast<int>(
+      syscall(__NR_io_uring_setup, num_entries, &params)));
+  if (!ring_fd.is_valid()) {
+    DPLOG_IF(ERROR, errno != ENOSYS && errno != EPERM) << "io_uring_setup";
+    return nullptr;
+  }
+  // IORING_FEAT_FAST_POLL comes with Linux 5.7, which is also the first
+  // version to support all the operations used by MessagePumpEpoll.
+  if (!(params.features & IORING_FEAT_FAST_POLL)) {
+    return nullptr;
+  }
+  auto io_uring = base::WrapUnique(new IOUring(std::move(ring_fd)));
+  if (!io_uring->MapRings(params)) {
+    return nullptr;
+  }
+  return io_uring;
+}
+
+IOUring::IOUring(ScopedFD ring_fd)
+    : ring_fd_(std::move(ring_fd)) {}
+
+IOUring::~IOUring() {
+  if (sqes_) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+}
+
+bool IOUring::MapRings(const io_uring_params& params) {
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+
+  void* sq_ring = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd_.get(),
+                       IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    DPLOG(ERROR) << "mmap";
+    return false;
+  }
+  sq_ring_ = sq_ring;
+
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    void* cq_ring = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring_fd_.get(),
+                         IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED) {
+      DPLOG(ERROR) << "mmap";
+      return false;
+    }
+    cq_ring_ = cq_ring;
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes =
+      mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ring_fd_.get(), IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    DPLOG(ERROR) << "mmap";
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  sq_head_ = RingPointer<uint32_t>(sq_ring_, params.sq_off.head);
+  sq_tail_ = RingPointer<uint32_t>(sq_ring_, params.sq_off.tail);
+  sq_mask_ = *RingPointer<uint32_t>(sq_ring_, params.sq_off.ring_mask);
+  sq_entries_ = *RingPointer<uint32_t>(sq_ring_, params.sq_off.ring_entries);
+  cq_head_ = RingPointer<uint32_t>(cq_ring_, params.cq_off.head);
+  cq_tail_ = RingPointer<uint32_t>(cq_ring_, params.cq_off.tail);
+  cq_mask_ = *RingPointer<uint32_t>(cq_ring_, params.cq_off.ring_mask);
+  cqes_ = RingPointer<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+
+  // Submission queue entries are always used in order, so the indirection
+  // array is the identity.
+  uint32_t* sq_array = RingPointer<uint32_t>(sq_ring_, params.sq_off.array);
+  for (uint32_t i = 0; i < sq_entries_; ++i) {
+    sq_array[i] = i;
+  }
+  sqe_tail_ = submitted_tail_ = *sq_tail_;
+  return true;
+}
+
+io_uring_sqe* IOUring::GetSqe() {
+  if (sqe_tail_ - LoadAcquire(sq_head_) >= sq_entries_) {
+    return nullptr;
+  }
+  io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+  ++sqe_tail_;
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+int IOUring::Submit(uint32_t min_complete) {
+  const uint32_t to_submit = sqe_tail_ - submitted_tail_;
+  if (to_submit == 0 && min_complete == 0) {
+    return 0;
+  }
+  StoreRelease(sq_tail_, sqe_tail_);
+  const long rv = HANDLE_EINTR(
+      syscall(__NR_io_uring_enter, ring_fd_.get(), to_submit, min_complete,
+              min_complete ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0));
+  if (rv < 0) {
+    return -errno;
+  }
+  submitted_tail_ += static_cast<uint32_t>(rv);
+  return static_cast<int>(rv);
+}
+
+size_t IOUring::ReapCompletions(
+    FunctionRef<void(const io_uring_cqe&)> on_completion) {
+  size_t num_completions = 0;
+  uint32_t head = *cq_head_;
+  // Completions can be posted while they're reaped, so reload the tail until
+  // none is left.
+  for (uint32_t tail = LoadAcquire(cq_tail_); head != tail;
+       tail = LoadAcquire(cq_tail_)) {
+    for (; head != tail; ++head) {
+      // Copy the entry so that the slot can be released before running
+      // `on_completion`, which may submit more entries.
+      const io_uring_cqe cqe = cqes_[head & cq_mask_];
+      StoreRelease(cq_head_, head + 1);
+      on_completion(cqe);
+      ++num_completions;
+    }
+  }
+  return num_completions;
+}
+
+bool IOUring::RegisterEventFd(int event_fd) {
+  const long rv = syscall(__NR_io_uring_register, ring_fd_.get(),
+                          IORING_REGISTER_EVENTFD, &event_fd, 1);
+  DPLOG_IF(ERROR, rv < 0) << "io_uring_register";
+  return rv == 0;
+}
+
+}  // namespace base
@@ -0,0 +1,91 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MESSAGE_LOOP_IO_URING_H_
+#define BASE_MESSAGE_LOOP_IO_URING_H_
+
+#include <linux/io_uring.h>
+#include <stddef.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "base/base_export.h"
+#include "base/files/scoped_file.h"
+#include "base/functional/function_ref.h"
+#include "base/memory/raw_ptr_exclusion.h"
+
+namespace base {
+
+// A minimal wrapper around an io_uring instance, used by MessagePumpEpoll to
+// submit completion-based I/O. Submission queue entries are only handed to the
+// kernel by Submit(), so that all the operations started between two calls to
+// Submit() are submitted by a single system call. Not thread-safe.
+class BASE_EXPORT IOUring {
+ public:
+  // Returns null if the kernel doesn't support io_uring or is older than 5.7,
+  // or if its use is disallowed, e.g. by a seccomp policy or by the
+  // io_uring_disabled sysctl.
+  static std::unique_ptr<IOUring> Create(uint32_t num_entries);
+
+  IOUring(const IOUring&) = delete;
+  IOUring& operator=(const IOUring&) = delete;
+  ~IOUring();
+
+  // Returns a zeroed submission queue entry to fill, or null if the
+  // submission queue is full, in which case Submit() must be called first.
+  io_uring_sqe* GetSqe();
+
+  // Submits all the entries returned by GetSqe() since the last call. If
+  // `min_complete` is non-zero, blocks until that many completions are
+  // available. Returns the number of entries submitted, or -errno.
+  int Submit(uint32_t min_complete = 0);
+
+  // Runs `on_completion` for each available completion queue entry, and
+  // returns their number.
+  size_t ReapCompletions(FunctionRef<void(const io_uring_cqe&)> on_completion);
+
+  // Makes the kernel signal `event_fd`, an eventfd, when completions are
+  // posted.
+  bool RegisterEventFd(int event_fd);
+
+  bool has_unsubmitted_entries() const { return sqe_tail_ != submitted_tail_; }
+
+ private:
+  explicit IOUring(ScopedFD ring_fd);
+
+  bool MapRings(const io_uring_params& params);
+
+  const ScopedFD ring_fd_;
+
+  // The mappings shared with the kernel. `cq_ring_` is equal to `sq_ring_`
+  // if the kernel supports IORING_FEAT_SINGLE_MMAP.
+  // RAW_PTR_EXCLUSION: These point to mmap()ed memory.
+  RAW_PTR_EXCLUSION void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  RAW_PTR_EXCLUSION void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  RAW_PTR_EXCLUSION io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  // Pointers into the rings. Heads and tails are shared with the kernel and
+  // must be accessed atomically.
+  RAW_PTR_EXCLUSION uint32_t* sq_head_ = nullptr;
+  RAW_PTR_EXCLUSION uint32_t* sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  RAW_PTR_EXCLUSION uint32_t* cq_head_ = nullptr;
+  RAW_PTR_EXCLUSION uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  RAW_PTR_EXCLUSION io_uring_cqe* cqes_ = nullptr;
+
+  // The tail of the entries returned by GetSqe(), and the tail of the entries
+  // handed to the kernel.
+  uint32_t sqe_tail_ = 0;
+  uint32_t submitted_tail_ = 0;
+};
+
+}  // namespace base
+
+#endif  // BASE_MESSAGE_LOOP_IO_URING_H_
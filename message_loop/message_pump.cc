@@ -12,6 +12,7 @@
 #include "base/task/task_features.h"
 #include "base/threading/platform_thread.h"
 #include "build/build_config.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
 
 #if BUILDFLAG(IS_APPLE)
 #include "base/message_loop/message_pump_apple.h"
@@ -36,6 +37,8 @@ constexpr uint64_t PackAlignWakeUpsAndLeeway(bool align_wake_ups,
 // because the value is queried from multiple threads.
 std::atomic<uint64_t> g_align_wake_ups_and_leeway =
     PackAlignWakeUpsAndLeeway(false, kDefaultLeeway);
+// Whether the current thread opted out of wake up alignment.
+ABSL_CONST_INIT thread_local bool g_wake_up_alignment_disallowed = false;
 #if BUILDFLAG(IS_WIN)
 bool g_explicit_high_resolution_timer_win = true;
 #endif  // BUILDFLAG(IS_WIN)
@@ -142,6 +145,16 @@ bool MessagePump::GetAlignWakeUpsEnabled() {
          kAlignWakeUpsMask;
 }
 
+// static
+void MessagePump::SetAlignWakeUpsForCurrentThread(bool align_wake_ups) {
+  g_wake_up_alignment_disallowed = !align_wake_ups;
+}
+
+// static
+bool MessagePump::GetAlignWakeUpsAllowedForCurrentThread() {
+  return !g_wake_up_alignment_disallowed;
+}
+
 // static
 TimeDelta MessagePump::GetLeewayIgnoringThreadOverride() {
   return Milliseconds(
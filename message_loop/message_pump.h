@@ -40,6 +40,16 @@ class BASE_EXPORT MessagePump {
   static TimeDelta GetLeewayIgnoringThreadOverride();
   static TimeDelta GetLeewayForCurrentThread();
 
+  // When |kAlignWakeUps| is enabled, non-precise delayed wake-ups of all the
+  // message pumps of the process are aligned on the same boundaries, multiples
+  // of the leeway, so that threads with delayed work wake up together (and
+  // timer slack is applied where supported). Threads which need their delayed
+  // tasks to run as close as possible to their scheduled time, e.g. because
+  // they drive media playback, can opt out, which makes all of their wake-ups
+  // precise.
+  static void SetAlignWakeUpsForCurrentThread(bool align_wake_ups);
+  static bool GetAlignWakeUpsAllowedForCurrentThread();
+
   // Creates the default MessagePump based on |type|. Caller owns return value.
   static std::unique_ptr<MessagePump> Create(MessagePumpType type);
 
@@ -6,7 +6,9 @@
 
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/ioctl.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -16,14 +18,46 @@
 #include "base/check_op.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/ref_counted.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/ranges/algorithm.h"
 #include "base/threading/thread_checker.h"
 #include "base/trace_event/base_tracing.h"
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+#include "base/message_loop/io_uring.h"
+#endif
+
+// Older system headers don't define these. See linux/eventpoll.h.
+#if !defined(EPIOCSPARAMS)
+struct epoll_params {
+  uint32_t busy_poll_usecs;
+  uint16_t busy_poll_budget;
+  uint8_t prefer_busy_poll;
+  uint8_t __pad;
+};
+#define EPIOCSPARAMS _IOW(0x8A, 0x01, struct epoll_params)
+#endif
+
 namespace base {
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+namespace {
+
+// The number of submission queue entries of the io_uring instance. Entries are
+// submitted before each wait, so this only bounds the number of operations
+// started by a single batch of work before a submission is forced.
+constexpr uint32_t kIOUringEntries = 256;
+
+}  // namespace
+
+MessagePumpEpoll::MessagePumpEpoll(bool use_io_uring) {
+#else
 MessagePumpEpoll::MessagePumpEpoll() {
+#endif
   epoll_.reset(epoll_create1(/*flags=*/0));
   PCHECK(epoll_.is_valid());
 
@@ -33,25 +67,55 @@ MessagePumpEpoll::MessagePumpEpoll() {
   epoll_event wake{.events = EPOLLIN, .data = {.ptr = &wake_event_}};
   int rv = epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, wake_event_.get(), &wake);
   PCHECK(rv == 0);
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  if (use_io_uring) {
+    // Fall back to plain epoll if the kernel doesn't support io_uring.
+    io_uring_ = IOUring::Create(kIOUringEntries);
+  }
+  if (io_uring_) {
+    completion_event_.reset(eventfd(0, EFD_NONBLOCK));
+    PCHECK(completion_event_.is_valid());
+    if (io_uring_->RegisterEventFd(completion_event_.get())) {
+      epoll_event completion{.events = EPOLLIN,
+                             .data = {.ptr = &completion_event_}};
+      rv = epoll_ctl(epoll_.get(), EPOLL_CTL_ADD, completion_event_.get(),
+                     &completion);
+      PCHECK(rv == 0);
+    } else {
+      io_uring_.reset();
+      completion_event_.reset();
+    }
+  }
+#endif
 }
 
-MessagePumpEpoll::~MessagePumpEpoll() = default;
+MessagePumpEpoll::~MessagePumpEpoll() {
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  if (io_uring_) {
+    CancelPendingIO();
+  }
+#endif
+}
 
 bool MessagePumpEpoll::WatchFileDescriptor(int fd,
                                            bool persistent,
                                            int mode,
                                            FdWatchController* controller,
-                                           FdWatcher* watcher) {
+                                           FdWatcher* watcher,
+                                           bool edge_triggered) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
   TRACE_EVENT("base", "MessagePumpEpoll::WatchFileDescriptor", "fd", fd,
               "persistent", persistent, "watch_read", mode & WATCH_READ,
-              "watch_write", mode & WATCH_WRITE);
+              "watch_write", mode & WATCH_WRITE, "edge_triggered",
+              edge_triggered);
 
   const InterestParams params{
       .fd = fd,
       .read = (mode == WATCH_READ || mode == WATCH_READ_WRITE),
       .write = (mode == WATCH_WRITE || mode == WATCH_READ_WRITE),
       .one_shot = !persistent,
+      .edge_triggered = edge_triggered,
   };
 
   auto [it, is_new_fd_entry] = entries_.emplace(fd, fd);
@@ -84,6 +148,52 @@ bool MessagePumpEpoll::WatchFileDescriptor(int fd,
   return true;
 }
 
+bool MessagePumpEpoll::SetBusyPoll(TimeDelta duration, uint16_t budget) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  epoll_params params = {
+      .busy_poll_usecs = saturated_cast<uint32_t>(duration.InMicroseconds()),
+      .busy_poll_budget = budget,
+      .prefer_busy_poll = duration.is_positive(),
+  };
+  // This fails with ENOTTY on kernels which don't support epoll busy-polling,
+  // and with EPERM if `budget` exceeds NAPI_POLL_WEIGHT without
+  // CAP_NET_ADMIN.
+  return ioctl(epoll_.get(), EPIOCSPARAMS, &params) == 0;
+}
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+void MessagePumpEpoll::ReadAsync(int fd,
+                                 span<uint8_t> buffer,
+                                 int64_t offset,
+                                 IOCompletionCallback callback) {
+  io_uring_sqe* sqe = StartIO(std::move(callback));
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->off = static_cast<uint64_t>(offset);
+  sqe->addr = reinterpret_cast<uintptr_t>(buffer.data());
+  sqe->len = checked_cast<uint32_t>(buffer.size());
+}
+
+void MessagePumpEpoll::WriteAsync(int fd,
+                                  span<const uint8_t> buffer,
+                                  int64_t offset,
+                                  IOCompletionCallback callback) {
+  io_uring_sqe* sqe = StartIO(std::move(callback));
+  sqe->opcode = IORING_OP_WRITE;
+  sqe->fd = fd;
+  sqe->off = static_cast<uint64_t>(offset);
+  sqe->addr = reinterpret_cast<uintptr_t>(buffer.data());
+  sqe->len = checked_cast<uint32_t>(buffer.size());
+}
+
+void MessagePumpEpoll::AcceptAsync(int fd, IOCompletionCallback callback) {
+  io_uring_sqe* sqe = StartIO(std::move(callback));
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = fd;
+  sqe->accept_flags = SOCK_CLOEXEC;
+}
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+
 void MessagePumpEpoll::Run(Delegate* delegate) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
   RunState run_state(delegate);
@@ -222,9 +332,21 @@ bool MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout) {
   const int epoll_timeout =
       timeout.is_max() ? -1
                        : saturated_cast<int>(timeout.InMillisecondsRoundedUp());
-  epoll_event events[16];
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  // Submit all the operations started since the last wait in a single system
+  // call.
+  if (io_uring_ && io_uring_->has_unsubmitted_entries()) {
+    const int rv = io_uring_->Submit();
+    DCHECK(rv >= 0 || rv == -EBUSY || rv == -EAGAIN) << rv;
+  }
+#endif
+
+  // The events live on the stack rather than in a member, since handling them
+  // may run a nested loop which waits again.
+  epoll_event events[kMaxEpollBatchSize];
   const int epoll_result =
-      epoll_wait(epoll_.get(), events, std::size(events), epoll_timeout);
+      epoll_wait(epoll_.get(), events, static_cast<int>(epoll_batch_size_),
+                 epoll_timeout);
   if (epoll_result < 0) {
     DPCHECK(errno == EINTR);
     return false;
@@ -234,8 +356,15 @@ bool MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout) {
     return false;
   }
 
-  const base::span<epoll_event> ready_events(events,
-                                             static_cast<size_t>(epoll_result));
+  // Adapt the batch size to the number of ready descriptors.
+  const size_t num_events = static_cast<size_t>(epoll_result);
+  if (num_events == epoll_batch_size_) {
+    epoll_batch_size_ = std::min(epoll_batch_size_ * 2, kMaxEpollBatchSize);
+  } else if (num_events < epoll_batch_size_ / 4) {
+    epoll_batch_size_ = std::max(epoll_batch_size_ / 2, kMinEpollBatchSize);
+  }
+
+  const base::span<epoll_event> ready_events(events, num_events);
   for (auto& e : ready_events) {
     if (e.data.ptr == &wake_event_) {
       // Wake-up events are always safe to handle immediately. Unlike other
@@ -246,6 +375,15 @@ bool MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout) {
       continue;
     }
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+    if (e.data.ptr == &completion_event_) {
+      // Completions don't point to an EpollEventEntry either, and are handled
+      // in the second pass below so that their callbacks can't invalidate the
+      // entries linked here.
+      continue;
+    }
+#endif
+
     // To guard against one of the ready events unregistering and thus
     // invalidating one of the others here, first link each entry to the
     // corresponding epoll_event returned by epoll_wait(). We do this before
@@ -257,6 +395,12 @@ bool MessagePumpEpoll::WaitForEpollEvents(TimeDelta timeout) {
   }
 
   for (auto& e : ready_events) {
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+    if (e.data.ptr == &completion_event_) {
+      HandleIOCompletions();
+      continue;
+    }
+#endif
     if (e.data.ptr) {
       auto& entry = EpollEventEntry::FromEpollEvent(e);
       entry.active_event = nullptr;
@@ -386,6 +530,83 @@ void MessagePumpEpoll::HandleWakeUp() {
   DPCHECK(n == sizeof(value));
 }
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+io_uring_sqe* MessagePumpEpoll::StartIO(IOCompletionCallback callback) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  CHECK(io_uring_);
+  io_uring_sqe* sqe = io_uring_->GetSqe();
+  if (!sqe) {
+    // The submission queue is full of entries which weren't submitted yet.
+    io_uring_->Submit();
+    sqe = io_uring_->GetSqe();
+    CHECK(sqe);
+  }
+  const uint64_t id = next_io_id_++;
+  pending_io_.emplace(id, std::move(callback));
+  sqe->user_data = id;
+  return sqe;
+}
+
+void MessagePumpEpoll::HandleIOCompletions() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  uint64_t value;
+  ssize_t n =
+      HANDLE_EINTR(read(completion_event_.get(), &value, sizeof(value)));
+  // The completions may have been reaped since the eventfd was signalled.
+  DPCHECK(n == sizeof(value) || errno == EAGAIN);
+  io_uring_->ReapCompletions([this](const io_uring_cqe& cqe) {
+    HandleIOCompletion(cqe.user_data, cqe.res);
+  });
+}
+
+void MessagePumpEpoll::HandleIOCompletion(uint64_t id, int result) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  auto it = pending_io_.find(id);
+  if (it == pending_io_.end()) {
+    return;
+  }
+  IOCompletionCallback callback = std::move(it->second);
+  pending_io_.erase(it);
+
+  BeginNativeWorkBatch();
+  processed_io_events_ = true;
+  // Make the MessagePumpDelegate aware of this other form of "DoWork", like
+  // HandleEvent() does.
+  Delegate::ScopedDoWorkItem scoped_do_work_item;
+  if (run_state_) {
+    scoped_do_work_item = run_state_->delegate->BeginWorkItem();
+  }
+  TRACE_EVENT("toplevel", "IOUringCompletion", "result", result);
+  std::move(callback).Run(result);
+}
+
+void MessagePumpEpoll::CancelPendingIO() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  for (const auto& [id, callback] : pending_io_) {
+    io_uring_sqe* sqe = io_uring_->GetSqe();
+    if (!sqe) {
+      io_uring_->Submit();
+      sqe = io_uring_->GetSqe();
+      CHECK(sqe);
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = id;
+    sqe->user_data = 0;
+  }
+
+  // The buffers of the pending operations may be freed as soon as the pump is
+  // destroyed, so wait until the kernel is done with all of them, whether they
+  // were cancelled or not.
+  while (!pending_io_.empty()) {
+    const int rv = io_uring_->Submit(/*min_complete=*/1);
+    DCHECK_GE(rv, 0);
+    io_uring_->ReapCompletions([this](const io_uring_cqe& cqe) {
+      pending_io_.erase(cqe.user_data);
+    });
+  }
+}
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+
 void MessagePumpEpoll::BeginNativeWorkBatch() {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
   // Call `BeginNativeWorkBeforeDoWork()` if native work hasn't started.
@@ -409,6 +630,7 @@ MessagePumpEpoll::EpollEventEntry::~EpollEventEntry() {
 uint32_t MessagePumpEpoll::EpollEventEntry::ComputeActiveEvents() {
   uint32_t events = 0;
   bool one_shot = true;
+  bool edge_triggered = true;
   for (const auto& interest : interests) {
     if (!interest->active()) {
       continue;
@@ -416,9 +638,18 @@ uint32_t MessagePumpEpoll::EpollEventEntry::ComputeActiveEvents() {
     const InterestParams& params = interest->params();
     events |= (params.read ? EPOLLIN : 0) | (params.write ? EPOLLOUT : 0);
     one_shot &= params.one_shot;
+    edge_triggered &= params.edge_triggered;
+  }
+  if (events == 0) {
+    return events;
+  }
+  if (one_shot) {
+    events |= EPOLLONESHOT;
   }
-  if (events != 0 && one_shot) {
-    return events | EPOLLONESHOT;
+  // Level-triggered interests would miss notifications if the descriptor was
+  // edge-triggered, so only make it edge-triggered if all of them are.
+  if (edge_triggered) {
+    events |= EPOLLET;
   }
   return events;
 }
@@ -9,24 +9,42 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 
 #include "base/base_export.h"
+#include "base/containers/span.h"
 #include "base/files/scoped_file.h"
+#include "base/functional/callback.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/raw_ptr_exclusion.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_pump.h"
+#include "base/message_loop/message_pump_buildflags.h"
 #include "base/message_loop/message_pump_libevent.h"
 #include "base/message_loop/watchable_io_message_pump_posix.h"
 #include "base/threading/thread_checker.h"
 #include "base/time/time.h"
 #include "third_party/abseil-cpp/absl/container/inlined_vector.h"
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+struct io_uring_sqe;
+#endif
+
 namespace base {
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+class IOUring;
+#endif
+
 // A MessagePump implementation suitable for I/O message loops on Linux-based
 // systems with epoll API support.
+//
+// If constructed with `use_io_uring` and the kernel supports it, the pump also
+// performs completion-based I/O through io_uring: operations started with
+// ReadAsync(), WriteAsync() and AcceptAsync() are queued, submitted in a single
+// system call right before the pump next waits, and their completions are
+// signalled to the epoll instance through an eventfd.
 class BASE_EXPORT MessagePumpEpoll : public MessagePump,
                                      public WatchableIOMessagePumpPosix {
   using InterestParams = MessagePumpLibevent::EpollInterestParams;
@@ -35,7 +53,13 @@ class BASE_EXPORT MessagePumpEpoll : public MessagePump,
  public:
   using FdWatchController = MessagePumpLibevent::FdWatchController;
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  using IOCompletionCallback = MessagePumpLibevent::IOCompletionCallback;
+
+  explicit MessagePumpEpoll(bool use_io_uring = false);
+#else
   MessagePumpEpoll();
+#endif
   MessagePumpEpoll(const MessagePumpEpoll&) = delete;
   MessagePumpEpoll& operator=(const MessagePumpEpoll&) = delete;
   ~MessagePumpEpoll() override;
@@ -44,7 +68,25 @@ class BASE_EXPORT MessagePumpEpoll : public MessagePump,
                            bool persistent,
                            int mode,
                            FdWatchController* controller,
-                           FdWatcher* watcher);
+                           FdWatcher* watcher,
+                           bool edge_triggered = false);
+
+  // See MessagePumpLibevent.
+  bool SetBusyPoll(TimeDelta duration, uint16_t budget);
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  // See MessagePumpLibevent for the documentation of these methods.
+  bool SupportsCompletionIO() const { return !!io_uring_; }
+  void ReadAsync(int fd,
+                 span<uint8_t> buffer,
+                 int64_t offset,
+                 IOCompletionCallback callback);
+  void WriteAsync(int fd,
+                  span<const uint8_t> buffer,
+                  int64_t offset,
+                  IOCompletionCallback callback);
+  void AcceptAsync(int fd, IOCompletionCallback callback);
+#endif
 
   // MessagePump methods:
   void Run(Delegate* delegate) override;
@@ -81,6 +123,7 @@ class BASE_EXPORT MessagePumpEpoll : public MessagePump,
     //   - EPOLLIN is set if any active Interest wants to `read`.
     //   - EPOLLOUT is set if any active Interest wants to `write`.
     //   - EPOLLONESHOT is set if all active Interests are one-shot.
+    //   - EPOLLET is set if all active Interests are edge-triggered.
     uint32_t ComputeActiveEvents();
 
     // The file descriptor to which this entry pertains.
@@ -121,6 +164,9 @@ class BASE_EXPORT MessagePumpEpoll : public MessagePump,
     bool should_quit = false;
   };
 
+  static constexpr size_t kMinEpollBatchSize = 16;
+  static constexpr size_t kMaxEpollBatchSize = 256;
+
   void AddEpollEvent(EpollEventEntry& entry);
   void UpdateEpollEvent(EpollEventEntry& entry);
   void StopEpollEvent(EpollEventEntry& entry);
@@ -132,6 +178,16 @@ class BASE_EXPORT MessagePumpEpoll : public MessagePump,
                    bool can_write,
                    FdWatchController* controller);
   void HandleWakeUp();
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  // Returns a submission queue entry for an operation whose completion runs
+  // `callback`.
+  io_uring_sqe* StartIO(IOCompletionCallback callback);
+  void HandleIOCompletions();
+  void HandleIOCompletion(uint64_t id, int result);
+  // Cancels all pending operations and waits for the kernel to be done with
+  // them, without running their callbacks.
+  void CancelPendingIO();
+#endif
 
   void BeginNativeWorkBatch();
 
@@ -142,6 +198,11 @@ class BASE_EXPORT MessagePumpEpoll : public MessagePump,
   // This flag is set if epoll has processed I/O events.
   bool processed_io_events_ = false;
 
+  // The maximum number of events returned by a single epoll_wait(). This
+  // grows while waits return full batches, so that a thread watching many
+  // busy descriptors needs fewer waits, and shrinks back when they don't.
+  size_t epoll_batch_size_ = kMinEpollBatchSize;
+
   // This flag is set when starting to process native work; reset after every
   // `DoWork()` call. See crbug.com/1500295.
   bool native_work_started_ = false;
@@ -158,6 +219,21 @@ class BASE_EXPORT MessagePumpEpoll : public MessagePump,
   // An eventfd object used to wake the pump's thread when scheduling new work.
   ScopedFD wake_event_;
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  // The io_uring instance used for completion-based I/O, or null if it's not
+  // used or supported.
+  std::unique_ptr<IOUring> io_uring_;
+
+  // An eventfd object signalled by `io_uring_` when completions are posted.
+  ScopedFD completion_event_;
+
+  // Callbacks of the operations submitted to `io_uring_`, keyed by the
+  // user_data of their submission queue entries. 0 is reserved for the
+  // entries whose completion doesn't need to be handled.
+  std::map<uint64_t, IOCompletionCallback> pending_io_;
+  uint64_t next_io_id_ = 1;
+#endif
+
   // WatchFileDescriptor() must be called from this thread, and so must
   // FdWatchController::StopWatchingFileDescriptor().
   THREAD_CHECKER(thread_checker_);
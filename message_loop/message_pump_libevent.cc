@@ -47,6 +47,16 @@ bool g_use_epoll = true;
 BASE_FEATURE(kMessagePumpEpoll, "MessagePumpEpoll", FEATURE_ENABLED_BY_DEFAULT);
 #endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+namespace {
+bool g_use_io_uring = false;
+}  // namespace
+
+BASE_FEATURE(kMessagePumpIOUring,
+             "MessagePumpIOUring",
+             FEATURE_DISABLED_BY_DEFAULT);
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+
 MessagePumpLibevent::FdWatchController::FdWatchController(
     const Location& from_here)
     : FdWatchControllerInterface(from_here) {}
@@ -137,7 +147,11 @@ void MessagePumpLibevent::FdWatchController::OnFdWritable() {
 MessagePumpLibevent::MessagePumpLibevent() {
 #if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
   if (g_use_epoll) {
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+    epoll_pump_ = std::make_unique<MessagePumpEpoll>(g_use_io_uring);
+#else
     epoll_pump_ = std::make_unique<MessagePumpEpoll>();
+#endif
     return;
   }
 #endif
@@ -181,17 +195,21 @@ void MessagePumpLibevent::InitializeFeatures() {
 #if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
   g_use_epoll = FeatureList::IsEnabled(kMessagePumpEpoll);
 #endif
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  g_use_io_uring = FeatureList::IsEnabled(kMessagePumpIOUring);
+#endif
 }
 
 bool MessagePumpLibevent::WatchFileDescriptor(int fd,
                                               bool persistent,
                                               int mode,
                                               FdWatchController* controller,
-                                              FdWatcher* delegate) {
+                                              FdWatcher* delegate,
+                                              bool edge_triggered) {
 #if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
   if (epoll_pump_) {
     return epoll_pump_->WatchFileDescriptor(fd, persistent, mode, controller,
-                                            delegate);
+                                            delegate, edge_triggered);
   }
 #endif
 
@@ -258,6 +276,39 @@ bool MessagePumpLibevent::WatchFileDescriptor(int fd,
   return true;
 }
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+bool MessagePumpLibevent::SetBusyPoll(TimeDelta duration, uint16_t budget) {
+  return epoll_pump_ && epoll_pump_->SetBusyPoll(duration, budget);
+}
+#endif
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+bool MessagePumpLibevent::SupportsCompletionIO() const {
+  return epoll_pump_ && epoll_pump_->SupportsCompletionIO();
+}
+
+void MessagePumpLibevent::ReadAsync(int fd,
+                                    span<uint8_t> buffer,
+                                    int64_t offset,
+                                    IOCompletionCallback callback) {
+  CHECK(SupportsCompletionIO());
+  epoll_pump_->ReadAsync(fd, buffer, offset, std::move(callback));
+}
+
+void MessagePumpLibevent::WriteAsync(int fd,
+                                     span<const uint8_t> buffer,
+                                     int64_t offset,
+                                     IOCompletionCallback callback) {
+  CHECK(SupportsCompletionIO());
+  epoll_pump_->WriteAsync(fd, buffer, offset, std::move(callback));
+}
+
+void MessagePumpLibevent::AcceptAsync(int fd, IOCompletionCallback callback) {
+  CHECK(SupportsCompletionIO());
+  epoll_pump_->AcceptAsync(fd, std::move(callback));
+}
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+
 // Tell libevent to break out of inner loop.
 static void timer_callback(int fd, short events, void* context) {
   event_base_loopbreak((struct event_base*)context);
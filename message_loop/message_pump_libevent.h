@@ -10,7 +10,9 @@
 
 #include "base/base_export.h"
 #include "base/compiler_specific.h"
+#include "base/containers/span.h"
 #include "base/feature_list.h"
+#include "base/functional/callback.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/raw_ptr_exclusion.h"
 #include "base/memory/weak_ptr.h"
@@ -18,6 +20,7 @@
 #include "base/message_loop/message_pump_buildflags.h"
 #include "base/message_loop/watchable_io_message_pump_posix.h"
 #include "base/threading/thread_checker.h"
+#include "base/time/time.h"
 #include "third_party/libevent/event.h"
 
 // Declare structs we need from libevent.h rather than including it
@@ -29,6 +32,12 @@ namespace base {
 BASE_EXPORT BASE_DECLARE_FEATURE(kMessagePumpEpoll);
 #endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+// Makes the epoll pump perform completion-based I/O through io_uring when the
+// kernel supports it. Only has an effect if kMessagePumpEpoll is enabled.
+BASE_EXPORT BASE_DECLARE_FEATURE(kMessagePumpIOUring);
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+
 class MessagePumpEpoll;
 
 // Class to monitor sockets and issue callbacks when sockets are ready for I/O
@@ -53,9 +62,14 @@ class BASE_EXPORT MessagePumpLibevent : public MessagePump,
     // must be automatically deactivated every time it triggers an epoll event.
     bool one_shot;
 
+    // Indicates whether this interest only wants to be notified when `fd`
+    // becomes ready, rather than for as long as it is ready.
+    bool edge_triggered = false;
+
     bool IsEqual(const EpollInterestParams& rhs) const {
-      return std::tie(fd, read, write, one_shot) ==
-             std::tie(rhs.fd, rhs.read, rhs.write, rhs.one_shot);
+      return std::tie(fd, read, write, one_shot, edge_triggered) ==
+             std::tie(rhs.fd, rhs.read, rhs.write, rhs.one_shot,
+                      rhs.edge_triggered);
     }
   };
 
@@ -202,11 +216,57 @@ class BASE_EXPORT MessagePumpLibevent : public MessagePump,
   // Initializes features for this class. See `base::features::Init()`.
   static void InitializeFeatures();
 
+  // If `edge_triggered` is true, `delegate` is only notified when `fd`
+  // becomes ready rather than for as long as it's ready, and must therefore
+  // read or write until it would block. This saves epoll_ctl() calls and
+  // spurious notifications for busy descriptors. It is a hint: it only has an
+  // effect when using epoll directly.
   bool WatchFileDescriptor(int fd,
                            bool persistent,
                            int mode,
                            FdWatchController* controller,
-                           FdWatcher* delegate);
+                           FdWatcher* delegate,
+                           bool edge_triggered = false);
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+  // Makes the kernel busy-poll the network sockets watched by this pump for up
+  // to `duration`, processing up to `budget` packets per poll, before waiting.
+  // This trades CPU time for latency on latency-critical IO threads. Returns
+  // false if the kernel doesn't support it (before Linux 6.9) or if epoll isn't
+  // used directly.
+  bool SetBusyPoll(TimeDelta duration, uint16_t budget);
+#endif
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  // Runs with the result of an operation started by one of the methods below:
+  // a byte count or a file descriptor on success, or -errno on failure.
+  using IOCompletionCallback = OnceCallback<void(int result)>;
+
+  // Returns true if this pump supports the completion-based I/O methods below,
+  // which is the case if it uses io_uring.
+  bool SupportsCompletionIO() const;
+
+  // Asynchronously reads into or writes from `buffer` at `offset` in `fd`, or
+  // at its current position if `offset` is -1, and runs `callback` on this
+  // pump's thread with the result. Operations are submitted to the kernel in
+  // batches, right before the pump waits. `buffer` must remain valid until
+  // `callback` runs or the pump is destroyed, in which case pending operations
+  // are cancelled without running their callbacks. Must only be called if
+  // SupportsCompletionIO().
+  void ReadAsync(int fd,
+                 span<uint8_t> buffer,
+                 int64_t offset,
+                 IOCompletionCallback callback);
+  void WriteAsync(int fd,
+                  span<const uint8_t> buffer,
+                  int64_t offset,
+                  IOCompletionCallback callback);
+
+  // Asynchronously accepts a connection on the listening socket `fd`, and runs
+  // `callback` with the accepted socket, which is close-on-exec. Same
+  // requirements as above.
+  void AcceptAsync(int fd, IOCompletionCallback callback);
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
 
   // MessagePump methods:
   void Run(Delegate* delegate) override;
@@ -5,16 +5,19 @@
 #include "base/message_loop/message_pump_libevent.h"
 
 #include <fcntl.h>
+#include <netinet/in.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include <memory>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "base/containers/span.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_file.h"
+#include "base/barrier_closure.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
 #include "base/logging.h"
@@ -31,6 +34,7 @@
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_executor.h"
 #include "base/task/single_thread_task_runner.h"
+#include "base/test/bind.h"
 #include "base/test/gtest_util.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
@@ -48,6 +52,7 @@ namespace base {
 enum PumpType {
   kLibevent,
   kEpoll,
+  kIOUring,
 };
 
 class MessagePumpLibeventTest : public testing::Test,
@@ -60,6 +65,8 @@ class MessagePumpLibeventTest : public testing::Test,
     return io_thread_.task_runner();
   }
 
+  void StopIOThread() { io_thread_.Stop(); }
+
   void ClearNotifications() {
     int unused;
     while (read(receiver_.get(), &unused, sizeof(unused)) == sizeof(unused)) {
@@ -80,10 +87,16 @@ class MessagePumpLibeventTest : public testing::Test,
 
   void SetUp() override {
 #if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
-    // Select MessagePumpLibevent or MessagePumpEpoll based on the test
-    // parameter.
+    // Select MessagePumpLibevent or MessagePumpEpoll, with or without
+    // io_uring, based on the test parameter.
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+    scoped_feature_list_.InitWithFeatureStates(
+        {{base::kMessagePumpEpoll, GetParam() != kLibevent},
+         {base::kMessagePumpIOUring, GetParam() == kIOUring}});
+#else
     scoped_feature_list_.InitWithFeatureState(base::kMessagePumpEpoll,
                                               GetParam() == kEpoll);
+#endif
     MessagePumpLibevent::InitializeFeatures();
 #endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
 
@@ -117,7 +130,7 @@ class MessagePumpLibeventTest : public testing::Test,
   void SimulateIOEvent(MessagePumpLibevent* pump,
                        MessagePumpLibevent::FdWatchController* controller) {
 #if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
-    if (GetParam() == kEpoll) {
+    if (GetParam() != kLibevent) {
       pump->epoll_pump_->HandleEvent(0, /*can_read=*/true, /*can_write=*/true,
                                      controller);
       return;
@@ -126,6 +139,17 @@ class MessagePumpLibeventTest : public testing::Test,
     pump->OnLibeventNotification(0, EV_WRITE | EV_READ, controller);
   }
 
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+  // Dispatches the ready events of a pump using epoll, without waiting.
+  void HandleReadyEpollEvents(MessagePumpLibevent* pump) {
+    pump->epoll_pump_->WaitForEpollEvents(TimeDelta());
+  }
+
+  size_t GetEpollBatchSize(MessagePumpLibevent* pump) {
+    return pump->epoll_pump_->epoll_batch_size_;
+  }
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+
   static constexpr char null_byte_ = 0;
   std::unique_ptr<test::SingleThreadTaskEnvironment> task_environment_;
 
@@ -419,6 +443,227 @@ TEST_P(MessagePumpLibeventTest, NestedNotification) {
 }
 
 #if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+class CountingReadWatcher : public BaseWatcher {
+ public:
+  int num_reads() const { return num_reads_; }
+
+  // Doesn't read, so that the descriptor remains readable.
+  void OnFileCanReadWithoutBlocking(int /* fd */) override { ++num_reads_; }
+
+ private:
+  int num_reads_ = 0;
+};
+
+TEST_P(MessagePumpLibeventTest, EdgeTriggeredWatch) {
+  if (GetParam() == kLibevent) {
+    GTEST_SKIP();
+  }
+
+  std::unique_ptr<MessagePumpLibevent> pump = CreateMessagePump();
+  MessagePumpLibevent::FdWatchController controller(FROM_HERE);
+  CountingReadWatcher watcher;
+  pump->WatchFileDescriptor(receiver(), /*persistent=*/true,
+                            MessagePumpLibevent::WATCH_READ, &controller,
+                            &watcher, /*edge_triggered=*/true);
+
+  // The watcher is only notified again once more data is received, even though
+  // it didn't read what was already received.
+  Notify();
+  HandleReadyEpollEvents(pump.get());
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(1, watcher.num_reads());
+  Notify();
+  HandleReadyEpollEvents(pump.get());
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(2, watcher.num_reads());
+}
+
+TEST_P(MessagePumpLibeventTest, LevelTriggeredWatch) {
+  if (GetParam() == kLibevent) {
+    GTEST_SKIP();
+  }
+
+  std::unique_ptr<MessagePumpLibevent> pump = CreateMessagePump();
+  MessagePumpLibevent::FdWatchController controller(FROM_HERE);
+  CountingReadWatcher watcher;
+  pump->WatchFileDescriptor(receiver(), /*persistent=*/true,
+                            MessagePumpLibevent::WATCH_READ, &controller,
+                            &watcher);
+
+  // The watcher is notified for as long as the descriptor is readable.
+  Notify();
+  HandleReadyEpollEvents(pump.get());
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(2, watcher.num_reads());
+}
+
+TEST_P(MessagePumpLibeventTest, EpollBatchSizeAdapts) {
+  if (GetParam() == kLibevent) {
+    GTEST_SKIP();
+  }
+
+  constexpr size_t kNumSockets = 40;
+  std::unique_ptr<MessagePumpLibevent> pump = CreateMessagePump();
+  std::vector<ScopedFD> receivers;
+  std::vector<ScopedFD> senders;
+  std::vector<std::unique_ptr<MessagePumpLibevent::FdWatchController>>
+      controllers;
+  StupidWatcher watcher;
+  for (size_t i = 0; i < kNumSockets; ++i) {
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    receivers.emplace_back(fds[0]);
+    senders.emplace_back(fds[1]);
+    ASSERT_EQ(1, HANDLE_EINTR(write(fds[1], &null_byte_, 1)));
+    controllers.push_back(
+        std::make_unique<MessagePumpLibevent::FdWatchController>(FROM_HERE));
+    pump->WatchFileDescriptor(fds[0], /*persistent=*/true,
+                              MessagePumpLibevent::WATCH_READ,
+                              controllers.back().get(), &watcher);
+  }
+
+  // The batch size doubles while waits return full batches.
+  EXPECT_EQ(16u, GetEpollBatchSize(pump.get()));
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(32u, GetEpollBatchSize(pump.get()));
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(64u, GetEpollBatchSize(pump.get()));
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(64u, GetEpollBatchSize(pump.get()));
+
+  // And halves when they return few events.
+  controllers.resize(1);
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(32u, GetEpollBatchSize(pump.get()));
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(16u, GetEpollBatchSize(pump.get()));
+  HandleReadyEpollEvents(pump.get());
+  EXPECT_EQ(16u, GetEpollBatchSize(pump.get()));
+}
+
+TEST_P(MessagePumpLibeventTest, SetBusyPoll) {
+  std::unique_ptr<MessagePumpLibevent> pump = CreateMessagePump();
+  // Busy-polling depends on the kernel version, but is never supported by
+  // libevent.
+  const bool supported = pump->SetBusyPoll(Microseconds(50), /*budget=*/8);
+  if (GetParam() == kLibevent) {
+    EXPECT_FALSE(supported);
+  } else if (supported) {
+    EXPECT_TRUE(pump->SetBusyPoll(TimeDelta(), /*budget=*/0));
+  }
+}
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+// Returns true if the pumps of the kIOUring tests use io_uring.
+bool IOUringSupported() {
+  return MessagePumpEpoll(/*use_io_uring=*/true).SupportsCompletionIO();
+}
+
+TEST_P(MessagePumpLibeventTest, ReadWriteAsync) {
+  if (GetParam() != kIOUring || !IOUringSupported()) {
+    GTEST_SKIP();
+  }
+
+  constexpr std::string_view kData = "Hello, io_uring!";
+  std::vector<uint8_t> read_buffer(kData.size());
+  int read_result = 0;
+  int write_result = 0;
+  RunLoop run_loop;
+  auto done = BarrierClosure(2, run_loop.QuitClosure());
+  io_runner()->PostTask(FROM_HERE, BindLambdaForTesting([&] {
+                          ASSERT_TRUE(
+                              CurrentIOThread::Get()->SupportsCompletionIO());
+                          // Start reading before anything is written, so that
+                          // the read has to wait for the write.
+                          CurrentIOThread::Get()->ReadAsync(
+                              receiver(), read_buffer, /*offset=*/-1,
+                              BindLambdaForTesting([&](int result) {
+                                read_result = result;
+                                done.Run();
+                              }));
+                          CurrentIOThread::Get()->WriteAsync(
+                              sender(), as_byte_span(kData), /*offset=*/-1,
+                              BindLambdaForTesting([&](int result) {
+                                write_result = result;
+                                done.Run();
+                              }));
+                        }));
+  run_loop.Run();
+
+  EXPECT_EQ(static_cast<int>(kData.size()), write_result);
+  EXPECT_EQ(static_cast<int>(kData.size()), read_result);
+  EXPECT_EQ(kData, as_string_view(as_chars(span(read_buffer))));
+}
+
+TEST_P(MessagePumpLibeventTest, AcceptAsync) {
+  if (GetParam() != kIOUring || !IOUringSupported()) {
+    GTEST_SKIP();
+  }
+
+  ScopedFD listener(socket(AF_INET, SOCK_STREAM, 0));
+  ASSERT_TRUE(listener.is_valid());
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_len = sizeof(address);
+  ASSERT_EQ(0, bind(listener.get(), reinterpret_cast<sockaddr*>(&address),
+                    address_len));
+  ASSERT_EQ(0, listen(listener.get(), 1));
+  ASSERT_EQ(0, getsockname(listener.get(),
+                           reinterpret_cast<sockaddr*>(&address),
+                           &address_len));
+
+  int accept_result = -1;
+  RunLoop run_loop;
+  io_runner()->PostTask(FROM_HERE, BindLambdaForTesting([&] {
+                          CurrentIOThread::Get()->AcceptAsync(
+                              listener.get(),
+                              BindLambdaForTesting([&](int result) {
+                                accept_result = result;
+                                run_loop.Quit();
+                              }));
+                        }));
+
+  ScopedFD client(socket(AF_INET, SOCK_STREAM, 0));
+  ASSERT_TRUE(client.is_valid());
+  ASSERT_EQ(0, HANDLE_EINTR(connect(client.get(),
+                                    reinterpret_cast<sockaddr*>(&address),
+                                    address_len)));
+  run_loop.Run();
+
+  ASSERT_GE(accept_result, 0);
+  ScopedFD accepted(accept_result);
+  EXPECT_TRUE(fcntl(accepted.get(), F_GETFD) & FD_CLOEXEC);
+}
+
+TEST_P(MessagePumpLibeventTest, PendingIOCancelledOnDestruction) {
+  if (GetParam() != kIOUring || !IOUringSupported()) {
+    GTEST_SKIP();
+  }
+
+  // Nothing is ever written to `sender()`, so the read can only complete by
+  // being cancelled when the pump is destroyed, without running its callback.
+  std::vector<uint8_t> read_buffer(16);
+  bool callback_ran = false;
+  RunLoop run_loop;
+  io_runner()->PostTaskAndReply(
+      FROM_HERE, BindLambdaForTesting([&] {
+        CurrentIOThread::Get()->ReadAsync(
+            receiver(), read_buffer, /*offset=*/-1,
+            BindLambdaForTesting([&](int result) { callback_ran = true; }));
+      }),
+      run_loop.QuitClosure());
+  run_loop.Run();
+
+  StopIOThread();
+  EXPECT_FALSE(callback_ran);
+}
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+#define TEST_PARAM_VALUES kLibevent, kEpoll, kIOUring
+#elif BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
 #define TEST_PARAM_VALUES kLibevent, kEpoll
 #else
 #define TEST_PARAM_VALUES kLibevent
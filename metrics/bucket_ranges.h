@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "base/base_export.h"
+#include "base/bits.h"
 #include "base/check_op.h"
 #include "base/metrics/histogram_base.h"
 
@@ -77,6 +78,34 @@ class BASE_EXPORT BucketRanges {
     return persistent_reference_.load(std::memory_order_acquire);
   }
 
+  // Ranges with a log-linear layout of precision p have unit-width buckets up
+  // to 2^(p+1), then 2^p buckets of equal width between consecutive powers of
+  // 2, up to an overflow bucket (see QuantileSketchHistogram). The bucket of a
+  // sample is then computed in constant time by GetLogLinearBucketIndex().
+  // These set and get p once the layout was verified, or 0 if it wasn't.
+  void set_log_linear_precision(int precision) const {
+    log_linear_precision_.store(precision, std::memory_order_relaxed);
+  }
+  int log_linear_precision() const {
+    return log_linear_precision_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the index of the bucket of |value| in the log-linear layout of
+  // |precision|, ignoring any overflow bucket. |value| must not be negative.
+  static size_t GetLogLinearBucketIndex(HistogramBase::Sample value,
+                                        int precision) {
+    DCHECK_GE(value, 0);
+    const uint32_t sample = static_cast<uint32_t>(value);
+    const uint32_t unit_buckets = 2u << precision;
+    if (sample < unit_buckets) {
+      return sample;
+    }
+    const int exponent = bits::Log2Floor(sample);
+    return unit_buckets + (static_cast<size_t>(exponent - precision - 1)
+                           << precision) +
+           ((sample >> (exponent - precision)) - (1u << precision));
+  }
+
  private:
   // A monotonically increasing list of values which determine which bucket to
   // put a sample into.  For each index, show the smallest sample that can be
@@ -95,6 +124,9 @@ class BASE_EXPORT BucketRanges {
   // re-used simply by having all histograms with the same ranges use the
   // same reference.
   mutable std::atomic<uint32_t> persistent_reference_{0};
+
+  // The precision of the log-linear layout of the ranges, or 0.
+  mutable std::atomic<int> log_linear_precision_{0};
 };
 
 }  // namespace base
@@ -4,6 +4,17 @@
 
 #include "base/metrics/crc32.h"
 
+#include "base/numerics/byte_conversions.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include <nmmintrin.h>
+
+#include "base/cpu.h"
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
 namespace base {
 
 // Static table of checksums for all possible 8 bit bytes.
@@ -62,6 +73,113 @@ const std::array<uint32_t, 256> kCrcTable = {
     0x2d02ef8dL,
 };
 
+namespace {
+
+constexpr uint32_t kCrc32Polynomial = 0xEDB88320;
+constexpr uint32_t kCrc32cPolynomial = 0x82F63B78;
+
+// The tables for slicing-by-8: `tables[0]` is the checksum of each byte, and
+// `tables[k]` the checksum of each byte followed by `k` zero bytes, so that 8
+// bytes can be folded into the checksum at once.
+using SlicingTables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr SlicingTables MakeSlicingTables(uint32_t reversed_polynomial) {
+  SlicingTables tables = {};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t checksum = i;
+    for (int j = 0; j < 8; ++j) {
+      checksum = (checksum >> 1) ^ ((checksum & 1) ? reversed_polynomial : 0);
+    }
+    tables[0][i] = checksum;
+  }
+  for (size_t k = 1; k < tables.size(); ++k) {
+    for (size_t i = 0; i < 256; ++i) {
+      const uint32_t previous = tables[k - 1][i];
+      tables[k][i] = tables[0][previous & 0xFF] ^ (previous >> 8);
+    }
+  }
+  return tables;
+}
+
+constexpr SlicingTables kCrc32Tables = MakeSlicingTables(kCrc32Polynomial);
+constexpr SlicingTables kCrc32cTables = MakeSlicingTables(kCrc32cPolynomial);
+
+// Computes the checksum using table lookups, 8 bytes at a time. The bytes are
+// combined explicitly so the result is the same on all architectures, and
+// matches a byte-at-a-time computation.
+uint32_t SlicingBy8(const SlicingTables& tables,
+                    uint32_t sum,
+                    span<const uint8_t> data) {
+  while (data.size() >= 8) {
+    sum ^= U32FromLittleEndian(data.first<4>());
+    sum = tables[7][sum & 0xFF] ^ tables[6][(sum >> 8) & 0xFF] ^
+          tables[5][(sum >> 16) & 0xFF] ^ tables[4][sum >> 24] ^
+          tables[3][data[4]] ^ tables[2][data[5]] ^ tables[1][data[6]] ^
+          tables[0][data[7]];
+    data = data.subspan(8u);
+  }
+  for (uint8_t byte : data) {
+    sum = tables[0][(sum & 0xFF) ^ byte] ^ (sum >> 8);
+  }
+  return sum;
+}
+
+#if defined(ARCH_CPU_X86_64)
+
+__attribute__((target("sse4.2"))) uint32_t Crc32cSse42(
+    uint32_t sum,
+    span<const uint8_t> data) {
+  uint64_t sum64 = sum;
+  while (data.size() >= 8) {
+    sum64 = _mm_crc32_u64(sum64, U64FromLittleEndian(data.first<8>()));
+    data = data.subspan(8u);
+  }
+  sum = static_cast<uint32_t>(sum64);
+  for (uint8_t byte : data) {
+    sum = _mm_crc32_u8(sum, byte);
+  }
+  return sum;
+}
+
+bool HasSse42() {
+  static const bool has_sse42 = CPU::GetInstanceNoAllocation().has_sse42();
+  return has_sse42;
+}
+
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_FEATURE_CRC32)
+
+// The CRC32 instructions of Armv8 are available whenever the compiler targets
+// them, so there is no need to check the CPU at runtime.
+template <uint32_t (*kUpdate64)(uint32_t, uint64_t),
+          uint32_t (*kUpdate8)(uint32_t, uint8_t)>
+uint32_t CrcArm(uint32_t sum, span<const uint8_t> data) {
+  while (data.size() >= 8) {
+    sum = kUpdate64(sum, U64FromLittleEndian(data.first<8>()));
+    data = data.subspan(8u);
+  }
+  for (uint8_t byte : data) {
+    sum = kUpdate8(sum, byte);
+  }
+  return sum;
+}
+
+uint32_t Crc32Update64(uint32_t sum, uint64_t value) {
+  return __crc32d(sum, value);
+}
+uint32_t Crc32Update8(uint32_t sum, uint8_t value) {
+  return __crc32b(sum, value);
+}
+uint32_t Crc32cUpdate64(uint32_t sum, uint64_t value) {
+  return __crc32cd(sum, value);
+}
+uint32_t Crc32cUpdate8(uint32_t sum, uint8_t value) {
+  return __crc32cb(sum, value);
+}
+
+#endif
+
+}  // namespace
+
 // We generate the CRC-32 using the low order bits to select whether to XOR in
 // the reversed polynomial 0xEDB88320.  This is nice and simple, and allows us
 // to keep the quotient in a uint32_t.  Since we're not concerned about the
@@ -70,11 +188,26 @@ const std::array<uint32_t, 256> kCrcTable = {
 // the CRC correct for big-endian vs little-ending calculations.  All we need is
 // a nice hash, that tends to depend on all the bits of the sample, with very
 // little chance of changes in one place impacting changes in another place.
+//
+// The checksums are persisted, e.g. in metrics files, so all implementations
+// must return the same value as the byte-at-a-time lookup in `kCrcTable`.
 uint32_t Crc32(uint32_t sum, span<const uint8_t> data) {
-  for (uint8_t byte : data) {
-    sum = kCrcTable[(sum & 0x000000FF) ^ byte] ^ (sum >> 8);
+#if defined(ARCH_CPU_ARM64) && defined(__ARM_FEATURE_CRC32)
+  return CrcArm<&Crc32Update64, &Crc32Update8>(sum, data);
+#else
+  return SlicingBy8(kCrc32Tables, sum, data);
+#endif
+}
+
+uint32_t Crc32c(uint32_t sum, span<const uint8_t> data) {
+#if defined(ARCH_CPU_X86_64)
+  if (HasSse42()) {
+    return Crc32cSse42(sum, data);
   }
-  return sum;
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_FEATURE_CRC32)
+  return CrcArm<&Crc32cUpdate64, &Crc32cUpdate8>(sum, data);
+#endif
+  return SlicingBy8(kCrc32cTables, sum, data);
 }
 
 }  // namespace base
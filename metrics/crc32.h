@@ -22,6 +22,13 @@ BASE_EXPORT extern const std::array<uint32_t, 256> kCrcTable;
 // with any seed or be used to continue an operation began with previous data.
 BASE_EXPORT uint32_t Crc32(uint32_t sum, span<const uint8_t> data);
 
+// Like Crc32(), but with the Castagnoli polynomial (CRC-32C), which has
+// better error detection and is computed by the SSE4.2 crc32 instruction
+// where available. As with Crc32(), the checksum isn't inverted before or
+// after: the standard CRC-32C of `data` is
+// `~Crc32c(0xFFFFFFFF, data)`.
+BASE_EXPORT uint32_t Crc32c(uint32_t sum, span<const uint8_t> data);
+
 }  // namespace base
 
 #endif  // BASE_METRICS_CRC32_H_
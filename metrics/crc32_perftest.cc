@@ -0,0 +1,67 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/crc32.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/debug/alias.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricThroughput[] = "throughput";
+
+void RunCrcPerfTest(const char* crc_name,
+                    uint32_t (*crc)(uint32_t, span<const uint8_t>),
+                    size_t len) {
+  perf_test::PerfResultReporter reporter(crc_name,
+                                         NumberToString(len) + "_bytes");
+  reporter.RegisterImportantMetric(kMetricThroughput, "MB/s");
+
+  std::vector<uint8_t> buffer(len);
+  RandBytes(buffer);
+  // Checksum at least 256 MB in total, so that the time is measurable.
+  const size_t num_runs = std::max<size_t>(1, (256u << 20) / len);
+
+  uint32_t sum = 0;
+  const TimeTicks start_time = TimeTicks::Now();
+  for (size_t i = 0; i < num_runs; ++i) {
+    sum = crc(sum, buffer);
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - start_time;
+  // Keep the result used so that the loop isn't optimized away.
+  debug::Alias(&sum);
+
+  // Bytes per microsecond are MB/s.
+  reporter.AddResult(kMetricThroughput,
+                     len * num_runs / elapsed.InMicrosecondsF());
+}
+
+}  // namespace
+
+TEST(Crc32PerfTest, Crc32) {
+  for (size_t len : {64u, 4096u, 1u << 20}) {
+    RunCrcPerfTest("Crc32", &Crc32, len);
+  }
+}
+
+TEST(Crc32PerfTest, Crc32c) {
+  for (size_t len : {64u, 4096u, 1u << 20}) {
+    RunCrcPerfTest("Crc32c", &Crc32c, len);
+  }
+}
+
+}  // namespace base
@@ -11,6 +11,8 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include "base/containers/span.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -38,4 +40,47 @@ TEST(Crc32Test, ZeroTest) {
   EXPECT_EQ(0U, Crc32(0, empty_data));
 }
 
+// The standard check values of CRC-32 and CRC-32C, which invert the checksum
+// before and after.
+TEST(Crc32Test, CheckValues) {
+  const span<const uint8_t> data = as_byte_span("123456789").first(9u);
+  EXPECT_EQ(0xCBF43926u, ~Crc32(0xFFFFFFFF, data));
+  EXPECT_EQ(0xE3069283u, ~Crc32c(0xFFFFFFFF, data));
+}
+
+// All lengths and alignments must give the same checksum as a byte-at-a-time
+// computation, since checksums are persisted.
+TEST(Crc32Test, MatchesByteAtATime) {
+  std::vector<uint8_t> buffer(300);
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<uint8_t>(i * 131 + 7);
+  }
+  for (size_t offset = 0; offset < 16; ++offset) {
+    for (size_t size = 0; offset + size <= buffer.size(); size += 7) {
+      const span<const uint8_t> data = span(buffer).subspan(offset, size);
+      uint32_t crc32 = 0x12345678;
+      uint32_t crc32c = 0x12345678;
+      for (uint8_t byte : data) {
+        crc32 = kCrcTable[(crc32 & 0xFF) ^ byte] ^ (crc32 >> 8);
+        crc32c ^= byte;
+        for (int j = 0; j < 8; ++j) {
+          crc32c = (crc32c >> 1) ^ ((crc32c & 1) ? 0x82F63B78 : 0);
+        }
+      }
+      EXPECT_EQ(crc32, Crc32(0x12345678, data));
+      EXPECT_EQ(crc32c, Crc32c(0x12345678, data));
+    }
+  }
+}
+
+// The checksum of data can be computed in several parts.
+TEST(Crc32Test, Continuation) {
+  std::vector<uint8_t> buffer(100, 42);
+  const span<const uint8_t> data(buffer);
+  EXPECT_EQ(Crc32(1, data),
+            Crc32(Crc32(1, data.first(13u)), data.subspan(13u)));
+  EXPECT_EQ(Crc32c(1, data),
+            Crc32c(Crc32c(1, data.first(13u)), data.subspan(13u)));
+}
+
 }  // namespace base
@@ -37,6 +37,7 @@ bool FieldTrialParamAssociator::AssociateFieldTrialParams(
   }
 
   field_trial_params_[key] = params;
+  internal::FeatureParamCache::InvalidateAll();
   return true;
 }
 
@@ -75,6 +76,7 @@ void FieldTrialParamAssociator::ClearAllParamsForTesting() {
     field_trial_params_.clear();
   }
   FieldTrialList::ClearParamsFromSharedMemoryForTesting();
+  internal::FeatureParamCache::InvalidateAll();
 }
 
 void FieldTrialParamAssociator::ClearParamsForTesting(
@@ -83,17 +85,20 @@ void FieldTrialParamAssociator::ClearParamsForTesting(
   AutoLock scoped_lock(lock_);
   const FieldTrialRefKey key(trial_name, group_name);
   field_trial_params_.erase(key);
+  internal::FeatureParamCache::InvalidateAll();
 }
 
 void FieldTrialParamAssociator::ClearAllCachedParamsForTesting() {
   AutoLock scoped_lock(lock_);
   field_trial_params_.clear();
+  internal::FeatureParamCache::InvalidateAll();
 }
 
 void FieldTrialParamAssociator::ClearAllCachedParams(
     PassKey<AppShimController>) {
   AutoLock scoped_lock(lock_);
   field_trial_params_.clear();
+  internal::FeatureParamCache::InvalidateAll();
 }
 
 }  // namespace base
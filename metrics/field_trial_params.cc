@@ -4,6 +4,7 @@
 
 #include "base/metrics/field_trial_params.h"
 
+#include <atomic>
 #include <optional>
 #include <set>
 #include <string_view>
@@ -17,15 +18,65 @@
 #include "base/metrics/field_trial_param_associator.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/metrics_hashes.h"
+#include "base/no_destructor.h"
 #include "base/notreached.h"
 #include "base/strings/escape.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "base/time/time_delta_from_string.h"
 
 namespace base {
 
+namespace {
+
+// The generation of field trial state which cached FeatureParam values are
+// valid for. Starts at 1, see FeatureParamCache::stamp_.
+std::atomic<uint32_t> g_feature_param_generation{1};
+
+// Serializes the writes of FeatureParamCache, so that a value and its
+// generation are never mixed with those of another writer.
+Lock& GetFeatureParamCacheLock() {
+  static NoDestructor<Lock> lock;
+  return *lock;
+}
+
+}  // namespace
+
+namespace internal {
+
+// static
+void FeatureParamCache::InvalidateAll() {
+  g_feature_param_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+// static
+uint32_t FeatureParamCache::GetGeneration() {
+  return g_feature_param_generation.load(std::memory_order_acquire);
+}
+
+bool FeatureParamCache::Load(uint64_t& bits) const {
+  const uint32_t stamp = stamp_.load(std::memory_order_acquire);
+  if (stamp != GetGeneration() * 2) {
+    return false;
+  }
+  bits = bits_.load(std::memory_order_relaxed);
+  // Check that `bits_` wasn't being rewritten meanwhile.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return stamp_.load(std::memory_order_relaxed) == stamp;
+}
+
+void FeatureParamCache::Store(uint32_t generation, uint64_t bits) const {
+  AutoLock lock(GetFeatureParamCacheLock());
+  stamp_.store(generation * 2 + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  bits_.store(bits, std::memory_order_relaxed);
+  stamp_.store(generation * 2, std::memory_order_release);
+}
+
+}  // namespace internal
+
 void LogInvalidValue(const Feature& feature,
                      const char* type,
                      const std::string& param_name,
@@ -239,19 +290,28 @@ std::string FeatureParam<std::string>::Get() const {
 }
 
 double FeatureParam<double>::Get() const {
-  return GetFieldTrialParamByFeatureAsDouble(*feature, name, default_value);
+  return cache.Get<double>([this] {
+    return GetFieldTrialParamByFeatureAsDouble(*feature, name, default_value);
+  });
 }
 
 int FeatureParam<int>::Get() const {
-  return GetFieldTrialParamByFeatureAsInt(*feature, name, default_value);
+  return cache.Get<int>([this] {
+    return GetFieldTrialParamByFeatureAsInt(*feature, name, default_value);
+  });
 }
 
 bool FeatureParam<bool>::Get() const {
-  return GetFieldTrialParamByFeatureAsBool(*feature, name, default_value);
+  return cache.Get<bool>([this] {
+    return GetFieldTrialParamByFeatureAsBool(*feature, name, default_value);
+  });
 }
 
 base::TimeDelta FeatureParam<base::TimeDelta>::Get() const {
-  return GetFieldTrialParamByFeatureAsTimeDelta(*feature, name, default_value);
+  return cache.Get<base::TimeDelta>([this] {
+    return GetFieldTrialParamByFeatureAsTimeDelta(*feature, name,
+                                                  default_value);
+  });
 }
 
 void LogInvalidEnumValue(const Feature& feature,
@@ -10,10 +10,16 @@
 #ifndef BASE_METRICS_FIELD_TRIAL_PARAMS_H_
 #define BASE_METRICS_FIELD_TRIAL_PARAMS_H_
 
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
 #include <map>
 #include <string>
+#include <type_traits>
 
 #include "base/base_export.h"
+#include "base/compiler_specific.h"
 #include "base/feature_list.h"
 #include "base/logging.h"
 #include "base/memory/raw_ptr_exclusion.h"
@@ -123,6 +129,62 @@ BASE_EXPORT base::TimeDelta GetFieldTrialParamByFeatureAsTimeDelta(
     const std::string& param_name,
     base::TimeDelta default_value);
 
+namespace internal {
+
+// Caches the value of a FeatureParam<T>, so that Get() doesn't take
+// FieldTrialParamAssociator's lock, copy the params of the field trial and
+// parse the value on every call. A cached value is tagged with the generation
+// of field trial state it was looked up in, and ignored once that state
+// changes, e.g. when params are associated or the FeatureList is replaced.
+// Reads don't take locks: the value and its tag are read like a seqlock.
+class BASE_EXPORT LOGICALLY_CONST FeatureParamCache {
+ public:
+  constexpr FeatureParamCache() = default;
+  FeatureParamCache(const FeatureParamCache&) = delete;
+  FeatureParamCache& operator=(const FeatureParamCache&) = delete;
+
+  // Invalidates the values cached by all FeatureParams. Must be called
+  // whenever field trial params, or the field trials associated with
+  // features, change.
+  static void InvalidateAll();
+
+  // Returns the cached value if it is still valid. Otherwise, returns the
+  // value looked up by `look_up` and caches it.
+  template <typename T, typename LookUp>
+  T Get(LookUp look_up) const {
+    static_assert(std::is_trivially_copyable_v<T> &&
+                  sizeof(T) <= sizeof(uint64_t));
+    uint64_t bits = 0;
+    T value;
+    if (Load(bits)) {
+      memcpy(&value, &bits, sizeof(T));
+      return value;
+    }
+    // Read the generation before looking up the value, so that a concurrent
+    // change makes the cached value stale.
+    const uint32_t generation = GetGeneration();
+    value = look_up();
+    memcpy(&bits, &value, sizeof(T));
+    Store(generation, bits);
+    return value;
+  }
+
+ private:
+  static uint32_t GetGeneration();
+
+  // Sets `bits` to the cached value and returns true if it is valid for the
+  // current generation.
+  bool Load(uint64_t& bits) const;
+  void Store(uint32_t generation, uint64_t bits) const;
+
+  // Twice the generation `bits_` was looked up in, plus one while `bits_` is
+  // being written. Generations start at 1, so 0 means nothing is cached.
+  mutable std::atomic<uint32_t> stamp_{0};
+  mutable std::atomic<uint64_t> bits_{0};
+};
+
+}  // namespace internal
+
 // Shared declaration for various FeatureParam<T> types.
 //
 // This template is defined for the following types T:
@@ -138,6 +200,8 @@ BASE_EXPORT base::TimeDelta GetFieldTrialParamByFeatureAsTimeDelta(
 //
 // Getting a param value from a FeatureParam<T> will have the same semantics as
 // GetFieldTrialParamValueByFeature(), see that function's comments for details.
+// Except for std::string, the value is cached in the FeatureParam, so that
+// getting it again is cheap until field trial params or the FeatureList change.
 template <typename T, bool IsEnum = std::is_enum_v<T>>
 struct FeatureParam {
   // Prevent use of FeatureParam<> with unsupported types (e.g. void*). Uses T
@@ -194,6 +258,7 @@ struct FeatureParam<double> {
   RAW_PTR_EXCLUSION const Feature* const feature;
   const char* const name;
   const double default_value;
+  internal::FeatureParamCache cache;
 };
 
 // Declares an int-valued parameter. Example:
@@ -219,6 +284,7 @@ struct FeatureParam<int> {
   RAW_PTR_EXCLUSION const Feature* const feature;
   const char* const name;
   const int default_value;
+  internal::FeatureParamCache cache;
 };
 
 // Declares a bool-valued parameter. Example:
@@ -244,6 +310,7 @@ struct FeatureParam<bool> {
   RAW_PTR_EXCLUSION const Feature* const feature;
   const char* const name;
   const bool default_value;
+  internal::FeatureParamCache cache;
 };
 
 // Declares an TimeDelta-valued parameter. Example:
@@ -270,6 +337,7 @@ struct FeatureParam<base::TimeDelta> {
   RAW_PTR_EXCLUSION const Feature* const feature;
   const char* const name;
   const base::TimeDelta default_value;
+  internal::FeatureParamCache cache;
 };
 
 BASE_EXPORT void LogInvalidEnumValue(const Feature& feature,
@@ -315,15 +383,7 @@ struct FeatureParam<Enum, true> {
   // Calling Get() will activate the field trial associated with |feature|. See
   // GetFieldTrialParamValueByFeature() for more details.
   Enum Get() const {
-    std::string value = GetFieldTrialParamValueByFeature(*feature, name);
-    if (value.empty())
-      return default_value;
-    for (size_t i = 0; i < option_count; ++i) {
-      if (value == options[i].name)
-        return options[i].value;
-    }
-    LogInvalidEnumValue(*feature, name, value, static_cast<int>(default_value));
-    return default_value;
+    return cache.Get<Enum>([this] { return GetWithoutCache(); });
   }
 
   // Returns the param-string for the given enum value.
@@ -345,6 +405,20 @@ struct FeatureParam<Enum, true> {
   // #global-scope, #constexpr-ctor-field-initializer
   RAW_PTR_EXCLUSION const Option* const options;
   const size_t option_count;
+  internal::FeatureParamCache cache;
+
+ private:
+  Enum GetWithoutCache() const {
+    std::string value = GetFieldTrialParamValueByFeature(*feature, name);
+    if (value.empty())
+      return default_value;
+    for (size_t i = 0; i < option_count; ++i) {
+      if (value == options[i].name)
+        return options[i].value;
+    }
+    LogInvalidEnumValue(*feature, name, value, static_cast<int>(default_value));
+    return default_value;
+  }
 };
 
 }  // namespace base
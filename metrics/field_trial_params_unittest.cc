@@ -310,6 +310,27 @@ TEST_F(FieldTrialParamsTest, FeatureParamInt_Disable) {
   EXPECT_EQ(123, a.Get());
 }
 
+TEST_F(FieldTrialParamsTest, FeatureParamInt_CachedUntilParamsChange) {
+  static BASE_FEATURE(kFeature, "TestFeature", FEATURE_DISABLED_BY_DEFAULT);
+  static const FeatureParam<int> a{&kFeature, "a", 123};
+  EXPECT_EQ(123, a.Get());
+  EXPECT_EQ(123, a.Get());
+
+  // Replacing the FeatureList invalidates the cached value.
+  const std::string kTrialName = "FeatureParamInt_CachedUntilParamsChange";
+  AssociateFieldTrialParams(kTrialName, "A", {{"a", "1"}});
+  scoped_refptr<FieldTrial> trial(CreateFieldTrial(kTrialName, 100, "A"));
+  CreateFeatureWithTrial(kFeature, FeatureList::OVERRIDE_ENABLE_FEATURE,
+                         trial.get());
+  EXPECT_EQ(1, a.Get());
+  EXPECT_EQ(1, a.Get());
+
+  // So does changing the params.
+  FieldTrialParamAssociator::GetInstance()->ClearParamsForTesting(kTrialName,
+                                                                  "A");
+  EXPECT_EQ(123, a.Get());
+}
+
 TEST_F(FieldTrialParamsTest, FeatureParamDouble) {
   const std::string kTrialName = "GetFieldTrialParamsByFeature";
 
@@ -14,6 +14,7 @@
 #include <math.h>
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -34,17 +35,37 @@
 #include "base/metrics/statistics_recorder.h"
 #include "base/notreached.h"
 #include "base/pickle.h"
+#include "base/rand_util.h"
 #include "base/ranges/algorithm.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "build/build_config.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
 
 namespace base {
 
 namespace {
 
+// The number of shards of histograms with kShardedSamplesFlag. Threads are
+// assigned shards round-robin.
+constexpr size_t kNumSampleShards = 16;
+
+std::atomic<size_t> g_next_sample_shard_index{0};
+
+// The shard of the current thread, or kNumSampleShards until it's assigned.
+ABSL_CONST_INIT thread_local size_t g_sample_shard_index = kNumSampleShards;
+
+size_t GetSampleShardIndex() {
+  if (UNLIKELY(g_sample_shard_index == kNumSampleShards)) {
+    g_sample_shard_index =
+        g_next_sample_shard_index.fetch_add(1, std::memory_order_relaxed) %
+        kNumSampleShards;
+  }
+  return g_sample_shard_index;
+}
+
 bool ReadHistogramArguments(PickleIterator* iter,
                             std::string* histogram_name,
                             int* flags,
@@ -205,6 +226,10 @@ HistogramBase* Histogram::Factory::Build() {
       flags_ &= ~HistogramBase::kIsPersistent;
       tentative_histogram = HeapAlloc(registered_ranges);
       tentative_histogram->SetFlags(flags_);
+      if (flags_ & HistogramBase::kShardedSamplesFlag) {
+        static_cast<Histogram*>(tentative_histogram.get())
+            ->CreateSampleShards();
+      }
     }
 
     FillHistogram(tentative_histogram.get());
@@ -503,7 +528,11 @@ void Histogram::AddCount(int value, int count) {
     NOTREACHED_IN_MIGRATION();
     return;
   }
-  unlogged_samples_->Accumulate(value, count);
+  if (!sample_shards_.empty()) {
+    sample_shards_[GetSampleShardIndex()]->Accumulate(value, count);
+  } else {
+    unlogged_samples_->Accumulate(value, count);
+  }
 
   if (UNLIKELY(StatisticsRecorder::have_active_callbacks()))
     FindAndRunCallbacks(value);
@@ -545,6 +574,7 @@ std::unique_ptr<HistogramSamples> Histogram::SnapshotDelta() {
   // vector: this way, the next snapshot will include any concurrent updates
   // missed by the current snapshot.
 
+  FoldSampleShards();
   std::unique_ptr<HistogramSamples> snapshot =
       std::make_unique<SampleVector>(unlogged_samples_->id(), bucket_ranges());
   snapshot->Extract(*unlogged_samples_);
@@ -697,12 +727,31 @@ std::unique_ptr<SampleVector> Histogram::SnapshotAllSamples() const {
 }
 
 std::unique_ptr<SampleVector> Histogram::SnapshotUnloggedSamplesImpl() const {
+  FoldSampleShards();
   std::unique_ptr<SampleVector> samples(
       new SampleVector(unlogged_samples_->id(), bucket_ranges()));
   samples->Add(*unlogged_samples_);
   return samples;
 }
 
+void Histogram::CreateSampleShards() {
+  DCHECK(sample_shards_.empty());
+  DCHECK_EQ(0, unlogged_samples_->TotalCount());
+  sample_shards_.reserve(kNumSampleShards);
+  for (size_t i = 0; i < kNumSampleShards; ++i) {
+    sample_shards_.push_back(std::make_unique<SampleVector>(
+        unlogged_samples_->id(), bucket_ranges()));
+  }
+}
+
+void Histogram::FoldSampleShards() const {
+  // Extracting samples is safe while other threads record into the shards:
+  // samples recorded concurrently are either moved now, or at the next fold.
+  for (const auto& shard : sample_shards_) {
+    unlogged_samples_->Extract(*shard);
+  }
+}
+
 Value::Dict Histogram::GetParameters() const {
   Value::Dict params;
   params.Set("type", HistogramTypeToString(GetHistogramType()));
@@ -1281,4 +1330,278 @@ bool CustomHistogram::ValidateCustomRanges(
   return has_valid_range;
 }
 
+//------------------------------------------------------------------------------
+// QuantileSketchHistogram: This histogram uses log-linear buckets which bound
+// the relative error of estimated quantiles.
+//------------------------------------------------------------------------------
+
+class QuantileSketchHistogram::Factory : public Histogram::Factory {
+ public:
+  Factory(std::string_view name, Sample maximum, int precision, int32_t flags)
+      : Histogram::Factory(
+            name,
+            QUANTILE_SKETCH_HISTOGRAM,
+            1,
+            GetBucketLowerBound(GetBucketCount(maximum, precision) - 1,
+                                precision),
+            GetBucketCount(maximum, precision),
+            flags),
+        precision_(precision) {}
+
+  Factory(const Factory&) = delete;
+  Factory& operator=(const Factory&) = delete;
+
+ protected:
+  BucketRanges* CreateRanges() override {
+    BucketRanges* ranges = new BucketRanges(bucket_count_ + 1);
+    QuantileSketchHistogram::InitializeBucketRanges(precision_, ranges);
+    return ranges;
+  }
+
+  std::unique_ptr<HistogramBase> HeapAlloc(
+      const BucketRanges* ranges) override {
+    return WrapUnique(
+        new QuantileSketchHistogram(GetPermanentName(name_), ranges));
+  }
+
+ private:
+  const int precision_;
+};
+
+QuantileSketchHistogram::~QuantileSketchHistogram() = default;
+
+HistogramBase* QuantileSketchHistogram::FactoryGet(const std::string& name,
+                                                   Sample maximum,
+                                                   double relative_accuracy,
+                                                   int32_t flags) {
+  return FactoryGetInternal(name, maximum, relative_accuracy, flags);
+}
+
+HistogramBase* QuantileSketchHistogram::FactoryGet(const char* name,
+                                                   Sample maximum,
+                                                   double relative_accuracy,
+                                                   int32_t flags) {
+  return FactoryGetInternal(name, maximum, relative_accuracy, flags);
+}
+
+std::unique_ptr<HistogramBase> QuantileSketchHistogram::PersistentCreate(
+    const char* name,
+    const BucketRanges* ranges,
+    const DelayedPersistentAllocation& counts,
+    const DelayedPersistentAllocation& logged_counts,
+    HistogramSamples::Metadata* meta,
+    HistogramSamples::Metadata* logged_meta) {
+  return WrapUnique(new QuantileSketchHistogram(name, ranges, counts,
+                                                logged_counts, meta,
+                                                logged_meta));
+}
+
+double QuantileSketchHistogram::GetQuantile(double quantile) const {
+  return EstimateQuantile(*SnapshotSamples(), quantile);
+}
+
+// static
+double QuantileSketchHistogram::EstimateQuantile(
+    const HistogramSamples& samples,
+    double quantile) {
+  DCHECK_GE(quantile, 0.0);
+  DCHECK_LE(quantile, 1.0);
+  const int64_t total_count = samples.TotalCount();
+  if (total_count <= 0) {
+    return 0.0;
+  }
+  // The rank of the sample at |quantile|, starting from 1.
+  const int64_t rank = std::clamp<int64_t>(
+      static_cast<int64_t>(ceil(quantile * total_count)), 1, total_count);
+
+  int64_t cumulative_count = 0;
+  Sample min = 0;
+  for (std::unique_ptr<SampleCountIterator> it = samples.Iterator();
+       !it->Done(); it->Next()) {
+    int64_t max;
+    Count count;
+    it->Get(&min, &max, &count);
+    cumulative_count += count;
+    if (cumulative_count >= rank) {
+      if (max >= kSampleType_MAX) {
+        return min;
+      }
+      // The middle of the integers in [min, max).
+      return (min + max - 1) / 2.0;
+    }
+  }
+  // Only reached if the counts changed concurrently.
+  return min;
+}
+
+// static
+int QuantileSketchHistogram::GetPrecisionForRelativeAccuracy(
+    double relative_accuracy) {
+  // Estimates are in the middle of buckets, whose width is at most
+  // 2^-precision of their lower bound.
+  int precision = kMinPrecision;
+  while (precision < kMaxPrecision &&
+         ldexp(1.0, -(precision + 1)) > relative_accuracy) {
+    ++precision;
+  }
+  return precision;
+}
+
+// static
+size_t QuantileSketchHistogram::GetBucketCount(Sample maximum,
+                                               int precision) {
+  DCHECK_GE(precision, kMinPrecision);
+  DCHECK_LE(precision, kMaxPrecision);
+  maximum = std::clamp<Sample>(maximum, 2, kMaxMaximum);
+  // The buckets up to the one with |maximum| - 1, plus the overflow bucket.
+  return BucketRanges::GetLogLinearBucketIndex(maximum - 1, precision) + 2;
+}
+
+// static
+HistogramBase::Sample QuantileSketchHistogram::GetBucketLowerBound(
+    size_t index,
+    int precision) {
+  const size_t unit_buckets = size_t{2} << precision;
+  if (index <= unit_buckets) {
+    return static_cast<Sample>(index);
+  }
+  const size_t log_linear_index = index - unit_buckets;
+  const int exponent =
+      precision + 1 + static_cast<int>(log_linear_index >> precision);
+  const size_t sub_bucket = log_linear_index & ((size_t{1} << precision) - 1);
+  DCHECK_LE(exponent, 30);
+  return static_cast<Sample>((size_t{1} << exponent) +
+                             (sub_bucket << (exponent - precision)));
+}
+
+// static
+void QuantileSketchHistogram::InitializeBucketRanges(int precision,
+                                                     BucketRanges* ranges) {
+  const size_t bucket_count = ranges->bucket_count();
+  for (size_t i = 0; i < bucket_count; ++i) {
+    ranges->set_range(i, GetBucketLowerBound(i, precision));
+  }
+  ranges->set_range(bucket_count, HistogramBase::kSampleType_MAX);
+  ranges->ResetChecksum();
+}
+
+HistogramType QuantileSketchHistogram::GetHistogramType() const {
+  return QUANTILE_SKETCH_HISTOGRAM;
+}
+
+QuantileSketchHistogram::QuantileSketchHistogram(const char* name,
+                                                 const BucketRanges* ranges)
+    : Histogram(name, ranges), precision_(VerifyBucketRanges(ranges)) {}
+
+QuantileSketchHistogram::QuantileSketchHistogram(
+    const char* name,
+    const BucketRanges* ranges,
+    const DelayedPersistentAllocation& counts,
+    const DelayedPersistentAllocation& logged_counts,
+    HistogramSamples::Metadata* meta,
+    HistogramSamples::Metadata* logged_meta)
+    : Histogram(name, ranges, counts, logged_counts, meta, logged_meta),
+      precision_(VerifyBucketRanges(ranges)) {}
+
+// static
+HistogramBase* QuantileSketchHistogram::DeserializeInfoImpl(
+    PickleIterator* iter) {
+  std::string histogram_name;
+  int flags;
+  int declared_min;
+  int declared_max;
+  size_t bucket_count;
+  uint32_t range_checksum;
+
+  if (!ReadHistogramArguments(iter, &histogram_name, &flags, &declared_min,
+                              &declared_max, &bucket_count, &range_checksum)) {
+    return nullptr;
+  }
+
+  // The precision isn't serialized, but it's the only one for which the
+  // layout has |bucket_count| buckets up to |declared_max|.
+  for (int precision = kMinPrecision; precision <= kMaxPrecision;
+       ++precision) {
+    if (GetBucketCount(declared_max, precision) != bucket_count ||
+        GetBucketLowerBound(bucket_count - 1, precision) != declared_max) {
+      continue;
+    }
+    HistogramBase* histogram =
+        Factory(histogram_name, declared_max, precision, flags).Build();
+    if (!ValidateRangeChecksum(*histogram, range_checksum)) {
+      // The serialized histogram might be corrupted.
+      return nullptr;
+    }
+    return histogram;
+  }
+  return nullptr;
+}
+
+// static
+HistogramBase* QuantileSketchHistogram::FactoryGetInternal(
+    std::string_view name,
+    Sample maximum,
+    double relative_accuracy,
+    int32_t flags) {
+  if (maximum < 2 || maximum > kMaxMaximum) {
+    DLOG(ERROR) << "Histogram: " << name << " has bad maximum: " << maximum;
+    maximum = std::clamp<Sample>(maximum, 2, kMaxMaximum);
+  }
+  // Keep the memory used bounded like for other histograms, at the cost of
+  // accuracy.
+  int precision = GetPrecisionForRelativeAccuracy(relative_accuracy);
+  while (precision > kMinPrecision &&
+         GetBucketCount(maximum, precision) > kBucketCount_MAX) {
+    --precision;
+  }
+  return Factory(name, maximum, precision, flags).Build();
+}
+
+// static
+int QuantileSketchHistogram::VerifyBucketRanges(const BucketRanges* ranges) {
+  if (const int precision = ranges->log_linear_precision()) {
+    return precision;
+  }
+  const size_t bucket_count = ranges->bucket_count();
+  for (int precision = kMinPrecision; precision <= kMaxPrecision;
+       ++precision) {
+    const Sample maximum = ranges->range(bucket_count - 1);
+    if (GetBucketCount(maximum, precision) != bucket_count ||
+        ranges->range(bucket_count) != kSampleType_MAX) {
+      continue;
+    }
+    bool matches = true;
+    for (size_t i = 0; i < bucket_count && matches; ++i) {
+      matches = ranges->range(i) == GetBucketLowerBound(i, precision);
+    }
+    if (matches) {
+      ranges->set_log_linear_precision(precision);
+      return precision;
+    }
+  }
+  return 0;
+}
+
+namespace internal {
+
+bool ShouldRecordSampledHistogramSlow(uint32_t* calls_until_sample,
+                                      uint32_t sampling_interval) {
+  // Each thread has its own generator, so that sampling doesn't need any
+  // synchronization.
+  static thread_local MetricsSubSampler sub_sampler;
+  const double probability = 1.0 / sampling_interval;
+  if (*calls_until_sample == 0) {
+    // This is the first call of the call site on this thread.
+    *calls_until_sample = sub_sampler.GetCallsUntilNextSample(probability);
+  }
+  if (*calls_until_sample > 1) {
+    --*calls_until_sample;
+    return false;
+  }
+  *calls_until_sample = sub_sampler.GetCallsUntilNextSample(probability);
+  return true;
+}
+
+}  // namespace internal
+
 }  // namespace base
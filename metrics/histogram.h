@@ -303,12 +303,23 @@ class BASE_EXPORT Histogram : public HistogramBase {
   // |params|.
   Value::Dict GetParameters() const override;
 
+  // Makes samples accumulate in |sample_shards_|. Must be called before
+  // recording any sample.
+  void CreateSampleShards();
+
+  // Moves the samples accumulated in |sample_shards_| to |unlogged_samples_|.
+  void FoldSampleShards() const;
+
   // Samples that have not yet been logged with SnapshotDelta().
   std::unique_ptr<SampleVectorBase> unlogged_samples_;
 
   // Accumulation of all samples that have been logged with SnapshotDelta().
   std::unique_ptr<SampleVectorBase> logged_samples_;
 
+  // Samples recorded on each thread, folded into |unlogged_samples_| when
+  // snapshotted, if kShardedSamplesFlag is set. Otherwise empty.
+  std::vector<std::unique_ptr<SampleVector>> sample_shards_;
+
 #if DCHECK_IS_ON()  // Don't waste memory if it won't be used.
   // Flag to indicate if PrepareFinalDelta has been previously called. It is
   // used to DCHECK that a final delta is not created multiple times.
@@ -602,6 +613,120 @@ class BASE_EXPORT CustomHistogram : public Histogram {
   static bool ValidateCustomRanges(const std::vector<Sample>& custom_ranges);
 };
 
+//------------------------------------------------------------------------------
+
+// QuantileSketchHistogram is a histogram whose buckets bound the relative error
+// of the quantiles estimated from its samples, like a DDSketch or an HDR
+// histogram, e.g. to track the p99.9 latency of an operation. Its log-linear
+// buckets have a width of at most 2^-precision of their lower bound: samples
+// below 2^(precision+1) are counted exactly, and each power of 2 above is
+// split into 2^precision buckets. The bucket of a sample is computed in
+// constant time.
+//
+// Like other Histograms, it uses a fixed amount of memory, can be allocated in
+// persistent memory, and its deltas can be merged across processes. Unlike
+// SparseHistogram, the number of buckets is bounded by kBucketCount_MAX: the
+// precision is lowered if needed to cover [0, maximum] with that many buckets.
+class BASE_EXPORT QuantileSketchHistogram : public Histogram {
+ public:
+  static constexpr int kMinPrecision = 1;
+  static constexpr int kMaxPrecision = 8;
+
+  // The largest supported |maximum|.
+  static constexpr Sample kMaxMaximum = 1 << 30;
+
+  // Samples in [0, |maximum|) are counted with a relative error of at most
+  // |relative_accuracy|, e.g. 0.01, or the closest supported accuracy.
+  static HistogramBase* FactoryGet(const std::string& name,
+                                   Sample maximum,
+                                   double relative_accuracy,
+                                   int32_t flags);
+
+  // Overload of the above function that takes a const char* |name| param,
+  // to avoid code bloat from the std::string constructor being inlined into
+  // call sites.
+  static HistogramBase* FactoryGet(const char* name,
+                                   Sample maximum,
+                                   double relative_accuracy,
+                                   int32_t flags);
+
+  QuantileSketchHistogram(const QuantileSketchHistogram&) = delete;
+  QuantileSketchHistogram& operator=(const QuantileSketchHistogram&) = delete;
+
+  ~QuantileSketchHistogram() override;
+
+  // Create a histogram using data in persistent storage.
+  static std::unique_ptr<HistogramBase> PersistentCreate(
+      const char* name,
+      const BucketRanges* ranges,
+      const DelayedPersistentAllocation& counts,
+      const DelayedPersistentAllocation& logged_counts,
+      HistogramSamples::Metadata* meta,
+      HistogramSamples::Metadata* logged_meta);
+
+  // Returns the precision of the buckets, which bounds the relative error of
+  // the estimated quantiles to 2^-(precision+1) for samples below the
+  // overflow bucket.
+  int precision() const { return precision_; }
+
+  // Returns the estimated value of |quantile|, in [0, 1], of all the samples
+  // recorded, or 0 if there are none.
+  double GetQuantile(double quantile) const;
+
+  // Returns the estimated value of |quantile|, in [0, 1], of |samples| of a
+  // QuantileSketchHistogram, e.g. deltas merged from several processes.
+  // Samples in a bucket are estimated to be in its middle, and the ones in the
+  // overflow bucket to be its lower bound. Returns 0 if there are no samples.
+  static double EstimateQuantile(const HistogramSamples& samples,
+                                 double quantile);
+
+  // Returns the precision of the buckets for |relative_accuracy|.
+  static int GetPrecisionForRelativeAccuracy(double relative_accuracy);
+
+  // Returns the number of buckets, including the underflow and overflow ones,
+  // needed to cover [0, |maximum|) with |precision|.
+  static size_t GetBucketCount(Sample maximum, int precision);
+
+  // Returns the lower bound of the bucket at |index| in the layout of
+  // |precision|.
+  static Sample GetBucketLowerBound(size_t index, int precision);
+
+  // Initializes |ranges| to the layout of |precision|, up to an overflow
+  // bucket. |ranges| must have one more range than the number of buckets.
+  static void InitializeBucketRanges(int precision, BucketRanges* ranges);
+
+  // Overridden from Histogram:
+  HistogramType GetHistogramType() const override;
+
+ protected:
+  class Factory;
+
+  QuantileSketchHistogram(const char* name, const BucketRanges* ranges);
+
+  QuantileSketchHistogram(const char* name,
+                          const BucketRanges* ranges,
+                          const DelayedPersistentAllocation& counts,
+                          const DelayedPersistentAllocation& logged_counts,
+                          HistogramSamples::Metadata* meta,
+                          HistogramSamples::Metadata* logged_meta);
+
+ private:
+  friend BASE_EXPORT HistogramBase* DeserializeHistogramInfo(
+      base::PickleIterator* iter);
+  static HistogramBase* DeserializeInfoImpl(base::PickleIterator* iter);
+
+  static HistogramBase* FactoryGetInternal(std::string_view name,
+                                           Sample maximum,
+                                           double relative_accuracy,
+                                           int32_t flags);
+
+  // Returns the precision of the layout of |ranges|, or 0 if they don't have
+  // one. Marks |ranges| with it, so that samples are bucketed directly.
+  static int VerifyBucketRanges(const BucketRanges* ranges);
+
+  const int precision_;
+};
+
 }  // namespace base
 
 #endif  // BASE_METRICS_HISTOGRAM_H_
@@ -44,6 +44,8 @@ std::string HistogramTypeToString(HistogramType type) {
       return "SPARSE_HISTOGRAM";
     case DUMMY_HISTOGRAM:
       return "DUMMY_HISTOGRAM";
+    case QUANTILE_SKETCH_HISTOGRAM:
+      return "QUANTILE_SKETCH_HISTOGRAM";
   }
   NOTREACHED_IN_MIGRATION();
   return "UNKNOWN";
@@ -65,6 +67,8 @@ HistogramBase* DeserializeHistogramInfo(PickleIterator* iter) {
       return CustomHistogram::DeserializeInfoImpl(iter);
     case SPARSE_HISTOGRAM:
       return SparseHistogram::DeserializeInfoImpl(iter);
+    case QUANTILE_SKETCH_HISTOGRAM:
+      return QuantileSketchHistogram::DeserializeInfoImpl(iter);
     default:
       return nullptr;
   }
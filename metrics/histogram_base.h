@@ -39,6 +39,7 @@ enum HistogramType {
   CUSTOM_HISTOGRAM,
   SPARSE_HISTOGRAM,
   DUMMY_HISTOGRAM,
+  QUANTILE_SKETCH_HISTOGRAM,
 };
 
 // Controls the verbosity of the information when the histogram is serialized to
@@ -130,6 +131,13 @@ class BASE_EXPORT HistogramBase {
     // MemoryAllocator, and that loaded into the Histogram module before this
     // histogram is created.
     kIsPersistent = 0x40,
+
+    // Indicates that samples are accumulated in per-thread shards, which are
+    // folded into the histogram when it's snapshotted. This avoids contention
+    // on hot histograms recorded from many threads, at the cost of memory.
+    // Only supported by Histogram and its subclasses, and ignored for
+    // persistent histograms.
+    kShardedSamplesFlag = 0x80,
   };
 
   // Histogram data inconsistency types.
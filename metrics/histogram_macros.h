@@ -338,6 +338,80 @@ enum class ScopedHistogramTiming {
     UMA_HISTOGRAM_CUSTOM_COUNTS(name, sample, 1, 64000, 100)
 
 
+//------------------------------------------------------------------------------
+// Sharded histograms.
+
+// Same as the non-sharded equivalents, but samples are accumulated in
+// per-thread shards that are folded into the histogram when it's snapshotted.
+// Use these for hot histograms recorded concurrently from many threads, where
+// contention on the shared counters is measurable. Each shard has its own
+// counts, so these use more memory.
+// All of these macros must be called with |name| as a runtime constant.
+
+// Sample usage:
+//   UMA_HISTOGRAM_SHARDED_CUSTOM_COUNTS("My.Histogram", sample, 1, 1000000,
+//                                       50);
+#define UMA_HISTOGRAM_SHARDED_CUSTOM_COUNTS(name, sample, min, exclusive_max, \
+                                            bucket_count)                     \
+  INTERNAL_HISTOGRAM_CUSTOM_COUNTS_WITH_FLAG(                                 \
+      name, sample, min, exclusive_max, bucket_count,                         \
+      base::HistogramBase::kUmaTargetedHistogramFlag |                        \
+          base::HistogramBase::kShardedSamplesFlag)
+
+#define UMA_HISTOGRAM_SHARDED_CUSTOM_TIMES(name, sample, min, max, \
+                                           bucket_count)           \
+  STATIC_HISTOGRAM_POINTER_BLOCK(                                  \
+      name, AddTimeMillisecondsGranularity(sample),                \
+      base::Histogram::FactoryTimeGet(                             \
+          name, min, max, bucket_count,                            \
+          base::HistogramBase::kUmaTargetedHistogramFlag |         \
+              base::HistogramBase::kShardedSamplesFlag))
+
+#define UMA_HISTOGRAM_SHARDED_CUSTOM_MICROSECONDS_TIMES(name, sample, min, \
+                                                        max, bucket_count) \
+  STATIC_HISTOGRAM_POINTER_BLOCK(                                          \
+      name, AddTimeMicrosecondsGranularity(sample),                        \
+      base::Histogram::FactoryMicrosecondsTimeGet(                         \
+          name, min, max, bucket_count,                                    \
+          base::HistogramBase::kUmaTargetedHistogramFlag |                 \
+              base::HistogramBase::kShardedSamplesFlag))
+
+//------------------------------------------------------------------------------
+// Sampled histograms.
+
+// Same as the non-sampled equivalents, but only 1 in |sampling_interval| calls
+// on average record their sample, with a count of |sampling_interval|. This
+// preserves the shape of the distribution, at a fraction of the cost: other
+// calls only decrement a thread-local counter, and don't evaluate |sample|.
+// Use these for call sites too hot to record each sample. Calls are sampled
+// independently of each other, so the counts are estimates with a relative
+// error of about 1/sqrt(number of samples recorded).
+// All of these macros must be called with |name| as a runtime constant, and
+// |sampling_interval| as a compile-time constant.
+
+// Sample usage:
+//   UMA_HISTOGRAM_SAMPLED_CUSTOM_COUNTS("My.Histogram", sample, 1, 1000000,
+//                                       50, /*sampling_interval=*/100);
+#define UMA_HISTOGRAM_SAMPLED_CUSTOM_COUNTS(name, sample, min, exclusive_max,  \
+                                            bucket_count, sampling_interval)   \
+  INTERNAL_HISTOGRAM_SAMPLED_POINTER_BLOCK(                                    \
+      name, sampling_interval,                                                 \
+      AddCount(sample, static_cast<int>(sampling_interval)),                   \
+      base::Histogram::FactoryGet(                                             \
+          name, min, exclusive_max, bucket_count,                              \
+          base::HistogramBase::kUmaTargetedHistogramFlag))
+
+#define UMA_HISTOGRAM_SAMPLED_CUSTOM_TIMES(name, sample, min, max,             \
+                                           bucket_count, sampling_interval)    \
+  INTERNAL_HISTOGRAM_SAMPLED_POINTER_BLOCK(                                    \
+      name, sampling_interval,                                                 \
+      AddCount(base::saturated_cast<base::HistogramBase::Sample>(              \
+                   (sample).InMilliseconds()),                                 \
+               static_cast<int>(sampling_interval)),                           \
+      base::Histogram::FactoryTimeGet(                                         \
+          name, min, max, bucket_count,                                        \
+          base::HistogramBase::kUmaTargetedHistogramFlag))
+
 //------------------------------------------------------------------------------
 // Stability-specific histograms.
 
@@ -12,10 +12,14 @@
 #include <memory>
 #include <type_traits>
 
+#include "base/base_export.h"
+#include "base/compiler_specific.h"
 #include "base/dcheck_is_on.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/sparse_histogram.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/time/time.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
 
 // This is for macros and helpers internal to base/metrics. They should not be
 // used outside of this directory. For writing to UMA histograms, see
@@ -51,6 +55,24 @@ struct EnumSizeTraits<
   }
 };
 
+// The slow path of ShouldRecordSampledHistogram(), taken once per sample.
+BASE_EXPORT bool ShouldRecordSampledHistogramSlow(uint32_t* calls_until_sample,
+                                                  uint32_t sampling_interval);
+
+// Returns whether the current call of a sampled histogram macro should record
+// a sample, for 1 in |sampling_interval| calls on average. The calls skipped
+// are counted down in |calls_until_sample|, the per-thread state of the call
+// site, which is initially 0.
+inline bool ShouldRecordSampledHistogram(uint32_t* calls_until_sample,
+                                         uint32_t sampling_interval) {
+  if (LIKELY(*calls_until_sample > 1)) {
+    --*calls_until_sample;
+    return false;
+  }
+  return ShouldRecordSampledHistogramSlow(calls_until_sample,
+                                          sampling_interval);
+}
+
 }  // namespace internal
 }  // namespace base
 
@@ -117,6 +139,25 @@ struct EnumSizeTraits<
         histogram_add_method_invocation, histogram_factory_get_invocation);   \
   } while (0)
 
+// This is a helper macro used by other macros and shouldn't be used directly.
+// Like STATIC_HISTOGRAM_POINTER_BLOCK, but only for 1 in |sampling_interval|
+// calls on average, chosen independently on each thread. Other calls only
+// decrement a thread-local counter.
+#define INTERNAL_HISTOGRAM_SAMPLED_POINTER_BLOCK(                              \
+    constant_histogram_name, sampling_interval,                                \
+    histogram_add_method_invocation, histogram_factory_get_invocation)         \
+  do {                                                                         \
+    static_assert((sampling_interval) >= 1,                                    \
+                  "|sampling_interval| should be at least 1!");                \
+    ABSL_CONST_INIT static thread_local uint32_t calls_until_sample = 0;       \
+    if (base::internal::ShouldRecordSampledHistogram(&calls_until_sample,      \
+                                                     (sampling_interval))) {   \
+      STATIC_HISTOGRAM_POINTER_BLOCK(constant_histogram_name,                  \
+                                     histogram_add_method_invocation,          \
+                                     histogram_factory_get_invocation);        \
+    }                                                                          \
+  } while (0)
+
 // This is a helper macro used by other macros and shouldn't be used directly.
 #define INTERNAL_HISTOGRAM_CUSTOM_COUNTS_WITH_FLAG(name, sample, min, max,     \
                                                    bucket_count, flag)         \
@@ -3,6 +3,11 @@
 // found in the LICENSE file.
 
 #include "base/metrics/histogram_macros.h"
+
+#include <memory>
+
+#include "base/metrics/statistics_recorder.h"
+#include "base/rand_util.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -72,4 +77,42 @@ TEST(HistogramMacro, EnumerationNonConstRef) {
   UMA_HISTOGRAM_ENUMERATION("Test.ScopedEnumeration4", value_ref);
 }
 
+TEST(HistogramMacro, SampledCustomCounts) {
+  std::unique_ptr<StatisticsRecorder> statistics_recorder =
+      StatisticsRecorder::CreateTemporaryForTesting();
+  constexpr int kNumCalls = 1000000;
+  constexpr int kSamplingInterval = 100;
+  int num_evaluated = 0;
+  for (int i = 0; i < kNumCalls; ++i) {
+    UMA_HISTOGRAM_SAMPLED_CUSTOM_COUNTS("Test.Sampled", (++num_evaluated, 10),
+                                        1, 1000, 50, kSamplingInterval);
+  }
+
+  // About 1 in kSamplingInterval calls are sampled, weighted to estimate the
+  // count of all calls. The standard deviation of the count is about 1%.
+  HistogramBase* histogram = StatisticsRecorder::FindHistogram("Test.Sampled");
+  ASSERT_TRUE(histogram);
+  std::unique_ptr<HistogramSamples> samples = histogram->SnapshotSamples();
+  EXPECT_EQ(num_evaluated * kSamplingInterval, samples->TotalCount());
+  EXPECT_EQ(samples->TotalCount(), samples->GetCount(10));
+  EXPECT_NEAR(kNumCalls, samples->TotalCount(), kNumCalls / 10);
+}
+
+TEST(HistogramMacro, SampledCustomTimes) {
+  std::unique_ptr<StatisticsRecorder> statistics_recorder =
+      StatisticsRecorder::CreateTemporaryForTesting();
+  MetricsSubSampler::ScopedAlwaysSampleForTesting always_sample;
+  for (int i = 0; i < 5; ++i) {
+    UMA_HISTOGRAM_SAMPLED_CUSTOM_TIMES("Test.SampledTimes", Milliseconds(20),
+                                       Milliseconds(1), Seconds(10), 50, 10);
+  }
+
+  HistogramBase* histogram =
+      StatisticsRecorder::FindHistogram("Test.SampledTimes");
+  ASSERT_TRUE(histogram);
+  std::unique_ptr<HistogramSamples> samples = histogram->SnapshotSamples();
+  EXPECT_EQ(50, samples->GetCount(20));
+  EXPECT_EQ(50 * 20, samples->sum());
+}
+
 }  // namespace base
@@ -0,0 +1,155 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/barrier_closure.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
+#include "base/memory/raw_ptr.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file contains tests to measure the cost of recording samples into a
+// histogram concurrently from many threads, with and without
+// HistogramBase::kShardedSamplesFlag, and the cost per call of the histogram
+// macros, with and without sampling.
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixHistogram[] = "Histogram.";
+constexpr char kMetricSampleThroughput[] = "sample_throughput";
+constexpr char kMetricTimePerCall[] = "time_per_call";
+constexpr int kNumIterations = 1000000;
+constexpr int kNumThreads = 32;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixHistogram, story_name);
+  reporter.RegisterImportantMetric(kMetricSampleThroughput, "samples/ms");
+  reporter.RegisterImportantMetric(kMetricTimePerCall, "ns");
+  return reporter;
+}
+
+class RecordThread : public SimpleThread {
+ public:
+  // Upon entering its main function, the thread waits for |start_event| to be
+  // signaled. Then, it records |kNumIterations| samples into |histogram|.
+  // Finally, it invokes |done_closure|.
+  RecordThread(WaitableEvent* start_event,
+               HistogramBase* histogram,
+               OnceClosure done_closure)
+      : SimpleThread("RecordThread"),
+        start_event_(start_event),
+        histogram_(histogram),
+        done_closure_(std::move(done_closure)) {}
+
+  // SimpleThread:
+  void Run() override {
+    start_event_->Wait();
+    for (int i = 0; i < kNumIterations; ++i) {
+      histogram_->Add(i % 1000);
+    }
+    std::move(done_closure_).Run();
+  }
+
+ private:
+  const raw_ptr<WaitableEvent> start_event_;
+  const raw_ptr<HistogramBase> histogram_;
+  OnceClosure done_closure_;
+};
+
+void RunRecordPerfTest(const std::string& story_name, int32_t flags) {
+  std::unique_ptr<StatisticsRecorder> statistics_recorder =
+      StatisticsRecorder::CreateTemporaryForTesting();
+  HistogramBase* histogram =
+      Histogram::FactoryGet(story_name, 1, 1000, 50, flags);
+
+  WaitableEvent start_event;
+  WaitableEvent end_event;
+  RepeatingClosure done_closure = BarrierClosure(
+      kNumThreads, BindOnce(&WaitableEvent::Signal, Unretained(&end_event)));
+
+  std::vector<std::unique_ptr<RecordThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(
+        std::make_unique<RecordThread>(&start_event, histogram, done_closure));
+    threads.back()->Start();
+  }
+
+  TimeTicks start_time = TimeTicks::Now();
+  start_event.Signal();
+  end_event.Wait();
+  TimeTicks end_time = TimeTicks::Now();
+
+  EXPECT_EQ(kNumThreads * kNumIterations,
+            histogram->SnapshotDelta()->TotalCount());
+
+  auto reporter = SetUpReporter(story_name);
+  reporter.AddResult(kMetricSampleThroughput,
+                     kNumThreads * kNumIterations /
+                         (end_time - start_time).InMillisecondsF());
+
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+}
+
+// Reports the time per call of |record|, which is called |kNumIterations|
+// times with the iteration as argument.
+template <typename RecordFunction>
+void RunMacroPerfTest(const std::string& story_name, RecordFunction record) {
+  std::unique_ptr<StatisticsRecorder> statistics_recorder =
+      StatisticsRecorder::CreateTemporaryForTesting();
+  // Create the histogram before measuring.
+  record(0);
+
+  TimeTicks start_time = TimeTicks::Now();
+  for (int i = 1; i < kNumIterations; ++i) {
+    record(i);
+  }
+  TimeTicks end_time = TimeTicks::Now();
+
+  auto reporter = SetUpReporter(story_name);
+  reporter.AddResult(kMetricTimePerCall,
+                     (end_time - start_time).InMicrosecondsF() * 1000 /
+                         kNumIterations);
+}
+
+}  // namespace
+
+TEST(HistogramPerfTest, Record_32Threads) {
+  RunRecordPerfTest("Record_32Threads", HistogramBase::kNoFlags);
+}
+
+TEST(HistogramPerfTest, RecordSharded_32Threads) {
+  RunRecordPerfTest("RecordSharded_32Threads",
+                    HistogramBase::kShardedSamplesFlag);
+}
+
+TEST(HistogramPerfTest, MacroCustomCounts) {
+  RunMacroPerfTest("MacroCustomCounts", [](int i) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("MacroCustomCounts", i % 1000, 1, 1000, 50);
+  });
+}
+
+TEST(HistogramPerfTest, MacroSampledCustomCounts_100) {
+  RunMacroPerfTest("MacroSampledCustomCounts_100", [](int i) {
+    UMA_HISTOGRAM_SAMPLED_CUSTOM_COUNTS("MacroSampledCustomCounts_100",
+                                        i % 1000, 1, 1000, 50, 100);
+  });
+}
+
+}  // namespace base
@@ -5,9 +5,11 @@
 #include "base/metrics/histogram.h"
 
 #include <limits.h>
+#include <math.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <climits>
 #include <memory>
 #include <string>
@@ -28,6 +30,7 @@
 #include "base/pickle.h"
 #include "base/strings/stringprintf.h"
 #include "base/test/gtest_util.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -282,6 +285,58 @@ TEST_P(HistogramTest, UnloggedSamplesTest) {
   EXPECT_EQ(122, samples->sum());
 }
 
+// Check that samples recorded from several threads into a sharded histogram
+// are all snapshotted.
+TEST_P(HistogramTest, ShardedSamplesTest) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumSamplesPerThread = 1000;
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "ShardedHistogram", 1, 64, 8, HistogramBase::kShardedSamplesFlag);
+
+  class RecordDelegate : public DelegateSimpleThread::Delegate {
+   public:
+    explicit RecordDelegate(HistogramBase* histogram) : histogram_(histogram) {}
+
+    void Run() override {
+      for (int i = 0; i < kNumSamplesPerThread; ++i) {
+        histogram_->Add(10);
+      }
+    }
+
+   private:
+    raw_ptr<HistogramBase> histogram_;
+  };
+
+  RecordDelegate delegate(histogram);
+  DelegateSimpleThreadPool pool("ShardedHistogramTest", kNumThreads);
+  pool.AddWork(&delegate, kNumThreads);
+  pool.Start();
+  delegate.Run();
+  pool.JoinAll();
+
+  constexpr int kNumSamples = (kNumThreads + 1) * kNumSamplesPerThread;
+  std::unique_ptr<HistogramSamples> samples =
+      histogram->SnapshotUnloggedSamples();
+  EXPECT_EQ(kNumSamples, samples->TotalCount());
+  EXPECT_EQ(kNumSamples, samples->GetCount(10));
+  EXPECT_EQ(samples->TotalCount(), samples->redundant_count());
+  EXPECT_EQ(10 * kNumSamples, samples->sum());
+
+  histogram->Add(1);
+  samples = histogram->SnapshotDelta();
+  EXPECT_EQ(kNumSamples + 1, samples->TotalCount());
+  EXPECT_EQ(1, samples->GetCount(1));
+  EXPECT_EQ(kNumSamples, samples->GetCount(10));
+  samples = histogram->SnapshotDelta();
+  EXPECT_EQ(0, samples->TotalCount());
+
+  histogram->Add(50);
+  samples = histogram->SnapshotSamples();
+  EXPECT_EQ(kNumSamples + 2, samples->TotalCount());
+  EXPECT_EQ(1, samples->GetCount(50));
+  EXPECT_EQ(10 * kNumSamples + 51, samples->sum());
+}
+
 // Check that final-delta calculations work correctly.
 TEST_P(HistogramTest, FinalDeltaTest) {
   HistogramBase* histogram = Histogram::FactoryGet("FinalDeltaHistogram", 1, 64,
@@ -1103,4 +1158,127 @@ TEST_P(HistogramTest, ToGraphDictNormalize) {
   EXPECT_THAT(*body, testing::MatchesRegex(kOutputBodyFormatRe));
 }
 
+TEST_P(HistogramTest, QuantileSketchHistogramRangesTest) {
+  QuantileSketchHistogram* histogram = static_cast<QuantileSketchHistogram*>(
+      QuantileSketchHistogram::FactoryGet("QuantileSketch", 1000, 0.01,
+                                          HistogramBase::kNoFlags));
+  // A relative error of at most 2^-7.
+  EXPECT_EQ(6, histogram->precision());
+  EXPECT_EQ(1, histogram->declared_min());
+  EXPECT_GE(histogram->declared_max(), 1000);
+
+  // Unit-width buckets up to 2^7, then 2^6 buckets per power of 2.
+  const BucketRanges* ranges = histogram->bucket_ranges();
+  const size_t bucket_count = histogram->bucket_count();
+  EXPECT_EQ(bucket_count + 1, ranges->size());
+  for (size_t i = 0; i <= 128; ++i) {
+    EXPECT_EQ(static_cast<HistogramBase::Sample>(i), ranges->range(i));
+  }
+  EXPECT_EQ(130, ranges->range(129));
+  EXPECT_EQ(256, ranges->range(192));
+  EXPECT_EQ(260, ranges->range(193));
+  EXPECT_EQ(histogram->declared_max(), ranges->range(bucket_count - 1));
+  EXPECT_EQ(HistogramBase::kSampleType_MAX, ranges->range(bucket_count));
+  for (size_t i = 1; i + 1 < bucket_count; ++i) {
+    EXPECT_LE((ranges->range(i + 1) - ranges->range(i)) * 64,
+              std::max(ranges->range(i), 64));
+  }
+  EXPECT_TRUE(ranges->HasValidChecksum());
+  EXPECT_EQ(6, ranges->log_linear_precision());
+
+  // Samples are counted in the bucket whose range contains them.
+  for (HistogramBase::Sample value = 0;
+       value < histogram->declared_max() + 100; ++value) {
+    histogram->Add(value);
+    std::unique_ptr<HistogramSamples> samples = histogram->SnapshotDelta();
+    std::unique_ptr<SampleCountIterator> it = samples->Iterator();
+    ASSERT_FALSE(it->Done());
+    HistogramBase::Sample min;
+    int64_t max;
+    HistogramBase::Count count;
+    it->Get(&min, &max, &count);
+    EXPECT_LE(min, value);
+    EXPECT_GT(max, value);
+    EXPECT_EQ(1, count);
+  }
+}
+
+TEST_P(HistogramTest, QuantileSketchHistogramQuantilesTest) {
+  QuantileSketchHistogram* histogram = static_cast<QuantileSketchHistogram*>(
+      QuantileSketchHistogram::FactoryGet("QuantileSketch", 1 << 20, 0.01,
+                                          HistogramBase::kNoFlags));
+  EXPECT_EQ(0.0, histogram->GetQuantile(0.5));
+
+  constexpr int kNumSamples = 100000;
+  for (int value = 1; value <= kNumSamples; ++value) {
+    histogram->Add(value);
+  }
+  for (double quantile : {0.0, 0.01, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+    const double exact = std::max(1.0, ceil(quantile * kNumSamples));
+    EXPECT_NEAR(exact, histogram->GetQuantile(quantile), exact * 0.01)
+        << quantile;
+  }
+
+  // Samples in the overflow bucket are estimated to be its lower bound.
+  histogram->AddCount(1 << 30, kNumSamples);
+  EXPECT_EQ(static_cast<double>(histogram->declared_max()),
+            histogram->GetQuantile(0.99));
+}
+
+TEST_P(HistogramTest, QuantileSketchHistogramBucketCountTest) {
+  // The precision is lowered to keep the number of buckets bounded.
+  QuantileSketchHistogram* histogram = static_cast<QuantileSketchHistogram*>(
+      QuantileSketchHistogram::FactoryGet(
+          "QuantileSketch", QuantileSketchHistogram::kMaxMaximum, 0.001,
+          HistogramBase::kNoFlags));
+  EXPECT_EQ(5, histogram->precision());
+  EXPECT_LE(histogram->bucket_count(), Histogram::kBucketCount_MAX);
+  EXPECT_EQ(QuantileSketchHistogram::kMaxMaximum, histogram->declared_max());
+
+  histogram->Add(HistogramBase::kSampleType_MAX - 1);
+  std::unique_ptr<HistogramSamples> samples = histogram->SnapshotSamples();
+  EXPECT_EQ(1, samples->GetCount(QuantileSketchHistogram::kMaxMaximum));
+
+  // The same histogram is returned for the same arguments.
+  EXPECT_EQ(histogram, QuantileSketchHistogram::FactoryGet(
+                           "QuantileSketch",
+                           QuantileSketchHistogram::kMaxMaximum, 0.001,
+                           HistogramBase::kNoFlags));
+}
+
+TEST_P(HistogramTest, QuantileSketchHistogramSerializeTest) {
+  QuantileSketchHistogram* histogram = static_cast<QuantileSketchHistogram*>(
+      QuantileSketchHistogram::FactoryGet(
+          "QuantileSketch", 10000, 0.05,
+          HistogramBase::kIPCSerializationSourceFlag));
+  for (int value = 0; value < 10000; value += 7) {
+    histogram->Add(value);
+  }
+  Pickle pickle;
+  histogram->SerializeInfo(&pickle);
+  std::unique_ptr<HistogramSamples> delta = histogram->SnapshotDelta();
+  delta->Serialize(&pickle);
+  delta->Serialize(&pickle);
+
+  // Deserialize the histogram as another process would, merging the deltas.
+  UninitializeStatisticsRecorder();
+  InitializeStatisticsRecorder();
+  PickleIterator iter(pickle);
+  HistogramBase* deserialized = DeserializeHistogramInfo(&iter);
+  ASSERT_TRUE(deserialized);
+  ASSERT_EQ(QUANTILE_SKETCH_HISTOGRAM, deserialized->GetHistogramType());
+  EXPECT_TRUE(deserialized->AddSamplesFromPickle(&iter));
+  EXPECT_TRUE(deserialized->AddSamplesFromPickle(&iter));
+
+  QuantileSketchHistogram* merged =
+      static_cast<QuantileSketchHistogram*>(deserialized);
+  EXPECT_EQ(histogram->precision(), merged->precision());
+  EXPECT_EQ(histogram->bucket_count(), merged->bucket_count());
+  EXPECT_EQ(2 * delta->TotalCount(), merged->SnapshotSamples()->TotalCount());
+  for (double quantile : {0.5, 0.9, 0.99}) {
+    EXPECT_EQ(QuantileSketchHistogram::EstimateQuantile(*delta, quantile),
+              merged->GetQuantile(quantile));
+  }
+}
+
 }  // namespace base
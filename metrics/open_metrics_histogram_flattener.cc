@@ -0,0 +1,133 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/open_metrics_histogram_flattener.h"
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/check.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/histogram_snapshot_manager.h"
+#include "base/metrics/persistent_histogram_allocator.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+
+namespace base {
+
+namespace {
+
+// Metric names match [a-zA-Z_:][a-zA-Z0-9_:]*.
+bool IsMetricNameChar(char c, bool first) {
+  return IsAsciiAlpha(c) || c == '_' || c == ':' || (!first && IsAsciiDigit(c));
+}
+
+}  // namespace
+
+OpenMetricsHistogramFlattener::OpenMetricsHistogramFlattener(
+    Sink sink,
+    size_t buffer_size)
+    : sink_(sink), buffer_size_(buffer_size) {
+  // Leave room for the line which crosses `buffer_size_`.
+  buffer_.reserve(buffer_size_ + 256);
+}
+
+OpenMetricsHistogramFlattener::~OpenMetricsHistogramFlattener() = default;
+
+void OpenMetricsHistogramFlattener::RecordDelta(
+    const HistogramBase& histogram,
+    const HistogramSamples& snapshot) {
+  DCHECK(!finished_);
+  if (sink_failed_) {
+    return;
+  }
+
+  SetMetricName(histogram.histogram_name());
+  buffer_.append("# TYPE ");
+  buffer_.append(metric_name_);
+  buffer_.append(" gaugehistogram\n");
+
+  int64_t cumulative_count = 0;
+  for (std::unique_ptr<SampleCountIterator> it = snapshot.Iterator();
+       !it->Done(); it->Next()) {
+    HistogramBase::Sample min;
+    int64_t max;
+    HistogramBase::Count count;
+    it->Get(&min, &max, &count);
+    if (count == 0) {
+      continue;
+    }
+    cumulative_count += count;
+    AppendSampleName("_bucket{le=\"");
+    // Samples are integers and `max` is exclusive.
+    AppendNumberToString(max - 1, buffer_);
+    buffer_.append("\"} ");
+    AppendNumberToString(cumulative_count, buffer_);
+    buffer_.push_back('\n');
+    MaybeFlush(/*force=*/false);
+  }
+
+  AppendSampleName("_bucket{le=\"+Inf\"} ");
+  AppendNumberToString(cumulative_count, buffer_);
+  buffer_.push_back('\n');
+  AppendSampleName("_gcount ");
+  AppendNumberToString(cumulative_count, buffer_);
+  buffer_.push_back('\n');
+  AppendSampleName("_gsum ");
+  AppendNumberToString(snapshot.sum(), buffer_);
+  buffer_.push_back('\n');
+  MaybeFlush(/*force=*/false);
+}
+
+void OpenMetricsHistogramFlattener::RecordDeltasFromAllocator(
+    PersistentHistogramAllocator* allocator) {
+  DCHECK(!finished_);
+  HistogramSnapshotManager snapshot_manager(this);
+  PersistentHistogramAllocator::Iterator iter(allocator);
+  while (std::unique_ptr<HistogramBase> histogram = iter.GetNext()) {
+    if (sink_failed_) {
+      return;
+    }
+    snapshot_manager.PrepareDelta(histogram.get());
+  }
+}
+
+bool OpenMetricsHistogramFlattener::Finish() {
+  DCHECK(!finished_);
+  finished_ = true;
+  buffer_.append("# EOF\n");
+  MaybeFlush(/*force=*/true);
+  return !sink_failed_;
+}
+
+void OpenMetricsHistogramFlattener::SetMetricName(
+    std::string_view histogram_name) {
+  metric_name_.clear();
+  if (histogram_name.empty()) {
+    metric_name_.push_back('_');
+    return;
+  }
+  for (char c : histogram_name) {
+    metric_name_.push_back(
+        IsMetricNameChar(c, /*first=*/metric_name_.empty()) ? c : '_');
+  }
+}
+
+void OpenMetricsHistogramFlattener::AppendSampleName(std::string_view suffix) {
+  buffer_.append(metric_name_);
+  buffer_.append(suffix);
+}
+
+void OpenMetricsHistogramFlattener::MaybeFlush(bool force) {
+  if (sink_failed_ || buffer_.empty() ||
+      (!force && buffer_.size() < buffer_size_)) {
+    return;
+  }
+  sink_failed_ = !sink_(buffer_);
+  buffer_.clear();
+}
+
+}  // namespace base
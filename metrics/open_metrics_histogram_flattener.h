@@ -0,0 +1,109 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_METRICS_OPEN_METRICS_HISTOGRAM_FLATTENER_H_
+#define BASE_METRICS_OPEN_METRICS_HISTOGRAM_FLATTENER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/functional/function_ref.h"
+#include "base/metrics/histogram_flattener.h"
+
+namespace base {
+
+class HistogramBase;
+class HistogramSamples;
+class PersistentHistogramAllocator;
+
+// A HistogramFlattener which writes the deltas recorded by a
+// HistogramSnapshotManager in the OpenMetrics text exposition format (see
+// https://openmetrics.io). Since each delta only covers the samples recorded
+// since the previous one, histograms are written as gauge histograms:
+//
+//   # TYPE Net_Foo gaugehistogram
+//   Net_Foo_bucket{le="9"} 3
+//   Net_Foo_bucket{le="+Inf"} 5
+//   Net_Foo_gcount 5
+//   Net_Foo_gsum 61
+//
+// Characters of histogram names that aren't allowed in metric names, e.g. '.',
+// are replaced with '_'. Only buckets with samples are written; `le` is the
+// largest sample of the bucket, and bucket counts are cumulative.
+//
+// The output is streamed to a sink in chunks of roughly `buffer_size` bytes,
+// reusing the same buffer for all histograms, so that the memory used doesn't
+// grow with the number of histograms. Example:
+//
+//   OpenMetricsHistogramFlattener flattener(
+//       [&file](span<const char> chunk) {
+//         return file.WriteAtCurrentPosAndCheck(as_bytes(chunk));
+//       });
+//   HistogramSnapshotManager snapshot_manager(&flattener);
+//   StatisticsRecorder::PrepareDeltas(/*include_persistent=*/true,
+//                                     HistogramBase::kNoFlags,
+//                                     HistogramBase::kNoFlags,
+//                                     &snapshot_manager);
+//   flattener.Finish();
+class BASE_EXPORT OpenMetricsHistogramFlattener : public HistogramFlattener {
+ public:
+  // Receives consecutive chunks of output. Returns false to abort writing,
+  // e.g. on an I/O error.
+  using Sink = FunctionRef<bool(span<const char>)>;
+
+  static constexpr size_t kDefaultSinkBufferSize = 64 * 1024;
+
+  // `sink` must outlive this.
+  explicit OpenMetricsHistogramFlattener(
+      Sink sink,
+      size_t buffer_size = kDefaultSinkBufferSize);
+  OpenMetricsHistogramFlattener(const OpenMetricsHistogramFlattener&) = delete;
+  OpenMetricsHistogramFlattener& operator=(
+      const OpenMetricsHistogramFlattener&) = delete;
+  ~OpenMetricsHistogramFlattener() override;
+
+  // HistogramFlattener:
+  void RecordDelta(const HistogramBase& histogram,
+                   const HistogramSamples& snapshot) override;
+
+  // Writes the deltas of the histograms in `allocator`, typically the shared
+  // memory of a child process, directly from it instead of merging them into
+  // the StatisticsRecorder first. The written samples are marked as logged in
+  // `allocator`, so they must not also be merged e.g. by
+  // PersistentHistogramAllocator::MergeHistogramDeltaToStatisticsRecorder().
+  void RecordDeltasFromAllocator(PersistentHistogramAllocator* allocator);
+
+  // Writes the terminating "# EOF" line and passes the remaining output to the
+  // sink. Nothing can be recorded afterwards. Returns false if the sink
+  // returned false at any point.
+  bool Finish();
+
+ private:
+  // Sets `metric_name_` to `histogram_name`, with disallowed characters
+  // replaced.
+  void SetMetricName(std::string_view histogram_name);
+
+  // Appends the start of a sample line: `metric_name_` followed by `suffix`.
+  void AppendSampleName(std::string_view suffix);
+
+  // Passes the buffered output to `sink_` if there is at least `buffer_size_`
+  // of it, or if `force` is true.
+  void MaybeFlush(bool force);
+
+  const Sink sink_;
+  const size_t buffer_size_;
+  std::string buffer_;
+  // The metric name of the histogram being written. Reused across histograms.
+  std::string metric_name_;
+  bool sink_failed_ = false;
+  bool finished_ = false;
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_OPEN_METRICS_HISTOGRAM_FLATTENER_H_
@@ -0,0 +1,195 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/open_metrics_histogram_flattener.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_snapshot_manager.h"
+#include "base/metrics/persistent_histogram_allocator.h"
+#include "base/metrics/persistent_memory_allocator.h"
+#include "base/metrics/sparse_histogram.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class OpenMetricsHistogramFlattenerTest : public testing::Test {
+ protected:
+  OpenMetricsHistogramFlattenerTest()
+      : statistics_recorder_(StatisticsRecorder::CreateTemporaryForTesting()) {}
+
+  // Returns the OpenMetrics output of the deltas of `histograms`.
+  std::string RecordDeltas(const std::vector<HistogramBase*>& histograms) {
+    std::string output;
+    OpenMetricsHistogramFlattener flattener(
+        [&output](span<const char> chunk) {
+          output.append(chunk.begin(), chunk.end());
+          return true;
+        });
+    HistogramSnapshotManager snapshot_manager(&flattener);
+    snapshot_manager.PrepareDeltas(histograms, HistogramBase::kNoFlags,
+                                   HistogramBase::kNoFlags);
+    EXPECT_TRUE(flattener.Finish());
+    return output;
+  }
+
+  std::unique_ptr<StatisticsRecorder> statistics_recorder_;
+};
+
+TEST_F(OpenMetricsHistogramFlattenerTest, Histogram) {
+  HistogramBase* histogram = LinearHistogram::FactoryGet(
+      "Test.Linear-Histogram", 1, 10, 11, HistogramBase::kNoFlags);
+  histogram->Add(1);
+  histogram->Add(1);
+  histogram->Add(5);
+  histogram->Add(20);
+
+  EXPECT_EQ(
+      "# TYPE Test_Linear_Histogram gaugehistogram\n"
+      "Test_Linear_Histogram_bucket{le=\"1\"} 2\n"
+      "Test_Linear_Histogram_bucket{le=\"5\"} 3\n"
+      "Test_Linear_Histogram_bucket{le=\"2147483646\"} 4\n"
+      "Test_Linear_Histogram_bucket{le=\"+Inf\"} 4\n"
+      "Test_Linear_Histogram_gcount 4\n"
+      "Test_Linear_Histogram_gsum 27\n"
+      "# EOF\n",
+      RecordDeltas({histogram}));
+
+  // Only samples recorded since the previous delta are written.
+  histogram->Add(5);
+  EXPECT_EQ(
+      "# TYPE Test_Linear_Histogram gaugehistogram\n"
+      "Test_Linear_Histogram_bucket{le=\"5\"} 1\n"
+      "Test_Linear_Histogram_bucket{le=\"+Inf\"} 1\n"
+      "Test_Linear_Histogram_gcount 1\n"
+      "Test_Linear_Histogram_gsum 5\n"
+      "# EOF\n",
+      RecordDeltas({histogram}));
+  EXPECT_EQ("# EOF\n", RecordDeltas({histogram}));
+}
+
+TEST_F(OpenMetricsHistogramFlattenerTest, SparseHistogram) {
+  HistogramBase* histogram =
+      SparseHistogram::FactoryGet("1Sparse", HistogramBase::kNoFlags);
+  histogram->Add(-3);
+  histogram->Add(7);
+
+  EXPECT_EQ(
+      "# TYPE _Sparse gaugehistogram\n"
+      "_Sparse_bucket{le=\"-3\"} 1\n"
+      "_Sparse_bucket{le=\"7\"} 2\n"
+      "_Sparse_bucket{le=\"+Inf\"} 2\n"
+      "_Sparse_gcount 2\n"
+      "_Sparse_gsum 4\n"
+      "# EOF\n",
+      RecordDeltas({histogram}));
+}
+
+TEST_F(OpenMetricsHistogramFlattenerTest, Chunks) {
+  std::vector<HistogramBase*> histograms;
+  for (int i = 0; i < 100; ++i) {
+    HistogramBase* histogram =
+        Histogram::FactoryGet("Test.Histogram" + NumberToString(i), 1, 1000,
+                              50, HistogramBase::kNoFlags);
+    histogram->Add(i);
+    histograms.push_back(histogram);
+  }
+  const std::string expected_output = RecordDeltas(histograms);
+
+  // Record the same samples as the first time, and write them in chunks.
+  for (int i = 0; i < 100; ++i) {
+    histograms[i]->Add(i);
+  }
+  constexpr size_t kBufferSize = 128;
+  std::vector<std::string> chunks;
+  OpenMetricsHistogramFlattener flattener(
+      [&chunks](span<const char> chunk) {
+        chunks.emplace_back(chunk.begin(), chunk.end());
+        return true;
+      },
+      kBufferSize);
+  HistogramSnapshotManager snapshot_manager(&flattener);
+  snapshot_manager.PrepareDeltas(histograms, HistogramBase::kNoFlags,
+                                 HistogramBase::kNoFlags);
+  EXPECT_TRUE(flattener.Finish());
+
+  ASSERT_GT(chunks.size(), 1u);
+  std::string output;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    if (i + 1 < chunks.size()) {
+      EXPECT_GE(chunks[i].size(), kBufferSize);
+    }
+    output += chunks[i];
+  }
+  EXPECT_EQ(expected_output, output);
+}
+
+TEST_F(OpenMetricsHistogramFlattenerTest, SinkFailure) {
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Test.Histogram", 1, 1000, 50, HistogramBase::kNoFlags);
+  histogram->Add(10);
+
+  int num_chunks = 0;
+  OpenMetricsHistogramFlattener flattener(
+      [&num_chunks](span<const char> chunk) {
+        ++num_chunks;
+        return false;
+      },
+      /*buffer_size=*/1);
+  HistogramSnapshotManager snapshot_manager(&flattener);
+  snapshot_manager.PrepareDeltas({histogram}, HistogramBase::kNoFlags,
+                                 HistogramBase::kNoFlags);
+  EXPECT_FALSE(flattener.Finish());
+  EXPECT_EQ(1, num_chunks);
+}
+
+TEST_F(OpenMetricsHistogramFlattenerTest, RecordDeltasFromAllocator) {
+  // Record a histogram in persistent memory, as a child process would.
+  GlobalHistogramAllocator* old_allocator =
+      GlobalHistogramAllocator::ReleaseForTesting();
+  GlobalHistogramAllocator::CreateWithLocalMemory(64 << 10, 0, "");
+  HistogramBase* histogram = LinearHistogram::FactoryGet(
+      "Child.Histogram", 1, 10, 11, HistogramBase::kNoFlags);
+  histogram->Add(1);
+  histogram->Add(1);
+  histogram->Add(3);
+  GlobalHistogramAllocator* child_allocator =
+      GlobalHistogramAllocator::ReleaseForTesting();
+  GlobalHistogramAllocator::Set(old_allocator);
+
+  PersistentHistogramAllocator allocator(
+      std::make_unique<PersistentMemoryAllocator>(
+          const_cast<void*>(child_allocator->memory_allocator()->data()),
+          child_allocator->memory_allocator()->size(), 0, 0, "",
+          PersistentMemoryAllocator::kReadWrite));
+  std::string output;
+  OpenMetricsHistogramFlattener flattener([&output](span<const char> chunk) {
+    output.append(chunk.begin(), chunk.end());
+    return true;
+  });
+  flattener.RecordDeltasFromAllocator(&allocator);
+  // The samples were marked as logged in the shared memory, so they aren't
+  // written again.
+  flattener.RecordDeltasFromAllocator(&allocator);
+  EXPECT_TRUE(flattener.Finish());
+  EXPECT_EQ(
+      "# TYPE Child_Histogram gaugehistogram\n"
+      "Child_Histogram_bucket{le=\"1\"} 2\n"
+      "Child_Histogram_bucket{le=\"3\"} 3\n"
+      "Child_Histogram_bucket{le=\"+Inf\"} 3\n"
+      "Child_Histogram_gcount 3\n"
+      "Child_Histogram_gsum 5\n"
+      "# EOF\n",
+      output);
+
+  delete child_allocator;
+}
+
+}  // namespace base
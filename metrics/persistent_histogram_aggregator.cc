@@ -0,0 +1,112 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/persistent_histogram_aggregator.h"
+
+#include <stdint.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/metrics/bucket_ranges.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_flattener.h"
+#include "base/metrics/histogram_samples.h"
+
+namespace base {
+
+namespace {
+
+// Returns whether the samples of |a| and |b| can be summed.
+bool AreCompatible(const HistogramBase& a, const HistogramBase& b) {
+  if (a.GetHistogramType() != b.GetHistogramType()) {
+    return false;
+  }
+  if (a.GetHistogramType() == SPARSE_HISTOGRAM) {
+    return true;
+  }
+  return static_cast<const Histogram&>(a).bucket_ranges()->Equals(
+      static_cast<const Histogram&>(b).bucket_ranges());
+}
+
+}  // namespace
+
+// The histograms of an allocator.
+struct PersistentHistogramAggregator::Source {
+  explicit Source(PersistentHistogramAllocator* allocator)
+      : allocator(allocator), iterator(allocator) {}
+
+  raw_ptr<PersistentHistogramAllocator> allocator;
+  // Finds the histograms created since the previous deltas.
+  PersistentHistogramAllocator::Iterator iterator;
+  // The histograms found so far, accessing the allocator's memory in place.
+  std::vector<std::unique_ptr<HistogramBase>> histograms;
+};
+
+PersistentHistogramAggregator::PersistentHistogramAggregator() = default;
+
+PersistentHistogramAggregator::~PersistentHistogramAggregator() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void PersistentHistogramAggregator::AddAllocator(
+    PersistentHistogramAllocator* allocator) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  sources_.push_back(std::make_unique<Source>(allocator));
+}
+
+void PersistentHistogramAggregator::RemoveAllocator(
+    PersistentHistogramAllocator* allocator) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const size_t num_removed = std::erase_if(
+      sources_, [allocator](const std::unique_ptr<Source>& source) {
+        return source->allocator == allocator;
+      });
+  DCHECK_EQ(1u, num_removed);
+}
+
+void PersistentHistogramAggregator::PrepareDeltas(
+    HistogramFlattener* flattener) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // The sum of the deltas of each name, and the first histogram which had
+  // samples, which describes them to |flattener|.
+  struct Aggregate {
+    raw_ptr<const HistogramBase> histogram;
+    std::unique_ptr<HistogramSamples> samples;
+  };
+  std::map<uint64_t, Aggregate> aggregates;
+
+  for (const std::unique_ptr<Source>& source : sources_) {
+    while (std::unique_ptr<HistogramBase> histogram =
+               source->iterator.GetNext()) {
+      source->histograms.push_back(std::move(histogram));
+    }
+
+    for (const std::unique_ptr<HistogramBase>& histogram : source->histograms) {
+      std::unique_ptr<HistogramSamples> delta = histogram->SnapshotDelta();
+      if (delta->IsDefinitelyEmpty()) {
+        continue;
+      }
+      auto [it, inserted] = aggregates.try_emplace(histogram->name_hash());
+      Aggregate& aggregate = it->second;
+      if (inserted) {
+        aggregate.histogram = histogram.get();
+        aggregate.samples = std::move(delta);
+      } else if (AreCompatible(*aggregate.histogram, *histogram)) {
+        aggregate.samples->Add(*delta);
+      } else {
+        ++num_mismatched_histograms_;
+      }
+    }
+  }
+
+  for (const auto& [name_hash, aggregate] : aggregates) {
+    flattener->RecordDelta(*aggregate.histogram, *aggregate.samples);
+  }
+}
+
+}  // namespace base
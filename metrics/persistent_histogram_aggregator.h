@@ -0,0 +1,85 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_METRICS_PERSISTENT_HISTOGRAM_AGGREGATOR_H_
+#define BASE_METRICS_PERSISTENT_HISTOGRAM_AGGREGATOR_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/memory/raw_ptr.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/persistent_histogram_allocator.h"
+#include "base/sequence_checker.h"
+
+namespace base {
+
+class HistogramFlattener;
+
+// Aggregates the histograms of several PersistentHistogramAllocators, e.g. the
+// shared memory of many child processes, when they are exported. Each time
+// deltas are prepared, the deltas of the histograms with the same name are
+// read from the allocators and summed, then passed to the flattener once per
+// name.
+//
+// Unlike with PersistentHistogramAllocator::
+// MergeHistogramDeltaToStatisticsRecorder(), the samples aren't first merged
+// into histograms of the StatisticsRecorder, which would copy them into a
+// duplicate of each histogram, kept even after the child processes are gone.
+// The histograms of the allocators are only accessed in place, through objects
+// created once per histogram.
+//
+// This class isn't thread-safe. Example:
+//
+//   PersistentHistogramAggregator aggregator;
+//   aggregator.AddAllocator(worker_allocator);  // For each worker process.
+//   ...
+//   OpenMetricsHistogramFlattener flattener(sink);
+//   aggregator.PrepareDeltas(&flattener);
+//   flattener.Finish();
+class BASE_EXPORT PersistentHistogramAggregator {
+ public:
+  PersistentHistogramAggregator();
+  PersistentHistogramAggregator(const PersistentHistogramAggregator&) = delete;
+  PersistentHistogramAggregator& operator=(
+      const PersistentHistogramAggregator&) = delete;
+  ~PersistentHistogramAggregator();
+
+  // Starts aggregating the histograms of |allocator|, which must outlive this
+  // or be removed first. No other code may take deltas of its histograms.
+  void AddAllocator(PersistentHistogramAllocator* allocator);
+
+  // Stops aggregating the histograms of |allocator|, e.g. once its process is
+  // gone. Call PrepareDeltas() first to not lose the latest samples.
+  void RemoveAllocator(PersistentHistogramAllocator* allocator);
+
+  // Passes to |flattener|, for each name, the sum of the samples recorded
+  // since the previous call into the histograms of that name of all the
+  // allocators. The samples are then marked as logged in the allocators.
+  void PrepareDeltas(HistogramFlattener* flattener);
+
+  // Returns the number of histograms whose samples were dropped because they
+  // were incompatible with the ones of the same name in other allocators, e.g.
+  // because their versions of the code disagree on the buckets.
+  size_t num_mismatched_histograms() const {
+    return num_mismatched_histograms_;
+  }
+
+ private:
+  struct Source;
+
+  std::vector<std::unique_ptr<Source>> sources_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+
+  size_t num_mismatched_histograms_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_PERSISTENT_HISTOGRAM_AGGREGATOR_H_
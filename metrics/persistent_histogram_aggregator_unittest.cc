@@ -0,0 +1,187 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/persistent_histogram_aggregator.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_flattener.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/persistent_histogram_allocator.h"
+#include "base/metrics/persistent_memory_allocator.h"
+#include "base/metrics/sparse_histogram.h"
+#include "base/metrics/statistics_recorder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Collects the deltas passed to it by name.
+class TestFlattener : public HistogramFlattener {
+ public:
+  TestFlattener() = default;
+  TestFlattener(const TestFlattener&) = delete;
+  TestFlattener& operator=(const TestFlattener&) = delete;
+  ~TestFlattener() override = default;
+
+  // HistogramFlattener:
+  void RecordDelta(const HistogramBase& histogram,
+                   const HistogramSamples& snapshot) override {
+    EXPECT_FALSE(deltas_.contains(histogram.histogram_name()));
+    deltas_[histogram.histogram_name()] = {snapshot.TotalCount(),
+                                           snapshot.sum()};
+  }
+
+  struct Delta {
+    HistogramBase::Count count;
+    int64_t sum;
+  };
+  const std::map<std::string, Delta>& deltas() const { return deltas_; }
+
+ private:
+  std::map<std::string, Delta> deltas_;
+};
+
+}  // namespace
+
+class PersistentHistogramAggregatorTest : public testing::Test {
+ protected:
+  PersistentHistogramAggregatorTest()
+      : statistics_recorder_(StatisticsRecorder::CreateTemporaryForTesting()) {}
+
+  // Creates the allocator of a child process, and returns it as its parent
+  // would see it.
+  PersistentHistogramAllocator* CreateChild() {
+    GlobalHistogramAllocator* old_allocator =
+        GlobalHistogramAllocator::ReleaseForTesting();
+    GlobalHistogramAllocator::CreateWithLocalMemory(64 << 10, 0, "");
+    child_allocators_.emplace_back(
+        GlobalHistogramAllocator::ReleaseForTesting());
+    GlobalHistogramAllocator::Set(old_allocator);
+
+    PersistentMemoryAllocator* memory =
+        child_allocators_.back()->memory_allocator();
+    parent_allocators_.push_back(std::make_unique<PersistentHistogramAllocator>(
+        std::make_unique<PersistentMemoryAllocator>(
+            const_cast<void*>(memory->data()), memory->size(), 0, 0, "",
+            PersistentMemoryAllocator::kReadWrite)));
+    return parent_allocators_.back().get();
+  }
+
+  // Records |count| samples of |value| into a histogram of the last child
+  // created, as the child would. Histograms named "Test.Sparse" are sparse,
+  // others have 50 buckets up to |maximum|.
+  void RecordInChild(const std::string& name,
+                     HistogramBase::Sample value,
+                     HistogramBase::Count count,
+                     HistogramBase::Sample maximum = 1000) {
+    // The child has its own histograms.
+    std::unique_ptr<StatisticsRecorder> child_recorder =
+        StatisticsRecorder::CreateTemporaryForTesting();
+    GlobalHistogramAllocator* old_allocator =
+        GlobalHistogramAllocator::ReleaseForTesting();
+    GlobalHistogramAllocator::Set(child_allocators_.back().get());
+
+    // Histograms which the child already created are found in its allocator.
+    PersistentHistogramAllocator::Iterator iter(
+        GlobalHistogramAllocator::Get());
+    while (std::unique_ptr<HistogramBase> histogram = iter.GetNext()) {
+      StatisticsRecorder::RegisterOrDeleteDuplicate(histogram.release());
+    }
+    HistogramBase* histogram =
+        name == "Test.Sparse"
+            ? SparseHistogram::FactoryGet(name, HistogramBase::kNoFlags)
+            : Histogram::FactoryGet(name, 1, maximum, 50,
+                                    HistogramBase::kNoFlags);
+    histogram->AddCount(value, count);
+
+    GlobalHistogramAllocator::ReleaseForTesting();
+    GlobalHistogramAllocator::Set(old_allocator);
+  }
+
+  std::unique_ptr<StatisticsRecorder> statistics_recorder_;
+  std::vector<std::unique_ptr<GlobalHistogramAllocator>> child_allocators_;
+  std::vector<std::unique_ptr<PersistentHistogramAllocator>>
+      parent_allocators_;
+};
+
+TEST_F(PersistentHistogramAggregatorTest, SumsChildren) {
+  PersistentHistogramAggregator aggregator;
+  for (int i = 1; i <= 3; ++i) {
+    aggregator.AddAllocator(CreateChild());
+    RecordInChild("Test.Histogram", 10, i);
+    RecordInChild("Test.Sparse", i, 1);
+    if (i == 2) {
+      RecordInChild("Test.OnlyInSecond", 5, 1);
+    }
+  }
+
+  TestFlattener flattener;
+  aggregator.PrepareDeltas(&flattener);
+  ASSERT_EQ(3u, flattener.deltas().size());
+  EXPECT_EQ(6, flattener.deltas().at("Test.Histogram").count);
+  EXPECT_EQ(60, flattener.deltas().at("Test.Histogram").sum);
+  EXPECT_EQ(3, flattener.deltas().at("Test.Sparse").count);
+  EXPECT_EQ(6, flattener.deltas().at("Test.Sparse").sum);
+  EXPECT_EQ(1, flattener.deltas().at("Test.OnlyInSecond").count);
+  EXPECT_EQ(0u, aggregator.num_mismatched_histograms());
+
+  // The histograms of the children weren't registered in the parent.
+  EXPECT_FALSE(StatisticsRecorder::FindHistogram("Test.Histogram"));
+
+  // Nothing new was recorded since.
+  TestFlattener empty_flattener;
+  aggregator.PrepareDeltas(&empty_flattener);
+  EXPECT_TRUE(empty_flattener.deltas().empty());
+}
+
+TEST_F(PersistentHistogramAggregatorTest, NewSamplesAndHistograms) {
+  PersistentHistogramAggregator aggregator;
+  aggregator.AddAllocator(CreateChild());
+  RecordInChild("Test.Histogram", 10, 1);
+
+  TestFlattener flattener;
+  aggregator.PrepareDeltas(&flattener);
+  EXPECT_EQ(1, flattener.deltas().at("Test.Histogram").count);
+
+  // The child keeps running.
+  RecordInChild("Test.Histogram", 20, 1);
+  RecordInChild("Test.New", 7, 2);
+
+  TestFlattener next_flattener;
+  aggregator.PrepareDeltas(&next_flattener);
+  ASSERT_EQ(2u, next_flattener.deltas().size());
+  EXPECT_EQ(1, next_flattener.deltas().at("Test.Histogram").count);
+  EXPECT_EQ(20, next_flattener.deltas().at("Test.Histogram").sum);
+  EXPECT_EQ(14, next_flattener.deltas().at("Test.New").sum);
+}
+
+TEST_F(PersistentHistogramAggregatorTest, MismatchedHistograms) {
+  PersistentHistogramAggregator aggregator;
+  aggregator.AddAllocator(CreateChild());
+  RecordInChild("Test.Histogram", 10, 1);
+  // Another version of the histogram, with different buckets.
+  aggregator.AddAllocator(CreateChild());
+  RecordInChild("Test.Histogram", 10, 1, /*maximum=*/100);
+
+  TestFlattener flattener;
+  aggregator.PrepareDeltas(&flattener);
+  EXPECT_EQ(1, flattener.deltas().at("Test.Histogram").count);
+  EXPECT_EQ(1u, aggregator.num_mismatched_histograms());
+
+  // Once the second child is gone, its samples aren't read anymore.
+  aggregator.RemoveAllocator(parent_allocators_.back().get());
+  RecordInChild("Test.Histogram", 10, 1, /*maximum=*/100);
+  TestFlattener next_flattener;
+  aggregator.PrepareDeltas(&next_flattener);
+  EXPECT_TRUE(next_flattener.deltas().empty());
+  EXPECT_EQ(1u, aggregator.num_mismatched_histograms());
+}
+
+}  // namespace base
@@ -125,7 +125,8 @@ void MergeSamplesToExistingHistogram(
   } else if (existing_type == HistogramType::HISTOGRAM ||
              existing_type == HistogramType::LINEAR_HISTOGRAM ||
              existing_type == HistogramType::BOOLEAN_HISTOGRAM ||
-             existing_type == HistogramType::CUSTOM_HISTOGRAM) {
+             existing_type == HistogramType::CUSTOM_HISTOGRAM ||
+             existing_type == HistogramType::QUANTILE_SKETCH_HISTOGRAM) {
     // Only numeric histograms make use of BucketRanges.
     const BucketRanges* existing_buckets =
         static_cast<const Histogram*>(existing)->bucket_ranges();
@@ -309,12 +310,14 @@ struct PersistentHistogramAllocator::PersistentHistogramData {
 
 PersistentHistogramAllocator::Iterator::Iterator(
     PersistentHistogramAllocator* allocator)
-    : allocator_(allocator), memory_iter_(allocator->memory_allocator()) {}
+    : allocator_(allocator),
+      memory_iter_(allocator->memory_allocator(),
+                   PersistentHistogramData::kPersistentTypeId) {}
 
 std::unique_ptr<HistogramBase>
 PersistentHistogramAllocator::Iterator::GetNextWithIgnore(Reference ignore) {
   PersistentMemoryAllocator::Reference ref;
-  while ((ref = memory_iter_.GetNextOfType<PersistentHistogramData>()) != 0) {
+  while ((ref = memory_iter_.GetNext()) != 0) {
     if (ref != ignore)
       return allocator_->GetHistogram(ref);
   }
@@ -696,6 +699,13 @@ std::unique_ptr<HistogramBase> PersistentHistogramAllocator::CreateHistogram(
           &histogram_data_ptr->logged_metadata);
       DCHECK(histogram);
       break;
+    case QUANTILE_SKETCH_HISTOGRAM:
+      histogram = QuantileSketchHistogram::PersistentCreate(
+          name, ranges, counts_data, logged_data,
+          &histogram_data_ptr->samples_metadata,
+          &histogram_data_ptr->logged_metadata);
+      DCHECK(histogram);
+      break;
     default:
       return nullptr;
   }
@@ -205,9 +205,9 @@ class BASE_EXPORT PersistentHistogramAllocator {
     // Weak-pointer to histogram allocator being iterated over.
     raw_ptr<PersistentHistogramAllocator> allocator_;
 
-    // The iterator used for stepping through objects in persistent memory.
+    // The iterator used for stepping through histograms in persistent memory.
     // It is lock-free and thread-safe which is why this class is also such.
-    PersistentMemoryAllocator::Iterator memory_iter_;
+    PersistentMemoryAllocator::TypedIterator memory_iter_;
   };
 
   // A PersistentHistogramAllocator is constructed from a PersistentMemory-
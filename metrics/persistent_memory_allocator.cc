@@ -31,6 +31,7 @@
 #include "base/numerics/safe_conversions.h"
 #include "base/strings/strcat.h"
 #include "base/system/sys_info.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "build/build_config.h"
 
@@ -300,6 +301,186 @@ PersistentMemoryAllocator::Iterator::GetNextOfType(uint32_t type_match) {
   return kReferenceNull;
 }
 
+// The index used by TypedIterator: append-only lists of the references of the
+// records of each type, in the order they were reached by |queue_iterator_|.
+// Lists are allocated in blocks of growing size which are never moved, so
+// that they can be read while being appended to without locks.
+class PersistentMemoryAllocator::TypeIndex {
+ public:
+  // The maximum number of types indexed. Most segments only have a few.
+  static constexpr size_t kMaxTypes = 64;
+
+  // The list of records of a type is split into blocks of kFirstBlockSize,
+  // 2 * kFirstBlockSize, 4 * kFirstBlockSize... records. This is enough for
+  // the largest number of records that fit in a segment.
+  static constexpr size_t kFirstBlockSize = 64;
+  static constexpr size_t kMaxBlocks = 21;
+  static_assert((kFirstBlockSize << (kMaxBlocks - 1)) >
+                    kSegmentMaxSize / (sizeof(BlockHeader) + kAllocAlignment),
+                "a segment can have more records than can be indexed");
+
+  explicit TypeIndex(const PersistentMemoryAllocator* allocator)
+      : queue_iterator_(allocator) {}
+
+  TypeIndex(const TypeIndex&) = delete;
+  TypeIndex& operator=(const TypeIndex&) = delete;
+
+  ~TypeIndex() {
+    for (List& list : lists_) {
+      for (std::atomic<std::atomic<Reference>*>& block : list.blocks) {
+        delete[] block.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns the list of the records of |type_id|, or false if there are too
+  // many types to index it.
+  bool FindOrAddList(uint32_t type_id, size_t* list_index) {
+    DCHECK_NE(kTypeIdAny, type_id);
+    for (size_t probe = 0; probe < kMaxTypes; ++probe) {
+      const size_t index = (type_id + probe) % kMaxTypes;
+      uint32_t list_type_id =
+          lists_[index].type_id.load(std::memory_order_acquire);
+      if (list_type_id == kTypeIdAny &&
+          lists_[index].type_id.compare_exchange_strong(
+              list_type_id, type_id, std::memory_order_acq_rel,
+              std::memory_order_acquire)) {
+        list_type_id = type_id;
+      }
+      if (list_type_id == type_id) {
+        *list_index = index;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Stores the reference at |position| of the list at |list_index| in |ref|.
+  // Returns false if there is none yet.
+  bool GetReference(size_t list_index, size_t position, Reference* ref) {
+    List& list = lists_[list_index];
+    while (true) {
+      if (position < list.size.load(std::memory_order_acquire)) {
+        // The record was added to the list, but |ref| may not be written yet.
+        std::atomic<Reference>& entry = GetEntry(list, position);
+        while ((*ref = entry.load(std::memory_order_acquire)) == 0) {
+          PlatformThread::YieldCurrentThread();
+        }
+        return true;
+      }
+      if (IndexNextRecord()) {
+        continue;
+      }
+      // There are no more iterable records, but some may still be being
+      // indexed by other threads.
+      if (pending_records_.load(std::memory_order_acquire) == 0 &&
+          position >= list.size.load(std::memory_order_acquire)) {
+        return false;
+      }
+      PlatformThread::YieldCurrentThread();
+    }
+  }
+
+ private:
+  struct List {
+    std::atomic<uint32_t> type_id{kTypeIdAny};
+    // The number of positions reserved in the list.
+    std::atomic<size_t> size{0};
+    std::atomic<std::atomic<Reference>*> blocks[kMaxBlocks] = {};
+  };
+
+  // Adds the next record of |queue_iterator_| to the list of its type.
+  // Returns false if there are no more.
+  bool IndexNextRecord() {
+    pending_records_.fetch_add(1, std::memory_order_acq_rel);
+    uint32_t type_id;
+    const Reference ref = queue_iterator_.GetNext(&type_id);
+    size_t list_index;
+    // Free or transitioning records are only ever returned from the index if
+    // their type changes back, which it wouldn't reflect anyway.
+    if (ref && type_id != kTypeIdAny && type_id != kTypeIdTransitioning &&
+        FindOrAddList(type_id, &list_index)) {
+      List& list = lists_[list_index];
+      const size_t position = list.size.fetch_add(1, std::memory_order_acq_rel);
+      GetEntry(list, position).store(ref, std::memory_order_release);
+    }
+    pending_records_.fetch_sub(1, std::memory_order_acq_rel);
+    return ref != 0;
+  }
+
+  // Returns the entry at |position| of |list|, allocating its block if needed.
+  static std::atomic<Reference>& GetEntry(List& list, size_t position) {
+    const size_t block_index =
+        static_cast<size_t>(bits::Log2Floor(position / kFirstBlockSize + 1));
+    CHECK_LT(block_index, kMaxBlocks);
+    const size_t block_size = kFirstBlockSize << block_index;
+    std::atomic<Reference>* block =
+        list.blocks[block_index].load(std::memory_order_acquire);
+    if (!block) {
+      std::atomic<Reference>* new_block =
+          new std::atomic<Reference>[block_size]();
+      if (list.blocks[block_index].compare_exchange_strong(
+              block, new_block, std::memory_order_acq_rel,
+              std::memory_order_acquire)) {
+        block = new_block;
+      } else {
+        delete[] new_block;
+      }
+    }
+    return block[position - (block_size - kFirstBlockSize)];
+  }
+
+  // Finds the records to index. It is shared by all threads, so that each
+  // record is indexed once.
+  Iterator queue_iterator_;
+
+  // The number of records taken from |queue_iterator_| which are not yet in
+  // their list.
+  std::atomic<size_t> pending_records_{0};
+
+  List lists_[kMaxTypes];
+};
+
+PersistentMemoryAllocator::TypedIterator::TypedIterator(
+    const PersistentMemoryAllocator* allocator,
+    uint32_t type_id)
+    : allocator_(allocator),
+      type_id_(type_id),
+      fallback_iterator_(allocator) {
+  DCHECK_NE(kTypeIdAny, type_id);
+  DCHECK_NE(kTypeIdTransitioning, type_id);
+  TypeIndex* index = allocator->GetTypeIndex();
+  if (index->FindOrAddList(type_id, &list_)) {
+    index_ = index;
+  }
+}
+
+PersistentMemoryAllocator::TypedIterator::~TypedIterator() = default;
+
+PersistentMemoryAllocator::Reference
+PersistentMemoryAllocator::TypedIterator::GetNext() {
+  if (!index_) {
+    return fallback_iterator_.GetNextOfType(type_id_);
+  }
+
+  size_t position = position_.load(std::memory_order_relaxed);
+  Reference ref;
+  while (index_->GetReference(list_, position, &ref)) {
+    // Claim |position|. If it fails then another thread has already returned
+    // it, and |position| was updated, so try again.
+    if (!position_.compare_exchange_strong(position, position + 1,
+                                           std::memory_order_relaxed)) {
+      continue;
+    }
+    // The type may have changed since the record was indexed.
+    if (allocator_->GetType(ref) == type_id_) {
+      return ref;
+    }
+    ++position;
+  }
+  return kReferenceNull;
+}
+
 
 // static
 bool PersistentMemoryAllocator::IsMemoryAcceptable(const void* base,
@@ -466,7 +647,23 @@ PersistentMemoryAllocator::~PersistentMemoryAllocator() {
   // It's strictly forbidden to do any memory access here in case there is
   // some issue with the underlying memory segment. The "Local" allocator
   // makes use of this to allow deletion of the segment on the heap from
-  // within its destructor.
+  // within its destructor. The type index is only in the process heap.
+  delete type_index_.load(std::memory_order_acquire);
+}
+
+PersistentMemoryAllocator::TypeIndex* PersistentMemoryAllocator::GetTypeIndex()
+    const {
+  TypeIndex* index = type_index_.load(std::memory_order_acquire);
+  if (index) {
+    return index;
+  }
+  auto new_index = std::make_unique<TypeIndex>(this);
+  if (type_index_.compare_exchange_strong(index, new_index.get(),
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+    index = new_index.release();
+  }
+  return index;
 }
 
 uint64_t PersistentMemoryAllocator::Id() const {
@@ -267,6 +267,67 @@ class BASE_EXPORT PersistentMemoryAllocator {
     std::atomic<uint32_t> record_count_;
   };
 
+ private:
+  class TypeIndex;
+
+ public:
+  // Iterator for going through the iterable memory records of a single type,
+  // in place of Iterator::GetNextOfType(). The first time records are reached
+  // by any TypedIterator of an allocator, they are added to an in-process
+  // index of the records of each type, so that later calls, and all other
+  // TypedIterators of the allocator, only touch the records of their type.
+  // This matters for large segments, e.g. metrics files of previous sessions,
+  // which are searched for a few types of records many times.
+  //
+  // Like Iterator, this is lock-free and thread-safe. Records are indexed by
+  // their type when first reached, so unlike Iterator::GetNextOfType(), a
+  // record whose type is changed to |type_id| after that, rather than before
+  // being made iterable, isn't returned. Records whose type was changed from
+  // |type_id| since are skipped. If there are too many types of records to
+  // index, this falls back to an Iterator.
+  class BASE_EXPORT TypedIterator {
+   public:
+    // Constructs an iterator over the records of |type_id| in |allocator|,
+    // starting at the beginning. The allocator must live beyond the lifetime
+    // of the iterator.
+    TypedIterator(const PersistentMemoryAllocator* allocator, uint32_t type_id);
+
+    TypedIterator(const TypedIterator&) = delete;
+    TypedIterator& operator=(const TypedIterator&) = delete;
+
+    ~TypedIterator();
+
+    // Gets the next iterable record of the type, or zero if there are no more.
+    // GetNext() may still be called again at a later time to retrieve any new
+    // records that have been added.
+    Reference GetNext();
+
+    // As above but returns the object, or null if there are no more.
+    template <typename T>
+    const T* GetNextObject() {
+      DCHECK_EQ(T::kPersistentTypeId, type_id_);
+      return allocator_->GetAsObject<T>(GetNext());
+    }
+
+   private:
+    // Weak-pointer to memory allocator being iterated over.
+    raw_ptr<const PersistentMemoryAllocator> allocator_;
+
+    const uint32_t type_id_;
+
+    // The index of |allocator_|, and the list of the records of |type_id_| in
+    // it. |index_| is null if |type_id_| couldn't be indexed, in which case
+    // |fallback_iterator_| is used.
+    raw_ptr<TypeIndex> index_;
+    size_t list_ = 0;
+
+    // The position in |list_| of the next record to return.
+    std::atomic<size_t> position_{0};
+
+    // Used instead of the index if |type_id_| couldn't be indexed.
+    Iterator fallback_iterator_;
+  };
+
   // Returned information about the internal state of the heap.
   struct MemoryInfo {
     size_t total;
@@ -704,6 +765,9 @@ class BASE_EXPORT PersistentMemoryAllocator {
   struct BlockHeader;
   static const Reference kReferenceQueue;
 
+  // Returns the index used by TypedIterator, creating it if needed.
+  TypeIndex* GetTypeIndex() const;
+
   // The shared metadata is always located at the top of the memory segment.
   // These convenience functions eliminate constant casting of the base
   // pointer within the code.
@@ -758,6 +822,10 @@ class BASE_EXPORT PersistentMemoryAllocator {
   // Local version of "corrupted" flag.
   mutable std::atomic<bool> corrupt_ = false;
 
+  // The index of the records of each type used by TypedIterator. Created and
+  // populated lazily by TypedIterators; owned by this.
+  mutable std::atomic<TypeIndex*> type_index_{nullptr};
+
   // Histogram recording allocs.
   raw_ptr<HistogramBase> allocs_histogram_ = nullptr;
   // Histogram recording used space.
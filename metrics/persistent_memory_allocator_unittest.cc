@@ -10,6 +10,8 @@
 #include "base/metrics/persistent_memory_allocator.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_util.h"
@@ -548,6 +550,149 @@ TEST_F(PersistentMemoryAllocatorTest, IteratorParallelismTest) {
 #endif
 }
 
+TEST_F(PersistentMemoryAllocatorTest, TypedIteratorTest) {
+  // Interleave the records of several types.
+  std::vector<Reference> refs1;
+  std::vector<Reference> refs2;
+  for (int i = 0; i < 500; ++i) {
+    Reference ref1 = allocator_->Allocate(sizeof(TestObject1),
+                                          TestObject1::kPersistentTypeId);
+    Reference ref2 = allocator_->Allocate(sizeof(TestObject2),
+                                          TestObject2::kPersistentTypeId);
+    Reference ref3 = allocator_->Allocate(8, 3);
+    ASSERT_TRUE(ref1 && ref2 && ref3);
+    allocator_->MakeIterable(ref1);
+    allocator_->MakeIterable(ref2);
+    allocator_->MakeIterable(ref3);
+    refs1.push_back(ref1);
+    refs2.push_back(ref2);
+  }
+
+  // Records are returned in the order they were made iterable.
+  PersistentMemoryAllocator::TypedIterator iter1(
+      allocator_.get(), TestObject1::kPersistentTypeId);
+  for (Reference ref : refs1) {
+    EXPECT_EQ(ref, iter1.GetNext());
+  }
+  EXPECT_EQ(0U, iter1.GetNext());
+
+  PersistentMemoryAllocator::TypedIterator iter2(
+      allocator_.get(), TestObject2::kPersistentTypeId);
+  size_t count2 = 0;
+  while (const TestObject2* obj = iter2.GetNextObject<TestObject2>()) {
+    EXPECT_EQ(refs2[count2], allocator_->GetAsReference(obj));
+    ++count2;
+  }
+  EXPECT_EQ(refs2.size(), count2);
+
+  // New records are found by later calls.
+  Reference ref1 = allocator_->Allocate(sizeof(TestObject1),
+                                        TestObject1::kPersistentTypeId);
+  allocator_->MakeIterable(allocator_->Allocate(8, 3));
+  allocator_->MakeIterable(ref1);
+  EXPECT_EQ(ref1, iter1.GetNext());
+  EXPECT_EQ(0U, iter1.GetNext());
+  EXPECT_EQ(0U, iter2.GetNext());
+
+  // Records whose type changed are skipped.
+  EXPECT_TRUE(allocator_->ChangeType(refs1[0], 4,
+                                     TestObject1::kPersistentTypeId, false));
+  PersistentMemoryAllocator::TypedIterator iter3(
+      allocator_.get(), TestObject1::kPersistentTypeId);
+  EXPECT_EQ(refs1[1], iter3.GetNext());
+}
+
+TEST_F(PersistentMemoryAllocatorTest, TypedIteratorManyTypesTest) {
+  // More types than can be indexed.
+  std::vector<Reference> refs;
+  for (uint32_t type = 1000; type < 1100; ++type) {
+    Reference ref = allocator_->Allocate(8, type);
+    ASSERT_TRUE(ref);
+    allocator_->MakeIterable(ref);
+    refs.push_back(ref);
+  }
+
+  for (uint32_t type = 1000; type < 1100; ++type) {
+    PersistentMemoryAllocator::TypedIterator iter(allocator_.get(), type);
+    EXPECT_EQ(refs[type - 1000], iter.GetNext());
+    EXPECT_EQ(0U, iter.GetNext());
+  }
+}
+
+// A simple thread that counts objects by iterating with a TypedIterator.
+class TypedCounterThread : public SimpleThread {
+ public:
+  TypedCounterThread(const std::string& name,
+                     PersistentMemoryAllocator::TypedIterator* iterator)
+      : SimpleThread(name, Options()), iterator_(iterator) {}
+
+  TypedCounterThread(const TypedCounterThread&) = delete;
+  TypedCounterThread& operator=(const TypedCounterThread&) = delete;
+
+  void Run() override {
+    while (iterator_->GetNext() != 0) {
+      ++count_;
+    }
+  }
+
+  unsigned count() { return count_; }
+
+ private:
+  raw_ptr<PersistentMemoryAllocator::TypedIterator> iterator_;
+  unsigned count_ = 0;
+};
+
+// Ensure that parallel typed iteration, which also builds the index in
+// parallel, returns the same number of objects as single-threaded iteration.
+TEST_F(PersistentMemoryAllocatorTest, TypedIteratorParallelismTest) {
+  // Fill the memory segment with random allocations.
+  constexpr uint32_t kNumTypes = 5;
+  unsigned counts[kNumTypes] = {};
+  for (;;) {
+    uint32_t size = RandInt(1, 99);
+    uint32_t type = RandInt(0, kNumTypes - 1);
+    Reference block = allocator_->Allocate(size, 100 + type);
+    if (!block)
+      break;
+    allocator_->MakeIterable(block);
+    ++counts[type];
+  }
+  EXPECT_TRUE(allocator_->IsFull());
+
+  // Threads sharing an iterator of the first type, and threads with their own
+  // iterator of the other types.
+  PersistentMemoryAllocator::TypedIterator shared_iter(allocator_.get(), 100);
+  std::vector<std::unique_ptr<PersistentMemoryAllocator::TypedIterator>>
+      iters;
+  std::vector<std::unique_ptr<TypedCounterThread>> threads;
+  for (uint32_t i = 0; i < 4; ++i) {
+    threads.push_back(std::make_unique<TypedCounterThread>(
+        StringPrintf("shared%u", i), &shared_iter));
+  }
+  for (uint32_t type = 1; type < kNumTypes; ++type) {
+    iters.push_back(std::make_unique<PersistentMemoryAllocator::TypedIterator>(
+        allocator_.get(), 100 + type));
+    threads.push_back(std::make_unique<TypedCounterThread>(
+        StringPrintf("own%u", type), iters.back().get()));
+  }
+  for (auto& thread : threads) {
+    thread->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  unsigned shared_count = 0;
+  for (uint32_t i = 0; i < 4; ++i) {
+    shared_count += threads[i]->count();
+  }
+  EXPECT_EQ(counts[0], shared_count);
+  for (uint32_t type = 1; type < kNumTypes; ++type) {
+    EXPECT_EQ(counts[type], threads[3 + type]->count());
+  }
+  EXPECT_FALSE(allocator_->IsCorrupt());
+}
+
 TEST_F(PersistentMemoryAllocatorTest, DelayedAllocationTest) {
   std::atomic<Reference> ref1, ref2;
   ref1.store(0, std::memory_order_relaxed);
@@ -425,6 +425,15 @@ size_t SampleVectorBase::GetBucketIndex(Sample value) const {
     return static_cast<size_t>(value);
   }
 
+  // Log-linear ranges, e.g. of a QuantileSketchHistogram, have many buckets,
+  // but the bucket of |value| can also be computed directly.
+  if (const int precision = bucket_ranges_->log_linear_precision()) {
+    if (value >= maximum) {
+      return bucket_count - 1;
+    }
+    return BucketRanges::GetLogLinearBucketIndex(value, precision);
+  }
+
   size_t under = 0;
   size_t over = bucket_count;
   size_t mid;
@@ -4,6 +4,8 @@
 
 #include "base/metrics/statistics_recorder.h"
 
+#include <atomic>
+#include <memory>
 #include <string_view>
 
 #include "base/at_exit.h"
@@ -32,8 +34,44 @@ bool HistogramNameLesser(const base::HistogramBase* a,
   return strcmp(a->histogram_name(), b->histogram_name()) < 0;
 }
 
+// The initial capacity of a HistogramIndex. Indexes are kept at most half
+// full, so probing always ends on a free entry.
+constexpr size_t kInitialHistogramIndexCapacity = 1024;
+
 }  // namespace
 
+struct StatisticsRecorder::HistogramIndex {
+  struct Entry {
+    // The name hash of |histogram|, or 0 if the entry is free. Set once.
+    std::atomic<uint64_t> hash{0};
+    // Null if the histogram was unregistered.
+    std::atomic<HistogramBase*> histogram{nullptr};
+  };
+
+  explicit HistogramIndex(size_t capacity)
+      : mask(capacity - 1), entries(new Entry[capacity]) {
+    DCHECK_EQ(0u, capacity & mask);
+  }
+
+  // Returns the entry with |hash|, or the free entry where it belongs.
+  Entry& Probe(uint64_t hash) const {
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const uint64_t entry_hash =
+          entries[i].hash.load(std::memory_order_acquire);
+      if (entry_hash == hash || entry_hash == 0) {
+        return entries[i];
+      }
+    }
+  }
+
+  size_t capacity() const { return mask + 1; }
+
+  const size_t mask;
+  const std::unique_ptr<Entry[]> entries;
+  // The number of used entries. Only accessed while holding GetLock().
+  size_t size = 0;
+};
+
 // static
 LazyInstance<Lock>::Leaky StatisticsRecorder::lock_ = LAZY_INSTANCE_INITIALIZER;
 
@@ -48,6 +86,10 @@ StatisticsRecorder::SnapshotTransactionId
 // static
 StatisticsRecorder* StatisticsRecorder::top_ = nullptr;
 
+// static
+std::atomic<const StatisticsRecorder::HistogramIndex*>
+    StatisticsRecorder::top_histogram_index_{nullptr};
+
 // static
 bool StatisticsRecorder::is_vlog_initialized_ = false;
 
@@ -81,6 +123,11 @@ StatisticsRecorder::~StatisticsRecorder() {
   const AutoLock auto_lock(GetLock());
   DCHECK_EQ(this, top_);
   top_ = previous_;
+  top_histogram_index_.store(
+      top_ && !top_->histogram_indexes_.empty()
+          ? top_->histogram_indexes_.back().get()
+          : nullptr,
+      std::memory_order_release);
 }
 
 // static
@@ -126,6 +173,7 @@ HistogramBase* StatisticsRecorder::RegisterOrDeleteDuplicate(
 
   if (!registered) {
     registered = histogram;
+    top_->SetInHistogramIndex(hash, histogram);
     ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
     // If there are callbacks for this histogram, we set the kCallbackExists
     // flag.
@@ -235,6 +283,15 @@ HistogramBase* StatisticsRecorder::FindHistogram(std::string_view name) {
   // will acquire the lock at that time.
   ImportGlobalPersistentHistograms();
 
+  // Histograms are looked up on every call of the UmaHistogram*() functions,
+  // so avoid contending on the lock when they are already registered.
+  if (HistogramBase* histogram = FindHistogramByHashLockFree(hash)) {
+    DCHECK_EQ(name, histogram->histogram_name())
+        << "Histogram name hash collision between " << name << " and "
+        << histogram->histogram_name() << " (hash = " << hash << ")";
+    return histogram;
+  }
+
   const AutoLock auto_lock(GetLock());
 
   // Manipulate |top_| through a const variable to ensure it is not mutated.
@@ -343,6 +400,78 @@ HistogramBase* StatisticsRecorder::FindHistogramByHashInternal(
   return it->second;
 }
 
+// static
+HistogramBase* StatisticsRecorder::FindHistogramByHashLockFree(uint64_t hash) {
+  const HistogramIndex* index =
+      top_histogram_index_.load(std::memory_order_acquire);
+  if (!index || hash == 0) {
+    return nullptr;
+  }
+  // Probe() also returns free entries, whose histogram may be in the middle of
+  // being published for another hash: only trust the histogram once the
+  // entry's hash is |hash|, since the hash is stored after the histogram.
+  const HistogramIndex::Entry& entry = index->Probe(hash);
+  if (entry.hash.load(std::memory_order_acquire) != hash) {
+    return nullptr;
+  }
+  return entry.histogram.load(std::memory_order_acquire);
+}
+
+void StatisticsRecorder::SetInHistogramIndex(uint64_t hash,
+                                             HistogramBase* histogram) {
+  AssertLockHeld();
+  // 0 marks free entries, so histograms with that hash are only found by
+  // FindHistogramByHashInternal().
+  if (hash == 0) {
+    return;
+  }
+
+  if (histogram_indexes_.empty()) {
+    histogram_indexes_.push_back(
+        std::make_unique<HistogramIndex>(kInitialHistogramIndexCapacity));
+  }
+  HistogramIndex* index = histogram_indexes_.back().get();
+  if (histogram && (index->size + 1) * 2 > index->capacity()) {
+    // Readers never block writers, so the index can't be grown in place.
+    // Copy it instead, and keep the previous one alive for readers still
+    // probing it; they'll fall back to the locked lookup if they miss.
+    auto grown_index = std::make_unique<HistogramIndex>(index->capacity() * 2);
+    for (size_t i = 0; i < index->capacity(); ++i) {
+      const HistogramIndex::Entry& entry = index->entries[i];
+      HistogramBase* entry_histogram =
+          entry.histogram.load(std::memory_order_relaxed);
+      if (!entry_histogram) {
+        continue;
+      }
+      const uint64_t entry_hash = entry.hash.load(std::memory_order_relaxed);
+      HistogramIndex::Entry& grown_entry = grown_index->Probe(entry_hash);
+      grown_entry.histogram.store(entry_histogram, std::memory_order_relaxed);
+      grown_entry.hash.store(entry_hash, std::memory_order_relaxed);
+      ++grown_index->size;
+    }
+    index = grown_index.get();
+    histogram_indexes_.push_back(std::move(grown_index));
+  }
+
+  HistogramIndex::Entry& entry = index->Probe(hash);
+  if (entry.hash.load(std::memory_order_relaxed) == 0) {
+    if (!histogram) {
+      return;
+    }
+    // Publish the histogram before the hash, so that readers which find the
+    // hash also find the histogram.
+    entry.histogram.store(histogram, std::memory_order_release);
+    entry.hash.store(hash, std::memory_order_release);
+    ++index->size;
+  } else {
+    entry.histogram.store(histogram, std::memory_order_release);
+  }
+
+  if (top_ == this) {
+    top_histogram_index_.store(index, std::memory_order_release);
+  }
+}
+
 // static
 void StatisticsRecorder::AddHistogramSampleObserver(
     const std::string& name,
@@ -481,6 +610,7 @@ void StatisticsRecorder::ForgetHistogramForTesting(std::string_view name) {
   // This performs another lookup in the map, but this is fine since this is
   // only used in tests.
   top_->histograms_.erase(hash);
+  top_->SetInHistogramIndex(hash, nullptr);
 }
 
 // static
@@ -593,6 +723,7 @@ StatisticsRecorder::StatisticsRecorder() {
   AssertLockHeld();
   previous_ = top_;
   top_ = this;
+  top_histogram_index_.store(nullptr, std::memory_order_release);
   InitLogOnShutdownWhileLocked();
 }
 
@@ -334,6 +334,21 @@ class BASE_EXPORT StatisticsRecorder {
                                              std::string_view name) const
       EXCLUSIVE_LOCKS_REQUIRED(GetLock());
 
+  // An open-addressing index of |histograms_| by name hash, which can be read
+  // without acquiring GetLock(). Defined in the .cc file.
+  struct HistogramIndex;
+
+  // Returns the histogram registered with |hash| in the index of the current
+  // global recorder, without acquiring GetLock(). Returns nullptr if there is
+  // none, or if it was registered concurrently; callers must then fall back to
+  // FindHistogramByHashInternal().
+  static HistogramBase* FindHistogramByHashLockFree(uint64_t hash);
+
+  // Sets the histogram registered with |hash| in |histogram_indexes_|, growing
+  // the index if needed. A null |histogram| unregisters it.
+  void SetInHistogramIndex(uint64_t hash, HistogramBase* histogram)
+      EXCLUSIVE_LOCKS_REQUIRED(GetLock());
+
   // Adds an observer to be notified when a new sample is recorded on
   // the histogram referred to by |histogram_name|. Observers added
   // while sending out notification are not notified. Can be called
@@ -396,6 +411,12 @@ class BASE_EXPORT StatisticsRecorder {
       EXCLUSIVE_LOCKS_REQUIRED(GetLock());
 
   HistogramMap histograms_;
+
+  // Indexes of |histograms_|, the last one being current. Indexes replaced
+  // when growing are kept until this recorder is destroyed, since lock-free
+  // readers may still be probing them.
+  std::vector<std::unique_ptr<HistogramIndex>> histogram_indexes_
+      GUARDED_BY(GetLock());
   ObserverMap observers_;
   HistogramProviders providers_;
   RangesManager ranges_manager_;
@@ -423,6 +444,10 @@ class BASE_EXPORT StatisticsRecorder {
   // previous global recorder is referenced by top_->previous_.
   static StatisticsRecorder* top_ GUARDED_BY(GetLock());
 
+  // The current index of |top_|, or null if it has none. Written while holding
+  // GetLock(), and read without it by FindHistogramByHashLockFree().
+  static std::atomic<const HistogramIndex*> top_histogram_index_;
+
   // Tracks whether InitLogOnShutdownWhileLocked() has registered a logging
   // function that will be called when the program finishes.
   static bool is_vlog_initialized_;
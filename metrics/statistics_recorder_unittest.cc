@@ -21,6 +21,7 @@
 #include "base/metrics/persistent_histogram_allocator.h"
 #include "base/metrics/record_histogram_checker.h"
 #include "base/metrics/sparse_histogram.h"
+#include "base/strings/stringprintf.h"
 #include "base/test/task_environment.h"
 #include "base/values.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -246,6 +247,33 @@ TEST_P(StatisticsRecorderTest, FindHistogram) {
   EXPECT_FALSE(StatisticsRecorder::FindHistogram("TestHistogram"));
 }
 
+// Check that histograms are found as the lock-free index grows, and aren't
+// found once forgotten.
+TEST_P(StatisticsRecorderTest, FindManyHistograms) {
+  constexpr int kNumHistograms = 1500;
+  std::vector<HistogramBase*> histograms;
+  for (int i = 0; i < kNumHistograms; ++i) {
+    histograms.push_back(
+        Histogram::FactoryGet(StringPrintf("TestHistogram%d", i), 1, 1000, 10,
+                              HistogramBase::kNoFlags));
+    // Look up a previous histogram, which may be in a replaced index.
+    EXPECT_EQ(histograms[i / 2], StatisticsRecorder::FindHistogram(
+                                     StringPrintf("TestHistogram%d", i / 2)));
+  }
+  for (int i = 0; i < kNumHistograms; ++i) {
+    EXPECT_EQ(histograms[i], StatisticsRecorder::FindHistogram(
+                                 StringPrintf("TestHistogram%d", i)));
+  }
+
+  StatisticsRecorder::ForgetHistogramForTesting("TestHistogram1");
+  EXPECT_FALSE(StatisticsRecorder::FindHistogram("TestHistogram1"));
+  EXPECT_EQ(histograms[2], StatisticsRecorder::FindHistogram("TestHistogram2"));
+
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "TestHistogram1", 1, 1000, 10, HistogramBase::kNoFlags);
+  EXPECT_EQ(histogram, StatisticsRecorder::FindHistogram("TestHistogram1"));
+}
+
 TEST_P(StatisticsRecorderTest, WithName) {
   Histogram::FactoryGet("TestHistogram1", 1, 1000, 10, Histogram::kNoFlags);
   Histogram::FactoryGet("TestHistogram2", 1, 1000, 10, Histogram::kNoFlags);
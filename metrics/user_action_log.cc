@@ -0,0 +1,231 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/user_action_log.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/memory/raw_ptr.h"
+#include "base/metrics/metrics_hashes.h"
+#include "base/metrics/persistent_memory_allocator.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace {
+
+// The ring buffer of records of a thread. It has a single producer, the
+// thread which owns it, and a single consumer, Drain(). Indices increase
+// forever, wrapping around, and are reduced modulo `kRecordsPerThread` to
+// index `records`.
+struct ThreadBuffer {
+  // SHA1(UserActionLogBuffer): Increment this if structure changes!
+  static constexpr uint32_t kPersistentTypeId = 0xB548A369 + 1;
+
+  // Expected size for 32/64-bit check. Update this if structure changes!
+  static constexpr size_t kExpectedInstanceSize =
+      16 + 16 * UserActionLog::kRecordsPerThread;
+
+  enum State : uint32_t {
+    kFree = 0,
+    kInUse = 1,
+    // Forgotten by ResetForTesting().
+    kAbandoned = 2,
+  };
+
+  // Only written by the owning thread.
+  std::atomic<uint32_t> write_index;
+  // Only written by Drain().
+  std::atomic<uint32_t> read_index;
+  std::atomic<uint32_t> num_dropped;
+  std::atomic<uint32_t> state;
+  std::array<UserActionLog::Record, UserActionLog::kRecordsPerThread> records;
+};
+
+static_assert(std::is_trivially_copyable_v<UserActionLog::Record>);
+static_assert(sizeof(UserActionLog::Record) == 16);
+
+// Passes the records between `read_index` and `write_index` of `buffer` to
+// `consumer`, and returns the index up to which they were read.
+uint32_t ReadRecords(const ThreadBuffer& buffer,
+                     uint32_t read_index,
+                     UserActionLog::Consumer consumer) {
+  const uint32_t write_index =
+      buffer.write_index.load(std::memory_order_acquire);
+  // Guard against corrupt persistent memory.
+  const uint32_t count = std::min<uint32_t>(write_index - read_index,
+                                            UserActionLog::kRecordsPerThread);
+  const span<const UserActionLog::Record> records(buffer.records);
+  const size_t begin = read_index % records.size();
+  const size_t first_count = std::min<size_t>(count, records.size() - begin);
+  if (first_count > 0) {
+    consumer(records.subspan(begin, first_count));
+  }
+  if (count > first_count) {
+    consumer(records.first(count - first_count));
+  }
+  return read_index + count;
+}
+
+std::atomic<bool> g_enabled{false};
+
+struct LogState {
+  Lock lock;
+  raw_ptr<PersistentMemoryAllocator> allocator GUARDED_BY(lock) = nullptr;
+  // The buffers of all threads.
+  std::vector<raw_ptr<ThreadBuffer>> buffers GUARDED_BY(lock);
+  // The buffers allocated on the heap, which are never freed since threads
+  // may still access them.
+  std::vector<std::unique_ptr<ThreadBuffer>> heap_buffers GUARDED_BY(lock);
+
+  // Serializes calls to Drain().
+  Lock drain_lock;
+};
+
+LogState& GetLogState() {
+  static NoDestructor<LogState> state;
+  return *state;
+}
+
+ThreadLocalStorage::Slot& GetThreadBufferSlot() {
+  static NoDestructor<ThreadLocalStorage::Slot> slot([](void* buffer) {
+    // Let another thread reuse the buffer, unless it was abandoned.
+    uint32_t in_use = ThreadBuffer::kInUse;
+    static_cast<ThreadBuffer*>(buffer)->state.compare_exchange_strong(
+        in_use, ThreadBuffer::kFree, std::memory_order_release,
+        std::memory_order_relaxed);
+  });
+  return *slot;
+}
+
+// Returns a buffer for the current thread, reusing one of an exited thread if
+// possible.
+ThreadBuffer* ClaimThreadBuffer() {
+  LogState& state = GetLogState();
+  AutoLock lock(state.lock);
+  for (ThreadBuffer* buffer : state.buffers) {
+    uint32_t free = ThreadBuffer::kFree;
+    if (buffer->state.compare_exchange_strong(free, ThreadBuffer::kInUse,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+      return buffer;
+    }
+  }
+
+  ThreadBuffer* buffer = nullptr;
+  if (state.allocator) {
+    buffer = state.allocator->New<ThreadBuffer>();
+  }
+  if (!buffer) {
+    state.heap_buffers.push_back(std::make_unique<ThreadBuffer>());
+    buffer = state.heap_buffers.back().get();
+  }
+  buffer->state.store(ThreadBuffer::kInUse, std::memory_order_relaxed);
+  state.buffers.push_back(buffer);
+  return buffer;
+}
+
+}  // namespace
+
+// static
+void UserActionLog::Enable(PersistentMemoryAllocator* allocator) {
+  LogState& state = GetLogState();
+  {
+    AutoLock lock(state.lock);
+    state.allocator = allocator;
+  }
+  const bool was_enabled = g_enabled.exchange(true, std::memory_order_relaxed);
+  DCHECK(!was_enabled);
+}
+
+// static
+bool UserActionLog::IsEnabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+// static
+size_t UserActionLog::Drain(Consumer consumer) {
+  LogState& state = GetLogState();
+  AutoLock drain_lock(state.drain_lock);
+  std::vector<ThreadBuffer*> buffers;
+  {
+    AutoLock lock(state.lock);
+    buffers.assign(state.buffers.begin(), state.buffers.end());
+  }
+
+  size_t num_dropped = 0;
+  for (ThreadBuffer* buffer : buffers) {
+    const uint32_t read_index = ReadRecords(
+        *buffer, buffer->read_index.load(std::memory_order_relaxed), consumer);
+    // Let the owning thread overwrite the records which were read.
+    buffer->read_index.store(read_index, std::memory_order_release);
+    num_dropped += buffer->num_dropped.exchange(0, std::memory_order_relaxed);
+  }
+  return num_dropped;
+}
+
+// static
+void UserActionLog::ReadFromAllocator(
+    const PersistentMemoryAllocator* allocator,
+    Consumer consumer) {
+  PersistentMemoryAllocator::Iterator iter(allocator);
+  while (const ThreadBuffer* buffer = iter.GetNextOfObject<ThreadBuffer>()) {
+    ReadRecords(*buffer, buffer->read_index.load(std::memory_order_acquire),
+                consumer);
+  }
+}
+
+// static
+void UserActionLog::Append(std::string_view action, TimeTicks action_time) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  ThreadLocalStorage::Slot& slot = GetThreadBufferSlot();
+  ThreadBuffer* buffer = static_cast<ThreadBuffer*>(slot.Get());
+  if (!buffer || buffer->state.load(std::memory_order_relaxed) ==
+                     ThreadBuffer::kAbandoned) {
+    buffer = ClaimThreadBuffer();
+    slot.Set(buffer);
+  }
+
+  const uint32_t write_index =
+      buffer->write_index.load(std::memory_order_relaxed);
+  // Acquire so that the consumer is done reading the record to overwrite.
+  const uint32_t read_index =
+      buffer->read_index.load(std::memory_order_acquire);
+  if (write_index - read_index >= kRecordsPerThread) {
+    buffer->num_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->records[write_index % kRecordsPerThread] = {HashMetricName(action),
+                                                      action_time};
+  buffer->write_index.store(write_index + 1, std::memory_order_release);
+}
+
+// static
+void UserActionLog::ResetForTesting() {
+  g_enabled.store(false, std::memory_order_relaxed);
+  LogState& state = GetLogState();
+  AutoLock drain_lock(state.drain_lock);
+  AutoLock lock(state.lock);
+  for (ThreadBuffer* buffer : state.buffers) {
+    buffer->state.store(ThreadBuffer::kAbandoned, std::memory_order_relaxed);
+  }
+  // The buffers may still be referenced by threads, so `heap_buffers` keeps
+  // them.
+  state.buffers.clear();
+  state.allocator = nullptr;
+}
+
+}  // namespace base
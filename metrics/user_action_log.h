@@ -0,0 +1,86 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_METRICS_USER_ACTION_LOG_H_
+#define BASE_METRICS_USER_ACTION_LOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string_view>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/functional/function_ref.h"
+#include "base/time/time.h"
+
+namespace base {
+
+class PersistentMemoryAllocator;
+
+// A log of the user actions recorded with RecordAction() and friends, for
+// consumers which process actions in batches, e.g. to upload them. Unlike
+// action callbacks (see AddActionCallback()), logging an action neither posts
+// a task nor copies its name: each thread appends a (name hash, time) record
+// to a fixed-size ring buffer of its own, without locks, and Drain() reads the
+// records of all threads.
+//
+// Records are dropped while a thread's buffer is full, so Drain() must be
+// called regularly. If the buffers are allocated in persistent memory, the
+// records which weren't drained, e.g. because of a crash, can be read from it
+// afterwards with ReadFromAllocator(). Example:
+//
+//   UserActionLog::Enable(GlobalHistogramAllocator::Get()->memory_allocator());
+//   ...
+//   // Periodically:
+//   UserActionLog::Drain([&](span<const UserActionLog::Record> records) {
+//     for (const UserActionLog::Record& record : records) {
+//       ...
+//     }
+//   });
+class BASE_EXPORT UserActionLog {
+ public:
+  struct Record {
+    // The HashMetricName() of the action name, as used by UMA.
+    uint64_t action_hash;
+    TimeTicks action_time;
+  };
+
+  using Consumer = FunctionRef<void(span<const Record>)>;
+
+  // The capacity of the buffer of each thread.
+  static constexpr size_t kRecordsPerThread = 256;
+
+  UserActionLog() = delete;
+
+  // Starts logging actions. If `allocator` isn't null, the buffers of threads
+  // are allocated in it, falling back to the heap once it is full; it must
+  // outlive the process. Must be called at most once.
+  static void Enable(PersistentMemoryAllocator* allocator = nullptr);
+  static bool IsEnabled();
+
+  // Passes the records logged since the previous call to `consumer`, in
+  // batches of consecutive records of a thread. Must not be called from
+  // `consumer`. Returns the number of records which were dropped since the
+  // previous call because a buffer was full.
+  static size_t Drain(Consumer consumer);
+
+  // Passes the records which weren't drained from the buffers in `allocator`
+  // to `consumer`, e.g. to recover them from the persistent memory of a
+  // previous session.
+  static void ReadFromAllocator(const PersistentMemoryAllocator* allocator,
+                                Consumer consumer);
+
+  // Logs `action` on the current thread if logging is enabled. Called by
+  // RecordComputedActionAt(); there is no need to call it directly.
+  static void Append(std::string_view action, TimeTicks action_time);
+
+  // Stops logging actions and forgets the logged records. The buffers of
+  // threads are leaked, so this must not be called often.
+  static void ResetForTesting();
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_USER_ACTION_LOG_H_
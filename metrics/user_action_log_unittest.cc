@@ -0,0 +1,130 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/user_action_log.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/functional/bind.h"
+#include "base/metrics/metrics_hashes.h"
+#include "base/metrics/persistent_memory_allocator.h"
+#include "base/metrics/user_metrics.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class UserActionLogTest : public testing::Test {
+ protected:
+  UserActionLogTest() { UserActionLog::ResetForTesting(); }
+  ~UserActionLogTest() override { UserActionLog::ResetForTesting(); }
+
+  // Drains the log into `records_`, and returns the number of dropped
+  // records.
+  size_t Drain() {
+    records_.clear();
+    return UserActionLog::Drain(
+        [this](span<const UserActionLog::Record> records) {
+          records_.insert(records_.end(), records.begin(), records.end());
+        });
+  }
+
+  std::vector<UserActionLog::Record> records_;
+};
+
+TEST_F(UserActionLogTest, Disabled) {
+  RecordComputedActionAt("Test.Action", TimeTicks::Now());
+  EXPECT_EQ(0u, Drain());
+  EXPECT_TRUE(records_.empty());
+}
+
+TEST_F(UserActionLogTest, RecordAndDrain) {
+  UserActionLog::Enable();
+  const TimeTicks now = TimeTicks::Now();
+  RecordComputedActionAt("Test.Action1", now);
+  RecordComputedActionAt("Test.Action2", now + Seconds(1));
+
+  EXPECT_EQ(0u, Drain());
+  ASSERT_EQ(2u, records_.size());
+  EXPECT_EQ(HashMetricName("Test.Action1"), records_[0].action_hash);
+  EXPECT_EQ(now, records_[0].action_time);
+  EXPECT_EQ(HashMetricName("Test.Action2"), records_[1].action_hash);
+  EXPECT_EQ(now + Seconds(1), records_[1].action_time);
+
+  // Records are only drained once.
+  EXPECT_EQ(0u, Drain());
+  EXPECT_TRUE(records_.empty());
+}
+
+TEST_F(UserActionLogTest, FullBuffer) {
+  UserActionLog::Enable();
+  const TimeTicks now = TimeTicks::Now();
+  for (size_t i = 0; i < UserActionLog::kRecordsPerThread + 5; ++i) {
+    RecordComputedActionAt("Test.Action", now + Microseconds(i));
+  }
+  EXPECT_EQ(5u, Drain());
+  ASSERT_EQ(UserActionLog::kRecordsPerThread, records_.size());
+  EXPECT_EQ(now, records_.front().action_time);
+
+  // The buffer wraps around once drained.
+  for (size_t i = 0; i < 10; ++i) {
+    RecordComputedActionAt("Test.Action", now + Microseconds(i));
+  }
+  EXPECT_EQ(0u, Drain());
+  ASSERT_EQ(10u, records_.size());
+  for (size_t i = 0; i < records_.size(); ++i) {
+    EXPECT_EQ(now + Microseconds(i), records_[i].action_time);
+  }
+}
+
+TEST_F(UserActionLogTest, ManyThreads) {
+  UserActionLog::Enable();
+  constexpr size_t kNumThreads = 4;
+  const TimeTicks now = TimeTicks::Now();
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    Thread thread("UserActionLogTest");
+    ASSERT_TRUE(thread.Start());
+    thread.task_runner()->PostTask(
+        FROM_HERE, BindOnce(&RecordComputedActionAt, "Test.Action", now));
+    thread.Stop();
+  }
+  RecordComputedActionAt("Test.Action", now);
+
+  EXPECT_EQ(0u, Drain());
+  EXPECT_EQ(kNumThreads + 1, records_.size());
+}
+
+TEST_F(UserActionLogTest, PersistentMemory) {
+  LocalPersistentMemoryAllocator allocator(64 << 10, 0, "");
+  UserActionLog::Enable(&allocator);
+  const TimeTicks now = TimeTicks::Now();
+  RecordComputedActionAt("Test.Action", now);
+
+  // The records which weren't drained are found in the allocator, e.g. after
+  // a crash.
+  std::vector<UserActionLog::Record> records;
+  UserActionLog::ReadFromAllocator(
+      &allocator, [&records](span<const UserActionLog::Record> batch) {
+        records.insert(records.end(), batch.begin(), batch.end());
+      });
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(HashMetricName("Test.Action"), records[0].action_hash);
+  EXPECT_EQ(now, records[0].action_time);
+
+  EXPECT_EQ(0u, Drain());
+  EXPECT_EQ(1u, records_.size());
+  records.clear();
+  UserActionLog::ReadFromAllocator(
+      &allocator, [&records](span<const UserActionLog::Record> batch) {
+        records.insert(records.end(), batch.begin(), batch.end());
+      });
+  EXPECT_TRUE(records.empty());
+}
+
+}  // namespace base
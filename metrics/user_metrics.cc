@@ -6,11 +6,13 @@
 
 #include <stddef.h>
 
+#include <atomic>
 #include <vector>
 
 #include "base/functional/bind.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
+#include "base/metrics/user_action_log.h"
 #include "base/ranges/algorithm.h"
 #include "base/threading/thread_checker.h"
 #include "base/time/time.h"
@@ -23,6 +25,14 @@ LazyInstance<std::vector<ActionCallback>>::DestructorAtExit g_callbacks =
     LAZY_INSTANCE_INITIALIZER;
 LazyInstance<scoped_refptr<SingleThreadTaskRunner>>::DestructorAtExit
     g_task_runner = LAZY_INSTANCE_INITIALIZER;
+// The size of `g_callbacks`, which can be read from any thread.
+std::atomic<size_t> g_num_callbacks{0};
+
+void RunActionCallbacks(const std::string& action, TimeTicks action_time) {
+  for (const ActionCallback& callback : g_callbacks.Get()) {
+    callback.Run(action, action_time);
+  }
+}
 
 }  // namespace
 
@@ -42,20 +52,24 @@ void RecordComputedActionSince(const std::string& action,
 void RecordComputedActionAt(const std::string& action, TimeTicks action_time) {
   TRACE_EVENT_INSTANT1("ui", "UserEvent", TRACE_EVENT_SCOPE_GLOBAL, "action",
                        action);
+  UserActionLog::Append(action, action_time);
   if (!g_task_runner.Get()) {
     DCHECK(g_callbacks.Get().empty());
     return;
   }
 
   if (!g_task_runner.Get()->BelongsToCurrentThread()) {
+    // Don't post tasks for nothing, e.g. if actions are only consumed from
+    // UserActionLog.
+    if (g_num_callbacks.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
     g_task_runner.Get()->PostTask(
-        FROM_HERE, BindOnce(&RecordComputedActionAt, action, action_time));
+        FROM_HERE, BindOnce(&RunActionCallbacks, action, action_time));
     return;
   }
 
-  for (const ActionCallback& callback : g_callbacks.Get()) {
-    callback.Run(action, action_time);
-  }
+  RunActionCallbacks(action, action_time);
 }
 
 void AddActionCallback(const ActionCallback& callback) {
@@ -63,6 +77,7 @@ void AddActionCallback(const ActionCallback& callback) {
   DCHECK(g_task_runner.Get());
   DCHECK(g_task_runner.Get()->BelongsToCurrentThread());
   g_callbacks.Get().push_back(callback);
+  g_num_callbacks.store(g_callbacks.Get().size(), std::memory_order_relaxed);
 }
 
 void RemoveActionCallback(const ActionCallback& callback) {
@@ -72,6 +87,7 @@ void RemoveActionCallback(const ActionCallback& callback) {
   const auto i = ranges::find(*callbacks, callback);
   if (i != callbacks->end())
     callbacks->erase(i);
+  g_num_callbacks.store(callbacks->size(), std::memory_order_relaxed);
 }
 
 void SetRecordActionTaskRunner(
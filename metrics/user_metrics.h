@@ -72,7 +72,9 @@ using ActionCallback = RepeatingCallback<void(const std::string&, TimeTicks)>;
 
 // Add/remove action callbacks (see above).
 // These functions must be called after the task runner has been set with
-// SetRecordActionTaskRunner().
+// SetRecordActionTaskRunner(). Actions recorded on other threads are posted to
+// it to run the callbacks, which is costly for frequent actions: consumers
+// which can process actions in batches should use UserActionLog instead.
 BASE_EXPORT void AddActionCallback(const ActionCallback& callback);
 BASE_EXPORT void RemoveActionCallback(const ActionCallback& callback);
 
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "base/check_op.h"
+#include "base/containers/span.h"
 #include "base/memory/raw_ref.h"
 #include "base/time/time.h"
 
@@ -43,6 +44,7 @@ namespace base {
 //
 // Window update (available for all templates):
 //   AddSample(T value) const;
+//   AddSamples(span<const T> values);
 //   size_t Count() const;
 //   void Reset();
 //
@@ -54,6 +56,7 @@ namespace base {
 //
 // Available for MovingWindowFeatures::Mean:
 //    U Mean<U>() const;
+//    auto Sum() const;
 //
 // Available for MovingWindowFeatures::Deviation:
 //    U Deviation<U>() const;
@@ -524,7 +527,8 @@ class MovingWindow {
         max_impl_(window_size),
         mean_impl_(window_size),
         deviation_impl_(window_size),
-        window_impl_(window_size) {}
+        window_impl_(window_size),
+        window_size_(window_size) {}
 
   // Adds sample to the window.
   void AddSample(const T& sample) {
@@ -538,6 +542,25 @@ class MovingWindow {
     window_impl_.AddSample(sample);
   }
 
+  // Adds `samples` to the window, in order. Equivalent to calling AddSample()
+  // on each of them, but samples which would leave the window before the end
+  // of `samples` are only counted, so this costs O(window size) at most.
+  void AddSamples(span<const T> samples) {
+    if (samples.size() >= window_size_) {
+      // The window will only hold the tail of `samples`: start from an empty
+      // window rather than replacing each stale sample one by one. This also
+      // gets rid of the rounding errors accumulated by floating point sums.
+      const size_t total_added =
+          total_added_ + (samples.size() - window_size_);
+      Reset();
+      total_added_ = total_added;
+      samples = samples.last(window_size_);
+    }
+    for (const T& sample : samples) {
+      AddSample(sample);
+    }
+  }
+
   // Returns amount of elementes so far in the stream (might be bigger than the
   // window size).
   size_t Count() const { return total_added_; }
@@ -566,6 +589,14 @@ class MovingWindow {
         std::min(total_added_, window_impl_.Size()));
   }
 
+  // Returns the sum of the samples in the window, of the `SumType` of the Mean
+  // feature.
+  auto Sum() const
+    requires internal::has_member_mean<EnabledFeatures>
+  {
+    return mean_impl_.Sum();
+  }
+
   // Calculates deviation in the window.
   // `ReturnType` can be used to adjust the type of the calculated deviation
   // value; if not specified, uses `T` by default.
@@ -708,6 +739,7 @@ class MovingWindow {
                      internal::MovingWindowBase<T>,
                      internal::NullWindowImpl<T>>
       window_impl_;
+  const size_t window_size_;
   // Total number of added elements.
   size_t total_added_ = 0;
 };
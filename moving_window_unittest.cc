@@ -206,4 +206,50 @@ TEST(MovingMeanDeviation, WorksWithTimeDelta) {
   EXPECT_EQ(window.Deviation(), base::Seconds(10));
 }
 
+TEST(MovingWindowTest, AddSamples) {
+  const size_t kWindowSize = 10;
+  using Window = MovingWindow<int,
+                              MovingWindowFeatures::Min,
+                              MovingWindowFeatures::Max,
+                              MovingWindowFeatures::Mean<int64_t>,
+                              MovingWindowFeatures::Iteration>;
+  Window bulk_window(kWindowSize);
+  Window window(kWindowSize);
+  // Add batches smaller, equal and bigger than the window.
+  const span<const int> values(kTestValues);
+  size_t offset = 0;
+  for (size_t batch_size : {1u, 3u, 10u, 0u, 7u, 25u, 9u}) {
+    ASSERT_LE(offset + batch_size, values.size());
+    const span<const int> batch = values.subspan(offset, batch_size);
+    offset += batch_size;
+    bulk_window.AddSamples(batch);
+    for (int value : batch) {
+      window.AddSample(value);
+    }
+    EXPECT_EQ(bulk_window.Count(), window.Count());
+    EXPECT_EQ(bulk_window.Min(), window.Min());
+    EXPECT_EQ(bulk_window.Max(), window.Max());
+    EXPECT_EQ(bulk_window.Mean(), window.Mean());
+    EXPECT_EQ(bulk_window.Sum(), window.Sum());
+    EXPECT_EQ(bulk_window.size(), window.size());
+    auto it = window.begin();
+    for (int value : bulk_window) {
+      ASSERT_NE(it, window.end());
+      EXPECT_EQ(value, *it);
+      ++it;
+    }
+    EXPECT_EQ(it, window.end());
+  }
+}
+
+TEST(MovingWindowTest, AddSamplesResetsRunningSum) {
+  MovingAverage<double, double> window(2);
+  window.AddSample(1e20);
+  window.AddSample(1.0);
+  const double kSamples[] = {1.0, 2.0, 4.0};
+  window.AddSamples(kSamples);
+  EXPECT_EQ(window.Count(), 5u);
+  EXPECT_EQ(window.Mean(), 3.0);
+}
+
 }  // namespace base
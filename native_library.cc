@@ -12,4 +12,16 @@ NativeLibrary LoadNativeLibrary(const FilePath& library_path,
       library_path, NativeLibraryOptions(), error);
 }
 
+std::vector<void*> GetFunctionPointersFromNativeLibrary(
+    NativeLibrary library,
+    span<const std::string> names) {
+  std::vector<void*> function_pointers;
+  function_pointers.reserve(names.size());
+  for (const std::string& name : names) {
+    function_pointers.push_back(
+        GetFunctionPointerFromNativeLibrary(library, name.c_str()));
+  }
+  return function_pointers;
+}
+
 }  // namespace base
@@ -9,8 +9,10 @@
 // a loadable module.
 
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
+#include "base/containers/span.h"
 #include "base/files/file_path.h"
 #include "base/memory/raw_ptr_exclusion.h"
 #include "base/strings/string_piece.h"
@@ -73,6 +75,13 @@ struct BASE_EXPORT NativeLibraryOptions {
   // inverse, i.e., it does not force a preference for global symbols over local
   // ones.
   bool prefer_own_symbols = false;
+
+  // If |true|, all the undefined symbols of the library are resolved while it
+  // is loaded (RTLD_NOW) instead of on their first use, so that loading it
+  // ahead of time, e.g. from a background thread, also pays for the dynamic
+  // linking. Ignored on Windows, which binds imports at load time anyway, and
+  // for bundles on Mac.
+  bool resolve_symbols_now = false;
 };
 
 // Loads a native library from disk.  Release it with UnloadNativeLibrary when
@@ -115,6 +124,12 @@ BASE_EXPORT void UnloadNativeLibrary(NativeLibrary library);
 BASE_EXPORT void* GetFunctionPointerFromNativeLibrary(NativeLibrary library,
                                                       const char* name);
 
+// Gets the function pointers named |names| from a native library, in the same
+// order. Pointers to functions which aren't found are null.
+BASE_EXPORT std::vector<void*> GetFunctionPointersFromNativeLibrary(
+    NativeLibrary library,
+    span<const std::string> names);
+
 // Returns the full platform-specific name for a native library. |name| must be
 // ASCII. This is also the default name for the output of a gn |shared_library|
 // target. See tools/gn/docs/reference.md#shared_library.
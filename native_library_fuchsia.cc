@@ -85,7 +85,9 @@ NativeLibrary LoadNativeLibraryWithOptions(const FilePath& library_path,
     return nullptr;
   }
 
-  NativeLibrary result = dlopen_vmo(vmo.get(), RTLD_LAZY | RTLD_LOCAL);
+  NativeLibrary result = dlopen_vmo(
+      vmo.get(),
+      (options.resolve_symbols_now ? RTLD_NOW : RTLD_LAZY) | RTLD_LOCAL);
   return result;
 }
 
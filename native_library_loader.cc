@@ -0,0 +1,103 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/native_library_loader.h"
+
+#include <utility>
+
+#include "base/barrier_closure.h"
+#include "base/functional/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+
+namespace base {
+
+namespace {
+
+using Results = RefCountedData<std::vector<NativeLibraryLoadResult>>;
+
+NativeLibraryLoadResult LoadAndResolve(NativeLibraryLoadRequest request) {
+  NativeLibraryLoadResult result;
+  result.library = LoadNativeLibraryWithOptions(request.path, request.options,
+                                                &result.error);
+  if (result.library) {
+    result.function_pointers = GetFunctionPointersFromNativeLibrary(
+        result.library, request.function_names);
+  }
+  return result;
+}
+
+void OnLibraryLoaded(scoped_refptr<Results> results,
+                     size_t index,
+                     OnceClosure done_closure,
+                     NativeLibraryLoadResult result) {
+  results->data[index] = std::move(result);
+  std::move(done_closure).Run();
+}
+
+void OnAllLibrariesLoaded(
+    scoped_refptr<Results> results,
+    OnceCallback<void(std::vector<NativeLibraryLoadResult>)> callback) {
+  std::move(callback).Run(std::move(results->data));
+}
+
+}  // namespace
+
+NativeLibraryLoadRequest::NativeLibraryLoadRequest() = default;
+
+NativeLibraryLoadRequest::NativeLibraryLoadRequest(
+    FilePath path,
+    std::vector<std::string> function_names,
+    NativeLibraryOptions options)
+    : path(std::move(path)),
+      function_names(std::move(function_names)),
+      options(options) {}
+
+NativeLibraryLoadRequest::NativeLibraryLoadRequest(
+    NativeLibraryLoadRequest&&) = default;
+
+NativeLibraryLoadRequest& NativeLibraryLoadRequest::operator=(
+    NativeLibraryLoadRequest&&) = default;
+
+NativeLibraryLoadRequest::~NativeLibraryLoadRequest() = default;
+
+NativeLibraryLoadResult::NativeLibraryLoadResult() = default;
+
+NativeLibraryLoadResult::NativeLibraryLoadResult(NativeLibraryLoadResult&&) =
+    default;
+
+NativeLibraryLoadResult& NativeLibraryLoadResult::operator=(
+    NativeLibraryLoadResult&&) = default;
+
+NativeLibraryLoadResult::~NativeLibraryLoadResult() = default;
+
+void LoadNativeLibrariesInParallel(
+    std::vector<NativeLibraryLoadRequest> requests,
+    OnceCallback<void(std::vector<NativeLibraryLoadResult>)> callback,
+    TaskPriority priority) {
+  if (requests.empty()) {
+    SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE, BindOnce(std::move(callback),
+                            std::vector<NativeLibraryLoadResult>()));
+    return;
+  }
+
+  auto results = MakeRefCounted<Results>(
+      std::vector<NativeLibraryLoadResult>(requests.size()));
+  // Replies run on the current sequence, so |results| is only accessed from
+  // there.
+  RepeatingClosure done_closure = BarrierClosure(
+      requests.size(),
+      BindOnce(&OnAllLibrariesLoaded, results, std::move(callback)));
+  for (size_t i = 0; i < requests.size(); ++i) {
+    ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE,
+        {MayBlock(), priority, TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        BindOnce(&LoadAndResolve, std::move(requests[i])),
+        BindOnce(&OnLibraryLoaded, results, i, done_closure));
+  }
+}
+
+}  // namespace base
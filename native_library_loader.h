@@ -0,0 +1,73 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_NATIVE_LIBRARY_LOADER_H_
+#define BASE_NATIVE_LIBRARY_LOADER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/files/file_path.h"
+#include "base/functional/callback.h"
+#include "base/native_library.h"
+#include "base/task/task_traits.h"
+
+namespace base {
+
+// A native library to load with LoadNativeLibrariesInParallel().
+struct BASE_EXPORT NativeLibraryLoadRequest {
+  NativeLibraryLoadRequest();
+  NativeLibraryLoadRequest(FilePath path,
+                           std::vector<std::string> function_names,
+                           NativeLibraryOptions options = {});
+  NativeLibraryLoadRequest(NativeLibraryLoadRequest&&);
+  NativeLibraryLoadRequest& operator=(NativeLibraryLoadRequest&&);
+  ~NativeLibraryLoadRequest();
+
+  FilePath path;
+  // Functions to resolve once the library is loaded.
+  std::vector<std::string> function_names;
+  // Set |options.resolve_symbols_now| to also pay for the dynamic linking of
+  // the library in the background, before its first use.
+  NativeLibraryOptions options;
+};
+
+// The outcome of a NativeLibraryLoadRequest.
+struct BASE_EXPORT NativeLibraryLoadResult {
+  NativeLibraryLoadResult();
+  NativeLibraryLoadResult(NativeLibraryLoadResult&&);
+  NativeLibraryLoadResult& operator=(NativeLibraryLoadResult&&);
+  ~NativeLibraryLoadResult();
+
+  // Null if the library failed to load, in which case |error| says why.
+  // Release it with UnloadNativeLibrary() when you're done.
+  NativeLibrary library = nullptr;
+  NativeLibraryLoadError error;
+  // The pointers to the functions named by the request's |function_names|, in
+  // the same order, null for the ones which weren't found. Empty if the
+  // library failed to load.
+  std::vector<void*> function_pointers;
+};
+
+// Loads |requests| from disk in parallel, each from its own ThreadPool task
+// with |priority|, and resolves their functions from that task. Then runs
+// |callback| on the current sequence with the results, in the same order as
+// |requests|. Use TaskPriority::BEST_EFFORT to load libraries which will only
+// be needed later.
+//
+// Loading is skipped once shutdown started, in which case |callback| doesn't
+// run. The libraries which were loaded are leaked if |callback| doesn't run.
+//
+// Note that the dynamic loader serializes parts of loading, so this mostly
+// overlaps reading the libraries off disk and relocating them, and keeps that
+// work off the current sequence.
+BASE_EXPORT void LoadNativeLibrariesInParallel(
+    std::vector<NativeLibraryLoadRequest> requests,
+    OnceCallback<void(std::vector<NativeLibraryLoadResult>)> callback,
+    TaskPriority priority = TaskPriority::USER_VISIBLE);
+
+}  // namespace base
+
+#endif  // BASE_NATIVE_LIBRARY_LOADER_H_
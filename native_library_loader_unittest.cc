@@ -0,0 +1,105 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/native_library_loader.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/path_service.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_future.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+using LoadFuture = test::TestFuture<std::vector<NativeLibraryLoadResult>>;
+
+const FilePath::CharType kDummyLibraryPath[] =
+    FILE_PATH_LITERAL("dummy_library");
+
+}  // namespace
+
+TEST(NativeLibraryLoaderTest, NoRequests) {
+  test::TaskEnvironment task_environment;
+  LoadFuture future;
+  LoadNativeLibrariesInParallel({}, future.GetCallback());
+  EXPECT_TRUE(future.Get().empty());
+}
+
+TEST(NativeLibraryLoaderTest, LoadFailure) {
+  test::TaskEnvironment task_environment;
+  std::vector<NativeLibraryLoadRequest> requests;
+  requests.emplace_back(FilePath(kDummyLibraryPath),
+                        std::vector<std::string>({"GetSimpleTestValue"}));
+  LoadFuture future;
+  LoadNativeLibrariesInParallel(std::move(requests), future.GetCallback());
+  const std::vector<NativeLibraryLoadResult> results = future.Take();
+  ASSERT_EQ(1u, results.size());
+  EXPECT_FALSE(results[0].library);
+  EXPECT_FALSE(results[0].error.ToString().empty());
+  EXPECT_TRUE(results[0].function_pointers.empty());
+}
+
+// See NativeLibraryTest for why the test library isn't loaded on these
+// configurations.
+#if !BUILDFLAG(IS_IOS) && !BUILDFLAG(IS_ANDROID) && \
+    !defined(ADDRESS_SANITIZER)
+
+TEST(NativeLibraryLoaderTest, LoadLibraries) {
+  test::TaskEnvironment task_environment;
+
+  FilePath exe_path;
+#if !BUILDFLAG(IS_FUCHSIA)
+  // Libraries do not sit alongside the executable in Fuchsia.
+  ASSERT_TRUE(PathService::Get(DIR_EXE, &exe_path));
+#endif
+  const FilePath library_path =
+      exe_path.AppendASCII(GetNativeLibraryName("test_shared_library"));
+
+  NativeLibraryOptions resolve_now_options;
+  resolve_now_options.resolve_symbols_now = true;
+  std::vector<NativeLibraryLoadRequest> requests;
+  requests.emplace_back(library_path,
+                        std::vector<std::string>(
+                            {"GetSimpleTestValue", "NoSuchFunction"}));
+  requests.emplace_back(FilePath(kDummyLibraryPath),
+                        std::vector<std::string>());
+  requests.emplace_back(
+      library_path, std::vector<std::string>({"GetSimpleTestValue"}),
+      resolve_now_options);
+
+  LoadFuture future;
+  LoadNativeLibrariesInParallel(std::move(requests), future.GetCallback(),
+                                TaskPriority::BEST_EFFORT);
+  std::vector<NativeLibraryLoadResult> results = future.Take();
+  ASSERT_EQ(3u, results.size());
+
+  ASSERT_TRUE(results[0].library);
+  ASSERT_EQ(2u, results[0].function_pointers.size());
+  ASSERT_TRUE(results[0].function_pointers[0]);
+  EXPECT_EQ(5,
+            reinterpret_cast<int (*)()>(results[0].function_pointers[0])());
+  EXPECT_FALSE(results[0].function_pointers[1]);
+
+  EXPECT_FALSE(results[1].library);
+
+  ASSERT_TRUE(results[2].library);
+  ASSERT_EQ(1u, results[2].function_pointers.size());
+  EXPECT_EQ(results[0].function_pointers[0],
+            results[2].function_pointers[0]);
+
+  UnloadNativeLibrary(results[0].library);
+  UnloadNativeLibrary(results[2].library);
+}
+
+#endif  // !BUILDFLAG(IS_IOS) && !BUILDFLAG(IS_ANDROID) &&
+        // !defined(ADDRESS_SANITIZER)
+
+}  // namespace base
@@ -32,7 +32,7 @@ NativeLibrary LoadNativeLibraryWithOptions(const FilePath& library_path,
   // please refer to the bug tracker.  Some useful bug reports to read include:
   // http://crbug.com/17943, http://crbug.com/17557, http://crbug.com/36892,
   // and http://crbug.com/40794.
-  int flags = RTLD_LAZY;
+  int flags = options.resolve_symbols_now ? RTLD_NOW : RTLD_LAZY;
 #if BUILDFLAG(IS_ANDROID) || !defined(RTLD_DEEPBIND)
   // Certain platforms don't define RTLD_DEEPBIND. Android dlopen() requires
   // further investigation, as it might vary across versions. Crash here to
@@ -4,6 +4,9 @@
 
 #include "base/native_library.h"
 
+#include <string>
+#include <vector>
+
 #include "base/check.h"
 #include "base/files/file_path.h"
 #include "base/path_service.h"
@@ -107,6 +110,8 @@ class TestLibrary {
   TestLibrary& operator=(const TestLibrary&) = delete;
   ~TestLibrary() { UnloadNativeLibrary(library_); }
 
+  NativeLibrary library() const { return library_; }
+
   template <typename ReturnType, typename... Args>
   ReturnType Call(const char* function_name, Args... args) {
     return reinterpret_cast<ReturnType (*)(Args...)>(
@@ -127,6 +132,30 @@ TEST(NativeLibraryTest, LoadLibrary) {
   EXPECT_EQ(5, library.Call<int>("GetSimpleTestValue"));
 }
 
+TEST(NativeLibraryTest, LoadLibraryResolveSymbolsNow) {
+  NativeLibraryOptions options;
+  options.resolve_symbols_now = true;
+  TestLibrary library(options);
+  EXPECT_EQ(5, library.Call<int>("GetSimpleTestValue"));
+}
+
+TEST(NativeLibraryTest, GetFunctionPointers) {
+  TestLibrary library;
+  const std::string kNames[] = {"GetSimpleTestValue", "NoSuchFunction",
+                                "GetExportedValue"};
+  const std::vector<void*> function_pointers =
+      GetFunctionPointersFromNativeLibrary(library.library(), kNames);
+  ASSERT_EQ(3u, function_pointers.size());
+  EXPECT_EQ(GetFunctionPointerFromNativeLibrary(library.library(),
+                                                "GetSimpleTestValue"),
+            function_pointers[0]);
+  EXPECT_FALSE(function_pointers[1]);
+  EXPECT_EQ(GetFunctionPointerFromNativeLibrary(library.library(),
+                                                "GetExportedValue"),
+            function_pointers[2]);
+  EXPECT_EQ(5, reinterpret_cast<int (*)()>(function_pointers[0])());
+}
+
 #endif  // !BUILDFLAG(IS_ANDROID)
 
 // Android dlopen() requires further investigation, as it might vary across
@@ -28,6 +28,26 @@ inline constexpr T ByteSwap(T value) {
   return internal::SwapBytes(value);
 }
 
+// Maps a signed integer to an unsigned one such that values of small
+// magnitude, whether positive or negative, map to small values: 0, -1, 1, -2,
+// 2... map to 0, 1, 2, 3, 4... This makes negative values short when encoded
+// as varints (see SpanWriter::WriteVarint()), as in protobuf's sint fields.
+template <class T>
+  requires(std::is_integral_v<T> && std::is_signed_v<T>)
+inline constexpr std::make_unsigned_t<T> ZigZagEncode(T value) {
+  using U = std::make_unsigned_t<T>;
+  const U sign = static_cast<U>(value >> (sizeof(T) * 8 - 1));
+  return static_cast<U>(static_cast<U>(static_cast<U>(value) << 1) ^ sign);
+}
+
+// The inverse of ZigZagEncode().
+template <class T>
+  requires(std::is_integral_v<T> && std::is_unsigned_v<T>)
+inline constexpr std::make_signed_t<T> ZigZagDecode(T value) {
+  const T sign = static_cast<T>(T{0} - static_cast<T>(value & 1u));
+  return static_cast<std::make_signed_t<T>>(static_cast<T>(value >> 1) ^ sign);
+}
+
 // Returns a uint8_t with the value in `bytes` interpreted as the native endian
 // encoding of the integer for the machine.
 //
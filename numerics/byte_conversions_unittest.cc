@@ -8,6 +8,7 @@
 #include <bit>
 #include <concepts>
 #include <cstdint>
+#include <limits>
 
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -547,4 +548,31 @@ TEST(NumericsTest, ToBigEndian) {
   }
 }
 
+TEST(NumericsTest, ZigZag) {
+  static_assert(ZigZagEncode(int32_t{0}) == 0u);
+  static_assert(ZigZagEncode(int32_t{-1}) == 1u);
+  static_assert(ZigZagEncode(int32_t{1}) == 2u);
+  static_assert(ZigZagEncode(int32_t{-2}) == 3u);
+  static_assert(ZigZagEncode(int32_t{2147483647}) == 0xfffffffeu);
+  static_assert(ZigZagEncode(int32_t{-2147483647 - 1}) == 0xffffffffu);
+  static_assert(std::same_as<decltype(ZigZagEncode(int16_t{0})), uint16_t>);
+  static_assert(std::same_as<decltype(ZigZagDecode(uint16_t{0})), int16_t>);
+
+  static_assert(ZigZagDecode(0u) == 0);
+  static_assert(ZigZagDecode(1u) == -1);
+  static_assert(ZigZagDecode(2u) == 1);
+  static_assert(ZigZagDecode(0xfffffffeu) == 2147483647);
+  static_assert(ZigZagDecode(0xffffffffu) == -2147483647 - 1);
+
+  for (int i = -128; i <= 127; ++i) {
+    const int8_t value = static_cast<int8_t>(i);
+    EXPECT_EQ(ZigZagDecode(ZigZagEncode(value)), value);
+  }
+  EXPECT_EQ(ZigZagEncode(int8_t{-128}), uint8_t{255});
+  EXPECT_EQ(ZigZagEncode(int8_t{127}), uint8_t{254});
+  EXPECT_EQ(ZigZagEncode(int64_t{-1}), uint64_t{1});
+  EXPECT_EQ(ZigZagDecode(uint64_t{0xffffffffffffffff}),
+            std::numeric_limits<int64_t>::min());
+}
+
 }  // namespace base::numerics
@@ -5,9 +5,15 @@
 #include "base/observer_list.h"
 
 #include <memory>
+#include <vector>
 
 #include "base/check_op.h"
+#include "base/location.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/observer_list_threadsafe.h"
+#include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
+#include "base/test/task_environment.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
@@ -19,12 +25,16 @@ volatile int g_observer_list_perf_test_counter;
 namespace base {
 
 constexpr char kMetricPrefixObserverList[] = "ObserverList.";
+constexpr char kMetricPrefixObserverListThreadSafe[] =
+    "ObserverListThreadSafe.";
 constexpr char kMetricNotifyTimePerObserver[] = "notify_time_per_observer";
 
 namespace {
 
-perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
-  perf_test::PerfResultReporter reporter(kMetricPrefixObserverList, story_name);
+perf_test::PerfResultReporter SetUpReporter(
+    const std::string& story_name,
+    const char* metric_prefix = kMetricPrefixObserverList) {
+  perf_test::PerfResultReporter reporter(metric_prefix, story_name);
   reporter.RegisterImportantMetric(kMetricNotifyTimePerObserver, "ns");
   return reporter;
 }
@@ -127,4 +137,79 @@ TYPED_TEST(ObserverListPerfTest, NotifyPerformance) {
   }
 }
 
+class ThreadSafeObserver {
+ public:
+  void Observe() {
+    g_observer_list_perf_test_counter = g_observer_list_perf_test_counter + 1;
+  }
+};
+
+class ObserverListThreadSafePerfTest
+    : public ::testing::TestWithParam<ObserverNotificationMode> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    All,
+    ObserverListThreadSafePerfTest,
+    ::testing::Values(ObserverNotificationMode::kTaskPerObserver,
+                      ObserverNotificationMode::kTaskPerSequence));
+
+// Performance test for base::ObserverListThreadSafe, with all the observers on
+// the current sequence. This measures both posting the notifications and
+// running them.
+TEST_P(ObserverListThreadSafePerfTest, NotifyPerformance) {
+  using ObserverListType = ObserverListThreadSafe<ThreadSafeObserver>;
+  constexpr int kMaxObservers = 128;
+#if DCHECK_IS_ON()
+  constexpr int kLaps = 100000;
+#else
+  constexpr int kLaps = 10000000;
+#endif
+  // The number of notifications posted before running them.
+  constexpr int kNotificationsPerRun = 16;
+  test::TaskEnvironment task_environment;
+
+  for (int observer_count = 1; observer_count <= kMaxObservers;
+       observer_count *= 2) {
+    auto list = MakeRefCounted<ObserverListType>(ObserverListPolicy::ALL,
+                                                 GetParam());
+    std::vector<ThreadSafeObserver> observers(observer_count);
+    for (auto& o : observers) {
+      list->AddObserver(&o);
+    }
+
+    g_observer_list_perf_test_counter = 0;
+    const int weighted_laps =
+        kLaps / observer_count / kNotificationsPerRun * kNotificationsPerRun;
+
+    TimeTicks start = TimeTicks::Now();
+    for (int i = 0; i < weighted_laps; i += kNotificationsPerRun) {
+      for (int j = 0; j < kNotificationsPerRun; ++j) {
+        list->Notify(FROM_HERE, &ThreadSafeObserver::Observe);
+      }
+      RunLoop().RunUntilIdle();
+    }
+    TimeDelta duration = TimeTicks::Now() - start;
+
+    for (auto& o : observers) {
+      list->RemoveObserver(&o);
+    }
+
+    EXPECT_EQ(observer_count * weighted_laps,
+              g_observer_list_perf_test_counter);
+
+    std::string story_name = base::StringPrintf(
+        "%s_%d",
+        GetParam() == ObserverNotificationMode::kTaskPerObserver
+            ? "TaskPerObserver"
+            : "TaskPerSequence",
+        observer_count);
+    auto reporter =
+        SetUpReporter(story_name, kMetricPrefixObserverListThreadSafe);
+    reporter.AddResult(
+        kMetricNotifyTimePerObserver,
+        duration.InNanoseconds() /
+            static_cast<double>(g_observer_list_perf_test_counter));
+  }
+}
+
 }  // namespace base
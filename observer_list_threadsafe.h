@@ -5,6 +5,8 @@
 #ifndef BASE_OBSERVER_LIST_THREADSAFE_H_
 #define BASE_OBSERVER_LIST_THREADSAFE_H_
 
+#include <algorithm>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 
@@ -13,6 +15,7 @@
 #include "base/check.h"
 #include "base/check_op.h"
 #include "base/containers/contains.h"
+#include "base/containers/small_vector.h"
 #include "base/dcheck_is_on.h"
 #include "base/debug/stack_trace.h"
 #include "base/functional/bind.h"
@@ -21,6 +24,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/observer_list.h"
 #include "base/strings/strcat.h"
+#include "base/synchronization/atomic_snapshot.h"
 #include "base/synchronization/lock.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
@@ -59,6 +63,12 @@
 //   will always be done via PostTask() to another sequence, whereas with the
 //   non-thread-safe ObserverList, notifications happen synchronously.
 //
+//   By default, each observer is notified by its own posted task. Lists with
+//   many observers per sequence that are notified often can instead use
+//   ObserverNotificationMode::kTaskPerSequence, which posts a single task per
+//   sequence and lets Notify() run without acquiring the lock taken by
+//   AddObserver() and RemoveObserver(), at the cost of making these O(n).
+//
 //   Note: this class previously supported synchronous notifications for
 //   same-sequence observers, but it was error-prone and removed in
 //   crbug.com/1193750, think twice before re-considering this paradigm.
@@ -114,6 +124,15 @@ enum class RemoveObserverPolicy {
   kAddingSequenceOnly,
 };
 
+enum class ObserverNotificationMode {
+  // Each observer is notified by its own posted task.
+  kTaskPerObserver,
+  // All the observers added on the same SequencedTaskRunner are notified by a
+  // single posted task. Notify() reads a copy-on-write snapshot of the
+  // observers, so it doesn't contend with AddObserver() and RemoveObserver().
+  kTaskPerSequence,
+};
+
 template <class ObserverType,
           RemoveObserverPolicy RemovePolicy =
               RemoveObserverPolicy::kAnySequence>
@@ -131,8 +150,15 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
   };
 
   ObserverListThreadSafe() = default;
-  explicit ObserverListThreadSafe(ObserverListPolicy policy)
-      : policy_(policy) {}
+  explicit ObserverListThreadSafe(
+      ObserverListPolicy policy,
+      ObserverNotificationMode mode =
+          ObserverNotificationMode::kTaskPerObserver)
+      : policy_(policy) {
+    if (mode == ObserverNotificationMode::kTaskPerSequence) {
+      snapshot_ = std::make_unique<AtomicSnapshot<ObserverSnapshot>>();
+    }
+  }
   ObserverListThreadSafe(const ObserverListThreadSafe&) = delete;
   ObserverListThreadSafe& operator=(const ObserverListThreadSafe&) = delete;
 
@@ -166,6 +192,7 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
     ObserverTaskRunnerInfo task_info = {task_runner, observer_id};
 #endif
     observers_[observer] = std::move(task_info);
+    UpdateSnapshotLocked();
 
     // If this is called while a notification is being dispatched on this thread
     // and |policy_| is ALL, |observer| must be notified (if a notification is
@@ -209,7 +236,9 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
       CHECK(it == observers_.end() ||
             it->second.task_runner->RunsTasksInCurrentSequence());
     }
-    observers_.erase(observer);
+    if (observers_.erase(observer)) {
+      UpdateSnapshotLocked();
+    }
     return observers_.empty() ? RemoveObserverResult::kWasOrBecameEmpty
                               : RemoveObserverResult::kRemainsNonEmpty;
   }
@@ -235,6 +264,17 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
         BindRepeating(&Dispatcher<ObserverType, Method>::Run, m,
                       std::forward<Params>(params)...);
 
+    if (snapshot_) {
+      scoped_refptr<const ObserverSnapshotRef> snapshot = snapshot_->Load();
+      for (size_t i = 0; i < snapshot->data.groups.size(); ++i) {
+        snapshot->data.groups[i].task_runner->PostTask(
+            from_here,
+            BindOnce(&Self::NotifyGroupWrapper, this, snapshot, i,
+                     NotificationData(this, 0, from_here, method)));
+      }
+      return;
+    }
+
     AutoLock lock(lock_);
     for (const auto& observer : observers_) {
       observer.second.task_runner->PostTask(
@@ -267,6 +307,21 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
     size_t observer_id;
   };
 
+  // The observers added on the same SequencedTaskRunner, with their ids.
+  struct ObserverGroup {
+    scoped_refptr<SequencedTaskRunner> task_runner;
+    // Most sequences have only a few observers of a given list.
+    small_vector<std::pair<ObserverType*, size_t>, 4> observers;
+  };
+
+  struct ObserverSnapshot {
+    std::unordered_map<ObserverType*, size_t> observer_ids;
+    // Most lists are observed from one or two sequences.
+    small_vector<ObserverGroup, 2> groups;
+  };
+  using ObserverSnapshotRef =
+      typename AtomicSnapshot<ObserverSnapshot>::Snapshot;
+
   ~ObserverListThreadSafe() override = default;
 
   void NotifyWrapper(MayBeDangling<ObserverType> observer,
@@ -297,6 +352,56 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
     notification.method.Run(observer);
   }
 
+  // Notifies the observers of the `group_index`th group of `snapshot`, which
+  // were added on the current sequence, unless they were removed since.
+  void NotifyGroupWrapper(scoped_refptr<const ObserverSnapshotRef> snapshot,
+                          size_t group_index,
+                          const NotificationData& notification) {
+    DCHECK_EQ(notification.observer_list, this);
+    const ObserverGroup& group = snapshot->data.groups[group_index];
+    DCHECK(group.task_runner->RunsTasksInCurrentSequence());
+
+    // See NotifyWrapper().
+    const AutoReset<const NotificationDataBase*> resetter_(
+        &GetCurrentNotification(), &notification);
+
+    for (const auto& [observer, observer_id] : group.observers) {
+      // The observer may have been removed by a previous callback, in which
+      // case it may be dangling, or by another sequence.
+      bool is_registered = false;
+      snapshot_->Read([&](const ObserverSnapshot& current) {
+        const auto it = current.observer_ids.find(observer);
+        is_registered = it != current.observer_ids.end() &&
+                        it->second == observer_id;
+      });
+      if (is_registered) {
+        notification.method.Run(observer);
+      }
+    }
+  }
+
+  // Publishes the current `observers_` to Notify() calls in
+  // kTaskPerSequence mode.
+  void UpdateSnapshotLocked() EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    if (!snapshot_) {
+      return;
+    }
+    ObserverSnapshot snapshot;
+    for (const auto& [observer, info] : observers_) {
+      snapshot.observer_ids.emplace(observer, info.observer_id);
+      auto group = std::find_if(snapshot.groups.begin(), snapshot.groups.end(),
+                                [&](const ObserverGroup& candidate) {
+                                  return candidate.task_runner ==
+                                         info.task_runner;
+                                });
+      if (group == snapshot.groups.end()) {
+        group = snapshot.groups.insert(group, {info.task_runner, {}});
+      }
+      group->observers.emplace_back(observer, info.observer_id);
+    }
+    snapshot_->Store(std::move(snapshot));
+  }
+
   std::string GetObserversCreationStackStringLocked() const
       EXCLUSIVE_LOCKS_REQUIRED(lock_) {
     std::string result;
@@ -327,6 +432,10 @@ class ObserverListThreadSafe : public internal::ObserverListThreadSafeBase {
   // be notified.
   std::unordered_map<ObserverType*, ObserverTaskRunnerInfo> observers_
       GUARDED_BY(lock_);
+
+  // A copy of `observers_`, grouped by task runner. Only used in
+  // kTaskPerSequence mode.
+  std::unique_ptr<AtomicSnapshot<ObserverSnapshot>> snapshot_;
 };
 
 }  // namespace base
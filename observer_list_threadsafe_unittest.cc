@@ -596,4 +596,134 @@ TEST(ObserverListThreadSafeTest, Existing) {
   EXPECT_EQ(1, c.total);
 }
 
+// Verify that in kTaskPerSequence mode, the observers added on the same
+// sequence are notified by a single task.
+TEST(ObserverListThreadSafeTest, TaskPerSequence) {
+  using List = ObserverListThreadSafe<Foo>;
+  test::TaskEnvironment task_environment;
+
+  auto observer_list = MakeRefCounted<List>(
+      ObserverListPolicy::ALL, ObserverNotificationMode::kTaskPerSequence);
+  Adder a(1);
+  Adder b(-1);
+  Adder c(1);
+
+  EXPECT_EQ(List::AddObserverResult::kBecameNonEmpty,
+            observer_list->AddObserver(&a));
+  EXPECT_EQ(List::AddObserverResult::kWasAlreadyNonEmpty,
+            observer_list->AddObserver(&b));
+  EXPECT_EQ(List::AddObserverResult::kWasAlreadyNonEmpty,
+            observer_list->AddObserver(&c));
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 10);
+  EXPECT_EQ(1u, task_environment.GetPendingMainThreadTaskCount());
+  RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(10, a.total);
+  EXPECT_EQ(-10, b.total);
+  EXPECT_EQ(10, c.total);
+
+  // A notification to a removed observer is aborted, even if the observer is
+  // added again before it runs.
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 10);
+  observer_list->RemoveObserver(&a);
+  observer_list->RemoveObserver(&b);
+  observer_list->AddObserver(&b);
+  RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(10, a.total);
+  EXPECT_EQ(-10, b.total);
+  EXPECT_EQ(20, c.total);
+
+  EXPECT_EQ(List::RemoveObserverResult::kRemainsNonEmpty,
+            observer_list->RemoveObserver(&b));
+  EXPECT_EQ(List::RemoveObserverResult::kWasOrBecameEmpty,
+            observer_list->RemoveObserver(&c));
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 10);
+  EXPECT_EQ(0u, task_environment.GetPendingMainThreadTaskCount());
+}
+
+namespace {
+
+// An observer which removes another observer when notified.
+class RemoveInObserve : public Foo {
+ public:
+  explicit RemoveInObserve(ObserverListThreadSafe<Foo>* observer_list)
+      : observer_list(observer_list) {}
+
+  void SetToRemove(Foo* to_remove) { to_remove_ = to_remove; }
+
+  void Observe(int x) override {
+    if (to_remove_) {
+      observer_list->RemoveObserver(to_remove_.get());
+      to_remove_ = nullptr;
+    }
+  }
+
+  raw_ptr<ObserverListThreadSafe<Foo>> observer_list;
+  raw_ptr<Foo> to_remove_;
+};
+
+}  // namespace
+
+// Verify that in kTaskPerSequence mode, an observer removed by another
+// observer of the same notification task isn't notified.
+TEST(ObserverListThreadSafeTest, TaskPerSequenceRemoveFromNotification) {
+  test::TaskEnvironment task_environment;
+  auto observer_list = MakeRefCounted<ObserverListThreadSafe<Foo>>(
+      ObserverListPolicy::ALL, ObserverNotificationMode::kTaskPerSequence);
+
+  // Each observer removes the other, so only the first one notified runs.
+  RemoveInObserve a(observer_list.get());
+  RemoveInObserve b(observer_list.get());
+  a.SetToRemove(&b);
+  b.SetToRemove(&a);
+  observer_list->AddObserver(&a);
+  observer_list->AddObserver(&b);
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 1);
+  RunLoop().RunUntilIdle();
+
+  // Exactly one of the observers removed the other.
+  EXPECT_EQ(1, !a.to_remove_ + !b.to_remove_);
+}
+
+// Verify that in kTaskPerSequence mode, observers are notified on the sequence
+// on which they were added, and that an observer added from a notification is
+// itself notified.
+TEST(ObserverListThreadSafeTest, TaskPerSequenceMultipleSequences) {
+  test::TaskEnvironment task_environment;
+
+  auto task_runner_1 = ThreadPool::CreateSequencedTaskRunner({});
+  auto task_runner_2 = ThreadPool::CreateSequencedTaskRunner({});
+
+  auto observer_list = MakeRefCounted<ObserverListThreadSafe<Foo>>(
+      ObserverListPolicy::ALL, ObserverNotificationMode::kTaskPerSequence);
+
+  SequenceVerificationObserver observer_1(task_runner_1);
+  SequenceVerificationObserver observer_2(task_runner_2);
+  Adder observer_added_from_notification(1);
+  AddInObserve initial_observer(observer_list.get());
+  initial_observer.SetToAdd(&observer_added_from_notification);
+
+  task_runner_1->PostTask(
+      FROM_HERE,
+      BindOnce(base::IgnoreResult(&ObserverListThreadSafe<Foo>::AddObserver),
+               observer_list, Unretained(&observer_1)));
+  task_runner_2->PostTask(
+      FROM_HERE,
+      BindOnce(base::IgnoreResult(&ObserverListThreadSafe<Foo>::AddObserver),
+               observer_list, Unretained(&observer_2)));
+  observer_list->AddObserver(&initial_observer);
+  ThreadPoolInstance::Get()->FlushForTesting();
+
+  observer_list->Notify(FROM_HERE, &Foo::Observe, 1);
+  RunLoop().RunUntilIdle();
+  ThreadPoolInstance::Get()->FlushForTesting();
+
+  EXPECT_TRUE(observer_1.called_on_valid_sequence());
+  EXPECT_TRUE(observer_2.called_on_valid_sequence());
+  EXPECT_EQ(1, observer_added_from_notification.GetValue());
+}
+
 }  // namespace base
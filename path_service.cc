@@ -4,8 +4,11 @@
 
 #include "base/path_service.h"
 
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/files/file_path.h"
@@ -145,6 +148,41 @@ Provider base_provider_posix = {EnvOverridePathProvider, &posix_provider,
 #endif
 
 
+// A copy of the cache which PathService::Get() reads without the lock. Entries
+// are only added, while holding PathData::lock, and never modified: clearing
+// the cache replaces the whole index instead, and the previous one is kept
+// alive for readers still probing it.
+struct CacheIndex {
+  // Indexes are kept at most half full, so probing always ends on a free
+  // entry. Keys which don't fit are only found in the locked cache.
+  static constexpr size_t kCapacity = 256;
+
+  struct Entry {
+    // The path key, or 0 (PATH_START, not a valid key) if the entry is free.
+    // Set once, after |path|.
+    std::atomic<int> key{0};
+    std::atomic<const FilePath*> path{nullptr};
+  };
+
+  CacheIndex() : entries(new Entry[kCapacity]) {}
+
+  // Returns the entry with |key|, or the free entry where it belongs.
+  Entry& Probe(int key) const {
+    for (size_t i = static_cast<size_t>(key) & (kCapacity - 1);;
+         i = (i + 1) & (kCapacity - 1)) {
+      const int entry_key = entries[i].key.load(std::memory_order_acquire);
+      if (entry_key == key || entry_key == 0) {
+        return entries[i];
+      }
+    }
+  }
+
+  const std::unique_ptr<Entry[]> entries;
+  // The values of the used entries. Only accessed while holding
+  // PathData::lock.
+  std::vector<std::unique_ptr<const FilePath>> paths;
+};
+
 struct PathData {
   Lock lock;
   PathMap cache;        // Cache mappings from path key to path value.
@@ -152,6 +190,13 @@ struct PathData {
   raw_ptr<Provider> providers;  // Linked list of path service providers.
   bool cache_disabled;  // Don't use cache if true;
 
+  // All the indexes of the cache, the current one last. Leaked with PathData,
+  // since readers may still be probing any of them.
+  std::vector<std::unique_ptr<CacheIndex>> cache_indexes;
+  // The current index, or null if the cache is empty or disabled. Written
+  // while holding |lock|, and read without it by GetFromCacheIndex().
+  std::atomic<const CacheIndex*> cache_index{nullptr};
+
   PathData() : cache_disabled(false) {
 #if BUILDFLAG(IS_WIN)
     providers = &base_provider_win;
@@ -174,6 +219,63 @@ static PathData* GetPathData() {
   return path_data;
 }
 
+// Tries to find |key| in the cache, without taking the lock.
+bool GetFromCacheIndex(int key, const PathData* path_data, FilePath* result) {
+  const CacheIndex* index =
+      path_data->cache_index.load(std::memory_order_acquire);
+  if (!index) {
+    return false;
+  }
+  // Probe() also returns free entries, whose path may be in the middle of
+  // being published for another key: only trust the path once the entry's key
+  // is |key|, since the key is stored after the path.
+  const CacheIndex::Entry& entry = index->Probe(key);
+  if (entry.key.load(std::memory_order_acquire) != key) {
+    return false;
+  }
+  *result = *entry.path.load(std::memory_order_relaxed);
+  return true;
+}
+
+// Adds |key| to the cache.
+void LockedAddToCache(int key, const FilePath& path, PathData* path_data)
+    EXCLUSIVE_LOCKS_REQUIRED(path_data->lock) {
+  if (path_data->cache_disabled) {
+    return;
+  }
+  path_data->cache[key] = path;
+
+  const CacheIndex* current_index =
+      path_data->cache_index.load(std::memory_order_relaxed);
+  if (!current_index) {
+    path_data->cache_indexes.push_back(std::make_unique<CacheIndex>());
+  }
+  CacheIndex* index = path_data->cache_indexes.back().get();
+  if ((index->paths.size() + 1) * 2 > CacheIndex::kCapacity) {
+    return;
+  }
+  CacheIndex::Entry& entry = index->Probe(key);
+  if (entry.key.load(std::memory_order_relaxed) != 0) {
+    // Another thread got and cached the same path while the lock was released.
+    return;
+  }
+  index->paths.push_back(std::make_unique<const FilePath>(path));
+  // Publish the path before the key, so that readers which find the key also
+  // find the path.
+  entry.path.store(index->paths.back().get(), std::memory_order_release);
+  entry.key.store(key, std::memory_order_release);
+  if (!current_index) {
+    path_data->cache_index.store(index, std::memory_order_release);
+  }
+}
+
+// Clears the cache. The next path added to it starts a new index.
+void LockedClearCache(PathData* path_data)
+    EXCLUSIVE_LOCKS_REQUIRED(path_data->lock) {
+  path_data->cache.clear();
+  path_data->cache_index.store(nullptr, std::memory_order_release);
+}
+
 // Tries to find |key| in the cache.
 bool LockedGetFromCache(int key, const PathData* path_data, FilePath* result)
     EXCLUSIVE_LOCKS_REQUIRED(path_data->lock) {
@@ -194,8 +296,7 @@ bool LockedGetFromOverrides(int key, PathData* path_data, FilePath* result)
   // check for an overridden version.
   PathMap::const_iterator it = path_data->overrides.find(key);
   if (it != path_data->overrides.end()) {
-    if (!path_data->cache_disabled)
-      path_data->cache[key] = it->second;
+    LockedAddToCache(key, it->second, path_data);
     *result = it->second;
     return true;
   }
@@ -218,6 +319,9 @@ bool PathService::Get(int key, FilePath* result) {
   if (key == DIR_CURRENT)
     return GetCurrentDirectory(result);
 
+  if (GetFromCacheIndex(key, path_data, result))
+    return true;
+
   Provider* provider = nullptr;
   {
     AutoLock scoped_lock(path_data->lock);
@@ -254,8 +358,7 @@ bool PathService::Get(int key, FilePath* result) {
   *result = path;
 
   AutoLock scoped_lock(path_data->lock);
-  if (!path_data->cache_disabled)
-    path_data->cache[key] = path;
+  LockedAddToCache(key, path, path_data);
 
   return true;
 }
@@ -303,7 +406,7 @@ bool PathService::OverrideAndCreateIfNeeded(int key,
 
   // Clear the cache now. Some of its entries could have depended
   // on the value we are overriding, and are now out of sync with reality.
-  path_data->cache.clear();
+  LockedClearCache(path_data);
 
   path_data->overrides[key] = std::move(file_path);
 
@@ -322,7 +425,7 @@ bool PathService::RemoveOverrideForTests(int key) {
 
   // Clear the cache now. Some of its entries could have depended on the value
   // we are going to remove, and are now out of sync.
-  path_data->cache.clear();
+  LockedClearCache(path_data);
 
   path_data->overrides.erase(key);
 
@@ -377,7 +480,7 @@ void PathService::DisableCache() {
   DCHECK(path_data);
 
   AutoLock scoped_lock(path_data->lock);
-  path_data->cache.clear();
+  LockedClearCache(path_data);
   path_data->cache_disabled = true;
 }
 
@@ -22,7 +22,8 @@ class BASE_EXPORT PathService {
  public:
   // Populates |path| with a special directory or file. Returns true on success,
   // in which case |path| is guaranteed to have a non-empty value. On failure,
-  // |path| will not be changed.
+  // |path| will not be changed. Paths are cached until the next override, and
+  // cached paths are returned without taking a lock.
   static bool Get(int key, FilePath* path);
 
   // Returns the corresponding path; CHECKs that the operation succeeds.
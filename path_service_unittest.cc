@@ -4,16 +4,22 @@
 
 #include "base/path_service.h"
 
+#include <memory>
+#include <vector>
+
 #include "base/base_paths.h"
 #include "base/containers/contains.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
+#include "base/memory/raw_ref.h"
 #include "base/scoped_environment_variable_override.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/test/gtest_util.h"
+#include "base/threading/simple_thread.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest-spi.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -102,6 +108,49 @@ bool ReturnsInvalidPath(int key) {
   return !result && path.empty();
 }
 
+// Gets a path repeatedly, and checks that it's one of two values.
+class PathReader : public DelegateSimpleThread::Delegate {
+ public:
+  PathReader(int key, const FilePath& expected1, const FilePath& expected2)
+      : key_(key), expected1_(expected1), expected2_(expected2) {}
+
+  void Run() override {
+    for (int i = 0; i < 1000; ++i) {
+      FilePath result;
+      EXPECT_TRUE(PathService::Get(key_, &result));
+      EXPECT_TRUE(result == *expected1_ || result == *expected2_) << result;
+    }
+  }
+
+ private:
+  const int key_;
+  const raw_ref<const FilePath> expected1_;
+  const raw_ref<const FilePath> expected2_;
+};
+
+// Gets the paths of consecutive keys repeatedly, and checks that each is the
+// path of its own key.
+class MultiKeyPathReader : public DelegateSimpleThread::Delegate {
+ public:
+  MultiKeyPathReader(int first_key, const std::vector<FilePath>& expected)
+      : first_key_(first_key), expected_(expected) {}
+
+  void Run() override {
+    for (int i = 0; i < 200; ++i) {
+      for (size_t j = 0; j < expected_->size(); ++j) {
+        FilePath result;
+        const int key = first_key_ + static_cast<int>(j);
+        EXPECT_TRUE(PathService::Get(key, &result));
+        EXPECT_EQ((*expected_)[j], result) << key;
+      }
+    }
+  }
+
+ private:
+  const int first_key_;
+  const raw_ref<const std::vector<FilePath>> expected_;
+};
+
 }  // namespace
 
 // On the Mac this winds up using some autoreleased objects, so we need to
@@ -264,6 +313,101 @@ TEST_F(PathServiceTest, OverrideMultiple) {
   EXPECT_TRUE(PathExists(result.AppendASCII("t2")));
 }
 
+// Check that cached paths are replaced by overrides.
+TEST_F(PathServiceTest, OverrideClearsCache) {
+  int my_special_key = 668;
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath fake_dir1(MakeAbsoluteFilePath(temp_dir.GetPath()).AppendASCII("1"));
+  FilePath fake_dir2(MakeAbsoluteFilePath(temp_dir.GetPath()).AppendASCII("2"));
+  ASSERT_TRUE(PathService::Override(my_special_key, fake_dir1));
+
+  // The second Get() is served from the cache.
+  FilePath result;
+  EXPECT_TRUE(PathService::Get(my_special_key, &result));
+  EXPECT_EQ(fake_dir1, result);
+  EXPECT_TRUE(PathService::Get(my_special_key, &result));
+  EXPECT_EQ(fake_dir1, result);
+
+  ASSERT_TRUE(PathService::Override(my_special_key, fake_dir2));
+  EXPECT_TRUE(PathService::Get(my_special_key, &result));
+  EXPECT_EQ(fake_dir2, result);
+  EXPECT_TRUE(PathService::Get(my_special_key, &result));
+  EXPECT_EQ(fake_dir2, result);
+
+  EXPECT_TRUE(PathService::RemoveOverrideForTests(my_special_key));
+  EXPECT_FALSE(PathService::Get(my_special_key, &result));
+}
+
+// Check that paths can be read from other threads while they are overridden.
+TEST_F(PathServiceTest, GetWhileOverriding) {
+  constexpr int kMySpecialKey = 669;
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath fake_dir1(
+      MakeAbsoluteFilePath(temp_dir.GetPath()).AppendASCII("1"));
+  const FilePath fake_dir2(
+      MakeAbsoluteFilePath(temp_dir.GetPath()).AppendASCII("2"));
+  ASSERT_TRUE(PathService::Override(kMySpecialKey, fake_dir1));
+
+  std::vector<std::unique_ptr<PathReader>> readers;
+  std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+  for (int i = 0; i < 4; ++i) {
+    readers.push_back(
+        std::make_unique<PathReader>(kMySpecialKey, fake_dir1, fake_dir2));
+    threads.push_back(std::make_unique<DelegateSimpleThread>(
+        readers.back().get(), "PathServiceReader"));
+    threads.back()->Start();
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(PathService::Override(kMySpecialKey,
+                                      i % 2 ? fake_dir1 : fake_dir2));
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+  EXPECT_TRUE(PathService::RemoveOverrideForTests(kMySpecialKey));
+}
+
+// Check that concurrent Get() calls, which fill the cache again after each
+// override, never return the path of another key.
+TEST_F(PathServiceTest, GetManyKeysWhileOverriding) {
+  constexpr int kClearingKey = 700;
+  constexpr int kFirstKey = 701;
+  constexpr int kNumKeys = 32;
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath root = MakeAbsoluteFilePath(temp_dir.GetPath());
+  std::vector<FilePath> expected;
+  for (int i = 0; i < kNumKeys; ++i) {
+    expected.push_back(root.AppendASCII(NumberToString(i)));
+    ASSERT_TRUE(PathService::Override(kFirstKey + i, expected.back()));
+  }
+
+  std::vector<std::unique_ptr<MultiKeyPathReader>> readers;
+  std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+  for (int i = 0; i < 4; ++i) {
+    readers.push_back(
+        std::make_unique<MultiKeyPathReader>(kFirstKey, expected));
+    threads.push_back(std::make_unique<DelegateSimpleThread>(
+        readers.back().get(), "PathServiceReader"));
+    threads.back()->Start();
+  }
+  // Each override clears the cache, so readers keep publishing new entries
+  // while others probe the index.
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_TRUE(PathService::Override(kClearingKey, root));
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  EXPECT_TRUE(PathService::RemoveOverrideForTests(kClearingKey));
+  for (int i = 0; i < kNumKeys; ++i) {
+    EXPECT_TRUE(PathService::RemoveOverrideForTests(kFirstKey + i));
+  }
+}
+
 TEST_F(PathServiceTest, RemoveOverride) {
   // Before we start the test we have to call RemoveOverride at least once to
   // clear any overrides that might have been left from other tests.
@@ -5,7 +5,10 @@
 #ifndef BASE_PENDING_TASK_H_
 #define BASE_PENDING_TASK_H_
 
+#include <stdint.h>
+
 #include <array>
+#include <limits>
 
 #include "base/base_export.h"
 #include "base/functional/callback.h"
@@ -68,6 +71,17 @@ struct BASE_EXPORT TaskMetadata {
   static constexpr size_t kTaskBacktraceLength = 4;
   std::array<const void*, kTaskBacktraceLength> task_backtrace = {};
 
+  // Identifies the causal chain of tasks this task belongs to in
+  // "toplevel.flow" traces. Tasks posted while running a task inherit its
+  // chain, so that a chain is either traced or skipped as a whole. Set by
+  // TaskAnnotator::WillQueueTask(): |kNoFlowChain| if "toplevel.flow" was
+  // disabled when the task was posted and |kSkippedFlowChain| if the chain
+  // wasn't sampled.
+  static constexpr uint64_t kNoFlowChain = 0;
+  static constexpr uint64_t kSkippedFlowChain =
+      std::numeric_limits<uint64_t>::max();
+  uint64_t flow_chain_id = kNoFlowChain;
+
   // The context of the IPC message that was being handled when this task was
   // posted. This is a hash of the IPC message name that is set within the scope
   // of an IPC handler and when symbolized uniquely identifies the message being
@@ -34,6 +34,30 @@ PickleIterator::PickleIterator(const Pickle& pickle)
       read_index_(0),
       end_index_(pickle.payload_size()) {}
 
+PickleIterator::PickleIterator(span<const uint8_t> payload)
+    : payload_(reinterpret_cast<const char*>(payload.data())),
+      read_index_(0),
+      end_index_(payload.size()) {}
+
+// static
+std::optional<PickleIterator> PickleIterator::WithUnownedData(
+    span<const uint8_t> data) {
+  Pickle::Header header;
+  if (data.size() < sizeof(header)) {
+    return std::nullopt;
+  }
+  // `data` may not be aligned for the header.
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.payload_size > data.size() - sizeof(header)) {
+    return std::nullopt;
+  }
+  const size_t header_size = data.size() - header.payload_size;
+  if (header_size != bits::AlignUp(header_size, sizeof(uint32_t))) {
+    return std::nullopt;
+  }
+  return PickleIterator(data.subspan(header_size));
+}
+
 template <typename Type>
 inline bool PickleIterator::ReadBuiltinType(Type* result) {
   static_assert(
@@ -489,4 +513,65 @@ inline void Pickle::WriteBytesCommon(span<const uint8_t> data) {
   std::copy(data.data(), data.data() + data.size(), static_cast<char*>(write));
 }
 
+PickleScatterWriter::PickleScatterWriter() = default;
+
+PickleScatterWriter::~PickleScatterWriter() = default;
+
+void PickleScatterWriter::WriteDataReference(span<const uint8_t> data) {
+  pickle_.WriteInt(checked_cast<int>(data.size()));
+  WriteBytesReference(data);
+}
+
+void PickleScatterWriter::WriteBytesReference(span<const uint8_t> data) {
+  if (data.empty()) {
+    return;
+  }
+  references_.push_back({pickle_.payload_size(), data});
+  references_size_ += bits::AlignUp(data.size(), sizeof(uint32_t));
+}
+
+size_t PickleScatterWriter::size() const {
+  return pickle_.size() + references_size_;
+}
+
+std::vector<span<const uint8_t>> PickleScatterWriter::GetSegments() {
+  // The padding of the references, as Pickle zeroes it.
+  static constexpr uint8_t kPadding[sizeof(uint32_t)] = {};
+
+  header_.payload_size =
+      checked_cast<uint32_t>(pickle_.payload_size() + references_size_);
+  std::vector<span<const uint8_t>> segments;
+  segments.reserve(2 * references_.size() + 2);
+  segments.push_back(byte_span_from_ref(header_));
+  const span<const uint8_t> payload = pickle_.payload_bytes();
+  size_t offset = 0;
+  for (const Reference& reference : references_) {
+    if (reference.payload_offset > offset) {
+      segments.push_back(
+          payload.subspan(offset, reference.payload_offset - offset));
+      offset = reference.payload_offset;
+    }
+    segments.push_back(reference.data);
+    const size_t padding =
+        bits::AlignUp(reference.data.size(), sizeof(uint32_t)) -
+        reference.data.size();
+    if (padding) {
+      segments.push_back(span(kPadding).first(padding));
+    }
+  }
+  if (offset < payload.size()) {
+    segments.push_back(payload.subspan(offset));
+  }
+  return segments;
+}
+
+void PickleScatterWriter::CopyTo(span<uint8_t> destination) {
+  CHECK_EQ(destination.size(), size());
+  for (span<const uint8_t> segment : GetSegments()) {
+    auto [to, rest] = destination.split_at(segment.size());
+    to.copy_from(segment);
+    destination = rest;
+  }
+}
+
 }  // namespace base
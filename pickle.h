@@ -16,6 +16,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/check_op.h"
@@ -36,6 +37,14 @@ class BASE_EXPORT PickleIterator {
   PickleIterator() : payload_(nullptr), read_index_(0), end_index_(0) {}
   explicit PickleIterator(const Pickle& pickle);
 
+  // Returns an iterator over the payload of the pickle serialized in `data`,
+  // without copying it, e.g. to parse a pickle in a
+  // ReadOnlySharedMemoryMapping in place. As for Pickle::WithUnownedBuffer(),
+  // the header size is deduced from the length of `data`, which must outlive
+  // the iterator. Returns nullopt if `data` doesn't hold a pickle.
+  static std::optional<PickleIterator> WithUnownedData(
+      span<const uint8_t> data);
+
   // Methods for reading the payload of the Pickle. To read from the start of
   // the Pickle, create a PickleIterator from a Pickle. If successful, these
   // methods return true. Otherwise, false is returned to indicate that the
@@ -92,6 +101,8 @@ class BASE_EXPORT PickleIterator {
   bool ReachedEnd() const { return read_index_ == end_index_; }
 
  private:
+  explicit PickleIterator(span<const uint8_t> payload);
+
   // Read Type from Pickle.
   template <typename Type>
   bool ReadBuiltinType(Type* result);
@@ -386,6 +397,56 @@ class BASE_EXPORT Pickle {
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextOverflow);
 };
 
+// Writes a pickle as a sequence of segments, so that large blobs are
+// referenced rather than copied into the pickle's buffer. The concatenation
+// of the segments is the pickle with the default header that the same writes
+// to a Pickle would make, so that it can be written out with one copy, e.g.
+// into shared memory, or with a vectored write.
+//
+//   PickleScatterWriter writer;
+//   writer.pickle().WriteInt(kind);
+//   writer.WriteDataReference(large_blob);
+//   writer.CopyTo(mapping.GetMemoryAsSpan<uint8_t>(writer.size()));
+class BASE_EXPORT PickleScatterWriter {
+ public:
+  PickleScatterWriter();
+  PickleScatterWriter(const PickleScatterWriter&) = delete;
+  PickleScatterWriter& operator=(const PickleScatterWriter&) = delete;
+  ~PickleScatterWriter();
+
+  // The pickle to write the values to copy to. Its header and size only
+  // cover the values written to it, not the references.
+  Pickle& pickle() { return pickle_; }
+
+  // As Pickle::WriteData() and Pickle::WriteBytes(), but `data` is only
+  // referenced, and must outlive the use of the segments.
+  void WriteDataReference(span<const uint8_t> data);
+  void WriteBytesReference(span<const uint8_t> data);
+
+  // Returns the number of bytes of the pickle, including the header.
+  size_t size() const;
+
+  // Returns the segments of the pickle, which are valid until the next write.
+  std::vector<span<const uint8_t>> GetSegments();
+
+  // Copies the pickle into `destination`, which must be size() bytes.
+  void CopyTo(span<uint8_t> destination);
+
+ private:
+  struct Reference {
+    // The offset in the payload of `pickle_` at which `data` goes.
+    size_t payload_offset;
+    span<const uint8_t> data;
+  };
+
+  Pickle pickle_;
+  std::vector<Reference> references_;
+  // The size of the references, with their padding.
+  size_t references_size_ = 0;
+  // The header of the whole pickle, as returned by GetSegments().
+  Pickle::Header header_;
+};
+
 }  // namespace base
 
 #endif  // BASE_PICKLE_H_
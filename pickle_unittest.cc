@@ -16,7 +16,9 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <vector>
 
+#include "base/containers/contains.h"
 #include "base/containers/heap_array.h"
 #include "base/containers/span.h"
 #include "base/strings/utf_string_conversions.h"
@@ -663,4 +665,75 @@ TEST(PickleTest, NonCanonicalBool) {
   EXPECT_TRUE(b);
 }
 
+TEST(PickleTest, IteratorWithUnownedData) {
+  Pickle pickle;
+  pickle.WriteInt(1);
+  pickle.WriteString("two");
+
+  // The data may be unaligned.
+  std::vector<uint8_t> buffer(pickle.size() + 1);
+  span<uint8_t> data = span(buffer).subspan(1u);
+  data.copy_from(span(pickle.data(), pickle.size()));
+
+  std::optional<PickleIterator> iter = PickleIterator::WithUnownedData(data);
+  ASSERT_TRUE(iter);
+  int out_int;
+  EXPECT_TRUE(iter->ReadInt(&out_int));
+  EXPECT_EQ(1, out_int);
+  StringPiece out_string;
+  EXPECT_TRUE(iter->ReadStringPiece(&out_string));
+  EXPECT_EQ("two", out_string);
+  // The string wasn't copied.
+  EXPECT_GE(reinterpret_cast<const uint8_t*>(out_string.data()), data.data());
+  EXPECT_LT(reinterpret_cast<const uint8_t*>(out_string.data()),
+            data.data() + data.size());
+  EXPECT_TRUE(iter->ReachedEnd());
+
+  // Too short for the header, or for the payload.
+  EXPECT_FALSE(PickleIterator::WithUnownedData(data.first(2u)));
+  EXPECT_FALSE(PickleIterator::WithUnownedData(data.first(data.size() - 4)));
+  // A header size which isn't a multiple of 4.
+  std::vector<uint8_t> padded(data.begin(), data.end());
+  padded.push_back(0);
+  EXPECT_FALSE(PickleIterator::WithUnownedData(padded));
+}
+
+TEST(PickleTest, ScatterWriter) {
+  const std::string blob(1000, 'b');
+  const std::string odd_blob(3, 'o');
+
+  // The same writes, to a Pickle and to a PickleScatterWriter.
+  Pickle pickle;
+  pickle.WriteInt(1);
+  pickle.WriteData(blob);
+  pickle.WriteData(odd_blob);
+  pickle.WriteBytes(as_byte_span(odd_blob));
+  pickle.WriteInt(2);
+  pickle.WriteData("");
+
+  PickleScatterWriter writer;
+  writer.pickle().WriteInt(1);
+  writer.WriteDataReference(as_byte_span(blob));
+  writer.WriteDataReference(as_byte_span(odd_blob));
+  writer.WriteBytesReference(as_byte_span(odd_blob));
+  writer.pickle().WriteInt(2);
+  writer.WriteDataReference({});
+
+  ASSERT_EQ(pickle.size(), writer.size());
+  std::vector<span<const uint8_t>> segments = writer.GetSegments();
+  std::vector<uint8_t> gathered;
+  for (span<const uint8_t> segment : segments) {
+    gathered.insert(gathered.end(), segment.begin(), segment.end());
+  }
+  EXPECT_EQ(span(pickle.data(), pickle.size()), span(gathered));
+  // The blob was referenced rather than copied.
+  EXPECT_TRUE(base::Contains(segments, as_byte_span(blob).data(),
+                             &span<const uint8_t>::data));
+  EXPECT_LT(writer.pickle().size(), blob.size());
+
+  std::vector<uint8_t> copy(writer.size());
+  writer.CopyTo(copy);
+  EXPECT_EQ(gathered, copy);
+}
+
 }  // namespace base
@@ -9,9 +9,11 @@
 
 #include "base/process/internal_linux.h"
 
+#include <fcntl.h>
 #include <limits.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <string_view>
@@ -19,6 +21,7 @@
 
 #include "base/files/file_util.h"
 #include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/strings/string_number_conversions.h"
@@ -87,6 +90,27 @@ bool ReadProcFile(const FilePath& file, std::string* buffer) {
   return !buffer->empty();
 }
 
+std::optional<std::string_view> ReadProcFileWithCachedFd(const FilePath& file,
+                                                         ScopedFD& fd,
+                                                         span<char> buffer) {
+  // Synchronously reading files in /proc is safe.
+  ScopedAllowBlocking scoped_allow_blocking;
+
+  if (!fd.is_valid()) {
+    DCHECK(FilePath(kProcDir).IsParent(file));
+    fd.reset(HANDLE_EINTR(open(file.value().c_str(), O_RDONLY | O_CLOEXEC)));
+    if (!fd.is_valid()) {
+      return std::nullopt;
+    }
+  }
+  const ssize_t size =
+      HANDLE_EINTR(pread(fd.get(), buffer.data(), buffer.size(), 0));
+  if (size <= 0) {
+    return std::nullopt;
+  }
+  return std::string_view(buffer.data(), static_cast<size_t>(size));
+}
+
 bool ReadProcFileToTrimmedStringPairs(pid_t pid,
                                       std::string_view filename,
                                       StringPairs* key_value_pairs) {
@@ -200,6 +224,52 @@ bool ParseProcStats(const std::string& stats_data,
   return true;
 }
 
+bool ParseProcStatsValues(std::string_view stats_data,
+                          ProcStatsValues* values) {
+  // See ParseProcStats() for the format.
+  const size_t open_parens_idx = stats_data.find(" (");
+  const size_t close_parens_idx = stats_data.rfind(") ");
+  if (open_parens_idx == std::string_view::npos ||
+      close_parens_idx == std::string_view::npos ||
+      open_parens_idx > close_parens_idx) {
+    return false;
+  }
+
+  values->fill(0);
+  if (!StringToInt64(stats_data.substr(0, open_parens_idx), &(*values)[0])) {
+    return false;
+  }
+
+  size_t pos = close_parens_idx + 2;
+  for (size_t field = VM_STATE; field < values->size(); ++field) {
+    if (pos >= stats_data.size()) {
+      return false;
+    }
+    const size_t end =
+        std::min(stats_data.find_first_of(" \n", pos), stats_data.size());
+    if (field != VM_STATE &&
+        !StringToInt64(stats_data.substr(pos, end - pos), &(*values)[field])) {
+      return false;
+    }
+    pos = end + 1;
+  }
+  return true;
+}
+
+bool ReadProcStatsValues(pid_t pid,
+                         ScopedFD& stat_fd,
+                         ProcStatsValues* values) {
+  // /proc/<pid>/stat is a few hundred bytes, so that a single pread() reads it
+  // whole.
+  std::array<char, 2048> buffer;
+  const FilePath stat_file = stat_fd.is_valid()
+                                 ? FilePath()
+                                 : GetProcPidDir(pid).Append(kStatFile);
+  const std::optional<std::string_view> stats_data =
+      ReadProcFileWithCachedFd(stat_file, stat_fd, buffer);
+  return stats_data && ParseProcStatsValues(*stats_data, values);
+}
+
 typedef std::map<std::string, std::string> ProcStatMap;
 void ParseProcStat(const std::string& contents, ProcStatMap* output) {
   StringPairs key_value_pairs;
@@ -12,14 +12,17 @@
 #include <stdint.h>
 #include <unistd.h>
 
+#include <array>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include "base/containers/span.h"
+#include "base/base_export.h"
 #include "base/files/dir_reader_posix.h"
 #include "base/files/file_path.h"
+#include "base/files/scoped_file.h"
 #include "base/process/process_handle.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
@@ -46,6 +49,15 @@ BASE_EXPORT base::FilePath GetProcPidDir(pid_t pid);
 // read and is non-empty.
 bool ReadProcFile(const FilePath& file, std::string* buffer);
 
+// Same as ReadProcFile(), but reads |file| into |buffer| with pread() on
+// |fd|, which is opened by the first call and then kept open so that the
+// following calls don't have to look |file| up and open it again. Returns the
+// part of |buffer| which was read, or nullopt if nothing could be read.
+// |file| is ignored once |fd| is open.
+std::optional<std::string_view> ReadProcFileWithCachedFd(const FilePath& file,
+                                                         ScopedFD& fd,
+                                                         span<char> buffer);
+
 // Take a /proc directory entry named |d_name|, and if it is the directory for
 // a process, convert it to a pid_t.
 // Returns 0 on failure.
@@ -96,8 +108,28 @@ enum ProcStatsFields {
   VM_STARTTIME = 21,   // The time the process started in clock ticks.
   VM_VSIZE = 22,       // Virtual memory size in bytes.
   VM_RSS = 23,         // Resident Set Size in pages.
+  VM_PROCESSOR = 38,   // CPU number last executed on.
 };
 
+// The numeric fields of /proc/<pid>/stat up to VM_RSS, indexed by
+// ProcStatsFields. The entries of VM_COMM and VM_STATE are 0.
+using ProcStatsValues = std::array<int64_t, VM_RSS + 1>;
+
+// Same as ParseProcStats() followed by GetProcStatsFieldAsOptionalInt64() on
+// each numeric field up to VM_RSS, but parses |stats_data| in place instead of
+// splitting it into strings. Returns false if |stats_data| is truncated or if
+// one of these fields isn't an integer.
+BASE_EXPORT bool ParseProcStatsValues(std::string_view stats_data,
+                                      ProcStatsValues* values);
+
+// Reads /proc/<pid>/stat and parses it with ParseProcStatsValues(). The file
+// is opened into |stat_fd| by the first call and re-read from the start with
+// pread() by the following ones, which saves the path lookup and the
+// open()/close() of ReadProcStats() when sampling the same process
+// repeatedly. Since |stat_fd| refers to the process it was opened for, the
+// read fails once that process exits, even if |pid| is reused.
+bool ReadProcStatsValues(pid_t pid, ScopedFD& stat_fd, ProcStatsValues* values);
+
 // Reads the |field_num|th field from |proc_stats|. Returns 0 on failure.
 // This version does not handle the first 3 values, since the first value is
 // simply |pid|, and the next two values are strings.
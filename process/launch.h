@@ -217,6 +217,14 @@ struct BASE_EXPORT LaunchOptions {
   // File descriptors of the parent process with FD_CLOEXEC flag to be removed
   // before calling exec*().
   std::vector<int> fds_to_remove_cloexec;
+
+  // If true, and neither |clone_flags| nor |pre_exec_delegate| is set, the
+  // child is created with clone(CLONE_VM | CLONE_VFORK), as posix_spawn()
+  // does: it runs in the memory of the parent until it calls exec*(), so the
+  // page tables of a large parent aren't copied. The launching thread is
+  // suspended meanwhile. Requires close_range() (Linux 5.9+) to close the
+  // inherited file descriptors; fork() is used otherwise.
+  bool use_vfork = false;
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
 
 #if BUILDFLAG(IS_MAC) || (BUILDFLAG(IS_IOS) && BUILDFLAG(USE_BLINK))
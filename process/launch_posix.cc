@@ -18,6 +18,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
@@ -25,6 +26,7 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -32,6 +34,7 @@
 
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
+#include "base/containers/span.h"
 #include "base/debug/debugger.h"
 #include "base/debug/stack_trace.h"
 #include "base/files/dir_reader_posix.h"
@@ -42,6 +45,7 @@
 #include "base/process/environment_internal.h"
 #include "base/process/process.h"
 #include "base/process/process_metrics.h"
+#include "base/ranges/algorithm.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/platform_thread_internal_posix.h"
@@ -214,10 +218,73 @@ static const char kFDDir[] = "/dev/fd";
 static const char kFDDir[] = "/proc/self/fd";
 #endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+namespace {
+
+// Closes the fds in [first, last] with close_range(), which, unlike close(),
+// isn't interposed by base/files/scoped_file_linux.cc. Returns false if the
+// kernel doesn't support close_range() (Linux < 5.9).
+bool CloseFdRange(unsigned int first, unsigned int last) {
+#if defined(__NR_close_range)
+  return syscall(__NR_close_range, first, last, 0) == 0;
+#else
+  return false;
+#endif
+}
+
+// Not async-signal-safe the first time, since it initializes a static.
+bool IsCloseRangeSupported() {
+  // The range only contains the largest fd, which can't be open.
+  static const bool supported = CloseFdRange(~0U, ~0U);
+  return supported;
+}
+
+// Closes the fds above stderr which aren't the destination of `saved_mapping`,
+// with one close_range() per gap between the destinations instead of one
+// close() per open fd. Returns false if close_range() failed, in which case
+// some of the fds may still be open.
+bool CloseSuperfluousFdsWithCloseRange(
+    const base::InjectiveMultimap& saved_mapping) {
+  // DANGER: no calls to malloc or locks are allowed from now on:
+  // http://crbug.com/36678
+  unsigned int first = STDERR_FILENO + 1;
+  while (true) {
+    // Find the lowest destination not below `first`. There are few of them,
+    // so a scan per gap is cheaper than sorting, which could allocate.
+    // Cannot use STL iterators here, since debug iterators use locks.
+    unsigned int next_saved = ~0U;
+    for (size_t i = 0; i < saved_mapping.size(); ++i) {
+      const int dest = saved_mapping[i].dest;
+      if (dest >= 0 && static_cast<unsigned int>(dest) >= first &&
+          static_cast<unsigned int>(dest) < next_saved) {
+        next_saved = static_cast<unsigned int>(dest);
+      }
+    }
+    if (next_saved == ~0U) {
+      return CloseFdRange(first, ~0U);
+    }
+    if (next_saved > first && !CloseFdRange(first, next_saved - 1)) {
+      return false;
+    }
+    first = next_saved + 1;
+  }
+}
+
+}  // namespace
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+
 void CloseSuperfluousFds(const base::InjectiveMultimap& saved_mapping) {
   // DANGER: no calls to malloc or locks are allowed from now on:
   // http://crbug.com/36678
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  // Falls back to closing the fds one at a time if close_range() isn't
+  // supported, which it reports before closing anything.
+  if (CloseSuperfluousFdsWithCloseRange(saved_mapping)) {
+    return;
+  }
+#endif
+
   // Get the maximum number of FDs possible.
   size_t max_fds = GetMaxFds();
 
@@ -276,6 +343,280 @@ void CloseSuperfluousFds(const base::InjectiveMultimap& saved_mapping) {
   }
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+namespace {
+
+// The size of the stack of the child of LaunchProcessWithVfork(), on top of
+// the room that execvpe() needs to rewrite the argv of a script.
+constexpr size_t kVforkChildStackSize = 64 * 1024;
+
+// A dup2() of the sequence computed by ScheduleFdMoves(). `kTempFd` stands for
+// the copy of an fd which breaks a cycle of the mapping.
+struct FdMove {
+  static constexpr int kTempFd = -1;
+
+  int source;
+  int dest;
+};
+
+// Orders the dup2()s which apply `fds_to_remap`, so that no fd is overwritten
+// before it's duplicated to all its destinations. A cycle, e.g. a swap of two
+// fds, goes through a copy of one of its fds: {fd, kTempFd}, and later
+// {kTempFd, ...}. A single copy is live at a time, since the moves which read
+// it form a chain that is applied before the next cycle is broken. Unlike
+// ShuffleFileDescriptors(), this runs in the parent, which can allocate, so the
+// child only has to issue the dup2()s.
+std::vector<FdMove> ScheduleFdMoves(
+    const FileHandleMappingVector& fds_to_remap) {
+  std::vector<FdMove> pending;
+  for (const auto& [source, dest] : fds_to_remap) {
+    if (source != dest) {
+      pending.push_back({source, dest});
+    }
+  }
+
+  std::vector<FdMove> moves;
+  while (!pending.empty()) {
+    // A move is ready once no pending move reads its destination.
+    auto ready = ranges::find_if(pending, [&pending](const FdMove& move) {
+      return ranges::none_of(pending, [&move](const FdMove& other) {
+        return other.source == move.dest;
+      });
+    });
+    if (ready != pending.end()) {
+      moves.push_back(*ready);
+      pending.erase(ready);
+      continue;
+    }
+
+    // Only cycles are left. Copy the destination of a move, so that the move
+    // becomes ready.
+    DCHECK(ranges::none_of(pending, [](const FdMove& move) {
+      return move.source == FdMove::kTempFd;
+    }));
+    const int saved_fd = pending.front().dest;
+    moves.push_back({saved_fd, FdMove::kTempFd});
+    for (FdMove& move : pending) {
+      if (move.source == saved_fd) {
+        move.source = FdMove::kTempFd;
+      }
+    }
+  }
+  return moves;
+}
+
+// What the child of LaunchProcessWithVfork() needs, computed by the parent.
+// It lives on the stack of the parent, which is suspended until the child
+// calls execvpe(), so the pointers can't dangle: they aren't raw_ptr<>, whose
+// checks the child must not run.
+struct VforkChildArgs {
+  RAW_PTR_EXCLUSION const LaunchOptions* options = nullptr;
+  RAW_PTR_EXCLUSION const char* executable_path = nullptr;
+  RAW_PTR_EXCLUSION char* const* argv = nullptr;
+  RAW_PTR_EXCLUSION char* const* envp = nullptr;
+  RAW_PTR_EXCLUSION const char* current_directory = nullptr;
+  span<const FdMove> fd_moves;
+  // Above all the fds of `fd_moves`, so that the copy of an fd isn't
+  // overwritten by a later move.
+  int min_temp_fd = 0;
+  RAW_PTR_EXCLUSION const InjectiveMultimap* saved_fds = nullptr;
+  sigset_t orig_sigmask;
+};
+
+// Runs in the child of LaunchProcessWithVfork() until it calls execvpe(). The
+// child has its own stack, but runs in the memory of the parent, so on top of
+// the rules of the fork() child (no malloc and no locks) it must not write to
+// the memory that the parent uses: the FD ownership table isn't reset, fds are
+// never closed with close(), which reads that table, and the environment is
+// passed to execvpe() instead of being set.
+int VforkChildMain(void* arg) {
+  const VforkChildArgs& args = *static_cast<const VforkChildArgs*>(arg);
+  const LaunchOptions& options = *args.options;
+
+  // Cannot use STL iterators here, since debug iterators use locks.
+  // NOLINTNEXTLINE(modernize-loop-convert)
+  for (size_t i = 0; i < options.fds_to_remove_cloexec.size(); ++i) {
+    if (!RemoveCloseOnExec(options.fds_to_remove_cloexec[i])) {
+      RAW_LOG(WARNING, "Failed to remove FD_CLOEXEC flag");
+    }
+  }
+
+  // See LaunchProcess() for why stdin is /dev/null.
+  const int null_fd = HANDLE_EINTR(open("/dev/null", O_RDONLY));
+  if (null_fd < 0) {
+    RAW_LOG(ERROR, "Failed to open /dev/null");
+    _exit(127);
+  }
+  if (null_fd != STDIN_FILENO) {
+    if (HANDLE_EINTR(dup2(null_fd, STDIN_FILENO)) != STDIN_FILENO) {
+      RAW_LOG(ERROR, "Failed to dup /dev/null for stdin");
+      _exit(127);
+    }
+    CloseFdRange(static_cast<unsigned int>(null_fd),
+                 static_cast<unsigned int>(null_fd));
+  }
+
+  if (options.new_process_group && setpgid(0, 0) < 0) {
+    RAW_LOG(ERROR, "setpgid failed");
+    _exit(127);
+  }
+
+  if (options.maximize_rlimits) {
+    for (auto resource : *options.maximize_rlimits) {
+      struct rlimit limit;
+      if (getrlimit(resource, &limit) < 0) {
+        RAW_LOG(WARNING, "getrlimit failed");
+      } else if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        if (setrlimit(resource, &limit) < 0) {
+          RAW_LOG(WARNING, "setrlimit failed");
+        }
+      }
+    }
+  }
+
+  // The child has its own copy of the signal handlers, which must be reset
+  // before the signals are unblocked: the handlers of the parent would run in
+  // its memory.
+  ResetChildSignalHandlersToDefaults();
+  SetSignalMask(args.orig_sigmask);
+
+#if BUILDFLAG(IS_CHROMEOS)
+  if (options.ctrl_terminal_fd >= 0) {
+    // Set process' controlling terminal.
+    if (HANDLE_EINTR(setsid()) != -1) {
+      if (HANDLE_EINTR(ioctl(options.ctrl_terminal_fd, TIOCSCTTY, nullptr)) ==
+          -1) {
+        RAW_LOG(WARNING, "ioctl(TIOCSCTTY), ctrl terminal not set");
+      }
+    } else {
+      RAW_LOG(WARNING, "setsid failed, ctrl terminal not set");
+    }
+  }
+#endif  // BUILDFLAG(IS_CHROMEOS)
+
+  // The copies are close-on-exec, and closed with the superfluous fds anyway.
+  int temp_fd = -1;
+  for (const FdMove& move : args.fd_moves) {
+    if (move.dest == FdMove::kTempFd) {
+      temp_fd =
+          HANDLE_EINTR(fcntl(move.source, F_DUPFD_CLOEXEC, args.min_temp_fd));
+      if (temp_fd < 0) {
+        RAW_LOG(ERROR, "Failed to copy an fd to remap");
+        _exit(127);
+      }
+      continue;
+    }
+    const int source = move.source == FdMove::kTempFd ? temp_fd : move.source;
+    if (HANDLE_EINTR(dup2(source, move.dest)) != move.dest) {
+      RAW_LOG(ERROR, "Failed to remap an fd");
+      _exit(127);
+    }
+  }
+
+  if (!CloseSuperfluousFdsWithCloseRange(*args.saved_fds)) {
+    RAW_LOG(ERROR, "close_range failed");
+    _exit(127);
+  }
+
+#ifndef PR_SET_NO_NEW_PRIVS
+#define PR_SET_NO_NEW_PRIVS 38
+#endif
+  if (!options.allow_new_privs) {
+    if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) && errno != EINVAL) {
+      // Only log if the error is not EINVAL (i.e. not supported).
+      RAW_LOG(FATAL, "prctl(PR_SET_NO_NEW_PRIVS) failed");
+    }
+  }
+
+  if (options.kill_on_parent_death) {
+    if (prctl(PR_SET_PDEATHSIG, SIGKILL) != 0) {
+      RAW_LOG(ERROR, "prctl(PR_SET_PDEATHSIG) failed");
+      _exit(127);
+    }
+  }
+
+  if (args.current_directory) {
+    RAW_CHECK(chdir(args.current_directory) == 0);
+  }
+
+  execvpe(args.executable_path, args.argv, args.envp);
+
+  RAW_LOG(ERROR, "LaunchProcess: failed to execvpe:");
+  RAW_LOG(ERROR, args.argv[0]);
+  _exit(127);
+}
+
+// Whether LaunchProcess() can create the child with LaunchProcessWithVfork().
+// The child can't run the async-signal-safe code of a PreExecDelegate, which
+// may write to memory, nor be created with custom clone flags.
+bool CanLaunchWithVfork(const LaunchOptions& options) {
+  return options.use_vfork && !options.clone_flags &&
+         !options.pre_exec_delegate && IsCloseRangeSupported();
+}
+
+// Creates the child with clone(CLONE_VM | CLONE_VFORK), like posix_spawn():
+// unlike fork(), it doesn't copy the page tables of the parent, so its cost
+// doesn't grow with the memory of the parent. The calling thread is suspended
+// until the child calls execvpe() or exits. Returns the pid of the child, or
+// -1 on failure.
+pid_t LaunchProcessWithVfork(const std::vector<char*>& argv_cstr,
+                             char* const* envp,
+                             const LaunchOptions& options) {
+  const std::vector<FdMove> fd_moves = ScheduleFdMoves(options.fds_to_remap);
+  InjectiveMultimap saved_fds;
+  saved_fds.reserve(options.fds_to_remap.size());
+  int max_fd = STDERR_FILENO;
+  for (const auto& [source, dest] : options.fds_to_remap) {
+    saved_fds.push_back(InjectionArc(source, dest, false));
+    max_fd = std::max({max_fd, source, dest});
+  }
+
+  VforkChildArgs args;
+  args.options = &options;
+  args.executable_path = !options.real_path.empty()
+                             ? options.real_path.value().c_str()
+                             : argv_cstr[0];
+  args.argv = argv_cstr.data();
+  args.envp = envp;
+  if (!options.current_directory.empty()) {
+    args.current_directory = options.current_directory.value().c_str();
+  }
+  args.fd_moves = fd_moves;
+  args.min_temp_fd = max_fd + 1;
+  args.saved_fds = &saved_fds;
+
+  // execvpe() copies the argv on the stack to run a script with /bin/sh.
+  const size_t stack_size =
+      kVforkChildStackSize + (argv_cstr.size() + 2) * sizeof(char*);
+  void* const stack =
+      mmap(nullptr, stack_size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+  if (stack == MAP_FAILED) {
+    DPLOG(ERROR) << "mmap";
+    return -1;
+  }
+
+  sigset_t full_sigset;
+  sigfillset(&full_sigset);
+  args.orig_sigmask = SetSignalMask(full_sigset);
+  // The stack grows downward on all the architectures that ForkWithFlags()
+  // supports.
+  const pid_t pid =
+      clone(&VforkChildMain, static_cast<char*>(stack) + stack_size,
+            CLONE_VM | CLONE_VFORK | SIGCHLD, &args);
+  SetSignalMask(args.orig_sigmask);
+  munmap(stack, stack_size);
+
+  if (pid < 0) {
+    DPLOG(ERROR) << "clone";
+  }
+  return pid;
+}
+
+}  // namespace
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+
 Process LaunchProcess(const CommandLine& cmdline,
                       const LaunchOptions& options) {
   return LaunchProcess(cmdline.argv(), options);
@@ -304,6 +645,24 @@ Process LaunchProcess(const std::vector<std::string>& argv,
   if (!options.environment.empty())
     new_environ = internal::AlterEnvironment(old_environ, options.environment);
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  if (CanLaunchWithVfork(options)) {
+    const pid_t pid = LaunchProcessWithVfork(
+        argv_cstr, new_environ ? new_environ.get() : old_environ, options);
+    if (pid < 0) {
+      return Process();
+    }
+    if (options.wait) {
+      // See below.
+      ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                              BlockingType::MAY_BLOCK);
+      pid_t ret = HANDLE_EINTR(waitpid(pid, nullptr, 0));
+      DPCHECK(ret > 0);
+    }
+    return Process(pid);
+  }
+#endif
+
   sigset_t full_sigset;
   sigfillset(&full_sigset);
   const sigset_t orig_sigmask = SetSignalMask(full_sigset);
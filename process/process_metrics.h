@@ -37,6 +37,10 @@
 #include "base/win/windows_types.h"
 #endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "base/files/scoped_file.h"
+#endif
+
 #if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
     BUILDFLAG(IS_AIX)
 #include <string>
@@ -262,6 +266,12 @@ class BASE_EXPORT ProcessMetrics {
 #if BUILDFLAG(IS_MAC)
   raw_ptr<PortProvider> port_provider_;
 #endif  // BUILDFLAG(IS_MAC)
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // /proc/<pid>/stat, kept open between samples. Opened by the first query
+  // which reads it.
+  mutable ScopedFD stat_fd_;
+#endif
 };
 
 // Returns the memory committed by the system in KBytes.
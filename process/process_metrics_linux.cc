@@ -97,20 +97,31 @@ std::unique_ptr<ProcessMetrics> ProcessMetrics::CreateProcessMetrics(
 }
 
 size_t ProcessMetrics::GetResidentSetSize() const {
-  return internal::ReadProcStatsAndGetFieldAsSizeT(process_, internal::VM_RSS) *
+  internal::ProcStatsValues proc_stats;
+  if (!internal::ReadProcStatsValues(process_, stat_fd_, &proc_stats) ||
+      proc_stats[internal::VM_RSS] < 0) {
+    return 0;
+  }
+  return static_cast<size_t>(proc_stats[internal::VM_RSS]) *
          checked_cast<size_t>(getpagesize());
 }
 
 base::expected<TimeDelta, ProcessCPUUsageError>
 ProcessMetrics::GetCumulativeCPUUsage() {
-  std::string buffer;
-  std::vector<std::string> proc_stats;
-  if (!internal::ReadProcStats(process_, &buffer) ||
-      !internal::ParseProcStats(buffer, &proc_stats)) {
+  internal::ProcStatsValues proc_stats;
+  if (!internal::ReadProcStatsValues(process_, stat_fd_, &proc_stats)) {
     return base::unexpected(ProcessCPUUsageError::kSystemError);
   }
 
-  return ParseTotalCPUTimeFromStats(proc_stats);
+  const int64_t utime = proc_stats[internal::VM_UTIME];
+  const int64_t stime = proc_stats[internal::VM_STIME];
+  if (utime < 0 || stime < 0) {
+    return base::unexpected(ProcessCPUUsageError::kSystemError);
+  }
+  const TimeDelta cpu_time =
+      internal::ClockTicksToTimeDelta(base::ClampAdd(utime, stime));
+  CHECK(!cpu_time.is_negative());
+  return base::ok(cpu_time);
 }
 
 bool ProcessMetrics::GetCumulativeCPUUsagePerThread(
@@ -148,17 +159,12 @@ uint64_t ProcessMetrics::GetVmSwapBytes() const {
 bool ProcessMetrics::GetPageFaultCounts(PageFaultCounts* counts) const {
   // We are not using internal::ReadStatsFileAndGetFieldAsInt64(), since it
   // would read the file twice, and return inconsistent numbers.
-  std::string stats_data;
-  if (!internal::ReadProcStats(process_, &stats_data))
-    return false;
-  std::vector<std::string> proc_stats;
-  if (!internal::ParseProcStats(stats_data, &proc_stats))
+  internal::ProcStatsValues proc_stats;
+  if (!internal::ReadProcStatsValues(process_, stat_fd_, &proc_stats))
     return false;
 
-  counts->minor =
-      internal::GetProcStatsFieldAsInt64(proc_stats, internal::VM_MINFLT);
-  counts->major =
-      internal::GetProcStatsFieldAsInt64(proc_stats, internal::VM_MAJFLT);
+  counts->minor = proc_stats[internal::VM_MINFLT];
+  counts->major = proc_stats[internal::VM_MAJFLT];
   return true;
 }
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
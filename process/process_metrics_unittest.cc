@@ -51,6 +51,10 @@
 #include <sys/mman.h>
 #endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "base/process/internal_linux.h"
+#endif
+
 #if BUILDFLAG(IS_MAC)
 #include <mach/mach.h>
 
@@ -856,6 +860,43 @@ TEST(ProcessMetricsTest, ParseProcStatCPU) {
       "140735857770737 140735857774557 0";
   EXPECT_EQ(5186 + 11, ParseProcStatCPU(kWeirdNameStat));
 }
+
+TEST(ProcessMetricsTest, ParseProcStatsValues) {
+  const char kWeirdNameStat[] =
+      "26115 (Hello) You ()))  ) R 24614 26115 24614"
+      " 34839 26115 4218880 227 0 0 0 "
+      "5186 11 0 0 "
+      "20 0 1 0 36933953 4296704 90 18446744073709551615 4194304 4196116 "
+      "140735857761568 140735857761160 4195644 0 0 0 0 0 0 0 17 14 0 0 0 0 0 "
+      "6295056 6295616 16519168 140735857770710 140735857770737 "
+      "140735857770737 140735857774557 0\n";
+  internal::ProcStatsValues values;
+  ASSERT_TRUE(internal::ParseProcStatsValues(kWeirdNameStat, &values));
+  EXPECT_EQ(26115, values[0]);
+  EXPECT_EQ(0, values[internal::VM_COMM]);
+  EXPECT_EQ(0, values[internal::VM_STATE]);
+  EXPECT_EQ(24614, values[internal::VM_PPID]);
+  EXPECT_EQ(227, values[internal::VM_MINFLT]);
+  EXPECT_EQ(0, values[internal::VM_MAJFLT]);
+  EXPECT_EQ(5186, values[internal::VM_UTIME]);
+  EXPECT_EQ(11, values[internal::VM_STIME]);
+  EXPECT_EQ(1, values[internal::VM_NUMTHREADS]);
+  EXPECT_EQ(36933953, values[internal::VM_STARTTIME]);
+  EXPECT_EQ(4296704, values[internal::VM_VSIZE]);
+  EXPECT_EQ(90, values[internal::VM_RSS]);
+
+  // Truncated before VM_RSS.
+  EXPECT_FALSE(internal::ParseProcStatsValues(
+      "960 (top) S 16230 960 16230 34818 960 4202496 471 0 0 0 12 16\n",
+      &values));
+  // Non-numeric field.
+  EXPECT_FALSE(internal::ParseProcStatsValues(
+      "960 (top) S 16230 960 16230 34818 960 4202496 471 0 0 0 x 16 0 0 "
+      "20 0 1 0 121946157 15077376 314 18446744073709551615",
+      &values));
+  // No parens.
+  EXPECT_FALSE(internal::ParseProcStatsValues("960 top S 16230", &values));
+}
 #endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
         // BUILDFLAG(IS_ANDROID)
 
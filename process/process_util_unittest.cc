@@ -18,6 +18,7 @@
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_file.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/functional/bind.h"
 #include "base/logging.h"
 #include "base/path_service.h"
@@ -79,7 +80,6 @@
 #include <zircon/process.h>
 #include <zircon/processargs.h>
 #include <zircon/syscalls.h>
-#include "base/files/scoped_temp_dir.h"
 #include "base/fuchsia/file_utils.h"
 #include "base/fuchsia/filtered_service_directory.h"
 #include "base/fuchsia/fuchsia_logging.h"
@@ -162,6 +162,13 @@ class ProcessUtilTest : public MultiProcessTest {
 #if BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
   // Spawn a child process that counts how many file descriptors are open.
   int CountOpenFDsInChild();
+#endif
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+  // Launches a child with `fds_to_remap` swapping the fds of two pipes, which
+  // is a cycle for LaunchProcess() to break. Returns the exit code of the
+  // child, the number of fds it inherited besides the pipes, or -1 if the fds
+  // to swap are in use in this process.
+  int LaunchWithSwappedFds(bool use_vfork);
 #endif
   // Converts the filename to a platform specific filepath.
   // On Android files can not be created in arbitrary directories.
@@ -1184,6 +1191,94 @@ TEST_F(ProcessUtilTest, FDRemappingIncludesStdio) {
   EXPECT_EQ(0, exit_code);
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+const char kFirstPipeValue = 'a';
+const char kSecondPipeValue = 'b';
+MULTIPROCESS_TEST_MAIN(ProcessUtilsVerifySwappedFds) {
+  CHECK_EQ(1, HANDLE_EINTR(write(kChildPipe, &kFirstPipeValue, 1)));
+  CHECK_EQ(1, HANDLE_EINTR(write(kChildPipe + 1, &kSecondPipeValue, 1)));
+
+  // Returns the number of other open fds, as ProcessUtilsLeakFDChildProcess.
+  int num_open_files = 0;
+  for (int i = STDERR_FILENO + 1; i < GetMaxFilesOpenInProcess(); i++) {
+    if (i != kChildPipe && i != kChildPipe + 1 && fcntl(i, F_GETFD) != -1) {
+      num_open_files += 1;
+    }
+  }
+  return num_open_files;
+}
+
+int ProcessUtilTest::LaunchWithSwappedFds(bool use_vfork) {
+  // The fds must be free in this process, so that the swap can be set up.
+  if (fcntl(kChildPipe, F_GETFD) != -1 ||
+      fcntl(kChildPipe + 1, F_GETFD) != -1) {
+    return -1;
+  }
+  int first_pipe[2];
+  int second_pipe[2];
+  CHECK_EQ(0, pipe(first_pipe));
+  CHECK_EQ(0, pipe(second_pipe));
+  ScopedFD first_read(first_pipe[0]);
+  ScopedFD second_read(second_pipe[0]);
+  // The write ends are in each other's destination.
+  ScopedFD first_write(HANDLE_EINTR(dup2(first_pipe[1], kChildPipe + 1)));
+  ScopedFD second_write(HANDLE_EINTR(dup2(second_pipe[1], kChildPipe)));
+  CHECK_EQ(0, IGNORE_EINTR(close(first_pipe[1])));
+  CHECK_EQ(0, IGNORE_EINTR(close(second_pipe[1])));
+
+  LaunchOptions options;
+  options.use_vfork = use_vfork;
+  options.fds_to_remap.emplace_back(first_write.get(), kChildPipe);
+  options.fds_to_remap.emplace_back(second_write.get(), kChildPipe + 1);
+  Process process =
+      SpawnChildWithOptions("ProcessUtilsVerifySwappedFds", options);
+  CHECK(process.IsValid());
+  first_write.reset();
+  second_write.reset();
+
+  char buf;
+  CHECK_EQ(1, HANDLE_EINTR(read(first_read.get(), &buf, 1)));
+  EXPECT_EQ(kFirstPipeValue, buf);
+  CHECK_EQ(1, HANDLE_EINTR(read(second_read.get(), &buf, 1)));
+  EXPECT_EQ(kSecondPipeValue, buf);
+
+  int exit_code;
+  CHECK(process.WaitForExitWithTimeout(TestTimeouts::action_timeout(),
+                                       &exit_code));
+  return exit_code;
+}
+
+TEST_F(ProcessUtilTest, FDRemappingCycle) {
+  const int exit_code = LaunchWithSwappedFds(/*use_vfork=*/false);
+  if (exit_code == -1) {
+    GTEST_SKIP() << "The fds to swap are in use";
+  }
+
+  // The vfork() child closes the same fds.
+  EXPECT_EQ(exit_code, LaunchWithSwappedFds(/*use_vfork=*/true));
+}
+
+TEST_F(ProcessUtilTest, LaunchProcessWithVfork) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath output_file = temp_dir.GetPath().AppendASCII("output");
+
+  LaunchOptions options;
+  options.use_vfork = true;
+  options.wait = true;
+  options.current_directory = temp_dir.GetPath();
+  options.environment["VFORK_TEST"] = "value";
+  Process process = LaunchProcess(
+      {"/bin/sh", "-c", "echo \"$VFORK_TEST\" > output"}, options);
+  ASSERT_TRUE(process.IsValid());
+
+  std::string output;
+  ASSERT_TRUE(ReadFileToString(output_file, &output));
+  EXPECT_EQ("value\n", output);
+  EXPECT_EQ(nullptr, getenv("VFORK_TEST"));
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS)
+
 #if BUILDFLAG(IS_FUCHSIA)
 
 const uint16_t kStartupHandleId = 43;
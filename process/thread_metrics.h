@@ -0,0 +1,108 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_PROCESS_THREAD_METRICS_H_
+#define BASE_PROCESS_THREAD_METRICS_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/files/scoped_file.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+
+namespace base {
+
+// Scheduling metrics of a thread of the current process, as reported by
+// /proc/self/task/<tid>/. Only available on Linux, ChromeOS and Android.
+struct BASE_EXPORT ThreadMetrics {
+  PlatformThreadId tid = kInvalidThreadId;
+
+  // The name of the thread in ThreadIdNameManager. Valid for the lifetime of
+  // the process.
+  const char* name = nullptr;
+
+  // Time spent running in user and kernel mode.
+  TimeDelta cpu_time;
+
+  // Number of times the thread gave up the CPU, e.g. to wait on a lock, an
+  // event or IO.
+  int64_t voluntary_context_switches = 0;
+
+  // Number of times the thread was preempted.
+  int64_t involuntary_context_switches = 0;
+
+  // The CPU the thread ran on last.
+  int last_cpu = -1;
+};
+
+// Collects the ThreadMetrics of the threads of the current process, e.g. to
+// diagnose an imbalance between the workers of a thread pool. The /proc files
+// of each thread are kept open between collections, so that periodic sampling
+// costs a pread() per file instead of a lookup, an open() and a close(). Not
+// thread-safe.
+class BASE_EXPORT ThreadMetricsCollector {
+ public:
+  ThreadMetricsCollector();
+  ThreadMetricsCollector(const ThreadMetricsCollector&) = delete;
+  ThreadMetricsCollector& operator=(const ThreadMetricsCollector&) = delete;
+  ~ThreadMetricsCollector();
+
+  // Returns the metrics of the live threads since they started.
+  std::vector<ThreadMetrics> Collect();
+
+  // Returns the metrics of the live threads since the previous call to
+  // CollectDeltas(), or since they started for the threads which weren't live
+  // then. `last_cpu` is the current value rather than a delta.
+  std::vector<ThreadMetrics> CollectDeltas();
+
+  // Emits `metrics` as counters on the tracks of their threads, in the
+  // disabled-by-default "system_stats" category.
+  static void EmitTraceCounters(span<const ThreadMetrics> metrics);
+
+  // Records one sample per thread in "<histogram_prefix>.CpuTime",
+  // "<histogram_prefix>.VoluntaryContextSwitches" and
+  // "<histogram_prefix>.InvoluntaryContextSwitches", so that the histograms
+  // show how the load is spread across threads. Typically called with the
+  // result of CollectDeltas().
+  static void RecordHistograms(std::string_view histogram_prefix,
+                               span<const ThreadMetrics> metrics);
+
+ private:
+  struct ThreadState {
+    ThreadState();
+    ThreadState(ThreadState&&);
+    ThreadState& operator=(ThreadState&&);
+    ~ThreadState();
+
+    ScopedFD stat_fd;
+    ScopedFD status_fd;
+
+    // The metrics returned by the previous call to CollectDeltas().
+    ThreadMetrics previous;
+
+    // The value of `generation_` when the thread was last seen live.
+    uint64_t generation = 0;
+  };
+
+  // Reads the metrics of thread `tid` with the files of `state`, which are
+  // opened if needed.
+  static std::optional<ThreadMetrics> ReadThreadMetrics(PlatformThreadId tid,
+                                                        ThreadState& state);
+
+  std::map<PlatformThreadId, ThreadState> threads_;
+
+  // Incremented by each call to Collect(), to find the threads which exited.
+  uint64_t generation_ = 0;
+};
+
+}  // namespace base
+
+#endif  // BASE_PROCESS_THREAD_METRICS_H_
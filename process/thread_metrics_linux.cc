@@ -0,0 +1,236 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/process/thread_metrics.h"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "base/files/dir_reader_posix.h"
+#include "base/files/file_path.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/process/internal_linux.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/threading/thread_id_name_manager.h"
+#include "base/trace_event/base_tracing.h"
+#include "base/tracing_buildflags.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kProcSelfTaskDir[] = "/proc/self/task";
+
+// Returns the VM_PROCESSOR field of `stats_data`, which ParseProcStatsValues()
+// doesn't reach since some of the fields before it don't fit in an int64_t.
+std::optional<int> ParseLastCpu(std::string_view stats_data) {
+  // See internal::ParseProcStats() for the format.
+  size_t pos = stats_data.rfind(") ");
+  if (pos == std::string_view::npos) {
+    return std::nullopt;
+  }
+  pos += 2;
+  for (int field = internal::VM_STATE; field < internal::VM_PROCESSOR;
+       ++field) {
+    pos = stats_data.find(' ', pos);
+    if (pos == std::string_view::npos) {
+      return std::nullopt;
+    }
+    ++pos;
+  }
+  std::string_view value = stats_data.substr(pos);
+  value = value.substr(0, value.find_first_of(" \n"));
+  int cpu;
+  if (!StringToInt(value, &cpu)) {
+    return std::nullopt;
+  }
+  return cpu;
+}
+
+// Returns the value of the "<field>:\t<value>" line of `status_data`, the
+// contents of a /proc/<pid>/status file.
+std::optional<int64_t> ParseStatusField(std::string_view status_data,
+                                        std::string_view field) {
+  for (size_t pos = status_data.find(field); pos != std::string_view::npos;
+       pos = status_data.find(field, pos + 1)) {
+    const size_t end = pos + field.size();
+    if ((pos != 0 && status_data[pos - 1] != '\n') ||
+        end >= status_data.size() || status_data[end] != ':') {
+      continue;
+    }
+    std::string_view value = status_data.substr(end + 1);
+    value = value.substr(0, value.find('\n'));
+    int64_t result;
+    if (!StringToInt64(TrimWhitespaceASCII(value, TRIM_ALL), &result)) {
+      return std::nullopt;
+    }
+    return result;
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+ThreadMetricsCollector::ThreadState::ThreadState() = default;
+ThreadMetricsCollector::ThreadState::ThreadState(ThreadState&&) = default;
+ThreadMetricsCollector::ThreadState&
+ThreadMetricsCollector::ThreadState::operator=(ThreadState&&) = default;
+ThreadMetricsCollector::ThreadState::~ThreadState() = default;
+
+ThreadMetricsCollector::ThreadMetricsCollector() = default;
+
+ThreadMetricsCollector::~ThreadMetricsCollector() = default;
+
+std::vector<ThreadMetrics> ThreadMetricsCollector::Collect() {
+  std::vector<ThreadMetrics> result;
+  DirReaderPosix dir_reader(kProcSelfTaskDir);
+  if (!dir_reader.IsValid()) {
+    return result;
+  }
+
+  ++generation_;
+  while (dir_reader.Next()) {
+    PlatformThreadId tid;
+    // Also skips "." and "..".
+    if (!StringToInt(dir_reader.name(), &tid)) {
+      continue;
+    }
+    ThreadState& state = threads_[tid];
+    std::optional<ThreadMetrics> metrics = ReadThreadMetrics(tid, state);
+    if (!metrics && state.stat_fd.is_valid()) {
+      // The files may belong to a thread which exited and whose tid was
+      // reused. Reopen them, and forget the metrics of the previous thread.
+      state = ThreadState();
+      metrics = ReadThreadMetrics(tid, state);
+    }
+    if (!metrics) {
+      // The thread exited since the directory was read.
+      threads_.erase(tid);
+      continue;
+    }
+    state.generation = generation_;
+    result.push_back(*metrics);
+  }
+
+  // Close the files of the threads which exited.
+  std::erase_if(threads_, [this](const auto& entry) {
+    return entry.second.generation != generation_;
+  });
+  return result;
+}
+
+std::vector<ThreadMetrics> ThreadMetricsCollector::CollectDeltas() {
+  std::vector<ThreadMetrics> result = Collect();
+  for (ThreadMetrics& metrics : result) {
+    ThreadMetrics& previous = threads_.at(metrics.tid).previous;
+    const ThreadMetrics current = metrics;
+    metrics.cpu_time -= previous.cpu_time;
+    metrics.voluntary_context_switches -= previous.voluntary_context_switches;
+    metrics.involuntary_context_switches -=
+        previous.involuntary_context_switches;
+    previous = current;
+  }
+  return result;
+}
+
+// static
+void ThreadMetricsCollector::EmitTraceCounters(
+    span<const ThreadMetrics> metrics) {
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  for (const ThreadMetrics& thread : metrics) {
+    const perfetto::ThreadTrack thread_track =
+        perfetto::ThreadTrack::ForThread(thread.tid);
+    TRACE_COUNTER(TRACE_DISABLED_BY_DEFAULT("system_stats"),
+                  perfetto::CounterTrack("CpuTimeMs", thread_track),
+                  thread.cpu_time.InMillisecondsF());
+    TRACE_COUNTER(
+        TRACE_DISABLED_BY_DEFAULT("system_stats"),
+        perfetto::CounterTrack("VoluntaryContextSwitches", thread_track),
+        thread.voluntary_context_switches);
+    TRACE_COUNTER(
+        TRACE_DISABLED_BY_DEFAULT("system_stats"),
+        perfetto::CounterTrack("InvoluntaryContextSwitches", thread_track),
+        thread.involuntary_context_switches);
+    TRACE_COUNTER(TRACE_DISABLED_BY_DEFAULT("system_stats"),
+                  perfetto::CounterTrack("LastCpu", thread_track),
+                  thread.last_cpu);
+  }
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+}
+
+// static
+void ThreadMetricsCollector::RecordHistograms(
+    std::string_view histogram_prefix,
+    span<const ThreadMetrics> metrics) {
+  const std::string cpu_time_histogram =
+      StrCat({histogram_prefix, ".CpuTime"});
+  const std::string voluntary_histogram =
+      StrCat({histogram_prefix, ".VoluntaryContextSwitches"});
+  const std::string involuntary_histogram =
+      StrCat({histogram_prefix, ".InvoluntaryContextSwitches"});
+  for (const ThreadMetrics& thread : metrics) {
+    UmaHistogramTimes(cpu_time_histogram, thread.cpu_time);
+    UmaHistogramCounts100000(
+        voluntary_histogram,
+        saturated_cast<int>(thread.voluntary_context_switches));
+    UmaHistogramCounts100000(
+        involuntary_histogram,
+        saturated_cast<int>(thread.involuntary_context_switches));
+  }
+}
+
+// static
+std::optional<ThreadMetrics> ThreadMetricsCollector::ReadThreadMetrics(
+    PlatformThreadId tid,
+    ThreadState& state) {
+  // The path is only needed to open the files.
+  FilePath task_dir;
+  if (!state.stat_fd.is_valid() || !state.status_fd.is_valid()) {
+    task_dir = FilePath(kProcSelfTaskDir).Append(NumberToString(tid));
+  }
+
+  std::array<char, 2048> stat_buffer;
+  const std::optional<std::string_view> stats_data =
+      internal::ReadProcFileWithCachedFd(task_dir.Append(internal::kStatFile),
+                                         state.stat_fd, stat_buffer);
+  internal::ProcStatsValues proc_stats;
+  if (!stats_data ||
+      !internal::ParseProcStatsValues(*stats_data, &proc_stats)) {
+    return std::nullopt;
+  }
+  const std::optional<int> last_cpu = ParseLastCpu(*stats_data);
+
+  // /proc/<pid>/status is larger than stat, mostly because of the CPU and
+  // memory node masks.
+  std::array<char, 8192> status_buffer;
+  const std::optional<std::string_view> status_data =
+      internal::ReadProcFileWithCachedFd(task_dir.Append("status"),
+                                         state.status_fd, status_buffer);
+  if (!status_data) {
+    return std::nullopt;
+  }
+  const std::optional<int64_t> voluntary_context_switches =
+      ParseStatusField(*status_data, "voluntary_ctxt_switches");
+  const std::optional<int64_t> involuntary_context_switches =
+      ParseStatusField(*status_data, "nonvoluntary_ctxt_switches");
+
+  ThreadMetrics metrics;
+  metrics.tid = tid;
+  metrics.name = ThreadIdNameManager::GetInstance()->GetName(tid);
+  metrics.cpu_time = internal::ClockTicksToTimeDelta(
+      proc_stats[internal::VM_UTIME] + proc_stats[internal::VM_STIME]);
+  metrics.voluntary_context_switches = voluntary_context_switches.value_or(0);
+  metrics.involuntary_context_switches =
+      involuntary_context_switches.value_or(0);
+  metrics.last_cpu = last_cpu.value_or(-1);
+  return metrics;
+}
+
+}  // namespace base
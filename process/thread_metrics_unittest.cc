@@ -0,0 +1,135 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/process/thread_metrics.h"
+
+#include <string_view>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/ranges/algorithm.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task/single_thread_task_runner.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kThreadName[] = "ThreadMetricsTestThread";
+
+// Longer than a clock tick, the unit of the CPU time in /proc.
+constexpr TimeDelta kBusyWaitDuration = Milliseconds(50);
+
+const ThreadMetrics* FindThread(const std::vector<ThreadMetrics>& metrics,
+                                PlatformThreadId tid) {
+  auto it = ranges::find(metrics, tid, &ThreadMetrics::tid);
+  return it == metrics.end() ? nullptr : &*it;
+}
+
+// Keeps the calling thread on the CPU for `duration`.
+void BusyWait(TimeDelta duration) {
+  const TimeTicks end_time = TimeTicks::Now() + duration;
+  while (TimeTicks::Now() < end_time) {
+  }
+}
+
+void BusyWaitAndSignal(WaitableEvent* done) {
+  BusyWait(kBusyWaitDuration);
+  done->Signal();
+}
+
+}  // namespace
+
+TEST(ThreadMetricsCollectorTest, CollectCurrentThread) {
+  ThreadMetricsCollector collector;
+  BusyWait(kBusyWaitDuration);
+  const std::vector<ThreadMetrics> metrics = collector.Collect();
+
+  const ThreadMetrics* current_thread =
+      FindThread(metrics, PlatformThread::CurrentId());
+  ASSERT_TRUE(current_thread);
+  EXPECT_TRUE(current_thread->cpu_time.is_positive());
+  EXPECT_GE(current_thread->voluntary_context_switches, 0);
+  EXPECT_GE(current_thread->involuntary_context_switches, 0);
+  EXPECT_GE(current_thread->last_cpu, 0);
+}
+
+TEST(ThreadMetricsCollectorTest, ThreadNameAndExit) {
+  ThreadMetricsCollector collector;
+  Thread thread(kThreadName);
+  ASSERT_TRUE(thread.Start());
+  const PlatformThreadId tid = thread.GetThreadId();
+
+  std::vector<ThreadMetrics> metrics = collector.Collect();
+  const ThreadMetrics* thread_metrics = FindThread(metrics, tid);
+  ASSERT_TRUE(thread_metrics);
+  EXPECT_EQ(std::string_view(kThreadName), thread_metrics->name);
+
+  thread.Stop();
+  metrics = collector.Collect();
+  EXPECT_FALSE(FindThread(metrics, tid));
+}
+
+TEST(ThreadMetricsCollectorTest, CollectDeltas) {
+  ThreadMetricsCollector collector;
+  Thread thread(kThreadName);
+  ASSERT_TRUE(thread.Start());
+  const PlatformThreadId tid = thread.GetThreadId();
+
+  // The first deltas are the cumulative values.
+  std::vector<ThreadMetrics> deltas = collector.CollectDeltas();
+  const ThreadMetrics* first_delta = FindThread(deltas, tid);
+  ASSERT_TRUE(first_delta);
+  const TimeDelta first_cpu_time = first_delta->cpu_time;
+
+  WaitableEvent done;
+  thread.task_runner()->PostTask(FROM_HERE,
+                                 BindOnce(&BusyWaitAndSignal, &done));
+  done.Wait();
+
+  deltas = collector.CollectDeltas();
+  const ThreadMetrics* second_delta = FindThread(deltas, tid);
+  ASSERT_TRUE(second_delta);
+  EXPECT_TRUE(second_delta->cpu_time.is_positive());
+  EXPECT_GE(second_delta->voluntary_context_switches, 0);
+  EXPECT_GE(second_delta->involuntary_context_switches, 0);
+
+  const std::vector<ThreadMetrics> cumulative = collector.Collect();
+  const ThreadMetrics* thread_metrics = FindThread(cumulative, tid);
+  ASSERT_TRUE(thread_metrics);
+  EXPECT_GE(thread_metrics->cpu_time, first_cpu_time + second_delta->cpu_time);
+}
+
+TEST(ThreadMetricsCollectorTest, RecordHistograms) {
+  HistogramTester histogram_tester;
+  ThreadMetrics first;
+  first.cpu_time = Milliseconds(10);
+  first.voluntary_context_switches = 3;
+  first.involuntary_context_switches = 1;
+  ThreadMetrics second;
+  second.cpu_time = Milliseconds(30);
+  second.voluntary_context_switches = 5;
+  second.involuntary_context_switches = 1;
+  const ThreadMetrics metrics[] = {first, second};
+
+  ThreadMetricsCollector::RecordHistograms("Test.Threads", metrics);
+
+  histogram_tester.ExpectTotalCount("Test.Threads.CpuTime", 2);
+  histogram_tester.ExpectTimeBucketCount("Test.Threads.CpuTime",
+                                         Milliseconds(30), 1);
+  histogram_tester.ExpectBucketCount("Test.Threads.VoluntaryContextSwitches",
+                                     3, 1);
+  histogram_tester.ExpectBucketCount("Test.Threads.VoluntaryContextSwitches",
+                                     5, 1);
+  histogram_tester.ExpectUniqueSample(
+      "Test.Threads.InvoluntaryContextSwitches", 1, 2);
+}
+
+}  // namespace base
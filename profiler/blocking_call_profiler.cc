@@ -0,0 +1,131 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/blocking_call_profiler.h"
+
+#include <atomic>
+
+#include "base/check.h"
+#include "base/debug/stack_trace.h"
+#include "base/no_destructor.h"
+#include "base/threading/scoped_blocking_call.h"
+
+namespace base {
+
+namespace {
+
+constexpr size_t kMaxStackFrames = 64;
+
+// Whether a profiler is started, checked without locking.
+std::atomic_bool g_is_running{false};
+
+// Guards the started profiler against its destruction while calls are
+// recorded.
+Lock& GetInstanceLock() {
+  static NoDestructor<Lock> lock;
+  return *lock;
+}
+
+BlockingCallProfiler* g_instance GUARDED_BY(GetInstanceLock()) = nullptr;
+
+}  // namespace
+
+BlockingCallProfiler::Entry::Entry() = default;
+BlockingCallProfiler::Entry::Entry(const Entry&) = default;
+BlockingCallProfiler::Entry::Entry(Entry&&) = default;
+BlockingCallProfiler::Entry& BlockingCallProfiler::Entry::operator=(
+    const Entry&) = default;
+BlockingCallProfiler::Entry& BlockingCallProfiler::Entry::operator=(Entry&&) =
+    default;
+BlockingCallProfiler::Entry::~Entry() = default;
+
+BlockingCallProfiler::BlockingCallProfiler(const Params& params)
+    : params_(params) {}
+
+BlockingCallProfiler::~BlockingCallProfiler() {
+  Stop();
+}
+
+void BlockingCallProfiler::Start() {
+  AutoLock lock(GetInstanceLock());
+  if (g_instance == this) {
+    return;
+  }
+  CHECK(!g_instance);
+  g_instance = this;
+  g_is_running.store(true, std::memory_order_relaxed);
+}
+
+void BlockingCallProfiler::Stop() {
+  AutoLock lock(GetInstanceLock());
+  if (g_instance != this) {
+    return;
+  }
+  g_instance = nullptr;
+  g_is_running.store(false, std::memory_order_relaxed);
+}
+
+std::vector<BlockingCallProfiler::Entry> BlockingCallProfiler::TakeProfile() {
+  std::map<Key, Stats> entries;
+  {
+    AutoLock lock(lock_);
+    std::swap(entries, entries_);
+    num_dropped_calls_ = 0;
+  }
+  std::vector<Entry> profile;
+  profile.reserve(entries.size());
+  for (auto& [key, stats] : entries) {
+    Entry& entry = profile.emplace_back();
+    entry.blocking_type = key.first;
+    entry.stack = std::move(key.second);
+    entry.blocked_time = stats.blocked_time;
+    entry.count = stats.count;
+  }
+  return profile;
+}
+
+size_t BlockingCallProfiler::GetNumDroppedCallsForTesting() {
+  AutoLock lock(lock_);
+  return num_dropped_calls_;
+}
+
+// static
+bool BlockingCallProfiler::IsRunning() {
+  return g_is_running.load(std::memory_order_relaxed);
+}
+
+// static
+void BlockingCallProfiler::OnBlockingCallEnded(BlockingType blocking_type,
+                                               TimeTicks start_time) {
+  DCHECK(!start_time.is_null());
+  const TimeDelta blocked_time = TimeTicks::Now() - start_time;
+  AutoLock lock(GetInstanceLock());
+  if (!g_instance || blocked_time < g_instance->params_.threshold) {
+    return;
+  }
+  const void* frames[kMaxStackFrames];
+  const size_t frame_count = debug::CollectStackTrace(frames, kMaxStackFrames);
+  g_instance->RecordBlockingCall(
+      blocking_type, blocked_time,
+      std::vector<const void*>(frames, frames + frame_count));
+}
+
+void BlockingCallProfiler::RecordBlockingCall(BlockingType blocking_type,
+                                              TimeDelta blocked_time,
+                                              std::vector<const void*> stack) {
+  AutoLock lock(lock_);
+  Key key(blocking_type, std::move(stack));
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    if (entries_.size() >= params_.max_entries) {
+      ++num_dropped_calls_;
+      return;
+    }
+    it = entries_.emplace(std::move(key), Stats()).first;
+  }
+  it->second.blocked_time += blocked_time;
+  ++it->second.count;
+}
+
+}  // namespace base
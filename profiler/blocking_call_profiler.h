@@ -0,0 +1,118 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_PROFILER_BLOCKING_CALL_PROFILER_H_
+#define BASE_PROFILER_BLOCKING_CALL_PROFILER_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+
+namespace base {
+
+enum class BlockingType;
+
+// Profiles the time threads spend off-CPU in ScopedBlockingCalls, e.g. to
+// find where workers wait on I/O. When the outermost ScopedBlockingCall of a
+// thread lasts longer than `threshold`, the stack of the thread is captured as
+// the call ends, while still in the blocking scope, and the blocked time is
+// added to the entry of that stack and the BlockingType of the outermost call.
+// Stacks start in the ScopedBlockingCall destructor, and end up where the
+// blocking call was made.
+//
+// Since only the calls exceeding the threshold are unwound, this is cheap
+// enough to be always on: other calls only read the clock twice.
+//
+// Example:
+//
+//   BlockingCallProfiler profiler({.threshold = Milliseconds(5)});
+//   profiler.Start();
+//   ...
+//   for (const auto& entry : profiler.TakeProfile()) {
+//     Report(entry.blocking_type, Symbolize(entry.stack), entry.blocked_time);
+//   }
+//
+// All methods are thread-safe. At most one instance may be started at a time.
+class BASE_EXPORT BlockingCallProfiler {
+ public:
+  struct Params {
+    // The minimal duration of the blocking calls to record.
+    TimeDelta threshold = Milliseconds(10);
+    // The maximal number of entries. The calls which would need more are
+    // dropped.
+    size_t max_entries = 10000;
+  };
+
+  // The blocking calls with the same stack and BlockingType, aggregated.
+  struct BASE_EXPORT Entry {
+    Entry();
+    Entry(const Entry&);
+    Entry(Entry&&);
+    Entry& operator=(const Entry&);
+    Entry& operator=(Entry&&);
+    ~Entry();
+
+    BlockingType blocking_type;
+    // Call stack of PC addresses, from the innermost frame.
+    std::vector<const void*> stack;
+    // Total time spent in the calls, and their number.
+    TimeDelta blocked_time;
+    size_t count = 0;
+  };
+
+  explicit BlockingCallProfiler(const Params& params);
+  BlockingCallProfiler(const BlockingCallProfiler&) = delete;
+  BlockingCallProfiler& operator=(const BlockingCallProfiler&) = delete;
+  // Stops profiling.
+  ~BlockingCallProfiler();
+
+  // Starts and stops recording the blocking calls of all threads. Calls which
+  // are pending when profiling starts aren't recorded.
+  void Start();
+  void Stop();
+
+  // Returns the entries recorded since the previous call, or since Start().
+  std::vector<Entry> TakeProfile();
+
+  // Returns the number of calls dropped because `max_entries` was reached,
+  // since the previous call to TakeProfile().
+  size_t GetNumDroppedCallsForTesting();
+
+  // Whether a profiler is started. Checked by ScopedBlockingCall when it
+  // starts, to only read the clock when needed.
+  static bool IsRunning();
+
+  // Called by the outermost ScopedBlockingCall of a thread where IsRunning()
+  // was true when it started, as it ends.
+  static void OnBlockingCallEnded(BlockingType blocking_type,
+                                  TimeTicks start_time);
+
+ private:
+  struct Stats {
+    TimeDelta blocked_time;
+    size_t count = 0;
+  };
+  using Key = std::pair<BlockingType, std::vector<const void*>>;
+
+  void RecordBlockingCall(BlockingType blocking_type,
+                          TimeDelta blocked_time,
+                          std::vector<const void*> stack);
+
+  const Params params_;
+
+  Lock lock_;
+  std::map<Key, Stats> entries_ GUARDED_BY(lock_);
+  size_t num_dropped_calls_ GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace base
+
+#endif  // BASE_PROFILER_BLOCKING_CALL_PROFILER_H_
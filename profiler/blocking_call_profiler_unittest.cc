@@ -0,0 +1,90 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/blocking_call_profiler.h"
+
+#include <vector>
+
+#include "base/threading/platform_thread.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+constexpr TimeDelta kBlockedTime = Milliseconds(20);
+
+void Block(BlockingType blocking_type, TimeDelta duration) {
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, blocking_type);
+  PlatformThread::Sleep(duration);
+}
+
+}  // namespace
+
+TEST(BlockingCallProfilerTest, AggregatesPerStackAndBlockingType) {
+  BlockingCallProfiler profiler({.threshold = Milliseconds(10)});
+  profiler.Start();
+  EXPECT_TRUE(BlockingCallProfiler::IsRunning());
+  for (int i = 0; i < 2; ++i) {
+    Block(BlockingType::MAY_BLOCK, kBlockedTime);
+  }
+  Block(BlockingType::WILL_BLOCK, kBlockedTime);
+
+  std::vector<BlockingCallProfiler::Entry> profile = profiler.TakeProfile();
+  ASSERT_EQ(2u, profile.size());
+  EXPECT_EQ(BlockingType::MAY_BLOCK, profile[0].blocking_type);
+  EXPECT_EQ(2u, profile[0].count);
+  EXPECT_GE(profile[0].blocked_time, 2 * kBlockedTime);
+  EXPECT_FALSE(profile[0].stack.empty());
+  EXPECT_EQ(BlockingType::WILL_BLOCK, profile[1].blocking_type);
+  EXPECT_EQ(1u, profile[1].count);
+  EXPECT_GE(profile[1].blocked_time, kBlockedTime);
+
+  // The profile was taken.
+  EXPECT_TRUE(profiler.TakeProfile().empty());
+}
+
+TEST(BlockingCallProfilerTest, IgnoresShortCalls) {
+  BlockingCallProfiler profiler({.threshold = Hours(1)});
+  profiler.Start();
+  Block(BlockingType::MAY_BLOCK, Milliseconds(1));
+  EXPECT_TRUE(profiler.TakeProfile().empty());
+}
+
+TEST(BlockingCallProfilerTest, RecordsOutermostCall) {
+  BlockingCallProfiler profiler({.threshold = Milliseconds(10)});
+  profiler.Start();
+  {
+    ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                            BlockingType::MAY_BLOCK);
+    Block(BlockingType::WILL_BLOCK, kBlockedTime);
+  }
+  std::vector<BlockingCallProfiler::Entry> profile = profiler.TakeProfile();
+  ASSERT_EQ(1u, profile.size());
+  EXPECT_EQ(BlockingType::MAY_BLOCK, profile[0].blocking_type);
+  EXPECT_EQ(1u, profile[0].count);
+}
+
+TEST(BlockingCallProfilerTest, DropsCallsPastMaxEntries) {
+  BlockingCallProfiler profiler(
+      {.threshold = Milliseconds(10), .max_entries = 1});
+  profiler.Start();
+  Block(BlockingType::MAY_BLOCK, kBlockedTime);
+  Block(BlockingType::WILL_BLOCK, kBlockedTime);
+  EXPECT_EQ(1u, profiler.GetNumDroppedCallsForTesting());
+  EXPECT_EQ(1u, profiler.TakeProfile().size());
+}
+
+TEST(BlockingCallProfilerTest, Stop) {
+  BlockingCallProfiler profiler({.threshold = Milliseconds(10)});
+  profiler.Start();
+  profiler.Stop();
+  EXPECT_FALSE(BlockingCallProfiler::IsRunning());
+  Block(BlockingType::MAY_BLOCK, kBlockedTime);
+  EXPECT_TRUE(profiler.TakeProfile().empty());
+}
+
+}  // namespace base
@@ -0,0 +1,297 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/call_tree_profile.h"
+
+#include <string_view>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/containers/adapters.h"
+#include "base/hash/hash.h"
+#include "base/numerics/safe_conversions.h"
+
+namespace base {
+
+namespace {
+
+// Field numbers of the messages of profile.proto.
+enum ProfileField {
+  kProfileSampleType = 1,
+  kProfileSample = 2,
+  kProfileMapping = 3,
+  kProfileLocation = 4,
+  kProfileStringTable = 6,
+  kProfilePeriodType = 11,
+  kProfilePeriod = 12,
+};
+enum ValueTypeField {
+  kValueTypeType = 1,
+  kValueTypeUnit = 2,
+};
+enum SampleField {
+  kSampleLocationId = 1,
+  kSampleValue = 2,
+  kSampleLabel = 3,
+};
+enum LabelField {
+  kLabelKey = 1,
+  kLabelNum = 3,
+};
+enum MappingField {
+  kMappingId = 1,
+  kMappingMemoryStart = 2,
+  kMappingMemoryLimit = 3,
+  kMappingFilename = 5,
+  kMappingBuildId = 6,
+};
+enum LocationField {
+  kLocationId = 1,
+  kLocationMappingId = 2,
+  kLocationAddress = 3,
+};
+
+// Writes messages in the protocol buffer wire format. Fields with the default
+// value are omitted, as in proto3.
+class ProtoWriter {
+ public:
+  void WriteVarint(int field, uint64_t value) {
+    if (value == 0) {
+      return;
+    }
+    WriteTag(field, kWireTypeVarint);
+    AppendVarint(value);
+  }
+
+  void WriteInt64(int field, int64_t value) {
+    WriteVarint(field, static_cast<uint64_t>(value));
+  }
+
+  void WriteBytes(int field, std::string_view bytes) {
+    WriteTag(field, kWireTypeLengthDelimited);
+    AppendVarint(bytes.size());
+    output_.append(bytes);
+  }
+
+  void WriteMessage(int field, const ProtoWriter& message) {
+    WriteBytes(field, message.output_);
+  }
+
+  void WritePackedVarints(int field, span<const uint64_t> values) {
+    ProtoWriter packed;
+    for (uint64_t value : values) {
+      packed.AppendVarint(value);
+    }
+    WriteBytes(field, packed.output_);
+  }
+
+  std::string TakeOutput() { return std::move(output_); }
+
+ private:
+  static constexpr int kWireTypeVarint = 0;
+  static constexpr int kWireTypeLengthDelimited = 2;
+
+  void WriteTag(int field, int wire_type) {
+    AppendVarint(static_cast<uint64_t>(field) << 3 | wire_type);
+  }
+
+  void AppendVarint(uint64_t value) {
+    while (value >= 0x80) {
+      output_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    output_.push_back(static_cast<char>(value));
+  }
+
+  std::string output_;
+};
+
+// The string table of a profile, in which strings are referenced by index.
+class StringTable {
+ public:
+  StringTable() { Intern(""); }
+
+  int64_t Intern(const std::string& string) {
+    auto [it, inserted] = indices_.emplace(string, strings_.size());
+    if (inserted) {
+      strings_.push_back(string);
+    }
+    return it->second;
+  }
+
+  void WriteTo(ProtoWriter& profile) const {
+    for (const std::string& string : strings_) {
+      profile.WriteBytes(kProfileStringTable, string);
+    }
+  }
+
+ private:
+  std::vector<std::string> strings_;
+  std::map<std::string, int64_t> indices_;
+};
+
+ProtoWriter MakeValueType(StringTable& strings,
+                          const std::string& type,
+                          const std::string& unit) {
+  ProtoWriter value_type;
+  value_type.WriteInt64(kValueTypeType, strings.Intern(type));
+  value_type.WriteInt64(kValueTypeUnit, strings.Intern(unit));
+  return value_type;
+}
+
+}  // namespace
+
+size_t CallTreeProfile::ChildKeyHash::operator()(const ChildKey& key) const {
+  return HashInts(key.parent, key.instruction_pointer);
+}
+
+CallTreeProfile::CallTreeProfile(size_t max_nodes) : max_nodes_(max_nodes) {}
+
+CallTreeProfile::CallTreeProfile(CallTreeProfile&&) = default;
+
+CallTreeProfile& CallTreeProfile::operator=(CallTreeProfile&&) = default;
+
+CallTreeProfile::~CallTreeProfile() = default;
+
+void CallTreeProfile::AddSample(PlatformThreadId thread_id,
+                                span<const Frame> frames) {
+  // Samples without frames, e.g. whose stack couldn't be copied, aren't
+  // useful.
+  if (frames.empty()) {
+    return;
+  }
+
+  auto root = thread_roots_.find(thread_id);
+  if (root == thread_roots_.end()) {
+    if (nodes_.size() >= max_nodes_) {
+      ++num_truncated_samples_;
+      return;
+    }
+    const uint32_t index = checked_cast<uint32_t>(nodes_.size());
+    nodes_.push_back({.parent = index, .mapping = kNoMapping,
+                      .instruction_pointer = 0});
+    root = thread_roots_.emplace(thread_id, index).first;
+  }
+
+  // Insert the frames from the outermost.
+  uint32_t node = root->second;
+  for (const Frame& frame : base::Reversed(frames)) {
+    const uint32_t child = GetChild(node, frame);
+    if (child == node) {
+      ++num_truncated_samples_;
+      break;
+    }
+    node = child;
+  }
+  ++nodes_[node].self_count;
+  ++num_samples_;
+}
+
+std::string CallTreeProfile::ExportPprof(TimeDelta sampling_period) const {
+  ProtoWriter profile;
+  StringTable strings;
+
+  profile.WriteMessage(kProfileSampleType,
+                       MakeValueType(strings, "samples", "count"));
+  profile.WriteMessage(kProfileSampleType,
+                       MakeValueType(strings, "wall", "nanoseconds"));
+  profile.WriteMessage(kProfilePeriodType,
+                       MakeValueType(strings, "wall", "nanoseconds"));
+  profile.WriteInt64(kProfilePeriod, sampling_period.InNanoseconds());
+
+  // Mapping ids are the indices in `mappings_` plus 1, since 0 means none.
+  for (size_t i = 0; i < mappings_.size(); ++i) {
+    const Mapping& mapping = mappings_[i];
+    ProtoWriter message;
+    message.WriteVarint(kMappingId, i + 1);
+    message.WriteVarint(kMappingMemoryStart, mapping.base_address);
+    message.WriteVarint(kMappingMemoryLimit,
+                        mapping.base_address + mapping.size);
+    message.WriteInt64(kMappingFilename,
+                       strings.Intern(mapping.debug_basename.AsUTF8Unsafe()));
+    message.WriteInt64(kMappingBuildId, strings.Intern(mapping.id));
+    profile.WriteMessage(kProfileMapping, message);
+  }
+
+  // Location ids are the indices of the nodes plus 1. Nodes with the same
+  // instruction pointer in different stacks get different locations, which is
+  // simpler than deduplicating them and valid in pprof.
+  const int64_t thread_id_key = strings.Intern("thread_id");
+  std::vector<uint64_t> location_ids;
+  for (size_t index = 0; index < nodes_.size(); ++index) {
+    const Node& node = nodes_[index];
+    if (node.parent == index) {
+      continue;
+    }
+    ProtoWriter location;
+    location.WriteVarint(kLocationId, index + 1);
+    if (node.mapping != kNoMapping) {
+      location.WriteVarint(kLocationMappingId, node.mapping + 1);
+    }
+    location.WriteVarint(kLocationAddress, node.instruction_pointer);
+    profile.WriteMessage(kProfileLocation, location);
+
+    if (node.self_count == 0) {
+      continue;
+    }
+    location_ids.clear();
+    size_t ancestor = index;
+    while (nodes_[ancestor].parent != ancestor) {
+      location_ids.push_back(ancestor + 1);
+      ancestor = nodes_[ancestor].parent;
+    }
+    ProtoWriter sample;
+    sample.WritePackedVarints(kSampleLocationId, location_ids);
+    const uint64_t values[] = {
+        node.self_count,
+        static_cast<uint64_t>(sampling_period.InNanoseconds()) *
+            node.self_count};
+    sample.WritePackedVarints(kSampleValue, values);
+    for (const auto& [thread_id, root] : thread_roots_) {
+      if (root == ancestor) {
+        ProtoWriter label;
+        label.WriteInt64(kLabelKey, thread_id_key);
+        label.WriteInt64(kLabelNum, static_cast<int64_t>(thread_id));
+        sample.WriteMessage(kSampleLabel, label);
+        break;
+      }
+    }
+    profile.WriteMessage(kProfileSample, sample);
+  }
+
+  strings.WriteTo(profile);
+  return profile.TakeOutput();
+}
+
+uint32_t CallTreeProfile::GetChild(uint32_t parent, const Frame& frame) {
+  const ChildKey key = {parent, frame.instruction_pointer};
+  auto it = children_.find(key);
+  if (it != children_.end()) {
+    return it->second;
+  }
+  if (nodes_.size() >= max_nodes_) {
+    return parent;
+  }
+
+  uint32_t mapping = kNoMapping;
+  if (frame.module) {
+    auto [mapping_it, inserted] = mapping_indices_.emplace(
+        frame.module, checked_cast<uint32_t>(mappings_.size()));
+    if (inserted) {
+      mappings_.push_back({frame.module->GetBaseAddress(),
+                           frame.module->GetSize(), frame.module->GetId(),
+                           frame.module->GetDebugBasename()});
+    }
+    mapping = mapping_it->second;
+  }
+
+  const uint32_t index = checked_cast<uint32_t>(nodes_.size());
+  nodes_.push_back({.parent = parent,
+                    .mapping = mapping,
+                    .instruction_pointer = frame.instruction_pointer});
+  children_.emplace(key, index);
+  return index;
+}
+
+}  // namespace base
@@ -0,0 +1,108 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_PROFILER_CALL_TREE_PROFILE_H_
+#define BASE_PROFILER_CALL_TREE_PROFILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/files/file_path.h"
+#include "base/profiler/frame.h"
+#include "base/profiler/module_cache.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+
+namespace base {
+
+// Aggregates stack samples into a call tree per thread, in which a stack
+// sampled many times only takes memory once, and exports it in the pprof
+// format (https://github.com/google/pprof/blob/main/proto/profile.proto).
+// The number of nodes of the tree is bounded: once it is reached, the frames
+// of new stacks which would need new nodes are dropped, and the sample is
+// attributed to the deepest existing node instead.
+//
+// The information needed from modules is copied when a frame is added, so
+// that the tree doesn't reference the ModuleCache.
+class BASE_EXPORT CallTreeProfile {
+ public:
+  static constexpr size_t kDefaultMaxNodes = 32 * 1024;
+
+  explicit CallTreeProfile(size_t max_nodes = kDefaultMaxNodes);
+  CallTreeProfile(CallTreeProfile&&);
+  CallTreeProfile& operator=(CallTreeProfile&&);
+  ~CallTreeProfile();
+
+  // Adds a sample of the stack of `thread_id`. `frames` are ordered from the
+  // innermost to the outermost, as recorded by StackSampler.
+  void AddSample(PlatformThreadId thread_id, span<const Frame> frames);
+
+  // Returns the tree as a serialized pprof Profile message, with one sample
+  // per distinct stack, labeled with its "thread_id". Each sample counts as
+  // `sampling_period` of wall time.
+  std::string ExportPprof(TimeDelta sampling_period) const;
+
+  size_t num_nodes() const { return nodes_.size(); }
+  size_t num_samples() const { return num_samples_; }
+  // Returns the number of samples from which frames were dropped because the
+  // tree was full.
+  size_t num_truncated_samples() const { return num_truncated_samples_; }
+
+ private:
+  static constexpr uint32_t kNoMapping = UINT32_MAX;
+
+  struct Node {
+    // The index of the parent node in `nodes_`, or of the node itself for the
+    // root node of a thread.
+    uint32_t parent;
+    // The index in `mappings_` of the module of `instruction_pointer`, or
+    // kNoMapping.
+    uint32_t mapping;
+    uintptr_t instruction_pointer;
+    // The number of samples in which this node was the innermost frame.
+    uint64_t self_count = 0;
+  };
+
+  struct Mapping {
+    uintptr_t base_address;
+    size_t size;
+    std::string id;
+    FilePath debug_basename;
+  };
+
+  // The child of a node with a given instruction pointer.
+  struct ChildKey {
+    bool operator==(const ChildKey& other) const = default;
+
+    uint32_t parent;
+    uintptr_t instruction_pointer;
+  };
+  struct ChildKeyHash {
+    size_t operator()(const ChildKey& key) const;
+  };
+
+  // Returns the index of the child of `parent` for `frame`, adding it if
+  // needed, or `parent` if the tree is full.
+  uint32_t GetChild(uint32_t parent, const Frame& frame);
+
+  size_t max_nodes_;
+  std::vector<Node> nodes_;
+  std::unordered_map<ChildKey, uint32_t, ChildKeyHash> children_;
+  std::map<PlatformThreadId, uint32_t> thread_roots_;
+  std::vector<Mapping> mappings_;
+  std::map<const ModuleCache::Module*, uint32_t> mapping_indices_;
+  size_t num_samples_ = 0;
+  size_t num_truncated_samples_ = 0;
+};
+
+}  // namespace base
+
+#endif  // BASE_PROFILER_CALL_TREE_PROFILE_H_
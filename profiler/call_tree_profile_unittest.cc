@@ -0,0 +1,92 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/call_tree_profile.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/profiler/frame.h"
+#include "base/profiler/stack_sampling_profiler_test_util.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(CallTreeProfileTest, DeduplicatesStacks) {
+  CallTreeProfile profile;
+  TestModule module(0x1000, 0x100);
+  const std::vector<Frame> stack = {Frame(0x1010, &module),
+                                    Frame(0x1020, &module)};
+  const std::vector<Frame> other_stack = {Frame(0x1030, &module),
+                                          Frame(0x1020, &module)};
+
+  profile.AddSample(1, stack);
+  // The thread root and a node per frame.
+  EXPECT_EQ(3u, profile.num_nodes());
+
+  profile.AddSample(1, stack);
+  EXPECT_EQ(3u, profile.num_nodes());
+
+  // Only the innermost frame differs.
+  profile.AddSample(1, other_stack);
+  EXPECT_EQ(4u, profile.num_nodes());
+
+  // Another thread gets its own tree.
+  profile.AddSample(2, stack);
+  EXPECT_EQ(7u, profile.num_nodes());
+
+  // Empty stacks are ignored.
+  profile.AddSample(1, {});
+  EXPECT_EQ(4u, profile.num_samples());
+  EXPECT_EQ(0u, profile.num_truncated_samples());
+}
+
+TEST(CallTreeProfileTest, BoundsNodes) {
+  CallTreeProfile profile(/*max_nodes=*/4);
+  const std::vector<Frame> stack = {Frame(0x10, nullptr), Frame(0x20, nullptr),
+                                    Frame(0x30, nullptr)};
+  profile.AddSample(1, stack);
+  EXPECT_EQ(4u, profile.num_nodes());
+  EXPECT_EQ(0u, profile.num_truncated_samples());
+
+  // The frames below the existing nodes are dropped.
+  const std::vector<Frame> deeper_stack = {
+      Frame(0x05, nullptr), Frame(0x10, nullptr), Frame(0x20, nullptr),
+      Frame(0x30, nullptr)};
+  profile.AddSample(1, deeper_stack);
+  EXPECT_EQ(4u, profile.num_nodes());
+  EXPECT_EQ(1u, profile.num_truncated_samples());
+
+  // New threads are dropped.
+  profile.AddSample(2, stack);
+  EXPECT_EQ(4u, profile.num_nodes());
+  EXPECT_EQ(2u, profile.num_truncated_samples());
+  EXPECT_EQ(2u, profile.num_samples());
+}
+
+TEST(CallTreeProfileTest, ExportPprof) {
+  CallTreeProfile profile;
+  TestModule module(0x1000, 0x100);
+  module.set_id("ABCDEF");
+  module.set_debug_basename(FilePath(FILE_PATH_LITERAL("libfoo.so")));
+  const std::vector<Frame> stack = {Frame(0x1010, &module)};
+  profile.AddSample(1, stack);
+
+  const std::string pprof = profile.ExportPprof(Milliseconds(10));
+  EXPECT_NE(std::string::npos, pprof.find("samples"));
+  EXPECT_NE(std::string::npos, pprof.find("nanoseconds"));
+  EXPECT_NE(std::string::npos, pprof.find("thread_id"));
+  EXPECT_NE(std::string::npos, pprof.find("ABCDEF"));
+  EXPECT_NE(std::string::npos, pprof.find("libfoo.so"));
+
+  // An empty profile still has its sample types.
+  const std::string empty_pprof =
+      CallTreeProfile().ExportPprof(Milliseconds(10));
+  EXPECT_NE(std::string::npos, empty_pprof.find("samples"));
+  EXPECT_LT(empty_pprof.size(), pprof.size());
+}
+
+}  // namespace base
@@ -0,0 +1,179 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/continuous_stack_sampling_profiler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/location.h"
+#include "base/memory/raw_ptr.h"
+#include "base/profiler/frame.h"
+#include "base/profiler/profile_builder.h"
+#include "base/profiler/stack_buffer.h"
+#include "base/profiler/stack_sampler.h"
+#include "base/profiler/stack_sampling_profiler.h"
+#include "base/profiler/unwinder.h"
+#include "base/ranges/algorithm.h"
+#include "base/task/single_thread_task_runner.h"
+
+namespace base {
+
+struct ContinuousStackSamplingProfiler::SampledThread {
+  int id;
+  PlatformThreadId thread_id;
+  std::unique_ptr<StackSampler> sampler;
+  // Whether `sampler` was initialized on the sampling thread.
+  bool initialized = false;
+};
+
+// Adds the samples of a thread to the call tree.
+class ContinuousStackSamplingProfiler::ProfileBuilderImpl
+    : public ProfileBuilder {
+ public:
+  ProfileBuilderImpl(ModuleCache* module_cache,
+                     CallTreeProfile* call_tree,
+                     PlatformThreadId thread_id)
+      : module_cache_(module_cache),
+        call_tree_(call_tree),
+        thread_id_(thread_id) {}
+
+  // ProfileBuilder:
+  ModuleCache* GetModuleCache() override { return module_cache_; }
+
+  void OnSampleCompleted(std::vector<Frame> frames,
+                         TimeTicks sample_timestamp) override {
+    call_tree_->AddSample(thread_id_, frames);
+  }
+
+  void OnProfileCompleted(TimeDelta profile_duration,
+                          TimeDelta sampling_period) override {}
+
+ private:
+  const raw_ptr<ModuleCache> module_cache_;
+  const raw_ptr<CallTreeProfile> call_tree_;
+  const PlatformThreadId thread_id_;
+};
+
+ContinuousStackSamplingProfiler::ContinuousStackSamplingProfiler(
+    const Params& params)
+    : params_(params),
+      call_tree_(params.max_nodes),
+      sampling_thread_("ContinuousStackSamplingProfiler") {
+  DCHECK(params_.sampling_interval.is_positive());
+}
+
+ContinuousStackSamplingProfiler::~ContinuousStackSamplingProfiler() {
+  Stop();
+}
+
+void ContinuousStackSamplingProfiler::Start() {
+  {
+    AutoLock lock(lock_);
+    if (!stack_buffer_) {
+      stack_buffer_ = StackSampler::CreateStackBuffer();
+    }
+  }
+  if (sampling_thread_.IsRunning()) {
+    return;
+  }
+  CHECK(sampling_thread_.Start());
+  sampling_thread_.task_runner()->PostDelayedTask(
+      FROM_HERE,
+      BindOnce(&ContinuousStackSamplingProfiler::SampleNextThread,
+               Unretained(this)),
+      params_.sampling_interval);
+}
+
+void ContinuousStackSamplingProfiler::Stop() {
+  // Pending samples are dropped.
+  sampling_thread_.Stop();
+}
+
+int ContinuousStackSamplingProfiler::RegisterThread(
+    SamplingProfilerThreadToken thread_token,
+    UnwindersFactory core_unwinders_factory) {
+  AutoLock lock(lock_);
+  const int id = next_thread_id_++;
+  if (!StackSamplingProfiler::IsSupportedForCurrentPlatform()) {
+    return id;
+  }
+  std::unique_ptr<StackSampler> sampler = StackSampler::Create(
+      thread_token, &module_cache_, std::move(core_unwinders_factory),
+      RepeatingClosure(), /*test_delegate=*/nullptr);
+  if (sampler) {
+    threads_.push_back(std::make_unique<SampledThread>(
+        SampledThread{.id = id,
+                      .thread_id = thread_token.id,
+                      .sampler = std::move(sampler)}));
+  }
+  return id;
+}
+
+void ContinuousStackSamplingProfiler::UnregisterThread(int id) {
+  // Since the thread is sampled with `lock_` held, it isn't sampled anymore
+  // once this returns.
+  AutoLock lock(lock_);
+  const auto it = ranges::find(threads_, id, &SampledThread::id);
+  if (it == threads_.end()) {
+    return;
+  }
+  const size_t index = static_cast<size_t>(it - threads_.begin());
+  threads_.erase(it);
+  // Keep the turn of the next thread.
+  if (next_thread_ > index) {
+    --next_thread_;
+  }
+}
+
+std::string ContinuousStackSamplingProfiler::TakePprofProfile() {
+  CallTreeProfile call_tree(params_.max_nodes);
+  {
+    AutoLock lock(lock_);
+    std::swap(call_tree, call_tree_);
+  }
+  return call_tree.ExportPprof(params_.sampling_interval);
+}
+
+size_t ContinuousStackSamplingProfiler::GetNumSamplesForTesting() {
+  AutoLock lock(lock_);
+  return call_tree_.num_samples();
+}
+
+void ContinuousStackSamplingProfiler::SampleNextThread() {
+  const TimeTicks start_time = TimeTicks::Now();
+  {
+    AutoLock lock(lock_);
+    if (!threads_.empty() && stack_buffer_) {
+      if (next_thread_ >= threads_.size()) {
+        next_thread_ = 0;
+      }
+      SampledThread& thread = *threads_[next_thread_++];
+      if (!thread.initialized) {
+        thread.sampler->Initialize();
+        thread.initialized = true;
+      }
+      ProfileBuilderImpl profile_builder(&module_cache_, &call_tree_,
+                                         thread.thread_id);
+      thread.sampler->RecordStackFrames(stack_buffer_.get(), &profile_builder,
+                                        thread.thread_id);
+    }
+  }
+
+  // Keep the rate of samples approximately constant, however long sampling
+  // takes.
+  const TimeDelta delay =
+      std::max(params_.sampling_interval - (TimeTicks::Now() - start_time),
+               TimeDelta());
+  SingleThreadTaskRunner::GetCurrentDefault()->PostDelayedTask(
+      FROM_HERE,
+      BindOnce(&ContinuousStackSamplingProfiler::SampleNextThread,
+               Unretained(this)),
+      delay);
+}
+
+}  // namespace base
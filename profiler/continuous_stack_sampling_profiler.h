@@ -0,0 +1,120 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_PROFILER_CONTINUOUS_STACK_SAMPLING_PROFILER_H_
+#define BASE_PROFILER_CONTINUOUS_STACK_SAMPLING_PROFILER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/functional/callback.h"
+#include "base/profiler/call_tree_profile.h"
+#include "base/profiler/module_cache.h"
+#include "base/profiler/sampling_profiler_thread_token.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+
+namespace base {
+
+class StackBuffer;
+class Unwinder;
+
+// Samples the stacks of many threads continuously at a low rate, e.g. for
+// always-on profiling of a fleet, aggregating them into a CallTreeProfile
+// which is periodically exported in the pprof format.
+//
+// Unlike StackSamplingProfiler, which samples a single thread for a bounded
+// number of samples, this uses a single sampling thread which samples one of
+// the registered threads every `sampling_interval`, in turn. Each thread is
+// therefore sampled every `sampling_interval` times the number of threads.
+// The memory used is bounded by `max_nodes` and doesn't grow with time.
+//
+// Example:
+//
+//   ContinuousStackSamplingProfiler profiler({});
+//   profiler.Start();
+//   // On each thread to profile:
+//   int id = profiler.RegisterThread(GetSamplingProfilerCurrentThreadToken());
+//   ...
+//   profiler.UnregisterThread(id);  // Before the thread exits.
+//
+//   // Periodically:
+//   Upload(profiler.TakePprofProfile());
+//
+// All methods are thread-safe.
+class BASE_EXPORT ContinuousStackSamplingProfiler {
+ public:
+  using UnwindersFactory =
+      OnceCallback<std::vector<std::unique_ptr<Unwinder>>()>;
+
+  struct Params {
+    // The interval between two samples of any registered thread.
+    TimeDelta sampling_interval = Milliseconds(100);
+    // The maximum number of nodes of the call tree.
+    size_t max_nodes = CallTreeProfile::kDefaultMaxNodes;
+  };
+
+  explicit ContinuousStackSamplingProfiler(const Params& params);
+  ContinuousStackSamplingProfiler(const ContinuousStackSamplingProfiler&) =
+      delete;
+  ContinuousStackSamplingProfiler& operator=(
+      const ContinuousStackSamplingProfiler&) = delete;
+  // Stops sampling.
+  ~ContinuousStackSamplingProfiler();
+
+  // Starts and stops sampling the registered threads. Stop() joins the
+  // sampling thread.
+  void Start();
+  void Stop();
+
+  // Starts sampling the thread of `thread_token`, and returns an id to
+  // unregister it. The thread must be unregistered before it exits; once
+  // UnregisterThread() returns, it isn't sampled anymore. As for
+  // StackSamplingProfiler, `core_unwinders_factory` is required on Android and
+  // must be null on other platforms. Threads are ignored if stack sampling
+  // isn't supported on the platform.
+  int RegisterThread(SamplingProfilerThreadToken thread_token,
+                     UnwindersFactory core_unwinders_factory = {});
+  void UnregisterThread(int id);
+
+  // Returns the samples recorded since the previous call, or since Start(),
+  // as a serialized pprof Profile message.
+  std::string TakePprofProfile();
+
+  // Returns the number of samples recorded since the previous call to
+  // TakePprofProfile().
+  size_t GetNumSamplesForTesting();
+
+ private:
+  class ProfileBuilderImpl;
+  struct SampledThread;
+
+  // Samples the next thread in turn. Runs on `sampling_thread_`.
+  void SampleNextThread();
+
+  const Params params_;
+
+  Lock lock_;
+  // The modules of the sampled stacks. Only accessed while sampling.
+  ModuleCache module_cache_ GUARDED_BY(lock_);
+  CallTreeProfile call_tree_ GUARDED_BY(lock_);
+  std::vector<std::unique_ptr<SampledThread>> threads_ GUARDED_BY(lock_);
+  // The index in `threads_` of the next thread to sample.
+  size_t next_thread_ GUARDED_BY(lock_) = 0;
+  int next_thread_id_ GUARDED_BY(lock_) = 0;
+  // Shared by all threads, since only one is sampled at a time.
+  std::unique_ptr<StackBuffer> stack_buffer_ GUARDED_BY(lock_);
+
+  Thread sampling_thread_;
+};
+
+}  // namespace base
+
+#endif  // BASE_PROFILER_CONTINUOUS_STACK_SAMPLING_PROFILER_H_
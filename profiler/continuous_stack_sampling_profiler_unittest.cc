@@ -0,0 +1,48 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/continuous_stack_sampling_profiler.h"
+
+#include <string>
+
+#include "base/profiler/sampling_profiler_thread_token.h"
+#include "base/profiler/stack_sampling_profiler.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(ContinuousStackSamplingProfilerTest, SamplesRegisteredThreads) {
+#if BUILDFLAG(IS_ANDROID)
+  // Android requires core unwinders, which aren't provided here.
+  GTEST_SKIP();
+#else
+  if (!StackSamplingProfiler::IsSupportedForCurrentPlatform()) {
+    GTEST_SKIP();
+  }
+
+  ContinuousStackSamplingProfiler profiler(
+      {.sampling_interval = Milliseconds(1)});
+  const int id =
+      profiler.RegisterThread(GetSamplingProfilerCurrentThreadToken());
+  profiler.Start();
+  while (profiler.GetNumSamplesForTesting() < 2) {
+    PlatformThread::Sleep(Milliseconds(1));
+  }
+  profiler.UnregisterThread(id);
+
+  const std::string pprof = profiler.TakePprofProfile();
+  EXPECT_NE(std::string::npos, pprof.find("thread_id"));
+  EXPECT_EQ(0u, profiler.GetNumSamplesForTesting());
+
+  // Unregistered threads aren't sampled anymore.
+  PlatformThread::Sleep(Milliseconds(10));
+  EXPECT_EQ(0u, profiler.GetNumSamplesForTesting());
+  profiler.Stop();
+#endif
+}
+
+}  // namespace base
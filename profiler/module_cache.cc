@@ -77,6 +77,9 @@ const ModuleCache::Module* ModuleCache::GetModuleForAddress(uintptr_t address) {
   const auto result = native_modules_.insert(std::move(new_module));
   // TODO(crbug.com/40150346): Reintroduce DCHECK(result.second) after
   // fixing the issue that is causing it to fail.
+  if (result.second) {
+    UpdateNativeModuleRanges();
+  }
   return result.first->get();
 }
 
@@ -136,6 +139,7 @@ void ModuleCache::UpdateNonNativeModules(
   // difficult-to-track-down crash scenario.
   CHECK_EQ(prior_non_native_modules_size + new_modules.size(),
            non_native_modules_.size());
+  UpdateNonNativeModuleRanges();
 }
 
 void ModuleCache::AddCustomNativeModule(std::unique_ptr<const Module> module) {
@@ -145,19 +149,53 @@ void ModuleCache::AddCustomNativeModule(std::unique_ptr<const Module> module) {
   // be a violation of the API contract, it would present a
   // difficult-to-track-down crash scenario.
   CHECK(was_inserted);
+  UpdateNativeModuleRanges();
 }
 
 const ModuleCache::Module* ModuleCache::GetExistingModuleForAddress(
     uintptr_t address) const {
-  const auto non_native_module_loc = non_native_modules_.find(address);
-  if (non_native_module_loc != non_native_modules_.end())
-    return non_native_module_loc->get();
+  if (const Module* module =
+          FindModuleInRanges(non_native_module_ranges_, address)) {
+    return module;
+  }
+  return FindModuleInRanges(native_module_ranges_, address);
+}
+
+// static
+const ModuleCache::Module* ModuleCache::FindModuleInRanges(
+    const std::vector<ModuleRange>& ranges,
+    uintptr_t address) {
+  // The first range starting after |address|. The previous one is the only
+  // one which may contain it, since the ranges don't overlap.
+  auto it = ranges::upper_bound(ranges, address, {},
+                                &ModuleRange::base_address);
+  if (it == ranges.begin()) {
+    return nullptr;
+  }
+  --it;
+  return address < it->end_address ? it->module : nullptr;
+}
+
+// static
+template <typename Modules>
+std::vector<ModuleCache::ModuleRange> ModuleCache::MakeModuleRanges(
+    const Modules& modules) {
+  std::vector<ModuleRange> ranges;
+  ranges.reserve(modules.size());
+  for (const std::unique_ptr<const Module>& module : modules) {
+    ranges.push_back({module->GetBaseAddress(),
+                      module->GetBaseAddress() + module->GetSize(),
+                      module.get()});
+  }
+  return ranges;
+}
 
-  const auto native_module_loc = native_modules_.find(address);
-  if (native_module_loc != native_modules_.end())
-    return native_module_loc->get();
+void ModuleCache::UpdateNativeModuleRanges() {
+  native_module_ranges_ = MakeModuleRanges(native_modules_);
+}
 
-  return nullptr;
+void ModuleCache::UpdateNonNativeModuleRanges() {
+  non_native_module_ranges_ = MakeModuleRanges(non_native_modules_);
 }
 
 void ModuleCache::RegisterAuxiliaryModuleProvider(
@@ -15,6 +15,7 @@
 #include "base/containers/flat_set.h"
 #include "base/files/file_path.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/raw_ptr_exclusion.h"
 #include "build/build_config.h"
 
 #if BUILDFLAG(IS_WIN)
@@ -162,6 +163,28 @@ class BASE_EXPORT ModuleCache {
                     const std::unique_ptr<const Module>& m2) const;
   };
 
+  // The address range of a module.
+  struct ModuleRange {
+    uintptr_t base_address;
+    uintptr_t end_address;
+    // RAW_PTR_EXCLUSION: Looked up for every frame of every sample, and owned
+    // by the cache which owns the ranges.
+    RAW_PTR_EXCLUSION const Module* module;
+  };
+
+  // Returns the module of |ranges| containing |address|, or nullptr.
+  static const Module* FindModuleInRanges(
+      const std::vector<ModuleRange>& ranges,
+      uintptr_t address);
+
+  // Returns the address ranges of |modules|, sorted by base address.
+  template <typename Modules>
+  static std::vector<ModuleRange> MakeModuleRanges(const Modules& modules);
+
+  // Rebuilds the ranges from the modules, after they changed.
+  void UpdateNativeModuleRanges();
+  void UpdateNonNativeModuleRanges();
+
   // Creates a Module object for the specified memory address. Returns null if
   // the address does not belong to a module.
   static std::unique_ptr<const Module> CreateModuleForAddress(
@@ -184,6 +207,14 @@ class BASE_EXPORT ModuleCache {
   base::flat_set<std::unique_ptr<const Module>, ModuleAndAddressCompare>
       non_native_modules_;
 
+  // Copies of the address ranges of |native_modules_| and
+  // |non_native_modules_|, sorted by base address. Looking up addresses in
+  // these contiguous arrays is much faster than in the sets, which need
+  // virtual calls to the modules at every step. The sets are only used to
+  // maintain the modules, which change rarely once a profile has started.
+  std::vector<ModuleRange> native_module_ranges_;
+  std::vector<ModuleRange> non_native_module_ranges_;
+
   // Unsorted vector of inactive non-native modules. Inactive modules are no
   // longer mapped in the address space and don't participate in address lookup,
   // but are retained by the cache so that existing references to the them
@@ -191,6 +191,32 @@ MAYBE_TEST(ModuleCacheTest, LookupOverlaidNonNativeModule) {
                                       non_native_module->GetSize()));
 }
 
+MAYBE_TEST(ModuleCacheTest, LookupManyModules) {
+  ModuleCache cache;
+  // Adjacent modules, separated by gaps every three modules, added out of
+  // order.
+  std::vector<const ModuleCache::Module*> modules(30);
+  for (size_t i : {1, 0, 2}) {
+    for (size_t j = i; j < modules.size(); j += 3) {
+      auto module = std::make_unique<FakeModule>(0x1000 + 0x100 * (j + j / 3),
+                                                 0x100);
+      modules[j] = module.get();
+      cache.AddCustomNativeModule(std::move(module));
+    }
+  }
+
+  EXPECT_EQ(nullptr, cache.GetExistingModuleForAddress(0xfff));
+  for (const ModuleCache::Module* module : modules) {
+    const uintptr_t base_address = module->GetBaseAddress();
+    EXPECT_EQ(module, cache.GetExistingModuleForAddress(base_address));
+    EXPECT_EQ(module, cache.GetExistingModuleForAddress(base_address + 0xff));
+  }
+  for (size_t j = 2; j < modules.size(); j += 3) {
+    EXPECT_EQ(nullptr, cache.GetExistingModuleForAddress(
+                           modules[j]->GetBaseAddress() + 0x100));
+  }
+}
+
 MAYBE_TEST(ModuleCacheTest, UpdateNonNativeModulesAdd) {
   ModuleCache cache;
   std::vector<std::unique_ptr<const ModuleCache::Module>> modules;
@@ -15,6 +15,7 @@
 #include <cstring>
 #include <optional>
 
+#include "base/bits.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/raw_ptr_exclusion.h"
 #include "base/notreached.h"
@@ -104,9 +105,23 @@ class ScopedEventSignaller {
   RAW_PTR_EXCLUSION AsyncSafeWaitableEvent* event_;
 };
 
+// Returns the top of the range of the stack to copy, from |bottom|. May only
+// call reentrant code.
+uintptr_t GetStackCopyTop(uintptr_t bottom,
+                          uintptr_t stack_base_address,
+                          size_t max_stack_copy_size) {
+  if (max_stack_copy_size == 0 ||
+      stack_base_address - bottom <= max_stack_copy_size) {
+    return stack_base_address;
+  }
+  // The top must be pointer aligned, see CopyStackContentsAndRewritePointers().
+  return bits::AlignDown(bottom + max_stack_copy_size, sizeof(uintptr_t));
+}
+
 // Struct to store the arguments to the signal handler.
 struct HandlerParams {
   uintptr_t stack_base_address;
+  size_t max_stack_copy_size;
 
   // RAW_PTR_EXCLUSION: raw_ptr<> is not safe within a signal handler,
   // as the target thread could be in the middle of an allocation and
@@ -160,7 +175,8 @@ void CopyStackSignalHandler(int n, siginfo_t* siginfo, void* sigcontext) {
   std::memcpy(params->context, &ucontext->uc_mcontext, sizeof(mcontext_t));
 
   const uintptr_t bottom = RegisterContextStackPointer(params->context);
-  const uintptr_t top = params->stack_base_address;
+  const uintptr_t top = GetStackCopyTop(bottom, params->stack_base_address,
+                                        params->max_stack_copy_size);
   if ((top - bottom) > params->stack_buffer->size()) {
     // The stack exceeds the size of the allocated buffer. The buffer is sized
     // such that this shouldn't happen under typical execution so we can safely
@@ -220,8 +236,10 @@ class ScopedSigaction {
 }  // namespace
 
 StackCopierSignal::StackCopierSignal(
-    std::unique_ptr<ThreadDelegate> thread_delegate)
-    : thread_delegate_(std::move(thread_delegate)) {}
+    std::unique_ptr<ThreadDelegate> thread_delegate,
+    size_t max_stack_copy_size)
+    : thread_delegate_(std::move(thread_delegate)),
+      max_stack_copy_size_(max_stack_copy_size) {}
 
 StackCopierSignal::~StackCopierSignal() = default;
 
@@ -235,9 +253,11 @@ bool StackCopierSignal::CopyStack(StackBuffer* stack_buffer,
   const uint8_t* stack_copy_bottom = nullptr;
   const uintptr_t stack_base_address = thread_delegate_->GetStackBaseAddress();
   std::optional<TimeTicks> maybe_timestamp;
-  HandlerParams params = {stack_base_address, &wait_event,  &copied,
-                          thread_context,     stack_buffer, &stack_copy_bottom,
-                          &maybe_timestamp,   delegate};
+  HandlerParams params = {stack_base_address, max_stack_copy_size_,
+                          &wait_event,        &copied,
+                          thread_context,     stack_buffer,
+                          &stack_copy_bottom, &maybe_timestamp,
+                          delegate};
   {
     ScopedSetSignalHandlerParams scoped_handler_params(&params);
 
@@ -281,16 +301,16 @@ bool StackCopierSignal::CopyStack(StackBuffer* stack_buffer,
   }
 
   const uintptr_t bottom = RegisterContextStackPointer(params.context);
+  const uintptr_t top =
+      GetStackCopyTop(bottom, stack_base_address, max_stack_copy_size_);
   for (uintptr_t* reg :
        thread_delegate_->GetRegistersToRewrite(thread_context)) {
     *reg = StackCopierSignal::RewritePointerIfInOriginalStack(
-        reinterpret_cast<uint8_t*>(bottom),
-        reinterpret_cast<uintptr_t*>(stack_base_address), stack_copy_bottom,
-        *reg);
+        reinterpret_cast<uint8_t*>(bottom), reinterpret_cast<uintptr_t*>(top),
+        stack_copy_bottom, *reg);
   }
 
-  *stack_top = reinterpret_cast<uintptr_t>(stack_copy_bottom) +
-               (stack_base_address - bottom);
+  *stack_top = reinterpret_cast<uintptr_t>(stack_copy_bottom) + (top - bottom);
 
   return copied;
 }
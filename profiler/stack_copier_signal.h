@@ -5,6 +5,8 @@
 #ifndef BASE_PROFILER_STACK_COPIER_SIGNAL_H_
 #define BASE_PROFILER_STACK_COPIER_SIGNAL_H_
 
+#include <stddef.h>
+
 #include <memory>
 
 #include "base/base_export.h"
@@ -16,9 +18,15 @@ class ThreadDelegate;
 
 // Supports stack copying on platforms where a signal must be delivered to the
 // profiled thread and the stack is copied from the signal handler.
+//
+// If |max_stack_copy_size| is non-zero, only the innermost
+// |max_stack_copy_size| bytes of the stack are copied, so that the time the
+// thread is stopped doesn't depend on how deep its stack is. The unwinders
+// then stop where the copy ends, and deeper frames are missing from samples.
 class BASE_EXPORT StackCopierSignal : public StackCopier {
  public:
-  StackCopierSignal(std::unique_ptr<ThreadDelegate> thread_delegate);
+  StackCopierSignal(std::unique_ptr<ThreadDelegate> thread_delegate,
+                    size_t max_stack_copy_size = 0);
   ~StackCopierSignal() override;
 
   // StackCopier:
@@ -32,6 +40,7 @@ class BASE_EXPORT StackCopierSignal : public StackCopier {
 
  private:
   std::unique_ptr<ThreadDelegate> thread_delegate_;
+  const size_t max_stack_copy_size_;
 };
 
 }  // namespace base
@@ -127,6 +127,41 @@ TEST(StackCopierSignalTest, MAYBE_CopyStack) {
   EXPECT_NE(end, sentinel_location);
 }
 
+// TSAN hangs on the AsyncSafeWaitableEvent FUTEX_WAIT call.
+#if defined(THREAD_SANITIZER)
+#define MAYBE_CopyTopOfStack DISABLED_CopyTopOfStack
+#elif BUILDFLAG(IS_LINUX)
+// We don't support getting the stack base address on Linux, and thus can't
+// copy the stack. // https://crbug.com/1394278
+#define MAYBE_CopyTopOfStack DISABLED_CopyTopOfStack
+#else
+#define MAYBE_CopyTopOfStack CopyTopOfStack
+#endif
+TEST(StackCopierSignalTest, MAYBE_CopyTopOfStack) {
+  constexpr size_t kMaxStackCopySize = 1024;
+  StackBuffer stack_buffer(/* buffer_size = */ 1 << 20);
+  uintptr_t stack_top = 0;
+  TimeTicks timestamp;
+  RegisterContext context;
+  TestStackCopierDelegate stack_copier_delegate;
+
+  auto thread_delegate =
+      ThreadDelegatePosix::Create(GetSamplingProfilerCurrentThreadToken());
+  ASSERT_TRUE(thread_delegate);
+  StackCopierSignal copier(std::move(thread_delegate), kMaxStackCopySize);
+
+  bool result = copier.CopyStack(&stack_buffer, &stack_top, &timestamp,
+                                 &context, &stack_copier_delegate);
+  ASSERT_TRUE(result);
+
+  // The test's stack is deeper than kMaxStackCopySize, so the copy is
+  // truncated.
+  EXPECT_LE(stack_top - RegisterContextStackPointer(&context),
+            kMaxStackCopySize);
+  EXPECT_GT(stack_top - RegisterContextStackPointer(&context),
+            kMaxStackCopySize - sizeof(uintptr_t));
+}
+
 // TSAN hangs on the AsyncSafeWaitableEvent FUTEX_WAIT call.
 #if defined(THREAD_SANITIZER)
 #define MAYBE_CopyStackTimestamp DISABLED_CopyStackTimestamp
@@ -0,0 +1,85 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/stack_trie_profile_builder.h"
+
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/containers/adapters.h"
+#include "base/hash/hash.h"
+#include "base/numerics/safe_conversions.h"
+
+namespace base {
+
+size_t StackTrieProfileBuilder::ChildKeyHash::operator()(
+    const ChildKey& key) const {
+  return HashInts(
+      HashInts(key.parent, reinterpret_cast<uintptr_t>(key.module.get())),
+      key.offset);
+}
+
+StackTrieProfileBuilder::StackTrieProfileBuilder(
+    ModuleCache* module_cache,
+    CompletedCallback completed_callback)
+    : module_cache_(module_cache),
+      completed_callback_(std::move(completed_callback)) {}
+
+StackTrieProfileBuilder::~StackTrieProfileBuilder() = default;
+
+ModuleCache* StackTrieProfileBuilder::GetModuleCache() {
+  return module_cache_;
+}
+
+void StackTrieProfileBuilder::OnSampleCompleted(std::vector<Frame> frames,
+                                                TimeTicks sample_timestamp) {
+  // Samples without frames, e.g. whose stack couldn't be copied, aren't
+  // useful.
+  if (frames.empty()) {
+    return;
+  }
+
+  uint32_t node = kNoParent;
+  for (const Frame& frame : base::Reversed(frames)) {
+    uintptr_t offset = frame.instruction_pointer;
+    if (frame.module) {
+      offset -= frame.module->GetBaseAddress();
+    }
+    const ChildKey key = {node, frame.module, offset};
+    auto [it, inserted] =
+        children_.emplace(key, checked_cast<uint32_t>(nodes_.size()));
+    if (inserted) {
+      nodes_.push_back(
+          {.parent = node, .module = frame.module, .offset = offset});
+    }
+    node = it->second;
+  }
+  ++nodes_[node].self_count;
+  ++num_samples_;
+}
+
+void StackTrieProfileBuilder::OnProfileCompleted(TimeDelta profile_duration,
+                                                 TimeDelta sampling_period) {
+  profile_duration_ = profile_duration;
+  sampling_period_ = sampling_period;
+  if (completed_callback_) {
+    std::move(completed_callback_).Run(*this);
+  }
+}
+
+std::vector<Frame> StackTrieProfileBuilder::GetStack(uint32_t node) const {
+  std::vector<Frame> frames;
+  while (node != kNoParent) {
+    CHECK_LT(node, nodes_.size());
+    const Node& current = nodes_[node];
+    const uintptr_t instruction_pointer =
+        current.module ? current.module->GetBaseAddress() + current.offset
+                       : current.offset;
+    frames.emplace_back(instruction_pointer, current.module.get());
+    node = current.parent;
+  }
+  return frames;
+}
+
+}  // namespace base
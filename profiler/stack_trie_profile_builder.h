@@ -0,0 +1,101 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_PROFILER_STACK_TRIE_PROFILE_BUILDER_H_
+#define BASE_PROFILER_STACK_TRIE_PROFILE_BUILDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/functional/callback.h"
+#include "base/memory/raw_ptr.h"
+#include "base/profiler/frame.h"
+#include "base/profiler/module_cache.h"
+#include "base/profiler/profile_builder.h"
+#include "base/time/time.h"
+
+namespace base {
+
+// A ProfileBuilder which interns the sampled stacks in a prefix trie keyed by
+// (module, offset in the module), from the outermost frame. A stack sampled
+// many times is stored once, and each sample only costs incrementing the
+// count of its innermost node, instead of storing a vector of frames per
+// sample.
+//
+// Consumers read the profile from the callback run on completion, typically
+// by walking nodes() once: since nodes are appended as they are first seen,
+// the parent of a node always precedes it.
+//
+// As for any ProfileBuilder, all methods but the constructor are called on
+// the sampling thread.
+class BASE_EXPORT StackTrieProfileBuilder : public ProfileBuilder {
+ public:
+  // The parent of the nodes of the outermost frames.
+  static constexpr uint32_t kNoParent = UINT32_MAX;
+
+  struct Node {
+    // The index in nodes() of the caller node, or kNoParent.
+    uint32_t parent;
+    // Null if the instruction pointer isn't in a known module, in which case
+    // `offset` is the instruction pointer.
+    raw_ptr<const ModuleCache::Module> module;
+    uintptr_t offset;
+    // The number of samples whose innermost frame is this node.
+    uint64_t self_count = 0;
+  };
+
+  using CompletedCallback = OnceCallback<void(const StackTrieProfileBuilder&)>;
+
+  // `module_cache` must outlive this, since nodes reference its modules.
+  explicit StackTrieProfileBuilder(
+      ModuleCache* module_cache,
+      CompletedCallback completed_callback = CompletedCallback());
+  ~StackTrieProfileBuilder() override;
+
+  // ProfileBuilder:
+  ModuleCache* GetModuleCache() override;
+  void OnSampleCompleted(std::vector<Frame> frames,
+                         TimeTicks sample_timestamp) override;
+  void OnProfileCompleted(TimeDelta profile_duration,
+                          TimeDelta sampling_period) override;
+
+  const std::vector<Node>& nodes() const { return nodes_; }
+
+  // Returns the stack ending at `node`, from the innermost frame, as recorded
+  // by the profiler.
+  std::vector<Frame> GetStack(uint32_t node) const;
+
+  size_t num_samples() const { return num_samples_; }
+  TimeDelta profile_duration() const { return profile_duration_; }
+  TimeDelta sampling_period() const { return sampling_period_; }
+
+ private:
+  struct ChildKey {
+    bool operator==(const ChildKey& other) const = default;
+
+    uint32_t parent;
+    raw_ptr<const ModuleCache::Module> module;
+    uintptr_t offset;
+  };
+  struct ChildKeyHash {
+    size_t operator()(const ChildKey& key) const;
+  };
+
+  const raw_ptr<ModuleCache> module_cache_;
+  CompletedCallback completed_callback_;
+
+  std::vector<Node> nodes_;
+  std::unordered_map<ChildKey, uint32_t, ChildKeyHash> children_;
+  size_t num_samples_ = 0;
+  TimeDelta profile_duration_;
+  TimeDelta sampling_period_;
+};
+
+}  // namespace base
+
+#endif  // BASE_PROFILER_STACK_TRIE_PROFILE_BUILDER_H_
@@ -0,0 +1,77 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/stack_trie_profile_builder.h"
+
+#include <vector>
+
+#include "base/test/bind.h"
+#include "base/profiler/frame.h"
+#include "base/profiler/module_cache.h"
+#include "base/profiler/stack_sampling_profiler_test_util.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(StackTrieProfileBuilderTest, InternsStacks) {
+  ModuleCache module_cache;
+  StackTrieProfileBuilder builder(&module_cache);
+  TestModule module(0x1000, 0x100);
+  const std::vector<Frame> stack = {Frame(0x1010, &module),
+                                    Frame(0x1020, &module)};
+  const std::vector<Frame> other_stack = {Frame(0x1030, &module),
+                                          Frame(0x1020, &module)};
+
+  builder.OnSampleCompleted(stack, TimeTicks());
+  builder.OnSampleCompleted(stack, TimeTicks());
+  builder.OnSampleCompleted(other_stack, TimeTicks());
+  builder.OnSampleCompleted({Frame(0x42, nullptr)}, TimeTicks());
+  builder.OnSampleCompleted({}, TimeTicks());
+
+  EXPECT_EQ(4u, builder.num_samples());
+  const std::vector<StackTrieProfileBuilder::Node>& nodes = builder.nodes();
+  ASSERT_EQ(4u, nodes.size());
+
+  // The outermost frame first, keyed by its offset.
+  EXPECT_EQ(StackTrieProfileBuilder::kNoParent, nodes[0].parent);
+  EXPECT_EQ(&module, nodes[0].module);
+  EXPECT_EQ(0x20u, nodes[0].offset);
+  EXPECT_EQ(0u, nodes[0].self_count);
+
+  EXPECT_EQ(0u, nodes[1].parent);
+  EXPECT_EQ(0x10u, nodes[1].offset);
+  EXPECT_EQ(2u, nodes[1].self_count);
+
+  EXPECT_EQ(0u, nodes[2].parent);
+  EXPECT_EQ(0x30u, nodes[2].offset);
+  EXPECT_EQ(1u, nodes[2].self_count);
+
+  EXPECT_EQ(StackTrieProfileBuilder::kNoParent, nodes[3].parent);
+  EXPECT_EQ(nullptr, nodes[3].module);
+  EXPECT_EQ(0x42u, nodes[3].offset);
+
+  EXPECT_EQ(stack, builder.GetStack(1));
+  EXPECT_EQ(other_stack, builder.GetStack(2));
+}
+
+TEST(StackTrieProfileBuilderTest, RunsCompletedCallback) {
+  ModuleCache module_cache;
+  size_t num_samples = 0;
+  TimeDelta sampling_period;
+  StackTrieProfileBuilder builder(
+      &module_cache,
+      BindLambdaForTesting([&](const StackTrieProfileBuilder& profile) {
+        num_samples = profile.num_samples();
+        sampling_period = profile.sampling_period();
+      }));
+  EXPECT_EQ(&module_cache, builder.GetModuleCache());
+
+  builder.OnSampleCompleted({Frame(0x42, nullptr)}, TimeTicks());
+  builder.OnProfileCompleted(Seconds(1), Milliseconds(10));
+  EXPECT_EQ(1u, num_samples);
+  EXPECT_EQ(Milliseconds(10), sampling_period);
+}
+
+}  // namespace base
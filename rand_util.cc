@@ -9,11 +9,22 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <limits>
 
 #include "base/check_op.h"
+#include "base/compiler_specific.h"
+#include "base/numerics/byte_conversions.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/time/time.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include <immintrin.h>
+
+#include "base/cpu.h"
+#endif
 
 namespace base {
 
@@ -26,6 +37,75 @@ namespace {
 std::atomic<bool> g_subsampling_always_sample = false;
 std::atomic<bool> g_subsampling_never_sample = false;
 
+// InsecureRandomGenerator::Fill() runs this many streams side by side, which
+// is enough to fill the vector registers of current CPUs.
+constexpr size_t kFillLanes = 8;
+constexpr size_t kFillBlockSize = kFillLanes * sizeof(uint64_t);
+
+using FillLanes = std::array<uint64_t, kFillLanes>;
+
+// The same steps as InsecureRandomGenerator::RandUint64(), on each lane of
+// `a` and `b`, until `output` is full. The inner loop has no dependency
+// between lanes, so compilers turn it into vector instructions.
+ALWAYS_INLINE void FillFromLanes(FillLanes& a,
+                                 FillLanes& b,
+                                 span<uint8_t> output) {
+  FillLanes block;
+  while (!output.empty()) {
+    for (size_t i = 0; i < kFillLanes; ++i) {
+      uint64_t t = a[i];
+      const uint64_t s = b[i];
+      a[i] = s;
+      t ^= t << 23;
+      t ^= t >> 17;
+      t ^= s ^ (s >> 26);
+      b[i] = t;
+      block[i] = t + s;
+    }
+    const size_t n = std::min(output.size(), kFillBlockSize);
+    output.first(n).copy_from(as_byte_span(block).first(n));
+    output = output.subspan(n);
+  }
+}
+
+#if defined(ARCH_CPU_X86_64)
+// FillFromLanes() with AVX2, which compilers don't reliably use on their own
+// here, as the baseline only has SSE2.
+__attribute__((target("avx2"))) void FillFromLanesAvx2(const FillLanes& a,
+                                                       const FillLanes& b,
+                                                       span<uint8_t> output) {
+  static_assert(kFillLanes == 8);
+  const __m256i* const a_lanes = reinterpret_cast<const __m256i*>(a.data());
+  const __m256i* const b_lanes = reinterpret_cast<const __m256i*>(b.data());
+  std::array<__m256i, 2> va = {_mm256_loadu_si256(&a_lanes[0]),
+                               _mm256_loadu_si256(&a_lanes[1])};
+  std::array<__m256i, 2> vb = {_mm256_loadu_si256(&b_lanes[0]),
+                               _mm256_loadu_si256(&b_lanes[1])};
+  FillLanes block;
+  __m256i* const block_lanes = reinterpret_cast<__m256i*>(block.data());
+  while (!output.empty()) {
+    for (size_t i = 0; i < 2; ++i) {
+      __m256i t = va[i];
+      const __m256i s = vb[i];
+      va[i] = s;
+      t = _mm256_xor_si256(t, _mm256_slli_epi64(t, 23));
+      t = _mm256_xor_si256(t, _mm256_srli_epi64(t, 17));
+      t = _mm256_xor_si256(t, _mm256_xor_si256(s, _mm256_srli_epi64(s, 26)));
+      vb[i] = t;
+      _mm256_storeu_si256(&block_lanes[i], _mm256_add_epi64(t, s));
+    }
+    const size_t n = std::min(output.size(), kFillBlockSize);
+    output.first(n).copy_from(as_byte_span(block).first(n));
+    output = output.subspan(n);
+  }
+}
+
+bool HasAvx2() {
+  static const bool has_avx2 = CPU::GetInstanceNoAllocation().has_avx2();
+  return has_avx2;
+}
+#endif
+
 }  // namespace
 
 uint64_t RandUint64() {
@@ -166,6 +246,39 @@ double InsecureRandomGenerator::RandDouble() {
   return (x >> 11) * 0x1.0p-53;
 }
 
+void InsecureRandomGenerator::Fill(span<uint8_t> output) {
+  // Seeding the lanes costs about as much as generating a couple of blocks
+  // one value at a time.
+  if (output.size() < 4 * kFillBlockSize) {
+    while (!output.empty()) {
+      const auto bytes = U64ToNativeEndian(RandUint64());
+      const size_t n = std::min(output.size(), bytes.size());
+      output.first(n).copy_from(span(bytes).first(n));
+      output = output.subspan(n);
+    }
+    return;
+  }
+
+  FillLanes a;
+  FillLanes b;
+  for (size_t i = 0; i < kFillLanes; ++i) {
+    a[i] = RandUint64();
+    b[i] = RandUint64();
+    // The all-zero state is a fixed point of XorShift128+.
+    if ((a[i] | b[i]) == 0) {
+      b[i] = 1;
+    }
+  }
+
+#if defined(ARCH_CPU_X86_64)
+  if (HasAvx2()) {
+    FillFromLanesAvx2(a, b, output);
+    return;
+  }
+#endif
+  FillFromLanes(a, b, output);
+}
+
 MetricsSubSampler::MetricsSubSampler() = default;
 bool MetricsSubSampler::ShouldSample(double probability) {
   if (g_subsampling_always_sample.load(std::memory_order_relaxed)) {
@@ -178,6 +291,24 @@ bool MetricsSubSampler::ShouldSample(double probability) {
   return generator_.RandDouble() < probability;
 }
 
+uint32_t MetricsSubSampler::GetCallsUntilNextSample(double probability) {
+  if (g_subsampling_always_sample.load(std::memory_order_relaxed) ||
+      probability >= 1.0) {
+    return 1;
+  }
+  if (g_subsampling_never_sample.load(std::memory_order_relaxed) ||
+      probability <= 0.0) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+
+  // The number of calls until one succeeds, by inverting the cumulative
+  // distribution function of the geometric distribution. 1 - RandDouble() is
+  // in (0, 1].
+  const double calls =
+      1.0 + floor(log(1.0 - generator_.RandDouble()) / log1p(-probability));
+  return saturated_cast<uint32_t>(calls);
+}
+
 MetricsSubSampler::ScopedAlwaysSampleForTesting::
     ScopedAlwaysSampleForTesting() {
   DCHECK(!g_subsampling_always_sample.load(std::memory_order_relaxed));
@@ -190,6 +190,11 @@ class BASE_EXPORT InsecureRandomGenerator {
   uint64_t RandUint64();
   // In [0, 1).
   double RandDouble();
+  // Fills `output` with random bytes. For more than a few dozen bytes this is
+  // several times faster than calling RandUint64() repeatedly, as it runs
+  // independent XorShift128+ streams, seeded from this generator, in parallel
+  // SIMD lanes. The bytes are not those RandUint64() would have returned.
+  void Fill(span<uint8_t> output);
 
  private:
   InsecureRandomGenerator();
@@ -211,7 +216,9 @@ class BASE_EXPORT InsecureRandomGenerator {
                            InsecureRandomGeneratorProducesBothValuesOfAllBits);
   FRIEND_TEST_ALL_PREFIXES(RandUtilTest, InsecureRandomGeneratorChiSquared);
   FRIEND_TEST_ALL_PREFIXES(RandUtilTest, InsecureRandomGeneratorRandDouble);
+  FRIEND_TEST_ALL_PREFIXES(RandUtilTest, InsecureRandomGeneratorFill);
   FRIEND_TEST_ALL_PREFIXES(RandUtilPerfTest, InsecureRandomRandUint64);
+  FRIEND_TEST_ALL_PREFIXES(RandUtilPerfTest, InsecureRandomFill);
 };
 
 class BASE_EXPORT MetricsSubSampler {
@@ -219,6 +226,12 @@ class BASE_EXPORT MetricsSubSampler {
   MetricsSubSampler();
   bool ShouldSample(double probability);
 
+  // Returns the number of calls to ShouldSample(|probability|) until the next
+  // one which would return true, including it, without making them. This is
+  // at least 1, and geometrically distributed with a mean of 1/|probability|,
+  // so that callers counting down calls sample each one independently.
+  uint32_t GetCallsUntilNextSample(double probability);
+
   // Make any call to ShouldSample for any instance of MetricsSubSampler
   // return true for testing. Cannot be used in conjunction with
   // ScopedNeverSampleForTesting.
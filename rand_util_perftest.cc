@@ -3,6 +3,18 @@
 // found in the LICENSE file.
 
 #include "base/rand_util.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/debug/alias.h"
+#include "base/functional/function_ref.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
@@ -13,6 +25,31 @@ namespace {
 
 constexpr char kMetricPrefix[] = "RandUtil.";
 constexpr char kThroughput[] = "throughput";
+constexpr char kBandwidth[] = "bandwidth";
+
+constexpr size_t kFillSizes[] = {8, 32, 256, 4096, 1 << 20};
+
+// Runs `fill` on a buffer of `size` bytes until it has produced 16 MB, and
+// reports its bandwidth.
+void RunFillTest(const char* story,
+                 size_t size,
+                 FunctionRef<void(span<uint8_t>)> fill) {
+  std::vector<uint8_t> buffer(size);
+  const size_t num_runs = std::max<size_t>(1, (16u << 20) / size);
+
+  const TimeTicks before = TimeTicks::Now();
+  for (size_t i = 0; i < num_runs; ++i) {
+    fill(span(buffer));
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - before;
+  debug::Alias(buffer.data());
+
+  perf_test::PerfResultReporter reporter(
+      kMetricPrefix, std::string(story) + "_" + NumberToString(size));
+  reporter.RegisterImportantMetric(kBandwidth, "MB/s");
+  // Bytes per microsecond are MB/s.
+  reporter.AddResult(kBandwidth, size * num_runs / elapsed.InMicrosecondsF());
+}
 
 }  // namespace
 
@@ -55,4 +92,19 @@ TEST(RandUtilPerfTest, InsecureRandomRandUint64) {
   ASSERT_NE(inclusive_or, static_cast<uint64_t>(0));
 }
 
+TEST(RandUtilPerfTest, RandBytes) {
+  for (size_t size : kFillSizes) {
+    RunFillTest("RandBytes", size,
+                [](span<uint8_t> buffer) { RandBytes(buffer); });
+  }
+}
+
+TEST(RandUtilPerfTest, InsecureRandomFill) {
+  base::InsecureRandomGenerator gen;
+  for (size_t size : kFillSizes) {
+    RunFillTest("InsecureRandomFill", size,
+                [&gen](span<uint8_t> buffer) { gen.Fill(buffer); });
+  }
+}
+
 }  // namespace base
@@ -161,6 +161,10 @@ namespace {
 // rand_util_win.cc.
 std::atomic<bool> g_use_boringssl;
 
+// BoringSSL keeps a per-thread DRBG, seeded from the OS and reseeded
+// periodically and after fork(), so small requests don't need a system call.
+// Since this changes what RandBytes() is backed by, it is rolled out through
+// a field trial; see ConfigureBoringSSLBackedRandBytesFieldTrial().
 BASE_FEATURE(kUseBoringSSLForRandBytes,
              "UseBoringSSLForRandBytes",
              FEATURE_DISABLED_BY_DEFAULT);
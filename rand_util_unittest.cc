@@ -390,6 +390,40 @@ TEST(RandUtilTest, InsecureRandomGeneratorRandDouble) {
   }
 }
 
+TEST(RandUtilTest, InsecureRandomGeneratorFill) {
+  InsecureRandomGenerator gen;
+
+  // Sizes on both sides of the threshold for running several lanes, and ones
+  // which end in a partial block.
+  for (size_t size : {0u, 1u, 7u, 8u, 255u, 256u, 257u, 4099u}) {
+    // Fill a buffer with a known pattern around the span to fill, to check
+    // that it writes exactly `size` bytes.
+    std::vector<uint8_t> buffer(size + 2, 0xAA);
+    gen.Fill(span(buffer).subspan(1, size));
+    EXPECT_EQ(buffer.front(), 0xAA);
+    EXPECT_EQ(buffer.back(), 0xAA);
+
+    // Each bit should take both values.
+    if (size >= 256) {
+      uint8_t found_ones = 0;
+      uint8_t found_zeros = 0xFF;
+      for (size_t i = 1; i <= size; ++i) {
+        found_ones |= buffer[i];
+        found_zeros &= buffer[i];
+      }
+      EXPECT_EQ(found_ones, 0xFF) << size;
+      EXPECT_EQ(found_zeros, 0) << size;
+    }
+  }
+
+  // Two consecutive calls should give different bytes.
+  std::vector<uint8_t> first(1024);
+  std::vector<uint8_t> second(1024);
+  gen.Fill(first);
+  gen.Fill(second);
+  EXPECT_NE(first, second);
+}
+
 TEST(RandUtilTest, MetricsSubSampler) {
   MetricsSubSampler sub_sampler;
   int true_count = 0;
@@ -412,6 +446,24 @@ TEST(RandUtilTest, MetricsSubSampler) {
   EXPECT_GT(false_count, 0);
 }
 
+TEST(RandUtilTest, MetricsSubSamplerGetCallsUntilNextSample) {
+  MetricsSubSampler sub_sampler;
+  EXPECT_EQ(1u, sub_sampler.GetCallsUntilNextSample(1));
+  EXPECT_EQ(std::numeric_limits<uint32_t>::max(),
+            sub_sampler.GetCallsUntilNextSample(0));
+
+  // The mean number of calls is 1/probability. With 10000 draws of a standard
+  // deviation of about 100, the standard deviation of their mean is about 1.
+  constexpr int kNumDraws = 10000;
+  uint64_t total_calls = 0;
+  for (int i = 0; i < kNumDraws; ++i) {
+    const uint32_t calls = sub_sampler.GetCallsUntilNextSample(0.01);
+    EXPECT_GE(calls, 1u);
+    total_calls += calls;
+  }
+  EXPECT_NEAR(100.0, static_cast<double>(total_calls) / kNumDraws, 5.0);
+}
+
 TEST(RandUtilTest, MetricsSubSamplerTestingSupport) {
   MetricsSubSampler sub_sampler;
 
@@ -424,6 +476,7 @@ TEST(RandUtilTest, MetricsSubSamplerTestingSupport) {
       EXPECT_TRUE(sub_sampler.ShouldSample(0.5));
       EXPECT_TRUE(sub_sampler.ShouldSample(1));
     }
+    EXPECT_EQ(1u, sub_sampler.GetCallsUntilNextSample(0.5));
   }
 
   // ScopedNeverSampleForTesting makes ShouldSample() return true with
@@ -435,6 +488,8 @@ TEST(RandUtilTest, MetricsSubSamplerTestingSupport) {
       EXPECT_FALSE(sub_sampler.ShouldSample(0.5));
       EXPECT_FALSE(sub_sampler.ShouldSample(1));
     }
+    EXPECT_EQ(std::numeric_limits<uint32_t>::max(),
+              sub_sampler.GetCallsUntilNextSample(0.5));
   }
 }
 
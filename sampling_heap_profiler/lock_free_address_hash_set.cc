@@ -4,21 +4,23 @@
 
 #include "base/sampling_heap_profiler/lock_free_address_hash_set.h"
 
+#include <algorithm>
 #include <bit>
+#include <cmath>
 #include <limits>
 
 #include "base/containers/contains.h"
 
 namespace base {
 
-LockFreeAddressHashSet::LockFreeAddressHashSet(size_t buckets_count)
-    : buckets_(buckets_count), bucket_mask_(buckets_count - 1) {
+LockFreeAddressHashSet::Table::Table(size_t buckets_count)
+    : buckets(buckets_count), bucket_mask(buckets_count - 1) {
   DCHECK(std::has_single_bit(buckets_count));
-  DCHECK_LE(bucket_mask_, std::numeric_limits<uint32_t>::max());
+  DCHECK_LE(bucket_mask, std::numeric_limits<uint32_t>::max());
 }
 
-LockFreeAddressHashSet::~LockFreeAddressHashSet() {
-  for (std::atomic<Node*>& bucket : buckets_) {
+LockFreeAddressHashSet::Table::~Table() {
+  for (std::atomic<Node*>& bucket : buckets) {
     Node* node = bucket.load(std::memory_order_relaxed);
     while (node) {
       Node* next = node->next;
@@ -28,13 +30,39 @@ LockFreeAddressHashSet::~LockFreeAddressHashSet() {
   }
 }
 
+LockFreeAddressHashSet::LockFreeAddressHashSet(size_t buckets_count,
+                                               float max_load_factor)
+    : buckets_migrated_per_write_(
+          // The new table exceeds |max_load_factor| after as many writes as
+          // the old table has buckets times |max_load_factor|.
+          std::isfinite(max_load_factor)
+              ? static_cast<size_t>(std::ceil(1 / max_load_factor)) + 1
+              : 0),
+      max_load_factor_(max_load_factor) {
+  DCHECK_GT(max_load_factor, 0);
+  tables_.push_back(std::make_unique<Table>(buckets_count));
+  table_.store(tables_.back().get(), std::memory_order_relaxed);
+}
+
+LockFreeAddressHashSet::~LockFreeAddressHashSet() = default;
+
 void LockFreeAddressHashSet::Insert(void* key) {
   DCHECK_NE(key, nullptr);
   CHECK(!Contains(key));
   ++size_;
+  InsertIntoTable(*table_.load(std::memory_order_relaxed), key);
+  if (UNLIKELY(old_table_.load(std::memory_order_relaxed))) {
+    MigrateBuckets(buckets_migrated_per_write_);
+  } else if (UNLIKELY(load_factor() > max_load_factor_)) {
+    StartResize();
+  }
+}
+
+// static
+void LockFreeAddressHashSet::InsertIntoTable(Table& table, void* key) {
   // Note: There's no need to use std::atomic_compare_exchange here,
   // as we do not support concurrent inserts, so values cannot change midair.
-  std::atomic<Node*>& bucket = buckets_[Hash(key) & bucket_mask_];
+  std::atomic<Node*>& bucket = table.buckets[Hash(key) & table.bucket_mask];
   Node* node = bucket.load(std::memory_order_relaxed);
   // First iterate over the bucket nodes and try to reuse an empty one if found.
   for (; node != nullptr; node = node->next) {
@@ -50,14 +78,50 @@ void LockFreeAddressHashSet::Insert(void* key) {
   bucket.store(new_node, std::memory_order_release);
 }
 
+void LockFreeAddressHashSet::StartResize() {
+  DCHECK(!old_table_.load(std::memory_order_relaxed));
+  Table* old_table = table_.load(std::memory_order_relaxed);
+  tables_.push_back(std::make_unique<Table>(old_table->buckets.size() * 2));
+  next_bucket_to_migrate_ = 0;
+  // Readers which see the new table must see the old one too.
+  old_table_.store(old_table, std::memory_order_release);
+  table_.store(tables_.back().get(), std::memory_order_release);
+}
+
+void LockFreeAddressHashSet::MigrateBuckets(size_t buckets) {
+  Table* old_table = old_table_.load(std::memory_order_relaxed);
+  Table& table = *table_.load(std::memory_order_relaxed);
+  const size_t end =
+      std::min(next_bucket_to_migrate_ + buckets, old_table->buckets.size());
+  for (; next_bucket_to_migrate_ < end; ++next_bucket_to_migrate_) {
+    for (Node* node = old_table->buckets[next_bucket_to_migrate_].load(
+             std::memory_order_relaxed);
+         node; node = node->next) {
+      void* key = node->key.load(std::memory_order_relaxed);
+      if (!key) {
+        continue;
+      }
+      // Publish the key in the new table before removing it from the old
+      // one, so that readers always find it in either.
+      InsertIntoTable(table, key);
+      node->key.store(nullptr, std::memory_order_release);
+    }
+  }
+  if (next_bucket_to_migrate_ == old_table->buckets.size()) {
+    old_table_.store(nullptr, std::memory_order_release);
+  }
+}
+
 void LockFreeAddressHashSet::Copy(const LockFreeAddressHashSet& other) {
   DCHECK_EQ(0u, size());
-  for (const std::atomic<Node*>& bucket : other.buckets_) {
-    for (Node* node = bucket.load(std::memory_order_relaxed); node;
-         node = node->next) {
-      void* key = node->key.load(std::memory_order_relaxed);
-      if (key)
-        Insert(key);
+  for (const std::unique_ptr<Table>& table : other.tables_) {
+    for (const std::atomic<Node*>& bucket : table->buckets) {
+      for (Node* node = bucket.load(std::memory_order_relaxed); node;
+           node = node->next) {
+        void* key = node->key.load(std::memory_order_relaxed);
+        if (key)
+          Insert(key);
+      }
     }
   }
 }
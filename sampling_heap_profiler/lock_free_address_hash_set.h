@@ -7,6 +7,8 @@
 
 #include <atomic>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
 #include "base/base_export.h"
@@ -25,10 +27,7 @@ namespace base {
 // However, please note the result of concurrent execution of |Contains|
 // with |Insert| or |Remove| over the same key is racy.
 //
-// The hash set never rehashes, so the number of buckets stays the same
-// for the lifetime of the set.
-//
-// Internally the hashset is implemented as a vector of N buckets
+// Internally the hashset is implemented as a table of N buckets
 // (N has to be a power of 2). Each bucket holds a single-linked list of
 // nodes each corresponding to a key.
 // It is not possible to really delete nodes from the list as there might
@@ -42,9 +41,20 @@ namespace base {
 // 2: {*}--> {NULL,*}--> {key3,*}--> {key4,*}--> NULL
 // ...
 // N-1: {*}--> {keyM,*}--> NULL
+//
+// Once the load factor exceeds |max_load_factor|, the set switches to a table
+// twice larger, and migrates the keys of the previous table gradually: every
+// |Insert| and |Remove| moves the keys of a few buckets, so that no single
+// write operation pays for copying the whole set. Until the migration is
+// complete, lookups check both tables. Previous tables are kept alive until
+// the set is destroyed, since concurrent readers may still be using them.
+// By default the load factor isn't bounded and the number of buckets stays
+// the same for the lifetime of the set.
 class BASE_EXPORT LockFreeAddressHashSet {
  public:
-  explicit LockFreeAddressHashSet(size_t buckets_count);
+  explicit LockFreeAddressHashSet(
+      size_t buckets_count,
+      float max_load_factor = std::numeric_limits<float>::infinity());
   ~LockFreeAddressHashSet();
 
   // Checks if the |key| is in the set. Can be executed concurrently with
@@ -66,11 +76,20 @@ class BASE_EXPORT LockFreeAddressHashSet {
   // Concurrent execution of |Insert|, |Remove|, or |Copy| is not supported.
   void Copy(const LockFreeAddressHashSet& other);
 
-  size_t buckets_count() const { return buckets_.size(); }
+  // Returns the number of buckets of the table receiving new keys.
+  size_t buckets_count() const {
+    return table_.load(std::memory_order_relaxed)->buckets.size();
+  }
   size_t size() const { return size_; }
+  float max_load_factor() const { return max_load_factor_; }
 
   // Returns the average bucket utilization.
-  float load_factor() const { return 1.f * size() / buckets_.size(); }
+  float load_factor() const { return 1.f * size() / buckets_count(); }
+
+  // Returns whether keys are being migrated to a larger table.
+  bool IsResizingForTesting() const {
+    return old_table_.load(std::memory_order_relaxed) != nullptr;
+  }
 
  private:
   friend class LockFreeAddressHashSetTest;
@@ -82,12 +101,40 @@ class BASE_EXPORT LockFreeAddressHashSet {
     RAW_PTR_EXCLUSION Node* next;
   };
 
+  struct Table {
+    explicit Table(size_t buckets_count);
+    ~Table();
+
+    std::vector<std::atomic<Node*>> buckets;
+    const size_t bucket_mask;
+  };
+
   ALWAYS_INLINE static uint32_t Hash(void* key);
+  ALWAYS_INLINE static Node* FindNode(const Table& table, void* key);
   ALWAYS_INLINE Node* FindNode(void* key) const;
 
-  std::vector<std::atomic<Node*>> buckets_;
+  // Inserts |key| into |table|, reusing an empty node if possible.
+  static void InsertIntoTable(Table& table, void* key);
+  // Starts migrating the keys to a table twice larger.
+  void StartResize();
+  // Migrates the keys of up to |buckets| buckets of |old_table_|.
+  void MigrateBuckets(size_t buckets);
+
+  // The table receiving new keys, and the table whose keys are being moved
+  // to it during a resize, if any. Readers load |table_| first: since
+  // |old_table_| is set before |table_| when a resize starts, they can't miss
+  // the keys which are yet to be migrated.
+  std::atomic<Table*> table_;
+  std::atomic<Table*> old_table_{nullptr};
+  // Owns all the tables ever used. Only accessed by writers.
+  std::vector<std::unique_ptr<Table>> tables_;
+  // The next bucket of |old_table_| to migrate.
+  size_t next_bucket_to_migrate_ = 0;
+  // The number of buckets to migrate on each write, enough to complete the
+  // migration before the new table exceeds |max_load_factor_|.
+  const size_t buckets_migrated_per_write_;
+  const float max_load_factor_;
   size_t size_ = 0;
-  const size_t bucket_mask_;
 };
 
 ALWAYS_INLINE LockFreeAddressHashSet::Node::Node(void* key, Node* next)
@@ -107,25 +154,56 @@ ALWAYS_INLINE void LockFreeAddressHashSet::Remove(void* key) {
   // Instead we just mark it as empty, so |Insert| can reuse it later.
   node->key.store(nullptr, std::memory_order_relaxed);
   --size_;
+  if (UNLIKELY(old_table_.load(std::memory_order_relaxed))) {
+    MigrateBuckets(buckets_migrated_per_write_);
+  }
 }
 
+// static
 ALWAYS_INLINE LockFreeAddressHashSet::Node* LockFreeAddressHashSet::FindNode(
-    void* key) const {
+    const Table& table,
+    void* key) {
   DCHECK_NE(key, nullptr);
-  const std::atomic<Node*>& bucket = buckets_[Hash(key) & bucket_mask_];
+  const std::atomic<Node*>& bucket =
+      table.buckets[Hash(key) & table.bucket_mask];
   // It's enough to use std::memory_order_consume ordering here, as the
   // node->next->...->next loads form dependency chain.
   // However std::memory_order_consume is temporary deprecated in C++17.
   // See https://isocpp.org/files/papers/p0636r0.html#removed
   // Make use of more strong std::memory_order_acquire for now.
+  // The keys are loaded with acquire ordering too, so that a key seen as
+  // removed from the old table by a migration is seen in the new table.
   for (Node* node = bucket.load(std::memory_order_acquire); node != nullptr;
        node = node->next) {
-    if (node->key.load(std::memory_order_relaxed) == key)
+    if (node->key.load(std::memory_order_acquire) == key)
       return node;
   }
   return nullptr;
 }
 
+ALWAYS_INLINE LockFreeAddressHashSet::Node* LockFreeAddressHashSet::FindNode(
+    void* key) const {
+  while (true) {
+    Table* table = table_.load(std::memory_order_acquire);
+    // Keys are migrated by inserting them into |table| before removing them
+    // from |old_table|, so the old table has to be searched first.
+    Table* old_table = old_table_.load(std::memory_order_acquire);
+    if (UNLIKELY(old_table)) {
+      if (Node* node = FindNode(*old_table, key)) {
+        return node;
+      }
+    }
+    if (Node* node = FindNode(*table, key)) {
+      return node;
+    }
+    // If another resize started meanwhile, the key may have been migrated
+    // to a table which wasn't searched.
+    if (LIKELY(table == table_.load(std::memory_order_acquire))) {
+      return nullptr;
+    }
+  }
+}
+
 // static
 ALWAYS_INLINE uint32_t LockFreeAddressHashSet::Hash(void* key) {
   // A simple fast hash function for addresses.
@@ -0,0 +1,188 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/memory/raw_ptr.h"
+#include "base/sampling_heap_profiler/lock_free_address_hash_set.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "base/timer/lap_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+namespace {
+
+constexpr int kWarmupRuns = 1;
+constexpr TimeDelta kTimeLimit = Seconds(1);
+constexpr int kTimeCheckInterval = 10000;
+
+constexpr char kMetricPrefixHashSet[] = "LockFreeAddressHashSet.";
+constexpr char kMetricInsertTime[] = "insert_time";
+constexpr char kMetricMaxInsertTime[] = "max_insert_time";
+constexpr char kMetricLookupThroughput[] = "lookup_throughput";
+constexpr char kStoryIncrementalResize[] = "incremental_resize";
+constexpr char kStoryCopyOnResize[] = "copy_on_resize";
+constexpr char kStoryWithGrowingWriter[] = "with_growing_writer";
+constexpr char kStoryWithoutWriter[] = "without_writer";
+
+constexpr size_t kInitialBucketsCount = 64;
+constexpr size_t kNumInsertedKeys = 1 << 20;
+constexpr int kNumReaders = 3;
+
+void* KeyAt(size_t index) {
+  // Like heap addresses, keys are aligned.
+  return reinterpret_cast<void*>(0x10000 + index * 16);
+}
+
+// Grows a set to kNumInsertedKeys keys, either letting it resize itself, or
+// copying it into a set twice larger whenever its load factor exceeds 1 as
+// PoissonAllocationSampler used to do, and reports the mean and worst
+// insertion times.
+void RunInsert(bool incremental_resize) {
+  std::vector<std::unique_ptr<LockFreeAddressHashSet>> sets;
+  sets.push_back(std::make_unique<LockFreeAddressHashSet>(
+      kInitialBucketsCount,
+      incremental_resize ? 1 : std::numeric_limits<float>::infinity()));
+  TimeDelta max_insert_time;
+  const TimeTicks start = TimeTicks::Now();
+  for (size_t i = 0; i < kNumInsertedKeys; ++i) {
+    const TimeTicks insert_start = TimeTicks::Now();
+    sets.back()->Insert(KeyAt(i));
+    if (!incremental_resize && sets.back()->load_factor() > 1) {
+      auto new_set = std::make_unique<LockFreeAddressHashSet>(
+          sets.back()->buckets_count() * 2);
+      new_set->Copy(*sets.back());
+      sets.push_back(std::move(new_set));
+    }
+    max_insert_time =
+        std::max(max_insert_time, TimeTicks::Now() - insert_start);
+  }
+  const TimeDelta total_time = TimeTicks::Now() - start;
+
+  perf_test::PerfResultReporter reporter(
+      kMetricPrefixHashSet,
+      incremental_resize ? kStoryIncrementalResize : kStoryCopyOnResize);
+  reporter.RegisterImportantMetric(kMetricInsertTime, "ns");
+  reporter.RegisterImportantMetric(kMetricMaxInsertTime, "us");
+  reporter.AddResult(kMetricInsertTime,
+                     total_time.InNanoseconds() * 1. / kNumInsertedKeys);
+  reporter.AddResult(kMetricMaxInsertTime, max_insert_time.InMicrosecondsF());
+}
+
+// Inserts keys until stopped, resizing the set many times.
+class GrowingWriter : public PlatformThread::Delegate {
+ public:
+  explicit GrowingWriter(LockFreeAddressHashSet* set) : set_(set) {}
+  ~GrowingWriter() override = default;
+
+  void ThreadMain() override {
+    for (size_t i = set_->size();
+         !should_stop_.load(std::memory_order_relaxed) &&
+         i < kNumInsertedKeys;
+         ++i) {
+      set_->Insert(KeyAt(i));
+    }
+  }
+
+  // Called from another thread to stop the loop.
+  void Stop() { should_stop_ = true; }
+
+ private:
+  raw_ptr<LockFreeAddressHashSet> set_;
+  std::atomic<bool> should_stop_{false};
+};
+
+// Looks up keys until stopped, half of which are in the set.
+class Reader : public PlatformThread::Delegate {
+ public:
+  explicit Reader(const LockFreeAddressHashSet* set) : set_(set) {}
+  ~Reader() override = default;
+
+  void ThreadMain() override {
+    for (size_t i = 0; !should_stop_.load(std::memory_order_relaxed); ++i) {
+      found_ += set_->Contains(KeyAt(i % (2 * kInitialBucketsCount)));
+    }
+  }
+
+  // Called from another thread to stop the loop.
+  void Stop() { should_stop_ = true; }
+
+ private:
+  raw_ptr<const LockFreeAddressHashSet> set_;
+  std::atomic<bool> should_stop_{false};
+  size_t found_ = 0;
+};
+
+// Measures the lookup throughput of this thread while `kNumReaders` other
+// threads look up keys too, and optionally a writer grows the set.
+void RunLookup(bool with_growing_writer) {
+  LockFreeAddressHashSet set(kInitialBucketsCount, /*max_load_factor=*/1);
+  for (size_t i = 0; i < kInitialBucketsCount; ++i) {
+    set.Insert(KeyAt(i));
+  }
+
+  std::vector<std::unique_ptr<Reader>> readers;
+  std::vector<PlatformThreadHandle> reader_handles(kNumReaders);
+  for (PlatformThreadHandle& handle : reader_handles) {
+    readers.push_back(std::make_unique<Reader>(&set));
+    ASSERT_TRUE(PlatformThread::Create(0, readers.back().get(), &handle));
+  }
+  GrowingWriter writer(&set);
+  PlatformThreadHandle writer_handle;
+  if (with_growing_writer) {
+    ASSERT_TRUE(PlatformThread::Create(0, &writer, &writer_handle));
+  }
+
+  LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+  size_t i = 0;
+  [[maybe_unused]] size_t found = 0;
+  do {
+    found += set.Contains(KeyAt(i++ % (2 * kInitialBucketsCount)));
+    timer.NextLap();
+  } while (!timer.HasTimeLimitExpired());
+
+  for (auto& reader : readers) {
+    reader->Stop();
+  }
+  for (PlatformThreadHandle& handle : reader_handles) {
+    PlatformThread::Join(handle);
+  }
+  if (with_growing_writer) {
+    writer.Stop();
+    PlatformThread::Join(writer_handle);
+  }
+
+  perf_test::PerfResultReporter reporter(
+      kMetricPrefixHashSet,
+      with_growing_writer ? kStoryWithGrowingWriter : kStoryWithoutWriter);
+  reporter.RegisterImportantMetric(kMetricLookupThroughput, "runs/s");
+  reporter.AddResult(kMetricLookupThroughput, timer.LapsPerSecond());
+}
+
+}  // namespace
+
+TEST(LockFreeAddressHashSetPerfTest, InsertWithIncrementalResize) {
+  RunInsert(/*incremental_resize=*/true);
+}
+
+TEST(LockFreeAddressHashSetPerfTest, InsertWithCopyOnResize) {
+  RunInsert(/*incremental_resize=*/false);
+}
+
+TEST(LockFreeAddressHashSetPerfTest, Lookup) {
+  RunLookup(/*with_growing_writer=*/false);
+}
+
+TEST(LockFreeAddressHashSetPerfTest, LookupWithGrowingWriter) {
+  RunLookup(/*with_growing_writer=*/true);
+}
+
+}  // namespace base
@@ -21,14 +21,17 @@ class LockFreeAddressHashSetTest : public ::testing::Test {
  public:
   static bool IsSubset(const LockFreeAddressHashSet& superset,
                        const LockFreeAddressHashSet& subset) {
-    for (const std::atomic<LockFreeAddressHashSet::Node*>& bucket :
-         subset.buckets_) {
-      for (LockFreeAddressHashSet::Node* node =
-               bucket.load(std::memory_order_acquire);
-           node; node = node->next) {
-        void* key = node->key.load(std::memory_order_relaxed);
-        if (key && !superset.Contains(key))
-          return false;
+    for (const std::unique_ptr<LockFreeAddressHashSet::Table>& table :
+         subset.tables_) {
+      for (const std::atomic<LockFreeAddressHashSet::Node*>& bucket :
+           table->buckets) {
+        for (LockFreeAddressHashSet::Node* node =
+                 bucket.load(std::memory_order_acquire);
+             node; node = node->next) {
+          void* key = node->key.load(std::memory_order_relaxed);
+          if (key && !superset.Contains(key))
+            return false;
+        }
       }
     }
     return true;
@@ -42,7 +45,9 @@ class LockFreeAddressHashSetTest : public ::testing::Test {
   static size_t BucketSize(const LockFreeAddressHashSet& set, size_t bucket) {
     size_t count = 0;
     LockFreeAddressHashSet::Node* node =
-        set.buckets_[bucket].load(std::memory_order_acquire);
+        set.table_.load(std::memory_order_acquire)
+            ->buckets[bucket]
+            .load(std::memory_order_acquire);
     for (; node; node = node->next)
       ++count;
     return count;
@@ -179,5 +184,81 @@ TEST_F(LockFreeAddressHashSetTest, BucketsUsage) {
   }
 }
 
+TEST_F(LockFreeAddressHashSetTest, Resize) {
+  LockFreeAddressHashSet set(8, /*max_load_factor=*/1);
+  EXPECT_EQ(1.f, set.max_load_factor());
+
+  for (size_t i = 1; i <= 8; ++i) {
+    set.Insert(reinterpret_cast<void*>(i));
+  }
+  EXPECT_EQ(size_t(8), set.buckets_count());
+  EXPECT_FALSE(set.IsResizingForTesting());
+
+  // Exceeding the load factor starts the migration to a larger table.
+  set.Insert(reinterpret_cast<void*>(9));
+  EXPECT_EQ(size_t(16), set.buckets_count());
+  EXPECT_TRUE(set.IsResizingForTesting());
+  for (size_t i = 1; i <= 9; ++i) {
+    EXPECT_TRUE(set.Contains(reinterpret_cast<void*>(i)));
+  }
+
+  // Keys are found while they are migrated by the following writes, and
+  // removed keys aren't migrated.
+  set.Remove(reinterpret_cast<void*>(1));
+  for (size_t i = 10; set.IsResizingForTesting(); ++i) {
+    set.Insert(reinterpret_cast<void*>(i));
+    ASSERT_LT(i, size_t(16));
+  }
+  EXPECT_EQ(size_t(16), set.buckets_count());
+  EXPECT_FALSE(set.Contains(reinterpret_cast<void*>(1)));
+  for (size_t i = 2; i <= set.size() + 1; ++i) {
+    EXPECT_TRUE(set.Contains(reinterpret_cast<void*>(i)));
+  }
+
+  LockFreeAddressHashSet copy(4);
+  copy.Copy(set);
+  EXPECT_TRUE(Equals(set, copy));
+}
+
+class GrowingWriterThread : public SimpleThread {
+ public:
+  GrowingWriterThread(LockFreeAddressHashSet* set, std::atomic_bool* done)
+      : SimpleThread("GrowingWriterThread"), set_(set), done_(done) {}
+
+  void Run() override {
+    // Every insertion grows the set, which is resized many times.
+    for (size_t value = 0x10000; value < 0x30000; ++value) {
+      set_->Insert(reinterpret_cast<void*>(value));
+    }
+    done_->store(true, std::memory_order_release);
+  }
+
+ private:
+  raw_ptr<LockFreeAddressHashSet> set_;
+  raw_ptr<std::atomic_bool> done_;
+};
+
+TEST_F(LockFreeAddressHashSetTest, ConcurrentAccessWhileResizing) {
+  // The purpose of this test is to make sure the keys are always found while
+  // they are migrated to larger tables concurrently.
+  LockFreeAddressHashSet set(4, /*max_load_factor=*/1);
+  for (size_t i = 1; i <= 20; ++i)
+    set.Insert(reinterpret_cast<void*>(i));
+
+  std::atomic_bool done(false);
+  auto thread = std::make_unique<GrowingWriterThread>(&set, &done);
+  thread->Start();
+
+  while (!done.load(std::memory_order_acquire)) {
+    for (size_t i = 1; i <= 20; ++i) {
+      EXPECT_TRUE(set.Contains(reinterpret_cast<void*>(i)));
+    }
+  }
+  thread->Join();
+
+  EXPECT_EQ(size_t(20 + 0x20000), set.size());
+  EXPECT_LE(set.load_factor(), 1.f);
+}
+
 }  // namespace
 }  // namespace base
@@ -33,7 +33,10 @@ const intptr_t kAccumulatedBytesOffset = 1 << 29;
 // Controls if sample intervals should not be randomized. Used for testing.
 bool g_deterministic = false;
 
-// Pointer to the current |LockFreeAddressHashSet|.
+// The load factor above which the set of sampled addresses grows.
+constexpr float kSampledAddressesMaxLoadFactor = 1;
+
+// Pointer to the |LockFreeAddressHashSet| of sampled addresses.
 ABSL_CONST_INIT std::atomic<LockFreeAddressHashSet*> g_sampled_addresses_set{
     nullptr};
 
@@ -178,7 +181,10 @@ ABSL_CONST_INIT std::atomic<PoissonAllocationSampler::ProfilingStateFlagMask>
 
 PoissonAllocationSampler::PoissonAllocationSampler() {
   Init();
-  auto* sampled_addresses = new LockFreeAddressHashSet(64);
+  // The set grows incrementally as addresses are inserted, so that no sample
+  // has to wait for the whole set to be copied.
+  auto* sampled_addresses =
+      new LockFreeAddressHashSet(64, kSampledAddressesMaxLoadFactor);
   g_sampled_addresses_set.store(sampled_addresses, std::memory_order_release);
 }
 
@@ -307,7 +313,6 @@ void PoissonAllocationSampler::DoRecordAllocation(
       return;
     }
     sampled_addresses_set().Insert(address);
-    BalanceAddressesHashSet();
     observers_copy = observers_;
   }
 
@@ -336,28 +341,6 @@ void PoissonAllocationSampler::DoRecordFree(void* address) {
   }
 }
 
-void PoissonAllocationSampler::BalanceAddressesHashSet() {
-  // Check if the load_factor of the current addresses hash set becomes higher
-  // than 1, allocate a new twice larger one, copy all the data,
-  // and switch to using it.
-  // During the copy process no other writes are made to both sets
-  // as it's behind the lock.
-  // All the readers continue to use the old one until the atomic switch
-  // process takes place.
-  LockFreeAddressHashSet& current_set = sampled_addresses_set();
-  if (current_set.load_factor() < 1) {
-    return;
-  }
-  auto new_set =
-      std::make_unique<LockFreeAddressHashSet>(current_set.buckets_count() * 2);
-  new_set->Copy(current_set);
-  // Atomically switch all the new readers to the new set.
-  g_sampled_addresses_set.store(new_set.release(), std::memory_order_release);
-  // We leak the older set because we still have to keep all the old maps alive
-  // as there might be reader threads that have already obtained the map,
-  // but haven't yet managed to access it.
-}
-
 // static
 LockFreeAddressHashSet& PoissonAllocationSampler::sampled_addresses_set() {
   return *g_sampled_addresses_set.load(std::memory_order_acquire);
@@ -195,8 +195,6 @@ class BASE_EXPORT PoissonAllocationSampler {
                           const char* context);
   void DoRecordFree(void* address);
 
-  void BalanceAddressesHashSet();
-
   Lock mutex_;
 
   // The |observers_| list is guarded by |mutex_|, however a copy of it
@@ -215,6 +213,7 @@ class BASE_EXPORT PoissonAllocationSampler {
   friend class PoissonAllocationSamplerStateTest;
   friend class SamplingHeapProfilerTest;
   FRIEND_TEST_ALL_PREFIXES(PoissonAllocationSamplerTest, MuteHooksWithoutInit);
+  FRIEND_TEST_ALL_PREFIXES(SamplingHeapProfilerTest, AllocationSiteSnapshot);
   FRIEND_TEST_ALL_PREFIXES(SamplingHeapProfilerTest, HookedAllocatorMuted);
 };
 
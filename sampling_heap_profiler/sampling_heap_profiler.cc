@@ -18,10 +18,12 @@
 #include "base/debug/stack_trace.h"
 #include "base/feature_list.h"
 #include "base/functional/bind.h"
+#include "base/hash/hash.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/no_destructor.h"
 #include "base/notreached.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/sampling_heap_profiler/lock_free_address_hash_set.h"
 #include "base/sampling_heap_profiler/poisson_allocation_sampler.h"
 #include "base/threading/thread_local_storage.h"
@@ -147,6 +149,38 @@ SamplingHeapProfiler::Sample::Sample(size_t size,
 SamplingHeapProfiler::Sample::Sample(const Sample&) = default;
 SamplingHeapProfiler::Sample::~Sample() = default;
 
+SamplingHeapProfiler::AllocationSite::AllocationSite() = default;
+SamplingHeapProfiler::AllocationSite::AllocationSite(const AllocationSite&) =
+    default;
+SamplingHeapProfiler::AllocationSite::AllocationSite(AllocationSite&&) =
+    default;
+SamplingHeapProfiler::AllocationSite&
+SamplingHeapProfiler::AllocationSite::operator=(const AllocationSite&) =
+    default;
+SamplingHeapProfiler::AllocationSite&
+SamplingHeapProfiler::AllocationSite::operator=(AllocationSite&&) = default;
+SamplingHeapProfiler::AllocationSite::~AllocationSite() = default;
+
+SamplingHeapProfiler::AllocationSiteSnapshot::AllocationSiteSnapshot() =
+    default;
+SamplingHeapProfiler::AllocationSiteSnapshot::AllocationSiteSnapshot(
+    const AllocationSiteSnapshot&) = default;
+SamplingHeapProfiler::AllocationSiteSnapshot::AllocationSiteSnapshot(
+    AllocationSiteSnapshot&&) = default;
+SamplingHeapProfiler::AllocationSiteSnapshot&
+SamplingHeapProfiler::AllocationSiteSnapshot::operator=(
+    const AllocationSiteSnapshot&) = default;
+SamplingHeapProfiler::AllocationSiteSnapshot&
+SamplingHeapProfiler::AllocationSiteSnapshot::operator=(
+    AllocationSiteSnapshot&&) = default;
+SamplingHeapProfiler::AllocationSiteSnapshot::~AllocationSiteSnapshot() =
+    default;
+
+size_t SamplingHeapProfiler::StackHash::operator()(
+    const std::vector<const void*>& stack) const {
+  return FastHash(as_byte_span(stack));
+}
+
 SamplingHeapProfiler::SamplingHeapProfiler() = default;
 SamplingHeapProfiler::~SamplingHeapProfiler() {
   if (record_thread_names_)
@@ -267,6 +301,17 @@ void SamplingHeapProfiler::SampleAdded(void* address,
   // the sampling heap profiler failed to observe the destruction -- possibly
   // because the sampling heap profiler was temporarily disabled. We should
   // override the old entry.
+  auto it = samples_.find(address);
+  if (it != samples_.end()) {
+    RemoveFromAllocationSite(it->second);
+  }
+  ++sequence_number_;
+  sample.stack_id = GetOrAddStackId(sample.stack);
+  AllocationSite& site = allocation_sites_[sample.stack_id].site;
+  site.in_use_bytes += sample.total;
+  ++site.in_use_count;
+  site.cumulative_bytes += sample.total;
+  ++site.cumulative_count;
   samples_.insert_or_assign(address, std::move(sample));
 }
 
@@ -299,7 +344,34 @@ const char* SamplingHeapProfiler::RecordString(const char* string) {
 void SamplingHeapProfiler::SampleRemoved(void* address) {
   DCHECK(base::PoissonAllocationSampler::ScopedMuteThreadSamples::IsMuted());
   base::AutoLock lock(mutex_);
-  samples_.erase(address);
+  auto it = samples_.find(address);
+  if (it == samples_.end()) {
+    return;
+  }
+  ++sequence_number_;
+  RemoveFromAllocationSite(it->second);
+  samples_.erase(it);
+}
+
+uint32_t SamplingHeapProfiler::GetOrAddStackId(
+    const std::vector<const void*>& stack) {
+  auto [it, inserted] = stack_ids_.emplace(
+      stack, checked_cast<uint32_t>(allocation_sites_.size()));
+  if (inserted) {
+    AllocationSiteState& state = allocation_sites_.emplace_back();
+    state.site.stack_id = it->second;
+    state.site.stack = stack;
+    state.first_sequence_number = sequence_number_;
+  }
+  return it->second;
+}
+
+void SamplingHeapProfiler::RemoveFromAllocationSite(const Sample& sample) {
+  AllocationSite& site = allocation_sites_[sample.stack_id].site;
+  DCHECK_GE(site.in_use_bytes, sample.total);
+  DCHECK_GT(site.in_use_count, 0u);
+  site.in_use_bytes -= sample.total;
+  --site.in_use_count;
 }
 
 std::vector<SamplingHeapProfiler::Sample> SamplingHeapProfiler::GetSamples(
@@ -319,6 +391,57 @@ std::vector<SamplingHeapProfiler::Sample> SamplingHeapProfiler::GetSamples(
   return samples;
 }
 
+SamplingHeapProfiler::AllocationSiteSnapshot
+SamplingHeapProfiler::GetAllocationSiteSnapshot(
+    uint64_t known_stacks_sequence_number) {
+  PoissonAllocationSampler::ScopedMuteThreadSamples no_samples_scope;
+  AutoLock lock(mutex_);
+  AllocationSiteSnapshot snapshot;
+  snapshot.sequence_number = sequence_number_;
+  snapshot.sites.reserve(allocation_sites_.size());
+  for (const AllocationSiteState& state : allocation_sites_) {
+    AllocationSite& site = snapshot.sites.emplace_back();
+    site.stack_id = state.site.stack_id;
+    if (state.first_sequence_number > known_stacks_sequence_number) {
+      site.stack = state.site.stack;
+    }
+    site.in_use_bytes = state.site.in_use_bytes;
+    site.in_use_count = state.site.in_use_count;
+    site.cumulative_bytes = state.site.cumulative_bytes;
+    site.cumulative_count = state.site.cumulative_count;
+  }
+  return snapshot;
+}
+
+// static
+SamplingHeapProfiler::AllocationSiteSnapshot
+SamplingHeapProfiler::GetAllocationSiteDelta(const AllocationSiteSnapshot& from,
+                                             const AllocationSiteSnapshot& to) {
+  DCHECK_LE(from.sequence_number, to.sequence_number);
+  AllocationSiteSnapshot delta;
+  delta.sequence_number = to.sequence_number;
+  auto from_it = from.sites.begin();
+  for (const AllocationSite& site : to.sites) {
+    // Sites are sorted by stack id in both snapshots, and never removed.
+    while (from_it != from.sites.end() && from_it->stack_id < site.stack_id) {
+      ++from_it;
+    }
+    if (from_it == from.sites.end() || from_it->stack_id != site.stack_id) {
+      delta.sites.push_back(site);
+      continue;
+    }
+    DCHECK_GE(site.cumulative_count, from_it->cumulative_count);
+    if (site.cumulative_count == from_it->cumulative_count &&
+        site.in_use_count == from_it->in_use_count) {
+      continue;
+    }
+    AllocationSite& changed_site = delta.sites.emplace_back(site);
+    changed_site.cumulative_bytes -= from_it->cumulative_bytes;
+    changed_site.cumulative_count -= from_it->cumulative_count;
+  }
+  return delta;
+}
+
 std::vector<const char*> SamplingHeapProfiler::GetStrings() {
   PoissonAllocationSampler::ScopedMuteThreadSamples no_samples_scope;
   AutoLock lock(mutex_);
@@ -345,6 +468,8 @@ void SamplingHeapProfiler::ClearSamplesForTesting() {
   DCHECK(PoissonAllocationSampler::AreHookedSamplesMuted());
   base::AutoLock lock(mutex_);
   samples_.clear();
+  allocation_sites_.clear();
+  stack_ids_.clear();
   // Since hooked samples are muted, any samples that are waiting to take the
   // lock in SampleAdded will be discarded. Tests can now call
   // PoissonAllocationSampler::RecordAlloc with allocator type kManualForTesting
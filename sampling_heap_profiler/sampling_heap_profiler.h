@@ -5,6 +5,8 @@
 #ifndef BASE_SAMPLING_HEAP_PROFILER_SAMPLING_HEAP_PROFILER_H_
 #define BASE_SAMPLING_HEAP_PROFILER_SAMPLING_HEAP_PROFILER_H_
 
+#include <stdint.h>
+
 #include <atomic>
 #include <unordered_map>
 #include <unordered_set>
@@ -57,6 +59,45 @@ class BASE_EXPORT SamplingHeapProfiler
 
 
     uint32_t ordinal;
+    // Index of the allocation site of `stack` in `allocation_sites_`.
+    uint32_t stack_id = 0;
+  };
+
+  // The samples which have the same call stack, aggregated.
+  struct BASE_EXPORT AllocationSite {
+    AllocationSite();
+    AllocationSite(const AllocationSite&);
+    AllocationSite(AllocationSite&&);
+    AllocationSite& operator=(const AllocationSite&);
+    AllocationSite& operator=(AllocationSite&&);
+    ~AllocationSite();
+
+    // Identifies the call stack for the lifetime of the process.
+    uint32_t stack_id = 0;
+    // Call stack of PC addresses, or empty if the caller already knows it.
+    std::vector<const void*> stack;
+    // Total size attributed to the live samples, and their number.
+    size_t in_use_bytes = 0;
+    size_t in_use_count = 0;
+    // Total size attributed to all the samples ever recorded, and their
+    // number, including the freed ones.
+    uint64_t cumulative_bytes = 0;
+    uint64_t cumulative_count = 0;
+  };
+
+  struct BASE_EXPORT AllocationSiteSnapshot {
+    AllocationSiteSnapshot();
+    AllocationSiteSnapshot(const AllocationSiteSnapshot&);
+    AllocationSiteSnapshot(AllocationSiteSnapshot&&);
+    AllocationSiteSnapshot& operator=(const AllocationSiteSnapshot&);
+    AllocationSiteSnapshot& operator=(AllocationSiteSnapshot&&);
+    ~AllocationSiteSnapshot();
+
+    // Increases with every sample added or removed, so that a snapshot only
+    // reflects the changes up to its sequence number.
+    uint64_t sequence_number = 0;
+    // Sorted by `stack_id`.
+    std::vector<AllocationSite> sites;
   };
 
   // On Android this is logged to UMA - keep in sync AndroidStackUnwinder in
@@ -94,6 +135,21 @@ class BASE_EXPORT SamplingHeapProfiler
   // set to 0.
   std::vector<Sample> GetSamples(uint32_t profile_id);
 
+  // Returns the allocation sites of all the samples recorded while the
+  // profiler was running, which is much smaller than GetSamples() since
+  // every distinct stack is only returned once. The stacks of the sites
+  // already present in the snapshot of `known_stacks_sequence_number` are
+  // left empty, so that periodic snapshots only copy the new stacks.
+  AllocationSiteSnapshot GetAllocationSiteSnapshot(
+      uint64_t known_stacks_sequence_number = 0);
+
+  // Returns the sites of `to` which changed since `from`, an earlier
+  // snapshot, with the cumulative values recorded between the two sequence
+  // numbers. The in-use values are those of `to`.
+  static AllocationSiteSnapshot GetAllocationSiteDelta(
+      const AllocationSiteSnapshot& from,
+      const AllocationSiteSnapshot& to);
+
   // List of strings used in the profile call stacks.
   std::vector<const char*> GetStrings();
 
@@ -125,7 +181,24 @@ class BASE_EXPORT SamplingHeapProfiler
                    const char* context) override;
   void SampleRemoved(void* address) override;
 
+  struct StackHash {
+    size_t operator()(const std::vector<const void*>& stack) const;
+  };
+
+  // The aggregated values of an allocation site, along with the sequence
+  // number at which it was added.
+  struct AllocationSiteState {
+    AllocationSite site;
+    uint64_t first_sequence_number;
+  };
+
   void CaptureNativeStack(const char* context, Sample* sample);
+  // Returns the id of the site of `stack`, adding it if needed.
+  uint32_t GetOrAddStackId(const std::vector<const void*>& stack)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Removes the contribution of a live sample from its site.
+  void RemoveFromAllocationSite(const Sample& sample)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   const char* RecordString(const char* string) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   // Delete all samples recorded, to ensure the profiler is in a consistent
@@ -134,12 +207,20 @@ class BASE_EXPORT SamplingHeapProfiler
   // that new hooked samples don't arrive while it's running.
   void ClearSamplesForTesting();
 
-  // Mutex to access |samples_| and |strings_|.
+  // Mutex to access |samples_|, |strings_| and the allocation sites.
   Lock mutex_;
 
   // Samples of the currently live allocations.
   std::unordered_map<void*, Sample> samples_ GUARDED_BY(mutex_);
 
+  // Allocation sites indexed by stack id. Sites are never removed, since
+  // their cumulative values outlive their samples, so this grows with the
+  // number of distinct stacks.
+  std::vector<AllocationSiteState> allocation_sites_ GUARDED_BY(mutex_);
+  std::unordered_map<std::vector<const void*>, uint32_t, StackHash> stack_ids_
+      GUARDED_BY(mutex_);
+  uint64_t sequence_number_ GUARDED_BY(mutex_) = 0;
+
   // Contains pointers to static sample context strings that are never deleted.
   std::unordered_set<const char*> strings_ GUARDED_BY(mutex_);
 
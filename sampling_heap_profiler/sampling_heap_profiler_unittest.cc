@@ -57,6 +57,10 @@ class SamplingHeapProfilerTest : public ::testing::Test {
     return SamplingHeapProfiler::Get()->running_sessions_;
   }
 
+  static void ClearSamples() {
+    SamplingHeapProfiler::Get()->ClearSamplesForTesting();
+  }
+
   static void RunStartStopLoop(SamplingHeapProfiler* profiler) {
     for (int i = 0; i < 100000; ++i) {
       profiler->Start();
@@ -377,4 +381,87 @@ TEST_F(SamplingHeapProfilerTest, HookedAllocatorMuted) {
   EXPECT_TRUE(collector.sample_removed);
 }
 
+NOINLINE void AllocateForTesting(void* address) {
+  PoissonAllocationSampler::Get()->OnAllocation(AllocationNotificationData(
+      address, 10000, nullptr, AllocationSubsystem::kManualForTesting));
+}
+
+NOINLINE void AllocateOtherForTesting(void* address) {
+  PoissonAllocationSampler::Get()->OnAllocation(AllocationNotificationData(
+      address, 20000, nullptr, AllocationSubsystem::kManualForTesting));
+}
+
+void FreeForTesting(void* address) {
+  PoissonAllocationSampler::Get()->OnFree(
+      FreeNotificationData(address, AllocationSubsystem::kManualForTesting));
+}
+
+TEST_F(SamplingHeapProfilerTest, AllocationSiteSnapshot) {
+  using AllocationSiteSnapshot = SamplingHeapProfiler::AllocationSiteSnapshot;
+  ScopedSuppressRandomnessForTesting suppress;
+  PoissonAllocationSampler::ScopedMuteHookedSamplesForTesting mute_hooks;
+  auto* profiler = SamplingHeapProfiler::Get();
+  profiler->SetSamplingInterval(1024);
+  profiler->Start();
+  ClearSamples();
+
+  // Allocations from the same loop have the same stack.
+  void* const kAddresses[] = {reinterpret_cast<void*>(0x1000),
+                              reinterpret_cast<void*>(0x2000),
+                              reinterpret_cast<void*>(0x3000)};
+  for (void* address : kAddresses) {
+    AllocateForTesting(address);
+  }
+
+  AllocationSiteSnapshot first = profiler->GetAllocationSiteSnapshot();
+  EXPECT_EQ(3u, first.sequence_number);
+  ASSERT_EQ(1u, first.sites.size());
+  const SamplingHeapProfiler::AllocationSite& site = first.sites[0];
+  EXPECT_FALSE(site.stack.empty());
+  EXPECT_EQ(3u, site.in_use_count);
+  EXPECT_EQ(3u, site.cumulative_count);
+  EXPECT_GT(site.in_use_bytes, 0u);
+  EXPECT_EQ(site.in_use_bytes, site.cumulative_bytes);
+
+  // Freed samples are only removed from the in-use values.
+  FreeForTesting(kAddresses[0]);
+  FreeForTesting(kAddresses[1]);
+  void* const kOtherAddress = reinterpret_cast<void*>(0x4000);
+  AllocateOtherForTesting(kOtherAddress);
+
+  AllocationSiteSnapshot second =
+      profiler->GetAllocationSiteSnapshot(first.sequence_number);
+  EXPECT_EQ(6u, second.sequence_number);
+  ASSERT_EQ(2u, second.sites.size());
+  // Only the stack of the new site isn't already known.
+  EXPECT_TRUE(second.sites[0].stack.empty());
+  EXPECT_FALSE(second.sites[1].stack.empty());
+  EXPECT_NE(site.stack, second.sites[1].stack);
+  EXPECT_EQ(1u, second.sites[0].in_use_count);
+  EXPECT_EQ(3u, second.sites[0].cumulative_count);
+  EXPECT_EQ(1u, second.sites[1].in_use_count);
+
+  AllocationSiteSnapshot delta =
+      SamplingHeapProfiler::GetAllocationSiteDelta(first, second);
+  EXPECT_EQ(second.sequence_number, delta.sequence_number);
+  ASSERT_EQ(2u, delta.sites.size());
+  EXPECT_EQ(site.stack_id, delta.sites[0].stack_id);
+  EXPECT_EQ(1u, delta.sites[0].in_use_count);
+  EXPECT_EQ(second.sites[0].in_use_bytes, delta.sites[0].in_use_bytes);
+  EXPECT_EQ(0u, delta.sites[0].cumulative_count);
+  EXPECT_EQ(0u, delta.sites[0].cumulative_bytes);
+  EXPECT_EQ(1u, delta.sites[1].cumulative_count);
+  EXPECT_EQ(second.sites[1].cumulative_bytes,
+            delta.sites[1].cumulative_bytes);
+
+  // Nothing changed since `second`.
+  EXPECT_TRUE(SamplingHeapProfiler::GetAllocationSiteDelta(
+                  second, profiler->GetAllocationSiteSnapshot())
+                  .sites.empty());
+
+  FreeForTesting(kAddresses[2]);
+  FreeForTesting(kOtherAddress);
+  profiler->Stop();
+}
+
 }  // namespace base
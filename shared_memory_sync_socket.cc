@@ -0,0 +1,288 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/shared_memory_sync_socket.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "base/bits.h"
+#include "base/check_op.h"
+#include "base/numerics/checked_math.h"
+
+namespace base {
+
+// The control block of a ring, at the start of its part of the region. The
+// positions count the bytes written and read since the creation of the ring,
+// and each is on a cache line of its own, so that the sender and the receiver
+// don't contend for them.
+struct SharedMemorySyncSocket::RingControl {
+  // Written by the sender.
+  alignas(64) std::atomic<uint64_t> write_position;
+  // Written by the receiver.
+  alignas(64) std::atomic<uint64_t> read_position;
+  // Set by the receiver while it waits for data, and by the sender while it
+  // waits for space. Cleared by whichever end wakes the waiter up.
+  alignas(64) std::atomic<uint32_t> receiver_waiting;
+  std::atomic<uint32_t> sender_waiting;
+  // Set by either end when it closes.
+  std::atomic<uint32_t> closed;
+};
+
+namespace {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "The atomics are shared with another process.");
+
+}  // namespace
+
+SharedMemorySyncSocket::Endpoint::Endpoint() = default;
+SharedMemorySyncSocket::Endpoint::Endpoint(Endpoint&&) = default;
+SharedMemorySyncSocket::Endpoint& SharedMemorySyncSocket::Endpoint::operator=(
+    Endpoint&&) = default;
+SharedMemorySyncSocket::Endpoint::~Endpoint() = default;
+
+SharedMemorySyncSocket::Ring::Ring() = default;
+SharedMemorySyncSocket::Ring::Ring(Ring&&) = default;
+SharedMemorySyncSocket::Ring& SharedMemorySyncSocket::Ring::operator=(
+    Ring&&) = default;
+SharedMemorySyncSocket::Ring::~Ring() = default;
+
+// static
+std::optional<std::pair<SharedMemorySyncSocket::Endpoint,
+                        SharedMemorySyncSocket::Endpoint>>
+SharedMemorySyncSocket::CreatePair(size_t capacity) {
+  CHECK_GT(capacity, 0u);
+  // Keep the control block of the second ring aligned.
+  const size_t ring_size =
+      sizeof(RingControl) + bits::AlignUp(capacity, alignof(RingControl));
+  // The memory is zeroed, which is the initial state of both rings.
+  UnsafeSharedMemoryRegion region =
+      UnsafeSharedMemoryRegion::Create(CheckMul(ring_size, 2).ValueOrDie());
+  if (!region.IsValid()) {
+    return std::nullopt;
+  }
+
+  std::pair<Endpoint, Endpoint> endpoints;
+  SyncSocket first_doorbells[2];
+  SyncSocket second_doorbells[2];
+  if (!SyncSocket::CreatePair(&first_doorbells[0], &first_doorbells[1]) ||
+      !SyncSocket::CreatePair(&second_doorbells[0], &second_doorbells[1])) {
+    return std::nullopt;
+  }
+  endpoints.first.region = region.Duplicate();
+  if (!endpoints.first.region.IsValid()) {
+    return std::nullopt;
+  }
+  endpoints.first.sends_to_first_ring = true;
+  endpoints.first.send_doorbell = first_doorbells[0].Take();
+  endpoints.first.receive_doorbell = second_doorbells[0].Take();
+  endpoints.second.region = std::move(region);
+  endpoints.second.sends_to_first_ring = false;
+  endpoints.second.send_doorbell = second_doorbells[1].Take();
+  endpoints.second.receive_doorbell = first_doorbells[1].Take();
+  return endpoints;
+}
+
+SharedMemorySyncSocket::SharedMemorySyncSocket(Endpoint endpoint) {
+  if (!endpoint.region.IsValid()) {
+    return;
+  }
+  const size_t ring_size = endpoint.region.GetSize() / 2;
+  if (ring_size <= sizeof(RingControl) ||
+      ring_size % alignof(RingControl) != 0) {
+    return;
+  }
+  mapping_ = endpoint.region.Map();
+  if (!mapping_.IsValid()) {
+    return;
+  }
+
+  span<uint8_t> memory = mapping_.GetMemoryAsSpan<uint8_t>();
+  auto [first_ring, second_ring] =
+      memory.first(2 * ring_size).split_at(ring_size);
+  auto make_ring = [](span<uint8_t> memory,
+                      SyncSocket::ScopedHandle doorbell) {
+    Ring ring;
+    ring.control = reinterpret_cast<RingControl*>(memory.data());
+    ring.data = memory.subspan(sizeof(RingControl));
+    ring.doorbell = std::make_unique<SyncSocket>(std::move(doorbell));
+    return ring;
+  };
+  send_ring_ =
+      make_ring(endpoint.sends_to_first_ring ? first_ring : second_ring,
+                std::move(endpoint.send_doorbell));
+  receive_ring_ =
+      make_ring(endpoint.sends_to_first_ring ? second_ring : first_ring,
+                std::move(endpoint.receive_doorbell));
+}
+
+SharedMemorySyncSocket::~SharedMemorySyncSocket() {
+  Close();
+}
+
+bool SharedMemorySyncSocket::IsValid() const {
+  return mapping_.IsValid() && send_ring_.doorbell &&
+         send_ring_.doorbell->IsValid() && receive_ring_.doorbell &&
+         receive_ring_.doorbell->IsValid();
+}
+
+size_t SharedMemorySyncSocket::Send(span<const uint8_t> data) {
+  DCHECK(IsValid());
+  RingControl& control = *send_ring_.control;
+  const size_t capacity = send_ring_.data.size();
+  size_t bytes_sent = 0;
+  while (!data.empty()) {
+    if (control.closed.load(std::memory_order_acquire)) {
+      break;
+    }
+    const uint64_t write_position =
+        control.write_position.load(std::memory_order_relaxed);
+    // Acquires the receiver's reads of the space to write to.
+    const std::optional<size_t> size = GetSize(
+        send_ring_, control.read_position.load(std::memory_order_acquire),
+        write_position);
+    if (!size) {
+      break;
+    }
+    if (*size == capacity) {
+      if (!Wait(send_ring_, control.sender_waiting, [&] {
+            return control.read_position.load() != write_position - capacity;
+          })) {
+        break;
+      }
+      continue;
+    }
+
+    // Copy as much as fits, in up to two parts around the end of the ring.
+    const size_t offset = static_cast<size_t>(write_position % capacity);
+    const size_t length = std::min(capacity - *size, data.size());
+    const size_t first_length = std::min(length, capacity - offset);
+    send_ring_.data.subspan(offset, first_length)
+        .copy_from(data.first(first_length));
+    send_ring_.data.first(length - first_length)
+        .copy_from(data.subspan(first_length, length - first_length));
+    data = data.subspan(length);
+    bytes_sent += length;
+
+    // Releases the data to the receiver. This is sequentially consistent with
+    // the receiver's announcement that it waits, so that either this sees it,
+    // or the receiver sees the data.
+    control.write_position.store(write_position + length);
+    WakeUp(send_ring_, control.receiver_waiting);
+  }
+  return bytes_sent;
+}
+
+size_t SharedMemorySyncSocket::Receive(span<uint8_t> buffer) {
+  DCHECK(IsValid());
+  RingControl& control = *receive_ring_.control;
+  const size_t capacity = receive_ring_.data.size();
+  size_t bytes_received = 0;
+  while (!buffer.empty()) {
+    const uint64_t read_position =
+        control.read_position.load(std::memory_order_relaxed);
+    // Acquires the data written by the sender.
+    const std::optional<size_t> size = GetSize(
+        receive_ring_, read_position,
+        control.write_position.load(std::memory_order_acquire));
+    if (!size) {
+      break;
+    }
+    if (*size == 0) {
+      // The data sent before closing is received first.
+      if (control.closed.load(std::memory_order_acquire) ||
+          !Wait(receive_ring_, control.receiver_waiting, [&] {
+            return control.write_position.load() != read_position ||
+                   control.closed.load();
+          })) {
+        break;
+      }
+      continue;
+    }
+
+    const size_t offset = static_cast<size_t>(read_position % capacity);
+    const size_t length = std::min(*size, buffer.size());
+    const size_t first_length = std::min(length, capacity - offset);
+    buffer.first(first_length)
+        .copy_from(receive_ring_.data.subspan(offset, first_length));
+    buffer.subspan(first_length, length - first_length)
+        .copy_from(receive_ring_.data.first(length - first_length));
+    buffer = buffer.subspan(length);
+    bytes_received += length;
+
+    // Releases the space to the sender, as Send() releases the data.
+    control.read_position.store(read_position + length);
+    WakeUp(receive_ring_, control.sender_waiting);
+  }
+  return bytes_received;
+}
+
+size_t SharedMemorySyncSocket::Peek() {
+  DCHECK(IsValid());
+  const RingControl& control = *receive_ring_.control;
+  return GetSize(receive_ring_,
+                 control.read_position.load(std::memory_order_relaxed),
+                 control.write_position.load(std::memory_order_acquire))
+      .value_or(0);
+}
+
+void SharedMemorySyncSocket::Close() {
+  if (!mapping_.IsValid()) {
+    return;
+  }
+  send_ring_.control->closed.store(1, std::memory_order_release);
+  receive_ring_.control->closed.store(1, std::memory_order_release);
+  // Closing the doorbells wakes up the peer if it waits.
+  send_ring_ = Ring();
+  receive_ring_ = Ring();
+  mapping_ = WritableSharedMemoryMapping();
+}
+
+// static
+std::optional<size_t> SharedMemorySyncSocket::GetSize(
+    const Ring& ring,
+    uint64_t read_position,
+    uint64_t write_position) {
+  // The positions only grow, and the writer stays at most a ring ahead.
+  const uint64_t size = write_position - read_position;
+  if (write_position < read_position || size > ring.data.size()) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(size);
+}
+
+// static
+template <typename ReadyFunction>
+bool SharedMemorySyncSocket::Wait(Ring& ring,
+                                  std::atomic<uint32_t>& waiting,
+                                  ReadyFunction ready) {
+  // Announce the wait before checking again, sequentially consistent with the
+  // peer's update and check of `waiting`, so that the peer either sees the
+  // announcement and rings the doorbell, or its update is seen here.
+  waiting.store(1);
+  uint8_t byte;
+  if (!ready()) {
+    return ring.doorbell->Receive(byte_span_from_ref(byte)) == 1;
+  }
+  // The peer may have seen the announcement already, in which case the
+  // doorbell rings, and must be consumed so as not to wake up the next wait.
+  if (waiting.exchange(0) == 0) {
+    return ring.doorbell->Receive(byte_span_from_ref(byte)) == 1;
+  }
+  return true;
+}
+
+// static
+void SharedMemorySyncSocket::WakeUp(Ring& ring,
+                                    std::atomic<uint32_t>& waiting) {
+  if (waiting.load() && waiting.exchange(0)) {
+    const uint8_t byte = 0;
+    ring.doorbell->Send(byte_span_from_ref(byte));
+  }
+}
+
+}  // namespace base
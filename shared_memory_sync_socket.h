@@ -0,0 +1,139 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SHARED_MEMORY_SYNC_SOCKET_H_
+#define BASE_SHARED_MEMORY_SYNC_SOCKET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/raw_span.h"
+#include "base/memory/shared_memory_mapping.h"
+#include "base/memory/unsafe_shared_memory_region.h"
+#include "base/sync_socket.h"
+
+namespace base {
+
+// A connected pair of byte streams with the blocking Send() and Receive() of
+// SyncSocket, which carries the data through a single-producer,
+// single-consumer ring buffer per direction in shared memory rather than
+// through the kernel. An end only makes a system call when it has to wait,
+// because the ring it receives from is empty or the one it sends to is full,
+// and to wake up a peer waiting for such a ring: on the hot path of a
+// real-time channel, where the receiver keeps up, Send() and Receive() are
+// just copies.
+//
+// The waits and wakeups go through a SyncSocket per direction, which carries
+// one byte per wakeup and lets the ends be in different processes.
+//
+// Like SyncSocket, an end may be used by one thread sending and another one
+// receiving, but not by several threads sending or several threads receiving
+// at once. The memory is shared with the peer, which may be untrusted: its
+// positions in the rings are validated, and a peer which corrupts them makes
+// Send() and Receive() fail rather than read or write out of bounds.
+class BASE_EXPORT SharedMemorySyncSocket {
+ public:
+  // The state of one end of a pair, e.g. to pass it to another process.
+  struct BASE_EXPORT Endpoint {
+    Endpoint();
+    Endpoint(Endpoint&&);
+    Endpoint& operator=(Endpoint&&);
+    ~Endpoint();
+
+    // The rings of both directions.
+    UnsafeSharedMemoryRegion region;
+    // Whether this end sends to the first ring of `region`, and receives from
+    // the second.
+    bool sends_to_first_ring = false;
+    // The SyncSockets to wait on and wake up the peer with, for the ring this
+    // end sends to and for the one it receives from.
+    SyncSocket::ScopedHandle send_doorbell;
+    SyncSocket::ScopedHandle receive_doorbell;
+  };
+
+  // Returns the ends of a new pair, which can each buffer up to `capacity`
+  // bytes in each direction, or nullopt on failure.
+  static std::optional<std::pair<Endpoint, Endpoint>> CreatePair(
+      size_t capacity);
+
+  // Connects to the peer of `endpoint`. IsValid() returns false if its memory
+  // can't be mapped.
+  explicit SharedMemorySyncSocket(Endpoint endpoint);
+  SharedMemorySyncSocket(const SharedMemorySyncSocket&) = delete;
+  SharedMemorySyncSocket& operator=(const SharedMemorySyncSocket&) = delete;
+  // Closes the socket.
+  ~SharedMemorySyncSocket();
+
+  bool IsValid() const;
+
+  // Sends `data`, blocking while the ring is full. Returns the number of
+  // bytes sent, which is less than the size of `data` only if the socket was
+  // closed at either end, or the memory corrupted.
+  size_t Send(span<const uint8_t> data);
+
+  // Receives data until `buffer` is full, blocking while the ring is empty.
+  // Returns the number of bytes received, which is less than the size of
+  // `buffer` only if the socket was closed at either end and all of the data
+  // sent before was received, or the memory corrupted.
+  size_t Receive(span<uint8_t> buffer);
+
+  // Returns the number of bytes which can be received without blocking.
+  size_t Peek();
+
+  // Closes the socket, which makes the peer's Send() fail and its Receive()
+  // return once it has received the data already sent. Must not be called
+  // while this end is sending or receiving on another thread.
+  void Close();
+
+ private:
+  struct RingControl;
+
+  // One direction of the pair: the control block and data of a ring, and the
+  // doorbell of this end for it.
+  struct Ring {
+    Ring();
+    Ring(Ring&&);
+    Ring& operator=(Ring&&);
+    ~Ring();
+
+    raw_ptr<RingControl> control = nullptr;
+    raw_span<uint8_t> data;
+    // SyncSocket can't be moved.
+    std::unique_ptr<SyncSocket> doorbell;
+  };
+
+  // Returns the number of bytes in `ring` between `read_position` and
+  // `write_position`, or nullopt if the positions are corrupt.
+  static std::optional<size_t> GetSize(const Ring& ring,
+                                       uint64_t read_position,
+                                       uint64_t write_position);
+
+  // Waits for the ring's doorbell, after announcing it in `waiting` and
+  // checking again that `ready()` is false. Returns false if the peer closed
+  // the doorbell.
+  template <typename ReadyFunction>
+  static bool Wait(Ring& ring,
+                   std::atomic<uint32_t>& waiting,
+                   ReadyFunction ready);
+
+  // Rings the ring's doorbell if the peer announced in `waiting` that it waits
+  // for it.
+  static void WakeUp(Ring& ring, std::atomic<uint32_t>& waiting);
+
+  WritableSharedMemoryMapping mapping_;
+  Ring send_ring_;
+  Ring receive_ring_;
+};
+
+}  // namespace base
+
+#endif  // BASE_SHARED_MEMORY_SYNC_SOCKET_H_
@@ -0,0 +1,166 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/shared_memory_sync_socket.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/functional/callback.h"
+#include "base/memory/shared_memory_mapping.h"
+#include "base/test/bind.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Creates a connected pair of sockets, with `capacity` bytes per direction.
+std::pair<std::unique_ptr<SharedMemorySyncSocket>,
+          std::unique_ptr<SharedMemorySyncSocket>>
+CreatePair(size_t capacity) {
+  std::optional<std::pair<SharedMemorySyncSocket::Endpoint,
+                          SharedMemorySyncSocket::Endpoint>>
+      endpoints = SharedMemorySyncSocket::CreatePair(capacity);
+  CHECK(endpoints);
+  auto a = std::make_unique<SharedMemorySyncSocket>(
+      std::move(endpoints->first));
+  auto b = std::make_unique<SharedMemorySyncSocket>(
+      std::move(endpoints->second));
+  CHECK(a->IsValid());
+  CHECK(b->IsValid());
+  return {std::move(a), std::move(b)};
+}
+
+// Runs a closure on a thread of its own.
+class ClosureThread : public SimpleThread {
+ public:
+  explicit ClosureThread(OnceClosure closure)
+      : SimpleThread("ClosureThread"), closure_(std::move(closure)) {
+    Start();
+  }
+
+  void Run() override { std::move(closure_).Run(); }
+
+ private:
+  OnceClosure closure_;
+};
+
+}  // namespace
+
+TEST(SharedMemorySyncSocketTest, SendReceivePeek) {
+  auto [a, b] = CreatePair(64);
+  const int kSending = 123;
+  int received = 0;
+
+  EXPECT_EQ(0u, b->Peek());
+  EXPECT_EQ(sizeof(kSending), a->Send(byte_span_from_ref(kSending)));
+  EXPECT_EQ(sizeof(kSending), b->Peek());
+  EXPECT_EQ(sizeof(received), b->Receive(byte_span_from_ref(received)));
+  EXPECT_EQ(kSending, received);
+  EXPECT_EQ(0u, b->Peek());
+
+  // And the other way around.
+  EXPECT_EQ(sizeof(kSending), b->Send(byte_span_from_ref(kSending)));
+  EXPECT_EQ(0u, b->Peek());
+  EXPECT_EQ(sizeof(kSending), a->Peek());
+  received = 0;
+  EXPECT_EQ(sizeof(received), a->Receive(byte_span_from_ref(received)));
+  EXPECT_EQ(kSending, received);
+}
+
+// Sends much more data than the rings hold, so that both ends wait and wake
+// each other up, and the data wraps around the end of the rings.
+TEST(SharedMemorySyncSocketTest, StreamThroughSmallRing) {
+  auto [a, b] = CreatePair(100);
+  std::vector<uint8_t> data(1000 * 1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 31);
+  }
+
+  ClosureThread sender(BindLambdaForTesting([&, &a = a] {
+    // Odd sizes, so that the writes don't line up with the ring.
+    span<const uint8_t> remaining(data);
+    while (!remaining.empty()) {
+      const size_t size = std::min<size_t>(remaining.size(), 77);
+      ASSERT_EQ(size, a->Send(remaining.first(size)));
+      remaining = remaining.subspan(size);
+    }
+  }));
+
+  std::vector<uint8_t> received(data.size());
+  span<uint8_t> remaining(received);
+  while (!remaining.empty()) {
+    const size_t size = std::min<size_t>(remaining.size(), 1234);
+    ASSERT_EQ(size, b->Receive(remaining.first(size)));
+    remaining = remaining.subspan(size);
+  }
+  sender.Join();
+  EXPECT_EQ(data, received);
+}
+
+TEST(SharedMemorySyncSocketTest, CloseWakesUpReceiver) {
+  auto [a, b] = CreatePair(64);
+  const int kSending = 123;
+  ASSERT_EQ(sizeof(kSending), a->Send(byte_span_from_ref(kSending)));
+
+  ClosureThread closer(BindLambdaForTesting([&, &a = a] {
+    // Let the receiver wait.
+    PlatformThread::Sleep(Milliseconds(10));
+    a->Close();
+  }));
+  // The data sent before closing is received, and then the rest fails.
+  int received[2] = {};
+  EXPECT_EQ(sizeof(kSending), b->Receive(as_writable_byte_span(received)));
+  EXPECT_EQ(kSending, received[0]);
+  closer.Join();
+
+  EXPECT_EQ(0u, b->Send(byte_span_from_ref(kSending)));
+}
+
+TEST(SharedMemorySyncSocketTest, CloseWakesUpSender) {
+  auto [a, b] = CreatePair(64);
+  std::vector<uint8_t> data(1000);
+
+  ClosureThread closer(BindLambdaForTesting([&, &b = b] {
+    // Let the sender wait.
+    PlatformThread::Sleep(Milliseconds(10));
+    b->Close();
+  }));
+  // Only what fits in the ring is sent.
+  EXPECT_EQ(64u, a->Send(data));
+  closer.Join();
+}
+
+TEST(SharedMemorySyncSocketTest, CorruptPositions) {
+  std::optional<std::pair<SharedMemorySyncSocket::Endpoint,
+                          SharedMemorySyncSocket::Endpoint>>
+      endpoints = SharedMemorySyncSocket::CreatePair(64);
+  ASSERT_TRUE(endpoints);
+  WritableSharedMemoryMapping mapping = endpoints->first.region.Map();
+  ASSERT_TRUE(mapping.IsValid());
+  SharedMemorySyncSocket a(std::move(endpoints->first));
+  SharedMemorySyncSocket b(std::move(endpoints->second));
+
+  // A write position further ahead of the read position than the ring holds,
+  // as by a compromised peer.
+  span<uint8_t> memory = mapping.GetMemoryAsSpan<uint8_t>();
+  const uint64_t write_position = 65;
+  memory.first(sizeof(uint64_t)).copy_from(byte_span_from_ref(write_position));
+  uint8_t buffer[8];
+  EXPECT_EQ(0u, b.Receive(buffer));
+  EXPECT_EQ(0u, b.Peek());
+  EXPECT_EQ(0u, a.Send(buffer));
+}
+
+}  // namespace base
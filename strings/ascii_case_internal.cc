@@ -0,0 +1,281 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifdef UNSAFE_BUFFERS_BUILD
+// TODO(crbug.com/40284755): Remove this and spanify to fix the errors.
+#pragma allow_unsafe_buffers
+#endif
+
+#include "base/strings/ascii_case_internal.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <bit>
+#include <string_view>
+
+#include "base/check_op.h"
+#include "base/strings/string_util_internal.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace base::internal {
+
+namespace {
+
+char ToUpperAsciiChar(char c) {
+  return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+}
+
+template <bool kToLower>
+void ConvertCaseScalar(const char* src, char* dst, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    dst[i] = kToLower ? ToLowerASCII(src[i]) : ToUpperAsciiChar(src[i]);
+  }
+}
+
+size_t MismatchScalar(const char* a, const char* b, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    if (ToLowerASCII(a[i]) != ToLowerASCII(b[i])) {
+      return i;
+    }
+  }
+  return size;
+}
+
+#if defined(ARCH_CPU_X86_64) || \
+    (defined(ARCH_CPU_ARM64) && defined(__ARM_NEON))
+
+// SSE2 is part of the x86-64 baseline, so this needs no CPU check.
+#if defined(ARCH_CPU_X86_64)
+
+using Vector = __m128i;
+
+// EqualMask() sets this many bits for each byte.
+constexpr size_t kBitsPerByte = 1;
+constexpr uint64_t kAllEqual = 0xFFFF;
+
+Vector Load(const char* src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+void Store(char* dst, Vector v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+}
+
+Vector Splat(char c) {
+  return _mm_set1_epi8(c);
+}
+
+// Returns 0x20 in the bytes of `v` which are in [`lo`, `hi`], and 0 in the
+// others.
+Vector CaseBitInRange(Vector v, char lo, char hi) {
+  // Bytes above 0x7F are negative, and so out of any ASCII range.
+  const Vector in_range = _mm_and_si128(
+      _mm_cmpgt_epi8(v, Splat(static_cast<char>(lo - 1))),
+      _mm_cmplt_epi8(v, Splat(static_cast<char>(hi + 1))));
+  return _mm_and_si128(in_range, Splat(0x20));
+}
+
+Vector Lower(Vector v) {
+  return _mm_or_si128(v, CaseBitInRange(v, 'A', 'Z'));
+}
+
+Vector Upper(Vector v) {
+  return _mm_xor_si128(v, CaseBitInRange(v, 'a', 'z'));
+}
+
+uint64_t EqualMask(Vector a, Vector b) {
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+}
+
+#else
+
+using Vector = uint8x16_t;
+
+constexpr size_t kBitsPerByte = 4;
+constexpr uint64_t kAllEqual = ~uint64_t{0};
+
+Vector Load(const char* src) {
+  return vld1q_u8(reinterpret_cast<const uint8_t*>(src));
+}
+
+void Store(char* dst, Vector v) {
+  vst1q_u8(reinterpret_cast<uint8_t*>(dst), v);
+}
+
+Vector Splat(char c) {
+  return vdupq_n_u8(static_cast<uint8_t>(c));
+}
+
+Vector CaseBitInRange(Vector v, char lo, char hi) {
+  // The subtraction wraps around, so that one unsigned comparison checks both
+  // ends of the range.
+  const Vector in_range = vcleq_u8(vsubq_u8(v, Splat(lo)),
+                                   vdupq_n_u8(static_cast<uint8_t>(hi - lo)));
+  return vandq_u8(in_range, vdupq_n_u8(0x20));
+}
+
+Vector Lower(Vector v) {
+  return vorrq_u8(v, CaseBitInRange(v, 'A', 'Z'));
+}
+
+Vector Upper(Vector v) {
+  return veorq_u8(v, CaseBitInRange(v, 'a', 'z'));
+}
+
+uint64_t EqualMask(Vector a, Vector b) {
+  // Narrows each byte of the comparison to a nibble.
+  const uint8x8_t narrowed =
+      vshrn_n_u16(vreinterpretq_u16_u8(vceqq_u8(a, b)), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+#endif  // defined(ARCH_CPU_X86_64)
+
+constexpr size_t kVectorSize = 16;
+
+template <bool kToLower>
+void ConvertCase(const char* src, char* dst, size_t size) {
+  if (size < kVectorSize) {
+    ConvertCaseScalar<kToLower>(src, dst, size);
+    return;
+  }
+  for (size_t i = 0; i + kVectorSize <= size; i += kVectorSize) {
+    const Vector v = Load(src + i);
+    Store(dst + i, kToLower ? Lower(v) : Upper(v));
+  }
+  // The last vector may overlap the previous one. That is harmless even when
+  // converting in place, as converting twice gives the same result.
+  const Vector v = Load(src + size - kVectorSize);
+  Store(dst + size - kVectorSize, kToLower ? Lower(v) : Upper(v));
+}
+
+size_t Mismatch(const char* a, const char* b, size_t size) {
+  if (size < kVectorSize) {
+    return MismatchScalar(a, b, size);
+  }
+  size_t i = 0;
+  while (true) {
+    const uint64_t equal = EqualMask(Lower(Load(a + i)), Lower(Load(b + i)));
+    if (equal != kAllEqual) {
+      return i + static_cast<size_t>(std::countr_zero(~equal)) / kBitsPerByte;
+    }
+    if (i + kVectorSize == size) {
+      return size;
+    }
+    // The last vector may overlap the previous one, which is known to match.
+    i = std::min(i + kVectorSize, size - kVectorSize);
+  }
+}
+
+size_t Find(const char* haystack,
+            size_t haystack_size,
+            const char* needle,
+            size_t needle_size) {
+  // Candidates are found by comparing the first and last characters of the
+  // needle with 16 positions at a time, and then checked in full. This is the
+  // "generic SIMD" substring search of Muła.
+  const Vector first = Splat(ToLowerASCII(needle[0]));
+  const Vector last = Splat(ToLowerASCII(needle[needle_size - 1]));
+  // The bits of a byte in EqualMask().
+  constexpr uint64_t kByteMask = (uint64_t{1} << kBitsPerByte) - 1;
+  size_t i = 0;
+  for (; i + needle_size - 1 + kVectorSize <= haystack_size;
+       i += kVectorSize) {
+    uint64_t candidates =
+        EqualMask(Lower(Load(haystack + i)), first) &
+        EqualMask(Lower(Load(haystack + i + needle_size - 1)), last);
+    while (candidates) {
+      const int bit = std::countr_zero(candidates);
+      const size_t offset = i + static_cast<size_t>(bit) / kBitsPerByte;
+      if (needle_size <= 2 || Mismatch(haystack + offset + 1, needle + 1,
+                                       needle_size - 2) == needle_size - 2) {
+        return offset;
+      }
+      candidates &= ~(kByteMask << bit);
+    }
+  }
+  for (; i + needle_size <= haystack_size; ++i) {
+    if (Mismatch(haystack + i, needle, needle_size) == needle_size) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+#else
+
+template <bool kToLower>
+void ConvertCase(const char* src, char* dst, size_t size) {
+  ConvertCaseScalar<kToLower>(src, dst, size);
+}
+
+size_t Mismatch(const char* a, const char* b, size_t size) {
+  return MismatchScalar(a, b, size);
+}
+
+size_t Find(const char* haystack,
+            size_t haystack_size,
+            const char* needle,
+            size_t needle_size) {
+  for (size_t i = 0; i + needle_size <= haystack_size; ++i) {
+    if (Mismatch(haystack + i, needle, needle_size) == needle_size) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+#endif
+
+}  // namespace
+
+void ToLowerAscii(std::string_view input, span<char> output) {
+  CHECK_EQ(input.size(), output.size());
+  ConvertCase</*kToLower=*/true>(input.data(), output.data(), input.size());
+}
+
+void ToUpperAscii(std::string_view input, span<char> output) {
+  CHECK_EQ(input.size(), output.size());
+  ConvertCase</*kToLower=*/false>(input.data(), output.data(), input.size());
+}
+
+size_t FindCaseInsensitiveMismatchAscii(std::string_view a,
+                                        std::string_view b) {
+  CHECK_EQ(a.size(), b.size());
+  return Mismatch(a.data(), b.data(), a.size());
+}
+
+size_t FindCaseInsensitiveAscii(std::string_view haystack,
+                                std::string_view needle) {
+  DCHECK(!needle.empty());
+  if (needle.size() > haystack.size()) {
+    return std::string_view::npos;
+  }
+  return Find(haystack.data(), haystack.size(), needle.data(), needle.size());
+}
+
+int CompareCaseInsensitiveAscii(std::string_view a, std::string_view b) {
+  const size_t length = std::min(a.size(), b.size());
+  const size_t i = Mismatch(a.data(), b.data(), length);
+  if (i < length) {
+    // Compares as unsigned so the order is independent of the signedness of
+    // `char`.
+    const auto lower_a = static_cast<unsigned char>(ToLowerASCII(a[i]));
+    const auto lower_b = static_cast<unsigned char>(ToLowerASCII(b[i]));
+    return lower_a < lower_b ? -1 : 1;
+  }
+  if (a.size() == b.size()) {
+    return 0;
+  }
+  return a.size() < b.size() ? -1 : 1;
+}
+
+}  // namespace base::internal
@@ -0,0 +1,50 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_STRINGS_ASCII_CASE_INTERNAL_H_
+#define BASE_STRINGS_ASCII_CASE_INTERNAL_H_
+
+#include <stddef.h>
+
+#include <string_view>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+
+// ASCII case folding kernels behind the 8-bit ToLowerASCII(), ToUpperASCII(),
+// CompareCaseInsensitiveASCII(), EqualsCaseInsensitiveASCII() and
+// FindCaseInsensitiveASCII(). They use SSE2 on x86-64, NEON on arm64, and
+// scalar loops elsewhere. Bytes outside A-Z and a-z, including non-ASCII ones,
+// are left as they are.
+
+namespace base::internal {
+
+// Writes the ASCII lowercase or uppercase of `input` to `output`, which must
+// be the same size. They may be the same buffer.
+BASE_EXPORT void ToLowerAscii(std::string_view input, span<char> output);
+BASE_EXPORT void ToUpperAscii(std::string_view input, span<char> output);
+
+// Returns the index of the first byte at which `a` and `b`, which must be the
+// same size, differ ignoring ASCII case, or their size if they don't.
+BASE_EXPORT size_t FindCaseInsensitiveMismatchAscii(std::string_view a,
+                                                    std::string_view b);
+
+// Returns the offset of the first occurrence of `needle`, which must not be
+// empty, in `haystack` ignoring ASCII case, or std::string_view::npos.
+BASE_EXPORT size_t FindCaseInsensitiveAscii(std::string_view haystack,
+                                            std::string_view needle);
+
+// Like CompareCaseInsensitiveASCII(): returns -1, 0 or 1.
+BASE_EXPORT int CompareCaseInsensitiveAscii(std::string_view a,
+                                            std::string_view b);
+
+inline bool EqualsCaseInsensitiveAscii(std::string_view a,
+                                       std::string_view b) {
+  return a.size() == b.size() &&
+         FindCaseInsensitiveMismatchAscii(a, b) == a.size();
+}
+
+}  // namespace base::internal
+
+#endif  // BASE_STRINGS_ASCII_CASE_INTERNAL_H_
@@ -0,0 +1,150 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/ascii_case_internal.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+
+#include "base/strings/string_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base::internal {
+
+namespace {
+
+// Vectors are 16 bytes; these sizes cover the scalar paths, whole vectors and
+// overlapping tails.
+constexpr size_t kMaxSize = 70;
+
+// Every byte value, repeated.
+std::string MakeAllBytes(size_t size) {
+  std::string str(size, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    str[i] = static_cast<char>(i * 7);
+  }
+  return str;
+}
+
+std::string ExpectedLower(std::string_view str) {
+  std::string expected(str);
+  for (char& c : expected) {
+    c = base::ToLowerASCII(c);
+  }
+  return expected;
+}
+
+std::string ExpectedUpper(std::string_view str) {
+  std::string expected(str);
+  for (char& c : expected) {
+    c = base::ToUpperASCII(c);
+  }
+  return expected;
+}
+
+}  // namespace
+
+TEST(AsciiCaseInternalTest, ConvertCase) {
+  for (size_t offset = 0; offset < 256; offset += 37) {
+    for (size_t size = 0; size <= kMaxSize; ++size) {
+      const std::string str = MakeAllBytes(offset + size).substr(offset);
+      std::string output(size, '\0');
+      ToLowerAscii(str, output);
+      EXPECT_EQ(ExpectedLower(str), output);
+      ToUpperAscii(str, output);
+      EXPECT_EQ(ExpectedUpper(str), output);
+
+      // In place.
+      output = str;
+      ToLowerAscii(output, output);
+      EXPECT_EQ(ExpectedLower(str), output);
+    }
+  }
+}
+
+TEST(AsciiCaseInternalTest, ConvertCaseAllBytes) {
+  const std::string str = MakeAllBytes(256 * 7);
+  std::string output(str.size(), '\0');
+  ToLowerAscii(str, output);
+  EXPECT_EQ(ExpectedLower(str), output);
+  ToUpperAscii(str, output);
+  EXPECT_EQ(ExpectedUpper(str), output);
+}
+
+TEST(AsciiCaseInternalTest, Mismatch) {
+  for (size_t size = 0; size <= kMaxSize; ++size) {
+    const std::string a = MakeAllBytes(size);
+    const std::string b = ExpectedUpper(a);
+    EXPECT_EQ(size, FindCaseInsensitiveMismatchAscii(a, b));
+    EXPECT_TRUE(EqualsCaseInsensitiveAscii(a, b));
+    EXPECT_EQ(0, CompareCaseInsensitiveAscii(a, b));
+
+    for (size_t i = 0; i < size; ++i) {
+      SCOPED_TRACE(testing::Message() << size << " " << i);
+      std::string c = b;
+      // Every byte has a different lowercase from its successor's.
+      c[i] = static_cast<char>(base::ToLowerASCII(c[i]) + 1);
+      EXPECT_EQ(i, FindCaseInsensitiveMismatchAscii(a, c));
+      EXPECT_FALSE(EqualsCaseInsensitiveAscii(a, c));
+      const int expected =
+          static_cast<unsigned char>(base::ToLowerASCII(a[i])) <
+                  static_cast<unsigned char>(base::ToLowerASCII(c[i]))
+              ? -1
+              : 1;
+      EXPECT_EQ(expected, CompareCaseInsensitiveAscii(a, c));
+      EXPECT_EQ(-expected, CompareCaseInsensitiveAscii(c, a));
+    }
+  }
+}
+
+TEST(AsciiCaseInternalTest, CompareLengths) {
+  const std::string a = MakeAllBytes(kMaxSize);
+  for (size_t size = 0; size < kMaxSize; ++size) {
+    const std::string prefix = ExpectedUpper(a.substr(0, size));
+    EXPECT_EQ(1, CompareCaseInsensitiveAscii(a, prefix));
+    EXPECT_EQ(-1, CompareCaseInsensitiveAscii(prefix, a));
+    EXPECT_FALSE(EqualsCaseInsensitiveAscii(a, prefix));
+  }
+}
+
+TEST(AsciiCaseInternalTest, Find) {
+  for (size_t haystack_size = 0; haystack_size <= kMaxSize; ++haystack_size) {
+    std::string haystack(haystack_size, 'x');
+    for (size_t needle_size = 1; needle_size <= haystack_size + 1;
+         ++needle_size) {
+      const std::string needle = "N" + std::string(needle_size - 1, 'e');
+      EXPECT_EQ(std::string_view::npos, FindCaseInsensitiveAscii(
+                                            haystack, needle));
+      for (size_t i = 0; i + needle_size <= haystack_size; ++i) {
+        SCOPED_TRACE(testing::Message()
+                     << haystack_size << " " << needle_size << " " << i);
+        std::string with_needle = haystack;
+        with_needle.replace(i, needle_size, ExpectedLower(needle));
+        // A near miss, which matches the first and last characters only,
+        // before the needle.
+        if (needle_size > 2 && i >= needle_size) {
+          with_needle.replace(i - needle_size, needle_size, needle);
+          with_needle[i - 2] = 'x';
+        }
+        const size_t expected = ExpectedLower(with_needle)
+                                    .find(ExpectedLower(needle));
+        EXPECT_EQ(expected, FindCaseInsensitiveAscii(with_needle, needle));
+      }
+    }
+  }
+}
+
+TEST(AsciiCaseInternalTest, FindNonAscii) {
+  const std::string haystack = std::string(40, 'x') + "\xC3\xA4xx";
+  EXPECT_EQ(40u, FindCaseInsensitiveAscii(haystack, "\xC3\xA4"));
+  EXPECT_EQ(std::string_view::npos,
+            FindCaseInsensitiveAscii(haystack, "\xC3\x84"));
+  // 0xC4 and 0xE4 differ in the ASCII case bit, but aren't ASCII.
+  EXPECT_EQ(std::string_view::npos,
+            FindCaseInsensitiveAscii(haystack, "\xE3\xA4"));
+}
+
+}  // namespace base::internal
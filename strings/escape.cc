@@ -14,6 +14,7 @@
 #include "base/check_op.h"
 #include "base/feature_list.h"
 #include "base/features.h"
+#include "base/strings/escape_internal.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
@@ -42,59 +43,140 @@ struct Charmap {
 // to +, otherwise, if spaces are in the charmap, they are converted to
 // %20. And if keep_escaped is true, %XX will be kept as it is, otherwise, if
 // '%' is in the charmap, it is converted to %25.
+//
+// The runs of characters which are copied as they are are appended in bulk,
+// to a string reserved to the exact size of the result.
 std::string Escape(StringPiece text,
                    const Charmap& charmap,
                    bool use_plus,
                    bool keep_escaped = false) {
+  // Returns whether |text[i]| isn't copied as it is.
+  auto is_special = [&](size_t i) {
+    const unsigned char c = static_cast<unsigned char>(text[i]);
+    return charmap.Contains(c) || (use_plus && ' ' == c);
+  };
+  // Returns whether the special |text[i]| is written as %XX.
+  auto is_percent_escaped = [&](size_t i) {
+    const unsigned char c = static_cast<unsigned char>(text[i]);
+    if (use_plus && ' ' == c) {
+      return false;
+    }
+    return !(keep_escaped && '%' == c && i + 2 < text.length() &&
+             IsHexDigit(text[i + 1]) && IsHexDigit(text[i + 2]));
+  };
+
+  size_t first_special = 0;
+  while (first_special < text.length() && !is_special(first_special)) {
+    ++first_special;
+  }
+  if (first_special == text.length()) {
+    return std::string(text);
+  }
+
+  size_t escaped_length = text.length();
+  for (size_t i = first_special; i < text.length(); ++i) {
+    if (is_special(i) && is_percent_escaped(i)) {
+      escaped_length += 2;
+    }
+  }
+
   std::string escaped;
-  escaped.reserve(text.length() * 3);
-  for (size_t i = 0; i < text.length(); ++i) {
-    unsigned char c = static_cast<unsigned char>(text[i]);
+  escaped.reserve(escaped_length);
+  size_t run_start = 0;
+  for (size_t i = first_special; i < text.length(); ++i) {
+    if (!is_special(i)) {
+      continue;
+    }
+    escaped.append(text.substr(run_start, i - run_start));
+    run_start = i + 1;
+    const unsigned char c = static_cast<unsigned char>(text[i]);
     if (use_plus && ' ' == c) {
       escaped.push_back('+');
-    } else if (keep_escaped && '%' == c && i + 2 < text.length() &&
-               IsHexDigit(text[i + 1]) && IsHexDigit(text[i + 2])) {
+    } else if (!is_percent_escaped(i)) {
       escaped.push_back('%');
-    } else if (charmap.Contains(c)) {
+    } else {
       escaped.push_back('%');
       AppendHexEncodedByte(c, escaped);
-    } else {
-      escaped.push_back(static_cast<char>(c));
     }
   }
+  escaped.append(text.substr(run_start));
+  DCHECK_EQ(escaped.length(), escaped_length);
   return escaped;
 }
 
+// The characters escaped by EscapeForHTML().
+constexpr StringPiece kCharsToEscapeForHTML = "<>&\"'";
+
+// Returns the replacement of |c| by EscapeForHTML(), or an empty string if it
+// isn't escaped.
+template <typename CharT>
+StringPiece GetHTMLReplacement(CharT c) {
+  switch (c) {
+    case '<':
+      return "&lt;";
+    case '>':
+      return "&gt;";
+    case '&':
+      return "&amp;";
+    case '"':
+      return "&quot;";
+    case '\'':
+      return "&#39;";
+    default:
+      return StringPiece();
+  }
+}
+
 // Convert a character |c| to a form that will not be mistaken as HTML.
 template <class str>
 void AppendEscapedCharForHTMLImpl(typename str::value_type c, str* output) {
-  static constexpr struct {
-    char key;
-    StringPiece replacement;
-  } kCharsToEscape[] = {
-      {'<', "&lt;"},   {'>', "&gt;"},   {'&', "&amp;"},
-      {'"', "&quot;"}, {'\'', "&#39;"},
-  };
-  for (const auto& char_to_escape : kCharsToEscape) {
-    if (c == char_to_escape.key) {
-      output->append(std::begin(char_to_escape.replacement),
-                     std::end(char_to_escape.replacement));
-      return;
+  const StringPiece replacement = GetHTMLReplacement(c);
+  if (replacement.empty()) {
+    output->push_back(c);
+    return;
+  }
+  output->append(std::begin(replacement), std::end(replacement));
+}
+
+// Returns the index of the first character of |input| at or after |begin|
+// which EscapeForHTML() replaces, or npos.
+size_t FindCharToEscapeForHTML(StringPiece input, size_t begin) {
+  const size_t found =
+      internal::FindFirstOfBytes(input.substr(begin), kCharsToEscapeForHTML);
+  return found == StringPiece::npos ? found : begin + found;
+}
+
+size_t FindCharToEscapeForHTML(StringPiece16 input, size_t begin) {
+  for (size_t i = begin; i < input.size(); ++i) {
+    if (!GetHTMLReplacement(input[i]).empty()) {
+      return i;
     }
   }
-  output->push_back(c);
+  return StringPiece16::npos;
 }
 
 // Convert |input| string to a form that will not be interpreted as HTML.
 template <typename T, typename CharT = typename T::value_type>
 std::basic_string<CharT> EscapeForHTMLImpl(T input) {
-  std::basic_string<CharT> result;
-  result.reserve(input.size());  // Optimize for no escaping.
+  size_t i = FindCharToEscapeForHTML(input, 0);
+  if (i == T::npos) {
+    return std::basic_string<CharT>(input);
+  }
 
-  for (auto c : input) {
-    AppendEscapedCharForHTMLImpl(c, &result);
+  size_t escaped_length = input.size();
+  for (size_t j = i; j != T::npos; j = FindCharToEscapeForHTML(input, j + 1)) {
+    escaped_length += GetHTMLReplacement(input[j]).size() - 1;
   }
 
+  std::basic_string<CharT> result;
+  result.reserve(escaped_length);
+  size_t run_start = 0;
+  for (; i != T::npos; i = FindCharToEscapeForHTML(input, i + 1)) {
+    result.append(input.substr(run_start, i - run_start));
+    AppendEscapedCharForHTMLImpl(input[i], &result);
+    run_start = i + 1;
+  }
+  result.append(input.substr(run_start));
   return result;
 }
 
@@ -402,8 +484,25 @@ std::string UnescapeURLWithAdjustmentsImpl(
   std::string result;
   result.reserve(escaped_text.length());
 
+  // Only '%', and '+' when it is replaced, are changed by unescaping: the runs
+  // of other characters are copied in bulk.
+  const StringPiece special_chars =
+      (rules & UnescapeRule::REPLACE_PLUS_WITH_SPACE) ? "%+" : "%";
+
   // Locations of adjusted text.
   for (size_t i = 0, max = escaped_text.size(); i < max;) {
+    if (escaped_text[i] != '%' && escaped_text[i] != '+') {
+      const size_t run_length =
+          internal::FindFirstOfBytes(escaped_text.substr(i), special_chars);
+      if (run_length == StringPiece::npos) {
+        result.append(escaped_text.substr(i));
+        break;
+      }
+      result.append(escaped_text.substr(i, run_length));
+      i += run_length;
+      continue;
+    }
+
     // Try to unescape the character.
     base_icu::UChar32 code_point;
     std::string unescaped;
@@ -0,0 +1,148 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifdef UNSAFE_BUFFERS_BUILD
+// TODO(crbug.com/40284755): Remove this and spanify to fix the errors.
+#pragma allow_unsafe_buffers
+#endif
+
+#include "base/strings/escape_internal.h"
+
+#include <stdint.h>
+
+#include <bit>
+#include <string_view>
+
+#include "base/check_op.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace base::internal {
+
+namespace {
+
+size_t FindFirstOfBytesScalar(const char* input,
+                              size_t begin,
+                              size_t size,
+                              std::string_view bytes) {
+  for (size_t i = begin; i < size; ++i) {
+    if (bytes.find(input[i]) != std::string_view::npos) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+#if defined(ARCH_CPU_X86_64) || \
+    (defined(ARCH_CPU_ARM64) && defined(__ARM_NEON))
+
+// SSE2 is part of the x86-64 baseline, so this needs no CPU check.
+#if defined(ARCH_CPU_X86_64)
+
+using Vector = __m128i;
+
+// Mask() sets this many bits for each byte.
+constexpr size_t kBitsPerByte = 1;
+
+Vector Load(const char* src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+Vector Splat(char c) {
+  return _mm_set1_epi8(c);
+}
+
+Vector Zero() {
+  return _mm_setzero_si128();
+}
+
+Vector Equal(Vector a, Vector b) {
+  return _mm_cmpeq_epi8(a, b);
+}
+
+Vector Or(Vector a, Vector b) {
+  return _mm_or_si128(a, b);
+}
+
+uint64_t Mask(Vector v) {
+  return static_cast<uint32_t>(_mm_movemask_epi8(v));
+}
+
+#else
+
+using Vector = uint8x16_t;
+
+constexpr size_t kBitsPerByte = 4;
+
+Vector Load(const char* src) {
+  return vld1q_u8(reinterpret_cast<const uint8_t*>(src));
+}
+
+Vector Splat(char c) {
+  return vdupq_n_u8(static_cast<uint8_t>(c));
+}
+
+Vector Zero() {
+  return vdupq_n_u8(0);
+}
+
+Vector Equal(Vector a, Vector b) {
+  return vceqq_u8(a, b);
+}
+
+Vector Or(Vector a, Vector b) {
+  return vorrq_u8(a, b);
+}
+
+uint64_t Mask(Vector v) {
+  // Narrows each byte to a nibble.
+  const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+#endif  // defined(ARCH_CPU_X86_64)
+
+constexpr size_t kVectorSize = 16;
+
+size_t FindFirstOf(const char* input, size_t size, std::string_view bytes) {
+  Vector needles[kMaxFindFirstOfBytes];
+  for (size_t j = 0; j < bytes.size(); ++j) {
+    needles[j] = Splat(bytes[j]);
+  }
+  size_t i = 0;
+  for (; i + kVectorSize <= size; i += kVectorSize) {
+    const Vector v = Load(input + i);
+    Vector found = Zero();
+    for (size_t j = 0; j < bytes.size(); ++j) {
+      found = Or(found, Equal(v, needles[j]));
+    }
+    if (const uint64_t mask = Mask(found)) {
+      return i + static_cast<size_t>(std::countr_zero(mask)) / kBitsPerByte;
+    }
+  }
+  return FindFirstOfBytesScalar(input, i, size, bytes);
+}
+
+#else
+
+size_t FindFirstOf(const char* input, size_t size, std::string_view bytes) {
+  return FindFirstOfBytesScalar(input, 0, size, bytes);
+}
+
+#endif
+
+}  // namespace
+
+size_t FindFirstOfBytes(std::string_view input, std::string_view bytes) {
+  DCHECK(!bytes.empty());
+  CHECK_LE(bytes.size(), kMaxFindFirstOfBytes);
+  return FindFirstOf(input.data(), input.size(), bytes);
+}
+
+}  // namespace base::internal
@@ -0,0 +1,31 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_STRINGS_ESCAPE_INTERNAL_H_
+#define BASE_STRINGS_ESCAPE_INTERNAL_H_
+
+#include <stddef.h>
+
+#include <string_view>
+
+#include "base/base_export.h"
+
+// The scanning kernel behind EscapeForHTML() and UnescapeURLComponent(),
+// which copy the runs of characters that need no escaping or unescaping in
+// bulk. It uses SSE2 on x86-64, NEON on arm64, and a scalar loop elsewhere.
+
+namespace base::internal {
+
+// The maximum size of the `bytes` of FindFirstOfBytes().
+inline constexpr size_t kMaxFindFirstOfBytes = 8;
+
+// Returns the index of the first byte of `input` which is one of `bytes`, or
+// std::string_view::npos. `bytes` must not be empty, nor have more than
+// kMaxFindFirstOfBytes bytes.
+BASE_EXPORT size_t FindFirstOfBytes(std::string_view input,
+                                    std::string_view bytes);
+
+}  // namespace base::internal
+
+#endif  // BASE_STRINGS_ESCAPE_INTERNAL_H_
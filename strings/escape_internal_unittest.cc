@@ -0,0 +1,51 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/escape_internal.h"
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base::internal {
+
+namespace {
+
+// Vectors are 16 bytes; these sizes cover the scalar tails and several
+// vectors.
+constexpr size_t kMaxSize = 70;
+
+}  // namespace
+
+TEST(EscapeInternalTest, FindFirstOfBytes) {
+  constexpr std::string_view kBytes = "<>&\"'";
+  for (size_t size = 0; size <= kMaxSize; ++size) {
+    std::string input(size, 'x');
+    EXPECT_EQ(std::string_view::npos, FindFirstOfBytes(input, kBytes));
+    for (size_t i = 0; i < size; ++i) {
+      SCOPED_TRACE(testing::Message() << size << " " << i);
+      std::string with_byte = input;
+      with_byte[i] = kBytes[i % kBytes.size()];
+      EXPECT_EQ(i, FindFirstOfBytes(with_byte, kBytes));
+      // A later match doesn't hide the first one.
+      with_byte.back() = '&';
+      EXPECT_EQ(i, FindFirstOfBytes(with_byte, kBytes));
+    }
+  }
+}
+
+TEST(EscapeInternalTest, FindFirstOfBytesNonASCII) {
+  constexpr std::string_view kBytes = "\x80\xff";
+  std::string input(kMaxSize, '\x7f');
+  EXPECT_EQ(std::string_view::npos, FindFirstOfBytes(input, kBytes));
+  input[33] = '\xff';
+  EXPECT_EQ(33u, FindFirstOfBytes(input, kBytes));
+  input[17] = '\x80';
+  EXPECT_EQ(17u, FindFirstOfBytes(input, kBytes));
+}
+
+}  // namespace base::internal
@@ -0,0 +1,104 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/escape.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+
+#include "base/debug/alias.h"
+#include "base/functional/function_ref.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricThroughput[] = "throughput";
+
+// A link of a typical page, with a query that needs some escaping.
+constexpr char kUrl[] =
+    "https://www.example.com/search/results/page?q=escape functions&lang=en"
+    "&session=0123456789abcdef&ref=/home/index.html#section-2";
+// Text of a typical page, with a few characters to escape for HTML.
+constexpr char kText[] =
+    "The quick brown fox jumps over the lazy dog, and then it's <b>gone</b> "
+    "before anyone notices that the dog & the fox were friends all along.";
+
+// Runs `function`, which processes `len` bytes, on at least 64 MB in total,
+// and reports its throughput in MB per second.
+void RunEscapePerfTest(const char* function_name,
+                       const char* story,
+                       size_t len,
+                       FunctionRef<void()> function) {
+  perf_test::PerfResultReporter reporter(function_name, story);
+  reporter.RegisterImportantMetric(kMetricThroughput, "MB/s");
+
+  const size_t num_runs = std::max<size_t>(1, (64u << 20) / len);
+  const TimeTicks start_time = TimeTicks::Now();
+  for (size_t i = 0; i < num_runs; ++i) {
+    function();
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - start_time;
+
+  // Bytes per microsecond are MB/s.
+  reporter.AddResult(kMetricThroughput,
+                     len * num_runs / elapsed.InMicrosecondsF());
+}
+
+}  // namespace
+
+TEST(EscapePerfTest, EscapeQueryParamValue) {
+  const std::string url(kUrl);
+  RunEscapePerfTest("EscapeQueryParamValue", "url", url.size(), [&] {
+    std::string escaped = EscapeQueryParamValue(url, /*use_plus=*/true);
+    debug::Alias(&escaped);
+  });
+  const std::string safe(1000, 'a');
+  RunEscapePerfTest("EscapeQueryParamValue", "nothing_to_escape", safe.size(),
+                    [&] {
+                      std::string escaped =
+                          EscapeQueryParamValue(safe, /*use_plus=*/true);
+                      debug::Alias(&escaped);
+                    });
+}
+
+TEST(EscapePerfTest, EscapeForHTML) {
+  const std::string text(kText);
+  RunEscapePerfTest("EscapeForHTML", "text", text.size(), [&] {
+    std::string escaped = EscapeForHTML(text);
+    debug::Alias(&escaped);
+  });
+  const std::u16string text16(std::begin(kText), std::end(kText) - 1);
+  RunEscapePerfTest("EscapeForHTML", "text16", text16.size() * 2, [&] {
+    std::u16string escaped = EscapeForHTML(text16);
+    debug::Alias(&escaped);
+  });
+}
+
+TEST(EscapePerfTest, UnescapeURLComponent) {
+  const std::string escaped =
+      EscapeQueryParamValue(std::string(kUrl) + "/caf\xC3\xA9",
+                            /*use_plus=*/true);
+  RunEscapePerfTest("UnescapeURLComponent", "url", escaped.size(), [&] {
+    std::string unescaped = UnescapeURLComponent(
+        escaped, UnescapeRule::SPACES | UnescapeRule::PATH_SEPARATORS |
+                     UnescapeRule::URL_SPECIAL_CHARS_EXCEPT_PATH_SEPARATORS |
+                     UnescapeRule::REPLACE_PLUS_WITH_SPACE);
+    debug::Alias(&unescaped);
+  });
+  const std::string plain(1000, 'a');
+  RunEscapePerfTest("UnescapeURLComponent", "nothing_to_unescape",
+                    plain.size(), [&] {
+                      std::string unescaped = UnescapeURLComponent(
+                          plain, UnescapeRule::NORMAL);
+                      debug::Alias(&unescaped);
+                    });
+}
+
+}  // namespace base
@@ -137,6 +137,30 @@ TEST(EscapeTest, EscapeForHTML) {
   }
 }
 
+// Long strings are scanned several bytes at a time, with the runs of
+// characters which aren't escaped copied in bulk.
+TEST(EscapeTest, EscapeLongStrings) {
+  const std::string run(40, 'x');
+  EXPECT_EQ(run, EscapeForHTML(run));
+  EXPECT_EQ(run + "&lt;" + run + "&amp;&quot;" + run,
+            EscapeForHTML(run + "<" + run + "&\"" + run));
+  EXPECT_EQ(u"&#39;" + ASCIIToUTF16(run) + u"&gt;",
+            EscapeForHTML(u"'" + ASCIIToUTF16(run) + u">"));
+
+  EXPECT_EQ(run, EscapeQueryParamValue(run, /*use_plus=*/true));
+  EXPECT_EQ(run + "+%26" + run + "%25",
+            EscapeQueryParamValue(run + " &" + run + "%", /*use_plus=*/true));
+
+  EXPECT_EQ(run, UnescapeURLComponent(run, UnescapeRule::NORMAL));
+  EXPECT_EQ(run + "a b" + run + "+",
+            UnescapeURLComponent(run + "a%20b" + run + "+",
+                                 UnescapeRule::SPACES));
+  EXPECT_EQ(run + " " + run + "/",
+            UnescapeURLComponent(run + "+" + run + "%2F",
+                                 UnescapeRule::REPLACE_PLUS_WITH_SPACE |
+                                     UnescapeRule::PATH_SEPARATORS));
+}
+
 TEST(EscapeTest, UnescapeForHTML) {
   const EscapeForHTMLCase tests[] = {
       {"", ""},
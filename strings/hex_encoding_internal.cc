@@ -0,0 +1,244 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifdef UNSAFE_BUFFERS_BUILD
+// TODO(crbug.com/40284755): Remove this and spanify to fix the errors.
+#pragma allow_unsafe_buffers
+#endif
+
+#include "base/strings/hex_encoding_internal.h"
+
+#include "base/check_op.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace base::internal {
+
+namespace {
+
+#if defined(ARCH_CPU_X86_64)
+
+// SSE2 is part of the x86-64 baseline, so these need no CPU check.
+
+// Maps each nibble of `nibbles` to its hex digit.
+__m128i NibblesToDigits(__m128i nibbles, HexCase hex_case) {
+  // The distance from '9' + 1 to the first letter.
+  const char letter_offset = hex_case == HexCase::kUpper ? 'A' - '0' - 10
+                                                         : 'a' - '0' - 10;
+  const __m128i is_letter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+  return _mm_add_epi8(
+      _mm_add_epi8(nibbles, _mm_set1_epi8('0')),
+      _mm_and_si128(is_letter, _mm_set1_epi8(letter_offset)));
+}
+
+// Returns 0xFF in the bytes of `chars` which are in [`lo`, `hi`], which must
+// be ASCII, and 0 in the others.
+__m128i InRange(__m128i chars, char lo, char hi) {
+  // Bytes above 0x7F are negative, and so out of any ASCII range.
+  return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(lo - 1)),
+                       _mm_cmpgt_epi8(_mm_set1_epi8(hi + 1), chars));
+}
+
+// Decodes 16 hex digits into the low bytes of the 16-bit lanes of the result,
+// or returns false.
+bool DecodeDigits(__m128i chars, HexCase hex_case, __m128i* bytes) {
+  const __m128i is_digit = InRange(chars, '0', '9');
+  __m128i is_valid = is_digit;
+  if (hex_case != HexCase::kUpper) {
+    is_valid = _mm_or_si128(is_valid, InRange(chars, 'a', 'f'));
+  }
+  if (hex_case != HexCase::kLower) {
+    is_valid = _mm_or_si128(is_valid, InRange(chars, 'A', 'F'));
+  }
+  if (_mm_movemask_epi8(is_valid) != 0xFFFF) {
+    return false;
+  }
+
+  const __m128i digit_values = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+  // Setting 0x20 lowercases letters.
+  const __m128i letter_values =
+      _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)),
+                   _mm_set1_epi8('a' - 10));
+  const __m128i nibbles =
+      _mm_or_si128(_mm_and_si128(is_digit, digit_values),
+                   _mm_andnot_si128(is_digit, letter_values));
+  // Each 16-bit lane holds the nibbles of one byte, the high one first, so in
+  // its low byte.
+  *bytes = _mm_and_si128(
+      _mm_or_si128(_mm_slli_epi16(nibbles, 4), _mm_srli_epi16(nibbles, 8)),
+      _mm_set1_epi16(0x00FF));
+  return true;
+}
+
+void HexEncode16Sse2(span<const uint8_t, 16> bytes,
+                     HexCase hex_case,
+                     span<char, 32> output) {
+  const __m128i v =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes.data()));
+  const __m128i low_nibble_mask = _mm_set1_epi8(0x0F);
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), low_nibble_mask);
+  const __m128i low = _mm_and_si128(v, low_nibble_mask);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(output.data()),
+      NibblesToDigits(_mm_unpacklo_epi8(high, low), hex_case));
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(output.data() + 16),
+      NibblesToDigits(_mm_unpackhi_epi8(high, low), hex_case));
+}
+
+bool HexDecode16Sse2(span<const char, 32> input,
+                     HexCase hex_case,
+                     span<uint8_t, 16> output) {
+  __m128i first;
+  __m128i second;
+  if (!DecodeDigits(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data())),
+          hex_case, &first) ||
+      !DecodeDigits(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + 16)),
+          hex_case, &second)) {
+    return false;
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data()),
+                   _mm_packus_epi16(first, second));
+  return true;
+}
+
+#else
+
+constexpr char kLowerDigits[] = "0123456789abcdef";
+constexpr char kUpperDigits[] = "0123456789ABCDEF";
+
+#if defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+
+// Decodes 16 hex digits into nibbles, or returns false.
+bool DecodeDigits(uint8x16_t chars, HexCase hex_case, uint8x16_t* nibbles) {
+  // The subtractions wrap around, so that one unsigned comparison checks both
+  // ends of each range.
+  const uint8x16_t digit_values = vsubq_u8(chars, vdupq_n_u8('0'));
+  const uint8x16_t is_digit = vcltq_u8(digit_values, vdupq_n_u8(10));
+  const uint8x16_t lower_values = vsubq_u8(chars, vdupq_n_u8('a'));
+  const uint8x16_t upper_values = vsubq_u8(chars, vdupq_n_u8('A'));
+  const uint8x16_t is_lower = hex_case != HexCase::kUpper
+                                  ? vcltq_u8(lower_values, vdupq_n_u8(6))
+                                  : vdupq_n_u8(0);
+  const uint8x16_t is_upper = hex_case != HexCase::kLower
+                                  ? vcltq_u8(upper_values, vdupq_n_u8(6))
+                                  : vdupq_n_u8(0);
+  if (vminvq_u8(vorrq_u8(is_digit, vorrq_u8(is_lower, is_upper))) != 0xFF) {
+    return false;
+  }
+  const uint8x16_t letter_values = vaddq_u8(
+      vbslq_u8(is_lower, lower_values, upper_values), vdupq_n_u8(10));
+  *nibbles = vbslq_u8(is_digit, digit_values, letter_values);
+  return true;
+}
+
+void HexEncode16Neon(span<const uint8_t, 16> bytes,
+                     HexCase hex_case,
+                     span<char, 32> output) {
+  const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t*>(
+      hex_case == HexCase::kUpper ? kUpperDigits : kLowerDigits));
+  const uint8x16_t v = vld1q_u8(bytes.data());
+  uint8x16x2_t chars;
+  chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(v, 4));
+  chars.val[1] = vqtbl1q_u8(digits, vandq_u8(v, vdupq_n_u8(0x0F)));
+  // Interleaves the high and low digits of each byte.
+  vst2q_u8(reinterpret_cast<uint8_t*>(output.data()), chars);
+}
+
+bool HexDecode16Neon(span<const char, 32> input,
+                     HexCase hex_case,
+                     span<uint8_t, 16> output) {
+  // Splits the digits of the high and low nibbles.
+  const uint8x16x2_t chars =
+      vld2q_u8(reinterpret_cast<const uint8_t*>(input.data()));
+  uint8x16_t high;
+  uint8x16_t low;
+  if (!DecodeDigits(chars.val[0], hex_case, &high) ||
+      !DecodeDigits(chars.val[1], hex_case, &low)) {
+    return false;
+  }
+  vst1q_u8(output.data(), vorrq_u8(vshlq_n_u8(high, 4), low));
+  return true;
+}
+
+#else
+
+// Returns the value of hex digit `c` of `hex_case`, or -1.
+int DecodeDigit(char c, HexCase hex_case) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (hex_case != HexCase::kUpper && c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (hex_case != HexCase::kLower && c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+void HexEncode16Scalar(span<const uint8_t, 16> bytes,
+                       HexCase hex_case,
+                       span<char, 32> output) {
+  const char* const digits =
+      hex_case == HexCase::kUpper ? kUpperDigits : kLowerDigits;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    output[2 * i] = digits[bytes[i] >> 4];
+    output[2 * i + 1] = digits[bytes[i] & 0x0F];
+  }
+}
+
+bool HexDecode16Scalar(span<const char, 32> input,
+                       HexCase hex_case,
+                       span<uint8_t, 16> output) {
+  for (size_t i = 0; i < output.size(); ++i) {
+    const int high = DecodeDigit(input[2 * i], hex_case);
+    const int low = DecodeDigit(input[2 * i + 1], hex_case);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    output[i] = static_cast<uint8_t>((high << 4) | low);
+  }
+  return true;
+}
+
+#endif  // defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+
+#endif  // defined(ARCH_CPU_X86_64)
+
+}  // namespace
+
+void HexEncode16(span<const uint8_t, 16> bytes,
+                 HexCase hex_case,
+                 span<char, 32> output) {
+  DCHECK_NE(hex_case, HexCase::kAny);
+#if defined(ARCH_CPU_X86_64)
+  HexEncode16Sse2(bytes, hex_case, output);
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+  HexEncode16Neon(bytes, hex_case, output);
+#else
+  HexEncode16Scalar(bytes, hex_case, output);
+#endif
+}
+
+bool HexDecode16(span<const char, 32> input,
+                 HexCase hex_case,
+                 span<uint8_t, 16> output) {
+#if defined(ARCH_CPU_X86_64)
+  return HexDecode16Sse2(input, hex_case, output);
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+  return HexDecode16Neon(input, hex_case, output);
+#else
+  return HexDecode16Scalar(input, hex_case, output);
+#endif
+}
+
+}  // namespace base::internal
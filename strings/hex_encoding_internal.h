@@ -0,0 +1,42 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_STRINGS_HEX_ENCODING_INTERNAL_H_
+#define BASE_STRINGS_HEX_ENCODING_INTERNAL_H_
+
+#include <stdint.h>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+
+// Hex codecs for 128-bit identifiers, behind the string forms of Token,
+// UnguessableToken and Uuid. They use SSE2 on x86-64, NEON on arm64, and
+// scalar loops elsewhere.
+
+namespace base::internal {
+
+enum class HexCase {
+  // 0-9 and a-f.
+  kLower,
+  // 0-9 and A-F.
+  kUpper,
+  // Either of the above, only for decoding.
+  kAny,
+};
+
+// Writes the 32 hex digits of `bytes`, most significant nibble first, to
+// `output`. `hex_case` must not be kAny.
+BASE_EXPORT void HexEncode16(span<const uint8_t, 16> bytes,
+                             HexCase hex_case,
+                             span<char, 32> output);
+
+// Decodes the 32 hex digits of `input` into `output`. Returns false, leaving
+// `output` unspecified, if any character isn't a hex digit of `hex_case`.
+BASE_EXPORT bool HexDecode16(span<const char, 32> input,
+                             HexCase hex_case,
+                             span<uint8_t, 16> output);
+
+}  // namespace base::internal
+
+#endif  // BASE_STRINGS_HEX_ENCODING_INTERNAL_H_
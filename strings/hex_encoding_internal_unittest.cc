@@ -0,0 +1,88 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/hex_encoding_internal.h"
+
+#include <stdint.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base::internal {
+
+namespace {
+
+std::array<uint8_t, 16> MakeBytes(uint8_t first) {
+  std::array<uint8_t, 16> bytes;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<uint8_t>(first + 17 * i);
+  }
+  return bytes;
+}
+
+}  // namespace
+
+TEST(HexEncodingInternalTest, Encode) {
+  // Covers every byte value in every position.
+  for (int first = 0; first < 256; ++first) {
+    const std::array<uint8_t, 16> bytes = MakeBytes(first);
+    const std::string expected = HexEncode(bytes);
+
+    std::array<char, 32> upper;
+    HexEncode16(bytes, HexCase::kUpper, upper);
+    EXPECT_EQ(expected, std::string_view(upper.data(), upper.size()));
+
+    std::array<char, 32> lower;
+    HexEncode16(bytes, HexCase::kLower, lower);
+    EXPECT_EQ(base::ToLowerASCII(expected),
+              std::string_view(lower.data(), lower.size()));
+  }
+}
+
+TEST(HexEncodingInternalTest, Decode) {
+  for (int first = 0; first < 256; ++first) {
+    const std::array<uint8_t, 16> bytes = MakeBytes(first);
+    const std::string upper = HexEncode(bytes);
+    const std::string lower = base::ToLowerASCII(upper);
+    std::array<uint8_t, 16> output;
+
+    EXPECT_TRUE(HexDecode16(span(upper).first<32>(), HexCase::kUpper, output));
+    EXPECT_EQ(bytes, output);
+    EXPECT_TRUE(HexDecode16(span(lower).first<32>(), HexCase::kLower, output));
+    EXPECT_EQ(bytes, output);
+    EXPECT_TRUE(HexDecode16(span(upper).first<32>(), HexCase::kAny, output));
+    EXPECT_EQ(bytes, output);
+    EXPECT_TRUE(HexDecode16(span(lower).first<32>(), HexCase::kAny, output));
+    EXPECT_EQ(bytes, output);
+  }
+}
+
+TEST(HexEncodingInternalTest, DecodeRejectsNonDigits) {
+  std::array<uint8_t, 16> output;
+  // Every character in every position, for each case.
+  for (int c = 0; c < 256; ++c) {
+    const bool is_digit = c >= '0' && c <= '9';
+    const bool is_lower = c >= 'a' && c <= 'f';
+    const bool is_upper = c >= 'A' && c <= 'F';
+    for (size_t i = 0; i < 32; ++i) {
+      std::string input(32, '0');
+      input[i] = static_cast<char>(c);
+      SCOPED_TRACE(input);
+      const span<const char, 32> chars = span(input).first<32>();
+      EXPECT_EQ(is_digit || is_lower,
+                HexDecode16(chars, HexCase::kLower, output));
+      EXPECT_EQ(is_digit || is_upper,
+                HexDecode16(chars, HexCase::kUpper, output));
+      EXPECT_EQ(is_digit || is_lower || is_upper,
+                HexDecode16(chars, HexCase::kAny, output));
+    }
+  }
+}
+
+}  // namespace base::internal
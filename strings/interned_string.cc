@@ -0,0 +1,167 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifdef UNSAFE_BUFFERS_BUILD
+// TODO(crbug.com/40284755): Remove this and spanify to fix the errors.
+#pragma allow_unsafe_buffers
+#endif
+
+#include "base/strings/interned_string.h"
+
+#include <string.h>
+
+#include <array>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <vector>
+
+#include "base/containers/flat_hash_set.h"
+#include "base/hash/hash.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace base {
+
+namespace internal {
+
+// Maps strings to their entries. The table is split into shards, each with its
+// own lock, so that threads interning different strings rarely contend.
+class InternTable {
+ public:
+  using Entry = InternedString::Entry;
+
+  static InternTable& Get() {
+    static NoDestructor<InternTable> table;
+    return *table;
+  }
+
+  InternedString Intern(std::string_view str) {
+    const size_t hash = FastHash(str);
+    Shard& shard = GetShard(hash);
+    AutoLock lock(shard.lock);
+    auto it = shard.entries.find(Key{str, hash});
+    if (it == shard.entries.end()) {
+      it = shard.entries.insert(shard.NewEntry(str, hash)).first;
+    }
+    return InternedString(*it);
+  }
+
+  std::optional<InternedString> Find(std::string_view str) {
+    const size_t hash = FastHash(str);
+    Shard& shard = GetShard(hash);
+    AutoLock lock(shard.lock);
+    auto it = shard.entries.find(Key{str, hash});
+    if (it == shard.entries.end()) {
+      return std::nullopt;
+    }
+    return InternedString(*it);
+  }
+
+ private:
+  friend class NoDestructor<InternTable>;
+
+  static constexpr size_t kNumShardBits = 4;
+  // Entries are carved out of blocks of this size, so that small strings cost
+  // little more than their characters. Longer strings get a block of their own.
+  static constexpr size_t kBlockSize = 4096;
+  static constexpr size_t kMaxSharedBlockEntrySize = kBlockSize / 4;
+
+  struct Key {
+    std::string_view str;
+    size_t hash;
+  };
+
+  struct EntryHash {
+    using is_transparent = void;
+    size_t operator()(const Entry* entry) const { return entry->hash; }
+    size_t operator()(const Key& key) const { return key.hash; }
+  };
+
+  struct EntryEq {
+    using is_transparent = void;
+    bool operator()(const Entry* a, const Entry* b) const { return a == b; }
+    bool operator()(const Entry* entry, const Key& key) const {
+      return entry->hash == key.hash &&
+             std::string_view(entry->chars(), entry->size) == key.str;
+    }
+    bool operator()(const Key& key, const Entry* entry) const {
+      return (*this)(entry, key);
+    }
+  };
+
+  struct Shard {
+    // Copies `str` into a new entry.
+    const Entry* NewEntry(std::string_view str, size_t hash)
+        EXCLUSIVE_LOCKS_REQUIRED(lock) {
+      const size_t entry_size = sizeof(Entry) + str.size() + 1;
+      char* memory;
+      if (entry_size > kMaxSharedBlockEntrySize) {
+        memory = large_entries.emplace_back(new char[entry_size]).get();
+      } else {
+        if (entry_size > kBlockSize - block_used) {
+          blocks.emplace_back(new char[kBlockSize]);
+          block_used = 0;
+        }
+        memory = blocks.back().get() + block_used;
+        // Keeps the next entry aligned.
+        block_used = (block_used + entry_size + alignof(Entry) - 1) &
+                     ~(alignof(Entry) - 1);
+      }
+
+      Entry* entry = new (memory) Entry{hash, str.size()};
+      char* chars = memory + sizeof(Entry);
+      memcpy(chars, str.data(), str.size());
+      chars[str.size()] = '\0';
+      return entry;
+    }
+
+    Lock lock;
+    flat_hash_set<const Entry*, EntryHash, EntryEq> entries GUARDED_BY(lock);
+    std::vector<std::unique_ptr<char[]>> blocks GUARDED_BY(lock);
+    // How much of blocks.back() is in use.
+    size_t block_used GUARDED_BY(lock) = kBlockSize;
+    std::vector<std::unique_ptr<char[]>> large_entries GUARDED_BY(lock);
+  };
+
+  InternTable() = default;
+  ~InternTable() = default;
+
+  Shard& GetShard(size_t hash) {
+    // The hash table uses the low bits.
+    return shards_[hash >> (sizeof(size_t) * 8 - kNumShardBits)];
+  }
+
+  std::array<Shard, 1 << kNumShardBits> shards_;
+};
+
+}  // namespace internal
+
+InternedString::InternedString(std::string_view str) {
+  if (!str.empty()) {
+    *this = internal::InternTable::Get().Intern(str);
+  }
+}
+
+// static
+std::optional<InternedString> InternedString::FindExisting(
+    std::string_view str) {
+  if (str.empty()) {
+    return InternedString();
+  }
+  return internal::InternTable::Get().Find(str);
+}
+
+// static
+size_t InternedString::EmptyHash() {
+  static const size_t hash = FastHash(std::string_view());
+  return hash;
+}
+
+std::ostream& operator<<(std::ostream& out, InternedString s) {
+  return out << s.str();
+}
+
+}  // namespace base
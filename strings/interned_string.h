@@ -0,0 +1,100 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_STRINGS_INTERNED_STRING_H_
+#define BASE_STRINGS_INTERNED_STRING_H_
+
+#include <stddef.h>
+
+#include <iosfwd>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "base/base_export.h"
+#include "base/memory/raw_ptr_exclusion.h"
+
+namespace base {
+
+namespace internal {
+class InternTable;
+}  // namespace internal
+
+// A pointer-sized handle to a string in a process-wide intern table, for
+// identifiers which are compared and hashed over and over, such as histogram
+// names or trace categories. Interning the same characters always gives the
+// same handle, so equality compares one pointer and hash() is precomputed.
+//
+//   static const base::InternedString kName("Memory.Browser");
+//   if (base::InternedString(name) == kName) { ... }
+//
+// Interning takes a lock and hashes the string, so it pays off only when the
+// handle is kept and reused. Interned strings are never freed: don't intern
+// strings from unbounded sources, such as arbitrary web content.
+//
+// The table is safe to use from any thread.
+class BASE_EXPORT InternedString {
+ public:
+  // The empty string.
+  constexpr InternedString() = default;
+
+  // Interns `str`, adding it to the table if needed.
+  explicit InternedString(std::string_view str);
+
+  InternedString(const InternedString&) = default;
+  InternedString& operator=(const InternedString&) = default;
+
+  // Returns the handle for `str` if it's already interned, without adding it.
+  static std::optional<InternedString> FindExisting(std::string_view str);
+
+  std::string_view str() const {
+    return entry_ ? std::string_view(entry_->chars(), entry_->size)
+                  : std::string_view();
+  }
+  // Interned strings are NUL-terminated.
+  const char* c_str() const { return entry_ ? entry_->chars() : ""; }
+  size_t size() const { return entry_ ? entry_->size : 0; }
+  bool empty() const { return !entry_; }
+
+  // Returns base::FastHash() of str().
+  size_t hash() const { return entry_ ? entry_->hash : EmptyHash(); }
+
+  friend bool operator==(InternedString a, InternedString b) = default;
+
+  template <typename H>
+  friend H AbslHashValue(H h, InternedString s) {
+    return H::combine(std::move(h), s.hash());
+  }
+
+ private:
+  // The characters follow the entry.
+  struct alignas(size_t) Entry {
+    const char* chars() const {
+      return reinterpret_cast<const char*>(this + 1);
+    }
+
+    size_t hash;
+    size_t size;
+  };
+
+  friend class internal::InternTable;
+
+  explicit InternedString(const Entry* entry) : entry_(entry) {}
+
+  static size_t EmptyHash();
+
+  // Entries are never freed, so this can't dangle.
+  RAW_PTR_EXCLUSION const Entry* entry_ = nullptr;
+};
+
+// For std::unordered_map and friends; absl containers use AbslHashValue().
+struct InternedStringHash {
+  size_t operator()(InternedString s) const { return s.hash(); }
+};
+
+BASE_EXPORT std::ostream& operator<<(std::ostream& out, InternedString s);
+
+}  // namespace base
+
+#endif  // BASE_STRINGS_INTERNED_STRING_H_
@@ -0,0 +1,165 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/interned_string.h"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_hash_set.h"
+#include "base/hash/hash.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(InternedStringTest, SameStringSameHandle) {
+  const std::string a = "InternedStringTest.SameStringSameHandle";
+  const std::string b = a;
+  ASSERT_NE(a.data(), b.data());
+
+  const InternedString interned_a(a);
+  const InternedString interned_b(b);
+  EXPECT_EQ(interned_a, interned_b);
+  EXPECT_EQ(interned_a.c_str(), interned_b.c_str());
+  EXPECT_EQ(a, interned_a.str());
+  EXPECT_EQ(a.size(), interned_a.size());
+  EXPECT_FALSE(interned_a.empty());
+
+  EXPECT_NE(interned_a, InternedString(a + "2"));
+  EXPECT_NE(interned_a, InternedString());
+}
+
+TEST(InternedStringTest, Hash) {
+  for (std::string_view str : {"", "a", "InternedStringTest.Hash"}) {
+    EXPECT_EQ(FastHash(str), InternedString(str).hash());
+  }
+  EXPECT_EQ(FastHash(std::string_view()), InternedString().hash());
+}
+
+TEST(InternedStringTest, Empty) {
+  constexpr InternedString empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(0u, empty.size());
+  EXPECT_EQ("", empty.str());
+  EXPECT_STREQ("", empty.c_str());
+  EXPECT_EQ(empty, InternedString(""));
+  EXPECT_EQ(empty, InternedString::FindExisting(""));
+}
+
+TEST(InternedStringTest, CharsAreCopied) {
+  std::string str = "InternedStringTest.CharsAreCopied";
+  const InternedString interned(str);
+  str[0] = 'X';
+  EXPECT_EQ("InternedStringTest.CharsAreCopied", interned.str());
+  EXPECT_STREQ("InternedStringTest.CharsAreCopied", interned.c_str());
+}
+
+TEST(InternedStringTest, EmbeddedNul) {
+  constexpr std::string_view kStr("Interned\0String", 15);
+  const InternedString interned(kStr);
+  EXPECT_EQ(kStr, interned.str());
+  EXPECT_NE(interned, InternedString("Interned"));
+}
+
+TEST(InternedStringTest, LongStrings) {
+  // Longer than the blocks which hold short strings.
+  for (size_t size : {1000u, 1024u, 5000u, 100000u}) {
+    const std::string str(size, 'L');
+    const InternedString interned(str);
+    EXPECT_EQ(str, interned.str());
+    EXPECT_EQ(interned, InternedString(str));
+    EXPECT_EQ('\0', interned.c_str()[size]);
+  }
+}
+
+TEST(InternedStringTest, ManyStrings) {
+  // Fills many blocks of each shard.
+  std::vector<InternedString> interned;
+  for (int i = 0; i < 10000; ++i) {
+    interned.emplace_back(StringPrintf("InternedStringTest.ManyStrings.%d", i));
+  }
+  for (int i = 0; i < 10000; ++i) {
+    const std::string str =
+        StringPrintf("InternedStringTest.ManyStrings.%d", i);
+    EXPECT_EQ(str, interned[i].str());
+    EXPECT_EQ(interned[i], InternedString(str));
+  }
+}
+
+TEST(InternedStringTest, FindExisting) {
+  const std::string str = "InternedStringTest.FindExisting";
+  EXPECT_FALSE(InternedString::FindExisting(str));
+  // Finding doesn't intern.
+  EXPECT_FALSE(InternedString::FindExisting(str));
+
+  const InternedString interned(str);
+  EXPECT_EQ(interned, InternedString::FindExisting(str));
+}
+
+TEST(InternedStringTest, HashSet) {
+  flat_hash_set<InternedString> set;
+  set.insert(InternedString("a"));
+  set.insert(InternedString("b"));
+  set.insert(InternedString("a"));
+  EXPECT_EQ(2u, set.size());
+  EXPECT_TRUE(set.contains(InternedString("b")));
+  EXPECT_FALSE(set.contains(InternedString("c")));
+}
+
+TEST(InternedStringTest, Stream) {
+  std::ostringstream out;
+  out << InternedString("InternedStringTest.Stream");
+  EXPECT_EQ("InternedStringTest.Stream", out.str());
+}
+
+TEST(InternedStringTest, Threads) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumStrings = 1000;
+
+  // Every thread interns the same strings, and all must get the same handles.
+  class InternDelegate : public DelegateSimpleThread::Delegate {
+   public:
+    void Run() override {
+      std::vector<InternedString> interned;
+      for (int i = 0; i < kNumStrings; ++i) {
+        interned.emplace_back("InternedStringTest.Threads." +
+                              NumberToString(i));
+      }
+      AutoLock lock(lock_);
+      results_.push_back(std::move(interned));
+    }
+
+    const std::vector<std::vector<InternedString>>& results() const {
+      return results_;
+    }
+
+   private:
+    Lock lock_;
+    std::vector<std::vector<InternedString>> results_;
+  };
+
+  InternDelegate delegate;
+  DelegateSimpleThreadPool pool("InternedStringTest", kNumThreads);
+  pool.AddWork(&delegate, kNumThreads);
+  pool.Start();
+  pool.JoinAll();
+
+  ASSERT_EQ(static_cast<size_t>(kNumThreads), delegate.results().size());
+  for (const std::vector<InternedString>& interned : delegate.results()) {
+    EXPECT_EQ(delegate.results()[0], interned);
+  }
+  for (int i = 0; i < kNumStrings; ++i) {
+    EXPECT_EQ("InternedStringTest.Threads." + NumberToString(i),
+              delegate.results()[0][i].str());
+  }
+}
+
+}  // namespace base
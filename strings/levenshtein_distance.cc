@@ -2,20 +2,205 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#ifdef UNSAFE_BUFFERS_BUILD
+// TODO(crbug.com/40284755): Remove this and spanify to fix the errors.
+#pragma allow_unsafe_buffers
+#endif
+
 #include "base/strings/levenshtein_distance.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
-#include <numeric>
+#include <bit>
 #include <optional>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "base/check_op.h"
+#include "base/ranges/algorithm.h"
+
 namespace base {
 
 namespace {
 
+constexpr size_t kWordBits = 64;
+// How many columns apart the blocked algorithm checks whether the distance is
+// known to exceed its limit.
+constexpr size_t kCutoffInterval = 16;
+
+// Returns the character of LevenshteinPattern for `c`. Bytes are unsigned, so
+// that they all fall below kNumDirectRows.
+template <typename CharT>
+char16_t ToPatternChar(CharT c) {
+  return static_cast<std::make_unsigned_t<CharT>>(c);
+}
+
+void AddDelta(size_t& score, int delta) {
+  if (delta > 0) {
+    ++score;
+  } else if (delta < 0) {
+    --score;
+  }
+}
+
+// Advances one block of the bit-parallel algorithm by one column, given the
+// horizontal delta `hin` at the row above the block, and returns the delta at
+// `last_row`, the block's bottom row.
+//
+// `pv` and `mv` hold the rows of the block whose vertical delta (that is, the
+// difference to the row above in the same column) is +1 and -1, and `eq` those
+// whose pattern character equals the text character. See Myers, "A fast
+// bit-vector algorithm for approximate string matching based on dynamic
+// programming", J. ACM 46(3), 1999, in particular the block-based version.
+int AdvanceBlock(uint64_t& pv,
+                 uint64_t& mv,
+                 uint64_t eq,
+                 int hin,
+                 uint64_t last_row) {
+  const uint64_t xv = eq | mv;
+  if (hin < 0) {
+    eq |= 1;
+  }
+  const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+  uint64_t ph = mv | ~(xh | pv);
+  uint64_t mh = pv & xh;
+  const int hout = (ph & last_row) ? 1 : (mh & last_row) ? -1 : 0;
+  ph <<= 1;
+  mh <<= 1;
+  if (hin < 0) {
+    mh |= 1;
+  } else if (hin > 0) {
+    ph |= 1;
+  }
+  pv = mh | ~(xv | ph);
+  mv = ph & xv;
+  return hout;
+}
+
+// Returns whether all `rows` rows of a block have a distance larger than `k`,
+// given the distance `bottom_score` at its bottom row and its vertical deltas.
+bool BlockExceeds(uint64_t pv,
+                  uint64_t mv,
+                  size_t bottom_score,
+                  size_t rows,
+                  size_t k) {
+  // No row can be more than popcount(pv) below the bottom one.
+  if (bottom_score > k + static_cast<size_t>(std::popcount(pv))) {
+    return true;
+  }
+  size_t score = bottom_score;
+  for (size_t row = rows - 1; row > 0; --row) {
+    if (score <= k) {
+      return false;
+    }
+    // Steps up to the row above, undoing this row's vertical delta.
+    if ((pv >> row) & 1) {
+      --score;
+    } else if ((mv >> row) & 1) {
+      ++score;
+    }
+  }
+  return score > k;
+}
+
+// Returns the Levenshtein distance of `pattern` and `text`, or `k + 1` if it
+// is larger than `k`. The lengths of `pattern`, which must not be empty, and
+// `text` must differ by at most `k`.
+//
+// The DP matrix has a row for each character of the pattern, and a column for
+// each character of the text. Rows are processed 64 at a time in blocks, and
+// columns one at a time.
+template <typename CharT>
+size_t MyersDistance(const internal::LevenshteinPattern& pattern,
+                     std::basic_string_view<CharT> text,
+                     size_t k) {
+  const size_t m = pattern.size();
+  const size_t n = text.size();
+  DCHECK_GT(m, 0u);
+  DCHECK_LE(m, n + k);
+  DCHECK_LE(n, m + k);
+
+  const uint64_t last_row = uint64_t{1} << ((m - 1) % kWordBits);
+  if (pattern.words() == 1) {
+    // Initially all vertical deltas are +1, as the first column holds the
+    // distances from the empty prefix of the text.
+    uint64_t pv = ~uint64_t{0};
+    uint64_t mv = 0;
+    size_t score = m;
+    for (size_t j = 0; j < n; ++j) {
+      // The first row holds the distances from the empty prefix of the
+      // pattern, so its horizontal delta is always +1.
+      const uint64_t eq = pattern.Masks(ToPatternChar(text[j]))[0];
+      AddDelta(score, AdvanceBlock(pv, mv, eq, 1, last_row));
+      // The score can decrease by at most one per remaining column.
+      if (score > k + (n - j - 1)) {
+        return k + 1;
+      }
+    }
+    return std::min(score, k + 1);
+  }
+
+  // A cell whose distance is at most `k` is at most `k` rows away from the
+  // diagonal of its column, and every cell on a path to it has a distance of
+  // at most `k` too. So it is enough to compute the blocks which meet that band
+  // of rows, treating the cells around it as larger than they might be: the
+  // rows above the band as growing by one per column, and the rows below it as
+  // growing by one per row.
+  const size_t words = pattern.words();
+  std::vector<uint64_t> pv(words, ~uint64_t{0});
+  std::vector<uint64_t> mv(words, 0);
+  // The distance at the bottom row of each block.
+  std::vector<size_t> scores(words);
+  for (size_t w = 0; w < words; ++w) {
+    scores[w] = std::min((w + 1) * kWordBits, m);
+  }
+
+  // Row `r`, counting from 1, is in block (r - 1) / 64.
+  const auto block_of_row = [](size_t row) { return (row - 1) / kWordBits; };
+  size_t last = std::min(words - 1, block_of_row(k + 1));
+  for (size_t j = 1; j <= n; ++j) {
+    const size_t first = j > k + 1 ? block_of_row(j - k) : 0;
+    const size_t new_last = std::min(words - 1, block_of_row(j + k));
+    if (new_last > last) {
+      // The band reaches a new block. Its distances in the previous column are
+      // taken to grow by one per row from the bottom of the block above.
+      last = new_last;
+      scores[last] =
+          scores[last - 1] + std::min(kWordBits, m - last * kWordBits);
+    }
+    const uint64_t* masks = pattern.Masks(ToPatternChar(text[j - 1]));
+    // Above the band, the distances grow by one per column.
+    int hin = 1;
+    for (size_t w = first; w <= last; ++w) {
+      hin = AdvanceBlock(pv[w], mv[w], masks[w], hin,
+                         w == words - 1 ? last_row : uint64_t{1} << 63);
+      AddDelta(scores[w], hin);
+    }
+    if (last == words - 1 && scores[last] > k + (n - j)) {
+      return k + 1;
+    }
+    // Every path to the last cell crosses each column, so the distance exceeds
+    // `k` if all cells of a column do. Cells outside the band do, and so does
+    // the first row once j > k. Checking the band costs up to 64 steps per
+    // block, so it is only done every few columns.
+    if (j > k && j % kCutoffInterval == 0) {
+      bool all_exceed = true;
+      for (size_t w = first; w <= last && all_exceed; ++w) {
+        const size_t rows = std::min(kWordBits, m - w * kWordBits);
+        all_exceed = BlockExceeds(pv[w], mv[w], scores[w], rows, k);
+      }
+      if (all_exceed) {
+        return k + 1;
+      }
+    }
+  }
+  return std::min(scores[words - 1], k + 1);
+}
+
 template <typename CharT>
 size_t LevenshteinDistanceImpl(std::basic_string_view<CharT> a,
                                std::basic_string_view<CharT> b,
@@ -31,59 +216,27 @@ size_t LevenshteinDistanceImpl(std::basic_string_view<CharT> a,
   if (a.size() + k < b.size()) {
     return k + 1;
   }
-  // The classical Levenshtein distance DP defines dp[i][j] as the minimum
-  // number of insert, remove and replace operation to convert a[:i] to b[:j].
-  // To make this more efficient, one can define dp[i][d] as the distance of
-  // a[:i] and b[:i + d]. Intuitively, d represents the delta between j and i in
-  // the former dp. Since the Levenshtein distance is restricted by `k`, abs(d)
-  // can be bounded by `k`. Since dp[i][d] only depends on values from dp[i-1],
-  // it is not necessary to store the entire 2D table. Instead, this code just
-  // stores the d-dimension, which represents "the distance with the current
-  // prefix of the string, for a given delta d". Since d is between `-k` and
-  // `k`, the implementation shifts the d-index by `k`, bringing it in range
-  // [0, `2*k`].
-
-  // The algorithm only cares if the Levenshtein distance is at most `k`. Thus,
-  // any unreachable states and states in which the distance is certainly larger
-  // than `k` can be set to any value larger than `k`, without affecting the
-  // result.
-  const size_t kInfinity = k + 1;
-  std::vector<size_t> dp(2 * k + 1, kInfinity);
-  // Initially, `dp[d]` represents the Levenshtein distance of the empty prefix
-  // of `a` and the first j = d - k characters of `b`. Their distance is j,
-  // since j removals are required. States with negative d are not reachable,
-  // since that corresponds to a negative index into `b`.
-  std::iota(dp.begin() + static_cast<long>(k), dp.end(), 0);
-  for (size_t i = 0; i < a.size(); i++) {
-    // Right now, `dp` represents the Levenshtein distance when considering the
-    // first `i` characters (up to index `i-1`) of `a`. After the next loop,
-    // `dp` will represent the Levenshtein distance when considering the first
-    // `i+1` characters.
-    for (size_t d = 0; d <= 2 * k; d++) {
-      if (i + d < k || i + d >= b.size() + k) {
-        // `j = i + d - k` is out of range of `b`. Since j == -1 corresponds to
-        // the empty prefix of `b`, the distance is i + 1 in this case.
-        dp[d] = i + d + 1 == k ? i + 1 : kInfinity;
-        continue;
-      }
-      const size_t j = i + d - k;
-      // If `a[i] == `b[j]` the Levenshtein distance for `d` remained the same.
-      if (a[i] != b[j]) {
-        // (i, j) -> (i-1, j-1), `d` stays the same.
-        const size_t replace = dp[d];
-        // (i, j) -> (i-1, j), `d` increases by 1.
-        // If the distance between `i` and `j` becomes larger than `k`, their
-        // distance is at least `k + 1`. Same in the `insert` case.
-        const size_t remove = d != 2 * k ? dp[d + 1] : kInfinity;
-        // (i, j) -> (i, j-1), `d` decreases by 1. Since `i` stays the same,
-        // this is intentionally using the dp value updated in the previous
-        // iteration.
-        const size_t insert = d != 0 ? dp[d - 1] : kInfinity;
-        dp[d] = 1 + std::min({replace, remove, insert});
-      }
-    }
+  if (a.empty()) {
+    return b.size();
   }
-  return std::min(dp[b.size() + k - a.size()], k + 1);
+  // The shorter string is the pattern, so that it takes fewer words.
+  return MyersDistance(internal::LevenshteinPattern(a), b, k);
+}
+
+template <typename CharT>
+size_t MatcherDistance(const internal::LevenshteinPattern& pattern,
+                       std::basic_string_view<CharT> candidate,
+                       std::optional<size_t> max_distance) {
+  const size_t k =
+      max_distance.value_or(std::max(pattern.size(), candidate.size()));
+  if (pattern.size() + k < candidate.size() ||
+      candidate.size() + k < pattern.size()) {
+    return k + 1;
+  }
+  if (pattern.size() == 0) {
+    return candidate.size();
+  }
+  return MyersDistance(pattern, candidate, k);
 }
 
 }  // namespace
@@ -99,4 +252,73 @@ size_t LevenshteinDistance(std::u16string_view a,
   return LevenshteinDistanceImpl(a, b, max_distance);
 }
 
+namespace internal {
+
+LevenshteinPattern::LevenshteinPattern(std::string_view pattern)
+    : size_(pattern.size()), words_((size_ + kWordBits - 1) / kWordBits) {
+  Init(pattern);
+}
+
+LevenshteinPattern::LevenshteinPattern(std::u16string_view pattern)
+    : size_(pattern.size()), words_((size_ + kWordBits - 1) / kWordBits) {
+  Init(pattern);
+}
+
+LevenshteinPattern::~LevenshteinPattern() = default;
+
+template <typename CharT>
+void LevenshteinPattern::Init(std::basic_string_view<CharT> pattern) {
+  // Row 0.
+  masks_.resize(words_);
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const char16_t c = ToPatternChar(pattern[i]);
+    size_t row = Row(c);
+    if (row == 0) {
+      row = masks_.size() / words_;
+      masks_.resize(masks_.size() + words_);
+      if (c < kNumDirectRows) {
+        direct_rows_[c] = static_cast<uint32_t>(row);
+      } else {
+        other_rows_.insert(ranges::upper_bound(other_rows_, c, {},
+                                               &std::pair<char16_t,
+                                                          uint32_t>::first),
+                           {c, static_cast<uint32_t>(row)});
+      }
+    }
+    masks_[row * words_ + i / kWordBits] |= uint64_t{1} << (i % kWordBits);
+  }
+}
+
+size_t LevenshteinPattern::Row(char16_t c) const {
+  if (c < kNumDirectRows) {
+    return direct_rows_[c];
+  }
+  const auto it = ranges::lower_bound(other_rows_, c, {},
+                                      &std::pair<char16_t, uint32_t>::first);
+  return it != other_rows_.end() && it->first == c ? it->second : 0;
+}
+
+}  // namespace internal
+
+LevenshteinMatcher::LevenshteinMatcher(std::string_view query)
+    : pattern_(query) {}
+
+LevenshteinMatcher::~LevenshteinMatcher() = default;
+
+size_t LevenshteinMatcher::Distance(std::string_view candidate,
+                                    std::optional<size_t> max_distance) const {
+  return MatcherDistance(pattern_, candidate, max_distance);
+}
+
+LevenshteinMatcher16::LevenshteinMatcher16(std::u16string_view query)
+    : pattern_(query) {}
+
+LevenshteinMatcher16::~LevenshteinMatcher16() = default;
+
+size_t LevenshteinMatcher16::Distance(
+    std::u16string_view candidate,
+    std::optional<size_t> max_distance) const {
+  return MatcherDistance(pattern_, candidate, max_distance);
+}
+
 }  // namespace base
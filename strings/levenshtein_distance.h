@@ -6,9 +6,13 @@
 #define BASE_STRINGS_LEVENSHTEIN_DISTANCE_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <array>
 #include <optional>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "base/base_export.h"
 
@@ -20,9 +24,13 @@ namespace base {
 // up to k. In case the actual Levenshtein distance is larger than k, k+1 is
 // returned instead. This is useful for checking whether the distance is at most
 // some small constant, since the algorithm is more efficient in this case.
-// Complexity:
-// - Without k: O(|a| * |b|) time and O(max(|a|, |b|)) memory.
-// - With k: O(min(|a|, |b|) * k + k) time and O(k) memory.
+//
+// This uses the bit-parallel algorithm of Myers, which handles 64 characters
+// of the shorter string per machine word. With m = min(|a|, |b|) and
+// n = max(|a|, |b|), the complexity is:
+// - Without k: O(n * ceil(m / 64)) time and O(m) memory.
+// - With k: O(n * ceil(k / 32)) time and O(m) memory. The computation also
+//   stops as soon as the distance is known to exceed k.
 BASE_EXPORT size_t
 LevenshteinDistance(std::string_view a,
                     std::string_view b,
@@ -32,6 +40,84 @@ LevenshteinDistance(std::u16string_view a,
                     std::u16string_view b,
                     std::optional<size_t> max_distance = std::nullopt);
 
+namespace internal {
+
+// The positions of each character of a Levenshtein pattern, as bitmasks of 64
+// positions per word.
+class BASE_EXPORT LevenshteinPattern {
+ public:
+  explicit LevenshteinPattern(std::string_view pattern);
+  explicit LevenshteinPattern(std::u16string_view pattern);
+  LevenshteinPattern(const LevenshteinPattern&) = delete;
+  LevenshteinPattern& operator=(const LevenshteinPattern&) = delete;
+  ~LevenshteinPattern();
+
+  size_t size() const { return size_; }
+  size_t words() const { return words_; }
+
+  // Returns the words() masks of `c`.
+  const uint64_t* Masks(char16_t c) const {
+    return &masks_[Row(c) * words_];
+  }
+
+ private:
+  template <typename CharT>
+  void Init(std::basic_string_view<CharT> pattern);
+
+  size_t Row(char16_t c) const;
+
+  static constexpr size_t kNumDirectRows = 256;
+
+  const size_t size_;
+  const size_t words_;
+  // The rows of `masks_` for characters below kNumDirectRows, and the others
+  // sorted by character. Row 0 is zero, for characters not in the pattern.
+  std::array<uint32_t, kNumDirectRows> direct_rows_ = {};
+  std::vector<std::pair<char16_t, uint32_t>> other_rows_;
+  std::vector<uint64_t> masks_;
+};
+
+}  // namespace internal
+
+// Computes LevenshteinDistance() between one query and many candidates, doing
+// the work which only depends on the query once.
+//
+//   base::LevenshteinMatcher matcher(query);
+//   for (std::string_view candidate : candidates) {
+//     if (matcher.Distance(candidate, /*max_distance=*/2) <= 2) { ... }
+//   }
+//
+// With `max_distance`, candidates whose lengths differ from the query's by more
+// than it are rejected without looking at their characters.
+class BASE_EXPORT LevenshteinMatcher {
+ public:
+  explicit LevenshteinMatcher(std::string_view query);
+  LevenshteinMatcher(const LevenshteinMatcher&) = delete;
+  LevenshteinMatcher& operator=(const LevenshteinMatcher&) = delete;
+  ~LevenshteinMatcher();
+
+  size_t Distance(std::string_view candidate,
+                  std::optional<size_t> max_distance = std::nullopt) const;
+
+ private:
+  const internal::LevenshteinPattern pattern_;
+};
+
+// As LevenshteinMatcher, for UTF-16 strings.
+class BASE_EXPORT LevenshteinMatcher16 {
+ public:
+  explicit LevenshteinMatcher16(std::u16string_view query);
+  LevenshteinMatcher16(const LevenshteinMatcher16&) = delete;
+  LevenshteinMatcher16& operator=(const LevenshteinMatcher16&) = delete;
+  ~LevenshteinMatcher16();
+
+  size_t Distance(std::u16string_view candidate,
+                  std::optional<size_t> max_distance = std::nullopt) const;
+
+ private:
+  const internal::LevenshteinPattern pattern_;
+};
+
 }  // namespace base
 
 #endif  // BASE_STRINGS_LEVENSHTEIN_DISTANCE_H_
@@ -4,7 +4,13 @@
 
 #include "base/strings/levenshtein_distance.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -12,6 +18,61 @@ namespace base {
 
 namespace {
 
+// The textbook O(|a| * |b|) DP.
+template <typename CharT>
+size_t ReferenceDistance(std::basic_string_view<CharT> a,
+                         std::basic_string_view<CharT> b) {
+  std::vector<size_t> row(b.size() + 1);
+  for (size_t j = 0; j <= b.size(); ++j) {
+    row[j] = j;
+  }
+  for (size_t i = 1; i <= a.size(); ++i) {
+    size_t diagonal = row[0];
+    row[0] = i;
+    for (size_t j = 1; j <= b.size(); ++j) {
+      const size_t above = row[j];
+      row[j] = std::min({above + 1, row[j - 1] + 1,
+                         diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+      diagonal = above;
+    }
+  }
+  return row[b.size()];
+}
+
+// Deterministic strings over a small alphabet, so that they share many
+// characters.
+class StringGenerator {
+ public:
+  std::string Next(size_t size, std::string_view alphabet) {
+    std::string str;
+    for (size_t i = 0; i < size; ++i) {
+      state_ = state_ * 6364136223846793005u + 1442695040888963407u;
+      str.push_back(alphabet[(state_ >> 33) % alphabet.size()]);
+    }
+    return str;
+  }
+
+  // Returns `str` with about one in `rate` characters edited.
+  std::string Mutate(std::string_view str, size_t rate) {
+    std::string mutated;
+    for (char c : str) {
+      state_ = state_ * 6364136223846793005u + 1442695040888963407u;
+      const uint64_t r = (state_ >> 33) % (3 * rate);
+      if (r == 0) {
+        continue;
+      }
+      mutated.push_back(r == 1 ? 'z' : c);
+      if (r == 2) {
+        mutated.push_back('y');
+      }
+    }
+    return mutated;
+  }
+
+ private:
+  uint64_t state_ = 1;
+};
+
 TEST(LevenshteinDistanceTest, WithoutMaxDistance) {
   EXPECT_EQ(0u, LevenshteinDistance("banana", "banana"));
 
@@ -62,6 +123,78 @@ TEST(LevenshteinDistanceTest, WithMaxDistance) {
             51u);
 }
 
+TEST(LevenshteinDistanceTest, NonAscii) {
+  EXPECT_EQ(1u, LevenshteinDistance("\xc3\xa4", "\xc3\x84"));
+  EXPECT_EQ(2u, LevenshteinDistance("a\xff", "\xff" "a"));
+  EXPECT_EQ(1u, LevenshteinDistance(u"\u4e2d\u6587", u"\u4e2d\u6588"));
+  EXPECT_EQ(0u, LevenshteinDistance(u"\u4e2d\u6587", u"\u4e2d\u6587"));
+  EXPECT_EQ(3u, LevenshteinDistance(u"\u4e2d\u6587x", u"xy\u6587\u4e2d"));
+}
+
+// Covers patterns of one and several words, with and without the band.
+TEST(LevenshteinDistanceTest, MatchesReference) {
+  StringGenerator generator;
+  for (size_t size : {1u, 5u, 63u, 64u, 65u, 127u, 128u, 129u, 300u, 1000u}) {
+    for (std::string_view alphabet : {"ab", "abcdefgh"}) {
+      for (size_t rate : {2u, 10u, 50u}) {
+        const std::string a = generator.Next(size, alphabet);
+        const std::string b = generator.Mutate(a, rate);
+        SCOPED_TRACE(a + " " + b);
+        const size_t expected =
+            ReferenceDistance(std::string_view(a), std::string_view(b));
+        EXPECT_EQ(expected, LevenshteinDistance(a, b));
+        EXPECT_EQ(expected, LevenshteinDistance(b, a));
+        for (size_t k : {size_t{0}, size_t{1}, size_t{5}, size_t{40},
+                         size_t{70}, expected, expected + 1}) {
+          EXPECT_EQ(std::min(expected, k + 1), LevenshteinDistance(a, b, k));
+          EXPECT_EQ(std::min(expected, k + 1), LevenshteinDistance(b, a, k));
+        }
+        // Unrelated strings of similar lengths.
+        const std::string c = generator.Next(b.size(), alphabet);
+        EXPECT_EQ(
+            ReferenceDistance(std::string_view(a), std::string_view(c)),
+            LevenshteinDistance(a, c));
+      }
+    }
+  }
+}
+
+TEST(LevenshteinDistanceTest, Matcher) {
+  const LevenshteinMatcher matcher("chromium");
+  EXPECT_EQ(0u, matcher.Distance("chromium"));
+  EXPECT_EQ(3u, matcher.Distance("chrome"));
+  EXPECT_EQ(8u, matcher.Distance(""));
+  EXPECT_EQ(2u, matcher.Distance("chrome", 1));
+  EXPECT_EQ(2u, matcher.Distance("c", 1));
+  EXPECT_EQ(1u, matcher.Distance("chromiums", 1));
+
+  const LevenshteinMatcher empty("");
+  EXPECT_EQ(0u, empty.Distance(""));
+  EXPECT_EQ(3u, empty.Distance("abc"));
+  EXPECT_EQ(2u, empty.Distance("abc", 1));
+
+  const LevenshteinMatcher16 matcher16(u"\u4e2d\u6587");
+  EXPECT_EQ(0u, matcher16.Distance(u"\u4e2d\u6587"));
+  EXPECT_EQ(1u, matcher16.Distance(u"\u4e2d"));
+  EXPECT_EQ(2u, matcher16.Distance(u"ab"));
+}
+
+TEST(LevenshteinDistanceTest, MatcherMatchesReference) {
+  StringGenerator generator;
+  for (size_t size : {1u, 20u, 64u, 100u, 200u}) {
+    const std::string query = generator.Next(size, "abcd");
+    const LevenshteinMatcher matcher(query);
+    for (int i = 0; i < 20; ++i) {
+      const std::string candidate =
+          generator.Mutate(i % 2 ? query : generator.Next(size, "abcd"), 5);
+      const size_t expected = ReferenceDistance(std::string_view(query),
+                                                std::string_view(candidate));
+      EXPECT_EQ(expected, matcher.Distance(candidate));
+      EXPECT_EQ(std::min<size_t>(expected, 4), matcher.Distance(candidate, 3));
+    }
+  }
+}
+
 }  // namespace
 
 }  // namespace base
@@ -9,6 +9,8 @@
 
 #include "base/strings/pattern.h"
 
+#include <utility>
+
 #include "base/third_party/icu/icu_utf.h"
 
 namespace base {
@@ -145,6 +147,65 @@ struct NextCharUTF16 {
   }
 };
 
+// Returns the position of the character after the one at `pos` in `string`.
+size_t NextCharPosition(std::string_view string, size_t pos) {
+  base_icu::UChar32 c;
+  CBU8_NEXT(reinterpret_cast<const uint8_t*>(string.data()), pos,
+            string.size(), c);
+  return pos;
+}
+
+// Returns the position of the first occurrence of `literal` in `string`
+// which starts at most `max_wildcard_length` characters after `pos`, or any
+// number of characters if it is negative. If `at_end`, the occurrence must
+// also end the string. Like SearchForChars(), only the first occurrence is
+// considered: the wildcards don't backtrack.
+//
+// The positions where an occurrence can start are the ones SearchForChars()
+// reaches by advancing one character at a time: since `literal` is valid
+// UTF-8, it can't start with a trail byte, which are the only bytes skipped
+// by NextCharPosition(), even in invalid sequences.
+std::optional<size_t> FindLiteral(std::string_view string,
+                                  size_t pos,
+                                  std::string_view literal,
+                                  int max_wildcard_length,
+                                  bool at_end) {
+  if (at_end) {
+    if (string.size() - pos < literal.size() || !string.ends_with(literal)) {
+      return std::nullopt;
+    }
+    const size_t start = string.size() - literal.size();
+    if (max_wildcard_length < 0) {
+      return start;
+    }
+    for (int skipped = 0; pos < start && skipped < max_wildcard_length;
+         ++skipped) {
+      pos = NextCharPosition(string, pos);
+    }
+    if (pos != start) {
+      return std::nullopt;
+    }
+    return start;
+  }
+
+  if (max_wildcard_length < 0) {
+    const size_t start = string.find(literal, pos);
+    if (start == std::string_view::npos) {
+      return std::nullopt;
+    }
+    return start;
+  }
+  for (int skipped = 0;; ++skipped) {
+    if (string.substr(pos).starts_with(literal)) {
+      return pos;
+    }
+    if (skipped == max_wildcard_length || pos == string.size()) {
+      return std::nullopt;
+    }
+    pos = NextCharPosition(string, pos);
+  }
+}
+
 }  // namespace
 
 bool MatchPattern(StringPiece eval, StringPiece pattern) {
@@ -157,4 +218,114 @@ bool MatchPattern(StringPiece16 eval, StringPiece16 pattern) {
                        pattern.data() + pattern.size(), NextCharUTF16());
 }
 
+CompiledPattern::CompiledPattern(std::string_view pattern) {
+  // Splits the pattern like EatWildcards() and SearchForChars() walk it.
+  size_t pos = 0;
+  do {
+    Segment& segment = segments_.emplace_back();
+    int num_question_marks = 0;
+    bool has_asterisk = false;
+    for (; pos < pattern.size() && IsWildcard(pattern[pos]); ++pos) {
+      if (pattern[pos] == '*') {
+        has_asterisk = true;
+      } else {
+        num_question_marks++;
+      }
+    }
+    segment.max_wildcard_length = has_asterisk ? -1 : num_question_marks;
+
+    bool escape = false;
+    while (pos < pattern.size()) {
+      if (!escape && IsWildcard(pattern[pos])) {
+        break;
+      }
+      if (!escape && pattern[pos] == '\\') {
+        escape = true;
+        ++pos;
+        continue;
+      }
+      escape = false;
+      const size_t char_start = pos;
+      base_icu::UChar32 c;
+      CBU8_NEXT(reinterpret_cast<const uint8_t*>(pattern.data()), pos,
+                pattern.size(), c);
+      if (c == CBU_SENTINEL) {
+        matches_nothing_ = true;
+      }
+      segment.literal.append(pattern.substr(char_start, pos - char_start));
+    }
+    if (escape) {
+      // SearchForChars() treats a trailing backslash as the end of the
+      // pattern on its first attempt, but as a literal backslash on the
+      // following ones. Keep that behavior by not compiling the pattern.
+      uncompiled_pattern_ = std::string(pattern);
+      segments_.clear();
+      return;
+    }
+  } while (pos < pattern.size());
+}
+
+CompiledPattern::CompiledPattern(const CompiledPattern&) = default;
+CompiledPattern::CompiledPattern(CompiledPattern&&) = default;
+CompiledPattern& CompiledPattern::operator=(const CompiledPattern&) = default;
+CompiledPattern& CompiledPattern::operator=(CompiledPattern&&) = default;
+CompiledPattern::~CompiledPattern() = default;
+
+bool CompiledPattern::Match(std::string_view string) const {
+  if (matches_nothing_) {
+    return false;
+  }
+  if (uncompiled_pattern_) {
+    return MatchPattern(string, *uncompiled_pattern_);
+  }
+  size_t pos = 0;
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    const Segment& segment = segments_[i];
+    const std::optional<size_t> start =
+        FindLiteral(string, pos, segment.literal, segment.max_wildcard_length,
+                    /*at_end=*/i + 1 == segments_.size());
+    if (!start) {
+      return false;
+    }
+    pos = *start + segment.literal.size();
+  }
+  return true;
+}
+
+std::optional<std::string_view> CompiledPattern::GetLiteral() const {
+  if (matches_nothing_ || uncompiled_pattern_ || segments_.size() != 1 ||
+      segments_[0].max_wildcard_length != 0) {
+    return std::nullopt;
+  }
+  return segments_[0].literal;
+}
+
+PatternSet::PatternSet() = default;
+PatternSet::PatternSet(const PatternSet&) = default;
+PatternSet::PatternSet(PatternSet&&) = default;
+PatternSet& PatternSet::operator=(const PatternSet&) = default;
+PatternSet& PatternSet::operator=(PatternSet&&) = default;
+PatternSet::~PatternSet() = default;
+
+void PatternSet::Add(std::string_view pattern) {
+  CompiledPattern compiled(pattern);
+  if (std::optional<std::string_view> literal = compiled.GetLiteral()) {
+    literals_.emplace(*literal);
+    return;
+  }
+  patterns_.push_back(std::move(compiled));
+}
+
+bool PatternSet::MatchesAny(std::string_view string) const {
+  if (literals_.contains(string)) {
+    return true;
+  }
+  for (const CompiledPattern& pattern : patterns_) {
+    if (pattern.Match(string)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace base
@@ -5,7 +5,13 @@
 #ifndef BASE_STRINGS_PATTERN_H_
 #define BASE_STRINGS_PATTERN_H_
 
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "base/base_export.h"
+#include "base/containers/flat_set.h"
 #include "base/strings/string_piece.h"
 
 namespace base {
@@ -18,6 +24,65 @@ namespace base {
 BASE_EXPORT bool MatchPattern(StringPiece string, StringPiece pattern);
 BASE_EXPORT bool MatchPattern(StringPiece16 string, StringPiece16 pattern);
 
+// A UTF-8 pattern of MatchPattern(), parsed once to be matched against many
+// strings. Match() returns the same result as MatchPattern(), but looks for
+// the literal parts between the wildcards with a substring search instead of
+// reinterpreting the pattern one character at a time.
+class BASE_EXPORT CompiledPattern {
+ public:
+  explicit CompiledPattern(std::string_view pattern);
+  CompiledPattern(const CompiledPattern&);
+  CompiledPattern(CompiledPattern&&);
+  CompiledPattern& operator=(const CompiledPattern&);
+  CompiledPattern& operator=(CompiledPattern&&);
+  ~CompiledPattern();
+
+  bool Match(std::string_view string) const;
+
+  // Returns the only string matched by the pattern, if it has no wildcards.
+  std::optional<std::string_view> GetLiteral() const;
+
+ private:
+  // The wildcards at the start of the pattern or after the previous segment,
+  // followed by the unescaped characters up to the next wildcard.
+  struct Segment {
+    // The maximum number of characters matched by the wildcards, or -1 if
+    // there is a * among them.
+    int max_wildcard_length = 0;
+    std::string literal;
+  };
+
+  std::vector<Segment> segments_;
+  // Set if the pattern has invalid UTF-8, in which case it matches nothing.
+  bool matches_nothing_ = false;
+  // The pattern, if it ends with an unescaped backslash, which Match()
+  // forwards to MatchPattern() rather than emulating its quirks.
+  std::optional<std::string> uncompiled_pattern_;
+};
+
+// A set of UTF-8 patterns of MatchPattern(), for finding whether a string
+// matches any of them. The patterns without wildcards are looked up in a set
+// rather than matched one by one.
+class BASE_EXPORT PatternSet {
+ public:
+  PatternSet();
+  PatternSet(const PatternSet&);
+  PatternSet(PatternSet&&);
+  PatternSet& operator=(const PatternSet&);
+  PatternSet& operator=(PatternSet&&);
+  ~PatternSet();
+
+  void Add(std::string_view pattern);
+
+  bool MatchesAny(std::string_view string) const;
+
+  bool empty() const { return literals_.empty() && patterns_.empty(); }
+
+ private:
+  flat_set<std::string, std::less<>> literals_;
+  std::vector<CompiledPattern> patterns_;
+};
+
 }  // namespace base
 
 #endif  // BASE_STRINGS_PATTERN_H_
@@ -9,6 +9,7 @@
 
 #include <fuzzer/FuzzedDataProvider.h>
 
+#include "base/check_op.h"
 #include "base/strings/pattern.h"
 #include "base/strings/utf_string_conversions.h"
 
@@ -24,7 +25,8 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
   std::string string = provider.ConsumeRandomLengthString(kMaxLength);
   std::string pattern = provider.ConsumeRandomLengthString(kMaxLength);
 
-  std::ignore = base::MatchPattern(string, pattern);
+  const bool matches = base::MatchPattern(string, pattern);
+  CHECK_EQ(matches, base::CompiledPattern(pattern).Match(string));
   // Test the wide-string version as well. Note that the Unicode conversion
   // function skips errors (returning the best conversion possible), which is
   // good enough for the fuzzer.
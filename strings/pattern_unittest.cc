@@ -47,4 +47,62 @@ TEST(StringUtilTest, MatchPatternTest) {
   EXPECT_TRUE(MatchPattern("aaaaaaaaaaab", "a*a*a*a*a*a*a*a*a*a*a*b"));
 }
 
+TEST(StringUtilTest, CompiledPatternTest) {
+  struct {
+    const char* string;
+    const char* pattern;
+  } const kCases[] = {
+      {"www.google.com", "*.com"},
+      {"www.google.com", "*"},
+      {"www.google.com", "www*.g*.org"},
+      {"Hello", "H?l?o"},
+      {"www.msn.com", "*.COM"},
+      {"Hello*1234", "He??o\\*1*"},
+      {"", "*.*"},
+      {"", "*"},
+      {"", "?"},
+      {"", ""},
+      {"Hello", ""},
+      {"abcd", "*???"},
+      {"abcd", "???"},
+      {"abcb", "a*b"},
+      {"abcb", "a?b"},
+      {"abc", "abc\\"},
+      {"abc\\", "ab?\\"},
+      {"heart: \xe2\x99\xa0", "*\xe2\x99\xa0"},
+      {"heart: \xe2\x99\xa0.", "heart: ?."},
+      {"invalid: \xef\xbf\xbe", "invalid: ?"},
+      {"\xf4\x90\x80\x80", "\xf4\x90\x80\x80"},
+      {"aaaaaaaaaaab", "a*a*a*a*a*a*a*a*a*a*a*b"},
+  };
+  for (const auto& test_case : kCases) {
+    SCOPED_TRACE(test_case.pattern);
+    EXPECT_EQ(MatchPattern(test_case.string, test_case.pattern),
+              CompiledPattern(test_case.pattern).Match(test_case.string));
+  }
+
+  EXPECT_EQ("abc*", CompiledPattern("abc\\*").GetLiteral());
+  EXPECT_FALSE(CompiledPattern("abc*").GetLiteral());
+  EXPECT_FALSE(CompiledPattern("\xf4\x90\x80\x80").GetLiteral());
+}
+
+TEST(StringUtilTest, PatternSetTest) {
+  PatternSet patterns;
+  EXPECT_TRUE(patterns.empty());
+  EXPECT_FALSE(patterns.MatchesAny(""));
+
+  patterns.Add("net");
+  patterns.Add("disabled-by-default-*");
+  patterns.Add("gpu.?");
+  EXPECT_FALSE(patterns.empty());
+
+  EXPECT_TRUE(patterns.MatchesAny("net"));
+  EXPECT_TRUE(patterns.MatchesAny("disabled-by-default-memory"));
+  EXPECT_TRUE(patterns.MatchesAny("gpu."));
+  EXPECT_TRUE(patterns.MatchesAny("gpu.x"));
+  EXPECT_FALSE(patterns.MatchesAny("network"));
+  EXPECT_FALSE(patterns.MatchesAny("gpu.xy"));
+  EXPECT_FALSE(patterns.MatchesAny("renderer"));
+}
+
 }  // namespace base
@@ -4,9 +4,12 @@
 
 #include "base/strings/strcat.h"
 
+#include <iterator>
 #include <string>
+#include <type_traits>
 
 #include "base/strings/strcat_internal.h"
+#include "base/strings/string_number_conversions_internal.h"
 
 namespace base {
 
@@ -42,4 +45,76 @@ void StrAppend(std::u16string* dest, span<const std::u16string> pieces) {
   internal::StrAppendT(*dest, pieces);
 }
 
+namespace internal {
+
+template <typename Int>
+void StrCatArg::FormatInt(Int value) {
+  static_assert(3 * sizeof(Int) + 1 <= kBufferSize);
+  char* const end = std::end(buffer_);
+  char* i = end;
+  using UnsignedInt = std::make_unsigned_t<Int>;
+  UnsignedInt res = static_cast<UnsignedInt>(value);
+  bool negative = false;
+  if constexpr (std::is_signed_v<Int>) {
+    if (value < 0) {
+      negative = true;
+      // Negate in the unsigned type so that the minimum value doesn't
+      // overflow.
+      res = static_cast<UnsignedInt>(0u - res);
+    }
+  }
+  do {
+    *--i = static_cast<char>('0' + res % 10);
+    res /= 10;
+  } while (res != 0);
+  if (negative) {
+    *--i = '-';
+  }
+  data_ = i;
+  size_ = static_cast<size_t>(end - i);
+}
+
+StrCatArg::StrCatArg(int value) {
+  FormatInt(value);
+}
+
+StrCatArg::StrCatArg(unsigned int value) {
+  FormatInt(value);
+}
+
+StrCatArg::StrCatArg(long value) {
+  FormatInt(value);
+}
+
+StrCatArg::StrCatArg(unsigned long value) {
+  FormatInt(value);
+}
+
+StrCatArg::StrCatArg(long long value) {
+  FormatInt(value);
+}
+
+StrCatArg::StrCatArg(unsigned long long value) {
+  FormatInt(value);
+}
+
+StrCatArg::StrCatArg(double value) {
+  double_conversion::StringBuilder builder(buffer_, kBufferSize);
+  GetDoubleToStringConverter()->ToShortest(value, &builder);
+  data_ = buffer_;
+  size_ = static_cast<size_t>(builder.position());
+}
+
+std::string StrCatArgs(span<const StrCatArg> args) {
+  std::string result;
+  StrAppendT(result, args);
+  return result;
+}
+
+void StrAppendArgs(std::string* dest, span<const StrCatArg> args) {
+  StrAppendT(*dest, args);
+}
+
+}  // namespace internal
+
 }  // namespace base
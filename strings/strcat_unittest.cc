@@ -3,6 +3,15 @@
 // found in the LICENSE file.
 
 #include "base/strings/strcat.h"
+
+#include <stdint.h>
+
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -17,6 +26,49 @@ TEST(StrCat, 8Bit) {
   EXPECT_EQ("122333444455555", StrCat({"1", "22", "333", "4444", "55555"}));
 }
 
+TEST(StrCat, Variadic) {
+  const std::string str = "string";
+  const std::string_view view = "view";
+  const char* const c_str = "c_str";
+  EXPECT_EQ("literal", StrCat("literal"));
+  EXPECT_EQ("stringviewc_str", StrCat(str, view, c_str));
+  EXPECT_EQ("string1view-2c_str3.5", StrCat(str, 1, view, -2, c_str, 3.5));
+  EXPECT_EQ("", StrCat(""));
+  EXPECT_EQ("temporary", StrCat(std::string("temp"), "orary"));
+
+  // A vector still uses the span overload.
+  const std::vector<std::string> strings = {"a", "b"};
+  EXPECT_EQ("ab", StrCat(strings));
+}
+
+TEST(StrCat, VariadicIntegers) {
+  EXPECT_EQ("0", StrCat(0));
+  EXPECT_EQ("42", StrCat(uint8_t{42}));
+  EXPECT_EQ("-42", StrCat(int16_t{-42}));
+  EXPECT_EQ("4294967295", StrCat(std::numeric_limits<uint32_t>::max()));
+  EXPECT_EQ("-2147483648", StrCat(std::numeric_limits<int32_t>::min()));
+  EXPECT_EQ("18446744073709551615",
+            StrCat(std::numeric_limits<uint64_t>::max()));
+  EXPECT_EQ("-9223372036854775808",
+            StrCat(std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ("9223372036854775807",
+            StrCat(std::numeric_limits<int64_t>::max()));
+  EXPECT_EQ("12345", StrCat(size_t{12345}));
+}
+
+TEST(StrCat, VariadicDoubles) {
+  // The same as NumberToString().
+  for (double value :
+       {0.0, -0.0, 1.0, -1.5, 0.1, 1.0 / 3, 1e21, 1e-7, 123456789012.0,
+        std::numeric_limits<double>::max(), std::numeric_limits<double>::min(),
+        -std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::quiet_NaN()}) {
+    EXPECT_EQ(NumberToString(value), StrCat(value));
+  }
+  EXPECT_EQ("0.5", StrCat(0.5f));
+}
+
 TEST(StrCat, 16Bit) {
   std::u16string arg1 = u"1";
   std::u16string arg2 = u"22";
@@ -44,6 +96,16 @@ TEST(StrAppend, 8Bit) {
   EXPECT_EQ("foo122333", result);
 }
 
+TEST(StrAppend, Variadic) {
+  std::string result = "foo";
+  StrAppend(&result, "/", 1, "/", 2.5, std::string_view("/bar"));
+  EXPECT_EQ("foo/1/2.5/bar", result);
+
+  result = "foo";
+  StrAppend(&result, 12u, -3l, 4ull);
+  EXPECT_EQ("foo12-34", result);
+}
+
 TEST(StrAppend, 16Bit) {
   std::u16string arg1 = u"1";
   std::u16string arg2 = u"22";
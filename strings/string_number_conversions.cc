@@ -4,16 +4,58 @@
 
 #include "base/strings/string_number_conversions.h"
 
+#include <stdint.h>
+
+#include <cmath>
 #include <iterator>
 #include <string>
+#include <type_traits>
 
 #include "base/containers/span.h"
 #include "base/logging.h"
 #include "base/strings/string_number_conversions_internal.h"
 #include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 
 namespace base {
 
+namespace {
+
+template <typename INT>
+void AppendIntToString(INT value, std::string& output) {
+  // See IntToStringT() for the buffer size.
+  char buffer[3 * sizeof(INT) + 1];
+  char* const end = std::end(buffer);
+  char* i = end;
+  using UINT = std::make_unsigned_t<INT>;
+  // Negate in the unsigned type so that the minimum value doesn't overflow.
+  UINT res = value < 0 ? static_cast<UINT>(0u - static_cast<UINT>(value))
+                       : static_cast<UINT>(value);
+  do {
+    *--i = static_cast<char>('0' + res % 10);
+    res /= 10;
+  } while (res != 0);
+  if (value < 0) {
+    *--i = '-';
+  }
+  output.append(i, end);
+}
+
+// Powers of ten that are exactly representable as doubles.
+constexpr double kExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int kMaxExactPowerOfTen =
+    static_cast<int>(std::size(kExactPowersOfTen)) - 1;
+
+// Integers up to 2^53 are exactly representable as doubles.
+constexpr uint64_t kMaxExactMantissa = uint64_t{1} << 53;
+
+// The number of decimal digits that always fit in a uint64_t.
+constexpr int kMaxMantissaDigits = 19;
+
+}  // namespace
+
 std::string NumberToString(int value) {
   return internal::IntToStringT<std::string>(value);
 }
@@ -70,6 +112,21 @@ std::u16string NumberToString16(double value) {
   return internal::DoubleToStringT<std::u16string>(value);
 }
 
+void AppendNumberToString(int value, std::string& output) {
+  AppendIntToString(value, output);
+}
+
+void AppendNumberToString(int64_t value, std::string& output) {
+  AppendIntToString(value, output);
+}
+
+void AppendNumberToString(double value, std::string& output) {
+  char buffer[32];
+  double_conversion::StringBuilder builder(buffer, sizeof(buffer));
+  internal::GetDoubleToStringConverter()->ToShortest(value, &builder);
+  output.append(buffer, static_cast<size_t>(builder.position()));
+}
+
 bool StringToInt(StringPiece input, int* output) {
   return internal::StringToIntImpl(input, *output);
 }
@@ -119,6 +176,122 @@ bool StringToDouble(StringPiece16 input, double* output) {
       input, reinterpret_cast<const uint16_t*>(input.data()), *output);
 }
 
+bool DecimalStringToDouble(StringPiece input, double* output) {
+  const char* p = input.data();
+  const char* const end = p + input.size();
+
+  const bool negative = p != end && *p == '-';
+  if (negative) {
+    ++p;
+  }
+
+  // Accumulate up to kMaxMantissaDigits significant digits in |mantissa|, so
+  // that the value is |mantissa| * 10^|exponent|, and note whether any nonzero
+  // digits beyond those were dropped.
+  uint64_t mantissa = 0;
+  int mantissa_digits = 0;
+  int64_t exponent = 0;
+  bool truncated = false;
+  auto add_digit = [&](char c) {
+    if (mantissa_digits < kMaxMantissaDigits) {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+      // Leading zeros are not significant.
+      if (mantissa != 0) {
+        ++mantissa_digits;
+      }
+      return true;
+    }
+    truncated |= c != '0';
+    return false;
+  };
+
+  const char* const int_start = p;
+  for (; p != end && IsAsciiDigit(*p); ++p) {
+    if (!add_digit(*p)) {
+      ++exponent;
+    }
+  }
+  if (p == int_start) {
+    return false;
+  }
+
+  if (p != end && *p == '.') {
+    const char* const fraction_start = ++p;
+    for (; p != end && IsAsciiDigit(*p); ++p) {
+      if (add_digit(*p)) {
+        --exponent;
+      }
+    }
+    if (p == fraction_start) {
+      return false;
+    }
+  }
+
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    const bool negative_exponent = p != end && *p == '-';
+    if (p != end && (*p == '-' || *p == '+')) {
+      ++p;
+    }
+    const char* const exponent_start = p;
+    int64_t explicit_exponent = 0;
+    for (; p != end && IsAsciiDigit(*p); ++p) {
+      // Anything this large overflows or underflows regardless of the
+      // mantissa, so stop accumulating rather than overflow.
+      if (explicit_exponent < 100000) {
+        explicit_exponent = explicit_exponent * 10 + (*p - '0');
+      }
+    }
+    if (p == exponent_start) {
+      return false;
+    }
+    exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+  }
+
+  if (p != end) {
+    return false;
+  }
+
+#if defined(DOUBLE_CONVERSION_CORRECT_DOUBLE_OPERATIONS)
+  // Clinger's fast path: when both the mantissa and the power of ten are
+  // exactly representable, a single IEEE multiplication or division rounds
+  // correctly.
+  if (!truncated && mantissa <= kMaxExactMantissa) {
+    double value = -1;
+    if (mantissa == 0) {
+      value = 0;
+    } else if (exponent >= -kMaxExactPowerOfTen && exponent <= 0) {
+      value = static_cast<double>(mantissa) / kExactPowersOfTen[-exponent];
+    } else if (exponent >= 0 && exponent <= kMaxExactPowerOfTen) {
+      value = static_cast<double>(mantissa) * kExactPowersOfTen[exponent];
+    } else if (exponent > kMaxExactPowerOfTen &&
+               exponent <= kMaxExactPowerOfTen + kMaxMantissaDigits) {
+      // Values like 12e30 can still take the fast path if the excess power
+      // of ten can be moved into the mantissa without losing exactness.
+      uint64_t shifted = mantissa;
+      for (int64_t i = kMaxExactPowerOfTen; i < exponent; ++i) {
+        shifted *= 10;
+        if (shifted > kMaxExactMantissa) {
+          break;
+        }
+      }
+      if (shifted <= kMaxExactMantissa) {
+        value = static_cast<double>(shifted) *
+                kExactPowersOfTen[kMaxExactPowerOfTen];
+      }
+    }
+    if (value >= 0) {
+      *output = negative ? -value : value;
+      return true;
+    }
+  }
+#endif  // defined(DOUBLE_CONVERSION_CORRECT_DOUBLE_OPERATIONS)
+
+  // The syntax has been validated, so StringToDouble() will consume all of
+  // |input|; it only fails here if the value overflows.
+  return StringToDouble(input, output) && std::isfinite(*output);
+}
+
 std::string HexEncode(const void* bytes, size_t size) {
   return HexEncode(span(static_cast<const uint8_t*>(bytes), size));
 }
@@ -57,6 +57,13 @@ BASE_EXPORT std::u16string NumberToString16(unsigned long long value);
 BASE_EXPORT std::string NumberToString(double value);
 BASE_EXPORT std::u16string NumberToString16(double value);
 
+// Appends the same representation as NumberToString() to |output|, without
+// creating a temporary string. Doubles use the shortest representation that
+// round-trips through StringToDouble().
+BASE_EXPORT void AppendNumberToString(int value, std::string& output);
+BASE_EXPORT void AppendNumberToString(int64_t value, std::string& output);
+BASE_EXPORT void AppendNumberToString(double value, std::string& output);
+
 // String -> number conversions ------------------------------------------------
 
 // Perform a best-effort conversion of the input string to a numeric type,
@@ -101,6 +108,17 @@ BASE_EXPORT bool StringToSizeT(StringPiece16 input, size_t* output);
 BASE_EXPORT bool StringToDouble(StringPiece input, double* output);
 BASE_EXPORT bool StringToDouble(StringPiece16 input, double* output);
 
+// Converts a number in the strict decimal syntax used by JSON,
+//   -?[0-9]+(\.[0-9]+)?([eE][+-]?[0-9]+)?
+// to the nearest double. Unlike StringToDouble(), whitespace, a leading '+',
+// hexadecimal and non-finite values are all rejected. Inputs with at most 19
+// significant digits and a small exponent, which covers most machine-generated
+// numbers, are converted exactly by multiplying by a power of ten; the rest
+// fall back to the same algorithm as StringToDouble(). Returns false if
+// |input| does not match the syntax above or if the value is out of the range
+// of a double, in which case |*output| is unspecified.
+BASE_EXPORT bool DecimalStringToDouble(StringPiece input, double* output);
+
 // Hex encoding ----------------------------------------------------------------
 
 // Returns a hex string representation of a binary buffer. The returned hex
@@ -924,6 +924,101 @@ TEST(StringNumberConversionsTest, DoubleToString) {
   EXPECT_EQ("1.33489033216e+12", NumberToString(input));
 }
 
+TEST(StringNumberConversionsTest, AppendNumberToString) {
+  std::string output = "x";
+  AppendNumberToString(0, output);
+  AppendNumberToString(-42, output);
+  AppendNumberToString(std::numeric_limits<int>::min(), output);
+  EXPECT_EQ("x0-42-2147483648", output);
+
+  output.clear();
+  AppendNumberToString(std::numeric_limits<int64_t>::min(), output);
+  EXPECT_EQ("-9223372036854775808", output);
+  output.clear();
+  AppendNumberToString(std::numeric_limits<int64_t>::max(), output);
+  EXPECT_EQ("9223372036854775807", output);
+
+  for (double value : {0.0, 0.5, -1.25, 1.33518e+012, 0.1, 1e300, 5e-324}) {
+    output = "prefix";
+    AppendNumberToString(value, output);
+    EXPECT_EQ("prefix" + NumberToString(value), output);
+  }
+}
+
+TEST(StringNumberConversionsTest, DecimalStringToDouble) {
+  static const struct {
+    const char* input;
+    double output;
+  } cases[] = {
+      {"0", 0.0},
+      {"-0", -0.0},
+      {"0.0", 0.0},
+      {"00012", 12.0},
+      {"1", 1.0},
+      {"-1.5", -1.5},
+      {"0.1", 0.1},
+      {"0.001", 0.001},
+      {"3.14159", 3.14159},
+      {"1e10", 1e10},
+      {"1E+10", 1e10},
+      {"1e-10", 1e-10},
+      {"12e30", 12e30},
+      {"1e23", 1e23},
+      {"9007199254740992", 9007199254740992.0},
+      {"9007199254740993", 9007199254740992.0},
+      {"123456789012345678901234567890", 1.2345678901234568e+29},
+      {"2.2250738585072011e-308", 2.2250738585072011e-308},
+      {"4.9406564584124654e-324", 5e-324},
+      {"1.7976931348623157e308", 1.7976931348623157e308},
+      {"1e-400", 0.0},
+      {"0e99999999999", 0.0},
+  };
+  for (const auto& test : cases) {
+    SCOPED_TRACE(test.input);
+    double output;
+    ASSERT_TRUE(DecimalStringToDouble(test.input, &output));
+    EXPECT_EQ(test.output, output);
+    EXPECT_EQ(std::signbit(test.output), std::signbit(output));
+  }
+
+  static const char* const kInvalid[] = {
+      "",    " 1",  "1 ",    "+1",     "-",     ".5",  "5.",  "1e",  "1e+",
+      "1x",  "0x1", "inf",   "nan",    "1e400", "-1e400", "1.5.2", "--1",
+  };
+  for (const char* input : kInvalid) {
+    double output;
+    EXPECT_FALSE(DecimalStringToDouble(input, &output)) << input;
+  }
+}
+
+TEST(StringNumberConversionsTest, DecimalStringToDoubleMatchesStringToDouble) {
+  // Exercise both the fast path and the fallback with a range of mantissas,
+  // lengths and exponents.
+  const uint64_t kMantissas[] = {1,
+                                 7,
+                                 123456789,
+                                 9007199254740991,
+                                 9007199254740993,
+                                 12345678901234567,
+                                 9999999999999999999u};
+  for (uint64_t mantissa : kMantissas) {
+    for (int exponent = -330; exponent <= 310; ++exponent) {
+      for (const char* format : {"%" PRIu64 "e%d", "0.%" PRIu64 "e%d"}) {
+        std::string input = StringPrintf(format, mantissa, exponent);
+        SCOPED_TRACE(input);
+        double expected;
+        bool expected_ok =
+            StringToDouble(input, &expected) && std::isfinite(expected);
+        double output;
+        ASSERT_EQ(expected_ok, DecimalStringToDouble(input, &output));
+        if (expected_ok) {
+          EXPECT_EQ(expected, output);
+        }
+      }
+    }
+  }
+}
+
 TEST(StringNumberConversionsTest, AppendHexEncodedByte) {
   std::string hex;
   AppendHexEncodedByte(0, hex);
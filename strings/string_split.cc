@@ -47,6 +47,18 @@ bool AppendStringKeyValue(StringPiece input,
 
 }  // namespace
 
+namespace internal {
+
+StringPiece TrimSplitPiece(StringPiece piece) {
+  return TrimString(piece, kWhitespaceASCII, TRIM_ALL);
+}
+
+StringPiece16 TrimSplitPiece(StringPiece16 piece) {
+  return TrimString(piece, kWhitespaceUTF16, TRIM_ALL);
+}
+
+}  // namespace internal
+
 std::vector<std::string> SplitString(StringPiece input,
                                      StringPiece separators,
                                      WhitespaceHandling whitespace,
@@ -83,9 +95,20 @@ bool SplitStringIntoKeyValuePairs(StringPiece input,
                                   char key_value_delimiter,
                                   char key_value_pair_delimiter,
                                   StringPairs* key_value_pairs) {
-  return SplitStringIntoKeyValuePairsUsingSubstr(
-      input, key_value_delimiter, StringPiece(&key_value_pair_delimiter, 1),
-      key_value_pairs);
+  key_value_pairs->clear();
+
+  // Equivalent to splitting on the substring of the one delimiter, but without
+  // a vector of the pairs.
+  bool success = true;
+  for (StringPiece pair :
+       SplitStringLazy(input, StringPiece(&key_value_pair_delimiter, 1),
+                       TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY)) {
+    if (!AppendStringKeyValue(pair, key_value_delimiter, key_value_pairs)) {
+      // As below, don't return here.
+      success = false;
+    }
+  }
+  return success;
 }
 
 bool SplitStringIntoKeyValuePairsUsingSubstr(
@@ -5,11 +5,16 @@
 #ifndef BASE_STRINGS_STRING_SPLIT_H_
 #define BASE_STRINGS_STRING_SPLIT_H_
 
+#include <stddef.h>
+
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "base/base_export.h"
+#include "base/memory/raw_ptr_exclusion.h"
 #include "base/strings/string_piece.h"
 #include "build/build_config.h"
 
@@ -81,6 +86,150 @@ enum SplitResult {
     WhitespaceHandling whitespace,
     SplitResult result_type);
 
+namespace internal {
+
+// Trims the whitespace of a piece for TRIM_WHITESPACE. Out of line so that
+// this header needn't include string_util.h.
+BASE_EXPORT StringPiece TrimSplitPiece(StringPiece piece);
+BASE_EXPORT StringPiece16 TrimSplitPiece(StringPiece16 piece);
+#if BUILDFLAG(IS_WIN)
+BASE_EXPORT std::wstring_view TrimSplitPiece(std::wstring_view piece);
+#endif
+
+}  // namespace internal
+
+// The range returned by SplitStringLazy(). It finds the pieces one at a time
+// as it is iterated, like SplitStringPiece() would return them, but without
+// building a vector. The pieces reference the input, which must outlive the
+// range, as must the separators.
+template <typename CharT>
+class SplitStringRange {
+ public:
+  using Piece = std::basic_string_view<CharT>;
+
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Piece;
+    using difference_type = ptrdiff_t;
+    using pointer = const Piece*;
+    using reference = const Piece&;
+
+    // The end iterator.
+    Iterator() = default;
+
+    reference operator*() const { return piece_; }
+    pointer operator->() const { return &piece_; }
+
+    Iterator& operator++() {
+      Advance();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      Advance();
+      return copy;
+    }
+
+    friend bool operator==(const Iterator& a, const Iterator& b) {
+      return a.start_ == b.start_ && a.piece_.data() == b.piece_.data();
+    }
+
+   private:
+    friend class SplitStringRange;
+
+    explicit Iterator(const SplitStringRange* range)
+        : range_(range), start_(range->input_.empty() ? Piece::npos : 0) {
+      Advance();
+    }
+
+    // Moves to the next piece which `result_type` wants, or to the end.
+    void Advance() {
+      const Piece input = range_->input_;
+      while (start_ != Piece::npos) {
+        // With a single separator, find() is a memchr() for 8-bit strings,
+        // which the C library vectorizes.
+        const size_t end = range_->separators_.size() == 1
+                               ? input.find(range_->separators_[0], start_)
+                               : input.find_first_of(range_->separators_,
+                                                     start_);
+        Piece piece;
+        if (end == Piece::npos) {
+          piece = input.substr(start_);
+          start_ = Piece::npos;
+        } else {
+          piece = input.substr(start_, end - start_);
+          start_ = end + 1;
+        }
+        if (range_->whitespace_ == TRIM_WHITESPACE) {
+          piece = internal::TrimSplitPiece(piece);
+        }
+        if (range_->result_type_ == SPLIT_WANT_ALL || !piece.empty()) {
+          piece_ = piece;
+          return;
+        }
+      }
+      // The end: like a default-constructed iterator.
+      piece_ = Piece();
+      start_ = kEnd;
+    }
+
+    // Distinct from npos, which marks the last piece.
+    static constexpr size_t kEnd = Piece::npos - 1;
+
+    // Not raw_ptr<> for performance: the iterators live on the stack, in
+    // loops over the range.
+    RAW_PTR_EXCLUSION const SplitStringRange* range_ = nullptr;
+    // Where the search for the next piece starts.
+    size_t start_ = kEnd;
+    Piece piece_;
+  };
+
+  SplitStringRange(Piece input,
+                   Piece separators,
+                   WhitespaceHandling whitespace,
+                   SplitResult result_type)
+      : input_(input),
+        separators_(separators),
+        whitespace_(whitespace),
+        result_type_(result_type) {}
+
+  Iterator begin() const { return Iterator(this); }
+  Iterator end() const { return Iterator(); }
+
+ private:
+  Piece input_;
+  Piece separators_;
+  WhitespaceHandling whitespace_;
+  SplitResult result_type_;
+};
+
+// Like SplitStringPiece(), but returns a range which yields the pieces as it
+// is iterated rather than a vector, so that loops over them don't allocate:
+//
+//   for (StringPiece header_line :
+//        base::SplitStringLazy(headers, "\n", base::TRIM_WHITESPACE,
+//                              base::SPLIT_WANT_NONEMPTY)) {
+//     ...
+//
+// The range references `input` and `separators`, so, unlike with
+// SplitStringPiece(), both must outlive it.
+[[nodiscard]] inline SplitStringRange<char> SplitStringLazy(
+    StringPiece input,
+    StringPiece separators,
+    WhitespaceHandling whitespace,
+    SplitResult result_type) {
+  return SplitStringRange<char>(input, separators, whitespace, result_type);
+}
+[[nodiscard]] inline SplitStringRange<char16_t> SplitStringLazy(
+    StringPiece16 input,
+    StringPiece16 separators,
+    WhitespaceHandling whitespace,
+    SplitResult result_type) {
+  return SplitStringRange<char16_t>(input, separators, whitespace,
+                                    result_type);
+}
+
 using StringPairs = std::vector<std::pair<std::string, std::string>>;
 
 // Splits |line| into key value pairs according to the given delimiters and
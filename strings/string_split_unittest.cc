@@ -451,4 +451,64 @@ TEST(StringSplitTest, SplitStringAlongWhitespace) {
   }
 }
 
+TEST(StringSplitTest, SplitStringLazy) {
+  std::vector<StringPiece> r;
+  for (StringPiece piece :
+       SplitStringLazy("a,b;;c", ",;", KEEP_WHITESPACE, SPLIT_WANT_ALL)) {
+    r.push_back(piece);
+  }
+  EXPECT_THAT(r, ElementsAre("a", "b", "", "c"));
+
+  r.clear();
+  for (StringPiece piece : SplitStringLazy(" a , ,b, ", ",", TRIM_WHITESPACE,
+                                           SPLIT_WANT_NONEMPTY)) {
+    r.push_back(piece);
+  }
+  EXPECT_THAT(r, ElementsAre("a", "b"));
+
+  auto empty = SplitStringLazy("", ",", KEEP_WHITESPACE, SPLIT_WANT_ALL);
+  EXPECT_EQ(empty.begin(), empty.end());
+  auto only_separators =
+      SplitStringLazy(",,", ",", KEEP_WHITESPACE, SPLIT_WANT_NONEMPTY);
+  EXPECT_EQ(only_separators.begin(), only_separators.end());
+
+  // The iterators are forward iterators.
+  auto range = SplitStringLazy("x y", " ", KEEP_WHITESPACE, SPLIT_WANT_ALL);
+  auto it = range.begin();
+  auto copy = it++;
+  EXPECT_EQ("x", *copy);
+  EXPECT_EQ("y", *it);
+  EXPECT_EQ(1u, it->size());
+  EXPECT_EQ(range.end(), ++it);
+  EXPECT_EQ(2, std::distance(range.begin(), range.end()));
+}
+
+TEST(StringSplitTest, SplitStringLazyMatchesSplitStringPiece) {
+  const char* const kInputs[] = {"",     ",",    " , ",  "a",   ",a,",
+                                 "a,,b", " a;b", "a\tb ", ";;a;", "a b, c"};
+  const char* const kSeparators[] = {"", ",", ",;", " \t"};
+  for (const char* input : kInputs) {
+    for (const char* separators : kSeparators) {
+      for (WhitespaceHandling whitespace : {KEEP_WHITESPACE, TRIM_WHITESPACE}) {
+        for (SplitResult result_type : {SPLIT_WANT_ALL, SPLIT_WANT_NONEMPTY}) {
+          auto range =
+              SplitStringLazy(input, separators, whitespace, result_type);
+          EXPECT_EQ(
+              SplitStringPiece(input, separators, whitespace, result_type),
+              std::vector<StringPiece>(range.begin(), range.end()))
+              << input << " " << separators;
+
+          const std::u16string input16 = UTF8ToUTF16(input);
+          const std::u16string separators16 = UTF8ToUTF16(separators);
+          auto range16 =
+              SplitStringLazy(input16, separators16, whitespace, result_type);
+          EXPECT_EQ(SplitStringPiece(input16, separators16, whitespace,
+                                     result_type),
+                    std::vector<StringPiece16>(range16.begin(), range16.end()));
+        }
+      }
+    }
+  }
+}
+
 }  // namespace base
@@ -20,6 +20,10 @@ inline std::wstring_view WhitespaceForType<wchar_t>() {
   return kWhitespaceWide;
 }
 
+std::wstring_view TrimSplitPiece(std::wstring_view piece) {
+  return TrimString(piece, kWhitespaceWide, TRIM_ALL);
+}
+
 }  // namespace internal
 
 std::vector<std::wstring> SplitString(std::wstring_view input,
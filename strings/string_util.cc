@@ -28,8 +28,10 @@
 #include "base/check_op.h"
 #include "base/no_destructor.h"
 #include "base/ranges/algorithm.h"
+#include "base/strings/ascii_case_internal.h"
 #include "base/strings/string_util_impl_helpers.h"
 #include "base/strings/string_util_internal.h"
+#include "base/strings/utf8_validation_internal.h"
 #include "base/strings/utf_string_conversion_utils.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/third_party/icu/icu_utf.h"
@@ -73,7 +75,9 @@ bool IsWprintfFormatPortable(const wchar_t* format) {
 }
 
 std::string ToLowerASCII(StringPiece str) {
-  return internal::ToLowerASCIIImpl(str);
+  std::string ret(str.size(), '\0');
+  internal::ToLowerAscii(str, ret);
+  return ret;
 }
 
 std::u16string ToLowerASCII(StringPiece16 str) {
@@ -81,7 +85,9 @@ std::u16string ToLowerASCII(StringPiece16 str) {
 }
 
 std::string ToUpperASCII(StringPiece str) {
-  return internal::ToUpperASCIIImpl(str);
+  std::string ret(str.size(), '\0');
+  internal::ToUpperAscii(str, ret);
+  return ret;
 }
 
 std::u16string ToUpperASCII(StringPiece16 str) {
@@ -232,7 +238,7 @@ bool ContainsOnlyChars(StringPiece16 input, StringPiece16 characters) {
 
 
 bool IsStringASCII(StringPiece str) {
-  return internal::DoIsStringASCII(str.data(), str.length());
+  return internal::IsAscii(as_byte_span(str));
 }
 
 bool IsStringASCII(StringPiece16 str) {
@@ -246,17 +252,39 @@ bool IsStringASCII(std::wstring_view str) {
 #endif
 
 bool IsStringUTF8(StringPiece str) {
-  return internal::DoIsStringUTF8<IsValidCharacter>(str);
+  switch (internal::ValidateUtf8(as_byte_span(str))) {
+    case internal::Utf8Validity::kInvalid:
+      return false;
+    case internal::Utf8Validity::kValid:
+      return true;
+    case internal::Utf8Validity::kValidMaybeNoncharacters:
+      return internal::DoIsStringUTF8<IsValidCharacter>(str);
+  }
 }
 
 bool IsStringUTF8AllowingNoncharacters(StringPiece str) {
-  return internal::DoIsStringUTF8<IsValidCodepoint>(str);
+  return internal::ValidateUtf8(as_byte_span(str)) !=
+         internal::Utf8Validity::kInvalid;
 }
 
 bool EqualsASCII(StringPiece16 str, StringPiece ascii) {
   return ranges::equal(ascii, str);
 }
 
+size_t FindCaseInsensitiveASCII(StringPiece str,
+                                StringPiece search_for,
+                                size_t start_pos) {
+  if (start_pos > str.size()) {
+    return StringPiece::npos;
+  }
+  if (search_for.empty()) {
+    return start_pos;
+  }
+  const size_t offset =
+      internal::FindCaseInsensitiveAscii(str.substr(start_pos), search_for);
+  return offset == StringPiece::npos ? offset : start_pos + offset;
+}
+
 bool StartsWith(StringPiece str,
                 StringPiece search_for,
                 CompareCase case_sensitivity) {
@@ -356,6 +384,18 @@ void ReplaceSubstringsAfterOffset(std::string* str,
       replace_with, internal::ReplaceType::REPLACE_ALL);
 }
 
+void ReplaceSubstrings(
+    std::u16string* str,
+    span<const std::pair<StringPiece16, StringPiece16>> replacements) {
+  internal::DoReplaceSubstrings(str, replacements);
+}
+
+void ReplaceSubstrings(
+    std::string* str,
+    span<const std::pair<StringPiece, StringPiece>> replacements) {
+  internal::DoReplaceSubstrings(str, replacements);
+}
+
 char* WriteInto(std::string* str, size_t length_with_null) {
   return internal::WriteIntoT(str, length_with_null);
 }
@@ -21,12 +21,15 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "base/base_export.h"
 #include "base/check_op.h"
 #include "base/compiler_specific.h"
 #include "base/containers/span.h"
+#include "base/strings/ascii_case_internal.h"
 #include "base/strings/string_piece.h"  // For implicit conversions.
 #include "base/strings/string_util_internal.h"
 #include "base/types/to_address.h"
@@ -177,7 +180,10 @@ template<typename Char> struct CaseInsensitiveCompareASCII {
 // will be compared unmodified.
 BASE_EXPORT constexpr int CompareCaseInsensitiveASCII(StringPiece a,
                                                       StringPiece b) {
-  return internal::CompareCaseInsensitiveASCIIT(a, b);
+  if (std::is_constant_evaluated()) {
+    return internal::CompareCaseInsensitiveASCIIT(a, b);
+  }
+  return internal::CompareCaseInsensitiveAscii(a, b);
 }
 BASE_EXPORT constexpr int CompareCaseInsensitiveASCII(StringPiece16 a,
                                                       StringPiece16 b) {
@@ -190,7 +196,7 @@ BASE_EXPORT constexpr int CompareCaseInsensitiveASCII(StringPiece16 a,
 // base::i18n::ToLower or base::i18n::FoldCase and then compare with either ==
 // or !=.
 inline bool EqualsCaseInsensitiveASCII(StringPiece a, StringPiece b) {
-  return internal::EqualsCaseInsensitiveASCIIT(a, b);
+  return internal::EqualsCaseInsensitiveAscii(a, b);
 }
 inline bool EqualsCaseInsensitiveASCII(StringPiece16 a, StringPiece16 b) {
   return internal::EqualsCaseInsensitiveASCIIT(a, b);
@@ -202,6 +208,14 @@ inline bool EqualsCaseInsensitiveASCII(StringPiece a, StringPiece16 b) {
   return internal::EqualsCaseInsensitiveASCIIT(a, b);
 }
 
+// Returns the offset of the first occurrence of `search_for` in `str` at or
+// after `start_pos`, ignoring ASCII case, or StringPiece::npos. Like
+// StringPiece::find(), an empty `search_for` is found at `start_pos` if that
+// is within `str`. Non-ASCII bytes are compared unmodified.
+BASE_EXPORT size_t FindCaseInsensitiveASCII(StringPiece str,
+                                            StringPiece search_for,
+                                            size_t start_pos = 0);
+
 // These threadsafe functions return references to globally unique empty
 // strings.
 //
@@ -530,6 +544,21 @@ BASE_EXPORT void ReplaceSubstringsAfterOffset(
     StringPiece find_this,
     StringPiece replace_with);
 
+// Replaces, in a single pass over |str|, every instance of the first string of
+// each pair of |replacements| with the second. This is faster than calling
+// ReplaceSubstringsAfterOffset() for each pair, and at each position of |str|,
+// the longest pattern which matches there is replaced; the replacements aren't
+// searched for more patterns. Empty patterns are ignored. For example:
+//   static constexpr std::pair<StringPiece, StringPiece> kEscapes[] = {
+//       {"&", "&amp;"}, {"<", "&lt;"}, {">", "&gt;"}};
+//   base::ReplaceSubstrings(&html, kEscapes);
+BASE_EXPORT void ReplaceSubstrings(
+    std::u16string* str,
+    span<const std::pair<StringPiece16, StringPiece16>> replacements);
+BASE_EXPORT void ReplaceSubstrings(
+    std::string* str,
+    span<const std::pair<StringPiece, StringPiece>> replacements);
+
 // Reserves enough memory in |str| to accommodate |length_with_null| characters,
 // sets the size of |str| to |length_with_null - 1| characters, and returns a
 // pointer to the underlying contiguous array of characters.  This is typically
@@ -10,12 +10,20 @@
 #ifndef BASE_STRINGS_STRING_UTIL_IMPL_HELPERS_H_
 #define BASE_STRINGS_STRING_UTIL_IMPL_HELPERS_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <algorithm>
+#include <array>
 #include <optional>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "base/check.h"
 #include "base/check_op.h"
+#include "base/containers/span.h"
 #include "base/logging.h"
 #include "base/notreached.h"
 #include "base/ranges/algorithm.h"
@@ -233,8 +241,7 @@ bool StartsWithT(T str, T search_for, CompareCase case_sensitivity) {
       return source == search_for;
 
     case CompareCase::INSENSITIVE_ASCII:
-      return std::equal(search_for.begin(), search_for.end(), source.begin(),
-                        CaseInsensitiveCompareASCII<CharT>());
+      return EqualsCaseInsensitiveASCII(source, search_for);
   }
 }
 
@@ -251,8 +258,7 @@ bool EndsWithT(T str, T search_for, CompareCase case_sensitivity) {
       return source == search_for;
 
     case CompareCase::INSENSITIVE_ASCII:
-      return std::equal(source.begin(), source.end(), search_for.begin(),
-                        CaseInsensitiveCompareASCII<CharT>());
+      return EqualsCaseInsensitiveASCII(source, search_for);
   }
 }
 
@@ -442,6 +448,110 @@ bool DoReplaceMatchesAfterOffset(std::basic_string<CharT>* str,
   return true;
 }
 
+// Implements ReplaceSubstrings(). The patterns are bucketed by the low byte
+// of their first character, longest first, so that each position of `str` is
+// only compared with the patterns which can match there; this is a one-level
+// trie, which suits the handful of patterns of escaping and templating code.
+// The first pass computes the size of the result, and the second builds it in
+// a single allocation.
+template <typename CharT>
+void DoReplaceSubstrings(
+    std::basic_string<CharT>* str,
+    span<const std::pair<std::basic_string_view<CharT>,
+                         std::basic_string_view<CharT>>> replacements) {
+  using Piece = std::basic_string_view<CharT>;
+  using CharTraits = std::char_traits<CharT>;
+
+  std::vector<size_t> order;
+  for (size_t i = 0; i < replacements.size(); ++i) {
+    if (!replacements[i].first.empty()) {
+      order.push_back(i);
+    }
+  }
+  if (order.empty()) {
+    return;
+  }
+  if (order.size() == 1) {
+    const auto& [find_this, replace_with] = replacements[order[0]];
+    DoReplaceMatchesAfterOffset(str, 0, MakeSubstringMatcher(find_this),
+                                replace_with, ReplaceType::REPLACE_ALL);
+    return;
+  }
+
+  const auto bucket = [](CharT c) {
+    return static_cast<uint8_t>(static_cast<std::make_unsigned_t<CharT>>(c));
+  };
+  // Among the patterns of a bucket, the longest is tried first, then the
+  // earliest in `replacements`.
+  ranges::stable_sort(order, [&](size_t a, size_t b) {
+    const Piece pattern_a = replacements[a].first;
+    const Piece pattern_b = replacements[b].first;
+    if (bucket(pattern_a[0]) != bucket(pattern_b[0])) {
+      return bucket(pattern_a[0]) < bucket(pattern_b[0]);
+    }
+    return pattern_a.size() > pattern_b.size();
+  });
+  // The patterns of bucket `b` are order[bucket_starts[b]..bucket_starts[b+1]).
+  std::array<size_t, 257> bucket_starts = {};
+  for (size_t index : order) {
+    ++bucket_starts[bucket(replacements[index].first[0]) + 1u];
+  }
+  for (size_t b = 1; b < bucket_starts.size(); ++b) {
+    bucket_starts[b] += bucket_starts[b - 1];
+  }
+
+  const Piece input(*str);
+  // Returns the index in `replacements` of the pattern found at `pos`, or
+  // npos.
+  const auto match_at = [&](size_t pos) {
+    const uint8_t b = bucket(input[pos]);
+    for (size_t i = bucket_starts[b]; i < bucket_starts[b + 1u]; ++i) {
+      const Piece pattern = replacements[order[i]].first;
+      if (pattern.size() <= input.size() - pos &&
+          CharTraits::compare(input.data() + pos, pattern.data(),
+                              pattern.size()) == 0) {
+        return order[i];
+      }
+    }
+    return Piece::npos;
+  };
+
+  size_t final_length = 0;
+  bool found = false;
+  for (size_t pos = 0; pos < input.size();) {
+    const size_t match = match_at(pos);
+    if (match == Piece::npos) {
+      ++final_length;
+      ++pos;
+    } else {
+      final_length += replacements[match].second.size();
+      pos += replacements[match].first.size();
+      found = true;
+    }
+  }
+  if (!found) {
+    return;
+  }
+
+  std::basic_string<CharT> result(str->get_allocator());
+  result.reserve(final_length);
+  size_t copied = 0;
+  for (size_t pos = 0; pos < input.size();) {
+    const size_t match = match_at(pos);
+    if (match == Piece::npos) {
+      ++pos;
+      continue;
+    }
+    result.append(input.substr(copied, pos - copied));
+    result.append(replacements[match].second);
+    pos += replacements[match].first.size();
+    copied = pos;
+  }
+  result.append(input.substr(copied));
+  DCHECK_EQ(result.size(), final_length);
+  str->swap(result);
+}
+
 template <typename T, typename CharT = typename T::value_type>
 bool ReplaceCharsT(T input,
                    T find_any_of_these,
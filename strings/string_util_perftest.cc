@@ -4,7 +4,10 @@
 
 #include "base/strings/string_util.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <string>
+#include <string_view>
 
 #include "base/time/time.h"
 #include "build/build_config.h"
@@ -43,4 +46,88 @@ TEST(StringUtilTest, DISABLED_IsStringASCIIPerf) {
   }
 }
 
+void MeasureIsStringUTF8(std::string_view description,
+                         std::string_view unit,
+                         size_t str_length) {
+  std::string str;
+  while (str.size() + unit.size() <= str_length) {
+    str += unit;
+  }
+
+  const size_t iterations =
+      (size_t{1} << 28) / std::max<size_t>(str_length, 64);
+  TimeTicks t0 = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i) {
+    IsStringUTF8(str);
+  }
+  TimeDelta time = TimeTicks::Now() - t0;
+  printf("content:\t%s\tlength:\t%zu\tMB/s:\t%.0f\n",
+         std::string(description).c_str(), str.size(),
+         static_cast<double>(str.size() * iterations) / time.InMicrosecondsF());
+}
+
+TEST(StringUtilTest, DISABLED_IsStringUTF8Perf) {
+  for (size_t str_length = 16; str_length <= 65536; str_length *= 4) {
+    MeasureIsStringUTF8("ascii", "abcdefgh", str_length);
+    MeasureIsStringUTF8("latin", "abc\xC3\xA9", str_length);
+    MeasureIsStringUTF8("cjk", "\xE3\x81\x82", str_length);
+    MeasureIsStringUTF8("emoji", "\xF0\x9F\x98\x80", str_length);
+    MeasureIsStringUTF8("noncharacters", "a\xEF\xBF\xBF", str_length);
+  }
+}
+
+// Runs `op` on `str_length` bytes enough times to take a measurable time, and
+// prints its throughput.
+template <typename Op>
+void MeasureCaseInsensitive(const char* description,
+                            size_t str_length,
+                            Op op) {
+  const size_t iterations =
+      (size_t{1} << 28) / std::max<size_t>(str_length, 64);
+  TimeTicks t0 = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i) {
+    op();
+  }
+  TimeDelta time = TimeTicks::Now() - t0;
+  printf("op:\t%s\tlength:\t%zu\tMB/s:\t%.0f\tns/op:\t%.1f\n", description,
+         str_length,
+         static_cast<double>(str_length * iterations) / time.InMicrosecondsF(),
+         time.InMicrosecondsF() * 1000 / static_cast<double>(iterations));
+}
+
+TEST(StringUtilTest, DISABLED_CaseInsensitiveASCIIPerf) {
+  // Header names and values, and bodies of a few KB.
+  for (size_t str_length : {12u, 40u, 4096u, 65536u}) {
+    std::string lower;
+    while (lower.size() < str_length) {
+      lower += "content-type: text/html; charset=utf-8\r\n";
+    }
+    lower.resize(str_length);
+    const std::string upper = ToUpperASCII(lower);
+    // Matches only at the end.
+    const std::string needle =
+        "X-" + ToUpperASCII(lower.substr(0, std::min<size_t>(10, str_length)));
+    const std::string haystack = lower + ToLowerASCII(needle);
+
+    volatile int result = 0;
+    MeasureCaseInsensitive("CompareCaseInsensitiveASCII", str_length, [&] {
+      result = result + CompareCaseInsensitiveASCII(lower, upper);
+    });
+    MeasureCaseInsensitive("EqualsCaseInsensitiveASCII", str_length, [&] {
+      result = result + EqualsCaseInsensitiveASCII(lower, upper);
+    });
+    MeasureCaseInsensitive("StartsWith", str_length, [&] {
+      result =
+          result + StartsWith(lower, upper, CompareCase::INSENSITIVE_ASCII);
+    });
+    MeasureCaseInsensitive("ToLowerASCII", str_length, [&] {
+      result = result + static_cast<int>(ToLowerASCII(upper).size());
+    });
+    MeasureCaseInsensitive("FindCaseInsensitiveASCII", str_length, [&] {
+      result = result +
+               static_cast<int>(FindCaseInsensitiveASCII(haystack, needle));
+    });
+  }
+}
+
 }  // namespace base
@@ -773,6 +773,45 @@ TEST(StringUtilTest, ReplaceSubstringsAfterOffset) {
   }
 }
 
+TEST(StringUtilTest, ReplaceSubstrings) {
+  static constexpr std::pair<StringPiece, StringPiece> kEscapes[] = {
+      {"&", "&amp;"}, {"<", "&lt;"}, {">", "&gt;"}};
+  std::string str = "<a href=\"?x&y\">";
+  ReplaceSubstrings(&str, kEscapes);
+  EXPECT_EQ("&lt;a href=\"?x&amp;y\"&gt;", str);
+
+  // The replacements aren't searched for patterns.
+  str = "ab";
+  static constexpr std::pair<StringPiece, StringPiece> kSwap[] = {{"a", "b"},
+                                                                   {"b", "a"}};
+  ReplaceSubstrings(&str, kSwap);
+  EXPECT_EQ("ba", str);
+
+  // The longest pattern wins, then the first one, and empty patterns are
+  // ignored.
+  static constexpr std::pair<StringPiece, StringPiece> kOverlapping[] = {
+      {"", "!"}, {"a", "1"}, {"aa", "2"}, {"aab", "3"}, {"a", "4"}};
+  str = "aaabaaxa";
+  ReplaceSubstrings(&str, kOverlapping);
+  EXPECT_EQ("21b2x1", str);
+
+  // Patterns whose first characters share a low byte.
+  std::u16string str16 = u"\u0161a\u0261b";
+  const std::pair<StringPiece16, StringPiece16> kWide[] = {
+      {u"\u0161", u"s"}, {u"\u0261b", u"gb"}, {u"a", u""}};
+  ReplaceSubstrings(&str16, kWide);
+  EXPECT_EQ(u"sgb", str16);
+
+  // Without a match, or with a single pattern.
+  str = "abc";
+  ReplaceSubstrings(&str, kEscapes);
+  EXPECT_EQ("abc", str);
+  ReplaceSubstrings(&str, span(kSwap).first(1u));
+  EXPECT_EQ("bbc", str);
+  ReplaceSubstrings(&str, {});
+  EXPECT_EQ("bbc", str);
+}
+
 TEST(StringUtilTest, ReplaceFirstSubstringAfterOffset) {
   static const struct {
     const char* str;
@@ -1547,6 +1586,37 @@ TEST(StringUtilTest, EqualsCaseInsensitiveASCII) {
 #endif
 }
 
+TEST(StringUtilTest, FindCaseInsensitiveASCII) {
+  EXPECT_EQ(0u, FindCaseInsensitiveASCII("", ""));
+  EXPECT_EQ(0u, FindCaseInsensitiveASCII("Content-Type", ""));
+  EXPECT_EQ(3u, FindCaseInsensitiveASCII("Content-Type", "", 3));
+  EXPECT_EQ(12u, FindCaseInsensitiveASCII("Content-Type", "", 12));
+  EXPECT_EQ(StringPiece::npos,
+            FindCaseInsensitiveASCII("Content-Type", "", 13));
+
+  EXPECT_EQ(0u, FindCaseInsensitiveASCII("Content-Type", "CONTENT"));
+  EXPECT_EQ(8u, FindCaseInsensitiveASCII("Content-Type", "type"));
+  EXPECT_EQ(8u, FindCaseInsensitiveASCII("Content-Type", "t", 7));
+  EXPECT_EQ(StringPiece::npos, FindCaseInsensitiveASCII("Content-Type", "x"));
+  EXPECT_EQ(StringPiece::npos,
+            FindCaseInsensitiveASCII("Content-Type", "Content-Types"));
+  EXPECT_EQ(StringPiece::npos,
+            FindCaseInsensitiveASCII("Content-Type", "content", 1));
+
+  // Longer than a vector, with near misses before the match.
+  const std::string haystack =
+      std::string(100, 'a') + "Chunked" + std::string(3, 'c') +
+      "tranSfer-Encodin;transfer-encodinG: chunked";
+  EXPECT_EQ(127u, FindCaseInsensitiveASCII(haystack, "Transfer-Encoding"));
+  EXPECT_EQ(100u, FindCaseInsensitiveASCII(haystack, "chunked"));
+  EXPECT_EQ(146u, FindCaseInsensitiveASCII(haystack, "chunked", 101));
+
+  // Non-ASCII bytes are permitted, but they will be compared case-sensitively.
+  EXPECT_EQ(4u, FindCaseInsensitiveASCII("aaa \xc3\xa4", "\xc3\xa4"));
+  EXPECT_EQ(StringPiece::npos,
+            FindCaseInsensitiveASCII("aaa \xc3\xa4", "\xc3\x84"));
+}
+
 TEST(StringUtilTest, IsUnicodeWhitespace) {
   // NOT unicode white space.
   EXPECT_FALSE(IsUnicodeWhitespace(L'\0'));
@@ -0,0 +1,425 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifdef UNSAFE_BUFFERS_BUILD
+// TODO(crbug.com/40284755): Remove this and spanify to fix the errors.
+#pragma allow_unsafe_buffers
+#endif
+
+#include "base/strings/utf8_validation_internal.h"
+
+#include <array>
+
+#include "base/strings/string_util.h"
+#include "base/strings/string_util_impl_helpers.h"
+#include "base/strings/utf_string_conversion_utils.h"
+#include "base/third_party/icu/icu_utf.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include <immintrin.h>
+
+#include "base/cpu.h"
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace base::internal {
+
+namespace {
+
+Utf8Validity ValidateUtf8Scalar(span<const uint8_t> bytes) {
+  const uint8_t* src = bytes.data();
+  const size_t src_len = bytes.size();
+  Utf8Validity validity = Utf8Validity::kValid;
+  size_t char_index = 0;
+  while (char_index < src_len) {
+    if (src[char_index] < 0x80) {
+      ++char_index;
+      continue;
+    }
+    base_icu::UChar32 code_point;
+    CBU8_NEXT(src, char_index, src_len, code_point);
+    if (!IsValidCodepoint(code_point)) {
+      return Utf8Validity::kInvalid;
+    }
+    if (!IsValidCharacter(code_point)) {
+      validity = Utf8Validity::kValidMaybeNoncharacters;
+    }
+  }
+  return validity;
+}
+
+#if defined(ARCH_CPU_X86_64) || \
+    (defined(ARCH_CPU_ARM64) && defined(__ARM_NEON))
+
+// The error classes of the lookup algorithm. Each table below maps a nibble to
+// the errors which are possible given that nibble, and a byte is in error when
+// all three of its lookups share an error bit. See the simdutf sources for the
+// reasoning behind each entry.
+//
+// A lead byte followed by too few continuations.
+constexpr uint8_t kTooShort = 1 << 0;
+// A continuation after ASCII.
+constexpr uint8_t kTooLong = 1 << 1;
+constexpr uint8_t kOverlong3 = 1 << 2;
+constexpr uint8_t kTooLarge = 1 << 3;
+constexpr uint8_t kSurrogate = 1 << 4;
+constexpr uint8_t kOverlong2 = 1 << 5;
+constexpr uint8_t kTooLarge1000 = 1 << 6;
+constexpr uint8_t kOverlong4 = 1 << 6;
+// A continuation after a continuation, which is only valid in the third or
+// fourth byte of a sequence, as checked separately.
+constexpr uint8_t kTwoConts = 1 << 7;
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+// Indexed by the high nibble of the previous byte.
+constexpr std::array<uint8_t, 16> kByte1High = {
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTwoConts,
+    kTwoConts,
+    kTwoConts,
+    kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+// Indexed by the low nibble of the previous byte.
+constexpr std::array<uint8_t, 16> kByte1Low = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+// Indexed by the high nibble of the current byte.
+constexpr std::array<uint8_t, 16> kByte2High = {
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+};
+
+// Blocks are padded with zeros, which are ASCII, so that a sequence truncated
+// by the end of the input is detected as too short.
+template <size_t kBlockSize>
+std::array<uint8_t, kBlockSize> PaddedTail(span<const uint8_t> bytes) {
+  std::array<uint8_t, kBlockSize> tail = {};
+  span(tail).first(bytes.size()).copy_from(bytes);
+  return tail;
+}
+
+#endif
+
+#if defined(ARCH_CPU_X86_64)
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+bool HasAvx2() {
+  static const bool has_avx2 = CPU::GetInstanceNoAllocation().has_avx2();
+  return has_avx2;
+}
+
+AVX2_TARGET __m256i LoadTable(const std::array<uint8_t, 16>& table) {
+  return _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data())));
+}
+
+// Returns `input` shifted by `N` bytes, with the last bytes of `previous` in
+// front.
+template <int N>
+AVX2_TARGET __m256i Previous(__m256i input, __m256i previous) {
+  return _mm256_alignr_epi8(
+      input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+}
+
+class Avx2Validator {
+ public:
+  static constexpr size_t kBlockSize = 32;
+
+  AVX2_TARGET Avx2Validator()
+      : byte_1_high_(LoadTable(kByte1High)),
+        byte_1_low_(LoadTable(kByte1Low)),
+        byte_2_high_(LoadTable(kByte2High)) {}
+
+  AVX2_TARGET void Add(const uint8_t* block) {
+    const __m256i input =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    if (_mm256_movemask_epi8(input) == 0) {
+      // ASCII is only an error after an incomplete sequence.
+      error_ = _mm256_or_si256(error_, previous_incomplete_);
+    } else {
+      AddMultibyte(input);
+    }
+    previous_ = input;
+  }
+
+  AVX2_TARGET Utf8Validity Finish(span<const uint8_t> tail) {
+    Add(PaddedTail<kBlockSize>(tail).data());
+    if (!_mm256_testz_si256(error_, error_)) {
+      return Utf8Validity::kInvalid;
+    }
+    return _mm256_testz_si256(noncharacters_, noncharacters_)
+               ? Utf8Validity::kValid
+               : Utf8Validity::kValidMaybeNoncharacters;
+  }
+
+ private:
+  AVX2_TARGET void AddMultibyte(__m256i input) {
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    const __m256i previous1 = Previous<1>(input, previous_);
+    const __m256i special_cases = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(
+                byte_1_high_,
+                _mm256_and_si256(_mm256_srli_epi16(previous1, 4), low_nibbles)),
+            _mm256_shuffle_epi8(byte_1_low_,
+                                _mm256_and_si256(previous1, low_nibbles))),
+        _mm256_shuffle_epi8(
+            byte_2_high_,
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibbles)));
+
+    // Two continuations in a row are only valid as the third or fourth byte of
+    // a sequence.
+    const __m256i previous2 = Previous<2>(input, previous_);
+    const __m256i previous3 = Previous<3>(input, previous_);
+    const __m256i is_third_byte =
+        _mm256_subs_epu8(previous2, _mm256_set1_epi8(0xE0u - 0x80));
+    const __m256i is_fourth_byte =
+        _mm256_subs_epu8(previous3, _mm256_set1_epi8(0xF0u - 0x80));
+    const __m256i must_be_continuation =
+        _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte),
+                         _mm256_set1_epi8(static_cast<char>(0x80)));
+    error_ = _mm256_or_si256(
+        error_, _mm256_xor_si256(must_be_continuation, special_cases));
+
+    // The last bytes of a lead byte of a sequence which goes past the block.
+    const __m256i max_complete = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1),
+        static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+    previous_incomplete_ = _mm256_subs_epu8(input, max_complete);
+
+    // Noncharacters end with EF B7 [90..AF] or with BF [BE..BF]. This also
+    // matches some valid characters, which the precise check then accepts.
+    const __m256i ends_in_bf = _mm256_and_si256(
+        _mm256_cmpeq_epi8(previous1, _mm256_set1_epi8(static_cast<char>(0xBF))),
+        _mm256_cmpeq_epi8(
+            _mm256_max_epu8(input, _mm256_set1_epi8(static_cast<char>(0xBE))),
+            input));
+    const __m256i fdd0_to_fdef = _mm256_and_si256(
+        _mm256_cmpeq_epi8(previous2, _mm256_set1_epi8(static_cast<char>(0xEF))),
+        _mm256_cmpeq_epi8(previous1,
+                          _mm256_set1_epi8(static_cast<char>(0xB7))));
+    noncharacters_ = _mm256_or_si256(noncharacters_,
+                                     _mm256_or_si256(ends_in_bf, fdd0_to_fdef));
+  }
+
+  const __m256i byte_1_high_;
+  const __m256i byte_1_low_;
+  const __m256i byte_2_high_;
+  __m256i previous_ = _mm256_setzero_si256();
+  __m256i previous_incomplete_ = _mm256_setzero_si256();
+  __m256i error_ = _mm256_setzero_si256();
+  __m256i noncharacters_ = _mm256_setzero_si256();
+};
+
+AVX2_TARGET Utf8Validity ValidateUtf8Avx2(span<const uint8_t> bytes) {
+  Avx2Validator validator;
+  while (bytes.size() >= Avx2Validator::kBlockSize) {
+    validator.Add(bytes.data());
+    bytes = bytes.subspan(Avx2Validator::kBlockSize);
+  }
+  return validator.Finish(bytes);
+}
+
+AVX2_TARGET bool IsAsciiAvx2(span<const uint8_t> bytes) {
+  // Four vectors at a time, with a single test of their high bits.
+  while (bytes.size() >= 128) {
+    const __m256i* data = reinterpret_cast<const __m256i*>(bytes.data());
+    const __m256i all_bits = _mm256_or_si256(
+        _mm256_or_si256(_mm256_loadu_si256(data), _mm256_loadu_si256(data + 1)),
+        _mm256_or_si256(_mm256_loadu_si256(data + 2),
+                        _mm256_loadu_si256(data + 3)));
+    if (_mm256_movemask_epi8(all_bits)) {
+      return false;
+    }
+    bytes = bytes.subspan(128u);
+  }
+  while (bytes.size() >= 32) {
+    if (_mm256_movemask_epi8(_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(bytes.data())))) {
+      return false;
+    }
+    bytes = bytes.subspan(32u);
+  }
+  return DoIsStringASCII(bytes.data(), bytes.size());
+}
+
+#undef AVX2_TARGET
+
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+
+class NeonValidator {
+ public:
+  static constexpr size_t kBlockSize = 16;
+
+  NeonValidator()
+      : byte_1_high_(vld1q_u8(kByte1High.data())),
+        byte_1_low_(vld1q_u8(kByte1Low.data())),
+        byte_2_high_(vld1q_u8(kByte2High.data())) {}
+
+  void Add(const uint8_t* block) {
+    const uint8x16_t input = vld1q_u8(block);
+    if (vmaxvq_u8(input) < 0x80) {
+      // ASCII is only an error after an incomplete sequence.
+      error_ = vorrq_u8(error_, previous_incomplete_);
+    } else {
+      AddMultibyte(input);
+    }
+    previous_ = input;
+  }
+
+  Utf8Validity Finish(span<const uint8_t> tail) {
+    Add(PaddedTail<kBlockSize>(tail).data());
+    if (vmaxvq_u8(error_) != 0) {
+      return Utf8Validity::kInvalid;
+    }
+    return vmaxvq_u8(noncharacters_) == 0
+               ? Utf8Validity::kValid
+               : Utf8Validity::kValidMaybeNoncharacters;
+  }
+
+ private:
+  void AddMultibyte(uint8x16_t input) {
+    const uint8x16_t low_nibbles = vdupq_n_u8(0x0F);
+    const uint8x16_t previous1 = vextq_u8(previous_, input, 16 - 1);
+    const uint8x16_t special_cases = vandq_u8(
+        vandq_u8(vqtbl1q_u8(byte_1_high_, vshrq_n_u8(previous1, 4)),
+                 vqtbl1q_u8(byte_1_low_, vandq_u8(previous1, low_nibbles))),
+        vqtbl1q_u8(byte_2_high_, vshrq_n_u8(input, 4)));
+
+    // Two continuations in a row are only valid as the third or fourth byte of
+    // a sequence.
+    const uint8x16_t previous2 = vextq_u8(previous_, input, 16 - 2);
+    const uint8x16_t previous3 = vextq_u8(previous_, input, 16 - 3);
+    const uint8x16_t is_third_byte =
+        vqsubq_u8(previous2, vdupq_n_u8(0xE0 - 0x80));
+    const uint8x16_t is_fourth_byte =
+        vqsubq_u8(previous3, vdupq_n_u8(0xF0 - 0x80));
+    const uint8x16_t must_be_continuation =
+        vandq_u8(vorrq_u8(is_third_byte, is_fourth_byte), vdupq_n_u8(0x80));
+    error_ = vorrq_u8(error_, veorq_u8(must_be_continuation, special_cases));
+
+    // The last bytes of a lead byte of a sequence which goes past the block.
+    static constexpr std::array<uint8_t, 16> kMaxComplete = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,     0xFF,     0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1};
+    previous_incomplete_ = vqsubq_u8(input, vld1q_u8(kMaxComplete.data()));
+
+    // Noncharacters end with EF B7 [90..AF] or with BF [BE..BF]. This also
+    // matches some valid characters, which the precise check then accepts.
+    const uint8x16_t ends_in_bf =
+        vandq_u8(vceqq_u8(previous1, vdupq_n_u8(0xBF)),
+                 vcgeq_u8(input, vdupq_n_u8(0xBE)));
+    const uint8x16_t fdd0_to_fdef =
+        vandq_u8(vceqq_u8(previous2, vdupq_n_u8(0xEF)),
+                 vceqq_u8(previous1, vdupq_n_u8(0xB7)));
+    noncharacters_ =
+        vorrq_u8(noncharacters_, vorrq_u8(ends_in_bf, fdd0_to_fdef));
+  }
+
+  const uint8x16_t byte_1_high_;
+  const uint8x16_t byte_1_low_;
+  const uint8x16_t byte_2_high_;
+  uint8x16_t previous_ = vdupq_n_u8(0);
+  uint8x16_t previous_incomplete_ = vdupq_n_u8(0);
+  uint8x16_t error_ = vdupq_n_u8(0);
+  uint8x16_t noncharacters_ = vdupq_n_u8(0);
+};
+
+Utf8Validity ValidateUtf8Neon(span<const uint8_t> bytes) {
+  NeonValidator validator;
+  while (bytes.size() >= NeonValidator::kBlockSize) {
+    validator.Add(bytes.data());
+    bytes = bytes.subspan(NeonValidator::kBlockSize);
+  }
+  return validator.Finish(bytes);
+}
+
+bool IsAsciiNeon(span<const uint8_t> bytes) {
+  // Four vectors at a time, with a single test of their high bits.
+  while (bytes.size() >= 64) {
+    const uint8_t* data = bytes.data();
+    const uint8x16_t all_bits =
+        vorrq_u8(vorrq_u8(vld1q_u8(data), vld1q_u8(data + 16)),
+                 vorrq_u8(vld1q_u8(data + 32), vld1q_u8(data + 48)));
+    if (vmaxvq_u8(all_bits) >= 0x80) {
+      return false;
+    }
+    bytes = bytes.subspan(64u);
+  }
+  return DoIsStringASCII(bytes.data(), bytes.size());
+}
+
+#endif
+
+}  // namespace
+
+Utf8Validity ValidateUtf8(span<const uint8_t> bytes) {
+#if defined(ARCH_CPU_X86_64)
+  if (HasAvx2()) {
+    return ValidateUtf8Avx2(bytes);
+  }
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+  return ValidateUtf8Neon(bytes);
+#endif
+  return ValidateUtf8Scalar(bytes);
+}
+
+bool IsAscii(span<const uint8_t> bytes) {
+#if defined(ARCH_CPU_X86_64)
+  if (HasAvx2()) {
+    return IsAsciiAvx2(bytes);
+  }
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+  return IsAsciiNeon(bytes);
+#endif
+  return DoIsStringASCII(bytes.data(), bytes.size());
+}
+
+}  // namespace base::internal
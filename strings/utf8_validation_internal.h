@@ -0,0 +1,44 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_STRINGS_UTF8_VALIDATION_INTERNAL_H_
+#define BASE_STRINGS_UTF8_VALIDATION_INTERNAL_H_
+
+#include <stdint.h>
+
+#include "base/base_export.h"
+#include "base/containers/span.h"
+
+// Bulk validation kernels behind IsStringASCII(), IsStringUTF8() and
+// StreamingUtf8Validator. They use AVX2 on x86-64 CPUs which have it, NEON on
+// arm64, and scalar loops elsewhere.
+
+namespace base::internal {
+
+enum class Utf8Validity {
+  // `bytes` isn't valid UTF-8.
+  kInvalid,
+  // `bytes` is valid UTF-8 without noncharacters.
+  kValid,
+  // `bytes` is valid UTF-8, but might contain noncharacters (U+FDD0..U+FDEF,
+  // and the code points ending in 0xFFFE or 0xFFFF), which IsStringUTF8()
+  // rejects. A precise check is needed to tell, but it is rarely necessary.
+  kValidMaybeNoncharacters,
+};
+
+// Validates `bytes` as complete UTF-8 as defined by RFC 3629: overlong forms,
+// surrogates, code points above U+10FFFF and truncated sequences are invalid.
+//
+// The vector implementations follow the lookup algorithm of simdutf (Keiser
+// and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"), which
+// classifies each byte from lookups on its nibbles and those of the previous
+// byte, rather than decoding code points one at a time.
+BASE_EXPORT Utf8Validity ValidateUtf8(span<const uint8_t> bytes);
+
+// Returns whether all of `bytes` are ASCII.
+BASE_EXPORT bool IsAscii(span<const uint8_t> bytes);
+
+}  // namespace base::internal
+
+#endif  // BASE_STRINGS_UTF8_VALIDATION_INTERNAL_H_
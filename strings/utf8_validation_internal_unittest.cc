@@ -0,0 +1,141 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/utf8_validation_internal.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "base/strings/string_util.h"
+#include "base/strings/string_util_impl_helpers.h"
+#include "base/strings/utf_string_conversion_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base::internal {
+
+namespace {
+
+// The expected results, from the code point at a time implementation.
+Utf8Validity ExpectedValidity(std::string_view str) {
+  if (!DoIsStringUTF8<IsValidCodepoint>(str)) {
+    return Utf8Validity::kInvalid;
+  }
+  return DoIsStringUTF8<IsValidCharacter>(str)
+             ? Utf8Validity::kValid
+             : Utf8Validity::kValidMaybeNoncharacters;
+}
+
+void ExpectValidity(std::string_view str) {
+  const Utf8Validity expected = ExpectedValidity(str);
+  const Utf8Validity validity = ValidateUtf8(as_byte_span(str));
+  if (expected == Utf8Validity::kValid) {
+    // Valid strings may be reported as maybe containing noncharacters.
+    EXPECT_NE(Utf8Validity::kInvalid, validity) << str;
+  } else {
+    EXPECT_EQ(expected, validity) << str;
+  }
+}
+
+// The sequences which the tests put at different offsets of a string.
+constexpr std::string_view kSequences[] = {
+    // Valid.
+    "\x7F",
+    "\xC2\x80",
+    "\xDF\xBF",
+    "\xE0\xA0\x80",
+    "\xED\x9F\xBF",
+    "\xEE\x80\x80",
+    "\xEF\xBF\xBD",
+    "\xF0\x90\x80\x80",
+    "\xF4\x8F\xBF\xBD",
+    // Noncharacters.
+    "\xEF\xB7\x90",
+    "\xEF\xB7\xAF",
+    "\xEF\xBF\xBE",
+    "\xEF\xBF\xBF",
+    "\xF0\x9F\xBF\xBE",
+    "\xF4\x8F\xBF\xBF",
+    // Invalid: continuations without a lead byte.
+    "\x80",
+    "\xBF",
+    // Invalid: truncated.
+    "\xC2",
+    "\xE0\xA0",
+    "\xF0\x90\x80",
+    // Invalid: too long.
+    "\xC2\x80\x80",
+    // Invalid: overlong.
+    "\xC0\x80",
+    "\xC1\xBF",
+    "\xE0\x9F\xBF",
+    "\xF0\x8F\xBF\xBF",
+    // Invalid: surrogates.
+    "\xED\xA0\x80",
+    "\xED\xBF\xBF",
+    // Invalid: above U+10FFFF.
+    "\xF4\x90\x80\x80",
+    "\xF5\x80\x80\x80",
+    "\xFF",
+};
+
+}  // namespace
+
+TEST(Utf8ValidationTest, Empty) {
+  EXPECT_EQ(Utf8Validity::kValid, ValidateUtf8({}));
+  EXPECT_TRUE(IsAscii({}));
+}
+
+TEST(Utf8ValidationTest, SequencesAtEachOffset) {
+  // Offsets around the boundaries of the blocks of the vector implementations.
+  for (std::string_view sequence : kSequences) {
+    for (size_t offset = 0; offset < 70; ++offset) {
+      for (std::string_view fill : {"a", "\xC3\xA9"}) {
+        std::string str;
+        while (str.size() < offset) {
+          str += fill;
+        }
+        str += sequence;
+        ExpectValidity(str);
+        str += "abc";
+        ExpectValidity(str);
+        str += std::string(40, 'z');
+        ExpectValidity(str);
+      }
+    }
+  }
+}
+
+TEST(Utf8ValidationTest, Random) {
+  // Strings of bytes likely to form both valid and invalid sequences.
+  constexpr uint8_t kBytes[] = {0x00, 0x41, 0x7F, 0x80, 0x8F, 0x90, 0x9F,
+                                0xA0, 0xB7, 0xBE, 0xBF, 0xC0, 0xC2, 0xDF,
+                                0xE0, 0xED, 0xEF, 0xF0, 0xF4, 0xF5};
+  uint32_t seed = 1;
+  for (int i = 0; i < 20000; ++i) {
+    std::string str;
+    const size_t size = i % 100;
+    for (size_t j = 0; j < size; ++j) {
+      seed = seed * 1103515245u + 12345u;
+      str += static_cast<char>(kBytes[(seed >> 16) % std::size(kBytes)]);
+    }
+    ExpectValidity(str);
+  }
+}
+
+TEST(Utf8ValidationTest, IsAscii) {
+  for (size_t size = 0; size < 300; size += 7) {
+    std::string str(size, 'a');
+    EXPECT_TRUE(IsAscii(as_byte_span(str)));
+    for (size_t i = 0; i < size; ++i) {
+      str[i] = '\x80';
+      EXPECT_FALSE(IsAscii(as_byte_span(str))) << size << " " << i;
+      str[i] = '\x7F';
+    }
+  }
+}
+
+}  // namespace base::internal
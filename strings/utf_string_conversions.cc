@@ -17,13 +17,22 @@
 #include <string_view>
 #include <type_traits>
 
+#include "base/check_op.h"
+#include "base/containers/span.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
+#include "base/strings/utf8_validation_internal.h"
 #include "base/strings/utf_ostream_operators.h"
 #include "base/strings/utf_string_conversion_utils.h"
 #include "base/third_party/icu/icu_utf.h"
 #include "build/build_config.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace base {
 
 namespace {
@@ -195,6 +204,231 @@ bool DoUTFConversion(const wchar_t* src,
 
 #endif  // defined(WCHAR_T_IS_32_BIT)
 
+// ConvertIfValid -------------------------------------------------------------
+// Fast paths for valid input, which is the common case. The input is checked
+// first, then the exact size of the output is computed so that it is allocated
+// once, then the input is converted without checks, skipping ASCII runs 16
+// code units at a time. Invalid input goes through DoUTFConversion(), which
+// replaces the errors.
+
+constexpr size_t kAsciiBlockSize = 16;
+
+// If the kAsciiBlockSize bytes at `src` are ASCII, copies them to `dest` and
+// returns true.
+bool WidenAsciiBlock(const uint8_t* src, char16_t* dest) {
+#if defined(__SSE2__)
+  const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  if (_mm_movemask_epi8(bytes)) {
+    return false;
+  }
+  const __m128i zero = _mm_setzero_si128();
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_unpacklo_epi8(bytes, zero));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8),
+                   _mm_unpackhi_epi8(bytes, zero));
+  return true;
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+  const uint8x16_t bytes = vld1q_u8(src);
+  if (vmaxvq_u8(bytes) >= 0x80) {
+    return false;
+  }
+  uint16_t* out = reinterpret_cast<uint16_t*>(dest);
+  vst1q_u16(out, vmovl_u8(vget_low_u8(bytes)));
+  vst1q_u16(out + 8, vmovl_high_u8(bytes));
+  return true;
+#else
+  uint8_t all_bits = 0;
+  for (size_t i = 0; i < kAsciiBlockSize; ++i) {
+    all_bits |= src[i];
+  }
+  if (all_bits >= 0x80) {
+    return false;
+  }
+  for (size_t i = 0; i < kAsciiBlockSize; ++i) {
+    dest[i] = src[i];
+  }
+  return true;
+#endif
+}
+
+// If the kAsciiBlockSize code units at `src` are ASCII, copies them to `dest`
+// and returns true.
+bool NarrowAsciiBlock(const char16_t* src, char* dest) {
+#if defined(__SSE2__)
+  const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  const __m128i high =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+  const __m128i non_ascii =
+      _mm_and_si128(_mm_or_si128(low, high),
+                    _mm_set1_epi16(static_cast<int16_t>(0xFF80)));
+  if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) !=
+      0xFFFF) {
+    return false;
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_packus_epi16(low, high));
+  return true;
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+  const uint16_t* in = reinterpret_cast<const uint16_t*>(src);
+  const uint16x8_t low = vld1q_u16(in);
+  const uint16x8_t high = vld1q_u16(in + 8);
+  if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80) {
+    return false;
+  }
+  vst1q_u8(reinterpret_cast<uint8_t*>(dest),
+           vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+  return true;
+#else
+  char16_t all_bits = 0;
+  for (size_t i = 0; i < kAsciiBlockSize; ++i) {
+    all_bits |= src[i];
+  }
+  if (all_bits >= 0x80) {
+    return false;
+  }
+  for (size_t i = 0; i < kAsciiBlockSize; ++i) {
+    dest[i] = static_cast<char>(src[i]);
+  }
+  return true;
+#endif
+}
+
+// Returns the number of UTF-16 code units of the valid UTF-8 `src`.
+size_t UTF16Length(span<const uint8_t> src) {
+  size_t length = 0;
+  for (uint8_t byte : src) {
+    // Every byte but continuations starts a character, and the characters of
+    // four bytes take two code units.
+    length += ((byte & 0xC0) != 0x80) + (byte >= 0xF0);
+  }
+  return length;
+}
+
+// Returns the number of UTF-8 code units of `src`, if its surrogates are
+// paired, and whether it has surrogates.
+size_t UTF8Length(StringPiece16 src, bool* has_surrogates) {
+  size_t length = 0;
+  bool surrogates = false;
+  for (char16_t c : src) {
+    // Each half of a surrogate pair takes two of the four bytes.
+    const bool is_surrogate = (c & 0xF800) == 0xD800;
+    length += 1u + (c >= 0x80) + (c >= 0x800) - is_surrogate;
+    surrogates |= is_surrogate;
+  }
+  *has_surrogates = surrogates;
+  return length;
+}
+
+bool HasOnlyPairedSurrogates(StringPiece16 src) {
+  for (size_t i = 0; i < src.size(); ++i) {
+    if (CBU16_IS_LEAD(src[i]) && i + 1 < src.size() &&
+        CBU16_IS_TRAIL(src[i + 1])) {
+      ++i;
+    } else if (CBU16_IS_SURROGATE(src[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename InputString, typename DestString>
+bool ConvertIfValid(const InputString& src_str, DestString* dest_str) {
+  // The other conversions only have the generic implementation.
+  return false;
+}
+
+bool ConvertIfValid(StringPiece src_str, std::u16string* dest_str) {
+  const span<const uint8_t> bytes = as_byte_span(src_str);
+  if (internal::ValidateUtf8(bytes) == internal::Utf8Validity::kInvalid) {
+    return false;
+  }
+  dest_str->resize(UTF16Length(bytes));
+  char16_t* dest = dest_str->data();
+
+  const uint8_t* src = bytes.data();
+  const size_t src_len = bytes.size();
+  size_t i = 0;
+  size_t j = 0;
+  while (i < src_len) {
+    const uint8_t lead = src[i];
+    if (lead < 0x80) {
+      while (i + kAsciiBlockSize <= src_len &&
+             WidenAsciiBlock(&src[i], &dest[j])) {
+        i += kAsciiBlockSize;
+        j += kAsciiBlockSize;
+      }
+      while (i < src_len && src[i] < 0x80) {
+        dest[j++] = src[i++];
+      }
+    } else if (lead < 0xE0) {
+      dest[j++] = static_cast<char16_t>(((lead & 0x1F) << 6) |
+                                        (src[i + 1] & 0x3F));
+      i += 2;
+    } else if (lead < 0xF0) {
+      dest[j++] = static_cast<char16_t>(((lead & 0x0F) << 12) |
+                                        ((src[i + 1] & 0x3F) << 6) |
+                                        (src[i + 2] & 0x3F));
+      i += 3;
+    } else {
+      const base_icu::UChar32 code_point =
+          ((lead & 0x07) << 18) | ((src[i + 1] & 0x3F) << 12) |
+          ((src[i + 2] & 0x3F) << 6) | (src[i + 3] & 0x3F);
+      dest[j++] = static_cast<char16_t>((code_point >> 10) + 0xD7C0);
+      dest[j++] = static_cast<char16_t>((code_point & 0x3FF) | 0xDC00);
+      i += 4;
+    }
+  }
+  DCHECK_EQ(j, dest_str->size());
+  return true;
+}
+
+bool ConvertIfValid(StringPiece16 src_str, std::string* dest_str) {
+  bool has_surrogates;
+  const size_t length = UTF8Length(src_str, &has_surrogates);
+  if (has_surrogates && !HasOnlyPairedSurrogates(src_str)) {
+    return false;
+  }
+  dest_str->resize(length);
+  uint8_t* dest = reinterpret_cast<uint8_t*>(dest_str->data());
+
+  const char16_t* src = src_str.data();
+  const size_t src_len = src_str.size();
+  size_t i = 0;
+  size_t j = 0;
+  while (i < src_len) {
+    const char16_t c = src[i];
+    if (c < 0x80) {
+      while (i + kAsciiBlockSize <= src_len &&
+             NarrowAsciiBlock(&src[i], reinterpret_cast<char*>(&dest[j]))) {
+        i += kAsciiBlockSize;
+        j += kAsciiBlockSize;
+      }
+      while (i < src_len && src[i] < 0x80) {
+        dest[j++] = static_cast<uint8_t>(src[i++]);
+      }
+    } else if (c < 0x800) {
+      dest[j++] = static_cast<uint8_t>(0xC0 | (c >> 6));
+      dest[j++] = static_cast<uint8_t>(0x80 | (c & 0x3F));
+      ++i;
+    } else if (!CBU16_IS_SURROGATE(c)) {
+      dest[j++] = static_cast<uint8_t>(0xE0 | (c >> 12));
+      dest[j++] = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3F));
+      dest[j++] = static_cast<uint8_t>(0x80 | (c & 0x3F));
+      ++i;
+    } else {
+      const base_icu::UChar32 code_point =
+          CBU16_GET_SUPPLEMENTARY(c, src[i + 1]);
+      dest[j++] = static_cast<uint8_t>(0xF0 | (code_point >> 18));
+      dest[j++] = static_cast<uint8_t>(0x80 | ((code_point >> 12) & 0x3F));
+      dest[j++] = static_cast<uint8_t>(0x80 | ((code_point >> 6) & 0x3F));
+      dest[j++] = static_cast<uint8_t>(0x80 | (code_point & 0x3F));
+      i += 2;
+    }
+  }
+  DCHECK_EQ(j, dest_str->size());
+  return true;
+}
+
 // UTFConversion --------------------------------------------------------------
 // Function template for generating all UTF conversions.
 
@@ -204,6 +438,9 @@ bool UTFConversion(const InputString& src_str, DestString* dest_str) {
     dest_str->assign(src_str.begin(), src_str.end());
     return true;
   }
+  if (ConvertIfValid(src_str, dest_str)) {
+    return true;
+  }
 
   dest_str->resize(src_str.length() *
                    size_coefficient_v<typename InputString::value_type,
@@ -8,6 +8,7 @@
 
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
+#include "base/third_party/icu/icu_utf.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -181,6 +182,50 @@ TEST(UTFStringConversionsTest, ConvertUTF32ToUTF8) {
 }
 #endif  // defined(WCHAR_T_IS_32_BIT)
 
+// Long strings mixing ASCII runs of all lengths with characters of every size
+// go through the fast paths of valid input, and convert exactly.
+TEST(UTFStringConversionsTest, ConvertLongMixedStrings) {
+  constexpr base_icu::UChar32 kCodePoints[] = {
+      0x7F,   0x80,    0xE9,    0x7FF,  0x800,    0x20AC,
+      0xFFFD, 0xFFFF,  0x10000, 0x1F600, 0x10FFFF};
+  std::string utf8;
+  std::u16string utf16;
+  for (size_t run = 0; run < 40; ++run) {
+    for (size_t i = 0; i < run; ++i) {
+      utf8 += static_cast<char>('a' + i % 26);
+      utf16 += static_cast<char16_t>('a' + i % 26);
+    }
+    const base_icu::UChar32 code_point =
+        kCodePoints[run % std::size(kCodePoints)];
+    uint8_t utf8_buffer[4];
+    size_t utf8_size = 0;
+    CBU8_APPEND_UNSAFE(utf8_buffer, utf8_size, code_point);
+    utf8.append(reinterpret_cast<const char*>(utf8_buffer), utf8_size);
+    char16_t utf16_buffer[2];
+    size_t utf16_size = 0;
+    CBU16_APPEND_UNSAFE(utf16_buffer, utf16_size, code_point);
+    utf16.append(utf16_buffer, utf16_size);
+
+    std::u16string converted16;
+    EXPECT_TRUE(UTF8ToUTF16(utf8.data(), utf8.size(), &converted16));
+    EXPECT_EQ(utf16, converted16);
+    std::string converted8;
+    EXPECT_TRUE(UTF16ToUTF8(utf16.data(), utf16.size(), &converted8));
+    EXPECT_EQ(utf8, converted8);
+  }
+
+  // Errors after long valid prefixes are still replaced.
+  std::u16string converted16;
+  EXPECT_FALSE(UTF8ToUTF16((utf8 + "\xC0").data(), utf8.size() + 1,
+                           &converted16));
+  EXPECT_EQ(utf16 + u"\xFFFD", converted16);
+  std::string converted8;
+  const std::u16string lone_surrogate = utf16 + u'\xD800';
+  EXPECT_FALSE(UTF16ToUTF8(lone_surrogate.data(), lone_surrogate.size(),
+                           &converted8));
+  EXPECT_EQ(utf8 + "\xEF\xBF\xBD", converted8);
+}
+
 TEST(UTFStringConversionsTest, ConvertMultiString) {
   // `operator""s` will avoid truncating the strings at the first embedded NUL.
   using std::string_literals::operator""s;
@@ -12,6 +12,7 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <bit>
 #include <queue>
 
 #ifdef __SSE2__
@@ -22,13 +23,111 @@
 #include "base/check_op.h"
 #include "base/containers/contains.h"
 #include "base/containers/queue.h"
+#include "base/containers/span_writer.h"
+#include "base/memory/stack_allocated.h"
 #include "base/numerics/checked_math.h"
 #include "base/trace_event/memory_usage_estimator.h"  // no-presubmit-check
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_64)
+#include "base/cpu.h"
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace base {
 
 namespace {
 
+using FirstBytes = std::array<std::array<uint8_t, 16>, 2>;
+
+bool IsFirstByte(const FirstBytes& first_bytes, uint8_t c) {
+  return (first_bytes[c >> 7][c & 0xF] >> ((c >> 4) & 7)) & 1;
+}
+
+// The bit of the first_bytes_ entries which stands for each high nibble.
+constexpr std::array<uint8_t, 16> kHighNibbleBits = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+
+#if defined(ARCH_CPU_X86_64)
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+bool HasAvx2() {
+  static const bool has_avx2 = CPU::GetInstanceNoAllocation().has_avx2();
+  return has_avx2;
+}
+
+AVX2_TARGET __m256i LoadTable(const std::array<uint8_t, 16>& table) {
+  return _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data())));
+}
+
+// Returns the position of the first byte of `text` in `first_bytes`, or a
+// position at most 31 bytes before the end to go on from with scalar code.
+AVX2_TARGET size_t FindFirstByteAvx2(const uint8_t* text,
+                                     size_t size,
+                                     const FirstBytes& first_bytes) {
+  const __m256i low_table = LoadTable(first_bytes[0]);
+  const __m256i high_table = LoadTable(first_bytes[1]);
+  const __m256i bits = LoadTable(kHighNibbleBits);
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i input =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+    const __m256i low = _mm256_and_si256(input, nibble_mask);
+    const __m256i high =
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble_mask);
+    // The sign bit of each byte picks the table for bytes 0x80 and up.
+    const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low_table, low),
+                                           _mm256_shuffle_epi8(high_table, low),
+                                           input);
+    const __m256i hits =
+        _mm256_and_si256(row, _mm256_shuffle_epi8(bits, high));
+    const uint32_t misses = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(hits, _mm256_setzero_si256())));
+    if (misses != 0xFFFFFFFFu) {
+      return i + static_cast<size_t>(std::countr_zero(~misses));
+    }
+  }
+  return i;
+}
+
+#undef AVX2_TARGET
+
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+
+// As FindFirstByteAvx2(), with 16-byte blocks.
+size_t FindFirstByteNeon(const uint8_t* text,
+                         size_t size,
+                         const FirstBytes& first_bytes) {
+  const uint8x16_t low_table = vld1q_u8(first_bytes[0].data());
+  const uint8x16_t high_table = vld1q_u8(first_bytes[1].data());
+  const uint8x16_t bits = vld1q_u8(kHighNibbleBits.data());
+  const uint8x16_t nibble_mask = vdupq_n_u8(0x0F);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const uint8x16_t input = vld1q_u8(text + i);
+    const uint8x16_t low = vandq_u8(input, nibble_mask);
+    const uint8x16_t row = vbslq_u8(vcgeq_u8(input, vdupq_n_u8(0x80)),
+                                    vqtbl1q_u8(high_table, low),
+                                    vqtbl1q_u8(low_table, low));
+    const uint8x16_t hits =
+        vtstq_u8(row, vqtbl1q_u8(bits, vshrq_n_u8(input, 4)));
+    if (vmaxvq_u8(hits) != 0) {
+      // Narrow each byte of `hits` to a nibble of a 64-bit mask.
+      const uint64_t mask = vget_lane_u64(
+          vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+      return i + static_cast<size_t>(std::countr_zero(mask)) / 4;
+    }
+  }
+  return i;
+}
+
+#endif
+
 // Compare MatcherStringPattern instances based on their string patterns.
 bool ComparePatterns(const MatcherStringPattern* a,
                      const MatcherStringPattern* b) {
@@ -46,8 +145,95 @@ std::vector<const MatcherStringPattern*> GetVectorOfPointers(
   return pattern_pointers;
 }
 
+// Serialize() writes a SerializedHeader, then the nodes as SerializedNodes in
+// breadth-first order, then the edges of all nodes in the same order, as
+// AhoCorasickEdges. As in AhoCorasickNode, a failure edge comes first, and a
+// dense node has kEmptyLabel + 1 edges indexed by label.
+struct SerializedHeader {
+  uint32_t magic;
+  // Bumped whenever the format changes.
+  uint32_t version;
+  uint32_t num_nodes;
+  uint32_t num_edges;
+};
+
+constexpr uint32_t kSerializedMagic = 0x314d5353;  // "SSM1" in little endian.
+constexpr uint32_t kSerializedVersion = 1;
+
+// Flags of SerializedNode.
+constexpr uint8_t kSerializedHasOutputs = 1 << 0;
+constexpr uint8_t kSerializedIsDense = 1 << 1;
+
 }  // namespace
 
+struct SubstringSetMatcher::SerializedNode {
+  // Index of the first edge of this node among all edges.
+  uint32_t first_edge;
+  uint16_t num_edges;
+  uint8_t flags;
+  uint8_t unused;
+};
+
+class SubstringSetMatcher::BuiltTree {
+  STACK_ALLOCATED();
+
+ public:
+  explicit BuiltTree(const std::vector<AhoCorasickNode>& tree)
+      : nodes_(tree.data()) {}
+
+  NodeID GetEdge(NodeID node, uint32_t label) const {
+    return nodes_[node].GetEdge(label);
+  }
+  NodeID failure(NodeID node) const { return nodes_[node].failure(); }
+  bool has_outputs(NodeID node) const { return nodes_[node].has_outputs(); }
+
+ private:
+  const AhoCorasickNode* nodes_;
+};
+
+class SubstringSetMatcher::SerializedTree {
+  STACK_ALLOCATED();
+
+ public:
+  SerializedTree(const SerializedNode* nodes, const AhoCorasickEdge* edges)
+      : nodes_(nodes), edges_(edges) {}
+
+  // Returns whether the edges with |label| lead to a node, rather than holding
+  // a pattern ID or nothing.
+  static bool LeadsToNode(uint32_t label) {
+    return label < kFirstSpecialLabel || label == kFailureNodeLabel ||
+           label == kOutputLinkLabel;
+  }
+
+  NodeID GetEdge(NodeID node_id, uint32_t label) const {
+    const SerializedNode& node = nodes_[node_id];
+    const AhoCorasickEdge* const edges = edges_ + node.first_edge;
+    if (node.flags & kSerializedIsDense) {
+      return edges[label].label == label ? edges[label].node_id
+                                         : kInvalidNodeID;
+    }
+    return FindEdge(edges, node.num_edges, label);
+  }
+  NodeID failure(NodeID node_id) const {
+    const SerializedNode& node = nodes_[node_id];
+    const AhoCorasickEdge* const edges = edges_ + node.first_edge;
+    const AhoCorasickEdge* const failure_edge =
+        node.flags & kSerializedIsDense ? &edges[kFailureNodeLabel]
+        : node.num_edges > 0            ? &edges[0]
+                                        : nullptr;
+    return failure_edge && failure_edge->label == kFailureNodeLabel
+               ? failure_edge->node_id
+               : kRootID;
+  }
+  bool has_outputs(NodeID node_id) const {
+    return nodes_[node_id].flags & kSerializedHasOutputs;
+  }
+
+ private:
+  const SerializedNode* nodes_;
+  const AhoCorasickEdge* edges_;
+};
+
 bool SubstringSetMatcher::Build(
     const std::vector<MatcherStringPattern>& patterns) {
   return Build(GetVectorOfPointers(patterns));
@@ -96,76 +282,228 @@ bool SubstringSetMatcher::Build(
 SubstringSetMatcher::SubstringSetMatcher() = default;
 SubstringSetMatcher::~SubstringSetMatcher() = default;
 
-bool SubstringSetMatcher::Match(
-    const std::string& text,
-    std::set<MatcherStringPattern::ID>* matches) const {
-  const size_t old_number_of_matches = matches->size();
-
-  // Handle patterns matching the empty string.
-  const AhoCorasickNode* const root = &tree_[kRootID];
-  AccumulateMatchesForNode(root, matches);
+std::vector<uint8_t> SubstringSetMatcher::Serialize() const {
+  if (serialized_nodes_) {
+    return std::vector<uint8_t>(serialized_.begin(), serialized_.end());
+  }
+  DCHECK(!tree_.empty());
+  static_assert(sizeof(SerializedNode) == 8);
+  static_assert(alignof(SerializedNode) == alignof(AhoCorasickEdge));
+
+  // Number the nodes in breadth-first order, so that failure and output links
+  // lead to lower IDs. That lets Load() rule out cycles cheaply.
+  std::vector<NodeID> order;
+  order.reserve(tree_.size());
+  order.push_back(kRootID);
+  std::vector<NodeID> new_ids(tree_.size(), kInvalidNodeID);
+  new_ids[kRootID] = kRootID;
+  size_t num_edges = 0;
+  for (size_t i = 0; i < order.size(); ++i) {
+    const AhoCorasickNode& node = tree_[order[i]];
+    for (unsigned edge_idx = 0; edge_idx < node.num_edges(); ++edge_idx) {
+      const AhoCorasickEdge& edge = node.edges()[edge_idx];
+      if (edge.label < kFirstSpecialLabel) {
+        new_ids[edge.node_id] = static_cast<NodeID>(order.size());
+        order.push_back(edge.node_id);
+      }
+    }
+    num_edges += node.num_edges();
+  }
+  DCHECK_EQ(tree_.size(), order.size());
+
+  const SerializedHeader header = {kSerializedMagic, kSerializedVersion,
+                                   static_cast<uint32_t>(tree_.size()),
+                                   static_cast<uint32_t>(num_edges)};
+  std::vector<uint8_t> data(sizeof(header) +
+                            tree_.size() * sizeof(SerializedNode) +
+                            num_edges * sizeof(AhoCorasickEdge));
+  SpanWriter writer{span(data)};
+  writer.Write(byte_span_from_ref(header));
+  uint32_t first_edge = 0;
+  for (NodeID id : order) {
+    const AhoCorasickNode& node = tree_[id];
+    const SerializedNode serialized_node = {
+        first_edge, static_cast<uint16_t>(node.num_edges()),
+        static_cast<uint8_t>((node.has_outputs() ? kSerializedHasOutputs : 0) |
+                             (node.is_dense() ? kSerializedIsDense : 0)),
+        0};
+    writer.Write(byte_span_from_ref(serialized_node));
+    first_edge += node.num_edges();
+  }
+  for (NodeID id : order) {
+    const AhoCorasickNode& node = tree_[id];
+    for (unsigned edge_idx = 0; edge_idx < node.num_edges(); ++edge_idx) {
+      AhoCorasickEdge edge = node.edges()[edge_idx];
+      if (SerializedTree::LeadsToNode(edge.label)) {
+        edge.node_id = new_ids[edge.node_id];
+      }
+      writer.Write(byte_span_from_ref(edge));
+    }
+  }
+  DCHECK_EQ(0u, writer.remaining());
+  return data;
+}
 
-  const AhoCorasickNode* current_node = root;
-  for (const char c : text) {
-    NodeID child = current_node->GetEdge(static_cast<unsigned char>(c));
+bool SubstringSetMatcher::Load(span<const uint8_t> data) {
+  DCHECK(tree_.empty());
+  DCHECK(!serialized_nodes_);
 
-    // If the child not can't be found, progressively iterate over the longest
-    // proper suffix of the string represented by the current node. In a sense
-    // we are pruning prefixes from the text.
-    while (child == kInvalidNodeID && current_node != root) {
-      current_node = &tree_[current_node->failure()];
-      child = current_node->GetEdge(static_cast<unsigned char>(c));
+  SerializedHeader header;
+  if (data.size() < sizeof(header) ||
+      reinterpret_cast<uintptr_t>(data.data()) % alignof(SerializedNode) != 0) {
+    return false;
+  }
+  byte_span_from_ref(header).copy_from(data.first<sizeof(header)>());
+  if (header.magic != kSerializedMagic ||
+      header.version != kSerializedVersion || header.num_nodes == 0 ||
+      header.num_nodes >= kInvalidNodeID) {
+    return false;
+  }
+  CheckedNumeric<size_t> size = sizeof(header);
+  size += CheckMul(header.num_nodes, sizeof(SerializedNode));
+  size += CheckMul(header.num_edges, sizeof(AhoCorasickEdge));
+  if (!size.IsValid() || size.ValueOrDie() != data.size()) {
+    return false;
+  }
+  const SerializedNode* const nodes =
+      reinterpret_cast<const SerializedNode*>(data.data() + sizeof(header));
+  const AhoCorasickEdge* const edges =
+      reinterpret_cast<const AhoCorasickEdge*>(nodes + header.num_nodes);
+
+  // Check everything that matching relies on: that all edges stay within the
+  // data, and that failure and output links, which are followed in loops,
+  // lead to lower IDs and so eventually to the root.
+  const SerializedTree tree(nodes, edges);
+  for (NodeID id = 0; id < header.num_nodes; ++id) {
+    const SerializedNode& node = nodes[id];
+    if (node.first_edge > header.num_edges ||
+        node.num_edges > header.num_edges - node.first_edge ||
+        ((node.flags & kSerializedIsDense) &&
+         node.num_edges != kEmptyLabel + 1)) {
+      return false;
     }
-
-    if (child != kInvalidNodeID) {
-      // The string represented by |child| is the longest possible suffix of the
-      // current position of |text| in the trie.
-      current_node = &tree_[child];
-      AccumulateMatchesForNode(current_node, matches);
-    } else {
-      // The empty string is the longest possible suffix of the current position
-      // of |text| in the trie.
-      DCHECK_EQ(root, current_node);
+    for (unsigned edge_idx = 0; edge_idx < node.num_edges; ++edge_idx) {
+      const AhoCorasickEdge& edge = edges[node.first_edge + edge_idx];
+      if (SerializedTree::LeadsToNode(edge.label) &&
+          edge.node_id >= header.num_nodes) {
+        return false;
+      }
+    }
+    const NodeID output_link = tree.GetEdge(id, kOutputLinkLabel);
+    if ((id != kRootID && tree.failure(id) >= id) ||
+        (output_link != kInvalidNodeID && output_link >= id)) {
+      return false;
     }
   }
 
+  serialized_ = data;
+  serialized_nodes_ = nodes;
+  serialized_edges_ = edges;
+  const SerializedNode& root = nodes[kRootID];
+  SetUpFirstBytes(edges + root.first_edge, root.num_edges,
+                  root.flags & kSerializedIsDense);
+  is_empty_ = !tree.has_outputs(kRootID) && header.num_nodes == 1;
+  return true;
+}
+
+bool SubstringSetMatcher::Match(
+    const std::string& text,
+    std::set<MatcherStringPattern::ID>* matches) const {
+  DCHECK(matches);
+  const size_t old_number_of_matches = matches->size();
+  if (serialized_nodes_) {
+    MatchImpl(SerializedTree(serialized_nodes_, serialized_edges_), text,
+              matches);
+  } else {
+    MatchImpl(BuiltTree(tree_), text, matches);
+  }
   return old_number_of_matches != matches->size();
 }
 
 bool SubstringSetMatcher::AnyMatch(const std::string& text) const {
+  if (serialized_nodes_) {
+    return MatchImpl(SerializedTree(serialized_nodes_, serialized_edges_),
+                     text, nullptr);
+  }
+  return MatchImpl(BuiltTree(tree_), text, nullptr);
+}
+
+template <typename Tree>
+bool SubstringSetMatcher::MatchImpl(
+    const Tree& tree,
+    const std::string& text,
+    std::set<MatcherStringPattern::ID>* matches) const {
   // Handle patterns matching the empty string.
-  const AhoCorasickNode* const root = &tree_[kRootID];
-  if (root->has_outputs()) {
-    return true;
+  if (tree.has_outputs(kRootID)) {
+    if (!matches) {
+      return true;
+    }
+    AccumulateMatchesForNode(tree, kRootID, matches);
   }
 
-  const AhoCorasickNode* current_node = root;
-  for (const char c : text) {
-    NodeID child = current_node->GetEdge(static_cast<unsigned char>(c));
+  bool found = false;
+  NodeID current_node = kRootID;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (current_node == kRootID && use_first_bytes_) {
+      // Staying at the root neither reports matches nor needs any state.
+      i = SkipToFirstByte(text, i);
+      if (i == text.size()) {
+        break;
+      }
+    }
+    const unsigned char c = static_cast<unsigned char>(text[i]);
+    NodeID child = tree.GetEdge(current_node, c);
 
     // If the child not can't be found, progressively iterate over the longest
     // proper suffix of the string represented by the current node. In a sense
     // we are pruning prefixes from the text.
-    while (child == kInvalidNodeID && current_node != root) {
-      current_node = &tree_[current_node->failure()];
-      child = current_node->GetEdge(static_cast<unsigned char>(c));
+    while (child == kInvalidNodeID && current_node != kRootID) {
+      current_node = tree.failure(current_node);
+      child = tree.GetEdge(current_node, c);
     }
 
     if (child != kInvalidNodeID) {
       // The string represented by |child| is the longest possible suffix of the
       // current position of |text| in the trie.
-      current_node = &tree_[child];
-      if (current_node->has_outputs()) {
-        return true;
+      current_node = child;
+      if (tree.has_outputs(current_node)) {
+        if (!matches) {
+          return true;
+        }
+        AccumulateMatchesForNode(tree, current_node, matches);
+        found = true;
       }
     } else {
       // The empty string is the longest possible suffix of the current position
       // of |text| in the trie.
-      DCHECK_EQ(root, current_node);
+      DCHECK_EQ(kRootID, current_node);
     }
   }
 
-  return false;
+  return found;
+}
+
+
+size_t SubstringSetMatcher::SkipToFirstByte(const std::string& text,
+                                            size_t pos) const {
+  DCHECK(use_first_bytes_);
+  const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(text.data());
+  // Coming back to the root, the next character is often a first byte anyway.
+  if (pos == text.size() || IsFirstByte(first_bytes_, bytes[pos])) {
+    return pos;
+  }
+  ++pos;
+#if defined(ARCH_CPU_X86_64)
+  if (HasAvx2()) {
+    pos += FindFirstByteAvx2(bytes + pos, text.size() - pos, first_bytes_);
+  }
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+  pos += FindFirstByteNeon(bytes + pos, text.size() - pos, first_bytes_);
+#endif
+  while (pos < text.size() && !IsFirstByte(first_bytes_, bytes[pos])) {
+    ++pos;
+  }
+  return pos;
 }
 
 size_t SubstringSetMatcher::EstimateMemoryUsage() const {
@@ -222,6 +560,7 @@ void SubstringSetMatcher::BuildAhoCorasickTree(
     InsertPatternIntoAhoCorasickTree(pattern);
 
   CreateFailureAndOutputEdges();
+  OptimizeForMatching();
 }
 
 void SubstringSetMatcher::InsertPatternIntoAhoCorasickTree(
@@ -327,26 +666,85 @@ void SubstringSetMatcher::CreateFailureAndOutputEdges() {
   }
 }
 
+void SubstringSetMatcher::OptimizeForMatching() {
+  for (AhoCorasickNode& node : tree_) {
+    if (node.num_edges() > kMinCapacityForDenseNode / 2) {
+      node.MakeDense();
+    }
+  }
+  const AhoCorasickNode& root = tree_[kRootID];
+  SetUpFirstBytes(root.edges(), root.num_edges(), root.is_dense());
+}
+
+void SubstringSetMatcher::SetUpFirstBytes(const AhoCorasickEdge* root_edges,
+                                          size_t num_root_edges,
+                                          bool root_is_dense) {
+  // A dense root is as fast to look characters up in as |first_bytes_|.
+  use_first_bytes_ = !root_is_dense;
+  first_bytes_ = {};
+  if (!use_first_bytes_) {
+    return;
+  }
+  for (size_t edge_idx = 0; edge_idx < num_root_edges; ++edge_idx) {
+    const uint32_t label = root_edges[edge_idx].label;
+    if (label < kFirstSpecialLabel) {
+      first_bytes_[label >> 7][label & 0xF] |= 1 << ((label >> 4) & 7);
+    }
+  }
+}
+
+// static
+template <typename Tree>
 void SubstringSetMatcher::AccumulateMatchesForNode(
-    const AhoCorasickNode* node,
-    std::set<MatcherStringPattern::ID>* matches) const {
+    const Tree& tree,
+    NodeID node,
+    std::set<MatcherStringPattern::ID>* matches) {
   DCHECK(matches);
 
-  if (!node->has_outputs()) {
+  if (!tree.has_outputs(node)) {
     // Fast reject.
     return;
   }
-  if (node->IsEndOfPattern())
-    matches->insert(node->GetMatchID());
+  const NodeID match_id = tree.GetEdge(node, kMatchIDLabel);
+  if (match_id != kInvalidNodeID) {
+    matches->insert(match_id);
+  }
 
-  NodeID node_id = node->output_link();
-  while (node_id != kInvalidNodeID) {
-    node = &tree_[node_id];
-    matches->insert(node->GetMatchID());
-    node_id = node->output_link();
+  node = tree.GetEdge(node, kOutputLinkLabel);
+  while (node != kInvalidNodeID) {
+    matches->insert(tree.GetEdge(node, kMatchIDLabel));
+    node = tree.GetEdge(node, kOutputLinkLabel);
   }
 }
 
+// static
+SubstringSetMatcher::NodeID SubstringSetMatcher::FindEdge(
+    const AhoCorasickEdge* edges,
+    size_t num_edges,
+    uint32_t label) {
+  size_t edge_idx = 0;
+#ifdef __SSE2__
+  const __m128i lbl = _mm_set1_epi32(static_cast<int>(label));
+  const __m128i mask = _mm_set1_epi32(0x1ff);
+  for (; edge_idx + 4 <= num_edges; edge_idx += 4) {
+    const __m128i four =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&edges[edge_idx]));
+    const __m128i match = _mm_cmpeq_epi32(_mm_and_si128(four, mask), lbl);
+    const uint32_t match_mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+    if (match_mask != 0) {
+      return edges[edge_idx + std::countr_zero(match_mask) / 4].node_id;
+    }
+  }
+#endif
+  for (; edge_idx < num_edges; ++edge_idx) {
+    if (edges[edge_idx].label == label) {
+      return edges[edge_idx].node_id;
+    }
+  }
+  return kInvalidNodeID;
+}
+
+
 SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode() {
   static_assert(kNumInlineEdges == 2, "Code below needs updating");
   edges_.inline_edges[0].label = kEmptyLabel;
@@ -378,6 +776,8 @@ SubstringSetMatcher::AhoCorasickNode::operator=(AhoCorasickNode&& other) {
     edges_.edges = other.edges_.edges;
     other.edges_.edges = nullptr;
   }
+  has_outputs_ = other.has_outputs_;
+  is_dense_ = other.is_dense_;
   num_free_edges_ = other.num_free_edges_;
   edges_capacity_ = other.edges_capacity_;
   return *this;
@@ -421,6 +821,7 @@ SubstringSetMatcher::AhoCorasickNode::GetEdgeNoInline(uint32_t label) const {
 void SubstringSetMatcher::AhoCorasickNode::SetEdge(uint32_t label,
                                                    NodeID node) {
   DCHECK_LT(node, kInvalidNodeID);
+  DCHECK(!is_dense_);
 
 #if DCHECK_IS_ON()
   // We don't support overwriting existing edges.
@@ -478,6 +879,27 @@ void SubstringSetMatcher::AhoCorasickNode::SetEdge(uint32_t label,
   --num_free_edges_;
 }
 
+void SubstringSetMatcher::AhoCorasickNode::MakeDense() {
+  DCHECK(!is_dense_);
+  DCHECK_NE(0u, edges_capacity_);
+  constexpr unsigned kDenseCapacity = kEmptyLabel + 1;
+  AhoCorasickEdge* dense_edges = new AhoCorasickEdge[kDenseCapacity];
+  for (unsigned label = 0; label < kDenseCapacity; ++label) {
+    dense_edges[label] = AhoCorasickEdge{kEmptyLabel, kInvalidNodeID};
+  }
+  for (unsigned edge_idx = 0; edge_idx < num_edges(); ++edge_idx) {
+    const AhoCorasickEdge& edge = edges_.edges[edge_idx];
+    dense_edges[edge.label] = edge;
+  }
+  delete[] edges_.edges;
+  edges_.edges = dense_edges;
+  edges_capacity_ = kDenseCapacity;
+  // All slots count as used, so that edges() and num_edges() still cover all
+  // edges; the unused ones are marked with kEmptyLabel as usual.
+  num_free_edges_ = 0;
+  is_dense_ = true;
+}
+
 void SubstringSetMatcher::AhoCorasickNode::SetFailure(NodeID node) {
   DCHECK_NE(kInvalidNodeID, node);
   if (node != kRootID) {
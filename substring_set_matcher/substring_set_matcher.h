@@ -12,6 +12,7 @@
 
 #include <stdint.h>
 
+#include <array>
 #include <limits>
 #include <set>
 #include <string>
@@ -19,7 +20,9 @@
 
 #include "base/base_export.h"
 #include "base/check_op.h"
+#include "base/containers/span.h"
 #include "base/memory/raw_ptr_exclusion.h"
+#include "base/memory/raw_span.h"
 #include "base/substring_set_matcher/matcher_string_pattern.h"
 
 namespace base {
@@ -50,6 +53,25 @@ class BASE_EXPORT SubstringSetMatcher {
   bool Build(const std::vector<MatcherStringPattern>& patterns);
   bool Build(std::vector<const MatcherStringPattern*> patterns);
 
+  // Returns the tree built by Build() or loaded by Load() in a flat format,
+  // which Load() can match against in place instead of building the tree
+  // again. The format holds native integers and may change with any version,
+  // so it is only meant to be read by the same build, eg. from a cache that is
+  // invalidated on update, or by other processes.
+  std::vector<uint8_t> Serialize() const;
+
+  // Can be called instead of Build() to match against the tree that
+  // Serialize() stored in |data|, without copying it, so that eg. a
+  // MemoryMappedFile or a ReadOnlySharedMemoryMapping is shared by all
+  // processes which use the same patterns. |data| must be 4-aligned, must not
+  // change and must outlive this object.
+  //
+  // Returns false if |data| isn't a serialized tree. It may come from less
+  // privileged processes: any |data| which is accepted is safe to match
+  // against, though matches are only meaningful for what Serialize() wrote.
+  // Complexity = O(|data|), without allocations.
+  bool Load(span<const uint8_t> data);
+
   // Matches |text| against all registered MatcherStringPatterns. Stores the IDs
   // of matching patterns in |matches|. |matches| is not cleared before adding
   // to it.
@@ -58,6 +80,10 @@ class BASE_EXPORT SubstringSetMatcher {
   //    Let k = range of char. Generally 256.
   //    Let z = number of matches returned.
   // Complexity = O(t * logk + zlogz)
+  //
+  // Stretches of |text| in which no pattern can start are skipped with SIMD
+  // where available, and the widest nodes are looked up in a table, so the
+  // logk factor mostly vanishes in practice.
   bool Match(const std::string& text,
              std::set<MatcherStringPattern::ID>* matches) const;
 
@@ -67,7 +93,8 @@ class BASE_EXPORT SubstringSetMatcher {
   // Complexity = O(t * logk)
   bool AnyMatch(const std::string& text) const;
 
-  // Returns true if this object retains no allocated data.
+  // Returns true if this object retains no allocated data. When loaded, it
+  // returns whether no pattern can match.
   bool IsEmpty() const { return is_empty_; }
 
   // Returns the dynamically allocated memory usage in bytes. See
@@ -159,6 +186,11 @@ class BASE_EXPORT SubstringSetMatcher {
   // match any other labels.
   static constexpr uint32_t kEmptyLabel = 0x103;
 
+  // Nodes whose edge storage has grown to this many slots, ie. which have more
+  // than half as many edges, are made dense once the tree is built. This is at
+  // most four times as much memory as before for them, and they are few.
+  static constexpr uint32_t kMinCapacityForDenseNode = 64;
+
   // A node in the trie, packed tightly together so that it occupies 12 bytes
   // (both on 32- and 64-bit platforms), but aligned to at least 4 (see the
   // comment on edges_).
@@ -171,6 +203,10 @@ class BASE_EXPORT SubstringSetMatcher {
 
     NodeID GetEdge(uint32_t label) const {
       if (edges_capacity_ != 0) {
+        if (is_dense_) {
+          const AhoCorasickEdge& edge = edges_.edges[label];
+          return edge.label == label ? edge.node_id : kInvalidNodeID;
+        }
         return GetEdgeNoInline(label);
       }
       static_assert(kNumInlineEdges == 2, "Code below needs updating");
@@ -184,6 +220,12 @@ class BASE_EXPORT SubstringSetMatcher {
     }
     NodeID GetEdgeNoInline(uint32_t label) const;
     void SetEdge(uint32_t label, NodeID node);
+
+    // Replaces the edges by a table indexed by label, see the comment on
+    // edges_. Must be called once the node's edges are final.
+    void MakeDense();
+    bool is_dense() const { return is_dense_; }
+
     const AhoCorasickEdge* edges() const {
       // NOTE: Returning edges_.inline_edges here is fine, because it's
       // the first thing in the struct (see the comment on edges_).
@@ -196,6 +238,10 @@ class BASE_EXPORT SubstringSetMatcher {
       // NOTE: Even if num_edges_ == 0, we are not doing anything
       // undefined, as we will have room for at least two edges
       // and empty edges are set to kEmptyLabel.
+      if (is_dense_) {
+        const AhoCorasickEdge& edge = edges_.edges[kFailureNodeLabel];
+        return edge.label == kFailureNodeLabel ? edge.node_id : kRootID;
+      }
       const AhoCorasickEdge& first_edge = *edges();
       if (first_edge.label == kFailureNodeLabel) {
         return first_edge.node_id;
@@ -262,6 +308,10 @@ class BASE_EXPORT SubstringSetMatcher {
     // of 259 (256 possible characters plus the three special label types)
     // edges, indexed directly by label type. This would use 20–50% more RAM,
     // but also increases the speed of lookups due to removing the search loop.
+    // We do this only for the widest nodes (see kMinCapacityForDenseNode),
+    // which are few but visited for most characters of the text; such nodes
+    // have |is_dense_| set, and edges_.edges[label].label is either |label| or
+    // kEmptyLabel.
     //
     // The nodes are generally unordered; since we typically index text, even
     // the root will rarely be more than 20–30 wide, and at that point, it's
@@ -293,7 +343,10 @@ class BASE_EXPORT SubstringSetMatcher {
     // ie., hitting this node during traversal will create one or more
     // matches. This is redundant, but since every single lookup during
     // traversal needs this, it saves a few searches for us.
-    bool has_outputs_ = false;
+    bool has_outputs_ : 1 = false;
+
+    // Whether edges_.edges is a table indexed by label, see above.
+    bool is_dense_ : 1 = false;
 
     // Number of unused left in edges_. Edges are always allocated from the
     // beginning and never deleted; those after num_edges_ will be marked with
@@ -312,8 +365,21 @@ class BASE_EXPORT SubstringSetMatcher {
     uint16_t edges_capacity_ = 0;
   } __attribute__((packed));
 
+  // The nodes of a tree loaded by Load(), see the .cc file for the format.
+  struct SerializedNode;
+
+  // Views of the tree for MatchImpl(), which is shared by both kinds of trees.
+  class BuiltTree;
+  class SerializedTree;
+
   using SubstringPatternVector = std::vector<const MatcherStringPattern*>;
 
+  // Returns the node that the edge labeled |label| among |edges|, those of a
+  // sparse node, leads to, or kInvalidNodeID.
+  static NodeID FindEdge(const AhoCorasickEdge* edges,
+                         size_t num_edges,
+                         uint32_t label);
+
   // Given the set of patterns, compute how many nodes will the corresponding
   // Aho-Corasick tree have. Note that |patterns| need to be sorted.
   NodeID GetTreeSize(
@@ -327,15 +393,52 @@ class BASE_EXPORT SubstringSetMatcher {
 
   void CreateFailureAndOutputEdges();
 
+  // Makes the widest nodes dense, and sets up |first_bytes_|.
+  void OptimizeForMatching();
+
+  // Sets up |first_bytes_| from the edges out of the root.
+  void SetUpFirstBytes(const AhoCorasickEdge* root_edges,
+                       size_t num_root_edges,
+                       bool root_is_dense);
+
+  // Matches |text| against |tree|, storing the IDs of the patterns found in
+  // |matches|. If |matches| is null, returns as soon as anything matches.
+  // Returns whether anything matches.
+  template <typename Tree>
+  bool MatchImpl(const Tree& tree,
+                 const std::string& text,
+                 std::set<MatcherStringPattern::ID>* matches) const;
+
+  // Returns the position of the first character at or after |pos| in |text|
+  // which has an edge out of the root, or text.size() if there is none.
+  size_t SkipToFirstByte(const std::string& text, size_t pos) const;
+
   // Adds all pattern IDs to |matches| which are a suffix of the string
   // represented by |node|.
-  void AccumulateMatchesForNode(
-      const AhoCorasickNode* node,
-      std::set<MatcherStringPattern::ID>* matches) const;
+  template <typename Tree>
+  static void AccumulateMatchesForNode(
+      const Tree& tree,
+      NodeID node,
+      std::set<MatcherStringPattern::ID>* matches);
 
-  // The nodes of a Aho-Corasick tree.
+  // The nodes of a Aho-Corasick tree, if it was built by Build().
   std::vector<AhoCorasickNode> tree_;
 
+  // If the tree was loaded by Load() instead: the serialized tree, and the
+  // nodes and edges in it. These are plain pointers as one of them is read
+  // for every character of the text matched.
+  raw_span<const uint8_t> serialized_;
+  RAW_PTR_EXCLUSION const SerializedNode* serialized_nodes_ = nullptr;
+  RAW_PTR_EXCLUSION const AhoCorasickEdge* serialized_edges_ = nullptr;
+
+  // The characters which have an edge out of the root: bit (c >> 4) & 7 of
+  // first_bytes_[c >> 7][c & 15] is set for each such unsigned char c. Only
+  // used if the root isn't dense, so that skipping over the text beats
+  // looking up each of its characters in the root. The split into nibbles is
+  // what lets SkipToFirstByte() use byte shuffles as table lookups.
+  std::array<std::array<uint8_t, 16>, 2> first_bytes_ = {};
+  bool use_first_bytes_ = false;
+
   bool is_empty_ = true;
 };
 
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "base/check.h"
 #include "base/substring_set_matcher/matcher_string_pattern.h"
 #include "base/substring_set_matcher/substring_set_matcher.h"
 
@@ -29,8 +30,17 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
 
   SubstringSetMatcher matcher;
   if (matcher.Build(patterns)) {
+    const std::string text = provider.ConsumeRandomLengthString();
     std::set<MatcherStringPattern::ID> matches;
-    matcher.Match(provider.ConsumeRandomLengthString(), &matches);
+    matcher.Match(text, &matches);
+
+    // The serialized tree must match the same.
+    const std::vector<uint8_t> serialized = matcher.Serialize();
+    SubstringSetMatcher loaded_matcher;
+    CHECK(loaded_matcher.Load(serialized));
+    std::set<MatcherStringPattern::ID> loaded_matches;
+    loaded_matcher.Match(text, &loaded_matches);
+    CHECK(matches == loaded_matches);
   }
 
   return 0;
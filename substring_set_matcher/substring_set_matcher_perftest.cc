@@ -4,11 +4,14 @@
 
 #include "base/substring_set_matcher/substring_set_matcher.h"
 
+#include <algorithm>
 #include <limits>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/containers/contains.h"
+#include "base/debug/alias.h"
 #include "base/rand_util.h"
 #include "base/time/time.h"
 #include "base/timer/elapsed_timer.h"
@@ -30,6 +33,54 @@ std::string GetRandomString(size_t len) {
   return std::string(random_chars.begin(), random_chars.end());
 }
 
+// Returns a random string of the given length using characters of `alphabet`.
+std::string GetRandomString(size_t len, const std::string& alphabet) {
+  std::string str;
+  str.reserve(len);
+  for (size_t i = 0; i < len; i++)
+    str.push_back(alphabet[base::RandGenerator(alphabet.size())]);
+  return str;
+}
+
+// Reports the throughput of Match() and AnyMatch() of a matcher for
+// `patterns` over `text`, in MB of text per second.
+void RunMatchThroughputTest(const std::string& story,
+                            const std::vector<MatcherStringPattern>& patterns,
+                            const std::string& text) {
+  SubstringSetMatcher matcher;
+  ASSERT_TRUE(matcher.Build(patterns));
+
+  const char* kMatchThroughput = ".match_throughput";
+  const char* kAnyMatchThroughput = ".any_match_throughput";
+  auto reporter = perf_test::PerfResultReporter("SubstringSetMatcher", story);
+  reporter.RegisterImportantMetric(kMatchThroughput, "MB/s");
+  reporter.RegisterImportantMetric(kAnyMatchThroughput, "MB/s");
+
+  // Scan at least 16 MB of text in total; large matchers are slow.
+  const size_t kNumRuns = std::max<size_t>(1, (16u << 20) / text.size());
+  std::set<MatcherStringPattern::ID> matches;
+  base::ElapsedTimer match_timer;
+  for (size_t i = 0; i < kNumRuns; i++) {
+    matches.clear();
+    matcher.Match(text, &matches);
+  }
+  // Bytes per microsecond are MB/s.
+  reporter.AddResult(
+      kMatchThroughput,
+      text.size() * kNumRuns / match_timer.Elapsed().InMicrosecondsF());
+  base::debug::Alias(&matches);
+
+  bool any_match = false;
+  base::ElapsedTimer any_match_timer;
+  for (size_t i = 0; i < kNumRuns; i++) {
+    any_match |= matcher.AnyMatch(text);
+  }
+  reporter.AddResult(
+      kAnyMatchThroughput,
+      text.size() * kNumRuns / any_match_timer.Elapsed().InMicrosecondsF());
+  base::debug::Alias(&any_match);
+}
+
 // Tests performance of SubstringSetMatcher for 20000 random patterns of length
 // 30.
 TEST(SubstringSetMatcherPerfTest, RandomKeys) {
@@ -58,6 +109,13 @@ TEST(SubstringSetMatcherPerfTest, RandomKeys) {
   ASSERT_TRUE(matcher->Build(patterns));
   base::TimeDelta init_time = init_timer.Elapsed();
 
+  // Loading the serialized matcher is the alternative to building it.
+  const std::vector<uint8_t> serialized = matcher->Serialize();
+  base::ElapsedTimer load_timer;
+  SubstringSetMatcher loaded_matcher;
+  ASSERT_TRUE(loaded_matcher.Load(serialized));
+  base::TimeDelta load_time = load_timer.Elapsed();
+
   // Match patterns against a random string of 500 characters.
   const size_t kTextLen = 500;
   base::ElapsedTimer match_timer;
@@ -66,21 +124,57 @@ TEST(SubstringSetMatcherPerfTest, RandomKeys) {
   base::TimeDelta match_time = match_timer.Elapsed();
 
   const char* kInitializationTime = ".init_time";
+  const char* kLoadTime = ".load_time";
   const char* kMatchTime = ".match_time";
   const char* kMemoryUsage = ".memory_usage";
   auto reporter =
       perf_test::PerfResultReporter("SubstringSetMatcher", "RandomKeys");
   reporter.RegisterImportantMetric(kInitializationTime, "us");
+  reporter.RegisterImportantMetric(kLoadTime, "us");
   reporter.RegisterImportantMetric(kMatchTime, "us");
   reporter.RegisterImportantMetric(kMemoryUsage, "Mb");
 
   reporter.AddResult(kInitializationTime, init_time);
+  reporter.AddResult(kLoadTime, load_time);
   reporter.AddResult(kMatchTime, match_time);
   reporter.AddResult(
       kMemoryUsage,
       (base::trace_event::EstimateMemoryUsage(matcher) * 1.0 / (1 << 20)));
 }
 
+// Tests the throughput of SubstringSetMatcher for a filter list the size of
+// those for URLs, over URL-like text which matches none of it. Most characters
+// have an edge out of the root, so this measures the automaton itself.
+TEST(SubstringSetMatcherPerfTest, ManyUrlPatterns) {
+  const std::string kAlphabet = "abcdefghijklmnopqrstuvwxyz0123456789-./?=&_";
+  std::vector<MatcherStringPattern> patterns;
+  std::set<std::string> pattern_strings;
+  for (size_t i = 0; i < 100000; i++) {
+    std::string str = GetRandomString(base::RandInt(8, 24), kAlphabet);
+    if (pattern_strings.insert(str).second)
+      patterns.emplace_back(str, i);
+  }
+  RunMatchThroughputTest("ManyUrlPatterns", patterns,
+                         GetRandomString(64 << 10, kAlphabet));
+}
+
+// Tests the throughput of SubstringSetMatcher for patterns which all start
+// with one of a few characters that are rare in the text, so that most of it
+// is skipped without entering the automaton.
+TEST(SubstringSetMatcherPerfTest, FewFirstBytes) {
+  std::vector<MatcherStringPattern> patterns;
+  std::set<std::string> pattern_strings;
+  for (size_t i = 0; i < 1000; i++) {
+    std::string str = GetRandomString(1, "/?&") + GetRandomString(10);
+    if (pattern_strings.insert(str).second)
+      patterns.emplace_back(str, i);
+  }
+  std::string text = GetRandomString(64 << 10);
+  for (size_t i = 0; i < text.size(); i += 100)
+    text[i] = '/';
+  RunMatchThroughputTest("FewFirstBytes", patterns, text);
+}
+
 }  // namespace
 
 }  // namespace base
@@ -8,8 +8,10 @@
 
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "base/rand_util.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -17,6 +19,44 @@ namespace base {
 
 namespace {
 
+std::string RandomString(size_t len, std::string_view alphabet) {
+  std::string str;
+  for (size_t i = 0; i < len; ++i) {
+    str.push_back(alphabet[RandGenerator(alphabet.size())]);
+  }
+  return str;
+}
+
+// Checks Match() and AnyMatch() against std::string::find(), with random texts
+// over `text_alphabet`, both for a matcher built for `patterns` and for one
+// loaded from its serialization.
+void TestAgainstFind(const std::vector<MatcherStringPattern>& patterns,
+                     std::string_view text_alphabet) {
+  SubstringSetMatcher built_matcher;
+  ASSERT_TRUE(built_matcher.Build(patterns));
+  const std::vector<uint8_t> serialized = built_matcher.Serialize();
+  SubstringSetMatcher loaded_matcher;
+  ASSERT_TRUE(loaded_matcher.Load(serialized));
+  EXPECT_EQ(serialized, loaded_matcher.Serialize());
+
+  for (size_t len : {0, 1, 31, 32, 33, 100, 1000}) {
+    const std::string text = RandomString(len, text_alphabet);
+    std::set<MatcherStringPattern::ID> expected;
+    for (const MatcherStringPattern& pattern : patterns) {
+      if (text.find(pattern.pattern()) != std::string::npos) {
+        expected.insert(pattern.id());
+      }
+    }
+    for (const SubstringSetMatcher* matcher :
+         {&built_matcher, &loaded_matcher}) {
+      std::set<MatcherStringPattern::ID> matches;
+      EXPECT_EQ(!expected.empty(), matcher->Match(text, &matches)) << text;
+      EXPECT_EQ(expected, matches) << text;
+      EXPECT_EQ(!expected.empty(), matcher->AnyMatch(text)) << text;
+    }
+  }
+}
+
 void TestOnePattern(const std::string& test_string,
                     const std::string& pattern,
                     bool is_match) {
@@ -220,4 +260,112 @@ TEST(SubstringSetMatcherTest, LotsOfEdges) {
   matcher.Build(patterns);
 }
 
+// Few first characters, so the matcher skips over the text to them.
+TEST(SubstringSetMatcherTest, SkipsToFirstBytes) {
+  const std::string kTextAlphabet = "ab\x7f\x80\xc3\xff .:/";
+  for (int run = 0; run < 20; ++run) {
+    std::vector<MatcherStringPattern> patterns;
+    std::set<std::string> pattern_strings;
+    for (int i = 0; i < 8; ++i) {
+      std::string str = RandomString(RandInt(1, 4), "a\x80\xff/");
+      if (pattern_strings.insert(str).second) {
+        patterns.emplace_back(str, i);
+      }
+    }
+    TestAgainstFind(patterns, kTextAlphabet);
+  }
+}
+
+// Many edges out of the root and of its children, so they are dense.
+TEST(SubstringSetMatcherTest, DenseNodes) {
+  std::string alphabet;
+  for (int c = 0; c < 256; c += 3) {
+    alphabet.push_back(static_cast<char>(c));
+  }
+  for (int run = 0; run < 5; ++run) {
+    std::vector<MatcherStringPattern> patterns;
+    std::set<std::string> pattern_strings;
+    for (int i = 0; i < 2000; ++i) {
+      std::string str = RandomString(RandInt(1, 3), alphabet);
+      if (pattern_strings.insert(str).second) {
+        patterns.emplace_back(str, i);
+      }
+    }
+    TestAgainstFind(patterns, alphabet);
+  }
+}
+
+TEST(SubstringSetMatcherTest, LoadSerialized) {
+  std::vector<MatcherStringPattern> patterns;
+  patterns.emplace_back("", 0);
+  patterns.emplace_back("abc", 1);
+  patterns.emplace_back("bc", 2);
+  patterns.emplace_back("c", 3);
+  patterns.emplace_back("xyz", 4);
+  TestAgainstFind(patterns, "abcxyz");
+
+  SubstringSetMatcher empty_matcher;
+  ASSERT_TRUE(empty_matcher.Build(std::vector<MatcherStringPattern>()));
+  SubstringSetMatcher loaded_empty_matcher;
+  ASSERT_TRUE(loaded_empty_matcher.Load(empty_matcher.Serialize()));
+  EXPECT_TRUE(loaded_empty_matcher.IsEmpty());
+  EXPECT_FALSE(loaded_empty_matcher.AnyMatch("abc"));
+}
+
+TEST(SubstringSetMatcherTest, LoadRejectsInvalidData) {
+  std::vector<MatcherStringPattern> patterns;
+  patterns.emplace_back("abc", 1);
+  patterns.emplace_back("bcd", 2);
+  SubstringSetMatcher matcher;
+  ASSERT_TRUE(matcher.Build(patterns));
+  const std::vector<uint8_t> serialized = matcher.Serialize();
+
+  EXPECT_FALSE(SubstringSetMatcher().Load({}));
+  // Truncated.
+  EXPECT_FALSE(SubstringSetMatcher().Load(
+      span(serialized).first(serialized.size() - 4)));
+  // Trailing data.
+  std::vector<uint8_t> padded = serialized;
+  padded.resize(padded.size() + 4);
+  EXPECT_FALSE(SubstringSetMatcher().Load(padded));
+  // Misaligned.
+  std::vector<uint8_t> misaligned(serialized.size() + 1);
+  span(misaligned).subspan(1u).copy_from(serialized);
+  EXPECT_FALSE(SubstringSetMatcher().Load(span(misaligned).subspan(1u)));
+  // Wrong magic.
+  std::vector<uint8_t> wrong_magic = serialized;
+  wrong_magic[0] ^= 1;
+  EXPECT_FALSE(SubstringSetMatcher().Load(wrong_magic));
+}
+
+// Any data which Load() accepts must be safe to match against, since it may
+// come from another process.
+TEST(SubstringSetMatcherTest, LoadCorruptedData) {
+  std::vector<MatcherStringPattern> patterns;
+  std::set<std::string> pattern_strings;
+  for (int i = 0; i < 50; ++i) {
+    std::string str = RandomString(RandInt(1, 6), "abcd");
+    if (pattern_strings.insert(str).second) {
+      patterns.emplace_back(str, i);
+    }
+  }
+  SubstringSetMatcher matcher;
+  ASSERT_TRUE(matcher.Build(patterns));
+  const std::vector<uint8_t> serialized = matcher.Serialize();
+
+  for (int run = 0; run < 1000; ++run) {
+    std::vector<uint8_t> corrupted = serialized;
+    for (int i = 0; i < 3; ++i) {
+      // Spare the header, else most runs only test its check.
+      corrupted[RandInt(16, corrupted.size() - 1)] = RandInt(0, 255);
+    }
+    SubstringSetMatcher corrupted_matcher;
+    if (corrupted_matcher.Load(corrupted)) {
+      std::set<MatcherStringPattern::ID> matches;
+      corrupted_matcher.Match(RandomString(100, "abcd"), &matches);
+      corrupted_matcher.AnyMatch(RandomString(100, "abcd"));
+    }
+  }
+}
+
 }  // namespace base
@@ -0,0 +1,109 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SYNCHRONIZATION_ATOMIC_SNAPSHOT_H_
+#define BASE_SYNCHRONIZATION_ATOMIC_SNAPSHOT_H_
+
+#include <utility>
+
+#include "base/functional/function_ref.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/rw_lock.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/thread_annotations.h"
+
+namespace base {
+
+// Holds an immutable snapshot of a value of type T, which writers replace as a
+// whole, in the style of RCU: readers either borrow the current snapshot for
+// the duration of a call, or take a reference to it which keeps it alive
+// after it's replaced. Readers only acquire their own shard of a
+// ShardedRWLock, so they don't contend with each other. Writes copy the
+// value, so they are expensive; use this for read-mostly data which isn't
+// trivially copyable, and SeqLock otherwise.
+//
+// If a `reclaim_task_runner` is provided, the snapshots replaced by writers are
+// released on it, so that writers don't pay for destroying them. Snapshots
+// referenced by readers are destroyed when the last reference goes away.
+//
+// Example:
+//   using Params = std::map<std::string, std::string>;
+//   AtomicSnapshot<Params> params;
+//   ...
+//   params.Update([](Params& map) { map["key"] = "value"; });
+//   ...
+//   params.Read([&](const Params& map) { ... });
+template <typename T>
+class AtomicSnapshot {
+ public:
+  using Snapshot = RefCountedData<T>;
+
+  explicit AtomicSnapshot(
+      T value = T(),
+      scoped_refptr<SequencedTaskRunner> reclaim_task_runner = nullptr)
+      : current_(MakeRefCounted<Snapshot>(std::move(value))),
+        reclaim_task_runner_(std::move(reclaim_task_runner)) {}
+  AtomicSnapshot(const AtomicSnapshot&) = delete;
+  AtomicSnapshot& operator=(const AtomicSnapshot&) = delete;
+  ~AtomicSnapshot() = default;
+
+  // Runs `reader` with the current value, which can't be replaced until
+  // `reader` returns. `reader` must not write to this AtomicSnapshot.
+  void Read(FunctionRef<void(const T&)> reader) const {
+    AutoShardedReadLock auto_lock(lock_);
+    reader(current_->data);
+  }
+
+  // Returns a reference to the current snapshot, which stays valid after it's
+  // replaced.
+  scoped_refptr<const Snapshot> Load() const {
+    AutoShardedReadLock auto_lock(lock_);
+    return current_;
+  }
+
+  // Replaces the current value with `value`.
+  void Store(T value) {
+    AutoLock writer_lock(writer_lock_);
+    Replace(MakeRefCounted<Snapshot>(std::move(value)));
+  }
+
+  // Replaces the current value with a copy of it modified by `updater`.
+  // Concurrent updates are serialized, so none of them is lost.
+  void Update(FunctionRef<void(T&)> updater) {
+    AutoLock writer_lock(writer_lock_);
+    scoped_refptr<Snapshot> snapshot;
+    {
+      AutoShardedReadLock auto_lock(lock_);
+      snapshot = MakeRefCounted<Snapshot>(current_->data);
+    }
+    updater(snapshot->data);
+    Replace(std::move(snapshot));
+  }
+
+ private:
+  void Replace(scoped_refptr<Snapshot> snapshot)
+      EXCLUSIVE_LOCKS_REQUIRED(writer_lock_) {
+    {
+      AutoShardedWriteLock auto_lock(lock_);
+      std::swap(current_, snapshot);
+    }
+    if (reclaim_task_runner_) {
+      reclaim_task_runner_->ReleaseSoon(FROM_HERE, std::move(snapshot));
+    }
+  }
+
+  // Serializes writers, so that only they acquire `lock_` for writing, and
+  // only to swap `current_`.
+  Lock writer_lock_;
+  mutable ShardedRWLock lock_;
+  scoped_refptr<Snapshot> current_ GUARDED_BY(lock_);
+  const scoped_refptr<SequencedTaskRunner> reclaim_task_runner_;
+};
+
+}  // namespace base
+
+#endif  // BASE_SYNCHRONIZATION_ATOMIC_SNAPSHOT_H_
@@ -0,0 +1,110 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/atomic_snapshot.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/memory/raw_ptr.h"
+#include "base/test/task_environment.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Increments `*num_destroyed` when destroyed.
+class DestructionCounter {
+ public:
+  explicit DestructionCounter(int* num_destroyed)
+      : num_destroyed_(num_destroyed) {}
+  DestructionCounter(const DestructionCounter& other) = default;
+  DestructionCounter& operator=(const DestructionCounter&) = delete;
+  ~DestructionCounter() { ++*num_destroyed_; }
+
+ private:
+  const raw_ptr<int> num_destroyed_;
+};
+
+class UpdaterThread : public PlatformThread::Delegate {
+ public:
+  explicit UpdaterThread(AtomicSnapshot<std::vector<int>>& snapshot)
+      : snapshot_(snapshot) {}
+  UpdaterThread(const UpdaterThread&) = delete;
+  UpdaterThread& operator=(const UpdaterThread&) = delete;
+
+  void ThreadMain() override {
+    for (int i = 0; i < kNumUpdates; ++i) {
+      snapshot_.Update([](std::vector<int>& values) { values.push_back(1); });
+    }
+  }
+
+  static constexpr int kNumUpdates = 1000;
+
+ private:
+  AtomicSnapshot<std::vector<int>>& snapshot_;
+};
+
+}  // namespace
+
+TEST(AtomicSnapshotTest, StoreAndRead) {
+  using Map = std::map<std::string, std::string>;
+  AtomicSnapshot<Map> snapshot;
+  snapshot.Read([](const Map& map) { EXPECT_TRUE(map.empty()); });
+
+  snapshot.Store({{"a", "1"}});
+  snapshot.Update([](Map& map) { map["b"] = "2"; });
+  snapshot.Read([](const Map& map) {
+    EXPECT_EQ(2u, map.size());
+    EXPECT_EQ("1", map.at("a"));
+    EXPECT_EQ("2", map.at("b"));
+  });
+}
+
+TEST(AtomicSnapshotTest, LoadedSnapshotOutlivesReplacement) {
+  AtomicSnapshot<std::string> snapshot("first");
+  scoped_refptr<const AtomicSnapshot<std::string>::Snapshot> first =
+      snapshot.Load();
+  snapshot.Store("second");
+  EXPECT_EQ("first", first->data);
+  EXPECT_EQ("second", snapshot.Load()->data);
+}
+
+TEST(AtomicSnapshotTest, ReplacedSnapshotReclaimedOnTaskRunner) {
+  test::TaskEnvironment task_environment;
+  int num_destroyed = 0;
+  AtomicSnapshot<DestructionCounter> snapshot(
+      DestructionCounter(&num_destroyed),
+      SequencedTaskRunner::GetCurrentDefault());
+  // Destroys the temporary which initialized the snapshot.
+  EXPECT_EQ(1, num_destroyed);
+
+  snapshot.Update([](DestructionCounter&) {});
+  EXPECT_EQ(1, num_destroyed);
+  task_environment.RunUntilIdle();
+  EXPECT_EQ(2, num_destroyed);
+}
+
+// Readers concurrent with updates see each update entirely, in order.
+TEST(AtomicSnapshotTest, ConcurrentUpdates) {
+  AtomicSnapshot<std::vector<int>> snapshot;
+  UpdaterThread updater(snapshot);
+  PlatformThreadHandle handle;
+  ASSERT_TRUE(PlatformThread::Create(0, &updater, &handle));
+
+  size_t last_size = 0;
+  while (last_size < UpdaterThread::kNumUpdates) {
+    snapshot.Read([&](const std::vector<int>& values) {
+      EXPECT_GE(values.size(), last_size);
+      last_size = values.size();
+    });
+  }
+
+  PlatformThread::Join(handle);
+}
+
+}  // namespace base
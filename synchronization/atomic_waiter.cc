@@ -0,0 +1,188 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/atomic_waiter.h"
+
+#include "base/check.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <limits>
+#elif BUILDFLAG(IS_FUCHSIA)
+#include <zircon/syscalls.h>
+
+#include <limits>
+#elif BUILDFLAG(IS_WIN)
+#include <windows.h>
+
+#include "base/numerics/safe_conversions.h"
+#else
+#include <array>
+
+#include "base/no_destructor.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#endif
+
+namespace base {
+
+namespace {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "The kernel waits on the atomic's storage.");
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+bool WaitImpl(const std::atomic<uint32_t>& atomic,
+              uint32_t expected_value,
+              TimeDelta timeout) {
+  struct timespec relative_timeout;
+  if (!timeout.is_max()) {
+    relative_timeout = timeout.ToTimeSpec();
+  }
+  const long rv =
+      syscall(SYS_futex, &atomic, FUTEX_WAIT_PRIVATE, expected_value,
+              timeout.is_max() ? nullptr : &relative_timeout, nullptr, 0);
+  DPCHECK(rv == 0 || errno == EAGAIN || errno == EINTR || errno == ETIMEDOUT);
+  return rv == 0 || errno != ETIMEDOUT;
+}
+
+void Notify(std::atomic<uint32_t>& atomic, bool notify_all) {
+  [[maybe_unused]] const long rv = syscall(
+      SYS_futex, &atomic, FUTEX_WAKE_PRIVATE,
+      notify_all ? std::numeric_limits<int>::max() : 1, nullptr, nullptr, 0);
+  DPCHECK(rv >= 0);
+}
+
+#elif BUILDFLAG(IS_FUCHSIA)
+
+bool WaitImpl(const std::atomic<uint32_t>& atomic,
+              uint32_t expected_value,
+              TimeDelta timeout) {
+  const zx_time_t deadline = timeout.is_max()
+                                 ? ZX_TIME_INFINITE
+                                 : zx_deadline_after(timeout.InNanoseconds());
+  const zx_status_t status = zx_futex_wait(
+      reinterpret_cast<const zx_futex_t*>(&atomic),
+      static_cast<zx_futex_t>(expected_value), ZX_HANDLE_INVALID, deadline);
+  DCHECK(status == ZX_OK || status == ZX_ERR_BAD_STATE ||
+         status == ZX_ERR_TIMED_OUT);
+  return status != ZX_ERR_TIMED_OUT;
+}
+
+void Notify(std::atomic<uint32_t>& atomic, bool notify_all) {
+  [[maybe_unused]] const zx_status_t status =
+      zx_futex_wake(reinterpret_cast<const zx_futex_t*>(&atomic),
+                    notify_all ? std::numeric_limits<uint32_t>::max() : 1);
+  DCHECK_EQ(status, ZX_OK);
+}
+
+#elif BUILDFLAG(IS_WIN)
+
+bool WaitImpl(const std::atomic<uint32_t>& atomic,
+              uint32_t expected_value,
+              TimeDelta timeout) {
+  // Round the timeout up, so as not to return before it expires.
+  const DWORD timeout_ms =
+      timeout.is_max()
+          ? INFINITE
+          : saturated_cast<DWORD>(timeout.InMillisecondsRoundedUp());
+  if (::WaitOnAddress(const_cast<std::atomic<uint32_t>*>(&atomic),
+                      &expected_value, sizeof(expected_value), timeout_ms)) {
+    return true;
+  }
+  DPCHECK(::GetLastError() == ERROR_TIMEOUT);
+  return false;
+}
+
+void Notify(std::atomic<uint32_t>& atomic, bool notify_all) {
+  if (notify_all) {
+    ::WakeByAddressAll(&atomic);
+  } else {
+    ::WakeByAddressSingle(&atomic);
+  }
+}
+
+#else
+
+// Waiters are parked on the condition variable of a bucket picked by the
+// address of the atomic they wait on. Different atomics may share a bucket, so
+// notifications wake up all the waiters of the bucket.
+struct Bucket {
+  Lock lock;
+  ConditionVariable condition_variable{&lock};
+};
+
+constexpr size_t kNumBuckets = 16;
+
+Bucket& GetBucket(const std::atomic<uint32_t>& atomic) {
+  static NoDestructor<std::array<Bucket, kNumBuckets>> buckets;
+  return (*buckets)[(reinterpret_cast<uintptr_t>(&atomic) / sizeof(uint32_t)) %
+                    kNumBuckets];
+}
+
+bool WaitImpl(const std::atomic<uint32_t>& atomic,
+              uint32_t expected_value,
+              TimeDelta timeout) {
+  Bucket& bucket = GetBucket(atomic);
+  AutoLock auto_lock(bucket.lock);
+  // Notifiers acquire the lock after changing the value, so this either sees
+  // the new value or waits before the notification.
+  if (atomic.load(std::memory_order_relaxed) != expected_value) {
+    return true;
+  }
+  if (timeout.is_max()) {
+    bucket.condition_variable.Wait();
+    return true;
+  }
+  const TimeTicks deadline = TimeTicks::Now() + timeout;
+  bucket.condition_variable.TimedWait(timeout);
+  return atomic.load(std::memory_order_relaxed) != expected_value ||
+         TimeTicks::Now() < deadline;
+}
+
+void Notify(std::atomic<uint32_t>& atomic, bool notify_all) {
+  Bucket& bucket = GetBucket(atomic);
+  AutoLock auto_lock(bucket.lock);
+  bucket.condition_variable.Broadcast();
+}
+
+#endif
+
+}  // namespace
+
+// static
+bool AtomicWaiter::Wait(const std::atomic<uint32_t>& atomic,
+                        uint32_t expected_value,
+                        TimeDelta timeout) {
+  if (atomic.load(std::memory_order_acquire) != expected_value) {
+    return true;
+  }
+  if (timeout <= TimeDelta()) {
+    return false;
+  }
+  internal::ScopedBlockingCallWithBaseSyncPrimitives scoped_blocking_call(
+      FROM_HERE, BlockingType::MAY_BLOCK);
+  return WaitImpl(atomic, expected_value, timeout);
+}
+
+// static
+void AtomicWaiter::NotifyOne(std::atomic<uint32_t>& atomic) {
+  Notify(atomic, /*notify_all=*/false);
+}
+
+// static
+void AtomicWaiter::NotifyAll(std::atomic<uint32_t>& atomic) {
+  Notify(atomic, /*notify_all=*/true);
+}
+
+}  // namespace base
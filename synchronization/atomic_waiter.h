@@ -0,0 +1,57 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SYNCHRONIZATION_ATOMIC_WAITER_H_
+#define BASE_SYNCHRONIZATION_ATOMIC_WAITER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/time/time.h"
+
+namespace base {
+
+// Waits for a 32-bit atomic to change, like std::atomic<>::wait() but with a
+// timeout, and integrated with ScopedBlockingCall. This lets flags, counters
+// and state machines made of a single atomic be waited on without a separate
+// WaitableEvent, which needs a kernel object or a lock and a condition
+// variable. The waits use futexes on Linux, ChromeOS and Android, Zircon
+// futexes on Fuchsia and WaitOnAddress() on Windows; elsewhere, they use a
+// condition variable from a small process-wide table.
+//
+// Example:
+//   std::atomic<uint32_t> state{kPending};
+//   ...
+//   // Waiting thread.
+//   uint32_t current;
+//   while ((current = state.load(std::memory_order_acquire)) == kPending) {
+//     AtomicWaiter::Wait(state, current);
+//   }
+//   ...
+//   // Notifying thread.
+//   state.store(kDone, std::memory_order_release);
+//   AtomicWaiter::NotifyAll(state);
+class BASE_EXPORT AtomicWaiter {
+ public:
+  AtomicWaiter() = delete;
+
+  // Blocks the current thread while `atomic` holds `expected_value`, until
+  // another thread notifies it or `timeout` expires. Returns false if
+  // `timeout` expired. Like condition variables, this may return spuriously,
+  // so callers must check `atomic` again.
+  static bool Wait(const std::atomic<uint32_t>& atomic,
+                   uint32_t expected_value,
+                   TimeDelta timeout = TimeDelta::Max());
+
+  // Wakes up one or all of the threads waiting on `atomic`. The new value must
+  // be stored before calling these.
+  static void NotifyOne(std::atomic<uint32_t>& atomic);
+  static void NotifyAll(std::atomic<uint32_t>& atomic);
+};
+
+}  // namespace base
+
+#endif  // BASE_SYNCHRONIZATION_ATOMIC_WAITER_H_
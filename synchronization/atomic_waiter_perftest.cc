@@ -0,0 +1,103 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/atomic_waiter.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include "base/memory/raw_ref.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/timer/lap_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixAtomicWaiter[] = "AtomicWaiter.";
+constexpr char kMetricRoundTripTime[] = "round_trip_time";
+constexpr char kMetricNotifyThroughput[] = "notify_throughput";
+constexpr char kStoryMultiThread[] = "multi_thread_1000_samples";
+constexpr char kStoryNoWaiter[] = "no_waiter";
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixAtomicWaiter,
+                                         story_name);
+  reporter.RegisterImportantMetric(kMetricRoundTripTime, "ns");
+  reporter.RegisterImportantMetric(kMetricNotifyThroughput, "runs/s");
+  return reporter;
+}
+
+// Waits until `*atomic` is odd, moves it to the next even value and notifies
+// the main thread, until it reaches `num_round_trips` * 2.
+class PingPongThread : public SimpleThread {
+ public:
+  PingPongThread(std::atomic<uint32_t>& atomic, uint32_t num_round_trips)
+      : SimpleThread("AtomicWaiterPerfTest"),
+        atomic_(atomic),
+        num_round_trips_(num_round_trips) {}
+
+  void Run() override {
+    for (uint32_t i = 0; i < num_round_trips_; ++i) {
+      uint32_t value;
+      while ((value = atomic_->load(std::memory_order_acquire)) % 2 == 0) {
+        AtomicWaiter::Wait(*atomic_, value);
+      }
+      atomic_->fetch_add(1, std::memory_order_release);
+      AtomicWaiter::NotifyOne(*atomic_);
+    }
+  }
+
+ private:
+  const raw_ref<std::atomic<uint32_t>> atomic_;
+  const uint32_t num_round_trips_;
+};
+
+}  // namespace
+
+// Comparable to WaitableEventPerfTest.MultipleThreads.
+TEST(AtomicWaiterPerfTest, MultipleThreads) {
+  constexpr uint32_t kSamples = 1000;
+  std::atomic<uint32_t> atomic{0};
+  PingPongThread thread(atomic, kSamples);
+  thread.Start();
+
+  ElapsedTimer timer;
+  for (uint32_t i = 0; i < kSamples; ++i) {
+    atomic.fetch_add(1, std::memory_order_release);
+    AtomicWaiter::NotifyOne(atomic);
+    uint32_t value;
+    while ((value = atomic.load(std::memory_order_acquire)) % 2 != 0) {
+      AtomicWaiter::Wait(atomic, value);
+    }
+  }
+  const TimeDelta elapsed = timer.Elapsed();
+  thread.Join();
+
+  auto reporter = SetUpReporter(kStoryMultiThread);
+  reporter.AddResult(kMetricRoundTripTime,
+                     static_cast<size_t>(elapsed.InNanoseconds()) / kSamples);
+}
+
+// Notifying an atomic nobody waits on should be cheap.
+TEST(AtomicWaiterPerfTest, NotifyWithoutWaiter) {
+  std::atomic<uint32_t> atomic{0};
+  LapTimer timer;
+  do {
+    atomic.fetch_add(1, std::memory_order_release);
+    AtomicWaiter::NotifyOne(atomic);
+    timer.NextLap();
+  } while (!timer.HasTimeLimitExpired());
+
+  auto reporter = SetUpReporter(kStoryNoWaiter);
+  reporter.AddResult(kMetricNotifyThroughput, timer.LapsPerSecond());
+}
+
+}  // namespace base
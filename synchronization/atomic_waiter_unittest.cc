@@ -0,0 +1,122 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/atomic_waiter.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/memory/raw_ref.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Waits until the atomic holds a non-zero value.
+class WaiterThread : public SimpleThread {
+ public:
+  explicit WaiterThread(const std::atomic<uint32_t>& atomic)
+      : SimpleThread("WaiterThread"), atomic_(atomic) {}
+
+  void Run() override {
+    while (atomic_->load(std::memory_order_acquire) == 0) {
+      AtomicWaiter::Wait(*atomic_, 0);
+    }
+  }
+
+ private:
+  const raw_ref<const std::atomic<uint32_t>> atomic_;
+};
+
+// Increments the atomic to odd values, and waits for the other thread to
+// increment it to even values.
+class PingPongThread : public SimpleThread {
+ public:
+  PingPongThread(std::atomic<uint32_t>& atomic, uint32_t num_round_trips)
+      : SimpleThread("PingPongThread"),
+        atomic_(atomic),
+        num_round_trips_(num_round_trips) {}
+
+  void Run() override {
+    for (uint32_t i = 0; i < num_round_trips_; ++i) {
+      uint32_t value;
+      while ((value = atomic_->load(std::memory_order_acquire)) % 2 != 0) {
+        AtomicWaiter::Wait(*atomic_, value);
+      }
+      atomic_->fetch_add(1, std::memory_order_release);
+      AtomicWaiter::NotifyOne(*atomic_);
+    }
+  }
+
+ private:
+  const raw_ref<std::atomic<uint32_t>> atomic_;
+  const uint32_t num_round_trips_;
+};
+
+}  // namespace
+
+TEST(AtomicWaiterTest, ReturnsImmediatelyIfValueDiffers) {
+  std::atomic<uint32_t> atomic{1};
+  EXPECT_TRUE(AtomicWaiter::Wait(atomic, 0));
+  EXPECT_TRUE(AtomicWaiter::Wait(atomic, 0, TimeDelta()));
+}
+
+TEST(AtomicWaiterTest, TimesOut) {
+  std::atomic<uint32_t> atomic{0};
+  EXPECT_FALSE(AtomicWaiter::Wait(atomic, 0, TimeDelta()));
+
+  const TimeTicks start = TimeTicks::Now();
+  // Spurious wake-ups are allowed, but shouldn't last the whole timeout.
+  while (AtomicWaiter::Wait(atomic, 0, Milliseconds(10))) {
+    ASSERT_LT(TimeTicks::Now() - start, Seconds(10));
+  }
+  EXPECT_GE(TimeTicks::Now() - start, Milliseconds(10));
+}
+
+TEST(AtomicWaiterTest, NotifyAll) {
+  constexpr size_t kNumThreads = 4;
+  std::atomic<uint32_t> atomic{0};
+  std::vector<std::unique_ptr<WaiterThread>> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.push_back(std::make_unique<WaiterThread>(atomic));
+    threads.back()->Start();
+  }
+
+  // Give the threads a chance to wait.
+  PlatformThread::Sleep(Milliseconds(10));
+  atomic.store(1, std::memory_order_release);
+  AtomicWaiter::NotifyAll(atomic);
+
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+}
+
+TEST(AtomicWaiterTest, PingPong) {
+  constexpr uint32_t kNumRoundTrips = 1000;
+  std::atomic<uint32_t> atomic{0};
+  PingPongThread thread(atomic, kNumRoundTrips);
+  thread.Start();
+
+  for (uint32_t i = 0; i < kNumRoundTrips; ++i) {
+    uint32_t value;
+    while ((value = atomic.load(std::memory_order_acquire)) % 2 == 0) {
+      AtomicWaiter::Wait(atomic, value);
+    }
+    atomic.fetch_add(1, std::memory_order_release);
+    AtomicWaiter::NotifyOne(atomic);
+  }
+
+  thread.Join();
+  EXPECT_EQ(2 * kNumRoundTrips, atomic.load());
+}
+
+}  // namespace base
@@ -72,6 +72,7 @@
 
 #include "base/base_export.h"
 #include "base/synchronization/lock.h"
+#include "base/synchronization/synchronization_buildflags.h"
 
 #if BUILDFLAG(IS_WIN)
 #include "base/win/windows_types.h"
@@ -126,7 +127,7 @@ class BASE_EXPORT ConditionVariable {
   raw_ptr<pthread_mutex_t> user_mutex_;
 #endif
 
-#if DCHECK_IS_ON()
+#if DCHECK_IS_ON() || BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
   const raw_ptr<base::Lock>
       user_lock_;  // Needed to adjust shadow lock state on wait.
 #endif
@@ -41,7 +41,7 @@ namespace base {
 
 ConditionVariable::ConditionVariable(Lock* user_lock)
     : user_mutex_(user_lock->lock_.native_handle())
-#if DCHECK_IS_ON()
+#if DCHECK_IS_ON() || BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
     , user_lock_(user_lock)
 #endif
 {
@@ -102,6 +102,10 @@ void ConditionVariable::Wait() {
 
 #if DCHECK_IS_ON()
   user_lock_->CheckHeldAndUnmark();
+#endif
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+  // Drop the sample of a contended acquisition, which ends with the wait.
+  user_lock_->contention_sample_.reset();
 #endif
   int rv = pthread_cond_wait(&condition_, user_mutex_);
   DCHECK_EQ(0, rv);
@@ -126,6 +130,10 @@ void ConditionVariable::TimedWait(const TimeDelta& max_time) {
 #if DCHECK_IS_ON()
   user_lock_->CheckHeldAndUnmark();
 #endif
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+  // Drop the sample of a contended acquisition, which ends with the wait.
+  user_lock_->contention_sample_.reset();
+#endif
 
 #if BUILDFLAG(IS_APPLE)
   int rv = pthread_cond_timedwait_relative_np(
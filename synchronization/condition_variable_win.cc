@@ -18,7 +18,7 @@ namespace base {
 
 ConditionVariable::ConditionVariable(Lock* user_lock)
     : srwlock_(user_lock->lock_.native_handle())
-#if DCHECK_IS_ON()
+#if DCHECK_IS_ON() || BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
     , user_lock_(user_lock)
 #endif
 {
@@ -44,6 +44,10 @@ void ConditionVariable::TimedWait(const TimeDelta& max_time) {
 #if DCHECK_IS_ON()
   user_lock_->CheckHeldAndUnmark();
 #endif
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+  // Drop the sample of a contended acquisition, which ends with the wait.
+  user_lock_->contention_sample_.reset();
+#endif
 
   if (!SleepConditionVariableSRW(reinterpret_cast<PCONDITION_VARIABLE>(&cv_),
                                  reinterpret_cast<PSRWLOCK>(srwlock_.get()),
@@ -0,0 +1,59 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/latch.h"
+
+#include "base/check_op.h"
+#include "base/synchronization/atomic_waiter.h"
+
+namespace base {
+
+Latch::Latch(uint32_t count) : count_(count) {}
+
+Latch::~Latch() = default;
+
+void Latch::CountDown(uint32_t n) {
+  // Releases the writes of the current thread to the threads which return from
+  // Wait().
+  const uint32_t previous_count =
+      count_.fetch_sub(n, std::memory_order_acq_rel);
+  DCHECK_GE(previous_count, n);
+  if (previous_count == n) {
+    AtomicWaiter::NotifyAll(count_);
+  }
+}
+
+bool Latch::IsSignaled() const {
+  return count_.load(std::memory_order_acquire) == 0;
+}
+
+void Latch::Wait() const {
+  uint32_t count;
+  while ((count = count_.load(std::memory_order_acquire)) != 0) {
+    AtomicWaiter::Wait(count_, count);
+  }
+}
+
+bool Latch::TimedWait(TimeDelta timeout) const {
+  if (IsSignaled()) {
+    return true;
+  }
+  const TimeTicks deadline = TimeTicks::Now() + timeout;
+  uint32_t count;
+  while ((count = count_.load(std::memory_order_acquire)) != 0) {
+    const TimeDelta remaining = deadline - TimeTicks::Now();
+    if (!remaining.is_positive()) {
+      return false;
+    }
+    AtomicWaiter::Wait(count_, count, remaining);
+  }
+  return true;
+}
+
+void Latch::ArriveAndWait(uint32_t n) {
+  CountDown(n);
+  Wait();
+}
+
+}  // namespace base
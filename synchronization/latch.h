@@ -0,0 +1,67 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SYNCHRONIZATION_LATCH_H_
+#define BASE_SYNCHRONIZATION_LATCH_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/time/time.h"
+
+namespace base {
+
+// A single-use countdown on which threads can block until it reaches zero,
+// like std::latch but with timed waits and integrated with ScopedBlockingCall.
+// It is meant for fan-in of parallel work, e.g. waiting for N tasks posted to
+// the ThreadPool:
+//
+//   Latch latch(kNumTasks);
+//   for (int i = 0; i < kNumTasks; ++i) {
+//     ThreadPool::PostTask(FROM_HERE,
+//                          BindOnce(&DoWork, i, Unretained(&latch)));
+//   }
+//   latch.Wait();
+//
+//   void DoWork(int i, Latch* latch) {
+//     ...
+//     latch->CountDown();
+//   }
+//
+// Unlike a WaitableEvent, a Latch is a single atomic that is waited on with
+// AtomicWaiter: counting down only takes an atomic decrement, and the waiters
+// are woken up once, by the call that reaches zero.
+class BASE_EXPORT Latch {
+ public:
+  explicit Latch(uint32_t count);
+  Latch(const Latch&) = delete;
+  Latch& operator=(const Latch&) = delete;
+  ~Latch();
+
+  // Decrements the count by `n`, which must not exceed the count, and wakes up
+  // the waiting threads if it reaches zero. Can be called from any thread.
+  void CountDown(uint32_t n = 1);
+
+  // Returns true if the count reached zero. Never blocks.
+  bool IsSignaled() const;
+
+  // Blocks until the count reaches zero.
+  void Wait() const;
+
+  // Blocks until the count reaches zero or `timeout` expires. Returns true if
+  // the count reached zero.
+  bool TimedWait(TimeDelta timeout) const;
+
+  // Same as CountDown(n) followed by Wait().
+  void ArriveAndWait(uint32_t n = 1);
+
+ private:
+  std::atomic<uint32_t> count_;
+};
+
+}  // namespace base
+
+#endif  // BASE_SYNCHRONIZATION_LATCH_H_
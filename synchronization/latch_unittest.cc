@@ -0,0 +1,91 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/latch.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/memory/raw_ref.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Increments a counter, then counts down the latch.
+class CountDownThread : public SimpleThread {
+ public:
+  CountDownThread(Latch& latch, std::atomic<int>& counter)
+      : SimpleThread("CountDownThread"), latch_(latch), counter_(counter) {}
+
+  void Run() override {
+    counter_->fetch_add(1, std::memory_order_relaxed);
+    latch_->CountDown();
+  }
+
+ private:
+  const raw_ref<Latch> latch_;
+  const raw_ref<std::atomic<int>> counter_;
+};
+
+}  // namespace
+
+TEST(LatchTest, ZeroCount) {
+  Latch latch(0);
+  EXPECT_TRUE(latch.IsSignaled());
+  latch.Wait();
+  EXPECT_TRUE(latch.TimedWait(TimeDelta()));
+}
+
+TEST(LatchTest, CountDown) {
+  Latch latch(3);
+  EXPECT_FALSE(latch.IsSignaled());
+  latch.CountDown();
+  EXPECT_FALSE(latch.IsSignaled());
+  latch.CountDown(2);
+  EXPECT_TRUE(latch.IsSignaled());
+  latch.Wait();
+}
+
+TEST(LatchTest, TimedWaitTimesOut) {
+  Latch latch(1);
+  EXPECT_FALSE(latch.TimedWait(Milliseconds(10)));
+  latch.ArriveAndWait();
+  EXPECT_TRUE(latch.TimedWait(Milliseconds(10)));
+}
+
+// The waiting thread sees the writes of all the threads which counted down.
+TEST(LatchTest, WaitForThreads) {
+  constexpr int kNumThreads = 8;
+  Latch latch(kNumThreads);
+  std::atomic<int> counter{0};
+
+  std::vector<std::unique_ptr<CountDownThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(std::make_unique<CountDownThread>(latch, counter));
+    threads.back()->Start();
+  }
+  latch.Wait();
+  EXPECT_EQ(counter.load(std::memory_order_relaxed), kNumThreads);
+
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+}
+
+TEST(LatchTest, ArriveAndWait) {
+  Latch latch(2);
+  std::atomic<int> counter{0};
+  CountDownThread thread(latch, counter);
+  thread.Start();
+  latch.ArriveAndWait();
+  EXPECT_EQ(counter.load(std::memory_order_relaxed), 1);
+  thread.Join();
+}
+
+}  // namespace base
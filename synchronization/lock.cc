@@ -12,10 +12,33 @@
 #include "base/threading/platform_thread.h"
 #endif
 
-#if DCHECK_IS_ON()
-
 namespace base {
 
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+
+void Lock::LockContended(const Location& from_here) {
+  if (!internal::ShouldSampleLockContention()) {
+    lock_.LockInternal();
+    return;
+  }
+  const TimeTicks wait_start = TimeTicks::Now();
+  lock_.LockInternal();
+  contention_sample_ =
+      internal::LockContentionSample{from_here, wait_start, TimeTicks::Now()};
+}
+
+void Lock::UnlockAndRecordContentionSample() {
+  const internal::LockContentionSample sample = *contention_sample_;
+  contention_sample_.reset();
+  const TimeTicks release_time = TimeTicks::Now();
+  lock_.Unlock();
+  internal::RecordLockContention(this, sample, release_time);
+}
+
+#endif  // BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+
+#if DCHECK_IS_ON()
+
 Lock::Lock() : lock_() {
 }
 
@@ -41,6 +64,6 @@ void Lock::CheckUnheldAndMark() {
   owning_thread_ref_ = PlatformThread::CurrentRef();
 }
 
-}  // namespace base
-
 #endif  // DCHECK_IS_ON()
+
+}  // namespace base
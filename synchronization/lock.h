@@ -8,6 +8,7 @@
 #include "base/base_export.h"
 #include "base/dcheck_is_on.h"
 #include "base/synchronization/lock_impl.h"
+#include "base/synchronization/synchronization_buildflags.h"
 #include "base/thread_annotations.h"
 #include "build/build_config.h"
 
@@ -15,6 +16,13 @@
 #include "base/threading/platform_thread_ref.h"
 #endif
 
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+#include <optional>
+
+#include "base/location.h"
+#include "base/synchronization/lock_contention_profiler.h"
+#endif
+
 namespace base {
 
 // A convenient wrapper for an OS specific critical section.  The only real
@@ -31,8 +39,16 @@ class LOCKABLE BASE_EXPORT Lock {
 
   ~Lock() {}
 
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+  void Acquire(const Location& from_here = Location::Current())
+      EXCLUSIVE_LOCK_FUNCTION() {
+    LockAndSampleContention(from_here);
+  }
+  void Release() UNLOCK_FUNCTION() { UnlockAndRecordContention(); }
+#else
   void Acquire() EXCLUSIVE_LOCK_FUNCTION() { lock_.Lock(); }
   void Release() UNLOCK_FUNCTION() { lock_.Unlock(); }
+#endif
 
   // If the lock is not held, take it and return true. If the lock is already
   // held by another thread, immediately return false. This must not be called
@@ -50,6 +66,17 @@ class LOCKABLE BASE_EXPORT Lock {
   // NOTE: We do not permit recursive locks and will commonly fire a DCHECK() if
   // a thread attempts to acquire the lock a second time (while already holding
   // it).
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+  void Acquire(const Location& from_here = Location::Current())
+      EXCLUSIVE_LOCK_FUNCTION() {
+    LockAndSampleContention(from_here);
+    CheckUnheldAndMark();
+  }
+  void Release() UNLOCK_FUNCTION() {
+    CheckHeldAndUnmark();
+    UnlockAndRecordContention();
+  }
+#else
   void Acquire() EXCLUSIVE_LOCK_FUNCTION() {
     lock_.Lock();
     CheckUnheldAndMark();
@@ -58,6 +85,7 @@ class LOCKABLE BASE_EXPORT Lock {
     CheckHeldAndUnmark();
     lock_.Unlock();
   }
+#endif
 
   bool Try() EXCLUSIVE_TRYLOCK_FUNCTION(true) {
     bool rv = lock_.Try();
@@ -94,6 +122,29 @@ class LOCKABLE BASE_EXPORT Lock {
   friend class ConditionVariable;
 
  private:
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+  // Only contended acquisitions are handled out-of-line, see
+  // LockContentionProfiler.
+  void LockAndSampleContention(const Location& from_here) {
+    if (!lock_.Try()) {
+      LockContended(from_here);
+    }
+  }
+  void UnlockAndRecordContention() {
+    if (contention_sample_) {
+      UnlockAndRecordContentionSample();
+    } else {
+      lock_.Unlock();
+    }
+  }
+  void LockContended(const Location& from_here);
+  void UnlockAndRecordContentionSample();
+
+  // Set while the lock is held after a sampled contended acquisition. Only
+  // accessed under lock_.
+  std::optional<internal::LockContentionSample> contention_sample_;
+#endif  // BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+
 #if DCHECK_IS_ON()
   // Members and routines taking care of locks assertions.
   // Note that this checks for recursive locks and allows them
@@ -0,0 +1,225 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/lock_contention_profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "base/auto_reset.h"
+#include "base/hash/hash.h"
+#include "base/trace_event/base_tracing.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
+
+namespace base {
+
+namespace {
+
+// The number of slots probed for a (lock, Location) pair before dropping its
+// samples.
+constexpr size_t kMaxProbes = 16;
+
+std::atomic<uint32_t> g_sampling_interval{
+    LockContentionProfiler::kDefaultSamplingInterval};
+std::atomic<size_t> g_num_dropped_samples{0};
+
+// The number of contended acquisitions on the current thread until the next
+// sampled one.
+ABSL_CONST_INIT thread_local uint32_t g_acquisitions_until_sample = 0;
+
+// Whether a sample is being recorded on the current thread. Contended
+// acquisitions meanwhile, e.g. by tracing, aren't sampled.
+ABSL_CONST_INIT thread_local bool g_is_recording_sample = false;
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+// Identifies the per-thread track on which samples are traced.
+const int g_track_tag = 0;
+#endif
+
+// The aggregated samples of a (lock, Location) pair.
+struct Slot {
+  // A hash of the (lock, Location) pair, or 0 if the slot is free. Set once.
+  std::atomic<size_t> key{0};
+  // Set once `lock_address` and `acquired_from` are written by the thread
+  // which set `key`.
+  std::atomic<bool> ready{false};
+  uintptr_t lock_address = 0;
+  Location acquired_from;
+
+  std::atomic<size_t> num_samples{0};
+  std::atomic<int64_t> total_wait_ns{0};
+  std::atomic<int64_t> max_wait_ns{0};
+  std::atomic<int64_t> total_hold_ns{0};
+  std::atomic<int64_t> max_hold_ns{0};
+};
+
+using Slots = std::array<Slot, LockContentionProfiler::kMaxEntries>;
+
+Slots& GetSlots() {
+  static Slots slots;
+  return slots;
+}
+
+void StoreMax(std::atomic<int64_t>& max, int64_t value) {
+  int64_t current = max.load(std::memory_order_relaxed);
+  while (current < value &&
+         !max.compare_exchange_weak(current, value,
+                                    std::memory_order_relaxed)) {
+  }
+}
+
+// Returns the slot of the (`lock`, `acquired_from`) pair, claiming a free one
+// if needed, or null if none is available.
+Slot* GetSlot(const void* lock, const Location& acquired_from) {
+  const uintptr_t lock_address = reinterpret_cast<uintptr_t>(lock);
+  const size_t key = std::max<size_t>(
+      HashInts(HashInts(lock_address, reinterpret_cast<uintptr_t>(
+                                          acquired_from.program_counter())),
+               HashInts(reinterpret_cast<uintptr_t>(acquired_from.file_name()),
+                        acquired_from.line_number())),
+      1);
+
+  Slots& slots = GetSlots();
+  for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+    Slot& slot = slots[(key + probe) % slots.size()];
+    size_t slot_key = slot.key.load(std::memory_order_relaxed);
+    if (slot_key == 0 &&
+        slot.key.compare_exchange_strong(slot_key, key,
+                                         std::memory_order_relaxed)) {
+      slot.lock_address = lock_address;
+      slot.acquired_from = acquired_from;
+      slot.ready.store(true, std::memory_order_release);
+      return &slot;
+    }
+    if (slot_key == key) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+LockContentionProfiler::Entry::Entry() = default;
+LockContentionProfiler::Entry::Entry(const Entry&) = default;
+LockContentionProfiler::Entry& LockContentionProfiler::Entry::operator=(
+    const Entry&) = default;
+LockContentionProfiler::Entry::~Entry() = default;
+
+// static
+void LockContentionProfiler::SetSamplingInterval(uint32_t sampling_interval) {
+  g_sampling_interval.store(sampling_interval, std::memory_order_relaxed);
+}
+
+// static
+uint32_t LockContentionProfiler::GetSamplingInterval() {
+  return g_sampling_interval.load(std::memory_order_relaxed);
+}
+
+// static
+std::vector<LockContentionProfiler::Entry>
+LockContentionProfiler::GetSnapshot() {
+  std::vector<Entry> entries;
+  for (const Slot& slot : GetSlots()) {
+    if (!slot.ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+    Entry entry;
+    entry.num_samples = slot.num_samples.load(std::memory_order_relaxed);
+    if (entry.num_samples == 0) {
+      continue;
+    }
+    entry.lock_address = slot.lock_address;
+    entry.acquired_from = slot.acquired_from;
+    entry.total_wait_time =
+        Nanoseconds(slot.total_wait_ns.load(std::memory_order_relaxed));
+    entry.max_wait_time =
+        Nanoseconds(slot.max_wait_ns.load(std::memory_order_relaxed));
+    entry.total_hold_time =
+        Nanoseconds(slot.total_hold_ns.load(std::memory_order_relaxed));
+    entry.max_hold_time =
+        Nanoseconds(slot.max_hold_ns.load(std::memory_order_relaxed));
+    entries.push_back(entry);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& lhs, const Entry& rhs) {
+              return lhs.total_wait_time > rhs.total_wait_time;
+            });
+  return entries;
+}
+
+// static
+size_t LockContentionProfiler::GetNumDroppedSamples() {
+  return g_num_dropped_samples.load(std::memory_order_relaxed);
+}
+
+// static
+void LockContentionProfiler::ResetForTesting() {
+  for (Slot& slot : GetSlots()) {
+    slot.ready.store(false, std::memory_order_relaxed);
+    slot.key.store(0, std::memory_order_relaxed);
+    slot.lock_address = 0;
+    slot.acquired_from = Location();
+    slot.num_samples.store(0, std::memory_order_relaxed);
+    slot.total_wait_ns.store(0, std::memory_order_relaxed);
+    slot.max_wait_ns.store(0, std::memory_order_relaxed);
+    slot.total_hold_ns.store(0, std::memory_order_relaxed);
+    slot.max_hold_ns.store(0, std::memory_order_relaxed);
+  }
+  g_num_dropped_samples.store(0, std::memory_order_relaxed);
+}
+
+namespace internal {
+
+bool ShouldSampleLockContention() {
+  if (g_is_recording_sample) {
+    return false;
+  }
+  const uint32_t sampling_interval =
+      g_sampling_interval.load(std::memory_order_relaxed);
+  if (sampling_interval == 0) {
+    return false;
+  }
+  if (g_acquisitions_until_sample == 0) {
+    g_acquisitions_until_sample = sampling_interval;
+  }
+  return --g_acquisitions_until_sample == 0;
+}
+
+void RecordLockContention(const void* lock,
+                          const LockContentionSample& sample,
+                          TimeTicks release_time) {
+  const AutoReset<bool> is_recording_sample(&g_is_recording_sample, true);
+  const int64_t wait_ns =
+      (sample.acquire_time - sample.wait_start).InNanoseconds();
+  const int64_t hold_ns = (release_time - sample.acquire_time).InNanoseconds();
+
+  if (Slot* slot = GetSlot(lock, sample.acquired_from)) {
+    slot->num_samples.fetch_add(1, std::memory_order_relaxed);
+    slot->total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+    StoreMax(slot->max_wait_ns, wait_ns);
+    slot->total_hold_ns.fetch_add(hold_ns, std::memory_order_relaxed);
+    StoreMax(slot->max_hold_ns, hold_ns);
+  } else {
+    g_num_dropped_samples.fetch_add(1, std::memory_order_relaxed);
+  }
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  const auto track = perfetto::Track::FromPointer(
+      &g_track_tag, perfetto::ThreadTrack::Current());
+  TRACE_EVENT_BEGIN(TRACE_DISABLED_BY_DEFAULT("base"), "Lock wait", track,
+                    sample.wait_start, "lock", lock, "acquired_from",
+                    sample.acquired_from);
+  TRACE_EVENT_END(TRACE_DISABLED_BY_DEFAULT("base"), track,
+                  sample.acquire_time);
+  TRACE_EVENT_BEGIN(TRACE_DISABLED_BY_DEFAULT("base"), "Lock held", track,
+                    sample.acquire_time);
+  TRACE_EVENT_END(TRACE_DISABLED_BY_DEFAULT("base"), track, release_time);
+#endif
+}
+
+}  // namespace internal
+
+}  // namespace base
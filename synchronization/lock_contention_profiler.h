@@ -0,0 +1,103 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SYNCHRONIZATION_LOCK_CONTENTION_PROFILER_H_
+#define BASE_SYNCHRONIZATION_LOCK_CONTENTION_PROFILER_H_
+
+#include "base/synchronization/synchronization_buildflags.h"
+
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/location.h"
+#include "base/time/time.h"
+
+namespace base {
+
+// Samples the base::Lock acquisitions that had to wait for another thread to
+// release the lock, when the `enable_lock_contention_profiling` GN arg is set.
+// Uncontended acquisitions, and all acquisitions in builds without the GN arg,
+// aren't instrumented.
+//
+// One contended acquisition out of GetSamplingInterval() on each thread is
+// sampled: its wait time and the time the lock is then held are aggregated
+// lock-free for the (lock, acquiring Location) pair, and reported as
+// "Lock wait" and "Lock held" slices in the disabled-by-default-base tracing
+// category. Use AutoLock, or pass FROM_HERE to Lock::Acquire(), for acquiring
+// Locations to be meaningful.
+class BASE_EXPORT LockContentionProfiler {
+ public:
+  // The aggregated samples of the contended acquisitions of a Lock from a
+  // Location.
+  struct BASE_EXPORT Entry {
+    Entry();
+    Entry(const Entry&);
+    Entry& operator=(const Entry&);
+    ~Entry();
+
+    // The address of the Lock. It may have been destroyed, and its address
+    // reused by another Lock.
+    uintptr_t lock_address = 0;
+    Location acquired_from;
+    size_t num_samples = 0;
+    TimeDelta total_wait_time;
+    TimeDelta max_wait_time;
+    TimeDelta total_hold_time;
+    TimeDelta max_hold_time;
+  };
+
+  // The maximum number of (lock, Location) pairs that are tracked. Samples of
+  // other pairs are dropped.
+  static constexpr size_t kMaxEntries = 1024;
+
+  static constexpr uint32_t kDefaultSamplingInterval = 16;
+
+  LockContentionProfiler() = delete;
+
+  // Sets the number of contended acquisitions per sampled one on each thread.
+  // 0 disables sampling.
+  static void SetSamplingInterval(uint32_t sampling_interval);
+  static uint32_t GetSamplingInterval();
+
+  // Returns the entries with at least one sample, most waited on first. This
+  // can be called from any thread, concurrently with sampling.
+  static std::vector<Entry> GetSnapshot();
+
+  // Returns the number of samples dropped because `kMaxEntries` were tracked.
+  static size_t GetNumDroppedSamples();
+
+  // Drops all the entries. Must not be called concurrently with sampling.
+  static void ResetForTesting();
+};
+
+namespace internal {
+
+// A sampled contended acquisition of a Lock, which is held.
+struct LockContentionSample {
+  Location acquired_from;
+  TimeTicks wait_start;
+  TimeTicks acquire_time;
+};
+
+// Returns whether the contended acquisition about to start on the current
+// thread should be sampled.
+BASE_EXPORT bool ShouldSampleLockContention();
+
+// Records `sample` of `lock`, which was released at `release_time`.
+BASE_EXPORT void RecordLockContention(const void* lock,
+                                      const LockContentionSample& sample,
+                                      TimeTicks release_time);
+
+}  // namespace internal
+
+}  // namespace base
+
+#endif  // BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+
+#endif  // BASE_SYNCHRONIZATION_LOCK_CONTENTION_PROFILER_H_
@@ -0,0 +1,167 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/lock_contention_profiler.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/functional/callback.h"
+#include "base/location.h"
+#include "base/synchronization/lock.h"
+#include "base/test/bind.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class CallbackThread : public PlatformThread::Delegate {
+ public:
+  explicit CallbackThread(OnceClosure callback)
+      : callback_(std::move(callback)) {}
+  CallbackThread(const CallbackThread&) = delete;
+  CallbackThread& operator=(const CallbackThread&) = delete;
+
+  void ThreadMain() override { std::move(callback_).Run(); }
+
+ private:
+  OnceClosure callback_;
+};
+
+size_t GetNumSamples() {
+  size_t num_samples = 0;
+  for (const auto& entry : LockContentionProfiler::GetSnapshot()) {
+    num_samples += entry.num_samples;
+  }
+  return num_samples;
+}
+
+// Runs `acquire` on another thread while the current thread holds `lock`.
+// The acquisition is contended unless it starts more than `hold_time` after
+// the thread.
+void RunWhileLockHeld(Lock& lock, TimeDelta hold_time, OnceClosure acquire) {
+  CallbackThread thread(std::move(acquire));
+  PlatformThreadHandle handle;
+  lock.Acquire();
+  ASSERT_TRUE(PlatformThread::Create(0, &thread, &handle));
+  PlatformThread::Sleep(hold_time);
+  lock.Release();
+  PlatformThread::Join(handle);
+}
+
+// Acquires `lock` from `from_here` on another thread until it's contended, and
+// sampled with a sampling interval of 1.
+void AcquireContended(Lock& lock, const Location& from_here) {
+  const size_t num_samples = GetNumSamples();
+  while (GetNumSamples() == num_samples) {
+    RunWhileLockHeld(lock, Milliseconds(1), BindLambdaForTesting([&] {
+                       lock.Acquire(from_here);
+                       lock.Release();
+                     }));
+  }
+}
+
+class LockContentionProfilerTest : public testing::Test {
+ protected:
+  LockContentionProfilerTest() {
+    LockContentionProfiler::ResetForTesting();
+    LockContentionProfiler::SetSamplingInterval(1);
+  }
+
+  ~LockContentionProfilerTest() override {
+    LockContentionProfiler::SetSamplingInterval(
+        LockContentionProfiler::kDefaultSamplingInterval);
+    LockContentionProfiler::ResetForTesting();
+  }
+};
+
+}  // namespace
+
+TEST_F(LockContentionProfilerTest, UncontendedAcquisitionsAreNotSampled) {
+  Lock lock;
+  for (int i = 0; i < 10; ++i) {
+    lock.Acquire(FROM_HERE);
+    lock.Release();
+  }
+  EXPECT_TRUE(LockContentionProfiler::GetSnapshot().empty());
+}
+
+TEST_F(LockContentionProfilerTest, ContendedAcquisitionIsSampled) {
+  Lock lock;
+  const Location from_here = FROM_HERE;
+  AcquireContended(lock, from_here);
+
+  const std::vector<LockContentionProfiler::Entry> entries =
+      LockContentionProfiler::GetSnapshot();
+  ASSERT_EQ(1u, entries.size());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(&lock), entries[0].lock_address);
+  EXPECT_EQ(from_here, entries[0].acquired_from);
+  EXPECT_EQ(from_here.line_number(), entries[0].acquired_from.line_number());
+  EXPECT_EQ(1u, entries[0].num_samples);
+  EXPECT_GT(entries[0].total_wait_time, TimeDelta());
+  EXPECT_EQ(entries[0].total_wait_time, entries[0].max_wait_time);
+  EXPECT_EQ(entries[0].total_hold_time, entries[0].max_hold_time);
+  EXPECT_EQ(0u, LockContentionProfiler::GetNumDroppedSamples());
+}
+
+TEST_F(LockContentionProfilerTest, SamplesAreAggregatedPerLockAndLocation) {
+  Lock lock;
+  Lock other_lock;
+  const Location from_here = FROM_HERE;
+  const Location other_from_here = FROM_HERE;
+  AcquireContended(lock, from_here);
+  AcquireContended(lock, from_here);
+  AcquireContended(lock, other_from_here);
+  AcquireContended(other_lock, from_here);
+
+  const std::vector<LockContentionProfiler::Entry> entries =
+      LockContentionProfiler::GetSnapshot();
+  ASSERT_EQ(3u, entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (i > 0) {
+      EXPECT_GE(entries[i - 1].total_wait_time, entries[i].total_wait_time);
+    }
+    if (entries[i].lock_address == reinterpret_cast<uintptr_t>(&lock) &&
+        entries[i].acquired_from == from_here) {
+      EXPECT_EQ(2u, entries[i].num_samples);
+    } else {
+      EXPECT_EQ(1u, entries[i].num_samples);
+    }
+  }
+}
+
+TEST_F(LockContentionProfilerTest, SamplingDisabled) {
+  LockContentionProfiler::SetSamplingInterval(0);
+  Lock lock;
+  for (int i = 0; i < 5; ++i) {
+    RunWhileLockHeld(lock, Milliseconds(10), BindLambdaForTesting([&] {
+                       lock.Acquire(FROM_HERE);
+                       lock.Release();
+                     }));
+  }
+  EXPECT_TRUE(LockContentionProfiler::GetSnapshot().empty());
+}
+
+TEST_F(LockContentionProfilerTest, AutoLockLocation) {
+  Lock lock;
+  int line_number = 0;
+  while (GetNumSamples() == 0) {
+    RunWhileLockHeld(lock, Milliseconds(1), BindLambdaForTesting([&] {
+                       // clang-format off
+                       line_number = __LINE__; AutoLock auto_lock(lock);
+                       // clang-format on
+                     }));
+  }
+
+  const std::vector<LockContentionProfiler::Entry> entries =
+      LockContentionProfiler::GetSnapshot();
+  ASSERT_EQ(1u, entries.size());
+  EXPECT_EQ(line_number, entries[0].acquired_from.line_number());
+  EXPECT_STREQ(__FILE__, entries[0].acquired_from.file_name());
+}
+
+}  // namespace base
@@ -10,9 +10,14 @@
 #include "base/dcheck_is_on.h"
 #include "base/memory/raw_ptr_exclusion.h"
 #include "base/memory/stack_allocated.h"
+#include "base/synchronization/synchronization_buildflags.h"
 #include "base/thread_annotations.h"
 #include "build/build_config.h"
 
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+#include "base/location.h"
+#endif
+
 #if BUILDFLAG(IS_WIN)
 #include "base/win/windows_types.h"
 #elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
@@ -134,10 +139,25 @@ class SCOPED_LOCKABLE BasicAutoLock {
  public:
   struct AlreadyAcquired {};
 
+#if BUILDFLAG(ENABLE_LOCK_CONTENTION_PROFILING)
+  // Forwards the acquiring Location to locks which support contention
+  // profiling.
+  explicit BasicAutoLock(LockType& lock,
+                         const Location& from_here = Location::Current())
+      EXCLUSIVE_LOCK_FUNCTION(lock)
+      : lock_(lock) {
+    if constexpr (requires { lock_.Acquire(from_here); }) {
+      lock_.Acquire(from_here);
+    } else {
+      lock_.Acquire();
+    }
+  }
+#else
   explicit BasicAutoLock(LockType& lock) EXCLUSIVE_LOCK_FUNCTION(lock)
       : lock_(lock) {
     lock_.Acquire();
   }
+#endif
 
   BasicAutoLock(LockType& lock, const AlreadyAcquired&)
       EXCLUSIVE_LOCKS_REQUIRED(lock)
@@ -2,9 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <memory>
+#include <vector>
+
 #include "base/compiler_specific.h"
 #include "base/memory/raw_ptr.h"
 #include "base/synchronization/lock.h"
+#include "base/synchronization/rw_lock.h"
+#include "base/synchronization/spinning_lock.h"
 #include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "base/timer/lap_timer.h"
@@ -19,19 +24,26 @@ constexpr TimeDelta kTimeLimit = Seconds(1);
 constexpr int kTimeCheckInterval = 100000;
 
 constexpr char kMetricPrefixLock[] = "Lock.";
+constexpr char kMetricPrefixSpinningLock[] = "SpinningLock.";
+constexpr char kMetricPrefixRWLock[] = "RWLock.";
+constexpr char kMetricPrefixShardedRWLock[] = "ShardedRWLock.";
 constexpr char kMetricLockUnlockThroughput[] = "lock_unlock_throughput";
 constexpr char kStoryBaseline[] = "baseline_story";
 constexpr char kStoryWithCompetingThread[] = "with_competing_thread";
+constexpr char kStoryWithCompetingReaders[] = "with_competing_readers";
+constexpr int kNumCompetingReaders = 3;
 
-perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
-  perf_test::PerfResultReporter reporter(kMetricPrefixLock, story_name);
+perf_test::PerfResultReporter SetUpReporter(const std::string& metric_prefix,
+                                            const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(metric_prefix, story_name);
   reporter.RegisterImportantMetric(kMetricLockUnlockThroughput, "runs/s");
   return reporter;
 }
 
+template <typename LockType>
 class Spin : public PlatformThread::Delegate {
  public:
-  Spin(Lock* lock, uint32_t* data)
+  Spin(LockType* lock, uint32_t* data)
       : lock_(lock), data_(data), should_stop_(false) {}
   ~Spin() override = default;
 
@@ -54,18 +66,60 @@ class Spin : public PlatformThread::Delegate {
   void Stop() { should_stop_ = true; }
 
  private:
-  raw_ptr<Lock> lock_;
+  raw_ptr<LockType> lock_;
   raw_ptr<uint32_t> data_ GUARDED_BY(lock_);
   std::atomic<bool> should_stop_;
 };
 
-}  // namespace
+// The scoped helper which acquires `LockType` for reading.
+template <typename LockType>
+struct ReadLockFor;
 
-TEST(LockPerfTest, Simple) {
+template <>
+struct ReadLockFor<Lock> {
+  using Type = AutoLock;
+};
+
+template <>
+struct ReadLockFor<RWLock> {
+  using Type = AutoReadLock;
+};
+
+template <>
+struct ReadLockFor<ShardedRWLock> {
+  using Type = AutoShardedReadLock;
+};
+
+template <typename LockType>
+class ReadSpin : public PlatformThread::Delegate {
+ public:
+  ReadSpin(LockType* lock, const uint32_t* data)
+      : lock_(lock), data_(data), should_stop_(false) {}
+  ~ReadSpin() override = default;
+
+  void ThreadMain() override {
+    [[maybe_unused]] uint32_t sum = 0;
+    while (!should_stop_.load(std::memory_order_relaxed)) {
+      typename ReadLockFor<LockType>::Type auto_lock(*lock_);
+      sum += *data_;
+    }
+  }
+
+  // Called from another thread to stop the loop.
+  void Stop() { should_stop_ = true; }
+
+ private:
+  raw_ptr<LockType> lock_;
+  raw_ptr<const uint32_t> data_;
+  std::atomic<bool> should_stop_;
+};
+
+template <typename LockType>
+void RunSimple(const std::string& metric_prefix) {
   LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
   [[maybe_unused]] uint32_t data = 0;
 
-  Lock lock;
+  LockType lock;
 
   do {
     lock.Acquire();
@@ -74,18 +128,19 @@ TEST(LockPerfTest, Simple) {
     timer.NextLap();
   } while (!timer.HasTimeLimitExpired());
 
-  auto reporter = SetUpReporter(kStoryBaseline);
+  auto reporter = SetUpReporter(metric_prefix, kStoryBaseline);
   reporter.AddResult(kMetricLockUnlockThroughput, timer.LapsPerSecond());
 }
 
-TEST(LockPerfTest, WithCompetingThread) {
+template <typename LockType>
+void RunWithCompetingThread(const std::string& metric_prefix) {
   LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
   uint32_t data = 0;
 
-  Lock lock;
+  LockType lock;
 
   // Starts a competing thread executing the same loop as this thread.
-  Spin thread_main(&lock, &data);
+  Spin<LockType> thread_main(&lock, &data);
   PlatformThreadHandle thread_handle;
   ASSERT_TRUE(PlatformThread::Create(0, &thread_main, &thread_handle));
 
@@ -99,7 +154,74 @@ TEST(LockPerfTest, WithCompetingThread) {
   thread_main.Stop();
   PlatformThread::Join(thread_handle);
 
-  auto reporter = SetUpReporter(kStoryWithCompetingThread);
+  auto reporter = SetUpReporter(metric_prefix, kStoryWithCompetingThread);
+  reporter.AddResult(kMetricLockUnlockThroughput, timer.LapsPerSecond());
+}
+
+// Measures the read lock throughput of this thread while
+// `kNumCompetingReaders` other threads also acquire the lock for reading.
+template <typename LockType>
+void RunWithCompetingReaders(const std::string& metric_prefix) {
+  LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+  const uint32_t data = 1;
+  [[maybe_unused]] uint32_t sum = 0;
+
+  LockType lock;
+
+  std::vector<std::unique_ptr<ReadSpin<LockType>>> readers;
+  std::vector<PlatformThreadHandle> handles(kNumCompetingReaders);
+  for (PlatformThreadHandle& handle : handles) {
+    readers.push_back(std::make_unique<ReadSpin<LockType>>(&lock, &data));
+    ASSERT_TRUE(PlatformThread::Create(0, readers.back().get(), &handle));
+  }
+
+  do {
+    {
+      typename ReadLockFor<LockType>::Type auto_lock(lock);
+      sum += data;
+    }
+    timer.NextLap();
+  } while (!timer.HasTimeLimitExpired());
+
+  for (auto& reader : readers) {
+    reader->Stop();
+  }
+  for (PlatformThreadHandle& handle : handles) {
+    PlatformThread::Join(handle);
+  }
+
+  auto reporter = SetUpReporter(metric_prefix, kStoryWithCompetingReaders);
   reporter.AddResult(kMetricLockUnlockThroughput, timer.LapsPerSecond());
 }
+
+}  // namespace
+
+TEST(LockPerfTest, Simple) {
+  RunSimple<Lock>(kMetricPrefixLock);
+}
+
+TEST(LockPerfTest, WithCompetingThread) {
+  RunWithCompetingThread<Lock>(kMetricPrefixLock);
+}
+
+TEST(LockPerfTest, WithCompetingReaders) {
+  RunWithCompetingReaders<Lock>(kMetricPrefixLock);
+}
+
+TEST(LockPerfTest, SpinningLockSimple) {
+  RunSimple<SpinningLock>(kMetricPrefixSpinningLock);
+}
+
+TEST(LockPerfTest, SpinningLockWithCompetingThread) {
+  RunWithCompetingThread<SpinningLock>(kMetricPrefixSpinningLock);
+}
+
+TEST(LockPerfTest, RWLockWithCompetingReaders) {
+  RunWithCompetingReaders<RWLock>(kMetricPrefixRWLock);
+}
+
+TEST(LockPerfTest, ShardedRWLockWithCompetingReaders) {
+  RunWithCompetingReaders<ShardedRWLock>(kMetricPrefixShardedRWLock);
+}
+
 }  // namespace base
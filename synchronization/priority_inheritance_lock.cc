@@ -0,0 +1,232 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/priority_inheritance_lock.h"
+
+#include <atomic>
+#include <optional>
+
+#include "base/check_op.h"
+#include "base/synchronization/lock_impl.h"
+#include "build/build_config.h"
+
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace base {
+
+namespace {
+
+std::atomic_bool g_priority_inheritance_futexes_allowed{false};
+
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+// Set when the kernel (or a sandbox) rejects priority inheritance futexes.
+std::atomic_bool g_priority_inheritance_futexes_unsupported{false};
+
+long Futex(std::atomic<uint32_t>* state, int op, uint32_t value) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(state), op, value,
+                 nullptr, nullptr, 0);
+}
+
+// Returns the nice value of |thread_id|, or 0 for the current thread, or
+// nullopt on failure. getpriority() can legitimately return -1.
+std::optional<int> GetNiceValue(uint32_t thread_id) {
+  errno = 0;
+  const int nice_value =
+      getpriority(PRIO_PROCESS, static_cast<id_t>(thread_id));
+  if (nice_value == -1 && errno != 0) {
+    return std::nullopt;
+  }
+  return nice_value;
+}
+
+uint64_t PackBoostedThread(uint32_t thread_id, int nice_value) {
+  return (uint64_t{thread_id} << 32) | static_cast<uint32_t>(nice_value);
+}
+
+uint32_t UnpackThreadId(uint64_t boosted_thread) {
+  return static_cast<uint32_t>(boosted_thread >> 32);
+}
+
+int UnpackNiceValue(uint64_t boosted_thread) {
+  return static_cast<int32_t>(static_cast<uint32_t>(boosted_thread));
+}
+#endif  // BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+
+}  // namespace
+
+PriorityInheritanceLock::PriorityInheritanceLock() = default;
+
+PriorityInheritanceLock::~PriorityInheritanceLock() {
+  AssertNotHeld();
+}
+
+// static
+void PriorityInheritanceLock::AllowPriorityInheritanceFutexes() {
+  g_priority_inheritance_futexes_allowed.store(true,
+                                               std::memory_order_relaxed);
+}
+
+// static
+bool PriorityInheritanceLock::UsesPriorityInheritanceFutexes() {
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+  return (internal::LockImpl::PriorityInheritanceAvailable() ||
+          g_priority_inheritance_futexes_allowed.load(
+              std::memory_order_relaxed)) &&
+         !g_priority_inheritance_futexes_unsupported.load(
+             std::memory_order_relaxed);
+#else
+  return false;
+#endif
+}
+
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+
+void PriorityInheritanceLock::AssertAcquired() const {
+  DCHECK_EQ(state_.load(std::memory_order_relaxed) & kThreadIdMask,
+            CurrentThreadState());
+}
+
+void PriorityInheritanceLock::AssertNotHeld() const {
+  DCHECK_EQ(state_.load(std::memory_order_relaxed), kUnlocked);
+}
+
+void PriorityInheritanceLock::AcquireContended() {
+  DCHECK_NE(state_.load(std::memory_order_relaxed) & kThreadIdMask,
+            CurrentThreadState())
+      << "Recursive acquisition of a PriorityInheritanceLock";
+
+  if (UsesPriorityInheritanceFutexes()) {
+    while (true) {
+      if (Futex(&state_, FUTEX_LOCK_PI_PRIVATE, 0) == 0) {
+        return;
+      }
+      // EAGAIN means that the holder is exiting.
+      if (errno != EINTR && errno != EAGAIN) {
+        break;
+      }
+    }
+    // Priority inheritance futexes are then rejected for all threads, so no
+    // thread waits for the lock in the kernel and it is safe to fall back.
+    PCHECK(errno == ENOSYS || errno == EPERM);
+    g_priority_inheritance_futexes_unsupported.store(true,
+                                                     std::memory_order_relaxed);
+  }
+  AcquireWithBoosting();
+}
+
+void PriorityInheritanceLock::ReleaseContended() {
+  DCHECK_EQ(state_.load(std::memory_order_relaxed) & kThreadIdMask,
+            CurrentThreadState());
+
+  // FUTEX_UNLOCK_PI hands the lock off to the highest priority waiter. If it
+  // fails, no thread waits in the kernel.
+  if (!UsesPriorityInheritanceFutexes() ||
+      Futex(&state_, FUTEX_UNLOCK_PI_PRIVATE, 0) != 0) {
+    state_.store(kUnlocked, std::memory_order_release);
+    Futex(&state_, FUTEX_WAKE_PRIVATE, 1);
+  }
+
+  // Restored after releasing the lock: a waiter that boosts the current
+  // thread while this runs then sees that the lock was released, and restores
+  // the nice value itself.
+  if (boosted_thread_.load(std::memory_order_relaxed) != kNoBoostedThread) {
+    RestoreBoostedThread();
+  }
+}
+
+void PriorityInheritanceLock::AcquireWithBoosting() {
+  const uint32_t current_thread_state = CurrentThreadState();
+  uint32_t state = state_.load(std::memory_order_relaxed);
+  while (true) {
+    if (state == kUnlocked || state == kHasWaitersBit) {
+      // Other threads may still sleep, so keep |kHasWaitersBit| set to wake
+      // them up on Release().
+      if (state_.compare_exchange_weak(state,
+                                       current_thread_state | kHasWaitersBit,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return;
+      }
+      continue;
+    }
+    if (!(state & kHasWaitersBit)) {
+      if (!state_.compare_exchange_weak(state, state | kHasWaitersBit,
+                                        std::memory_order_relaxed,
+                                        std::memory_order_relaxed)) {
+        continue;
+      }
+      state |= kHasWaitersBit;
+    }
+    // The holder now releases the lock through ReleaseContended(), which
+    // restores its nice value.
+    BoostHolder(state);
+    Futex(&state_, FUTEX_WAIT_PRIVATE, state);
+    state = state_.load(std::memory_order_relaxed);
+  }
+}
+
+void PriorityInheritanceLock::BoostHolder(uint32_t state) {
+  const uint32_t holder = state & kThreadIdMask;
+  const std::optional<int> nice_value = GetNiceValue(0);
+  const std::optional<int> holder_nice_value = GetNiceValue(holder);
+  if (!nice_value || !holder_nice_value ||
+      *nice_value >= *holder_nice_value) {
+    return;
+  }
+
+  // Only the original nice value of the holder is recorded; a higher priority
+  // waiter still raises it further.
+  uint64_t boosted_thread = kNoBoostedThread;
+  if (!boosted_thread_.compare_exchange_strong(
+          boosted_thread, PackBoostedThread(holder, *holder_nice_value),
+          std::memory_order_relaxed, std::memory_order_relaxed) &&
+      UnpackThreadId(boosted_thread) != holder) {
+    // A thread which held the lock earlier is still being restored.
+    return;
+  }
+  const int original_nice_value = boosted_thread == kNoBoostedThread
+                                      ? *holder_nice_value
+                                      : UnpackNiceValue(boosted_thread);
+  if (setpriority(PRIO_PROCESS, static_cast<id_t>(holder), *nice_value) != 0) {
+    // Raising the priority of another thread requires privileges.
+    if (boosted_thread == kNoBoostedThread) {
+      boosted_thread = PackBoostedThread(holder, original_nice_value);
+      boosted_thread_.compare_exchange_strong(boosted_thread, kNoBoostedThread,
+                                              std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  // If the holder released the lock in the meantime, it may have restored its
+  // nice value before it was raised above; restore it again.
+  if ((state_.load(std::memory_order_relaxed) & kThreadIdMask) != holder) {
+    boosted_thread = PackBoostedThread(holder, original_nice_value);
+    boosted_thread_.compare_exchange_strong(boosted_thread, kNoBoostedThread,
+                                            std::memory_order_relaxed);
+    setpriority(PRIO_PROCESS, static_cast<id_t>(holder), original_nice_value);
+  }
+}
+
+void PriorityInheritanceLock::RestoreBoostedThread() {
+  const uint64_t boosted_thread =
+      boosted_thread_.exchange(kNoBoostedThread, std::memory_order_relaxed);
+  if (boosted_thread == kNoBoostedThread) {
+    return;
+  }
+  const uint32_t thread_id = UnpackThreadId(boosted_thread);
+  setpriority(PRIO_PROCESS,
+              static_cast<id_t>(thread_id == CurrentThreadState() ? 0
+                                                                  : thread_id),
+              UnpackNiceValue(boosted_thread));
+}
+
+#endif  // BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+
+}  // namespace base
@@ -0,0 +1,157 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SYNCHRONIZATION_PRIORITY_INHERITANCE_LOCK_H_
+#define BASE_SYNCHRONIZATION_PRIORITY_INHERITANCE_LOCK_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/synchronization/lock_impl.h"
+#include "base/thread_annotations.h"
+#include "base/threading/platform_thread.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#define BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX() 1
+#else
+#define BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX() 0
+#include "base/synchronization/lock.h"
+#endif
+
+namespace base {
+
+// A lock for critical sections shared by threads of different priorities,
+// e.g. a lock taken both by the UI thread and by BEST_EFFORT ThreadPool
+// workers. It mitigates priority inversion, i.e. a high priority thread
+// waiting on a low priority holder that doesn't get scheduled:
+//
+// - On Linux, ChromeOS and Android, it is a priority inheritance futex
+//   (FUTEX_LOCK_PI) if the process allows them (see
+//   AllowPriorityInheritanceFutexes()): the kernel runs the holder at the
+//   priority of its highest priority waiter. Otherwise, or if the kernel
+//   doesn't support them, a waiter raises the nice value of the holder to its
+//   own before sleeping, and the holder restores its nice value on Release().
+//   Raising the priority of another thread can fail without CAP_SYS_NICE or
+//   a sufficient RLIMIT_NICE, in which case there is no mitigation.
+// - Elsewhere, it is a Lock, and has the same priority inversion mitigations
+//   as Lock (see Lock::HandlesMultipleThreadPriorities()).
+//
+// Uncontended acquisitions and releases are a single atomic operation. Unlike
+// Lock, it can't be used with a ConditionVariable.
+class LOCKABLE BASE_EXPORT PriorityInheritanceLock {
+ public:
+  PriorityInheritanceLock();
+  PriorityInheritanceLock(const PriorityInheritanceLock&) = delete;
+  PriorityInheritanceLock& operator=(const PriorityInheritanceLock&) = delete;
+  ~PriorityInheritanceLock();
+
+  // Allows priority inheritance futexes to be used by all
+  // PriorityInheritanceLocks of the process, from now on. They are allowed by
+  // default only if Lock uses priority inheritance, because some sandboxes
+  // (e.g. Chrome's seccomp-bpf policies) kill processes which use them. Call
+  // this early, from processes that aren't sandboxed.
+  static void AllowPriorityInheritanceFutexes();
+
+  // Returns true if PriorityInheritanceLocks use priority inheritance futexes.
+  static bool UsesPriorityInheritanceFutexes();
+
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+  // NOTE: Recursive locks are not permitted, and will fire a DCHECK() if a
+  // thread attempts to acquire the lock a second time while holding it.
+  void Acquire() EXCLUSIVE_LOCK_FUNCTION() {
+    uint32_t expected = kUnlocked;
+    if (!state_.compare_exchange_strong(expected, CurrentThreadState(),
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+      AcquireContended();
+    }
+  }
+
+  void Release() UNLOCK_FUNCTION() {
+    uint32_t expected = CurrentThreadState();
+    if (!state_.compare_exchange_strong(expected, kUnlocked,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+      ReleaseContended();
+    }
+  }
+
+  // If the lock is not held, take it and return true. If the lock is already
+  // held by another thread, immediately return false. This must not be called
+  // by a thread already holding the lock.
+  bool Try() EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+    uint32_t expected = kUnlocked;
+    return state_.compare_exchange_strong(expected, CurrentThreadState(),
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  void AssertAcquired() const ASSERT_EXCLUSIVE_LOCK();
+  void AssertNotHeld() const;
+#else
+  void Acquire() EXCLUSIVE_LOCK_FUNCTION() { lock_.Acquire(); }
+  void Release() UNLOCK_FUNCTION() { lock_.Release(); }
+  bool Try() EXCLUSIVE_TRYLOCK_FUNCTION(true) { return lock_.Try(); }
+  void AssertAcquired() const ASSERT_EXCLUSIVE_LOCK() {
+    lock_.AssertAcquired();
+  }
+  void AssertNotHeld() const { lock_.AssertNotHeld(); }
+#endif  // BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+
+ private:
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+  // The state is the thread id of the holder, or kUnlocked, with
+  // kHasWaitersBit set when a thread may be waiting. This is the layout of
+  // priority inheritance futexes, shared by both the futex and the boosting
+  // implementations.
+  static constexpr uint32_t kUnlocked = 0;
+  static constexpr uint32_t kHasWaitersBit = 0x80000000;  // FUTEX_WAITERS.
+  static constexpr uint32_t kThreadIdMask = 0x3fffffff;    // FUTEX_TID_MASK.
+
+  // A thread whose nice value was raised by a waiter, with its own nice value.
+  // Packed in a single word, so that it is claimed atomically by whoever
+  // restores the nice value.
+  static constexpr uint64_t kNoBoostedThread = 0;
+
+  static uint32_t CurrentThreadState() {
+    return static_cast<uint32_t>(PlatformThread::CurrentId());
+  }
+
+  void AcquireContended();
+  void ReleaseContended();
+
+  // Acquires the lock without priority inheritance futexes.
+  void AcquireWithBoosting();
+
+  // Raises the nice value of the thread holding the lock, as of |state|, to
+  // that of the current thread if it is higher.
+  void BoostHolder(uint32_t state);
+
+  // Restores the nice value of the thread recorded in |boosted_thread_|, if
+  // any.
+  void RestoreBoostedThread();
+
+  std::atomic<uint32_t> state_{kUnlocked};
+  std::atomic<uint64_t> boosted_thread_{kNoBoostedThread};
+#else
+  Lock lock_;
+#endif  // BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+};
+
+// A helper class that acquires the given PriorityInheritanceLock while the
+// AutoPriorityInheritanceLock is in scope.
+using AutoPriorityInheritanceLock =
+    internal::BasicAutoLock<PriorityInheritanceLock>;
+
+// A helper class that tries to acquire the given PriorityInheritanceLock while
+// the AutoTryPriorityInheritanceLock is in scope.
+using AutoTryPriorityInheritanceLock =
+    internal::BasicAutoTryLock<PriorityInheritanceLock>;
+
+}  // namespace base
+
+#endif  // BASE_SYNCHRONIZATION_PRIORITY_INHERITANCE_LOCK_H_
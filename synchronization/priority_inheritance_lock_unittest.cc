@@ -0,0 +1,245 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/priority_inheritance_lock.h"
+
+#include "base/memory/raw_ptr.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/gtest_util.h"
+#include "base/test/test_timeouts.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+#include <sys/resource.h>
+#endif
+
+namespace base {
+
+namespace {
+
+class PriorityInheritanceLockTestThread : public PlatformThread::Delegate {
+ public:
+  PriorityInheritanceLockTestThread(PriorityInheritanceLock* lock, int* value)
+      : lock_(lock), value_(value) {}
+
+  PriorityInheritanceLockTestThread(const PriorityInheritanceLockTestThread&) =
+      delete;
+  PriorityInheritanceLockTestThread& operator=(
+      const PriorityInheritanceLockTestThread&) = delete;
+
+  // Static helper which can also be called from the main thread.
+  static void DoStuff(PriorityInheritanceLock* lock, int* value) {
+    for (int i = 0; i < 10000; i++) {
+      AutoPriorityInheritanceLock auto_lock(*lock);
+      int v = *value;
+      *value = v + 1;
+    }
+  }
+
+  void ThreadMain() override { DoStuff(lock_, value_); }
+
+ private:
+  raw_ptr<PriorityInheritanceLock> lock_;
+  raw_ptr<int> value_;
+};
+
+class TryLockTestThread : public PlatformThread::Delegate {
+ public:
+  explicit TryLockTestThread(PriorityInheritanceLock* lock) : lock_(lock) {}
+
+  TryLockTestThread(const TryLockTestThread&) = delete;
+  TryLockTestThread& operator=(const TryLockTestThread&) = delete;
+
+  void ThreadMain() override {
+    got_lock_ = lock_->Try();
+    if (got_lock_) {
+      lock_->Release();
+    }
+  }
+
+  bool got_lock() const { return got_lock_; }
+
+ private:
+  raw_ptr<PriorityInheritanceLock> lock_;
+  bool got_lock_ = false;
+};
+
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+// Holds the lock until its nice value is raised to |waiter_nice_value|, or for
+// up to TestTimeouts::action_timeout().
+class BoostedHolderThread : public PlatformThread::Delegate {
+ public:
+  BoostedHolderThread(PriorityInheritanceLock* lock, int waiter_nice_value)
+      : lock_(lock), waiter_nice_value_(waiter_nice_value) {}
+
+  BoostedHolderThread(const BoostedHolderThread&) = delete;
+  BoostedHolderThread& operator=(const BoostedHolderThread&) = delete;
+
+  void ThreadMain() override {
+    lock_->Acquire();
+    nice_value_ = getpriority(PRIO_PROCESS, 0);
+    // A waiter can raise the nice value of this thread only if this thread
+    // could raise it itself.
+    can_be_boosted_ = nice_value_ > waiter_nice_value_ &&
+                      setpriority(PRIO_PROCESS, 0, waiter_nice_value_) == 0 &&
+                      setpriority(PRIO_PROCESS, 0, nice_value_) == 0;
+    acquired_.Signal();
+
+    if (can_be_boosted_) {
+      const TimeTicks deadline =
+          TimeTicks::Now() + TestTimeouts::action_timeout();
+      while (getpriority(PRIO_PROCESS, 0) > waiter_nice_value_ &&
+             TimeTicks::Now() < deadline) {
+        PlatformThread::Sleep(Milliseconds(1));
+      }
+    }
+    boosted_nice_value_ = getpriority(PRIO_PROCESS, 0);
+    lock_->Release();
+    restored_nice_value_ = getpriority(PRIO_PROCESS, 0);
+  }
+
+  void WaitUntilAcquired() { acquired_.Wait(); }
+
+  bool can_be_boosted() const { return can_be_boosted_; }
+  int nice_value() const { return nice_value_; }
+  int boosted_nice_value() const { return boosted_nice_value_; }
+  int restored_nice_value() const { return restored_nice_value_; }
+
+ private:
+  raw_ptr<PriorityInheritanceLock> lock_;
+  const int waiter_nice_value_;
+  WaitableEvent acquired_;
+  bool can_be_boosted_ = false;
+  int nice_value_ = 0;
+  int boosted_nice_value_ = 0;
+  int restored_nice_value_ = 0;
+};
+#endif  // BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+
+}  // namespace
+
+TEST(PriorityInheritanceLockTest, TryLock) {
+  PriorityInheritanceLock lock;
+
+  ASSERT_TRUE(lock.Try());
+  lock.AssertAcquired();
+
+  // This thread will not be able to get the lock.
+  {
+    TryLockTestThread thread(&lock);
+    PlatformThreadHandle handle;
+    ASSERT_TRUE(PlatformThread::Create(0, &thread, &handle));
+    PlatformThread::Join(handle);
+    EXPECT_FALSE(thread.got_lock());
+  }
+
+  lock.Release();
+
+  // This thread will.
+  {
+    TryLockTestThread thread(&lock);
+    PlatformThreadHandle handle;
+    ASSERT_TRUE(PlatformThread::Create(0, &thread, &handle));
+    PlatformThread::Join(handle);
+    EXPECT_TRUE(thread.got_lock());
+  }
+
+  lock.AssertNotHeld();
+}
+
+TEST(PriorityInheritanceLockTest, MutexFourThreads) {
+  PriorityInheritanceLock lock;
+  int value = 0;
+
+  PriorityInheritanceLockTestThread thread1(&lock, &value);
+  PriorityInheritanceLockTestThread thread2(&lock, &value);
+  PriorityInheritanceLockTestThread thread3(&lock, &value);
+  PlatformThreadHandle handle1;
+  PlatformThreadHandle handle2;
+  PlatformThreadHandle handle3;
+
+  ASSERT_TRUE(PlatformThread::Create(0, &thread1, &handle1));
+  ASSERT_TRUE(PlatformThread::Create(0, &thread2, &handle2));
+  ASSERT_TRUE(PlatformThread::Create(0, &thread3, &handle3));
+
+  PriorityInheritanceLockTestThread::DoStuff(&lock, &value);
+
+  PlatformThread::Join(handle1);
+  PlatformThread::Join(handle2);
+  PlatformThread::Join(handle3);
+
+  EXPECT_EQ(4 * 10000, value);
+}
+
+#if BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+// A waiter raises the nice value of a lower priority holder until it releases
+// the lock.
+TEST(PriorityInheritanceLockTest, WaiterBoostsHolder) {
+  // Priority inheritance futexes boost the holder without changing its nice
+  // value.
+  if (PriorityInheritanceLock::UsesPriorityInheritanceFutexes()) {
+    GTEST_SKIP() << "Priority inheritance futexes are used";
+  }
+
+  PriorityInheritanceLock lock;
+  BoostedHolderThread thread(&lock, getpriority(PRIO_PROCESS, 0));
+  PlatformThreadHandle handle;
+  ASSERT_TRUE(PlatformThread::CreateWithType(0, &thread, &handle,
+                                             ThreadType::kBackground));
+  thread.WaitUntilAcquired();
+  lock.Acquire();
+  lock.Release();
+  PlatformThread::Join(handle);
+
+  if (!thread.can_be_boosted()) {
+    GTEST_SKIP() << "Raising the priority of a thread requires privileges";
+  }
+  EXPECT_EQ(getpriority(PRIO_PROCESS, 0), thread.boosted_nice_value());
+  EXPECT_EQ(thread.nice_value(), thread.restored_nice_value());
+}
+#endif  // BASE_PRIORITY_INHERITANCE_LOCK_USES_FUTEX()
+
+TEST(PriorityInheritanceLockTest, MutexFourThreadsWithPriorityInheritance) {
+  // Falls back to boosting if priority inheritance futexes aren't supported.
+  PriorityInheritanceLock::AllowPriorityInheritanceFutexes();
+
+  PriorityInheritanceLock lock;
+  int value = 0;
+
+  PriorityInheritanceLockTestThread thread1(&lock, &value);
+  PriorityInheritanceLockTestThread thread2(&lock, &value);
+  PriorityInheritanceLockTestThread thread3(&lock, &value);
+  PlatformThreadHandle handle1;
+  PlatformThreadHandle handle2;
+  PlatformThreadHandle handle3;
+
+  ASSERT_TRUE(PlatformThread::CreateWithType(0, &thread1, &handle1,
+                                             ThreadType::kBackground));
+  ASSERT_TRUE(PlatformThread::Create(0, &thread2, &handle2));
+  ASSERT_TRUE(PlatformThread::CreateWithType(0, &thread3, &handle3,
+                                             ThreadType::kBackground));
+
+  PriorityInheritanceLockTestThread::DoStuff(&lock, &value);
+
+  PlatformThread::Join(handle1);
+  PlatformThread::Join(handle2);
+  PlatformThread::Join(handle3);
+
+  EXPECT_EQ(4 * 10000, value);
+  lock.AssertNotHeld();
+}
+
+TEST(PriorityInheritanceLockTest, AutoTryPriorityInheritanceLock) {
+  PriorityInheritanceLock lock;
+  {
+    AutoTryPriorityInheritanceLock auto_try_lock(lock);
+    ASSERT_TRUE(auto_try_lock.is_acquired());
+    lock.AssertAcquired();
+  }
+  EXPECT_DCHECK_DEATH(lock.AssertAcquired());
+}
+
+}  // namespace base
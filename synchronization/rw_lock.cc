@@ -0,0 +1,75 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/rw_lock.h"
+
+#include "base/check_op.h"
+#include "base/threading/platform_thread.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <sched.h>
+#endif
+
+namespace base {
+
+#if DCHECK_IS_ON()
+void RWLock::AssertWriteAcquired() const {
+  DCHECK_EQ(writer_thread_ref_, PlatformThread::CurrentRef());
+}
+
+void RWLock::CheckWriteHeldAndUnmark() {
+  DCHECK_EQ(writer_thread_ref_, PlatformThread::CurrentRef());
+  writer_thread_ref_ = PlatformThreadRef();
+}
+
+void RWLock::CheckWriteUnheldAndMark() {
+  DCHECK(writer_thread_ref_.is_null());
+  writer_thread_ref_ = PlatformThread::CurrentRef();
+}
+#endif  // DCHECK_IS_ON()
+
+ShardedRWLock::ShardedRWLock() = default;
+
+ShardedRWLock::~ShardedRWLock() = default;
+
+size_t ShardedRWLock::ReadAcquire() NO_THREAD_SAFETY_ANALYSIS {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // sched_getcpu() is implemented in the vDSO, so it doesn't make a system
+  // call.
+  const int cpu = sched_getcpu();
+  const size_t shard =
+      cpu >= 0 ? static_cast<size_t>(cpu) % kNumShards
+               : static_cast<size_t>(PlatformThread::CurrentId()) % kNumShards;
+#else
+  const size_t shard =
+      static_cast<size_t>(PlatformThread::CurrentId()) % kNumShards;
+#endif
+  shards_[shard].lock.ReadAcquire();
+  return shard;
+}
+
+void ShardedRWLock::ReadRelease(size_t shard) NO_THREAD_SAFETY_ANALYSIS {
+  shards_[shard].lock.ReadRelease();
+}
+
+void ShardedRWLock::WriteAcquire() NO_THREAD_SAFETY_ANALYSIS {
+  // Always acquire the shards in the same order, so that concurrent writers
+  // can't deadlock.
+  for (Shard& shard : shards_) {
+    shard.lock.WriteAcquire();
+  }
+}
+
+void ShardedRWLock::WriteRelease() NO_THREAD_SAFETY_ANALYSIS {
+  for (Shard& shard : shards_) {
+    shard.lock.WriteRelease();
+  }
+}
+
+void ShardedRWLock::AssertWriteAcquired() const {
+  shards_[0].lock.AssertWriteAcquired();
+}
+
+}  // namespace base
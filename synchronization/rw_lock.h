@@ -0,0 +1,187 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SYNCHRONIZATION_RW_LOCK_H_
+#define BASE_SYNCHRONIZATION_RW_LOCK_H_
+
+#include <stddef.h>
+
+#include <array>
+
+#include "base/base_export.h"
+#include "base/dcheck_is_on.h"
+#include "base/memory/raw_ref.h"
+#include "base/thread_annotations.h"
+#include "build/build_config.h"
+
+#if BUILDFLAG(IS_WIN)
+#include "base/win/windows_types.h"
+#elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+#include <pthread.h>
+#endif
+
+#if DCHECK_IS_ON()
+#include "base/threading/platform_thread_ref.h"
+#endif
+
+namespace base {
+
+// A reader-writer lock: any number of readers can hold it at once, or a single
+// writer. Use it for read-mostly data whose readers would otherwise serialize
+// on a Lock; for data that is written about as often as it's read, Lock is
+// cheaper.
+//
+// Writers are preferred: once a writer waits, new readers wait for it, so
+// that a steady stream of readers can't starve writers. As a consequence, a
+// thread must not acquire the read lock recursively, since a writer waiting
+// in between would deadlock it. The lock is not recursive for writers either.
+class LOCKABLE BASE_EXPORT RWLock {
+ public:
+  RWLock();
+  RWLock(const RWLock&) = delete;
+  RWLock& operator=(const RWLock&) = delete;
+  ~RWLock();
+
+  void ReadAcquire() SHARED_LOCK_FUNCTION();
+  void ReadRelease() UNLOCK_FUNCTION();
+
+  // If the lock can be acquired for reading without waiting, acquire it and
+  // return true. Otherwise, immediately return false.
+  bool TryReadAcquire() SHARED_TRYLOCK_FUNCTION(true);
+
+  void WriteAcquire() EXCLUSIVE_LOCK_FUNCTION();
+  void WriteRelease() UNLOCK_FUNCTION();
+
+  // If the lock is not held, acquire it for writing and return true.
+  // Otherwise, immediately return false.
+  bool TryWriteAcquire() EXCLUSIVE_TRYLOCK_FUNCTION(true);
+
+#if DCHECK_IS_ON()
+  void AssertWriteAcquired() const ASSERT_EXCLUSIVE_LOCK();
+#else
+  void AssertWriteAcquired() const ASSERT_EXCLUSIVE_LOCK() {}
+#endif
+
+ private:
+#if BUILDFLAG(IS_WIN)
+  using NativeHandle = CHROME_SRWLOCK;
+#elif BUILDFLAG(IS_POSIX) || BUILDFLAG(IS_FUCHSIA)
+  using NativeHandle = pthread_rwlock_t;
+#endif
+
+#if DCHECK_IS_ON()
+  void CheckWriteHeldAndUnmark();
+  void CheckWriteUnheldAndMark();
+
+  // The thread holding the write lock, if any. Only accessed while the write
+  // lock is held.
+  base::PlatformThreadRef writer_thread_ref_;
+#endif  // DCHECK_IS_ON()
+
+  NativeHandle native_handle_;
+};
+
+// A reader-writer lock made of one RWLock per shard, where readers only
+// acquire the shard of the CPU they run on (or of their thread, on platforms
+// which can't tell), and writers acquire all shards. Readers on different CPUs
+// therefore don't contend for a cache line, which makes read acquisitions
+// nearly contention-free, at the cost of much more expensive writes and of
+// ~1 KiB of memory. Only use this for data which is very rarely written and
+// very frequently read from many threads.
+//
+// ReadAcquire() returns the shard which must be passed to ReadRelease(), since
+// the thread may have migrated in between. Prefer AutoShardedReadLock.
+class LOCKABLE BASE_EXPORT ShardedRWLock {
+ public:
+  static constexpr size_t kNumShards = 16;
+
+  ShardedRWLock();
+  ShardedRWLock(const ShardedRWLock&) = delete;
+  ShardedRWLock& operator=(const ShardedRWLock&) = delete;
+  ~ShardedRWLock();
+
+  size_t ReadAcquire() SHARED_LOCK_FUNCTION();
+  void ReadRelease(size_t shard) UNLOCK_FUNCTION();
+
+  void WriteAcquire() EXCLUSIVE_LOCK_FUNCTION();
+  void WriteRelease() UNLOCK_FUNCTION();
+
+  void AssertWriteAcquired() const ASSERT_EXCLUSIVE_LOCK();
+
+ private:
+  // Each shard is on its own cache line.
+  struct alignas(64) Shard {
+    RWLock lock;
+  };
+
+  std::array<Shard, kNumShards> shards_;
+};
+
+// A helper class that acquires the given RWLock for reading while the
+// AutoReadLock is in scope.
+class SCOPED_LOCKABLE AutoReadLock {
+ public:
+  explicit AutoReadLock(RWLock& lock) SHARED_LOCK_FUNCTION(lock)
+      : lock_(lock) {
+    lock_->ReadAcquire();
+  }
+  AutoReadLock(const AutoReadLock&) = delete;
+  AutoReadLock& operator=(const AutoReadLock&) = delete;
+  ~AutoReadLock() UNLOCK_FUNCTION() { lock_->ReadRelease(); }
+
+ private:
+  const raw_ref<RWLock> lock_;
+};
+
+// A helper class that acquires the given RWLock for writing while the
+// AutoWriteLock is in scope.
+class SCOPED_LOCKABLE AutoWriteLock {
+ public:
+  explicit AutoWriteLock(RWLock& lock) EXCLUSIVE_LOCK_FUNCTION(lock)
+      : lock_(lock) {
+    lock_->WriteAcquire();
+  }
+  AutoWriteLock(const AutoWriteLock&) = delete;
+  AutoWriteLock& operator=(const AutoWriteLock&) = delete;
+  ~AutoWriteLock() UNLOCK_FUNCTION() { lock_->WriteRelease(); }
+
+ private:
+  const raw_ref<RWLock> lock_;
+};
+
+// A helper class that acquires the given ShardedRWLock for reading while the
+// AutoShardedReadLock is in scope.
+class SCOPED_LOCKABLE AutoShardedReadLock {
+ public:
+  explicit AutoShardedReadLock(ShardedRWLock& lock) SHARED_LOCK_FUNCTION(lock)
+      : lock_(lock), shard_(lock_->ReadAcquire()) {}
+  AutoShardedReadLock(const AutoShardedReadLock&) = delete;
+  AutoShardedReadLock& operator=(const AutoShardedReadLock&) = delete;
+  ~AutoShardedReadLock() UNLOCK_FUNCTION() { lock_->ReadRelease(shard_); }
+
+ private:
+  const raw_ref<ShardedRWLock> lock_;
+  const size_t shard_;
+};
+
+// A helper class that acquires the given ShardedRWLock for writing while the
+// AutoShardedWriteLock is in scope.
+class SCOPED_LOCKABLE AutoShardedWriteLock {
+ public:
+  explicit AutoShardedWriteLock(ShardedRWLock& lock)
+      EXCLUSIVE_LOCK_FUNCTION(lock)
+      : lock_(lock) {
+    lock_->WriteAcquire();
+  }
+  AutoShardedWriteLock(const AutoShardedWriteLock&) = delete;
+  AutoShardedWriteLock& operator=(const AutoShardedWriteLock&) = delete;
+  ~AutoShardedWriteLock() UNLOCK_FUNCTION() { lock_->WriteRelease(); }
+
+ private:
+  const raw_ref<ShardedRWLock> lock_;
+};
+
+}  // namespace base
+
+#endif  // BASE_SYNCHRONIZATION_RW_LOCK_H_
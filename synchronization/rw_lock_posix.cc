@@ -0,0 +1,80 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/rw_lock.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "base/check_op.h"
+#include "build/build_config.h"
+
+namespace base {
+
+RWLock::RWLock() {
+  pthread_rwlockattr_t attr;
+  int rv = pthread_rwlockattr_init(&attr);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+#if defined(__GLIBC__) || BUILDFLAG(IS_ANDROID)
+  // glibc and Bionic prefer readers by default. Other implementations, such as
+  // Apple's, already prefer writers.
+  rv = pthread_rwlockattr_setkind_np(
+      &attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+#endif
+  rv = pthread_rwlock_init(&native_handle_, &attr);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+  rv = pthread_rwlockattr_destroy(&attr);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+RWLock::~RWLock() {
+  [[maybe_unused]] int rv = pthread_rwlock_destroy(&native_handle_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+void RWLock::ReadAcquire() {
+  [[maybe_unused]] int rv = pthread_rwlock_rdlock(&native_handle_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+void RWLock::ReadRelease() {
+  [[maybe_unused]] int rv = pthread_rwlock_unlock(&native_handle_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+bool RWLock::TryReadAcquire() {
+  int rv = pthread_rwlock_tryrdlock(&native_handle_);
+  DCHECK(rv == 0 || rv == EBUSY) << ". " << strerror(rv);
+  return rv == 0;
+}
+
+void RWLock::WriteAcquire() {
+  [[maybe_unused]] int rv = pthread_rwlock_wrlock(&native_handle_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+#if DCHECK_IS_ON()
+  CheckWriteUnheldAndMark();
+#endif
+}
+
+void RWLock::WriteRelease() {
+#if DCHECK_IS_ON()
+  CheckWriteHeldAndUnmark();
+#endif
+  [[maybe_unused]] int rv = pthread_rwlock_unlock(&native_handle_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+bool RWLock::TryWriteAcquire() {
+  int rv = pthread_rwlock_trywrlock(&native_handle_);
+  DCHECK(rv == 0 || rv == EBUSY) << ". " << strerror(rv);
+#if DCHECK_IS_ON()
+  if (rv == 0) {
+    CheckWriteUnheldAndMark();
+  }
+#endif
+  return rv == 0;
+}
+
+}  // namespace base
@@ -0,0 +1,180 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/rw_lock.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
+#include "base/test/bind.h"
+#include "base/test/gtest_util.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class CallbackThread : public PlatformThread::Delegate {
+ public:
+  explicit CallbackThread(RepeatingClosure callback)
+      : callback_(std::move(callback)) {}
+  CallbackThread(const CallbackThread&) = delete;
+  CallbackThread& operator=(const CallbackThread&) = delete;
+
+  void ThreadMain() override { callback_.Run(); }
+
+ private:
+  const RepeatingClosure callback_;
+};
+
+// Runs `callback` on `num_threads` threads at once, and waits for all of them.
+void RunOnThreads(size_t num_threads, RepeatingClosure callback) {
+  CallbackThread thread(std::move(callback));
+  std::vector<PlatformThreadHandle> handles(num_threads);
+  for (PlatformThreadHandle& handle : handles) {
+    ASSERT_TRUE(PlatformThread::Create(0, &thread, &handle));
+  }
+  for (PlatformThreadHandle& handle : handles) {
+    PlatformThread::Join(handle);
+  }
+}
+
+// Returns whether the lock can be acquired for reading, from another thread.
+bool CanReadAcquire(RWLock& lock) {
+  bool acquired = false;
+  RunOnThreads(1, BindLambdaForTesting([&] {
+                 acquired = lock.TryReadAcquire();
+                 if (acquired) {
+                   lock.ReadRelease();
+                 }
+               }));
+  return acquired;
+}
+
+// Returns whether the lock can be acquired for writing, from another thread.
+bool CanWriteAcquire(RWLock& lock) {
+  bool acquired = false;
+  RunOnThreads(1, BindLambdaForTesting([&] {
+                 acquired = lock.TryWriteAcquire();
+                 if (acquired) {
+                   lock.WriteRelease();
+                 }
+               }));
+  return acquired;
+}
+
+constexpr size_t kNumThreads = 4;
+constexpr int kNumIterations = 1000;
+
+}  // namespace
+
+TEST(RWLockTest, ReadersShareTheLock) {
+  RWLock lock;
+  lock.ReadAcquire();
+  EXPECT_TRUE(CanReadAcquire(lock));
+  EXPECT_FALSE(CanWriteAcquire(lock));
+  lock.ReadRelease();
+
+  ASSERT_TRUE(lock.TryReadAcquire());
+  EXPECT_TRUE(CanReadAcquire(lock));
+  lock.ReadRelease();
+  EXPECT_TRUE(CanWriteAcquire(lock));
+}
+
+TEST(RWLockTest, WriterExcludesEveryone) {
+  RWLock lock;
+  lock.WriteAcquire();
+  lock.AssertWriteAcquired();
+  EXPECT_FALSE(CanReadAcquire(lock));
+  EXPECT_FALSE(CanWriteAcquire(lock));
+  lock.WriteRelease();
+
+  ASSERT_TRUE(lock.TryWriteAcquire());
+  EXPECT_FALSE(CanReadAcquire(lock));
+  lock.WriteRelease();
+  EXPECT_TRUE(CanReadAcquire(lock));
+}
+
+TEST(RWLockTest, AutoLocks) {
+  RWLock lock;
+  {
+    AutoReadLock auto_lock(lock);
+    EXPECT_TRUE(CanReadAcquire(lock));
+    EXPECT_FALSE(CanWriteAcquire(lock));
+  }
+  {
+    AutoWriteLock auto_lock(lock);
+    lock.AssertWriteAcquired();
+    EXPECT_FALSE(CanReadAcquire(lock));
+  }
+  EXPECT_TRUE(CanWriteAcquire(lock));
+}
+
+TEST(RWLockTest, AssertWriteAcquiredWithoutWriter) {
+  RWLock lock;
+  EXPECT_DCHECK_DEATH(lock.AssertWriteAcquired());
+  lock.ReadAcquire();
+  EXPECT_DCHECK_DEATH(lock.AssertWriteAcquired());
+  lock.ReadRelease();
+}
+
+// Writers keep two values equal, and readers check that they never see them
+// differ.
+TEST(RWLockTest, ReadersAndWritersFourThreads) {
+  RWLock lock;
+  int a = 0;
+  int b = 0;
+  RunOnThreads(kNumThreads, BindLambdaForTesting([&] {
+                 for (int i = 0; i < kNumIterations; ++i) {
+                   if (i % 10 == 0) {
+                     AutoWriteLock auto_lock(lock);
+                     ++a;
+                     ++b;
+                   } else {
+                     AutoReadLock auto_lock(lock);
+                     EXPECT_EQ(a, b);
+                   }
+                 }
+               }));
+  EXPECT_EQ(a, static_cast<int>(kNumThreads) * kNumIterations / 10);
+  EXPECT_EQ(a, b);
+}
+
+// Readers share the lock, whichever shards they use.
+TEST(ShardedRWLockTest, ReadersShareTheLock) {
+  ShardedRWLock lock;
+  const size_t shard = lock.ReadAcquire();
+  EXPECT_LT(shard, ShardedRWLock::kNumShards);
+  RunOnThreads(kNumThreads, BindLambdaForTesting([&] {
+                 AutoShardedReadLock auto_lock(lock);
+               }));
+  lock.ReadRelease(shard);
+}
+
+TEST(ShardedRWLockTest, ReadersAndWritersFourThreads) {
+  ShardedRWLock lock;
+  int a = 0;
+  int b = 0;
+  RunOnThreads(kNumThreads, BindLambdaForTesting([&] {
+                 for (int i = 0; i < kNumIterations; ++i) {
+                   if (i % 10 == 0) {
+                     AutoShardedWriteLock auto_lock(lock);
+                     lock.AssertWriteAcquired();
+                     ++a;
+                     ++b;
+                   } else {
+                     AutoShardedReadLock auto_lock(lock);
+                     EXPECT_EQ(a, b);
+                   }
+                 }
+               }));
+  EXPECT_EQ(a, static_cast<int>(kNumThreads) * kNumIterations / 10);
+  EXPECT_EQ(a, b);
+}
+
+}  // namespace base
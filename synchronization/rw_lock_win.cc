@@ -0,0 +1,61 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/rw_lock.h"
+
+#include <windows.h>
+
+namespace base {
+
+namespace {
+
+PSRWLOCK AsSRWLock(CHROME_SRWLOCK* lock) {
+  return reinterpret_cast<PSRWLOCK>(lock);
+}
+
+}  // namespace
+
+// SRW locks don't strictly prefer writers, but they don't let readers starve
+// them either: readers arriving while a writer waits queue behind it.
+RWLock::RWLock() : native_handle_(SRWLOCK_INIT) {}
+
+RWLock::~RWLock() = default;
+
+void RWLock::ReadAcquire() {
+  ::AcquireSRWLockShared(AsSRWLock(&native_handle_));
+}
+
+void RWLock::ReadRelease() {
+  ::ReleaseSRWLockShared(AsSRWLock(&native_handle_));
+}
+
+bool RWLock::TryReadAcquire() {
+  return !!::TryAcquireSRWLockShared(AsSRWLock(&native_handle_));
+}
+
+void RWLock::WriteAcquire() {
+  ::AcquireSRWLockExclusive(AsSRWLock(&native_handle_));
+#if DCHECK_IS_ON()
+  CheckWriteUnheldAndMark();
+#endif
+}
+
+void RWLock::WriteRelease() {
+#if DCHECK_IS_ON()
+  CheckWriteHeldAndUnmark();
+#endif
+  ::ReleaseSRWLockExclusive(AsSRWLock(&native_handle_));
+}
+
+bool RWLock::TryWriteAcquire() {
+  if (!::TryAcquireSRWLockExclusive(AsSRWLock(&native_handle_))) {
+    return false;
+  }
+#if DCHECK_IS_ON()
+  CheckWriteUnheldAndMark();
+#endif
+  return true;
+}
+
+}  // namespace base
@@ -0,0 +1,104 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SYNCHRONIZATION_SEQ_LOCK_H_
+#define BASE_SYNCHRONIZATION_SEQ_LOCK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+
+namespace base {
+
+// A sequence lock holding a trivially copyable value of type T. Readers never
+// write to memory shared with other threads: they copy the value, and retry if
+// a writer modified it in the meantime. This makes reads scale to any number
+// of threads, as long as writes are rare; reads spin while a write is in
+// progress. Writers are serialized with a Lock.
+//
+// Example:
+//   struct Config { int a; int b; };
+//   SeqLock<Config> config;
+//   ...
+//   config.Write({1, 2});                  // On any thread.
+//   ...
+//   Config snapshot = config.Read();       // On any thread.
+//
+// For values which aren't trivially copyable, see AtomicSnapshot.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SeqLock copies T byte by byte, so T must be trivially "
+                "copyable. Use AtomicSnapshot otherwise.");
+  static_assert(std::is_default_constructible_v<T>);
+
+ public:
+  SeqLock() : SeqLock(T()) {}
+  explicit SeqLock(const T& value) { StoreWords(value); }
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+  ~SeqLock() = default;
+
+  // Returns a consistent copy of the value.
+  T Read() const {
+    while (true) {
+      const uint32_t sequence = sequence_.load(std::memory_order_acquire);
+      if (sequence & 1) {
+        // A write is in progress.
+        continue;
+      }
+      std::array<uintptr_t, kNumWords> words;
+      for (size_t i = 0; i < kNumWords; ++i) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      // Orders the loads of the words before the load of the sequence below.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence_.load(std::memory_order_relaxed) == sequence) {
+        T value;
+        memcpy(&value, words.data(), sizeof(T));
+        return value;
+      }
+    }
+  }
+
+  void Write(const T& value) {
+    AutoLock auto_lock(write_lock_);
+    const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    // Orders the store of the odd sequence before the stores of the words.
+    std::atomic_thread_fence(std::memory_order_release);
+    StoreWords(value);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+ private:
+  static constexpr size_t kNumWords =
+      (sizeof(T) + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+
+  // The value is stored in atomic words so that reading it while it's being
+  // written isn't a data race.
+  void StoreWords(const T& value) {
+    std::array<uintptr_t, kNumWords> words = {};
+    memcpy(words.data(), &value, sizeof(T));
+    for (size_t i = 0; i < kNumWords; ++i) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+
+  // Odd while a write is in progress.
+  std::atomic<uint32_t> sequence_ = 0;
+  std::array<std::atomic<uintptr_t>, kNumWords> words_;
+  Lock write_lock_;
+};
+
+}  // namespace base
+
+#endif  // BASE_SYNCHRONIZATION_SEQ_LOCK_H_
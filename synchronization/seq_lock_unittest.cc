@@ -0,0 +1,80 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/seq_lock.h"
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Larger than a word, and not a multiple of its size, so that torn reads
+// would be noticed.
+struct Values {
+  uint64_t a = 0;
+  uint64_t b = 0;
+  uint32_t c = 0;
+};
+
+class WriterThread : public PlatformThread::Delegate {
+ public:
+  explicit WriterThread(SeqLock<Values>& seq_lock) : seq_lock_(seq_lock) {}
+  WriterThread(const WriterThread&) = delete;
+  WriterThread& operator=(const WriterThread&) = delete;
+
+  void ThreadMain() override {
+    for (uint32_t i = 1; i <= kNumWrites; ++i) {
+      seq_lock_.Write({i, i, i});
+    }
+  }
+
+  static constexpr uint32_t kNumWrites = 100000;
+
+ private:
+  SeqLock<Values>& seq_lock_;
+};
+
+}  // namespace
+
+TEST(SeqLockTest, ReadWrite) {
+  SeqLock<Values> seq_lock;
+  EXPECT_EQ(0u, seq_lock.Read().a);
+
+  seq_lock.Write({1, 2, 3});
+  const Values values = seq_lock.Read();
+  EXPECT_EQ(1u, values.a);
+  EXPECT_EQ(2u, values.b);
+  EXPECT_EQ(3u, values.c);
+
+  SeqLock<int> initialized(42);
+  EXPECT_EQ(42, initialized.Read());
+}
+
+// Reads concurrent with writes always see one of the written values entirely.
+TEST(SeqLockTest, ConcurrentReadsAreConsistent) {
+  SeqLock<Values> seq_lock;
+  WriterThread writer(seq_lock);
+  PlatformThreadHandle handle;
+  ASSERT_TRUE(PlatformThread::Create(0, &writer, &handle));
+
+  uint64_t last = 0;
+  while (last < WriterThread::kNumWrites) {
+    const Values values = seq_lock.Read();
+    ASSERT_EQ(values.a, values.b);
+    ASSERT_EQ(values.a, values.c);
+    // Values are written in increasing order.
+    ASSERT_GE(values.a, last);
+    last = values.a;
+  }
+
+  PlatformThread::Join(handle);
+}
+
+}  // namespace base
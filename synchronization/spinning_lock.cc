@@ -0,0 +1,42 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This file is used for debugging assertion support, like lock.cc.
+
+#include "base/synchronization/spinning_lock.h"
+
+#if DCHECK_IS_ON()
+
+#include "base/check_op.h"
+#include "base/threading/platform_thread.h"
+
+namespace base {
+
+SpinningLock::SpinningLock() = default;
+
+SpinningLock::~SpinningLock() {
+  DCHECK(owning_thread_ref_.is_null());
+}
+
+void SpinningLock::AssertAcquired() const {
+  DCHECK_EQ(owning_thread_ref_, PlatformThread::CurrentRef());
+}
+
+void SpinningLock::AssertNotHeld() const {
+  DCHECK(owning_thread_ref_.is_null());
+}
+
+void SpinningLock::CheckHeldAndUnmark() {
+  DCHECK_EQ(owning_thread_ref_, PlatformThread::CurrentRef());
+  owning_thread_ref_ = PlatformThreadRef();
+}
+
+void SpinningLock::CheckUnheldAndMark() {
+  DCHECK(owning_thread_ref_.is_null());
+  owning_thread_ref_ = PlatformThread::CurrentRef();
+}
+
+}  // namespace base
+
+#endif  // DCHECK_IS_ON()
@@ -0,0 +1,100 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SYNCHRONIZATION_SPINNING_LOCK_H_
+#define BASE_SYNCHRONIZATION_SPINNING_LOCK_H_
+
+#include "base/base_export.h"
+#include "base/dcheck_is_on.h"
+#include "base/synchronization/lock_impl.h"
+#include "base/thread_annotations.h"
+#include "partition_alloc/spinning_mutex.h"
+
+#if DCHECK_IS_ON()
+#include "base/threading/platform_thread_ref.h"
+#endif
+
+namespace base {
+
+// A lock which spins in user space for a few microseconds before sleeping in
+// the kernel, built on PartitionAlloc's SpinningMutex (a futex on Linux and
+// Android, SRWLOCK on Windows, os_unfair_lock on Apple platforms). Acquiring
+// and releasing it are inlined, and a short critical section contended by
+// another thread is usually waited for without a futex handoff.
+//
+// Prefer Lock unless profiling shows that a lock protecting short critical
+// sections is contended. Unlike Lock, a SpinningLock can't be used with a
+// ConditionVariable and doesn't mitigate priority inversion, so it must not be
+// shared by threads of different priorities.
+class LOCKABLE BASE_EXPORT SpinningLock {
+ public:
+#if !DCHECK_IS_ON()
+  SpinningLock() = default;
+  SpinningLock(const SpinningLock&) = delete;
+  SpinningLock& operator=(const SpinningLock&) = delete;
+  ~SpinningLock() = default;
+
+  void Acquire() EXCLUSIVE_LOCK_FUNCTION() { lock_.Acquire(); }
+  void Release() UNLOCK_FUNCTION() { lock_.Release(); }
+
+  // If the lock is not held, take it and return true. If the lock is already
+  // held by another thread, immediately return false. This must not be called
+  // by a thread already holding the lock.
+  bool Try() EXCLUSIVE_TRYLOCK_FUNCTION(true) { return lock_.Try(); }
+
+  // Null implementation if not debug.
+  void AssertAcquired() const ASSERT_EXCLUSIVE_LOCK() {}
+  void AssertNotHeld() const {}
+#else
+  SpinningLock();
+  SpinningLock(const SpinningLock&) = delete;
+  SpinningLock& operator=(const SpinningLock&) = delete;
+  ~SpinningLock();
+
+  // NOTE: Recursive locks are not permitted, and will fire a DCHECK() if a
+  // thread attempts to acquire the lock a second time while holding it.
+  void Acquire() EXCLUSIVE_LOCK_FUNCTION() {
+    lock_.Acquire();
+    CheckUnheldAndMark();
+  }
+  void Release() UNLOCK_FUNCTION() {
+    CheckHeldAndUnmark();
+    lock_.Release();
+  }
+
+  bool Try() EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+    const bool rv = lock_.Try();
+    if (rv) {
+      CheckUnheldAndMark();
+    }
+    return rv;
+  }
+
+  void AssertAcquired() const ASSERT_EXCLUSIVE_LOCK();
+  void AssertNotHeld() const;
+#endif  // DCHECK_IS_ON()
+
+ private:
+#if DCHECK_IS_ON()
+  void CheckHeldAndUnmark();
+  void CheckUnheldAndMark();
+
+  // Only accessed while `lock_` is held.
+  base::PlatformThreadRef owning_thread_ref_;
+#endif  // DCHECK_IS_ON()
+
+  partition_alloc::internal::SpinningMutex lock_;
+};
+
+// A helper class that acquires the given SpinningLock while the
+// AutoSpinningLock is in scope.
+using AutoSpinningLock = internal::BasicAutoLock<SpinningLock>;
+
+// A helper class that tries to acquire the given SpinningLock while the
+// AutoTrySpinningLock is in scope.
+using AutoTrySpinningLock = internal::BasicAutoTryLock<SpinningLock>;
+
+}  // namespace base
+
+#endif  // BASE_SYNCHRONIZATION_SPINNING_LOCK_H_
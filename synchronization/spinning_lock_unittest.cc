@@ -0,0 +1,127 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/synchronization/spinning_lock.h"
+
+#include "base/memory/raw_ptr.h"
+#include "base/test/gtest_util.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class SpinningLockTestThread : public PlatformThread::Delegate {
+ public:
+  SpinningLockTestThread(SpinningLock* lock, int* value)
+      : lock_(lock), value_(value) {}
+
+  SpinningLockTestThread(const SpinningLockTestThread&) = delete;
+  SpinningLockTestThread& operator=(const SpinningLockTestThread&) = delete;
+
+  // Static helper which can also be called from the main thread. The critical
+  // section is short, so that contended acquisitions usually spin.
+  static void DoStuff(SpinningLock* lock, int* value) {
+    for (int i = 0; i < 10000; i++) {
+      AutoSpinningLock auto_lock(*lock);
+      int v = *value;
+      *value = v + 1;
+    }
+  }
+
+  void ThreadMain() override { DoStuff(lock_, value_); }
+
+ private:
+  raw_ptr<SpinningLock> lock_;
+  raw_ptr<int> value_;
+};
+
+class TryLockTestThread : public PlatformThread::Delegate {
+ public:
+  explicit TryLockTestThread(SpinningLock* lock) : lock_(lock) {}
+
+  TryLockTestThread(const TryLockTestThread&) = delete;
+  TryLockTestThread& operator=(const TryLockTestThread&) = delete;
+
+  void ThreadMain() override {
+    got_lock_ = lock_->Try();
+    if (got_lock_) {
+      lock_->Release();
+    }
+  }
+
+  bool got_lock() const { return got_lock_; }
+
+ private:
+  raw_ptr<SpinningLock> lock_;
+  bool got_lock_ = false;
+};
+
+}  // namespace
+
+TEST(SpinningLockTest, TryLock) {
+  SpinningLock lock;
+
+  ASSERT_TRUE(lock.Try());
+  lock.AssertAcquired();
+
+  // This thread will not be able to get the lock.
+  {
+    TryLockTestThread thread(&lock);
+    PlatformThreadHandle handle;
+    ASSERT_TRUE(PlatformThread::Create(0, &thread, &handle));
+    PlatformThread::Join(handle);
+    EXPECT_FALSE(thread.got_lock());
+  }
+
+  lock.Release();
+
+  // This thread will.
+  {
+    TryLockTestThread thread(&lock);
+    PlatformThreadHandle handle;
+    ASSERT_TRUE(PlatformThread::Create(0, &thread, &handle));
+    PlatformThread::Join(handle);
+    EXPECT_TRUE(thread.got_lock());
+  }
+
+  lock.AssertNotHeld();
+}
+
+TEST(SpinningLockTest, MutexFourThreads) {
+  SpinningLock lock;
+  int value = 0;
+
+  SpinningLockTestThread thread1(&lock, &value);
+  SpinningLockTestThread thread2(&lock, &value);
+  SpinningLockTestThread thread3(&lock, &value);
+  PlatformThreadHandle handle1;
+  PlatformThreadHandle handle2;
+  PlatformThreadHandle handle3;
+
+  ASSERT_TRUE(PlatformThread::Create(0, &thread1, &handle1));
+  ASSERT_TRUE(PlatformThread::Create(0, &thread2, &handle2));
+  ASSERT_TRUE(PlatformThread::Create(0, &thread3, &handle3));
+
+  SpinningLockTestThread::DoStuff(&lock, &value);
+
+  PlatformThread::Join(handle1);
+  PlatformThread::Join(handle2);
+  PlatformThread::Join(handle3);
+
+  EXPECT_EQ(4 * 10000, value);
+}
+
+TEST(SpinningLockTest, AutoTrySpinningLock) {
+  SpinningLock lock;
+  {
+    AutoTrySpinningLock auto_try_lock(lock);
+    ASSERT_TRUE(auto_try_lock.is_acquired());
+    lock.AssertAcquired();
+  }
+  EXPECT_DCHECK_DEATH(lock.AssertAcquired());
+}
+
+}  // namespace base
@@ -9,10 +9,17 @@
 
 #include "base/synchronization/waitable_event.h"
 
+#include <algorithm>
+
 #include "base/check.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "base/trace_event/base_tracing.h"
 #include "base/tracing_buildflags.h"
+#include "build/build_config.h"
+
+#if !BUILDFLAG(IS_NACL)
+#include "partition_alloc/yield_processor.h"
+#endif
 
 namespace base {
 
@@ -57,15 +64,17 @@ bool WaitableEvent::TimedWait(TimeDelta wait_delta) {
     return IsSignaled();
 
   // Consider this thread blocked for scheduling purposes. Ignore this for
-  // non-blocking WaitableEvents.
+  // non-blocking WaitableEvents, and while spinning, which is short.
   std::optional<internal::ScopedBlockingCallWithBaseSyncPrimitives>
       scoped_blocking_call;
-  if (!only_used_while_idle_) {
-    scoped_blocking_call.emplace(FROM_HERE, BlockingType::MAY_BLOCK);
+  bool result = spin_before_wait_ && SpinUntilSignaled();
+  if (!result) {
+    if (!only_used_while_idle_) {
+      scoped_blocking_call.emplace(FROM_HERE, BlockingType::MAY_BLOCK);
+    }
+    result = TimedWaitImpl(wait_delta);
   }
 
-  const bool result = TimedWaitImpl(wait_delta);
-
   if (result && !only_used_while_idle_) {
     TRACE_EVENT_INSTANT("wakeup.flow,toplevel.flow",
                         "WaitableEvent::Wait Complete",
@@ -75,6 +84,30 @@ bool WaitableEvent::TimedWait(TimeDelta wait_delta) {
   return result;
 }
 
+bool WaitableEvent::SpinUntilSignaled() {
+#if BUILDFLAG(IS_NACL)
+  // PartitionAlloc isn't available in NaCl.
+  return false;
+#else
+  // Like partition_alloc::internal::SpinningMutex, spin for up to ~3us on
+  // x86_64, backing off exponentially between polls so as not to slow down
+  // Signal() by contending for the event's state.
+  constexpr int kSpinCount = 64;
+  constexpr int kMaxBackoff = 16;
+  int backoff = 1;
+  for (int spins = 0; spins < kSpinCount;) {
+    if (IsSignaled()) {
+      return true;
+    }
+    for (int yields = 0; yields < backoff; ++yields, ++spins) {
+      PA_YIELD_PROCESSOR;
+    }
+    backoff = std::min(kMaxBackoff, backoff << 1);
+  }
+  return false;
+#endif  // BUILDFLAG(IS_NACL)
+}
+
 size_t WaitableEvent::WaitMany(WaitableEvent** events, size_t count) {
   DCHECK(count) << "Cannot wait on no events";
   internal::ScopedBlockingCallWithBaseSyncPrimitives scoped_blocking_call(
@@ -121,6 +121,13 @@ class BASE_EXPORT WaitableEvent {
   // are responsible for emitting the cause of their wakeup from idle.
   void declare_only_used_while_idle() { only_used_while_idle_ = true; }
 
+  // Declares that Wait() and TimedWait() should spin for a few microseconds,
+  // polling IsSignaled(), before blocking. This avoids sleeping in the kernel
+  // when the event is usually signaled shortly after the wait starts, at the
+  // cost of wasted CPU time otherwise. Polling is cheap on POSIX platforms
+  // other than Apple ones, where it doesn't make a system call.
+  void declare_spin_before_wait() { spin_before_wait_ = true; }
+
   // Wait, synchronously, on multiple events.
   //   waitables: an array of WaitableEvent pointers
   //   count: the number of elements in @waitables
@@ -175,6 +182,10 @@ class BASE_EXPORT WaitableEvent {
   // the actual signaling and waiting).
   void SignalImpl();
   bool TimedWaitImpl(TimeDelta wait_delta);
+
+  // Polls IsSignaled() for a few microseconds. Returns true if it was
+  // signaled.
+  bool SpinUntilSignaled();
   static size_t WaitManyImpl(WaitableEvent** waitables, size_t count);
 
 #if BUILDFLAG(IS_WIN)
@@ -268,6 +279,9 @@ class BASE_EXPORT WaitableEvent {
   // and whether WaitableEvent should emit a wakeup.flow event on Signal =>
   // TimedWait.
   bool only_used_while_idle_ = false;
+
+  // Whether Wait() and TimedWait() spin before blocking.
+  bool spin_before_wait_ = false;
 };
 
 }  // namespace base
@@ -26,6 +26,10 @@ constexpr char kStoryMultiThreadWaiter[] = "multi_thread_1000_samples_waiter";
 constexpr char kStoryMultiThreadSignaler[] =
     "multi_thread_1000_samples_signaler";
 constexpr char kStoryTimedThroughput[] = "timed_throughput";
+constexpr char kStoryMultiThreadWaiterSpin[] =
+    "multi_thread_1000_samples_waiter_spin_before_wait";
+constexpr char kStoryMultiThreadSignalerSpin[] =
+    "multi_thread_1000_samples_signaler_spin_before_wait";
 
 perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
   perf_test::PerfResultReporter reporter(kMetricPrefixWaitableEvent,
@@ -38,7 +42,11 @@ perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
 
 class TraceWaitableEvent {
  public:
-  TraceWaitableEvent() = default;
+  explicit TraceWaitableEvent(bool spin_before_wait = false) {
+    if (spin_before_wait) {
+      event_.declare_spin_before_wait();
+    }
+  }
 
   TraceWaitableEvent(const TraceWaitableEvent&) = delete;
   TraceWaitableEvent& operator=(const TraceWaitableEvent&) = delete;
@@ -173,6 +181,34 @@ TEST(WaitableEventPerfTest, MultipleThreads) {
   PrintPerfWaitableEvent(&signaler, kStoryMultiThreadSignaler);
 }
 
+// Same as above, with events which spin before blocking. The round trips are
+// short enough that most waits should be satisfied while spinning.
+TEST(WaitableEventPerfTest, MultipleThreadsSpinBeforeWait) {
+  const size_t kSamples = 1000;
+
+  TraceWaitableEvent waiter(/*spin_before_wait=*/true);
+  TraceWaitableEvent signaler(/*spin_before_wait=*/true);
+
+  // The other thread will wait and signal on the respective opposite events.
+  SignalerThread thread(&signaler, &waiter);
+  thread.Start();
+
+  for (size_t i = 0; i < kSamples; ++i) {
+    signaler.Signal();
+    waiter.Wait();
+  }
+
+  // Signal the stop event and then make sure the signaler event it is
+  // waiting on is also signaled.
+  thread.RequestStop();
+  signaler.Signal();
+
+  thread.Join();
+
+  PrintPerfWaitableEvent(&waiter, kStoryMultiThreadWaiterSpin);
+  PrintPerfWaitableEvent(&signaler, kStoryMultiThreadSignalerSpin);
+}
+
 TEST(WaitableEventPerfTest, Throughput) {
   TraceWaitableEvent event;
 
@@ -5,6 +5,8 @@
 #include "base/system/sys_info.h"
 
 #include <algorithm>
+#include <cmath>
+#include <optional>
 
 #include "base/base_switches.h"
 #include "base/command_line.h"
@@ -12,6 +14,7 @@
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/location.h"
+#include "base/no_destructor.h"
 #include "base/notreached.h"
 #include "base/system/sys_info_internal.h"
 #include "base/task/task_traits.h"
@@ -30,6 +33,16 @@ constexpr uint64_t kLowMemoryDeviceThresholdMB = 2048;
 #endif
 
 std::optional<uint64_t> g_amount_of_physical_memory_mb_for_testing;
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Cached like NumberOfProcessors(), since the control group files can't be
+// read in the sandbox.
+const internal::CgroupLimits& GetCachedCgroupLimits() {
+  static const NoDestructor<internal::CgroupLimits> cgroup_limits(
+      internal::GetCurrentProcessCgroupLimits());
+  return *cgroup_limits;
+}
+#endif
 }  // namespace
 
 // static
@@ -38,6 +51,36 @@ int SysInfo::NumberOfEfficientProcessors() {
   return number_of_efficient_processors;
 }
 
+// static
+int SysInfo::EffectiveNumberOfProcessors() {
+  static const int effective_number_of_processors = [] {
+    const int number_of_processors = NumberOfProcessors();
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    const std::optional<double>& cpu_quota = GetCachedCgroupLimits().cpu_quota;
+    if (cpu_quota) {
+      return std::clamp(static_cast<int>(std::ceil(*cpu_quota)), 1,
+                        number_of_processors);
+    }
+#endif
+    return number_of_processors;
+  }();
+  return effective_number_of_processors;
+}
+
+// static
+const std::vector<std::vector<int>>& SysInfo::NumaNodeProcessors() {
+  static const NoDestructor<std::vector<std::vector<int>>>
+      numa_node_processors(NumaNodeProcessorsImpl());
+  return *numa_node_processors;
+}
+
+#if !BUILDFLAG(IS_LINUX) && !BUILDFLAG(IS_CHROMEOS) && !BUILDFLAG(IS_ANDROID)
+// static
+std::vector<std::vector<int>> SysInfo::NumaNodeProcessorsImpl() {
+  return {};
+}
+#endif
+
 // static
 uint64_t SysInfo::AmountOfPhysicalMemory() {
   constexpr uint64_t kMB = 1024 * 1024;
@@ -59,6 +102,19 @@ uint64_t SysInfo::AmountOfPhysicalMemory() {
   return AmountOfPhysicalMemoryImpl();
 }
 
+// static
+uint64_t SysInfo::EffectiveAmountOfPhysicalMemory() {
+  const uint64_t amount_of_physical_memory = AmountOfPhysicalMemory();
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  const std::optional<uint64_t>& memory_limit =
+      GetCachedCgroupLimits().memory_limit;
+  if (memory_limit && *memory_limit != 0) {
+    return std::min(amount_of_physical_memory, *memory_limit);
+  }
+#endif
+  return amount_of_physical_memory;
+}
+
 // static
 uint64_t SysInfo::AmountOfAvailablePhysicalMemory() {
   if (base::CommandLine::ForCurrentProcess()->HasSwitch(
@@ -12,6 +12,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/functional/callback_forward.h"
@@ -69,11 +70,31 @@ class BASE_EXPORT SysInfo {
   // This function will cache the result value in its implementation.
   static int NumberOfEfficientProcessors();
 
+  // Returns the number of processors that the current application can keep
+  // busy at once: NumberOfProcessors(), lowered on Linux, ChromeOS and Android
+  // to the CPU bandwidth quota of the control group of the process (e.g. in a
+  // container), rounded up. A quota of 1.5 CPUs on a 64-CPU host returns 2.
+  // Use this rather than NumberOfProcessors() to size pools of CPU-bound
+  // threads. This function will cache the result value in its implementation.
+  static int EffectiveNumberOfProcessors();
+
+  // Returns the logical processors available for the current application,
+  // grouped by NUMA node. Nodes without any available processor are omitted.
+  // Returns an empty vector when the topology is unknown, e.g. on platforms
+  // other than Linux/ChromeOS/Android. This function will cache the result
+  // value in its implementation.
+  static const std::vector<std::vector<int>>& NumaNodeProcessors();
+
   // Return the number of bytes of physical memory on the current machine.
   // If low-end device mode is manually enabled via command line flag, this
   // will return the lesser of the actual physical memory, or 512MB.
   static uint64_t AmountOfPhysicalMemory();
 
+  // Returns AmountOfPhysicalMemory(), lowered on Linux, ChromeOS and Android
+  // to the memory limit of the control group of the process (e.g. in a
+  // container). The limit is cached.
+  static uint64_t EffectiveAmountOfPhysicalMemory();
+
   // Return the number of bytes of current available physical memory on the
   // machine.
   // (The amount of memory that can be allocated without any significant
@@ -331,6 +352,7 @@ class BASE_EXPORT SysInfo {
   FRIEND_TEST_ALL_PREFIXES(debug::SystemMetricsTest, ParseMeminfo);
 
   static int NumberOfEfficientProcessorsImpl();
+  static std::vector<std::vector<int>> NumaNodeProcessorsImpl();
   static uint64_t AmountOfPhysicalMemoryImpl();
   static uint64_t AmountOfAvailablePhysicalMemoryImpl();
   static bool IsLowEndDeviceImpl();
@@ -8,10 +8,19 @@
 #include "base/base_export.h"
 #include "build/build_config.h"
 
-#if BUILDFLAG(IS_APPLE)
+#if BUILDFLAG(IS_APPLE) || BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || \
+    BUILDFLAG(IS_ANDROID)
 #include <optional>
 #endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <stdint.h>
+
+#include <string_view>
+
+#include "base/files/file_path.h"
+#endif
+
 namespace base {
 
 namespace internal {
@@ -48,6 +57,29 @@ std::optional<int> NumberOfProcessorsWhenCpuSecurityMitigationEnabled();
 std::optional<int> GetSysctlIntValue(const char* key_name);
 #endif
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// The resource limits of a control group.
+struct CgroupLimits {
+  // The CPU bandwidth quota, in CPUs (e.g. 1.5), if any.
+  std::optional<double> cpu_quota;
+  // The memory limit, in bytes, if any.
+  std::optional<uint64_t> memory_limit;
+};
+
+// Returns the limits of the control group of the current process, i.e. the
+// strictest of the limits of the group and of its ancestors, in the cgroup v1
+// and v2 hierarchies. |proc_self_cgroup| and |proc_self_mountinfo| are the
+// contents of /proc/self/cgroup and /proc/self/mountinfo, and the mount points
+// are looked up under |root|. Exposed for testing.
+BASE_EXPORT CgroupLimits GetCgroupLimits(std::string_view proc_self_cgroup,
+                                         std::string_view proc_self_mountinfo,
+                                         const FilePath& root);
+
+// Returns the limits of the control group of the current process, or no limits
+// if they can't be read.
+CgroupLimits GetCurrentProcessCgroupLimits();
+#endif
+
 }  // namespace internal
 
 }  // namespace base
@@ -4,20 +4,27 @@
 
 #include "base/system/sys_info.h"
 
+#include <sched.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #include <algorithm>
 #include <limits>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "base/check.h"
 #include "base/files/file_util.h"
+#include "base/functional/function_ref.h"
 #include "base/lazy_instance.h"
 #include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/process/process_metrics.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/system/sys_info_internal.h"
@@ -41,10 +48,264 @@ base::LazyInstance<
     base::internal::LazySysInfoValue<uint64_t, AmountOfPhysicalMemory>>::Leaky
     g_lazy_physical_memory = LAZY_INSTANCE_INITIALIZER;
 
+// Parses a list of integers in the format of e.g.
+// /sys/devices/system/node/online ("0-3,8,10-11"). Returns an empty vector on
+// error.
+std::vector<int> ParseSysfsList(std::string_view list) {
+  std::vector<int> values;
+  for (std::string_view range : base::SplitStringPiece(
+           list, ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    std::vector<std::string_view> bounds = base::SplitStringPiece(
+        range, "-", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
+    int first;
+    int last;
+    if (bounds.size() > 2 || !base::StringToInt(bounds.front(), &first) ||
+        !base::StringToInt(bounds.back(), &last) || first < 0 ||
+        last < first) {
+      return {};
+    }
+    for (int value = first; value <= last; ++value) {
+      values.push_back(value);
+    }
+  }
+  return values;
+}
+
+// Reads and parses a list from sysfs. Returns an empty vector on error.
+std::vector<int> ReadSysfsList(const std::string& path) {
+  std::string contents;
+  if (!base::ReadFileToString(base::FilePath(path), &contents)) {
+    return {};
+  }
+  return ParseSysfsList(contents);
+}
+
 }  // namespace
 
 namespace base {
 
+namespace {
+
+// Large enough for the content of the control group files which are read.
+constexpr size_t kMaxCgroupFileSize = 4096;
+
+// A control group hierarchy mounted in the mount namespace of the process.
+struct CgroupMount {
+  // The path of the group of the hierarchy which is mounted, e.g. "/", or the
+  // group of a container without its own cgroup namespace.
+  std::string_view root;
+  std::string_view mount_point;
+};
+
+// The mounts of the hierarchies whose limits are read.
+struct CgroupMounts {
+  std::optional<CgroupMount> unified;
+  std::optional<CgroupMount> cpu;
+  std::optional<CgroupMount> memory;
+};
+
+std::optional<std::string> ReadCgroupFile(const FilePath& path) {
+  std::string contents;
+  if (!ReadFileToStringWithMaxSize(path, &contents, kMaxCgroupFileSize)) {
+    return std::nullopt;
+  }
+  return contents;
+}
+
+// Returns the limit in |value|, or nullopt if it is "max" or negative, which
+// mean no limit.
+std::optional<int64_t> ParseCgroupLimit(std::string_view value) {
+  int64_t limit;
+  if (!StringToInt64(TrimWhitespaceASCII(value, TRIM_ALL), &limit) ||
+      limit < 0) {
+    return std::nullopt;
+  }
+  return limit;
+}
+
+std::optional<int64_t> ReadCgroupLimit(const FilePath& path) {
+  std::optional<std::string> contents = ReadCgroupFile(path);
+  return contents ? ParseCgroupLimit(*contents) : std::nullopt;
+}
+
+template <typename T>
+void LowerLimit(std::optional<T>& limit, T value) {
+  limit = limit ? std::min(*limit, value) : value;
+}
+
+// Parses the lines of /proc/self/mountinfo, e.g.
+//   "30 23 0:26 / /sys/fs/cgroup rw,nosuid - cgroup2 cgroup2 rw"
+//   "31 23 0:27 / /sys/fs/cgroup/cpu,cpuacct rw - cgroup cgroup rw,cpu,cpuacct"
+CgroupMounts ParseCgroupMounts(std::string_view proc_self_mountinfo) {
+  CgroupMounts mounts;
+  for (std::string_view line : SplitStringPiece(
+           proc_self_mountinfo, "\n", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY)) {
+    const std::vector<std::string_view> fields =
+        SplitStringPiece(line, " ", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY);
+    // The optional fields which follow the mount options end with a "-".
+    const auto separator = std::find(fields.begin(), fields.end(), "-");
+    if (fields.size() < 5 || fields.end() - separator < 4) {
+      continue;
+    }
+    const CgroupMount mount = {fields[3], fields[4]};
+    const std::string_view filesystem_type = separator[1];
+    if (filesystem_type == "cgroup2") {
+      mounts.unified = mount;
+    } else if (filesystem_type == "cgroup") {
+      for (std::string_view option : SplitStringPiece(
+               separator[3], ",", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY)) {
+        if (option == "cpu") {
+          mounts.cpu = mount;
+        } else if (option == "memory") {
+          mounts.memory = mount;
+        }
+      }
+    }
+  }
+  return mounts;
+}
+
+// Calls |read_limits| on the directory of the group at |cgroup_path| of the
+// hierarchy mounted as |mount|, then on the directories of its ancestors up to
+// the mount point, since the limits of the ancestors apply too.
+void ForEachCgroupDirectory(const CgroupMount& mount,
+                            std::string_view cgroup_path,
+                            const FilePath& root,
+                            FunctionRef<void(const FilePath&)> read_limits) {
+  const FilePath mount_directory =
+      root.Append(TrimString(mount.mount_point, "/", TRIM_LEADING));
+  // A group outside of the mounted subtree, e.g. when a container sees the
+  // paths of the host hierarchy, is limited by the mounted group.
+  std::string_view relative_path;
+  if (mount.root == "/") {
+    relative_path = cgroup_path;
+  } else if (cgroup_path.starts_with(mount.root) &&
+             (cgroup_path.size() == mount.root.size() ||
+              cgroup_path[mount.root.size()] == '/')) {
+    relative_path = cgroup_path.substr(mount.root.size());
+  }
+  relative_path = TrimString(relative_path, "/", TRIM_ALL);
+
+  FilePath directory = mount_directory.Append(relative_path);
+  while (true) {
+    read_limits(directory);
+    if (!mount_directory.IsParent(directory)) {
+      break;
+    }
+    directory = directory.DirName();
+  }
+}
+
+void ReadUnifiedCgroupLimits(const FilePath& directory,
+                             internal::CgroupLimits& limits) {
+  // The content of "cpu.max" is "$MAX $PERIOD", where $MAX is "max" if there
+  // is no quota.
+  if (std::optional<std::string> cpu_max =
+          ReadCgroupFile(directory.Append("cpu.max"))) {
+    const std::vector<std::string_view> fields = SplitStringPiece(
+        *cpu_max, " ", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY);
+    const std::optional<int64_t> quota_us =
+        fields.size() == 2 ? ParseCgroupLimit(fields[0]) : std::nullopt;
+    const std::optional<int64_t> period_us =
+        fields.size() == 2 ? ParseCgroupLimit(fields[1]) : std::nullopt;
+    if (quota_us && period_us && *period_us > 0) {
+      LowerLimit(limits.cpu_quota,
+                 static_cast<double>(*quota_us) / *period_us);
+    }
+  }
+  if (std::optional<int64_t> memory_max =
+          ReadCgroupLimit(directory.Append("memory.max"))) {
+    LowerLimit(limits.memory_limit, static_cast<uint64_t>(*memory_max));
+  }
+}
+
+void ReadCpuCgroupLimits(const FilePath& directory,
+                         internal::CgroupLimits& limits) {
+  // The quota is -1 if there is none.
+  const std::optional<int64_t> quota_us =
+      ReadCgroupLimit(directory.Append("cpu.cfs_quota_us"));
+  const std::optional<int64_t> period_us =
+      quota_us ? ReadCgroupLimit(directory.Append("cpu.cfs_period_us"))
+               : std::nullopt;
+  if (quota_us && period_us && *period_us > 0) {
+    LowerLimit(limits.cpu_quota, static_cast<double>(*quota_us) / *period_us);
+  }
+}
+
+void ReadMemoryCgroupLimits(const FilePath& directory,
+                            internal::CgroupLimits& limits) {
+  // Without a limit, the content is a large number rounded down to a page.
+  if (std::optional<int64_t> limit =
+          ReadCgroupLimit(directory.Append("memory.limit_in_bytes"))) {
+    LowerLimit(limits.memory_limit, static_cast<uint64_t>(*limit));
+  }
+}
+
+}  // namespace
+
+namespace internal {
+
+CgroupLimits GetCgroupLimits(std::string_view proc_self_cgroup,
+                             std::string_view proc_self_mountinfo,
+                             const FilePath& root) {
+  const CgroupMounts mounts = ParseCgroupMounts(proc_self_mountinfo);
+  CgroupLimits limits;
+  // The lines are "$HIERARCHY_ID:$CONTROLLERS:$PATH", where the controllers
+  // are empty for cgroup v2, e.g. "0::/user.slice" or "4:cpu,cpuacct:/".
+  for (std::string_view line : SplitStringPiece(
+           proc_self_cgroup, "\n", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY)) {
+    const size_t controllers_begin = line.find(':');
+    const size_t path_begin = controllers_begin == std::string_view::npos
+                                  ? std::string_view::npos
+                                  : line.find(':', controllers_begin + 1);
+    if (path_begin == std::string_view::npos) {
+      continue;
+    }
+    const std::string_view controllers = line.substr(
+        controllers_begin + 1, path_begin - controllers_begin - 1);
+    const std::string_view path = line.substr(path_begin + 1);
+
+    if (controllers.empty()) {
+      if (mounts.unified) {
+        ForEachCgroupDirectory(*mounts.unified, path, root,
+                               [&](const FilePath& directory) {
+                                 ReadUnifiedCgroupLimits(directory, limits);
+                               });
+      }
+      continue;
+    }
+    for (std::string_view controller : SplitStringPiece(
+             controllers, ",", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY)) {
+      if (controller == "cpu" && mounts.cpu) {
+        ForEachCgroupDirectory(*mounts.cpu, path, root,
+                               [&](const FilePath& directory) {
+                                 ReadCpuCgroupLimits(directory, limits);
+                               });
+      } else if (controller == "memory" && mounts.memory) {
+        ForEachCgroupDirectory(*mounts.memory, path, root,
+                               [&](const FilePath& directory) {
+                                 ReadMemoryCgroupLimits(directory, limits);
+                               });
+      }
+    }
+  }
+  return limits;
+}
+
+CgroupLimits GetCurrentProcessCgroupLimits() {
+  std::string proc_self_cgroup;
+  std::string proc_self_mountinfo;
+  if (!ReadFileToString(FilePath("/proc/self/cgroup"), &proc_self_cgroup) ||
+      !ReadFileToString(FilePath("/proc/self/mountinfo"),
+                        &proc_self_mountinfo)) {
+    return CgroupLimits();
+  }
+  return GetCgroupLimits(proc_self_cgroup, proc_self_mountinfo,
+                         FilePath("/"));
+}
+
+}  // namespace internal
+
 // static
 uint64_t SysInfo::AmountOfPhysicalMemoryImpl() {
   return g_lazy_physical_memory.Get().value();
@@ -71,6 +332,34 @@ uint64_t SysInfo::AmountOfAvailablePhysicalMemory(
   return checked_cast<uint64_t>(res_kb) * 1024;
 }
 
+// static
+std::vector<std::vector<int>> SysInfo::NumaNodeProcessorsImpl() {
+  const int num_cpus = checked_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+  if (num_cpus <= 0) {
+    return {};
+  }
+  cpu_set_t* cpu_set = CPU_ALLOC(num_cpus);
+  const size_t cpu_set_size = CPU_ALLOC_SIZE(num_cpus);
+  const bool has_affinity = sched_getaffinity(0, cpu_set_size, cpu_set) == 0;
+
+  std::vector<std::vector<int>> nodes;
+  for (int node : ReadSysfsList("/sys/devices/system/node/online")) {
+    std::vector<int> processors;
+    for (int cpu : ReadSysfsList(StringPrintf(
+             "/sys/devices/system/node/node%d/cpulist", node))) {
+      if (cpu < num_cpus &&
+          (!has_affinity || CPU_ISSET_S(cpu, cpu_set_size, cpu_set))) {
+        processors.push_back(cpu);
+      }
+    }
+    if (!processors.empty()) {
+      nodes.push_back(std::move(processors));
+    }
+  }
+  CPU_FREE(cpu_set);
+  return nodes;
+}
+
 // static
 std::string SysInfo::CPUModelName() {
 #if BUILDFLAG(IS_CHROMEOS) && defined(ARCH_CPU_ARMEL)
@@ -7,6 +7,7 @@
 #include <stdint.h>
 
 #include <optional>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -46,6 +47,11 @@
 #include "base/test/scoped_feature_list.h"
 #endif  // BUILDFLAG(IS_MAC)
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "base/files/scoped_temp_dir.h"
+#include "base/system/sys_info_internal.h"
+#endif
+
 namespace base {
 
 #if BUILDFLAG(IS_ANDROID)
@@ -66,6 +72,94 @@ TEST_F(SysInfoTest, NumProcs) {
             SysInfo::NumberOfProcessors());
 }
 
+TEST_F(SysInfoTest, NumaNodeProcessors) {
+  // Each available processor belongs to at most one node.
+  std::set<int> processors;
+  for (const std::vector<int>& node : SysInfo::NumaNodeProcessors()) {
+    EXPECT_FALSE(node.empty());
+    for (int processor : node) {
+      EXPECT_GE(processor, 0);
+      EXPECT_TRUE(processors.insert(processor).second);
+    }
+  }
+  EXPECT_LE(processors.size(),
+            static_cast<size_t>(SysInfo::NumberOfProcessors()));
+}
+
+TEST_F(SysInfoTest, EffectiveLimits) {
+  EXPECT_GE(SysInfo::EffectiveNumberOfProcessors(), 1);
+  EXPECT_LE(SysInfo::EffectiveNumberOfProcessors(),
+            SysInfo::NumberOfProcessors());
+  EXPECT_GT(SysInfo::EffectiveAmountOfPhysicalMemory(), 0u);
+  EXPECT_LE(SysInfo::EffectiveAmountOfPhysicalMemory(),
+            SysInfo::AmountOfPhysicalMemory());
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+TEST_F(SysInfoTest, CgroupV2Limits) {
+  ScopedTempDir root;
+  ASSERT_TRUE(root.CreateUniqueTempDir());
+  const FilePath parent = root.GetPath().Append("sys/fs/cgroup/parent");
+  const FilePath child = parent.Append("child");
+  ASSERT_TRUE(CreateDirectory(child));
+  // The strictest limits of the group and its ancestors apply.
+  ASSERT_TRUE(WriteFile(parent.Append("cpu.max"), "150000 100000\n"));
+  ASSERT_TRUE(WriteFile(child.Append("cpu.max"), "max 100000\n"));
+  ASSERT_TRUE(WriteFile(parent.Append("memory.max"), "max\n"));
+  ASSERT_TRUE(WriteFile(child.Append("memory.max"), "1073741824\n"));
+
+  const internal::CgroupLimits limits = internal::GetCgroupLimits(
+      "0::/parent/child\n",
+      "30 23 0:26 / /sys/fs/cgroup rw,nosuid,nodev - cgroup2 cgroup2 rw\n",
+      root.GetPath());
+  ASSERT_TRUE(limits.cpu_quota.has_value());
+  EXPECT_DOUBLE_EQ(1.5, *limits.cpu_quota);
+  EXPECT_EQ(1073741824u, limits.memory_limit);
+}
+
+TEST_F(SysInfoTest, CgroupV1ContainerLimits) {
+  ScopedTempDir root;
+  ASSERT_TRUE(root.CreateUniqueTempDir());
+  const FilePath cpu = root.GetPath().Append("sys/fs/cgroup/cpu,cpuacct");
+  const FilePath memory = root.GetPath().Append("sys/fs/cgroup/memory");
+  ASSERT_TRUE(CreateDirectory(cpu));
+  ASSERT_TRUE(CreateDirectory(memory));
+  ASSERT_TRUE(WriteFile(cpu.Append("cpu.cfs_quota_us"), "200000\n"));
+  ASSERT_TRUE(WriteFile(cpu.Append("cpu.cfs_period_us"), "100000\n"));
+  ASSERT_TRUE(WriteFile(memory.Append("memory.limit_in_bytes"), "536870912\n"));
+
+  // Without a cgroup namespace, the paths are those of the host hierarchy, in
+  // which the group of the container is mounted.
+  const internal::CgroupLimits limits = internal::GetCgroupLimits(
+      "12:memory:/docker/abc\n"
+      "4:cpu,cpuacct:/docker/abc\n"
+      "1:name=systemd:/docker/abc\n",
+      "40 39 0:35 /docker/abc /sys/fs/cgroup/cpu,cpuacct ro,nosuid master:17 - "
+      "cgroup cgroup rw,cpu,cpuacct\n"
+      "41 39 0:36 /docker/abc /sys/fs/cgroup/memory ro - cgroup cgroup "
+      "rw,memory\n",
+      root.GetPath());
+  ASSERT_TRUE(limits.cpu_quota.has_value());
+  EXPECT_DOUBLE_EQ(2, *limits.cpu_quota);
+  EXPECT_EQ(536870912u, limits.memory_limit);
+}
+
+TEST_F(SysInfoTest, CgroupWithoutLimits) {
+  ScopedTempDir root;
+  ASSERT_TRUE(root.CreateUniqueTempDir());
+  const FilePath group = root.GetPath().Append("sys/fs/cgroup");
+  ASSERT_TRUE(CreateDirectory(group));
+  ASSERT_TRUE(WriteFile(group.Append("cpu.max"), "max 100000\n"));
+
+  const internal::CgroupLimits limits = internal::GetCgroupLimits(
+      "0::/\n", "30 23 0:26 / /sys/fs/cgroup rw - cgroup2 cgroup2 rw\n",
+      root.GetPath());
+  EXPECT_FALSE(limits.cpu_quota.has_value());
+  EXPECT_FALSE(limits.memory_limit.has_value());
+}
+#endif  // BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) ||
+        // BUILDFLAG(IS_ANDROID)
+
 #if BUILDFLAG(IS_MAC)
 TEST_F(SysInfoTest, NumProcsWithSecurityMitigationEnabled) {
   // Reset state so that the call to SetCpuSecurityMitigationsEnabled() below
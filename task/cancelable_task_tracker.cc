@@ -6,8 +6,10 @@
 
 #include <stddef.h>
 
+#include <limits>
 #include <utility>
 
+#include "base/check_op.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
 #include "base/location.h"
@@ -28,12 +30,77 @@ void RunOrPostToTaskRunner(scoped_refptr<SequencedTaskRunner> task_runner,
     task_runner->PostTask(FROM_HERE, std::move(closure));
 }
 
+// A TaskId has the generation of the slot of the task in its upper 32 bits,
+// and the index of the slot plus one in its lower 32 bits, so that it is never
+// kBadTaskId.
+CancelableTaskTracker::TaskId MakeTaskId(uint32_t index, uint32_t generation) {
+  return static_cast<CancelableTaskTracker::TaskId>(
+      (uint64_t{generation} << 32) | (uint64_t{index} + 1));
+}
+
+uint32_t GetSlotIndex(CancelableTaskTracker::TaskId id) {
+  return static_cast<uint32_t>(static_cast<uint64_t>(id)) - 1;
+}
+
+uint32_t GetSlotGeneration(CancelableTaskTracker::TaskId id) {
+  return static_cast<uint32_t>(static_cast<uint64_t>(id) >> 32);
+}
+
 }  // namespace
 
+// The slots are allocated by chunks that are never moved, so that the tasks
+// can refer to them while the table grows. Only the sequence of the tracker
+// accesses the table itself.
+class CancelableTaskTracker::SlotTable
+    : public RefCountedThreadSafe<SlotTable> {
+ public:
+  static constexpr size_t kSlotsPerChunk = 64;
+
+  SlotTable() = default;
+  SlotTable(const SlotTable&) = delete;
+  SlotTable& operator=(const SlotTable&) = delete;
+
+  size_t size() const { return chunks_.size() * kSlotsPerChunk; }
+
+  // Adds |kSlotsPerChunk| slots, with an even generation.
+  void Grow() {
+    CHECK_LT(size() + kSlotsPerChunk, std::numeric_limits<uint32_t>::max());
+    chunks_.push_back(
+        std::make_unique<std::atomic<uint32_t>[]>(kSlotsPerChunk));
+  }
+
+  std::atomic<uint32_t>& generation(size_t index) {
+    DCHECK_LT(index, size());
+    return chunks_[index / kSlotsPerChunk][index % kSlotsPerChunk];
+  }
+
+ private:
+  friend class RefCountedThreadSafe<SlotTable>;
+  ~SlotTable() = default;
+
+  std::vector<std::unique_ptr<std::atomic<uint32_t>[]>> chunks_;
+};
+
+CancelableTaskTracker::TaskHandle::TaskHandle(
+    scoped_refptr<SlotTable> table,
+    const std::atomic<uint32_t>* generation,
+    uint32_t expected_generation)
+    : table_(std::move(table)),
+      generation_(generation),
+      expected_generation_(expected_generation) {}
+
+CancelableTaskTracker::TaskHandle::TaskHandle(const TaskHandle&) = default;
+
+CancelableTaskTracker::TaskHandle& CancelableTaskTracker::TaskHandle::operator=(
+    const TaskHandle&) = default;
+
+CancelableTaskTracker::TaskHandle::~TaskHandle() = default;
+
 // static
 const CancelableTaskTracker::TaskId CancelableTaskTracker::kBadTaskId = 0;
 
-CancelableTaskTracker::CancelableTaskTracker() {
+CancelableTaskTracker::CancelableTaskTracker()
+    : slots_(MakeRefCounted<SlotTable>()) {
   weak_this_ = weak_factory_.GetWeakPtr();
 }
 
@@ -64,24 +131,20 @@ CancelableTaskTracker::TaskId CancelableTaskTracker::PostTaskAndReply(
   // We need a SequencedTaskRunner::CurrentDefaultHandle to run |reply|.
   DCHECK(SequencedTaskRunner::HasCurrentDefault());
 
-  auto flag = MakeRefCounted<TaskCancellationFlag>();
+  TaskId id = kBadTaskId;
+  TaskHandle handle = Track(&id);
 
-  TaskId id = next_id_;
-  next_id_++;  // int64_t is big enough that we ignore the potential overflow.
-
-  // Unretained(this) is safe because |flag| will have been set to the
-  // "canceled" state after |this| is deleted.
-  OnceClosure untrack_closure =
-      BindOnce(&CancelableTaskTracker::Untrack, Unretained(this), id);
+  // Unretained(this) is safe because |handle| will have been canceled after
+  // |this| is deleted.
   bool success = task_runner->PostTaskAndReply(
-      from_here, BindOnce(&RunIfNotCanceled, flag, std::move(task)),
-      BindOnce(&RunThenUntrackIfNotCanceled, flag, std::move(reply),
-               std::move(untrack_closure)));
+      from_here, BindOnce(&RunIfNotCanceled, handle, std::move(task)),
+      BindOnce(&RunThenUntrackIfNotCanceled, handle, std::move(reply),
+               Unretained(this), id));
 
-  if (!success)
+  if (!success) {
+    Untrack(id);
     return kBadTaskId;
-
-  Track(id, std::move(flag));
+  }
   return id;
 }
 
@@ -90,32 +153,32 @@ CancelableTaskTracker::TaskId CancelableTaskTracker::NewTrackedTaskId(
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   DCHECK(SequencedTaskRunner::HasCurrentDefault());
 
-  TaskId id = next_id_;
-  next_id_++;  // int64_t is big enough that we ignore the potential overflow.
+  TaskId id = kBadTaskId;
+  TaskHandle handle = Track(&id);
 
-  auto flag = MakeRefCounted<TaskCancellationFlag>();
-
-  // Unretained(this) is safe because |flag| will have been set to the
-  // "canceled" state after |this| is deleted.
+  // Unretained(this) is safe because |handle| will have been canceled after
+  // |this| is deleted.
   OnceClosure untrack_closure =
       BindOnce(&CancelableTaskTracker::Untrack, Unretained(this), id);
 
   // Will always run |untrack_closure| on current sequence.
-  ScopedClosureRunner untrack_runner(
-      BindOnce(&RunOrPostToTaskRunner, SequencedTaskRunner::GetCurrentDefault(),
-               BindOnce(&RunIfNotCanceled, flag, std::move(untrack_closure))));
+  ScopedClosureRunner untrack_runner(BindOnce(
+      &RunOrPostToTaskRunner, SequencedTaskRunner::GetCurrentDefault(),
+      BindOnce(&RunIfNotCanceled, handle, std::move(untrack_closure))));
 
-  *is_canceled_cb = BindRepeating(&IsCanceled, flag, std::move(untrack_runner));
+  *is_canceled_cb =
+      BindRepeating(&IsCanceled, handle, std::move(untrack_runner));
 
-  Track(id, std::move(flag));
   return id;
 }
 
 void CancelableTaskTracker::TryCancel(TaskId id) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const auto it = task_flags_.find(id);
-  if (it == task_flags_.end()) {
+  const uint32_t index = GetSlotIndex(id);
+  if (index >= slots_->size() ||
+      slots_->generation(index).load(std::memory_order_relaxed) !=
+          GetSlotGeneration(id)) {
     // Two possibilities:
     //
     //   1. The task has already been untracked.
@@ -124,65 +187,103 @@ void CancelableTaskTracker::TryCancel(TaskId id) {
     // Since this function is best-effort, it's OK to ignore these.
     return;
   }
-  it->second->data.Set();
 
-  // Remove |id| from |task_flags_| immediately, since we have no further
-  // use for tracking it. This allows the reply closures (see
-  // PostTaskAndReply()) for cancelled tasks to be skipped, since they have
-  // no clean-up to perform.
-  task_flags_.erase(it);
+  // Release the slot immediately, since we have no further use for tracking
+  // the task. This allows the reply closures (see PostTaskAndReply()) for
+  // cancelled tasks to be skipped, since they have no clean-up to perform.
+  ReleaseSlot(index);
 }
 
 void CancelableTaskTracker::TryCancelAll() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  for (const auto& it : task_flags_)
-    it.second->data.Set();
-  task_flags_.clear();
+  // A single pass over the table, which is as large as the maximum number of
+  // tasks tracked at once.
+  for (size_t index = 0; num_tracked_tasks_ > 0 && index < slots_->size();
+       ++index) {
+    if (slots_->generation(index).load(std::memory_order_relaxed) & 1) {
+      ReleaseSlot(static_cast<uint32_t>(index));
+    }
+  }
 }
 
 bool CancelableTaskTracker::HasTrackedTasks() const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  return !task_flags_.empty();
+  return num_tracked_tasks_ > 0;
 }
 
 // static
-void CancelableTaskTracker::RunIfNotCanceled(
-    const scoped_refptr<TaskCancellationFlag>& flag,
-    OnceClosure task) {
-  if (!flag->data.IsSet()) {
+void CancelableTaskTracker::RunIfNotCanceled(const TaskHandle& handle,
+                                             OnceClosure task) {
+  if (!handle.IsCanceled()) {
     std::move(task).Run();
   }
 }
 
 // static
 void CancelableTaskTracker::RunThenUntrackIfNotCanceled(
-    const scoped_refptr<TaskCancellationFlag>& flag,
+    const TaskHandle& handle,
     OnceClosure task,
-    OnceClosure untrack) {
-  RunIfNotCanceled(flag, std::move(task));
-  RunIfNotCanceled(flag, std::move(untrack));
+    CancelableTaskTracker* tracker,
+    TaskId id) {
+  RunIfNotCanceled(handle, std::move(task));
+  if (!handle.IsCanceled()) {
+    tracker->Untrack(id);
+  }
 }
 
 // static
 bool CancelableTaskTracker::IsCanceled(
-    const scoped_refptr<TaskCancellationFlag>& flag,
+    const TaskHandle& handle,
     const ScopedClosureRunner& cleanup_runner) {
-  return flag->data.IsSet();
+  return handle.IsCanceled();
 }
 
-void CancelableTaskTracker::Track(TaskId id,
-                                  scoped_refptr<TaskCancellationFlag> flag) {
+CancelableTaskTracker::TaskHandle CancelableTaskTracker::Track(TaskId* id) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   CHECK(weak_this_);
-  bool success = task_flags_.insert(std::make_pair(id, std::move(flag))).second;
-  DCHECK(success);
+  if (free_slots_.empty()) {
+    const size_t old_size = slots_->size();
+    slots_->Grow();
+    // In decreasing order, so that the lowest indices are used first.
+    for (size_t index = slots_->size(); index > old_size; --index) {
+      free_slots_.push_back(static_cast<uint32_t>(index - 1));
+    }
+  }
+  const uint32_t index = free_slots_.back();
+  free_slots_.pop_back();
+
+  // Only this sequence modifies the generations. The tasks get the new one
+  // through PostTask(), which synchronizes.
+  std::atomic<uint32_t>& generation = slots_->generation(index);
+  const uint32_t tracked_generation =
+      generation.load(std::memory_order_relaxed) + 1;
+  DCHECK(tracked_generation & 1);
+  generation.store(tracked_generation, std::memory_order_relaxed);
+  ++num_tracked_tasks_;
+
+  *id = MakeTaskId(index, tracked_generation);
+  return TaskHandle(slots_, &generation, tracked_generation);
 }
 
 void CancelableTaskTracker::Untrack(TaskId id) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   CHECK(weak_this_);
-  size_t num = task_flags_.erase(id);
-  DCHECK_EQ(1u, num);
+  const uint32_t index = GetSlotIndex(id);
+  DCHECK_EQ(slots_->generation(index).load(std::memory_order_relaxed),
+            GetSlotGeneration(id));
+  ReleaseSlot(index);
+}
+
+void CancelableTaskTracker::ReleaseSlot(uint32_t index) {
+  std::atomic<uint32_t>& generation = slots_->generation(index);
+  const uint32_t released_generation =
+      generation.load(std::memory_order_relaxed) + 1;
+  DCHECK(!(released_generation & 1));
+  // Pairs with the acquire load of TaskHandle::IsCanceled(), so that a task
+  // which sees the cancelation also sees what happened before.
+  generation.store(released_generation, std::memory_order_release);
+  free_slots_.push_back(index);
+  --num_tracked_tasks_;
 }
 
 }  // namespace base
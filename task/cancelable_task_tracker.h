@@ -38,18 +38,19 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/base_export.h"
-#include "base/containers/small_map.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/functional/callback_helpers.h"
+#include "base/memory/raw_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
-#include "base/synchronization/atomic_flag.h"
 #include "base/task/post_task_and_reply_with_result_internal.h"
 
 namespace base {
@@ -126,32 +127,62 @@ class BASE_EXPORT CancelableTaskTracker {
   bool HasTrackedTasks() const;
 
  private:
-  // Cancellation flags are ref-counted to ensure they remain valid even if the
+  // The tracked tasks are slots of a dense table, indexed by the TaskId. Each
+  // slot has a generation, which is odd while the slot tracks a task and is
+  // incremented when the task is canceled or untracked. The tasks posted to
+  // other sequences check that the generation of their slot is still theirs,
+  // so that tracking, cancelation and completion need no lock and, once the
+  // table has grown to the number of outstanding tasks, no allocation.
+  //
+  // The table is ref-counted to ensure that the slots remain valid even if the
   // tracker and its calling thread are torn down while there are still
   // cancelable tasks queued to the target TaskRunner.
   // See https://crbug.com/918948.
-  using TaskCancellationFlag = RefCountedData<AtomicFlag>;
-
-  static void RunIfNotCanceled(const scoped_refptr<TaskCancellationFlag>& flag,
-                               OnceClosure task);
-  static void RunThenUntrackIfNotCanceled(
-      const scoped_refptr<TaskCancellationFlag>& flag,
-      OnceClosure task,
-      OnceClosure untrack);
-  static bool IsCanceled(const scoped_refptr<TaskCancellationFlag>& flag,
+  class SlotTable;
+
+  // Refers to the slot of a tracked task. Can be copied and used on any
+  // sequence.
+  class TaskHandle {
+   public:
+    TaskHandle(scoped_refptr<SlotTable> table,
+               const std::atomic<uint32_t>* generation,
+               uint32_t expected_generation);
+    TaskHandle(const TaskHandle&);
+    TaskHandle& operator=(const TaskHandle&);
+    ~TaskHandle();
+
+    bool IsCanceled() const {
+      return generation_->load(std::memory_order_acquire) !=
+             expected_generation_;
+    }
+
+   private:
+    // Keeps |generation_| alive.
+    scoped_refptr<SlotTable> table_;
+    raw_ptr<const std::atomic<uint32_t>> generation_;
+    uint32_t expected_generation_;
+  };
+
+  static void RunIfNotCanceled(const TaskHandle& handle, OnceClosure task);
+  static void RunThenUntrackIfNotCanceled(const TaskHandle& handle,
+                                          OnceClosure task,
+                                          CancelableTaskTracker* tracker,
+                                          TaskId id);
+  static bool IsCanceled(const TaskHandle& handle,
                          const ScopedClosureRunner& cleanup_runner);
 
-  void Track(TaskId id, scoped_refptr<TaskCancellationFlag> flag);
+  // Starts tracking a new task, whose id is returned in |*id|.
+  TaskHandle Track(TaskId* id);
   void Untrack(TaskId id);
 
-  // Typically the number of tasks are 0-2 and occationally 3-4. But since
-  // this is a general API that could be used in unexpected ways, use a
-  // small_map instead of a flat_map to avoid falling over if there are many
-  // tasks.
-  small_map<std::map<TaskId, scoped_refptr<TaskCancellationFlag>>, 4>
-      task_flags_;
+  // Stops tracking the task of slot |index|, which cancels it.
+  void ReleaseSlot(uint32_t index);
+
+  const scoped_refptr<SlotTable> slots_;
+  // Indices of the slots of |slots_| which don't track a task.
+  std::vector<uint32_t> free_slots_;
+  size_t num_tracked_tasks_ = 0;
 
-  TaskId next_id_ = 1;
   SEQUENCE_CHECKER(sequence_checker_);
 
   // TODO(crbug.com/40050290): Remove once crasher is resolved.
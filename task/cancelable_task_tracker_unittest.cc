@@ -4,8 +4,10 @@
 
 #include "base/task/cancelable_task_tracker.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <tuple>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/functional/bind.h"
@@ -291,6 +293,67 @@ TEST_F(CancelableTaskTrackerTest, HasTrackedTasksIsCancelledCancelAll) {
   EXPECT_FALSE(task_tracker_.HasTrackedTasks());
 }
 
+// Cancel a task whose slot was reused by a later task. The later task should
+// run.
+TEST_F(CancelableTaskTrackerTest, CancelStaleTaskId) {
+  scoped_refptr<TestSimpleTaskRunner> test_task_runner(
+      new TestSimpleTaskRunner());
+
+  CancelableTaskTracker::TaskId first_task_id = task_tracker_.PostTask(
+      test_task_runner.get(), FROM_HERE, MakeExpectedNotRunClosure(FROM_HERE));
+  task_tracker_.TryCancel(first_task_id);
+
+  CancelableTaskTracker::TaskId second_task_id = task_tracker_.PostTask(
+      test_task_runner.get(), FROM_HERE, MakeExpectedRunClosure(FROM_HERE));
+  EXPECT_NE(CancelableTaskTracker::kBadTaskId, second_task_id);
+  EXPECT_NE(first_task_id, second_task_id);
+
+  task_tracker_.TryCancel(first_task_id);
+  EXPECT_TRUE(task_tracker_.HasTrackedTasks());
+
+  test_task_runner->RunUntilIdle();
+  RunLoop().RunUntilIdle();
+  EXPECT_FALSE(task_tracker_.HasTrackedTasks());
+}
+
+// Post many tasks, run some of them, then cancel all of them. Only the tasks
+// that ran before TryCancelAll() should have run.
+TEST_F(CancelableTaskTrackerTest, CancelAllManyTasks) {
+  constexpr int kNumTasks = 200;
+  scoped_refptr<TestSimpleTaskRunner> test_task_runner(
+      new TestSimpleTaskRunner());
+
+  int num_tasks_run = 0;
+  int num_replies_run = 0;
+  std::vector<CancelableTaskTracker::TaskId> task_ids;
+  for (int i = 0; i < kNumTasks; ++i) {
+    task_ids.push_back(task_tracker_.PostTaskAndReply(
+        test_task_runner.get(), FROM_HERE,
+        BindLambdaForTesting([&] { ++num_tasks_run; }),
+        BindLambdaForTesting([&] { ++num_replies_run; })));
+  }
+  std::sort(task_ids.begin(), task_ids.end());
+  EXPECT_EQ(std::adjacent_find(task_ids.begin(), task_ids.end()),
+            task_ids.end());
+
+  test_task_runner->RunPendingTasks();
+  RunLoop().RunUntilIdle();
+  EXPECT_EQ(kNumTasks, num_tasks_run);
+  EXPECT_EQ(kNumTasks, num_replies_run);
+  EXPECT_FALSE(task_tracker_.HasTrackedTasks());
+
+  for (int i = 0; i < kNumTasks; ++i) {
+    std::ignore = task_tracker_.PostTaskAndReply(
+        test_task_runner.get(), FROM_HERE, MakeExpectedNotRunClosure(FROM_HERE),
+        MakeExpectedNotRunClosure(FROM_HERE));
+  }
+  task_tracker_.TryCancelAll();
+  EXPECT_FALSE(task_tracker_.HasTrackedTasks());
+
+  test_task_runner->RunUntilIdle();
+  RunLoop().RunUntilIdle();
+}
+
 // The death tests below make sure that calling task tracker member
 // functions from a thread different from its owner thread DCHECKs in
 // debug mode.
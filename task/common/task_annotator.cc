@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <string_view>
 
 #include "base/auto_reset.h"
@@ -19,6 +20,7 @@
 #include "base/logging.h"
 #include "base/metrics/metrics_hashes.h"
 #include "base/ranges/algorithm.h"
+#include "base/task/common/task_cpu_time_tracker.h"
 #include "base/time/time.h"
 #include "base/trace_event/base_tracing.h"
 #include "base/tracing_buildflags.h"
@@ -70,7 +72,39 @@ TaskAnnotator::LongTaskTracker* GetCurrentLongTaskTracker() {
   return current_long_task_tracker;
 }
 
+// One in |g_flow_chain_sampling_interval| chains of tasks is traced.
+std::atomic<uint32_t> g_flow_chain_sampling_interval{1};
+
+// The id of the next chain of tasks, whether traced or not.
+std::atomic<uint64_t> g_next_flow_chain_id{1};
+
 #if BUILDFLAG(ENABLE_BASE_TRACING)
+bool IsFlowChainTraced(uint64_t flow_chain_id) {
+  return flow_chain_id != TaskMetadata::kNoFlowChain &&
+         flow_chain_id != TaskMetadata::kSkippedFlowChain;
+}
+
+// Sets the flow chain of |task|: the chain of |parent_task| if there's one,
+// otherwise a new chain which is sampled for tracing.
+void SetFlowChain(const PendingTask* parent_task, TaskMetadata& task) {
+  static const uint8_t* flow_enabled =
+      TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED("toplevel.flow");
+  if (!*flow_enabled) {
+    return;
+  }
+  if (parent_task && parent_task->flow_chain_id != TaskMetadata::kNoFlowChain) {
+    task.flow_chain_id = parent_task->flow_chain_id;
+    return;
+  }
+  const uint64_t flow_chain_id =
+      g_next_flow_chain_id.fetch_add(1, std::memory_order_relaxed);
+  const uint32_t interval =
+      g_flow_chain_sampling_interval.load(std::memory_order_relaxed);
+  task.flow_chain_id = flow_chain_id % interval == 0
+                           ? flow_chain_id
+                           : TaskMetadata::kSkippedFlowChain;
+}
+
 perfetto::protos::pbzero::ChromeTaskAnnotator::DelayPolicy ToProtoEnum(
     subtle::DelayPolicy type) {
   using ProtoType = perfetto::protos::pbzero::ChromeTaskAnnotator::DelayPolicy;
@@ -116,15 +150,29 @@ void TaskAnnotator::MarkCurrentTaskAsInterestingForTracing() {
   tracker->is_interesting_task = true;
 }
 
+// static
+void TaskAnnotator::SetFlowChainSamplingInterval(uint32_t interval) {
+  DCHECK_GT(interval, 0u);
+  g_flow_chain_sampling_interval.store(interval, std::memory_order_relaxed);
+}
+
 TaskAnnotator::TaskAnnotator() = default;
 TaskAnnotator::~TaskAnnotator() = default;
 
 void TaskAnnotator::WillQueueTask(perfetto::StaticString trace_event_name,
                                   TaskMetadata* pending_task) {
   DCHECK(pending_task);
-  TRACE_EVENT_INSTANT(
-      "toplevel.flow", trace_event_name,
-      perfetto::Flow::ProcessScoped(GetTaskTraceID(*pending_task)));
+  const auto* parent_task = CurrentTaskForThread();
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  SetFlowChain(parent_task, *pending_task);
+  if (IsFlowChainTraced(pending_task->flow_chain_id)) {
+    TRACE_EVENT_INSTANT(
+        "toplevel.flow", trace_event_name,
+        perfetto::Flow::ProcessScoped(GetTaskTraceID(*pending_task)),
+        "chain_id", pending_task->flow_chain_id);
+  }
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
 
   DCHECK(!pending_task->task_backtrace[0])
       << "Task backtrace was already set, task posted twice??";
@@ -139,7 +187,6 @@ void TaskAnnotator::WillQueueTask(perfetto::StaticString trace_event_name,
     pending_task->ipc_hash = hash->GetIpcHash();
   }
 
-  const auto* parent_task = CurrentTaskForThread();
   if (!parent_task)
     return;
 
@@ -200,7 +247,14 @@ void TaskAnnotator::RunTaskImpl(PendingTask& pending_task) {
     if (g_task_annotator_observer) {
       g_task_annotator_observer->BeforeRunTask(&pending_task);
     }
-    std::move(pending_task.task).Run();
+    if (TaskCpuTimeTracker::IsEnabled()) [[unlikely]] {
+      const ThreadTicks start_time = ThreadTicks::Now();
+      std::move(pending_task.task).Run();
+      TaskCpuTimeTracker::RecordTask(pending_task.posted_from,
+                                     ThreadTicks::Now() - start_time);
+    } else {
+      std::move(pending_task.task).Run();
+    }
   }
 
   // Stomp the markers. Otherwise they can stick around on the unused parts of
@@ -245,10 +299,11 @@ void TaskAnnotator::MaybeEmitIncomingTaskFlow(perfetto::EventContext& ctx,
                                               const PendingTask& task) const {
   static const uint8_t* flow_enabled =
       TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED("toplevel.flow");
-  if (!*flow_enabled)
+  if (!*flow_enabled || !IsFlowChainTraced(task.flow_chain_id))
     return;
 
   perfetto::Flow::ProcessScoped(GetTaskTraceID(task))(ctx);
+  ctx.AddDebugAnnotation("chain_id", task.flow_chain_id);
 }
 
 // static
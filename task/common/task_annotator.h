@@ -50,6 +50,12 @@ class BASE_EXPORT TaskAnnotator {
 
   static void MarkCurrentTaskAsInterestingForTracing();
 
+  // Traces one in |interval| causal chains of tasks in "toplevel.flow": a task
+  // posted while no traced task is running starts a new chain, which the tasks
+  // that it (transitively) posts belong to. Defaults to 1, i.e. every chain is
+  // traced. Can be called from any thread.
+  static void SetFlowChainSamplingInterval(uint32_t interval);
+
   TaskAnnotator();
 
   TaskAnnotator(const TaskAnnotator&) = delete;
@@ -111,7 +117,8 @@ class BASE_EXPORT TaskAnnotator {
                                       const PendingTask& task);
 
   // TRACE_EVENT argument helper, writing the incoming task flow information
-  // into EventContext if toplevel.flow category is enabled.
+  // into EventContext if toplevel.flow category is enabled and the chain of
+  // |task| is traced.
   void MaybeEmitIncomingTaskFlow(perfetto::EventContext& ctx,
                                  const PendingTask& task) const;
 
@@ -5,12 +5,14 @@
 #include "base/task/common/task_annotator.h"
 
 #include <algorithm>
+#include <array>
 #include <vector>
 
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/functional/callback_helpers.h"
 #include "base/pending_task.h"
+#include "base/ranges/algorithm.h"
 #include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/lock.h"
@@ -19,7 +21,10 @@
 #include "base/task/thread_pool.h"
 #include "base/test/bind.h"
 #include "base/test/task_environment.h"
+#include "base/test/trace_test_utils.h"
 #include "base/threading/thread.h"
+#include "base/trace_event/trace_log.h"
+#include "base/tracing_buildflags.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace base {
@@ -42,6 +47,42 @@ TEST(TaskAnnotatorTest, QueueAndRunTask) {
   EXPECT_EQ(123, result);
 }
 
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+TEST(TaskAnnotatorTest, FlowChainSampling) {
+  test::TracingEnvironment tracing_environment;
+  trace_event::TraceLog::GetInstance()->SetEnabled(
+      trace_event::TraceConfig("toplevel.flow", ""),
+      trace_event::TraceLog::RECORDING_MODE);
+  TaskAnnotator::SetFlowChainSamplingInterval(2);
+  TaskAnnotator annotator;
+
+  // Of two consecutive chains, one is traced and the other is skipped. The
+  // tasks posted from a task belong to its chain.
+  std::array<uint64_t, 2> chain_ids;
+  for (uint64_t& chain_id : chain_ids) {
+    auto post_child_task = [&] {
+      PendingTask child_task(FROM_HERE, DoNothing());
+      annotator.WillQueueTask("TaskAnnotatorTest::Queue", &child_task);
+      EXPECT_EQ(chain_id, child_task.flow_chain_id);
+    };
+    PendingTask parent_task(FROM_HERE, BindLambdaForTesting(post_child_task));
+    annotator.WillQueueTask("TaskAnnotatorTest::Queue", &parent_task);
+    chain_id = parent_task.flow_chain_id;
+    EXPECT_NE(TaskMetadata::kNoFlowChain, chain_id);
+    annotator.RunTask("TaskAnnotator::RunTask", parent_task);
+  }
+  EXPECT_EQ(1, ranges::count(chain_ids, TaskMetadata::kSkippedFlowChain));
+
+  // Tasks posted while toplevel.flow is disabled don't belong to a chain.
+  trace_event::TraceLog::GetInstance()->SetDisabled();
+  PendingTask pending_task(FROM_HERE, DoNothing());
+  annotator.WillQueueTask("TaskAnnotatorTest::Queue", &pending_task);
+  EXPECT_EQ(TaskMetadata::kNoFlowChain, pending_task.flow_chain_id);
+
+  TaskAnnotator::SetFlowChainSamplingInterval(1);
+}
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+
 // Test task annotator integration in base APIs and ensuing support for
 // backtraces. Tasks posted across multiple threads in this test fixture should
 // be synchronized as BeforeRunTask() and VerifyTraceAndPost() assume tasks are
@@ -0,0 +1,266 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/common/task_cpu_time_tracker.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <utility>
+
+#include "base/check.h"
+#include "base/functional/bind.h"
+#include "base/hash/hash.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace {
+
+// The number of slots probed for a Location before counting its CPU time as
+// untracked.
+constexpr size_t kMaxProbes = 16;
+
+std::atomic<bool> g_enabled{false};
+
+// The aggregated CPU time of the tasks of a Location on a thread.
+struct Slot {
+  // The program counter of `posted_from`, or null if the slot is free. Set
+  // once, after `posted_from` is written.
+  std::atomic<const void*> program_counter{nullptr};
+  Location posted_from;
+
+  // Only written by the thread which owns the table.
+  std::atomic<int64_t> cpu_time_ns{0};
+  std::atomic<uint64_t> num_tasks{0};
+};
+
+struct ThreadTable {
+  std::array<Slot, TaskCpuTimeTracker::kMaxLocationsPerThread> slots;
+  std::atomic<int64_t> untracked_cpu_time_ns{0};
+};
+
+// Adds `value` to an atomic which only the current thread writes to, without
+// the cost of a read-modify-write operation.
+template <typename T>
+void AddRelaxed(std::atomic<T>& atomic, T value) {
+  atomic.store(atomic.load(std::memory_order_relaxed) + value,
+               std::memory_order_relaxed);
+}
+
+class ThreadTables {
+ public:
+  static ThreadTables& Get() {
+    static NoDestructor<ThreadTables> tables;
+    return *tables;
+  }
+
+  // Returns the table of the current thread, assigning one to it if needed.
+  ThreadTable& GetForCurrentThread() {
+    void* table = slot_.Get();
+    if (!table) {
+      table = Acquire();
+      slot_.Set(table);
+    }
+    return *static_cast<ThreadTable*>(table);
+  }
+
+  // Calls `function` on all the tables, including the free ones.
+  template <typename Function>
+  void ForEach(Function function) {
+    AutoLock lock(lock_);
+    for (ThreadTable* table : tables_) {
+      function(*table);
+    }
+  }
+
+ private:
+  friend class NoDestructor<ThreadTables>;
+
+  ThreadTables() : slot_(&OnThreadExit) {}
+  ~ThreadTables() = delete;
+
+  static void OnThreadExit(void* table) {
+    Get().Release(static_cast<ThreadTable*>(table));
+  }
+
+  ThreadTable* Acquire() {
+    AutoLock lock(lock_);
+    if (!free_tables_.empty()) {
+      ThreadTable* table = free_tables_.back();
+      free_tables_.pop_back();
+      return table;
+    }
+    // Tables are never deleted, so that they can be read without
+    // synchronizing with thread exit.
+    tables_.push_back(new ThreadTable());
+    return tables_.back();
+  }
+
+  void Release(ThreadTable* table) {
+    AutoLock lock(lock_);
+    free_tables_.push_back(table);
+  }
+
+  ThreadLocalStorage::Slot slot_;
+  Lock lock_;
+  std::vector<ThreadTable*> tables_ GUARDED_BY(lock_);
+  std::vector<ThreadTable*> free_tables_ GUARDED_BY(lock_);
+};
+
+// Returns the slot of `posted_from` in `table`, claiming a free one if
+// needed, or null if none is available.
+Slot* GetSlot(ThreadTable& table, const Location& posted_from) {
+  const void* program_counter = posted_from.program_counter();
+  if (!program_counter) {
+    return nullptr;
+  }
+  const size_t hash = HashInts(reinterpret_cast<uintptr_t>(program_counter),
+                               uintptr_t{0});
+  for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+    Slot& slot = table.slots[(hash + probe) % table.slots.size()];
+    const void* slot_program_counter =
+        slot.program_counter.load(std::memory_order_relaxed);
+    if (slot_program_counter == program_counter) {
+      return &slot;
+    }
+    if (!slot_program_counter) {
+      slot.posted_from = posted_from;
+      slot.program_counter.store(program_counter, std::memory_order_release);
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the entries of all the threads, by program counter.
+std::map<const void*, TaskCpuTimeTracker::Entry> GetEntries() {
+  std::map<const void*, TaskCpuTimeTracker::Entry> entries;
+  ThreadTables::Get().ForEach([&](const ThreadTable& table) {
+    for (const Slot& slot : table.slots) {
+      const void* program_counter =
+          slot.program_counter.load(std::memory_order_acquire);
+      if (!program_counter) {
+        continue;
+      }
+      TaskCpuTimeTracker::Entry& entry = entries[program_counter];
+      entry.posted_from = slot.posted_from;
+      entry.cpu_time +=
+          Nanoseconds(slot.cpu_time_ns.load(std::memory_order_relaxed));
+      entry.num_tasks += slot.num_tasks.load(std::memory_order_relaxed);
+    }
+  });
+  return entries;
+}
+
+void SortByCpuTime(std::vector<TaskCpuTimeTracker::Entry>& entries) {
+  std::sort(entries.begin(), entries.end(),
+            [](const TaskCpuTimeTracker::Entry& lhs,
+               const TaskCpuTimeTracker::Entry& rhs) {
+              return lhs.cpu_time > rhs.cpu_time;
+            });
+}
+
+}  // namespace
+
+TaskCpuTimeTracker::Entry::Entry() = default;
+TaskCpuTimeTracker::Entry::Entry(const Entry&) = default;
+TaskCpuTimeTracker::Entry& TaskCpuTimeTracker::Entry::operator=(
+    const Entry&) = default;
+TaskCpuTimeTracker::Entry::~Entry() = default;
+
+TaskCpuTimeTracker::PeriodicDumper::PeriodicDumper(TimeDelta interval,
+                                                   DumpCallback callback)
+    : callback_(std::move(callback)), previous_entries_(GetEntries()) {
+  timer_.Start(FROM_HERE, interval,
+               BindRepeating(&PeriodicDumper::Dump, Unretained(this)));
+}
+
+TaskCpuTimeTracker::PeriodicDumper::~PeriodicDumper() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void TaskCpuTimeTracker::PeriodicDumper::Dump() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::map<const void*, Entry> entries = GetEntries();
+  std::vector<Entry> deltas;
+  for (const auto& [program_counter, entry] : entries) {
+    Entry delta = entry;
+    const auto previous = previous_entries_.find(program_counter);
+    if (previous != previous_entries_.end()) {
+      delta.cpu_time -= previous->second.cpu_time;
+      delta.num_tasks -= previous->second.num_tasks;
+    }
+    if (delta.num_tasks > 0) {
+      deltas.push_back(delta);
+    }
+  }
+  previous_entries_ = std::move(entries);
+  SortByCpuTime(deltas);
+  callback_.Run(std::move(deltas));
+}
+
+// static
+void TaskCpuTimeTracker::SetEnabled(bool enabled) {
+  g_enabled.store(enabled && ThreadTicks::IsSupported(),
+                  std::memory_order_relaxed);
+}
+
+// static
+bool TaskCpuTimeTracker::IsEnabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+// static
+void TaskCpuTimeTracker::RecordTask(const Location& posted_from,
+                                    TimeDelta cpu_time) {
+  ThreadTable& table = ThreadTables::Get().GetForCurrentThread();
+  const int64_t cpu_time_ns = cpu_time.InNanoseconds();
+  if (Slot* slot = GetSlot(table, posted_from)) {
+    AddRelaxed(slot->cpu_time_ns, cpu_time_ns);
+    AddRelaxed(slot->num_tasks, uint64_t{1});
+  } else {
+    AddRelaxed(table.untracked_cpu_time_ns, cpu_time_ns);
+  }
+}
+
+// static
+std::vector<TaskCpuTimeTracker::Entry> TaskCpuTimeTracker::GetSnapshot() {
+  std::vector<Entry> snapshot;
+  for (auto& [program_counter, entry] : GetEntries()) {
+    if (entry.num_tasks > 0) {
+      snapshot.push_back(std::move(entry));
+    }
+  }
+  SortByCpuTime(snapshot);
+  return snapshot;
+}
+
+// static
+TimeDelta TaskCpuTimeTracker::GetUntrackedCpuTime() {
+  TimeDelta untracked_cpu_time;
+  ThreadTables::Get().ForEach([&](const ThreadTable& table) {
+    untracked_cpu_time += Nanoseconds(
+        table.untracked_cpu_time_ns.load(std::memory_order_relaxed));
+  });
+  return untracked_cpu_time;
+}
+
+// static
+void TaskCpuTimeTracker::ResetForTesting() {
+  ThreadTables::Get().ForEach([](ThreadTable& table) {
+    for (Slot& slot : table.slots) {
+      slot.program_counter.store(nullptr, std::memory_order_relaxed);
+      slot.posted_from = Location();
+      slot.cpu_time_ns.store(0, std::memory_order_relaxed);
+      slot.num_tasks.store(0, std::memory_order_relaxed);
+    }
+    table.untracked_cpu_time_ns.store(0, std::memory_order_relaxed);
+  });
+}
+
+}  // namespace base
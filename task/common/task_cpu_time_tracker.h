@@ -0,0 +1,102 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_COMMON_TASK_CPU_TIME_TRACKER_H_
+#define BASE_TASK_COMMON_TASK_CPU_TIME_TRACKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/functional/callback.h"
+#include "base/location.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace base {
+
+// Attributes the CPU time of the tasks run by TaskAnnotator to the Location
+// they were posted from, when enabled. This gives the CPU usage of features
+// in a multithreaded process without tracing.
+//
+// Each thread aggregates the ThreadTicks of its tasks in its own table, which
+// it alone writes to, so that recording a task takes no lock. Tables can be
+// read concurrently by GetSnapshot() from any thread. The tables of exited
+// threads are kept, and reused by new threads.
+class BASE_EXPORT TaskCpuTimeTracker {
+ public:
+  // The aggregated CPU time of the tasks posted from a Location.
+  struct BASE_EXPORT Entry {
+    Entry();
+    Entry(const Entry&);
+    Entry& operator=(const Entry&);
+    ~Entry();
+
+    Location posted_from;
+    TimeDelta cpu_time;
+    uint64_t num_tasks = 0;
+  };
+
+  // Calls a callback periodically with the CPU time of the tasks run since
+  // the previous call. Must be used on a sequence which runs tasks.
+  class BASE_EXPORT PeriodicDumper {
+   public:
+    using DumpCallback = RepeatingCallback<void(std::vector<Entry>)>;
+
+    // Calls `callback` on the current sequence every `interval`, with the
+    // entries which changed since the previous call, or since construction,
+    // most CPU time first.
+    PeriodicDumper(TimeDelta interval, DumpCallback callback);
+    PeriodicDumper(const PeriodicDumper&) = delete;
+    PeriodicDumper& operator=(const PeriodicDumper&) = delete;
+    ~PeriodicDumper();
+
+   private:
+    void Dump();
+
+    SEQUENCE_CHECKER(sequence_checker_);
+    const DumpCallback callback_;
+    // The previous snapshot, by program counter of the posting Location.
+    std::map<const void*, Entry> previous_entries_
+        GUARDED_BY_CONTEXT(sequence_checker_);
+    RepeatingTimer timer_;
+  };
+
+  // The maximum number of Locations tracked on each thread. The CPU time of
+  // tasks from other Locations is only counted in GetUntrackedCpuTime().
+  static constexpr size_t kMaxLocationsPerThread = 256;
+
+  TaskCpuTimeTracker() = delete;
+
+  // Enables or disables the tracking of the tasks which start running
+  // afterwards. Tracking stays disabled where ThreadTicks aren't supported.
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled();
+
+  // Records that a task posted from `posted_from` ran for `cpu_time` on the
+  // current thread. Called by TaskAnnotator when enabled.
+  static void RecordTask(const Location& posted_from, TimeDelta cpu_time);
+
+  // Returns the CPU time of the tasks run on all threads since tracking was
+  // first enabled, by posting Location, most CPU time first. This can be
+  // called from any thread, concurrently with tasks being recorded.
+  static std::vector<Entry> GetSnapshot();
+
+  // Returns the CPU time of the tasks which couldn't be attributed, because
+  // their thread tracked kMaxLocationsPerThread Locations already, or because
+  // their Location is unknown.
+  static TimeDelta GetUntrackedCpuTime();
+
+  // Drops all the recorded times. Must not be called concurrently with tasks
+  // being recorded.
+  static void ResetForTesting();
+};
+
+}  // namespace base
+
+#endif  // BASE_TASK_COMMON_TASK_CPU_TIME_TRACKER_H_
@@ -0,0 +1,143 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/common/task_cpu_time_tracker.h"
+
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/pending_task.h"
+#include "base/task/common/task_annotator.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+void BusyLoop(TimeDelta cpu_time) {
+  const ThreadTicks end_time = ThreadTicks::Now() + cpu_time;
+  while (ThreadTicks::Now() < end_time) {
+  }
+}
+
+class TaskCpuTimeTrackerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    if (!ThreadTicks::IsSupported()) {
+      GTEST_SKIP() << "ThreadTicks aren't supported";
+    }
+    TaskCpuTimeTracker::ResetForTesting();
+    TaskCpuTimeTracker::SetEnabled(true);
+  }
+
+  void TearDown() override {
+    TaskCpuTimeTracker::SetEnabled(false);
+    TaskCpuTimeTracker::ResetForTesting();
+  }
+
+  // Runs a task which uses `cpu_time`, posted from `posted_from`.
+  void RunTask(const Location& posted_from, TimeDelta cpu_time) {
+    PendingTask pending_task(posted_from, BindOnce(&BusyLoop, cpu_time));
+    TaskAnnotator annotator;
+    annotator.WillQueueTask("TaskCpuTimeTrackerTest::RunTask", &pending_task);
+    annotator.RunTask("TaskCpuTimeTrackerTest::RunTask", pending_task);
+  }
+
+  const TaskCpuTimeTracker::Entry* FindEntry(
+      const std::vector<TaskCpuTimeTracker::Entry>& entries,
+      const Location& posted_from) {
+    for (const TaskCpuTimeTracker::Entry& entry : entries) {
+      if (entry.posted_from == posted_from) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+};
+
+}  // namespace
+
+TEST_F(TaskCpuTimeTrackerTest, AttributesCpuTimeToPostingLocation) {
+  const Location heavy_location = FROM_HERE;
+  const Location light_location = FROM_HERE;
+  RunTask(heavy_location, Milliseconds(20));
+  RunTask(heavy_location, Milliseconds(20));
+  RunTask(light_location, Milliseconds(1));
+
+  const std::vector<TaskCpuTimeTracker::Entry> snapshot =
+      TaskCpuTimeTracker::GetSnapshot();
+  ASSERT_EQ(2u, snapshot.size());
+  EXPECT_EQ(heavy_location, snapshot[0].posted_from);
+  EXPECT_EQ(2u, snapshot[0].num_tasks);
+  EXPECT_GE(snapshot[0].cpu_time, Milliseconds(40));
+  EXPECT_EQ(light_location, snapshot[1].posted_from);
+  EXPECT_EQ(1u, snapshot[1].num_tasks);
+  EXPECT_GE(snapshot[1].cpu_time, Milliseconds(1));
+  EXPECT_TRUE(TaskCpuTimeTracker::GetUntrackedCpuTime().is_zero());
+}
+
+TEST_F(TaskCpuTimeTrackerTest, Disabled) {
+  TaskCpuTimeTracker::SetEnabled(false);
+  RunTask(FROM_HERE, Milliseconds(1));
+  EXPECT_TRUE(TaskCpuTimeTracker::GetSnapshot().empty());
+}
+
+TEST_F(TaskCpuTimeTrackerTest, AggregatesThreads) {
+  const Location location = FROM_HERE;
+  RunTask(location, Milliseconds(1));
+
+  // The table of the thread outlives it.
+  Thread thread("TaskCpuTimeTrackerTest");
+  ASSERT_TRUE(thread.Start());
+  thread.task_runner()->PostTask(
+      FROM_HERE,
+      BindLambdaForTesting([&] { RunTask(location, Milliseconds(1)); }));
+  thread.Stop();
+
+  const TaskCpuTimeTracker::Entry* entry =
+      FindEntry(TaskCpuTimeTracker::GetSnapshot(), location);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(2u, entry->num_tasks);
+  EXPECT_GE(entry->cpu_time, Milliseconds(2));
+}
+
+TEST_F(TaskCpuTimeTrackerTest, UntrackedCpuTime) {
+  RunTask(Location(), Milliseconds(1));
+  EXPECT_TRUE(TaskCpuTimeTracker::GetSnapshot().empty());
+  EXPECT_GE(TaskCpuTimeTracker::GetUntrackedCpuTime(), Milliseconds(1));
+}
+
+TEST_F(TaskCpuTimeTrackerTest, PeriodicDumper) {
+  test::TaskEnvironment task_environment(
+      test::TaskEnvironment::TimeSource::MOCK_TIME);
+  const Location location = FROM_HERE;
+  RunTask(location, Milliseconds(1));
+
+  std::vector<std::vector<TaskCpuTimeTracker::Entry>> dumps;
+  TaskCpuTimeTracker::PeriodicDumper dumper(
+      Seconds(1), BindLambdaForTesting(
+                      [&](std::vector<TaskCpuTimeTracker::Entry> entries) {
+                        dumps.push_back(std::move(entries));
+                      }));
+
+  // Tasks run before the dumper was created aren't dumped.
+  RunTask(location, Milliseconds(1));
+  task_environment.FastForwardBy(Seconds(1));
+  ASSERT_EQ(1u, dumps.size());
+  const TaskCpuTimeTracker::Entry* entry = FindEntry(dumps[0], location);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(1u, entry->num_tasks);
+
+  // Locations without new tasks aren't dumped.
+  task_environment.FastForwardBy(Seconds(1));
+  ASSERT_EQ(2u, dumps.size());
+  EXPECT_FALSE(FindEntry(dumps[1], location));
+}
+
+}  // namespace base
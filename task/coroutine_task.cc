@@ -0,0 +1,183 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/coroutine_task.h"
+
+#include <stdlib.h>
+
+#include <array>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "base/compiler_specific.h"
+#include "base/no_destructor.h"
+#include "base/threading/thread_local.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Frames are pooled by size class, rounded up to |kFrameSizeGranularity|.
+// Larger frames aren't pooled.
+constexpr size_t kFrameSizeGranularity = 64;
+constexpr size_t kMaxPooledFrameSize = 1024;
+constexpr size_t kNumFrameSizeClasses =
+    kMaxPooledFrameSize / kFrameSizeGranularity;
+
+// Max number of free frames kept per size class and thread.
+constexpr size_t kMaxPooledFramesPerSizeClass = 16;
+
+size_t GetFrameSizeClass(size_t size) {
+  return (size + kFrameSizeGranularity - 1) / kFrameSizeGranularity - 1;
+}
+
+class CoroutineFramePool {
+ public:
+  CoroutineFramePool() = default;
+  CoroutineFramePool(const CoroutineFramePool&) = delete;
+  CoroutineFramePool& operator=(const CoroutineFramePool&) = delete;
+
+  ~CoroutineFramePool() {
+    for (FreeFrame* frame : free_frames_) {
+      while (frame) {
+        free(std::exchange(frame, frame->next));
+      }
+    }
+  }
+
+  // Returns a frame of size class |size_class|, or nullptr if none is free.
+  void* Take(size_t size_class) {
+    FreeFrame* frame = free_frames_[size_class];
+    if (!frame) {
+      return nullptr;
+    }
+    free_frames_[size_class] = frame->next;
+    --num_free_frames_[size_class];
+    --num_frames_;
+    return frame;
+  }
+
+  // Keeps |frame| of size class |size_class| for reuse. Returns false if the
+  // pool is full.
+  bool Give(void* frame, size_t size_class) {
+    if (num_free_frames_[size_class] == kMaxPooledFramesPerSizeClass) {
+      return false;
+    }
+    free_frames_[size_class] =
+        new (frame) FreeFrame{free_frames_[size_class]};
+    ++num_free_frames_[size_class];
+    ++num_frames_;
+    return true;
+  }
+
+  size_t num_frames() const { return num_frames_; }
+
+ private:
+  struct FreeFrame {
+    FreeFrame* next;
+  };
+
+  std::array<FreeFrame*, kNumFrameSizeClasses> free_frames_{};
+  std::array<size_t, kNumFrameSizeClasses> num_free_frames_{};
+  size_t num_frames_ = 0;
+};
+
+CoroutineFramePool& GetCoroutineFramePool() {
+  static NoDestructor<ThreadLocalOwnedPointer<CoroutineFramePool>> pool;
+  if (!pool->Get()) [[unlikely]] {
+    pool->Set(std::make_unique<CoroutineFramePool>());
+  }
+  return **pool;
+}
+
+void DestroyCoroutine(std::coroutine_handle<> handle) {
+  handle.destroy();
+}
+
+}  // namespace
+
+void* AllocateCoroutineFrame(size_t size) {
+  if (size <= kMaxPooledFrameSize) {
+    const size_t size_class = GetFrameSizeClass(size);
+    if (void* frame = GetCoroutineFramePool().Take(size_class)) {
+      return frame;
+    }
+    // Allocate the whole size class so that the frame can be reused for any
+    // size in it.
+    size = (size_class + 1) * kFrameSizeGranularity;
+  }
+  void* frame = malloc(size);
+  CHECK(frame);
+  return frame;
+}
+
+void FreeCoroutineFrame(void* frame, size_t size) {
+  if (size <= kMaxPooledFrameSize &&
+      GetCoroutineFramePool().Give(frame, GetFrameSizeClass(size))) {
+    return;
+  }
+  free(frame);
+}
+
+size_t GetNumPooledCoroutineFramesForTesting() {
+  return GetCoroutineFramePool().num_frames();
+}
+
+CoroutinePromiseBase::CoroutinePromiseBase() = default;
+
+CoroutinePromiseBase::~CoroutinePromiseBase() = default;
+
+CoroutineResumer::CoroutineResumer(std::coroutine_handle<> handle,
+                                   const CoroutinePromiseBase& promise)
+    : handle_(handle),
+      root_(promise.root()),
+      task_runner_(promise.task_runner()) {
+  DCHECK(handle_);
+  DCHECK(root_);
+  DCHECK(task_runner_);
+}
+
+CoroutineResumer::CoroutineResumer(CoroutineResumer&& other)
+    : handle_(std::exchange(other.handle_, nullptr)),
+      root_(std::exchange(other.root_, nullptr)),
+      task_runner_(std::move(other.task_runner_)) {}
+
+CoroutineResumer::~CoroutineResumer() {
+  if (!handle_) {
+    return;
+  }
+  // Always post, since this may be destroyed while the coroutine is being
+  // suspended.
+  task_runner_->PostTask(FROM_HERE, BindOnce(&DestroyCoroutine, root_));
+}
+
+void CoroutineResumer::Resume() && {
+  if (task_runner_->RunsTasksInCurrentSequence()) {
+    std::exchange(handle_, nullptr).resume();
+    return;
+  }
+  std::move(*this).PostResume(FROM_HERE);
+}
+
+void CoroutineResumer::PostResume(const Location& from_here) && {
+  scoped_refptr<SequencedTaskRunner> task_runner = task_runner_;
+  task_runner->PostTask(from_here,
+                        BindOnce(&CoroutineResumer::ResumeNow,
+                                 std::move(*this)));
+}
+
+void CoroutineResumer::Release() {
+  handle_ = nullptr;
+}
+
+// static
+void CoroutineResumer::ResumeNow(CoroutineResumer resumer) {
+  DCHECK(resumer.task_runner_->RunsTasksInCurrentSequence());
+  std::exchange(resumer.handle_, nullptr).resume();
+}
+
+}  // namespace internal
+}  // namespace base
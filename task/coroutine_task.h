@@ -0,0 +1,440 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_COROUTINE_TASK_H_
+#define BASE_TASK_COROUTINE_TASK_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "base/base_export.h"
+#include "base/check.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
+#include "base/location.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/notreached.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/task_traits.h"
+#include "base/task/thread_pool.h"
+
+// CoroutineTask<T> is the return type of a C++20 coroutine that runs on a
+// SequencedTaskRunner and produces a T. It replaces chains of
+// PostTaskAndReplyWithResult() and nested callbacks with straight-line code:
+//
+//   CoroutineTask<int> CountWords(FilePath path) {
+//     std::string text = co_await AwaitThreadPool(
+//         FROM_HERE, {MayBlock()}, BindOnce(&ReadFile, path));
+//     co_return co_await CountWordsOnSequence(std::move(text));
+//   }
+//
+//   CountWords(path).Start(FROM_HERE, task_runner,
+//                          BindOnce(&OnWordsCounted));
+//
+// A CoroutineTask doesn't run until it's either started with Start(), which
+// posts a single task to run it on |task_runner|, or awaited by another
+// CoroutineTask, which runs it inline on the awaiting coroutine's sequence.
+// Every co_await resumes the coroutine on that sequence: awaiting another
+// CoroutineTask resumes without posting a task, and awaiting a callback or the
+// thread pool posts a single task to come back only if the result is produced
+// on another sequence.
+//
+// Coroutine frames are allocated from a per-thread pool of recycled blocks, so
+// that short coroutines running on the same threads don't hit the allocator.
+//
+// If a coroutine can't be resumed because the callback it awaits is destroyed
+// without being run, the coroutine is destroyed on its sequence, along with
+// the coroutines that await it. As with DeleteSoon(), it is leaked if its
+// sequence no longer runs tasks.
+
+namespace base {
+
+template <typename T = void>
+class CoroutineTask;
+
+namespace internal {
+
+// Allocates and frees coroutine frames from a per-thread pool.
+BASE_EXPORT void* AllocateCoroutineFrame(size_t size);
+BASE_EXPORT void FreeCoroutineFrame(void* frame, size_t size);
+
+// Returns the number of frames currently cached in the pool of the current
+// thread. Exposed for testing.
+BASE_EXPORT size_t GetNumPooledCoroutineFramesForTesting();
+
+class BASE_EXPORT CoroutinePromiseBase {
+ public:
+  CoroutinePromiseBase();
+  CoroutinePromiseBase(const CoroutinePromiseBase&) = delete;
+  CoroutinePromiseBase& operator=(const CoroutinePromiseBase&) = delete;
+  ~CoroutinePromiseBase();
+
+  static void* operator new(size_t size) {
+    return AllocateCoroutineFrame(size);
+  }
+  static void operator delete(void* frame, size_t size) {
+    FreeCoroutineFrame(frame, size);
+  }
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  void unhandled_exception() noexcept { NOTREACHED(); }
+
+  // Binds this coroutine to the sequence of |task_runner|. |root| is the
+  // outermost coroutine of the chain of awaiting coroutines, destroying it
+  // destroys this coroutine.
+  void Bind(scoped_refptr<SequencedTaskRunner> task_runner,
+            std::coroutine_handle<> root) {
+    DCHECK(!task_runner_);
+    task_runner_ = std::move(task_runner);
+    root_ = root;
+  }
+
+  const scoped_refptr<SequencedTaskRunner>& task_runner() const {
+    return task_runner_;
+  }
+  std::coroutine_handle<> root() const { return root_; }
+
+  // The coroutine to resume when this one returns, if it's awaited.
+  std::coroutine_handle<> continuation;
+
+ private:
+  scoped_refptr<SequencedTaskRunner> task_runner_;
+  std::coroutine_handle<> root_;
+};
+
+// Resumes a suspended coroutine on its sequence. If destroyed without being
+// used, destroys the chain of coroutines the suspended coroutine belongs to on
+// its sequence.
+class BASE_EXPORT CoroutineResumer {
+ public:
+  template <typename Promise>
+  explicit CoroutineResumer(std::coroutine_handle<Promise> handle)
+      : CoroutineResumer(handle, handle.promise()) {}
+  CoroutineResumer(CoroutineResumer&& other);
+  CoroutineResumer& operator=(CoroutineResumer&&) = delete;
+  ~CoroutineResumer();
+
+  // Resumes the coroutine, inline if called on its sequence or from a posted
+  // task otherwise.
+  void Resume() &&;
+
+  // Posts a task to resume the coroutine on its sequence.
+  void PostResume(const Location& from_here) &&;
+
+  // Gives up on the coroutine without resuming or destroying it, e.g. because
+  // it didn't suspend.
+  void Release();
+
+ private:
+  CoroutineResumer(std::coroutine_handle<> handle,
+                   const CoroutinePromiseBase& promise);
+
+  static void ResumeNow(CoroutineResumer resumer);
+
+  std::coroutine_handle<> handle_;
+  std::coroutine_handle<> root_;
+  scoped_refptr<SequencedTaskRunner> task_runner_;
+};
+
+template <typename Promise>
+CoroutinePromiseBase& GetPromiseBase(std::coroutine_handle<Promise> handle) {
+  static_assert(std::is_base_of_v<CoroutinePromiseBase, Promise>,
+                "Can only be awaited from a CoroutineTask.");
+  return handle.promise();
+}
+
+template <typename T>
+struct CoroutineResultCallbackType {
+  using Type = OnceCallback<void(T)>;
+};
+
+template <>
+struct CoroutineResultCallbackType<void> {
+  using Type = OnceClosure;
+};
+
+template <typename T>
+using CoroutineResultCallback = typename CoroutineResultCallbackType<T>::Type;
+
+// Storage for the result of a coroutine or of an awaited operation.
+template <typename T>
+class CoroutineResult {
+ public:
+  void Set(T value) { value_.emplace(std::move(value)); }
+  T Take() {
+    DCHECK(value_);
+    return std::move(*value_);
+  }
+  void Run(OnceCallback<void(T)> callback) {
+    std::move(callback).Run(Take());
+  }
+
+ private:
+  std::optional<T> value_;
+};
+
+template <>
+class CoroutineResult<void> {
+ public:
+  void Set() {}
+  void Take() {}
+  void Run(OnceClosure callback) { std::move(callback).Run(); }
+};
+
+template <typename T>
+class CoroutinePromise;
+
+template <typename T>
+class CoroutinePromiseWithResult : public CoroutinePromiseBase {
+ public:
+  void return_value(T value) { result.Set(std::move(value)); }
+
+  CoroutineResult<T> result;
+};
+
+template <>
+class CoroutinePromiseWithResult<void> : public CoroutinePromiseBase {
+ public:
+  void return_void() {}
+
+  CoroutineResult<void> result;
+};
+
+template <typename T>
+class CoroutinePromise : public CoroutinePromiseWithResult<T> {
+ public:
+  class FinalAwaiter {
+   public:
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<CoroutinePromise> handle) noexcept {
+      CoroutinePromise& promise = handle.promise();
+      if (promise.continuation) {
+        // The awaiting coroutine destroys this one once it's resumed.
+        return promise.continuation;
+      }
+      // This is the root of the chain: report the result and self-destroy.
+      CoroutineResult<T> result = std::move(promise.result);
+      CoroutineResultCallback<T> on_done = std::move(promise.on_done);
+      handle.destroy();
+      if (on_done) {
+        result.Run(std::move(on_done));
+      }
+      return std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+  };
+
+  CoroutineTask<T> get_return_object() {
+    return CoroutineTask<T>(
+        std::coroutine_handle<CoroutinePromise>::from_promise(*this));
+  }
+  FinalAwaiter final_suspend() noexcept { return {}; }
+
+  // Run with the result of a started coroutine.
+  CoroutineResultCallback<T> on_done;
+};
+
+// Awaits the result of a callback passed to |starter|.
+template <typename R, typename Starter>
+class CallbackAwaiter {
+ public:
+  explicit CallbackAwaiter(Starter starter) : starter_(std::move(starter)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  template <typename Promise>
+  bool await_suspend(std::coroutine_handle<Promise> handle) {
+    GetPromiseBase(handle);
+    if constexpr (std::is_void_v<R>) {
+      std::move(starter_)(BindOnce(&CallbackAwaiter::OnDone, Unretained(this),
+                                   CoroutineResumer(handle)));
+    } else {
+      std::move(starter_)(BindOnce(&CallbackAwaiter::OnResult<R>,
+                                   Unretained(this), CoroutineResumer(handle)));
+    }
+    // Don't suspend if the callback already ran.
+    return state_.exchange(State::kSuspended, std::memory_order_acq_rel) !=
+           State::kDone;
+  }
+
+  R await_resume() { return result_.Take(); }
+
+ private:
+  enum class State { kStarting, kSuspended, kDone };
+
+  template <typename U>
+  void OnResult(CoroutineResumer resumer, U result) {
+    result_.Set(std::move(result));
+    OnDone(std::move(resumer));
+  }
+
+  void OnDone(CoroutineResumer resumer) {
+    if (state_.exchange(State::kDone, std::memory_order_acq_rel) ==
+        State::kStarting) {
+      // Run from |starter_|: await_suspend() won't suspend.
+      resumer.Release();
+      return;
+    }
+    std::move(resumer).Resume();
+  }
+
+  Starter starter_;
+  std::atomic<State> state_{State::kStarting};
+  CoroutineResult<R> result_;
+};
+
+// Awaits the result of a task run in the thread pool.
+template <typename R>
+class ThreadPoolAwaiter {
+ public:
+  ThreadPoolAwaiter(const Location& from_here,
+                    const TaskTraits& traits,
+                    OnceCallback<R()> task)
+      : from_here_(from_here), traits_(traits), task_(std::move(task)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  template <typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) {
+    GetPromiseBase(handle);
+    ThreadPool::PostTask(
+        from_here_, traits_,
+        BindOnce(&ThreadPoolAwaiter::Run, Unretained(this), std::move(task_),
+                 CoroutineResumer(handle)));
+  }
+
+  R await_resume() { return result_.Take(); }
+
+ private:
+  void Run(OnceCallback<R()> task, CoroutineResumer resumer) {
+    if constexpr (std::is_void_v<R>) {
+      std::move(task).Run();
+    } else {
+      result_.Set(std::move(task).Run());
+    }
+    std::move(resumer).PostResume(from_here_);
+  }
+
+  const Location from_here_;
+  const TaskTraits traits_;
+  OnceCallback<R()> task_;
+  CoroutineResult<R> result_;
+};
+
+// Awaits a CoroutineTask<T>.
+template <typename T>
+class CoroutineTaskAwaiter {
+ public:
+  explicit CoroutineTaskAwaiter(
+      std::coroutine_handle<CoroutinePromise<T>> handle)
+      : handle_(handle) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  template <typename Promise>
+  std::coroutine_handle<> await_suspend(
+      std::coroutine_handle<Promise> awaiting) noexcept {
+    const CoroutinePromiseBase& awaiting_promise = GetPromiseBase(awaiting);
+    handle_.promise().Bind(awaiting_promise.task_runner(),
+                           awaiting_promise.root());
+    handle_.promise().continuation = awaiting;
+    return handle_;
+  }
+
+  T await_resume() { return handle_.promise().result.Take(); }
+
+ private:
+  // Owned by the awaited CoroutineTask, which outlives the co_await
+  // expression.
+  std::coroutine_handle<CoroutinePromise<T>> handle_;
+};
+
+}  // namespace internal
+
+template <typename T>
+class [[nodiscard]] CoroutineTask {
+ public:
+  using promise_type = internal::CoroutinePromise<T>;
+  using ResultCallback = internal::CoroutineResultCallback<T>;
+
+  CoroutineTask(CoroutineTask&& other)
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  CoroutineTask& operator=(CoroutineTask&& other) {
+    if (this != &other) {
+      Reset();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  ~CoroutineTask() { Reset(); }
+
+  // Posts a task to run the coroutine on |task_runner|. |on_done| is run with
+  // the result on the sequence of |task_runner|, unless the coroutine is
+  // destroyed before returning.
+  void Start(const Location& from_here,
+             scoped_refptr<SequencedTaskRunner> task_runner,
+             ResultCallback on_done = ResultCallback()) && {
+    DCHECK(handle_);
+    std::coroutine_handle<promise_type> handle =
+        std::exchange(handle_, nullptr);
+    handle.promise().Bind(std::move(task_runner), handle);
+    handle.promise().on_done = std::move(on_done);
+    internal::CoroutineResumer(handle).PostResume(from_here);
+  }
+
+  // Runs the coroutine inline on the sequence of the awaiting coroutine, which
+  // is resumed without posting a task once it returns.
+  auto operator co_await() && noexcept {
+    DCHECK(handle_);
+    return internal::CoroutineTaskAwaiter<T>(handle_);
+  }
+
+ private:
+  friend class internal::CoroutinePromise<T>;
+
+  explicit CoroutineTask(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {}
+
+  void Reset() {
+    if (handle_) {
+      std::exchange(handle_, nullptr).destroy();
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// Returns an awaitable that calls |starter| with a callback and resumes the
+// awaiting CoroutineTask with the value that the callback is run with, e.g.
+//
+//   int value = co_await AwaitCallback<int>(
+//       [&](OnceCallback<void(int)> callback) {
+//         GetValueAsync(std::move(callback));
+//       });
+//
+// The callback may be run on any sequence, including synchronously from
+// |starter|, in which case the coroutine doesn't suspend.
+template <typename R, typename Starter>
+auto AwaitCallback(Starter starter) {
+  return internal::CallbackAwaiter<R, Starter>(std::move(starter));
+}
+
+// Returns an awaitable that runs |task| in the thread pool with |traits| and
+// resumes the awaiting CoroutineTask on its sequence with the result.
+template <typename R>
+auto AwaitThreadPool(const Location& from_here,
+                     const TaskTraits& traits,
+                     OnceCallback<R()> task) {
+  return internal::ThreadPoolAwaiter<R>(from_here, traits, std::move(task));
+}
+
+}  // namespace base
+
+#endif  // BASE_TASK_COROUTINE_TASK_H_
@@ -0,0 +1,175 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/coroutine_task.h"
+
+#include <string>
+#include <utility>
+
+#include "base/functional/callback_helpers.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_future.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+CoroutineTask<int> ReturnValue(int value) {
+  co_return value;
+}
+
+CoroutineTask<int> AddValues(int a, int b) {
+  const int sum = co_await ReturnValue(a) + co_await ReturnValue(b);
+  co_return sum;
+}
+
+CoroutineTask<std::string> Stringify(int a, int b) {
+  co_return NumberToString(co_await AddValues(a, b));
+}
+
+class CoroutineTaskTest : public testing::Test {
+ protected:
+  test::TaskEnvironment task_environment_;
+  const scoped_refptr<SequencedTaskRunner> task_runner_ =
+      ThreadPool::CreateSequencedTaskRunner({});
+};
+
+}  // namespace
+
+TEST_F(CoroutineTaskTest, ReturnValue) {
+  test::TestFuture<int> future;
+  ReturnValue(42).Start(FROM_HERE, task_runner_, future.GetCallback());
+  EXPECT_EQ(42, future.Get());
+}
+
+TEST_F(CoroutineTaskTest, ReturnVoid) {
+  auto coroutine = [](bool& ran) -> CoroutineTask<> {
+    ran = true;
+    co_return;
+  };
+  bool ran = false;
+  test::TestFuture<void> future;
+  coroutine(ran).Start(FROM_HERE, task_runner_, future.GetCallback());
+  EXPECT_TRUE(future.Wait());
+  EXPECT_TRUE(ran);
+}
+
+// Awaited coroutines run inline on the sequence of the awaiting coroutine.
+TEST_F(CoroutineTaskTest, AwaitCoroutineTask) {
+  test::TestFuture<std::string> future;
+  Stringify(40, 2).Start(FROM_HERE, task_runner_, future.GetCallback());
+  EXPECT_EQ("42", future.Get());
+}
+
+TEST_F(CoroutineTaskTest, DestroyedWithoutStarting) {
+  auto coroutine = [](ScopedClosureRunner) -> CoroutineTask<> {
+    ADD_FAILURE();
+    co_return;
+  };
+  bool destroyed = false;
+  {
+    CoroutineTask<> task = coroutine(
+        ScopedClosureRunner(BindLambdaForTesting([&] { destroyed = true; })));
+    EXPECT_FALSE(destroyed);
+  }
+  EXPECT_TRUE(destroyed);
+}
+
+// A callback run synchronously doesn't suspend the coroutine.
+TEST_F(CoroutineTaskTest, AwaitCallbackRunSynchronously) {
+  auto coroutine =
+      [](scoped_refptr<SequencedTaskRunner> task_runner) -> CoroutineTask<int> {
+    const int value = co_await AwaitCallback<int>(
+        [](OnceCallback<void(int)> callback) { std::move(callback).Run(42); });
+    EXPECT_TRUE(task_runner->RunsTasksInCurrentSequence());
+    co_return value;
+  };
+  test::TestFuture<int> future;
+  coroutine(task_runner_).Start(FROM_HERE, task_runner_, future.GetCallback());
+  EXPECT_EQ(42, future.Get());
+}
+
+// A callback run on another sequence resumes the coroutine on its sequence.
+TEST_F(CoroutineTaskTest, AwaitCallbackRunOnAnotherSequence) {
+  auto coroutine =
+      [](scoped_refptr<SequencedTaskRunner> task_runner) -> CoroutineTask<> {
+    co_await AwaitCallback<void>([](OnceClosure callback) {
+      ThreadPool::PostTask(FROM_HERE, std::move(callback));
+    });
+    EXPECT_TRUE(task_runner->RunsTasksInCurrentSequence());
+  };
+  test::TestFuture<void> future;
+  coroutine(task_runner_).Start(FROM_HERE, task_runner_, future.GetCallback());
+  EXPECT_TRUE(future.Wait());
+}
+
+TEST_F(CoroutineTaskTest, AwaitThreadPool) {
+  auto coroutine =
+      [](scoped_refptr<SequencedTaskRunner> task_runner) -> CoroutineTask<int> {
+    const int value = co_await AwaitThreadPool(
+        FROM_HERE, {},
+        BindOnce(
+            [](scoped_refptr<SequencedTaskRunner> task_runner) {
+              EXPECT_FALSE(task_runner->RunsTasksInCurrentSequence());
+              return 42;
+            },
+            task_runner));
+    EXPECT_TRUE(task_runner->RunsTasksInCurrentSequence());
+    co_return value + co_await ReturnValue(1);
+  };
+  test::TestFuture<int> future;
+  coroutine(task_runner_).Start(FROM_HERE, task_runner_, future.GetCallback());
+  EXPECT_EQ(43, future.Get());
+}
+
+// A coroutine awaiting a callback that is destroyed without being run is
+// destroyed, along with the coroutines that await it.
+TEST_F(CoroutineTaskTest, AwaitDestroyedCallback) {
+  auto inner = [](ScopedClosureRunner) -> CoroutineTask<int> {
+    co_return co_await AwaitCallback<int>([](OnceCallback<void(int)>) {});
+  };
+  auto outer = [](CoroutineTask<int> inner,
+                  ScopedClosureRunner) -> CoroutineTask<int> {
+    co_return co_await std::move(inner);
+  };
+  int num_destroyed = 0;
+  RunLoop run_loop;
+  outer(inner(ScopedClosureRunner(
+            BindLambdaForTesting([&] { ++num_destroyed; }))),
+        ScopedClosureRunner(BindLambdaForTesting([&] {
+          ++num_destroyed;
+          run_loop.Quit();
+        })))
+      .Start(FROM_HERE, task_runner_, BindOnce([](int) { ADD_FAILURE(); }));
+  run_loop.Run();
+  EXPECT_EQ(2, num_destroyed);
+}
+
+// Frames of coroutines that returned are reused by the next coroutines.
+TEST_F(CoroutineTaskTest, FramesAreRecycled) {
+  const scoped_refptr<SequencedTaskRunner> task_runner =
+      SequencedTaskRunner::GetCurrentDefault();
+  for (int i = 0; i < 2; ++i) {
+    test::TestFuture<std::string> future;
+    Stringify(1, 2).Start(FROM_HERE, task_runner, future.GetCallback());
+    EXPECT_EQ("3", future.Get());
+  }
+  const size_t num_pooled_frames =
+      internal::GetNumPooledCoroutineFramesForTesting();
+  EXPECT_GT(num_pooled_frames, 0u);
+
+  test::TestFuture<std::string> future;
+  Stringify(1, 2).Start(FROM_HERE, task_runner, future.GetCallback());
+  EXPECT_EQ("3", future.Get());
+  EXPECT_EQ(num_pooled_frames,
+            internal::GetNumPooledCoroutineFramesForTesting());
+}
+
+}  // namespace base
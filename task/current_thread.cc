@@ -239,6 +239,56 @@ bool CurrentIOThread::WatchFileDescriptor(
   return GetMessagePumpForIO()->WatchFileDescriptor(fd, persistent, mode,
                                                     controller, delegate);
 }
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+bool CurrentIOThread::WatchFileDescriptorEdgeTriggered(
+    int fd,
+    bool persistent,
+    MessagePumpForIO::Mode mode,
+    MessagePumpForIO::FdWatchController* controller,
+    MessagePumpForIO::FdWatcher* delegate) {
+  DCHECK(current_->IsBoundToCurrentThread());
+  return GetMessagePumpForIO()->WatchFileDescriptor(
+      fd, persistent, mode, controller, delegate, /*edge_triggered=*/true);
+}
+
+bool CurrentIOThread::SetBusyPoll(TimeDelta duration, uint16_t budget) {
+  DCHECK(current_->IsBoundToCurrentThread());
+  return GetMessagePumpForIO()->SetBusyPoll(duration, budget);
+}
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+bool CurrentIOThread::SupportsCompletionIO() {
+  DCHECK(current_->IsBoundToCurrentThread());
+  return GetMessagePumpForIO()->SupportsCompletionIO();
+}
+
+void CurrentIOThread::ReadAsync(
+    int fd,
+    span<uint8_t> buffer,
+    int64_t offset,
+    MessagePumpForIO::IOCompletionCallback callback) {
+  DCHECK(current_->IsBoundToCurrentThread());
+  GetMessagePumpForIO()->ReadAsync(fd, buffer, offset, std::move(callback));
+}
+
+void CurrentIOThread::WriteAsync(
+    int fd,
+    span<const uint8_t> buffer,
+    int64_t offset,
+    MessagePumpForIO::IOCompletionCallback callback) {
+  DCHECK(current_->IsBoundToCurrentThread());
+  GetMessagePumpForIO()->WriteAsync(fd, buffer, offset, std::move(callback));
+}
+
+void CurrentIOThread::AcceptAsync(
+    int fd,
+    MessagePumpForIO::IOCompletionCallback callback) {
+  DCHECK(current_->IsBoundToCurrentThread());
+  GetMessagePumpForIO()->AcceptAsync(fd, std::move(callback));
+}
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
 #endif  // BUILDFLAG(IS_WIN)
 
 #if BUILDFLAG(IS_MAC) || (BUILDFLAG(IS_IOS) && !BUILDFLAG(CRONET_BUILD))
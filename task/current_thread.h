@@ -11,16 +11,19 @@
 #include "base/base_export.h"
 #include "base/callback_list.h"
 #include "base/check.h"
+#include "base/containers/span.h"
 #include "base/functional/callback_forward.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/message_loop/ios_cronet_buildflags.h"
+#include "base/message_loop/message_pump_buildflags.h"
 #include "base/message_loop/message_pump_for_io.h"
 #include "base/message_loop/message_pump_for_ui.h"
 #include "base/pending_task.h"
 #include "base/task/sequence_manager/task_time_observer.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/task/task_observer.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 
 namespace autofill {
@@ -317,6 +320,31 @@ class BASE_EXPORT CurrentIOThread : public CurrentThread {
                            MessagePumpForIO::Mode mode,
                            MessagePumpForIO::FdWatchController* controller,
                            MessagePumpForIO::FdWatcher* delegate);
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+  // Please see MessagePumpLibevent for definition.
+  bool WatchFileDescriptorEdgeTriggered(
+      int fd,
+      bool persistent,
+      MessagePumpForIO::Mode mode,
+      MessagePumpForIO::FdWatchController* controller,
+      MessagePumpForIO::FdWatcher* delegate);
+  bool SetBusyPoll(TimeDelta duration, uint16_t budget);
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_EPOLL)
+
+#if BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
+  // Please see MessagePumpLibevent for definition.
+  bool SupportsCompletionIO();
+  void ReadAsync(int fd,
+                 span<uint8_t> buffer,
+                 int64_t offset,
+                 MessagePumpForIO::IOCompletionCallback callback);
+  void WriteAsync(int fd,
+                  span<const uint8_t> buffer,
+                  int64_t offset,
+                  MessagePumpForIO::IOCompletionCallback callback);
+  void AcceptAsync(int fd, MessagePumpForIO::IOCompletionCallback callback);
+#endif  // BUILDFLAG(ENABLE_MESSAGE_PUMP_IO_URING)
 #endif  // BUILDFLAG(IS_WIN)
 
 #if BUILDFLAG(IS_MAC) || (BUILDFLAG(IS_IOS) && !BUILDFLAG(CRONET_BUILD))
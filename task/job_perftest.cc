@@ -5,6 +5,7 @@
 #include <stddef.h>
 
 #include <atomic>
+#include <limits>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -13,10 +14,14 @@
 #include "base/containers/stack.h"
 #include "base/functional/callback_helpers.h"
 #include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
 #include "base/task/post_job.h"
+#include "base/task/task_features.h"
 #include "base/task/thread_pool.h"
 #include "base/test/bind.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
+#include "base/threading/platform_thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
 
@@ -34,9 +39,12 @@ namespace {
 // - No-op + disrupted: 10 disruptive tasks are posted every 1ms.
 // - Busy wait: Work items are busy wait for 5us.
 // - Busy wait + disrupted
+// JobPreemptionPerfTest measures the latency of USER_BLOCKING tasks posted
+// while a job occupies all workers, with and without kThreadGroupJobPreemption.
 
 constexpr char kMetricPrefixJob[] = "Job.";
 constexpr char kMetricWorkThroughput[] = "work_throughput";
+constexpr char kMetricUserBlockingLatency[] = "user_blocking_latency";
 constexpr char kStoryNoOpNaive[] = "noop_naive";
 constexpr char kStoryBusyWaitNaive[] = "busy_wait_naive";
 constexpr char kStoryNoOpAtomic[] = "noop_atomic";
@@ -52,10 +60,14 @@ constexpr char kStoryNoOpLoopAroundDisrupted[] = "noop_loop_around_disrupted";
 constexpr char kStoryBusyWaitLoopAround[] = "busy_wait_loop_around";
 constexpr char kStoryBusyWaitLoopAroundDisrupted[] =
     "busy_wait_loop_around_disrupted";
+constexpr char kStoryLatencyUnderLoad[] = "latency_under_load";
+constexpr char kStoryLatencyUnderLoadPreemption[] =
+    "latency_under_load_preemption";
 
 perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
   perf_test::PerfResultReporter reporter(kMetricPrefixJob, story_name);
   reporter.RegisterImportantMetric(kMetricWorkThroughput, "tasks/ms");
+  reporter.RegisterImportantMetric(kMetricUserBlockingLatency, "us");
   return reporter;
 }
 
@@ -402,6 +414,75 @@ class JobPerfTest : public testing::Test {
   test::TaskEnvironment task_environment;
 };
 
+// The param is whether kThreadGroupJobPreemption is enabled. It must be set
+// before the thread pool starts.
+class JobPreemptionPerfTest : public testing::TestWithParam<bool> {
+ public:
+  JobPreemptionPerfTest() {
+    feature_list_.InitWithFeatureState(kThreadGroupJobPreemption, GetParam());
+    task_environment_.emplace();
+  }
+
+  JobPreemptionPerfTest(const JobPreemptionPerfTest&) = delete;
+  JobPreemptionPerfTest& operator=(const JobPreemptionPerfTest&) = delete;
+
+  // Posts |num_tasks| USER_BLOCKING tasks one after the other while a
+  // USER_VISIBLE job that busy waits in chunks of |chunk_duration| occupies
+  // all workers, and reports their average latency.
+  void RunLatencyUnderLoad(const std::string& story_name,
+                           size_t num_tasks,
+                           TimeDelta chunk_duration) {
+    std::atomic_bool done{false};
+    auto handle = PostJob(
+        FROM_HERE, {TaskPriority::USER_VISIBLE},
+        BindRepeating(
+            [](std::atomic_bool* done, TimeDelta chunk_duration,
+               JobDelegate* delegate) {
+              while (!done->load(std::memory_order_relaxed) &&
+                     !delegate->ShouldYield()) {
+                const TimeTicks end_time = TimeTicks::Now() + chunk_duration;
+                while (TimeTicks::Now() < end_time)
+                  ;
+              }
+            },
+            Unretained(&done), chunk_duration),
+        BindRepeating(
+            [](std::atomic_bool* done, size_t /*worker_count*/) -> size_t {
+              return done->load(std::memory_order_relaxed)
+                         ? 0
+                         : std::numeric_limits<size_t>::max();
+            },
+            Unretained(&done)));
+    // Let the job occupy all workers.
+    PlatformThread::Sleep(Milliseconds(10));
+
+    TimeDelta total_latency;
+    for (size_t i = 0; i < num_tasks; ++i) {
+      WaitableEvent ran;
+      TimeTicks run_time;
+      const TimeTicks post_time = TimeTicks::Now();
+      ThreadPool::PostTask(FROM_HERE, {TaskPriority::USER_BLOCKING},
+                           BindLambdaForTesting([&] {
+                             run_time = TimeTicks::Now();
+                             ran.Signal();
+                           }));
+      ran.Wait();
+      total_latency += run_time - post_time;
+      PlatformThread::Sleep(Milliseconds(1));
+    }
+    done.store(true, std::memory_order_relaxed);
+    handle.Join();
+
+    auto reporter = SetUpReporter(story_name);
+    reporter.AddResult(kMetricUserBlockingLatency,
+                       size_t((total_latency / num_tasks).InMicroseconds()));
+  }
+
+ private:
+  test::ScopedFeatureList feature_list_;
+  std::optional<test::TaskEnvironment> task_environment_;
+};
+
 }  // namespace
 
 TEST_F(JobPerfTest, NoOpWorkNaiveAssignment) {
@@ -474,4 +555,12 @@ TEST_F(JobPerfTest, BusyWaitDisruptedWorkLoopAround) {
                        std::move(callback), true);
 }
 
+TEST_P(JobPreemptionPerfTest, LatencyUnderLoad) {
+  RunLatencyUnderLoad(
+      GetParam() ? kStoryLatencyUnderLoadPreemption : kStoryLatencyUnderLoad,
+      200, Microseconds(500));
+}
+
+INSTANTIATE_TEST_SUITE_P(All, JobPreemptionPerfTest, testing::Bool());
+
 }  // namespace base
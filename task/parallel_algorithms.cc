@@ -0,0 +1,117 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/parallel_algorithms.h"
+
+#include <atomic>
+
+#include "base/functional/bind.h"
+#include "base/system/sys_info.h"
+#include "base/task/post_job.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Number of chunks per processor when the grain size is picked automatically,
+// so that workers that run slower than others still get their share of work.
+constexpr size_t kChunksPerProcessor = 4;
+
+// Minimum number of elements per chunk when the grain size is picked
+// automatically, to amortize the cost of claiming a chunk.
+constexpr size_t kMinAutomaticGrainSize = 256;
+
+// Chunks of a RunChunksInParallel() call, claimed by workers in order.
+class ChunkQueue {
+ public:
+  ChunkQueue(
+      size_t size,
+      size_t grain_size,
+      FunctionRef<void(size_t chunk_index, size_t begin, size_t end)> run_chunk)
+      : size_(size),
+        grain_size_(grain_size),
+        num_chunks_((size + grain_size - 1) / grain_size),
+        run_chunk_(run_chunk) {}
+
+  ChunkQueue(const ChunkQueue&) = delete;
+  ChunkQueue& operator=(const ChunkQueue&) = delete;
+
+  size_t num_chunks() const { return num_chunks_; }
+
+  // Worker task: runs chunks until none is left or |delegate| asks to yield.
+  void RunChunks(JobDelegate* delegate) {
+    do {
+      const size_t chunk_index =
+          next_chunk_index_.fetch_add(1, std::memory_order_relaxed);
+      if (chunk_index >= num_chunks_) {
+        return;
+      }
+      RunChunk(chunk_index);
+    } while (!delegate->ShouldYield());
+  }
+
+  void RunChunk(size_t chunk_index) {
+    const size_t begin = chunk_index * grain_size_;
+    run_chunk_(chunk_index, begin, std::min(begin + grain_size_, size_));
+  }
+
+  // Max concurrency callback: the number of chunks that weren't claimed yet.
+  size_t GetMaxConcurrency(size_t /*worker_count*/) const {
+    const size_t next_chunk_index =
+        next_chunk_index_.load(std::memory_order_relaxed);
+    return next_chunk_index >= num_chunks_ ? 0
+                                           : num_chunks_ - next_chunk_index;
+  }
+
+ private:
+  const size_t size_;
+  const size_t grain_size_;
+  const size_t num_chunks_;
+  const FunctionRef<void(size_t chunk_index, size_t begin, size_t end)>
+      run_chunk_;
+  std::atomic<size_t> next_chunk_index_{0};
+};
+
+}  // namespace
+
+size_t GetParallelGrainSize(size_t size, const ParallelOptions& options) {
+  if (options.grain_size) {
+    return options.grain_size;
+  }
+  if (options.deterministic_reduction) {
+    return kDeterministicReductionGrainSize;
+  }
+  const size_t num_chunks =
+      static_cast<size_t>(SysInfo::NumberOfProcessors()) * kChunksPerProcessor;
+  return std::max((size + num_chunks - 1) / num_chunks,
+                  kMinAutomaticGrainSize);
+}
+
+void RunChunksInParallel(
+    const Location& from_here,
+    const TaskTraits& traits,
+    size_t size,
+    size_t grain_size,
+    FunctionRef<void(size_t chunk_index, size_t begin, size_t end)> run_chunk) {
+  DCHECK_GT(grain_size, 0u);
+  ChunkQueue chunk_queue(size, grain_size, run_chunk);
+  // Avoid the cost of a job when there's no parallelism to gain.
+  if (chunk_queue.num_chunks() <= 1) {
+    if (chunk_queue.num_chunks() == 1) {
+      chunk_queue.RunChunk(0);
+    }
+    return;
+  }
+  // |chunk_queue| outlives the job, since Join() returns once all workers
+  // returned and no chunk is left.
+  CreateJob(from_here, traits,
+            BindRepeating(&ChunkQueue::RunChunks, Unretained(&chunk_queue)),
+            BindRepeating(&ChunkQueue::GetMaxConcurrency,
+                          Unretained(&chunk_queue)))
+      .Join();
+}
+
+}  // namespace internal
+}  // namespace base
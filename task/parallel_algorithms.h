@@ -0,0 +1,198 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_PARALLEL_ALGORITHMS_H_
+#define BASE_TASK_PARALLEL_ALGORITHMS_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/check_op.h"
+#include "base/containers/span.h"
+#include "base/functional/function_ref.h"
+#include "base/location.h"
+#include "base/synchronization/lock.h"
+#include "base/task/task_traits.h"
+
+// Parallel versions of common algorithms over spans, built on base::CreateJob()
+// (see post_job.h). The input is split in chunks that workers claim one at a
+// time, so that fast workers process more chunks than slow ones, and the
+// calling thread participates through JobHandle::Join(). All functions return
+// once the whole input is processed.
+//
+// Like the job's worker task, the callables passed to these functions may run
+// concurrently on any thread and must not acquire a lock held while calling
+// into ThreadPool. They must be safe to call concurrently on different
+// elements.
+//
+// Example:
+//   std::vector<float> values = ...;
+//   base::ParallelFor(FROM_HERE, {base::TaskPriority::USER_BLOCKING},
+//                     base::span(values), [](float& value) { value *= 2; });
+//   float sum = base::ParallelReduce(FROM_HERE, {}, base::span(values), 0.f,
+//                                    std::plus<>(),
+//                                    {.deterministic_reduction = true});
+
+namespace base {
+
+struct ParallelOptions {
+  // Number of elements per chunk, or 0 to pick one from the input size and the
+  // number of processors. Chunks should be large enough for their processing
+  // time to dwarf the cost of claiming one (an atomic increment).
+  size_t grain_size = 0;
+
+  // ParallelReduce() only. If true, partial results are combined in the order
+  // of the input, and chunks don't depend on the number of processors, so that
+  // the result is the same on every run even if the reduction isn't
+  // associative (e.g. floating-point addition). Otherwise, partial results are
+  // combined in the order in which chunks complete.
+  bool deterministic_reduction = false;
+};
+
+namespace internal {
+
+// Chunk size used by deterministic reductions when none is specified.
+inline constexpr size_t kDeterministicReductionGrainSize = 1024;
+
+// Returns the chunk size to use for an input of |size| elements.
+BASE_EXPORT size_t GetParallelGrainSize(size_t size,
+                                        const ParallelOptions& options);
+
+// Splits [0, |size|) in chunks of |grain_size| elements (the last one may be
+// smaller) and calls |run_chunk| with the index and bounds of each chunk, in
+// parallel. Returns once all chunks ran.
+BASE_EXPORT void RunChunksInParallel(
+    const Location& from_here,
+    const TaskTraits& traits,
+    size_t size,
+    size_t grain_size,
+    FunctionRef<void(size_t chunk_index, size_t begin, size_t end)> run_chunk);
+
+}  // namespace internal
+
+// Calls |function| on each element of |data|, in parallel.
+template <typename T, typename Function>
+void ParallelFor(const Location& from_here,
+                 const TaskTraits& traits,
+                 span<T> data,
+                 Function function,
+                 const ParallelOptions& options = {}) {
+  internal::RunChunksInParallel(
+      from_here, traits, data.size(),
+      internal::GetParallelGrainSize(data.size(), options),
+      [&](size_t /*chunk_index*/, size_t begin, size_t end) {
+        for (T& element : data.subspan(begin, end - begin)) {
+          function(element);
+        }
+      });
+}
+
+// Stores |function(input[i])| in |output[i]| for each element of |input|, in
+// parallel. |input| and |output| must have the same size.
+template <typename In, typename Out, typename Function>
+void ParallelTransform(const Location& from_here,
+                       const TaskTraits& traits,
+                       span<In> input,
+                       span<Out> output,
+                       Function function,
+                       const ParallelOptions& options = {}) {
+  CHECK_EQ(input.size(), output.size());
+  internal::RunChunksInParallel(
+      from_here, traits, input.size(),
+      internal::GetParallelGrainSize(input.size(), options),
+      [&](size_t /*chunk_index*/, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          output[i] = function(input[i]);
+        }
+      });
+}
+
+// Returns the reduction of |init| and the elements of |data| with |reduce|,
+// like std::reduce(). |reduce| is called with two values of type T, each being
+// |init|, an element of |data| or a result of |reduce|. See
+// ParallelOptions::deterministic_reduction for the order of the reduction.
+template <typename T, typename Reduce>
+std::remove_cv_t<T> ParallelReduce(const Location& from_here,
+                                   const TaskTraits& traits,
+                                   span<T> data,
+                                   std::remove_cv_t<T> init,
+                                   Reduce reduce,
+                                   const ParallelOptions& options = {}) {
+  using Value = std::remove_cv_t<T>;
+  const size_t grain_size =
+      internal::GetParallelGrainSize(data.size(), options);
+  auto reduce_chunk = [&](size_t begin, size_t end) {
+    Value partial_result = data[begin];
+    for (size_t i = begin + 1; i < end; ++i) {
+      partial_result = reduce(std::move(partial_result), data[i]);
+    }
+    return partial_result;
+  };
+
+  if (options.deterministic_reduction) {
+    std::vector<std::optional<Value>> partial_results(
+        (data.size() + grain_size - 1) / grain_size);
+    internal::RunChunksInParallel(
+        from_here, traits, data.size(), grain_size,
+        [&](size_t chunk_index, size_t begin, size_t end) {
+          partial_results[chunk_index].emplace(reduce_chunk(begin, end));
+        });
+    Value result = std::move(init);
+    for (std::optional<Value>& partial_result : partial_results) {
+      result = reduce(std::move(result), std::move(*partial_result));
+    }
+    return result;
+  }
+
+  Lock lock;
+  Value result = std::move(init);
+  internal::RunChunksInParallel(
+      from_here, traits, data.size(), grain_size,
+      [&](size_t /*chunk_index*/, size_t begin, size_t end) {
+        Value partial_result = reduce_chunk(begin, end);
+        AutoLock auto_lock(lock);
+        result = reduce(std::move(result), std::move(partial_result));
+      });
+  return result;
+}
+
+// Sorts |data| with |compare|, like std::sort(). Chunks are sorted in parallel,
+// then merged pairwise in parallel rounds; the last rounds have less
+// parallelism, since they merge fewer, larger ranges.
+template <typename T, typename Compare = std::less<>>
+void ParallelSort(const Location& from_here,
+                  const TaskTraits& traits,
+                  span<T> data,
+                  Compare compare = {},
+                  const ParallelOptions& options = {}) {
+  const size_t grain_size =
+      internal::GetParallelGrainSize(data.size(), options);
+  internal::RunChunksInParallel(
+      from_here, traits, data.size(), grain_size,
+      [&](size_t /*chunk_index*/, size_t begin, size_t end) {
+        std::sort(data.begin() + begin, data.begin() + end, compare);
+      });
+  // Each round merges pairs of sorted ranges of |sorted_size| elements.
+  for (size_t sorted_size = grain_size; sorted_size < data.size();
+       sorted_size *= 2) {
+    internal::RunChunksInParallel(
+        from_here, traits, data.size(), sorted_size * 2,
+        [&](size_t /*chunk_index*/, size_t begin, size_t end) {
+          const size_t middle = std::min(begin + sorted_size, end);
+          std::inplace_merge(data.begin() + begin, data.begin() + middle,
+                             data.begin() + end, compare);
+        });
+  }
+}
+
+}  // namespace base
+
+#endif  // BASE_TASK_PARALLEL_ALGORITHMS_H_
@@ -0,0 +1,160 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/parallel_algorithms.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "base/functional/function_ref.h"
+#include "base/rand_util.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+// Each story compares a std algorithm on a single thread ("sequential") with
+// its parallel version ("parallel") on the same input.
+
+constexpr char kMetricPrefixParallelAlgorithms[] = "ParallelAlgorithms.";
+constexpr char kMetricSequentialDuration[] = "sequential_duration";
+constexpr char kMetricParallelDuration[] = "parallel_duration";
+constexpr char kStoryFor[] = "for";
+constexpr char kStoryTransform[] = "transform";
+constexpr char kStoryReduce[] = "reduce";
+constexpr char kStoryReduceDeterministic[] = "reduce_deterministic";
+constexpr char kStorySort[] = "sort";
+
+constexpr size_t kNumElements = 1 << 22;
+
+std::vector<float> MakeRandomVector() {
+  std::vector<float> values(kNumElements);
+  for (float& value : values) {
+    value = static_cast<float>(RandDouble());
+  }
+  return values;
+}
+
+// Moderately expensive per-element work, so that the benchmarks measure more
+// than memory bandwidth.
+float Work(float value) {
+  return std::sqrt(value) * std::sin(value) + std::cos(value);
+}
+
+class ParallelAlgorithmsPerfTest : public testing::Test {
+ public:
+  ParallelAlgorithmsPerfTest() = default;
+
+  ParallelAlgorithmsPerfTest(const ParallelAlgorithmsPerfTest&) = delete;
+  ParallelAlgorithmsPerfTest& operator=(const ParallelAlgorithmsPerfTest&) =
+      delete;
+
+  // Reports the duration of |sequential| and |parallel|.
+  void Run(const std::string& story_name,
+           FunctionRef<void()> sequential,
+           FunctionRef<void()> parallel) {
+    perf_test::PerfResultReporter reporter(kMetricPrefixParallelAlgorithms,
+                                           story_name);
+    reporter.RegisterImportantMetric(kMetricSequentialDuration, "us");
+    reporter.RegisterImportantMetric(kMetricParallelDuration, "us");
+
+    TimeTicks start = TimeTicks::Now();
+    sequential();
+    reporter.AddResult(kMetricSequentialDuration, TimeTicks::Now() - start);
+
+    start = TimeTicks::Now();
+    parallel();
+    reporter.AddResult(kMetricParallelDuration, TimeTicks::Now() - start);
+  }
+
+ private:
+  test::TaskEnvironment task_environment_;
+};
+
+}  // namespace
+
+TEST_F(ParallelAlgorithmsPerfTest, For) {
+  std::vector<float> values = MakeRandomVector();
+  std::vector<float> parallel_values = values;
+  Run(
+      kStoryFor,
+      [&] {
+        std::for_each(values.begin(), values.end(),
+                      [](float& value) { value = Work(value); });
+      },
+      [&] {
+        ParallelFor(FROM_HERE, {TaskPriority::USER_BLOCKING},
+                    span(parallel_values),
+                    [](float& value) { value = Work(value); });
+      });
+  EXPECT_EQ(values, parallel_values);
+}
+
+TEST_F(ParallelAlgorithmsPerfTest, Transform) {
+  const std::vector<float> input = MakeRandomVector();
+  std::vector<float> output(kNumElements);
+  std::vector<float> parallel_output(kNumElements);
+  Run(
+      kStoryTransform,
+      [&] { std::transform(input.begin(), input.end(), output.begin(), Work); },
+      [&] {
+        ParallelTransform(FROM_HERE, {TaskPriority::USER_BLOCKING}, span(input),
+                          span(parallel_output), Work);
+      });
+  EXPECT_EQ(output, parallel_output);
+}
+
+TEST_F(ParallelAlgorithmsPerfTest, Reduce) {
+  const std::vector<float> values = MakeRandomVector();
+  float sum = 0.f;
+  float parallel_sum = 0.f;
+  Run(
+      kStoryReduce,
+      [&] { sum = std::reduce(values.begin(), values.end(), 0.f); },
+      [&] {
+        parallel_sum =
+            ParallelReduce(FROM_HERE, {TaskPriority::USER_BLOCKING},
+                           span(values), 0.f, std::plus<>());
+      });
+  EXPECT_NEAR(sum, parallel_sum, sum * 1e-3);
+}
+
+TEST_F(ParallelAlgorithmsPerfTest, ReduceDeterministic) {
+  const std::vector<float> values = MakeRandomVector();
+  float sum = 0.f;
+  float parallel_sum = 0.f;
+  Run(
+      kStoryReduceDeterministic,
+      [&] { sum = std::reduce(values.begin(), values.end(), 0.f); },
+      [&] {
+        parallel_sum = ParallelReduce(
+            FROM_HERE, {TaskPriority::USER_BLOCKING}, span(values), 0.f,
+            std::plus<>(), {.deterministic_reduction = true});
+      });
+  EXPECT_NEAR(sum, parallel_sum, sum * 1e-3);
+}
+
+TEST_F(ParallelAlgorithmsPerfTest, Sort) {
+  std::vector<float> values = MakeRandomVector();
+  std::vector<float> parallel_values = values;
+  Run(
+      kStorySort, [&] { std::sort(values.begin(), values.end()); },
+      [&] {
+        ParallelSort(FROM_HERE, {TaskPriority::USER_BLOCKING},
+                     span(parallel_values));
+      });
+  EXPECT_EQ(values, parallel_values);
+}
+
+}  // namespace base
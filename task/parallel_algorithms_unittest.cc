@@ -0,0 +1,155 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/parallel_algorithms.h"
+
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+constexpr size_t kNumElements = 100000;
+
+std::vector<int> MakeRandomVector(size_t size) {
+  std::vector<int> values(size);
+  for (int& value : values) {
+    value = RandInt(-1000000, 1000000);
+  }
+  return values;
+}
+
+class ParallelAlgorithmsTest : public testing::Test {
+ protected:
+  test::TaskEnvironment task_environment_;
+};
+
+}  // namespace
+
+TEST_F(ParallelAlgorithmsTest, ParallelFor) {
+  std::vector<int> values(kNumElements);
+  std::iota(values.begin(), values.end(), 0);
+  ParallelFor(FROM_HERE, {}, span(values), [](int& value) { value *= 2; });
+  for (size_t i = 0; i < kNumElements; ++i) {
+    EXPECT_EQ(static_cast<int>(i * 2), values[i]);
+  }
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelForEmptyAndSmall) {
+  std::vector<int> values;
+  ParallelFor(FROM_HERE, {}, span(values), [](int& value) { ADD_FAILURE(); });
+
+  values.push_back(1);
+  ParallelFor(FROM_HERE, {}, span(values), [](int& value) { ++value; });
+  EXPECT_EQ(2, values[0]);
+}
+
+// Each element is visited exactly once when chunks are claimed concurrently by
+// the workers and the calling thread.
+TEST_F(ParallelAlgorithmsTest, ParallelForVisitsEachElementOnce) {
+  std::vector<std::atomic_int> counts(kNumElements);
+  ParallelFor(
+      FROM_HERE, {}, span(counts),
+      [](std::atomic_int& count) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        PlatformThread::YieldCurrentThread();
+      },
+      {.grain_size = 7});
+  for (const std::atomic_int& count : counts) {
+    EXPECT_EQ(1, count.load());
+  }
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelTransform) {
+  std::vector<int> input(kNumElements);
+  std::iota(input.begin(), input.end(), 0);
+  std::vector<std::string> output(kNumElements);
+  ParallelTransform(FROM_HERE, {}, span<const int>(input), span(output),
+                    [](int value) { return NumberToString(value); });
+  for (size_t i = 0; i < kNumElements; ++i) {
+    EXPECT_EQ(NumberToString(i), output[i]);
+  }
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelReduce) {
+  const std::vector<int> random_values = MakeRandomVector(kNumElements);
+  const std::vector<int64_t> values(random_values.begin(),
+                                    random_values.end());
+  const int64_t expected =
+      std::accumulate(values.begin(), values.end(), int64_t{42});
+  EXPECT_EQ(expected, ParallelReduce(FROM_HERE, {}, span(values), int64_t{42},
+                                     std::plus<>()));
+  EXPECT_EQ(expected,
+            ParallelReduce(FROM_HERE, {}, span(values), int64_t{42},
+                           std::plus<>(),
+                           {.grain_size = 3, .deterministic_reduction = true}));
+
+  const std::vector<int64_t> empty;
+  EXPECT_EQ(42, ParallelReduce(FROM_HERE, {}, span(empty), int64_t{42},
+                               std::plus<>()));
+}
+
+// A deterministic reduction of floats matches a sequential reduction of the
+// per-chunk sums, in order.
+TEST_F(ParallelAlgorithmsTest, ParallelReduceDeterministic) {
+  constexpr size_t kGrainSize = 100;
+  std::vector<float> values(kNumElements);
+  for (float& value : values) {
+    value = static_cast<float>(RandDouble());
+  }
+  float expected = 0.f;
+  for (size_t begin = 0; begin < kNumElements; begin += kGrainSize) {
+    expected += std::accumulate(values.begin() + begin + 1,
+                                values.begin() + begin + kGrainSize,
+                                values[begin]);
+  }
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(expected,
+              ParallelReduce(FROM_HERE, {}, span<const float>(values), 0.f,
+                             std::plus<>(),
+                             {.grain_size = kGrainSize,
+                              .deterministic_reduction = true}));
+  }
+}
+
+// The result of a reduction doesn't need to be the element type's identity.
+TEST_F(ParallelAlgorithmsTest, ParallelReduceMax) {
+  std::vector<int> values = MakeRandomVector(kNumElements);
+  values[kNumElements / 3] = 2000000;
+  EXPECT_EQ(2000000,
+            ParallelReduce(FROM_HERE, {}, span(values), -1,
+                           [](int a, int b) { return std::max(a, b); }));
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelSort) {
+  for (size_t grain_size : {size_t{0}, size_t{1}, size_t{1000}, kNumElements}) {
+    std::vector<int> values = MakeRandomVector(kNumElements);
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+    ParallelSort(FROM_HERE, {}, span(values), std::less<>(),
+                 {.grain_size = grain_size});
+    EXPECT_EQ(expected, values);
+  }
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelSortCompare) {
+  std::vector<int> values = MakeRandomVector(kNumElements + 17);
+  std::vector<int> expected = values;
+  std::sort(expected.begin(), expected.end(), std::greater<>());
+  ParallelSort(FROM_HERE, {}, span(values), std::greater<>(),
+               {.grain_size = 333});
+  EXPECT_EQ(expected, values);
+}
+
+}  // namespace base
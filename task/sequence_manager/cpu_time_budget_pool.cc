@@ -0,0 +1,195 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/sequence_manager/cpu_time_budget_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/check_op.h"
+#include "base/containers/contains.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/strings/strcat.h"
+#include "base/task/common/lazy_now.h"
+#include "base/task/sequence_manager/sequence_manager.h"
+#include "base/time/tick_clock.h"
+#include "base/trace_event/base_tracing.h"
+
+namespace base {
+namespace sequence_manager {
+
+CpuTimeBudgetPool::CpuTimeBudgetPool(std::string_view name,
+                                     SequenceManager* sequence_manager,
+                                     TimeDelta budget,
+                                     TimeDelta window)
+    : name_(name),
+      tick_clock_(sequence_manager->GetTickClock()),
+      budget_(budget),
+      replenish_rate_(budget / window),
+      use_thread_ticks_(ThreadTicks::IsSupported()),
+      budget_level_(budget),
+      last_update_time_(tick_clock_->NowTicks()) {
+  DCHECK(budget.is_positive());
+  DCHECK_LE(budget, window);
+}
+
+CpuTimeBudgetPool::~CpuTimeBudgetPool() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  while (!queues_.empty()) {
+    RemoveQueue(queues_.back());
+  }
+}
+
+void CpuTimeBudgetPool::AddQueue(TaskQueue* queue) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK(!Contains(queues_, queue));
+  queues_.push_back(queue);
+  queue->SetThrottler(this);
+  queue->AddTaskObserver(this);
+
+  LazyNow lazy_now(tick_clock_);
+  if (is_throttled()) {
+    queue->InsertFence(TaskQueue::InsertFencePosition::kBeginningOfTime);
+  }
+  queue->UpdateWakeUp(&lazy_now);
+}
+
+void CpuTimeBudgetPool::RemoveQueue(TaskQueue* queue) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  auto it = std::find(queues_.begin(), queues_.end(), queue);
+  CHECK(it != queues_.end());
+  queues_.erase(it);
+  queue->RemoveTaskObserver(this);
+  queue->ResetThrottler();
+
+  LazyNow lazy_now(tick_clock_);
+  if (is_throttled()) {
+    queue->RemoveFence();
+  }
+  queue->UpdateWakeUp(&lazy_now);
+}
+
+void CpuTimeBudgetPool::OnWakeUp(LazyNow* lazy_now) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (!is_throttled()) {
+    return;
+  }
+  UpdateBudgetLevel(lazy_now->Now());
+  if (!budget_level_.is_negative()) {
+    Unthrottle(lazy_now);
+  }
+}
+
+void CpuTimeBudgetPool::OnHasImmediateTask() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  // The queue which got the task isn't known, and only needs a wake-up if it
+  // is throttled.
+  if (is_throttled()) {
+    LazyNow lazy_now(tick_clock_);
+    UpdateWakeUps(&lazy_now);
+  }
+}
+
+std::optional<WakeUp> CpuTimeBudgetPool::GetNextAllowedWakeUp(
+    LazyNow* lazy_now,
+    std::optional<WakeUp> next_desired_wake_up,
+    bool has_ready_task) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (!is_throttled()) {
+    return next_desired_wake_up;
+  }
+  const TimeTicks next_allowed_run_time = GetNextAllowedRunTime();
+  if (has_ready_task) {
+    return WakeUp{next_allowed_run_time};
+  }
+  if (!next_desired_wake_up ||
+      next_desired_wake_up->time >= next_allowed_run_time) {
+    return next_desired_wake_up;
+  }
+  return WakeUp{next_allowed_run_time};
+}
+
+void CpuTimeBudgetPool::WillProcessTask(const PendingTask& pending_task,
+                                        bool was_blocked_or_low_priority) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (task_nesting_depth_++ == 0) {
+    task_start_time_ = GetTaskClockTime();
+  }
+}
+
+void CpuTimeBudgetPool::DidProcessTask(const PendingTask& pending_task) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK_GT(task_nesting_depth_, 0);
+  if (--task_nesting_depth_ != 0) {
+    return;
+  }
+  LazyNow lazy_now(tick_clock_);
+  UpdateBudgetLevel(lazy_now.Now());
+  budget_level_ -= GetTaskClockTime() - task_start_time_;
+  if (budget_level_.is_negative() && !is_throttled()) {
+    Throttle(&lazy_now);
+  }
+}
+
+void CpuTimeBudgetPool::UpdateBudgetLevel(TimeTicks now) {
+  const TimeDelta replenished_budget = TimeDelta::FromSecondsD(
+      (now - last_update_time_).InSecondsF() * replenish_rate_);
+  budget_level_ = std::min(budget_, budget_level_ + replenished_budget);
+  last_update_time_ = now;
+}
+
+TimeTicks CpuTimeBudgetPool::GetNextAllowedRunTime() const {
+  if (!budget_level_.is_negative()) {
+    return last_update_time_;
+  }
+  // Rounded up, so that the budget is back to zero at the returned time.
+  return last_update_time_ +
+         Microseconds(std::ceil(-budget_level_.InMicrosecondsF() /
+                                replenish_rate_));
+}
+
+void CpuTimeBudgetPool::Throttle(LazyNow* lazy_now) {
+  TRACE_EVENT_BEGIN("sequence_manager", "CpuTimeBudgetPool::Throttled",
+                    perfetto::Track(reinterpret_cast<uint64_t>(this),
+                                    perfetto::ThreadTrack::Current()),
+                    "name", name_);
+  throttled_since_ = lazy_now->Now();
+  for (TaskQueue* queue : queues_) {
+    queue->InsertFence(TaskQueue::InsertFencePosition::kBeginningOfTime);
+  }
+  UpdateWakeUps(lazy_now);
+}
+
+void CpuTimeBudgetPool::Unthrottle(LazyNow* lazy_now) {
+  const TimeDelta throttling_duration = lazy_now->Now() - *throttled_since_;
+  total_throttled_time_ += throttling_duration;
+  UmaHistogramMediumTimes(
+      StrCat({"SequenceManager.CpuTimeBudgetPool.ThrottlingDuration.", name_}),
+      throttling_duration);
+  TRACE_EVENT_END("sequence_manager" /* CpuTimeBudgetPool::Throttled */,
+                  perfetto::Track(reinterpret_cast<uint64_t>(this),
+                                  perfetto::ThreadTrack::Current()));
+
+  throttled_since_.reset();
+  for (TaskQueue* queue : queues_) {
+    queue->RemoveFence();
+  }
+  UpdateWakeUps(lazy_now);
+}
+
+void CpuTimeBudgetPool::UpdateWakeUps(LazyNow* lazy_now) {
+  for (TaskQueue* queue : queues_) {
+    queue->UpdateWakeUp(lazy_now);
+  }
+}
+
+TimeDelta CpuTimeBudgetPool::GetTaskClockTime() const {
+  if (use_thread_ticks_) {
+    return ThreadTicks::Now() - ThreadTicks();
+  }
+  return tick_clock_->NowTicks() - TimeTicks();
+}
+
+}  // namespace sequence_manager
+}  // namespace base
@@ -0,0 +1,132 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_SEQUENCE_MANAGER_CPU_TIME_BUDGET_POOL_H_
+#define BASE_TASK_SEQUENCE_MANAGER_CPU_TIME_BUDGET_POOL_H_
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/memory/raw_ptr.h"
+#include "base/task/sequence_manager/task_queue.h"
+#include "base/task/task_observer.h"
+#include "base/threading/thread_checker.h"
+#include "base/time/time.h"
+
+namespace base {
+
+class TickClock;
+
+namespace sequence_manager {
+
+class SequenceManager;
+
+// A CpuTimeBudgetPool limits the CPU time used by the tasks of a group of
+// TaskQueues of a SequenceManager, e.g. background work, so that it doesn't
+// starve the other queues. The pool gets |budget| of CPU time per |window| of
+// wall time; unused budget accumulates up to |budget|. When the tasks of the
+// pool used more than their budget, all its queues are blocked by a fence
+// until enough budget is recovered to bring it back to zero. A task that
+// started is never interrupted, so the budget can go negative.
+//
+// CPU time is measured with ThreadTicks if supported, and with the
+// SequenceManager's clock otherwise. The time spent in throttled state is
+// recorded in the SequenceManager.CpuTimeBudgetPool.ThrottlingDuration.<name>
+// histogram.
+//
+// This must be used on the thread of the SequenceManager. Its queues must not
+// have another Throttler, nor another fence while they are in the pool.
+class BASE_EXPORT CpuTimeBudgetPool : public TaskQueue::Throttler,
+                                      public TaskObserver {
+ public:
+  CpuTimeBudgetPool(std::string_view name,
+                    SequenceManager* sequence_manager,
+                    TimeDelta budget,
+                    TimeDelta window);
+  CpuTimeBudgetPool(const CpuTimeBudgetPool&) = delete;
+  CpuTimeBudgetPool& operator=(const CpuTimeBudgetPool&) = delete;
+  // Removes all queues from the pool.
+  ~CpuTimeBudgetPool() override;
+
+  // Adds |queue| to the pool, or removes it from the pool. A queue must be
+  // removed before it is shut down.
+  void AddQueue(TaskQueue* queue);
+  void RemoveQueue(TaskQueue* queue);
+
+  // Returns true if the queues of the pool are blocked because the budget is
+  // exhausted.
+  bool is_throttled() const { return throttled_since_.has_value(); }
+
+  // Returns the budget left as of the last update, negative if overspent.
+  TimeDelta budget_level() const { return budget_level_; }
+
+  // Returns the total time spent in throttled state, not including the current
+  // throttling period if any.
+  TimeDelta total_throttled_time() const { return total_throttled_time_; }
+
+  // Measures task durations on the SequenceManager's clock instead of as CPU
+  // time.
+  void UseWallTimeForTesting() { use_thread_ticks_ = false; }
+
+  // TaskQueue::Throttler:
+  void OnWakeUp(LazyNow* lazy_now) override;
+  void OnHasImmediateTask() override;
+  std::optional<WakeUp> GetNextAllowedWakeUp(
+      LazyNow* lazy_now,
+      std::optional<WakeUp> next_desired_wake_up,
+      bool has_ready_task) override;
+
+  // TaskObserver:
+  void WillProcessTask(const PendingTask& pending_task,
+                       bool was_blocked_or_low_priority) override;
+  void DidProcessTask(const PendingTask& pending_task) override;
+
+ private:
+  // Replenishes the budget for the wall time elapsed since the last update.
+  void UpdateBudgetLevel(TimeTicks now);
+
+  // Returns the earliest time at which the budget is back to zero.
+  TimeTicks GetNextAllowedRunTime() const;
+
+  void Throttle(LazyNow* lazy_now);
+  void Unthrottle(LazyNow* lazy_now);
+
+  // Updates the wake-ups of all queues, which depend on the state of the pool.
+  void UpdateWakeUps(LazyNow* lazy_now);
+
+  // Returns the time used to measure task durations, as an offset from an
+  // arbitrary origin.
+  TimeDelta GetTaskClockTime() const;
+
+  const std::string name_;
+  const raw_ptr<const TickClock> tick_clock_;
+  const TimeDelta budget_;
+  // Ratio of CPU time to wall time at which the budget is replenished.
+  const double replenish_rate_;
+
+  bool use_thread_ticks_;
+  std::vector<raw_ptr<TaskQueue>> queues_;
+
+  TimeDelta budget_level_;
+  TimeTicks last_update_time_;
+
+  // Start time of the outermost task running in one of the queues, as
+  // returned by GetTaskClockTime(). Tasks of the pool that run in nested loops
+  // are accounted as part of the outermost one.
+  TimeDelta task_start_time_;
+  int task_nesting_depth_ = 0;
+
+  std::optional<TimeTicks> throttled_since_;
+  TimeDelta total_throttled_time_;
+
+  THREAD_CHECKER(thread_checker_);
+};
+
+}  // namespace sequence_manager
+}  // namespace base
+
+#endif  // BASE_TASK_SEQUENCE_MANAGER_CPU_TIME_BUDGET_POOL_H_
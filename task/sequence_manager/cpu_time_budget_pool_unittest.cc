@@ -0,0 +1,147 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/sequence_manager/cpu_time_budget_pool.h"
+
+#include <memory>
+
+#include "base/functional/bind.h"
+#include "base/task/sequence_manager/sequence_manager.h"
+#include "base/task/sequence_manager/task_queue.h"
+#include "base/task/sequence_manager/test/sequence_manager_for_test.h"
+#include "base/task/single_thread_task_runner.h"
+#include "base/test/bind.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/test_mock_time_task_runner.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace sequence_manager {
+
+namespace {
+
+constexpr TimeDelta kBudget = Milliseconds(100);
+constexpr TimeDelta kWindow = Seconds(1);
+constexpr TimeDelta kTaskDuration = Milliseconds(50);
+
+class CpuTimeBudgetPoolTest : public testing::Test {
+ public:
+  CpuTimeBudgetPoolTest()
+      : test_task_runner_(MakeRefCounted<TestMockTimeTaskRunner>(
+            TestMockTimeTaskRunner::Type::kBoundToThread)) {
+    // A null clock triggers some assertions.
+    test_task_runner_->AdvanceMockTickClock(Milliseconds(1));
+    sequence_manager_ = SequenceManagerForTest::Create(
+        nullptr, SingleThreadTaskRunner::GetCurrentDefault(),
+        test_task_runner_->GetMockTickClock(),
+        SequenceManager::Settings::Builder()
+            .SetTickClock(test_task_runner_->GetMockTickClock())
+            .Build());
+    queue_ = sequence_manager_->CreateTaskQueue(
+        TaskQueue::Spec(QueueName::TEST_TQ));
+    other_queue_ = sequence_manager_->CreateTaskQueue(
+        TaskQueue::Spec(QueueName::TEST2_TQ));
+    pool_ = std::make_unique<CpuTimeBudgetPool>(
+        "Test", sequence_manager_.get(), kBudget, kWindow);
+    pool_->UseWallTimeForTesting();
+    pool_->AddQueue(queue_.get());
+  }
+
+  // Posts a task to |queue| that takes |kTaskDuration| and increments
+  // |*counter|.
+  void PostTask(TaskQueue* queue, int* counter) {
+    queue->task_runner()->PostTask(FROM_HERE, BindLambdaForTesting([=, this] {
+                                     test_task_runner_->AdvanceMockTickClock(
+                                         kTaskDuration);
+                                     ++*counter;
+                                   }));
+  }
+
+ protected:
+  scoped_refptr<TestMockTimeTaskRunner> test_task_runner_;
+  std::unique_ptr<SequenceManagerForTest> sequence_manager_;
+  TaskQueue::Handle queue_;
+  TaskQueue::Handle other_queue_;
+  std::unique_ptr<CpuTimeBudgetPool> pool_;
+};
+
+}  // namespace
+
+TEST_F(CpuTimeBudgetPoolTest, ThrottlesWhenBudgetIsExhausted) {
+  HistogramTester histogram_tester;
+  int run_count = 0;
+  for (int i = 0; i < 4; ++i) {
+    PostTask(queue_.get(), &run_count);
+  }
+
+  // The first 2 tasks use the budget, and the budget replenished while they
+  // ran (5ms per task) lets a third one start.
+  test_task_runner_->RunUntilIdle();
+  EXPECT_EQ(run_count, 3);
+  EXPECT_TRUE(pool_->is_throttled());
+  EXPECT_EQ(pool_->budget_level(), Milliseconds(-40));
+
+  // The budget gets back to zero after 400ms.
+  test_task_runner_->FastForwardBy(Milliseconds(399));
+  EXPECT_EQ(run_count, 3);
+  test_task_runner_->FastForwardBy(Milliseconds(1));
+  EXPECT_EQ(run_count, 4);
+  histogram_tester.ExpectUniqueTimeSample(
+      "SequenceManager.CpuTimeBudgetPool.ThrottlingDuration.Test",
+      Milliseconds(400), 1);
+  EXPECT_EQ(pool_->total_throttled_time(), Milliseconds(400));
+}
+
+TEST_F(CpuTimeBudgetPoolTest, DoesNotThrottleOtherQueues) {
+  int run_count = 0;
+  int other_run_count = 0;
+  for (int i = 0; i < 4; ++i) {
+    PostTask(queue_.get(), &run_count);
+  }
+  test_task_runner_->RunUntilIdle();
+  EXPECT_TRUE(pool_->is_throttled());
+
+  PostTask(other_queue_.get(), &other_run_count);
+  PostTask(other_queue_.get(), &other_run_count);
+  test_task_runner_->RunUntilIdle();
+  EXPECT_EQ(other_run_count, 2);
+  EXPECT_EQ(run_count, 3);
+}
+
+TEST_F(CpuTimeBudgetPoolTest, ThrottlesDelayedTasks) {
+  int run_count = 0;
+  for (int i = 0; i < 3; ++i) {
+    PostTask(queue_.get(), &run_count);
+  }
+  queue_->task_runner()->PostDelayedTask(
+      FROM_HERE, BindLambdaForTesting([&] { ++run_count; }),
+      Milliseconds(100));
+
+  test_task_runner_->RunUntilIdle();
+  EXPECT_EQ(run_count, 3);
+  EXPECT_TRUE(pool_->is_throttled());
+
+  // The delayed task is ripe, but waits for the budget to recover.
+  test_task_runner_->FastForwardBy(Milliseconds(200));
+  EXPECT_EQ(run_count, 3);
+  test_task_runner_->FastForwardBy(Milliseconds(200));
+  EXPECT_EQ(run_count, 4);
+  EXPECT_FALSE(pool_->is_throttled());
+}
+
+TEST_F(CpuTimeBudgetPoolTest, RemoveQueueUnblocksIt) {
+  int run_count = 0;
+  for (int i = 0; i < 4; ++i) {
+    PostTask(queue_.get(), &run_count);
+  }
+  test_task_runner_->RunUntilIdle();
+  EXPECT_EQ(run_count, 3);
+
+  pool_->RemoveQueue(queue_.get());
+  test_task_runner_->RunUntilIdle();
+  EXPECT_EQ(run_count, 4);
+}
+
+}  // namespace sequence_manager
+}  // namespace base
@@ -0,0 +1,114 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/sequence_manager/fast_lane_task_runner.h"
+
+#include <utility>
+
+#include "base/check.h"
+#include "base/task/sequence_manager/thread_controller.h"
+
+namespace base {
+namespace sequence_manager {
+namespace internal {
+
+FastLaneTaskRunner::FastLaneTaskRunner(ThreadController* thread_controller)
+    : thread_controller_(thread_controller),
+      associated_thread_(thread_controller->GetAssociatedThread()) {
+  operations_controller_.StartAcceptingOperations();
+}
+
+FastLaneTaskRunner::~FastLaneTaskRunner() = default;
+
+bool FastLaneTaskRunner::PostDelayedTask(const Location& from_here,
+                                         OnceClosure task,
+                                         TimeDelta delay) {
+  auto operation = operations_controller_.TryBeginOperation();
+  if (!operation) {
+    return false;
+  }
+
+  if (delay.is_positive()) {
+    scoped_refptr<SingleThreadTaskRunner> task_runner =
+        thread_controller_->GetDefaultTaskRunner();
+    return task_runner &&
+           task_runner->PostDelayedTask(from_here, std::move(task), delay);
+  }
+
+  const EnqueueOrder sequence_order = enqueue_order_generator_.GenerateNext();
+  Task pending_task(PostedTask(this, std::move(task), from_here),
+                    sequence_order);
+  thread_controller_->WillQueueTask(&pending_task);
+
+  // Otherwise, the thread which made the queue non-empty requested a DoWork()
+  // which hasn't taken the tasks yet.
+  if (posted_tasks_.Push(std::move(pending_task), sequence_order)) {
+    thread_controller_->ScheduleWork();
+  }
+  return true;
+}
+
+bool FastLaneTaskRunner::PostNonNestableDelayedTask(const Location& from_here,
+                                                    OnceClosure task,
+                                                    TimeDelta delay) {
+  auto operation = operations_controller_.TryBeginOperation();
+  if (!operation) {
+    return false;
+  }
+  scoped_refptr<SingleThreadTaskRunner> task_runner =
+      thread_controller_->GetDefaultTaskRunner();
+  return task_runner && task_runner->PostNonNestableDelayedTask(
+                            from_here, std::move(task), delay);
+}
+
+bool FastLaneTaskRunner::RunsTasksInCurrentSequence() const {
+  return associated_thread_->IsBoundToCurrentThread();
+}
+
+void FastLaneTaskRunner::RunPendingTasks(
+    FunctionRef<bool(Task&)> run_task) {
+  DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
+  TakePostedTasks();
+  // A task may run a nested loop which runs some of the remaining tasks.
+  for (size_t num_tasks = ready_tasks_.size();
+       num_tasks > 0 && !ready_tasks_.empty(); --num_tasks) {
+    Task task = std::move(ready_tasks_.front());
+    ready_tasks_.pop_front();
+    if (!run_task(task)) {
+      break;
+    }
+  }
+}
+
+bool FastLaneTaskRunner::HasPendingTasks() const {
+  DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
+  return !ready_tasks_.empty() || !posted_tasks_.empty();
+}
+
+void FastLaneTaskRunner::Shutdown() {
+  DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
+  operations_controller_.ShutdownAndWaitForZeroOperations();
+  // |operations_controller_| won't let any more operations here, and
+  // |thread_controller_| is about to be deleted.
+  thread_controller_ = nullptr;
+  TakePostedTasks();
+  ready_tasks_.clear();
+}
+
+void FastLaneTaskRunner::TakePostedTasks() {
+  if (posted_tasks_.empty()) {
+    return;
+  }
+  posted_tasks_.TakeTasks(
+      last_enqueue_order_,
+      [this] { return enqueue_order_generator_.GenerateNext(); },
+      [this](Task task) {
+        last_enqueue_order_ = task.enqueue_order();
+        ready_tasks_.push_back(std::move(task));
+      });
+}
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace base
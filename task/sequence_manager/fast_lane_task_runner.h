@@ -0,0 +1,104 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_SEQUENCE_MANAGER_FAST_LANE_TASK_RUNNER_H_
+#define BASE_TASK_SEQUENCE_MANAGER_FAST_LANE_TASK_RUNNER_H_
+
+#include "base/base_export.h"
+#include "base/containers/circular_deque.h"
+#include "base/functional/function_ref.h"
+#include "base/memory/raw_ptr_exclusion.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/task/common/operations_controller.h"
+#include "base/task/sequence_manager/associated_thread_id.h"
+#include "base/task/sequence_manager/enqueue_order.h"
+#include "base/task/sequence_manager/enqueue_order_generator.h"
+#include "base/task/sequence_manager/lock_free_task_queue.h"
+#include "base/task/sequence_manager/tasks.h"
+#include "base/task/single_thread_task_runner.h"
+
+namespace base {
+namespace sequence_manager {
+namespace internal {
+
+class ThreadController;
+
+// A SingleThreadTaskRunner for latency-critical tasks, e.g. replies to the UI
+// or IO thread, which bypasses the task queues of the SequenceManager. Posting
+// pushes the task on a LockFreeTaskQueue and only requests a DoWork() from the
+// ThreadController if the queue was empty, so a burst of tasks costs a single
+// pump wake-up. The ThreadController runs the tasks at the start of its next
+// DoWork(), in posting order, before selecting a task from its
+// SequencedTaskSource.
+//
+// The tasks don't belong to any TaskQueue: they can't be throttled, fenced or
+// blocked, and TaskObservers and TaskTimeObservers aren't notified of them.
+// Delayed and non-nestable tasks are forwarded to the default task runner of
+// the ThreadController.
+class BASE_EXPORT FastLaneTaskRunner : public SingleThreadTaskRunner {
+ public:
+  // |thread_controller| must outlive the call to Shutdown().
+  explicit FastLaneTaskRunner(ThreadController* thread_controller);
+  FastLaneTaskRunner(const FastLaneTaskRunner&) = delete;
+  FastLaneTaskRunner& operator=(const FastLaneTaskRunner&) = delete;
+
+  // SingleThreadTaskRunner:
+  bool PostDelayedTask(const Location& from_here,
+                       OnceClosure task,
+                       TimeDelta delay) override;
+  bool PostNonNestableDelayedTask(const Location& from_here,
+                                  OnceClosure task,
+                                  TimeDelta delay) override;
+  bool RunsTasksInCurrentSequence() const override;
+
+  // Runs the tasks posted before this call, in posting order, by calling
+  // |run_task| on each of them until it returns false. The tasks that weren't
+  // run are run by the next call. Tasks posted meanwhile are run by the next
+  // call too, so that a task which keeps posting doesn't starve the
+  // SequencedTaskSource. Must be called on the thread of the ThreadController.
+  void RunPendingTasks(FunctionRef<bool(Task&)> run_task);
+
+  // Returns true if a task is waiting for RunPendingTasks(). Must be called on
+  // the thread of the ThreadController.
+  bool HasPendingTasks() const;
+
+  // Stops accepting tasks, waits for concurrent calls to PostDelayedTask() to
+  // return, and deletes the pending tasks. Must be called on the thread of the
+  // ThreadController, before it is deleted.
+  void Shutdown();
+
+ private:
+  ~FastLaneTaskRunner() override;
+
+  // Moves the tasks of |posted_tasks_| to the end of |ready_tasks_|.
+  void TakePostedTasks();
+
+  base::internal::OperationsController operations_controller_;
+
+  // Pointer might be stale, access guarded by |operations_controller_|.
+  // RAW_PTR_EXCLUSION: Accessed on every post from other threads.
+  RAW_PTR_EXCLUSION ThreadController* thread_controller_ = nullptr;
+
+  const scoped_refptr<const AssociatedThreadId> associated_thread_;
+
+  EnqueueOrderGenerator enqueue_order_generator_;
+
+  // The tasks posted since the last call to TakePostedTasks().
+  LockFreeTaskQueue posted_tasks_;
+
+  // The enqueue order of the last task taken from |posted_tasks_|. Only
+  // accessed on the thread of the ThreadController.
+  EnqueueOrder last_enqueue_order_;
+
+  // The tasks taken from |posted_tasks_| that RunPendingTasks() didn't run
+  // yet, in posting order. Only accessed on the thread of the
+  // ThreadController.
+  circular_deque<Task> ready_tasks_;
+};
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace base
+
+#endif  // BASE_TASK_SEQUENCE_MANAGER_FAST_LANE_TASK_RUNNER_H_
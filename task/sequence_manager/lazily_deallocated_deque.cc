@@ -0,0 +1,25 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/sequence_manager/lazily_deallocated_deque.h"
+
+#include "base/feature_list.h"
+#include "base/task/task_features.h"
+
+namespace base {
+namespace sequence_manager {
+namespace internal {
+
+// static
+std::atomic_bool TaskQueueStorageRecycling::enabled_{false};
+
+// static
+void TaskQueueStorageRecycling::InitializeFeatures() {
+  enabled_.store(FeatureList::IsEnabled(kRecycleTaskQueueStorage),
+                 std::memory_order_relaxed);
+}
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace base
@@ -6,25 +6,46 @@
 #define BASE_TASK_SEQUENCE_MANAGER_LAZILY_DEALLOCATED_DEQUE_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <new>
 #include <utility>
 #include <vector>
 
+#include "base/base_export.h"
 #include "base/check.h"
 #include "base/check_op.h"
 #include "base/containers/span.h"
 #include "base/debug/alias.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/object_pool.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/raw_ptr_exclusion.h"
+#include "base/no_destructor.h"
 #include "base/time/time.h"
 
 namespace base {
 namespace sequence_manager {
 namespace internal {
 
+// Whether the storage of task queues is recycled through ObjectPools, as of
+// the kRecycleTaskQueueStorage feature: the rings of LazilyDeallocatedDeques,
+// and the thread pool's Sequences. While it's disabled, their memory still
+// comes from the pools, without being cached, so that it can be freed whether
+// or not the feature was enabled when it was allocated.
+class BASE_EXPORT TaskQueueStorageRecycling {
+ public:
+  // Initializes the state of the feature. May be called at any time.
+  static void InitializeFeatures();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+ private:
+  static std::atomic_bool enabled_;
+};
+
 // A LazilyDeallocatedDeque specialized for the SequenceManager's usage
 // patterns. The queue generally grows while tasks are added and then removed
 // until empty and the cycle repeats.
@@ -38,6 +59,12 @@ namespace internal {
 // We keep track of the maximum recent queue size and rate limit
 // MaybeShrinkQueue to avoid unnecessary churn.
 //
+// The rings of the minimum size keep their elements inline. With
+// TaskQueueStorageRecycling, the rings making up the queues are also recycled
+// across all the queues holding the same type, through an ObjectPool, so a new
+// queue, like a queue which grows and shrinks back, usually doesn't allocate
+// memory.
+//
 // NB this queue isn't by itself thread safe.
 template <typename T, TimeTicks (*now_source)() = TimeTicks::Now>
 class LazilyDeallocatedDeque {
@@ -57,6 +84,7 @@ class LazilyDeallocatedDeque {
   };
 
   LazilyDeallocatedDeque() = default;
+  LazilyDeallocatedDeque(LazilyDeallocatedDeque&& other) { swap(other); }
   LazilyDeallocatedDeque(const LazilyDeallocatedDeque&) = delete;
   LazilyDeallocatedDeque& operator=(const LazilyDeallocatedDeque&) = delete;
   ~LazilyDeallocatedDeque() { clear(); }
@@ -88,7 +116,7 @@ class LazilyDeallocatedDeque {
   void push_front(T t) {
     if (!head_) {
       DCHECK(!tail_);
-      head_ = std::make_unique<Ring>(kMinimumRingSize);
+      head_ = NewRing(kMinimumRingSize);
       tail_ = head_.get();
     }
 
@@ -98,7 +126,7 @@ class LazilyDeallocatedDeque {
       size_t size = size_;
       base::debug::Alias(&size);
 
-      std::unique_ptr<Ring> new_ring = std::make_unique<Ring>(kMinimumRingSize);
+      RingPtr new_ring = NewRing(kMinimumRingSize);
       new_ring->next_ = std::move(head_);
       head_ = std::move(new_ring);
     }
@@ -111,7 +139,7 @@ class LazilyDeallocatedDeque {
   void push_back(T t) {
     if (!head_) {
       DCHECK(!tail_);
-      head_ = std::make_unique<Ring>(kMinimumRingSize);
+      head_ = NewRing(kMinimumRingSize);
       tail_ = head_.get();
     }
 
@@ -123,8 +151,7 @@ class LazilyDeallocatedDeque {
 
       // Doubling the size is a common strategy, but one which can be wasteful
       // so we use a (somewhat) slower growth curve.
-      tail_->next_ = std::make_unique<Ring>(2 + tail_->capacity() +
-                                            (tail_->capacity() / 2));
+      tail_->next_ = NewRing(2 + tail_->capacity() + (tail_->capacity() / 2));
       tail_ = tail_->next_.get();
     }
 
@@ -207,7 +234,7 @@ class LazilyDeallocatedDeque {
   }
 
   void SetCapacity(size_t new_capacity) {
-    std::unique_ptr<Ring> new_ring = std::make_unique<Ring>(new_capacity);
+    RingPtr new_ring = NewRing(new_capacity);
 
     DCHECK_GE(new_capacity, size_ + 1);
 
@@ -232,11 +259,45 @@ class LazilyDeallocatedDeque {
   FRIEND_TEST_ALL_PREFIXES(LazilyDeallocatedDequeTest, RingPushBack);
   FRIEND_TEST_ALL_PREFIXES(LazilyDeallocatedDequeTest, RingCanPush);
   FRIEND_TEST_ALL_PREFIXES(LazilyDeallocatedDequeTest, RingPushPopPushPop);
+  FRIEND_TEST_ALL_PREFIXES(LazilyDeallocatedDequeTest, RingsAreRecycled);
+
+  struct Ring;
+
+  struct RingDeleter {
+    void operator()(Ring* ring) const {
+      ring->~Ring();
+      base::internal::ObjectPoolBase& pool = GetRingPool();
+      if (TaskQueueStorageRecycling::IsEnabled()) {
+        pool.Free(ring);
+      } else {
+        pool.FreeUncached(ring);
+      }
+    }
+  };
+  using RingPtr = std::unique_ptr<Ring, RingDeleter>;
+
+  static base::internal::ObjectPoolBase& GetRingPool() {
+    static NoDestructor<base::internal::ObjectPoolBase> pool(
+        "task_queue_rings", sizeof(Ring), alignof(Ring));
+    return *pool;
+  }
+
+  static RingPtr NewRing(size_t capacity) {
+    base::internal::ObjectPoolBase& pool = GetRingPool();
+    void* storage = TaskQueueStorageRecycling::IsEnabled()
+                        ? pool.Allocate()
+                        : pool.AllocateUncached();
+    return RingPtr(new (storage) Ring(capacity));
+  }
 
   struct Ring {
     explicit Ring(size_t capacity)
-        : backing_store_(std::make_unique<char[]>(sizeof(T) * capacity)),
-          data_(reinterpret_cast<T*>(backing_store_.get()), capacity) {
+        : backing_store_(capacity > kMinimumRingSize
+                             ? std::make_unique<char[]>(sizeof(T) * capacity)
+                             : nullptr),
+          data_(reinterpret_cast<T*>(backing_store_ ? backing_store_.get()
+                                                    : inline_store_),
+                capacity) {
       DCHECK_GE(capacity, kMinimumRingSize);
       CHECK_LT(capacity, std::numeric_limits<size_t>::max() / sizeof(T));
     }
@@ -314,9 +375,11 @@ class LazilyDeallocatedDeque {
 
     size_t front_index_ = 0;
     size_t back_index_ = 0;
+    // Null for the rings of the minimum size, which use `inline_store_`.
     std::unique_ptr<char[]> backing_store_;
     base::span<T> data_;
-    std::unique_ptr<Ring> next_ = nullptr;
+    RingPtr next_ = nullptr;
+    alignas(T) char inline_store_[sizeof(T) * kMinimumRingSize];
   };
 
  public:
@@ -366,7 +429,7 @@ class LazilyDeallocatedDeque {
  private:
   // We maintain a list of Ring buffers, to enable us to grow without copying,
   // but most of the time we aim to have only one active Ring.
-  std::unique_ptr<Ring> head_;
+  RingPtr head_;
 
   // `tail_` is not a raw_ptr<...> for performance reasons (based on analysis of
   // sampling profiler data and tab_search:top100:2020).
@@ -4,6 +4,11 @@
 
 #include "base/task/sequence_manager/lazily_deallocated_deque.h"
 
+#include <utility>
+
+#include "base/memory/object_pool.h"
+#include "base/task/task_features.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/scoped_mock_clock_override.h"
 #include "testing/gmock/include/gmock/gmock.h"
 
@@ -11,6 +16,21 @@ namespace base {
 namespace sequence_manager {
 namespace internal {
 
+namespace {
+
+size_t GetAllocatedRings() {
+  size_t rings = 0;
+  for (const auto& stats :
+       base::internal::ObjectPoolBase::GetStatsForAllPools()) {
+    if (stats.name == "task_queue_rings") {
+      rings += stats.allocated_slots;
+    }
+  }
+  return rings;
+}
+
+}  // namespace
+
 class LazilyDeallocatedDequeTest : public testing::Test {};
 
 TEST_F(LazilyDeallocatedDequeTest, InitiallyEmpty) {
@@ -424,6 +444,45 @@ TEST_F(LazilyDeallocatedDequeTest, RingPushPopPushPop) {
   EXPECT_FALSE(r.CanPop());
 }
 
+TEST_F(LazilyDeallocatedDequeTest, RingsAreNotRecycledByDefault) {
+  const size_t rings = GetAllocatedRings();
+  {
+    LazilyDeallocatedDeque<int> d;
+    d.push_back(1);
+    EXPECT_EQ(rings + 1, GetAllocatedRings());
+  }
+  EXPECT_EQ(rings, GetAllocatedRings());
+}
+
+TEST_F(LazilyDeallocatedDequeTest, RingsAreRecycled) {
+  test::ScopedFeatureList feature_list(kRecycleTaskQueueStorage);
+  TaskQueueStorageRecycling::InitializeFeatures();
+
+  const void* ring;
+  {
+    LazilyDeallocatedDeque<int> d;
+    d.push_back(1);
+    ring = d.head_.get();
+    // A ring of the minimum size holds its elements inline.
+    EXPECT_FALSE(d.head_->backing_store_);
+  }
+
+  // The ring of the destroyed queue is reused by the next one.
+  LazilyDeallocatedDeque<int> d;
+  d.push_back(2);
+  EXPECT_EQ(ring, d.head_.get());
+
+  // Larger rings have a backing store.
+  for (int i = 0; i < 10; i++) {
+    d.push_back(i);
+  }
+  EXPECT_TRUE(d.tail_->backing_store_);
+
+  // The rings of `d` are then freed rather than recycled.
+  feature_list.Reset();
+  TaskQueueStorageRecycling::InitializeFeatures();
+}
+
 TEST_F(LazilyDeallocatedDequeTest, PushAndIterate) {
   LazilyDeallocatedDeque<int> d;
 
@@ -480,6 +539,19 @@ class DestructorTestItem {
 
 int DestructorTestItem::destructor_count_ = 0;
 
+TEST_F(LazilyDeallocatedDequeTest, MoveConstruct) {
+  LazilyDeallocatedDeque<int> a;
+  for (int i = 0; i < 100; i++) {
+    a.push_back(i);
+  }
+
+  LazilyDeallocatedDeque<int> b(std::move(a));
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(100u, b.size());
+  EXPECT_EQ(0, b.front());
+  EXPECT_EQ(99, b.back());
+}
+
 TEST_F(LazilyDeallocatedDequeTest, PopFrontCallsDestructor) {
   LazilyDeallocatedDeque<DestructorTestItem> a;
 
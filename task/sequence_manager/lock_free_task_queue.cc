@@ -0,0 +1,105 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/sequence_manager/lock_free_task_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check.h"
+#include "base/memory/raw_ptr_exclusion.h"
+
+namespace base {
+namespace sequence_manager {
+namespace internal {
+
+struct LockFreeTaskQueue::Node {
+  Node(Task task, EnqueueOrder sequence_order)
+      : task(std::move(task)), sequence_order(sequence_order) {}
+
+  Task task;
+  const EnqueueOrder sequence_order;
+  // Nodes are owned by the queue and only linked to each other.
+  RAW_PTR_EXCLUSION Node* next = nullptr;
+};
+
+LockFreeTaskQueue::LockFreeTaskQueue() = default;
+
+LockFreeTaskQueue::~LockFreeTaskQueue() {
+  Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+  while (node) {
+    delete std::exchange(node, node->next);
+  }
+}
+
+bool LockFreeTaskQueue::Push(Task task, EnqueueOrder sequence_order) {
+  DCHECK(!task.enqueue_order_set());
+  Node* node = new Node(std::move(task), sequence_order);
+  size_.fetch_add(1, std::memory_order_relaxed);
+  // Release so that TakeTasks() sees the task when it sees |node|.
+  Node* head = head_.load(std::memory_order_relaxed);
+  do {
+    node->next = head;
+  } while (!head_.compare_exchange_weak(head, node, std::memory_order_release,
+                                        std::memory_order_relaxed));
+  return !head;
+}
+
+void LockFreeTaskQueue::TakeTasks(
+    EnqueueOrder last_enqueue_order,
+    FunctionRef<EnqueueOrder()> next_enqueue_order,
+    FunctionRef<void(Task)> on_task) {
+  Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+  if (!node) {
+    return;
+  }
+
+  // Nodes are linked from the most recently pushed, which is usually the
+  // highest sequence order. Sort them in increasing sequence order by
+  // inserting each of them at the front of |sorted|, which rarely requires
+  // walking past the front since concurrent pushes are seldom out of order.
+  Node* sorted = nullptr;
+  while (node) {
+    Node* next = std::exchange(node->next, nullptr);
+    Node** position = &sorted;
+    while (*position && (*position)->sequence_order < node->sequence_order) {
+      position = &(*position)->next;
+    }
+    node->next = *position;
+    *position = node;
+    node = next;
+  }
+
+  size_t num_tasks = 0;
+  while (sorted) {
+    Node* next = sorted->next;
+    EnqueueOrder enqueue_order = sorted->sequence_order;
+    if (enqueue_order <= last_enqueue_order) {
+      enqueue_order = next_enqueue_order();
+      DCHECK(enqueue_order > last_enqueue_order);
+    }
+    last_enqueue_order = enqueue_order;
+    sorted->task.set_enqueue_order(enqueue_order);
+    on_task(std::move(sorted->task));
+    delete sorted;
+    sorted = next;
+    ++num_tasks;
+  }
+  size_.fetch_sub(num_tasks, std::memory_order_relaxed);
+}
+
+EnqueueOrder LockFreeTaskQueue::GetLowestSequenceOrder() const {
+  // Nodes are only deleted by TakeTasks(), and are immutable once pushed.
+  const Node* node = head_.load(std::memory_order_acquire);
+  DCHECK(node);
+  EnqueueOrder lowest = node->sequence_order;
+  for (node = node->next; node; node = node->next) {
+    lowest = std::min(lowest, node->sequence_order);
+  }
+  return lowest;
+}
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace base
@@ -0,0 +1,74 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_SEQUENCE_MANAGER_LOCK_FREE_TASK_QUEUE_H_
+#define BASE_TASK_SEQUENCE_MANAGER_LOCK_FREE_TASK_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/functional/function_ref.h"
+#include "base/task/sequence_manager/enqueue_order.h"
+#include "base/task/sequence_manager/tasks.h"
+
+namespace base {
+namespace sequence_manager {
+namespace internal {
+
+// A multi-producer single-consumer queue of immediate tasks. Tasks can be
+// pushed from any thread without a lock, and are taken in bulk, in the order
+// of the sequence number they were given when posted.
+//
+// A producer gets a sequence number before pushing its task, so tasks aren't
+// necessarily pushed in sequence order. TakeTasks() sorts the tasks it takes,
+// and a task that is pushed after a task with a higher sequence number was
+// taken is given a new enqueue order, so that taken tasks are always in
+// strictly increasing enqueue order. This is as if that task had been posted
+// after the ones that were taken, which is indistinguishable for its poster
+// since its PostTask() call hadn't returned yet.
+class BASE_EXPORT LockFreeTaskQueue {
+ public:
+  LockFreeTaskQueue();
+  LockFreeTaskQueue(const LockFreeTaskQueue&) = delete;
+  LockFreeTaskQueue& operator=(const LockFreeTaskQueue&) = delete;
+  ~LockFreeTaskQueue();
+
+  // Pushes |task|, whose enqueue order must not be set yet and which was
+  // given |sequence_order| when posted. Can be called from any thread. Returns
+  // true if the queue was empty.
+  bool Push(Task task, EnqueueOrder sequence_order);
+
+  // Removes all tasks and passes them to |on_task| in increasing sequence
+  // order. A task's enqueue order is set to its sequence order if it's higher
+  // than |last_enqueue_order| and the previous task's enqueue order, or to
+  // |next_enqueue_order()| otherwise. Calls must be serialized, e.g. by a lock
+  // held by the consumer.
+  void TakeTasks(EnqueueOrder last_enqueue_order,
+                 FunctionRef<EnqueueOrder()> next_enqueue_order,
+                 FunctionRef<void(Task)> on_task);
+
+  // Returns the lowest sequence order of the tasks, which must not be empty.
+  // Calls must be serialized with TakeTasks().
+  EnqueueOrder GetLowestSequenceOrder() const;
+
+  // Can be called from any thread, but the result may be stale as soon as it's
+  // returned unless calls to TakeTasks() are serialized with this.
+  bool empty() const { return !head_.load(std::memory_order_acquire); }
+  size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Node;
+
+  // Most recently pushed task, linked to the previously pushed ones.
+  std::atomic<Node*> head_{nullptr};
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace base
+
+#endif  // BASE_TASK_SEQUENCE_MANAGER_LOCK_FREE_TASK_QUEUE_H_
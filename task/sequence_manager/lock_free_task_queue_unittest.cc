@@ -0,0 +1,159 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/sequence_manager/lock_free_task_queue.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/memory/raw_ptr.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gmock/include/gmock/gmock.h"
+
+namespace base {
+namespace sequence_manager {
+namespace internal {
+
+namespace {
+
+void NopTask() {}
+
+class LockFreeTaskQueueTest : public testing::Test {
+ protected:
+  bool Push(int sequence_order) {
+    return queue_.Push(
+        Task(PostedTask(nullptr, BindOnce(&NopTask), FROM_HERE),
+             EnqueueOrder::FromIntForTesting(sequence_order)),
+        EnqueueOrder::FromIntForTesting(sequence_order));
+  }
+
+  // Takes all tasks and returns their (sequence number, enqueue order) pairs.
+  // Tasks that need a new enqueue order get one from |next_enqueue_order_|.
+  std::vector<std::pair<int, uint64_t>> TakeTasks(
+      uint64_t last_enqueue_order) {
+    std::vector<std::pair<int, uint64_t>> tasks;
+    queue_.TakeTasks(
+        EnqueueOrder::FromIntForTesting(last_enqueue_order),
+        [&] { return EnqueueOrder::FromIntForTesting(next_enqueue_order_++); },
+        [&](Task task) {
+          tasks.emplace_back(task.sequence_num,
+                             static_cast<uint64_t>(task.enqueue_order()));
+        });
+    return tasks;
+  }
+
+  LockFreeTaskQueue queue_;
+  uint64_t next_enqueue_order_ = 100;
+};
+
+}  // namespace
+
+using testing::ElementsAre;
+using testing::Pair;
+
+TEST_F(LockFreeTaskQueueTest, InitiallyEmpty) {
+  EXPECT_TRUE(queue_.empty());
+  EXPECT_EQ(0u, queue_.size());
+  EXPECT_TRUE(TakeTasks(0).empty());
+}
+
+TEST_F(LockFreeTaskQueueTest, PushReturnsWhetherEmpty) {
+  EXPECT_TRUE(Push(1));
+  EXPECT_FALSE(Push(2));
+  EXPECT_FALSE(queue_.empty());
+  EXPECT_EQ(2u, queue_.size());
+
+  TakeTasks(0);
+  EXPECT_TRUE(queue_.empty());
+  EXPECT_EQ(0u, queue_.size());
+  EXPECT_TRUE(Push(3));
+}
+
+TEST_F(LockFreeTaskQueueTest, TakenInSequenceOrder) {
+  Push(2);
+  Push(4);
+  Push(1);
+  Push(3);
+  EXPECT_THAT(TakeTasks(0),
+              ElementsAre(Pair(1, 1u), Pair(2, 2u), Pair(3, 3u), Pair(4, 4u)));
+}
+
+TEST_F(LockFreeTaskQueueTest, GetLowestSequenceOrder) {
+  Push(3);
+  EXPECT_EQ(3u, static_cast<uint64_t>(queue_.GetLowestSequenceOrder()));
+  Push(5);
+  Push(2);
+  Push(4);
+  EXPECT_EQ(2u, static_cast<uint64_t>(queue_.GetLowestSequenceOrder()));
+}
+
+// A task pushed after a task with a higher sequence number was taken is given
+// a new enqueue order.
+TEST_F(LockFreeTaskQueueTest, LateTaskGetsNewEnqueueOrder) {
+  Push(2);
+  EXPECT_THAT(TakeTasks(0), ElementsAre(Pair(2, 2u)));
+
+  Push(3);
+  Push(1);
+  EXPECT_THAT(TakeTasks(2), ElementsAre(Pair(1, 100u), Pair(3, 101u)));
+}
+
+TEST_F(LockFreeTaskQueueTest, ConcurrentPushes) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumTasksPerThread = 1000;
+  constexpr size_t kNumTasks = kNumThreads * kNumTasksPerThread;
+
+  class PushThread : public SimpleThread {
+   public:
+    PushThread(LockFreeTaskQueue* queue, int first_sequence_order)
+        : SimpleThread("PushThread"),
+          queue_(queue),
+          first_sequence_order_(first_sequence_order) {}
+
+    void Run() override {
+      for (int i = 0; i < kNumTasksPerThread; ++i) {
+        const int sequence_order = first_sequence_order_ + i * kNumThreads;
+        queue_->Push(Task(PostedTask(nullptr, BindOnce(&NopTask), FROM_HERE),
+                          EnqueueOrder::FromIntForTesting(sequence_order)),
+                     EnqueueOrder::FromIntForTesting(sequence_order));
+      }
+    }
+
+   private:
+    const raw_ptr<LockFreeTaskQueue> queue_;
+    const int first_sequence_order_;
+  };
+
+  std::vector<std::unique_ptr<PushThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(std::make_unique<PushThread>(&queue_, i + 1));
+    threads.back()->Start();
+  }
+
+  // Enqueue orders must strictly increase across all the taken tasks.
+  std::vector<std::pair<int, uint64_t>> tasks;
+  uint64_t last_enqueue_order = 0;
+  next_enqueue_order_ = kNumTasks + 1;
+  while (tasks.size() < kNumTasks) {
+    for (const auto& task : TakeTasks(last_enqueue_order)) {
+      EXPECT_GT(task.second, last_enqueue_order);
+      last_enqueue_order = task.second;
+      tasks.push_back(task);
+    }
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+  EXPECT_TRUE(queue_.empty());
+  EXPECT_EQ(0u, queue_.size());
+}
+
+}  // namespace internal
+}  // namespace sequence_manager
+}  // namespace base
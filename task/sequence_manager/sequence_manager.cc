@@ -4,13 +4,20 @@
 
 #include "base/task/sequence_manager/sequence_manager.h"
 
+#include <atomic>
 #include <utility>
 
+#include "base/feature_list.h"
+#include "base/task/task_features.h"
+#include "base/time/tsc_tick_clock.h"
+
 namespace base {
 namespace sequence_manager {
 
 namespace {
 
+std::atomic_bool g_use_tsc_tick_clock = false;
+
 #if BUILDFLAG(ENABLE_BASE_TRACING)
 perfetto::protos::pbzero::SequenceManagerTask::Priority
 DefaultTaskPriorityToProto(TaskQueue::QueuePriority priority) {
@@ -102,7 +109,19 @@ SequenceManager::PrioritySettings::PrioritySettings(
 SequenceManager::PrioritySettings& SequenceManager::PrioritySettings::operator=(
     PrioritySettings&&) = default;
 
-SequenceManager::Settings::Settings() = default;
+SequenceManager::Settings::Settings() {
+  if (g_use_tsc_tick_clock.load(std::memory_order_relaxed)) {
+    if (const TickClock* tsc_tick_clock = TscTickClock::GetInstance()) {
+      clock = tsc_tick_clock;
+    }
+  }
+}
+
+// static
+void SequenceManager::Settings::InitializeFeatures() {
+  g_use_tsc_tick_clock.store(FeatureList::IsEnabled(kUseTscTickClock),
+                             std::memory_order_relaxed);
+}
 
 SequenceManager::Settings::Settings(Settings&& move_from) noexcept = default;
 
@@ -153,6 +172,13 @@ SequenceManager::Settings::Builder::SetPrioritySettings(
   return *this;
 }
 
+SequenceManager::Settings::Builder&
+SequenceManager::Settings::Builder::SetEarliestDeadlineFirst(
+    bool earliest_deadline_first_val) {
+  settings_.earliest_deadline_first = earliest_deadline_first_val;
+  return *this;
+}
+
 #if DCHECK_IS_ON()
 
 SequenceManager::Settings::Builder&
@@ -162,6 +162,10 @@ class BASE_EXPORT SequenceManager {
 
     ~Settings();
 
+    // Makes the default `clock` a TscTickClock if |kUseTscTickClock| is
+    // enabled and the CPU supports it.
+    static void InitializeFeatures();
+
     MessagePumpType message_loop_type = MessagePumpType::DEFAULT;
     bool randomised_sampling_enabled = false;
     raw_ptr<const TickClock, DanglingUntriaged> clock =
@@ -175,6 +179,11 @@ class BASE_EXPORT SequenceManager {
 
     PrioritySettings priority_settings = PrioritySettings::CreateDefault();
 
+    // Whether the queues of a given priority are selected by the deadline of
+    // their next task (earliest deadline first) rather than by its age. See
+    // TaskQueue::PostTaskWithDeadline().
+    bool earliest_deadline_first = false;
+
 #if DCHECK_IS_ON()
     // TODO(alexclarke): Consider adding command line flags to control these.
     enum class TaskLogging {
@@ -331,6 +340,10 @@ class BASE_EXPORT SequenceManager::Settings::Builder {
 
   Builder& SetPrioritySettings(PrioritySettings settings);
 
+  // Whether the queues of a given priority are selected by the deadline of
+  // their next task rather than by its age.
+  Builder& SetEarliestDeadlineFirst(bool earliest_deadline_first);
+
 #if DCHECK_IS_ON()
   // Controls task execution logging.
   Builder& SetTaskLogging(TaskLogging task_execution_logging);
@@ -299,7 +299,9 @@ std::unique_ptr<SequenceManagerImpl> SequenceManagerImpl::CreateUnbound(
 
 // static
 void SequenceManagerImpl::InitializeFeatures() {
+  Settings::InitializeFeatures();
   TaskQueueImpl::InitializeFeatures();
+  TaskQueueStorageRecycling::InitializeFeatures();
   MessagePump::InitializeFeatures();
   ThreadControllerWithMessagePumpImpl::InitializeFeatures();
 #if BUILDFLAG(IS_WIN)
@@ -676,6 +678,10 @@ void SequenceManagerImpl::DidRunTask(LazyNow& lazy_now) {
   ExecutingTask& executing_task =
       *main_thread_only().task_execution_stack.rbegin();
 
+  if (!executing_task.pending_task.deadline.is_null()) {
+    executing_task.task_queue->RecordTaskDeadline(executing_task.pending_task,
+                                                  lazy_now.Now());
+  }
   NotifyDidProcessTask(&executing_task, &lazy_now);
   main_thread_only().task_execution_stack.pop_back();
 
@@ -1187,6 +1193,11 @@ scoped_refptr<SingleThreadTaskRunner> SequenceManagerImpl::GetTaskRunner() {
   return controller_->GetDefaultTaskRunner();
 }
 
+scoped_refptr<SingleThreadTaskRunner>
+SequenceManagerImpl::GetFastLaneTaskRunner() {
+  return controller_->GetFastLaneTaskRunner();
+}
+
 bool SequenceManagerImpl::IsBoundToCurrentThread() const {
   return associated_thread_->IsBoundToCurrentThread();
 }
@@ -161,6 +161,12 @@ class BASE_EXPORT SequenceManagerImpl
   void SetTaskRunner(scoped_refptr<SingleThreadTaskRunner> task_runner);
   scoped_refptr<SingleThreadTaskRunner> GetTaskRunner();
 
+  // Returns a task runner for latency-critical tasks, e.g. replies to this
+  // thread, which run before the tasks of all TaskQueues and cost a single
+  // wake-up per burst. They can't be throttled, and TaskObservers aren't
+  // notified of them. Thread-safe.
+  scoped_refptr<SingleThreadTaskRunner> GetFastLaneTaskRunner();
+
   bool IsBoundToCurrentThread() const;
   MessagePump* GetMessagePump() const;
   bool IsType(MessagePumpType type) const;
@@ -112,6 +112,13 @@ enum class MetricsSampling {
   kMetricsOff,
 };
 
+// Whether immediate tasks are posted to the lock-free incoming queue, as per
+// kLockFreeImmediateIncomingQueue.
+enum class IncomingQueueType {
+  kLocked,
+  kLockFree,
+};
+
 enum class TestQueuePriority : TaskQueue::QueuePriority {
   kControlPriority = 0,
   kHighestPriority = 1,
@@ -154,12 +161,24 @@ std::string ToString(MetricsSampling sampling) {
   }
 }
 
+std::string ToString(IncomingQueueType type) {
+  switch (type) {
+    case IncomingQueueType::kLocked:
+      return "";
+    case IncomingQueueType::kLockFree:
+      return "LockFreeIncomingQueue";
+  }
+}
+
 std::string GetTestNameSuffix(
-    const testing::TestParamInfo<
-        std::tuple<RunnerType, WakeUpType, MetricsSampling>>& info) {
+    const testing::TestParamInfo<std::tuple<RunnerType,
+                                            WakeUpType,
+                                            MetricsSampling,
+                                            IncomingQueueType>>& info) {
   return StrCat({"With", ToString(std::get<0>(info.param)).substr(1),
                  ToString(std::get<1>(info.param)),
-                 ToString(std::get<2>(info.param))});
+                 ToString(std::get<2>(info.param)),
+                 ToString(std::get<3>(info.param))});
 }
 
 TaskQueueImpl* GetTaskQueueImpl(TaskQueue* task_queue) {
@@ -414,11 +433,21 @@ class FixtureWithMockMessagePump : public Fixture {
 // instead of templated ones. The latter would be more verbose as all method
 // calls to the fixture would need to be like this->method()
 class SequenceManagerTest
-    : public testing::TestWithParam<
-          std::tuple<RunnerType, WakeUpType, MetricsSampling>>,
+    : public testing::TestWithParam<std::tuple<RunnerType,
+                                               WakeUpType,
+                                               MetricsSampling,
+                                               IncomingQueueType>>,
       public Fixture {
  public:
   SequenceManagerTest() {
+    // The feature is read when task queues are created.
+    if (GetIncomingQueueType() == IncomingQueueType::kLockFree) {
+      feature_list_.InitAndEnableFeature(kLockFreeImmediateIncomingQueue);
+    } else {
+      feature_list_.InitAndDisableFeature(kLockFreeImmediateIncomingQueue);
+    }
+    TaskQueueImpl::InitializeFeatures();
+
     switch (GetUnderlyingRunnerType()) {
       case RunnerType::kMockTaskRunner:
         fixture_ = std::make_unique<FixtureWithMockTaskRunner>();
@@ -436,6 +465,12 @@ class SequenceManagerTest
     }
   }
 
+  ~SequenceManagerTest() override {
+    fixture_.reset();
+    feature_list_.Reset();
+    TaskQueueImpl::InitializeFeatures();
+  }
+
   // Accounts for the extra calls to Now() that come when sampling is enabled.
   int GetExtraNowSampleCount() {
     // When no extra metrics are sampled there are no extra Now() calls.
@@ -523,6 +558,7 @@ class SequenceManagerTest
   RunnerType GetUnderlyingRunnerType() { return std::get<0>(GetParam()); }
   WakeUpType GetWakeUpType() { return std::get<1>(GetParam()); }
   MetricsSampling GetSampling() { return std::get<2>(GetParam()); }
+  IncomingQueueType GetIncomingQueueType() { return std::get<3>(GetParam()); }
 
   TimeTicks FromStartAligned(TimeDelta delta) const override {
     return fixture_->FromStartAligned(delta);
@@ -534,25 +570,35 @@ class SequenceManagerTest
   std::optional<base::MetricsSubSampler::ScopedNeverSampleForTesting>
       never_sample_scoper_;
   debug::CrashKeyString dummy_key_{"dummy", debug::CrashKeySize::Size64};
+  // Must outlive `fixture_`, whose own ScopedFeatureList is created after it.
+  base::test::ScopedFeatureList feature_list_;
   std::unique_ptr<Fixture> fixture_;
 };
 
 auto GetTestTypes() {
   return testing::Values(
       std::make_tuple(RunnerType::kMessagePump, WakeUpType::kDefault,
-                      MetricsSampling::kMetricsOn),
+                      MetricsSampling::kMetricsOn, IncomingQueueType::kLocked),
       std::make_tuple(RunnerType::kMessagePump, WakeUpType::kDefault,
-                      MetricsSampling::kMetricsOff),
+                      MetricsSampling::kMetricsOff, IncomingQueueType::kLocked),
 #if !BUILDFLAG(IS_WIN)
       std::make_tuple(RunnerType::kMessagePump, WakeUpType::kAlign,
-                      MetricsSampling::kMetricsOn),
+                      MetricsSampling::kMetricsOn, IncomingQueueType::kLocked),
       std::make_tuple(RunnerType::kMessagePump, WakeUpType::kAlign,
-                      MetricsSampling::kMetricsOff),
+                      MetricsSampling::kMetricsOff, IncomingQueueType::kLocked),
 #endif
       std::make_tuple(RunnerType::kMockTaskRunner, WakeUpType::kDefault,
-                      MetricsSampling::kMetricsOn),
+                      MetricsSampling::kMetricsOn, IncomingQueueType::kLocked),
+      std::make_tuple(RunnerType::kMockTaskRunner, WakeUpType::kDefault,
+                      MetricsSampling::kMetricsOff, IncomingQueueType::kLocked),
+      // The lock-free incoming queue doesn't depend on the other parameters,
+      // so it is only tested with the main ones.
+      std::make_tuple(RunnerType::kMessagePump, WakeUpType::kDefault,
+                      MetricsSampling::kMetricsOff,
+                      IncomingQueueType::kLockFree),
       std::make_tuple(RunnerType::kMockTaskRunner, WakeUpType::kDefault,
-                      MetricsSampling::kMetricsOff));
+                      MetricsSampling::kMetricsOff,
+                      IncomingQueueType::kLockFree));
 }
 
 INSTANTIATE_TEST_SUITE_P(All,
@@ -1608,6 +1654,52 @@ TEST_P(SequenceManagerTest, BlockedByFence_BothTypesOfFence) {
   EXPECT_TRUE(queue->BlockedByFence());
 }
 
+TEST_P(SequenceManagerTest, BlockedByFence_CrossThreadTasks) {
+  auto queue = CreateTaskQueue();
+  std::vector<EnqueueOrder> run_order;
+  Thread thread("TestThread");
+  thread.Start();
+  auto post_from_thread = [&](uint64_t value) {
+    WaitableEvent done_event;
+    thread.task_runner()->PostTask(
+        FROM_HERE, BindLambdaForTesting([&]() {
+          queue->task_runner()->PostTask(
+              FROM_HERE, BindOnce(&TestTask, value, &run_order));
+          done_event.Signal();
+        }));
+    done_event.Wait();
+  };
+
+  post_from_thread(1);
+  queue->InsertFence(TaskQueue::InsertFencePosition::kNow);
+  EXPECT_FALSE(queue->BlockedByFence());
+
+  // Task 1 is still ahead of the fence.
+  post_from_thread(2);
+  EXPECT_FALSE(queue->BlockedByFence());
+
+  RunLoop().RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(1u));
+  EXPECT_TRUE(queue->BlockedByFence());
+
+  queue->RemoveFence();
+  EXPECT_FALSE(queue->BlockedByFence());
+  RunLoop().RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(1u, 2u));
+
+  // A task posted after the fence, while no other task is pending.
+  queue->InsertFence(TaskQueue::InsertFencePosition::kNow);
+  post_from_thread(3);
+  EXPECT_TRUE(queue->BlockedByFence());
+  RunLoop().RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(1u, 2u));
+
+  queue->RemoveFence();
+  RunLoop().RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(1u, 2u, 3u));
+  thread.Stop();
+}
+
 namespace {
 
 void RecordTimeTask(std::vector<TimeTicks>* run_times, const TickClock* clock) {
@@ -2185,6 +2277,37 @@ TEST_P(SequenceManagerTest, HasTaskToRunImmediatelyOrReadyDelayedTask) {
   EXPECT_FALSE(queue->HasTaskToRunImmediatelyOrReadyDelayedTask());
 }
 
+TEST_P(SequenceManagerTest, CrossThreadTasksArePending) {
+  auto queue = CreateTaskQueue();
+  std::vector<EnqueueOrder> run_order;
+  WaitableEvent done_event;
+  Thread thread("TestThread");
+  thread.Start();
+  thread.task_runner()->PostTask(
+      FROM_HERE, BindLambdaForTesting([&]() {
+        for (uint64_t i = 1; i <= 3; ++i) {
+          queue->task_runner()->PostTask(FROM_HERE,
+                                         BindOnce(&TestTask, i, &run_order));
+        }
+        done_event.Signal();
+      }));
+  done_event.Wait();
+  thread.Stop();
+
+  EXPECT_FALSE(queue->IsEmpty());
+  EXPECT_EQ(3u, queue->GetNumberOfPendingTasks());
+  EXPECT_TRUE(queue->HasTaskToRunImmediatelyOrReadyDelayedTask());
+
+  queue->task_runner()->PostTask(FROM_HERE, BindOnce(&TestTask, 4, &run_order));
+  EXPECT_EQ(4u, queue->GetNumberOfPendingTasks());
+
+  RunLoop().RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(1u, 2u, 3u, 4u));
+  EXPECT_TRUE(queue->IsEmpty());
+  EXPECT_EQ(0u, queue->GetNumberOfPendingTasks());
+  EXPECT_FALSE(queue->HasTaskToRunImmediatelyOrReadyDelayedTask());
+}
+
 TEST_P(SequenceManagerTest,
        HasTaskToRunImmediatelyOrReadyDelayedTask_DelayedTasks) {
   auto queue = CreateTaskQueue();
@@ -5469,6 +5592,32 @@ TEST_P(SequenceManagerTest, OnTaskPostedCallbacks) {
   EXPECT_EQ(2, counter2);
 }
 
+// With kLockFreeImmediateIncomingQueue, tasks are only posted without the lock
+// while there is no OnTaskPostedHandler. Tasks posted either way must stay in
+// order.
+TEST_P(SequenceManagerTest, OnTaskPostedHandlerChangedWithPendingTasks) {
+  auto queue = CreateTaskQueue();
+  std::vector<EnqueueOrder> run_order;
+  int counter = 0;
+
+  queue->task_runner()->PostTask(FROM_HERE, BindOnce(&TestTask, 1, &run_order));
+  std::unique_ptr<TaskQueue::OnTaskPostedCallbackHandle> handle =
+      queue->AddOnTaskPostedHandler(BindRepeating(
+          [](int* counter, const Task& task) { ++(*counter); }, &counter));
+  EXPECT_EQ(0, counter);
+
+  queue->task_runner()->PostTask(FROM_HERE, BindOnce(&TestTask, 2, &run_order));
+  EXPECT_EQ(1, counter);
+
+  handle.reset();
+  queue->task_runner()->PostTask(FROM_HERE, BindOnce(&TestTask, 3, &run_order));
+  EXPECT_EQ(1, counter);
+  EXPECT_EQ(3u, queue->GetNumberOfPendingTasks());
+
+  RunLoop().RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(1u, 2u, 3u));
+}
+
 // `RunOrPostTask` is tightly integrated with `ThreadControllerWithMessagePump`
 // and `RunLoop` so its tests can't use `SequenceManagerTest`.
 class SequenceManagerRunOrPostTaskTest : public testing::Test {
@@ -6057,6 +6206,106 @@ TEST(SequenceManagerTest, BindOnDifferentThreadWithActiveVoters) {
   EXPECT_THAT(results, ElementsAre(false, true));
 }
 
+class SequenceManagerDeadlineTest : public testing::Test {
+ public:
+  SequenceManagerDeadlineTest()
+      : test_task_runner_(MakeRefCounted<TestMockTimeTaskRunner>(
+            TestMockTimeTaskRunner::Type::kBoundToThread)) {
+    // A null clock triggers some assertions.
+    test_task_runner_->AdvanceMockTickClock(Milliseconds(1));
+  }
+
+  void CreateSequenceManager(bool earliest_deadline_first) {
+    sequence_manager_ = SequenceManagerForTest::Create(
+        nullptr, SingleThreadTaskRunner::GetCurrentDefault(),
+        test_task_runner_->GetMockTickClock(),
+        SequenceManager::Settings::Builder()
+            .SetTickClock(test_task_runner_->GetMockTickClock())
+            .SetEarliestDeadlineFirst(earliest_deadline_first)
+            .Build());
+    for (int i = 0; i < 3; ++i) {
+      queues_.push_back(sequence_manager_->CreateTaskQueue(
+          TaskQueue::Spec(QueueName::TEST_TQ)));
+    }
+  }
+
+  TimeTicks Now() const { return test_task_runner_->NowTicks(); }
+
+  // Posts tasks which append to |run_order|: 1 without deadline, then 2 with a
+  // distant deadline and 3 with a close deadline, each to its own queue.
+  void PostTasksWithDeadlines(std::vector<EnqueueOrder>* run_order) {
+    queues_[0]->task_runner()->PostTask(
+        FROM_HERE, BindOnce(&TestTask, 1, run_order));
+    queues_[1]->PostTaskWithDeadline(FROM_HERE,
+                                     BindOnce(&TestTask, 2, run_order),
+                                     Now() + Milliseconds(30));
+    queues_[2]->PostTaskWithDeadline(FROM_HERE,
+                                     BindOnce(&TestTask, 3, run_order),
+                                     Now() + Milliseconds(10));
+  }
+
+ protected:
+  scoped_refptr<TestMockTimeTaskRunner> test_task_runner_;
+  std::unique_ptr<SequenceManagerForTest> sequence_manager_;
+  std::vector<TaskQueue::Handle> queues_;
+};
+
+TEST_F(SequenceManagerDeadlineTest, EarliestDeadlineFirst) {
+  CreateSequenceManager(/*earliest_deadline_first=*/true);
+  std::vector<EnqueueOrder> run_order;
+  PostTasksWithDeadlines(&run_order);
+  test_task_runner_->RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(3u, 2u, 1u));
+}
+
+TEST_F(SequenceManagerDeadlineTest, EarliestDeadlineFirstWithinQueue) {
+  CreateSequenceManager(/*earliest_deadline_first=*/true);
+  std::vector<EnqueueOrder> run_order;
+  // The tasks of a queue run in posting order, whatever their deadline.
+  queues_[0]->PostTaskWithDeadline(FROM_HERE,
+                                   BindOnce(&TestTask, 1, &run_order),
+                                   Now() + Milliseconds(30));
+  queues_[0]->PostTaskWithDeadline(FROM_HERE,
+                                   BindOnce(&TestTask, 2, &run_order),
+                                   Now() + Milliseconds(10));
+  queues_[1]->PostTaskWithDeadline(FROM_HERE,
+                                   BindOnce(&TestTask, 3, &run_order),
+                                   Now() + Milliseconds(20));
+  test_task_runner_->RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(3u, 1u, 2u));
+}
+
+TEST_F(SequenceManagerDeadlineTest, DeadlinesIgnoredByDefault) {
+  CreateSequenceManager(/*earliest_deadline_first=*/false);
+  std::vector<EnqueueOrder> run_order;
+  PostTasksWithDeadlines(&run_order);
+  test_task_runner_->RunUntilIdle();
+  EXPECT_THAT(run_order, ElementsAre(1u, 2u, 3u));
+}
+
+TEST_F(SequenceManagerDeadlineTest, DeadlineStatistics) {
+  CreateSequenceManager(/*earliest_deadline_first=*/true);
+  const TimeTicks deadline = Now() + Milliseconds(30);
+  // Each task takes 20ms, so they complete at 20ms, 40ms and 60ms.
+  for (int i = 0; i < 3; ++i) {
+    queues_[0]->PostTaskWithDeadline(FROM_HERE, BindLambdaForTesting([&] {
+                                       test_task_runner_->AdvanceMockTickClock(
+                                           Milliseconds(20));
+                                     }),
+                                     deadline);
+  }
+  queues_[0]->task_runner()->PostTask(FROM_HERE, DoNothing());
+  test_task_runner_->RunUntilIdle();
+
+  TaskQueue::DeadlineStatistics statistics =
+      queues_[0]->GetDeadlineStatistics();
+  EXPECT_EQ(statistics.tasks_with_deadline, 3u);
+  EXPECT_EQ(statistics.missed_deadlines, 2u);
+  EXPECT_EQ(statistics.total_lateness, Milliseconds(40));
+  EXPECT_EQ(statistics.max_lateness, Milliseconds(30));
+  EXPECT_EQ(queues_[1]->GetDeadlineStatistics().tasks_with_deadline, 0u);
+}
+
 }  // namespace internal
 }  // namespace sequence_manager
 }  // namespace base
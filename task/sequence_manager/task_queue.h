@@ -389,6 +389,31 @@ class BASE_EXPORT TaskQueue {
   // Default task runner which doesn't annotate tasks with a task type.
   virtual const scoped_refptr<SingleThreadTaskRunner>& task_runner() const = 0;
 
+  // Posts |task| to run as soon as possible, and completed by |deadline|. If
+  // the SequenceManager was created with Settings::earliest_deadline_first,
+  // the queues of a given priority are selected by the deadline of their next
+  // task, queues whose next task has no deadline coming last. Tasks of a queue
+  // still run in posting order, so a task only gets ahead of the tasks of
+  // other queues. Otherwise, the deadline is only used for the statistics
+  // below. Returns false if the task was not posted, as PostTask() does.
+  // Can be called on any thread, as long as the TaskQueue is alive.
+  virtual bool PostTaskWithDeadline(const Location& from_here,
+                                    OnceClosure task,
+                                    TimeTicks deadline) = 0;
+
+  // Statistics about the tasks posted with PostTaskWithDeadline() that ran.
+  struct DeadlineStatistics {
+    size_t tasks_with_deadline = 0;
+    // Tasks which completed after their deadline.
+    size_t missed_deadlines = 0;
+    // Sum and maximum of the time by which the missed deadlines were missed.
+    TimeDelta total_lateness;
+    TimeDelta max_lateness;
+  };
+
+  // NOTE this must be called on the thread this TaskQueue was created by.
+  virtual DeadlineStatistics GetDeadlineStatistics() const = 0;
+
   using OnTaskStartedHandler =
       RepeatingCallback<void(const Task&, const TaskQueue::TaskTiming&)>;
   using OnTaskCompletedHandler =
@@ -6,6 +6,7 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -71,6 +72,7 @@ std::atomic<base::TimeDelta> g_max_precise_delay{kDefaultMaxPreciseDelay};
 // tasks are posted cross-thread, which can race with its initialization.
 std::atomic_bool g_explicit_high_resolution_timer_win{true};
 #endif  // BUILDFLAG(IS_WIN)
+std::atomic_bool g_use_lock_free_incoming_queue{false};
 
 void RunTaskSynchronously(const AssociatedThreadId* associated_thread,
                           scoped_refptr<SingleThreadTaskRunner> task_runner,
@@ -240,6 +242,9 @@ void TaskQueueImpl::InitializeFeatures() {
       FeatureList::IsEnabled(kExplicitHighResolutionTimerWin),
       std::memory_order_relaxed);
 #endif  // BUILDFLAG(IS_WIN)
+  g_use_lock_free_incoming_queue.store(
+      FeatureList::IsEnabled(kLockFreeImmediateIncomingQueue),
+      std::memory_order_relaxed);
 }
 
 TaskQueueImpl::TaskQueueImpl(SequenceManagerImpl* sequence_manager,
@@ -259,6 +264,8 @@ TaskQueueImpl::TaskQueueImpl(SequenceManagerImpl* sequence_manager,
       should_monitor_quiescence_(spec.should_monitor_quiescence),
       should_notify_observers_(spec.should_notify_observers),
       delayed_fence_allowed_(spec.delayed_fence_allowed),
+      use_lock_free_incoming_queue_(
+          g_use_lock_free_incoming_queue.load(std::memory_order_relaxed)),
       default_task_runner_(CreateTaskRunner(kTaskTypeNone)) {
   UpdateCrossThreadQueueStateLocked();
   // SequenceManager can't be set later, so we need to prevent task runners
@@ -308,6 +315,32 @@ const scoped_refptr<SingleThreadTaskRunner>& TaskQueueImpl::task_runner()
   return default_task_runner_;
 }
 
+bool TaskQueueImpl::PostTaskWithDeadline(const Location& from_here,
+                                         OnceClosure task,
+                                         TimeTicks deadline) {
+  PostedTask posted_task(default_task_runner_, std::move(task), from_here);
+  posted_task.deadline = deadline;
+  return task_poster_->PostTask(std::move(posted_task));
+}
+
+TaskQueue::DeadlineStatistics TaskQueueImpl::GetDeadlineStatistics() const {
+  DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
+  return main_thread_only().deadline_statistics;
+}
+
+void TaskQueueImpl::RecordTaskDeadline(const Task& task, TimeTicks now) {
+  DCHECK(!task.deadline.is_null());
+  DeadlineStatistics& statistics = main_thread_only().deadline_statistics;
+  ++statistics.tasks_with_deadline;
+  if (now <= task.deadline) {
+    return;
+  }
+  const TimeDelta lateness = now - task.deadline;
+  ++statistics.missed_deadlines;
+  statistics.total_lateness += lateness;
+  statistics.max_lateness = std::max(statistics.max_lateness, lateness);
+}
+
 void TaskQueueImpl::UnregisterTaskQueue() {
   TRACE_EVENT0("base", "TaskQueueImpl::UnregisterTaskQueue");
   // Invalidate weak pointers now so no voters reference this in a partially
@@ -326,11 +359,13 @@ void TaskQueueImpl::UnregisterTaskQueue() {
   {
     base::internal::CheckedAutoLock lock(any_thread_lock_);
     any_thread_.unregistered = true;
+    MoveLockFreeIncomingTasksLocked();
     immediate_incoming_queue.swap(any_thread_.immediate_incoming_queue);
 
     for (auto& handler : any_thread_.on_task_posted_handlers)
       handler.first->UnregisterTaskQueue();
     any_thread_.on_task_posted_handlers.swap(on_task_posted_handlers);
+    has_on_task_posted_handlers_.store(false, std::memory_order_relaxed);
   }
 
   if (main_thread_only().wake_up_queue) {
@@ -434,11 +469,20 @@ void TaskQueueImpl::PostImmediateTaskImpl(PostedTask task,
   // for details.
   CHECK(task.callback);
 
+  // OnTaskPostedHandlers are run under the lock, so they can't be run when
+  // posting lock-free.
+  if (use_lock_free_incoming_queue_ &&
+      !has_on_task_posted_handlers_.load(std::memory_order_relaxed)) {
+    PostImmediateTaskLockFree(std::move(task), current_thread);
+    return;
+  }
+
   bool should_schedule_work = false;
   {
     // TODO(alexclarke): Maybe add a main thread only immediate_incoming_queue
     // See https://crbug.com/901800
     base::internal::CheckedAutoLock lock(any_thread_lock_);
+    MoveLockFreeIncomingTasksLocked();
     bool add_queue_time_to_tasks = sequence_manager_->GetAddQueueTimeToTasks();
     TimeTicks queue_time;
     if (add_queue_time_to_tasks || delayed_fence_allowed_)
@@ -453,6 +497,7 @@ void TaskQueueImpl::PostImmediateTaskImpl(PostedTask task,
         any_thread_.immediate_incoming_queue.empty();
     any_thread_.immediate_incoming_queue.push_back(
         Task(std::move(task), sequence_number, sequence_number, queue_time));
+    any_thread_.last_immediate_incoming_enqueue_order = sequence_number;
 
 #if DCHECK_IS_ON()
     any_thread_.immediate_incoming_queue.back().cross_thread_ =
@@ -499,6 +544,63 @@ void TaskQueueImpl::PostImmediateTaskImpl(PostedTask task,
   TraceQueueSize();
 }
 
+void TaskQueueImpl::PostImmediateTaskLockFree(PostedTask task,
+                                              CurrentThread current_thread) {
+  TimeTicks queue_time;
+  if (sequence_manager_->GetAddQueueTimeToTasks() || delayed_fence_allowed_)
+    queue_time = sequence_manager_->any_thread_clock()->NowTicks();
+
+  // Unlike in PostImmediateTaskImpl(), the sequence number isn't taken
+  // atomically with pushing the task. MoveLockFreeIncomingTasksLocked() orders
+  // the tasks by sequence number instead, and gives a task a new enqueue order
+  // if tasks with a higher sequence number were already moved.
+  EnqueueOrder sequence_number = sequence_manager_->GetNextSequenceNumber();
+  Task pending_task(std::move(task), sequence_number, EnqueueOrder(),
+                    queue_time);
+#if DCHECK_IS_ON()
+  pending_task.cross_thread_ =
+      (current_thread == TaskQueueImpl::CurrentThread::kNotMainThread);
+#endif
+
+  sequence_manager_->WillQueueTask(&pending_task);
+  MaybeReportIpcTaskQueuedFromAnyThreadUnlocked(pending_task);
+
+  // Only the task that makes the queue non-empty needs to check whether the
+  // SequenceManager must be informed, as in PostImmediateTaskImpl(). This is
+  // checked after pushing the task, so a reload that would miss it can't race
+  // with the check.
+  bool should_schedule_work = false;
+  if (lock_free_incoming_queue_.Push(std::move(pending_task),
+                                     sequence_number)) {
+    base::internal::CheckedAutoLock lock(any_thread_lock_);
+    if (any_thread_.immediate_work_queue_empty) {
+      sequence_manager_->WillRequestReloadImmediateWorkQueue();
+      empty_queues_to_reload_handle_.SetActive(true);
+      should_schedule_work =
+          any_thread_.post_immediate_task_should_schedule_work;
+    }
+  }
+
+  // See PostImmediateTaskImpl() for why this is called outside of the lock.
+  if (should_schedule_work)
+    sequence_manager_->ScheduleWork();
+
+  TraceQueueSize();
+}
+
+void TaskQueueImpl::MoveLockFreeIncomingTasksLocked() {
+  if (lock_free_incoming_queue_.empty())
+    return;
+  lock_free_incoming_queue_.TakeTasks(
+      any_thread_.last_immediate_incoming_enqueue_order,
+      [this] { return sequence_manager_->GetNextSequenceNumber(); },
+      [this](Task task) {
+        any_thread_.last_immediate_incoming_enqueue_order =
+            task.enqueue_order();
+        any_thread_.immediate_incoming_queue.push_back(std::move(task));
+      });
+}
+
 void TaskQueueImpl::PostDelayedTaskImpl(PostedTask posted_task,
                                         CurrentThread current_thread) {
   // Use CHECK instead of DCHECK to crash earlier. See http://crbug.com/711167
@@ -595,6 +697,7 @@ void TaskQueueImpl::TakeImmediateIncomingQueueTasks(TaskDeque* queue) {
   queue->MaybeShrinkQueue();
 
   base::internal::CheckedAutoLock lock(any_thread_lock_);
+  MoveLockFreeIncomingTasksLocked();
   queue->swap(any_thread_.immediate_incoming_queue);
 
   // Activate delayed fence if necessary. This is ideologically similar to
@@ -632,7 +735,8 @@ bool TaskQueueImpl::IsEmpty() const {
   }
 
   base::internal::CheckedAutoLock lock(any_thread_lock_);
-  return any_thread_.immediate_incoming_queue.empty();
+  return any_thread_.immediate_incoming_queue.empty() &&
+         lock_free_incoming_queue_.empty();
 }
 
 size_t TaskQueueImpl::GetNumberOfPendingTasks() const {
@@ -643,6 +747,7 @@ size_t TaskQueueImpl::GetNumberOfPendingTasks() const {
 
   base::internal::CheckedAutoLock lock(any_thread_lock_);
   task_count += any_thread_.immediate_incoming_queue.size();
+  task_count += lock_free_incoming_queue_.size();
   return task_count;
 }
 
@@ -661,9 +766,11 @@ bool TaskQueueImpl::HasTaskToRunImmediatelyOrReadyDelayedTask() const {
     return true;
   }
 
-  // Finally tasks on |immediate_incoming_queue| count as immediate work.
+  // Finally tasks on |immediate_incoming_queue| and
+  // |lock_free_incoming_queue_| count as immediate work.
   base::internal::CheckedAutoLock lock(any_thread_lock_);
-  return !any_thread_.immediate_incoming_queue.empty();
+  return !any_thread_.immediate_incoming_queue.empty() ||
+         !lock_free_incoming_queue_.empty();
 }
 
 std::optional<WakeUp> TaskQueueImpl::GetNextDesiredWakeUp() {
@@ -784,6 +891,7 @@ void TaskQueueImpl::TraceQueueSize() const {
   {
     base::internal::CheckedAutoLock lock(any_thread_lock_);
     total_task_count = any_thread_.immediate_incoming_queue.size() +
+                       lock_free_incoming_queue_.size() +
                        main_thread_only().immediate_work_queue->Size() +
                        main_thread_only().delayed_work_queue->Size() +
                        main_thread_only().delayed_incoming_queue.size();
@@ -848,6 +956,8 @@ Value::Dict TaskQueueImpl::AsValue(TimeTicks now, bool force_verbose) const {
   // remove the various static_casts below.
   state.Set("any_thread_.immediate_incoming_queuesize",
             static_cast<int>(any_thread_.immediate_incoming_queue.size()));
+  state.Set("lock_free_incoming_queue_size",
+            static_cast<int>(lock_free_incoming_queue_.size()));
   state.Set("delayed_incoming_queue_size",
             static_cast<int>(main_thread_only().delayed_incoming_queue.size()));
   state.Set("immediate_work_queue_size",
@@ -950,6 +1060,7 @@ void TaskQueueImpl::InsertFence(Fence current_fence) {
 
   {
     base::internal::CheckedAutoLock lock(any_thread_lock_);
+    MoveLockFreeIncomingTasksLocked();
     if (!front_task_unblocked && previous_fence &&
         previous_fence->task_order() < current_fence.task_order()) {
       if (!any_thread_.immediate_incoming_queue.empty() &&
@@ -991,6 +1102,7 @@ void TaskQueueImpl::RemoveFence() {
 
   {
     base::internal::CheckedAutoLock lock(any_thread_lock_);
+    MoveLockFreeIncomingTasksLocked();
     if (!front_task_unblocked && previous_fence) {
       if (!any_thread_.immediate_incoming_queue.empty() &&
           any_thread_.immediate_incoming_queue.front().task_order() >
@@ -1018,11 +1130,25 @@ bool TaskQueueImpl::BlockedByFence() const {
   }
 
   base::internal::CheckedAutoLock lock(any_thread_lock_);
-  if (any_thread_.immediate_incoming_queue.empty())
+  if (!any_thread_.immediate_incoming_queue.empty()) {
+    return any_thread_.immediate_incoming_queue.front().task_order() >
+           main_thread_only().current_fence->task_order();
+  }
+  if (lock_free_incoming_queue_.empty())
     return true;
 
-  return any_thread_.immediate_incoming_queue.front().task_order() >
-         main_thread_only().current_fence->task_order();
+  // The first task of |lock_free_incoming_queue_| is the one with the lowest
+  // sequence order. If it isn't after the last task moved to
+  // |immediate_incoming_queue|, it gets a new enqueue order when moved, which
+  // is after the fence. Otherwise it keeps its sequence order as its enqueue
+  // order. Enqueue orders are never shared by a task and a fence, so comparing
+  // them is enough.
+  const EnqueueOrder sequence_order =
+      lock_free_incoming_queue_.GetLowestSequenceOrder();
+  if (sequence_order <= any_thread_.last_immediate_incoming_enqueue_order)
+    return true;
+  return sequence_order >
+         main_thread_only().current_fence->task_order().enqueue_order();
 }
 
 bool TaskQueueImpl::HasActiveFence() {
@@ -1251,6 +1377,8 @@ void TaskQueueImpl::ReclaimMemory(TimeTicks now) {
 
 void TaskQueueImpl::PushImmediateIncomingTaskForTest(Task task) {
   base::internal::CheckedAutoLock lock(any_thread_lock_);
+  MoveLockFreeIncomingTasksLocked();
+  any_thread_.last_immediate_incoming_enqueue_order = task.enqueue_order();
   any_thread_.immediate_incoming_queue.push_back(std::move(task));
 }
 
@@ -1335,15 +1463,18 @@ bool TaskQueueImpl::HasTaskToRunImmediately() const {
     return true;
   }
 
-  // Finally tasks on |immediate_incoming_queue| count as immediate work.
+  // Finally tasks on |immediate_incoming_queue| and
+  // |lock_free_incoming_queue_| count as immediate work.
   base::internal::CheckedAutoLock lock(any_thread_lock_);
-  return !any_thread_.immediate_incoming_queue.empty();
+  return !any_thread_.immediate_incoming_queue.empty() ||
+         !lock_free_incoming_queue_.empty();
 }
 
 bool TaskQueueImpl::HasTaskToRunImmediatelyLocked() const {
   return !main_thread_only().delayed_work_queue->Empty() ||
          !main_thread_only().immediate_work_queue->Empty() ||
-         !any_thread_.immediate_incoming_queue.empty();
+         !any_thread_.immediate_incoming_queue.empty() ||
+         !lock_free_incoming_queue_.empty();
 }
 
 void TaskQueueImpl::SetOnTaskStartedHandler(
@@ -1387,6 +1518,7 @@ TaskQueueImpl::AddOnTaskPostedHandler(OnTaskPostedHandler handler) {
   base::internal::CheckedAutoLock lock(any_thread_lock_);
   any_thread_.on_task_posted_handlers.insert(
       {handle.get(), std::move(handler)});
+  has_on_task_posted_handlers_.store(true, std::memory_order_relaxed);
   return handle;
 }
 
@@ -1395,6 +1527,8 @@ void TaskQueueImpl::RemoveOnTaskPostedHandler(
         on_task_posted_callback_handle) {
   base::internal::CheckedAutoLock lock(any_thread_lock_);
   any_thread_.on_task_posted_handlers.erase(on_task_posted_callback_handle);
+  has_on_task_posted_handlers_.store(
+      !any_thread_.on_task_posted_handlers.empty(), std::memory_order_relaxed);
 }
 
 void TaskQueueImpl::SetTaskExecutionTraceLogger(
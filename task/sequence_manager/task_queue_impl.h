@@ -7,6 +7,7 @@
 
 #include <stddef.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -33,6 +34,7 @@
 #include "base/task/sequence_manager/enqueue_order.h"
 #include "base/task/sequence_manager/fence.h"
 #include "base/task/sequence_manager/lazily_deallocated_deque.h"
+#include "base/task/sequence_manager/lock_free_task_queue.h"
 #include "base/task/sequence_manager/sequenced_task_source.h"
 #include "base/task/sequence_manager/task_queue.h"
 #include "base/task/sequence_manager/tasks.h"
@@ -140,6 +142,10 @@ class BASE_EXPORT TaskQueueImpl : public TaskQueue {
   scoped_refptr<SingleThreadTaskRunner> CreateTaskRunner(
       TaskType task_type) const override;
   const scoped_refptr<SingleThreadTaskRunner>& task_runner() const override;
+  bool PostTaskWithDeadline(const Location& from_here,
+                            OnceClosure task,
+                            TimeTicks deadline) override;
+  DeadlineStatistics GetDeadlineStatistics() const override;
   void SetOnTaskStartedHandler(OnTaskStartedHandler handler) override;
   void SetOnTaskCompletedHandler(OnTaskCompletedHandler handler) override;
   [[nodiscard]] std::unique_ptr<TaskQueue::OnTaskPostedCallbackHandle>
@@ -170,6 +176,10 @@ class BASE_EXPORT TaskQueueImpl : public TaskQueue {
   bool GetQuiescenceMonitored() const { return should_monitor_quiescence_; }
   bool GetShouldNotifyObservers() const { return should_notify_observers_; }
 
+  // Records the completion of |task|, which has a deadline, at |now| in the
+  // deadline statistics.
+  void RecordTaskDeadline(const Task& task, TimeTicks now);
+
   void NotifyWillProcessTask(const Task& task,
                              bool was_blocked_or_low_priority);
   void NotifyDidProcessTask(const Task& task);
@@ -409,7 +419,8 @@ class BASE_EXPORT TaskQueueImpl : public TaskQueue {
     struct Compare {
       bool operator()(const Task& lhs, const Task& rhs) const;
     };
-    IntrusiveHeap<Task, Compare> queue_;
+    // 4-ary, since this can hold many tasks, which are mostly popped.
+    IntrusiveHeap<Task, Compare, DefaultHeapHandleAccessor<Task>, 4> queue_;
 
     // Number of pending tasks in the queue that need high resolution timing.
     int pending_high_res_tasks_ = 0;
@@ -459,6 +470,7 @@ class BASE_EXPORT TaskQueueImpl : public TaskQueue {
     OnTaskStartedHandler on_task_started_handler;
     OnTaskCompletedHandler on_task_completed_handler;
     TaskExecutionTraceLogger task_execution_trace_logger;
+    DeadlineStatistics deadline_statistics;
     // Last reported wake up, used only in UpdateWakeUp to avoid
     // excessive calls.
     std::optional<WakeUp> scheduled_wake_up;
@@ -481,6 +493,19 @@ class BASE_EXPORT TaskQueueImpl : public TaskQueue {
   void PostImmediateTaskImpl(PostedTask task, CurrentThread current_thread);
   void PostDelayedTaskImpl(PostedTask task, CurrentThread current_thread);
 
+  // Pushes the task onto |lock_free_incoming_queue_|, only taking
+  // |any_thread_lock_| if the queue was empty and the SequenceManager may
+  // need to be informed.
+  void PostImmediateTaskLockFree(PostedTask task,
+                                 CurrentThread current_thread);
+
+  // Moves the tasks of |lock_free_incoming_queue_| to the back of
+  // |immediate_incoming_queue|. This doesn't change the set of pending tasks,
+  // and is done before any change to |immediate_incoming_queue|. Const methods
+  // look at both queues instead.
+  void MoveLockFreeIncomingTasksLocked()
+      EXCLUSIVE_LOCKS_REQUIRED(any_thread_lock_);
+
   // Push the task onto the |delayed_incoming_queue|. Lock-free main thread
   // only fast path.
   void PushOntoDelayedIncomingQueueFromMainThread(Task pending_task,
@@ -578,6 +603,10 @@ class BASE_EXPORT TaskQueueImpl : public TaskQueue {
 
     TaskDeque immediate_incoming_queue;
 
+    // Enqueue order of the last task added to |immediate_incoming_queue|. Tasks
+    // moved from |lock_free_incoming_queue_| must be ordered after it.
+    EnqueueOrder last_immediate_incoming_enqueue_order;
+
     bool immediate_work_queue_empty = true;
     bool post_immediate_task_should_schedule_work = true;
     bool unregistered = false;
@@ -620,6 +649,19 @@ class BASE_EXPORT TaskQueueImpl : public TaskQueue {
   const bool should_notify_observers_;
   const bool delayed_fence_allowed_;
 
+  // Whether immediate tasks are posted to |lock_free_incoming_queue_| rather
+  // than to |any_thread_.immediate_incoming_queue|, under the
+  // kLockFreeImmediateIncomingQueue feature.
+  const bool use_lock_free_incoming_queue_;
+
+  // Immediate tasks posted without holding |any_thread_lock_|. Only taken from
+  // while holding it, by MoveLockFreeIncomingTasksLocked().
+  LockFreeTaskQueue lock_free_incoming_queue_;
+
+  // Mirrors !|any_thread_.on_task_posted_handlers.empty()|. Posting takes
+  // |any_thread_lock_| while there are handlers, to run them.
+  std::atomic_bool has_on_task_posted_handlers_{false};
+
   const scoped_refptr<SingleThreadTaskRunner> default_task_runner_;
 
   base::WeakPtrFactory<TaskQueueImpl> voter_weak_ptr_factory_{this};
@@ -4,11 +4,13 @@
 
 #include "base/task/sequence_manager/task_queue_selector.h"
 
+#include <algorithm>
 #include <bit>
 #include <optional>
 #include <utility>
 
 #include "base/check_op.h"
+#include "base/feature_list.h"
 #include "base/task/sequence_manager/associated_thread_id.h"
 #include "base/task/sequence_manager/task_queue_impl.h"
 #include "base/task/sequence_manager/work_queue.h"
@@ -22,6 +24,7 @@ namespace internal {
 
 std::atomic_int TaskQueueSelector::g_max_delayed_starvation_tasks =
     TaskQueueSelector::kDefaultMaxDelayedStarvationTasks;
+std::atomic_int TaskQueueSelector::g_max_batch_size = 1;
 
 TaskQueueSelector::TaskQueueSelector(
     scoped_refptr<const AssociatedThreadId> associated_thread,
@@ -32,6 +35,7 @@ TaskQueueSelector::TaskQueueSelector(
 #endif
       non_empty_set_counts_(
           std::vector<int>(settings.priority_settings.priority_count(), 0)),
+      earliest_deadline_first_(settings.earliest_deadline_first),
       delayed_work_queue_sets_("delayed", this, settings),
       immediate_work_queue_sets_("immediate", this, settings) {
 }
@@ -42,6 +46,10 @@ TaskQueueSelector::~TaskQueueSelector() = default;
 void TaskQueueSelector::InitializeFeatures() {
   g_max_delayed_starvation_tasks.store(kMaxDelayedStarvationTasksParam.Get(),
                                        std::memory_order_relaxed);
+  g_max_batch_size.store(FeatureList::IsEnabled(kTaskQueueSelectorBatching)
+                             ? std::max(kTaskQueueSelectorBatchSize.Get(), 1)
+                             : 1,
+                         std::memory_order_relaxed);
 }
 
 void TaskQueueSelector::AddQueue(internal::TaskQueueImpl* queue,
@@ -104,6 +112,7 @@ void TaskQueueSelector::ChangeSetIndex(internal::TaskQueueImpl* queue,
 #if DCHECK_IS_ON()
   DCHECK(CheckContainsQueueForTest(queue));
 #endif
+  EndBatchIfFrom(queue);
   delayed_work_queue_sets_.ChangeSetIndex(queue->delayed_work_queue(),
                                           priority);
   immediate_work_queue_sets_.ChangeSetIndex(queue->immediate_work_queue(),
@@ -117,6 +126,7 @@ void TaskQueueSelector::RemoveQueueImpl(internal::TaskQueueImpl* queue) {
 #if DCHECK_IS_ON()
   DCHECK(CheckContainsQueueForTest(queue));
 #endif
+  EndBatchIfFrom(queue);
   delayed_work_queue_sets_.RemoveQueue(queue->delayed_work_queue());
   immediate_work_queue_sets_.RemoveQueue(queue->immediate_work_queue());
 
@@ -192,6 +202,20 @@ WorkQueue* TaskQueueSelector::SelectWorkQueueToService(
   // priority.
   TaskQueue::QueuePriority priority = highest_priority.value();
 
+  // Keep selecting the queue of the current batch while it's runnable and no
+  // higher priority work is pending. This skips comparing it with the other
+  // queues of the same priority, so it may run up to |g_max_batch_size| tasks
+  // before older tasks of that priority.
+  if (batch_tasks_remaining_ > 0 && option == SelectTaskOption::kDefault) {
+    if (batch_work_queue_->heap_handle().IsValid() &&
+        batch_work_queue_->work_queue_set_index() == priority) {
+      --batch_tasks_remaining_;
+      immediate_starvation_count_ = 0;
+      return batch_work_queue_;
+    }
+    batch_tasks_remaining_ = 0;
+  }
+
   // For selecting an immediate queue only, the highest priority can be used as
   // a starting priority, but it is required to check work at other priorities.
   // For the case where a delayed task is at a higher priority than an immediate
@@ -223,9 +247,23 @@ WorkQueue* TaskQueueSelector::SelectWorkQueueToService(
   } else {
     immediate_starvation_count_ = 0;
   }
+
+  if (queue->queue_type() == WorkQueue::QueueType::kImmediate &&
+      !earliest_deadline_first_) {
+    batch_work_queue_ = queue;
+    batch_tasks_remaining_ =
+        g_max_batch_size.load(std::memory_order_relaxed) - 1;
+  }
   return queue;
 }
 
+void TaskQueueSelector::EndBatchIfFrom(internal::TaskQueueImpl* queue) {
+  if (batch_work_queue_ && batch_work_queue_->task_queue() == queue) {
+    batch_work_queue_ = nullptr;
+    batch_tasks_remaining_ = 0;
+  }
+}
+
 Value::Dict TaskQueueSelector::AsValue() const {
   DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
   Value::Dict state;
@@ -212,6 +212,9 @@ class BASE_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
                     TaskQueue::QueuePriority priority);
   void RemoveQueueImpl(internal::TaskQueueImpl* queue);
 
+  // Ends the current batch if it selects from a work queue of |queue|.
+  void EndBatchIfFrom(internal::TaskQueueImpl* queue);
+
 #if DCHECK_IS_ON() || !defined(NDEBUG)
   bool CheckContainsQueueForTest(const internal::TaskQueueImpl* queue) const;
 #endif
@@ -223,7 +226,7 @@ class BASE_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
             immediate_work_queue_sets_, priority)) {
       if (auto delayed_queue_and_order = SetOperation::GetWithPriority(
               delayed_work_queue_sets_, priority)) {
-        return immediate_queue_and_order->order < delayed_queue_and_order->order
+        return immediate_queue_and_order->RunsBefore(*delayed_queue_and_order)
                    ? immediate_queue_and_order->queue
                    : delayed_queue_and_order->queue;
       }
@@ -249,6 +252,13 @@ class BASE_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
   // An atomic is used here because InitializeFeatures() can race with
   // SequenceManager reading this.
   static std::atomic_int g_max_delayed_starvation_tasks;
+  // Batches are disabled when selecting tasks by deadline, since a batch
+  // ignores the deadlines of the other queues.
+  const bool earliest_deadline_first_;
+
+  // Max number of consecutive tasks selected from |batch_work_queue_|. 1 if
+  // kTaskQueueSelectorBatching is disabled.
+  static std::atomic_int g_max_batch_size;
 
   // List of active priorities, which is used to work out which priority to run
   // next.
@@ -258,6 +268,12 @@ class BASE_EXPORT TaskQueueSelector : public WorkQueueSets::Observer {
   WorkQueueSets immediate_work_queue_sets_;
   int immediate_starvation_count_ = 0;
 
+  // The immediate work queue returned by the last full selection, which can
+  // be returned again up to |batch_tasks_remaining_| times without running
+  // the selection while it has the highest pending priority.
+  raw_ptr<WorkQueue> batch_work_queue_ = nullptr;
+  int batch_tasks_remaining_ = 0;
+
   raw_ptr<Observer> task_queue_selector_observer_ = nullptr;  // Not owned.
 };
 
@@ -13,6 +13,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <utility>
 #include <vector>
@@ -25,6 +26,8 @@
 #include "base/task/sequence_manager/test/mock_time_domain.h"
 #include "base/task/sequence_manager/work_queue.h"
 #include "base/task/sequence_manager/work_queue_sets.h"
+#include "base/task/task_features.h"
+#include "base/test/scoped_feature_list.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -592,6 +595,74 @@ TEST_F(TaskQueueSelectorTest, CollectSkippedOverLowerPriorityTasks) {
   EXPECT_EQ(4u, result[2]->enqueue_order());
 }
 
+class TaskQueueSelectorBatchingTest : public TaskQueueSelectorTest {
+ public:
+  TaskQueueSelectorBatchingTest() {
+    feature_list_.InitAndEnableFeatureWithParameters(
+        kTaskQueueSelectorBatching, {{"batch_size", "3"}});
+    TaskQueueSelector::InitializeFeatures();
+  }
+
+  ~TaskQueueSelectorBatchingTest() override {
+    feature_list_.Reset();
+    TaskQueueSelector::InitializeFeatures();
+  }
+
+ protected:
+  // Like PopTasksAndReturnQueueIndices(), but doesn't assume that the selected
+  // queue is the oldest of its set.
+  std::optional<size_t> PopTaskAndReturnQueueIndex() {
+    WorkQueue* chosen_work_queue = selector_.SelectWorkQueueToService();
+    if (!chosen_work_queue)
+      return std::nullopt;
+    chosen_work_queue->PopTaskForTesting();
+    chosen_work_queue->work_queue_sets()->OnQueuesFrontTaskChanged(
+        chosen_work_queue);
+    return queue_to_index_map_.find(chosen_work_queue->task_queue())->second;
+  }
+
+  test::ScopedFeatureList feature_list_;
+};
+
+TEST_F(TaskQueueSelectorBatchingTest, SelectsBatchesFromSameQueue) {
+  size_t enqueue_order[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  size_t queue_order[] = {0, 1, 0, 1, 0, 1, 0, 1};
+  PushTasksWithEnqueueOrder(queue_order, enqueue_order, 8);
+
+  std::vector<size_t> order;
+  while (std::optional<size_t> index = PopTaskAndReturnQueueIndex())
+    order.push_back(*index);
+  EXPECT_THAT(order, ElementsAre(0, 0, 0, 1, 1, 1, 0, 1));
+}
+
+TEST_F(TaskQueueSelectorBatchingTest, HigherPriorityWorkEndsBatch) {
+  size_t enqueue_order[] = {1, 2, 3, 4};
+  size_t queue_order[] = {0, 0, 0, 0};
+  PushTasksWithEnqueueOrder(queue_order, enqueue_order, 4);
+  EXPECT_EQ(0u, PopTaskAndReturnQueueIndex());
+
+  selector_.SetQueuePriority(task_queues_[1].get(), kHighPriority);
+  PushTask(1, 5);
+  EXPECT_EQ(1u, PopTaskAndReturnQueueIndex());
+  EXPECT_EQ(0u, PopTaskAndReturnQueueIndex());
+}
+
+TEST_F(TaskQueueSelectorBatchingTest, DisablingQueueEndsBatch) {
+  size_t enqueue_order[] = {1, 2, 3, 4};
+  size_t queue_order[] = {0, 0, 1, 1};
+  PushTasksWithEnqueueOrder(queue_order, enqueue_order, 4);
+  EXPECT_EQ(0u, PopTaskAndReturnQueueIndex());
+
+  task_queues_[0]->SetQueueEnabled(false);
+  selector_.DisableQueue(task_queues_[0].get());
+  EXPECT_EQ(1u, PopTaskAndReturnQueueIndex());
+  EXPECT_EQ(1u, PopTaskAndReturnQueueIndex());
+  EXPECT_EQ(std::nullopt, PopTaskAndReturnQueueIndex());
+
+  task_queues_[0]->SetQueueEnabled(true);
+  selector_.EnableQueue(task_queues_[0].get());
+}
+
 struct ChooseWithPriorityTestParam {
   int delayed_task_enqueue_order;
   int immediate_task_enqueue_order;
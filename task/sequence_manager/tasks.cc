@@ -27,6 +27,7 @@ Task::Task(internal::PostedTask posted_task,
                   posted_task.delay_policy),
       nestable(posted_task.nestable),
       task_type(posted_task.task_type),
+      deadline(posted_task.deadline),
       task_runner(std::move(posted_task.task_runner)),
       enqueue_order_(enqueue_order),
       delayed_task_handle_delegate_(
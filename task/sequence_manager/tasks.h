@@ -71,6 +71,9 @@ struct BASE_EXPORT PostedTask {
   // The delegate for the DelayedTaskHandle, if this task was posted through
   // PostCancelableDelayedTask(), nullptr otherwise.
   WeakPtr<DelayedTaskHandleDelegate> delayed_task_handle_delegate;
+  // The time by which the task should have run, if it was posted through
+  // TaskQueue::PostTaskWithDeadline(), null otherwise.
+  TimeTicks deadline;
 };
 
 }  // namespace internal
@@ -135,6 +138,10 @@ struct BASE_EXPORT Task : public PendingTask {
 
   TaskType task_type;
 
+  // The time by which the task should have run, or null if it has no deadline.
+  // See TaskQueue::PostTaskWithDeadline().
+  TimeTicks deadline;
+
   // The task runner this task is running on. Can be used by task runners that
   // support posting back to the "current sequence".
   scoped_refptr<SequencedTaskRunner> task_runner;
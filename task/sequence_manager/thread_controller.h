@@ -176,6 +176,9 @@ class BASE_EXPORT ThreadController {
   virtual bool RunsTasksInCurrentSequence() = 0;
   void SetTickClock(const TickClock* clock);
   virtual scoped_refptr<SingleThreadTaskRunner> GetDefaultTaskRunner() = 0;
+  // Returns a task runner for latency-critical tasks, which run before the
+  // tasks of the SequencedTaskSource (see FastLaneTaskRunner). Thread-safe.
+  virtual scoped_refptr<SingleThreadTaskRunner> GetFastLaneTaskRunner() = 0;
   virtual void RestoreDefaultTaskRunner() = 0;
   virtual void AddNestingObserver(RunLoop::NestingObserver* observer) = 0;
   virtual void RemoveNestingObserver(RunLoop::NestingObserver* observer) = 0;
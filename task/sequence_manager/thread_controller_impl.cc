@@ -143,6 +143,13 @@ ThreadControllerImpl::GetDefaultTaskRunner() {
   return funneled_sequence_manager_->GetTaskRunner();
 }
 
+scoped_refptr<SingleThreadTaskRunner>
+ThreadControllerImpl::GetFastLaneTaskRunner() {
+  // Tasks are funneled through the task runner of another SequenceManager,
+  // which has no fast lane.
+  return GetDefaultTaskRunner();
+}
+
 void ThreadControllerImpl::RestoreDefaultTaskRunner() {
   if (!funneled_sequence_manager_)
     return;
@@ -63,12 +63,23 @@ std::atomic_bool g_run_tasks_by_batches = false;
 std::atomic_bool g_avoid_schedule_calls_during_native_event_processing = false;
 
 base::TimeDelta GetLeewayForWakeUp(std::optional<WakeUp> wake_up) {
-  if (!wake_up || wake_up->delay_policy == subtle::DelayPolicy::kPrecise) {
+  if (!wake_up || wake_up->delay_policy == subtle::DelayPolicy::kPrecise ||
+      !MessagePump::GetAlignWakeUpsAllowedForCurrentThread()) {
     return TimeDelta();
   }
   return wake_up->leeway;
 }
 
+// Returns the time at which |pump| should wake up for |wake_up|, which is
+// aligned with the wake-ups of other threads unless this thread opted out.
+TimeTicks GetRunTimeForWakeUp(MessagePump* pump, const WakeUp& wake_up) {
+  if (!MessagePump::GetAlignWakeUpsAllowedForCurrentThread()) {
+    return wake_up.time;
+  }
+  return pump->AdjustDelayedRunTime(wake_up.earliest_time(), wake_up.time,
+                                    wake_up.latest_time());
+}
+
 }  // namespace
 
 // static
@@ -95,6 +106,7 @@ ThreadControllerWithMessagePumpImpl::ThreadControllerWithMessagePumpImpl(
     const SequenceManager::Settings& settings)
     : ThreadController(settings.clock),
       work_deduplicator_(associated_thread_),
+      fast_lane_task_runner_(MakeRefCounted<FastLaneTaskRunner>(this)),
       can_run_tasks_by_batches_(settings.can_run_tasks_by_batches) {}
 
 ThreadControllerWithMessagePumpImpl::ThreadControllerWithMessagePumpImpl(
@@ -105,6 +117,8 @@ ThreadControllerWithMessagePumpImpl::ThreadControllerWithMessagePumpImpl(
 }
 
 ThreadControllerWithMessagePumpImpl::~ThreadControllerWithMessagePumpImpl() {
+  fast_lane_task_runner_->Shutdown();
+
   // Destructors of MessagePump::Delegate and
   // SingleThreadTaskRunner::CurrentDefaultHandle will do all the clean-up.
   // ScopedSetSequenceLocalStorageMapForCurrentThread destructor will
@@ -203,11 +217,9 @@ void ThreadControllerWithMessagePumpImpl::SetNextDelayedDoWork(
       ShouldScheduleWork::kScheduleImmediate) {
     return;
   }
-  TimeTicks run_time =
-      wake_up.has_value()
-          ? pump_->AdjustDelayedRunTime(wake_up->earliest_time(), wake_up->time,
-                                        wake_up->latest_time())
-          : TimeTicks::Max();
+  TimeTicks run_time = wake_up.has_value()
+                           ? GetRunTimeForWakeUp(pump_.get(), *wake_up)
+                           : TimeTicks::Max();
   DCHECK_LT(lazy_now->Now(), run_time);
 
   if (!run_time.is_max()) {
@@ -254,6 +266,11 @@ ThreadControllerWithMessagePumpImpl::GetDefaultTaskRunner() {
   return task_runner_;
 }
 
+scoped_refptr<SingleThreadTaskRunner>
+ThreadControllerWithMessagePumpImpl::GetFastLaneTaskRunner() {
+  return fast_lane_task_runner_;
+}
+
 void ThreadControllerWithMessagePumpImpl::RestoreDefaultTaskRunner() {
   // There is no default task runner (as opposed to ThreadControllerImpl).
 }
@@ -370,9 +387,8 @@ ThreadControllerWithMessagePumpImpl::DoWork() {
 
   // The MessagePump will schedule the wake up on our behalf, so we need to
   // update |next_work_info.delayed_run_time|.
-  TimeTicks next_delayed_do_work = pump_->AdjustDelayedRunTime(
-      next_wake_up->earliest_time(), next_wake_up->time,
-      next_wake_up->latest_time());
+  TimeTicks next_delayed_do_work =
+      GetRunTimeForWakeUp(pump_.get(), *next_wake_up);
 
   // Don't request a run time past |main_thread_only().quit_runloop_after|.
   if (next_delayed_do_work > main_thread_only().quit_runloop_after) {
@@ -407,6 +423,10 @@ std::optional<WakeUp> ThreadControllerWithMessagePumpImpl::DoWorkImpl(
 
   DCHECK(main_thread_only().task_source);
 
+  if (!RunFastLaneTasks()) {
+    return std::nullopt;
+  }
+
   // Keep running tasks for up to 8ms before yielding to the pump when tasks are
   // run by batches.
   const base::TimeDelta batch_duration =
@@ -511,6 +531,10 @@ std::optional<WakeUp> ThreadControllerWithMessagePumpImpl::DoWorkImpl(
 
   work_deduplicator_.WillCheckForMoreWork();
 
+  if (fast_lane_task_runner_->HasPendingTasks()) {
+    return WakeUp{};
+  }
+
   // Re-check the state of the power after running tasks. An executed task may
   // have been a power change notification.
   const SequencedTaskSource::SelectTaskOption select_task_option =
@@ -521,6 +545,27 @@ std::optional<WakeUp> ThreadControllerWithMessagePumpImpl::DoWorkImpl(
                                                           select_task_option);
 }
 
+bool ThreadControllerWithMessagePumpImpl::RunFastLaneTasks() {
+  fast_lane_task_runner_->RunPendingTasks([this](Task& task) {
+    LazyNow lazy_now_select_task(time_source_);
+    OnBeginWorkItemImpl(lazy_now_select_task);
+    int run_depth = static_cast<int>(run_level_tracker_.num_run_levels());
+    run_level_tracker_.OnApplicationTaskSelected(task.queue_time,
+                                                 lazy_now_select_task);
+    {
+      AutoReset<bool> ban_nested_application_tasks(
+          &main_thread_only().task_execution_allowed, false);
+      TaskAnnotator::LongTaskTracker long_task_tracker(time_source_, task,
+                                                       &task_annotator_);
+      task_annotator_.RunTask("ThreadControllerImpl::RunFastLaneTask", task);
+    }
+    LazyNow lazy_now_after_run_task(time_source_);
+    OnEndWorkItemImpl(lazy_now_after_run_task, run_depth);
+    return !main_thread_only().quit_pending;
+  });
+  return !main_thread_only().quit_pending;
+}
+
 bool ThreadControllerWithMessagePumpImpl::RunsTasksByBatches() const {
   return can_run_tasks_by_batches_ &&
          g_run_tasks_by_batches.load(std::memory_order_relaxed);
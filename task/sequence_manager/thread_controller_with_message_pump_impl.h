@@ -15,6 +15,7 @@
 #include "base/run_loop.h"
 #include "base/task/common/checked_lock.h"
 #include "base/task/common/task_annotator.h"
+#include "base/task/sequence_manager/fast_lane_task_runner.h"
 #include "base/task/sequence_manager/sequence_manager_impl.h"
 #include "base/task/sequence_manager/sequenced_task_source.h"
 #include "base/task/sequence_manager/thread_controller.h"
@@ -66,6 +67,7 @@ class BASE_EXPORT ThreadControllerWithMessagePumpImpl
   void SetDefaultTaskRunner(
       scoped_refptr<SingleThreadTaskRunner> task_runner) override;
   scoped_refptr<SingleThreadTaskRunner> GetDefaultTaskRunner() override;
+  scoped_refptr<SingleThreadTaskRunner> GetFastLaneTaskRunner() override;
   void RestoreDefaultTaskRunner() override;
   void AddNestingObserver(RunLoop::NestingObserver* observer) override;
   void RemoveNestingObserver(RunLoop::NestingObserver* observer) override;
@@ -154,6 +156,10 @@ class BASE_EXPORT ThreadControllerWithMessagePumpImpl
   // tasks.
   std::optional<WakeUp> DoWorkImpl(LazyNow* continuation_lazy_now);
 
+  // Runs the tasks of |fast_lane_task_runner_|. Returns false if the work batch
+  // must stop, i.e. on Quit().
+  bool RunFastLaneTasks();
+
   bool RunsTasksByBatches() const;
 
   void InitializeSingleThreadTaskRunnerCurrentDefaultHandle()
@@ -182,6 +188,8 @@ class BASE_EXPORT ThreadControllerWithMessagePumpImpl
 
   TaskAnnotator task_annotator_;
 
+  const scoped_refptr<FastLaneTaskRunner> fast_lane_task_runner_;
+
   // Non-null provider of id state for identifying distinct work items executed
   // by the message loop (task, event, etc.). Cached on the class to avoid TLS
   // lookups on task execution.
@@ -19,6 +19,7 @@
 #include "base/memory/raw_ptr.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/message_loop/message_pump.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/task/sequence_manager/task_queue.h"
 #include "base/task/sequence_manager/thread_controller_power_monitor.h"
 #include "base/task/single_thread_task_runner.h"
@@ -332,6 +333,29 @@ TEST_F(ThreadControllerWithMessagePumpTest, SetNextDelayedDoWork) {
                                           WakeUp{FromNow(Seconds(123))});
 }
 
+TEST_F(ThreadControllerWithMessagePumpTest,
+       SetNextDelayedDoWork_AlignWakeUps) {
+  MessagePump::OverrideAlignWakeUpsState(true, Milliseconds(20));
+  const WakeUp wake_up{FromNow(Milliseconds(3)), Milliseconds(20)};
+
+  // The wake-up is aligned on the next multiple of the leeway.
+  EXPECT_CALL(*message_pump_,
+              ScheduleDelayedWork_TimeTicks(FromNow(Milliseconds(20))));
+  LazyNow lazy_now(&clock_);
+  thread_controller_.SetNextDelayedDoWork(&lazy_now, wake_up);
+  testing::Mock::VerifyAndClearExpectations(message_pump_);
+
+  // Unless the thread opted out.
+  MessagePump::SetAlignWakeUpsForCurrentThread(false);
+  EXPECT_CALL(*message_pump_,
+              ScheduleDelayedWork_TimeTicks(FromNow(Milliseconds(3))));
+  thread_controller_.SetNextDelayedDoWork(&lazy_now, wake_up);
+  testing::Mock::VerifyAndClearExpectations(message_pump_);
+
+  MessagePump::SetAlignWakeUpsForCurrentThread(true);
+  MessagePump::ResetAlignWakeUpsState();
+}
+
 TEST_F(ThreadControllerWithMessagePumpTest, SetNextDelayedDoWork_CapAtOneDay) {
   EXPECT_CALL(*message_pump_, ScheduleDelayedWork_TimeTicks(FromNow(Days(1))));
 
@@ -528,6 +552,53 @@ TEST_F(ThreadControllerWithMessagePumpTest, EnsureWorkScheduled) {
   testing::Mock::VerifyAndClearExpectations(message_pump_);
 }
 
+TEST_F(ThreadControllerWithMessagePumpTest, FastLaneTasksRunFirst) {
+  std::vector<std::string> log;
+  task_source_.AddTask(FROM_HERE,
+                       BindLambdaForTesting([&] { log.push_back("task"); }));
+  scoped_refptr<SingleThreadTaskRunner> fast_lane_task_runner =
+      thread_controller_.GetFastLaneTaskRunner();
+  EXPECT_TRUE(fast_lane_task_runner->RunsTasksInCurrentSequence());
+
+  // Only the first fast lane task schedules work.
+  EXPECT_CALL(*message_pump_, ScheduleWork()).Times(1);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(fast_lane_task_runner->PostTask(
+        FROM_HERE, BindLambdaForTesting([&log, i] {
+          log.push_back("fast lane " + NumberToString(i));
+        })));
+  }
+  testing::Mock::VerifyAndClearExpectations(message_pump_);
+
+  thread_controller_.DoWork();
+  EXPECT_THAT(log, ElementsAre("fast lane 0", "fast lane 1", "fast lane 2",
+                               "task"));
+}
+
+TEST_F(ThreadControllerWithMessagePumpTest, FastLaneTaskPostedFromFastLane) {
+  scoped_refptr<SingleThreadTaskRunner> fast_lane_task_runner =
+      thread_controller_.GetFastLaneTaskRunner();
+  std::vector<std::string> log;
+
+  auto second_task = BindLambdaForTesting([&] { log.push_back("second"); });
+  auto first_task = BindLambdaForTesting([&] {
+    log.push_back("first");
+    fast_lane_task_runner->PostTask(FROM_HERE, std::move(second_task));
+  });
+
+  EXPECT_CALL(*message_pump_, ScheduleWork()).Times(1);
+  fast_lane_task_runner->PostTask(FROM_HERE, std::move(first_task));
+  testing::Mock::VerifyAndClearExpectations(message_pump_);
+
+  // The task posted by the first task runs in the next DoWork(), which doesn't
+  // require another call to the pump.
+  EXPECT_CALL(*message_pump_, ScheduleWork()).Times(0);
+  EXPECT_TRUE(thread_controller_.DoWork().is_immediate());
+  EXPECT_THAT(log, ElementsAre("first"));
+  EXPECT_EQ(thread_controller_.DoWork().delayed_run_time, TimeTicks::Max());
+  EXPECT_THAT(log, ElementsAre("first", "second"));
+}
+
 TEST_F(ThreadControllerWithMessagePumpTest, WorkBatching) {
   SingleThreadTaskRunner::CurrentDefaultHandle handle(
       MakeRefCounted<FakeTaskRunner>());
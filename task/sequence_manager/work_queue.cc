@@ -213,8 +213,13 @@ Task WorkQueue::TakeTaskFromWorkQueue() {
   work_queue_sets_->OnQueuesFrontTaskChanged(this);
 #else
   // OnPopMinQueueInSet calls GetFrontTaskOrder which checks
-  // BlockedByFence() so we don't need to here.
-  work_queue_sets_->OnPopMinQueueInSet(this);
+  // BlockedByFence() so we don't need to here. The selector may batch tasks
+  // from a queue which isn't the oldest of its set.
+  if (work_queue_sets_->IsOldestQueueInSet(this)) {
+    work_queue_sets_->OnPopMinQueueInSet(this);
+  } else {
+    work_queue_sets_->OnQueuesFrontTaskChanged(this);
+  }
 #endif
   task_queue_->TraceQueueSize();
   return pending_task;
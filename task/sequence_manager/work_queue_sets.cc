@@ -18,6 +18,7 @@ WorkQueueSets::WorkQueueSets(const char* name,
                              Observer* observer,
                              const SequenceManager::Settings& settings)
     : name_(name),
+      earliest_deadline_first_(settings.earliest_deadline_first),
       work_queue_heaps_(settings.priority_settings.priority_count()),
 #if DCHECK_IS_ON()
       last_rand_(settings.random_task_selection_seed),
@@ -31,13 +32,13 @@ void WorkQueueSets::AddQueue(WorkQueue* work_queue, size_t set_index) {
   DCHECK(!work_queue->work_queue_sets());
   DCHECK_LT(set_index, work_queue_heaps_.size());
   DCHECK(!work_queue->heap_handle().IsValid());
-  std::optional<TaskOrder> key = work_queue->GetFrontTaskOrder();
+  std::optional<OldestTaskOrder> key = GetFrontTaskKey(work_queue);
   work_queue->AssignToWorkQueueSets(this);
   work_queue->AssignSetIndex(set_index);
   if (!key)
     return;
   bool was_empty = work_queue_heaps_[set_index].empty();
-  work_queue_heaps_[set_index].insert({*key, work_queue});
+  work_queue_heaps_[set_index].insert(*key);
   if (was_empty)
     observer_->WorkQueueSetBecameNonEmpty(set_index);
 }
@@ -58,7 +59,7 @@ void WorkQueueSets::RemoveQueue(WorkQueue* work_queue) {
 void WorkQueueSets::ChangeSetIndex(WorkQueue* work_queue, size_t set_index) {
   DCHECK_EQ(this, work_queue->work_queue_sets());
   DCHECK_LT(set_index, work_queue_heaps_.size());
-  std::optional<TaskOrder> key = work_queue->GetFrontTaskOrder();
+  std::optional<OldestTaskOrder> key = GetFrontTaskKey(work_queue);
   size_t old_set = work_queue->work_queue_set_index();
   DCHECK_LT(old_set, work_queue_heaps_.size());
   DCHECK_NE(old_set, set_index);
@@ -68,7 +69,7 @@ void WorkQueueSets::ChangeSetIndex(WorkQueue* work_queue, size_t set_index) {
     return;
   work_queue_heaps_[old_set].erase(work_queue->heap_handle());
   bool was_empty = work_queue_heaps_[set_index].empty();
-  work_queue_heaps_[set_index].insert({*key, work_queue});
+  work_queue_heaps_[set_index].insert(*key);
   // Invoke `WorkQueueSetBecameNonEmpty()` before `WorkQueueSetBecameEmpty()` so
   // `observer_` doesn't momentarily observe that all work queue sets are empty.
   // TaskQueueSelectorTest.TestDisableEnable will fail if the order changes.
@@ -85,10 +86,9 @@ void WorkQueueSets::OnQueuesFrontTaskChanged(WorkQueue* work_queue) {
   DCHECK_LT(set_index, work_queue_heaps_.size());
   DCHECK(work_queue->heap_handle().IsValid());
   DCHECK(!work_queue_heaps_[set_index].empty()) << " set_index = " << set_index;
-  if (auto key = work_queue->GetFrontTaskOrder()) {
+  if (auto key = GetFrontTaskKey(work_queue)) {
     // O(log n)
-    work_queue_heaps_[set_index].Replace(work_queue->heap_handle(),
-                                         {*key, work_queue});
+    work_queue_heaps_[set_index].Replace(work_queue->heap_handle(), *key);
   } else {
     // O(log n)
     work_queue_heaps_[set_index].erase(work_queue->heap_handle());
@@ -102,7 +102,7 @@ void WorkQueueSets::OnTaskPushedToEmptyQueue(WorkQueue* work_queue) {
   // NOTE if this function changes, we need to keep |WorkQueueSets::AddQueue| in
   // sync.
   DCHECK_EQ(this, work_queue->work_queue_sets());
-  std::optional<TaskOrder> key = work_queue->GetFrontTaskOrder();
+  std::optional<OldestTaskOrder> key = GetFrontTaskKey(work_queue);
   DCHECK(key);
   size_t set_index = work_queue->work_queue_set_index();
   DCHECK_LT(set_index, work_queue_heaps_.size())
@@ -110,7 +110,7 @@ void WorkQueueSets::OnTaskPushedToEmptyQueue(WorkQueue* work_queue) {
   // |work_queue| should not be in work_queue_heaps_[set_index].
   DCHECK(!work_queue->heap_handle().IsValid());
   bool was_empty = work_queue_heaps_[set_index].empty();
-  work_queue_heaps_[set_index].insert({*key, work_queue});
+  work_queue_heaps_[set_index].insert(*key);
   if (was_empty)
     observer_->WorkQueueSetBecameNonEmpty(set_index);
 }
@@ -124,9 +124,9 @@ void WorkQueueSets::OnPopMinQueueInSet(WorkQueue* work_queue) {
   DCHECK_EQ(work_queue_heaps_[set_index].top().value, work_queue)
       << " set_index = " << set_index;
   DCHECK(work_queue->heap_handle().IsValid());
-  if (auto key = work_queue->GetFrontTaskOrder()) {
+  if (auto key = GetFrontTaskKey(work_queue)) {
     // O(log n)
-    work_queue_heaps_[set_index].ReplaceTop({*key, work_queue});
+    work_queue_heaps_[set_index].ReplaceTop(*key);
   } else {
     // O(log n)
     work_queue_heaps_[set_index].pop();
@@ -162,7 +162,7 @@ WorkQueueSets::GetOldestQueueAndTaskOrderInSet(size_t set_index) const {
   std::optional<TaskOrder> order = oldest.value->GetFrontTaskOrder();
   DCHECK(order && oldest.key == *order);
 #endif
-  return WorkQueueAndTaskOrder(*oldest.value, oldest.key);
+  return WorkQueueAndTaskOrder(*oldest.value, oldest.key, oldest.deadline);
 }
 
 #if DCHECK_IS_ON()
@@ -178,7 +178,7 @@ WorkQueueSets::GetRandomQueueAndTaskOrderInSet(size_t set_index) const {
   std::optional<TaskOrder> key = chosen.value->GetFrontTaskOrder();
   DCHECK(key && chosen.key == *key);
 #endif
-  return WorkQueueAndTaskOrder(*chosen.value, chosen.key);
+  return WorkQueueAndTaskOrder(*chosen.value, chosen.key, chosen.deadline);
 }
 #endif
 
@@ -188,6 +188,14 @@ bool WorkQueueSets::IsSetEmpty(size_t set_index) const {
   return work_queue_heaps_[set_index].empty();
 }
 
+bool WorkQueueSets::IsOldestQueueInSet(const WorkQueue* work_queue) const {
+  DCHECK_EQ(this, work_queue->work_queue_sets());
+  size_t set_index = work_queue->work_queue_set_index();
+  DCHECK_LT(set_index, work_queue_heaps_.size());
+  return !work_queue_heaps_[set_index].empty() &&
+         work_queue_heaps_[set_index].top().value == work_queue;
+}
+
 #if DCHECK_IS_ON() || !defined(NDEBUG)
 bool WorkQueueSets::ContainsWorkQueueForTest(
     const WorkQueue* work_queue) const {
@@ -213,6 +221,20 @@ bool WorkQueueSets::ContainsWorkQueueForTest(
 }
 #endif
 
+std::optional<WorkQueueSets::OldestTaskOrder> WorkQueueSets::GetFrontTaskKey(
+    WorkQueue* work_queue) const {
+  std::optional<TaskOrder> task_order = work_queue->GetFrontTaskOrder();
+  if (!task_order)
+    return std::nullopt;
+  TimeTicks deadline;
+  if (earliest_deadline_first_) {
+    deadline = work_queue->GetFrontTask()->deadline;
+    if (deadline.is_null())
+      deadline = TimeTicks::Max();
+  }
+  return OldestTaskOrder{deadline, *task_order, work_queue};
+}
+
 void WorkQueueSets::CollectSkippedOverLowerPriorityTasks(
     const internal::WorkQueue* selected_work_queue,
     std::vector<const Task*>* result) const {
@@ -19,6 +19,7 @@
 #include "base/task/sequence_manager/task_order.h"
 #include "base/task/sequence_manager/task_queue_impl.h"
 #include "base/task/sequence_manager/work_queue.h"
+#include "base/time/time.h"
 
 namespace base {
 namespace sequence_manager {
@@ -28,16 +29,33 @@ struct WorkQueueAndTaskOrder {
   STACK_ALLOCATED();
 
   public:
-  WorkQueueAndTaskOrder(WorkQueue& work_queue, const TaskOrder& task_order)
-      : queue(&work_queue), order(task_order) {}
+  WorkQueueAndTaskOrder(WorkQueue& work_queue,
+                        const TaskOrder& task_order,
+                        TimeTicks task_deadline = TimeTicks())
+      : queue(&work_queue), order(task_order), deadline(task_deadline) {}
+
+  // Returns true if the task of this should run before the task of |other|,
+  // which is from the same priority: the earliest deadline first, then the
+  // oldest.
+  bool RunsBefore(const WorkQueueAndTaskOrder& other) const {
+    if (deadline != other.deadline) {
+      return deadline < other.deadline;
+    }
+    return order < other.order;
+  }
 
   WorkQueue* queue = nullptr;
   TaskOrder order;
+  // The deadline of the task if the sets order tasks by deadline, Max() for a
+  // task without deadline in that case, null otherwise.
+  TimeTicks deadline;
 };
 
 // There is a min-heap for each scheduler priority which keeps track of which
 // queue in the set has the oldest task (i.e. the one that should be run next if
-// the TaskQueueSelector chooses to run a task a given priority).
+// the TaskQueueSelector chooses to run a task a given priority). With
+// Settings::earliest_deadline_first, the heaps are ordered by the deadline of
+// the front task of each queue first, tasks without deadline coming last.
 class BASE_EXPORT WorkQueueSets {
  public:
   class Observer {
@@ -79,7 +97,9 @@ class BASE_EXPORT WorkQueueSets {
   // O(log num queues)
   void OnQueueBlocked(WorkQueue* work_queue);
 
-  // O(1)
+  // O(1) Returns the queue whose task should run next in the set: the one with
+  // the oldest task, or with the earliest deadline if the sets order tasks by
+  // deadline.
   std::optional<WorkQueueAndTaskOrder> GetOldestQueueAndTaskOrderInSet(
       size_t set_index) const;
 
@@ -92,6 +112,9 @@ class BASE_EXPORT WorkQueueSets {
   // O(1)
   bool IsSetEmpty(size_t set_index) const;
 
+  // O(1) Returns true if |work_queue| has the lowest enqueue order in its set.
+  bool IsOldestQueueInSet(const WorkQueue* work_queue) const;
+
 #if DCHECK_IS_ON() || !defined(NDEBUG)
   // Note this iterates over everything in |work_queue_heaps_|.
   // It's intended for use with DCHECKS and for testing
@@ -108,12 +131,17 @@ class BASE_EXPORT WorkQueueSets {
 
  private:
   struct OldestTaskOrder {
+    // Compared before |key|. See WorkQueueAndTaskOrder::deadline.
+    TimeTicks deadline;
     TaskOrder key;
     // RAW_PTR_EXCLUSION: Performance: visible in sampling profiler stacks.
     RAW_PTR_EXCLUSION WorkQueue* value = nullptr;
 
     // Used for a min-heap.
     bool operator>(const OldestTaskOrder& other) const {
+      if (deadline != other.deadline) {
+        return deadline > other.deadline;
+      }
       return key > other.key;
     }
 
@@ -124,7 +152,12 @@ class BASE_EXPORT WorkQueueSets {
     HeapHandle GetHeapHandle() const { return value->heap_handle(); }
   };
 
+  // Returns the heap entry for the front task of |work_queue|, or nullopt if
+  // it has no task that can run.
+  std::optional<OldestTaskOrder> GetFrontTaskKey(WorkQueue* work_queue) const;
+
   const char* const name_;
+  const bool earliest_deadline_first_;
 
   // For each set |work_queue_heaps_| has a queue of WorkQueue ordered by the
   // oldest task in each WorkQueue.
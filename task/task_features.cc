@@ -79,10 +79,63 @@ BASE_FEATURE(kMaxDelayedStarvationTasks,
 const base::FeatureParam<int> kMaxDelayedStarvationTasksParam{
     &kMaxDelayedStarvationTasks, "count", 3};
 
+BASE_FEATURE(kTaskQueueSelectorBatching,
+             "TaskQueueSelectorBatching",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+const base::FeatureParam<int> kTaskQueueSelectorBatchSize{
+    &kTaskQueueSelectorBatching, "batch_size", 16};
+
 BASE_FEATURE(kThreadGroupSemaphore,
              "ThreadGroupSemaphore",
              base::FEATURE_DISABLED_BY_DEFAULT);
 const base::FeatureParam<int> kMaxNumWorkersCreated{
     &kThreadGroupSemaphore, "max_num_workers_created", 2};
 
+BASE_FEATURE(kThreadGroupWorkStealing,
+             "ThreadGroupWorkStealing",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+BASE_FEATURE(kDelayedTaskManagerTimerWheel,
+             "DelayedTaskManagerTimerWheel",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+BASE_FEATURE(kWorkerThreadSpinBeforeSleep,
+             "WorkerThreadSpinBeforeSleep",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+const base::FeatureParam<TimeDelta> kWorkerThreadMaxSpinDuration{
+    &kWorkerThreadSpinBeforeSleep, "max_spin_duration", Microseconds(50)};
+
+BASE_FEATURE(kThreadGroupJobPreemption,
+             "ThreadGroupJobPreemption",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+BASE_FEATURE(kThreadPoolCpuQuotaController,
+             "ThreadPoolCpuQuotaController",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+const base::FeatureParam<TimeDelta> kCpuQuotaPollPeriod{
+    &kThreadPoolCpuQuotaController, "poll_period", Seconds(1)};
+
+BASE_FEATURE(kThreadPoolPowerSaving,
+             "ThreadPoolPowerSaving",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+const base::FeatureParam<int> kPowerSavingMaxBestEffortTasks{
+    &kThreadPoolPowerSaving, "max_best_effort_tasks", 1};
+const base::FeatureParam<TimeDelta> kPowerSavingLeeway{
+    &kThreadPoolPowerSaving, "leeway", Milliseconds(32)};
+const base::FeatureParam<TimeDelta> kPowerSavingBestEffortLeeway{
+    &kThreadPoolPowerSaving, "best_effort_leeway", Seconds(1)};
+
+BASE_FEATURE(kLockFreeImmediateIncomingQueue,
+             "LockFreeImmediateIncomingQueue",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+BASE_FEATURE(kRecycleTaskQueueStorage,
+             "RecycleTaskQueueStorage",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+BASE_FEATURE(kUseTscTickClock,
+             "UseTscTickClock",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 }  // namespace base
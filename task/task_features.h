@@ -71,10 +71,74 @@ BASE_EXPORT BASE_DECLARE_FEATURE(kMaxDelayedStarvationTasks);
 extern const BASE_EXPORT base::FeatureParam<int>
     kMaxDelayedStarvationTasksParam;
 
+// Under this feature, the sequence manager selects up to
+// |kTaskQueueSelectorBatchSize| consecutive tasks from the same immediate work
+// queue without re-running the selector, as long as no higher priority work
+// is pending.
+BASE_EXPORT BASE_DECLARE_FEATURE(kTaskQueueSelectorBatching);
+extern const BASE_EXPORT base::FeatureParam<int> kTaskQueueSelectorBatchSize;
+
 // Feature to use ThreadGroupSemaphore instead of ThreadGroupImpl.
 BASE_EXPORT BASE_DECLARE_FEATURE(kThreadGroupSemaphore);
 extern const BASE_EXPORT base::FeatureParam<int> kMaxNumWorkersCreated;
 
+// Under this feature, a ThreadGroupImpl worker keeps the task sources posted
+// from it in a queue of its own, which it runs without acquiring the thread
+// group's lock and which idle workers steal from.
+BASE_EXPORT BASE_DECLARE_FEATURE(kThreadGroupWorkStealing);
+
+// Under this feature, the ThreadPool's DelayedTaskManager keeps delayed tasks
+// in a hierarchical timing wheel until shortly before they are ripe, making
+// posting a delayed task O(1) instead of O(log n) under a single lock.
+BASE_EXPORT BASE_DECLARE_FEATURE(kDelayedTaskManagerTimerWheel);
+
+// Under this feature, an idle ThreadGroupImpl worker spins for up to
+// |kWorkerThreadMaxSpinDuration| before sleeping, if work recently arrived
+// within that time. Waking up a spinning worker doesn't require a system call.
+BASE_EXPORT BASE_DECLARE_FEATURE(kWorkerThreadSpinBeforeSleep);
+extern const BASE_EXPORT base::FeatureParam<TimeDelta>
+    kWorkerThreadMaxSpinDuration;
+
+// Under this feature, when a USER_BLOCKING task source is queued in a thread
+// group that has no free worker, the job of the lowest priority running in the
+// thread group is asked to yield through a flag of its worker, which its next
+// JobDelegate::ShouldYield() call reads.
+BASE_EXPORT BASE_DECLARE_FEATURE(kThreadGroupJobPreemption);
+
+// Under this feature, ThreadPool caps the number of tasks that its foreground
+// thread groups run concurrently based on the CPU usage of the process and,
+// in a Linux control group with a CPU quota, on the time during which the
+// process is throttled. The cap is updated every |kCpuQuotaPollPeriod|.
+BASE_EXPORT BASE_DECLARE_FEATURE(kThreadPoolCpuQuotaController);
+extern const BASE_EXPORT base::FeatureParam<TimeDelta> kCpuQuotaPollPeriod;
+
+// Under this feature, ThreadPool saves power while the device is on battery
+// power, in a serious or critical thermal state, or under a CPU speed limit:
+// its thread groups run at most |kPowerSavingMaxBestEffortTasks| BEST_EFFORT
+// tasks concurrently, and delayed tasks get at least |kPowerSavingLeeway| of
+// leeway, or |kPowerSavingBestEffortLeeway| for BEST_EFFORT ones, so that
+// their wake-ups are coalesced.
+BASE_EXPORT BASE_DECLARE_FEATURE(kThreadPoolPowerSaving);
+extern const BASE_EXPORT base::FeatureParam<int> kPowerSavingMaxBestEffortTasks;
+extern const BASE_EXPORT base::FeatureParam<TimeDelta> kPowerSavingLeeway;
+extern const BASE_EXPORT base::FeatureParam<TimeDelta>
+    kPowerSavingBestEffortLeeway;
+
+// Under this feature, immediate tasks are posted to a SequenceManager task
+// queue by pushing them onto a lock-free list, which the main thread drains
+// when it reloads the queue's immediate work queue.
+BASE_EXPORT BASE_DECLARE_FEATURE(kLockFreeImmediateIncomingQueue);
+
+// Under this feature, the rings of the task queues of SequenceManagers and the
+// Sequences of the ThreadPool are recycled through ObjectPools, instead of
+// being allocated for each queue or sequence.
+BASE_EXPORT BASE_DECLARE_FEATURE(kRecycleTaskQueueStorage);
+
+// Under this feature, SequenceManagers created without an explicit TickClock
+// read the time from a TscTickClock, when the CPU supports it, instead of
+// TimeTicks::Now().
+BASE_EXPORT BASE_DECLARE_FEATURE(kUseTscTickClock);
+
 }  // namespace base
 
 #endif  // BASE_TASK_TASK_FEATURES_H_
@@ -7,6 +7,8 @@
 
 #include <stddef.h>
 
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/check.h"
 #include "base/functional/bind.h"
@@ -67,6 +69,17 @@ class BASE_EXPORT TaskRunner
   // Equivalent to PostDelayedTask(from_here, task, 0).
   bool PostTask(const Location& from_here, OnceClosure task);
 
+  // Posts all of |tasks| to be run, as if by calling PostTask() for each of
+  // them in order. Returns true if all the tasks may be run at some point in
+  // the future, and false if any of them definitely will not be run.
+  //
+  // Implementations may override this to amortize the cost of posting over
+  // the batch, e.g. by enqueuing all the tasks under a single lock acquisition
+  // and waking up workers once. The default implementation calls PostTask()
+  // for each task.
+  virtual bool PostTasks(const Location& from_here,
+                         std::vector<OnceClosure> tasks);
+
   // Like PostTask, but tries to run the posted task only after |delay_ms|
   // has passed. Implementations should use a tick clock, rather than wall-
   // clock time, to implement |delay|.
@@ -0,0 +1,167 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/cpu_quota_controller.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/functional/bind.h"
+#include "base/process/process_metrics.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/system/sys_info.h"
+#include "build/build_config.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// Files of the cgroup v2 hierarchy mounted for the process, which in a
+// container is the control group of the container.
+constexpr char kCgroupCpuMaxPath[] = "/sys/fs/cgroup/cpu.max";
+constexpr char kCgroupCpuStatPath[] = "/sys/fs/cgroup/cpu.stat";
+
+// Large enough for the content of "cpu.max" and "cpu.stat".
+constexpr size_t kMaxCgroupFileSize = 4096;
+
+std::optional<std::string> ReadCgroupFile(const char* path) {
+  std::string content;
+  if (!ReadFileToStringWithMaxSize(FilePath(path), &content,
+                                   kMaxCgroupFileSize)) {
+    return std::nullopt;
+  }
+  return content;
+}
+
+std::optional<CpuQuotaController::CpuUsage> GetCgroupCpuUsage() {
+  std::optional<std::string> cpu_stat = ReadCgroupFile(kCgroupCpuStatPath);
+  if (!cpu_stat) {
+    return std::nullopt;
+  }
+  return ParseCgroupCpuStat(*cpu_stat);
+}
+#endif
+
+std::optional<CpuQuotaController::CpuUsage> GetProcessCpuUsage(
+    ProcessMetrics* process_metrics) {
+  base::expected<TimeDelta, ProcessCPUUsageError> usage =
+      process_metrics->GetCumulativeCPUUsage();
+  if (!usage.has_value()) {
+    return std::nullopt;
+  }
+  return CpuQuotaController::CpuUsage{usage.value(), TimeDelta()};
+}
+
+}  // namespace
+
+CpuQuotaController::CpuQuotaController(size_t max_tasks,
+                                       double num_cores,
+                                       CpuUsageCallback cpu_usage_callback)
+    : max_tasks_(max_tasks),
+      num_cores_(num_cores),
+      cpu_usage_callback_(std::move(cpu_usage_callback)),
+      max_tasks_limit_(std::clamp<size_t>(
+          static_cast<size_t>(std::ceil(num_cores)), 1, max_tasks)) {
+  DCHECK_GE(max_tasks_, 1u);
+  DCHECK_GT(num_cores_, 0);
+}
+
+CpuQuotaController::~CpuQuotaController() = default;
+
+// static
+std::unique_ptr<CpuQuotaController> CpuQuotaController::Create(
+    size_t max_tasks) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  std::optional<std::string> cpu_max = ReadCgroupFile(kCgroupCpuMaxPath);
+  std::optional<double> quota_cores =
+      cpu_max ? ParseCgroupCpuMax(*cpu_max) : std::nullopt;
+  if (quota_cores && GetCgroupCpuUsage()) {
+    return std::make_unique<CpuQuotaController>(
+        max_tasks, *quota_cores, BindRepeating(&GetCgroupCpuUsage));
+  }
+#endif
+  return std::make_unique<CpuQuotaController>(
+      max_tasks, SysInfo::NumberOfProcessors(),
+      BindRepeating(&GetProcessCpuUsage,
+                    Owned(ProcessMetrics::CreateCurrentProcessMetrics())));
+}
+
+size_t CpuQuotaController::Update(TimeTicks now) {
+  std::optional<CpuUsage> cpu_usage = cpu_usage_callback_.Run();
+  if (!cpu_usage) {
+    return max_tasks_limit_;
+  }
+  std::optional<CpuUsage> last_cpu_usage =
+      std::exchange(last_cpu_usage_, cpu_usage);
+  const TimeDelta elapsed = now - std::exchange(last_update_time_, now);
+  if (!last_cpu_usage || !elapsed.is_positive()) {
+    return max_tasks_limit_;
+  }
+
+  const double throttled_fraction =
+      (cpu_usage->throttled_time - last_cpu_usage->throttled_time) / elapsed;
+  const double used_cores =
+      (cpu_usage->usage - last_cpu_usage->usage) / elapsed;
+  if (throttled_fraction > kMaxThrottledFraction) {
+    max_tasks_limit_ = std::max<size_t>(max_tasks_limit_ - 1, 1);
+  } else if (used_cores + 1 <= num_cores_) {
+    max_tasks_limit_ = std::min(max_tasks_limit_ + 1, max_tasks_);
+  }
+  return max_tasks_limit_;
+}
+
+std::optional<double> ParseCgroupCpuMax(std::string_view cpu_max) {
+  // The content is "$MAX $PERIOD", where $MAX is "max" if there is no quota.
+  std::vector<std::string_view> fields = SplitStringPiece(
+      cpu_max, " \n", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY);
+  int64_t quota_us;
+  int64_t period_us;
+  if (fields.size() != 2 || !StringToInt64(fields[0], &quota_us) ||
+      !StringToInt64(fields[1], &period_us) || quota_us <= 0 ||
+      period_us <= 0) {
+    return std::nullopt;
+  }
+  return static_cast<double>(quota_us) / static_cast<double>(period_us);
+}
+
+std::optional<CpuQuotaController::CpuUsage> ParseCgroupCpuStat(
+    std::string_view cpu_stat) {
+  // The content has a "$KEY $VALUE" line per statistic.
+  std::optional<int64_t> usage_us;
+  std::optional<int64_t> throttled_us;
+  for (std::string_view line : SplitStringPiece(
+           cpu_stat, "\n", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY)) {
+    std::vector<std::string_view> fields = SplitStringPiece(
+        line, " ", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY);
+    int64_t value;
+    if (fields.size() != 2 || !StringToInt64(fields[1], &value)) {
+      continue;
+    }
+    if (fields[0] == "usage_usec") {
+      usage_us = value;
+    } else if (fields[0] == "throttled_usec") {
+      throttled_us = value;
+    }
+  }
+  if (!usage_us) {
+    return std::nullopt;
+  }
+  // "throttled_usec" is only present if the cpu controller is enabled.
+  return CpuQuotaController::CpuUsage{Microseconds(*usage_us),
+                                      Microseconds(throttled_us.value_or(0))};
+}
+
+}  // namespace internal
+}  // namespace base
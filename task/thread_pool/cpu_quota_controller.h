@@ -0,0 +1,91 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_THREAD_POOL_CPU_QUOTA_CONTROLLER_H_
+#define BASE_TASK_THREAD_POOL_CPU_QUOTA_CONTROLLER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "base/base_export.h"
+#include "base/functional/callback.h"
+#include "base/time/time.h"
+
+namespace base {
+namespace internal {
+
+// Picks the max number of tasks that a thread group may run concurrently from
+// the CPU usage of the process and, when it runs in a Linux control group with
+// a CPU quota (e.g. a container), from the time during which the group was
+// throttled for exceeding its quota. The limit shrinks while the process is
+// throttled and grows while cores are idle, so that a thread group of CPU-bound
+// tasks doesn't run more threads than the CPU time it is allotted. This class
+// isn't thread-safe.
+class BASE_EXPORT CpuQuotaController {
+ public:
+  // Cumulative CPU time consumed and time throttled since an arbitrary origin.
+  struct CpuUsage {
+    TimeDelta usage;
+    TimeDelta throttled_time;
+  };
+
+  // Returns the current CpuUsage, or nullopt if it can't be read.
+  using CpuUsageCallback = RepeatingCallback<std::optional<CpuUsage>()>;
+
+  // Fraction of the time between two calls to Update() during which the
+  // process may be throttled without lowering the limit.
+  static constexpr double kMaxThrottledFraction = 0.01;
+
+  // The limit is never higher than |max_tasks|, starts at the number of cores
+  // in |num_cores| (e.g. a CPU quota of 2.5 cores allows 3 tasks), and grows
+  // while fewer than |num_cores| - 1 cores are used. |cpu_usage_callback| is
+  // called from Update().
+  CpuQuotaController(size_t max_tasks,
+                     double num_cores,
+                     CpuUsageCallback cpu_usage_callback);
+
+  CpuQuotaController(const CpuQuotaController&) = delete;
+  CpuQuotaController& operator=(const CpuQuotaController&) = delete;
+  ~CpuQuotaController();
+
+  // Returns a controller that reads the quota and the usage of the control
+  // group of the process if it has a CPU quota, or that uses the CPU usage of
+  // the process and the number of processors otherwise.
+  static std::unique_ptr<CpuQuotaController> Create(size_t max_tasks);
+
+  // Samples the CPU usage at |now|, updates the limit based on the usage since
+  // the previous call and returns it.
+  size_t Update(TimeTicks now);
+
+  size_t max_tasks_limit() const { return max_tasks_limit_; }
+
+ private:
+  const size_t max_tasks_;
+  const double num_cores_;
+  const CpuUsageCallback cpu_usage_callback_;
+
+  size_t max_tasks_limit_;
+
+  // The sample of the previous call to Update(), if any.
+  std::optional<CpuUsage> last_cpu_usage_;
+  TimeTicks last_update_time_;
+};
+
+// Returns the number of cores allowed by the content of a cgroup v2 "cpu.max"
+// file (e.g. "150000 100000" allows 1.5 cores), or nullopt if there is no quota
+// or the content can't be parsed. Exposed for testing.
+BASE_EXPORT std::optional<double> ParseCgroupCpuMax(std::string_view cpu_max);
+
+// Returns the usage and the throttled time in the content of a cgroup v2
+// "cpu.stat" file, or nullopt if it can't be parsed. Exposed for testing.
+BASE_EXPORT std::optional<CpuQuotaController::CpuUsage> ParseCgroupCpuStat(
+    std::string_view cpu_stat);
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_TASK_THREAD_POOL_CPU_QUOTA_CONTROLLER_H_
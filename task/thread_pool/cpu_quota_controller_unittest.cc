@@ -0,0 +1,128 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/cpu_quota_controller.h"
+
+#include <optional>
+
+#include "base/test/bind.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+constexpr size_t kMaxTasks = 8;
+constexpr TimeDelta kPollPeriod = Seconds(1);
+
+class CpuQuotaControllerTest : public testing::Test {
+ protected:
+  // Creates a controller that allows |num_cores| and samples |cpu_usage_|.
+  void CreateController(double num_cores) {
+    controller_.emplace(kMaxTasks, num_cores,
+                        BindLambdaForTesting([&]() { return cpu_usage_; }));
+  }
+
+  // Advances time by kPollPeriod, during which the process used |used_cores|
+  // and was throttled for |throttled_fraction| of the time, and returns the
+  // updated limit.
+  size_t Advance(double used_cores, double throttled_fraction = 0) {
+    now_ += kPollPeriod;
+    cpu_usage_->usage += kPollPeriod * used_cores;
+    cpu_usage_->throttled_time += kPollPeriod * throttled_fraction;
+    return controller_->Update(now_);
+  }
+
+  std::optional<CpuQuotaController::CpuUsage> cpu_usage_ =
+      CpuQuotaController::CpuUsage();
+  TimeTicks now_ = TimeTicks() + Seconds(1);
+  std::optional<CpuQuotaController> controller_;
+};
+
+}  // namespace
+
+TEST_F(CpuQuotaControllerTest, InitialLimit) {
+  CreateController(2.5);
+  EXPECT_EQ(3u, controller_->max_tasks_limit());
+  CreateController(0.5);
+  EXPECT_EQ(1u, controller_->max_tasks_limit());
+  CreateController(kMaxTasks * 2);
+  EXPECT_EQ(kMaxTasks, controller_->max_tasks_limit());
+
+  // The first sample doesn't change the limit.
+  CreateController(2);
+  EXPECT_EQ(2u, controller_->Update(now_));
+}
+
+TEST_F(CpuQuotaControllerTest, ShrinksWhileThrottled) {
+  CreateController(4);
+  controller_->Update(now_);
+  EXPECT_EQ(3u, Advance(4, 0.5));
+  EXPECT_EQ(2u, Advance(4, 0.5));
+  EXPECT_EQ(1u, Advance(4, 0.5));
+  EXPECT_EQ(1u, Advance(4, 0.5));
+  // Throttling below kMaxThrottledFraction is tolerated.
+  EXPECT_EQ(1u, Advance(3.5, CpuQuotaController::kMaxThrottledFraction / 2));
+}
+
+TEST_F(CpuQuotaControllerTest, GrowsWhileCoresAreIdle) {
+  CreateController(4);
+  controller_->Update(now_);
+  EXPECT_EQ(3u, Advance(4, 0.5));
+  // All cores are used: the limit is stable.
+  EXPECT_EQ(3u, Advance(3.5));
+  // At least a core is idle.
+  EXPECT_EQ(4u, Advance(2));
+  EXPECT_EQ(5u, Advance(2));
+  for (size_t i = 0; i < kMaxTasks; ++i) {
+    Advance(0);
+  }
+  EXPECT_EQ(kMaxTasks, controller_->max_tasks_limit());
+}
+
+TEST_F(CpuQuotaControllerTest, FailedSampleIsIgnored) {
+  CreateController(4);
+  controller_->Update(now_);
+  cpu_usage_.reset();
+  now_ += kPollPeriod;
+  EXPECT_EQ(4u, controller_->Update(now_));
+  cpu_usage_ = CpuQuotaController::CpuUsage();
+  // The next sample is compared with the last successful one, 2 periods ago.
+  EXPECT_EQ(3u, Advance(4, 0.5));
+}
+
+TEST(CpuQuotaControllerParseTest, ParseCgroupCpuMax) {
+  EXPECT_EQ(1.5, ParseCgroupCpuMax("150000 100000\n"));
+  EXPECT_EQ(4, ParseCgroupCpuMax("400000 100000"));
+  EXPECT_FALSE(ParseCgroupCpuMax("max 100000\n"));
+  EXPECT_FALSE(ParseCgroupCpuMax("0 100000"));
+  EXPECT_FALSE(ParseCgroupCpuMax(""));
+  EXPECT_FALSE(ParseCgroupCpuMax("150000"));
+}
+
+TEST(CpuQuotaControllerParseTest, ParseCgroupCpuStat) {
+  std::optional<CpuQuotaController::CpuUsage> cpu_usage = ParseCgroupCpuStat(
+      "usage_usec 123456\n"
+      "user_usec 100000\n"
+      "system_usec 23456\n"
+      "nr_periods 10\n"
+      "nr_throttled 2\n"
+      "throttled_usec 4567\n");
+  ASSERT_TRUE(cpu_usage);
+  EXPECT_EQ(Microseconds(123456), cpu_usage->usage);
+  EXPECT_EQ(Microseconds(4567), cpu_usage->throttled_time);
+
+  cpu_usage = ParseCgroupCpuStat("usage_usec 42\n");
+  ASSERT_TRUE(cpu_usage);
+  EXPECT_EQ(Microseconds(42), cpu_usage->usage);
+  EXPECT_EQ(TimeDelta(), cpu_usage->throttled_time);
+
+  EXPECT_FALSE(ParseCgroupCpuStat("throttled_usec 4567\n"));
+  EXPECT_FALSE(ParseCgroupCpuStat(""));
+}
+
+}  // namespace internal
+}  // namespace base
@@ -69,6 +69,11 @@ void DelayedTaskManager::Start(
     DCHECK(!service_thread_task_runner_);
     service_thread_task_runner_ = std::move(service_thread_task_runner);
     max_precise_delay = kMaxPreciseDelay.Get();
+    if (FeatureList::IsEnabled(kDelayedTaskManagerTimerWheel)) {
+      timer_wheel_ =
+          std::make_unique<DelayedTaskTimerWheel>(tick_clock_->NowTicks());
+      use_timer_wheel_.store(true, std::memory_order_release);
+    }
     std::tie(process_ripe_tasks_time, delay_policy) =
         GetTimeAndDelayPolicyToScheduleProcessRipeTasksLockRequired();
   }
@@ -88,6 +93,28 @@ void DelayedTaskManager::AddDelayedTask(
   // Use CHECK instead of DCHECK to crash earlier. See http://crbug.com/711167
   // for details.
   CHECK(task.task);
+
+  if (use_timer_wheel_.load(std::memory_order_acquire)) {
+    task.delay_policy = subtle::MaybeOverrideDelayPolicy(
+        task.delay_policy, task.delayed_run_time - task.queue_time,
+        TS_UNCHECKED_READ(max_precise_delay));
+    const TimeTicks latest_delayed_run_time = task.latest_delayed_run_time();
+    std::optional<DelayedTaskTimerWheel::Entry> entry = timer_wheel_->Insert(
+        DelayedTaskTimerWheel::Entry(std::move(task),
+                                     std::move(post_task_now_callback)));
+    if (!entry) {
+      if (latest_delayed_run_time < process_ripe_tasks_time_.load()) {
+        service_thread_task_runner_->PostTask(
+            FROM_HERE, schedule_process_ripe_tasks_closure_);
+      }
+      return;
+    }
+    // The task is ripe within the current tick of |timer_wheel_|: keep it in
+    // |delayed_task_queue_| to run it at its exact time.
+    task = std::move(entry->task);
+    post_task_now_callback = std::move(entry->callback);
+  }
+
   TimeTicks process_ripe_tasks_time;
   subtle::DelayPolicy delay_policy;
   {
@@ -122,9 +149,25 @@ void DelayedTaskManager::ProcessRipeTasks() {
   std::vector<DelayedTask> ripe_delayed_tasks;
   TimeTicks process_ripe_tasks_time;
 
+  // Tasks whose tick was reached in |timer_wheel_| move to
+  // |delayed_task_queue_|, which forwards them once ripe. Tasks added to
+  // |timer_wheel_| from now on reschedule this until the next run time is
+  // known.
+  const bool use_timer_wheel = use_timer_wheel_.load(std::memory_order_acquire);
+  std::vector<DelayedTaskTimerWheel::Entry> reached_entries;
+  if (use_timer_wheel) {
+    process_ripe_tasks_time_.store(TimeTicks::Min());
+    reached_entries = timer_wheel_->Advance(tick_clock_->NowTicks());
+  }
+
   {
     CheckedAutoLock auto_lock(queue_lock_);
 
+    for (DelayedTaskTimerWheel::Entry& entry : reached_entries) {
+      delayed_task_queue_.insert(
+          DelayedTask(std::move(entry.task), std::move(entry.callback)));
+    }
+
     // Already shutdown.
     if (!service_thread_task_runner_)
       return;
@@ -147,6 +190,17 @@ void DelayedTaskManager::ProcessRipeTasks() {
     std::tie(process_ripe_tasks_time, std::ignore) =
         GetTimeAndDelayPolicyToScheduleProcessRipeTasksLockRequired();
   }
+  if (use_timer_wheel) {
+    std::optional<DelayedTaskTimerWheel::RunTime> run_time =
+        timer_wheel_->GetNextRunTime();
+    if (run_time) {
+      process_ripe_tasks_time =
+          std::min(process_ripe_tasks_time, run_time->delayed_run_time);
+    }
+    if (process_ripe_tasks_time.is_max()) {
+      process_ripe_tasks_time_.store(TimeTicks::Max());
+    }
+  }
   if (!process_ripe_tasks_time.is_max()) {
     if (service_thread_task_runner_->RunsTasksInCurrentSequence()) {
       ScheduleProcessRipeTasksOnServiceThread();
@@ -163,15 +217,15 @@ void DelayedTaskManager::ProcessRipeTasks() {
 }
 
 std::optional<TimeTicks> DelayedTaskManager::NextScheduledRunTime() const {
-  CheckedAutoLock auto_lock(queue_lock_);
-  if (delayed_task_queue_.empty())
+  const TimeTicks next_scheduled_run_time =
+      GetTimeAndDelayPolicyToScheduleProcessRipeTasks().first;
+  if (next_scheduled_run_time.is_max())
     return std::nullopt;
-  return delayed_task_queue_.top().task.delayed_run_time;
+  return next_scheduled_run_time;
 }
 
 subtle::DelayPolicy DelayedTaskManager::TopTaskDelayPolicyForTesting() const {
-  CheckedAutoLock auto_lock(queue_lock_);
-  return delayed_task_queue_.top().task.delay_policy;
+  return GetTimeAndDelayPolicyToScheduleProcessRipeTasks().second;
 }
 
 void DelayedTaskManager::Shutdown() {
@@ -200,7 +254,7 @@ void DelayedTaskManager::Shutdown() {
 }
 
 std::pair<TimeTicks, subtle::DelayPolicy> DelayedTaskManager::
-    GetTimeAndDelayPolicyToScheduleProcessRipeTasksLockRequired() {
+    GetTimeAndDelayPolicyToScheduleProcessRipeTasksLockRequired() const {
   queue_lock_.AssertAcquired();
   if (delayed_task_queue_.empty()) {
     return std::make_pair(TimeTicks::Max(),
@@ -213,16 +267,40 @@ std::pair<TimeTicks, subtle::DelayPolicy> DelayedTaskManager::
                         delay_policy);
 }
 
-void DelayedTaskManager::ScheduleProcessRipeTasksOnServiceThread() {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-
-  TimeTicks process_ripe_tasks_time;
-  subtle::DelayPolicy delay_policy;
+std::pair<TimeTicks, subtle::DelayPolicy>
+DelayedTaskManager::GetTimeAndDelayPolicyToScheduleProcessRipeTasks() const {
+  std::pair<TimeTicks, subtle::DelayPolicy> time_and_delay_policy;
+  TimeTicks latest_delayed_run_time = TimeTicks::Max();
   {
     CheckedAutoLock auto_lock(queue_lock_);
-    std::tie(process_ripe_tasks_time, delay_policy) =
+    time_and_delay_policy =
         GetTimeAndDelayPolicyToScheduleProcessRipeTasksLockRequired();
+    if (!delayed_task_queue_.empty()) {
+      latest_delayed_run_time =
+          delayed_task_queue_.top().task.latest_delayed_run_time();
+    }
   }
+  if (use_timer_wheel_.load(std::memory_order_acquire)) {
+    std::optional<DelayedTaskTimerWheel::RunTime> run_time =
+        timer_wheel_->GetNextRunTime();
+    if (run_time &&
+        run_time->latest_delayed_run_time < latest_delayed_run_time) {
+      time_and_delay_policy = {run_time->delayed_run_time,
+                               run_time->delay_policy};
+    }
+  }
+  return time_and_delay_policy;
+}
+
+void DelayedTaskManager::ScheduleProcessRipeTasksOnServiceThread() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // Tasks added to |timer_wheel_| while the next run time is computed below
+  // reschedule this, so that none is missed.
+  process_ripe_tasks_time_.store(TimeTicks::Min());
+  auto [process_ripe_tasks_time, delay_policy] =
+      GetTimeAndDelayPolicyToScheduleProcessRipeTasks();
+  process_ripe_tasks_time_.store(process_ripe_tasks_time);
   DCHECK(!process_ripe_tasks_time.is_null());
   if (process_ripe_tasks_time.is_max())
     return;
@@ -5,7 +5,9 @@
 #ifndef BASE_TASK_THREAD_POOL_DELAYED_TASK_MANAGER_H_
 #define BASE_TASK_THREAD_POOL_DELAYED_TASK_MANAGER_H_
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <optional>
 
 #include "base/base_export.h"
@@ -17,6 +19,7 @@
 #include "base/task/common/checked_lock.h"
 #include "base/task/delay_policy.h"
 #include "base/task/task_features.h"
+#include "base/task/thread_pool/delayed_task_timer_wheel.h"
 #include "base/task/thread_pool/task.h"
 #include "base/thread_annotations.h"
 #include "base/time/default_tick_clock.h"
@@ -29,8 +32,10 @@ class SequencedTaskRunner;
 namespace internal {
 
 // The DelayedTaskManager forwards tasks to post task callbacks when they become
-// ripe for execution. Tasks are not forwarded before Start() is called. This
-// class is thread-safe.
+// ripe for execution. Tasks are not forwarded before Start() is called. When
+// kDelayedTaskManagerTimerWheel is enabled, tasks added after Start() are kept
+// in a DelayedTaskTimerWheel until their tick is reached. This class is
+// thread-safe.
 class BASE_EXPORT DelayedTaskManager {
  public:
   // Posts |task| for execution immediately.
@@ -103,9 +108,13 @@ class BASE_EXPORT DelayedTaskManager {
   // or TimeTicks::Max() if none needs to be scheduled (i.e. no task, or next
   // task already scheduled).
   std::pair<TimeTicks, subtle::DelayPolicy>
-  GetTimeAndDelayPolicyToScheduleProcessRipeTasksLockRequired()
+  GetTimeAndDelayPolicyToScheduleProcessRipeTasksLockRequired() const
       EXCLUSIVE_LOCKS_REQUIRED(queue_lock_);
 
+  // Same as above, taking into account tasks in |timer_wheel_|.
+  std::pair<TimeTicks, subtle::DelayPolicy>
+  GetTimeAndDelayPolicyToScheduleProcessRipeTasks() const;
+
   // Schedule |ProcessRipeTasks()| on the service thread to be executed when
   // the next task is ripe.
   void ScheduleProcessRipeTasksOnServiceThread();
@@ -126,12 +135,28 @@ class BASE_EXPORT DelayedTaskManager {
 
   DelayedTaskHandle delayed_task_handle_ GUARDED_BY_CONTEXT(sequence_checker_);
 
-  IntrusiveHeap<DelayedTask, std::greater<>> delayed_task_queue_
-      GUARDED_BY(queue_lock_);
+  // 4-ary, since this holds the delayed tasks of every thread pool sequence.
+  IntrusiveHeap<DelayedTask,
+                std::greater<>,
+                DefaultHeapHandleAccessor<DelayedTask>,
+                4>
+      delayed_task_queue_ GUARDED_BY(queue_lock_);
 
+  // Immutable once |use_timer_wheel_| is set.
   base::TimeDelta max_precise_delay GUARDED_BY(queue_lock_) =
       kDefaultMaxPreciseDelay;
 
+  // Created in Start() if kDelayedTaskManagerTimerWheel is enabled, before
+  // |use_timer_wheel_| is set.
+  std::unique_ptr<DelayedTaskTimerWheel> timer_wheel_;
+  std::atomic_bool use_timer_wheel_{false};
+
+  // With |timer_wheel_|, the time at which ProcessRipeTasks() is scheduled, or
+  // TimeTicks::Min() while it is being rescheduled. Adding a task to
+  // |timer_wheel_| reschedules ProcessRipeTasks() only if the task is ripe
+  // before this.
+  std::atomic<TimeTicks> process_ripe_tasks_time_{TimeTicks::Max()};
+
   SEQUENCE_CHECKER(sequence_checker_);
 };
 
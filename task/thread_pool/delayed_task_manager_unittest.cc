@@ -81,6 +81,16 @@ class ThreadPoolDelayedTaskManagerTest : public testing::Test {
   Task task_;
 };
 
+class ThreadPoolDelayedTaskManagerTimerWheelTest
+    : public ThreadPoolDelayedTaskManagerTest {
+ protected:
+  ThreadPoolDelayedTaskManagerTimerWheelTest() {
+    feature_list_.InitAndEnableFeature(kDelayedTaskManagerTimerWheel);
+  }
+
+  base::test::ScopedFeatureList feature_list_;
+};
+
 }  // namespace
 
 // Verify that a delayed task isn't forwarded before Start().
@@ -336,5 +346,67 @@ TEST_F(ThreadPoolDelayedTaskManagerTest, PostTaskDuringStart) {
   service_thread_task_runner_->FastForwardBy(kLongDelay);
 }
 
+// Verify that delayed tasks added to the timer wheel after Start() are
+// forwarded when they are ripe for execution, whichever level of the wheel
+// they are in.
+TEST_F(ThreadPoolDelayedTaskManagerTimerWheelTest, DelayedTasksRunAfterDelay) {
+  delayed_task_manager_.Start(service_thread_task_runner_);
+
+  const TimeTicks now = service_thread_task_runner_->NowTicks();
+  testing::StrictMock<MockCallback> mock_callback_a;
+  delayed_task_manager_.AddDelayedTask(
+      ConstructMockedTask(mock_callback_a, now, Milliseconds(10)),
+      BindOnce(&PostTaskNow));
+  testing::StrictMock<MockCallback> mock_callback_b;
+  delayed_task_manager_.AddDelayedTask(
+      ConstructMockedTask(mock_callback_b, now, Seconds(10)),
+      BindOnce(&PostTaskNow));
+  delayed_task_manager_.AddDelayedTask(std::move(task_),
+                                       BindOnce(&PostTaskNow));
+  EXPECT_EQ(now + Milliseconds(10),
+            delayed_task_manager_.NextScheduledRunTime());
+
+  service_thread_task_runner_->FastForwardBy(Milliseconds(9));
+  EXPECT_CALL(mock_callback_a, Run());
+  service_thread_task_runner_->FastForwardBy(Milliseconds(1));
+  testing::Mock::VerifyAndClear(&mock_callback_a);
+
+  service_thread_task_runner_->FastForwardBy(Seconds(10) - Milliseconds(11));
+  EXPECT_CALL(mock_callback_b, Run());
+  service_thread_task_runner_->FastForwardBy(Milliseconds(1));
+  testing::Mock::VerifyAndClear(&mock_callback_b);
+
+  service_thread_task_runner_->FastForwardBy(kLongDelay - Seconds(10) -
+                                             Milliseconds(1));
+  EXPECT_CALL(mock_callback_, Run());
+  service_thread_task_runner_->FastForwardBy(Milliseconds(1));
+  testing::Mock::VerifyAndClear(&mock_callback_);
+  EXPECT_FALSE(delayed_task_manager_.NextScheduledRunTime());
+}
+
+// Verify that a task added to the timer wheel is forwarded before a later task
+// that is already scheduled.
+TEST_F(ThreadPoolDelayedTaskManagerTimerWheelTest,
+       EarlierDelayedTaskRunsFirst) {
+  delayed_task_manager_.Start(service_thread_task_runner_);
+
+  delayed_task_manager_.AddDelayedTask(std::move(task_),
+                                       BindOnce(&PostTaskNow));
+  service_thread_task_runner_->RunUntilIdle();
+
+  testing::StrictMock<MockCallback> mock_callback_a;
+  delayed_task_manager_.AddDelayedTask(
+      ConstructMockedTask(mock_callback_a,
+                          service_thread_task_runner_->NowTicks(), Seconds(1)),
+      BindOnce(&PostTaskNow));
+
+  EXPECT_CALL(mock_callback_a, Run());
+  service_thread_task_runner_->FastForwardBy(Seconds(1));
+  testing::Mock::VerifyAndClear(&mock_callback_a);
+
+  EXPECT_CALL(mock_callback_, Run());
+  service_thread_task_runner_->FastForwardBy(kLongDelay - Seconds(1));
+}
+
 }  // namespace internal
 }  // namespace base
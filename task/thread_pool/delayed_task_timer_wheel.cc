@@ -0,0 +1,231 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/delayed_task_timer_wheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "base/check_op.h"
+
+namespace base {
+namespace internal {
+
+DelayedTaskTimerWheel::Entry::Entry(Task task, PostTaskNowCallback callback)
+    : task(std::move(task)), callback(std::move(callback)) {}
+
+DelayedTaskTimerWheel::Entry::Entry(Entry&& other) = default;
+
+DelayedTaskTimerWheel::Entry& DelayedTaskTimerWheel::Entry::operator=(
+    Entry&& other) = default;
+
+DelayedTaskTimerWheel::Entry::~Entry() = default;
+
+DelayedTaskTimerWheel::Slot::Slot() = default;
+
+DelayedTaskTimerWheel::Slot::~Slot() = default;
+
+DelayedTaskTimerWheel::DelayedTaskTimerWheel(TimeTicks origin)
+    : origin_(origin) {}
+
+DelayedTaskTimerWheel::~DelayedTaskTimerWheel() = default;
+
+std::optional<DelayedTaskTimerWheel::Entry> DelayedTaskTimerWheel::Insert(
+    Entry entry) {
+  const int64_t tick = GetTick(entry.task.earliest_delayed_run_time());
+  while (true) {
+    const int64_t current_tick = current_tick_.load();
+    const std::optional<std::pair<size_t, size_t>> level_and_index =
+        GetLevelAndIndex(tick, current_tick);
+    if (!level_and_index) {
+      return entry;
+    }
+    const auto [level, index] = *level_and_index;
+    Slot& slot = slots_[level][index];
+    CheckedAutoLock auto_lock(slot.lock);
+    // The bit is set before |current_tick_| is validated: if Advance() moves
+    // past |current_tick| concurrently, either this sees the new tick and
+    // retries, or Advance() sees the bit and processes the slot.
+    non_empty_slots_[level].fetch_or(uint64_t{1} << index);
+    if (current_tick_.load() != current_tick) {
+      continue;
+    }
+    const RunTime run_time{entry.task.latest_delayed_run_time(),
+                           entry.task.delayed_run_time,
+                           entry.task.delay_policy};
+    if (!slot.next_run_time ||
+        run_time.latest_delayed_run_time <
+            slot.next_run_time->latest_delayed_run_time) {
+      slot.next_run_time = run_time;
+    }
+    slot.entries.push_back(std::move(entry));
+    return std::nullopt;
+  }
+}
+
+std::vector<DelayedTaskTimerWheel::Entry> DelayedTaskTimerWheel::Advance(
+    TimeTicks now) {
+  CheckedAutoLock auto_lock(advance_lock_);
+  const int64_t target_tick = GetTick(now);
+  std::vector<Entry> entries;
+  int64_t current_tick = current_tick_.load(std::memory_order_relaxed);
+  while (current_tick < target_tick) {
+    // Jump to the next tick at which a slot must be processed, skipping empty
+    // slots.
+    int64_t next_tick = target_tick;
+    for (size_t level = 0; level < kNumLevels; ++level) {
+      next_tick =
+          std::min(next_tick, GetNextSlotTick(level, current_tick).value_or(
+                                  target_tick));
+    }
+    current_tick_.store(next_tick);
+
+    // Process the slots reached, including those that Insert() filled
+    // concurrently relative to |current_tick| and that the search above
+    // missed. Higher levels go first, since they cascade into lower ones.
+    for (size_t level = kNumLevels; level-- > 0;) {
+      uint64_t bits = non_empty_slots_[level].load();
+      while (bits) {
+        const size_t index = static_cast<size_t>(std::countr_zero(bits));
+        bits &= bits - 1;
+        if (GetSlotTick(level, index, current_tick) > next_tick) {
+          continue;
+        }
+        for (Entry& entry : TakeSlot(level, index)) {
+          if (!entry.task.task.MaybeValid()) {
+            entries.push_back(std::move(entry));
+            continue;
+          }
+          std::optional<Entry> reached = Insert(std::move(entry));
+          if (reached) {
+            entries.push_back(std::move(*reached));
+          }
+        }
+      }
+    }
+    current_tick = next_tick;
+  }
+  return entries;
+}
+
+std::optional<DelayedTaskTimerWheel::RunTime>
+DelayedTaskTimerWheel::GetNextRunTime() const {
+  const int64_t current_tick = current_tick_.load();
+  std::optional<RunTime> next_run_time;
+  auto update_next_run_time = [&](size_t level, size_t index) {
+    std::optional<RunTime> run_time = GetSlotRunTime(level, index);
+    if (run_time &&
+        (!next_run_time || run_time->latest_delayed_run_time <
+                               next_run_time->latest_delayed_run_time)) {
+      next_run_time = run_time;
+    }
+    return run_time.has_value();
+  };
+
+  for (uint64_t bits = non_empty_slots_[0].load(); bits; bits &= bits - 1) {
+    update_next_run_time(0, static_cast<size_t>(std::countr_zero(bits)));
+  }
+  for (size_t level = 1; level < kNumLevels; ++level) {
+    // Visit the slots of |level| in the order in which they are processed,
+    // until one turns out to be non-empty.
+    const int shift = static_cast<int>(level) * kLevelBits;
+    const size_t first_index =
+        static_cast<size_t>((current_tick >> shift) + 1) % kSlotsPerLevel;
+    for (uint64_t bits =
+             std::rotr(non_empty_slots_[level].load(), first_index);
+         bits; bits &= bits - 1) {
+      const size_t index =
+          (first_index + static_cast<size_t>(std::countr_zero(bits))) %
+          kSlotsPerLevel;
+      if (update_next_run_time(level, index)) {
+        break;
+      }
+    }
+  }
+  return next_run_time;
+}
+
+int64_t DelayedTaskTimerWheel::GetTick(TimeTicks time) const {
+  if (time <= origin_) {
+    return 0;
+  }
+  return (time - origin_).IntDiv(kTickDuration);
+}
+
+// static
+std::optional<std::pair<size_t, size_t>>
+DelayedTaskTimerWheel::GetLevelAndIndex(int64_t tick, int64_t current_tick) {
+  if (tick <= current_tick) {
+    return std::nullopt;
+  }
+  // Use the lowest level where |tick| is less than a full turn away from the
+  // current tick. It is then in a later slot than the current one, which was
+  // already processed.
+  for (size_t level = 0; level < kNumLevels; ++level) {
+    const int shift = static_cast<int>(level) * kLevelBits;
+    if ((tick >> shift) - (current_tick >> shift) <
+        static_cast<int64_t>(kSlotsPerLevel)) {
+      return std::make_pair(
+          level, static_cast<size_t>(tick >> shift) % kSlotsPerLevel);
+    }
+  }
+  // Beyond the range of the wheel: keep the entry in the furthest slot of the
+  // last level, from which it is inserted again when that slot is processed.
+  constexpr int kLastShift = static_cast<int>(kNumLevels - 1) * kLevelBits;
+  return std::make_pair(
+      kNumLevels - 1,
+      static_cast<size_t>((current_tick >> kLastShift) + kSlotsPerLevel - 1) %
+          kSlotsPerLevel);
+}
+
+// static
+int64_t DelayedTaskTimerWheel::GetSlotTick(size_t level,
+                                           size_t index,
+                                           int64_t current_tick) {
+  const int shift = static_cast<int>(level) * kLevelBits;
+  const int64_t current_slot = current_tick >> shift;
+  // Slots after the current one, up to a full turn.
+  const int64_t distance =
+      static_cast<int64_t>(
+          (index - static_cast<size_t>(current_slot) - 1) % kSlotsPerLevel) +
+      1;
+  return (current_slot + distance) << shift;
+}
+
+std::optional<int64_t> DelayedTaskTimerWheel::GetNextSlotTick(
+    size_t level,
+    int64_t current_tick) const {
+  const uint64_t bits = non_empty_slots_[level].load();
+  if (!bits) {
+    return std::nullopt;
+  }
+  const int shift = static_cast<int>(level) * kLevelBits;
+  const size_t first_index =
+      static_cast<size_t>((current_tick >> shift) + 1) % kSlotsPerLevel;
+  const size_t index = (first_index + static_cast<size_t>(std::countr_zero(
+                                          std::rotr(bits, first_index)))) %
+                       kSlotsPerLevel;
+  return GetSlotTick(level, index, current_tick);
+}
+
+std::vector<DelayedTaskTimerWheel::Entry> DelayedTaskTimerWheel::TakeSlot(
+    size_t level,
+    size_t index) {
+  Slot& slot = slots_[level][index];
+  CheckedAutoLock auto_lock(slot.lock);
+  non_empty_slots_[level].fetch_and(~(uint64_t{1} << index));
+  slot.next_run_time.reset();
+  return std::exchange(slot.entries, {});
+}
+
+std::optional<DelayedTaskTimerWheel::RunTime>
+DelayedTaskTimerWheel::GetSlotRunTime(size_t level, size_t index) const {
+  const Slot& slot = slots_[level][index];
+  CheckedAutoLock auto_lock(slot.lock);
+  return slot.next_run_time;
+}
+
+}  // namespace internal
+}  // namespace base
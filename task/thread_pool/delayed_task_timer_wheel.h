@@ -0,0 +1,147 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_THREAD_POOL_DELAYED_TASK_TIMER_WHEEL_H_
+#define BASE_TASK_THREAD_POOL_DELAYED_TASK_TIMER_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/functional/callback.h"
+#include "base/task/common/checked_lock.h"
+#include "base/task/delay_policy.h"
+#include "base/task/thread_pool/task.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+
+namespace base {
+namespace internal {
+
+// A hierarchical timing wheel of delayed tasks, used by DelayedTaskManager to
+// make adding a delayed task O(1) regardless of how many are pending.
+//
+// Time is divided in ticks of kTickDuration. A task is kept in a slot of the
+// level whose slots are just wide enough to tell its tick apart from the
+// current one: level 0 has a slot per tick for the next 64 ticks, level 1 a
+// slot per 64 ticks for the next 64 * 64 ticks, and so on. As time advances,
+// the tasks of a higher level slot are spread in lower levels ("cascaded"),
+// until they reach the current tick. Each slot has its own lock, so adding
+// tasks from several threads doesn't contend on a single lock.
+//
+// The wheel only tells which tasks reached their tick; DelayedTaskManager keeps
+// them in its DelayedPriorityQueue until their earliest delayed run time, so
+// DelayPolicy and leeway semantics are unaffected. This class is thread-safe.
+class BASE_EXPORT DelayedTaskTimerWheel {
+ public:
+  using PostTaskNowCallback = OnceCallback<void(Task task)>;
+
+  static constexpr TimeDelta kTickDuration = Milliseconds(1);
+  static constexpr size_t kNumLevels = 4;
+  static constexpr int kLevelBits = 6;
+  static constexpr size_t kSlotsPerLevel = size_t{1} << kLevelBits;
+
+  struct BASE_EXPORT Entry {
+    Entry(Task task, PostTaskNowCallback callback);
+    Entry(Entry&& other);
+    Entry& operator=(Entry&& other);
+    ~Entry();
+
+    Task task;
+    PostTaskNowCallback callback;
+  };
+
+  // The run time of the next task, see GetNextRunTime().
+  struct RunTime {
+    TimeTicks latest_delayed_run_time;
+    TimeTicks delayed_run_time;
+    subtle::DelayPolicy delay_policy;
+  };
+
+  // Ticks are counted from |origin|.
+  explicit DelayedTaskTimerWheel(TimeTicks origin);
+  DelayedTaskTimerWheel(const DelayedTaskTimerWheel&) = delete;
+  DelayedTaskTimerWheel& operator=(const DelayedTaskTimerWheel&) = delete;
+  ~DelayedTaskTimerWheel();
+
+  // Adds |entry| to the wheel, unless its earliest delayed run time falls
+  // within the current tick, in which case it is returned to the caller.
+  std::optional<Entry> Insert(Entry entry);
+
+  // Advances the current tick to that of |now|, and returns the entries whose
+  // tick was reached, in no particular order. Canceled entries found while
+  // cascading are returned early, to be deleted.
+  std::vector<Entry> Advance(TimeTicks now);
+
+  // Returns the run time of the task with the earliest latest delayed run time
+  // among the tasks of level 0 and of the first slot of each higher level, or
+  // nullopt if the wheel is empty. Tasks of higher levels are at least 64 ticks
+  // away, so looking beyond their first slot doesn't change when they need to
+  // be cascaded.
+  std::optional<RunTime> GetNextRunTime() const;
+
+ private:
+  struct Slot {
+    Slot();
+    ~Slot();
+
+    // Universal successor: tasks can be posted while holding any lock.
+    mutable CheckedLock lock{UniversalSuccessor()};
+    std::vector<Entry> entries GUARDED_BY(lock);
+    // The run time of the entry with the earliest latest delayed run time.
+    std::optional<RunTime> next_run_time GUARDED_BY(lock);
+  };
+
+  // Returns the tick during which |time| falls.
+  int64_t GetTick(TimeTicks time) const;
+
+  // Returns the level and index of the slot that keeps entries of |tick| when
+  // the current tick is |current_tick|, or nullopt if |tick| is not after
+  // |current_tick|.
+  static std::optional<std::pair<size_t, size_t>> GetLevelAndIndex(
+      int64_t tick,
+      int64_t current_tick);
+
+  // Returns the tick at which the slot |index| of |level| must be processed
+  // when the current tick is |current_tick|.
+  static int64_t GetSlotTick(size_t level, size_t index, int64_t current_tick);
+
+  // Returns the tick at which the first non-empty slot of |level| must be
+  // processed when the current tick is |current_tick|, if any.
+  std::optional<int64_t> GetNextSlotTick(size_t level,
+                                         int64_t current_tick) const;
+
+  // Removes and returns the entries of the slot |index| of |level|.
+  std::vector<Entry> TakeSlot(size_t level, size_t index);
+
+  // Returns the next run time of the slot |index| of |level|.
+  std::optional<RunTime> GetSlotRunTime(size_t level, size_t index) const;
+
+  const TimeTicks origin_;
+
+  // Serializes calls to Advance(), the only writer of |current_tick_|.
+  CheckedLock advance_lock_;
+
+  // The last tick that Advance() reached. Insert() reads it without
+  // |advance_lock_| and validates it under the lock of its slot.
+  std::atomic<int64_t> current_tick_{0};
+
+  // For each level, a bit per slot that might be non-empty. A bit is set
+  // before a slot is validated for insertion and cleared when the slot is
+  // emptied, both under the lock of the slot.
+  std::array<std::atomic<uint64_t>, kNumLevels> non_empty_slots_{};
+
+  std::array<std::array<Slot, kSlotsPerLevel>, kNumLevels> slots_;
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_TASK_THREAD_POOL_DELAYED_TASK_TIMER_WHEEL_H_
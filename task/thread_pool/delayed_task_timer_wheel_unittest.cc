@@ -0,0 +1,127 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/delayed_task_timer_wheel.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "base/cancelable_callback.h"
+#include "base/functional/callback_helpers.h"
+#include "base/task/thread_pool/task.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+class DelayedTaskTimerWheelTest : public testing::Test {
+ protected:
+  DelayedTaskTimerWheel::Entry MakeEntry(TimeDelta delay,
+                                         OnceClosure closure = DoNothing()) {
+    return DelayedTaskTimerWheel::Entry(
+        Task(FROM_HERE, std::move(closure), origin_, delay), DoNothing());
+  }
+
+  // Inserts an entry that runs after |delay|, and expects it to be kept in
+  // the wheel.
+  void Insert(TimeDelta delay, OnceClosure closure = DoNothing()) {
+    EXPECT_FALSE(wheel_.Insert(MakeEntry(delay, std::move(closure))));
+  }
+
+  size_t Advance(TimeDelta delay) {
+    return wheel_.Advance(origin_ + delay).size();
+  }
+
+  const TimeTicks origin_ = TimeTicks() + Seconds(1);
+  DelayedTaskTimerWheel wheel_{origin_};
+};
+
+}  // namespace
+
+TEST_F(DelayedTaskTimerWheelTest, InsertWithinCurrentTickIsReturned) {
+  EXPECT_TRUE(wheel_.Insert(MakeEntry(Microseconds(500))));
+  EXPECT_FALSE(wheel_.GetNextRunTime());
+
+  EXPECT_EQ(0u, Advance(Milliseconds(10)));
+  EXPECT_TRUE(wheel_.Insert(MakeEntry(Milliseconds(5))));
+}
+
+TEST_F(DelayedTaskTimerWheelTest, AdvanceReturnsReachedEntries) {
+  Insert(Milliseconds(5));
+  Insert(Milliseconds(10));
+  Insert(Milliseconds(10));
+
+  EXPECT_EQ(0u, Advance(Milliseconds(4)));
+  EXPECT_EQ(1u, Advance(Milliseconds(5)));
+  EXPECT_EQ(0u, Advance(Milliseconds(9)));
+  EXPECT_EQ(2u, Advance(Milliseconds(20)));
+  EXPECT_FALSE(wheel_.GetNextRunTime());
+}
+
+// Entries kept in higher levels are cascaded to lower levels and returned only
+// when their tick is reached.
+TEST_F(DelayedTaskTimerWheelTest, CascadesFromHigherLevels) {
+  Insert(Milliseconds(1000));
+  Insert(Hours(1));
+
+  EXPECT_EQ(0u, Advance(Milliseconds(999)));
+  EXPECT_EQ(1u, Advance(Milliseconds(1000)));
+  EXPECT_EQ(0u, Advance(Hours(1) - Milliseconds(1)));
+  EXPECT_EQ(1u, Advance(Hours(1)));
+}
+
+// Entries beyond the range of the wheel are kept until their tick is reached.
+TEST_F(DelayedTaskTimerWheelTest, BeyondRange) {
+  Insert(Days(2));
+
+  EXPECT_EQ(0u, Advance(Days(1)));
+  EXPECT_EQ(0u, Advance(Days(2) - Milliseconds(1)));
+  EXPECT_EQ(1u, Advance(Days(2)));
+}
+
+// Canceled entries are returned when their slot is processed, before their
+// tick is reached.
+TEST_F(DelayedTaskTimerWheelTest, CanceledEntriesReturnedWhenCascading) {
+  CancelableOnceClosure cancelable_closure(DoNothing());
+  Insert(Milliseconds(1000), cancelable_closure.callback());
+  Insert(Milliseconds(1000));
+  cancelable_closure.Cancel();
+
+  std::vector<DelayedTaskTimerWheel::Entry> entries =
+      wheel_.Advance(origin_ + Milliseconds(999));
+  ASSERT_EQ(1u, entries.size());
+  EXPECT_FALSE(entries[0].task.task.MaybeValid());
+  EXPECT_EQ(1u, Advance(Milliseconds(1000)));
+}
+
+TEST_F(DelayedTaskTimerWheelTest, GetNextRunTime) {
+  EXPECT_FALSE(wheel_.GetNextRunTime());
+
+  Insert(Milliseconds(1000));
+  std::optional<DelayedTaskTimerWheel::RunTime> run_time =
+      wheel_.GetNextRunTime();
+  ASSERT_TRUE(run_time);
+  EXPECT_EQ(origin_ + Milliseconds(1000), run_time->delayed_run_time);
+
+  Insert(Milliseconds(10));
+  run_time = wheel_.GetNextRunTime();
+  ASSERT_TRUE(run_time);
+  EXPECT_EQ(origin_ + Milliseconds(10), run_time->delayed_run_time);
+  EXPECT_EQ(subtle::DelayPolicy::kFlexibleNoSooner, run_time->delay_policy);
+
+  EXPECT_EQ(1u, Advance(Milliseconds(10)));
+  run_time = wheel_.GetNextRunTime();
+  ASSERT_TRUE(run_time);
+  EXPECT_EQ(origin_ + Milliseconds(1000), run_time->delayed_run_time);
+
+  EXPECT_EQ(1u, Advance(Milliseconds(1000)));
+  EXPECT_FALSE(wheel_.GetNextRunTime());
+}
+
+}  // namespace internal
+}  // namespace base
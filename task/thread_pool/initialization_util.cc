@@ -15,7 +15,8 @@ size_t RecommendedMaxNumberOfThreadsInThreadGroup(size_t min,
                                                   size_t max,
                                                   double cores_multiplier,
                                                   size_t offset) {
-  const auto num_of_cores = static_cast<size_t>(SysInfo::NumberOfProcessors());
+  const auto num_of_cores =
+      static_cast<size_t>(SysInfo::EffectiveNumberOfProcessors());
   const size_t threads =
       std::ceil<size_t>(num_of_cores * cores_multiplier) + offset;
   return std::clamp(threads, min, max);
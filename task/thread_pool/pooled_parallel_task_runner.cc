@@ -5,6 +5,8 @@
 #include "base/task/thread_pool/pooled_parallel_task_runner.h"
 #include "base/task/thread_pool/pooled_task_runner_delegate.h"
 
+#include <utility>
+
 #include "base/task/thread_pool/sequence.h"
 
 namespace base {
@@ -35,5 +37,27 @@ bool PooledParallelTaskRunner::PostDelayedTask(const Location& from_here,
       std::move(sequence));
 }
 
+bool PooledParallelTaskRunner::PostTasks(const Location& from_here,
+                                         std::vector<OnceClosure> closures) {
+  if (!PooledTaskRunnerDelegate::MatchesCurrentDelegate(
+          pooled_task_runner_delegate_)) {
+    return false;
+  }
+
+  // Post each task as part of a one-off single-task Sequence.
+  const TimeTicks now = TimeTicks::Now();
+  std::vector<std::pair<Task, scoped_refptr<Sequence>>> tasks_and_sequences;
+  tasks_and_sequences.reserve(closures.size());
+  for (OnceClosure& closure : closures) {
+    tasks_and_sequences.emplace_back(
+        Task(from_here, std::move(closure), now, TimeDelta()),
+        MakeRefCounted<Sequence>(traits_, nullptr,
+                                 TaskSourceExecutionMode::kParallel));
+  }
+
+  return pooled_task_runner_delegate_->PostTasksWithSequences(
+      std::move(tasks_and_sequences));
+}
+
 }  // namespace internal
 }  // namespace base
@@ -5,6 +5,8 @@
 #ifndef BASE_TASK_THREAD_POOL_POOLED_PARALLEL_TASK_RUNNER_H_
 #define BASE_TASK_THREAD_POOL_POOLED_PARALLEL_TASK_RUNNER_H_
 
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/functional/callback_forward.h"
 #include "base/location.h"
@@ -32,6 +34,8 @@ class BASE_EXPORT PooledParallelTaskRunner : public TaskRunner {
   bool PostDelayedTask(const Location& from_here,
                        OnceClosure closure,
                        TimeDelta delay) override;
+  bool PostTasks(const Location& from_here,
+                 std::vector<OnceClosure> closures) override;
 
  private:
   ~PooledParallelTaskRunner() override;
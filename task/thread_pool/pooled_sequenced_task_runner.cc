@@ -65,6 +65,25 @@ bool PooledSequencedTaskRunner::PostNonNestableDelayedTask(
   return PostDelayedTask(from_here, std::move(closure), delay);
 }
 
+bool PooledSequencedTaskRunner::PostTasks(const Location& from_here,
+                                          std::vector<OnceClosure> closures) {
+  if (!PooledTaskRunnerDelegate::MatchesCurrentDelegate(
+          pooled_task_runner_delegate_)) {
+    return false;
+  }
+
+  const TimeTicks now = TimeTicks::Now();
+  std::vector<Task> tasks;
+  tasks.reserve(closures.size());
+  for (OnceClosure& closure : closures) {
+    tasks.emplace_back(from_here, std::move(closure), now, TimeDelta());
+  }
+
+  // Post the tasks as part of |sequence_|.
+  return pooled_task_runner_delegate_->PostTasksWithSequence(std::move(tasks),
+                                                             sequence_);
+}
+
 bool PooledSequencedTaskRunner::RunsTasksInCurrentSequence() const {
   return sequence_->token() == SequenceToken::GetForCurrentThread();
 }
@@ -5,6 +5,8 @@
 #ifndef BASE_TASK_THREAD_POOL_POOLED_SEQUENCED_TASK_RUNNER_H_
 #define BASE_TASK_THREAD_POOL_POOLED_SEQUENCED_TASK_RUNNER_H_
 
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/functional/callback_forward.h"
 #include "base/location.h"
@@ -45,6 +47,9 @@ class BASE_EXPORT PooledSequencedTaskRunner
                                   OnceClosure closure,
                                   TimeDelta delay) override;
 
+  bool PostTasks(const Location& from_here,
+                 std::vector<OnceClosure> closures) override;
+
   bool RunsTasksInCurrentSequence() const override;
 
   void UpdatePriority(TaskPriority priority) override;
@@ -4,6 +4,8 @@
 
 #include "base/task/thread_pool/pooled_task_runner_delegate.h"
 
+#include <utility>
+
 #include "base/debug/task_trace.h"
 #include "base/logging.h"
 
@@ -52,5 +54,25 @@ bool PooledTaskRunnerDelegate::MatchesCurrentDelegate(
   return g_current_delegate == delegate;
 }
 
+bool PooledTaskRunnerDelegate::PostTasksWithSequence(
+    std::vector<Task> tasks,
+    scoped_refptr<Sequence> sequence) {
+  bool all_posted = true;
+  for (Task& task : tasks) {
+    all_posted &= PostTaskWithSequence(std::move(task), sequence);
+  }
+  return all_posted;
+}
+
+bool PooledTaskRunnerDelegate::PostTasksWithSequences(
+    std::vector<std::pair<Task, scoped_refptr<Sequence>>>
+        tasks_and_sequences) {
+  bool all_posted = true;
+  for (auto& [task, sequence] : tasks_and_sequences) {
+    all_posted &= PostTaskWithSequence(std::move(task), std::move(sequence));
+  }
+  return all_posted;
+}
+
 }  // namespace internal
 }  // namespace base
@@ -5,6 +5,9 @@
 #ifndef BASE_TASK_THREAD_POOL_POOLED_TASK_RUNNER_DELEGATE_H_
 #define BASE_TASK_THREAD_POOL_POOLED_TASK_RUNNER_DELEGATE_H_
 
+#include <utility>
+#include <vector>
+
 #include "base/base_export.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool/job_task_source.h"
@@ -41,6 +44,23 @@ class BASE_EXPORT PooledTaskRunnerDelegate {
   virtual bool PostTaskWithSequence(Task task,
                                     scoped_refptr<Sequence> sequence) = 0;
 
+  // Invoked when |tasks| are posted together to the PooledSequencedTaskRunner
+  // of |sequence|. Equivalent to calling PostTaskWithSequence() for each task
+  // in order, which the default implementation does; implementations may
+  // enqueue them at once instead. Returns true if all tasks were successfully
+  // posted.
+  virtual bool PostTasksWithSequence(std::vector<Task> tasks,
+                                     scoped_refptr<Sequence> sequence);
+
+  // Invoked when tasks are posted together to a PooledParallelTaskRunner, each
+  // with its own one-off Sequence. Equivalent to calling
+  // PostTaskWithSequence() for each pair, which the default implementation
+  // does; implementations may wake up workers once for all of them instead.
+  // Returns true if all tasks were successfully posted.
+  virtual bool PostTasksWithSequences(
+      std::vector<std::pair<Task, scoped_refptr<Sequence>>>
+          tasks_and_sequences);
+
   // Invoked when a task is posted as a Job. The implementation must add
   // |task_source| to the appropriate priority queue, depending on |task_source|
   // traits, if it's not there already. Returns true if task source was
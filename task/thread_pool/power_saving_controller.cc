@@ -0,0 +1,65 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/power_saving_controller.h"
+
+#include <utility>
+
+#include "base/power_monitor/power_monitor.h"
+
+namespace base {
+namespace internal {
+
+PowerSavingController::PowerSavingController(Callback callback)
+    : callback_(std::move(callback)) {
+  on_battery_power_ =
+      PowerMonitor::AddPowerStateObserverAndReturnOnBatteryState(this);
+  thermal_state_ =
+      PowerMonitor::AddPowerStateObserverAndReturnPowerThermalState(this);
+  Update();
+}
+
+PowerSavingController::~PowerSavingController() {
+  PowerMonitor::RemovePowerStateObserver(this);
+  PowerMonitor::RemovePowerThermalObserver(this);
+}
+
+bool PowerSavingController::should_save_power() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return should_save_power_;
+}
+
+void PowerSavingController::OnPowerStateChange(bool on_battery_power) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  on_battery_power_ = on_battery_power;
+  Update();
+}
+
+void PowerSavingController::OnThermalStateChange(
+    DeviceThermalState new_state) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  thermal_state_ = new_state;
+  Update();
+}
+
+void PowerSavingController::OnSpeedLimitChange(int speed_limit) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  speed_limit_ = speed_limit;
+  Update();
+}
+
+void PowerSavingController::Update() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const bool should_save_power =
+      on_battery_power_ || thermal_state_ >= DeviceThermalState::kSerious ||
+      speed_limit_ < kSpeedLimitMax;
+  if (should_save_power == should_save_power_) {
+    return;
+  }
+  should_save_power_ = should_save_power;
+  callback_.Run(should_save_power_);
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,62 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_THREAD_POOL_POWER_SAVING_CONTROLLER_H_
+#define BASE_TASK_THREAD_POOL_POWER_SAVING_CONTROLLER_H_
+
+#include "base/base_export.h"
+#include "base/functional/callback.h"
+#include "base/power_monitor/power_observer.h"
+#include "base/sequence_checker.h"
+#include "base/thread_annotations.h"
+
+namespace base {
+namespace internal {
+
+// Decides whether the ThreadPool should save power, from the state reported by
+// the PowerMonitor: it should while the device is on battery power, while its
+// thermal state is serious or critical, or while the OS lowers the CPU speed
+// limit. Must be created on a sequence with a SequencedTaskRunner, on which the
+// PowerMonitor notifies it and it runs |callback| each time the decision
+// changes.
+class BASE_EXPORT PowerSavingController : public PowerStateObserver,
+                                          public PowerThermalObserver {
+ public:
+  using Callback = RepeatingCallback<void(bool should_save_power)>;
+
+  // Runs |callback| right away if the initial state calls for saving power.
+  explicit PowerSavingController(Callback callback);
+  PowerSavingController(const PowerSavingController&) = delete;
+  PowerSavingController& operator=(const PowerSavingController&) = delete;
+  // Can be destroyed on any sequence once the sequence it was created on
+  // stopped running tasks.
+  ~PowerSavingController() override;
+
+  bool should_save_power() const;
+
+  // PowerStateObserver:
+  void OnPowerStateChange(bool on_battery_power) override;
+
+  // PowerThermalObserver:
+  void OnThermalStateChange(DeviceThermalState new_state) override;
+  void OnSpeedLimitChange(int speed_limit) override;
+
+ private:
+  void Update();
+
+  bool on_battery_power_ GUARDED_BY_CONTEXT(sequence_checker_) = false;
+  DeviceThermalState thermal_state_ GUARDED_BY_CONTEXT(sequence_checker_) =
+      DeviceThermalState::kUnknown;
+  int speed_limit_ GUARDED_BY_CONTEXT(sequence_checker_) = kSpeedLimitMax;
+  bool should_save_power_ GUARDED_BY_CONTEXT(sequence_checker_) = false;
+
+  const Callback callback_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_TASK_THREAD_POOL_POWER_SAVING_CONTROLLER_H_
@@ -0,0 +1,97 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/power_saving_controller.h"
+
+#include <optional>
+#include <vector>
+
+#include "base/test/bind.h"
+#include "base/test/power_monitor_test.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+using DeviceThermalState = PowerThermalObserver::DeviceThermalState;
+
+class PowerSavingControllerTest : public testing::Test {
+ protected:
+  void CreateController() {
+    controller_.emplace(BindLambdaForTesting([&](bool should_save_power) {
+      changes_.push_back(should_save_power);
+    }));
+  }
+
+  test::TaskEnvironment task_environment_;
+  test::ScopedPowerMonitorTestSource power_monitor_source_;
+  std::vector<bool> changes_;
+  std::optional<PowerSavingController> controller_;
+};
+
+}  // namespace
+
+TEST_F(PowerSavingControllerTest, OnBatteryPower) {
+  CreateController();
+  EXPECT_FALSE(controller_->should_save_power());
+  EXPECT_TRUE(changes_.empty());
+
+  power_monitor_source_.GeneratePowerStateEvent(true);
+  EXPECT_TRUE(controller_->should_save_power());
+  power_monitor_source_.GeneratePowerStateEvent(false);
+  EXPECT_FALSE(controller_->should_save_power());
+  EXPECT_EQ(std::vector<bool>({true, false}), changes_);
+}
+
+TEST_F(PowerSavingControllerTest, InitialState) {
+  power_monitor_source_.GeneratePowerStateEvent(true);
+  CreateController();
+  EXPECT_TRUE(controller_->should_save_power());
+  EXPECT_EQ(std::vector<bool>({true}), changes_);
+}
+
+TEST_F(PowerSavingControllerTest, ThermalState) {
+  CreateController();
+  power_monitor_source_.GenerateThermalThrottlingEvent(
+      DeviceThermalState::kFair);
+  EXPECT_FALSE(controller_->should_save_power());
+  power_monitor_source_.GenerateThermalThrottlingEvent(
+      DeviceThermalState::kSerious);
+  EXPECT_TRUE(controller_->should_save_power());
+  power_monitor_source_.GenerateThermalThrottlingEvent(
+      DeviceThermalState::kCritical);
+  EXPECT_TRUE(controller_->should_save_power());
+  power_monitor_source_.GenerateThermalThrottlingEvent(
+      DeviceThermalState::kNominal);
+  EXPECT_FALSE(controller_->should_save_power());
+  EXPECT_EQ(std::vector<bool>({true, false}), changes_);
+}
+
+TEST_F(PowerSavingControllerTest, SpeedLimit) {
+  CreateController();
+  power_monitor_source_.GenerateSpeedLimitEvent(50);
+  EXPECT_TRUE(controller_->should_save_power());
+  power_monitor_source_.GenerateSpeedLimitEvent(
+      PowerThermalObserver::kSpeedLimitMax);
+  EXPECT_FALSE(controller_->should_save_power());
+  EXPECT_EQ(std::vector<bool>({true, false}), changes_);
+}
+
+TEST_F(PowerSavingControllerTest, SavesPowerUntilAllStatesClear) {
+  CreateController();
+  power_monitor_source_.GeneratePowerStateEvent(true);
+  power_monitor_source_.GenerateSpeedLimitEvent(50);
+  power_monitor_source_.GeneratePowerStateEvent(false);
+  EXPECT_TRUE(controller_->should_save_power());
+  power_monitor_source_.GenerateSpeedLimitEvent(
+      PowerThermalObserver::kSpeedLimitMax);
+  EXPECT_FALSE(controller_->should_save_power());
+  EXPECT_EQ(std::vector<bool>({true, false}), changes_);
+}
+
+}  // namespace internal
+}  // namespace base
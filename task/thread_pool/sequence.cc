@@ -10,8 +10,10 @@
 #include "base/critical_closure.h"
 #include "base/feature_list.h"
 #include "base/functional/bind.h"
+#include "base/memory/object_pool.h"
 #include "base/memory/ptr_util.h"
 #include "base/memory/stack_allocated.h"
+#include "base/no_destructor.h"
 #include "base/task/task_features.h"
 #include "base/time/time.h"
 
@@ -38,6 +40,12 @@ class SCOPED_LOCKABLE AnnotateLockAcquired {
   const CheckedLock& acquired_lock_;
 };
 
+ObjectPoolBase& GetSequencePool() {
+  static NoDestructor<ObjectPoolBase> pool(
+      "thread_pool_sequences", sizeof(Sequence), alignof(Sequence));
+  return *pool;
+}
+
 void MaybeMakeCriticalClosure(TaskShutdownBehavior shutdown_behavior,
                               Task& task) {
   switch (shutdown_behavior) {
@@ -91,7 +99,7 @@ void Sequence::Transaction::PushImmediateTask(Task task) {
 
   MaybeMakeCriticalClosure(sequence()->traits_.shutdown_behavior(), task);
 
-  sequence()->queue_.push(std::move(task));
+  sequence()->queue_.push_back(std::move(task));
 
   if (queue_was_empty)
     sequence()->UpdateReadyTimes();
@@ -167,7 +175,12 @@ size_t Sequence::GetRemainingConcurrency() const {
 
 Task Sequence::TakeNextImmediateTask() {
   Task next_task = std::move(queue_.front());
-  queue_.pop();
+  queue_.pop_front();
+  // Give back the memory of a burst of tasks once they ran. This is rate
+  // limited by the queue.
+  if (queue_.empty() && queue_.max_size() > TaskQueue::kReclaimThreshold) {
+    queue_.MaybeShrinkQueue();
+  }
   return next_task;
 }
 
@@ -309,10 +322,10 @@ std::optional<Task> Sequence::Clear(TaskSource::Transaction* transaction) {
   return Task(
       FROM_HERE,
       base::BindOnce(
-          [](base::queue<Task> queue,
+          [](TaskQueue queue,
              base::IntrusiveHeap<Task, DelayedTaskGreater> delayed_queue) {
             while (!queue.empty())
-              queue.pop();
+              queue.pop_front();
 
             while (!delayed_queue.empty())
               delayed_queue.pop();
@@ -337,6 +350,30 @@ Sequence::Sequence(const TaskTraits& traits,
 
 Sequence::~Sequence() = default;
 
+// static
+void* Sequence::operator new(size_t size) {
+  if (size != sizeof(Sequence)) {
+    return ::operator new(size);
+  }
+  if (!sequence_manager::internal::TaskQueueStorageRecycling::IsEnabled()) {
+    return GetSequencePool().AllocateUncached();
+  }
+  return GetSequencePool().Allocate();
+}
+
+// static
+void Sequence::operator delete(void* sequence, size_t size) {
+  if (size != sizeof(Sequence)) {
+    ::operator delete(sequence);
+    return;
+  }
+  if (!sequence_manager::internal::TaskQueueStorageRecycling::IsEnabled()) {
+    GetSequencePool().FreeUncached(sequence);
+    return;
+  }
+  GetSequencePool().Free(sequence);
+}
+
 Sequence::Transaction Sequence::BeginTransaction() {
   return Transaction(this);
 }
@@ -9,8 +9,8 @@
 
 #include "base/base_export.h"
 #include "base/containers/intrusive_heap.h"
-#include "base/containers/queue.h"
 #include "base/sequence_token.h"
+#include "base/task/sequence_manager/lazily_deallocated_deque.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool/pooled_parallel_task_runner.h"
 #include "base/task/thread_pool/task.h"
@@ -18,6 +18,7 @@
 #include "base/task/thread_pool/task_source_sort_key.h"
 #include "base/thread_annotations.h"
 #include "base/threading/sequence_local_storage_map.h"
+#include "base/time/time_override.h"
 
 namespace base {
 namespace internal {
@@ -90,6 +91,11 @@ class BASE_EXPORT Sequence : public TaskSource {
   Sequence(const Sequence&) = delete;
   Sequence& operator=(const Sequence&) = delete;
 
+  // The memory of Sequences is recycled with TaskQueueStorageRecycling, since a
+  // parallel task runner creates one for each of its tasks.
+  static void* operator new(size_t size);
+  static void operator delete(void* sequence, size_t size);
+
   // Begins a Transaction. This method cannot be called on a thread which has an
   // active Sequence::Transaction.
   [[nodiscard]] Transaction BeginTransaction();
@@ -175,8 +181,11 @@ class BASE_EXPORT Sequence : public TaskSource {
   // comment.
   raw_ptr<SequencedTaskRunner, DisableDanglingPtrDetection> task_runner_;
 
-  // Queues of tasks to execute.
-  base::queue<Task> queue_ GUARDED_BY(lock_);
+  // Queues of tasks to execute. The storage of `queue_` is recycled across
+  // Sequences.
+  using TaskQueue = sequence_manager::internal::
+      LazilyDeallocatedDeque<Task, subtle::TimeTicksNowIgnoringOverride>;
+  TaskQueue queue_ GUARDED_BY(lock_);
   base::IntrusiveHeap<Task, DelayedTaskGreater> delayed_queue_
       GUARDED_BY(lock_);
 
@@ -0,0 +1,259 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/task_latency_recorder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/hash/hash.h"
+#include "base/ranges/algorithm.h"
+#include "base/trace_event/base_tracing.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Number of tasks to run on the current thread before the next sampled one.
+ABSL_CONST_INIT thread_local size_t num_tasks_before_next_sample = 0;
+
+// Wake-up latency of the current worker, set until its next task runs.
+ABSL_CONST_INIT thread_local std::optional<TimeDelta>
+    wake_up_latency_for_current_thread;
+
+// Shard to which the current thread records, kNumShards if not assigned yet.
+ABSL_CONST_INIT thread_local size_t shard_index_for_current_thread =
+    TaskLatencyRecorder::kNumShards;
+
+std::atomic<size_t> g_next_shard_index{0};
+
+size_t GetShardIndexForCurrentThread() {
+  if (shard_index_for_current_thread == TaskLatencyRecorder::kNumShards) {
+    shard_index_for_current_thread =
+        g_next_shard_index.fetch_add(1, std::memory_order_relaxed) %
+        TaskLatencyRecorder::kNumShards;
+  }
+  return shard_index_for_current_thread;
+}
+
+uint64_t GetKey(const Location& posted_from, const TaskTraits& traits) {
+  const uint64_t traits_bits =
+      static_cast<uint64_t>(traits.priority()) |
+      static_cast<uint64_t>(traits.shutdown_behavior()) << 8 |
+      static_cast<uint64_t>(traits.thread_policy()) << 16 |
+      static_cast<uint64_t>(traits.may_block()) << 24 |
+      static_cast<uint64_t>(traits.with_base_sync_primitives()) << 25;
+  // 0 denotes an unused bucket.
+  return HashInts64(reinterpret_cast<uintptr_t>(posted_from.program_counter()),
+                    traits_bits) |
+         1;
+}
+
+void AtomicMax(std::atomic<int64_t>& max, int64_t value) {
+  int64_t current = max.load(std::memory_order_relaxed);
+  while (current < value &&
+         !max.compare_exchange_weak(current, value,
+                                    std::memory_order_relaxed)) {
+  }
+}
+
+void AddSample(std::atomic<int64_t>& total,
+               std::atomic<int64_t>& max,
+               TimeDelta value) {
+  const int64_t value_us = std::max<int64_t>(value.InMicroseconds(), 0);
+  total.fetch_add(value_us, std::memory_order_relaxed);
+  AtomicMax(max, value_us);
+}
+
+TimeDelta LoadMicroseconds(const std::atomic<int64_t>& value) {
+  return Microseconds(value.load(std::memory_order_relaxed));
+}
+
+}  // namespace
+
+TaskLatencyRecorder::TaskLatencyRecorder() = default;
+
+TaskLatencyRecorder::~TaskLatencyRecorder() = default;
+
+void TaskLatencyRecorder::Start(size_t sampling_interval,
+                                bool emit_trace_counters) {
+  DCHECK_GT(sampling_interval, 0u);
+  {
+    CheckedAutoLock auto_lock(shards_lock_);
+    if (!shards_) {
+      shards_ = std::make_unique<Shards>();
+      shards_ptr_.store(shards_.get(), std::memory_order_release);
+    }
+  }
+  emit_trace_counters_.store(emit_trace_counters, std::memory_order_relaxed);
+  sampling_interval_.store(sampling_interval, std::memory_order_relaxed);
+}
+
+void TaskLatencyRecorder::Stop() {
+  sampling_interval_.store(0, std::memory_order_relaxed);
+}
+
+// static
+void TaskLatencyRecorder::SetWakeUpLatencyForCurrentThread(TimeDelta latency) {
+  wake_up_latency_for_current_thread = latency;
+}
+
+std::optional<TaskLatencyRecorder::Sample>
+TaskLatencyRecorder::MaybeStartSample() {
+  const size_t sampling_interval =
+      sampling_interval_.load(std::memory_order_relaxed);
+  if (!sampling_interval) {
+    return std::nullopt;
+  }
+  // The wake-up latency only applies to the first task after a wake-up, even
+  // if that task isn't sampled.
+  std::optional<TimeDelta> wake_up_latency =
+      std::exchange(wake_up_latency_for_current_thread, std::nullopt);
+  // The interval may have been reduced since the countdown started.
+  num_tasks_before_next_sample =
+      std::min(num_tasks_before_next_sample, sampling_interval - 1);
+  if (num_tasks_before_next_sample > 0) {
+    --num_tasks_before_next_sample;
+    return std::nullopt;
+  }
+  num_tasks_before_next_sample = sampling_interval - 1;
+  return Sample{wake_up_latency};
+}
+
+void TaskLatencyRecorder::RecordSample(const Sample& sample,
+                                       const Location& posted_from,
+                                       const TaskTraits& traits,
+                                       TimeDelta queue_time,
+                                       TimeDelta run_time) {
+  Shards* shards = shards_ptr_.load(std::memory_order_acquire);
+  DCHECK(shards);
+  Bucket* bucket = GetBucket((*shards)[GetShardIndexForCurrentThread()],
+                             posted_from, traits);
+  if (bucket) {
+    bucket->num_samples.fetch_add(1, std::memory_order_relaxed);
+    AddSample(bucket->total_queue_time_us, bucket->max_queue_time_us,
+              queue_time);
+    AddSample(bucket->total_run_time_us, bucket->max_run_time_us, run_time);
+    if (sample.wake_up_latency) {
+      bucket->num_wake_up_samples.fetch_add(1, std::memory_order_relaxed);
+      AddSample(bucket->total_wake_up_latency_us,
+                bucket->max_wake_up_latency_us, *sample.wake_up_latency);
+    }
+  }
+  if (emit_trace_counters_.load(std::memory_order_relaxed)) {
+    EmitTraceCounters(traits.priority(), queue_time, run_time);
+  }
+}
+
+std::vector<ThreadPoolInstance::TaskLatencyStats>
+TaskLatencyRecorder::GetSnapshot() const {
+  std::vector<ThreadPoolInstance::TaskLatencyStats> snapshot;
+  const Shards* shards = shards_ptr_.load(std::memory_order_acquire);
+  if (!shards) {
+    return snapshot;
+  }
+  for (const Shard& shard : *shards) {
+    for (const Bucket& bucket : shard) {
+      if (!bucket.initialized.load(std::memory_order_acquire)) {
+        continue;
+      }
+      // Merge the buckets of all shards for the same location and traits.
+      auto it = ranges::find_if(snapshot, [&](const auto& stats) {
+        return stats.posted_from == bucket.posted_from &&
+               stats.traits == bucket.traits;
+      });
+      if (it == snapshot.end()) {
+        it = snapshot.emplace(snapshot.end());
+        it->posted_from = bucket.posted_from;
+        it->traits = bucket.traits;
+      }
+      it->num_samples += static_cast<size_t>(
+          bucket.num_samples.load(std::memory_order_relaxed));
+      it->total_queue_time += LoadMicroseconds(bucket.total_queue_time_us);
+      it->max_queue_time = std::max(it->max_queue_time,
+                                    LoadMicroseconds(bucket.max_queue_time_us));
+      it->total_run_time += LoadMicroseconds(bucket.total_run_time_us);
+      it->max_run_time =
+          std::max(it->max_run_time, LoadMicroseconds(bucket.max_run_time_us));
+      it->num_wake_up_samples += static_cast<size_t>(
+          bucket.num_wake_up_samples.load(std::memory_order_relaxed));
+      it->total_wake_up_latency +=
+          LoadMicroseconds(bucket.total_wake_up_latency_us);
+      it->max_wake_up_latency =
+          std::max(it->max_wake_up_latency,
+                   LoadMicroseconds(bucket.max_wake_up_latency_us));
+    }
+  }
+  return snapshot;
+}
+
+// static
+TaskLatencyRecorder::Bucket* TaskLatencyRecorder::GetBucket(
+    Shard& shard,
+    const Location& posted_from,
+    const TaskTraits& traits) {
+  const uint64_t key = GetKey(posted_from, traits);
+  for (size_t i = 0; i < kNumBucketsPerShard; ++i) {
+    Bucket& bucket = shard[(key + i) % kNumBucketsPerShard];
+    uint64_t bucket_key = bucket.key.load(std::memory_order_acquire);
+    if (bucket_key == 0) {
+      if (bucket.key.compare_exchange_strong(bucket_key, key,
+                                             std::memory_order_acq_rel)) {
+        bucket.posted_from = posted_from;
+        bucket.traits = traits;
+        bucket.initialized.store(true, std::memory_order_release);
+        return &bucket;
+      }
+      // Another thread claimed the bucket; |bucket_key| is its key.
+    }
+    if (bucket_key != key) {
+      continue;
+    }
+    if (!bucket.initialized.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    if (bucket.posted_from == posted_from && bucket.traits == traits) {
+      return &bucket;
+    }
+  }
+  return nullptr;
+}
+
+// static
+void TaskLatencyRecorder::EmitTraceCounters(TaskPriority priority,
+                                            TimeDelta queue_time,
+                                            TimeDelta run_time) {
+  switch (priority) {
+    case TaskPriority::BEST_EFFORT:
+      TRACE_COUNTER1(TRACE_DISABLED_BY_DEFAULT("thread_pool_diagnostics"),
+                     "ThreadPool.QueueTimeUs.BestEffort",
+                     queue_time.InMicroseconds());
+      TRACE_COUNTER1(TRACE_DISABLED_BY_DEFAULT("thread_pool_diagnostics"),
+                     "ThreadPool.RunTimeUs.BestEffort",
+                     run_time.InMicroseconds());
+      return;
+    case TaskPriority::USER_VISIBLE:
+      TRACE_COUNTER1(TRACE_DISABLED_BY_DEFAULT("thread_pool_diagnostics"),
+                     "ThreadPool.QueueTimeUs.UserVisible",
+                     queue_time.InMicroseconds());
+      TRACE_COUNTER1(TRACE_DISABLED_BY_DEFAULT("thread_pool_diagnostics"),
+                     "ThreadPool.RunTimeUs.UserVisible",
+                     run_time.InMicroseconds());
+      return;
+    case TaskPriority::USER_BLOCKING:
+      TRACE_COUNTER1(TRACE_DISABLED_BY_DEFAULT("thread_pool_diagnostics"),
+                     "ThreadPool.QueueTimeUs.UserBlocking",
+                     queue_time.InMicroseconds());
+      TRACE_COUNTER1(TRACE_DISABLED_BY_DEFAULT("thread_pool_diagnostics"),
+                     "ThreadPool.RunTimeUs.UserBlocking",
+                     run_time.InMicroseconds());
+      return;
+  }
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,128 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_THREAD_POOL_TASK_LATENCY_RECORDER_H_
+#define BASE_TASK_THREAD_POOL_TASK_LATENCY_RECORDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/location.h"
+#include "base/task/common/checked_lock.h"
+#include "base/task/task_traits.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+
+namespace base {
+namespace internal {
+
+// Collects latency statistics of a sample of the tasks run by the thread pool,
+// per posting location and traits. Statistics are aggregated in fixed-size
+// hash tables with atomic counters, without locks. Each thread records to one
+// of kNumShards tables so that workers don't contend on the same cache lines.
+// Samples are dropped if a table is full. This class is thread-safe.
+class BASE_EXPORT TaskLatencyRecorder {
+ public:
+  static constexpr size_t kNumShards = 8;
+  static constexpr size_t kNumBucketsPerShard = 256;
+
+  // A task to record, returned by MaybeStartSample().
+  struct Sample {
+    // Set if the task is the first that the current worker runs after being
+    // woken up.
+    std::optional<TimeDelta> wake_up_latency;
+  };
+
+  TaskLatencyRecorder();
+  TaskLatencyRecorder(const TaskLatencyRecorder&) = delete;
+  TaskLatencyRecorder& operator=(const TaskLatencyRecorder&) = delete;
+  ~TaskLatencyRecorder();
+
+  // See ThreadPoolInstance::StartTaskLatencySampling().
+  void Start(size_t sampling_interval, bool emit_trace_counters);
+
+  // See ThreadPoolInstance::StopTaskLatencySampling().
+  void Stop();
+
+  bool IsEnabled() const {
+    return sampling_interval_.load(std::memory_order_relaxed) != 0;
+  }
+
+  // Informs this recorder that the current worker was woken up |latency| after
+  // being asked to.
+  static void SetWakeUpLatencyForCurrentThread(TimeDelta latency);
+
+  // Returns a Sample if the next task that runs on the current thread should
+  // be recorded. Must be called once per task run.
+  std::optional<Sample> MaybeStartSample();
+
+  // Records |sample|, a task posted from |posted_from| with |traits| that
+  // started running |queue_time| after it became ready to run, and ran for
+  // |run_time|.
+  void RecordSample(const Sample& sample,
+                    const Location& posted_from,
+                    const TaskTraits& traits,
+                    TimeDelta queue_time,
+                    TimeDelta run_time);
+
+  // See ThreadPoolInstance::GetTaskLatencyStats().
+  std::vector<ThreadPoolInstance::TaskLatencyStats> GetSnapshot() const;
+
+ private:
+  struct Bucket {
+    // Hash of the posting location and traits, 0 if the bucket is unused.
+    std::atomic<uint64_t> key{0};
+    // Set once |posted_from| and |traits| are written by the thread that
+    // claimed the bucket.
+    std::atomic_bool initialized{false};
+    Location posted_from;
+    TaskTraits traits;
+
+    std::atomic<int64_t> num_samples{0};
+    std::atomic<int64_t> total_queue_time_us{0};
+    std::atomic<int64_t> max_queue_time_us{0};
+    std::atomic<int64_t> total_run_time_us{0};
+    std::atomic<int64_t> max_run_time_us{0};
+    std::atomic<int64_t> num_wake_up_samples{0};
+    std::atomic<int64_t> total_wake_up_latency_us{0};
+    std::atomic<int64_t> max_wake_up_latency_us{0};
+  };
+
+  using Shard = std::array<Bucket, kNumBucketsPerShard>;
+  using Shards = std::array<Shard, kNumShards>;
+
+  // Returns the bucket of |shard| for |posted_from| and |traits|, claiming it
+  // if needed, or nullptr if |shard| is full or the bucket is being claimed
+  // by another thread.
+  static Bucket* GetBucket(Shard& shard,
+                           const Location& posted_from,
+                           const TaskTraits& traits);
+
+  static void EmitTraceCounters(TaskPriority priority,
+                                TimeDelta queue_time,
+                                TimeDelta run_time);
+
+  // 0 when sampling is disabled.
+  std::atomic<size_t> sampling_interval_{0};
+  std::atomic_bool emit_trace_counters_{false};
+
+  // Allocated by the first Start() and kept until destruction, so that
+  // threads recording samples never see it deleted.
+  CheckedLock shards_lock_;
+  std::unique_ptr<Shards> shards_ GUARDED_BY(shards_lock_);
+  std::atomic<Shards*> shards_ptr_{nullptr};
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_TASK_THREAD_POOL_TASK_LATENCY_RECORDER_H_
@@ -0,0 +1,206 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/task_latency_recorder.h"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/memory/raw_ptr.h"
+#include "base/ranges/algorithm.h"
+#include "base/task/task_traits.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+const Location kLocationA = Location::CreateForTesting(
+    "FunctionA",
+    "a.cc",
+    1,
+    reinterpret_cast<const void*>(0x1000));
+const Location kLocationB = Location::CreateForTesting(
+    "FunctionB",
+    "b.cc",
+    2,
+    reinterpret_cast<const void*>(0x2000));
+
+constexpr int kNumSamplesPerThread = 100;
+
+// Records kNumSamplesPerThread samples for kLocationA.
+class RecordingDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  RecordingDelegate(TaskLatencyRecorder* recorder, const TaskTraits& traits)
+      : recorder_(recorder), traits_(traits) {}
+
+  void Run() override {
+    for (int i = 0; i < kNumSamplesPerThread; ++i) {
+      std::optional<TaskLatencyRecorder::Sample> sample =
+          recorder_->MaybeStartSample();
+      ASSERT_TRUE(sample);
+      recorder_->RecordSample(*sample, kLocationA, traits_, Microseconds(i),
+                              Microseconds(1));
+    }
+  }
+
+ private:
+  const raw_ptr<TaskLatencyRecorder> recorder_;
+  const TaskTraits traits_;
+};
+
+class TaskLatencyRecorderTest : public testing::Test {
+ protected:
+  // Starts a sample with an interval of 1 and records it.
+  void Record(const Location& posted_from,
+              const TaskTraits& traits,
+              TimeDelta queue_time,
+              TimeDelta run_time) {
+    std::optional<TaskLatencyRecorder::Sample> sample =
+        recorder_.MaybeStartSample();
+    ASSERT_TRUE(sample);
+    recorder_.RecordSample(*sample, posted_from, traits, queue_time, run_time);
+  }
+
+  const ThreadPoolInstance::TaskLatencyStats* Find(
+      const std::vector<ThreadPoolInstance::TaskLatencyStats>& snapshot,
+      const Location& posted_from,
+      const TaskTraits& traits) {
+    auto it = ranges::find_if(snapshot, [&](const auto& stats) {
+      return stats.posted_from == posted_from && stats.traits == traits;
+    });
+    return it == snapshot.end() ? nullptr : &*it;
+  }
+
+  TaskLatencyRecorder recorder_;
+};
+
+}  // namespace
+
+TEST_F(TaskLatencyRecorderTest, DisabledByDefault) {
+  EXPECT_FALSE(recorder_.IsEnabled());
+  EXPECT_FALSE(recorder_.MaybeStartSample());
+  EXPECT_TRUE(recorder_.GetSnapshot().empty());
+}
+
+TEST_F(TaskLatencyRecorderTest, SamplingInterval) {
+  recorder_.Start(3, /*emit_trace_counters=*/false);
+  EXPECT_TRUE(recorder_.IsEnabled());
+
+  // Skip to the first sampled task, which depends on tasks that previous tests
+  // ran on this thread.
+  size_t num_calls = 1;
+  while (!recorder_.MaybeStartSample()) {
+    ++num_calls;
+  }
+  EXPECT_LE(num_calls, 3u);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_FALSE(recorder_.MaybeStartSample());
+    EXPECT_FALSE(recorder_.MaybeStartSample());
+    EXPECT_TRUE(recorder_.MaybeStartSample());
+  }
+
+  recorder_.Stop();
+  EXPECT_FALSE(recorder_.IsEnabled());
+  EXPECT_FALSE(recorder_.MaybeStartSample());
+}
+
+TEST_F(TaskLatencyRecorderTest, AggregatesPerLocationAndTraits) {
+  recorder_.Start(1, /*emit_trace_counters=*/false);
+  const TaskTraits user_blocking = {TaskPriority::USER_BLOCKING};
+  const TaskTraits best_effort = {TaskPriority::BEST_EFFORT};
+  Record(kLocationA, user_blocking, Milliseconds(1), Milliseconds(10));
+  Record(kLocationA, user_blocking, Milliseconds(3), Milliseconds(20));
+  Record(kLocationA, best_effort, Milliseconds(5), Milliseconds(30));
+  Record(kLocationB, user_blocking, Milliseconds(7), Milliseconds(40));
+
+  const std::vector<ThreadPoolInstance::TaskLatencyStats> snapshot =
+      recorder_.GetSnapshot();
+  EXPECT_EQ(3u, snapshot.size());
+
+  const ThreadPoolInstance::TaskLatencyStats* stats =
+      Find(snapshot, kLocationA, user_blocking);
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(2u, stats->num_samples);
+  EXPECT_EQ(Milliseconds(4), stats->total_queue_time);
+  EXPECT_EQ(Milliseconds(3), stats->max_queue_time);
+  EXPECT_EQ(Milliseconds(30), stats->total_run_time);
+  EXPECT_EQ(Milliseconds(20), stats->max_run_time);
+  EXPECT_EQ(0u, stats->num_wake_up_samples);
+
+  stats = Find(snapshot, kLocationA, best_effort);
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(1u, stats->num_samples);
+  EXPECT_EQ(Milliseconds(5), stats->max_queue_time);
+
+  stats = Find(snapshot, kLocationB, user_blocking);
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(1u, stats->num_samples);
+  EXPECT_EQ(Milliseconds(40), stats->total_run_time);
+}
+
+// The wake-up latency is attributed to the first task that runs after it is
+// set, and only to that task.
+TEST_F(TaskLatencyRecorderTest, WakeUpLatency) {
+  recorder_.Start(1, /*emit_trace_counters=*/false);
+  const TaskTraits traits = {TaskPriority::USER_VISIBLE};
+
+  TaskLatencyRecorder::SetWakeUpLatencyForCurrentThread(Milliseconds(2));
+  std::optional<TaskLatencyRecorder::Sample> sample =
+      recorder_.MaybeStartSample();
+  ASSERT_TRUE(sample);
+  EXPECT_EQ(Milliseconds(2), sample->wake_up_latency);
+  recorder_.RecordSample(*sample, kLocationA, traits, TimeDelta(),
+                         Milliseconds(1));
+  Record(kLocationA, traits, TimeDelta(), Milliseconds(1));
+
+  const std::vector<ThreadPoolInstance::TaskLatencyStats> snapshot =
+      recorder_.GetSnapshot();
+  const ThreadPoolInstance::TaskLatencyStats* stats =
+      Find(snapshot, kLocationA, traits);
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(2u, stats->num_samples);
+  EXPECT_EQ(1u, stats->num_wake_up_samples);
+  EXPECT_EQ(Milliseconds(2), stats->total_wake_up_latency);
+  EXPECT_EQ(Milliseconds(2), stats->max_wake_up_latency);
+}
+
+// Samples recorded by multiple threads, in different shards, are merged in the
+// snapshot.
+TEST_F(TaskLatencyRecorderTest, MergesThreads) {
+  constexpr size_t kNumThreads = TaskLatencyRecorder::kNumShards * 2;
+  recorder_.Start(1, /*emit_trace_counters=*/false);
+  const TaskTraits traits = {TaskPriority::USER_VISIBLE};
+
+  std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+  std::vector<std::unique_ptr<DelegateSimpleThread::Delegate>> delegates;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    delegates.push_back(
+        std::make_unique<RecordingDelegate>(&recorder_, traits));
+    threads.push_back(std::make_unique<DelegateSimpleThread>(
+        delegates.back().get(), "TaskLatencyRecorderTest"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+
+  const std::vector<ThreadPoolInstance::TaskLatencyStats> snapshot =
+      recorder_.GetSnapshot();
+  ASSERT_EQ(1u, snapshot.size());
+  EXPECT_EQ(kNumThreads * kNumSamplesPerThread, snapshot[0].num_samples);
+  EXPECT_EQ(Microseconds(kNumSamplesPerThread - 1), snapshot[0].max_queue_time);
+  EXPECT_EQ(Microseconds(kNumThreads * kNumSamplesPerThread),
+            snapshot[0].total_run_time);
+}
+
+}  // namespace internal
+}  // namespace base
@@ -7,6 +7,9 @@
 
 #include <stddef.h>
 
+#include <atomic>
+#include <limits>
+
 #include "base/base_export.h"
 #include "base/containers/intrusive_heap.h"
 #include "base/dcheck_is_on.h"
@@ -220,6 +223,18 @@ class BASE_EXPORT TaskSource : public RefCountedThreadSafe<TaskSource> {
 
   TaskSourceExecutionMode execution_mode() const { return execution_mode_; }
 
+  // Returns the index of the NUMA node whose thread group this TaskSource has
+  // affinity to, or kNoNumaNode if none was assigned. Used by ThreadPoolImpl
+  // when the foreground thread group is partitioned per NUMA node. Can be
+  // accessed without a Transaction but may return an outdated result.
+  static constexpr size_t kNoNumaNode = std::numeric_limits<size_t>::max();
+  size_t numa_node_racy() const {
+    return numa_node_.load(std::memory_order_relaxed);
+  }
+  void set_numa_node(size_t numa_node) {
+    numa_node_.store(numa_node, std::memory_order_relaxed);
+  }
+
   void ClearForTesting();
 
  protected:
@@ -265,6 +280,8 @@ class BASE_EXPORT TaskSource : public RefCountedThreadSafe<TaskSource> {
   HeapHandle delayed_pq_heap_handle_;
 
   TaskSourceExecutionMode execution_mode_;
+
+  std::atomic_size_t numa_node_{kNoNumaNode};
 };
 
 // Wrapper around TaskSource to signify the intent to queue and run it.
@@ -412,8 +412,22 @@ RegisteredTaskSource TaskTracker::RunAndPopNextTask(
     if (!task->delayed_run_time.is_null() && state_->HasShutdownStarted())
       task->task = base::DoNothingWithBoundArgs(std::move(task->task));
 
-    // Run the |task| (whether it's a worker task or the Clear() closure).
-    RunTask(std::move(task.value()), task_source.get(), traits);
+    std::optional<TaskLatencyRecorder::Sample> latency_sample =
+        task_latency_recorder_.MaybeStartSample();
+    if (latency_sample) {
+      const Location posted_from = task->posted_from;
+      const TimeTicks ready_time = task->GetDesiredExecutionTime();
+      const TimeTicks start_time = TimeTicks::Now();
+      RunTask(std::move(task.value()), task_source.get(), traits);
+      const TimeTicks end_time = TimeTicks::Now();
+      task_latency_recorder_.RecordSample(
+          *latency_sample, posted_from, traits,
+          ready_time.is_null() ? TimeDelta() : start_time - ready_time,
+          end_time - start_time);
+    } else {
+      // Run the |task| (whether it's a worker task or the Clear() closure).
+      RunTask(std::move(task.value()), task_source.get(), traits);
+    }
   }
   if (should_run_tasks)
     AfterRunTask(task_source->shutdown_behavior());
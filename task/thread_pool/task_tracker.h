@@ -24,6 +24,7 @@
 #include "base/task/common/task_annotator.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool/task.h"
+#include "base/task/thread_pool/task_latency_recorder.h"
 #include "base/task/thread_pool/task_source.h"
 #include "base/task/thread_pool/tracked_ref.h"
 #include "base/thread_annotations.h"
@@ -139,6 +140,12 @@ class BASE_EXPORT TaskTracker {
   // no tasks are blocking shutdown).
   bool IsShutdownComplete() const;
 
+  // Records latency statistics of a sample of the tasks run by
+  // RunAndPopNextTask().
+  TaskLatencyRecorder& task_latency_recorder() {
+    return task_latency_recorder_;
+  }
+
   TrackedRef<TaskTracker> GetTrackedRef() {
     return tracked_ref_factory_.GetTrackedRef();
   }
@@ -230,6 +237,8 @@ class BASE_EXPORT TaskTracker {
 
   TaskAnnotator task_annotator_;
 
+  TaskLatencyRecorder task_latency_recorder_;
+
   // Indicates whether logging information about TaskPriority::BEST_EFFORT tasks
   // was enabled with a command line switch.
   const bool has_log_best_effort_tasks_switch_;
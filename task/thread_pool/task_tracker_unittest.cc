@@ -1027,6 +1027,28 @@ TEST_F(ThreadPoolTaskTrackerTest, CurrentSequenceToken) {
   EXPECT_NE(SequenceToken::GetForCurrentThread(), sequence_token);
 }
 
+// Verify that RunAndPopNextTask() records the latency of sampled tasks.
+TEST_F(ThreadPoolTaskTrackerTest, TaskLatencySampling) {
+  tracker_.task_latency_recorder().Start(1, /*emit_trace_counters=*/false);
+  const TaskTraits traits = {TaskPriority::USER_BLOCKING};
+  const Location posted_from = FROM_HERE;
+  for (int i = 0; i < 2; ++i) {
+    Task task(posted_from,
+              BindOnce(&PlatformThread::Sleep, TestTimeouts::tiny_timeout()),
+              TimeTicks::Now(), TimeDelta());
+    RunAndPopNextTask(WillPostTaskAndQueueTaskSource(std::move(task), traits));
+  }
+
+  const std::vector<ThreadPoolInstance::TaskLatencyStats> stats =
+      tracker_.task_latency_recorder().GetSnapshot();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ(posted_from, stats[0].posted_from);
+  EXPECT_EQ(traits, stats[0].traits);
+  EXPECT_EQ(2u, stats[0].num_samples);
+  EXPECT_GE(stats[0].total_run_time, TestTimeouts::tiny_timeout() * 2);
+  EXPECT_GE(stats[0].max_run_time, TestTimeouts::tiny_timeout());
+}
+
 TEST_F(ThreadPoolTaskTrackerTest, LoadWillPostAndRunBeforeShutdown) {
   // Post and run tasks asynchronously.
   std::vector<std::unique_ptr<ThreadPostingAndRunningTask>> threads;
@@ -4,6 +4,7 @@
 
 #include "base/task/thread_pool/thread_group.h"
 
+#include <algorithm>
 #include <string_view>
 #include <utility>
 
@@ -173,6 +174,12 @@ void ThreadGroup::StartImpl(
   }
 
   in_start().no_worker_reclaim = FeatureList::IsEnabled(kNoWorkerThreadReclaim);
+  in_start().work_stealing = FeatureList::IsEnabled(kThreadGroupWorkStealing);
+  in_start().max_spin_duration =
+      FeatureList::IsEnabled(kWorkerThreadSpinBeforeSleep)
+          ? std::max(kWorkerThreadMaxSpinDuration.Get(), TimeDelta())
+          : TimeDelta();
+  in_start().job_preemption = FeatureList::IsEnabled(kThreadGroupJobPreemption);
   in_start().may_block_threshold =
       may_block_threshold ? may_block_threshold.value()
                           : (thread_type_hint_ != ThreadType::kBackground
@@ -190,6 +197,7 @@ void ThreadGroup::StartImpl(
   DCHECK_GE(max_tasks_, 1U);
   in_start().initial_max_tasks = std::min(max_tasks_, kMaxNumberOfWorkers);
   max_best_effort_tasks_ = max_best_effort_tasks;
+  in_start().initial_max_best_effort_tasks = max_best_effort_tasks;
   in_start().suggested_reclaim_time = suggested_reclaim_time;
   in_start().worker_environment = worker_environment;
   in_start().service_thread_task_runner = std::move(service_thread_task_runner);
@@ -202,6 +210,10 @@ void ThreadGroup::StartImpl(
 
 ThreadGroup::~ThreadGroup() = default;
 
+void ThreadGroup::SetWorkerProcessors(std::vector<int> processors) {
+  worker_processors_ = std::move(processors);
+}
+
 void ThreadGroup::BindToCurrentThread() {
   DCHECK(!CurrentThreadHasGroup());
   current_thread_group = this;
@@ -273,8 +285,10 @@ void ThreadGroup::ReEnqueueTaskSourceLockRequired(
     ScopedReenqueueExecutor* reenqueue_executor,
     RegisteredTaskSourceAndTransaction transaction_with_task_source) {
   // Decide in which thread group the TaskSource should be reenqueued.
-  ThreadGroup* destination_thread_group = delegate_->GetThreadGroupForTraits(
-      transaction_with_task_source.transaction.traits());
+  ThreadGroup* destination_thread_group =
+      delegate_->GetThreadGroupForTaskSource(
+          *transaction_with_task_source.task_source.get(),
+          transaction_with_task_source.transaction.traits());
 
   bool push_to_immediate_queue =
       transaction_with_task_source.task_source.WillReEnqueue(
@@ -360,7 +374,8 @@ void ThreadGroup::UpdateSortKeyImpl(BaseScopedCommandsExecutor* executor,
 void ThreadGroup::PushTaskSourceAndWakeUpWorkersImpl(
     BaseScopedCommandsExecutor* executor,
     RegisteredTaskSourceAndTransaction transaction_with_task_source) {
-  DCHECK_EQ(delegate_->GetThreadGroupForTraits(
+  DCHECK_EQ(delegate_->GetThreadGroupForTaskSource(
+                *transaction_with_task_source.task_source.get(),
                 transaction_with_task_source.transaction.traits()),
             this);
   CheckedAutoLock lock(lock_);
@@ -380,9 +395,23 @@ void ThreadGroup::PushTaskSourceAndWakeUpWorkersImpl(
   transaction_with_task_source.transaction.Release();
   priority_queue_.Push(std::move(transaction_with_task_source.task_source),
                        sort_key);
+  MaybePreemptJobLockRequired(sort_key.priority());
   EnsureEnoughWorkersLockRequired(executor);
 }
 
+void ThreadGroup::PushTaskSourcesAndWakeUpWorkers(
+    std::vector<std::pair<RegisteredTaskSource, TaskSourceSortKey>>
+        task_sources) {
+  std::unique_ptr<BaseScopedCommandsExecutor> executor = GetExecutor();
+  CheckedAutoLock lock(lock_);
+  for (auto& [task_source, sort_key] : task_sources) {
+    DCHECK(!task_source->immediate_heap_handle().IsValid());
+    priority_queue_.Push(std::move(task_source), sort_key);
+    MaybePreemptJobLockRequired(sort_key.priority());
+  }
+  EnsureEnoughWorkersLockRequired(executor.get());
+}
+
 void ThreadGroup::EnqueueAllTaskSources(PriorityQueue* new_priority_queue) {
   std::unique_ptr<BaseScopedCommandsExecutor> executor = GetExecutor();
   CheckedAutoLock lock(lock_);
@@ -421,11 +450,38 @@ void ThreadGroup::HandoffNonUserBlockingTaskSourcesToOtherThreadGroup(
   destination_thread_group->EnqueueAllTaskSources(&new_priority_queue);
 }
 
+void ThreadGroup::MaybePreemptJobLockRequired(TaskPriority priority) {
+  // Checking |num_running_tasks_| first avoids reading |after_start()| before
+  // Start().
+  if (priority != TaskPriority::USER_BLOCKING || num_running_tasks_ == 0 ||
+      num_running_tasks_ < max_tasks_ || !after_start().job_preemption) {
+    return;
+  }
+  ThreadGroupWorkerDelegate* lowest_priority_job_worker = nullptr;
+  TaskPriority lowest_priority = priority;
+  for (const auto& worker : workers_) {
+    ThreadGroupWorkerDelegate* delegate = GetWorkerDelegate(worker.get());
+    const std::optional<TaskPriority> job_priority =
+        delegate->preemptible_job_priority_lock_required();
+    if (job_priority && *job_priority < lowest_priority) {
+      lowest_priority = *job_priority;
+      lowest_priority_job_worker = delegate;
+    }
+  }
+  if (lowest_priority_job_worker) {
+    lowest_priority_job_worker->PreemptJobLockRequired();
+  }
+}
+
 bool ThreadGroup::ShouldYield(TaskSourceSortKey sort_key) {
   DCHECK(TS_UNCHECKED_READ(max_allowed_sort_key_).is_lock_free());
 
   if (!task_tracker_->CanRunPriority(sort_key.priority()))
     return true;
+  // A job preempted by a USER_BLOCKING task source yields right away.
+  if (ThreadGroupWorkerDelegate::ConsumeJobPreemptionForCurrentThread()) {
+    return true;
+  }
   // It is safe to read |max_allowed_sort_key_| without a lock since this
   // variable is atomic, keeping in mind that threads may not immediately see
   // the new value when it is updated.
@@ -621,6 +677,41 @@ void ThreadGroup::AdjustMaxTasks() {
   EnsureEnoughWorkersLockRequired(executor.get());
 }
 
+void ThreadGroup::SetMaxTasksLimit(size_t max_tasks_limit) {
+  DCHECK_GE(max_tasks_limit, 1u);
+  std::unique_ptr<BaseScopedCommandsExecutor> executor = GetExecutor();
+  CheckedAutoLock auto_lock(lock_);
+  const size_t initial_max_tasks = after_start().initial_max_tasks;
+  const size_t max_tasks_reduction =
+      initial_max_tasks - std::min(initial_max_tasks, max_tasks_limit);
+  // This doesn't underflow: |max_tasks_| is never below |initial_max_tasks| -
+  // |max_tasks_reduction_|, since decrements only undo the increments for
+  // blocked workers.
+  max_tasks_ = max_tasks_ + max_tasks_reduction_ - max_tasks_reduction;
+  max_tasks_reduction_ = max_tasks_reduction;
+  UpdateMinAllowedPriorityLockRequired();
+  EnsureEnoughWorkersLockRequired(executor.get());
+}
+
+void ThreadGroup::SetMaxBestEffortTasksLimit(
+    size_t max_best_effort_tasks_limit) {
+  DCHECK_GE(max_best_effort_tasks_limit, 1u);
+  std::unique_ptr<BaseScopedCommandsExecutor> executor = GetExecutor();
+  CheckedAutoLock auto_lock(lock_);
+  const size_t initial_max_best_effort_tasks =
+      after_start().initial_max_best_effort_tasks;
+  const size_t max_best_effort_tasks_reduction =
+      initial_max_best_effort_tasks -
+      std::min(initial_max_best_effort_tasks, max_best_effort_tasks_limit);
+  // This doesn't underflow, for the same reason as in SetMaxTasksLimit().
+  max_best_effort_tasks_ = max_best_effort_tasks_ +
+                           max_best_effort_tasks_reduction_ -
+                           max_best_effort_tasks_reduction;
+  max_best_effort_tasks_reduction_ = max_best_effort_tasks_reduction;
+  UpdateMinAllowedPriorityLockRequired();
+  EnsureEnoughWorkersLockRequired(executor.get());
+}
+
 void ThreadGroup::OnShutDownStartedImpl(BaseScopedCommandsExecutor* executor) {
   CheckedAutoLock auto_lock(lock_);
 
@@ -670,13 +761,21 @@ bool ThreadGroup::ShouldPeriodicallyAdjustMaxTasksLockRequired() {
 }
 
 void ThreadGroup::UpdateMinAllowedPriorityLockRequired() {
-  if (priority_queue_.IsEmpty() || num_running_tasks_ < max_tasks_) {
+  // A preempted job is about to make room for the next task source, so no other
+  // task needs to yield for it.
+  if (priority_queue_.IsEmpty() || num_running_tasks_ < max_tasks_ ||
+      num_preempted_jobs_ > 0) {
     max_allowed_sort_key_.store(kMaxYieldSortKey, std::memory_order_relaxed);
   } else {
     max_allowed_sort_key_.store({priority_queue_.PeekSortKey().priority(),
                                  priority_queue_.PeekSortKey().worker_count()},
                                 std::memory_order_relaxed);
   }
+  is_idle_.store(num_running_tasks_ == 0 && priority_queue_.IsEmpty(),
+                 std::memory_order_relaxed);
+  is_saturated_.store(
+      !priority_queue_.IsEmpty() && num_running_tasks_ >= max_tasks_,
+      std::memory_order_relaxed);
 }
 
 void ThreadGroup::DecrementTasksRunningLockRequired(TaskPriority priority) {
@@ -9,6 +9,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "base/base_export.h"
@@ -53,6 +54,15 @@ class BASE_EXPORT ThreadGroup {
     // ThreadGroup has run a task from it. The implementation must return the
     // thread group in which the TaskSource should be reenqueued.
     virtual ThreadGroup* GetThreadGroupForTraits(const TaskTraits& traits) = 0;
+
+    // Same as GetThreadGroupForTraits(), for |task_source| which has |traits|.
+    // Lets the implementation take the NUMA node |task_source| has affinity to
+    // into account.
+    virtual ThreadGroup* GetThreadGroupForTaskSource(
+        const TaskSource& task_source,
+        const TaskTraits& traits) {
+      return GetThreadGroupForTraits(traits);
+    }
   };
 
   enum class WorkerEnvironment {
@@ -94,6 +104,11 @@ class BASE_EXPORT ThreadGroup {
       bool synchronous_thread_start_for_testing,
       std::optional<TimeDelta> may_block_threshold) = 0;
 
+  // Restricts the workers of this thread group to run on |processors|, e.g.
+  // those of a NUMA node (see PlatformThread::SetCurrentThreadAffinity()).
+  // Must be called before Start().
+  void SetWorkerProcessors(std::vector<int> processors);
+
   // Registers the thread group in TLS.
   void BindToCurrentThread();
 
@@ -103,6 +118,17 @@ class BASE_EXPORT ThreadGroup {
   // Returns true if the thread group is registered in TLS.
   bool IsBoundToCurrentThread() const;
 
+  // Returns true if the thread group has no running or queued task
+  // (IsIdleRacy()), or if it runs as many tasks as it is allowed to while more
+  // are queued (IsSaturatedRacy()). These don't acquire |lock_| and may thus
+  // return an outdated result.
+  bool IsIdleRacy() const {
+    return TS_UNCHECKED_READ(is_idle_).load(std::memory_order_relaxed);
+  }
+  bool IsSaturatedRacy() const {
+    return TS_UNCHECKED_READ(is_saturated_).load(std::memory_order_relaxed);
+  }
+
   // Removes |task_source| from |priority_queue_|. Returns a
   // RegisteredTaskSource that evaluats to true if successful, or false if
   // |task_source| is not currently in |priority_queue_|, such as when a worker
@@ -124,6 +150,14 @@ class BASE_EXPORT ThreadGroup {
   virtual void PushTaskSourceAndWakeUpWorkers(
       RegisteredTaskSourceAndTransaction transaction_with_task_source) = 0;
 
+  // Pushes |task_sources|, with their sort keys, into this ThreadGroup's
+  // PriorityQueue under a single acquisition of |lock_|, and wakes up as many
+  // workers as needed to run them. The task sources must have just been
+  // registered, i.e. not be queued in any thread group yet.
+  void PushTaskSourcesAndWakeUpWorkers(
+      std::vector<std::pair<RegisteredTaskSource, TaskSourceSortKey>>
+          task_sources);
+
   // Move all task sources from this ThreadGroup's PriorityQueue to the
   // |destination_thread_group|'s.
   void HandoffAllTaskSourcesToOtherThreadGroup(
@@ -160,6 +194,16 @@ class BASE_EXPORT ThreadGroup {
 
   virtual void OnShutdownStarted() = 0;
 
+  // Caps the number of tasks that can run concurrently in this thread group to
+  // |max_tasks_limit|, not counting the increments for blocked workers, and
+  // wakes up workers as appropriate. The cap can't exceed the |max_tasks|
+  // passed to Start(), after which this must be called.
+  void SetMaxTasksLimit(size_t max_tasks_limit);
+
+  // Like SetMaxTasksLimit(), for the number of BEST_EFFORT tasks. The cap
+  // can't exceed the |max_best_effort_tasks| passed to Start().
+  void SetMaxBestEffortTasksLimit(size_t max_best_effort_tasks_limit);
+
   // Returns true if a thread group is registered in TLS. Used by diagnostic
   // code to check whether it's inside a ThreadPool task.
   static bool CurrentThreadHasGroup();
@@ -373,6 +417,12 @@ class BASE_EXPORT ThreadGroup {
   // or when a new task is added to |priority_queue_|.
   void UpdateMinAllowedPriorityLockRequired() EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Called when a task source with |priority| is added to |priority_queue_|.
+  // If |priority| is USER_BLOCKING and no worker is free, preempts the job of
+  // the lowest priority running in this thread group, if any.
+  void MaybePreemptJobLockRequired(TaskPriority priority)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Increments/decrements the number of tasks of |priority| that are currently
   // running in this thread group. Must be invoked before/after running a task.
   void DecrementTasksRunningLockRequired(TaskPriority priority)
@@ -399,13 +449,26 @@ class BASE_EXPORT ThreadGroup {
     bool initialized = false;
 #endif
 
-    // Initial value of |max_tasks_|.
+    // Initial value of |max_tasks_| / |max_best_effort_tasks_|.
     size_t initial_max_tasks = 0;
+    size_t initial_max_best_effort_tasks = 0;
 
     // Suggested reclaim time for workers.
     TimeDelta suggested_reclaim_time;
     bool no_worker_reclaim = false;
 
+    // Whether workers queue the task sources they post locally, and steal
+    // them from each other. Only supported by ThreadGroupImpl.
+    bool work_stealing = false;
+
+    // How long idle workers may spin before sleeping, or zero if they don't.
+    // Only supported by ThreadGroupImpl.
+    TimeDelta max_spin_duration;
+
+    // Whether a queued USER_BLOCKING task source for which there is no free
+    // worker preempts the lowest priority job running in the thread group.
+    bool job_preemption = false;
+
     // Environment to be initialized per worker.
     WorkerEnvironment worker_environment = WorkerEnvironment::NONE;
 
@@ -471,10 +534,19 @@ class BASE_EXPORT ThreadGroup {
   std::atomic<YieldSortKey> max_allowed_sort_key_ GUARDED_BY(lock_){
       kMaxYieldSortKey};
 
+  // Returned by IsIdleRacy() and IsSaturatedRacy(). Updated alongside
+  // |max_allowed_sort_key_|.
+  std::atomic_bool is_idle_ GUARDED_BY(lock_){true};
+  std::atomic_bool is_saturated_ GUARDED_BY(lock_){false};
+
   const std::string histogram_label_;
   const std::string thread_group_label_;
   const ThreadType thread_type_hint_;
 
+  // Processors on which the workers run, or empty to let them run anywhere.
+  // Set before Start() and immutable afterwards.
+  std::vector<int> worker_processors_;
+
   // All workers owned by this thread group.
   size_t worker_sequence_num_ GUARDED_BY(lock_) = 0;
 
@@ -485,11 +557,20 @@ class BASE_EXPORT ThreadGroup {
   size_t max_tasks_ GUARDED_BY(lock_) = 0;
   size_t max_best_effort_tasks_ GUARDED_BY(lock_) = 0;
 
+  // Number of tasks by which SetMaxTasksLimit() / SetMaxBestEffortTasksLimit()
+  // reduced |max_tasks_| / |max_best_effort_tasks_|.
+  size_t max_tasks_reduction_ GUARDED_BY(lock_) = 0;
+  size_t max_best_effort_tasks_reduction_ GUARDED_BY(lock_) = 0;
+
   // Number of tasks of any priority / BEST_EFFORT priority that are currently
   // running in this thread group.
   size_t num_running_tasks_ GUARDED_BY(lock_) = 0;
   size_t num_running_best_effort_tasks_ GUARDED_BY(lock_) = 0;
 
+  // Number of running jobs that were preempted by MaybePreemptJobLockRequired()
+  // and didn't return yet.
+  size_t num_preempted_jobs_ GUARDED_BY(lock_) = 0;
+
   // Number of workers running a task of any priority / BEST_EFFORT priority
   // that are within the scope of a MAY_BLOCK ScopedBlockingCall but haven't
   // caused a max tasks increase yet.
@@ -4,20 +4,26 @@
 
 #include "base/task/thread_pool/thread_group_impl.h"
 
+#include <algorithm>
 #include <optional>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "base/auto_reset.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/sequence_token.h"
 #include "base/task/common/checked_lock.h"
 #include "base/task/thread_pool/thread_group_worker_delegate.h"
+#include "base/task/thread_pool/worker_local_queue.h"
 #include "base/task/thread_pool/worker_thread_waitable_event.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "base/threading/scoped_blocking_call_internal.h"
 #include "base/threading/thread_checker.h"
 #include "base/time/time_override.h"
 #include "base/trace_event/base_tracing.h"
+#include "build/build_config.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
 #include "third_party/abseil-cpp/absl/container/inlined_vector.h"
 
 namespace base {
@@ -27,6 +33,15 @@ namespace {
 
 constexpr size_t kMaxNumberOfWorkers = 256;
 
+// In work stealing mode, the maximum number of task sources that a worker takes
+// from its local queue in a row without acquiring the thread group's lock. This
+// bounds how long it takes for the worker to notice that it is in excess.
+constexpr int kMaxLocalSwapsWithoutLock = 16;
+
+// The local queue of the current thread, if it is a worker of a
+// ThreadGroupImpl in work stealing mode.
+ABSL_CONST_INIT thread_local WorkerLocalQueue* current_local_queue = nullptr;
+
 }  // namespace
 
 // Upon destruction, executes actions that control the number of active workers.
@@ -85,6 +100,8 @@ class ThreadGroupImpl::WaitableEventWorkerDelegate
   void RecordUnnecessaryWakeup() override;
   TimeDelta GetSleepTimeout() override;
 
+  WorkerLocalQueue* local_queue() { return &local_queue_; }
+
  private:
   ThreadGroupImpl* outer() const {
     return static_cast<ThreadGroupImpl*>(outer_.get());
@@ -94,6 +111,8 @@ class ThreadGroupImpl::WaitableEventWorkerDelegate
   bool CanGetWorkLockRequired(BaseScopedCommandsExecutor* executor,
                               WorkerThread* worker)
       EXCLUSIVE_LOCKS_REQUIRED(outer()->lock_) override;
+  RegisteredTaskSource TakeLocalTaskSourceLockRequired(TaskPriority* priority)
+      EXCLUSIVE_LOCKS_REQUIRED(outer()->lock_) override;
   void CleanupLockRequired(BaseScopedCommandsExecutor* executor,
                            WorkerThread* worker)
       EXCLUSIVE_LOCKS_REQUIRED(outer()->lock_) override;
@@ -105,6 +124,19 @@ class ThreadGroupImpl::WaitableEventWorkerDelegate
   // thread group. Called from GetWork() when no work is available.
   bool CanCleanupLockRequired(const WorkerThread* worker)
       EXCLUSIVE_LOCKS_REQUIRED(outer()->lock_) override;
+
+  // Returns a task source from |local_queue_| that can run in place of the one
+  // that was just processed without acquiring |outer()->lock_|, or nullptr.
+  // This requires it to have the same priority and shutdown behavior, so that
+  // the running tasks bookkeeping doesn't change.
+  RegisteredTaskSource TakeLocalTaskSourceWithoutLock();
+
+  // Task sources posted from this worker in work stealing mode.
+  WorkerLocalQueue local_queue_;
+
+  // Number of task sources returned by TakeLocalTaskSourceWithoutLock() since
+  // |outer()->lock_| was last acquired. Accessed only from the worker thread.
+  int num_local_swaps_without_lock_ = 0;
 };
 
 std::unique_ptr<ThreadGroup::BaseScopedCommandsExecutor>
@@ -163,14 +195,50 @@ void ThreadGroupImpl::UpdateSortKey(TaskSource::Transaction transaction) {
 void ThreadGroupImpl::PushTaskSourceAndWakeUpWorkers(
     RegisteredTaskSourceAndTransaction transaction_with_task_source) {
   ScopedCommandsExecutor executor(this);
-  PushTaskSourceAndWakeUpWorkersImpl(&executor,
-                                     std::move(transaction_with_task_source));
+  if (!CanPushToLocalQueue(transaction_with_task_source)) {
+    PushTaskSourceAndWakeUpWorkersImpl(&executor,
+                                       std::move(transaction_with_task_source));
+    return;
+  }
+
+  const TaskPriority priority =
+      transaction_with_task_source.transaction.traits().priority();
+  // As in PushTaskSourceAndWakeUpWorkersImpl(), release |transaction| before
+  // moving |task_source| to a queue from which another worker may take it.
+  transaction_with_task_source.transaction.Release();
+  current_local_queue->Push(std::move(transaction_with_task_source.task_source),
+                            priority);
+  num_local_task_sources_.fetch_add(1, std::memory_order_seq_cst);
+
+  // The current worker runs the task source eventually. Only acquire |lock_|
+  // to wake up a worker that could steal it sooner.
+  if (can_wake_up_more_workers_.load(std::memory_order_seq_cst)) {
+    CheckedAutoLock auto_lock(lock_);
+    EnsureEnoughWorkersLockRequired(&executor);
+  }
+}
+
+bool ThreadGroupImpl::CanPushToLocalQueue(
+    const RegisteredTaskSourceAndTransaction& transaction_with_task_source)
+    const {
+  // Jobs can run on multiple workers at once, and BEST_EFFORT task sources are
+  // subject to |max_best_effort_tasks_|, so these always go through
+  // |priority_queue_|. So do task sources that may already be queued there
+  // after changing thread group.
+  const TaskSource* task_source =
+      transaction_with_task_source.task_source.get();
+  return current_local_queue && IsBoundToCurrentThread() &&
+         task_source->execution_mode() != TaskSourceExecutionMode::kJob &&
+         transaction_with_task_source.transaction.traits().priority() !=
+             TaskPriority::BEST_EFFORT &&
+         !task_source->immediate_heap_handle().IsValid();
 }
 
 ThreadGroupImpl::WaitableEventWorkerDelegate::WaitableEventWorkerDelegate(
     TrackedRef<ThreadGroup> outer,
     bool is_excess)
-    : ThreadGroupWorkerDelegate(std::move(outer), is_excess) {
+    : ThreadGroupWorkerDelegate(std::move(outer), is_excess),
+      local_queue_(&this->outer()->lock_) {
   // Bound in OnMainEntry().
   DETACH_FROM_THREAD(worker_thread_checker_);
 }
@@ -182,11 +250,16 @@ TimeDelta ThreadGroupImpl::WaitableEventWorkerDelegate::GetSleepTimeout() {
 void ThreadGroupImpl::WaitableEventWorkerDelegate::OnMainEntry(
     WorkerThread* worker) {
   OnMainEntryImpl(worker);
+  if (outer()->after_start().work_stealing) {
+    current_local_queue = &local_queue_;
+  }
+  set_max_spin_duration(outer()->after_start().max_spin_duration);
 }
 
 void ThreadGroupImpl::WaitableEventWorkerDelegate::OnMainExit(
     WorkerThread* worker_base) {
   DCHECK_CALLED_ON_VALID_THREAD(worker_thread_checker_);
+  current_local_queue = nullptr;
 
 #if DCHECK_IS_ON()
   WorkerThreadWaitableEvent* worker =
@@ -277,6 +350,13 @@ ThreadGroupImpl::WaitableEventWorkerDelegate::SwapProcessedTask(
   DCHECK(read_worker().current_task_priority);
   DCHECK(read_worker().current_shutdown_behavior);
 
+  if (!task_source) {
+    RegisteredTaskSource local_task_source = TakeLocalTaskSourceWithoutLock();
+    if (local_task_source) {
+      return local_task_source;
+    }
+  }
+
   // A transaction to the TaskSource to reenqueue, if any. Instantiated here as
   // |TaskSource::lock_| is a UniversalPredecessor and must always be acquired
   // prior to acquiring a second lock
@@ -299,6 +379,7 @@ ThreadGroupImpl::WaitableEventWorkerDelegate::SwapProcessedTask(
   ScopedReenqueueExecutor reenqueue_executor;
   CheckedAutoLock auto_lock(outer()->lock_);
   AnnotateAcquiredLockAlias annotate(outer()->lock_, lock());
+  num_local_swaps_without_lock_ = 0;
 
   // During shutdown, max_tasks may have been incremented in
   // OnShutdownStartedLockRequired().
@@ -320,8 +401,7 @@ ThreadGroupImpl::WaitableEventWorkerDelegate::SwapProcessedTask(
   // Running task bookkeeping.
   outer()->DecrementTasksRunningLockRequired(
       *read_worker().current_task_priority);
-  write_worker().current_shutdown_behavior = std::nullopt;
-  write_worker().current_task_priority = std::nullopt;
+  DidRunTaskLockRequired();
 
   if (transaction_with_task_source) {
     outer()->ReEnqueueTaskSourceLockRequired(
@@ -333,6 +413,83 @@ ThreadGroupImpl::WaitableEventWorkerDelegate::SwapProcessedTask(
                              static_cast<WorkerThreadWaitableEvent*>(worker));
 }
 
+RegisteredTaskSource
+ThreadGroupImpl::WaitableEventWorkerDelegate::TakeLocalTaskSourceLockRequired(
+    TaskPriority* priority) {
+  if (outer()->num_local_task_sources_.load(std::memory_order_relaxed) == 0 ||
+      !outer()->task_tracker_->CanRunPriority(TaskPriority::USER_VISIBLE)) {
+    return nullptr;
+  }
+
+  // Task sources in |priority_queue_| with a higher priority run first.
+  const TaskPriority min_priority =
+      outer()->priority_queue_.IsEmpty()
+          ? TaskPriority::LOWEST
+          : outer()->priority_queue_.PeekSortKey().priority();
+
+  // Prefer the most recent task source posted from this worker, then steal the
+  // oldest task source posted from another worker.
+  RegisteredTaskSource task_source =
+      local_queue_.PopBack(min_priority, priority);
+  for (const auto& worker : outer()->workers_) {
+    if (task_source) {
+      break;
+    }
+    auto* delegate =
+        static_cast<WaitableEventWorkerDelegate*>(worker->delegate());
+    if (delegate != this && !delegate->local_queue_.IsEmpty()) {
+      task_source = delegate->local_queue_.PopFront(min_priority, priority);
+    }
+  }
+  if (!task_source) {
+    return nullptr;
+  }
+
+  outer()->num_local_task_sources_.fetch_sub(1, std::memory_order_relaxed);
+  // Only sequences are pushed to local queues, and they are always saturated
+  // by a single worker.
+  const TaskSource::RunStatus run_status = task_source.WillRunTask();
+  DCHECK_EQ(run_status, TaskSource::RunStatus::kAllowedSaturated);
+  return task_source;
+}
+
+RegisteredTaskSource
+ThreadGroupImpl::WaitableEventWorkerDelegate::TakeLocalTaskSourceWithoutLock() {
+  DCHECK_CALLED_ON_VALID_THREAD(worker_thread_checker_);
+  // A worker that ran a job goes through GetWorkLockRequired(), which updates
+  // the bookkeeping used to preempt jobs.
+  if (!outer()->after_start().work_stealing || local_queue_.IsEmpty() ||
+      read_worker().is_running_job ||
+      num_local_swaps_without_lock_ >= kMaxLocalSwapsWithoutLock ||
+      outer()->task_tracker_->HasShutdownStarted()) {
+    return nullptr;
+  }
+
+  const TaskPriority current_priority = *read_worker().current_task_priority;
+  TaskPriority priority;
+  RegisteredTaskSource task_source =
+      local_queue_.PopBack(current_priority, &priority);
+  if (!task_source) {
+    return nullptr;
+  }
+  // A task source that doesn't match the running tasks bookkeeping, or that
+  // should yield to the task sources in |priority_queue_|, goes back to the
+  // queue and is taken by GetWorkLockRequired() instead.
+  if (priority != current_priority ||
+      task_source->shutdown_behavior() !=
+          *read_worker().current_shutdown_behavior ||
+      outer()->ShouldYield(task_source->GetSortKey())) {
+    local_queue_.Push(std::move(task_source), priority);
+    return nullptr;
+  }
+
+  ++num_local_swaps_without_lock_;
+  outer()->num_local_task_sources_.fetch_sub(1, std::memory_order_relaxed);
+  const TaskSource::RunStatus run_status = task_source.WillRunTask();
+  DCHECK_EQ(run_status, TaskSource::RunStatus::kAllowedSaturated);
+  return task_source;
+}
+
 bool ThreadGroupImpl::WaitableEventWorkerDelegate::CanCleanupLockRequired(
     const WorkerThread* worker) {
   DCHECK_CALLED_ON_VALID_THREAD(worker_thread_checker_);
@@ -354,6 +511,8 @@ void ThreadGroupImpl::WaitableEventWorkerDelegate::CleanupLockRequired(
       static_cast<WorkerThreadWaitableEvent*>(worker_base);
   DCHECK(!outer()->join_for_testing_started_);
   DCHECK_CALLED_ON_VALID_THREAD(worker_thread_checker_);
+  // Task sources are moved out of |local_queue_| when the worker becomes idle.
+  DCHECK(local_queue_.IsEmpty());
 
   worker->Cleanup();
 
@@ -376,10 +535,19 @@ void ThreadGroupImpl::WaitableEventWorkerDelegate::
   DCHECK_CALLED_ON_VALID_THREAD(worker_thread_checker_);
   DCHECK(!outer()->idle_workers_set_.Contains(worker));
 
+  // Task sources that this worker posted but couldn't run, e.g. because of the
+  // CanRunPolicy, are handed to the other workers.
+  if (!local_queue_.IsEmpty()) {
+    outer()->num_local_task_sources_.fetch_sub(
+        local_queue_.MoveAllTo(&outer()->priority_queue_),
+        std::memory_order_relaxed);
+  }
+
   // Add the worker to the idle set.
   outer()->idle_workers_set_.Insert(worker);
   DCHECK_LE(outer()->idle_workers_set_.Size(), outer()->workers_.size());
   outer()->idle_workers_set_cv_for_testing_.Broadcast();
+  outer()->UpdateCanWakeUpMoreWorkersLockRequired();
 }
 
 void ThreadGroupImpl::WaitableEventWorkerDelegate::RecordUnnecessaryWakeup() {
@@ -412,6 +580,14 @@ void ThreadGroupImpl::JoinForTesting() {
 
   CheckedAutoLock auto_lock(lock_);
   DCHECK(workers_ == workers_copy);
+  // Move task sources left in local queues to |priority_queue_|, which flushes
+  // them on destruction.
+  for (const auto& worker : workers_) {
+    static_cast<WaitableEventWorkerDelegate*>(worker->delegate())
+        ->local_queue()
+        ->MoveAllTo(&priority_queue_);
+  }
+  num_local_task_sources_.store(0, std::memory_order_relaxed);
   // Release |workers_| to clear their TrackedRef against |this|.
   workers_.clear();
 }
@@ -503,8 +679,11 @@ void ThreadGroupImpl::EnsureEnoughWorkersLockRequired(
   ScopedCommandsExecutor* executor =
       static_cast<ScopedCommandsExecutor*>(base_executor);
 
-  const size_t desired_num_awake_workers =
-      GetDesiredNumAwakeWorkersLockRequired();
+  // Task sources in local queues can be stolen by any worker.
+  const size_t desired_num_awake_workers = std::min(
+      {GetDesiredNumAwakeWorkersLockRequired() +
+           num_local_task_sources_.load(std::memory_order_relaxed),
+       max_tasks_, kMaxNumberOfWorkers});
   const size_t num_awake_workers = GetNumAwakeWorkersLockRequired();
 
   size_t num_workers_to_wake_up =
@@ -533,6 +712,13 @@ void ThreadGroupImpl::EnsureEnoughWorkersLockRequired(
 
   // Ensure that the number of workers is periodically adjusted if needed.
   MaybeScheduleAdjustMaxTasksLockRequired(executor);
+
+  UpdateCanWakeUpMoreWorkersLockRequired();
+}
+
+void ThreadGroupImpl::UpdateCanWakeUpMoreWorkersLockRequired() {
+  can_wake_up_more_workers_.store(GetNumAwakeWorkersLockRequired() < max_tasks_,
+                                  std::memory_order_seq_cst);
 }
 
 bool ThreadGroupImpl::IsOnIdleSetLockRequired(
@@ -5,6 +5,7 @@
 #ifndef BASE_TASK_THREAD_POOL_THREAD_GROUP_IMPL_H_
 #define BASE_TASK_THREAD_POOL_THREAD_GROUP_IMPL_H_
 
+#include <atomic>
 #include <optional>
 #include <string_view>
 #include <vector>
@@ -109,6 +110,16 @@ class BASE_EXPORT ThreadGroupImpl : public ThreadGroup {
   scoped_refptr<WorkerThreadWaitableEvent> CreateAndRegisterWorkerLockRequired(
       ScopedCommandsExecutor* executor) EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Returns true if |transaction_with_task_source|, posted from a worker of
+  // this thread group in work stealing mode, may be pushed to that worker's
+  // local queue instead of |priority_queue_|.
+  bool CanPushToLocalQueue(
+      const RegisteredTaskSourceAndTransaction& transaction_with_task_source)
+      const;
+
+  // Updates |can_wake_up_more_workers_|.
+  void UpdateCanWakeUpMoreWorkersLockRequired() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   bool IsOnIdleSetLockRequired(WorkerThread* worker) const
       EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
@@ -128,6 +139,15 @@ class BASE_EXPORT ThreadGroupImpl : public ThreadGroup {
   // is inserted on this set when it receives nullptr from GetWork().
   WorkerThreadSet idle_workers_set_ GUARDED_BY(lock_);
 
+  // Number of task sources in the local queues of workers, in work stealing
+  // mode. These count towards the number of workers that should be awake.
+  std::atomic_size_t num_local_task_sources_{0};
+
+  // Whether more workers could be awake, i.e. the number of awake workers is
+  // lower than |max_tasks_|. Readable without |lock_|, to avoid acquiring it
+  // when pushing to a local queue if no worker could be woken up to steal.
+  std::atomic_bool can_wake_up_more_workers_{true};
+
   // Ensures recently cleaned up workers (ref.
   // WaitableEventWorkerDelegate::CleanupLockRequired()) had time to exit as
   // they have a raw reference to |this| (and to TaskTracker) which can
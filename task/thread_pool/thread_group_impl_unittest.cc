@@ -1206,6 +1206,82 @@ TEST_F(ThreadGroupImplBlockingTest, ThreadBusyShutdown) {
   thread_group_.reset();
 }
 
+// Verify that SetMaxTasksLimit() caps the number of tasks that run
+// concurrently, and that blocked workers still increase max tasks beyond it.
+TEST_F(ThreadGroupImplBlockingTest, MaxTasksLimit) {
+  CreateAndStartThreadGroup();
+  thread_group_->SetMaxTasksLimit(kMaxTasks * 2);
+  EXPECT_EQ(thread_group_->GetMaxTasksForTesting(), kMaxTasks);
+  thread_group_->SetMaxTasksLimit(2);
+  EXPECT_EQ(thread_group_->GetMaxTasksForTesting(), 2U);
+
+  std::atomic_size_t num_running_tasks{0};
+  std::atomic_size_t max_num_running_tasks{0};
+  for (size_t i = 0; i < kMaxTasks * 2; ++i) {
+    task_runner_->PostTask(FROM_HERE, BindLambdaForTesting([&]() {
+                             const size_t num = ++num_running_tasks;
+                             size_t max = max_num_running_tasks.load();
+                             while (max < num &&
+                                    !max_num_running_tasks
+                                         .compare_exchange_weak(max, num)) {
+                             }
+                             PlatformThread::Sleep(
+                                 TestTimeouts::tiny_timeout());
+                             --num_running_tasks;
+                           }));
+  }
+  task_tracker_.FlushForTesting();
+  EXPECT_LE(max_num_running_tasks.load(), 2U);
+
+  // Blocked workers increase max tasks from the limit.
+  SaturateWithBlockingTasks(NestedBlockingType(BlockingType::WILL_BLOCK,
+                                               OptionalBlockingType::NO_BLOCK,
+                                               BlockingType::WILL_BLOCK));
+  EXPECT_EQ(thread_group_->GetMaxTasksForTesting(), 2U + kMaxTasks);
+  UnblockBlockingTasks();
+  task_tracker_.FlushForTesting();
+  EXPECT_EQ(thread_group_->GetMaxTasksForTesting(), 2U);
+
+  thread_group_->SetMaxTasksLimit(kMaxTasks);
+  EXPECT_EQ(thread_group_->GetMaxTasksForTesting(), kMaxTasks);
+}
+
+// Verify that SetMaxBestEffortTasksLimit() caps the number of BEST_EFFORT tasks
+// that run concurrently, and that lifting the cap restores the initial max.
+TEST_F(ThreadGroupImplBlockingTest, MaxBestEffortTasksLimit) {
+  CreateAndStartThreadGroup();
+  thread_group_->SetMaxBestEffortTasksLimit(kMaxTasks * 2);
+  EXPECT_EQ(thread_group_->GetMaxBestEffortTasksForTesting(), kMaxTasks);
+  thread_group_->SetMaxBestEffortTasksLimit(1);
+  EXPECT_EQ(thread_group_->GetMaxBestEffortTasksForTesting(), 1U);
+
+  const scoped_refptr<TaskRunner> best_effort_task_runner =
+      test::CreatePooledTaskRunner({TaskPriority::BEST_EFFORT},
+                                   &mock_pooled_task_runner_delegate_);
+  std::atomic_size_t num_running_tasks{0};
+  std::atomic_size_t max_num_running_tasks{0};
+  for (size_t i = 0; i < kMaxTasks * 2; ++i) {
+    best_effort_task_runner->PostTask(
+        FROM_HERE, BindLambdaForTesting([&]() {
+          const size_t num = ++num_running_tasks;
+          size_t max = max_num_running_tasks.load();
+          while (max < num &&
+                 !max_num_running_tasks.compare_exchange_weak(max, num)) {
+          }
+          PlatformThread::Sleep(TestTimeouts::tiny_timeout());
+          --num_running_tasks;
+        }));
+  }
+  task_tracker_.FlushForTesting();
+  EXPECT_EQ(max_num_running_tasks.load(), 1U);
+
+  // The cap doesn't apply to foreground tasks.
+  EXPECT_EQ(thread_group_->GetMaxTasksForTesting(), kMaxTasks);
+
+  thread_group_->SetMaxBestEffortTasksLimit(kMaxTasks);
+  EXPECT_EQ(thread_group_->GetMaxBestEffortTasksForTesting(), kMaxTasks);
+}
+
 enum class ReclaimType { DELAYED_RECLAIM, NO_RECLAIM };
 
 class ThreadGroupImplOverCapacityTest
@@ -1695,5 +1771,68 @@ TEST_F(ThreadGroupImplImplStartInBodyTest, RacyCleanup) {
   thread_group_.reset();
 }
 
+namespace {
+
+class ThreadGroupImplWorkStealingTest : public ThreadGroupImplImplTest {
+ public:
+  void SetUp() override {
+    feature_list_.InitAndEnableFeature(kThreadGroupWorkStealing);
+    ThreadGroupImplImplTest::SetUp();
+  }
+
+ private:
+  base::test::ScopedFeatureList feature_list_;
+};
+
+}  // namespace
+
+// Verify that all the tasks posted from workers run.
+TEST_F(ThreadGroupImplWorkStealingTest, FanOut) {
+  constexpr size_t kNumParentTasks = kMaxTasks;
+  constexpr size_t kNumChildTasksPerParent = 100;
+  scoped_refptr<TaskRunner> task_runner =
+      test::CreatePooledTaskRunner({}, &mock_pooled_task_runner_delegate_);
+
+  std::atomic_size_t num_child_tasks_run{0};
+  for (size_t i = 0; i < kNumParentTasks; ++i) {
+    task_runner->PostTask(FROM_HERE, BindLambdaForTesting([&]() {
+                            for (size_t j = 0; j < kNumChildTasksPerParent;
+                                 ++j) {
+                              task_runner->PostTask(
+                                  FROM_HERE, BindLambdaForTesting([&]() {
+                                    ++num_child_tasks_run;
+                                  }));
+                            }
+                          }));
+  }
+
+  task_tracker_.FlushForTesting();
+  EXPECT_EQ(kNumParentTasks * kNumChildTasksPerParent, num_child_tasks_run);
+}
+
+// Verify that a task posted from a worker is stolen by another worker while
+// the worker that posted it is busy.
+TEST_F(ThreadGroupImplWorkStealingTest, StealFromBusyWorker) {
+  scoped_refptr<TaskRunner> task_runner = test::CreatePooledTaskRunner(
+      {WithBaseSyncPrimitives()}, &mock_pooled_task_runner_delegate_);
+
+  TestWaitableEvent child_task_ran;
+  task_runner->PostTask(
+      FROM_HERE, BindLambdaForTesting([&]() {
+        const PlatformThreadRef parent_thread_ref =
+            PlatformThread::CurrentRef();
+        task_runner->PostTask(FROM_HERE, BindLambdaForTesting([&]() {
+                                EXPECT_NE(parent_thread_ref,
+                                          PlatformThread::CurrentRef());
+                                child_task_ran.Signal();
+                              }));
+        // This only returns if another worker runs the child task.
+        child_task_ran.Wait();
+      }));
+
+  task_tracker_.FlushForTesting();
+  EXPECT_TRUE(child_task_ran.IsSignaled());
+}
+
 }  // namespace internal
 }  // namespace base
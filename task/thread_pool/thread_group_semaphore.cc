@@ -315,8 +315,7 @@ ThreadGroupSemaphore::SemaphoreWorkerDelegate::SwapProcessedTask(
   // Running task bookkeeping.
   outer()->DecrementTasksRunningLockRequired(
       *read_worker().current_task_priority);
-  write_worker().current_shutdown_behavior = std::nullopt;
-  write_worker().current_task_priority = std::nullopt;
+  DidRunTaskLockRequired();
 
   if (transaction_with_task_source) {
     // If there is a task to enqueue, we can swap it for another task without
@@ -4,6 +4,7 @@
 
 #include "base/task/thread_pool/thread_group.h"
 
+#include <atomic>
 #include <memory>
 #include <tuple>
 #include <utility>
@@ -13,6 +14,7 @@
 #include "base/functional/callback_helpers.h"
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
+#include "base/task/task_features.h"
 #include "base/task/task_runner.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool/can_run_policy_test.h"
@@ -23,6 +25,7 @@
 #include "base/task/thread_pool/test_utils.h"
 #include "base/task/thread_pool/thread_group_impl.h"
 #include "base/test/bind.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/test_timeouts.h"
 #include "base/test/test_waitable_event.h"
 #include "base/threading/platform_thread.h"
@@ -860,6 +863,70 @@ TEST_F(ThreadGroupTest, JobTaskSourceUpdatePriority) {
   task_tracker_.FlushForTesting();
 }
 
+// Verify that with kThreadGroupJobPreemption, a USER_BLOCKING task posted while
+// all workers are busy preempts the job of the lowest priority, and only it.
+TEST_F(ThreadGroupTest, JobPreemption) {
+  base::test::ScopedFeatureList feature_list(kThreadGroupJobPreemption);
+  StartThreadGroup();
+
+  std::atomic_size_t num_tasks_running{0};
+  std::atomic_size_t num_user_visible_yields{0};
+  std::atomic_bool best_effort_yielded{false};
+  std::atomic_bool stop{false};
+  TestWaitableEvent all_tasks_running;
+
+  auto on_task_running = [&] {
+    if (++num_tasks_running == kMaxTasks) {
+      all_tasks_running.Signal();
+    }
+  };
+  auto best_effort_job_task = base::MakeRefCounted<test::MockJobTask>(
+      BindLambdaForTesting([&](JobDelegate* delegate) {
+        on_task_running();
+        while (!delegate->ShouldYield()) {
+        }
+        best_effort_yielded = true;
+      }),
+      /* num_tasks_to_run */ 1);
+  auto user_visible_job_task = base::MakeRefCounted<test::MockJobTask>(
+      BindLambdaForTesting([&](JobDelegate* delegate) {
+        on_task_running();
+        while (!stop) {
+          if (delegate->ShouldYield()) {
+            ++num_user_visible_yields;
+            return;
+          }
+        }
+      }),
+      /* num_tasks_to_run */ kMaxTasks - 1);
+  scoped_refptr<JobTaskSource> best_effort_task_source =
+      best_effort_job_task->GetJobTaskSource(
+          FROM_HERE, {TaskPriority::BEST_EFFORT},
+          &mock_pooled_task_runner_delegate_);
+  scoped_refptr<JobTaskSource> user_visible_task_source =
+      user_visible_job_task->GetJobTaskSource(
+          FROM_HERE, {TaskPriority::USER_VISIBLE},
+          &mock_pooled_task_runner_delegate_);
+  mock_pooled_task_runner_delegate_.EnqueueJobTaskSource(
+      best_effort_task_source);
+  mock_pooled_task_runner_delegate_.EnqueueJobTaskSource(
+      user_visible_task_source);
+  all_tasks_running.Wait();
+
+  TestWaitableEvent user_blocking_task_ran;
+  test::CreatePooledTaskRunner({TaskPriority::USER_BLOCKING},
+                               &mock_pooled_task_runner_delegate_)
+      ->PostTask(FROM_HERE, BindLambdaForTesting([&] {
+                   EXPECT_TRUE(best_effort_yielded);
+                   user_blocking_task_ran.Signal();
+                 }));
+  user_blocking_task_ran.Wait();
+  EXPECT_EQ(0u, num_user_visible_yields);
+
+  stop = true;
+  task_tracker_.FlushForTesting();
+}
+
 INSTANTIATE_TEST_SUITE_P(GenericParallel,
                          ThreadGroupTestAllExecutionModes,
                          ::testing::Values(TaskSourceExecutionMode::kParallel));
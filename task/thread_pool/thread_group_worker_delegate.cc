@@ -6,14 +6,24 @@
 
 #include "base/metrics/histogram_functions.h"
 #include "base/strings/stringprintf.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "base/threading/scoped_blocking_call_internal.h"
 #include "base/threading/thread_checker.h"
 #include "base/time/time.h"
 #include "base/time/time_override.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
 
 namespace base::internal {
 
+namespace {
+
+// |job_preempted_| of the ThreadGroupWorkerDelegate of the current thread.
+ABSL_CONST_INIT thread_local std::atomic_bool*
+    job_preempted_for_current_thread = nullptr;
+
+}  // namespace
+
 ThreadGroup::ThreadGroupWorkerDelegate::ThreadGroupWorkerDelegate(
     TrackedRef<ThreadGroup> outer,
     bool is_excess)
@@ -241,8 +251,8 @@ ThreadGroup::ThreadGroupWorkerDelegate::GetWorkLockRequired(
     return nullptr;
   }
 
-  RegisteredTaskSource task_source;
   TaskPriority priority;
+  RegisteredTaskSource task_source = TakeLocalTaskSourceLockRequired(&priority);
   while (!task_source && !outer_->priority_queue_.IsEmpty()) {
     // Enforce the CanRunPolicy and that no more than |max_best_effort_tasks_|
     // BEST_EFFORT tasks run concurrently.
@@ -266,10 +276,57 @@ ThreadGroup::ThreadGroupWorkerDelegate::GetWorkLockRequired(
 
   write_worker().current_task_priority = priority;
   write_worker().current_shutdown_behavior = task_source->shutdown_behavior();
+  write_worker().is_running_job =
+      task_source->execution_mode() == TaskSourceExecutionMode::kJob;
+  job_preempted_.store(false, std::memory_order_relaxed);
 
   return task_source;
 }
 
+std::optional<TaskPriority> ThreadGroup::ThreadGroupWorkerDelegate::
+    preemptible_job_priority_lock_required() const {
+  if (!read_any().is_running_job || is_running_preempted_job_) {
+    return std::nullopt;
+  }
+  return read_any().current_task_priority;
+}
+
+void ThreadGroup::ThreadGroupWorkerDelegate::PreemptJobLockRequired() {
+  DCHECK(read_any().is_running_job);
+  DCHECK(!is_running_preempted_job_);
+  is_running_preempted_job_ = true;
+  ++outer_->num_preempted_jobs_;
+  job_preempted_.store(true, std::memory_order_relaxed);
+}
+
+void ThreadGroup::ThreadGroupWorkerDelegate::DidRunTaskLockRequired() {
+  DCHECK_CALLED_ON_VALID_THREAD(worker_thread_checker_);
+  write_worker().current_shutdown_behavior = std::nullopt;
+  write_worker().current_task_priority = std::nullopt;
+  write_worker().is_running_job = false;
+  if (is_running_preempted_job_) {
+    DCHECK_GT(outer_->num_preempted_jobs_, 0u);
+    --outer_->num_preempted_jobs_;
+    is_running_preempted_job_ = false;
+  }
+}
+
+// static
+bool ThreadGroup::ThreadGroupWorkerDelegate::
+    ConsumeJobPreemptionForCurrentThread() {
+  // Check before exchanging to keep the common case read-only.
+  return job_preempted_for_current_thread &&
+         job_preempted_for_current_thread->load(std::memory_order_relaxed) &&
+         job_preempted_for_current_thread->exchange(false,
+                                                    std::memory_order_relaxed);
+}
+
+RegisteredTaskSource
+ThreadGroup::ThreadGroupWorkerDelegate::TakeLocalTaskSourceLockRequired(
+    TaskPriority* priority) {
+  return nullptr;
+}
+
 void ThreadGroup::ThreadGroupWorkerDelegate::RecordUnnecessaryWakeupImpl() {
   DCHECK_CALLED_ON_VALID_THREAD(worker_thread_checker_);
 
@@ -300,10 +357,15 @@ void ThreadGroup::ThreadGroupWorkerDelegate::OnMainEntryImpl(
 
   PlatformThread::SetName(
       StringPrintf("ThreadPool%sWorker", outer_->thread_group_label_.c_str()));
+  if (!outer_->worker_processors_.empty()) {
+    // Failing is harmless: the worker then runs on any processor.
+    PlatformThread::SetCurrentThreadAffinity(outer_->worker_processors_);
+  }
 
   outer_->BindToCurrentThread();
   worker_only().worker_thread_ = static_cast<WorkerThread*>(worker);
   SetBlockingObserverForCurrentThread(this);
+  job_preempted_for_current_thread = &job_preempted_;
 
   if (outer_->worker_started_for_testing_) {
     // When |worker_started_for_testing_| is set, the thread that starts workers
@@ -5,6 +5,7 @@
 #ifndef BASE_TASK_THREAD_POOL_THREAD_GROUP_WORKER_DELEGATE_H_
 #define BASE_TASK_THREAD_POOL_THREAD_GROUP_WORKER_DELEGATE_H_
 
+#include <atomic>
 #include <optional>
 
 #include "base/task/task_traits.h"
@@ -54,6 +55,20 @@ class ThreadGroup::ThreadGroupWorkerDelegate : public BlockingObserver {
     return *read_any().current_task_priority;
   }
 
+  // Returns the priority of the job that the worker is running, unless it isn't
+  // running a job or the job was already preempted.
+  std::optional<TaskPriority> preemptible_job_priority_lock_required() const
+      EXCLUSIVE_LOCKS_REQUIRED(outer_->lock_);
+
+  // Makes the next ShouldYield() call of the job that the worker is running
+  // return true. The job counts in |outer_->num_preempted_jobs_| until it
+  // returns.
+  void PreemptJobLockRequired() EXCLUSIVE_LOCKS_REQUIRED(outer_->lock_);
+
+  // Returns true if the job running on the current thread was preempted by
+  // PreemptJobLockRequired() since the last call.
+  static bool ConsumeJobPreemptionForCurrentThread();
+
   // Exposed for AnnotateAcquiredLockAlias.
   const CheckedLock& lock() const LOCK_RETURNED(outer_->lock_) {
     return outer_->lock_;
@@ -75,6 +90,14 @@ class ThreadGroup::ThreadGroupWorkerDelegate : public BlockingObserver {
                                            WorkerThread* worker)
       EXCLUSIVE_LOCKS_REQUIRED(outer_->lock_);
 
+  // Returns a task source that was posted from a worker of the thread group
+  // and kept out of |outer_->priority_queue_|, on which WillRunTask() was
+  // called, and sets |priority| to its priority. Returns nullptr if there is
+  // none that should run before the task sources in |outer_->priority_queue_|.
+  // By default, thread groups don't keep such task sources.
+  virtual RegisteredTaskSource TakeLocalTaskSourceLockRequired(
+      TaskPriority* priority) EXCLUSIVE_LOCKS_REQUIRED(outer_->lock_);
+
   // Calls cleanup on |worker| and removes it from the thread group. Called from
   // GetWork() when no work is available and CanCleanupLockRequired() returns
   // true.
@@ -82,6 +105,9 @@ class ThreadGroup::ThreadGroupWorkerDelegate : public BlockingObserver {
                                    WorkerThread* worker)
       EXCLUSIVE_LOCKS_REQUIRED(outer_->lock_) = 0;
 
+  // Resets the running task bookkeeping after the worker ran a task.
+  void DidRunTaskLockRequired() EXCLUSIVE_LOCKS_REQUIRED(outer_->lock_);
+
   // Called in GetWork() when a worker becomes idle.
   virtual void OnWorkerBecomesIdleLockRequired(
       BaseScopedCommandsExecutor* executor,
@@ -121,6 +147,9 @@ class ThreadGroup::ThreadGroupWorkerDelegate : public BlockingObserver {
     // The shutdown behavior of the task the worker is currently running if any.
     std::optional<TaskShutdownBehavior> current_shutdown_behavior;
 
+    // Whether the task source the worker is currently running is a job.
+    bool is_running_job = false;
+
     // Time when MayBlockScopeEntered() was last called. Reset when
     // BlockingScopeExited() is called.
     TimeTicks blocking_start_time;
@@ -168,6 +197,13 @@ class ThreadGroup::ThreadGroupWorkerDelegate : public BlockingObserver {
   // shutdown.
   bool incremented_max_tasks_for_shutdown_ GUARDED_BY(outer_->lock_) = false;
 
+  // Whether the job that the worker is running was preempted.
+  bool is_running_preempted_job_ GUARDED_BY(outer_->lock_) = false;
+
+  // Set by PreemptJobLockRequired(), reset when the worker starts running a
+  // task source or when ConsumeJobPreemptionForCurrentThread() reads it.
+  std::atomic_bool job_preempted_{false};
+
   // Verifies that specific calls are always made from the worker thread.
   THREAD_CHECKER(worker_thread_checker_);
 };
@@ -5,10 +5,12 @@
 #include "base/task/thread_pool/thread_pool_impl.h"
 
 #include <algorithm>
+#include <limits>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "base/base_switches.h"
 #include "base/command_line.h"
@@ -20,9 +22,13 @@
 #include "base/message_loop/message_pump.h"
 #include "base/message_loop/message_pump_type.h"
 #include "base/metrics/field_trial_params.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/system/sys_info.h"
 #include "base/task/scoped_set_task_priority_for_current_thread.h"
+#include "base/task/task_features.h"
 #include "base/task/thread_pool/pooled_parallel_task_runner.h"
 #include "base/task/thread_pool/pooled_sequenced_task_runner.h"
 #include "base/task/thread_pool/task.h"
@@ -67,6 +73,11 @@ bool HasDisableBestEffortTasksSwitch() {
 // internal edge case.
 bool g_synchronous_thread_start_for_testing = false;
 
+// Overrides SysInfo::NumaNodeProcessors() if set. Set from tests while no
+// ThreadPoolInstance is active, like the above.
+const std::vector<std::vector<int>>* g_numa_node_processors_for_testing =
+    nullptr;
+
 }  // namespace
 
 ThreadPoolImpl::ThreadPoolImpl(std::string_view histogram_label)
@@ -112,8 +123,12 @@ ThreadPoolImpl::~ThreadPoolImpl() {
   DCHECK(join_for_testing_returned_.IsSet());
 #endif
 
+  // Destroyed before the thread groups, which it updates.
+  power_saving_controller_.reset();
+
   // Reset thread groups to release held TrackedRefs, which block teardown.
   foreground_thread_group_.reset();
+  numa_node_thread_groups_.clear();
   utility_thread_group_.reset();
   background_thread_group_.reset();
 }
@@ -210,6 +225,48 @@ void ThreadPoolImpl::Start(const ThreadPoolInstance::InitParams& init_params,
     }
   }
 
+  size_t foreground_threads = init_params.max_num_foreground_threads;
+  const std::vector<std::vector<int>>& numa_node_processors =
+      g_numa_node_processors_for_testing ? *g_numa_node_processors_for_testing
+                                         : SysInfo::NumaNodeProcessors();
+  // The per-node thread groups are ThreadGroupImpls, which aren't mixed with
+  // ThreadGroupSemaphores.
+  if (init_params.numa_aware_foreground_thread_groups &&
+      init_params.foreground_worker_processors.empty() &&
+      numa_node_processors.size() > 1 &&
+      !FeatureList::IsEnabled(kThreadGroupSemaphore)) {
+    foreground_threads =
+        std::max<size_t>(1, foreground_threads / numa_node_processors.size());
+    foreground_thread_group_->SetWorkerProcessors(numa_node_processors[0]);
+    for (size_t node = 1; node < numa_node_processors.size(); ++node) {
+      const std::string thread_group_label =
+          StrCat({kForegroundPoolEnvironmentParams.name_suffix, "Node",
+                  NumberToString(node)});
+      auto thread_group = std::make_unique<ThreadGroupImpl>(
+          histogram_label_.empty()
+              ? std::string()
+              : JoinString({histogram_label_, thread_group_label}, "."),
+          thread_group_label, kForegroundPoolEnvironmentParams.thread_type_hint,
+          task_tracker_->GetTrackedRef(), tracked_ref_factory_.GetTrackedRef());
+      thread_group->SetWorkerProcessors(numa_node_processors[node]);
+      numa_node_thread_groups_.push_back(std::move(thread_group));
+    }
+  }
+
+  if (!init_params.foreground_worker_processors.empty()) {
+    foreground_thread_group_->SetWorkerProcessors(
+        init_params.foreground_worker_processors);
+    if (utility_thread_group_) {
+      utility_thread_group_->SetWorkerProcessors(
+          init_params.foreground_worker_processors);
+    }
+  }
+  if (background_thread_group_ &&
+      !init_params.background_worker_processors.empty()) {
+    background_thread_group_->SetWorkerProcessors(
+        init_params.background_worker_processors);
+  }
+
   // Update the CanRunPolicy based on |has_disable_best_effort_switch_|.
   UpdateCanRunPolicy();
 
@@ -232,7 +289,6 @@ void ThreadPoolImpl::Start(const ThreadPoolInstance::InitParams& init_params,
 #endif
   }
 
-  size_t foreground_threads = init_params.max_num_foreground_threads;
   size_t utility_threads = init_params.max_num_utility_threads;
 
   // On platforms that can't use the background thread priority, best-effort
@@ -241,12 +297,21 @@ void ThreadPoolImpl::Start(const ThreadPoolInstance::InitParams& init_params,
   // room for incoming foreground tasks and to minimize the performance impact
   // of best-effort tasks.
   foreground_thread_group_.get()->Start(
-      foreground_threads, max_best_effort_tasks,
+      foreground_threads, std::min(max_best_effort_tasks, foreground_threads),
       init_params.suggested_reclaim_time, service_thread_task_runner,
       worker_thread_observer, worker_environment,
       g_synchronous_thread_start_for_testing,
       /*may_block_threshold=*/{});
 
+  for (auto& thread_group : numa_node_thread_groups_) {
+    thread_group->Start(
+        foreground_threads, std::min(max_best_effort_tasks, foreground_threads),
+        init_params.suggested_reclaim_time, service_thread_task_runner,
+        worker_thread_observer, worker_environment,
+        g_synchronous_thread_start_for_testing,
+        /*may_block_threshold=*/{});
+  }
+
   if (utility_thread_group_) {
     utility_thread_group_.get()->Start(
         utility_threads, max_best_effort_tasks,
@@ -265,6 +330,23 @@ void ThreadPoolImpl::Start(const ThreadPoolInstance::InitParams& init_params,
         /*may_block_threshold=*/{});
   }
 
+  if (FeatureList::IsEnabled(kThreadPoolCpuQuotaController)) {
+    cpu_quota_controller_ = CpuQuotaController::Create(
+        foreground_threads * (1 + numa_node_thread_groups_.size()));
+    // The first call samples the CPU usage and applies the CPU quota, if any.
+    ScheduleAdjustMaxTasksForCpuQuota(TimeDelta());
+  }
+
+  if (FeatureList::IsEnabled(kThreadPoolPowerSaving)) {
+    power_saving_leeway_ = kPowerSavingLeeway.Get();
+    power_saving_best_effort_leeway_ = kPowerSavingBestEffortLeeway.Get();
+    // Unretained is safe because the service thread is stopped before |this|
+    // is destroyed.
+    service_thread_.task_runner()->PostTask(
+        FROM_HERE, BindOnce(&ThreadPoolImpl::StartPowerSavingController,
+                            Unretained(this)));
+  }
+
   started_ = true;
 }
 
@@ -338,6 +420,13 @@ void ThreadPoolImpl::SetSynchronousThreadStartForTesting(bool enabled) {
   g_synchronous_thread_start_for_testing = enabled;
 }
 
+// static
+void ThreadPoolImpl::SetNumaNodeProcessorsForTesting(
+    const std::vector<std::vector<int>>* numa_node_processors) {
+  DCHECK(!ThreadPoolInstance::Get());
+  g_numa_node_processors_for_testing = numa_node_processors;
+}
+
 size_t ThreadPoolImpl::GetMaxConcurrentNonBlockedTasksWithTraitsDeprecated(
     const TaskTraits& traits) const {
   // This method does not support getting the maximum number of BEST_EFFORT
@@ -372,6 +461,9 @@ void ThreadPoolImpl::Shutdown() {
   // Ensures that there are enough background worker to run BLOCK_SHUTDOWN
   // tasks.
   foreground_thread_group_->OnShutdownStarted();
+  for (auto& thread_group : numa_node_thread_groups_) {
+    thread_group->OnShutdownStarted();
+  }
   if (utility_thread_group_)
     utility_thread_group_->OnShutdownStarted();
   if (background_thread_group_)
@@ -402,6 +494,9 @@ void ThreadPoolImpl::JoinForTesting() {
   service_thread_.Stop();
   single_thread_task_runner_manager_.JoinForTesting();
   foreground_thread_group_->JoinForTesting();
+  for (auto& thread_group : numa_node_thread_groups_) {
+    thread_group->JoinForTesting();
+  }
   if (utility_thread_group_)
     utility_thread_group_->JoinForTesting();  // IN-TEST
   if (background_thread_group_)
@@ -445,6 +540,77 @@ void ThreadPoolImpl::EndFizzlingBlockShutdownTasks() {
   task_tracker_->EndFizzlingBlockShutdownTasks();
 }
 
+void ThreadPoolImpl::StartTaskLatencySampling(size_t sampling_interval,
+                                              bool emit_trace_counters) {
+  task_tracker_->task_latency_recorder().Start(sampling_interval,
+                                               emit_trace_counters);
+}
+
+void ThreadPoolImpl::StopTaskLatencySampling() {
+  task_tracker_->task_latency_recorder().Stop();
+}
+
+std::vector<ThreadPoolInstance::TaskLatencyStats>
+ThreadPoolImpl::GetTaskLatencyStats() const {
+  return task_tracker_->task_latency_recorder().GetSnapshot();
+}
+
+void ThreadPoolImpl::ScheduleAdjustMaxTasksForCpuQuota(TimeDelta delay) {
+  // Unretained is safe because the service thread is stopped before |this| is
+  // destroyed.
+  service_thread_.task_runner()->PostDelayedTask(
+      FROM_HERE,
+      BindOnce(&ThreadPoolImpl::AdjustMaxTasksForCpuQuota, Unretained(this)),
+      delay);
+}
+
+void ThreadPoolImpl::AdjustMaxTasksForCpuQuota() {
+  DCHECK(service_thread_.task_runner()->RunsTasksInCurrentSequence());
+  const size_t max_tasks_limit =
+      cpu_quota_controller_->Update(TimeTicks::Now());
+  // Split the limit between the foreground thread groups of all NUMA nodes.
+  const size_t num_thread_groups = 1 + numa_node_thread_groups_.size();
+  const size_t max_tasks_limit_per_thread_group =
+      (max_tasks_limit + num_thread_groups - 1) / num_thread_groups;
+  foreground_thread_group_->SetMaxTasksLimit(max_tasks_limit_per_thread_group);
+  for (auto& thread_group : numa_node_thread_groups_) {
+    thread_group->SetMaxTasksLimit(max_tasks_limit_per_thread_group);
+  }
+  ScheduleAdjustMaxTasksForCpuQuota(kCpuQuotaPollPeriod.Get());
+}
+
+void ThreadPoolImpl::StartPowerSavingController() {
+  DCHECK(service_thread_.task_runner()->RunsTasksInCurrentSequence());
+  // Unretained is safe because |this| outlives |power_saving_controller_|.
+  power_saving_controller_ = std::make_unique<PowerSavingController>(
+      BindRepeating(&ThreadPoolImpl::OnPowerSavingChange, Unretained(this)));
+}
+
+void ThreadPoolImpl::OnPowerSavingChange(bool should_save_power) {
+  DCHECK(service_thread_.task_runner()->RunsTasksInCurrentSequence());
+  is_saving_power_.store(should_save_power, std::memory_order_relaxed);
+  // SetMaxBestEffortTasksLimit() caps the limit to the initial max BEST_EFFORT
+  // tasks, which restores it.
+  const size_t max_best_effort_tasks_limit =
+      should_save_power
+          ? static_cast<size_t>(
+                std::max(kPowerSavingMaxBestEffortTasks.Get(), 1))
+          : std::numeric_limits<size_t>::max();
+  foreground_thread_group_->SetMaxBestEffortTasksLimit(
+      max_best_effort_tasks_limit);
+  for (auto& thread_group : numa_node_thread_groups_) {
+    thread_group->SetMaxBestEffortTasksLimit(max_best_effort_tasks_limit);
+  }
+  if (utility_thread_group_) {
+    utility_thread_group_->SetMaxBestEffortTasksLimit(
+        max_best_effort_tasks_limit);
+  }
+  if (background_thread_group_) {
+    background_thread_group_->SetMaxBestEffortTasksLimit(
+        max_best_effort_tasks_limit);
+  }
+}
+
 bool ThreadPoolImpl::PostTaskWithSequenceNow(Task task,
                                              scoped_refptr<Sequence> sequence) {
   auto transaction = sequence->BeginTransaction();
@@ -461,8 +627,12 @@ bool ThreadPoolImpl::PostTaskWithSequenceNow(Task task,
   transaction.PushImmediateTask(std::move(task));
   if (task_source) {
     const TaskTraits traits = transaction.traits();
-    GetThreadGroupForTraits(traits)->PushTaskSourceAndWakeUpWorkers(
-        {std::move(task_source), std::move(transaction)});
+    // |sequence| is neither queued nor running, so it can move to another NUMA
+    // node.
+    UpdateNumaNodeAffinity(sequence.get(), traits, /*can_migrate=*/true);
+    GetThreadGroupForTaskSource(*sequence, traits)
+        ->PushTaskSourceAndWakeUpWorkers(
+            {std::move(task_source), std::move(transaction)});
   }
   return true;
 }
@@ -474,18 +644,21 @@ bool ThreadPoolImpl::PostTaskWithSequence(Task task,
   CHECK(task.task);
   DCHECK(sequence);
 
-  if (!task_tracker_->WillPostTask(&task, sequence->shutdown_behavior())) {
-    // `task`'s destructor may run sequence-affine code, so it must be leaked
-    // when `WillPostTask` returns false.
-    auto leak = std::make_unique<Task>(std::move(task));
-    ANNOTATE_LEAKING_OBJECT_PTR(leak.get());
-    leak.release();
+  if (!WillPostTask(&task, sequence->shutdown_behavior()))
     return false;
-  }
 
   if (task.delayed_run_time.is_null()) {
     return PostTaskWithSequenceNow(std::move(task), std::move(sequence));
   } else {
+    if (is_saving_power_.load(std::memory_order_relaxed)) {
+      // Coalesce the wake-ups of delayed tasks, and defer the BEST_EFFORT
+      // ones further. This doesn't affect tasks with a precise delay policy.
+      task.leeway = std::max(
+          task.leeway,
+          sequence->priority_racy() == TaskPriority::BEST_EFFORT
+              ? power_saving_best_effort_leeway_
+              : power_saving_leeway_);
+    }
     // It's safe to take a ref on this pointer since the caller must have a ref
     // to the TaskRunner in order to post.
     scoped_refptr<TaskRunner> task_runner = sequence->task_runner();
@@ -504,16 +677,140 @@ bool ThreadPoolImpl::PostTaskWithSequence(Task task,
   return true;
 }
 
+bool ThreadPoolImpl::PostTasksWithSequence(std::vector<Task> tasks,
+                                           scoped_refptr<Sequence> sequence) {
+  DCHECK(sequence);
+
+  bool all_posted = true;
+  std::vector<Task> tasks_to_push;
+  tasks_to_push.reserve(tasks.size());
+  for (Task& task : tasks) {
+    // Use CHECK instead of DCHECK to crash earlier. See http://crbug.com/711167
+    // for details.
+    CHECK(task.task);
+    DCHECK(task.delayed_run_time.is_null());
+    if (!WillPostTask(&task, sequence->shutdown_behavior())) {
+      all_posted = false;
+      continue;
+    }
+    tasks_to_push.push_back(std::move(task));
+  }
+  if (tasks_to_push.empty())
+    return all_posted;
+
+  // Push all tasks in a single transaction, and queue |sequence| at most once.
+  auto transaction = sequence->BeginTransaction();
+  const bool sequence_should_be_queued = transaction.WillPushImmediateTask();
+  RegisteredTaskSource task_source;
+  if (sequence_should_be_queued) {
+    task_source = task_tracker_->RegisterTaskSource(sequence);
+    // We shouldn't push the tasks if we're not allowed to queue
+    // |task_source|.
+    if (!task_source)
+      return false;
+  }
+  const TaskPriority priority = transaction.traits().priority();
+  for (Task& task : tasks_to_push) {
+    if (!task_tracker_->WillPostTaskNow(task, priority)) {
+      all_posted = false;
+      continue;
+    }
+    transaction.PushImmediateTask(std::move(task));
+  }
+  if (task_source) {
+    const TaskTraits traits = transaction.traits();
+    UpdateNumaNodeAffinity(sequence.get(), traits, /*can_migrate=*/true);
+    GetThreadGroupForTaskSource(*sequence, traits)
+        ->PushTaskSourceAndWakeUpWorkers(
+            {std::move(task_source), std::move(transaction)});
+  }
+  return all_posted;
+}
+
+bool ThreadPoolImpl::PostTasksWithSequences(
+    std::vector<std::pair<Task, scoped_refptr<Sequence>>>
+        tasks_and_sequences) {
+  using TaskSources =
+      std::vector<std::pair<RegisteredTaskSource, TaskSourceSortKey>>;
+  bool all_posted = true;
+  // The task sources to push, grouped by destination thread group, so that
+  // each thread group is locked and wakes up workers once.
+  std::vector<std::pair<ThreadGroup*, TaskSources>>
+      task_sources_by_thread_group;
+  for (auto& [task, sequence] : tasks_and_sequences) {
+    // Use CHECK instead of DCHECK to crash earlier. See http://crbug.com/711167
+    // for details.
+    CHECK(task.task);
+    DCHECK(task.delayed_run_time.is_null());
+    DCHECK(sequence);
+    if (!WillPostTask(&task, sequence->shutdown_behavior())) {
+      all_posted = false;
+      continue;
+    }
+
+    auto transaction = sequence->BeginTransaction();
+    const bool sequence_should_be_queued = transaction.WillPushImmediateTask();
+    RegisteredTaskSource task_source;
+    if (sequence_should_be_queued) {
+      task_source = task_tracker_->RegisterTaskSource(sequence);
+      if (!task_source) {
+        all_posted = false;
+        continue;
+      }
+    }
+    if (!task_tracker_->WillPostTaskNow(task,
+                                        transaction.traits().priority())) {
+      all_posted = false;
+      continue;
+    }
+    transaction.PushImmediateTask(std::move(task));
+    if (!task_source)
+      continue;
+
+    const TaskTraits traits = transaction.traits();
+    UpdateNumaNodeAffinity(sequence.get(), traits, /*can_migrate=*/true);
+    ThreadGroup* const thread_group =
+        GetThreadGroupForTaskSource(*sequence, traits);
+    const TaskSourceSortKey sort_key = task_source->GetSortKey();
+    // As in ThreadGroup::PushTaskSourceAndWakeUpWorkersImpl(), release
+    // |transaction| before |task_source| becomes visible to workers.
+    transaction.Release();
+    auto it = ranges::find(task_sources_by_thread_group, thread_group,
+                           &std::pair<ThreadGroup*, TaskSources>::first);
+    if (it == task_sources_by_thread_group.end()) {
+      it = task_sources_by_thread_group.emplace(it, thread_group,
+                                                TaskSources());
+    }
+    it->second.emplace_back(std::move(task_source), sort_key);
+  }
+
+  for (auto& [thread_group, task_sources] : task_sources_by_thread_group) {
+    thread_group->PushTaskSourcesAndWakeUpWorkers(std::move(task_sources));
+  }
+  return all_posted;
+}
+
+bool ThreadPoolImpl::WillPostTask(Task* task,
+                                  TaskShutdownBehavior shutdown_behavior) {
+  if (task_tracker_->WillPostTask(task, shutdown_behavior))
+    return true;
+  // `task`'s destructor may run sequence-affine code, so it must be leaked
+  // when `WillPostTask` returns false.
+  auto leak = std::make_unique<Task>(std::move(*task));
+  ANNOTATE_LEAKING_OBJECT_PTR(leak.get());
+  leak.release();
+  return false;
+}
+
 bool ThreadPoolImpl::ShouldYield(const TaskSource* task_source) {
   const TaskPriority priority = task_source->priority_racy();
-  auto* const thread_group =
-      GetThreadGroupForTraits({priority, task_source->thread_policy()});
+  auto* const thread_group = GetThreadGroupForTaskSource(
+      *task_source, {priority, task_source->thread_policy()});
   // A task whose priority changed and is now running in the wrong thread group
   // should yield so it's rescheduled in the right one.
   if (!thread_group->IsBoundToCurrentThread())
     return true;
-  return GetThreadGroupForTraits({priority, task_source->thread_policy()})
-      ->ShouldYield(task_source->GetSortKey());
+  return thread_group->ShouldYield(task_source->GetSortKey());
 }
 
 bool ThreadPoolImpl::EnqueueJobTaskSource(
@@ -526,8 +823,12 @@ bool ThreadPoolImpl::EnqueueJobTaskSource(
       static_cast<JobTaskSource*>(registered_task_source.get()));
   auto transaction = registered_task_source->BeginTransaction();
   const TaskTraits traits = transaction.traits();
-  GetThreadGroupForTraits(traits)->PushTaskSourceAndWakeUpWorkers(
-      {std::move(registered_task_source), std::move(transaction)});
+  // Workers may be running the job already, so it stays on its NUMA node.
+  UpdateNumaNodeAffinity(registered_task_source.get(), traits,
+                         /*can_migrate=*/false);
+  GetThreadGroupForTaskSource(*registered_task_source.get(), traits)
+      ->PushTaskSourceAndWakeUpWorkers(
+          {std::move(registered_task_source), std::move(transaction)});
   return true;
 }
 
@@ -535,7 +836,7 @@ void ThreadPoolImpl::RemoveJobTaskSource(
     scoped_refptr<JobTaskSource> task_source) {
   auto transaction = task_source->BeginTransaction();
   ThreadGroup* const current_thread_group =
-      GetThreadGroupForTraits(transaction.traits());
+      GetThreadGroupForTaskSource(*task_source, transaction.traits());
   current_thread_group->RemoveTaskSource(*task_source);
 }
 
@@ -554,10 +855,12 @@ void ThreadPoolImpl::UpdatePriority(scoped_refptr<TaskSource> task_source,
   }
 
   ThreadGroup* const current_thread_group =
-      GetThreadGroupForTraits(transaction.traits());
+      GetThreadGroupForTaskSource(*task_source, transaction.traits());
   transaction.UpdatePriority(priority);
+  UpdateNumaNodeAffinity(task_source.get(), transaction.traits(),
+                         /*can_migrate=*/false);
   ThreadGroup* const new_thread_group =
-      GetThreadGroupForTraits(transaction.traits());
+      GetThreadGroupForTaskSource(*task_source, transaction.traits());
 
   if (new_thread_group == current_thread_group) {
     // |task_source|'s position needs to be updated within its current thread
@@ -602,6 +905,65 @@ ThreadGroup* ThreadPoolImpl::GetThreadGroupForTraits(const TaskTraits& traits) {
   return foreground_thread_group_.get();
 }
 
+ThreadGroup* ThreadPoolImpl::GetThreadGroupForTaskSource(
+    const TaskSource& task_source,
+    const TaskTraits& traits) {
+  ThreadGroup* const thread_group = GetThreadGroupForTraits(traits);
+  const size_t node = task_source.numa_node_racy();
+  if (thread_group != foreground_thread_group_.get() ||
+      node == TaskSource::kNoNumaNode || numa_node_thread_groups_.empty()) {
+    return thread_group;
+  }
+  return GetForegroundThreadGroupForNumaNode(node);
+}
+
+ThreadGroup* ThreadPoolImpl::GetForegroundThreadGroupForNumaNode(size_t node) {
+  if (node == 0) {
+    return foreground_thread_group_.get();
+  }
+  return numa_node_thread_groups_[node - 1].get();
+}
+
+void ThreadPoolImpl::UpdateNumaNodeAffinity(TaskSource* task_source,
+                                            const TaskTraits& traits,
+                                            bool can_migrate) {
+  if (numa_node_thread_groups_.empty() ||
+      GetThreadGroupForTraits(traits) != foreground_thread_group_.get()) {
+    return;
+  }
+  const size_t num_nodes = numa_node_thread_groups_.size() + 1;
+
+  size_t node = task_source->numa_node_racy();
+  if (node == TaskSource::kNoNumaNode) {
+    // Prefer the node of the posting worker, whose caches likely hold the data
+    // that |task_source| operates on.
+    for (node = 0; node < num_nodes; ++node) {
+      if (GetForegroundThreadGroupForNumaNode(node)->IsBoundToCurrentThread()) {
+        break;
+      }
+    }
+    if (node == num_nodes) {
+      node = next_numa_node_.fetch_add(1, std::memory_order_relaxed) %
+             num_nodes;
+    }
+    can_migrate = true;
+  }
+
+  // Crossing nodes is only worth it if |task_source| would otherwise wait while
+  // another node has nothing to do.
+  if (can_migrate &&
+      GetForegroundThreadGroupForNumaNode(node)->IsSaturatedRacy()) {
+    for (size_t i = 1; i < num_nodes; ++i) {
+      const size_t other_node = (node + i) % num_nodes;
+      if (GetForegroundThreadGroupForNumaNode(other_node)->IsIdleRacy()) {
+        node = other_node;
+        break;
+      }
+    }
+  }
+  task_source->set_numa_node(node);
+}
+
 void ThreadPoolImpl::UpdateCanRunPolicy() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -619,6 +981,9 @@ void ThreadPoolImpl::UpdateCanRunPolicy() {
 
   task_tracker_->SetCanRunPolicy(can_run_policy);
   foreground_thread_group_->DidUpdateCanRunPolicy();
+  for (auto& thread_group : numa_node_thread_groups_) {
+    thread_group->DidUpdateCanRunPolicy();
+  }
   if (utility_thread_group_)
     utility_thread_group_->DidUpdateCanRunPolicy();
   if (background_thread_group_)
@@ -5,9 +5,11 @@
 #ifndef BASE_TASK_THREAD_POOL_THREAD_POOL_IMPL_H_
 #define BASE_TASK_THREAD_POOL_THREAD_POOL_IMPL_H_
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/dcheck_is_on.h"
@@ -17,10 +19,12 @@
 #include "base/synchronization/atomic_flag.h"
 #include "base/task/single_thread_task_runner_thread_mode.h"
 #include "base/task/task_traits.h"
+#include "base/task/thread_pool/cpu_quota_controller.h"
 #include "base/task/thread_pool/delayed_task_manager.h"
 #include "base/task/thread_pool/environment_config.h"
 #include "base/task/thread_pool/pooled_single_thread_task_runner_manager.h"
 #include "base/task/thread_pool/pooled_task_runner_delegate.h"
+#include "base/task/thread_pool/power_saving_controller.h"
 #include "base/task/thread_pool/service_thread.h"
 #include "base/task/thread_pool/task_source.h"
 #include "base/task/thread_pool/task_tracker.h"
@@ -78,6 +82,10 @@ class BASE_EXPORT ThreadPoolImpl : public ThreadPoolInstance,
   void EndBestEffortFence() override;
   void BeginFizzlingBlockShutdownTasks() override;
   void EndFizzlingBlockShutdownTasks() override;
+  void StartTaskLatencySampling(size_t sampling_interval,
+                                bool emit_trace_counters) override;
+  void StopTaskLatencySampling() override;
+  std::vector<TaskLatencyStats> GetTaskLatencyStats() const override;
 
   // PooledTaskRunnerDelegate:
   bool EnqueueJobTaskSource(scoped_refptr<JobTaskSource> task_source) override;
@@ -104,6 +112,15 @@ class BASE_EXPORT ThreadPoolImpl : public ThreadPoolInstance,
   // configuration param because only one internal test truly needs this.
   static void SetSynchronousThreadStartForTesting(bool enabled);
 
+  // Overrides the NUMA topology used by future ThreadPoolImpls in this process
+  // started with InitParams::numa_aware_foreground_thread_groups. Nodes with
+  // no processors are allowed and don't restrict their workers. Cancels the
+  // override if |numa_node_processors| is null; otherwise it must outlive
+  // those ThreadPoolImpls. Must be called while no ThreadPoolImpls are alive
+  // in this process.
+  static void SetNumaNodeProcessorsForTesting(
+      const std::vector<std::vector<int>>* numa_node_processors);
+
   // Posts |task| with a |delay| and specific |traits|. |delay| can be zero. For
   // one off tasks that don't require a TaskRunner. Returns false if the task
   // definitely won't run because of current shutdown state.
@@ -161,15 +178,53 @@ class BASE_EXPORT ThreadPoolImpl : public ThreadPoolInstance,
 
   // ThreadGroup::Delegate:
   ThreadGroup* GetThreadGroupForTraits(const TaskTraits& traits) override;
+  ThreadGroup* GetThreadGroupForTaskSource(const TaskSource& task_source,
+                                           const TaskTraits& traits) override;
+
+  // Returns the thread group that runs foreground tasks of NUMA node |node|.
+  ThreadGroup* GetForegroundThreadGroupForNumaNode(size_t node);
+
+  // Posts AdjustMaxTasksForCpuQuota() to the service thread after |delay|.
+  void ScheduleAdjustMaxTasksForCpuQuota(TimeDelta delay);
+
+  // Updates |cpu_quota_controller_| and caps the max tasks of the foreground
+  // thread groups accordingly. Runs on the service thread, and reschedules
+  // itself.
+  void AdjustMaxTasksForCpuQuota();
+
+  // Creates |power_saving_controller_|. Runs on the service thread.
+  void StartPowerSavingController();
+
+  // Caps the max BEST_EFFORT tasks of all thread groups, and increases the
+  // leeway of delayed tasks, while |should_save_power|. Runs on the service
+  // thread.
+  void OnPowerSavingChange(bool should_save_power);
+
+  // Assigns the NUMA node whose thread group runs |task_source|, which has
+  // |traits|, before it is pushed to a thread group. The node is picked the
+  // first time, and only changes afterwards if |can_migrate| and its thread
+  // group is saturated while that of another node is idle.
+  void UpdateNumaNodeAffinity(TaskSource* task_source,
+                              const TaskTraits& traits,
+                              bool can_migrate);
 
   // Posts |task| to be executed by the appropriate thread group as part of
   // |sequence|. This must only be called after |task| has gone through
   // TaskTracker::WillPostTask() and after |task|'s delayed run time.
   bool PostTaskWithSequenceNow(Task task, scoped_refptr<Sequence> sequence);
 
+  // Calls TaskTracker::WillPostTask() for |task|, which is leaked if it returns
+  // false.
+  bool WillPostTask(Task* task, TaskShutdownBehavior shutdown_behavior);
+
   // PooledTaskRunnerDelegate:
   bool PostTaskWithSequence(Task task,
                             scoped_refptr<Sequence> sequence) override;
+  bool PostTasksWithSequence(std::vector<Task> tasks,
+                             scoped_refptr<Sequence> sequence) override;
+  bool PostTasksWithSequences(
+      std::vector<std::pair<Task, scoped_refptr<Sequence>>>
+          tasks_and_sequences) override;
   bool ShouldYield(const TaskSource* task_source) override;
 
   const std::string histogram_label_;
@@ -183,6 +238,32 @@ class BASE_EXPORT ThreadPoolImpl : public ThreadPoolInstance,
   std::unique_ptr<ThreadGroup> utility_thread_group_;
   std::unique_ptr<ThreadGroup> background_thread_group_;
 
+  // When started with InitParams::numa_aware_foreground_thread_groups on a
+  // machine with several NUMA nodes, the thread groups that run the foreground
+  // tasks of the nodes other than the first, whose thread group is
+  // |foreground_thread_group_|. Set in Start() and immutable afterwards.
+  std::vector<std::unique_ptr<ThreadGroup>> numa_node_thread_groups_;
+
+  // The node assigned to the next task source first posted from outside of a
+  // per-NUMA-node thread group.
+  std::atomic_size_t next_numa_node_{0};
+
+  // Set in Start() under kThreadPoolCpuQuotaController, and only used on the
+  // service thread afterwards.
+  std::unique_ptr<CpuQuotaController> cpu_quota_controller_;
+
+  // Created on the service thread under kThreadPoolPowerSaving, and only used
+  // there afterwards.
+  std::unique_ptr<PowerSavingController> power_saving_controller_;
+
+  // The minimum leeway of delayed tasks, and of BEST_EFFORT delayed tasks,
+  // while saving power. Set in Start() and immutable afterwards.
+  TimeDelta power_saving_leeway_;
+  TimeDelta power_saving_best_effort_leeway_;
+
+  // Set by OnPowerSavingChange(), read when delayed tasks are posted.
+  std::atomic_bool is_saving_power_{false};
+
   // Whether this TaskScheduler was started.
   bool started_ GUARDED_BY_CONTEXT(sequence_checker_) = false;
 
@@ -17,6 +17,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/barrier_closure.h"
 #include "base/base_switches.h"
 #include "base/cfi_buildflags.h"
 #include "base/containers/span.h"
@@ -28,6 +29,7 @@
 #include "base/message_loop/message_pump_type.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/field_trial_params.h"
+#include "base/synchronization/lock.h"
 #include "base/system/sys_info.h"
 #include "base/task/task_features.h"
 #include "base/task/task_traits.h"
@@ -479,6 +481,46 @@ TEST_P(ThreadPoolImplTest_CoverAllSchedulingOptions, PostTasksViaTaskRunner) {
   factory.WaitForAllTasksToRun();
 }
 
+// Verifies that Tasks posted as a batch via TaskRunner::PostTasks() with
+// parameterized TaskTraits and ExecutionMode all run on a thread with the
+// expected priority and I/O restrictions, in posting order unless the
+// ExecutionMode is parallel.
+TEST_P(ThreadPoolImplTest_CoverAllSchedulingOptions,
+       PostTasksBatchViaTaskRunner) {
+  StartThreadPool();
+  scoped_refptr<TaskRunner> task_runner = CreateTaskRunnerAndExecutionMode(
+      thread_pool_.get(), GetTraits(), GetExecutionMode());
+
+  const size_t kNumTasks = 150;
+  TestWaitableEvent all_tasks_ran;
+  RepeatingClosure barrier = BarrierClosure(
+      kNumTasks,
+      BindOnce(&TestWaitableEvent::Signal, Unretained(&all_tasks_ran)));
+  Lock lock;
+  std::vector<size_t> run_order;
+  std::vector<OnceClosure> tasks;
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    tasks.push_back(BindLambdaForTesting([&, i] {
+      VerifyTaskEnvironment(GetTraits(), GetUseResourceEfficientThreadGroup());
+      {
+        AutoLock auto_lock(lock);
+        run_order.push_back(i);
+      }
+      barrier.Run();
+    }));
+  }
+  EXPECT_TRUE(task_runner->PostTasks(FROM_HERE, std::move(tasks)));
+
+  all_tasks_ran.Wait();
+  AutoLock auto_lock(lock);
+  ASSERT_EQ(kNumTasks, run_order.size());
+  if (GetExecutionMode() != TaskSourceExecutionMode::kParallel) {
+    for (size_t i = 0; i < kNumTasks; ++i) {
+      EXPECT_EQ(i, run_order[i]);
+    }
+  }
+}
+
 // Verifies that a task posted via PostDelayedTask without a delay doesn't run
 // before Start() is called.
 TEST_P(ThreadPoolImplTest_CoverAllSchedulingOptions,
@@ -1618,6 +1660,82 @@ TEST_P(ThreadPoolImplTest, UpdatePriorityFromBestEffortNoThreadPolicy) {
   }
 }
 
+namespace {
+
+class ThreadPoolImplNumaTest : public testing::Test {
+ public:
+  ThreadPoolImplNumaTest() {
+    // Nodes without processors don't restrict their workers.
+    ThreadPoolImpl::SetNumaNodeProcessorsForTesting(&numa_node_processors_);
+    thread_pool_ = std::make_unique<ThreadPoolImpl>("Test");
+    ThreadPoolInstance::InitParams init_params(4);
+    init_params.numa_aware_foreground_thread_groups = true;
+    thread_pool_->Start(init_params, nullptr);
+  }
+
+  ~ThreadPoolImplNumaTest() override {
+    thread_pool_->FlushForTesting();
+    thread_pool_->JoinForTesting();
+    thread_pool_.reset();
+    ThreadPoolImpl::SetNumaNodeProcessorsForTesting(nullptr);
+  }
+
+ protected:
+  // Returns true if the current task runs in the thread group of the second
+  // NUMA node.
+  static bool IsOnSecondNumaNode() {
+    return PlatformThread::GetName().find("ForegroundNode1") !=
+           std::string::npos;
+  }
+
+  const std::vector<std::vector<int>> numa_node_processors_{{}, {}};
+  std::unique_ptr<ThreadPoolImpl> thread_pool_;
+};
+
+}  // namespace
+
+// Verify that sequences first posted from outside of the thread pool are
+// assigned to NUMA nodes in turn.
+TEST_F(ThreadPoolImplNumaTest, SequencesAlternateNodes) {
+  bool on_second_node[2];
+  TestWaitableEvent done[2];
+  for (int i = 0; i < 2; ++i) {
+    thread_pool_->CreateSequencedTaskRunner({})->PostTask(
+        FROM_HERE, BindLambdaForTesting([&, i] {
+          on_second_node[i] = IsOnSecondNumaNode();
+          done[i].Signal();
+        }));
+  }
+  done[0].Wait();
+  done[1].Wait();
+  EXPECT_NE(on_second_node[0], on_second_node[1]);
+}
+
+// Verify that a sequence posted from a worker runs on the worker's NUMA node,
+// and that it stays there.
+TEST_F(ThreadPoolImplNumaTest, SequencePostedFromWorkerStaysOnNode) {
+  for (int i = 0; i < 2; ++i) {
+    TestWaitableEvent done;
+    thread_pool_->PostDelayedTask(
+        FROM_HERE, {}, BindLambdaForTesting([&] {
+          const bool on_second_node = IsOnSecondNumaNode();
+          auto task_runner = thread_pool_->CreateSequencedTaskRunner({});
+          task_runner->PostTask(
+              FROM_HERE,
+              BindLambdaForTesting([&done, on_second_node, task_runner] {
+                EXPECT_EQ(on_second_node, IsOnSecondNumaNode());
+                task_runner->PostTask(
+                    FROM_HERE, BindLambdaForTesting([&done, on_second_node] {
+                      EXPECT_EQ(on_second_node, IsOnSecondNumaNode());
+                      done.Signal();
+                    }));
+              }));
+        }),
+        TimeDelta());
+    done.Wait();
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(All, ThreadPoolImplTest, ::testing::Bool());
 
 INSTANTIATE_TEST_SUITE_P(
@@ -47,6 +47,17 @@ ThreadPoolInstance::InitParams::InitParams(size_t max_num_foreground_threads_in,
 
 ThreadPoolInstance::InitParams::~InitParams() = default;
 
+ThreadPoolInstance::TaskLatencyStats::TaskLatencyStats() = default;
+
+ThreadPoolInstance::TaskLatencyStats::TaskLatencyStats(
+    const TaskLatencyStats& other) = default;
+
+ThreadPoolInstance::TaskLatencyStats&
+ThreadPoolInstance::TaskLatencyStats::operator=(const TaskLatencyStats& other) =
+    default;
+
+ThreadPoolInstance::TaskLatencyStats::~TaskLatencyStats() = default;
+
 ThreadPoolInstance::ScopedExecutionFence::ScopedExecutionFence() {
   DCHECK(g_thread_pool);
   g_thread_pool->BeginFence();
@@ -98,8 +109,10 @@ void ThreadPoolInstance::StartWithDefaultParams() {
   // * The system is utilized maximally by foreground threads.
   // * The main thread is assumed to be busy, cap foreground workers at
   //   |num_cores - 1|.
-  const size_t max_num_foreground_threads =
-      static_cast<size_t>(std::max(3, SysInfo::NumberOfProcessors() - 1));
+  // The cores are those allotted to the process, e.g. by a container's CPU
+  // quota, rather than those of the host.
+  const size_t max_num_foreground_threads = static_cast<size_t>(
+      std::max(3, SysInfo::EffectiveNumberOfProcessors() - 1));
   Start({max_num_foreground_threads});
 }
 #endif  // !BUILDFLAG(IS_NACL)
@@ -7,10 +7,12 @@
 
 #include <memory>
 #include <string_view>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/functional/callback.h"
 #include "base/gtest_prod_util.h"
+#include "base/location.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/task/single_thread_task_runner_thread_mode.h"
@@ -76,6 +78,27 @@ class BASE_EXPORT ThreadPoolInstance {
     CommonThreadPoolEnvironment common_thread_pool_environment =
         CommonThreadPoolEnvironment::DEFAULT;
 
+    // Whether the foreground thread group is partitioned into one thread group
+    // per NUMA node, with |max_num_foreground_threads| split evenly between
+    // them. Each thread group's workers run on the processors of its node. A
+    // sequence runs in the thread group of the node it was first scheduled on
+    // (that of the posting worker, or the next node in turn), and only moves to
+    // another node when its own is saturated while the other one is idle.
+    // Ignored on machines with a single NUMA node or an unknown topology (see
+    // SysInfo::NumaNodeProcessors()).
+    bool numa_aware_foreground_thread_groups = false;
+
+    // If non-empty, the logical processors that the workers of the foreground
+    // and utility thread groups, respectively of the background thread group,
+    // are restricted to run on (see
+    // PlatformThread::SetCurrentThreadAffinity()).
+    // E.g. worker groups can be pinned to separate core sets, or kept off the
+    // cores of latency-sensitive threads such as an IO thread (see
+    // Thread::Options::cpu_affinity). NUMA-aware foreground thread groups are
+    // not created when |foreground_worker_processors| is non-empty.
+    std::vector<int> foreground_worker_processors;
+    std::vector<int> background_worker_processors;
+
     // An experiment conducted in July 2019 revealed that on Android, changing
     // the reclaim time from 30 seconds to 5 minutes:
     // - Reduces jank by 5% at 99th percentile
@@ -138,6 +161,36 @@ class BASE_EXPORT ThreadPoolInstance {
     ~ScopedFizzleBlockShutdownTasks();
   };
 
+  // Latency statistics of the sampled tasks posted from the same location with
+  // the same traits. See StartTaskLatencySampling().
+  struct BASE_EXPORT TaskLatencyStats {
+    TaskLatencyStats();
+    TaskLatencyStats(const TaskLatencyStats& other);
+    TaskLatencyStats& operator=(const TaskLatencyStats& other);
+    ~TaskLatencyStats();
+
+    Location posted_from;
+    TaskTraits traits;
+
+    // Number of sampled tasks.
+    size_t num_samples = 0;
+
+    // Time between when a task became ready to run and when it started running.
+    TimeDelta total_queue_time;
+    TimeDelta max_queue_time;
+
+    // Time spent running a task.
+    TimeDelta total_run_time;
+    TimeDelta max_run_time;
+
+    // Time between when a worker was woken up and when it started running its
+    // first task, for the sampled tasks that a worker ran right after waking
+    // up.
+    size_t num_wake_up_samples = 0;
+    TimeDelta total_wake_up_latency;
+    TimeDelta max_wake_up_latency;
+  };
+
   // Destroying a ThreadPoolInstance is not allowed in production; it is always
   // leaked. In tests, it should only be destroyed after JoinForTesting() has
   // returned.
@@ -198,6 +251,22 @@ class BASE_EXPORT ThreadPoolInstance {
   virtual void BeginFizzlingBlockShutdownTasks() = 0;
   virtual void EndFizzlingBlockShutdownTasks() = 0;
 
+  // Starts sampling one task out of |sampling_interval| on each worker to
+  // collect latency statistics per posting location and traits, retrieved with
+  // GetTaskLatencyStats(). If |emit_trace_counters| is true, the queue and run
+  // times of the sampled tasks are also emitted as trace counters in the
+  // "thread_pool_diagnostics" category. Calling this again changes the
+  // parameters without resetting the statistics collected so far.
+  virtual void StartTaskLatencySampling(size_t sampling_interval,
+                                        bool emit_trace_counters) = 0;
+
+  // Stops sampling tasks. The statistics collected so far are kept.
+  virtual void StopTaskLatencySampling() = 0;
+
+  // Returns a snapshot of the statistics collected since the first call to
+  // StartTaskLatencySampling(), in no particular order.
+  virtual std::vector<TaskLatencyStats> GetTaskLatencyStats() const = 0;
+
   // CreateAndStartWithDefaultParams(), Create(), and SetInstance() register a
   // ThreadPoolInstance to handle tasks posted through the thread_pool.h API for
   // this process.
@@ -0,0 +1,385 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "base/barrier_closure.h"
+#include "base/functional/bind.h"
+#include "base/functional/callback.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/single_thread_task_runner.h"
+#include "base/task/task_features.h"
+#include "base/task/thread_pool.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/thread_annotations.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// Unlike thread_pool_perftest.cc, which measures the throughput of posting
+// and running no-op tasks, these benchmarks measure the latencies which users
+// of the ThreadPool observe: how long a task waits between the time it could
+// run and the time it runs. Each story reports percentiles and a histogram of
+// the latencies, with and without work stealing and the delayed task timer
+// wheel, so that these proposals can be evaluated on their tails.
+
+namespace base {
+namespace internal {
+
+namespace {
+
+constexpr char kMetricPrefixThreadPoolLatency[] = "ThreadPoolLatency.";
+constexpr char kMetricLatencyP50[] = "latency_p50";
+constexpr char kMetricLatencyP90[] = "latency_p90";
+constexpr char kMetricLatencyP99[] = "latency_p99";
+constexpr char kMetricLatencyMax[] = "latency_max";
+// The number of latencies in [2^(i-1), 2^i) us for each bucket i, the first
+// bucket counting the latencies under 1us and the last one all the latencies
+// above the second to last.
+constexpr char kMetricLatencyHistogram[] = "latency_histogram_log2_us";
+constexpr size_t kNumHistogramBuckets = 24;
+
+constexpr size_t kNumWorkers = 4;
+
+// Collects latencies from any thread, and reports their distribution.
+class LatencyRecorder {
+ public:
+  LatencyRecorder() = default;
+  LatencyRecorder(const LatencyRecorder&) = delete;
+  LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+  ~LatencyRecorder() = default;
+
+  void Add(TimeDelta latency) {
+    AutoLock auto_lock(lock_);
+    latencies_.push_back(latency);
+  }
+
+  void Report(const std::string& story_name) {
+    AutoLock auto_lock(lock_);
+    ASSERT_FALSE(latencies_.empty());
+    ranges::sort(latencies_);
+    const auto percentile = [this](size_t percent) {
+      lock_.AssertAcquired();
+      return latencies_[std::min(latencies_.size() - 1,
+                                 latencies_.size() * percent / 100)];
+    };
+
+    std::vector<size_t> histogram(kNumHistogramBuckets);
+    for (TimeDelta latency : latencies_) {
+      const uint64_t microseconds =
+          static_cast<uint64_t>(std::max<int64_t>(latency.InMicroseconds(), 0));
+      ++histogram[std::min<size_t>(std::bit_width(microseconds),
+                                   kNumHistogramBuckets - 1)];
+    }
+    std::vector<std::string> histogram_strings;
+    for (size_t count : histogram) {
+      histogram_strings.push_back(NumberToString(count));
+    }
+
+    perf_test::PerfResultReporter reporter(kMetricPrefixThreadPoolLatency,
+                                           story_name);
+    reporter.RegisterImportantMetric(kMetricLatencyP50, "us");
+    reporter.RegisterImportantMetric(kMetricLatencyP99, "us");
+    reporter.RegisterFyiMetric(kMetricLatencyP90, "us");
+    reporter.RegisterFyiMetric(kMetricLatencyMax, "us");
+    reporter.RegisterFyiMetric(kMetricLatencyHistogram, "count");
+    reporter.AddResult(kMetricLatencyP50, percentile(50).InMicrosecondsF());
+    reporter.AddResult(kMetricLatencyP90, percentile(90).InMicrosecondsF());
+    reporter.AddResult(kMetricLatencyP99, percentile(99).InMicrosecondsF());
+    reporter.AddResult(kMetricLatencyMax,
+                       latencies_.back().InMicrosecondsF());
+    reporter.AddResultList(kMetricLatencyHistogram,
+                           JoinString(histogram_strings, ","));
+  }
+
+ private:
+  Lock lock_;
+  std::vector<TimeDelta> latencies_ GUARDED_BY(lock_);
+};
+
+void BusyWait(TimeDelta duration) {
+  const TimeTicks end_time = TimeTicks::Now() + duration;
+  while (TimeTicks::Now() < end_time) {
+  }
+}
+
+// Records the time between `ready_time` and now.
+void RecordLatency(LatencyRecorder* recorder,
+                   TimeTicks ready_time,
+                   OnceClosure done) {
+  recorder->Add(TimeTicks::Now() - ready_time);
+  std::move(done).Run();
+}
+
+// A chain of tasks, each of which posts the next one to the next task runner,
+// round-robin.
+struct TaskChain {
+  std::vector<scoped_refptr<SequencedTaskRunner>> task_runners;
+  size_t num_hops = 0;
+  raw_ptr<LatencyRecorder> recorder = nullptr;
+  OnceClosure done;
+};
+
+void RunTaskChainHop(TaskChain* chain, size_t hop, TimeTicks posted_time) {
+  chain->recorder->Add(TimeTicks::Now() - posted_time);
+  if (hop + 1 == chain->num_hops) {
+    std::move(chain->done).Run();
+    return;
+  }
+  chain->task_runners[(hop + 1) % chain->task_runners.size()]->PostTask(
+      FROM_HERE,
+      BindOnce(&RunTaskChainHop, Unretained(chain), hop + 1, TimeTicks::Now()));
+}
+
+// Keeps a worker busy with a sequence of 1ms tasks until `stop` is set.
+void RunLoad(std::atomic_bool* stop) {
+  BusyWait(Milliseconds(1));
+  if (!stop->load(std::memory_order_relaxed)) {
+    ThreadPool::PostTask(FROM_HERE, BindOnce(&RunLoad, Unretained(stop)));
+  }
+}
+
+void RunBlockingTask(BlockingType blocking_type, TimeDelta duration) {
+  ScopedBlockingCall scoped_blocking_call(FROM_HERE, blocking_type);
+  PlatformThread::Sleep(duration);
+}
+
+}  // namespace
+
+// The parameters are whether work stealing and the delayed task timer wheel
+// are enabled.
+class ThreadPoolLatencyPerfTest
+    : public testing::TestWithParam<std::tuple<bool, bool>> {
+ public:
+  ThreadPoolLatencyPerfTest(const ThreadPoolLatencyPerfTest&) = delete;
+  ThreadPoolLatencyPerfTest& operator=(const ThreadPoolLatencyPerfTest&) =
+      delete;
+
+ protected:
+  ThreadPoolLatencyPerfTest() {
+    feature_list_.InitWithFeatureStates(
+        {{kThreadGroupWorkStealing, work_stealing()},
+         {kDelayedTaskManagerTimerWheel, timer_wheel()}});
+    ThreadPoolInstance::Create("LatencyPerfTest");
+    ThreadPoolInstance::Get()->Start({kNumWorkers});
+  }
+
+  ~ThreadPoolLatencyPerfTest() override {
+    ThreadPoolInstance::Get()->FlushForTesting();
+    ThreadPoolInstance::Get()->JoinForTesting();
+    ThreadPoolInstance::Set(nullptr);
+  }
+
+  bool work_stealing() const { return std::get<0>(GetParam()); }
+  bool timer_wheel() const { return std::get<1>(GetParam()); }
+
+  std::string StoryName(std::string_view story) const {
+    return StrCat({story, work_stealing() ? "_work_stealing" : "",
+                   timer_wheel() ? "_timer_wheel" : ""});
+  }
+
+  // Measures the lateness of delayed tasks, posted over about 200ms,
+  // optionally while all the workers are busy with 1ms tasks.
+  void MeasureDelayedTaskLateness(const std::string& story_name,
+                                  bool with_load) {
+    constexpr size_t kNumDelayedTasks = 200;
+    std::atomic_bool stop_load{false};
+    if (with_load) {
+      for (size_t i = 0; i < kNumWorkers; ++i) {
+        ThreadPool::PostTask(FROM_HERE,
+                             BindOnce(&RunLoad, Unretained(&stop_load)));
+      }
+    }
+
+    LatencyRecorder recorder;
+    WaitableEvent done;
+    RepeatingClosure barrier = BarrierClosure(
+        kNumDelayedTasks, BindOnce(&WaitableEvent::Signal, Unretained(&done)));
+    for (size_t i = 0; i < kNumDelayedTasks; ++i) {
+      const TimeDelta delay = Milliseconds(1 + i % 16);
+      ThreadPool::PostDelayedTask(
+          FROM_HERE, {TaskPriority::USER_BLOCKING},
+          BindOnce(&RecordLatency, Unretained(&recorder),
+                   TimeTicks::Now() + delay, barrier),
+          delay);
+      PlatformThread::Sleep(Milliseconds(1));
+    }
+    done.Wait();
+    stop_load.store(true, std::memory_order_relaxed);
+    ThreadPoolInstance::Get()->FlushForTesting();
+    recorder.Report(story_name);
+  }
+
+  // Measures the latency of short tasks posted while all the workers are in
+  // a `blocking_type` ScopedBlockingCall. The ThreadPool compensates for
+  // WILL_BLOCK calls right away, and for MAY_BLOCK calls after a threshold
+  // longer than these ones.
+  void MeasureBlockingLatency(const std::string& story_name,
+                              BlockingType blocking_type) {
+    constexpr size_t kNumProbes = 20;
+    constexpr TimeDelta kBlockingDuration = Milliseconds(50);
+    constexpr TimeDelta kProbeInterval = Milliseconds(5);
+    // Keeps the workers blocked for 150ms, longer than the probes take.
+    constexpr size_t kNumBlockingTasks = kNumWorkers * 3;
+
+    for (size_t i = 0; i < kNumBlockingTasks; ++i) {
+      ThreadPool::PostTask(
+          FROM_HERE, {MayBlock()},
+          BindOnce(&RunBlockingTask, blocking_type, kBlockingDuration));
+    }
+    // Lets the workers enter the blocking calls.
+    PlatformThread::Sleep(kProbeInterval);
+
+    LatencyRecorder recorder;
+    WaitableEvent done;
+    RepeatingClosure barrier = BarrierClosure(
+        kNumProbes, BindOnce(&WaitableEvent::Signal, Unretained(&done)));
+    for (size_t i = 0; i < kNumProbes; ++i) {
+      ThreadPool::PostTask(FROM_HERE, {TaskPriority::USER_BLOCKING},
+                           BindOnce(&RecordLatency, Unretained(&recorder),
+                                    TimeTicks::Now(), barrier));
+      PlatformThread::Sleep(kProbeInterval);
+    }
+    done.Wait();
+    ThreadPoolInstance::Get()->FlushForTesting();
+    recorder.Report(story_name);
+  }
+
+  // Measures the latency of a task posted to `task_runner` after its workers
+  // went idle.
+  void MeasureWakeUpLatency(const std::string& story_name,
+                            scoped_refptr<TaskRunner> task_runner) {
+    constexpr size_t kNumWakeUps = 50;
+    LatencyRecorder recorder;
+    for (size_t i = 0; i < kNumWakeUps; ++i) {
+      // Longer than the spinning of idle workers, if enabled.
+      PlatformThread::Sleep(Milliseconds(10));
+      WaitableEvent done;
+      task_runner->PostTask(
+          FROM_HERE,
+          BindOnce(&RecordLatency, Unretained(&recorder), TimeTicks::Now(),
+                   BindOnce(&WaitableEvent::Signal, Unretained(&done))));
+      done.Wait();
+    }
+    recorder.Report(story_name);
+  }
+
+ private:
+  test::ScopedFeatureList feature_list_;
+};
+
+// Measures the latency of each hop of chains of tasks which alternate between
+// two sequences and a dedicated thread, with one chain per worker.
+TEST_P(ThreadPoolLatencyPerfTest, TaskChainHops) {
+  constexpr size_t kNumHops = 2000;
+  LatencyRecorder recorder;
+  WaitableEvent done;
+  RepeatingClosure barrier = BarrierClosure(
+      kNumWorkers, BindOnce(&WaitableEvent::Signal, Unretained(&done)));
+
+  std::vector<TaskChain> chains(kNumWorkers);
+  for (TaskChain& chain : chains) {
+    chain.task_runners = {ThreadPool::CreateSequencedTaskRunner({}),
+                          ThreadPool::CreateSequencedTaskRunner({}),
+                          ThreadPool::CreateSingleThreadTaskRunner({})};
+    chain.num_hops = kNumHops;
+    chain.recorder = &recorder;
+    chain.done = barrier;
+  }
+  for (TaskChain& chain : chains) {
+    chain.task_runners[0]->PostTask(
+        FROM_HERE, BindOnce(&RunTaskChainHop, Unretained(&chain), size_t{0},
+                            TimeTicks::Now()));
+  }
+  done.Wait();
+  recorder.Report(StoryName("task_chain_hops"));
+}
+
+TEST_P(ThreadPoolLatencyPerfTest, DelayedTaskLateness) {
+  MeasureDelayedTaskLateness(StoryName("delayed_task_lateness_idle"),
+                             /*with_load=*/false);
+}
+
+TEST_P(ThreadPoolLatencyPerfTest, DelayedTaskLatenessUnderLoad) {
+  MeasureDelayedTaskLateness(StoryName("delayed_task_lateness_under_load"),
+                             /*with_load=*/true);
+}
+
+// Measures how long USER_BLOCKING and BEST_EFFORT tasks wait when they are
+// posted in a burst which keeps all the workers busy.
+TEST_P(ThreadPoolLatencyPerfTest, MixedPriorities) {
+  constexpr size_t kNumTasksPerPriority = 2000;
+  constexpr TimeDelta kTaskDuration = Microseconds(20);
+  LatencyRecorder user_blocking_recorder;
+  LatencyRecorder best_effort_recorder;
+  WaitableEvent done;
+  RepeatingClosure barrier =
+      BarrierClosure(2 * kNumTasksPerPriority,
+                     BindOnce(&WaitableEvent::Signal, Unretained(&done)));
+
+  for (size_t i = 0; i < kNumTasksPerPriority; ++i) {
+    for (auto [priority, recorder] :
+         {std::make_pair(TaskPriority::BEST_EFFORT, &best_effort_recorder),
+          std::make_pair(TaskPriority::USER_BLOCKING,
+                         &user_blocking_recorder)}) {
+      ThreadPool::PostTask(
+          FROM_HERE, {priority},
+          BindOnce(
+              [](LatencyRecorder* recorder, TimeTicks posted_time,
+                 TimeDelta duration, OnceClosure done) {
+                recorder->Add(TimeTicks::Now() - posted_time);
+                BusyWait(duration);
+                std::move(done).Run();
+              },
+              Unretained(recorder), TimeTicks::Now(), kTaskDuration, barrier));
+    }
+  }
+  done.Wait();
+  user_blocking_recorder.Report(StoryName("mixed_priorities_user_blocking"));
+  best_effort_recorder.Report(StoryName("mixed_priorities_best_effort"));
+}
+
+TEST_P(ThreadPoolLatencyPerfTest, WillBlockCompensation) {
+  MeasureBlockingLatency(StoryName("will_block_compensation"),
+                         BlockingType::WILL_BLOCK);
+}
+
+TEST_P(ThreadPoolLatencyPerfTest, MayBlockCompensation) {
+  MeasureBlockingLatency(StoryName("may_block_compensation"),
+                         BlockingType::MAY_BLOCK);
+}
+
+TEST_P(ThreadPoolLatencyPerfTest, WakeUp) {
+  MeasureWakeUpLatency(StoryName("wake_up_worker"),
+                       ThreadPool::CreateTaskRunner({}));
+  MeasureWakeUpLatency(StoryName("wake_up_dedicated_thread"),
+                       ThreadPool::CreateSingleThreadTaskRunner({}));
+}
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         ThreadPoolLatencyPerfTest,
+                         testing::Combine(testing::Bool(), testing::Bool()));
+
+}  // namespace internal
+}  // namespace base
@@ -9,6 +9,8 @@
 #include <atomic>
 #include <memory>
 #include <optional>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #include "base/barrier_closure.h"
@@ -16,8 +18,12 @@
 #include "base/functional/callback.h"
 #include "base/functional/callback_helpers.h"
 #include "base/memory/raw_ptr.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/task/task_features.h"
 #include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -43,6 +49,9 @@ constexpr char kStoryPostRunNoOpManyThreads[] =
     "post_run_noop_tasks_many_threads";
 constexpr char kStoryPostRunBusyManyThreads[] =
     "post_run_busy_tasks_many_threads";
+constexpr char kStoryPostRunFanOutNoOp[] = "post_run_fan_out_noop_tasks";
+constexpr char kStoryPostRunFanOutNoOpWorkStealing[] =
+    "post_run_fan_out_noop_tasks_work_stealing";
 
 perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
   perf_test::PerfResultReporter reporter(kMetricPrefixThreadPool, story_name);
@@ -142,6 +151,34 @@ class ThreadPoolPerfTest : public testing::Test {
     }
   }
 
+  // Posts |num_parent_tasks| tasks which each post |num_child_tasks| no-op
+  // tasks from a worker.
+  void ContinuouslyPostFanOutNoOpTasks(size_t num_parent_tasks,
+                                       size_t num_child_tasks) {
+    scoped_refptr<TaskRunner> task_runner = ThreadPool::CreateTaskRunner({});
+    base::RepeatingClosure child_closure = base::BindRepeating(
+        [](std::atomic_size_t* num_task_pending) { (*num_task_pending)--; },
+        &num_tasks_pending_);
+    base::RepeatingClosure parent_closure = base::BindRepeating(
+        [](TaskRunner* task_runner, const RepeatingClosure& child_closure,
+           size_t num_child_tasks, std::atomic_size_t* num_task_pending,
+           std::atomic_size_t* num_posted_tasks) {
+          for (size_t i = 0; i < num_child_tasks; ++i) {
+            ++(*num_task_pending);
+            ++(*num_posted_tasks);
+            task_runner->PostTask(FROM_HERE, child_closure);
+          }
+          (*num_task_pending)--;
+        },
+        base::RetainedRef(task_runner), child_closure, num_child_tasks,
+        &num_tasks_pending_, &num_posted_tasks_);
+    for (size_t i = 0; i < num_parent_tasks; ++i) {
+      ++num_tasks_pending_;
+      ++num_posted_tasks_;
+      task_runner->PostTask(FROM_HERE, parent_closure);
+    }
+  }
+
  protected:
   ThreadPoolPerfTest() { ThreadPoolInstance::Create("PerfTest"); }
 
@@ -268,5 +305,47 @@ TEST_F(ThreadPoolPerfTest, PostRunBusyTasksManyThreads) {
   Benchmark(kStoryPostRunBusyManyThreads, ExecutionMode::kPostAndRun);
 }
 
+namespace {
+
+// Runs a fan-out workload, in which most tasks are posted from workers, with
+// an increasing number of workers, with and without work stealing.
+class ThreadPoolFanOutPerfTest
+    : public ThreadPoolPerfTest,
+      public testing::WithParamInterface<std::tuple<size_t, bool>> {
+ protected:
+  ThreadPoolFanOutPerfTest() {
+    if (work_stealing()) {
+      feature_list_.InitAndEnableFeature(kThreadGroupWorkStealing);
+    } else {
+      feature_list_.InitAndDisableFeature(kThreadGroupWorkStealing);
+    }
+  }
+
+  size_t num_running_threads() const { return std::get<0>(GetParam()); }
+  bool work_stealing() const { return std::get<1>(GetParam()); }
+
+ private:
+  test::ScopedFeatureList feature_list_;
+};
+
+}  // namespace
+
+TEST_P(ThreadPoolFanOutPerfTest, PostRunFanOutNoOpTasks) {
+  StartThreadPool(
+      num_running_threads(), 1,
+      BindRepeating(&ThreadPoolPerfTest::ContinuouslyPostFanOutNoOpTasks,
+                    Unretained(this), 64, 1000));
+  Benchmark(StrCat({work_stealing() ? kStoryPostRunFanOutNoOpWorkStealing
+                                    : kStoryPostRunFanOutNoOp,
+                    "_", NumberToString(num_running_threads()), "_threads"}),
+            ExecutionMode::kPostAndRun);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    All,
+    ThreadPoolFanOutPerfTest,
+    testing::Combine(testing::Values(1u, 2u, 4u, 8u, 16u, 32u, 64u),
+                     testing::Bool()));
+
 }  // namespace internal
 }  // namespace base
@@ -0,0 +1,80 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/worker_local_queue.h"
+
+#include <utility>
+
+#include "base/check.h"
+#include "base/task/thread_pool/priority_queue.h"
+
+namespace base {
+namespace internal {
+
+WorkerLocalQueue::Entry::Entry(RegisteredTaskSource task_source,
+                               TaskPriority priority)
+    : task_source(std::move(task_source)), priority(priority) {}
+
+WorkerLocalQueue::Entry::Entry(Entry&& other) = default;
+
+WorkerLocalQueue::Entry& WorkerLocalQueue::Entry::operator=(Entry&& other) =
+    default;
+
+WorkerLocalQueue::Entry::~Entry() = default;
+
+WorkerLocalQueue::WorkerLocalQueue(const CheckedLock* predecessor)
+    : lock_(predecessor) {}
+
+WorkerLocalQueue::~WorkerLocalQueue() {
+  DCHECK(IsEmpty());
+}
+
+void WorkerLocalQueue::Push(RegisteredTaskSource task_source,
+                            TaskPriority priority) {
+  DCHECK(task_source);
+  CheckedAutoLock auto_lock(lock_);
+  entries_.emplace_back(std::move(task_source), priority);
+  size_.store(entries_.size(), std::memory_order_relaxed);
+}
+
+RegisteredTaskSource WorkerLocalQueue::PopBack(TaskPriority min_priority,
+                                               TaskPriority* priority) {
+  CheckedAutoLock auto_lock(lock_);
+  if (entries_.empty() || entries_.back().priority < min_priority) {
+    return nullptr;
+  }
+  *priority = entries_.back().priority;
+  RegisteredTaskSource task_source = std::move(entries_.back().task_source);
+  entries_.pop_back();
+  size_.store(entries_.size(), std::memory_order_relaxed);
+  return task_source;
+}
+
+RegisteredTaskSource WorkerLocalQueue::PopFront(TaskPriority min_priority,
+                                                TaskPriority* priority) {
+  CheckedAutoLock auto_lock(lock_);
+  if (entries_.empty() || entries_.front().priority < min_priority) {
+    return nullptr;
+  }
+  *priority = entries_.front().priority;
+  RegisteredTaskSource task_source = std::move(entries_.front().task_source);
+  entries_.pop_front();
+  size_.store(entries_.size(), std::memory_order_relaxed);
+  return task_source;
+}
+
+size_t WorkerLocalQueue::MoveAllTo(PriorityQueue* priority_queue) {
+  CheckedAutoLock auto_lock(lock_);
+  const size_t num_task_sources = entries_.size();
+  for (Entry& entry : entries_) {
+    const TaskSourceSortKey sort_key = entry.task_source->GetSortKey();
+    priority_queue->Push(std::move(entry.task_source), sort_key);
+  }
+  entries_.clear();
+  size_.store(0, std::memory_order_relaxed);
+  return num_task_sources;
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,83 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_THREAD_POOL_WORKER_LOCAL_QUEUE_H_
+#define BASE_TASK_THREAD_POOL_WORKER_LOCAL_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/containers/circular_deque.h"
+#include "base/task/common/checked_lock.h"
+#include "base/task/task_traits.h"
+#include "base/task/thread_pool/task_source.h"
+#include "base/thread_annotations.h"
+
+namespace base {
+namespace internal {
+
+class PriorityQueue;
+
+// A double-ended queue of the TaskSources posted from a worker of a
+// ThreadGroupImpl in work stealing mode. The worker that owns the queue pushes
+// and pops at the back, so that it runs the work it most recently posted while
+// its data is still in cache. Other workers of the thread group steal from the
+// front, taking the oldest work.
+//
+// Unlike the thread group's PriorityQueue, this has its own lock: it is
+// normally only used by its owner, so posting from a worker and running the
+// work it posted doesn't contend with the rest of the thread group. This class
+// is thread-safe.
+class BASE_EXPORT WorkerLocalQueue {
+ public:
+  // |predecessor| is a lock that may be held when the queue is accessed, i.e.
+  // the thread group's lock.
+  explicit WorkerLocalQueue(const CheckedLock* predecessor);
+  WorkerLocalQueue(const WorkerLocalQueue&) = delete;
+  WorkerLocalQueue& operator=(const WorkerLocalQueue&) = delete;
+  ~WorkerLocalQueue();
+
+  // Adds |task_source|, which has |priority|, at the back of the queue.
+  void Push(RegisteredTaskSource task_source, TaskPriority priority);
+
+  // Removes and returns the TaskSource at the back / front of the queue if its
+  // priority is at least |min_priority|, and sets |priority| to its priority.
+  // Returns nullptr otherwise.
+  RegisteredTaskSource PopBack(TaskPriority min_priority,
+                               TaskPriority* priority);
+  RegisteredTaskSource PopFront(TaskPriority min_priority,
+                                TaskPriority* priority);
+
+  // Moves all TaskSources to |priority_queue|, and returns how many there
+  // were.
+  size_t MoveAllTo(PriorityQueue* priority_queue);
+
+  // Returns true if the queue is empty. This does not acquire the lock, and
+  // may thus be out of date as soon as it returns.
+  bool IsEmpty() const { return size_.load(std::memory_order_relaxed) == 0; }
+
+ private:
+  struct Entry {
+    Entry(RegisteredTaskSource task_source, TaskPriority priority);
+    Entry(Entry&& other);
+    Entry& operator=(Entry&& other);
+    ~Entry();
+
+    RegisteredTaskSource task_source;
+    TaskPriority priority;
+  };
+
+  CheckedLock lock_;
+  circular_deque<Entry> entries_ GUARDED_BY(lock_);
+
+  // The size of |entries_|, readable without |lock_|.
+  std::atomic_size_t size_{0};
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_TASK_THREAD_POOL_WORKER_LOCAL_QUEUE_H_
@@ -0,0 +1,122 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/thread_pool/worker_local_queue.h"
+
+#include <utility>
+
+#include "base/functional/callback_helpers.h"
+#include "base/memory/ref_counted.h"
+#include "base/task/common/checked_lock.h"
+#include "base/task/task_traits.h"
+#include "base/task/thread_pool/priority_queue.h"
+#include "base/task/thread_pool/sequence.h"
+#include "base/task/thread_pool/task.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+class WorkerLocalQueueTest : public testing::Test {
+ protected:
+  static scoped_refptr<Sequence> MakeSequenceWithTask(TaskPriority priority) {
+    scoped_refptr<Sequence> sequence = MakeRefCounted<Sequence>(
+        TaskTraits(priority), nullptr, TaskSourceExecutionMode::kParallel);
+    auto transaction = sequence->BeginTransaction();
+    transaction.WillPushImmediateTask();
+    transaction.PushImmediateTask(
+        Task(FROM_HERE, DoNothing(), TimeTicks::Now(), TimeDelta()));
+    return sequence;
+  }
+
+  void Push(scoped_refptr<Sequence> sequence) {
+    const TaskPriority priority = sequence->priority_racy();
+    queue_.Push(RegisteredTaskSource::CreateForTesting(std::move(sequence)),
+                priority);
+  }
+
+  scoped_refptr<Sequence> sequence_a_ =
+      MakeSequenceWithTask(TaskPriority::USER_VISIBLE);
+  scoped_refptr<Sequence> sequence_b_ =
+      MakeSequenceWithTask(TaskPriority::USER_BLOCKING);
+  scoped_refptr<Sequence> sequence_c_ =
+      MakeSequenceWithTask(TaskPriority::USER_VISIBLE);
+
+  CheckedLock predecessor_;
+  WorkerLocalQueue queue_{&predecessor_};
+};
+
+}  // namespace
+
+TEST_F(WorkerLocalQueueTest, PopBackIsLastInFirstOut) {
+  EXPECT_TRUE(queue_.IsEmpty());
+  Push(sequence_a_);
+  Push(sequence_b_);
+  Push(sequence_c_);
+  EXPECT_FALSE(queue_.IsEmpty());
+
+  TaskPriority priority;
+  EXPECT_EQ(sequence_c_,
+            queue_.PopBack(TaskPriority::BEST_EFFORT, &priority).get());
+  EXPECT_EQ(TaskPriority::USER_VISIBLE, priority);
+  EXPECT_EQ(sequence_b_,
+            queue_.PopBack(TaskPriority::BEST_EFFORT, &priority).get());
+  EXPECT_EQ(TaskPriority::USER_BLOCKING, priority);
+  EXPECT_EQ(sequence_a_,
+            queue_.PopBack(TaskPriority::BEST_EFFORT, &priority).get());
+  EXPECT_FALSE(queue_.PopBack(TaskPriority::BEST_EFFORT, &priority));
+  EXPECT_TRUE(queue_.IsEmpty());
+}
+
+TEST_F(WorkerLocalQueueTest, PopFrontIsFirstInFirstOut) {
+  Push(sequence_a_);
+  Push(sequence_b_);
+  Push(sequence_c_);
+
+  TaskPriority priority;
+  EXPECT_EQ(sequence_a_,
+            queue_.PopFront(TaskPriority::BEST_EFFORT, &priority).get());
+  EXPECT_EQ(sequence_b_,
+            queue_.PopFront(TaskPriority::BEST_EFFORT, &priority).get());
+  EXPECT_EQ(sequence_c_,
+            queue_.PopBack(TaskPriority::BEST_EFFORT, &priority).get());
+  EXPECT_TRUE(queue_.IsEmpty());
+}
+
+TEST_F(WorkerLocalQueueTest, MinPriority) {
+  Push(sequence_a_);
+  Push(sequence_b_);
+
+  // The back is USER_BLOCKING, the front USER_VISIBLE.
+  TaskPriority priority;
+  EXPECT_FALSE(queue_.PopFront(TaskPriority::USER_BLOCKING, &priority));
+  EXPECT_EQ(sequence_b_,
+            queue_.PopBack(TaskPriority::USER_BLOCKING, &priority).get());
+  EXPECT_FALSE(queue_.PopBack(TaskPriority::USER_BLOCKING, &priority));
+  EXPECT_EQ(sequence_a_,
+            queue_.PopBack(TaskPriority::USER_VISIBLE, &priority).get());
+}
+
+TEST_F(WorkerLocalQueueTest, MoveAllTo) {
+  Push(sequence_a_);
+  Push(sequence_b_);
+  Push(sequence_c_);
+
+  PriorityQueue priority_queue;
+  EXPECT_EQ(3u, queue_.MoveAllTo(&priority_queue));
+  EXPECT_TRUE(queue_.IsEmpty());
+  EXPECT_EQ(1u, priority_queue.GetNumTaskSourcesWithPriority(
+                    TaskPriority::USER_BLOCKING));
+  EXPECT_EQ(2u, priority_queue.GetNumTaskSourcesWithPriority(
+                    TaskPriority::USER_VISIBLE));
+  EXPECT_EQ(sequence_b_, priority_queue.PopTaskSource().get());
+
+  EXPECT_EQ(0u, queue_.MoveAllTo(&priority_queue));
+}
+
+}  // namespace internal
+}  // namespace base
@@ -253,6 +253,16 @@ bool WorkerThread::ShouldExit() const {
          task_tracker_->IsShutdownComplete();
 }
 
+void WorkerThread::RecordWakeUpRequestTime() {
+  if (!task_tracker_->task_latency_recorder().IsEnabled()) {
+    return;
+  }
+  // Keep the earliest request, which the worker is slowest to honor.
+  TimeTicks expected;
+  wake_up_request_time_.compare_exchange_strong(expected, TimeTicks::Now(),
+                                                std::memory_order_relaxed);
+}
+
 ThreadType WorkerThread::GetDesiredThreadType() const {
   // To avoid shutdown hangs, disallow a type below kNormal during shutdown
   if (task_tracker_->HasShutdownStarted())
@@ -409,6 +419,13 @@ void WorkerThread::RunWorker() {
                       perfetto::TerminatingFlow::FromPointer(
                           reinterpret_cast<void*>(flow_terminator_)));
 
+    const TimeTicks wake_up_request_time =
+        wake_up_request_time_.exchange(TimeTicks(), std::memory_order_relaxed);
+    if (!wake_up_request_time.is_null()) {
+      TaskLatencyRecorder::SetWakeUpLatencyForCurrentThread(
+          TimeTicks::Now() - wake_up_request_time);
+    }
+
     // Don't GetWork() in the case where we woke up for Cleanup().
     if (ShouldExit()) {
       break;
@@ -5,6 +5,8 @@
 #ifndef BASE_TASK_THREAD_POOL_WORKER_THREAD_H_
 #define BASE_TASK_THREAD_POOL_WORKER_THREAD_H_
 
+#include <atomic>
+
 #include "base/base_export.h"
 #include "base/compiler_specific.h"
 #include "base/memory/raw_ptr.h"
@@ -202,6 +204,11 @@ class BASE_EXPORT WorkerThread : public RefCountedThreadSafe<WorkerThread>,
 
   bool ShouldExit() const;
 
+  // Records the time at which this worker is asked to wake up, if task latency
+  // sampling is enabled, to measure how long it takes to wake up. Must be
+  // called by implementations of WakeUp().
+  void RecordWakeUpRequestTime();
+
   // Returns the thread type to use based on the thread type hint, current
   // shutdown state, and platform capabilities.
   ThreadType GetDesiredThreadType() const;
@@ -254,6 +261,10 @@ class BASE_EXPORT WorkerThread : public RefCountedThreadSafe<WorkerThread>,
 
   const TrackedRef<TaskTracker> task_tracker_;
 
+  // The time at which the worker was first asked to wake up since it last
+  // woke up, null if it wasn't. See RecordWakeUpRequestTime().
+  std::atomic<TimeTicks> wake_up_request_time_{TimeTicks()};
+
   // Optional observer notified when a worker enters and exits its main
   // function. Set in Start() and never modified afterwards.
   raw_ptr<WorkerThreadObserver> worker_thread_observer_ = nullptr;
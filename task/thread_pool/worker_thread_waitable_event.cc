@@ -4,10 +4,13 @@
 
 #include "base/task/thread_pool/worker_thread_waitable_event.h"
 
+#include <algorithm>
+
 #include "base/debug/alias.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/task/thread_pool/task_tracker.h"
 #include "base/task/thread_pool/worker_thread_observer.h"
+#include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "base/trace_event/base_tracing.h"
 
@@ -22,8 +25,66 @@
 
 namespace base::internal {
 
+namespace {
+
+// Number of iterations of the spin loop that only check for a wake up, before
+// each iteration also yields the CPU.
+constexpr int kNumSpinsBeforeYield = 64;
+
+}  // namespace
+
 bool WorkerThreadWaitableEvent::Delegate::TimedWait(TimeDelta timeout) {
-  return wake_up_event_.TimedWait(timeout);
+  if (max_spin_duration_.is_zero()) {
+    return wake_up_event_.TimedWait(timeout);
+  }
+
+  // Spin for twice the average wait, if that is short enough for spinning to
+  // likely catch the next wake up.
+  const TimeTicks wait_start = TimeTicks::Now();
+  const TimeDelta spin_duration = 2 * average_wait_duration_;
+  bool was_signaled = false;
+  if (spin_duration.is_positive() && spin_duration <= max_spin_duration_) {
+    was_signaled = Spin(std::min(spin_duration, timeout));
+  }
+  if (!was_signaled) {
+    was_signaled = wake_up_event_.TimedWait(timeout);
+  }
+  RecordWaitDuration(TimeTicks::Now() - wait_start);
+  return was_signaled;
+}
+
+bool WorkerThreadWaitableEvent::Delegate::Spin(TimeDelta spin_duration) {
+  TRACE_EVENT0("base", "WorkerThreadWaitableEvent::Spin");
+  spin_state_.store(SpinState::kSpinning, std::memory_order_seq_cst);
+  const TimeTicks spin_end = TimeTicks::Now() + spin_duration;
+  bool was_signaled = false;
+  int num_spins = 0;
+  do {
+    if (spin_state_.load(std::memory_order_acquire) == SpinState::kWokenUp) {
+      break;
+    }
+    if (++num_spins > kNumSpinsBeforeYield) {
+      // Cleanup() and JoinForTesting() signal |wake_up_event_| directly.
+      if (wake_up_event_.IsSignaled()) {
+        was_signaled = true;
+        break;
+      }
+      PlatformThread::YieldCurrentThread();
+    }
+  } while (TimeTicks::Now() < spin_end);
+  // A WakeUp() that sees kSpinning relies on this to observe kWokenUp. Any
+  // later WakeUp() signals |wake_up_event_|.
+  return spin_state_.exchange(SpinState::kNotSpinning,
+                              std::memory_order_acq_rel) ==
+             SpinState::kWokenUp ||
+         was_signaled;
+}
+
+void WorkerThreadWaitableEvent::Delegate::RecordWaitDuration(
+    TimeDelta wait_duration) {
+  // Capping samples lets the average recover quickly from long waits.
+  wait_duration = std::min(wait_duration, 2 * max_spin_duration_);
+  average_wait_duration_ = (average_wait_duration_ * 7 + wait_duration) / 8;
 }
 
 WorkerThreadWaitableEvent::WorkerThreadWaitableEvent(
@@ -88,7 +149,14 @@ void WorkerThreadWaitableEvent::WakeUp() {
   DCHECK(!should_exit_.IsSet());
   TRACE_EVENT_INSTANT("wakeup.flow", "WorkerThreadWaitableEvent::WakeUp",
                       perfetto::Flow::FromPointer(this));
+  RecordWakeUpRequestTime();
 
+  // A spinning worker notices the wake up without a system call.
+  Delegate::SpinState expected = Delegate::SpinState::kSpinning;
+  if (delegate_->spin_state_.compare_exchange_strong(
+          expected, Delegate::SpinState::kWokenUp, std::memory_order_acq_rel)) {
+    return;
+  }
   delegate_->wake_up_event_.Signal();
 }
 
@@ -7,6 +7,7 @@
 
 #include "base/task/thread_pool/worker_thread.h"
 
+#include <atomic>
 #include <memory>
 
 #include "base/base_export.h"
@@ -24,10 +25,47 @@ class BASE_EXPORT WorkerThreadWaitableEvent : public WorkerThread {
    protected:
     friend WorkerThreadWaitableEvent;
     bool TimedWait(TimeDelta timeout) override;
+
+    // Allows the worker to spin for up to |max_spin_duration| before sleeping
+    // in TimedWait(), so that a WakeUp() shortly after it runs out of work
+    // doesn't pay the latency of waking up a sleeping thread. The duration
+    // adapts to how long the worker recently waited: it doesn't spin if work
+    // usually takes longer than |max_spin_duration| to arrive. Must be called
+    // on the worker thread.
+    void set_max_spin_duration(TimeDelta max_spin_duration) {
+      max_spin_duration_ = max_spin_duration;
+      average_wait_duration_ = max_spin_duration / 2;
+    }
+
     // Event to wake up the thread managed by the WorkerThread whose delegate
     // this is.
     WaitableEvent wake_up_event_{WaitableEvent::ResetPolicy::AUTOMATIC,
                                  WaitableEvent::InitialState::NOT_SIGNALED};
+
+   private:
+    enum class SpinState {
+      kNotSpinning,
+      kSpinning,
+      // WakeUp() was called while spinning, without signaling
+      // |wake_up_event_|.
+      kWokenUp,
+    };
+
+    // Spins for up to |spin_duration|. Returns true if woken up meanwhile.
+    bool Spin(TimeDelta spin_duration);
+
+    // Updates |average_wait_duration_| after a TimedWait() that lasted
+    // |wait_duration|.
+    void RecordWaitDuration(TimeDelta wait_duration);
+
+    // Set by WakeUp() to skip signaling |wake_up_event_| while spinning.
+    std::atomic<SpinState> spin_state_{SpinState::kNotSpinning};
+
+    // Accessed only on the worker thread.
+    TimeDelta max_spin_duration_;
+    // Exponential moving average of recent wait durations, each capped at
+    // twice |max_spin_duration_|.
+    TimeDelta average_wait_duration_;
   };
 
   // Everything is passed to WorkerThread's constructor, except the Delegate.
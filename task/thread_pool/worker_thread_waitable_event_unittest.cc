@@ -1152,5 +1152,53 @@ TYPED_TEST(ThreadPoolWorkerTest, PurgeOnUninteruptedSleep) {
 #endif  // PA_BUILDFLAG(USE_PARTITION_ALLOC_AS_MALLOC) &&
         // PA_CONFIG(THREAD_CACHE_SUPPORTED)
 
+namespace {
+
+// A delegate whose worker spins for a long time before sleeping.
+class SpinningWorkerDelegate
+    : public WorkerThreadDefaultDelegate<WorkerThreadWaitableEvent> {
+ public:
+  SpinningWorkerDelegate() = default;
+  SpinningWorkerDelegate(const SpinningWorkerDelegate&) = delete;
+  SpinningWorkerDelegate& operator=(const SpinningWorkerDelegate&) = delete;
+
+  // WorkerThread::Delegate:
+  void OnMainEntry(WorkerThread* worker) override {
+    set_max_spin_duration(TestTimeouts::action_timeout());
+  }
+  RegisteredTaskSource GetWork(WorkerThread* worker) override {
+    get_work_called_.Signal();
+    return nullptr;
+  }
+
+  TestWaitableEvent get_work_called_{WaitableEvent::ResetPolicy::AUTOMATIC};
+};
+
+}  // namespace
+
+// Verify that a worker that spins before sleeping is woken up by WakeUp(),
+// and exits when joined while spinning.
+TEST(ThreadPoolWorkerWaitableEventTest, WakeUpSpinningWorker) {
+  Thread service_thread("ServiceThread");
+  Thread::Options service_thread_options;
+  service_thread_options.message_pump_type = MessagePumpType::IO;
+  service_thread.StartWithOptions(std::move(service_thread_options));
+  TaskTracker task_tracker;
+
+  auto delegate = std::make_unique<SpinningWorkerDelegate>();
+  SpinningWorkerDelegate* const delegate_raw = delegate.get();
+  auto worker = MakeRefCounted<WorkerThreadWaitableEvent>(
+      ThreadType::kDefault, std::move(delegate), task_tracker.GetTrackedRef(),
+      0);
+  worker->Start(service_thread.task_runner());
+
+  for (int i = 0; i < 10; ++i) {
+    worker->WakeUp();
+    delegate_raw->get_work_called_.Wait();
+  }
+
+  worker->JoinForTesting();
+}
+
 }  // namespace internal
 }  // namespace base
@@ -0,0 +1,344 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/test/perf_benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/perf/perf_result_reporter.h"
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#endif
+
+namespace base {
+
+namespace {
+
+// The 97.5th percentiles of the Student's t-distribution, by degrees of
+// freedom. Beyond the table, the normal distribution is close enough.
+constexpr double kStudentT975[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+constexpr double kNormal975 = 1.960;
+
+double StudentT975(size_t degrees_of_freedom) {
+  DCHECK_GT(degrees_of_freedom, 0u);
+  return degrees_of_freedom <= std::size(kStudentT975)
+             ? kStudentT975[degrees_of_freedom - 1]
+             : kNormal975;
+}
+
+// Returns the `fraction` quantile of `sorted_samples`, interpolated linearly
+// between the closest ranks.
+double Quantile(const std::vector<double>& sorted_samples, double fraction) {
+  DCHECK(!sorted_samples.empty());
+  const double rank = fraction * static_cast<double>(sorted_samples.size() - 1);
+  const size_t lower = static_cast<size_t>(rank);
+  const size_t upper = std::min(lower + 1, sorted_samples.size() - 1);
+  const double weight = rank - static_cast<double>(lower);
+  return sorted_samples[lower] +
+         weight * (sorted_samples[upper] - sorted_samples[lower]);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+constexpr uint64_t kHardwareCounterConfigs[] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+// Opens a disabled counter of `config` for the calling thread, in user space.
+ScopedFD OpenHardwareCounter(uint64_t config) {
+  struct perf_event_attr attr = {};
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  const long fd = syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                          /*group_fd=*/-1, PERF_FLAG_FD_CLOEXEC);
+  if (fd < 0) {
+    VPLOG(1) << "perf_event_open: omitting hardware counter " << config;
+    return ScopedFD();
+  }
+  return ScopedFD(checked_cast<int>(fd));
+}
+
+#endif
+
+}  // namespace
+
+PerfSampleStatistics ComputePerfSampleStatistics(std::vector<double> samples,
+                                                 double outlier_iqr_factor) {
+  PerfSampleStatistics statistics;
+  if (samples.empty()) {
+    return statistics;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  if (outlier_iqr_factor > 0 && samples.size() >= 4) {
+    const double first_quartile = Quantile(samples, 0.25);
+    const double third_quartile = Quantile(samples, 0.75);
+    const double margin =
+        outlier_iqr_factor * (third_quartile - first_quartile);
+    const auto begin = std::lower_bound(samples.begin(), samples.end(),
+                                        first_quartile - margin);
+    const auto end =
+        std::upper_bound(begin, samples.end(), third_quartile + margin);
+    statistics.num_outliers = samples.size() - static_cast<size_t>(end - begin);
+    samples = std::vector<double>(begin, end);
+  }
+
+  const size_t count = samples.size();
+  statistics.num_samples = count;
+  statistics.min = samples.front();
+  statistics.max = samples.back();
+  statistics.median = Quantile(samples, 0.5);
+
+  double sum = 0;
+  for (double sample : samples) {
+    sum += sample;
+  }
+  statistics.mean = sum / static_cast<double>(count);
+  if (count < 2) {
+    return statistics;
+  }
+
+  double sum_of_squares = 0;
+  for (double sample : samples) {
+    sum_of_squares += (sample - statistics.mean) * (sample - statistics.mean);
+  }
+  statistics.stddev =
+      std::sqrt(sum_of_squares / static_cast<double>(count - 1));
+  statistics.confidence_interval_95 =
+      StudentT975(count - 1) * statistics.stddev /
+      std::sqrt(static_cast<double>(count));
+  return statistics;
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+
+HardwarePerfCounters::HardwarePerfCounters() {
+  for (size_t i = 0; i < fds_.size(); ++i) {
+    fds_[i] = OpenHardwareCounter(kHardwareCounterConfigs[i]);
+  }
+}
+
+HardwarePerfCounters::~HardwarePerfCounters() = default;
+
+bool HardwarePerfCounters::IsSupported() const {
+  return ranges::any_of(fds_, &ScopedFD::is_valid);
+}
+
+void HardwarePerfCounters::Start() {
+  for (const ScopedFD& fd : fds_) {
+    if (fd.is_valid()) {
+      ioctl(fd.get(), PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd.get(), PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+HardwarePerfCounters::Values HardwarePerfCounters::Stop() {
+  std::array<std::optional<uint64_t>, 3> values;
+  for (size_t i = 0; i < fds_.size(); ++i) {
+    if (!fds_[i].is_valid()) {
+      continue;
+    }
+    ioctl(fds_[i].get(), PERF_EVENT_IOC_DISABLE, 0);
+    uint64_t value;
+    if (HANDLE_EINTR(read(fds_[i].get(), &value, sizeof(value))) ==
+        static_cast<ssize_t>(sizeof(value))) {
+      values[i] = value;
+    }
+  }
+  return {values[0], values[1], values[2]};
+}
+
+#else
+
+HardwarePerfCounters::HardwarePerfCounters() = default;
+HardwarePerfCounters::~HardwarePerfCounters() = default;
+
+bool HardwarePerfCounters::IsSupported() const {
+  return false;
+}
+
+void HardwarePerfCounters::Start() {}
+
+HardwarePerfCounters::Values HardwarePerfCounters::Stop() {
+  return {};
+}
+
+#endif
+
+PerfBenchmark::PerfBenchmark(std::string metric_prefix, std::string story_name)
+    : PerfBenchmark(std::move(metric_prefix), std::move(story_name), {}) {}
+
+PerfBenchmark::PerfBenchmark(std::string metric_prefix,
+                             std::string story_name,
+                             const Options& options)
+    : metric_prefix_(std::move(metric_prefix)),
+      story_name_(std::move(story_name)),
+      options_(options) {
+  CHECK_GE(options_.warmup_repetitions, 0);
+  CHECK_GT(options_.repetitions, 0);
+}
+
+PerfBenchmark::~PerfBenchmark() = default;
+
+PerfSampleStatistics PerfBenchmark::Run(std::string_view metric,
+                                        FunctionRef<void()> function) {
+  return RunWithSetup(metric, [] {}, function);
+}
+
+PerfSampleStatistics PerfBenchmark::RunWithSetup(
+    std::string_view metric,
+    FunctionRef<void()> setup,
+    FunctionRef<void()> function) {
+  for (int i = 0; i < options_.warmup_repetitions; ++i) {
+    setup();
+    function();
+  }
+
+  std::optional<HardwarePerfCounters> hardware_counters;
+  if (options_.hardware_counters) {
+    hardware_counters.emplace();
+  }
+  // The sums of the counters over the repetitions.
+  HardwarePerfCounters::Values counters;
+  auto accumulate = [](std::optional<uint64_t>& sum,
+                       std::optional<uint64_t> value, bool first) {
+    if (first) {
+      sum = value;
+    } else if (sum && value) {
+      *sum += *value;
+    } else {
+      sum.reset();
+    }
+  };
+
+  std::vector<double> samples;
+  samples.reserve(static_cast<size_t>(options_.repetitions));
+  for (int i = 0; i < options_.repetitions; ++i) {
+    setup();
+    if (hardware_counters) {
+      hardware_counters->Start();
+    }
+    const TimeTicks start = TimeTicks::Now();
+    function();
+    const TimeTicks end = TimeTicks::Now();
+    if (hardware_counters) {
+      const HardwarePerfCounters::Values values = hardware_counters->Stop();
+      accumulate(counters.cycles, values.cycles, i == 0);
+      accumulate(counters.instructions, values.instructions, i == 0);
+      accumulate(counters.cache_misses, values.cache_misses, i == 0);
+    }
+    samples.push_back((end - start).InMillisecondsF());
+  }
+
+  const PerfSampleStatistics statistics =
+      ComputePerfSampleStatistics(samples, options_.outlier_iqr_factor);
+  for (std::optional<uint64_t>* counter :
+       {&counters.cycles, &counters.instructions, &counters.cache_misses}) {
+    if (*counter) {
+      **counter /= static_cast<uint64_t>(options_.repetitions);
+    }
+  }
+  Report(metric, samples, statistics, counters);
+  return statistics;
+}
+
+void PerfBenchmark::Report(std::string_view metric,
+                           const std::vector<double>& samples,
+                           const PerfSampleStatistics& statistics,
+                           const HardwarePerfCounters::Values& counters) {
+  const std::string metric_name(metric);
+  const std::string median_metric = StrCat({metric, "_median"});
+  const std::string outliers_metric = StrCat({metric, "_outliers"});
+  perf_test::PerfResultReporter reporter(metric_prefix_, story_name_);
+  reporter.RegisterImportantMetric(metric_name, "ms");
+  reporter.RegisterFyiMetric(median_metric, "ms");
+  reporter.RegisterFyiMetric(outliers_metric, "count");
+  reporter.AddResultMeanAndError(
+      metric_name, StrCat({NumberToString(statistics.mean), ",",
+                           NumberToString(statistics.confidence_interval_95)}));
+  reporter.AddResult(median_metric, statistics.median);
+  reporter.AddResult(outliers_metric, statistics.num_outliers);
+
+  Value::Dict counters_dict;
+  using NamedCounter = std::pair<const char*, const std::optional<uint64_t>&>;
+  const NamedCounter named_counters[] = {
+      {"cycles", counters.cycles},
+      {"instructions", counters.instructions},
+      {"cache_misses", counters.cache_misses}};
+  for (const auto& [name, value] : named_counters) {
+    if (!value) {
+      continue;
+    }
+    const std::string counter_metric = StrCat({metric, "_", name});
+    reporter.RegisterFyiMetric(counter_metric, "count");
+    reporter.AddResult(counter_metric, static_cast<size_t>(*value));
+    // JSON numbers are doubles, which are exact up to 2^53.
+    counters_dict.Set(name, static_cast<double>(*value));
+  }
+
+  const FilePath json_path =
+      CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          kPerfBenchmarkJsonSwitch);
+  if (json_path.empty()) {
+    return;
+  }
+  Value::List samples_list;
+  for (double sample : samples) {
+    samples_list.Append(sample);
+  }
+  Value::Dict result;
+  result.Set("metric", StrCat({metric_prefix_, metric}));
+  result.Set("story", story_name_);
+  result.Set("units", "ms");
+  result.Set("samples", std::move(samples_list));
+  result.Set("num_outliers", saturated_cast<int>(statistics.num_outliers));
+  result.Set("mean", statistics.mean);
+  result.Set("median", statistics.median);
+  result.Set("stddev", statistics.stddev);
+  result.Set("min", statistics.min);
+  result.Set("max", statistics.max);
+  result.Set("ci95", statistics.confidence_interval_95);
+  result.Set("counters", std::move(counters_dict));
+
+  std::string line;
+  CHECK(JSONWriter::Write(result, &line));
+  line.push_back('\n');
+  File file(json_path, File::FLAG_OPEN_ALWAYS | File::FLAG_APPEND);
+  if (!file.IsValid() ||
+      !file.WriteAtCurrentPosAndCheck(as_byte_span(line))) {
+    LOG(ERROR) << "Failed to write the results to " << json_path;
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,140 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TEST_PERF_BENCHMARK_H_
+#define BASE_TEST_PERF_BENCHMARK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/files/scoped_file.h"
+#include "base/functional/function_ref.h"
+#include "build/build_config.h"
+
+// A layer over perf_test::PerfResultReporter for the perftests whose results
+// gate regressions, where a single timed run is too noisy:
+//
+//   PerfBenchmark benchmark("JSON.", "number_heavy");
+//   benchmark.Run("parse_time", [&] { JSONReader::Read(json); });
+//
+// Run() times a few warmup repetitions, which are discarded, then the
+// measured repetitions. It rejects the outliers, and reports the mean with
+// its 95% confidence interval as the important metric, and the median, the
+// number of outliers and, where perf_event_open() is available, the hardware
+// counters as FYI metrics. Each run is also appended as a line of JSON to the
+// file passed with --perf-benchmark-json=<path>, for the tools which compare
+// the samples of two builds rather than their means.
+
+namespace base {
+
+// The command line switch for the JSON output of PerfBenchmark.
+inline constexpr char kPerfBenchmarkJsonSwitch[] = "perf-benchmark-json";
+
+struct PerfSampleStatistics {
+  // The number of samples kept, and rejected as outliers.
+  size_t num_samples = 0;
+  size_t num_outliers = 0;
+  double mean = 0;
+  double median = 0;
+  // The sample standard deviation.
+  double stddev = 0;
+  double min = 0;
+  double max = 0;
+  // The half-width of the 95% confidence interval of the mean, from the
+  // Student's t-distribution.
+  double confidence_interval_95 = 0;
+};
+
+// Computes the statistics of `samples` without the outliers outside of the
+// Tukey fences [Q1 - k * IQR, Q3 + k * IQR], where k is `outlier_iqr_factor`
+// and IQR is the interquartile range. Outliers are not rejected if k is 0 or
+// if there are fewer than 4 samples.
+PerfSampleStatistics ComputePerfSampleStatistics(std::vector<double> samples,
+                                                 double outlier_iqr_factor);
+
+// Counts the cycles, instructions and cache misses of the calling thread in
+// user space, between Start() and Stop(). The counters which can't be opened,
+// e.g. in a VM or when perf events are disallowed by
+// /proc/sys/kernel/perf_event_paranoid, are nullopt.
+class HardwarePerfCounters {
+ public:
+  struct Values {
+    std::optional<uint64_t> cycles;
+    std::optional<uint64_t> instructions;
+    std::optional<uint64_t> cache_misses;
+  };
+
+  HardwarePerfCounters();
+  HardwarePerfCounters(const HardwarePerfCounters&) = delete;
+  HardwarePerfCounters& operator=(const HardwarePerfCounters&) = delete;
+  ~HardwarePerfCounters();
+
+  // Returns true if at least one counter could be opened.
+  bool IsSupported() const;
+
+  void Start();
+  Values Stop();
+
+ private:
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Indexed like the fields of Values.
+  std::array<ScopedFD, 3> fds_;
+#endif
+};
+
+class PerfBenchmark {
+ public:
+  struct Options {
+    // The repetitions which are run before the measured ones, to warm up the
+    // caches and the allocator.
+    int warmup_repetitions = 2;
+    int repetitions = 10;
+    // See ComputePerfSampleStatistics().
+    double outlier_iqr_factor = 1.5;
+    bool hardware_counters = true;
+  };
+
+  PerfBenchmark(std::string metric_prefix, std::string story_name);
+  PerfBenchmark(std::string metric_prefix,
+                std::string story_name,
+                const Options& options);
+  PerfBenchmark(const PerfBenchmark&) = delete;
+  PerfBenchmark& operator=(const PerfBenchmark&) = delete;
+  ~PerfBenchmark();
+
+  // Runs `function` for the warmup and measured repetitions, and reports the
+  // time of a repetition in ms as `metric`. The FYI metrics are reported as
+  // `metric` followed by "_median", "_outliers", "_cycles", "_instructions"
+  // and "_cache_misses"; the counters are the means per repetition.
+  PerfSampleStatistics Run(std::string_view metric,
+                           FunctionRef<void()> function);
+
+  // Like Run(), but `setup` is called before each repetition, and isn't
+  // timed. Useful when `function` consumes its input.
+  PerfSampleStatistics RunWithSetup(std::string_view metric,
+                                    FunctionRef<void()> setup,
+                                    FunctionRef<void()> function);
+
+ private:
+  // Reports the results of a run to the PerfResultReporter and to the JSON
+  // file.
+  void Report(std::string_view metric,
+              const std::vector<double>& samples,
+              const PerfSampleStatistics& statistics,
+              const HardwarePerfCounters::Values& counters);
+
+  const std::string metric_prefix_;
+  const std::string story_name_;
+  const Options options_;
+};
+
+}  // namespace base
+
+#endif  // BASE_TEST_PERF_BENCHMARK_H_
@@ -0,0 +1,92 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/test/perf_benchmark.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(PerfSampleStatisticsTest, Empty) {
+  const PerfSampleStatistics statistics = ComputePerfSampleStatistics({}, 1.5);
+  EXPECT_EQ(0u, statistics.num_samples);
+  EXPECT_EQ(0u, statistics.num_outliers);
+}
+
+TEST(PerfSampleStatisticsTest, SingleSample) {
+  const PerfSampleStatistics statistics =
+      ComputePerfSampleStatistics({4.0}, 1.5);
+  EXPECT_EQ(1u, statistics.num_samples);
+  EXPECT_DOUBLE_EQ(4.0, statistics.mean);
+  EXPECT_DOUBLE_EQ(4.0, statistics.median);
+  EXPECT_DOUBLE_EQ(0.0, statistics.stddev);
+  EXPECT_DOUBLE_EQ(0.0, statistics.confidence_interval_95);
+}
+
+TEST(PerfSampleStatisticsTest, MeanAndConfidenceInterval) {
+  const PerfSampleStatistics statistics =
+      ComputePerfSampleStatistics({5.0, 1.0, 4.0, 2.0, 3.0}, 1.5);
+  EXPECT_EQ(5u, statistics.num_samples);
+  EXPECT_EQ(0u, statistics.num_outliers);
+  EXPECT_DOUBLE_EQ(3.0, statistics.mean);
+  EXPECT_DOUBLE_EQ(3.0, statistics.median);
+  EXPECT_DOUBLE_EQ(1.0, statistics.min);
+  EXPECT_DOUBLE_EQ(5.0, statistics.max);
+  // The sample variance is 10 / 4.
+  EXPECT_NEAR(1.5811, statistics.stddev, 1e-4);
+  // t(0.975, 4) * stddev / sqrt(5).
+  EXPECT_NEAR(1.9632, statistics.confidence_interval_95, 1e-3);
+}
+
+TEST(PerfSampleStatisticsTest, EvenNumberOfSamples) {
+  const PerfSampleStatistics statistics =
+      ComputePerfSampleStatistics({1.0, 2.0, 3.0, 10.0}, 0);
+  EXPECT_DOUBLE_EQ(2.5, statistics.median);
+  EXPECT_DOUBLE_EQ(4.0, statistics.mean);
+}
+
+TEST(PerfSampleStatisticsTest, RejectsOutliers) {
+  std::vector<double> samples = {10.0, 11.0, 10.5, 10.2, 10.8,
+                                 10.1, 10.4, 10.6, 50.0, 1.0};
+  PerfSampleStatistics statistics = ComputePerfSampleStatistics(samples, 1.5);
+  EXPECT_EQ(8u, statistics.num_samples);
+  EXPECT_EQ(2u, statistics.num_outliers);
+  EXPECT_DOUBLE_EQ(10.0, statistics.min);
+  EXPECT_DOUBLE_EQ(11.0, statistics.max);
+
+  // A factor of 0 keeps all the samples.
+  statistics = ComputePerfSampleStatistics(samples, 0);
+  EXPECT_EQ(10u, statistics.num_samples);
+  EXPECT_EQ(0u, statistics.num_outliers);
+  EXPECT_DOUBLE_EQ(50.0, statistics.max);
+}
+
+TEST(PerfSampleStatisticsTest, KeepsIdenticalSamples) {
+  const PerfSampleStatistics statistics =
+      ComputePerfSampleStatistics({2.0, 2.0, 2.0, 2.0, 2.0}, 1.5);
+  EXPECT_EQ(5u, statistics.num_samples);
+  EXPECT_EQ(0u, statistics.num_outliers);
+  EXPECT_DOUBLE_EQ(0.0, statistics.stddev);
+}
+
+TEST(HardwarePerfCountersTest, StartAndStop) {
+  HardwarePerfCounters counters;
+  counters.Start();
+  volatile int sum = 0;
+  for (int i = 0; i < 1000; ++i) {
+    sum = sum + i;
+  }
+  const HardwarePerfCounters::Values values = counters.Stop();
+  if (!counters.IsSupported()) {
+    EXPECT_FALSE(values.cycles);
+    EXPECT_FALSE(values.instructions);
+    EXPECT_FALSE(values.cache_misses);
+  } else if (values.instructions) {
+    EXPECT_GT(*values.instructions, 0u);
+  }
+}
+
+}  // namespace base
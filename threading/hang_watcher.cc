@@ -5,6 +5,7 @@
 #include "base/threading/hang_watcher.h"
 
 #include <atomic>
+#include <cinttypes>
 #include <utility>
 
 #include "base/containers/flat_map.h"
@@ -18,8 +19,14 @@
 #include "base/metrics/field_trial_params.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/power_monitor/power_monitor.h"
+#include "base/profiler/frame.h"
+#include "base/profiler/module_cache.h"
+#include "base/profiler/profile_builder.h"
+#include "base/profiler/stack_buffer.h"
+#include "base/profiler/stack_sampler.h"
 #include "base/ranges/algorithm.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/platform_thread.h"
@@ -57,6 +64,56 @@ std::atomic<LoggingLevel> g_main_thread_log_level{LoggingLevel::kNone};
 // Indicates whether HangWatcher::Run() should return after the next monitoring.
 std::atomic<bool> g_keep_monitoring{true};
 
+// Whether WatchHangsInScope computes deadlines from |g_coarse_now| rather than
+// from TimeTicks::Now(). See HangWatcher::IsCoarseDeadlineTrackingEnabled().
+std::atomic<bool> g_use_coarse_deadlines{false};
+
+// Whether the stacks of hung threads are captured with a StackSampler when a
+// hang is recorded.
+std::atomic<bool> g_capture_hung_thread_stacks{false};
+
+// The internal value of the time at which the HangWatcher thread last woke up,
+// and the longest time that can elapse until it wakes up again. Zero until the
+// HangWatcher thread starts waiting.
+std::atomic<int64_t> g_coarse_now{0};
+std::atomic<int64_t> g_coarse_now_slack{0};
+
+// Returns a time which is guaranteed not to be before TimeTicks::Now() while
+// the HangWatcher thread keeps monitoring in a timely way.
+TimeTicks GetCoarseNow() {
+  const int64_t coarse_now = g_coarse_now.load(std::memory_order_relaxed);
+  if (coarse_now == 0) {
+    return TimeTicks::Now();
+  }
+  return TimeTicks::FromInternalValue(
+      coarse_now + g_coarse_now_slack.load(std::memory_order_relaxed));
+}
+
+#if !BUILDFLAG(IS_NACL) && !BUILDFLAG(IS_ANDROID)
+// Keeps the frames of the single sample taken of a hung thread.
+class HungThreadProfileBuilder : public ProfileBuilder {
+ public:
+  explicit HungThreadProfileBuilder(ModuleCache* module_cache)
+      : module_cache_(module_cache) {}
+
+  ModuleCache* GetModuleCache() override { return module_cache_; }
+
+  void OnSampleCompleted(std::vector<Frame> frames,
+                         TimeTicks sample_timestamp) override {
+    frames_ = std::move(frames);
+  }
+
+  void OnProfileCompleted(TimeDelta profile_duration,
+                          TimeDelta sampling_period) override {}
+
+  const std::vector<Frame>& frames() const { return frames_; }
+
+ private:
+  const raw_ptr<ModuleCache> module_cache_;
+  std::vector<Frame> frames_;
+};
+#endif  // !BUILDFLAG(IS_NACL) && !BUILDFLAG(IS_ANDROID)
+
 // Emits the hung thread count histogram. |count| is the number of threads
 // of type |thread_type| that were hung or became hung during the last
 // monitoring window. This function should be invoked for each thread type
@@ -179,6 +236,12 @@ constexpr base::FeatureParam<int> kThreadPoolLogLevel{
     &kEnableHangWatcher, "threadpool_log_level",
     static_cast<int>(LoggingLevel::kUmaOnly)};
 
+// All processes.
+constexpr base::FeatureParam<bool> kCoarseDeadlines{
+    &kEnableHangWatcher, "coarse_deadlines", false};
+constexpr base::FeatureParam<bool> kCaptureHungThreadStacks{
+    &kEnableHangWatcher, "capture_hung_thread_stacks", false};
+
 // GPU process.
 constexpr base::FeatureParam<int> kGPUProcessIOThreadLogLevel{
     &kEnableHangWatcher, "gpu_process_io_thread_log_level",
@@ -252,7 +315,11 @@ WatchHangsInScope::WatchHangsInScope(TimeDelta timeout) {
   // and resuing the value.
 
   previous_deadline_ = old_deadline;
-  TimeTicks deadline = TimeTicks::Now() + timeout;
+  TimeTicks deadline =
+      (g_use_coarse_deadlines.load(std::memory_order_relaxed)
+           ? GetCoarseNow()
+           : TimeTicks::Now()) +
+      timeout;
   current_hang_watch_state->SetDeadline(deadline);
   current_hang_watch_state->IncrementNestingLevel();
 
@@ -356,6 +423,11 @@ void HangWatcher::InitializeOnMainThread(ProcessType process_type,
   if (!enable_hang_watcher)
     return;
 
+  g_use_coarse_deadlines.store(kCoarseDeadlines.Get(),
+                               std::memory_order_relaxed);
+  g_capture_hung_thread_stacks.store(kCaptureHungThreadStacks.Get(),
+                                     std::memory_order_relaxed);
+
   // Retrieve thread-specific config for hang watching.
   if (process_type == HangWatcher::ProcessType::kBrowserProcess) {
     // Crashes are set to always emit. Override any feature flags.
@@ -416,6 +488,8 @@ void HangWatcher::UnitializeOnMainThreadForTesting() {
   g_threadpool_log_level.store(LoggingLevel::kNone, std::memory_order_relaxed);
   g_io_thread_log_level.store(LoggingLevel::kNone, std::memory_order_relaxed);
   g_main_thread_log_level.store(LoggingLevel::kNone, std::memory_order_relaxed);
+  g_use_coarse_deadlines.store(false, std::memory_order_relaxed);
+  g_capture_hung_thread_stacks.store(false, std::memory_order_relaxed);
 }
 
 // static
@@ -423,6 +497,16 @@ bool HangWatcher::IsEnabled() {
   return g_use_hang_watcher.load(std::memory_order_relaxed);
 }
 
+// static
+bool HangWatcher::IsCoarseDeadlineTrackingEnabled() {
+  return g_use_coarse_deadlines.load(std::memory_order_relaxed);
+}
+
+// static
+bool HangWatcher::IsHungThreadStackCaptureEnabled() {
+  return g_capture_hung_thread_stacks.load(std::memory_order_relaxed);
+}
+
 // static
 bool HangWatcher::IsThreadPoolHangWatchingEnabled() {
   return g_threadpool_log_level.load(std::memory_order_relaxed) !=
@@ -563,6 +647,7 @@ void HangWatcher::Start() {
 
 void HangWatcher::Stop() {
   g_keep_monitoring.store(false, std::memory_order_relaxed);
+  g_coarse_now.store(0, std::memory_order_relaxed);
   should_monitor_.Signal();
   thread_.Join();
   thread_started_ = false;
@@ -594,6 +679,7 @@ void HangWatcher::Wait() {
 
     const base::TimeTicks time_after_wait = tick_clock_->NowTicks();
     const base::TimeDelta wait_time = time_after_wait - time_before_wait;
+    PublishCoarseNow();
     const bool wait_was_normal =
         wait_time <= (monitor_period_ + kWaitDriftTolerance);
 
@@ -631,11 +717,31 @@ void HangWatcher::Wait() {
   }
 }
 
+void HangWatcher::PublishCoarseNow() {
+  // Amount by which the actual time spent sleeping can deviate from the
+  // target time and still be considered timely. Must match Wait().
+  constexpr base::TimeDelta kWaitDriftTolerance = base::Milliseconds(100);
+
+  // Deadlines are compared to TimeTicks::Now() in WatchStateSnapShot::Init(),
+  // so the coarse clock is based on it rather than on |tick_clock_|. Until the
+  // next wake up, TimeTicks::Now() can get ahead of the published time by up
+  // to a monitoring period, which is accounted for by the slack so that
+  // coarse deadlines are never earlier than precise ones. Wake ups that are
+  // later than that are already handled by Wait().
+  g_coarse_now_slack.store(
+      (monitor_period_ + kWaitDriftTolerance).InMicroseconds(),
+      std::memory_order_relaxed);
+  g_coarse_now.store(TimeTicks::Now().ToInternalValue(),
+                     std::memory_order_relaxed);
+}
+
 void HangWatcher::Run() {
   // Monitor() should only run on |thread_|. Bind |thread_checker_| here to make
   // sure of that.
   DCHECK_CALLED_ON_VALID_THREAD(hang_watcher_thread_checker_);
 
+  PublishCoarseNow();
+
   while (g_keep_monitoring.load(std::memory_order_relaxed)) {
     Wait();
 
@@ -782,8 +888,9 @@ void HangWatcher::WatchStateSnapShot::Init(
       // the next capture then they'll already be marked and will be included
       // in the capture at that time.
       if (thread_marked && all_threads_marked) {
-        hung_watch_state_copies_.push_back(
-            WatchStateCopy{deadline, watch_state.get()->GetThreadID()});
+        hung_watch_state_copies_.push_back(WatchStateCopy{
+            deadline, watch_state.get()->GetThreadID(),
+            watch_state.get()->GetSamplingProfilerThreadToken()});
       } else {
         all_threads_marked = false;
       }
@@ -943,6 +1050,16 @@ void HangWatcher::DoDumpWithoutCrashing(
   base::TimeTicks latest_expired_deadline =
       watch_state_snapshot.GetHighestDeadline();
 
+#if !BUILDFLAG(IS_NACL) && !BUILDFLAG(IS_ANDROID)
+  static debug::CrashKeyString* stacks_crash_key = AllocateCrashKeyString(
+      "hung-thread-stacks", debug::CrashKeySize::Size1024);
+
+  const debug::ScopedCrashKeyString hung_thread_stacks_crash_key_string(
+      stacks_crash_key, IsHungThreadStackCaptureEnabled()
+                            ? CaptureHungThreadStacks(watch_state_snapshot)
+                            : std::string());
+#endif
+
   if (on_hang_closure_for_testing_)
     on_hang_closure_for_testing_.Run();
   else
@@ -954,6 +1071,67 @@ void HangWatcher::DoDumpWithoutCrashing(
   capture_in_progress_.store(false, std::memory_order_relaxed);
 }
 
+#if !BUILDFLAG(IS_NACL) && !BUILDFLAG(IS_ANDROID)
+std::string HangWatcher::CaptureHungThreadStacks(
+    const WatchStateSnapShot& watch_state_snapshot) {
+  TRACE_EVENT("base", "HangWatcher::CaptureHungThreadStacks");
+
+  // Threads are listed by decreasing hang severity, so stop as soon as one
+  // doesn't fit, like PrepareHungThreadListCrashKey().
+  constexpr size_t kMaxSize =
+      static_cast<size_t>(debug::CrashKeySize::Size1024);
+  std::string hung_thread_stacks;
+  ModuleCache module_cache;
+  std::unique_ptr<StackBuffer> stack_buffer;
+
+  for (const WatchStateSnapShot::WatchStateCopy& copy :
+       watch_state_snapshot.hung_watch_state_copies()) {
+    if (!copy.thread_token) {
+      continue;
+    }
+    std::unique_ptr<StackSampler> sampler = StackSampler::Create(
+        *copy.thread_token, &module_cache, StackSampler::UnwindersFactory(),
+        RepeatingClosure(), nullptr);
+    if (!sampler) {
+      // Sampling isn't supported on this platform.
+      break;
+    }
+    if (!stack_buffer) {
+      stack_buffer = StackSampler::CreateStackBuffer();
+      if (!stack_buffer) {
+        break;
+      }
+    }
+
+    sampler->Initialize();
+    HungThreadProfileBuilder profile_builder(&module_cache);
+    sampler->RecordStackFrames(stack_buffer.get(), &profile_builder,
+                               copy.thread_id);
+
+    // Formatted as "<thread id>:<module>+<offset> <module>+<offset>...|".
+    std::string fragment = NumberToString(copy.thread_id) + ':';
+    for (const Frame& frame : profile_builder.frames()) {
+      if (frame.module) {
+        StringAppendF(&fragment, "%s+0x%" PRIxPTR " ",
+                      frame.module->GetDebugBasename().MaybeAsASCII().c_str(),
+                      frame.instruction_pointer -
+                          frame.module->GetBaseAddress());
+      } else {
+        StringAppendF(&fragment, "0x%" PRIxPTR " ", frame.instruction_pointer);
+      }
+    }
+    fragment += '|';
+
+    if (hung_thread_stacks.size() + fragment.size() >= kMaxSize) {
+      break;
+    }
+    hung_thread_stacks += fragment;
+  }
+
+  return hung_thread_stacks;
+}
+#endif  // !BUILDFLAG(IS_NACL) && !BUILDFLAG(IS_ANDROID)
+
 void HangWatcher::SetAfterMonitorClosureForTesting(
     base::RepeatingClosure closure) {
   DCHECK_CALLED_ON_VALID_THREAD(constructing_thread_checker_);
@@ -1193,6 +1371,11 @@ HangWatchState::HangWatchState(HangWatcher::ThreadType thread_type)
 #else
   thread_id_ = PlatformThread::CurrentId();
 #endif
+  // Only the watched thread can get its token, and getting it can be costly on
+  // some platforms, so only do it when it's going to be used.
+  if (HangWatcher::IsHungThreadStackCaptureEnabled()) {
+    thread_token_ = GetSamplingProfilerCurrentThreadToken();
+  }
 }
 
 HangWatchState::~HangWatchState() {
@@ -1295,6 +1478,11 @@ PlatformThreadId HangWatchState::GetThreadID() const {
   return thread_id_;
 }
 
+const std::optional<SamplingProfilerThreadToken>&
+HangWatchState::GetSamplingProfilerThreadToken() const {
+  return thread_token_;
+}
+
 }  // namespace internal
 
 }  // namespace base
@@ -8,6 +8,8 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -24,6 +26,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/memory/raw_ptr.h"
+#include "base/profiler/sampling_profiler_thread_token.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/thread_annotations.h"
@@ -162,6 +165,19 @@ class BASE_EXPORT HangWatcher : public DelegateSimpleThread::Delegate {
   // before InitializeOnMainThread returns the default value which is false.
   static bool IsEnabled();
   static bool IsThreadPoolHangWatchingEnabled();
+
+  // Returns true if WatchHangsInScope computes deadlines from a coarse clock
+  // published by the HangWatcher thread whenever it wakes up, rather than by
+  // reading the clock itself. This moves the cost of reading the clock out of
+  // every scope entry, in exchange for hangs being detected up to one
+  // monitoring period later. Deadlines are never earlier than in the default
+  // mode, so no additional hangs are reported.
+  static bool IsCoarseDeadlineTrackingEnabled();
+
+  // Returns true if the stacks of hung threads are captured with a
+  // StackSampler, and added to the hang report in the "hung-thread-stacks"
+  // crash key, on platforms which support stack sampling.
+  static bool IsHungThreadStackCaptureEnabled();
   static bool IsIOThreadHangWatchingEnabled();
 
   // Returns true if crash dump reporting is configured for any thread type.
@@ -289,6 +305,8 @@ class BASE_EXPORT HangWatcher : public DelegateSimpleThread::Delegate {
     struct WatchStateCopy {
       base::TimeTicks deadline;
       base::PlatformThreadId thread_id;
+      // Only set if IsHungThreadStackCaptureEnabled().
+      std::optional<SamplingProfilerThreadToken> thread_token;
     };
 
     WatchStateSnapShot();
@@ -328,6 +346,13 @@ class BASE_EXPORT HangWatcher : public DelegateSimpleThread::Delegate {
     // report and false if not. Can only be called after Init().
     bool IsActionable() const;
 
+    // Returns the hung threads, by order of decreasing hang severity. Can only
+    // be called after Init().
+    const std::vector<WatchStateCopy>& hung_watch_state_copies() const {
+      DCHECK(initialized_);
+      return hung_watch_state_copies_;
+    }
+
    private:
     bool initialized_ = false;
     std::vector<WatchStateCopy> hung_watch_state_copies_;
@@ -349,6 +374,17 @@ class BASE_EXPORT HangWatcher : public DelegateSimpleThread::Delegate {
   void DoDumpWithoutCrashing(const WatchStateSnapShot& watch_state_snapshot)
       EXCLUSIVE_LOCKS_REQUIRED(watch_state_lock_) LOCKS_EXCLUDED(capture_lock_);
 
+#if !BUILDFLAG(IS_NACL) && !BUILDFLAG(IS_ANDROID)
+  // Samples the stacks of the threads in |watch_state_snapshot| and returns
+  // them formatted for the "hung-thread-stacks" crash key.
+  std::string CaptureHungThreadStacks(
+      const WatchStateSnapShot& watch_state_snapshot);
+#endif
+
+  // Publishes the current time for WatchHangsInScope to use in the coarse
+  // deadline mode. Called on the HangWatcher thread.
+  void PublishCoarseNow();
+
   // Stop all monitoring and join the HangWatcher thread.
   void Stop();
 
@@ -551,7 +587,12 @@ class BASE_EXPORT HangWatchDeadline {
   // Binary format: 0xFFDDDDDDDDDDDDDDDD
   // F = Flags
   // D = Deadline
-  std::atomic<BitsType> bits_{static_cast<uint64_t>(Max().ToInternalValue())};
+  //
+  // Aligned to a cache line, so that the stores of the watched thread at every
+  // scope entry and exit don't contend with unrelated data accessed by other
+  // threads.
+  alignas(64) std::atomic<BitsType> bits_{
+      static_cast<uint64_t>(Max().ToInternalValue())};
 
   RepeatingCallback<uint64_t(void)> switch_bits_callback_for_testing_;
 
@@ -632,6 +673,11 @@ class BASE_EXPORT HangWatchState {
 
   PlatformThreadId GetThreadID() const;
 
+  // Returns the token to sample the stack of the thread under watch, if stack
+  // capture is enabled.
+  const std::optional<SamplingProfilerThreadToken>&
+  GetSamplingProfilerThreadToken() const;
+
   // Retrieve the current hang watch deadline directly. For testing only.
   HangWatchDeadline* GetHangWatchDeadlineForTesting();
 
@@ -662,6 +708,9 @@ class BASE_EXPORT HangWatchState {
   // only.
   PlatformThreadId thread_id_;
 
+  // See GetSamplingProfilerThreadToken().
+  std::optional<SamplingProfilerThreadToken> thread_token_;
+
   // Number of active HangWatchScopeEnables on this thread.
   int nesting_level_ = 0;
 
@@ -210,6 +210,60 @@ class HangWatcherTest : public testing::Test {
   HangWatcher hang_watcher_;
 };
 
+class HangWatcherCoarseDeadlineTest : public testing::Test {
+ public:
+  const base::TimeDelta kTimeout = base::Seconds(10);
+
+  HangWatcherCoarseDeadlineTest() {
+    feature_list_.InitAndEnableFeatureWithParameters(
+        base::kEnableHangWatcher, {{"ui_thread_log_level", "2"},
+                                   {"coarse_deadlines", "true"},
+                                   {"capture_hung_thread_stacks", "true"}});
+    HangWatcher::InitializeOnMainThread(
+        HangWatcher::ProcessType::kBrowserProcess, false,
+        /*emit_crashes=*/true);
+
+    hang_watcher_.SetAfterMonitorClosureForTesting(base::BindRepeating(
+        &WaitableEvent::Signal, base::Unretained(&monitor_event_)));
+    hang_watcher_.SetMonitoringPeriodForTesting(kVeryLongDelta);
+    hang_watcher_.Start();
+  }
+
+  void TearDown() override { HangWatcher::UnitializeOnMainThreadForTesting(); }
+
+  HangWatcherCoarseDeadlineTest(const HangWatcherCoarseDeadlineTest& other) =
+      delete;
+  HangWatcherCoarseDeadlineTest& operator=(
+      const HangWatcherCoarseDeadlineTest& other) = delete;
+
+ protected:
+  WaitableEvent monitor_event_;
+  base::test::ScopedFeatureList feature_list_;
+  HangWatcher hang_watcher_;
+};
+
+TEST_F(HangWatcherCoarseDeadlineTest, DeadlineIsNeverEarly) {
+  ASSERT_TRUE(HangWatcher::IsCoarseDeadlineTrackingEnabled());
+  EXPECT_TRUE(HangWatcher::IsHungThreadStackCaptureEnabled());
+
+  base::ScopedClosureRunner unregister_thread_closure =
+      HangWatcher::RegisterThread(base::HangWatcher::ThreadType::kMainThread);
+  internal::HangWatchState* const state =
+      internal::HangWatchState::GetHangWatchStateForCurrentThread();
+  ASSERT_TRUE(state);
+  EXPECT_TRUE(state->GetSamplingProfilerThreadToken().has_value());
+
+  // Make sure the HangWatcher thread published the coarse time at least once.
+  hang_watcher_.SignalMonitorEventForTesting();
+  monitor_event_.Wait();
+
+  const TimeTicks precise_deadline = TimeTicks::Now() + kTimeout;
+  WatchHangsInScope scope(kTimeout);
+  // The deadline accounts for the time until the next monitoring, which is
+  // very long here.
+  EXPECT_GT(state->GetDeadline(), precise_deadline + kVeryLongDelta / 2);
+}
+
 class HangWatcherBlockingThreadTest : public HangWatcherTest {
  public:
   HangWatcherBlockingThreadTest() : thread_(&unblock_thread_, kTimeout) {}
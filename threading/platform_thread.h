@@ -14,8 +14,10 @@
 #include <iosfwd>
 #include <optional>
 #include <type_traits>
+#include <vector>
 
 #include "base/base_export.h"
+#include "base/containers/span.h"
 #include "base/message_loop/message_pump_type.h"
 #include "base/process/process_handle.h"
 #include "base/sequence_checker_impl.h"
@@ -265,6 +267,21 @@ class BASE_EXPORT PlatformThreadBase {
   // underlying priority successfully changed or not.
   static ThreadType GetCurrentThreadType();
 
+  // Restricts the current thread to run on the logical processors listed in
+  // `processors`, numbered from 0 to SysInfo::NumberOfProcessors() - 1, e.g. to
+  // keep latency-sensitive threads off the cores used by worker threads.
+  // Returns false if the affinity couldn't be changed, e.g. because none of
+  // `processors` is available to the process, or because the platform doesn't
+  // support thread affinity (only Linux, ChromeOS, Android and Windows do). On
+  // Windows, only the first 64 processors can be used. Unlike the thread type,
+  // the affinity is inherited by threads created by the current thread on
+  // Linux, ChromeOS and Android.
+  static bool SetCurrentThreadAffinity(span<const int> processors);
+
+  // Returns the logical processors the current thread is allowed to run on, in
+  // increasing order, or an empty vector if this is unknown.
+  static std::vector<int> GetCurrentThreadAffinity();
+
   // Returns a realtime period provided by `delegate`.
   static TimeDelta GetRealtimePeriod(Delegate* delegate);
 
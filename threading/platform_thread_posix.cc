@@ -13,8 +13,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <memory>
 #include <tuple>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/lazy_instance.h"
@@ -416,6 +418,53 @@ ThreadPriorityForTest PlatformThreadBase::GetCurrentThreadPriorityForTest() {
 
 #endif  // !BUILDFLAG(IS_APPLE) && !BUILDFLAG(IS_FUCHSIA)
 
+// static
+bool PlatformThreadBase::SetCurrentThreadAffinity(span<const int> processors) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (processors.empty()) {
+    return false;
+  }
+  const int max_processor =
+      *std::max_element(processors.begin(), processors.end());
+  DCHECK_GE(*std::min_element(processors.begin(), processors.end()), 0);
+  cpu_set_t* cpu_set = CPU_ALLOC(max_processor + 1);
+  const size_t cpu_set_size = CPU_ALLOC_SIZE(max_processor + 1);
+  CPU_ZERO_S(cpu_set_size, cpu_set);
+  for (int processor : processors) {
+    CPU_SET_S(processor, cpu_set_size, cpu_set);
+  }
+  const bool success = sched_setaffinity(0, cpu_set_size, cpu_set) == 0;
+  CPU_FREE(cpu_set);
+  return success;
+#else
+  return false;
+#endif
+}
+
+// static
+std::vector<int> PlatformThreadBase::GetCurrentThreadAffinity() {
+  std::vector<int> processors;
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  const long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+  if (num_cpus <= 0) {
+    return processors;
+  }
+  // The kernel's mask may be larger than the number of configured processors.
+  const int max_cpus = std::max(static_cast<int>(num_cpus), CPU_SETSIZE);
+  cpu_set_t* cpu_set = CPU_ALLOC(max_cpus);
+  const size_t cpu_set_size = CPU_ALLOC_SIZE(max_cpus);
+  if (sched_getaffinity(0, cpu_set_size, cpu_set) == 0) {
+    for (int cpu = 0; cpu < max_cpus; ++cpu) {
+      if (CPU_ISSET_S(cpu, cpu_set_size, cpu_set)) {
+        processors.push_back(cpu);
+      }
+    }
+  }
+  CPU_FREE(cpu_set);
+#endif
+  return processors;
+}
+
 // static
 size_t PlatformThreadBase::GetDefaultThreadStackSize() {
   pthread_attr_t attributes;
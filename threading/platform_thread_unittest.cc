@@ -11,6 +11,8 @@
 
 #include <stddef.h>
 
+#include <vector>
+
 #include "base/compiler_specific.h"
 #include "base/process/process.h"
 #include "base/synchronization/waitable_event.h"
@@ -550,6 +552,24 @@ TEST(PlatformThreadTest, SetHugeThreadName) {
   PlatformThread::SetName(long_name);
 }
 
+TEST(PlatformThreadTest, SetCurrentThreadAffinity) {
+  // No processor to run on.
+  EXPECT_FALSE(PlatformThread::SetCurrentThreadAffinity({}));
+
+  const std::vector<int> processors =
+      PlatformThread::GetCurrentThreadAffinity();
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    BUILDFLAG(IS_WIN)
+  ASSERT_FALSE(processors.empty());
+  // Setting the current affinity again is a no-op.
+  EXPECT_TRUE(PlatformThread::SetCurrentThreadAffinity(processors));
+  EXPECT_EQ(PlatformThread::GetCurrentThreadAffinity(), processors);
+#else
+  EXPECT_TRUE(processors.empty());
+  EXPECT_FALSE(PlatformThread::SetCurrentThreadAffinity({0}));
+#endif
+}
+
 TEST(PlatformThreadTest, GetDefaultThreadStackSize) {
   size_t stack_size = PlatformThread::GetDefaultThreadStackSize();
 #if BUILDFLAG(IS_IOS) && BUILDFLAG(USE_BLINK)
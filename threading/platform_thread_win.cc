@@ -9,6 +9,7 @@
 #include <stddef.h>
 
 #include <string>
+#include <vector>
 
 #include "base/debug/alias.h"
 #include "base/debug/crash_logging.h"
@@ -580,6 +581,48 @@ void InitializePlatformThreadFeatures() {
       std::memory_order_relaxed);
 }
 
+// static
+bool PlatformThreadBase::SetCurrentThreadAffinity(span<const int> processors) {
+  DWORD_PTR mask = 0;
+  for (int processor : processors) {
+    DCHECK_GE(processor, 0);
+    if (processor < static_cast<int>(sizeof(mask) * 8)) {
+      mask |= DWORD_PTR{1} << processor;
+    }
+  }
+  if (!mask) {
+    return false;
+  }
+  const bool success = ::SetThreadAffinityMask(::GetCurrentThread(), mask) != 0;
+  return success;
+}
+
+// static
+std::vector<int> PlatformThreadBase::GetCurrentThreadAffinity() {
+  std::vector<int> processors;
+  DWORD_PTR process_mask = 0;
+  DWORD_PTR system_mask = 0;
+  if (!::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask,
+                                &system_mask)) {
+    return processors;
+  }
+  // There is no getter for the thread mask; read it back by setting it to one
+  // that restricts nothing more than the process mask does.
+  const DWORD_PTR thread_mask =
+      ::SetThreadAffinityMask(::GetCurrentThread(), process_mask);
+  if (!thread_mask) {
+    return processors;
+  }
+  ::SetThreadAffinityMask(::GetCurrentThread(), thread_mask);
+  for (int processor = 0; processor < static_cast<int>(sizeof(thread_mask) * 8);
+       ++processor) {
+    if (thread_mask & (DWORD_PTR{1} << processor)) {
+      processors.push_back(processor);
+    }
+  }
+  return processors;
+}
+
 // static
 size_t PlatformThread::GetDefaultThreadStackSize() {
   return 0;
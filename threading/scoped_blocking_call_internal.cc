@@ -18,6 +18,7 @@
 #include "base/functional/callback_helpers.h"
 #include "base/no_destructor.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/profiler/blocking_call_profiler.h"
 #include "base/scoped_clear_last_error.h"
 #include "base/task/scoped_set_task_priority_for_current_thread.h"
 #include "base/task/thread_pool.h"
@@ -345,6 +346,10 @@ UncheckedScopedBlockingCall::UncheckedScopedBlockingCall(
     }
   }
 
+  if (!previous_scoped_blocking_call_ && BlockingCallProfiler::IsRunning()) {
+    profiled_call_start_ = TimeTicks::Now();
+  }
+
   if (blocking_observer_) {
     if (!previous_scoped_blocking_call_) {
       blocking_observer_->BlockingStarted(blocking_type);
@@ -360,6 +365,11 @@ UncheckedScopedBlockingCall::~UncheckedScopedBlockingCall() {
   // prevents side effect.
   ScopedClearLastError save_last_error;
   DCHECK_EQ(this, GetLastScopedBlockingCall());
+  if (!profiled_call_start_.is_null()) {
+    BlockingCallProfiler::OnBlockingCallEnded(
+        is_will_block_ ? BlockingType::WILL_BLOCK : BlockingType::MAY_BLOCK,
+        profiled_call_start_);
+  }
   if (blocking_observer_ && !previous_scoped_blocking_call_)
     blocking_observer_->BlockingEnded();
 }
@@ -201,6 +201,10 @@ class BASE_EXPORT [[maybe_unused, nodiscard]] UncheckedScopedBlockingCall {
   // Non-nullopt for non-nested blocking calls of type MAY_BLOCK on foreground
   // threads which we monitor for I/O jank.
   std::optional<IOJankMonitoringWindow::ScopedMonitoredCall> monitored_call_;
+
+  // Set for non-nested blocking calls instantiated while a
+  // BlockingCallProfiler is running.
+  TimeTicks profiled_call_start_;
 };
 
 }  // namespace internal
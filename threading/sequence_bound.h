@@ -10,6 +10,7 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "base/check.h"
 #include "base/location.h"
@@ -112,6 +113,8 @@ class SequenceBound {
   using CrossThreadTask =
       typename CrossThreadTraits::template CrossThreadTask<Signature>;
 
+  class Batch;
+
   // Note: on construction, SequenceBound binds to the current sequence. Any
   // subsequent SequenceBound calls (including destruction) must run on that
   // same sequence.
@@ -253,6 +256,100 @@ class SequenceBound {
                             void, std::tuple<Args...>>(this, &location, method);
   }
 
+  // Collects `AsyncCall()`s to post them to `impl_task_runner_` as a single
+  // task when the Batch is flushed or destroyed, instead of one task per call:
+  //
+  //   {
+  //     auto batch = helper.BeginBatch();
+  //     for (const auto& item : items) {
+  //       batch.AsyncCall(&IOHelper::Process).WithArgs(item);
+  //     }
+  //   }  // Posts one task, which calls `Process()` for each item in order.
+  //
+  // Only calls without `Then()` can be batched, i.e. calls to methods that
+  // return void or that are wrapped in `base::IgnoreResult()`. The calls of a
+  // batch run in order, after the calls made directly on the SequenceBound
+  // before the batch is flushed. A Batch must be used on the owner sequence,
+  // and the SequenceBound must not be reset or moved while the Batch exists.
+  class Batch {
+   public:
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+    ~Batch() { Flush(); }
+
+    template <typename C, typename... Args>
+      requires(std::derived_from<UnwrappedT, C>)
+    auto AsyncCall(void (C::*method)(Args...),
+                   const Location& location = Location::Current()) {
+      return AsyncCallBuilder<void (C::*)(Args...), void, std::tuple<Args...>>(
+          sequence_bound_, &location, method, this);
+    }
+
+    template <typename C, typename... Args>
+      requires(std::derived_from<UnwrappedT, C>)
+    auto AsyncCall(void (C::*method)(Args...) const,
+                   const Location& location = Location::Current()) {
+      return AsyncCallBuilder<void (C::*)(Args...) const, void,
+                              std::tuple<Args...>>(sequence_bound_, &location,
+                                                   method, this);
+    }
+
+    template <typename R, typename C, typename... Args>
+      requires(std::derived_from<UnwrappedT, C>)
+    auto AsyncCall(internal::IgnoreResultHelper<R (C::*)(Args...) const> method,
+                   const Location& location = Location::Current()) {
+      return AsyncCallBuilder<
+          internal::IgnoreResultHelper<R (C::*)(Args...) const>, void,
+          std::tuple<Args...>>(sequence_bound_, &location, method, this);
+    }
+
+    template <typename R, typename C, typename... Args>
+      requires(std::derived_from<UnwrappedT, C>)
+    auto AsyncCall(internal::IgnoreResultHelper<R (C::*)(Args...)> method,
+                   const Location& location = Location::Current()) {
+      return AsyncCallBuilder<internal::IgnoreResultHelper<R (C::*)(Args...)>,
+                              void, std::tuple<Args...>>(
+          sequence_bound_, &location, method, this);
+    }
+
+    // Posts the calls collected so far, if any, as a single task.
+    void Flush() {
+      if (calls_.empty()) {
+        return;
+      }
+      CrossThreadTraits::PostTask(
+          *sequence_bound_->impl_task_runner_, location_,
+          CrossThreadTraits::BindOnce(&RunCalls, std::exchange(calls_, {})));
+    }
+
+    // Returns the number of calls collected since the last flush.
+    size_t size() const { return calls_.size(); }
+
+   private:
+    friend SequenceBound;
+
+    Batch(const SequenceBound* sequence_bound, const Location& location)
+        : sequence_bound_(sequence_bound), location_(location) {
+      DCHECK(!sequence_bound_->is_null());
+    }
+
+    static void RunCalls(std::vector<CrossThreadTask<void()>> calls) {
+      for (auto& call : calls) {
+        std::move(call).Run();
+      }
+    }
+
+    const raw_ptr<const SequenceBound> sequence_bound_;
+    const Location location_;
+    std::vector<CrossThreadTask<void()>> calls_;
+  };
+
+  // Returns a Batch for the managed `T`. May only be used when `is_null()` is
+  // false.
+  Batch BeginBatch(const Location& location = Location::Current()) const {
+    return Batch(this, location);
+  }
+
   // Posts `task` to `impl_task_runner_`, passing it a reference to the wrapped
   // object. This allows arbitrary logic to be safely executed on the object's
   // task runner. The object is guaranteed to remain alive for the duration of
@@ -387,10 +484,12 @@ class SequenceBound {
    protected:
     AsyncCallBuilderBase(const SequenceBound* sequence_bound,
                          const Location* location,
-                         MethodRef method)
+                         MethodRef method,
+                         Batch* batch = nullptr)
         : sequence_bound_(sequence_bound),
           location_(location),
-          method_(method) {
+          method_(method),
+          batch_(batch) {
       // Common entry point for `AsyncCall()`, so check preconditions here.
       DCHECK(sequence_bound_);
       DCHECK(!sequence_bound_->storage_.is_null());
@@ -423,6 +522,8 @@ class SequenceBound {
     // `location_` will trigger a stack-use-after-scope when running with ASan.
     const raw_ptr<const Location> location_;
     MethodRef method_;
+    // The Batch which collects the call instead of posting it, if any.
+    const raw_ptr<Batch> batch_;
   };
 
   template <typename MethodRef, typename ReturnType, typename ArgsTuple>
@@ -439,8 +540,8 @@ class SequenceBound {
 
     ~AsyncCallBuilderImpl() {
       if (this->sequence_bound_) {
-        CrossThreadTraits::PostTask(
-            *this->sequence_bound_->impl_task_runner_, *this->location_,
+        this->sequence_bound_->PostOrBatchHelper(
+            this->batch_, *this->location_,
             CrossThreadTraits::BindOnce(
                 this->method_,
                 this->sequence_bound_->storage_.GetPtrForBind()));
@@ -448,6 +549,7 @@ class SequenceBound {
     }
 
     void Then(CrossThreadTask<void()> then_callback) && {
+      CHECK(!this->batch_) << "Then() is not supported for batched calls";
       this->sequence_bound_->PostTaskAndThenHelper(
           *this->location_,
           CrossThreadTraits::BindOnce(
@@ -521,7 +623,8 @@ class SequenceBound {
           sequence_bound, this->location_,
           CrossThreadTraits::BindOnce(this->method_,
                                       sequence_bound->storage_.GetPtrForBind(),
-                                      std::forward<BoundArgs>(bound_args)...));
+                                      std::forward<BoundArgs>(bound_args)...),
+          this->batch_);
     }
 
    private:
@@ -548,10 +651,12 @@ class SequenceBound {
    protected:
     AsyncCallWithBoundArgsBuilderBase(const SequenceBound* sequence_bound,
                                       const Location* location,
-                                      CrossThreadTask<ReturnType()> callback)
+                                      CrossThreadTask<ReturnType()> callback,
+                                      Batch* batch)
         : sequence_bound_(sequence_bound),
           location_(location),
-          callback_(std::move(callback)) {
+          callback_(std::move(callback)),
+          batch_(batch) {
       DCHECK(sequence_bound_);
       DCHECK(!sequence_bound_->storage_.is_null());
     }
@@ -568,6 +673,7 @@ class SequenceBound {
     raw_ptr<const SequenceBound<T, CrossThreadTraits>> sequence_bound_;
     const raw_ptr<const Location> location_;
     CrossThreadTask<ReturnType()> callback_;
+    const raw_ptr<Batch> batch_;
   };
 
   // Note: this doesn't handle a void return type, which has an explicit
@@ -614,13 +720,13 @@ class SequenceBound {
 
     ~AsyncCallWithBoundArgsBuilderVoid() {
       if (this->sequence_bound_) {
-        CrossThreadTraits::PostTask(*this->sequence_bound_->impl_task_runner_,
-                                    *this->location_,
-                                    std::move(this->callback_));
+        this->sequence_bound_->PostOrBatchHelper(
+            this->batch_, *this->location_, std::move(this->callback_));
       }
     }
 
     void Then(CrossThreadTask<void()> then_callback) && {
+      CHECK(!this->batch_) << "Then() is not supported for batched calls";
       this->sequence_bound_->PostTaskAndThenHelper(*this->location_,
                                                    std::move(this->callback_),
                                                    std::move(then_callback));
@@ -642,6 +748,19 @@ class SequenceBound {
       AsyncCallWithBoundArgsBuilderVoid,
       AsyncCallWithBoundArgsBuilderDefault<ReturnType>>::type;
 
+  // Posts `callback`, or adds it to `batch` if non-null.
+  void PostOrBatchHelper(Batch* batch,
+                         const Location& location,
+                         CrossThreadTask<void()> callback) const {
+    if (batch) {
+      DCHECK(batch->sequence_bound_ == this);
+      batch->calls_.push_back(std::move(callback));
+      return;
+    }
+    CrossThreadTraits::PostTask(*impl_task_runner_, location,
+                                std::move(callback));
+  }
+
   void PostTaskAndThenHelper(const Location& location,
                              CrossThreadTask<void()> callback,
                              CrossThreadTask<void()> then_callback) const {
@@ -623,6 +623,38 @@ TYPED_TEST(SequenceBoundTest, FlushPostedTasksForTesting) {
                                      "updated BoxedValue from 0 to 42"));
 }
 
+TYPED_TEST(SequenceBoundTest, Batch) {
+  SEQUENCE_BOUND_T<BoxedValue> value(this->background_task_runner_, 0,
+                                     &this->logger_);
+  value.FlushPostedTasksForTesting();
+  EXPECT_THAT(this->logger_.TakeEvents(),
+              ::testing::ElementsAre("constructed BoxedValue = 0"));
+
+  {
+    auto batch = value.BeginBatch();
+    batch.AsyncCall(&BoxedValue::set_value).WithArgs(1);
+    batch.AsyncCall(&BoxedValue::set_value).WithArgs(2);
+    EXPECT_EQ(2u, batch.size());
+    value.FlushPostedTasksForTesting();
+    // The calls are only posted when the batch is flushed.
+    EXPECT_THAT(this->logger_.TakeEvents(), ::testing::IsEmpty());
+
+    batch.Flush();
+    EXPECT_EQ(0u, batch.size());
+    value.FlushPostedTasksForTesting();
+    EXPECT_THAT(this->logger_.TakeEvents(),
+                ::testing::ElementsAre("updated BoxedValue from 0 to 1",
+                                       "updated BoxedValue from 1 to 2"));
+
+    batch.AsyncCall(&BoxedValue::set_value).WithArgs(3);
+    batch.AsyncCall(IgnoreResult(&BoxedValue::value));
+  }
+  value.FlushPostedTasksForTesting();
+  EXPECT_THAT(this->logger_.TakeEvents(),
+              ::testing::ElementsAre("updated BoxedValue from 2 to 3",
+                                     "accessed BoxedValue = 3"));
+}
+
 TYPED_TEST(SequenceBoundTest, SmallObject) {
   class EmptyClass {};
   SEQUENCE_BOUND_T<EmptyClass> value(this->background_task_runner_);
@@ -47,10 +47,15 @@ bool SequenceLocalStorageMap::Has(int slot_id) const {
 }
 
 void SequenceLocalStorageMap::Reset(int slot_id) {
+  if (slot_id < kNumInlineSlots) {
+    inline_slots_[static_cast<size_t>(slot_id)] = ValueDestructorPair();
+    return;
+  }
   sls_map_.erase(slot_id);
 }
 
-SequenceLocalStorageMap::Value* SequenceLocalStorageMap::Get(int slot_id) {
+SequenceLocalStorageMap::Value* SequenceLocalStorageMap::GetFromMap(
+    int slot_id) {
   auto it = sls_map_.find(slot_id);
   if (it != sls_map_.end()) {
     return it->second.get();
@@ -61,6 +66,12 @@ SequenceLocalStorageMap::Value* SequenceLocalStorageMap::Get(int slot_id) {
 SequenceLocalStorageMap::Value* SequenceLocalStorageMap::Set(
     int slot_id,
     SequenceLocalStorageMap::ValueDestructorPair value_destructor_pair) {
+  if (slot_id < kNumInlineSlots) {
+    ValueDestructorPair& slot = inline_slots_[static_cast<size_t>(slot_id)];
+    slot = std::move(value_destructor_pair);
+    return slot.get();
+  }
+
   auto it = sls_map_.find(slot_id);
 
   if (it == sls_map_.end())
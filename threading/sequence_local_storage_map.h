@@ -5,6 +5,10 @@
 #ifndef BASE_THREADING_SEQUENCE_LOCAL_STORAGE_MAP_H_
 #define BASE_THREADING_SEQUENCE_LOCAL_STORAGE_MAP_H_
 
+#include <stddef.h>
+
+#include <array>
+
 #include "base/auto_reset.h"
 #include "base/base_export.h"
 #include "base/containers/flat_map.h"
@@ -156,6 +160,10 @@ class BASE_EXPORT SequenceLocalStorageMap {
     RAW_PTR_EXCLUSION DestructorFunc* destructor_;
   };
 
+  // The number of slots, starting from slot id 0, which are stored in a dense
+  // array rather than in the map.
+  static constexpr int kNumInlineSlots = 16;
+
   // Returns true if a value is stored in |slot_id|.
   bool Has(int slot_id) const;
 
@@ -163,14 +171,29 @@ class BASE_EXPORT SequenceLocalStorageMap {
   void Reset(int slot_id);
 
   // Returns the value stored in |slot_id| or nullptr if no value was stored.
-  Value* Get(int slot_id);
+  // Inlined, so that the hot path of SequenceLocalStorageSlot accesses is an
+  // array access for the first kNumInlineSlots slots.
+  Value* Get(int slot_id) {
+    if (slot_id < kNumInlineSlots) {
+      return inline_slots_[static_cast<size_t>(slot_id)].get();
+    }
+    return GetFromMap(slot_id);
+  }
 
   // Stores |value_destructor_pair| in |slot_id|. Overwrites and destroys any
   // previously stored value.
   Value* Set(int slot_id, ValueDestructorPair value_destructor_pair);
 
  private:
-  // Map from slot id to ValueDestructorPair.
+  Value* GetFromMap(int slot_id);
+
+  // Values of slots whose ids are below kNumInlineSlots. Slot ids are handed
+  // out in order of creation of the slots, and the earliest created ones are
+  // typically the hottest ones (e.g. those of base and of process-wide
+  // singletons), so they are looked up directly by index.
+  std::array<ValueDestructorPair, kNumInlineSlots> inline_slots_;
+
+  // Map from slot id to ValueDestructorPair, for the other slots.
   // flat_map was chosen because there are expected to be relatively few entries
   // in the map. For low number of entries, flat_map is known to perform better
   // than other map implementations.
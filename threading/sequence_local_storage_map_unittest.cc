@@ -228,5 +228,39 @@ TEST(SequenceLocalStorageMapTest, DestructorCalledOnSetOverwriteInline) {
   }
 }
 
+// Verify that values of slots stored inline and in the map are independent,
+// and are destroyed on Reset() and when the map is destroyed.
+TEST(SequenceLocalStorageMapTest, InlineAndMapSlots) {
+  constexpr int kInlineSlotId = 0;
+  constexpr int kMapSlotId = SequenceLocalStorageMap::kNumInlineSlots;
+  bool inline_destroyed = false;
+  bool map_destroyed = false;
+
+  {
+    SequenceLocalStorageMap sequence_local_storage_map;
+    ScopedSetSequenceLocalStorageMapForCurrentThread
+        scoped_sequence_local_storage_map(&sequence_local_storage_map);
+
+    sequence_local_storage_map.Set(
+        kInlineSlotId,
+        CreateExternalValueDestructorPair<SetOnDestroy>(&inline_destroyed));
+    sequence_local_storage_map.Set(
+        kMapSlotId,
+        CreateExternalValueDestructorPair<SetOnDestroy>(&map_destroyed));
+    EXPECT_TRUE(sequence_local_storage_map.Has(kInlineSlotId));
+    EXPECT_TRUE(sequence_local_storage_map.Has(kMapSlotId));
+    EXPECT_FALSE(sequence_local_storage_map.Has(kInlineSlotId + 1));
+    EXPECT_FALSE(sequence_local_storage_map.Has(kMapSlotId + 1));
+
+    sequence_local_storage_map.Reset(kInlineSlotId);
+    EXPECT_TRUE(inline_destroyed);
+    EXPECT_FALSE(sequence_local_storage_map.Has(kInlineSlotId));
+    EXPECT_TRUE(sequence_local_storage_map.Has(kMapSlotId));
+    EXPECT_FALSE(map_destroyed);
+  }
+
+  EXPECT_TRUE(map_destroyed);
+}
+
 }  // namespace internal
 }  // namespace base
@@ -0,0 +1,118 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+
+#include "base/threading/sequence_local_storage_map.h"
+#include "base/threading/sequence_local_storage_slot.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+constexpr size_t kCount = 10000000;
+
+constexpr char kMetricPrefixSequenceLocalStorage[] = "SequenceLocalStorage.";
+constexpr char kMetricRead[] = "read_operation_time";
+constexpr char kMetricReadWrite[] = "read_write_operation_time";
+constexpr char kStoryInlineSlot[] = "inline_slot";
+constexpr char kStoryMapSlot[] = "map_slot";
+constexpr char kStorySlot[] = "sequence_local_storage_slot";
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixSequenceLocalStorage,
+                                         story_name);
+  reporter.RegisterImportantMetric(kMetricRead, "ns");
+  reporter.RegisterImportantMetric(kMetricReadWrite, "ns");
+  return reporter;
+}
+
+class SequenceLocalStoragePerfTest : public testing::Test {
+ protected:
+  template <class Read, class Write>
+  void Benchmark(const std::string& story_name, Read read, Write write) {
+    auto reporter = SetUpReporter(story_name);
+    write(2);
+
+    TimeTicks start = TimeTicks::Now();
+    volatile intptr_t total = 0;
+    for (size_t i = 0; i < kCount; ++i) {
+      total = total + read();
+    }
+    reporter.AddResult(kMetricRead,
+                       (TimeTicks::Now() - start).InNanosecondsF() / kCount);
+
+    start = TimeTicks::Now();
+    for (size_t i = 0; i < kCount; ++i) {
+      write(read() + 1);
+    }
+    reporter.AddResult(kMetricReadWrite,
+                       (TimeTicks::Now() - start).InNanosecondsF() / kCount);
+  }
+
+  // Benchmarks direct accesses to |slot_id| of the current map.
+  void BenchmarkMapSlot(const std::string& story_name, int slot_id) {
+    SequenceLocalStorageMap& map =
+        SequenceLocalStorageMap::GetForCurrentThread();
+    SequenceLocalStorageMap::InlineValue value;
+    value.emplace<intptr_t>(0);
+    map.Set(slot_id,
+            SequenceLocalStorageMap::ValueDestructorPair(
+                std::move(value),
+                SequenceLocalStorageMap::MakeInlineDestructor<intptr_t>()));
+
+    Benchmark(
+        story_name,
+        [&]() {
+          return SequenceLocalStorageMap::GetForCurrentThread()
+              .Get(slot_id)
+              ->inline_value.value_as<intptr_t>();
+        },
+        [&](intptr_t new_value) {
+          SequenceLocalStorageMap::GetForCurrentThread()
+              .Get(slot_id)
+              ->inline_value.value_as<intptr_t>() = new_value;
+        });
+  }
+
+  SequenceLocalStorageMap map_;
+  ScopedSetSequenceLocalStorageMapForCurrentThread scoped_map_{&map_};
+};
+
+}  // namespace
+
+TEST_F(SequenceLocalStoragePerfTest, InlineSlot) {
+  BenchmarkMapSlot(kStoryInlineSlot, 0);
+}
+
+TEST_F(SequenceLocalStoragePerfTest, MapSlot) {
+  // Populate the map with a few other slots, as in a typical sequence.
+  for (int i = 1; i <= 8; ++i) {
+    SequenceLocalStorageMap::InlineValue value;
+    value.emplace<intptr_t>(i);
+    map_.Set(SequenceLocalStorageMap::kNumInlineSlots + i,
+             SequenceLocalStorageMap::ValueDestructorPair(
+                 std::move(value),
+                 SequenceLocalStorageMap::MakeInlineDestructor<intptr_t>()));
+  }
+  BenchmarkMapSlot(kStoryMapSlot, SequenceLocalStorageMap::kNumInlineSlots);
+}
+
+TEST_F(SequenceLocalStoragePerfTest, SequenceLocalStorageSlot) {
+  SequenceLocalStorageSlot<intptr_t> slot;
+  Benchmark(
+      kStorySlot, [&]() { return slot.GetOrCreateValue(); },
+      [&](intptr_t value) { slot.GetOrCreateValue() = value; });
+}
+
+}  // namespace internal
+}  // namespace base
@@ -121,6 +121,7 @@ Thread::Options::Options(Options&& other)
       message_pump_factory(std::move(other.message_pump_factory)),
       stack_size(std::move(other.stack_size)),
       thread_type(std::move(other.thread_type)),
+      cpu_affinity(std::move(other.cpu_affinity)),
       joinable(std::move(other.joinable)) {
   other.moved_from = true;
 }
@@ -133,6 +134,7 @@ Thread::Options& Thread::Options::operator=(Thread::Options&& other) {
   message_pump_factory = std::move(other.message_pump_factory);
   stack_size = std::move(other.stack_size);
   thread_type = std::move(other.thread_type);
+  cpu_affinity = std::move(other.cpu_affinity);
   joinable = std::move(other.joinable);
   other.moved_from = true;
 
@@ -200,6 +202,7 @@ bool Thread::StartWithOptions(Options options) {
                  options.message_pump_type));
   }
 
+  cpu_affinity_ = std::move(options.cpu_affinity);
   start_event_.Reset();
 
   // Hold |thread_lock_| while starting the new thread to synchronize with
@@ -369,6 +372,9 @@ void Thread::ThreadMain() {
   // Complete the initialization of our Thread object.
   PlatformThread::SetName(name_.c_str());
   ABSL_ANNOTATE_THREAD_NAME(name_.c_str());  // Tell the name to race detector.
+  if (!cpu_affinity_.empty()) {
+    PlatformThread::SetCurrentThreadAffinity(cpu_affinity_);
+  }
 
   // Lazily initialize the |message_loop| so that it can run on this thread.
   DCHECK(delegate_);
@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/check.h"
@@ -103,6 +104,11 @@ class BASE_EXPORT Thread : PlatformThread::Delegate {
     // Specifies the initial thread type.
     ThreadType thread_type = ThreadType::kDefault;
 
+    // If non-empty, the logical processors the thread is restricted to run on
+    // (see PlatformThread::SetCurrentThreadAffinity()). E.g. an IO thread can
+    // be kept off the processors used by ThreadPool workers.
+    std::vector<int> cpu_affinity;
+
     // If false, the thread will not be joined on destruction. This is intended
     // for threads that want TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN
     // semantics. Non-joinable threads can't be joined (must be leaked and
@@ -323,6 +329,10 @@ class BASE_EXPORT Thread : PlatformThread::Delegate {
   // The name of the thread.  Used for debugging purposes.
   const std::string name_;
 
+  // Processors the thread runs on, or empty to let it run anywhere. Set before
+  // the thread is created and read by the created thread.
+  std::vector<int> cpu_affinity_;
+
   // Signaled when the created thread gets ready to use the message loop.
   mutable WaitableEvent start_event_;
 
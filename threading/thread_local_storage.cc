@@ -17,7 +17,9 @@
 #include "base/memory/raw_ptr_exclusion.h"
 #include "base/notreached.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/threading_buildflags.h"
 #include "build/build_config.h"
+#include "third_party/abseil-cpp/absl/base/attributes.h"
 
 #if BUILDFLAG(IS_MAC) && defined(ARCH_CPU_X86_64)
 #include <pthread.h>
@@ -85,6 +87,26 @@ namespace {
 std::atomic<PlatformThreadLocalStorage::TLSKey> g_native_tls_key{
     PlatformThreadLocalStorage::TLS_KEY_OUT_OF_INDEXES};
 
+#if BUILDFLAG(USE_STATIC_TLS_FOR_THREAD_LOCAL_STORAGE)
+// Copy of the value of the g_native_tls_key slot for the current thread, read
+// by Slot::Get() and Slot::Set() instead of calling pthread_getspecific().
+// base is linked into the executable, so this is in the static TLS block, at a
+// fixed offset from the thread pointer, and is accessed without going through
+// __tls_get_addr(). The OS TLS slot is still needed to get a destructor call
+// on thread exit.
+//
+// pthread clears the OS TLS slot before calling OnThreadExit(), while this
+// copy keeps pointing to the TLS vector until OnThreadExitInternal() updates
+// it. The pthread key destructors which run before OnThreadExit() therefore
+// still see the values of the thread in Slot::Get(), where they would
+// otherwise see null, and Slot::Set() stores into the vector rather than
+// creating a new one. The values are still alive then, as their destructors
+// only run in OnThreadExitInternal(), which also runs the destructors of the
+// values stored this way.
+ABSL_CONST_INIT thread_local uintptr_t g_tls_vector_value
+    __attribute__((tls_model("initial-exec"))) = 0;
+#endif
+
 // The OS TLS slot has the following states. The TLS slot's lower 2 bits contain
 // the state, the upper bits the TlsVectorEntry*.
 //   * kUninitialized: Any call to Slot::Get()/Set() will create the base
@@ -193,9 +215,13 @@ void SetTlsVectorValue(PlatformThreadLocalStorage::TLSKey key,
                        TlsVectorState state) {
   DCHECK(tls_data || (state == TlsVectorState::kUninitialized) ||
          (state == TlsVectorState::kDestroyed));
-  PlatformThreadLocalStorage::SetTLSValue(
-      key, reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(tls_data) |
-                                   static_cast<uintptr_t>(state)));
+  const uintptr_t tls_value =
+      reinterpret_cast<uintptr_t>(tls_data) | static_cast<uintptr_t>(state);
+#if BUILDFLAG(USE_STATIC_TLS_FOR_THREAD_LOCAL_STORAGE)
+  g_tls_vector_value = tls_value;
+#endif
+  PlatformThreadLocalStorage::SetTLSValue(key,
+                                          reinterpret_cast<void*>(tls_value));
 }
 
 // Returns the tls vector and current state from the raw tls value.
@@ -212,6 +238,10 @@ TlsVectorState GetTlsVectorStateAndValue(void* tls_value,
 // Returns the tls vector and state using the tls key.
 TlsVectorState GetTlsVectorStateAndValue(PlatformThreadLocalStorage::TLSKey key,
                                          TlsVectorEntry** entry = nullptr) {
+#if BUILDFLAG(USE_STATIC_TLS_FOR_THREAD_LOCAL_STORAGE)
+  return GetTlsVectorStateAndValue(reinterpret_cast<void*>(g_tls_vector_value),
+                                   entry);
+#else
 // Only on x86_64, the implementation is not stable on ARM64. For instance, in
 // macOS 11, the TPIDRRO_EL0 registers holds the CPU index in the low bits,
 // which is not the case in macOS 12. See libsyscall/os/tsd.h in XNU
@@ -252,6 +282,20 @@ TlsVectorState GetTlsVectorStateAndValue(PlatformThreadLocalStorage::TLSKey key,
   return GetTlsVectorStateAndValue(PlatformThreadLocalStorage::GetTLSValue(key),
                                    entry);
 #endif
+#endif  // BUILDFLAG(USE_STATIC_TLS_FOR_THREAD_LOCAL_STORAGE)
+}
+
+// Returns the tls vector and state of the current thread. This doesn't need
+// the tls key, and so doesn't load it, with static TLS.
+ALWAYS_INLINE TlsVectorState
+GetCurrentTlsVectorStateAndValue(TlsVectorEntry** entry = nullptr) {
+#if BUILDFLAG(USE_STATIC_TLS_FOR_THREAD_LOCAL_STORAGE)
+  return GetTlsVectorStateAndValue(reinterpret_cast<void*>(g_tls_vector_value),
+                                   entry);
+#else
+  return GetTlsVectorStateAndValue(
+      g_native_tls_key.load(std::memory_order_relaxed), entry);
+#endif
 }
 
 // This function is called to initialize our entire Chromium TLS system.
@@ -500,8 +544,7 @@ void ThreadLocalStorage::Slot::Free() {
 
 void* ThreadLocalStorage::Slot::Get() const {
   TlsVectorEntry* tls_data = nullptr;
-  const TlsVectorState state = GetTlsVectorStateAndValue(
-      g_native_tls_key.load(std::memory_order_relaxed), &tls_data);
+  const TlsVectorState state = GetCurrentTlsVectorStateAndValue(&tls_data);
   DCHECK_NE(state, TlsVectorState::kDestroyed);
   if (!tls_data)
     return nullptr;
@@ -514,8 +557,7 @@ void* ThreadLocalStorage::Slot::Get() const {
 
 void ThreadLocalStorage::Slot::Set(void* value) {
   TlsVectorEntry* tls_data = nullptr;
-  const TlsVectorState state = GetTlsVectorStateAndValue(
-      g_native_tls_key.load(std::memory_order_relaxed), &tls_data);
+  const TlsVectorState state = GetCurrentTlsVectorStateAndValue(&tls_data);
   DCHECK_NE(state, TlsVectorState::kDestroyed);
   if (UNLIKELY(!tls_data)) {
     if (!value)
@@ -30,6 +30,7 @@ class MallocDumpProvider;
 
 namespace internal {
 
+class ObjectPoolBase;
 class ThreadLocalStorageTestInternal;
 
 // WARNING: You should *NOT* use this class directly.
@@ -158,6 +159,7 @@ class BASE_EXPORT ThreadLocalStorage {
   friend class SequenceCheckerImpl;
   friend class SamplingHeapProfiler;
   friend class ThreadCheckerImpl;
+  friend class internal::ObjectPoolBase;
   friend class internal::ThreadLocalStorageTestInternal;
   friend class trace_event::MallocDumpProvider;
   friend class debug::GlobalActivityTracker;
@@ -185,6 +185,32 @@ TEST_F(ThreadTest, StartWithOptions_StackSize) {
   event.Wait();
 }
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID) || \
+    BUILDFLAG(IS_WIN)
+TEST_F(ThreadTest, StartWithOptions_CpuAffinity) {
+  const std::vector<int> processors =
+      PlatformThread::GetCurrentThreadAffinity();
+  ASSERT_FALSE(processors.empty());
+
+  Thread a("StartWithCpuAffinity");
+  Thread::Options options;
+  options.cpu_affinity = {processors.back()};
+  EXPECT_TRUE(a.StartWithOptions(std::move(options)));
+
+  std::vector<int> thread_processors;
+  WaitableEvent event;
+  a.task_runner()->PostTask(FROM_HERE, BindLambdaForTesting([&] {
+                              thread_processors =
+                                  PlatformThread::GetCurrentThreadAffinity();
+                              event.Signal();
+                            }));
+  event.Wait();
+  EXPECT_EQ(thread_processors, std::vector<int>{processors.back()});
+  // The affinity of the starting thread is unchanged.
+  EXPECT_EQ(PlatformThread::GetCurrentThreadAffinity(), processors);
+}
+#endif
+
 // Intentional test-only race for otherwise untestable code, won't fix.
 // https://crbug.com/634383
 #if !defined(THREAD_SANITIZER)
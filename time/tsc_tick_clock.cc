@@ -0,0 +1,141 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/time/tsc_tick_clock.h"
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/no_destructor.h"
+#include "base/time/time_override.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID))
+#include <x86intrin.h>
+
+#include "base/cpu.h"
+#define TSC_TICK_CLOCK_SUPPORTED 1
+#else
+#define TSC_TICK_CLOCK_SUPPORTED 0
+#endif
+
+namespace base {
+
+namespace {
+
+// How long the counter's rate is measured for when the clock is created.
+constexpr TimeDelta kInitialCalibrationDuration = Milliseconds(1);
+
+// How often the counter's rate is measured again, at most. Since the rate is
+// measured since the first calibration, its error shrinks over time, so the
+// clock is recalibrated after twice the time since the first calibration until
+// that reaches this interval.
+constexpr TimeDelta kMaxRecalibrationInterval = Seconds(1);
+
+uint64_t ReadTsc() {
+#if TSC_TICK_CLOCK_SUPPORTED
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
+TscTickClock::TscTickClock()
+    : start_tsc_(ReadTsc()),
+      start_ticks_(subtle::TimeTicksNowIgnoringOverride()) {
+  TimeTicks ticks;
+  uint64_t tsc;
+  do {
+    ticks = subtle::TimeTicksNowIgnoringOverride();
+    tsc = ReadTsc();
+  } while (ticks - start_ticks_ < kInitialCalibrationDuration);
+  DCHECK_GT(tsc, start_tsc_);
+
+  const double microseconds_per_tsc_tick =
+      (ticks - start_ticks_).InMicrosecondsF() /
+      static_cast<double>(tsc - start_tsc_);
+  calibration_.Write(
+      {tsc, ticks, microseconds_per_tsc_tick,
+       static_cast<uint64_t>(2 * static_cast<double>(tsc - start_tsc_))});
+}
+
+TscTickClock::~TscTickClock() = default;
+
+// static
+const TscTickClock* TscTickClock::GetInstance() {
+#if TSC_TICK_CLOCK_SUPPORTED
+  static const TscTickClock* const instance = []() -> const TscTickClock* {
+    const CPU& cpu = CPU::GetInstanceNoAllocation();
+    // Hypervisors don't always keep the counters of virtual CPUs in sync.
+    if (!cpu.has_non_stop_time_stamp_counter() || cpu.is_running_in_vm()) {
+      return nullptr;
+    }
+    static const NoDestructor<TscTickClock> tsc_tick_clock;
+    return tsc_tick_clock.get();
+  }();
+  return instance;
+#else
+  return nullptr;
+#endif
+}
+
+TimeTicks TscTickClock::NowTicks() const {
+  if (subtle::ScopedTimeClockOverrides::overrides_active()) {
+    return TimeTicks::Now();
+  }
+
+  const uint64_t tsc = ReadTsc();
+  const Calibration calibration = calibration_.Read();
+  // The counters of different cores may be a few cycles apart.
+  if (tsc <= calibration.tsc) {
+    return calibration.ticks;
+  }
+  const uint64_t elapsed = tsc - calibration.tsc;
+  if (elapsed > calibration.recalibration_tsc_ticks) {
+    Recalibrate(tsc);
+  }
+  return calibration.ticks +
+         Microseconds(static_cast<double>(elapsed) *
+                      calibration.microseconds_per_tsc_tick);
+}
+
+void TscTickClock::Recalibrate(uint64_t tsc) const {
+  // Only one thread recalibrates at a time; the others keep extrapolating
+  // from the previous calibration.
+  if (recalibrating_.exchange(true, std::memory_order_acquire)) {
+    return;
+  }
+
+  const Calibration previous = calibration_.Read();
+  const TimeTicks now = subtle::TimeTicksNowIgnoringOverride();
+  tsc = ReadTsc();
+
+  // The rate measured since the first calibration only gets more accurate.
+  const double microseconds_per_tsc_tick =
+      (now - start_ticks_).InMicrosecondsF() /
+      static_cast<double>(tsc - start_tsc_);
+
+  // Don't go back in time if the previous calibration ran fast. Instead, run
+  // slightly slower until the next recalibration to catch up with `now`.
+  const TimeTicks extrapolated =
+      previous.ticks +
+      Microseconds(static_cast<double>(tsc - previous.tsc) *
+                   previous.microseconds_per_tsc_tick);
+  const TimeTicks ticks = std::max(now, extrapolated);
+  const TimeDelta interval =
+      std::min(2 * (now - start_ticks_), kMaxRecalibrationInterval);
+  const double slowdown = std::clamp(1.0 - (ticks - now) / interval, 0.5, 1.0);
+
+  calibration_.Write(
+      {tsc, ticks, microseconds_per_tsc_tick * slowdown,
+       static_cast<uint64_t>(interval.InMicrosecondsF() /
+                             microseconds_per_tsc_tick)});
+
+  recalibrating_.store(false, std::memory_order_release);
+}
+
+}  // namespace base
@@ -0,0 +1,75 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TIME_TSC_TICK_CLOCK_H_
+#define BASE_TIME_TSC_TICK_CLOCK_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "base/base_export.h"
+#include "base/synchronization/seq_lock.h"
+#include "base/time/tick_clock.h"
+#include "base/time/time.h"
+
+namespace base {
+
+template <typename T>
+class NoDestructor;
+
+// A TickClock which extrapolates TimeTicks::Now() from the CPU's time stamp
+// counter, which is cheaper to read than the platform clock. The counter's
+// rate is calibrated against TimeTicks::Now() when the clock is created, and
+// then at increasing intervals up to once per second, so that the times it
+// returns stay within a few microseconds of TimeTicks::Now() and never go
+// backwards.
+//
+// Only available on x86 Linux, ChromeOS and Android, on CPUs whose time stamp
+// counter runs at a constant rate in all power states and is synchronized
+// across cores. Returns TimeTicks::Now() while time is overridden, e.g. by
+// TaskEnvironment's MOCK_TIME.
+class BASE_EXPORT TscTickClock : public TickClock {
+ public:
+  TscTickClock(const TscTickClock&) = delete;
+  TscTickClock& operator=(const TscTickClock&) = delete;
+  ~TscTickClock() override;
+
+  // Returns a shared instance of TscTickClock, or null if the CPU doesn't
+  // have an invariant time stamp counter. This is thread-safe, but the first
+  // call blocks for about a millisecond to calibrate the clock.
+  static const TscTickClock* GetInstance();
+
+  // TickClock:
+  TimeTicks NowTicks() const override;
+
+ private:
+  friend class NoDestructor<TscTickClock>;
+
+  // Maps time stamp counter values to TimeTicks.
+  struct Calibration {
+    uint64_t tsc;
+    TimeTicks ticks;
+    double microseconds_per_tsc_tick;
+    // Number of time stamp counter ticks after `tsc` past which the clock is
+    // recalibrated.
+    uint64_t recalibration_tsc_ticks;
+  };
+
+  TscTickClock();
+
+  void Recalibrate(uint64_t tsc) const;
+
+  // The time stamp counter and the time of the first calibration, against
+  // which all the recalibrations measure the counter's rate.
+  uint64_t start_tsc_;
+  TimeTicks start_ticks_;
+
+  mutable SeqLock<Calibration> calibration_;
+  mutable std::atomic_bool recalibrating_ = false;
+};
+
+}  // namespace base
+
+#endif  // BASE_TIME_TSC_TICK_CLOCK_H_
@@ -0,0 +1,66 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/time/tsc_tick_clock.h"
+
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "base/time/time_override.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+TimeTicks OverriddenTimeTicksNow() {
+  return TimeTicks() + Seconds(42);
+}
+
+}  // namespace
+
+TEST(TscTickClockTest, CloseToTimeTicksNow) {
+  const TscTickClock* clock = TscTickClock::GetInstance();
+  if (!clock) {
+    GTEST_SKIP() << "The CPU doesn't have an invariant time stamp counter.";
+  }
+
+  for (int i = 0; i < 10; ++i) {
+    const TimeTicks before = TimeTicks::Now();
+    const TimeTicks now = clock->NowTicks();
+    const TimeTicks after = TimeTicks::Now();
+    // Allow for calibration errors.
+    EXPECT_GE(now, before - Milliseconds(1));
+    EXPECT_LE(now, after + Milliseconds(1));
+    PlatformThread::Sleep(Milliseconds(10));
+  }
+}
+
+TEST(TscTickClockTest, Monotonic) {
+  const TscTickClock* clock = TscTickClock::GetInstance();
+  if (!clock) {
+    GTEST_SKIP() << "The CPU doesn't have an invariant time stamp counter.";
+  }
+
+  // Spans a recalibration.
+  TimeTicks last = clock->NowTicks();
+  const TimeTicks end = TimeTicks::Now() + Milliseconds(1100);
+  while (TimeTicks::Now() < end) {
+    const TimeTicks now = clock->NowTicks();
+    ASSERT_GE(now, last);
+    last = now;
+  }
+}
+
+TEST(TscTickClockTest, Overridden) {
+  const TscTickClock* clock = TscTickClock::GetInstance();
+  if (!clock) {
+    GTEST_SKIP() << "The CPU doesn't have an invariant time stamp counter.";
+  }
+
+  subtle::ScopedTimeClockOverrides overrides(nullptr, &OverriddenTimeTicksNow,
+                                             nullptr);
+  EXPECT_EQ(OverriddenTimeTicksNow(), clock->NowTicks());
+}
+
+}  // namespace base
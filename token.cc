@@ -9,16 +9,16 @@
 
 #include "base/token.h"
 
-#include <inttypes.h>
-
+#include <array>
 #include <optional>
 
 #include "base/check.h"
 #include "base/hash/hash.h"
+#include "base/numerics/byte_conversions.h"
 #include "base/pickle.h"
 #include "base/rand_util.h"
+#include "base/strings/hex_encoding_internal.h"
 #include "base/strings/string_piece.h"
-#include "base/strings/stringprintf.h"
 
 namespace base {
 
@@ -36,32 +36,40 @@ Token Token::CreateRandom() {
 }
 
 std::string Token::ToString() const {
-  return base::StringPrintf("%016" PRIX64 "%016" PRIX64, words_[0], words_[1]);
+  const std::array<char, kStringLength> chars = ToCharArray();
+  return std::string(chars.begin(), chars.end());
+}
+
+std::array<char, Token::kStringLength> Token::ToCharArray() const {
+  // The words in big-endian order, so that the digits read as two 64-bit hex
+  // numbers.
+  std::array<uint8_t, 16> bytes;
+  span(bytes).first<8>().copy_from(U64ToBigEndian(words_[0]));
+  span(bytes).last<8>().copy_from(U64ToBigEndian(words_[1]));
+  std::array<char, kStringLength> chars;
+  internal::HexEncode16(bytes, internal::HexCase::kUpper, chars);
+  return chars;
+}
+
+void Token::AppendTo(std::string* output) const {
+  const std::array<char, kStringLength> chars = ToCharArray();
+  output->append(chars.begin(), chars.end());
 }
 
 // static
 std::optional<Token> Token::FromString(StringPiece string_representation) {
-  if (string_representation.size() != 32) {
+  if (string_representation.size() != kStringLength) {
     return std::nullopt;
   }
-  uint64_t words[2];
-  for (size_t i = 0; i < 2; i++) {
-    uint64_t word = 0;
-    // This j loop is similar to HexStringToUInt64 but we are intentionally
-    // strict about case, accepting 'A' but rejecting 'a'.
-    for (size_t j = 0; j < 16; j++) {
-      const char c = string_representation[(16 * i) + j];
-      if (('0' <= c) && (c <= '9')) {
-        word = (word << 4) | static_cast<uint64_t>(c - '0');
-      } else if (('A' <= c) && (c <= 'F')) {
-        word = (word << 4) | static_cast<uint64_t>(c - 'A' + 10);
-      } else {
-        return std::nullopt;
-      }
-    }
-    words[i] = word;
+  // We are intentionally strict about case, accepting 'A' but rejecting 'a'.
+  std::array<uint8_t, 16> bytes;
+  if (!internal::HexDecode16(span(string_representation).first<kStringLength>(),
+                             internal::HexCase::kUpper, bytes)) {
+    return std::nullopt;
   }
-  return std::optional<Token>(std::in_place, words[0], words[1]);
+  return std::optional<Token>(std::in_place,
+                              U64FromBigEndian(span(bytes).first<8>()),
+                              U64FromBigEndian(span(bytes).last<8>()));
 }
 
 void WriteTokenToPickle(Pickle* pickle, const Token& token) {
@@ -12,6 +12,7 @@
 
 #include <stdint.h>
 
+#include <array>
 #include <compare>
 #include <optional>
 #include <string>
@@ -30,6 +31,9 @@ namespace base {
 // associated with UUIDs.
 class BASE_EXPORT Token {
  public:
+  // The length of ToString().
+  static constexpr size_t kStringLength = 32;
+
   // Constructs a zero Token.
   constexpr Token() = default;
 
@@ -64,6 +68,11 @@ class BASE_EXPORT Token {
   // Generates a string representation of this Token useful for e.g. logging.
   std::string ToString() const;
 
+  // Like ToString(), but without allocating, for callers which format many
+  // Tokens.
+  std::array<char, kStringLength> ToCharArray() const;
+  void AppendTo(std::string* output) const;
+
   // FromString is the opposite of ToString. It returns std::nullopt if the
   // |string_representation| is invalid.
   static std::optional<Token> FromString(StringPiece string_representation);
@@ -0,0 +1,128 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/token.h"
+
+#include <stddef.h>
+
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/check.h"
+#include "base/debug/alias.h"
+#include "base/functional/function_ref.h"
+#include "base/strings/string_util.h"
+#include "base/time/time.h"
+#include "base/unguessable_token.h"
+#include "base/uuid.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "Token.";
+constexpr char kMetricTime[] = "time_per_call";
+
+constexpr size_t kNumIds = 1024;
+constexpr size_t kNumRuns = 1000;
+
+// Runs `op`, which handles the `i`th of kNumIds ids, kNumRuns times on each of
+// them, and reports the mean time per call.
+void RunIdTest(const char* story, FunctionRef<void(size_t i)> op) {
+  const TimeTicks start = TimeTicks::Now();
+  for (size_t run = 0; run < kNumRuns; ++run) {
+    for (size_t i = 0; i < kNumIds; ++i) {
+      op(i);
+    }
+  }
+  const TimeDelta elapsed = TimeTicks::Now() - start;
+
+  perf_test::PerfResultReporter reporter(kMetricPrefix, story);
+  reporter.RegisterImportantMetric(kMetricTime, "ns");
+  reporter.AddResult(kMetricTime, elapsed.InMicrosecondsF() * 1000 /
+                                      (kNumRuns * kNumIds));
+}
+
+std::vector<Token> MakeTokens() {
+  std::vector<Token> tokens;
+  for (size_t i = 0; i < kNumIds; ++i) {
+    tokens.push_back(Token::CreateRandom());
+  }
+  return tokens;
+}
+
+}  // namespace
+
+TEST(TokenPerfTest, Format) {
+  const std::vector<Token> tokens = MakeTokens();
+
+  std::string string;
+  RunIdTest("ToString", [&](size_t i) { string = tokens[i].ToString(); });
+  debug::Alias(&string);
+
+  std::array<char, Token::kStringLength> chars;
+  RunIdTest("ToCharArray", [&](size_t i) { chars = tokens[i].ToCharArray(); });
+  debug::Alias(&chars);
+
+  // As when building a key or a log line.
+  RunIdTest("AppendTo", [&](size_t i) {
+    string.clear();
+    tokens[i].AppendTo(&string);
+  });
+  debug::Alias(&string);
+}
+
+TEST(TokenPerfTest, Parse) {
+  std::vector<std::string> strings;
+  for (const Token& token : MakeTokens()) {
+    strings.push_back(token.ToString());
+  }
+
+  std::optional<Token> token;
+  RunIdTest("FromString", [&](size_t i) {
+    token = Token::FromString(strings[i]);
+    CHECK(token);
+  });
+  debug::Alias(&token);
+
+  std::optional<UnguessableToken> unguessable_token;
+  RunIdTest("UnguessableToken.DeserializeFromString", [&](size_t i) {
+    unguessable_token = UnguessableToken::DeserializeFromString(strings[i]);
+    CHECK(unguessable_token);
+  });
+  debug::Alias(&unguessable_token);
+}
+
+TEST(TokenPerfTest, Uuid) {
+  std::vector<std::string> lowercase;
+  std::vector<std::string> uppercase;
+  for (const Token& token : MakeTokens()) {
+    const Uuid uuid = Uuid::FormatRandomDataAsV4ForTesting(token.AsBytes());
+    lowercase.push_back(uuid.AsLowercaseString());
+    uppercase.push_back(ToUpperASCII(uuid.AsLowercaseString()));
+  }
+
+  Uuid uuid;
+  RunIdTest("Uuid.ParseLowercase", [&](size_t i) {
+    uuid = Uuid::ParseLowercase(lowercase[i]);
+    CHECK(uuid.is_valid());
+  });
+  RunIdTest("Uuid.ParseCaseInsensitive", [&](size_t i) {
+    uuid = Uuid::ParseCaseInsensitive(uppercase[i]);
+    CHECK(uuid.is_valid());
+  });
+  debug::Alias(&uuid);
+
+  const std::vector<Token> tokens = MakeTokens();
+  RunIdTest("Uuid.FormatRandomDataAsV4", [&](size_t i) {
+    uuid = Uuid::FormatRandomDataAsV4ForTesting(tokens[i].AsBytes());
+  });
+  debug::Alias(&uuid);
+}
+
+}  // namespace base
@@ -4,6 +4,10 @@
 
 #include "base/token.h"
 
+#include <array>
+#include <string>
+#include <string_view>
+
 #include "base/pickle.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -56,6 +60,17 @@ TEST(TokenTest, ToString) {
             Token(0xfffffffffffffffdull, 0xfffffffffffffffeull).ToString());
 }
 
+TEST(TokenTest, ToCharArrayAndAppendTo) {
+  const Token token(0x0123456789abcdefull, 0x5a5a5a5aa5a5a5a5ull);
+  const std::array<char, Token::kStringLength> chars = token.ToCharArray();
+  EXPECT_EQ("0123456789ABCDEF5A5A5A5AA5A5A5A5",
+            std::string_view(chars.data(), chars.size()));
+
+  std::string output = "token=";
+  token.AppendTo(&output);
+  EXPECT_EQ("token=0123456789ABCDEF5A5A5A5AA5A5A5A5", output);
+}
+
 TEST(TokenTest, FromString) {
   // digits is 40 bytes long. We call FromString on various substrings of it,
   // which should only succeed when the substring is 32 bytes long.
@@ -78,6 +93,24 @@ TEST(TokenTest, FromString) {
   EXPECT_FALSE(Token::FromString(digits.substr(0, 32)));
   digits[5] = 'A';
   EXPECT_TRUE(Token::FromString(digits.substr(0, 32)));
+  // The characters on either side of the digit and letter ranges, and
+  // non-ASCII ones, in both halves.
+  for (char c : {'/', ':', '@', 'G', '`', 'g', '\0', '\x80', '\xC6'}) {
+    for (size_t i : {0u, 15u, 16u, 31u}) {
+      std::string input = digits.substr(0, 32);
+      input[i] = c;
+      EXPECT_FALSE(Token::FromString(input)) << input;
+    }
+  }
+}
+
+TEST(TokenTest, StringRoundTrip) {
+  for (const Token& token :
+       {Token(), Token(1, 2),
+        Token(0xfedcba9876543210ull, 0x0f1e2d3c4b5a6978ull),
+        Token(~0ull, ~0ull), Token::CreateRandom()}) {
+    EXPECT_EQ(token, Token::FromString(token.ToString()));
+  }
 }
 
 TEST(TokenTest, Pickle) {
@@ -16,8 +16,10 @@
 #include "base/allocator/buildflags.h"
 #include "base/debug/profiler.h"
 #include "base/format_macros.h"
+#include "base/memory/object_pool.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/strings/strcat.h"
 #include "base/strings/stringprintf.h"
 #include "base/trace_event/process_memory_dump.h"
 #include "base/trace_event/traced_value.h"
@@ -412,6 +414,24 @@ bool MallocDumpProvider::OnMemoryDump(const MemoryDumpArgs& args,
                           allocated_objects_count);
   }
 
+  // Object pools get their memory from malloc(), so it is part of the
+  // allocated objects.
+  for (const internal::ObjectPoolBase::Stats& stats :
+       internal::ObjectPoolBase::GetStatsForAllPools()) {
+    MemoryAllocatorDump* pool_dump =
+        pmd->CreateAllocatorDump(StrCat({"malloc/object_pools/", stats.name}));
+    pool_dump->AddScalar(MemoryAllocatorDump::kNameSize,
+                         MemoryAllocatorDump::kUnitsBytes,
+                         stats.allocated_size);
+    pool_dump->AddScalar(MemoryAllocatorDump::kNameObjectCount,
+                         MemoryAllocatorDump::kUnitsObjects,
+                         stats.allocated_slots);
+    pool_dump->AddScalar("shared_cached_size",
+                         MemoryAllocatorDump::kUnitsBytes,
+                         stats.shared_cached_size);
+    pmd->AddSuballocation(pool_dump->guid(), kAllocatedObjects);
+  }
+
   int64_t waste = static_cast<int64_t>(resident_size - allocated_objects_size);
 
   // With PartitionAlloc, reported size under malloc/partitions is the resident
@@ -328,7 +328,7 @@ void MemoryDumpManager::CreateProcessDump(const MemoryDumpRequestArgs& args,
 
     pmd_async_state = std::make_unique<ProcessMemoryDumpAsyncState>(
         args, dump_providers_, std::move(callback),
-        GetOrCreateBgTaskRunnerLocked());
+        GetOrCreateBgTaskRunnerLocked(), next_dump_sequence_number_++);
   }
 
   // Start the process dump. This involves task runner hops as specified by the
@@ -472,11 +472,43 @@ void MemoryDumpManager::InvokeOnMemoryDump(MemoryDumpProviderInfo* mdpinfo,
   CHECK(!is_thread_bound ||
         !*(static_cast<volatile bool*>(&mdpinfo->disabled)));
   bool dump_successful =
-      mdpinfo->dump_provider->OnMemoryDump(pmd->dump_args(), pmd);
+      mdpinfo->options.supports_incremental_dumps
+          ? InvokeIncrementalOnMemoryDump(mdpinfo, pmd)
+          : mdpinfo->dump_provider->OnMemoryDump(pmd->dump_args(), pmd);
   mdpinfo->consecutive_failures =
       dump_successful ? 0 : mdpinfo->consecutive_failures + 1;
 }
 
+// static
+bool MemoryDumpManager::InvokeIncrementalOnMemoryDump(
+    MemoryDumpProviderInfo* mdpinfo,
+    ProcessMemoryDump* pmd) {
+  MemoryDumpArgs args = pmd->dump_args();
+  // Deterministic dumps, and dumps with another level of detail than the last
+  // one, are full dumps.
+  const bool is_incremental =
+      mdpinfo->last_dump &&
+      args.determinism == MemoryDumpDeterminism::kNone &&
+      mdpinfo->last_dump->dump_args().level_of_detail == args.level_of_detail;
+  args.last_dump_sequence_number =
+      is_incremental ? mdpinfo->last_dump_sequence_number : 0;
+
+  auto dump = std::make_unique<ProcessMemoryDump>(args);
+  if (!mdpinfo->dump_provider->OnMemoryDump(args, dump.get())) {
+    // The changes since the last dump are lost, so the next one is full.
+    mdpinfo->last_dump.reset();
+    return false;
+  }
+  if (is_incremental) {
+    mdpinfo->last_dump->ApplyIncrementalDump(dump.get());
+  } else {
+    mdpinfo->last_dump = std::move(dump);
+  }
+  mdpinfo->last_dump_sequence_number = args.sequence_number;
+  pmd->CopyAllDumpsFrom(*mdpinfo->last_dump);
+  return true;
+}
+
 void MemoryDumpManager::FinishAsyncProcessDump(
     std::unique_ptr<ProcessMemoryDumpAsyncState> pmd_async_state) {
   HEAP_PROFILER_SCOPED_IGNORE;
@@ -543,7 +575,8 @@ MemoryDumpManager::ProcessMemoryDumpAsyncState::ProcessMemoryDumpAsyncState(
     MemoryDumpRequestArgs req_args,
     const MemoryDumpProviderInfo::OrderedSet& dump_providers,
     ProcessMemoryDumpCallback callback,
-    scoped_refptr<SequencedTaskRunner> dump_thread_task_runner)
+    scoped_refptr<SequencedTaskRunner> dump_thread_task_runner,
+    uint64_t sequence_number)
     : req_args(req_args),
       callback(std::move(callback)),
       callback_task_runner(SingleThreadTaskRunner::GetCurrentDefault()),
@@ -551,7 +584,7 @@ MemoryDumpManager::ProcessMemoryDumpAsyncState::ProcessMemoryDumpAsyncState(
   pending_dump_providers.reserve(dump_providers.size());
   pending_dump_providers.assign(dump_providers.rbegin(), dump_providers.rend());
   MemoryDumpArgs args = {req_args.level_of_detail, req_args.determinism,
-                         req_args.dump_guid};
+                         req_args.dump_guid, sequence_number};
   process_memory_dump = std::make_unique<ProcessMemoryDump>(args);
 }
 
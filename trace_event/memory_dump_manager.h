@@ -173,7 +173,8 @@ class BASE_EXPORT MemoryDumpManager {
         MemoryDumpRequestArgs req_args,
         const MemoryDumpProviderInfo::OrderedSet& dump_providers,
         ProcessMemoryDumpCallback callback,
-        scoped_refptr<SequencedTaskRunner> dump_thread_task_runner);
+        scoped_refptr<SequencedTaskRunner> dump_thread_task_runner,
+        uint64_t sequence_number);
     ProcessMemoryDumpAsyncState(const ProcessMemoryDumpAsyncState&) = delete;
     ProcessMemoryDumpAsyncState& operator=(const ProcessMemoryDumpAsyncState&) =
         delete;
@@ -230,6 +231,11 @@ class BASE_EXPORT MemoryDumpManager {
   void InvokeOnMemoryDump(MemoryDumpProviderInfo* mdpinfo,
                           ProcessMemoryDump* pmd);
 
+  // Invokes OnMemoryDump() of the given MDP which supports incremental dumps,
+  // and adds its last dump with the changes applied to |pmd|.
+  static bool InvokeIncrementalOnMemoryDump(MemoryDumpProviderInfo* mdpinfo,
+                                            ProcessMemoryDump* pmd);
+
   void FinishAsyncProcessDump(
       std::unique_ptr<ProcessMemoryDumpAsyncState> pmd_async_state);
 
@@ -266,6 +272,9 @@ class BASE_EXPORT MemoryDumpManager {
   // affinity.
   std::unique_ptr<Thread> dump_thread_ GUARDED_BY(lock_);
 
+  // The MemoryDumpArgs::sequence_number of the next dump.
+  uint64_t next_dump_sequence_number_ GUARDED_BY(lock_) = 1;
+
   // The unique id of the child process. This is created only for tracing and is
   // expected to be valid only when tracing is enabled.
   uint64_t tracing_process_id_ = kInvalidTracingProcessId;
@@ -202,9 +202,12 @@ class MemoryDumpManagerTest : public testing::Test {
   // Blocks the current thread (spinning a nested message loop) until the
   // memory dump is complete. Returns:
   // - return value: the |success| from the CreateProcessDump() callback.
-  bool RequestProcessDumpAndWait(MemoryDumpType dump_type,
-                                 MemoryDumpLevelOfDetail level_of_detail,
-                                 MemoryDumpDeterminism determinism) {
+  // - |pmd|: if not null, the ProcessMemoryDump from the callback.
+  bool RequestProcessDumpAndWait(
+      MemoryDumpType dump_type,
+      MemoryDumpLevelOfDetail level_of_detail,
+      MemoryDumpDeterminism determinism,
+      std::unique_ptr<ProcessMemoryDump>* pmd_out = nullptr) {
     RunLoop run_loop;
     bool success = false;
     static uint64_t test_guid = 1;
@@ -223,14 +226,19 @@ class MemoryDumpManagerTest : public testing::Test {
     // lambdas.
     ProcessMemoryDumpCallback callback = BindOnce(
         [](bool* curried_success, OnceClosure curried_quit_closure,
-           uint64_t curried_expected_guid, bool success, uint64_t dump_guid,
-           std::unique_ptr<ProcessMemoryDump> pmd) {
+           uint64_t curried_expected_guid,
+           std::unique_ptr<ProcessMemoryDump>* curried_pmd_out, bool success,
+           uint64_t dump_guid, std::unique_ptr<ProcessMemoryDump> pmd) {
           *curried_success = success;
           EXPECT_EQ(curried_expected_guid, dump_guid);
+          if (curried_pmd_out) {
+            *curried_pmd_out = std::move(pmd);
+          }
           SingleThreadTaskRunner::GetCurrentDefault()->PostTask(
               FROM_HERE, std::move(curried_quit_closure));
         },
-        Unretained(&success), run_loop.QuitClosure(), test_guid);
+        Unretained(&success), run_loop.QuitClosure(), test_guid,
+        Unretained(pmd_out));
 
     mdm_->CreateProcessDump(request_args, std::move(callback));
     run_loop.Run();
@@ -333,6 +341,69 @@ TEST_F(MemoryDumpManagerTest, CheckMemoryDumpArgs) {
   mdm_->UnregisterDumpProvider(&mdp);
 }
 
+// Checks that providers which support incremental dumps only have to dump what
+// changed since their last dump, and that the complete dump is reported.
+TEST_F(MemoryDumpManagerTest, IncrementalDumps) {
+  MockMemoryDumpProvider mdp;
+  MemoryDumpProvider::Options options;
+  options.supports_incremental_dumps = true;
+  RegisterDumpProvider(&mdp, SingleThreadTaskRunner::GetCurrentDefault(),
+                       options);
+  EnableForTracing();
+
+  std::vector<uint64_t> last_dump_sequence_numbers;
+  uint64_t sequence_number = 0;
+  EXPECT_CALL(mdp, OnMemoryDump(_, _))
+      .WillRepeatedly(
+          Invoke([&](const MemoryDumpArgs& args, ProcessMemoryDump* pmd) {
+            last_dump_sequence_numbers.push_back(
+                args.last_dump_sequence_number);
+            if (args.last_dump_sequence_number == 0) {
+              pmd->CreateAllocatorDump("mdp/stable");
+              pmd->CreateAllocatorDump("mdp/removed");
+            } else {
+              EXPECT_EQ(sequence_number, args.last_dump_sequence_number);
+              pmd->CreateAllocatorDump("mdp/added");
+              pmd->AddRemovedAllocatorDump("mdp/removed");
+            }
+            EXPECT_GT(args.sequence_number, sequence_number);
+            sequence_number = args.sequence_number;
+            return true;
+          }));
+
+  std::unique_ptr<ProcessMemoryDump> pmd;
+  EXPECT_TRUE(RequestProcessDumpAndWait(MemoryDumpType::kExplicitlyTriggered,
+                                        MemoryDumpLevelOfDetail::kDetailed,
+                                        MemoryDumpDeterminism::kNone, &pmd));
+  ASSERT_TRUE(pmd);
+  EXPECT_TRUE(pmd->GetAllocatorDump("mdp/stable"));
+  EXPECT_TRUE(pmd->GetAllocatorDump("mdp/removed"));
+
+  EXPECT_TRUE(RequestProcessDumpAndWait(MemoryDumpType::kExplicitlyTriggered,
+                                        MemoryDumpLevelOfDetail::kDetailed,
+                                        MemoryDumpDeterminism::kNone, &pmd));
+  ASSERT_TRUE(pmd);
+  EXPECT_TRUE(pmd->GetAllocatorDump("mdp/stable"));
+  EXPECT_TRUE(pmd->GetAllocatorDump("mdp/added"));
+  EXPECT_FALSE(pmd->GetAllocatorDump("mdp/removed"));
+
+  // Dumps with another level of detail are full dumps.
+  EXPECT_TRUE(RequestProcessDumpAndWait(MemoryDumpType::kExplicitlyTriggered,
+                                        MemoryDumpLevelOfDetail::kLight,
+                                        MemoryDumpDeterminism::kNone, &pmd));
+  ASSERT_TRUE(pmd);
+  EXPECT_TRUE(pmd->GetAllocatorDump("mdp/removed"));
+  EXPECT_FALSE(pmd->GetAllocatorDump("mdp/added"));
+
+  ASSERT_EQ(3u, last_dump_sequence_numbers.size());
+  EXPECT_EQ(0u, last_dump_sequence_numbers[0]);
+  EXPECT_NE(0u, last_dump_sequence_numbers[1]);
+  EXPECT_EQ(0u, last_dump_sequence_numbers[2]);
+
+  DisableTracing();
+  mdm_->UnregisterDumpProvider(&mdp);
+}
+
 // Checks that requesting deterministic dumps actually propagates
 // the deterministic option properly to OnMemoryDump() call on dump providers.
 TEST_F(MemoryDumpManagerTest, CheckMemoryDumpArgsDeterministic) {
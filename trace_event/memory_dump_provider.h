@@ -19,12 +19,22 @@ class BASE_EXPORT MemoryDumpProvider {
  public:
   // Optional arguments for MemoryDumpManager::RegisterDumpProvider().
   struct Options {
-    Options() : dumps_on_single_thread_task_runner(false) {}
+    Options()
+        : dumps_on_single_thread_task_runner(false),
+          supports_incremental_dumps(false) {}
 
     // |dumps_on_single_thread_task_runner| is true if the dump provider runs on
     // a SingleThreadTaskRunner, which is usually the case. It is faster to run
     // all providers that run on the same thread together without thread hops.
     bool dumps_on_single_thread_task_runner;
+
+    // |supports_incremental_dumps| is true if the dump provider can dump only
+    // what changed since its previous dump, when
+    // MemoryDumpArgs::last_dump_sequence_number is set. The MemoryDumpManager
+    // then keeps the last dump of the provider, and applies the changes to it.
+    // This makes periodic dumps of providers with many, mostly stable,
+    // allocator dumps much cheaper.
+    bool supports_incremental_dumps;
   };
 
   MemoryDumpProvider(const MemoryDumpProvider&) = delete;
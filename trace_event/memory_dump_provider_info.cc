@@ -7,6 +7,7 @@
 #include <tuple>
 
 #include "base/task/sequenced_task_runner.h"
+#include "base/trace_event/process_memory_dump.h"
 
 namespace base {
 namespace trace_event {
@@ -5,6 +5,8 @@
 #ifndef BASE_TRACE_EVENT_MEMORY_DUMP_PROVIDER_INFO_H_
 #define BASE_TRACE_EVENT_MEMORY_DUMP_PROVIDER_INFO_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <set>
 
@@ -102,6 +104,12 @@ struct BASE_EXPORT MemoryDumpProviderInfo
   // Flagged either by the auto-disable logic or during unregistration.
   bool disabled;
 
+  // For the MDPs which support incremental dumps, the allocator dumps and
+  // edges of their last successful dump, with the incremental dumps since
+  // applied, and the sequence number of that last dump.
+  std::unique_ptr<ProcessMemoryDump> last_dump;
+  uint64_t last_dump_sequence_number = 0;
+
  private:
   friend class base::RefCountedThreadSafe<MemoryDumpProviderInfo>;
   ~MemoryDumpProviderInfo();
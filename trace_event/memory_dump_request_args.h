@@ -88,6 +88,19 @@ struct MemoryDumpArgs {
   // local dump with the same guid. This allows the trace importers to
   // reconstruct the global dump.
   uint64_t dump_guid;
+
+  // Increases with each dump of the process. 0 outside of the
+  // MemoryDumpManager.
+  uint64_t sequence_number = 0;
+
+  // Only for the dump providers which support incremental dumps (see
+  // MemoryDumpProvider::Options). If not 0, the |sequence_number| of the last
+  // successful dump of the provider: the provider only has to create the
+  // allocator dumps and edges which changed since, and to report the dumps
+  // which don't exist anymore with
+  // ProcessMemoryDump::AddRemovedAllocatorDump(). The others are kept from the
+  // previous dumps. If 0, a full dump is needed.
+  uint64_t last_dump_sequence_number = 0;
 };
 
 using ProcessMemoryDumpCallback = OnceCallback<
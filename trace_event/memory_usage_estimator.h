@@ -15,6 +15,7 @@
 #include <array>
 #include <concepts>
 #include <deque>
+#include <iterator>
 #include <list>
 #include <map>
 #include <memory>
@@ -25,15 +26,19 @@
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "base/base_export.h"
+#include "base/check_op.h"
 #include "base/containers/circular_deque.h"
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
+#include "base/containers/id_map.h"
 #include "base/containers/linked_list.h"
 #include "base/containers/lru_cache.h"
 #include "base/containers/queue.h"
+#include "base/containers/small_map.h"
 #include "base/memory/raw_ptr.h"
 #include "base/stl_util.h"
 #include "base/types/always_false.h"
@@ -202,6 +207,63 @@ size_t EstimateMemoryUsage(const base::LRUCacheSet<V, C>& lru);
 template <class V, class C>
 size_t EstimateMemoryUsage(const base::HashingLRUCacheSet<V, C>& lru);
 
+template <class M, size_t N, class E, class I>
+size_t EstimateMemoryUsage(const base::small_map<M, N, E, I>& map);
+
+template <class V, class K>
+size_t EstimateMemoryUsage(const base::IDMap<V, K>& map);
+
+// EstimateShallowMemoryUsage() estimates the memory of a container's own
+// storage, in O(1), without the memory which its items allocate. Along with an
+// IncrementalMemoryUsage of the items (see below), it estimates the memory of
+// big containers without walking them on every memory dump.
+
+template <class T, class A>
+size_t EstimateShallowMemoryUsage(const std::vector<T, A>& vector);
+
+template <class T, class A>
+size_t EstimateShallowMemoryUsage(const std::list<T, A>& list);
+
+template <class T, class C, class A>
+size_t EstimateShallowMemoryUsage(const std::set<T, C, A>& set);
+
+template <class K, class V, class C, class A>
+size_t EstimateShallowMemoryUsage(const std::map<K, V, C, A>& map);
+
+template <class T, class H, class KE, class A>
+size_t EstimateShallowMemoryUsage(const std::unordered_set<T, H, KE, A>& set);
+
+template <class K, class V, class H, class KE, class A>
+size_t EstimateShallowMemoryUsage(
+    const std::unordered_map<K, V, H, KE, A>& map);
+
+template <class T>
+size_t EstimateShallowMemoryUsage(const base::circular_deque<T>& deque);
+
+template <class T, class C>
+size_t EstimateShallowMemoryUsage(const base::flat_set<T, C>& set);
+
+template <class K, class V, class C>
+size_t EstimateShallowMemoryUsage(const base::flat_map<K, V, C>& map);
+
+template <class K, class V, class C>
+size_t EstimateShallowMemoryUsage(const base::LRUCache<K, V, C>& lru);
+
+template <class K, class V, class C>
+size_t EstimateShallowMemoryUsage(const base::HashingLRUCache<K, V, C>& lru);
+
+template <class V, class C>
+size_t EstimateShallowMemoryUsage(const base::LRUCacheSet<V, C>& lru);
+
+template <class V, class C>
+size_t EstimateShallowMemoryUsage(const base::HashingLRUCacheSet<V, C>& lru);
+
+template <class M, size_t N, class E, class I>
+size_t EstimateShallowMemoryUsage(const base::small_map<M, N, E, I>& map);
+
+template <class V, class K>
+size_t EstimateShallowMemoryUsage(const base::IDMap<V, K>& map);
+
 // TODO(dskiba):
 //   std::forward_list
 
@@ -251,6 +313,16 @@ concept IsKnownNonAllocatingType =
     std::is_trivially_destructible_v<T> || base::IsRawPtrV<T> ||
     IsIteratorOfStandardContainer<T>;
 
+// Whether EstimateItemMemoryUsage() is always 0 for T, so that the items of a
+// container don't need to be walked.
+template <typename T>
+inline constexpr bool kNeverAllocates =
+    !HasEMU<T> && IsKnownNonAllocatingType<T>;
+
+template <typename F, typename S>
+inline constexpr bool kNeverAllocates<std::pair<F, S>> =
+    kNeverAllocates<std::remove_cv_t<F>> && kNeverAllocates<S>;
+
 }  // namespace internal
 
 // Estimates T's memory usage as follows:
@@ -277,11 +349,17 @@ size_t EstimateItemMemoryUsage(const T& value) {
 
 template <class I>
 size_t EstimateIterableMemoryUsage(const I& iterable) {
-  size_t memory_usage = 0;
-  for (const auto& item : iterable) {
-    memory_usage += EstimateItemMemoryUsage(item);
+  using Item = std::remove_cvref_t<decltype(*std::begin(iterable))>;
+  // Don't walk the items if none of them can allocate.
+  if constexpr (internal::kNeverAllocates<Item>) {
+    return 0;
+  } else {
+    size_t memory_usage = 0;
+    for (const auto& item : iterable) {
+      memory_usage += EstimateItemMemoryUsage(item);
+    }
+    return memory_usage;
   }
-  return memory_usage;
 }
 
 // Global EstimateMemoryUsage(T) that just calls T::EstimateMemoryUsage().
@@ -381,23 +459,33 @@ size_t EstimateMemoryUsage(const std::pair<F, S>& pair) {
 
 // std::vector
 
+template <class T, class A>
+size_t EstimateShallowMemoryUsage(const std::vector<T, A>& vector) {
+  return sizeof(T) * vector.capacity();
+}
+
 template <class T, class A>
 size_t EstimateMemoryUsage(const std::vector<T, A>& vector) {
-  return sizeof(T) * vector.capacity() + EstimateIterableMemoryUsage(vector);
+  return EstimateShallowMemoryUsage(vector) +
+         EstimateIterableMemoryUsage(vector);
 }
 
 // std::list
 
 template <class T, class A>
-size_t EstimateMemoryUsage(const std::list<T, A>& list) {
+size_t EstimateShallowMemoryUsage(const std::list<T, A>& list) {
   using value_type = typename std::list<T, A>::value_type;
   struct Node {
     raw_ptr<Node> prev;
     raw_ptr<Node> next;
     value_type value;
   };
-  return sizeof(Node) * list.size() +
-         EstimateIterableMemoryUsage(list);
+  return sizeof(Node) * list.size();
+}
+
+template <class T, class A>
+size_t EstimateMemoryUsage(const std::list<T, A>& list) {
+  return EstimateShallowMemoryUsage(list) + EstimateIterableMemoryUsage(list);
 }
 
 template <class T>
@@ -429,10 +517,14 @@ size_t EstimateTreeMemoryUsage(size_t size) {
 }
 
 template <class T, class C, class A>
-size_t EstimateMemoryUsage(const std::set<T, C, A>& set) {
+size_t EstimateShallowMemoryUsage(const std::set<T, C, A>& set) {
   using value_type = typename std::set<T, C, A>::value_type;
-  return EstimateTreeMemoryUsage<value_type>(set.size()) +
-         EstimateIterableMemoryUsage(set);
+  return EstimateTreeMemoryUsage<value_type>(set.size());
+}
+
+template <class T, class C, class A>
+size_t EstimateMemoryUsage(const std::set<T, C, A>& set) {
+  return EstimateShallowMemoryUsage(set) + EstimateIterableMemoryUsage(set);
 }
 
 template <class T, class C, class A>
@@ -443,10 +535,14 @@ size_t EstimateMemoryUsage(const std::multiset<T, C, A>& set) {
 }
 
 template <class K, class V, class C, class A>
-size_t EstimateMemoryUsage(const std::map<K, V, C, A>& map) {
+size_t EstimateShallowMemoryUsage(const std::map<K, V, C, A>& map) {
   using value_type = typename std::map<K, V, C, A>::value_type;
-  return EstimateTreeMemoryUsage<value_type>(map.size()) +
-         EstimateIterableMemoryUsage(map);
+  return EstimateTreeMemoryUsage<value_type>(map.size());
+}
+
+template <class K, class V, class C, class A>
+size_t EstimateMemoryUsage(const std::map<K, V, C, A>& map) {
+  return EstimateShallowMemoryUsage(map) + EstimateIterableMemoryUsage(map);
 }
 
 template <class K, class V, class C, class A>
@@ -476,6 +572,24 @@ size_t DoEstimateMemoryUsageForLruCache(const LruCacheType& lru_cache) {
          EstimateMemoryUsage(lru_cache.index_);
 }
 
+template <class LruCacheType>
+size_t DoEstimateShallowMemoryUsageForLruCache(const LruCacheType& lru_cache) {
+  return EstimateShallowMemoryUsage(lru_cache.ordering_) +
+         EstimateShallowMemoryUsage(lru_cache.index_);
+}
+
+template <class IDMapType>
+size_t DoEstimateMemoryUsageForIDMap(const IDMapType& id_map) {
+  return EstimateMemoryUsage(id_map.data_) +
+         EstimateMemoryUsage(id_map.removed_ids_);
+}
+
+template <class IDMapType>
+size_t DoEstimateShallowMemoryUsageForIDMap(const IDMapType& id_map) {
+  return EstimateShallowMemoryUsage(id_map.data_) +
+         EstimateShallowMemoryUsage(id_map.removed_ids_);
+}
+
 }  // namespace internal
 
 template <class V>
@@ -493,11 +607,15 @@ size_t EstimateHashMapMemoryUsage(size_t bucket_count, size_t size) {
 }
 
 template <class K, class H, class KE, class A>
-size_t EstimateMemoryUsage(const std::unordered_set<K, H, KE, A>& set) {
+size_t EstimateShallowMemoryUsage(const std::unordered_set<K, H, KE, A>& set) {
   using value_type = typename std::unordered_set<K, H, KE, A>::value_type;
   return EstimateHashMapMemoryUsage<value_type>(set.bucket_count(),
-                                                set.size()) +
-         EstimateIterableMemoryUsage(set);
+                                                set.size());
+}
+
+template <class K, class H, class KE, class A>
+size_t EstimateMemoryUsage(const std::unordered_set<K, H, KE, A>& set) {
+  return EstimateShallowMemoryUsage(set) + EstimateIterableMemoryUsage(set);
 }
 
 template <class K, class H, class KE, class A>
@@ -509,11 +627,16 @@ size_t EstimateMemoryUsage(const std::unordered_multiset<K, H, KE, A>& set) {
 }
 
 template <class K, class V, class H, class KE, class A>
-size_t EstimateMemoryUsage(const std::unordered_map<K, V, H, KE, A>& map) {
+size_t EstimateShallowMemoryUsage(
+    const std::unordered_map<K, V, H, KE, A>& map) {
   using value_type = typename std::unordered_map<K, V, H, KE, A>::value_type;
   return EstimateHashMapMemoryUsage<value_type>(map.bucket_count(),
-                                                map.size()) +
-         EstimateIterableMemoryUsage(map);
+                                                map.size());
+}
+
+template <class K, class V, class H, class KE, class A>
+size_t EstimateMemoryUsage(const std::unordered_map<K, V, H, KE, A>& map) {
+  return EstimateShallowMemoryUsage(map) + EstimateIterableMemoryUsage(map);
 }
 
 template <class K, class V, class H, class KE, class A>
@@ -595,23 +718,38 @@ size_t EstimateMemoryUsage(const std::stack<T, C>& stack) {
 
 // base::circular_deque
 
+template <class T>
+size_t EstimateShallowMemoryUsage(const base::circular_deque<T>& deque) {
+  return sizeof(T) * deque.capacity();
+}
+
 template <class T>
 size_t EstimateMemoryUsage(const base::circular_deque<T>& deque) {
-  return sizeof(T) * deque.capacity() + EstimateIterableMemoryUsage(deque);
+  return EstimateShallowMemoryUsage(deque) + EstimateIterableMemoryUsage(deque);
 }
 
 // Flat containers
 
 template <class T, class C>
-size_t EstimateMemoryUsage(const base::flat_set<T, C>& set) {
+size_t EstimateShallowMemoryUsage(const base::flat_set<T, C>& set) {
   using value_type = typename base::flat_set<T, C>::value_type;
-  return sizeof(value_type) * set.capacity() + EstimateIterableMemoryUsage(set);
+  return sizeof(value_type) * set.capacity();
+}
+
+template <class T, class C>
+size_t EstimateMemoryUsage(const base::flat_set<T, C>& set) {
+  return EstimateShallowMemoryUsage(set) + EstimateIterableMemoryUsage(set);
 }
 
 template <class K, class V, class C>
-size_t EstimateMemoryUsage(const base::flat_map<K, V, C>& map) {
+size_t EstimateShallowMemoryUsage(const base::flat_map<K, V, C>& map) {
   using value_type = typename base::flat_map<K, V, C>::value_type;
-  return sizeof(value_type) * map.capacity() + EstimateIterableMemoryUsage(map);
+  return sizeof(value_type) * map.capacity();
+}
+
+template <class K, class V, class C>
+size_t EstimateMemoryUsage(const base::flat_map<K, V, C>& map) {
+  return EstimateShallowMemoryUsage(map) + EstimateIterableMemoryUsage(map);
 }
 
 template <class K, class V, class C>
@@ -634,6 +772,100 @@ size_t EstimateMemoryUsage(const HashingLRUCacheSet<V, C>& lru_cache) {
   return internal::DoEstimateMemoryUsageForLruCache(lru_cache);
 }
 
+template <class K, class V, class C>
+size_t EstimateShallowMemoryUsage(const LRUCache<K, V, C>& lru_cache) {
+  return internal::DoEstimateShallowMemoryUsageForLruCache(lru_cache);
+}
+
+template <class K, class V, class C>
+size_t EstimateShallowMemoryUsage(const HashingLRUCache<K, V, C>& lru_cache) {
+  return internal::DoEstimateShallowMemoryUsageForLruCache(lru_cache);
+}
+
+template <class V, class C>
+size_t EstimateShallowMemoryUsage(const LRUCacheSet<V, C>& lru_cache) {
+  return internal::DoEstimateShallowMemoryUsageForLruCache(lru_cache);
+}
+
+template <class V, class C>
+size_t EstimateShallowMemoryUsage(const HashingLRUCacheSet<V, C>& lru_cache) {
+  return internal::DoEstimateShallowMemoryUsageForLruCache(lru_cache);
+}
+
+// base::small_map
+
+template <class M, size_t N, class E, class I>
+size_t EstimateShallowMemoryUsage(const base::small_map<M, N, E, I>& map) {
+  // The inline array isn't a separate allocation.
+  return map.UsingFullMap() ? EstimateShallowMemoryUsage(*map.map()) : 0;
+}
+
+template <class M, size_t N, class E, class I>
+size_t EstimateMemoryUsage(const base::small_map<M, N, E, I>& map) {
+  return EstimateShallowMemoryUsage(map) + EstimateIterableMemoryUsage(map);
+}
+
+// base::IDMap
+
+template <class V, class K>
+size_t EstimateShallowMemoryUsage(const base::IDMap<V, K>& id_map) {
+  return internal::DoEstimateShallowMemoryUsageForIDMap(id_map);
+}
+
+template <class V, class K>
+size_t EstimateMemoryUsage(const base::IDMap<V, K>& id_map) {
+  return internal::DoEstimateMemoryUsageForIDMap(id_map);
+}
+
+// Maintains the estimated memory which the items of a container allocate, as
+// they are inserted and erased, so that it isn't computed by walking all of the
+// items on every memory dump:
+//
+//   class MyCache {
+//    public:
+//     void Put(std::string key, Entry entry) {
+//       items_memory_usage_.Add(key, entry);
+//       map_.emplace(std::move(key), std::move(entry));
+//     }
+//     void Erase(const std::string& key) {
+//       auto it = map_.find(key);
+//       items_memory_usage_.Remove(it->first, it->second);
+//       map_.erase(it);
+//     }
+//     size_t EstimateMemoryUsage() const {
+//       return base::trace_event::EstimateShallowMemoryUsage(map_) +
+//              items_memory_usage_.Get();
+//     }
+//
+//    private:
+//     std::map<std::string, Entry> map_;
+//     base::trace_event::IncrementalMemoryUsage items_memory_usage_;
+//   };
+//
+// The items must be removed with the same estimation as they were added, so an
+// item which is modified in place must be removed before, and added after.
+class IncrementalMemoryUsage {
+ public:
+  template <class... Ts>
+  void Add(const Ts&... items) {
+    bytes_ += (EstimateItemMemoryUsage(items) + ... + 0);
+  }
+
+  template <class... Ts>
+  void Remove(const Ts&... items) {
+    const size_t bytes = (EstimateItemMemoryUsage(items) + ... + 0);
+    DCHECK_GE(bytes_, bytes);
+    bytes_ -= bytes;
+  }
+
+  void Clear() { bytes_ = 0; }
+
+  size_t Get() const { return bytes_; }
+
+ private:
+  size_t bytes_ = 0;
+};
+
 }  // namespace trace_event
 }  // namespace base
 
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "base/memory/ptr_util.h"
+#include "base/values.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -265,6 +266,91 @@ TEST(EstimateMemoryUsageTest, Deque) {
   EXPECT_LE(min_expected_usage, EstimateMemoryUsage(deque));
 }
 
+TEST(EstimateMemoryUsageTest, SmallMap) {
+  small_map<std::map<int, Data>, 2> map;
+  map.emplace(1, Data(10));
+  map.emplace(2, Data(20));
+  // The inline array doesn't count.
+  EXPECT_EQ(30u, EstimateMemoryUsage(map));
+  EXPECT_EQ(0u, EstimateShallowMemoryUsage(map));
+
+  map.emplace(3, Data(30));
+  ASSERT_TRUE(map.UsingFullMap());
+  EXPECT_EQ(EstimateMemoryUsage(*map.map()), EstimateMemoryUsage(map));
+  EXPECT_EQ(EstimateMemoryUsage(*map.map()),
+            EstimateShallowMemoryUsage(map) + 60u);
+}
+
+TEST(EstimateMemoryUsageTest, IDMap) {
+  IDMap<std::unique_ptr<Data>> map;
+  map.Add(std::make_unique<Data>(10));
+  map.Add(std::make_unique<Data>(20));
+  const size_t shallow_usage = EstimateShallowMemoryUsage(map);
+  EXPECT_LT(0u, shallow_usage);
+  EXPECT_EQ(shallow_usage + 2 * sizeof(Data) + 30u, EstimateMemoryUsage(map));
+
+  // The pointers which aren't owned don't count.
+  Data data(10);
+  IDMap<Data*> raw_map;
+  raw_map.Add(&data);
+  EXPECT_EQ(EstimateShallowMemoryUsage(raw_map), EstimateMemoryUsage(raw_map));
+}
+
+TEST(EstimateMemoryUsageTest, Value) {
+  Value::List list;
+  list.Append(std::string(1000, 'a'));
+  EXPECT_LE(1000u, EstimateMemoryUsage(list));
+  EXPECT_LE(1000u, EstimateMemoryUsage(Value(std::move(list))));
+}
+
+TEST(EstimateMemoryUsageTest, ShallowMemoryUsage) {
+  std::vector<Data> vector(10, Data(100));
+  EXPECT_EQ(sizeof(Data) * vector.capacity(),
+            EstimateShallowMemoryUsage(vector));
+  EXPECT_EQ(EstimateShallowMemoryUsage(vector) + 1000u,
+            EstimateMemoryUsage(vector));
+
+  base::flat_map<int, Data> flat_map;
+  flat_map.emplace(1, Data(100));
+  EXPECT_EQ(EstimateShallowMemoryUsage(flat_map) + 100u,
+            EstimateMemoryUsage(flat_map));
+
+  LRUCache<int, Data> lru_cache(10);
+  lru_cache.Put(1, Data(100));
+  lru_cache.Put(2, Data(200));
+  EXPECT_EQ(EstimateShallowMemoryUsage(lru_cache) + 300u,
+            EstimateMemoryUsage(lru_cache));
+}
+
+TEST(EstimateMemoryUsageTest, IncrementalMemoryUsage) {
+  std::map<std::string, Data> map;
+  IncrementalMemoryUsage items_memory_usage;
+  for (int i = 0; i < 100; ++i) {
+    std::string key(100, static_cast<char>(i));
+    Data data(i);
+    items_memory_usage.Add(key, data);
+    map.emplace(std::move(key), data);
+  }
+  EXPECT_EQ(EstimateMemoryUsage(map),
+            EstimateShallowMemoryUsage(map) + items_memory_usage.Get());
+
+  auto it = map.begin();
+  items_memory_usage.Remove(it->first, it->second);
+  map.erase(it);
+  EXPECT_EQ(EstimateMemoryUsage(map),
+            EstimateShallowMemoryUsage(map) + items_memory_usage.Get());
+
+  items_memory_usage.Clear();
+  EXPECT_EQ(0u, items_memory_usage.Get());
+}
+
+TEST(EstimateMemoryUsageTest, NeverAllocates) {
+  static_assert(internal::kNeverAllocates<int>);
+  static_assert(internal::kNeverAllocates<std::pair<const int, int*>>);
+  static_assert(!internal::kNeverAllocates<std::string>);
+  static_assert(!internal::kNeverAllocates<std::pair<const int, Data>>);
+}
+
 TEST(EstimateMemoryUsageTest, IsStandardContainerComplexIteratorTest) {
   struct abstract {
     virtual void method() = 0;
@@ -390,6 +390,7 @@ void ProcessMemoryDump::SetAllEdgesForSerialization(
 void ProcessMemoryDump::Clear() {
   allocator_dumps_.clear();
   allocator_dumps_edges_.clear();
+  removed_allocator_dumps_.clear();
 }
 
 void ProcessMemoryDump::TakeAllDumpsFrom(ProcessMemoryDump* other) {
@@ -405,6 +406,51 @@ void ProcessMemoryDump::TakeAllDumpsFrom(ProcessMemoryDump* other) {
   other->allocator_dumps_edges_.clear();
 }
 
+void ProcessMemoryDump::CopyAllDumpsFrom(const ProcessMemoryDump& other) {
+  for (const auto& it : other.allocator_dumps_) {
+    const MemoryAllocatorDump& mad = *it.second;
+    auto copy = std::make_unique<MemoryAllocatorDump>(
+        mad.absolute_name(), mad.level_of_detail(), mad.guid());
+    copy->set_flags(mad.flags());
+    for (const MemoryAllocatorDump::Entry& entry : mad.entries()) {
+      if (entry.entry_type == MemoryAllocatorDump::Entry::kUint64) {
+        copy->AddScalar(entry.name.c_str(), entry.units.c_str(),
+                        entry.value_uint64);
+      } else {
+        copy->AddString(entry.name.c_str(), entry.units.c_str(),
+                        entry.value_string);
+      }
+    }
+    AddAllocatorDumpInternal(std::move(copy));
+  }
+  allocator_dumps_edges_.insert(other.allocator_dumps_edges_.begin(),
+                                other.allocator_dumps_edges_.end());
+}
+
+void ProcessMemoryDump::AddRemovedAllocatorDump(
+    const std::string& absolute_name) {
+  removed_allocator_dumps_.push_back(absolute_name);
+}
+
+void ProcessMemoryDump::ApplyIncrementalDump(ProcessMemoryDump* delta) {
+  for (const std::string& absolute_name : delta->removed_allocator_dumps_) {
+    auto it = allocator_dumps_.find(absolute_name);
+    if (it == allocator_dumps_.end())
+      continue;
+    allocator_dumps_edges_.erase(it->second->guid());
+    allocator_dumps_.erase(it);
+  }
+  delta->removed_allocator_dumps_.clear();
+
+  for (auto& it : delta->allocator_dumps_)
+    allocator_dumps_[it.first] = std::move(it.second);
+  delta->allocator_dumps_.clear();
+
+  for (const auto& it : delta->allocator_dumps_edges_)
+    allocator_dumps_edges_.insert_or_assign(it.first, it.second);
+  delta->allocator_dumps_edges_.clear();
+}
+
 void ProcessMemoryDump::SerializeAllocatorDumpsInto(TracedValue* value) const {
   if (allocator_dumps_.size() > 0) {
     value->BeginDictionary("allocators");
@@ -9,6 +9,7 @@
 
 #include <map>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -234,6 +235,25 @@ class BASE_EXPORT ProcessMemoryDump {
   // of the MemoryDumpProvider::OnMemoryDump(ProcessMemoryDump*) callback.
   void TakeAllDumpsFrom(ProcessMemoryDump* other);
 
+  // Copies all MemoryAllocatorDump(s) and edges contained in |other| inside
+  // this ProcessMemoryDump, checking for duplicates. |other| is unchanged.
+  void CopyAllDumpsFrom(const ProcessMemoryDump& other);
+
+  // In incremental dumps (see MemoryDumpArgs::last_dump_sequence_number),
+  // records that the MemoryAllocatorDump |absolute_name| of the previous dumps
+  // doesn't exist anymore. It is removed with the edges from it.
+  void AddRemovedAllocatorDump(const std::string& absolute_name);
+  const std::vector<std::string>& removed_allocator_dumps() const {
+    return removed_allocator_dumps_;
+  }
+
+  // Applies the incremental dump |delta| onto this ProcessMemoryDump, holding
+  // the previous dumps of the same provider: the MemoryAllocatorDump(s) and
+  // edges of |delta| replace those with the same name and source, and those
+  // recorded with AddRemovedAllocatorDump() are removed. |delta| will be an
+  // empty ProcessMemoryDump after this method returns.
+  void ApplyIncrementalDump(ProcessMemoryDump* delta);
+
   // Populate the traced value with information about the memory allocator
   // dumps.
   void SerializeAllocatorDumpsInto(TracedValue* value) const;
@@ -279,6 +299,10 @@ class BASE_EXPORT ProcessMemoryDump {
   // Keeps track of relationships between MemoryAllocatorDump(s).
   AllocatorDumpEdgesMap allocator_dumps_edges_;
 
+  // The names of the MemoryAllocatorDump(s) removed since the previous dump,
+  // in incremental dumps.
+  std::vector<std::string> removed_allocator_dumps_;
+
   // Level of detail of the current dump.
   MemoryDumpArgs dump_args_;
 
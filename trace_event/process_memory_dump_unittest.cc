@@ -216,6 +216,74 @@ TEST(ProcessMemoryDumpTest, TakeAllDumpsFrom) {
   pmd1.reset();
 }
 
+TEST(ProcessMemoryDumpTest, CopyAllDumpsFrom) {
+  ProcessMemoryDump pmd1(kDetailedDumpArgs);
+  auto* mad1 = pmd1.CreateAllocatorDump("pmd1/mad1");
+  mad1->AddScalar(MemoryAllocatorDump::kNameSize,
+                  MemoryAllocatorDump::kUnitsBytes, 42);
+  mad1->AddString("name", "", "value");
+  auto* mad2 = pmd1.CreateWeakSharedGlobalAllocatorDump(
+      MemoryAllocatorDumpGuid(1));
+  pmd1.AddOwnershipEdge(mad1->guid(), mad2->guid());
+
+  ProcessMemoryDump pmd2(kDetailedDumpArgs);
+  pmd2.CopyAllDumpsFrom(pmd1);
+
+  // |pmd1| is unchanged.
+  ASSERT_EQ(2u, pmd1.allocator_dumps().size());
+  ASSERT_EQ(1u, pmd1.allocator_dumps_edges().size());
+
+  ASSERT_EQ(2u, pmd2.allocator_dumps().size());
+  const MemoryAllocatorDump* copy1 = pmd2.GetAllocatorDump("pmd1/mad1");
+  ASSERT_TRUE(copy1);
+  EXPECT_NE(mad1, copy1);
+  EXPECT_EQ(mad1->guid(), copy1->guid());
+  EXPECT_EQ(mad1->entries(), copy1->entries());
+  const MemoryAllocatorDump* copy2 =
+      pmd2.GetSharedGlobalAllocatorDump(MemoryAllocatorDumpGuid(1));
+  ASSERT_TRUE(copy2);
+  EXPECT_TRUE(MemoryAllocatorDump::Flags::WEAK & copy2->flags());
+  EXPECT_EQ(pmd1.allocator_dumps_edges(), pmd2.allocator_dumps_edges());
+}
+
+TEST(ProcessMemoryDumpTest, ApplyIncrementalDump) {
+  ProcessMemoryDump last_dump(kDetailedDumpArgs);
+  auto* unchanged = last_dump.CreateAllocatorDump("alloc/unchanged");
+  unchanged->AddScalar(MemoryAllocatorDump::kNameSize,
+                       MemoryAllocatorDump::kUnitsBytes, 1);
+  auto* changed = last_dump.CreateAllocatorDump("alloc/changed");
+  changed->AddScalar(MemoryAllocatorDump::kNameSize,
+                     MemoryAllocatorDump::kUnitsBytes, 2);
+  auto* removed = last_dump.CreateAllocatorDump("alloc/removed");
+  last_dump.AddOwnershipEdge(removed->guid(), unchanged->guid());
+  const MemoryAllocatorDumpGuid unchanged_guid = unchanged->guid();
+
+  ProcessMemoryDump delta(kDetailedDumpArgs);
+  delta.CreateAllocatorDump("alloc/changed")
+      ->AddScalar(MemoryAllocatorDump::kNameSize,
+                  MemoryAllocatorDump::kUnitsBytes, 3);
+  auto* added = delta.CreateAllocatorDump("alloc/added");
+  delta.AddOwnershipEdge(added->guid(), unchanged_guid);
+  delta.AddRemovedAllocatorDump("alloc/removed");
+  delta.AddRemovedAllocatorDump("alloc/unknown");
+
+  last_dump.ApplyIncrementalDump(&delta);
+
+  EXPECT_TRUE(delta.allocator_dumps().empty());
+  EXPECT_TRUE(delta.allocator_dumps_edges().empty());
+  EXPECT_TRUE(delta.removed_allocator_dumps().empty());
+
+  ASSERT_EQ(3u, last_dump.allocator_dumps().size());
+  EXPECT_EQ(unchanged, last_dump.GetAllocatorDump("alloc/unchanged"));
+  ASSERT_TRUE(last_dump.GetAllocatorDump("alloc/changed"));
+  EXPECT_EQ(3u, last_dump.GetAllocatorDump("alloc/changed")->GetSizeInternal());
+  ASSERT_TRUE(last_dump.GetAllocatorDump("alloc/added"));
+  EXPECT_FALSE(last_dump.GetAllocatorDump("alloc/removed"));
+  ASSERT_EQ(1u, last_dump.allocator_dumps_edges().size());
+  EXPECT_EQ(unchanged_guid,
+            last_dump.allocator_dumps_edges().begin()->second.target);
+}
+
 TEST(ProcessMemoryDumpTest, OverrideOwnershipEdge) {
   std::unique_ptr<ProcessMemoryDump> pmd(
       new ProcessMemoryDump(kDetailedDumpArgs));
@@ -14,8 +14,10 @@
 #include <vector>
 
 #include "base/functional/bind.h"
+#include "base/memory/raw_ptr.h"
 #include "base/trace_event/heap_profiler.h"
 #include "base/trace_event/trace_event_impl.h"
+#include "base/trace_event/trace_flight_recorder.h"
 
 namespace base {
 namespace trace_event {
@@ -157,6 +159,24 @@ class TraceBufferRingBuffer : public TraceBuffer {
   uint32_t current_chunk_seq_;
 };
 
+// A ring buffer which also copies the events of the returned chunks into a
+// TraceFlightRecorder.
+class TraceBufferRingBufferWithFlightRecorder : public TraceBufferRingBuffer {
+ public:
+  TraceBufferRingBufferWithFlightRecorder(size_t max_chunks,
+                                          TraceFlightRecorder* flight_recorder)
+      : TraceBufferRingBuffer(max_chunks), flight_recorder_(flight_recorder) {}
+
+  void ReturnChunk(size_t index,
+                   std::unique_ptr<TraceBufferChunk> chunk) override {
+    flight_recorder_->RecordChunk(*chunk);
+    TraceBufferRingBuffer::ReturnChunk(index, std::move(chunk));
+  }
+
+ private:
+  const raw_ptr<TraceFlightRecorder> flight_recorder_;
+};
+
 class TraceBufferVector : public TraceBuffer {
  public:
   TraceBufferVector(size_t max_chunks)
@@ -345,6 +365,14 @@ TraceBuffer* TraceBuffer::CreateTraceBufferRingBuffer(size_t max_chunks) {
   return new TraceBufferRingBuffer(max_chunks);
 }
 
+TraceBuffer* TraceBuffer::CreateTraceBufferRingBufferWithFlightRecorder(
+    size_t max_chunks,
+    TraceFlightRecorder* flight_recorder) {
+  DCHECK(flight_recorder->IsValid());
+  return new TraceBufferRingBufferWithFlightRecorder(max_chunks,
+                                                     flight_recorder);
+}
+
 TraceBuffer* TraceBuffer::CreateTraceBufferVectorOfSize(size_t max_chunks) {
   return new TraceBufferVector(max_chunks);
 }
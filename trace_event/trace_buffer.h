@@ -22,6 +22,8 @@ namespace base {
 
 namespace trace_event {
 
+class TraceFlightRecorder;
+
 // TraceBufferChunk is the basic unit of TraceBuffer.
 class BASE_EXPORT TraceBufferChunk {
  public:
@@ -84,6 +86,11 @@ class BASE_EXPORT TraceBuffer {
       TraceEventMemoryOverhead* overhead) = 0;
 
   static TraceBuffer* CreateTraceBufferRingBuffer(size_t max_chunks);
+  // As CreateTraceBufferRingBuffer(), also copying the events of the chunks
+  // returned to the buffer into `flight_recorder`, which must outlive it.
+  static TraceBuffer* CreateTraceBufferRingBufferWithFlightRecorder(
+      size_t max_chunks,
+      TraceFlightRecorder* flight_recorder);
   static TraceBuffer* CreateTraceBufferVectorOfSize(size_t max_chunks);
 };
 
@@ -69,6 +69,8 @@ const char kIncludedProcessesParam[] = "included_process_ids";
 
 const char kHistogramNamesParam[] = "histogram_names";
 
+const char kCategorySamplingRatesParam[] = "category_sampling_rates";
+
 class ConvertableTraceConfigToTraceFormat
     : public base::trace_event::ConvertableToTraceFormat {
  public:
@@ -318,6 +320,7 @@ TraceConfig& TraceConfig::operator=(const TraceConfig& rhs) {
   event_filters_ = rhs.event_filters_;
   histogram_names_ = rhs.histogram_names_;
   systrace_events_ = rhs.systrace_events_;
+  category_sampling_rates_ = rhs.category_sampling_rates_;
   return *this;
 }
 
@@ -328,6 +331,7 @@ bool TraceConfig::IsEquivalentTo(const TraceConfig& other) const {
           other.enable_event_package_name_filter_ ||
       histogram_names_ != other.histogram_names_ ||
       systrace_events_ != other.systrace_events_ ||
+      category_sampling_rates_ != other.category_sampling_rates_ ||
       process_filter_config_ != other.process_filter_config_ ||
       memory_dump_config_ != other.memory_dump_config_ ||
       !category_filter_.IsEquivalentTo(other.category_filter_)) {
@@ -396,6 +400,14 @@ void TraceConfig::Merge(const TraceConfig& config) {
                         config.event_filters().end());
   histogram_names_.insert(config.histogram_names().begin(),
                           config.histogram_names().end());
+  // Keep the highest rate of both configs, so that no config records less
+  // than it asked for.
+  for (const auto& [category, rate] : config.category_sampling_rates()) {
+    auto [it, inserted] = category_sampling_rates_.emplace(category, rate);
+    if (!inserted) {
+      it->second = std::max(it->second, rate);
+    }
+  }
 }
 
 void TraceConfig::Clear() {
@@ -411,6 +423,7 @@ void TraceConfig::Clear() {
   event_filters_.clear();
   histogram_names_.clear();
   systrace_events_.clear();
+  category_sampling_rates_.clear();
 }
 
 void TraceConfig::InitializeDefault() {
@@ -456,6 +469,11 @@ void TraceConfig::InitializeFromConfigDict(const Value::Dict& dict) {
   const Value::List* histogram_names = dict.FindList(kHistogramNamesParam);
   if (histogram_names)
     SetHistogramNamesFromConfigList(*histogram_names);
+  const Value::Dict* category_sampling_rates =
+      dict.FindDict(kCategorySamplingRatesParam);
+  if (category_sampling_rates) {
+    SetCategorySamplingRatesFromConfigDict(*category_sampling_rates);
+  }
 
   if (category_filter_.IsCategoryEnabled(MemoryDumpManager::kTraceCategory)) {
     // If dump triggers not set, the client is using the legacy with just
@@ -630,6 +648,17 @@ void TraceConfig::SetHistogramNamesFromConfigList(
   }
 }
 
+void TraceConfig::SetCategorySamplingRatesFromConfigDict(
+    const Value::Dict& category_sampling_rates) {
+  category_sampling_rates_.clear();
+  for (const auto [category, value] : category_sampling_rates) {
+    std::optional<double> rate = value.GetIfDouble();
+    if (rate && *rate >= 0 && *rate <= 1) {
+      category_sampling_rates_[category] = *rate;
+    }
+  }
+}
+
 void TraceConfig::SetEventFiltersFromConfigList(
     const Value::List& category_event_filters) {
   event_filters_.clear();
@@ -724,6 +753,14 @@ Value TraceConfig::ToValue() const {
     dict.Set(kHistogramNamesParam, std::move(histogram_names));
   }
 
+  if (!category_sampling_rates_.empty()) {
+    base::Value::Dict category_sampling_rates;
+    for (const auto& [category, rate] : category_sampling_rates_) {
+      category_sampling_rates.Set(category, rate);
+    }
+    dict.Set(kCategorySamplingRatesParam, std::move(category_sampling_rates));
+  }
+
   if (enable_systrace_) {
     if (!systrace_events_.empty()) {
       base::Value::List systrace_events;
@@ -744,6 +781,30 @@ void TraceConfig::EnableHistogram(const std::string& histogram_name) {
   histogram_names_.insert(histogram_name);
 }
 
+void TraceConfig::SetCategorySamplingRate(const std::string& category,
+                                          double rate) {
+  DCHECK(rate >= 0 && rate <= 1) << rate;
+  category_sampling_rates_[category] = rate;
+}
+
+double TraceConfig::GetCategorySamplingRate(
+    std::string_view category_group_name) const {
+  if (category_sampling_rates_.empty()) {
+    return 1;
+  }
+  std::optional<double> rate;
+  for (std::string_view category :
+       SplitStringPiece(category_group_name, ",", TRIM_WHITESPACE,
+                        SPLIT_WANT_NONEMPTY)) {
+    auto it = category_sampling_rates_.find(category);
+    if (it == category_sampling_rates_.end()) {
+      return 1;
+    }
+    rate = std::max(rate.value_or(0), it->second);
+  }
+  return rate.value_or(1);
+}
+
 std::string TraceConfig::ToTraceOptionsString() const {
   std::string ret;
   switch (record_mode_) {
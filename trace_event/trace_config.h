@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -157,6 +159,9 @@ class BASE_EXPORT TraceConfig {
   };
   typedef std::vector<EventFilterConfig> EventFilters;
 
+  // The sampling rate of each category, in [0, 1].
+  using CategorySamplingRates = std::map<std::string, double, std::less<>>;
+
   static std::string TraceRecordModeToStr(TraceRecordMode record_mode);
 
   TraceConfig();
@@ -257,6 +262,16 @@ class BASE_EXPORT TraceConfig {
   void EnableArgumentFilter() { enable_argument_filter_ = true; }
   void EnableHistogram(const std::string& histogram_name);
 
+  // Records only a fraction `rate`, in [0, 1], of the complete, instant and
+  // counter events of `category`, e.g. to limit the overhead of high-volume
+  // categories. Begin and end events are always recorded to keep them
+  // balanced.
+  void SetCategorySamplingRate(const std::string& category, double rate);
+
+  // Returns the fraction of events of `category_group_name` to record, which
+  // is the highest rate of its categories, or 1 if any of them has none.
+  double GetCategorySamplingRate(std::string_view category_group_name) const;
+
   // Writes the string representation of the TraceConfig. The string is JSON
   // formatted.
   std::string ToString() const;
@@ -326,6 +341,10 @@ class BASE_EXPORT TraceConfig {
     return histogram_names_;
   }
 
+  const CategorySamplingRates& category_sampling_rates() const {
+    return category_sampling_rates_;
+  }
+
  private:
   FRIEND_TEST_ALL_PREFIXES(TraceConfigTest, TraceConfigFromValidLegacyFormat);
   FRIEND_TEST_ALL_PREFIXES(TraceConfigTest,
@@ -351,6 +370,8 @@ class BASE_EXPORT TraceConfig {
   void SetDefaultMemoryDumpConfig();
 
   void SetHistogramNamesFromConfigList(const Value::List& histogram_names);
+  void SetCategorySamplingRatesFromConfigDict(
+      const Value::Dict& category_sampling_rates);
   void SetEventFiltersFromConfigList(const Value::List& event_filters);
   Value ToValue() const;
 
@@ -369,6 +390,7 @@ class BASE_EXPORT TraceConfig {
   bool enable_event_package_name_filter_ : 1;
   std::unordered_set<std::string> histogram_names_;
   std::unordered_set<std::string> systrace_events_;
+  CategorySamplingRates category_sampling_rates_;
 };
 
 }  // namespace base::trace_event
@@ -733,6 +733,38 @@ TEST(TraceConfigTest, SystraceEventsSerialization) {
   EXPECT_TRUE(tc2.systrace_events().count("timer:tick_stop"));
 }
 
+TEST(TraceConfigTest, CategorySamplingRates) {
+  TraceConfig tc("foo,bar,baz", "");
+  EXPECT_EQ(1, tc.GetCategorySamplingRate("foo"));
+
+  tc.SetCategorySamplingRate("foo", 0.1);
+  tc.SetCategorySamplingRate("bar", 0.5);
+  EXPECT_EQ(0.1, tc.GetCategorySamplingRate("foo"));
+  // The highest rate of the categories of a group applies.
+  EXPECT_EQ(0.5, tc.GetCategorySamplingRate("foo,bar"));
+  // Categories without a rate are always recorded.
+  EXPECT_EQ(1, tc.GetCategorySamplingRate("foo,baz"));
+  EXPECT_EQ(1, tc.GetCategorySamplingRate(""));
+
+  const TraceConfig tc1(tc.ToString());
+  EXPECT_EQ(tc.category_sampling_rates(), tc1.category_sampling_rates());
+  EXPECT_TRUE(tc.IsEquivalentTo(tc1));
+
+  TraceConfig tc2("foo", "");
+  tc2.SetCategorySamplingRate("foo", 0.2);
+  EXPECT_FALSE(tc.IsEquivalentTo(tc2));
+  tc2.Merge(tc);
+  EXPECT_EQ(0.2, tc2.GetCategorySamplingRate("foo"));
+  EXPECT_EQ(0.5, tc2.GetCategorySamplingRate("bar"));
+
+  // Invalid rates are ignored.
+  const TraceConfig tc3(
+      R"({"category_sampling_rates": {"foo": 2, "bar": "x", "baz": 0.25}})");
+  EXPECT_EQ(1, tc3.GetCategorySamplingRate("foo"));
+  EXPECT_EQ(1, tc3.GetCategorySamplingRate("bar"));
+  EXPECT_EQ(0.25, tc3.GetCategorySamplingRate("baz"));
+}
+
 TEST(TraceConfigTest, IsConfigEquivalent) {
   TraceConfig tc1("foo,bar", "");
   TraceConfig tc2("bar,foo", "");
@@ -1172,6 +1172,40 @@ TEST_F(TraceEventTestFixture, StaticStringVsString) {
   }
 }
 
+// Test that category sampling rates apply to events added through TraceLog.
+TEST_F(TraceEventTestFixture, CategorySamplingRate) {
+  TraceConfig trace_config("cat", "");
+  trace_config.SetCategorySamplingRate("cat", 0.25);
+  TraceLog::GetInstance()->SetEnabled(trace_config, TraceLog::RECORDING_MODE);
+  const unsigned char* category_group_enabled =
+      TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED("cat");
+  for (int i = 0; i < 100; ++i) {
+    trace_event_internal::AddTraceEvent(
+        TRACE_EVENT_PHASE_INSTANT, category_group_enabled, "sampled",
+        trace_event_internal::kGlobalScope, trace_event_internal::kNoId,
+        TRACE_EVENT_FLAG_NONE, trace_event_internal::kNoId);
+    // Begin events are always recorded.
+    trace_event_internal::AddTraceEvent(
+        TRACE_EVENT_PHASE_BEGIN, category_group_enabled, "balanced",
+        trace_event_internal::kGlobalScope, trace_event_internal::kNoId,
+        TRACE_EVENT_FLAG_NONE, trace_event_internal::kNoId);
+  }
+  EndTraceAndFlush();
+
+  size_t num_sampled = 0;
+  size_t num_balanced = 0;
+  for (const Value& item : trace_parsed_) {
+    const std::string* name = item.GetDict().FindString("name");
+    if (name && *name == "sampled") {
+      ++num_sampled;
+    } else if (name && *name == "balanced") {
+      ++num_balanced;
+    }
+  }
+  EXPECT_EQ(25u, num_sampled);
+  EXPECT_EQ(100u, num_balanced);
+}
+
 // Test that data sent from other threads is gathered
 TEST_F(TraceEventTestFixture, DataCapturedOnThread) {
   BeginTrace();
@@ -0,0 +1,134 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/trace_flight_recorder.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "base/check.h"
+#include "base/metrics/persistent_memory_allocator.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/trace_event/trace_buffer.h"
+#include "base/trace_event/trace_event_impl.h"
+#include "base/trace_event/trace_log.h"
+
+namespace base {
+namespace trace_event {
+
+// The header of the ring, followed in the same allocation by `num_records`
+// Records.
+struct TraceFlightRecorder::Header {
+  // Increment this if the structure of the header or of the records changes!
+  static constexpr uint32_t kPersistentTypeId = 0x6E1E2B3A + 1;
+
+  // Expected size for 32/64-bit check. Update this if structure changes!
+  static constexpr size_t kExpectedInstanceSize = 16;
+
+  // The number of records ever written. The record of the next event is at
+  // `next_record % num_records`.
+  std::atomic<uint64_t> next_record;
+  uint32_t num_records;
+  uint32_t padding;
+};
+
+struct TraceFlightRecorder::Record {
+  static constexpr size_t kExpectedInstanceSize = 128;
+
+  int64_t timestamp_us;
+  int64_t duration_us;
+  int64_t thread_id;
+  char phase;
+  // Truncated, NUL-terminated names.
+  char category_group[39];
+  char name[64];
+};
+
+TraceFlightRecorder::Event::Event() = default;
+TraceFlightRecorder::Event::Event(const Event&) = default;
+TraceFlightRecorder::Event& TraceFlightRecorder::Event::operator=(
+    const Event&) = default;
+TraceFlightRecorder::Event::~Event() = default;
+
+TraceFlightRecorder::TraceFlightRecorder(PersistentMemoryAllocator* allocator,
+                                         size_t max_events) {
+  static_assert(sizeof(Record) == Record::kExpectedInstanceSize,
+                "inconsistent size");
+  DCHECK_GT(max_events, 0u);
+  header_ =
+      allocator->New<Header>(sizeof(Header) + max_events * sizeof(Record));
+  if (!header_) {
+    return;
+  }
+  header_->num_records = checked_cast<uint32_t>(max_events);
+  allocator->MakeIterable(header_.get());
+}
+
+TraceFlightRecorder::~TraceFlightRecorder() = default;
+
+void TraceFlightRecorder::RecordChunk(const TraceBufferChunk& chunk) {
+  DCHECK(IsValid());
+  Record* records = reinterpret_cast<Record*>(header_.get() + 1);
+  uint64_t next_record = header_->next_record.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < chunk.size(); ++i) {
+    const TraceEvent& event = *chunk.GetEventAt(i);
+    Record& record = records[next_record % header_->num_records];
+    record.timestamp_us = event.timestamp().since_origin().InMicroseconds();
+    record.duration_us = event.duration().InMicroseconds();
+    record.thread_id = event.thread_id();
+    record.phase = event.phase();
+    strlcpy(record.category_group,
+            TraceLog::GetCategoryGroupName(event.category_group_enabled()),
+            sizeof(record.category_group));
+    strlcpy(record.name, event.name() ? event.name() : "",
+            sizeof(record.name));
+    // Publish the record, for readers in other processes.
+    header_->next_record.store(++next_record, std::memory_order_release);
+  }
+}
+
+// static
+std::vector<TraceFlightRecorder::Event> TraceFlightRecorder::Recover(
+    const PersistentMemoryAllocator& allocator) {
+  std::vector<Event> events;
+  PersistentMemoryAllocator::Iterator iter(&allocator);
+  const PersistentMemoryAllocator::Reference ref =
+      iter.GetNextOfType<Header>();
+  const Header* header = iter.GetAsObject<Header>(ref);
+  if (!header || header->num_records == 0 ||
+      allocator.GetAllocSize(ref) <
+          sizeof(Header) + header->num_records * sizeof(Record)) {
+    return events;
+  }
+  const Record* records = reinterpret_cast<const Record*>(header + 1);
+
+  // The oldest record may have been partially overwritten when the process
+  // stopped, so it is skipped once the ring has wrapped around.
+  const uint64_t next_record =
+      header->next_record.load(std::memory_order_acquire);
+  const uint64_t num_events =
+      std::min<uint64_t>(next_record, header->num_records - 1);
+  events.reserve(static_cast<size_t>(num_events));
+  for (uint64_t i = next_record - num_events; i != next_record; ++i) {
+    const Record& record = records[i % header->num_records];
+    Event event;
+    event.timestamp = TimeTicks() + Microseconds(record.timestamp_us);
+    event.duration = Microseconds(record.duration_us);
+    event.thread_id = static_cast<PlatformThreadId>(record.thread_id);
+    event.phase = record.phase;
+    event.category_group.assign(
+        record.category_group,
+        strnlen(record.category_group, sizeof(record.category_group)));
+    event.name.assign(record.name, strnlen(record.name, sizeof(record.name)));
+    events.push_back(std::move(event));
+  }
+  return events;
+}
+
+}  // namespace trace_event
+}  // namespace base
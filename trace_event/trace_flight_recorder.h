@@ -0,0 +1,82 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TRACE_EVENT_TRACE_FLIGHT_RECORDER_H_
+#define BASE_TRACE_EVENT_TRACE_FLIGHT_RECORDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/memory/raw_ptr.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+
+namespace base {
+
+class PersistentMemoryAllocator;
+
+namespace trace_event {
+
+class TraceBufferChunk;
+
+// Keeps a copy of the most recent trace events in persistent memory, e.g. a
+// FilePersistentMemoryAllocator or a WritableSharedPersistentMemoryAllocator,
+// so that the last moments of trace can be recovered after the process
+// crashed or hung, without writing the trace to a file continuously.
+//
+// Events are copied into a ring of fixed-size records when their
+// TraceBufferChunk is returned to the TraceBuffer, so the cost is one copy of
+// each event, without arguments. Category and event names are truncated.
+//
+// Enable it with TraceLog::SetFlightRecorder(). Only traces recorded
+// continuously, in a ring buffer, are mirrored.
+class BASE_EXPORT TraceFlightRecorder {
+ public:
+  // An event recovered from persistent memory.
+  struct BASE_EXPORT Event {
+    Event();
+    Event(const Event&);
+    Event& operator=(const Event&);
+    ~Event();
+
+    TimeTicks timestamp;
+    // Negative if the event has no duration.
+    TimeDelta duration;
+    PlatformThreadId thread_id = kInvalidThreadId;
+    char phase = 0;
+    std::string category_group;
+    std::string name;
+  };
+
+  // Allocates a ring of `max_events` records in `allocator`, which must
+  // outlive this. IsValid() is false if the allocation failed.
+  TraceFlightRecorder(PersistentMemoryAllocator* allocator, size_t max_events);
+  TraceFlightRecorder(const TraceFlightRecorder&) = delete;
+  TraceFlightRecorder& operator=(const TraceFlightRecorder&) = delete;
+  ~TraceFlightRecorder();
+
+  bool IsValid() const { return header_ != nullptr; }
+
+  // Copies the events of `chunk`. Must not be called concurrently.
+  void RecordChunk(const TraceBufferChunk& chunk);
+
+  // Returns the events recorded in `allocator`, e.g. by a process which
+  // crashed, oldest first.
+  static std::vector<Event> Recover(const PersistentMemoryAllocator& allocator);
+
+ private:
+  struct Header;
+  struct Record;
+
+  raw_ptr<Header> header_ = nullptr;
+};
+
+}  // namespace trace_event
+}  // namespace base
+
+#endif  // BASE_TRACE_EVENT_TRACE_FLIGHT_RECORDER_H_
@@ -0,0 +1,135 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/trace_flight_recorder.h"
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/metrics/persistent_memory_allocator.h"
+#include "base/trace_event/trace_buffer.h"
+#include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_event_impl.h"
+#include "base/trace_event/trace_log.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+constexpr size_t kAllocatorSize = 64 << 10;
+
+void AddEvent(TraceBufferChunk& chunk,
+              const char* name,
+              int64_t timestamp_us) {
+  size_t event_index;
+  chunk.AddTraceEvent(&event_index)
+      ->Reset(PlatformThread::CurrentId(),
+              TimeTicks() + Microseconds(timestamp_us), ThreadTicks(),
+              TRACE_EVENT_PHASE_INSTANT,
+              TraceLog::GetCategoryGroupEnabled("flight_recorder"), name,
+              /*scope=*/nullptr, /*id=*/0, /*bind_id=*/0, /*args=*/nullptr,
+              TRACE_EVENT_FLAG_NONE);
+}
+
+std::vector<std::string> GetNames(
+    const std::vector<TraceFlightRecorder::Event>& events) {
+  std::vector<std::string> names;
+  for (const TraceFlightRecorder::Event& event : events) {
+    names.push_back(event.name);
+  }
+  return names;
+}
+
+}  // namespace
+
+TEST(TraceFlightRecorderTest, RecordAndRecover) {
+  LocalPersistentMemoryAllocator allocator(kAllocatorSize, 0, "");
+  TraceFlightRecorder recorder(&allocator, 16);
+  ASSERT_TRUE(recorder.IsValid());
+
+  TraceBufferChunk chunk(1);
+  AddEvent(chunk, "event1", 10);
+  AddEvent(chunk, "event2", 20);
+  recorder.RecordChunk(chunk);
+
+  const std::vector<TraceFlightRecorder::Event> events =
+      TraceFlightRecorder::Recover(allocator);
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ("event1", events[0].name);
+  EXPECT_EQ("flight_recorder", events[0].category_group);
+  EXPECT_EQ(TimeTicks() + Microseconds(10), events[0].timestamp);
+  EXPECT_EQ(PlatformThread::CurrentId(), events[0].thread_id);
+  EXPECT_EQ(TRACE_EVENT_PHASE_INSTANT, events[0].phase);
+  EXPECT_EQ("event2", events[1].name);
+  EXPECT_EQ(TimeTicks() + Microseconds(20), events[1].timestamp);
+}
+
+TEST(TraceFlightRecorderTest, KeepsMostRecentEvents) {
+  LocalPersistentMemoryAllocator allocator(kAllocatorSize, 0, "");
+  TraceFlightRecorder recorder(&allocator, 4);
+  ASSERT_TRUE(recorder.IsValid());
+
+  TraceBufferChunk chunk(1);
+  for (const char* name : {"a", "b", "c", "d", "e", "f"}) {
+    AddEvent(chunk, name, 0);
+  }
+  recorder.RecordChunk(chunk);
+
+  // The oldest record of a full ring isn't recovered, since it may have been
+  // partially overwritten.
+  EXPECT_EQ((std::vector<std::string>{"d", "e", "f"}),
+            GetNames(TraceFlightRecorder::Recover(allocator)));
+}
+
+TEST(TraceFlightRecorderTest, TruncatesNames) {
+  LocalPersistentMemoryAllocator allocator(kAllocatorSize, 0, "");
+  TraceFlightRecorder recorder(&allocator, 4);
+  ASSERT_TRUE(recorder.IsValid());
+
+  const std::string long_name(100, 'x');
+  TraceBufferChunk chunk(1);
+  AddEvent(chunk, long_name.c_str(), 0);
+  recorder.RecordChunk(chunk);
+
+  const std::vector<TraceFlightRecorder::Event> events =
+      TraceFlightRecorder::Recover(allocator);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_FALSE(events[0].name.empty());
+  EXPECT_LT(events[0].name.size(), long_name.size());
+  EXPECT_EQ(0u, long_name.find(events[0].name));
+}
+
+TEST(TraceFlightRecorderTest, RecoverFromCopyOfMemory) {
+  LocalPersistentMemoryAllocator allocator(kAllocatorSize, 0, "");
+  TraceFlightRecorder recorder(&allocator, 16);
+  ASSERT_TRUE(recorder.IsValid());
+
+  std::unique_ptr<TraceBuffer> buffer(
+      TraceBuffer::CreateTraceBufferRingBufferWithFlightRecorder(4,
+                                                                 &recorder));
+  size_t chunk_index;
+  std::unique_ptr<TraceBufferChunk> chunk = buffer->GetChunk(&chunk_index);
+  AddEvent(*chunk, "returned", 0);
+  buffer->ReturnChunk(chunk_index, std::move(chunk));
+  // Events of chunks which weren't returned aren't recorded.
+  chunk = buffer->GetChunk(&chunk_index);
+  AddEvent(*chunk, "in_flight", 0);
+
+  // As if read post-mortem, e.g. from a file.
+  std::vector<uint64_t> memory(kAllocatorSize / sizeof(uint64_t));
+  memcpy(memory.data(), allocator.data(), kAllocatorSize);
+  const PersistentMemoryAllocator read_only_allocator(
+      memory.data(), kAllocatorSize, 0, 0, "",
+      PersistentMemoryAllocator::kReadOnly);
+  EXPECT_EQ(std::vector<std::string>{"returned"},
+            GetNames(TraceFlightRecorder::Recover(read_only_allocator)));
+}
+
+}  // namespace trace_event
+}  // namespace base
@@ -9,6 +9,7 @@
 
 #include "base/trace_event/trace_log.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <memory>
@@ -53,6 +54,7 @@
 #include "base/trace_event/process_memory_dump.h"
 #include "base/trace_event/trace_buffer.h"
 #include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_flight_recorder.h"
 #include "build/build_config.h"
 
 #include "base/numerics/safe_conversions.h"
@@ -104,6 +106,11 @@ const size_t kEchoToConsoleTraceEventBufferChunks = 256;
 
 const size_t kTraceEventBufferSizeInBytes = 100 * 1024;
 
+// The chunk_seq of the handles of events dropped by category sampling. Valid
+// chunk_seqs are allocated from 1, so this doesn't collide with them.
+constexpr uint32_t kSampledOutEventChunkSeq =
+    std::numeric_limits<uint32_t>::max();
+
 bool g_perfetto_initialized_by_tracelog = false;
 
 TraceLog* g_trace_log_for_testing = nullptr;
@@ -532,13 +539,14 @@ TraceEvent* TraceLog::ThreadLocalEventBuffer::AddTraceEvent(
     TraceEventHandle* handle) {
   CheckThisIsCurrentBuffer();
 
-  if (chunk_ && chunk_->IsFull()) {
-    AutoLock lock(trace_log_->lock_);
-    FlushWhileLocked();
-    chunk_.reset();
-  }
-  if (!chunk_) {
+  // The lock is only taken once per chunk, to return the full chunk and get a
+  // new one at once.
+  if (!chunk_ || chunk_->IsFull()) {
     AutoLock lock(trace_log_->lock_);
+    if (chunk_) {
+      FlushWhileLocked();
+      chunk_.reset();
+    }
     chunk_ = trace_log_->logged_events_->GetChunk(&chunk_index_);
     trace_log_->CheckIfBufferIsFullWhileLocked();
   }
@@ -884,6 +892,18 @@ void TraceLog::SetEnabledImpl(const TraceConfig& trace_config,
   InitializePerfettoIfNeeded();
   trace_config_ = trace_config;
   perfetto_config_ = perfetto_config;
+  {
+    AutoLock sampling_lock(category_sampling_lock_);
+    category_sampling_config_.Clear();
+    for (const auto& [category, rate] :
+         trace_config.category_sampling_rates()) {
+      category_sampling_config_.SetCategorySamplingRate(category, rate);
+    }
+    category_sampling_states_.clear();
+    has_category_sampling_rates_.store(
+        !trace_config.category_sampling_rates().empty(),
+        std::memory_order_relaxed);
+  }
   tracing_session_ = perfetto::Tracing::NewTrace();
 
   AutoUnlock unlock(lock_);
@@ -1574,6 +1594,10 @@ TraceEventHandle TraceLog::AddTraceEventWithThreadIdAndTimestamps(
                                    thread_id, timestamp, args)) {
     return handle;
   }
+  if (!ShouldRecordSampledEvent(phase, category_group_enabled)) {
+    handle.chunk_seq = kSampledOutEventChunkSeq;
+    return handle;
+  }
   DCHECK(!timestamp.is_null());
 
   const AutoReset<bool> resetter(&thread_is_in_trace_event, true, false);
@@ -1645,6 +1669,38 @@ TraceEventHandle TraceLog::AddTraceEventWithThreadIdAndTimestamps(
   return handle;
 }
 
+bool TraceLog::ShouldRecordSampledEvent(
+    char phase,
+    const unsigned char* category_group_enabled) {
+  if (!has_category_sampling_rates_.load(std::memory_order_relaxed)) {
+    return true;
+  }
+  // Events which must be balanced, e.g. begin and end events, aren't sampled.
+  if (phase != TRACE_EVENT_PHASE_COMPLETE &&
+      phase != TRACE_EVENT_PHASE_INSTANT &&
+      phase != TRACE_EVENT_PHASE_COUNTER) {
+    return true;
+  }
+
+  AutoLock lock(category_sampling_lock_);
+  auto it = category_sampling_states_.find(category_group_enabled);
+  if (it == category_sampling_states_.end()) {
+    const double rate = category_sampling_config_.GetCategorySamplingRate(
+        GetCategoryGroupName(category_group_enabled));
+    const uint32_t interval =
+        rate > 0 ? ClampRound<uint32_t>(std::max(1 / rate, 1.0)) : 0;
+    it = category_sampling_states_
+             .emplace(category_group_enabled,
+                      CategorySamplingState{.interval = interval})
+             .first;
+  }
+  CategorySamplingState& state = it->second;
+  if (state.interval == 0) {
+    return false;
+  }
+  return state.count++ % state.interval == 0;
+}
+
 void TraceLog::AddMetadataEvent(const unsigned char* category_group_enabled,
                                 const char* name,
                                 TraceArguments* args,
@@ -1738,6 +1794,11 @@ void TraceLog::UpdateTraceEventDurationExplicit(
   if (!*category_group_enabled)
     return;
 
+  // The beginning of the event wasn't recorded.
+  if (handle.chunk_seq == kSampledOutEventChunkSeq) {
+    return;
+  }
+
   // Avoid re-entrance of AddTraceEvent. This may happen in GPU process when
   // ECHO_TO_CONSOLE is enabled: AddTraceEvent -> LOG(ERROR) ->
   // GpuProcessLogMessageHandler -> PostPendingTask -> TRACE_EVENT ...
@@ -1984,9 +2045,14 @@ TraceBuffer* TraceLog::CreateTraceBuffer() {
   const size_t config_buffer_chunks =
       trace_config_.GetTraceBufferSizeInEvents() / kTraceBufferChunkSize;
   if (options & kInternalRecordContinuously) {
-    return TraceBuffer::CreateTraceBufferRingBuffer(
-        config_buffer_chunks > 0 ? config_buffer_chunks
-                                 : kTraceEventRingBufferChunks);
+    const size_t max_chunks = config_buffer_chunks > 0
+                                  ? config_buffer_chunks
+                                  : kTraceEventRingBufferChunks;
+    if (flight_recorder_) {
+      return TraceBuffer::CreateTraceBufferRingBufferWithFlightRecorder(
+          max_chunks, flight_recorder_);
+    }
+    return TraceBuffer::CreateTraceBufferRingBuffer(max_chunks);
   }
   if (options & kInternalEchoToConsole) {
     return TraceBuffer::CreateTraceBufferRingBuffer(
@@ -2024,6 +2090,13 @@ void TraceLog::SetTraceBufferForTesting(
   logged_events_ = std::move(trace_buffer);
 }
 
+void TraceLog::SetFlightRecorder(TraceFlightRecorder* flight_recorder) {
+  AutoLock lock(lock_);
+  DCHECK(!enabled_);
+  DCHECK(!flight_recorder || flight_recorder->IsValid());
+  flight_recorder_ = flight_recorder;
+}
+
 void TraceLog::OnSetup(const perfetto::DataSourceBase::SetupArgs& args) {
   AutoLock lock(track_event_lock_);
   track_event_sessions_.emplace_back(args.internal_instance_index, *args.config,
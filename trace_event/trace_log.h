@@ -49,6 +49,7 @@ class TraceBuffer;
 class TraceBufferChunk;
 class TraceEvent;
 class TraceEventMemoryOverhead;
+class TraceFlightRecorder;
 class JsonStringOutputWriter;
 
 struct BASE_EXPORT TraceLogStatus {
@@ -399,6 +400,13 @@ class BASE_EXPORT TraceLog :
   // Replaces |logged_events_| with a new TraceBuffer for testing.
   void SetTraceBufferForTesting(std::unique_ptr<TraceBuffer> trace_buffer);
 
+  // Copies the events of the traces recorded continuously into
+  // |flight_recorder|, so that the most recent ones can be recovered after the
+  // process crashed or hung. Takes effect from the next trace; null disables
+  // it. |flight_recorder| must outlive TraceLog, and this must be called while
+  // tracing is disabled.
+  void SetFlightRecorder(TraceFlightRecorder* flight_recorder);
+
   struct TrackEventSession {
     uint32_t internal_instance_index;
     perfetto::DataSourceConfig config;
@@ -477,6 +485,12 @@ class BASE_EXPORT TraceLog :
   TraceBuffer* trace_buffer() const { return logged_events_.get(); }
   TraceBuffer* CreateTraceBuffer();
 
+  // Returns whether to record an event of `phase` given the category sampling
+  // rates of the trace config. Events which aren't recorded are given a handle
+  // which makes UpdateTraceEventDuration() ignore them.
+  bool ShouldRecordSampledEvent(char phase,
+                                const unsigned char* category_group_enabled);
+
   std::string EventToConsoleMessage(char phase,
                                     const TimeTicks& timestamp,
                                     TraceEvent* trace_event);
@@ -539,6 +553,7 @@ class BASE_EXPORT TraceLog :
   bool enabled_{false};
   int num_traces_recorded_{0};
   std::unique_ptr<TraceBuffer> logged_events_;
+  raw_ptr<TraceFlightRecorder> flight_recorder_ = nullptr;
   std::vector<std::unique_ptr<TraceEvent>> metadata_events_;
 
   // The lock protects observers access.
@@ -581,6 +596,20 @@ class BASE_EXPORT TraceLog :
 
   TraceConfig trace_config_;
 
+  // Records one of every `interval` events of a category, or none if 0.
+  struct CategorySamplingState {
+    uint32_t interval;
+    uint32_t count = 0;
+  };
+  // Whether the trace config has category sampling rates, to skip sampling
+  // without taking `category_sampling_lock_` otherwise.
+  std::atomic_bool has_category_sampling_rates_{false};
+  Lock category_sampling_lock_;
+  // Only holds the category sampling rates of `trace_config_`.
+  TraceConfig category_sampling_config_ GUARDED_BY(category_sampling_lock_);
+  std::map<const unsigned char*, CategorySamplingState>
+      category_sampling_states_ GUARDED_BY(category_sampling_lock_);
+
   // Contains task runners for the threads that have had at least one event
   // added into the local event buffer.
   std::unordered_map<PlatformThreadId, scoped_refptr<SingleThreadTaskRunner>>
@@ -0,0 +1,67 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "base/trace_event/trace_config.h"
+#include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_log.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file contains tests to measure the cost per event of recording complete
+// events through TraceLog, with and without category sampling.
+
+namespace base::trace_event {
+
+namespace {
+
+constexpr char kMetricPrefixTraceLog[] = "TraceLog.";
+constexpr char kMetricTimePerEvent[] = "time_per_event";
+constexpr int kNumIterations = 100000;
+
+void RunAddTraceEventPerfTest(const std::string& story_name,
+                              double sampling_rate) {
+  test::TaskEnvironment task_environment;
+  TraceConfig trace_config("cat", "");
+  if (sampling_rate < 1) {
+    trace_config.SetCategorySamplingRate("cat", sampling_rate);
+  }
+  TraceLog* trace_log = TraceLog::GetInstance();
+  trace_log->SetEnabled(trace_config, TraceLog::RECORDING_MODE);
+  const unsigned char* category_group_enabled =
+      TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED("cat");
+
+  TimeTicks start_time = TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    TraceEventHandle handle = trace_event_internal::AddTraceEvent(
+        TRACE_EVENT_PHASE_COMPLETE, category_group_enabled, "event",
+        trace_event_internal::kGlobalScope, trace_event_internal::kNoId,
+        TRACE_EVENT_FLAG_NONE, trace_event_internal::kNoId);
+    trace_event_internal::UpdateTraceEventDuration(category_group_enabled,
+                                                    "event", handle);
+  }
+  TimeTicks end_time = TimeTicks::Now();
+  trace_log->SetDisabled();
+
+  perf_test::PerfResultReporter reporter(kMetricPrefixTraceLog, story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerEvent, "ns");
+  reporter.AddResult(kMetricTimePerEvent,
+                     (end_time - start_time).InMicrosecondsF() * 1000 /
+                         kNumIterations);
+}
+
+}  // namespace
+
+TEST(TraceLogPerfTest, AddTraceEvent) {
+  RunAddTraceEventPerfTest("AddTraceEvent", 1);
+}
+
+TEST(TraceLogPerfTest, AddTraceEventSampled_10) {
+  RunAddTraceEventPerfTest("AddTraceEventSampled_10", 0.1);
+}
+
+}  // namespace base::trace_event
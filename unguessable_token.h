@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <array>
 #include <compare>
 #include <iosfwd>
 #include <tuple>
@@ -101,6 +102,10 @@ class BASE_EXPORT UnguessableToken {
 
   // Hex representation of the unguessable token.
   std::string ToString() const { return token_.ToString(); }
+  std::array<char, Token::kStringLength> ToCharArray() const {
+    return token_.ToCharArray();
+  }
+  void AppendTo(std::string* output) const { token_.AppendTo(output); }
 
   explicit constexpr operator bool() const { return !is_empty(); }
 
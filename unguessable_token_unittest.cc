@@ -110,6 +110,11 @@ TEST(UnguessableTokenTest, VerifyToString1) {
   std::string expected = "1234567890ABCDEFFEDCBA0987654321";
 
   EXPECT_EQ(expected, token.ToString());
+  const auto chars = token.ToCharArray();
+  EXPECT_EQ(expected, std::string(chars.begin(), chars.end()));
+  std::string appended;
+  token.AppendTo(&appended);
+  EXPECT_EQ(expected, appended);
 
   std::string expected_stream = "(1234567890ABCDEFFEDCBA0987654321)";
   std::stringstream stream;
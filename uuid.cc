@@ -6,21 +6,29 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
+#include <array>
 #include <ostream>
 #include <string_view>
 
 #include "base/containers/span.h"
 #include "base/hash/hash.h"
+#include "base/numerics/byte_conversions.h"
 #include "base/rand_util.h"
+#include "base/strings/hex_encoding_internal.h"
 #include "base/strings/string_util.h"
-#include "base/strings/stringprintf.h"
 #include "base/types/pass_key.h"
 
 namespace base {
 
 namespace {
 
+constexpr size_t kUuidLength = 36;
+
+// The number of hex digits in each hyphen-separated group of a Uuid.
+constexpr size_t kGroupLengths[] = {8, 4, 4, 4, 12};
+
 template <typename Char>
 constexpr bool IsLowerHexDigit(Char c) {
   return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
@@ -37,7 +45,6 @@ template <typename StringPieceType>
 std::string GetCanonicalUuidInternal(StringPieceType input, bool strict) {
   using CharType = typename StringPieceType::value_type;
 
-  constexpr size_t kUuidLength = 36;
   if (input.length() != kUuidLength) {
     return std::string();
   }
@@ -62,6 +69,56 @@ std::string GetCanonicalUuidInternal(StringPieceType input, bool strict) {
   return lowercase_;
 }
 
+// Formats `bytes` as xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx, in lowercase.
+std::string FormatUuidBytes(span<const uint8_t, 16> bytes) {
+  std::array<char, 32> digits;
+  internal::HexEncode16(bytes, internal::HexCase::kLower, digits);
+  std::string uuid(kUuidLength, '-');
+  size_t pos = 0;
+  span<const char> remaining_digits(digits);
+  for (size_t group_length : kGroupLengths) {
+    span(uuid).subspan(pos, group_length)
+        .copy_from(remaining_digits.first(group_length));
+    remaining_digits = remaining_digits.subspan(group_length);
+    // Skip the hyphen.
+    pos += group_length + 1;
+  }
+  return uuid;
+}
+
+// Like GetCanonicalUuidInternal(), for 8-bit strings, which lets the digits be
+// validated all at once.
+std::string GetCanonicalUuid(std::string_view input,
+                             internal::HexCase hex_case) {
+  if (input.length() != kUuidLength) {
+    return std::string();
+  }
+
+  std::array<char, 32> digits;
+  span<char> remaining_digits(digits);
+  size_t pos = 0;
+  for (size_t group_length : kGroupLengths) {
+    if (pos > 0) {
+      if (input[pos] != '-') {
+        return std::string();
+      }
+      ++pos;
+    }
+    remaining_digits.first(group_length)
+        .copy_from(span(input).subspan(pos, group_length));
+    remaining_digits = remaining_digits.subspan(group_length);
+    pos += group_length;
+  }
+
+  std::array<uint8_t, 16> bytes;
+  if (!internal::HexDecode16(digits, hex_case, bytes)) {
+    return std::string();
+  }
+  // Lowercase input is already canonical.
+  return hex_case == internal::HexCase::kLower ? std::string(input)
+                                               : FormatUuidBytes(bytes);
+}
+
 }  // namespace
 
 // static
@@ -105,21 +162,21 @@ Uuid Uuid::FormatRandomDataAsV4Impl(base::span<const uint8_t, 16> input) {
   sixteen_bytes[1] &= 0x3fffffff'ffffffffULL;
   sixteen_bytes[1] |= 0x80000000'00000000ULL;
 
+  // The words in big-endian order, so that each group of digits reads as a
+  // hex number of the bits above.
+  std::array<uint8_t, 16> bytes;
+  span(bytes).first<8>().copy_from(U64ToBigEndian(sixteen_bytes[0]));
+  span(bytes).last<8>().copy_from(U64ToBigEndian(sixteen_bytes[1]));
+
   Uuid uuid;
-  uuid.lowercase_ =
-      StringPrintf("%08x-%04x-%04x-%04x-%012llx",
-                   static_cast<uint32_t>(sixteen_bytes[0] >> 32),
-                   static_cast<uint32_t>((sixteen_bytes[0] >> 16) & 0x0000ffff),
-                   static_cast<uint32_t>(sixteen_bytes[0] & 0x0000ffff),
-                   static_cast<uint32_t>(sixteen_bytes[1] >> 48),
-                   sixteen_bytes[1] & 0x0000ffff'ffffffffULL);
+  uuid.lowercase_ = FormatUuidBytes(bytes);
   return uuid;
 }
 
 // static
 Uuid Uuid::ParseCaseInsensitive(std::string_view input) {
   Uuid uuid;
-  uuid.lowercase_ = GetCanonicalUuidInternal(input, /*strict=*/false);
+  uuid.lowercase_ = GetCanonicalUuid(input, internal::HexCase::kAny);
   return uuid;
 }
 
@@ -133,7 +190,7 @@ Uuid Uuid::ParseCaseInsensitive(std::u16string_view input) {
 // static
 Uuid Uuid::ParseLowercase(std::string_view input) {
   Uuid uuid;
-  uuid.lowercase_ = GetCanonicalUuidInternal(input, /*strict=*/true);
+  uuid.lowercase_ = GetCanonicalUuid(input, internal::HexCase::kLower);
   return uuid;
 }
 
@@ -158,6 +215,10 @@ const std::string& Uuid::AsLowercaseString() const {
   return lowercase_;
 }
 
+void Uuid::AppendTo(std::string* output) const {
+  output->append(lowercase_);
+}
+
 std::ostream& operator<<(std::ostream& out, const Uuid& uuid) {
   return out << uuid.AsLowercaseString();
 }
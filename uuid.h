@@ -83,6 +83,10 @@ class BASE_EXPORT Uuid {
   // more context.
   const std::string& AsLowercaseString() const;
 
+  // Appends AsLowercaseString() to `output`, e.g. to build a key or a log line
+  // without a temporary string.
+  void AppendTo(std::string* output) const;
+
   // Invalid Uuids are equal.
   friend bool operator==(const Uuid&, const Uuid&) = default;
   // Uuids are 128bit chunks of data so must be indistinguishable if equivalent.
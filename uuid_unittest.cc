@@ -78,6 +78,14 @@ TEST(UuidTest, Validity) {
       {"DEADBEEFDEADBEEFDEADBEEFDEADBEEF", kDoesntParse},
       {"deadbeefWdeadXbeefYdeadZbeefdeadbeef", kDoesntParse},
       {"XXXdeadbeefWdeadXbeefYdeadZbeefdeadbeefXXX", kDoesntParse},
+      {"deadbeef-dead-beef-dead-beef-eadbeef", kDoesntParse},
+      {"-eadbeef-dead-beef-dead-beefdeadbeef", kDoesntParse},
+      {"deadbeef-dead-beef-dead-beefdeadbeeg", kDoesntParse},
+      {"deadbeef-dead-beef-dead-beefdeadbee\xE6", kDoesntParse},
+      {"deadbeef-dead-beef-dead-beefdeadbee`", kDoesntParse},
+      {"deadbeef-dead-beef-dead-beefdeadbee@", kDoesntParse},
+      {"deadbeef-dead-beef-dead-beefdeadbee/", kDoesntParse},
+      {"deadbeef-dead-beef-dead-beefdeadbee:", kDoesntParse},
       {"01234567-89aB-cDeF-fEdC-bA9876543210", kParsesCaseInsensitiveOnly},
       {"DEADBEEF-DEAD-BEEF-DEAD-BEEFDEADBEEF", kParsesCaseInsensitiveOnly},
       {"00000000-0000-0000-0000-000000000000", kAlwaysParses},
@@ -219,4 +227,26 @@ TEST(UuidTest, FormatRandomDataAsV4) {
   EXPECT_NE(guid2, guid3);
 }
 
+TEST(UuidTest, FormatRandomDataAsV4String) {
+  static constexpr uint64_t bytes[] = {0x0123456789abcdefull,
+                                       0x5a5a5a5aa5a5a5a5ull};
+  const Uuid guid =
+      Uuid::FormatRandomDataAsV4ForTesting(as_bytes(make_span(bytes)));
+  // The version and variant bits are set.
+  EXPECT_EQ("01234567-89ab-4def-9a5a-5a5aa5a5a5a5", guid.AsLowercaseString());
+  EXPECT_EQ(guid, Uuid::ParseLowercase(guid.AsLowercaseString()));
+}
+
+TEST(UuidTest, AppendTo) {
+  static constexpr char kCanonicalStr[] =
+      "deadbeef-dead-4eef-bead-beefdeadbeef";
+  std::string output = "uuid=";
+  Uuid::ParseLowercase(kCanonicalStr).AppendTo(&output);
+  EXPECT_EQ(std::string("uuid=") + kCanonicalStr, output);
+
+  // Invalid Uuids append nothing.
+  Uuid().AppendTo(&output);
+  EXPECT_EQ(std::string("uuid=") + kCanonicalStr, output);
+}
+
 }  // namespace base
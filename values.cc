@@ -353,6 +353,39 @@ Value::Dict::Dict(Dict&&) noexcept = default;
 
 Value::Dict& Value::Dict::operator=(Dict&&) noexcept = default;
 
+Value::Dict::Dict(std::vector<std::pair<std::string, Value>> entries) {
+  std::vector<std::pair<std::string, std::unique_ptr<Value>>> storage;
+  storage.reserve(entries.size());
+  for (auto& [key, value] : entries) {
+    storage.emplace_back(std::move(key),
+                         std::make_unique<Value>(std::move(value)));
+  }
+  entries.clear();
+
+  // A stable sort keeps entries with the same key in their original order,
+  // so the last of each run of equal keys is the one to keep.
+  const auto key_less = [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  };
+  if (!ranges::is_sorted(storage, key_less)) {
+    ranges::stable_sort(storage, key_less);
+  }
+  size_t kept = 0;
+  for (size_t i = 0; i < storage.size(); ++i) {
+    if (i + 1 < storage.size() && storage[i].first == storage[i + 1].first) {
+      continue;
+    }
+    if (kept != i) {
+      storage[kept] = std::move(storage[i]);
+    }
+    ++kept;
+  }
+  storage.resize(kept);
+
+  storage_ = flat_map<std::string, std::unique_ptr<Value>>(sorted_unique,
+                                                            std::move(storage));
+}
+
 Value::Dict::~Dict() = default;
 
 bool Value::Dict::empty() const {
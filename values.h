@@ -325,6 +325,13 @@ class BASE_EXPORT GSL_OWNER Value {
           flat_map<std::string, std::unique_ptr<Value>>(std::move(values));
     }
 
+    // Moves the entries of |entries|, which may be in any order, into a new
+    // Dict. If a key appears more than once, the last entry for it wins, as if
+    // each entry had been passed to Set() in turn. This sorts the entries
+    // once, and skips sorting entirely if they are already in key order, so
+    // it is much faster than calling Set() for each entry of a large dict.
+    explicit Dict(std::vector<std::pair<std::string, Value>> entries);
+
     ~Dict();
 
     // Returns true if there are no entries in this dictionary and false
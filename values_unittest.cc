@@ -462,6 +462,37 @@ TEST(ValuesTest, ConstructDictWithIterators) {
   EXPECT_EQ(123, blank.GetDict().Find("Int")->GetInt());
 }
 
+TEST(ValuesTest, ConstructDictWithVector) {
+  std::vector<std::pair<std::string, Value>> values;
+  values.emplace_back("b", 1);
+  values.emplace_back("a", 2);
+  values.emplace_back("c", 3);
+  values.emplace_back("b", 4);
+  values.emplace_back("a", 5);
+
+  Value::Dict dict(std::move(values));
+  ASSERT_EQ(3u, dict.size());
+  // The last entry for each key wins, as with Set().
+  EXPECT_EQ(5, dict.FindInt("a"));
+  EXPECT_EQ(4, dict.FindInt("b"));
+  EXPECT_EQ(3, dict.FindInt("c"));
+  std::vector<std::string> keys;
+  for (auto [key, value] : dict) {
+    keys.push_back(key);
+  }
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c"}), keys);
+
+  std::vector<std::pair<std::string, Value>> sorted;
+  sorted.emplace_back("x", 1);
+  sorted.emplace_back("y", 2);
+  sorted.emplace_back("y", 3);
+  EXPECT_EQ(Value::Dict().Set("x", 1).Set("y", 3),
+            Value::Dict(std::move(sorted)));
+
+  EXPECT_TRUE(
+      Value::Dict(std::vector<std::pair<std::string, Value>>()).empty());
+}
+
 TEST(ValuesTest, MoveList) {
   Value::List list;
   list.Append(123);
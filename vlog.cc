@@ -112,6 +112,7 @@ int VlogInfo::GetVlogLevel(std::string_view file) const {
 void VlogInfo::SetMaxVlogLevel(int level) {
   // Log severity is the negative verbosity.
   *min_log_level_ = -level;
+  InvalidateVlogLevelCaches();
 }
 
 int VlogInfo::GetMaxVlogLevel() const {
@@ -4,6 +4,7 @@
 
 #include "base/vlog.h"
 
+#include "base/logging.h"
 #include "base/time/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -183,6 +184,15 @@ TEST(VlogTest, WithSwitches) {
   EXPECT_EQ(1, vlog_info_with_switches->GetVlogLevel("foo.cc"));
   EXPECT_EQ(2, vlog_info_with_switches->GetVlogLevel("bar.cc"));
 }
+
+TEST(VlogTest, SetMaxVlogLevelInvalidatesCaches) {
+  int min_log_level = 0;
+  VlogInfo vlog_info(std::string(), std::string(), &min_log_level);
+  const uint32_t generation = g_vlog_levels_generation.load();
+  vlog_info.SetMaxVlogLevel(2);
+  EXPECT_EQ(-2, min_log_level);
+  EXPECT_NE(generation, g_vlog_levels_generation.load());
+}
 }  // namespace
 
 }  // namespace logging